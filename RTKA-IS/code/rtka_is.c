@@ -18,6 +18,9 @@
  * # Parallel mode
  * gcc -O3 -march=native -DPARALLEL_ENABLED rtka_is.c -lpthread -lm -o rtka_parallel
 
+ * # Parallel mode without the deque trace hooks
+ * gcc -O3 -march=native -DPARALLEL_ENABLED -DRTKA_TRACE_DISABLE rtka_is.c -lpthread -lm -o rtka_parallel
+
  * # Thread safety check
  * gcc -fsanitize=thread -march=native -DPARALLEL_ENABLED rtka_is.c -lpthread -lm -o rtka_tsan
  * or gcc -fsanitize=thread -mavx -DPARALLEL_ENABLED rtka_is.c -lpthread -lm -o rtka_tsan
@@ -28,6 +31,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -91,16 +95,15 @@ typedef struct expr_node {
     struct expr_node *left;
     struct expr_node *right;
 #ifdef PARALLEL_ENABLED
+    // A line per node, so workers completing siblings do not share one
     _Atomic(int) children_complete;
     char padding[CACHE_LINE_SIZE -
                  (sizeof(uint32_t) + sizeof(float) +
                   2 * sizeof(void*) + sizeof(_Atomic(int)))];
+} CACHE_ALIGN expr_node_t;
 #else
-    char padding[CACHE_LINE_SIZE -
-                 (sizeof(uint32_t) + sizeof(float) +
-                  2 * sizeof(void*))];
+} expr_node_t;
 #endif
-} CACHE_ALIGN expr_node_t;
 
 #ifdef PARALLEL_ENABLED
 typedef struct {
@@ -140,22 +143,84 @@ static threshold_config_t g_threshold = {
 
 #define LUT_SIZE 101U
 #define VAR_LUT_SIZE 101U
-static float sigmoid_lut[LUT_SIZE] CACHE_ALIGN;
+#define SIGMOID_LUT_TOLERANCE 1e-3f     // x0 drift that rebuilds the sigmoid LUT
+#define THRESHOLD_MERGE_INTERVAL 32U    // Per-thread updates between merges
+
+// Sigmoid LUT, double-buffered: a rebuild fills the idle buffer and then
+// publishes its index, so readers never see a table being written unless
+// they hold one across two rebuilds. Entries are relaxed atomics in
+// parallel builds (plain loads on x86) so that case is benign, not a race.
+#ifdef PARALLEL_ENABLED
+typedef _Atomic(float) lut_entry_t;
+#define LUT_GET(lut, i) atomic_load_explicit(&(lut)[i], memory_order_relaxed)
+#define LUT_SET(lut, i, v) atomic_store_explicit(&(lut)[i], (v), memory_order_relaxed)
+static _Atomic(uint32_t) sigmoid_lut_live;
+#else
+typedef float lut_entry_t;
+#define LUT_GET(lut, i) ((lut)[i])
+#define LUT_SET(lut, i, v) ((lut)[i] = (v))
+static uint32_t sigmoid_lut_live;
+#endif
+static lut_entry_t sigmoid_lut_buf[2][LUT_SIZE] CACHE_ALIGN;
+static float sigmoid_lut_x0;        // x0 of the live table; written under update_lock
+static uint32_t sigmoid_lut_rebuilds;
 static float var_weight_lut[VAR_LUT_SIZE] CACHE_ALIGN;
 
-static void init_sigmoid_lut(void) __attribute__((constructor));
-static void init_sigmoid_lut(void) {
+#ifdef PARALLEL_ENABLED
+// Thread-local Beta(alpha, beta) counts, merged into g_threshold every
+// THRESHOLD_MERGE_INTERVAL updates: the shared line is written once per
+// interval instead of once per fusion call
+typedef struct {
+    float alpha;
+    float beta;
+    uint32_t pending;
+} threshold_local_t;
+
+static _Thread_local threshold_local_t tl_threshold;
+#endif
+
+static void build_sigmoid_lut(uint32_t target) {
+#ifdef PARALLEL_ENABLED
+    float k = atomic_load_explicit(&g_threshold.sigmoid_k, memory_order_relaxed);
+    float x0 = atomic_load_explicit(&g_threshold.x0, memory_order_relaxed);
+#else
+    float k = g_threshold.sigmoid_k;
+    float x0 = g_threshold.x0;
+#endif
+    lut_entry_t* lut = sigmoid_lut_buf[target];
     for (uint32_t i = 0U; i < LUT_SIZE; i++) {
         float x = (float)i / (float)(LUT_SIZE - 1U);
+        LUT_SET(lut, i, 1.0f / (1.0f + expf(-k * (x - x0))));
+    }
+    sigmoid_lut_x0 = x0;
+    sigmoid_lut_rebuilds++;
 #ifdef PARALLEL_ENABLED
-        float k = atomic_load_explicit(&g_threshold.sigmoid_k, memory_order_relaxed);
-        float x0 = atomic_load_explicit(&g_threshold.x0, memory_order_relaxed);
+    atomic_store_explicit(&sigmoid_lut_live, target, memory_order_release);
 #else
-        float k = g_threshold.sigmoid_k;
-        float x0 = g_threshold.x0;
+    sigmoid_lut_live = target;
 #endif
-        sigmoid_lut[i] = 1.0f / (1.0f + expf(-k * (x - x0)));
-    }
+}
+
+static void init_sigmoid_lut(void) __attribute__((constructor));
+static void init_sigmoid_lut(void) {
+#ifdef PARALLEL_ENABLED
+    build_sigmoid_lut(atomic_load_explicit(&sigmoid_lut_live, memory_order_relaxed) ^ 1U);
+#else
+    build_sigmoid_lut(sigmoid_lut_live ^ 1U);
+#endif
+}
+
+// Rebuild only once x0 has moved past the tolerance; caller holds update_lock
+static void refresh_sigmoid_lut(void) {
+#ifdef PARALLEL_ENABLED
+    float x0 = atomic_load_explicit(&g_threshold.x0, memory_order_relaxed);
+    uint32_t live = atomic_load_explicit(&sigmoid_lut_live, memory_order_relaxed);
+#else
+    float x0 = g_threshold.x0;
+    uint32_t live = sigmoid_lut_live;
+#endif
+    if (fabsf(x0 - sigmoid_lut_x0) <= SIGMOID_LUT_TOLERANCE) return;
+    build_sigmoid_lut(live ^ 1U);
 }
 
 static void init_var_lut(void) __attribute__((constructor));
@@ -167,17 +232,22 @@ static void init_var_lut(void) {
 }
 
 ALWAYS_INLINE static float sigmoid_lut_interp(float conf) {
-    if (UNLIKELY(conf < 0.0f)) return sigmoid_lut[0];
-    if (UNLIKELY(conf > 1.0f)) return sigmoid_lut[LUT_SIZE - 1U];
+#ifdef PARALLEL_ENABLED
+    const lut_entry_t* lut = sigmoid_lut_buf[atomic_load_explicit(&sigmoid_lut_live, memory_order_acquire)];
+#else
+    const lut_entry_t* lut = sigmoid_lut_buf[sigmoid_lut_live];
+#endif
+    if (UNLIKELY(conf < 0.0f)) return LUT_GET(lut, 0U);
+    if (UNLIKELY(conf > 1.0f)) return LUT_GET(lut, LUT_SIZE - 1U);
 
     float idx = conf * (float)(LUT_SIZE - 1U);
     uint32_t low = (uint32_t)idx;
     float frac = idx - (float)low;
 
     if (LIKELY(low < LUT_SIZE - 1U)) {
-        return (1.0f - frac) * sigmoid_lut[low] + frac * sigmoid_lut[low + 1U];
+        return (1.0f - frac) * LUT_GET(lut, low) + frac * LUT_GET(lut, low + 1U);
     }
-    return sigmoid_lut[LUT_SIZE - 1U];
+    return LUT_GET(lut, LUT_SIZE - 1U);
 }
 
 static rtka_value_t apply_threshold_coercion(rtka_value_t value, float confidence) {
@@ -198,24 +268,45 @@ static rtka_value_t apply_threshold_coercion(rtka_value_t value, float confidenc
     return value;
 }
 
-static void update_threshold(bool decision_correct) {
 #ifdef PARALLEL_ENABLED
+// Fold this thread's pending counts into g_threshold. Theta takes the
+// pending EMA steps at once, 0.9^n toward the merged Beta mean.
+static void merge_threshold_estimator(void) {
+    threshold_local_t* local = &tl_threshold;
+    if (local->pending == 0U) return;
+
     pthread_mutex_lock(&g_threshold.update_lock);
-    float old_alpha = atomic_load_explicit(&g_threshold.alpha, memory_order_relaxed);
-    float old_beta = atomic_load_explicit(&g_threshold.beta, memory_order_relaxed);
-    if (decision_correct) {
-        atomic_store_explicit(&g_threshold.alpha, old_alpha + 1.0f, memory_order_relaxed);
-        old_alpha += 1.0f;
-    } else {
-        atomic_store_explicit(&g_threshold.beta, old_beta + 1.0f, memory_order_relaxed);
-        old_beta += 1.0f;
-    }
-    float new_theta = old_alpha / (old_alpha + old_beta);
+    float alpha = atomic_load_explicit(&g_threshold.alpha, memory_order_relaxed) + local->alpha;
+    float beta = atomic_load_explicit(&g_threshold.beta, memory_order_relaxed) + local->beta;
+    atomic_store_explicit(&g_threshold.alpha, alpha, memory_order_relaxed);
+    atomic_store_explicit(&g_threshold.beta, beta, memory_order_relaxed);
+    float new_theta = alpha / (alpha + beta);
+    float keep = powf(0.9f, (float)local->pending);
     float current_theta = atomic_load_explicit(&g_threshold.theta, memory_order_relaxed);
-    atomic_store_explicit(&g_threshold.theta, 0.9f * current_theta + 0.1f * new_theta, memory_order_relaxed);
+    atomic_store_explicit(&g_threshold.theta, keep * current_theta + (1.0f - keep) * new_theta,
+                          memory_order_relaxed);
     atomic_store_explicit(&g_threshold.x0, new_theta * 0.7f, memory_order_relaxed);
-    init_sigmoid_lut();
+    refresh_sigmoid_lut();
     pthread_mutex_unlock(&g_threshold.update_lock);
+
+    local->alpha = 0.0f;
+    local->beta = 0.0f;
+    local->pending = 0U;
+}
+#endif
+
+static void update_threshold(bool decision_correct) {
+#ifdef PARALLEL_ENABLED
+    if (!atomic_load_explicit(&g_threshold.adaptive_enabled, memory_order_relaxed)) return;
+    threshold_local_t* local = &tl_threshold;
+    if (decision_correct) {
+        local->alpha += 1.0f;
+    } else {
+        local->beta += 1.0f;
+    }
+    if (++local->pending >= THRESHOLD_MERGE_INTERVAL) {
+        merge_threshold_estimator();
+    }
 #else
     if (!g_threshold.adaptive_enabled) return;
     if (decision_correct) {
@@ -226,7 +317,7 @@ static void update_threshold(bool decision_correct) {
     float new_theta = g_threshold.alpha / (g_threshold.alpha + g_threshold.beta);
     g_threshold.theta = 0.9f * g_threshold.theta + 0.1f * new_theta;
     g_threshold.x0 = g_threshold.theta * 0.7f;
-    init_sigmoid_lut();
+    refresh_sigmoid_lut();
 #endif
 }
 
@@ -298,64 +389,1486 @@ static bool evaluate_node_scalar(expr_node_t* node, float threshold) {
             if (node->bits.value == RTKA_TRUE && node->confidence >= threshold) return true;
             break;
         case OP_NOT:
-            node->bits.value = rtka_not(left_val);
-            node->confidence = conf_not(left_conf);
-            break;
-        case OP_IMPLY:
-            node->bits.value = rtka_imply(left_val, right_val);
-            node->confidence = conf_imply(left_conf, right_conf);
+            node->bits.value = rtka_not(left_val);
+            node->confidence = conf_not(left_conf);
+            break;
+        case OP_IMPLY:
+            node->bits.value = rtka_imply(left_val, right_val);
+            node->confidence = conf_imply(left_conf, right_conf);
+            break;
+        case OP_EQUIV:
+            node->bits.value = rtka_equiv(left_val, right_val);
+            node->confidence = conf_equiv(left_conf, right_conf);
+            break;
+        case OP_VALUE:
+            break;
+        default:
+            node->bits.value = RTKA_UNKNOWN;
+            node->confidence = 0.0f;
+            return false;
+    }
+
+    node->bits.value = apply_threshold_coercion(node->bits.value, node->confidence);
+    update_threshold(node->bits.value != RTKA_UNKNOWN);
+    return true;
+}
+
+rtka_value_t rtka_evaluate_scalar(expr_node_t* root, float threshold) {
+    if (UNLIKELY(!root)) return RTKA_UNKNOWN;
+    evaluate_node_scalar(root, threshold);
+    return root->bits.value;
+}
+
+static uint32_t count_tree_nodes(const expr_node_t* node, uint32_t* leaves) {
+    if (!node) return 0U;
+    if (node->bits.op == OP_VALUE) {
+        (*leaves)++;
+        return 1U;
+    }
+    return 1U + count_tree_nodes(node->left, leaves) + count_tree_nodes(node->right, leaves);
+}
+
+// Packed Trees
+//
+// Big trees stored as one array of 16-byte nodes with 32-bit child indices
+// instead of linked expr_node_t. Children precede their parents, so
+// rtka_evaluate_packed() is a single forward pass with no pointer chasing,
+// and rtka_compile_packed() feeds the compiled and batch evaluators without
+// ever building linked nodes. Index 0 is the missing child, UNKNOWN/0.0.
+// rtka_pack_tree() lays a tree out in post-order, in which order the
+// packed scalar pass matches rtka_evaluate_scalar step for step, threshold
+// learning included.
+
+#define PACKED_NO_CHILD 0U
+#define PACKED_INVALID UINT32_MAX
+#define PACKED_MIN_NODES 64U
+
+typedef struct {
+    uint8_t op;
+    int8_t value;
+    uint16_t reserved;
+    float confidence;
+    uint32_t left;      /* Node index, PACKED_NO_CHILD for none */
+    uint32_t right;
+} packed_node_t;
+
+typedef struct {
+    packed_node_t* nodes;
+    uint32_t count;     /* Including node 0; the last node is the root */
+    uint32_t capacity;
+} rtka_packed_tree_t;
+
+void rtka_packed_destroy(rtka_packed_tree_t* tree) {
+    if (!tree) return;
+    free(tree->nodes);
+    free(tree);
+}
+
+rtka_packed_tree_t* rtka_packed_create(uint32_t expected_nodes) {
+    rtka_packed_tree_t* tree = calloc(1, sizeof(rtka_packed_tree_t));
+    if (UNLIKELY(!tree)) return NULL;
+    uint32_t capacity = PACKED_MIN_NODES;
+    while (capacity <= expected_nodes && capacity < (1U << 30)) capacity *= 2U;
+    tree->nodes = malloc(capacity * sizeof(packed_node_t));
+    if (UNLIKELY(!tree->nodes)) {
+        free(tree);
+        return NULL;
+    }
+    tree->nodes[PACKED_NO_CHILD] = (packed_node_t){.op = OP_VALUE, .value = RTKA_UNKNOWN, .confidence = 0.0f};
+    tree->count = 1U;
+    tree->capacity = capacity;
+    return tree;
+}
+
+// Children must already be in the tree; OP_VALUE nodes take none
+uint32_t rtka_packed_add(rtka_packed_tree_t* tree, uint32_t op, rtka_value_t value, float conf,
+                         uint32_t left, uint32_t right) {
+    if (UNLIKELY(!tree || op > 7U || left >= tree->count || right >= tree->count)) return PACKED_INVALID;
+    if (UNLIKELY(tree->count == tree->capacity)) {
+        packed_node_t* nodes = realloc(tree->nodes, 2U * tree->capacity * sizeof(packed_node_t));
+        if (UNLIKELY(!nodes)) return PACKED_INVALID;
+        tree->nodes = nodes;
+        tree->capacity *= 2U;
+    }
+    bool leaf = op == OP_VALUE;
+    tree->nodes[tree->count] = (packed_node_t){
+        .op = (uint8_t)op, .value = (int8_t)value, .confidence = conf,
+        .left = leaf ? PACKED_NO_CHILD : left, .right = leaf ? PACKED_NO_CHILD : right};
+    return tree->count++;
+}
+
+static uint32_t pack_subtree(rtka_packed_tree_t* tree, const expr_node_t* node) {
+    if (!node) return PACKED_NO_CHILD;
+    uint32_t left = PACKED_NO_CHILD, right = PACKED_NO_CHILD;
+    if (node->bits.op != OP_VALUE) {
+        left = pack_subtree(tree, node->left);
+        right = pack_subtree(tree, node->right);
+        if (UNLIKELY(left == PACKED_INVALID || right == PACKED_INVALID)) return PACKED_INVALID;
+    }
+    return rtka_packed_add(tree, node->bits.op, node->bits.value, node->confidence, left, right);
+}
+
+rtka_packed_tree_t* rtka_pack_tree(const expr_node_t* root) {
+    if (UNLIKELY(!root)) return NULL;
+    uint32_t leaves = 0U;
+    rtka_packed_tree_t* tree = rtka_packed_create(count_tree_nodes(root, &leaves) + 1U);
+    if (UNLIKELY(!tree)) return NULL;
+    if (UNLIKELY(pack_subtree(tree, root) == PACKED_INVALID)) {
+        rtka_packed_destroy(tree);
+        return NULL;
+    }
+    return tree;
+}
+
+// evaluate_node_scalar over the array: results and coerced leaves are
+// written back, and a node that terminates early skips coercion and learning
+rtka_value_t rtka_evaluate_packed(rtka_packed_tree_t* tree, float threshold) {
+    if (UNLIKELY(!tree || tree->count < 2U)) return RTKA_UNKNOWN;
+    packed_node_t* restrict nodes = tree->nodes;
+
+    for (uint32_t i = 1U; i < tree->count; i++) {
+        packed_node_t* node = &nodes[i];
+        const packed_node_t* l = &nodes[node->left];
+        const packed_node_t* r = &nodes[node->right];
+        rtka_value_t v = (rtka_value_t)node->value;
+        float c = node->confidence;
+
+        switch (node->op) {
+            case OP_AND:
+                v = rtka_and((rtka_value_t)l->value, (rtka_value_t)r->value);
+                c = conf_and(l->confidence, r->confidence);
+                if (v == RTKA_FALSE) goto store;
+                break;
+            case OP_OR:
+                v = rtka_or((rtka_value_t)l->value, (rtka_value_t)r->value);
+                c = conf_or(l->confidence, r->confidence);
+                if (v == RTKA_TRUE && c >= threshold) goto store;
+                break;
+            case OP_NOT:
+                v = rtka_not((rtka_value_t)l->value);
+                c = conf_not(l->confidence);
+                break;
+            case OP_IMPLY:
+                v = rtka_imply((rtka_value_t)l->value, (rtka_value_t)r->value);
+                c = conf_imply(l->confidence, r->confidence);
+                break;
+            case OP_EQUIV:
+                v = rtka_equiv((rtka_value_t)l->value, (rtka_value_t)r->value);
+                c = conf_equiv(l->confidence, r->confidence);
+                break;
+            case OP_VALUE:
+                break;
+            default:
+                v = RTKA_UNKNOWN;
+                c = 0.0f;
+                goto store;
+        }
+        v = apply_threshold_coercion(v, c);
+        update_threshold(v != RTKA_UNKNOWN);
+    store:
+        node->value = (int8_t)v;
+        node->confidence = c;
+    }
+    return (rtka_value_t)nodes[tree->count - 1U].value;
+}
+
+// Tree Metadata
+static uint32_t compute_tree_metadata(expr_node_t* node, uint32_t depth) {
+    if (UNLIKELY(!node)) return 0U;
+
+    node->bits.depth = depth;
+    node->bits.visited = 1U;
+
+    if (node->bits.op == OP_VALUE) {
+        node->bits.subtree_size = 1U;
+        node->bits.height = 0U;
+        node->bits.balance_factor = 0;
+        node->bits.heat = (node->confidence > 0.5f) ? 1U : 0U;
+        return 1U;
+    }
+
+    uint32_t left_size = compute_tree_metadata(node->left, depth + 1U);
+    uint32_t right_size = compute_tree_metadata(node->right, depth + 1U);
+
+    node->bits.subtree_size = 1U + left_size + right_size;
+
+    uint32_t left_height = node->left ? node->left->bits.height + 1U : 0U;
+    uint32_t right_height = node->right ? node->right->bits.height + 1U : 0U;
+
+    node->bits.height = (left_height > right_height) ? left_height : right_height;
+    node->bits.balance_factor = (int32_t)(right_height - left_height);
+    node->bits.heat = (left_size + right_size > 5U) ? 1U : 0U;
+
+    return node->bits.subtree_size;
+}
+
+// Compiled Evaluation
+//
+// rtka_compile() flattens a tree once into a level-ordered instruction array;
+// rtka_program_run() then re-evaluates it with no allocation, map lookups or
+// thread creation. Instruction k writes result slot k + 1, slot 0 is the
+// UNKNOWN/0.0 stand-in for a missing child, and every instruction reads only
+// slots of lower levels - so each level can be split across a worker team.
+// Semantics match rtka_evaluate_parallel: coercion at every node, no
+// threshold short-circuit and no threshold learning.
+
+#define PROGRAM_NO_CHILD 0U
+#define PROGRAM_NO_PARENT UINT32_MAX
+#define PROGRAM_MIN_PARALLEL_WIDTH 512U  /* Narrower levels stay on the caller */
+#define PROGRAM_BATCH_TILE 256U          /* Rows per column pass */
+
+typedef struct {
+    uint32_t op;
+    uint32_t left;      /* Result slot, or leaf id for OP_VALUE */
+    uint32_t right;     /* Result slot */
+    uint32_t level;
+} program_instr_t;
+
+// Batch code: post-order with columns allocated like registers, so a tile
+// needs only as many live columns as the tree's widest frontier. Column 0
+// is the constant UNKNOWN/0.0 column for missing children.
+typedef struct {
+    uint32_t op;
+    uint32_t left;      /* Source column, or leaf id for OP_VALUE */
+    uint32_t right;     /* Source column */
+    uint32_t dst;       /* Never equal to a source column */
+} batch_instr_t;
+
+// Short-circuit statistics of one AND/OR instruction, by side (0 left, 1 right)
+typedef struct {
+    uint32_t evals[2];      /* Times the child was evaluated */
+    uint32_t absorbs[2];    /* ... and came out absorbing */
+    uint32_t cost[2];       /* Instructions visited for it */
+    uint32_t size[2];       /* Subtree instructions, the cost prior */
+    uint32_t first;         /* Side evaluated first */
+} short_stats_t;
+
+typedef struct {
+    uint32_t begin;     /* Instruction range */
+    uint32_t end;
+    bool parallel;      /* Split across the team, else caller only */
+} program_phase_t;
+
+#ifdef PARALLEL_ENABLED
+typedef struct rtka_program rtka_program_t;
+
+typedef struct {
+    rtka_program_t* prog;
+    uint32_t index;     /* 1..n; caller is 0 */
+} program_worker_t;
+
+typedef struct {
+    pthread_t* threads;
+    program_worker_t* workers;
+    uint32_t num_workers;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    _Atomic(uint32_t) run_gen CACHE_ALIGN;
+    _Atomic(bool) shutdown;
+    _Atomic(uint32_t) barrier_count CACHE_ALIGN;
+    _Atomic(uint32_t) barrier_gen;
+} program_team_t;
+#endif
+
+typedef struct rtka_program {
+    program_instr_t* code;
+    uint32_t num_instr;
+    int8_t* values;             /* num_instr + 1 slots */
+    float* confs;
+
+    rtka_value_t* leaf_values;  /* Inputs, by leaf id */
+    float* leaf_confs;
+    expr_node_t** leaf_nodes;   /* Source leaves, for rtka_program_sync_leaves */
+    uint32_t num_leaves;
+
+    program_phase_t* phases;
+    uint32_t num_phases;
+    bool has_parallel_phase;
+
+    uint32_t* parent;           /* Parent instruction, PROGRAM_NO_PARENT at the root */
+    uint32_t* leaf_instr;       /* Instruction of each leaf id */
+    bool evaluated;             /* Slots hold the results of the current inputs */
+    uint32_t last_update_visits;
+
+    short_stats_t* short_stats; /* Per instruction, allocated on the first short run */
+    uint64_t short_runs;
+    uint64_t early_terminations;    /* AND/OR nodes decided by their first child */
+    uint32_t last_short_visits;
+    uint32_t short_reorders;        /* Child orders flipped so far */
+
+    batch_instr_t* batch_code;  /* num_instr entries, post-order */
+    uint32_t batch_columns;
+    int8_t* batch_values;       /* batch_columns x PROGRAM_BATCH_TILE */
+    float* batch_confs;
+#ifdef PARALLEL_ENABLED
+    program_team_t team;
+#endif
+} rtka_program_t;
+
+typedef struct {
+    program_instr_t* code;
+    uint32_t count;
+    expr_node_t** leaves;       /* Source leaves of a linked tree */
+    rtka_value_t* leaf_values;
+    float* leaf_confs;
+    uint32_t num_leaves;
+} program_builder_t;
+
+ALWAYS_INLINE static uint32_t emit_instr(program_builder_t* b, program_instr_t ins) {
+    if (ins.op != OP_VALUE) {
+        uint32_t ll = ins.left ? b->code[ins.left - 1U].level + 1U : 0U;
+        uint32_t rl = ins.right ? b->code[ins.right - 1U].level + 1U : 0U;
+        ins.level = (ll > rl) ? ll : rl;
+    }
+    b->code[b->count++] = ins;
+    return b->count;
+}
+
+// Post-order emit; returns the result slot of node
+static uint32_t emit_postorder(program_builder_t* b, expr_node_t* node) {
+    if (!node) return PROGRAM_NO_CHILD;
+
+    program_instr_t ins = {.op = node->bits.op, .left = 0U, .right = 0U, .level = 0U};
+    if (node->bits.op == OP_VALUE) {
+        ins.left = b->num_leaves;
+        b->leaf_values[b->num_leaves] = node->bits.value;
+        b->leaf_confs[b->num_leaves] = node->confidence;
+        b->leaves[b->num_leaves++] = node;
+    } else {
+        ins.left = emit_postorder(b, node->left);
+        ins.right = emit_postorder(b, node->right);
+    }
+    return emit_instr(b, ins);
+}
+
+// A node reached twice in a packed array is emitted twice: programs are trees
+static uint32_t count_packed_nodes(const rtka_packed_tree_t* tree, uint32_t i, uint32_t* leaves) {
+    if (i == PACKED_NO_CHILD) return 0U;
+    const packed_node_t* node = &tree->nodes[i];
+    if (node->op == OP_VALUE) {
+        (*leaves)++;
+        return 1U;
+    }
+    return 1U + count_packed_nodes(tree, node->left, leaves) + count_packed_nodes(tree, node->right, leaves);
+}
+
+static uint32_t emit_packed(program_builder_t* b, const rtka_packed_tree_t* tree, uint32_t i) {
+    if (i == PACKED_NO_CHILD) return PROGRAM_NO_CHILD;
+
+    const packed_node_t* node = &tree->nodes[i];
+    program_instr_t ins = {.op = node->op, .left = 0U, .right = 0U, .level = 0U};
+    if (node->op == OP_VALUE) {
+        ins.left = b->num_leaves;
+        b->leaf_values[b->num_leaves] = (rtka_value_t)node->value;
+        b->leaf_confs[b->num_leaves++] = node->confidence;
+    } else {
+        ins.left = emit_packed(b, tree, node->left);
+        ins.right = emit_packed(b, tree, node->right);
+    }
+    return emit_instr(b, ins);
+}
+
+// Evaluates instruction k into slot k + 1
+ALWAYS_INLINE static void program_eval_instr(rtka_program_t* restrict prog, uint32_t k) {
+    const program_instr_t ins = prog->code[k];
+    int8_t* restrict values = prog->values;
+    float* restrict confs = prog->confs;
+
+    if (ins.op == OP_VALUE) {
+        // left holds the leaf index, not a slot
+        rtka_value_t v = prog->leaf_values[ins.left];
+        float c = prog->leaf_confs[ins.left];
+        values[k + 1U] = (int8_t)apply_threshold_coercion(v, c);
+        confs[k + 1U] = c;
+        return;
+    }
+    rtka_value_t lv = (rtka_value_t)values[ins.left];
+    rtka_value_t rv = (rtka_value_t)values[ins.right];
+    float lc = confs[ins.left];
+    float rc = confs[ins.right];
+    rtka_value_t v;
+    float c;
+
+    switch (ins.op) {
+        case OP_AND:   v = rtka_and(lv, rv);   c = conf_and(lc, rc);   break;
+        case OP_OR:    v = rtka_or(lv, rv);    c = conf_or(lc, rc);    break;
+        case OP_NOT:   v = rtka_not(lv);       c = conf_not(lc);       break;
+        case OP_IMPLY: v = rtka_imply(lv, rv); c = conf_imply(lc, rc); break;
+        case OP_EQUIV: v = rtka_equiv(lv, rv); c = conf_equiv(lc, rc); break;
+        default:
+            values[k + 1U] = RTKA_UNKNOWN;
+            confs[k + 1U] = 0.0f;
+            return;
+    }
+
+    values[k + 1U] = (int8_t)apply_threshold_coercion(v, c);
+    confs[k + 1U] = c;
+}
+
+ALWAYS_INLINE static void program_eval_range(rtka_program_t* restrict prog, uint32_t begin, uint32_t end) {
+    for (uint32_t k = begin; k < end; k++) {
+        program_eval_instr(prog, k);
+    }
+}
+
+#ifdef PARALLEL_ENABLED
+static void team_barrier(program_team_t* team, uint32_t participants) {
+    uint32_t gen = atomic_load_explicit(&team->barrier_gen, memory_order_acquire);
+    if (atomic_fetch_add_explicit(&team->barrier_count, 1U, memory_order_acq_rel) + 1U == participants) {
+        atomic_store_explicit(&team->barrier_count, 0U, memory_order_relaxed);
+        atomic_fetch_add_explicit(&team->barrier_gen, 1U, memory_order_release);
+        return;
+    }
+    uint32_t spins = 0U;
+    while (atomic_load_explicit(&team->barrier_gen, memory_order_acquire) == gen) {
+        if (++spins < 128U) {
+            __builtin_ia32_pause();
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+// Phase walk shared by caller (index 0) and workers
+static void program_run_phases(rtka_program_t* prog, uint32_t index) {
+    uint32_t participants = prog->team.num_workers + 1U;
+    for (uint32_t p = 0U; p < prog->num_phases; p++) {
+        const program_phase_t* ph = &prog->phases[p];
+        if (ph->parallel) {
+            uint32_t len = ph->end - ph->begin;
+            uint32_t lo = ph->begin + (uint32_t)(((uint64_t)len * index) / participants);
+            uint32_t hi = ph->begin + (uint32_t)(((uint64_t)len * (index + 1U)) / participants);
+            program_eval_range(prog, lo, hi);
+        } else if (index == 0U) {
+            program_eval_range(prog, ph->begin, ph->end);
+        }
+        team_barrier(&prog->team, participants);
+    }
+}
+
+static void* program_worker_main(void* arg) {
+    program_worker_t* self = (program_worker_t*)arg;
+    program_team_t* team = &self->prog->team;
+    uint32_t seen = 0U;   /* run_gen is 0 until the team is fully started */
+
+    for (;;) {
+        // Spin briefly for back-to-back runs, yield, then park
+        uint32_t spins = 0U;
+        while (atomic_load_explicit(&team->run_gen, memory_order_acquire) == seen &&
+               !atomic_load_explicit(&team->shutdown, memory_order_acquire) && spins < 1024U) {
+            if (++spins < 256U) {
+                __builtin_ia32_pause();
+            } else {
+                sched_yield();
+            }
+        }
+        pthread_mutex_lock(&team->lock);
+        while (atomic_load_explicit(&team->run_gen, memory_order_acquire) == seen &&
+               !atomic_load_explicit(&team->shutdown, memory_order_acquire)) {
+            pthread_cond_wait(&team->wake, &team->lock);
+        }
+        pthread_mutex_unlock(&team->lock);
+
+        if (atomic_load_explicit(&team->shutdown, memory_order_acquire)) break;
+        seen = atomic_load_explicit(&team->run_gen, memory_order_acquire);
+        program_run_phases(self->prog, self->index);
+    }
+    return NULL;
+}
+
+static void program_team_stop(rtka_program_t* prog) {
+    program_team_t* team = &prog->team;
+    if (!team->threads) return;
+    pthread_mutex_lock(&team->lock);
+    atomic_store_explicit(&team->shutdown, true, memory_order_release);
+    pthread_cond_broadcast(&team->wake);
+    pthread_mutex_unlock(&team->lock);
+    for (uint32_t i = 0U; i < team->num_workers; i++) {
+        pthread_join(team->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&team->lock);
+    pthread_cond_destroy(&team->wake);
+    free(team->threads);
+    free(team->workers);
+    team->threads = NULL;
+    team->num_workers = 0U;
+}
+
+static bool program_team_start(rtka_program_t* prog, uint32_t num_workers) {
+    program_team_t* team = &prog->team;
+    team->threads = calloc(num_workers, sizeof(pthread_t));
+    team->workers = calloc(num_workers, sizeof(program_worker_t));
+    if (UNLIKELY(!team->threads || !team->workers)) {
+        free(team->threads);
+        free(team->workers);
+        team->threads = NULL;
+        return false;
+    }
+    pthread_mutex_init(&team->lock, NULL);
+    pthread_cond_init(&team->wake, NULL);
+    atomic_store_explicit(&team->run_gen, 0U, memory_order_relaxed);
+    atomic_store_explicit(&team->shutdown, false, memory_order_relaxed);
+    atomic_store_explicit(&team->barrier_count, 0U, memory_order_relaxed);
+    atomic_store_explicit(&team->barrier_gen, 0U, memory_order_relaxed);
+
+    for (uint32_t i = 0U; i < num_workers; i++) {
+        team->workers[i].prog = prog;
+        team->workers[i].index = i + 1U;
+        if (pthread_create(&team->threads[i], NULL, program_worker_main, &team->workers[i]) != 0) {
+            team->num_workers = i;
+            program_team_stop(prog);
+            return false;
+        }
+        team->num_workers = i + 1U;
+    }
+    return true;
+}
+#endif
+
+// Assign batch columns over the post-order code. Each result is read
+// exactly once, so a column is recycled as soon as its consumer issues.
+static bool program_alloc_batch(rtka_program_t* prog, const program_instr_t* post, uint32_t n) {
+    uint32_t* column_of = malloc((n + 1U) * sizeof(uint32_t));
+    uint32_t* free_cols = malloc((n + 1U) * sizeof(uint32_t));
+    prog->batch_code = malloc(n * sizeof(batch_instr_t));
+    if (UNLIKELY(!column_of || !free_cols || !prog->batch_code)) {
+        free(column_of);
+        free(free_cols);
+        return false;
+    }
+
+    uint32_t num_free = 0U, columns = 1U;
+    column_of[PROGRAM_NO_CHILD] = 0U;
+    for (uint32_t k = 0U; k < n; k++) {
+        batch_instr_t bi = {.op = post[k].op, .left = 0U, .right = 0U, .dst = 0U};
+        if (post[k].op == OP_VALUE) {
+            bi.left = post[k].left;
+        } else {
+            bi.left = column_of[post[k].left];
+            bi.right = column_of[post[k].right];
+        }
+        bi.dst = num_free ? free_cols[--num_free] : columns++;
+        if (post[k].op != OP_VALUE) {
+            if (bi.left) free_cols[num_free++] = bi.left;
+            if (bi.right) free_cols[num_free++] = bi.right;
+        }
+        column_of[k + 1U] = bi.dst;
+        prog->batch_code[k] = bi;
+    }
+    free(column_of);
+    free(free_cols);
+
+    size_t vbytes = (size_t)columns * PROGRAM_BATCH_TILE;
+    prog->batch_columns = columns;
+    prog->batch_values = aligned_alloc(CACHE_LINE_SIZE, vbytes);
+    prog->batch_confs = aligned_alloc(CACHE_LINE_SIZE, vbytes * sizeof(float));
+    if (UNLIKELY(!prog->batch_values || !prog->batch_confs)) return false;
+    memset(prog->batch_values, 0, vbytes);
+    memset(prog->batch_confs, 0, vbytes * sizeof(float));
+    return true;
+}
+
+void rtka_program_destroy(rtka_program_t* prog);
+
+// Compiles either the linked tree at root or the packed tree
+static rtka_program_t* program_build(expr_node_t* root, const rtka_packed_tree_t* tree,
+                                     uint32_t n, uint32_t num_leaves, int num_threads) {
+    rtka_program_t* prog = calloc(1, sizeof(rtka_program_t));
+    if (UNLIKELY(!prog)) return NULL;
+
+    size_t code_bytes = ((n * sizeof(program_instr_t)) + CACHE_LINE_SIZE - 1U) & ~(size_t)(CACHE_LINE_SIZE - 1U);
+    size_t slot_bytes = (((n + 1U) * sizeof(float)) + CACHE_LINE_SIZE - 1U) & ~(size_t)(CACHE_LINE_SIZE - 1U);
+
+    program_instr_t* scratch = malloc(n * sizeof(program_instr_t));
+    uint32_t* level_count = NULL;
+    prog->code = aligned_alloc(CACHE_LINE_SIZE, code_bytes);
+    prog->values = aligned_alloc(CACHE_LINE_SIZE, slot_bytes);
+    prog->confs = aligned_alloc(CACHE_LINE_SIZE, slot_bytes);
+    prog->leaf_values = calloc(num_leaves + 1U, sizeof(rtka_value_t));
+    prog->leaf_confs = calloc(num_leaves + 1U, sizeof(float));
+    prog->leaf_nodes = calloc(num_leaves + 1U, sizeof(expr_node_t*));
+    prog->parent = malloc(n * sizeof(uint32_t));
+    prog->leaf_instr = calloc(num_leaves + 1U, sizeof(uint32_t));
+    if (UNLIKELY(!scratch || !prog->code || !prog->values || !prog->confs ||
+                 !prog->leaf_values || !prog->leaf_confs || !prog->leaf_nodes ||
+                 !prog->parent || !prog->leaf_instr)) {
+        free(scratch);
+        rtka_program_destroy(prog);
+        return NULL;
+    }
+
+    program_builder_t b = {.code = scratch, .count = 0U, .leaves = prog->leaf_nodes,
+                           .leaf_values = prog->leaf_values, .leaf_confs = prog->leaf_confs,
+                           .num_leaves = 0U};
+    if (root) {
+        emit_postorder(&b, root);
+    } else {
+        emit_packed(&b, tree, tree->count - 1U);
+    }
+    prog->num_instr = n;
+    prog->num_leaves = num_leaves;
+
+    if (UNLIKELY(!program_alloc_batch(prog, scratch, n))) {
+        free(scratch);
+        rtka_program_destroy(prog);
+        return NULL;
+    }
+
+    // Stable counting sort by level; remap child slots post-order -> level order
+    uint32_t max_level = 0U;
+    for (uint32_t k = 0U; k < n; k++) {
+        if (scratch[k].level > max_level) max_level = scratch[k].level;
+    }
+    level_count = calloc(max_level + 2U, sizeof(uint32_t));
+    uint32_t* remap = malloc((n + 1U) * sizeof(uint32_t));
+    prog->phases = calloc(max_level + 1U, sizeof(program_phase_t));
+    if (UNLIKELY(!level_count || !remap || !prog->phases)) {
+        free(scratch); free(level_count); free(remap);
+        rtka_program_destroy(prog);
+        return NULL;
+    }
+    for (uint32_t k = 0U; k < n; k++) level_count[scratch[k].level + 1U]++;
+    for (uint32_t l = 1U; l <= max_level + 1U; l++) level_count[l] += level_count[l - 1U];
+
+    remap[PROGRAM_NO_CHILD] = PROGRAM_NO_CHILD;
+    for (uint32_t k = 0U; k < n; k++) {
+        remap[k + 1U] = level_count[scratch[k].level]++ + 1U;
+    }
+    for (uint32_t k = 0U; k < n; k++) {
+        program_instr_t ins = scratch[k];
+        if (ins.op != OP_VALUE) {
+            ins.left = remap[ins.left];
+            ins.right = remap[ins.right];
+        }
+        prog->code[remap[k + 1U] - 1U] = ins;
+    }
+
+    // Upward links for incremental updates
+    for (uint32_t k = 0U; k < n; k++) prog->parent[k] = PROGRAM_NO_PARENT;
+    for (uint32_t k = 0U; k < n; k++) {
+        const program_instr_t* ins = &prog->code[k];
+        if (ins->op == OP_VALUE) {
+            prog->leaf_instr[ins->left] = k;
+            continue;
+        }
+        if (ins->left) prog->parent[ins->left - 1U] = k;
+        if (ins->right) prog->parent[ins->right - 1U] = k;
+    }
+
+    // Phases: wide levels alone, runs of narrow levels merged for the caller
+    uint32_t begin = 0U;
+    for (uint32_t l = 0U; l <= max_level; l++) {
+        uint32_t end = begin;
+        while (end < n && prog->code[end].level == l) end++;
+        bool wide = (end - begin) >= PROGRAM_MIN_PARALLEL_WIDTH && num_threads > 1;
+        program_phase_t* last = prog->num_phases ? &prog->phases[prog->num_phases - 1U] : NULL;
+        if (!wide && last && !last->parallel) {
+            last->end = end;
+        } else {
+            prog->phases[prog->num_phases++] = (program_phase_t){begin, end, wide};
+            prog->has_parallel_phase |= wide;
+        }
+        begin = end;
+    }
+
+    free(scratch);
+    free(level_count);
+    free(remap);
+
+    prog->values[PROGRAM_NO_CHILD] = RTKA_UNKNOWN;
+    prog->confs[PROGRAM_NO_CHILD] = 0.0f;
+
+#ifdef PARALLEL_ENABLED
+    if (prog->has_parallel_phase && !program_team_start(prog, (uint32_t)num_threads - 1U)) {
+        prog->has_parallel_phase = false;
+    }
+#endif
+    return prog;
+}
+
+rtka_program_t* rtka_compile(expr_node_t* root, int num_threads) {
+    if (UNLIKELY(!root)) return NULL;
+    uint32_t num_leaves = 0U;
+    uint32_t n = count_tree_nodes(root, &num_leaves);
+    return program_build(root, NULL, n, num_leaves, num_threads);
+}
+
+// Inputs come from the packed leaves; leaf_nodes stay NULL
+rtka_program_t* rtka_compile_packed(const rtka_packed_tree_t* tree, int num_threads) {
+    if (UNLIKELY(!tree || tree->count < 2U)) return NULL;
+    uint32_t num_leaves = 0U;
+    uint32_t n = count_packed_nodes(tree, tree->count - 1U, &num_leaves);
+    return program_build(NULL, tree, n, num_leaves, num_threads);
+}
+
+void rtka_program_destroy(rtka_program_t* prog) {
+    if (!prog) return;
+#ifdef PARALLEL_ENABLED
+    program_team_stop(prog);
+#endif
+    free(prog->code);
+    free(prog->values);
+    free(prog->confs);
+    free(prog->leaf_values);
+    free(prog->leaf_confs);
+    free(prog->leaf_nodes);
+    free(prog->phases);
+    free(prog->parent);
+    free(prog->leaf_instr);
+    free(prog->short_stats);
+    free(prog->batch_code);
+    free(prog->batch_values);
+    free(prog->batch_confs);
+    free(prog);
+}
+
+// Leaf ids are assigned left to right
+void rtka_program_set_leaf(rtka_program_t* prog, uint32_t leaf, rtka_value_t value, float conf) {
+    prog->leaf_values[leaf] = value;
+    prog->leaf_confs[leaf] = conf;
+    prog->evaluated = false;
+}
+
+// Reload all inputs from the source tree's leaves (after in-place edits);
+// packed programs have none and keep their inputs
+void rtka_program_sync_leaves(rtka_program_t* prog) {
+    for (uint32_t i = 0U; i < prog->num_leaves; i++) {
+        if (!prog->leaf_nodes[i]) continue;
+        prog->leaf_values[i] = prog->leaf_nodes[i]->bits.value;
+        prog->leaf_confs[i] = prog->leaf_nodes[i]->confidence;
+    }
+    prog->evaluated = false;
+}
+
+rtka_value_t rtka_program_run(rtka_program_t* prog, float* out_conf) {
+    if (UNLIKELY(!prog || prog->num_instr == 0U)) return RTKA_UNKNOWN;
+
+#ifdef PARALLEL_ENABLED
+    if (prog->has_parallel_phase) {
+        program_team_t* team = &prog->team;
+        pthread_mutex_lock(&team->lock);
+        atomic_fetch_add_explicit(&team->run_gen, 1U, memory_order_release);
+        pthread_cond_broadcast(&team->wake);
+        pthread_mutex_unlock(&team->lock);
+        program_run_phases(prog, 0U);
+    } else
+#endif
+    {
+        program_eval_range(prog, 0U, prog->num_instr);
+    }
+    prog->evaluated = true;
+
+    // Root is the last instruction of the top level
+    if (out_conf) *out_conf = prog->confs[prog->num_instr];
+    return (rtka_value_t)prog->values[prog->num_instr];
+}
+
+// Incremental Evaluation
+//
+// The result slots double as each node's cached output. Changing one leaf
+// re-evaluates its path toward the root and stops at the first node whose
+// value and confidence both come out unchanged - e.g. an AND that already
+// has a FALSE child whose confidence is unaffected. Cost follows the
+// changed path, not the tree. The result equals a full rtka_program_run.
+rtka_value_t rtka_program_update_leaf(rtka_program_t* prog, uint32_t leaf,
+                                      rtka_value_t value, float conf, float* out_conf) {
+    if (UNLIKELY(!prog || prog->num_instr == 0U || leaf >= prog->num_leaves)) return RTKA_UNKNOWN;
+
+    prog->leaf_values[leaf] = value;
+    prog->leaf_confs[leaf] = conf;
+    if (UNLIKELY(!prog->evaluated)) {
+        prog->last_update_visits = prog->num_instr;
+        return rtka_program_run(prog, out_conf);
+    }
+
+    uint32_t visits = 0U;
+    uint32_t k = prog->leaf_instr[leaf];
+    while (k != PROGRAM_NO_PARENT) {
+        int8_t old_value = prog->values[k + 1U];
+        float old_conf = prog->confs[k + 1U];
+        program_eval_instr(prog, k);
+        visits++;
+        if (prog->values[k + 1U] == old_value && prog->confs[k + 1U] == old_conf) break;
+        k = prog->parent[k];
+    }
+    prog->last_update_visits = visits;
+
+    if (out_conf) *out_conf = prog->confs[prog->num_instr];
+    return (rtka_value_t)prog->values[prog->num_instr];
+}
+
+// Short-Circuit Evaluation
+//
+// rtka_program_run_short() walks the program top-down and stops an AND at
+// its first FALSE child, an OR at its first TRUE one; the node then takes
+// that child's state, as rtka_recursive_and / rtka_recursive_or do. The
+// skipped subtree is never visited. Values agree with rtka_program_run
+// while coercion is off; with it on, an absorbed node keeps the deciding
+// child's confidence instead of the combined one, so it is not coerced by
+// a weak sibling.
+//
+// Which child goes first is learned. Each AND/OR keeps, per side, how often
+// the child came out absorbing and how many instructions it cost, and every
+// PROGRAM_REORDER_INTERVAL runs the side with the lower cost / P(absorb) is
+// put first - the cheap, frequently decisive subtree, as in selectivity
+// ordering of database predicates. Counts are halved at each reorder so
+// the order follows drifting inputs.
+
+#define PROGRAM_REORDER_INTERVAL 256U
+
+static bool program_alloc_short(rtka_program_t* prog) {
+    prog->short_stats = calloc(prog->num_instr, sizeof(short_stats_t));
+    if (UNLIKELY(!prog->short_stats)) return false;
+
+    // Children sit on lower levels, so sizes are known before their parent's
+    uint32_t* size = malloc((prog->num_instr + 1U) * sizeof(uint32_t));
+    if (UNLIKELY(!size)) {
+        free(prog->short_stats);
+        prog->short_stats = NULL;
+        return false;
+    }
+    size[PROGRAM_NO_CHILD] = 0U;
+    for (uint32_t k = 0U; k < prog->num_instr; k++) {
+        const program_instr_t* ins = &prog->code[k];
+        if (ins->op == OP_VALUE) {
+            size[k + 1U] = 1U;
+            continue;
+        }
+        size[k + 1U] = 1U + size[ins->left] + size[ins->right];
+        prog->short_stats[k].size[0] = size[ins->left];
+        prog->short_stats[k].size[1] = size[ins->right];
+    }
+    free(size);
+    return true;
+}
+
+// Evaluates the subtree of slot (instruction slot - 1) into its result slot
+static void short_eval(rtka_program_t* restrict prog, uint32_t slot, uint32_t* visits) {
+    if (slot == PROGRAM_NO_CHILD) return;
+    const uint32_t k = slot - 1U;
+    const program_instr_t ins = prog->code[k];
+    (*visits)++;
+
+    if (ins.op != OP_AND && ins.op != OP_OR) {
+        if (ins.op != OP_VALUE) {
+            short_eval(prog, ins.left, visits);
+            if (ins.op != OP_NOT) short_eval(prog, ins.right, visits);
+        }
+        program_eval_instr(prog, k);
+        return;
+    }
+
+    short_stats_t* st = &prog->short_stats[k];
+    const int8_t absorbing = (ins.op == OP_AND) ? (int8_t)RTKA_FALSE : (int8_t)RTKA_TRUE;
+    const uint32_t child[2] = {ins.left, ins.right};
+    const uint32_t side = st->first;
+
+    uint32_t before = *visits;
+    short_eval(prog, child[side], visits);
+    st->evals[side]++;
+    st->cost[side] += *visits - before;
+    if (prog->values[child[side]] == absorbing) {
+        // Already coerced at this confidence, so it stands as the result
+        st->absorbs[side]++;
+        prog->values[slot] = absorbing;
+        prog->confs[slot] = prog->confs[child[side]];
+        prog->early_terminations++;
+        return;
+    }
+
+    before = *visits;
+    short_eval(prog, child[side ^ 1U], visits);
+    st->evals[side ^ 1U]++;
+    st->cost[side ^ 1U] += *visits - before;
+    st->absorbs[side ^ 1U] += prog->values[child[side ^ 1U]] == absorbing;
+    program_eval_instr(prog, k);
+}
+
+// Left first iff cost_l / p_l < cost_r / p_r. P(absorb) starts at 1/2 and
+// the cost at the subtree size, so an untried side is neither favoured nor
+// written off.
+static void program_reorder(rtka_program_t* prog) {
+    for (uint32_t k = 0U; k < prog->num_instr; k++) {
+        const uint32_t op = prog->code[k].op;
+        if (op != OP_AND && op != OP_OR) continue;
+
+        short_stats_t* st = &prog->short_stats[k];
+        double cost[2], p[2];
+        for (uint32_t s = 0U; s < 2U; s++) {
+            cost[s] = ((double)st->cost[s] + st->size[s]) / ((double)st->evals[s] + 1.0);
+            p[s] = ((double)st->absorbs[s] + 1.0) / ((double)st->evals[s] + 2.0);
+            st->evals[s] >>= 1;
+            st->absorbs[s] >>= 1;
+            st->cost[s] >>= 1;
+        }
+        uint32_t first = (cost[0] * p[1] <= cost[1] * p[0]) ? 0U : 1U;
+        prog->short_reorders += first != st->first;
+        st->first = first;
+    }
+}
+
+rtka_value_t rtka_program_run_short(rtka_program_t* prog, float* out_conf) {
+    if (UNLIKELY(!prog || prog->num_instr == 0U)) return RTKA_UNKNOWN;
+    if (UNLIKELY(!prog->short_stats && !program_alloc_short(prog))) return rtka_program_run(prog, out_conf);
+
+    uint32_t visits = 0U;
+    short_eval(prog, prog->num_instr, &visits);
+    prog->last_short_visits = visits;
+    // Skipped slots are stale
+    prog->evaluated = false;
+    if (++prog->short_runs % PROGRAM_REORDER_INTERVAL == 0U) program_reorder(prog);
+
+    if (out_conf) *out_conf = prog->confs[prog->num_instr];
+    return (rtka_value_t)prog->values[prog->num_instr];
+}
+
+// Batch Evaluation
+//
+// Evaluates the program over `rows` independent input rows. Inputs are
+// column-major: leaf i's values for all rows are leaf_values[i * rows ...],
+// likewise leaf_confs. Rows are processed in tiles; each instruction is one
+// streaming pass over the tile, which the compiler turns into SIMD.
+
+static bool coerce_predicate(float c) {
+    return 1.0f - sigmoid_lut_interp(c) > 0.8f;
+}
+
+// The sigmoid table is monotone, so below theta coercion holds exactly for
+// confidences under a single cutoff. Bisect for it over float bit patterns,
+// which order like the values for c >= 0; negative c behaves like 0.
+static float batch_coerce_cutoff(void) {
+    if (!coerce_predicate(0.0f)) return 0.0f;
+    if (coerce_predicate(1.0f)) return INFINITY;
+
+    uint32_t lo = 0U, hi;
+    float one = 1.0f;
+    memcpy(&hi, &one, sizeof(hi));
+    while (hi - lo > 1U) {
+        uint32_t mid = lo + (hi - lo) / 2U;
+        float c;
+        memcpy(&c, &mid, sizeof(c));
+        if (coerce_predicate(c)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    float cut;
+    memcpy(&cut, &hi, sizeof(cut));
+    return cut;
+}
+
+typedef struct {
+    bool enabled;
+    float theta;
+    float cutoff;
+} batch_coerce_t;
+
+static batch_coerce_t batch_coerce_load(void) {
+    batch_coerce_t co;
+#ifdef PARALLEL_ENABLED
+    co.enabled = atomic_load_explicit(&g_threshold.adaptive_enabled, memory_order_relaxed);
+    co.theta = atomic_load_explicit(&g_threshold.theta, memory_order_relaxed);
+#else
+    co.enabled = g_threshold.adaptive_enabled;
+    co.theta = g_threshold.theta;
+#endif
+    co.cutoff = co.enabled ? batch_coerce_cutoff() : 0.0f;
+    return co;
+}
+
+static void batch_coerce(int8_t* restrict v, const float* restrict c, uint32_t n, const batch_coerce_t* co) {
+    if (!co->enabled) return;
+    const float theta = co->theta, cutoff = co->cutoff;
+    for (uint32_t i = 0U; i < n; i++) {
+        float x = c[i] > 0.0f ? c[i] : 0.0f;
+        int8_t keep = (int8_t)-(int8_t)((c[i] >= theta) | (x >= cutoff));
+        v[i] = (int8_t)(v[i] & keep);
+    }
+}
+
+static void batch_exec(uint32_t op, int8_t* restrict dv, float* restrict dc,
+                       const int8_t* restrict lv, const float* restrict lc,
+                       const int8_t* restrict rv, const float* restrict rc, uint32_t n,
+                       const batch_coerce_t* co) {
+    switch (op) {
+        case OP_AND:
+            for (uint32_t i = 0U; i < n; i++) {
+                dv[i] = (lv[i] < rv[i]) ? lv[i] : rv[i];
+                dc[i] = lc[i] * rc[i];
+            }
+            break;
+        case OP_OR:
+            for (uint32_t i = 0U; i < n; i++) {
+                dv[i] = (lv[i] > rv[i]) ? lv[i] : rv[i];
+                dc[i] = 1.0f - (1.0f - lc[i]) * (1.0f - rc[i]);
+            }
+            break;
+        case OP_NOT:
+            for (uint32_t i = 0U; i < n; i++) {
+                dv[i] = (int8_t)-lv[i];
+                dc[i] = lc[i];
+            }
+            break;
+        case OP_IMPLY:
+            for (uint32_t i = 0U; i < n; i++) {
+                int8_t na = (int8_t)-lv[i];
+                dv[i] = (na > rv[i]) ? na : rv[i];
+                dc[i] = 1.0f - (1.0f - (1.0f - lc[i])) * (1.0f - rc[i]);
+            }
+            break;
+        case OP_EQUIV:
+            // Equal -> TRUE, else the product: 0 with an UNKNOWN, -1 for opposites
+            for (uint32_t i = 0U; i < n; i++) {
+                dv[i] = (lv[i] == rv[i]) ? (int8_t)RTKA_TRUE : (int8_t)(lv[i] * rv[i]);
+                dc[i] = lc[i] * rc[i];
+            }
+            break;
+        default:
+            memset(dv, 0, n);
+            memset(dc, 0, n * sizeof(float));
+            return;
+    }
+    batch_coerce(dv, dc, n, co);
+}
+
+bool rtka_program_run_batch(rtka_program_t* prog,
+                            const int8_t* restrict leaf_values,
+                            const float* restrict leaf_confs,
+                            uint32_t rows,
+                            int8_t* restrict out_values,
+                            float* restrict out_confs) {
+    if (UNLIKELY(!prog || !leaf_values || !leaf_confs || !out_values || !out_confs)) return false;
+    if (UNLIKELY(prog->num_instr == 0U)) return false;
+
+    const batch_instr_t* code = prog->batch_code;
+    const uint32_t root = code[prog->num_instr - 1U].dst;
+
+    // Threshold state is read once per batch
+    const batch_coerce_t co = batch_coerce_load();
+
+    for (uint32_t row0 = 0U; row0 < rows; row0 += PROGRAM_BATCH_TILE) {
+        uint32_t n = rows - row0;
+        if (n > PROGRAM_BATCH_TILE) n = PROGRAM_BATCH_TILE;
+
+        for (uint32_t k = 0U; k < prog->num_instr; k++) {
+            const batch_instr_t bi = code[k];
+            int8_t* dv = prog->batch_values + (size_t)bi.dst * PROGRAM_BATCH_TILE;
+            float* dc = prog->batch_confs + (size_t)bi.dst * PROGRAM_BATCH_TILE;
+
+            if (bi.op == OP_VALUE) {
+                size_t off = (size_t)bi.left * rows + row0;
+                memcpy(dv, leaf_values + off, n);
+                memcpy(dc, leaf_confs + off, n * sizeof(float));
+                batch_coerce(dv, dc, n, &co);
+                continue;
+            }
+            batch_exec(bi.op, dv, dc,
+                       prog->batch_values + (size_t)bi.left * PROGRAM_BATCH_TILE,
+                       prog->batch_confs + (size_t)bi.left * PROGRAM_BATCH_TILE,
+                       prog->batch_values + (size_t)bi.right * PROGRAM_BATCH_TILE,
+                       prog->batch_confs + (size_t)bi.right * PROGRAM_BATCH_TILE, n, &co);
+        }
+
+        memcpy(out_values + row0, prog->batch_values + (size_t)root * PROGRAM_BATCH_TILE, n);
+        memcpy(out_confs + row0, prog->batch_confs + (size_t)root * PROGRAM_BATCH_TILE, n * sizeof(float));
+    }
+    return true;
+}
+
+// Shared Expression DAGs
+//
+// A rule base often repeats whole sub-rules. rtka_dag_* hash-conses them:
+// rtka_dag_node() returns the existing node for an (op, left, right) it has
+// seen before, so structurally identical subexpressions become one node
+// whatever rule they came from. AND, OR and EQUIV are commutative here,
+// value and confidence alike, and have their operands ordered; NOT of a NOT
+// is its operand, since coercion depends on the confidence alone.
+//
+// Leaves are numbered inputs. Node 0 is the missing child, UNKNOWN/0.0.
+// Results are memoized per node and stay valid until an input changes, so
+// a shared node is evaluated once however many rules reach it, and later
+// roots of the same inputs reuse the earlier work. Semantics match
+// rtka_program_run.
+
+#define DAG_NO_CHILD 0U
+#define DAG_INVALID UINT32_MAX
+#define DAG_MIN_NODES 64U
+
+typedef struct {
+    uint32_t op;
+    uint32_t left;      /* Node id, or input id for OP_VALUE */
+    uint32_t right;
+} dag_node_t;
+
+typedef struct rtka_dag {
+    dag_node_t* nodes;
+    uint32_t num_nodes;         /* Including node 0 */
+    uint32_t capacity;
+    uint32_t* table;            /* Open addressing, node id or 0 */
+    uint32_t table_mask;
+
+    int8_t* values;             /* Memoized results, by node */
+    float* confs;
+    uint32_t* stamp;            /* Epoch of each result */
+    uint32_t epoch;
+    bool inputs_changed;
+
+    rtka_value_t* input_values;
+    float* input_confs;
+    uint32_t num_inputs;
+
+    uint64_t lookups;
+    uint64_t shared;            /* Lookups answered by an existing node */
+    uint32_t last_eval_visits;
+} rtka_dag_t;
+
+ALWAYS_INLINE static uint32_t dag_hash(uint32_t op, uint32_t left, uint32_t right) {
+    uint64_t h = ((uint64_t)left << 32 | right) * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)op * 0xC2B2AE3D27D4EB4FULL;
+    return (uint32_t)(h >> 32) ^ (uint32_t)h;
+}
+
+static bool dag_grow_nodes(rtka_dag_t* dag) {
+    uint32_t capacity = dag->capacity * 2U;
+    dag_node_t* nodes = realloc(dag->nodes, capacity * sizeof(dag_node_t));
+    if (UNLIKELY(!nodes)) return false;
+    dag->nodes = nodes;
+    int8_t* values = realloc(dag->values, capacity);
+    if (UNLIKELY(!values)) return false;
+    dag->values = values;
+    float* confs = realloc(dag->confs, capacity * sizeof(float));
+    if (UNLIKELY(!confs)) return false;
+    dag->confs = confs;
+    uint32_t* stamp = realloc(dag->stamp, capacity * sizeof(uint32_t));
+    if (UNLIKELY(!stamp)) return false;
+    dag->stamp = stamp;
+    dag->capacity = capacity;
+    return true;
+}
+
+// Table kept at most half full
+static bool dag_grow_table(rtka_dag_t* dag) {
+    uint32_t size = (dag->table_mask + 1U) * 2U;
+    uint32_t* table = calloc(size, sizeof(uint32_t));
+    if (UNLIKELY(!table)) return false;
+    for (uint32_t id = 1U; id < dag->num_nodes; id++) {
+        const dag_node_t* n = &dag->nodes[id];
+        uint32_t i = dag_hash(n->op, n->left, n->right) & (size - 1U);
+        while (table[i]) i = (i + 1U) & (size - 1U);
+        table[i] = id;
+    }
+    free(dag->table);
+    dag->table = table;
+    dag->table_mask = size - 1U;
+    return true;
+}
+
+static bool dag_grow_inputs(rtka_dag_t* dag, uint32_t count) {
+    rtka_value_t* values = realloc(dag->input_values, count * sizeof(rtka_value_t));
+    if (UNLIKELY(!values)) return false;
+    dag->input_values = values;
+    float* confs = realloc(dag->input_confs, count * sizeof(float));
+    if (UNLIKELY(!confs)) return false;
+    dag->input_confs = confs;
+    for (uint32_t i = dag->num_inputs; i < count; i++) {
+        dag->input_values[i] = RTKA_UNKNOWN;
+        dag->input_confs[i] = 0.0f;
+    }
+    dag->num_inputs = count;
+    dag->inputs_changed = true;
+    return true;
+}
+
+void rtka_dag_destroy(rtka_dag_t* dag);
+
+rtka_dag_t* rtka_dag_create(uint32_t expected_nodes) {
+    rtka_dag_t* dag = calloc(1, sizeof(rtka_dag_t));
+    if (UNLIKELY(!dag)) return NULL;
+
+    uint32_t capacity = DAG_MIN_NODES;
+    while (capacity < expected_nodes && capacity < (1U << 30)) capacity *= 2U;
+    dag->capacity = capacity;
+    dag->nodes = malloc(capacity * sizeof(dag_node_t));
+    dag->values = malloc(capacity);
+    dag->confs = malloc(capacity * sizeof(float));
+    dag->stamp = malloc(capacity * sizeof(uint32_t));
+    dag->table = calloc(2U * capacity, sizeof(uint32_t));
+    if (UNLIKELY(!dag->nodes || !dag->values || !dag->confs || !dag->stamp || !dag->table)) {
+        rtka_dag_destroy(dag);
+        return NULL;
+    }
+    dag->table_mask = 2U * capacity - 1U;
+
+    dag->nodes[DAG_NO_CHILD] = (dag_node_t){.op = OP_VALUE, .left = 0U, .right = 0U};
+    dag->values[DAG_NO_CHILD] = RTKA_UNKNOWN;
+    dag->confs[DAG_NO_CHILD] = 0.0f;
+    dag->stamp[DAG_NO_CHILD] = 0U;
+    dag->num_nodes = 1U;
+    dag->epoch = 1U;
+    return dag;
+}
+
+void rtka_dag_destroy(rtka_dag_t* dag) {
+    if (!dag) return;
+    free(dag->nodes);
+    free(dag->values);
+    free(dag->confs);
+    free(dag->stamp);
+    free(dag->table);
+    free(dag->input_values);
+    free(dag->input_confs);
+    free(dag);
+}
+
+static uint32_t dag_intern(rtka_dag_t* dag, uint32_t op, uint32_t left, uint32_t right) {
+    if (UNLIKELY(2U * (dag->num_nodes + 1U) > dag->table_mask + 1U) && !dag_grow_table(dag)) {
+        return DAG_INVALID;
+    }
+    dag->lookups++;
+    uint32_t i = dag_hash(op, left, right) & dag->table_mask;
+    for (uint32_t id; (id = dag->table[i]) != 0U; i = (i + 1U) & dag->table_mask) {
+        const dag_node_t* n = &dag->nodes[id];
+        if (n->op == op && n->left == left && n->right == right) {
+            dag->shared++;
+            return id;
+        }
+    }
+
+    if (UNLIKELY(dag->num_nodes == dag->capacity && !dag_grow_nodes(dag))) return DAG_INVALID;
+    uint32_t id = dag->num_nodes++;
+    dag->nodes[id] = (dag_node_t){.op = op, .left = left, .right = right};
+    dag->stamp[id] = 0U;
+    dag->table[i] = id;
+    return id;
+}
+
+// Leaf reading input; inputs start UNKNOWN/0.0
+uint32_t rtka_dag_input(rtka_dag_t* dag, uint32_t input) {
+    if (UNLIKELY(!dag || input == UINT32_MAX)) return DAG_INVALID;
+    if (input >= dag->num_inputs && !dag_grow_inputs(dag, input + 1U)) return DAG_INVALID;
+    return dag_intern(dag, OP_VALUE, input, 0U);
+}
+
+// Operands are node ids of this DAG, DAG_NO_CHILD for a missing child
+uint32_t rtka_dag_node(rtka_dag_t* dag, uint32_t op, uint32_t left, uint32_t right) {
+    if (UNLIKELY(!dag || op >= OP_VALUE)) return DAG_INVALID;
+    if (UNLIKELY(left >= dag->num_nodes || right >= dag->num_nodes)) return DAG_INVALID;
+
+    switch (op) {
+        case OP_NOT:
+            if (dag->nodes[left].op == OP_NOT) return dag->nodes[left].left;
+            right = DAG_NO_CHILD;
             break;
+        case OP_AND:
+        case OP_OR:
         case OP_EQUIV:
-            node->bits.value = rtka_equiv(left_val, right_val);
-            node->confidence = conf_equiv(left_conf, right_conf);
-            break;
-        case OP_VALUE:
+            if (left > right) {
+                uint32_t t = left;
+                left = right;
+                right = t;
+            }
             break;
         default:
-            node->bits.value = RTKA_UNKNOWN;
-            node->confidence = 0.0f;
-            return false;
+            break;
     }
+    return dag_intern(dag, op, left, right);
+}
 
-    node->bits.value = apply_threshold_coercion(node->bits.value, node->confidence);
-    update_threshold(node->bits.value != RTKA_UNKNOWN);
-    return true;
+static uint32_t dag_add_subtree(rtka_dag_t* dag, const expr_node_t* node,
+                                const uint32_t* leaf_inputs, uint32_t* next_leaf) {
+    if (!node) return DAG_NO_CHILD;
+    if (node->bits.op == OP_VALUE) {
+        uint32_t leaf = (*next_leaf)++;
+        return rtka_dag_input(dag, leaf_inputs ? leaf_inputs[leaf] : leaf);
+    }
+    uint32_t left = dag_add_subtree(dag, node->left, leaf_inputs, next_leaf);
+    uint32_t right = dag_add_subtree(dag, node->right, leaf_inputs, next_leaf);
+    if (UNLIKELY(left == DAG_INVALID || right == DAG_INVALID)) return DAG_INVALID;
+    // Unknown ops evaluate to UNKNOWN/0.0, like the missing child
+    if (node->bits.op > OP_VALUE) return DAG_NO_CHILD;
+    return rtka_dag_node(dag, node->bits.op, left, right);
 }
 
-rtka_value_t rtka_evaluate_scalar(expr_node_t* root, float threshold) {
-    if (UNLIKELY(!root)) return RTKA_UNKNOWN;
-    evaluate_node_scalar(root, threshold);
-    return root->bits.value;
+// Adds a tree; its k-th leaf, left to right as in rtka_compile, reads input
+// leaf_inputs[k] (k itself when leaf_inputs is NULL). Returns the root node.
+uint32_t rtka_dag_add_tree(rtka_dag_t* dag, const expr_node_t* root, const uint32_t* leaf_inputs) {
+    if (UNLIKELY(!dag || !root)) return DAG_INVALID;
+    uint32_t next_leaf = 0U;
+    return dag_add_subtree(dag, root, leaf_inputs, &next_leaf);
 }
 
-// Tree Metadata
-static uint32_t compute_tree_metadata(expr_node_t* node, uint32_t depth) {
-    if (UNLIKELY(!node)) return 0U;
+void rtka_dag_set_input(rtka_dag_t* dag, uint32_t input, rtka_value_t value, float conf) {
+    if (UNLIKELY(!dag || input >= dag->num_inputs)) return;
+    dag->input_values[input] = value;
+    dag->input_confs[input] = conf;
+    dag->inputs_changed = true;
+}
 
-    node->bits.depth = depth;
-    node->bits.visited = 1U;
+static void dag_eval_node(rtka_dag_t* restrict dag, uint32_t id, uint32_t* visits) {
+    if (id == DAG_NO_CHILD || dag->stamp[id] == dag->epoch) return;
+    const dag_node_t n = dag->nodes[id];
+    (*visits)++;
 
-    if (node->bits.op == OP_VALUE) {
-        node->bits.subtree_size = 1U;
-        node->bits.height = 0U;
-        node->bits.balance_factor = 0;
-        node->bits.heat = (node->confidence > 0.5f) ? 1U : 0U;
-        return 1U;
+    rtka_value_t v;
+    float c;
+    if (n.op == OP_VALUE) {
+        v = dag->input_values[n.left];
+        c = dag->input_confs[n.left];
+    } else {
+        dag_eval_node(dag, n.left, visits);
+        dag_eval_node(dag, n.right, visits);
+        rtka_value_t lv = (rtka_value_t)dag->values[n.left];
+        rtka_value_t rv = (rtka_value_t)dag->values[n.right];
+        float lc = dag->confs[n.left];
+        float rc = dag->confs[n.right];
+        switch (n.op) {
+            case OP_AND:   v = rtka_and(lv, rv);   c = conf_and(lc, rc);   break;
+            case OP_OR:    v = rtka_or(lv, rv);    c = conf_or(lc, rc);    break;
+            case OP_NOT:   v = rtka_not(lv);       c = conf_not(lc);       break;
+            case OP_IMPLY: v = rtka_imply(lv, rv); c = conf_imply(lc, rc); break;
+            default:       v = rtka_equiv(lv, rv); c = conf_equiv(lc, rc); break;
+        }
     }
+    dag->values[id] = (int8_t)apply_threshold_coercion(v, c);
+    dag->confs[id] = c;
+    dag->stamp[id] = dag->epoch;
+}
 
-    uint32_t left_size = compute_tree_metadata(node->left, depth + 1U);
-    uint32_t right_size = compute_tree_metadata(node->right, depth + 1U);
+// Evaluates root, reusing every result computed since the last input change
+rtka_value_t rtka_dag_eval(rtka_dag_t* dag, uint32_t root, float* out_conf) {
+    if (UNLIKELY(!dag || root >= dag->num_nodes)) {
+        if (out_conf) *out_conf = 0.0f;
+        return RTKA_UNKNOWN;
+    }
+    if (dag->inputs_changed) {
+        if (UNLIKELY(++dag->epoch == UINT32_MAX)) {
+            memset(dag->stamp + 1, 0, (dag->num_nodes - 1U) * sizeof(uint32_t));
+            dag->epoch = 1U;
+        }
+        dag->inputs_changed = false;
+    }
 
-    node->bits.subtree_size = 1U + left_size + right_size;
+    uint32_t visits = 0U;
+    dag_eval_node(dag, root, &visits);
+    dag->last_eval_visits = visits;
 
-    uint32_t left_height = node->left ? node->left->bits.height + 1U : 0U;
-    uint32_t right_height = node->right ? node->right->bits.height + 1U : 0U;
+    if (out_conf) *out_conf = dag->confs[root];
+    return (rtka_value_t)dag->values[root];
+}
 
-    node->bits.height = (left_height > right_height) ? left_height : right_height;
-    node->bits.balance_factor = (int32_t)(right_height - left_height);
-    node->bits.heat = (left_size + right_size > 5U) ? 1U : 0U;
+// Fixed Rules
+//
+// A rule known at build time is written as an expression of RULE_* macros
+// and defined with RTKA_RULE; it compiles to straight-line rtka_* / conf_*
+// code with no node loads and no op dispatch. Semantics match
+// rtka_program_run: coercion at every node, leaves included. Coercion is the
+// branch-free cutoff test of batch_coerce, fed by a batch_coerce_load()
+// snapshot the caller takes once per run of evaluations. Terms that are
+// UNKNOWN at compile time skip the test, so RULE_CONST(RTKA_UNKNOWN, ...)
+// and what it decides (NOT of it, AND with TRUE, ...) fold to constants.
+//
+//   RTKA_RULE(rule_alarm, RULE_OR(RULE_AND(RULE_VAR(0), RULE_VAR(1)), RULE_NOT(RULE_VAR(2))))
+//   batch_coerce_t co = batch_coerce_load();
+//   rtka_value_t v = rule_alarm(values, confs, &co, &conf);
+//
+// RULE_VAR(i) reads values[i] / confs[i]. rtka_rule_print emits the
+// expression of an existing tree, numbering leaves like rtka_compile, so a
+// tree and its generated rule take the same leaf arrays.
 
-    return node->bits.subtree_size;
+typedef struct {
+    rtka_value_t value;
+    float conf;
+} rule_term_t;
+
+ALWAYS_INLINE static rule_term_t rule_coerce(rtka_value_t v, float c, const batch_coerce_t* restrict co) {
+    if (__builtin_constant_p(v) && v == RTKA_UNKNOWN) return (rule_term_t){RTKA_UNKNOWN, c};
+    float x = c > 0.0f ? c : 0.0f;
+    bool coerce = co->enabled & (c < co->theta) & (x < co->cutoff);
+    return (rule_term_t){coerce ? RTKA_UNKNOWN : v, c};
+}
+
+ALWAYS_INLINE static rule_term_t rule_and(rule_term_t a, rule_term_t b, const batch_coerce_t* restrict co) {
+    return rule_coerce(rtka_and(a.value, b.value), conf_and(a.conf, b.conf), co);
+}
+
+ALWAYS_INLINE static rule_term_t rule_or(rule_term_t a, rule_term_t b, const batch_coerce_t* restrict co) {
+    return rule_coerce(rtka_or(a.value, b.value), conf_or(a.conf, b.conf), co);
+}
+
+ALWAYS_INLINE static rule_term_t rule_not(rule_term_t a, const batch_coerce_t* restrict co) {
+    return rule_coerce(rtka_not(a.value), conf_not(a.conf), co);
+}
+
+ALWAYS_INLINE static rule_term_t rule_imply(rule_term_t a, rule_term_t b, const batch_coerce_t* restrict co) {
+    return rule_coerce(rtka_imply(a.value, b.value), conf_imply(a.conf, b.conf), co);
+}
+
+ALWAYS_INLINE static rule_term_t rule_equiv(rule_term_t a, rule_term_t b, const batch_coerce_t* restrict co) {
+    return rule_coerce(rtka_equiv(a.value, b.value), conf_equiv(a.conf, b.conf), co);
+}
+
+#define RULE_VAR(i)        rule_coerce(rule_v_[i], rule_c_[i], rule_co_)
+#define RULE_CONST(v, c)   rule_coerce((v), (c), rule_co_)
+#define RULE_AND(a, b)     rule_and((a), (b), rule_co_)
+#define RULE_OR(a, b)      rule_or((a), (b), rule_co_)
+#define RULE_NOT(a)        rule_not((a), rule_co_)
+#define RULE_IMPLY(a, b)   rule_imply((a), (b), rule_co_)
+#define RULE_EQUIV(a, b)   rule_equiv((a), (b), rule_co_)
+
+// Defines rtka_value_t name(values, confs, co, out_conf); out_conf may be NULL
+#define RTKA_RULE(name, expr)                                                      \
+    static inline rtka_value_t name(const rtka_value_t* restrict rule_v_,         \
+                                    const float* restrict rule_c_,                \
+                                    const batch_coerce_t* restrict rule_co_,      \
+                                    float* out_conf) {                            \
+        const rule_term_t rule_t_ = (expr);                                        \
+        if (out_conf) *out_conf = rule_t_.conf;                                    \
+        return rule_t_.value;                                                      \
+    }
+
+// A missing child reads as UNKNOWN/0.0, like program slot 0
+static void rule_print_node(const expr_node_t* node, FILE* out, uint32_t* next_leaf) {
+    if (!node) {
+        fputs("RULE_CONST(RTKA_UNKNOWN, 0.0f)", out);
+        return;
+    }
+    const char* name = NULL;
+    switch (node->bits.op) {
+        case OP_VALUE:
+            fprintf(out, "RULE_VAR(%u)", (*next_leaf)++);
+            return;
+        case OP_NOT:
+            // The right operand is never read, but its leaves keep their ids
+            fputs("RULE_NOT(", out);
+            rule_print_node(node->left, out, next_leaf);
+            fputc(')', out);
+            if (node->right) count_tree_nodes(node->right, next_leaf);
+            return;
+        case OP_AND:   name = "RULE_AND";   break;
+        case OP_OR:    name = "RULE_OR";    break;
+        case OP_IMPLY: name = "RULE_IMPLY"; break;
+        case OP_EQUIV: name = "RULE_EQUIV"; break;
+        default:
+            // Evaluates to UNKNOWN/0.0 without coercion
+            fputs("RULE_CONST(RTKA_UNKNOWN, 0.0f)", out);
+            count_tree_nodes(node->left, next_leaf);
+            count_tree_nodes(node->right, next_leaf);
+            return;
+    }
+    fprintf(out, "%s(", name);
+    rule_print_node(node->left, out, next_leaf);
+    fputs(", ", out);
+    rule_print_node(node->right, out, next_leaf);
+    fputc(')', out);
+}
+
+// Writes root as a RULE_* expression for RTKA_RULE; returns the leaf count
+uint32_t rtka_rule_print(const expr_node_t* root, FILE* out) {
+    uint32_t leaves = 0U;
+    if (UNLIKELY(!out)) return 0U;
+    rule_print_node(root, out, &leaves);
+    return leaves;
 }
 
 // Sensor Fusion
@@ -371,13 +1884,10 @@ typedef struct {
     float confidence;
 } fusion_result_t;
 
-ALWAYS_INLINE static float geometric_mean(const float* restrict confs, uint32_t n) {
+/* (∏cᵢ)^(1/n) from Σ ln cᵢ: no underflow and no powf for any sensor count */
+ALWAYS_INLINE static float geometric_mean_log(float log_sum, uint32_t n, bool any_zero) {
     if (UNLIKELY(n == 0U)) return 1.0f;
-    float prod = 1.0f;
-    for (uint32_t i = 0U; i < n; i++) {
-        prod *= confs[i];
-    }
-    return powf(prod, 1.0f / (float)n);
+    return any_zero ? 0.0f : expf(log_sum / (float)n);
 }
 
 static fusion_result_t fuse_sensors_adaptive(const sensor_input_t* restrict sensors, uint32_t n) {
@@ -385,8 +1895,9 @@ static fusion_result_t fuse_sensors_adaptive(const sensor_input_t* restrict sens
     float weighted_sum = 0.0f;
     float weight_sum = 0.0f;
     float conf_prod_or = 1.0f;
-    float confs[NUM_SENSORS] = {0.0f};
-    uint32_t conf_idx = 0U;
+    float log_conf_sum = 0.0f;
+    uint32_t conf_count = 0U;
+    bool zero_conf = false;
     float total_var = 0.0f;
     bool early_term = false;
 
@@ -398,7 +1909,9 @@ static fusion_result_t fuse_sensors_adaptive(const sensor_input_t* restrict sens
         weight_sum += sensors[i].confidence;
 
         conf_prod_or *= (1.0f - sensors[i].confidence);
-        if (conf_idx < NUM_SENSORS) confs[conf_idx++] = sensors[i].confidence;
+        log_conf_sum += logf(fmaxf(sensors[i].confidence, 1e-30f));
+        zero_conf |= sensors[i].confidence <= 0.0f;
+        conf_count++;
         total_var += sensors[i].variance;
 
         float theta =
@@ -425,7 +1938,7 @@ static fusion_result_t fuse_sensors_adaptive(const sensor_input_t* restrict sens
     res.fused = (consensus_val > 0.5f) ? RTKA_TRUE : (consensus_val < -0.5f ? RTKA_FALSE : RTKA_UNKNOWN);
     res.confidence = fused_conf_or;
     if (res.fused == RTKA_UNKNOWN) {
-        float geo_mean = geometric_mean(confs, conf_idx);
+        float geo_mean = geometric_mean_log(log_conf_sum, conf_count, zero_conf);
         float deviation = fabsf(consensus_val) / 0.5f;
         res.confidence = geo_mean * (1.0f - deviation);
     }
@@ -486,15 +1999,180 @@ static void simd_conf_and_batch(float* restrict result, const float* restrict c1
     }
 }
 
+// Work-Stealing Deque Trace
+// One single-writer ring per thread of push, pop, steal, failed-steal and
+// idle events, exported as Chrome trace JSON (chrome://tracing,
+// ui.perfetto.dev). Recording is off until ws_trace_start; a disabled hook
+// is one relaxed load and a branch. RTKA_TRACE_DISABLE compiles the hooks
+// out, as it does for the RTKA-ML recorder (rtka_trace.h). Export and
+// clear while no thread is recording.
+typedef enum {
+    WS_TRACE_PUSH,          // Instant: arg = deque size after the push
+    WS_TRACE_POP,           // Instant: own deque gave a task
+    WS_TRACE_STEAL,         // Instant: arg = victim thread
+    WS_TRACE_STEAL_FAIL,    // Instant: a sweep over every victim came back empty
+    WS_TRACE_IDLE,          // Span: worker asleep with no work in sight
+    WS_TRACE_EVENT_COUNT
+} ws_trace_event_t;
+
+#define WS_TRACE_RING_EVENTS 65536U
+#define WS_TRACE_MAX_THREADS 256U
+
+typedef struct {
+    uint64_t start_ns;
+    uint32_t dur_ns;        // 0 for instants
+    uint16_t event;
+    uint16_t arg;
+} ws_trace_record_t;
+
+typedef struct {
+    ws_trace_record_t events[WS_TRACE_RING_EVENTS];
+    uint64_t written;       // Owner only; the newest WS_TRACE_RING_EVENTS are held
+    uint32_t tid;
+} ws_trace_ring_t;
+
+static _Atomic(bool) ws_trace_on = false;
+static _Atomic(uint32_t) ws_trace_thread_count = 0U;
+static ws_trace_ring_t* _Atomic ws_trace_rings[WS_TRACE_MAX_THREADS];
+
+static void ws_trace_start(void) {
+    atomic_store_explicit(&ws_trace_on, true, memory_order_release);
+}
+
+static void ws_trace_stop(void) {
+    atomic_store_explicit(&ws_trace_on, false, memory_order_release);
+}
+
+// Drop every ring's events; rings stay registered to their threads
+static void ws_trace_clear(void) {
+    uint32_t n = atomic_load_explicit(&ws_trace_thread_count, memory_order_acquire);
+    for (uint32_t i = 0U; i < n && i < WS_TRACE_MAX_THREADS; i++) {
+        ws_trace_ring_t* ring = atomic_load_explicit(&ws_trace_rings[i], memory_order_acquire);
+        if (ring) ring->written = 0U;
+    }
+}
+
+#ifndef RTKA_TRACE_DISABLE
+static const char* const ws_trace_names[WS_TRACE_EVENT_COUNT] = {
+    "deque_push", "deque_pop", "deque_steal", "deque_steal_fail", "worker_idle"
+};
+
+static _Thread_local ws_trace_ring_t* ws_trace_local = NULL;
+
+static uint64_t ws_trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void ws_trace_record(ws_trace_event_t event, uint64_t start_ns, uint64_t end_ns, uint32_t arg) {
+    ws_trace_ring_t* ring = ws_trace_local;
+    if (UNLIKELY(!ring)) {
+        uint32_t slot = atomic_fetch_add_explicit(&ws_trace_thread_count, 1U, memory_order_relaxed);
+        if (slot >= WS_TRACE_MAX_THREADS) return;
+        ring = calloc(1U, sizeof(ws_trace_ring_t));
+        if (!ring) return;
+        ring->tid = slot + 1U;
+        atomic_store_explicit(&ws_trace_rings[slot], ring, memory_order_release);
+        ws_trace_local = ring;
+    }
+    ws_trace_record_t* r = &ring->events[ring->written % WS_TRACE_RING_EVENTS];
+    r->start_ns = start_ns;
+    r->dur_ns = (uint32_t)(end_ns - start_ns);
+    r->event = (uint16_t)event;
+    r->arg = (uint16_t)(arg > UINT16_MAX ? UINT16_MAX : arg);
+    ring->written++;
+}
+
+static ALWAYS_INLINE bool ws_trace_active(void) {
+    return atomic_load_explicit(&ws_trace_on, memory_order_relaxed);
+}
+
+static ALWAYS_INLINE uint64_t ws_trace_begin(void) {
+    return ws_trace_active() ? ws_trace_now_ns() : 0U;
+}
+
+static ALWAYS_INLINE void ws_trace_end(ws_trace_event_t event, uint64_t start_ns, uint32_t arg) {
+    if (start_ns && ws_trace_active()) ws_trace_record(event, start_ns, ws_trace_now_ns(), arg);
+}
+
+static ALWAYS_INLINE void ws_trace_instant(ws_trace_event_t event, uint32_t arg) {
+    if (ws_trace_active()) {
+        uint64_t now = ws_trace_now_ns();
+        ws_trace_record(event, now, now, arg);
+    }
+}
+// Held events of one kind across all rings
+static uint64_t ws_trace_count(ws_trace_event_t event) {
+    uint64_t count = 0U;
+    uint32_t n = atomic_load_explicit(&ws_trace_thread_count, memory_order_acquire);
+    for (uint32_t i = 0U; i < n && i < WS_TRACE_MAX_THREADS; i++) {
+        const ws_trace_ring_t* ring = atomic_load_explicit(&ws_trace_rings[i], memory_order_acquire);
+        if (!ring) continue;
+        uint64_t held = ring->written < WS_TRACE_RING_EVENTS ? ring->written : WS_TRACE_RING_EVENTS;
+        for (uint64_t k = ring->written - held; k < ring->written; k++) {
+            count += ring->events[k % WS_TRACE_RING_EVENTS].event == (uint16_t)event;
+        }
+    }
+    return count;
+}
+
+// Chrome trace event JSON, oldest held event first per thread; false on I/O failure
+static bool ws_trace_write(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    uint32_t n = atomic_load_explicit(&ws_trace_thread_count, memory_order_acquire);
+    for (uint32_t i = 0U; i < n && i < WS_TRACE_MAX_THREADS; i++) {
+        const ws_trace_ring_t* ring = atomic_load_explicit(&ws_trace_rings[i], memory_order_acquire);
+        if (!ring) continue;
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                   "\"args\":{\"name\":\"%s %u\"}}",
+                first ? "" : ",\n", ring->tid, ring->tid == 1U ? "main" : "thread", ring->tid);
+        first = false;
+        uint64_t held = ring->written < WS_TRACE_RING_EVENTS ? ring->written : WS_TRACE_RING_EVENTS;
+        for (uint64_t k = ring->written - held; k < ring->written; k++) {
+            const ws_trace_record_t* r = &ring->events[k % WS_TRACE_RING_EVENTS];
+            if (r->event == WS_TRACE_IDLE) {
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"deque\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                           "\"ts\":%.3f,\"dur\":%.3f}",
+                        ws_trace_names[r->event], ring->tid, (double)r->start_ns * 1e-3, (double)r->dur_ns * 1e-3);
+            } else {
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"deque\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,"
+                           "\"tid\":%u,\"ts\":%.3f,\"args\":{\"arg\":%u}}",
+                        ws_trace_names[r->event], ring->tid, (double)r->start_ns * 1e-3, r->arg);
+            }
+        }
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+#else
+static ALWAYS_INLINE uint64_t ws_trace_begin(void) { return 0U; }
+static ALWAYS_INLINE void ws_trace_end(ws_trace_event_t event, uint64_t start_ns, uint32_t arg) {
+    (void)event; (void)start_ns; (void)arg;
+}
+static ALWAYS_INLINE void ws_trace_instant(ws_trace_event_t event, uint32_t arg) {
+    (void)event; (void)arg;
+}
+#endif // RTKA_TRACE_DISABLE
+
 // Work-Stealing Deque
 #define DEQUE_CAPACITY 1024U
 #define DEQUE_MASK (DEQUE_CAPACITY - 1U)
 
+// Slots are atomic: a thief reads one concurrently with the owner's push.
+// top (thieves) and bottom (owner) sit on separate lines. The library
+// version with growth is the per-worker deque in RTKA-ML's rtka_threadpool.c;
+// trees here are capped at 1023 nodes by subtree_size, so the fixed
+// capacity cannot overflow.
 typedef struct {
-    expr_node_t** tasks CACHE_ALIGN;
-    _Atomic(int64_t) top;
-    _Atomic(int64_t) bottom;
+    _Atomic(expr_node_t*)* tasks CACHE_ALIGN;
     size_t capacity;
+    _Atomic(int64_t) top CACHE_ALIGN;
+    _Atomic(int64_t) bottom CACHE_ALIGN;
 } ws_deque_t;
 
 static ws_deque_t* deque_create(size_t capacity) {
@@ -506,9 +2184,9 @@ static ws_deque_t* deque_create(size_t capacity) {
     if (UNLIKELY(!deque)) return NULL;
     deque->tasks =
 #ifdef _GNU_SOURCE
-    (numa_available() >= 0) ? numa_alloc_onnode(capacity * sizeof(expr_node_t*), numa_node_of_cpu(sched_getcpu())) :
+    (numa_available() >= 0) ? numa_alloc_onnode(capacity * sizeof(_Atomic(expr_node_t*)), numa_node_of_cpu(sched_getcpu())) :
 #endif
-    calloc(capacity, sizeof(expr_node_t*));
+    calloc(capacity, sizeof(_Atomic(expr_node_t*)));
     if (UNLIKELY(!deque->tasks)) {
         free(deque);
         return NULL;
@@ -524,7 +2202,7 @@ static void deque_destroy(ws_deque_t* deque) {
 #ifdef _GNU_SOURCE
     if (numa_available() >= 0) {
         if (deque->tasks) {
-            numa_free(deque->tasks, deque->capacity * sizeof(expr_node_t*));
+            numa_free(deque->tasks, deque->capacity * sizeof(_Atomic(expr_node_t*)));
         }
         numa_free(deque, sizeof(ws_deque_t));
     } else
@@ -538,7 +2216,7 @@ static void deque_destroy(ws_deque_t* deque) {
 static void deque_push_bottom(ws_deque_t* restrict deque, expr_node_t* task) {
     if (UNLIKELY(!deque || !task)) return;
     int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
-    deque->tasks[(size_t)b & DEQUE_MASK] = task;
+    atomic_store_explicit(&deque->tasks[(size_t)b & DEQUE_MASK], task, memory_order_relaxed);
     atomic_thread_fence(memory_order_release);
     atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
 }
@@ -551,7 +2229,7 @@ static expr_node_t* deque_pop_bottom(ws_deque_t* restrict deque) {
 
     int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
     if (t <= b) {
-        expr_node_t* task = deque->tasks[(size_t)b & DEQUE_MASK];
+        expr_node_t* task = atomic_load_explicit(&deque->tasks[(size_t)b & DEQUE_MASK], memory_order_relaxed);
         if (t == b) {
             int64_t expected = t;
             if (!atomic_compare_exchange_strong_explicit(&deque->top, &expected, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
@@ -573,7 +2251,7 @@ static expr_node_t* deque_steal(ws_deque_t* restrict deque) {
     int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
 
     if (t < b) {
-        expr_node_t* task = deque->tasks[(size_t)t & DEQUE_MASK];
+        expr_node_t* task = atomic_load_explicit(&deque->tasks[(size_t)t & DEQUE_MASK], memory_order_relaxed);
         int64_t expected = t;
         if (atomic_compare_exchange_strong_explicit(&deque->top, &expected, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
             return task;
@@ -642,17 +2320,21 @@ static void* worker_thread(void* arg) {
 
     while (!atomic_load_explicit(ctx->should_terminate, memory_order_acquire)) {
         expr_node_t* node = deque_pop_bottom(ctx->local_deque);
-        if (!node) {
+        if (node) {
+            ws_trace_instant(WS_TRACE_POP, 0U);
+        } else {
             bool stole = false;
             for (int j = 0; j < ctx->num_threads; j++) {
                 if (j == ctx->thread_id) continue;
                 node = deque_steal(ctx->all_deques[j]);
                 if (node) {
+                    ws_trace_instant(WS_TRACE_STEAL, (uint32_t)j);
                     stole = true;
                     break;
                 }
             }
             if (!stole) {
+                ws_trace_instant(WS_TRACE_STEAL_FAIL, 0U);
                 // No work available, check if others are done
                 if (atomic_load_explicit(ctx->active_workers, memory_order_acquire) == 1) {
                     // I'm the last active worker, signal termination
@@ -661,8 +2343,10 @@ static void* worker_thread(void* arg) {
                 }
                 // Sleep briefly
                 atomic_fetch_sub(ctx->active_workers, 1);
+                uint64_t idle = ws_trace_begin();
                 struct timespec ts = {.tv_sec = 0, .tv_nsec = 10000000L};  // 10ms
                 nanosleep(&ts, NULL);
+                ws_trace_end(WS_TRACE_IDLE, idle, 0U);
                 atomic_fetch_add(ctx->active_workers, 1);
                 continue;
             }
@@ -773,6 +2457,8 @@ static void enqueue_tree_postorder(ws_deque_t* deque, expr_node_t* node) {
     enqueue_tree_postorder(deque, node->left);
     enqueue_tree_postorder(deque, node->right);
     deque_push_bottom(deque, node);
+    ws_trace_instant(WS_TRACE_PUSH, (uint32_t)(atomic_load_explicit(&deque->bottom, memory_order_relaxed) -
+                                               atomic_load_explicit(&deque->top, memory_order_relaxed)));
 }
 
 rtka_value_t rtka_evaluate_parallel(expr_node_t* root, float threshold, int num_threads) {
@@ -987,6 +2673,678 @@ static void test_parallel_tree(void) {
     free(left); free(right); free(root);
 }
 
+
+// Deterministic generator so tree tests leave rand() and the regression stats untouched
+static uint32_t test_lcg(uint32_t* state) {
+    *state = *state * 1664525U + 1013904223U;
+    return *state >> 8;
+}
+
+static expr_node_t* build_random_tree(uint32_t depth, uint32_t* seed) {
+    expr_node_t* node = calloc(1, sizeof(expr_node_t));
+    if (!node) return NULL;
+    if (depth == 0U) {
+        node->bits.op = OP_VALUE;
+        node->bits.value = (int32_t)(test_lcg(seed) % 3U) - 1;
+        node->confidence = 0.2f + 0.8f * (float)(test_lcg(seed) % 1000U) / 1000.0f;
+        return node;
+    }
+    uint32_t r = test_lcg(seed) % 16U;
+    node->bits.op = (r == 0U) ? OP_NOT : (r < 7U ? OP_AND : (r < 13U ? OP_OR : (r < 15U ? OP_IMPLY : OP_EQUIV)));
+    node->left = build_random_tree(depth - 1U, seed);
+    if (node->bits.op != OP_NOT) node->right = build_random_tree(depth - 1U, seed);
+    return node;
+}
+
+static void free_tree(expr_node_t* node) {
+    if (!node) return;
+    free_tree(node->left);
+    free_tree(node->right);
+    free(node);
+}
+
+// Recursive reference with rtka_evaluate_parallel semantics
+static rtka_value_t reference_eval(const expr_node_t* node, float* conf) {
+    if (!node) {
+        *conf = 0.0f;
+        return RTKA_UNKNOWN;
+    }
+    if (node->bits.op == OP_VALUE) {
+        *conf = node->confidence;
+        return apply_threshold_coercion(node->bits.value, node->confidence);
+    }
+    float lc, rc;
+    rtka_value_t lv = reference_eval(node->left, &lc);
+    rtka_value_t rv = reference_eval(node->right, &rc);
+    rtka_value_t v = RTKA_UNKNOWN;
+    switch (node->bits.op) {
+        case OP_AND:   v = rtka_and(lv, rv);   *conf = conf_and(lc, rc);   break;
+        case OP_OR:    v = rtka_or(lv, rv);    *conf = conf_or(lc, rc);    break;
+        case OP_NOT:   v = rtka_not(lv);       *conf = conf_not(lc);       break;
+        case OP_IMPLY: v = rtka_imply(lv, rv); *conf = conf_imply(lc, rc); break;
+        case OP_EQUIV: v = rtka_equiv(lv, rv); *conf = conf_equiv(lc, rc); break;
+        default:       *conf = 0.0f;           return RTKA_UNKNOWN;
+    }
+    return apply_threshold_coercion(v, *conf);
+}
+
+static void test_compiled_program(void) {
+    uint32_t seed = 7U;
+    expr_node_t* root = build_random_tree(12U, &seed);
+    assert(root);
+
+    rtka_program_t* prog = rtka_compile(root, 4);
+    assert(prog);
+
+    for (uint32_t round = 0U; round < 50U; round++) {
+        // Rewrite a few inputs through each path
+        for (uint32_t k = 0U; k < 8U; k++) {
+            uint32_t leaf = test_lcg(&seed) % prog->num_leaves;
+            prog->leaf_nodes[leaf]->bits.value = (int32_t)(test_lcg(&seed) % 3U) - 1;
+            prog->leaf_nodes[leaf]->confidence = (float)(test_lcg(&seed) % 1000U) / 1000.0f;
+        }
+        rtka_program_sync_leaves(prog);
+        rtka_program_set_leaf(prog, round % prog->num_leaves, RTKA_TRUE, 0.95f);
+        prog->leaf_nodes[round % prog->num_leaves]->bits.value = RTKA_TRUE;
+        prog->leaf_nodes[round % prog->num_leaves]->confidence = 0.95f;
+
+        float conf = 0.0f, ref_conf = 0.0f;
+        rtka_value_t v = rtka_program_run(prog, &conf);
+        rtka_value_t ref = reference_eval(root, &ref_conf);
+        assert(v == ref);
+        assert(fabsf(conf - ref_conf) <= 1e-6f);
+    }
+
+    const uint32_t runs = 2000U;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t r = 0U; r < runs; r++) {
+        (void)rtka_program_run(prog, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / runs;
+
+    printf("Compiled tree test passed (%u nodes, %.1f ns/eval)\n", prog->num_instr, ns);
+    rtka_program_destroy(prog);
+    free_tree(root);
+}
+
+static void test_incremental_program(void) {
+    uint32_t seed = 23U;
+    expr_node_t* root = build_random_tree(12U, &seed);
+    assert(root);
+
+    rtka_program_t* prog = rtka_compile(root, 1);
+    assert(prog);
+    (void)rtka_program_run(prog, NULL);
+
+    const uint32_t updates = 1000U;
+    uint64_t visits = 0U;
+    for (uint32_t u = 0U; u < updates; u++) {
+        uint32_t leaf = test_lcg(&seed) % prog->num_leaves;
+        rtka_value_t value = (rtka_value_t)((int32_t)(test_lcg(&seed) % 3U) - 1);
+        // Every fourth update keeps the confidence: value-only flips can be absorbed
+        float conf = (u % 4U == 0U) ? prog->leaf_confs[leaf]
+                                    : (float)(test_lcg(&seed) % 1000U) / 1000.0f;
+        prog->leaf_nodes[leaf]->bits.value = value;
+        prog->leaf_nodes[leaf]->confidence = conf;
+
+        float inc_conf = 0.0f, ref_conf = 0.0f;
+        rtka_value_t v = rtka_program_update_leaf(prog, leaf, value, conf, &inc_conf);
+        rtka_value_t ref = reference_eval(root, &ref_conf);
+        assert(v == ref);
+        assert(fabsf(inc_conf - ref_conf) <= 1e-6f);
+        visits += prog->last_update_visits;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t u = 0U; u < updates; u++) {
+        uint32_t leaf = test_lcg(&seed) % prog->num_leaves;
+        (void)rtka_program_update_leaf(prog, leaf, (rtka_value_t)((int32_t)(u % 3U) - 1),
+                                       prog->leaf_confs[leaf], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / updates;
+
+    printf("Incremental tree test passed (%u nodes, %.1f nodes/update, %.1f ns/update)\n",
+           prog->num_instr, (double)visits / updates, ns);
+    rtka_program_destroy(prog);
+    free_tree(root);
+}
+
+static void test_batch_program(void) {
+    uint32_t seed = 11U;
+    expr_node_t* root = build_random_tree(8U, &seed);
+    assert(root);
+
+    rtka_program_t* prog = rtka_compile(root, 1);
+    assert(prog);
+
+    // Ragged last tile
+    const uint32_t rows = 3U * PROGRAM_BATCH_TILE + 37U;
+    const uint32_t leaves = prog->num_leaves;
+    int8_t* in_v = malloc((size_t)leaves * rows);
+    float* in_c = malloc((size_t)leaves * rows * sizeof(float));
+    int8_t* out_v = malloc(rows);
+    float* out_c = malloc(rows * sizeof(float));
+    assert(in_v && in_c && out_v && out_c);
+
+    for (size_t i = 0U; i < (size_t)leaves * rows; i++) {
+        in_v[i] = (int8_t)((int32_t)(test_lcg(&seed) % 3U) - 1);
+        in_c[i] = (float)(test_lcg(&seed) % 1000U) / 1000.0f;
+    }
+
+    bool ok = rtka_program_run_batch(prog, in_v, in_c, rows, out_v, out_c);
+    assert(ok);
+
+    for (uint32_t r = 0U; r < rows; r++) {
+        for (uint32_t l = 0U; l < leaves; l++) {
+            prog->leaf_nodes[l]->bits.value = in_v[(size_t)l * rows + r];
+            prog->leaf_nodes[l]->confidence = in_c[(size_t)l * rows + r];
+        }
+        float ref_conf = 0.0f;
+        rtka_value_t ref = reference_eval(root, &ref_conf);
+        assert((rtka_value_t)out_v[r] == ref);
+        assert(fabsf(out_c[r] - ref_conf) <= 1e-6f);
+    }
+
+    const uint32_t reps = 200U;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t k = 0U; k < reps; k++) {
+        (void)rtka_program_run_batch(prog, in_v, in_c, rows, out_v, out_c);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) /
+                ((double)reps * rows);
+
+    printf("Batch tree test passed (%u nodes, %u rows, %u columns, %.1f ns/row)\n",
+           prog->num_instr, rows, prog->batch_columns, ns);
+    free(in_v);
+    free(in_c);
+    free(out_v);
+    free(out_c);
+    rtka_program_destroy(prog);
+    free_tree(root);
+}
+
+static void test_short_circuit_program(void) {
+    uint32_t seed = 47U;
+    bool adaptive = g_threshold.adaptive_enabled;
+    g_threshold.adaptive_enabled = false;
+
+    // Without coercion the value is the full evaluation's
+    expr_node_t* tree = build_random_tree(10U, &seed);
+    assert(tree);
+    rtka_program_t* prog = rtka_compile(tree, 1);
+    assert(prog);
+    for (uint32_t round = 0U; round < 4U * PROGRAM_REORDER_INTERVAL; round++) {
+        for (uint32_t l = 0U; l < prog->num_leaves; l++) {
+            rtka_program_set_leaf(prog, l, (rtka_value_t)((int32_t)(test_lcg(&seed) % 3U) - 1),
+                                  (float)(test_lcg(&seed) % 1000U) / 1000.0f);
+        }
+        rtka_value_t v = rtka_program_run_short(prog, NULL);
+        assert(v == rtka_program_run(prog, NULL));
+        assert(prog->last_short_visits <= prog->num_instr);
+    }
+    rtka_program_destroy(prog);
+    free_tree(tree);
+
+    // A large, rarely FALSE subtree ANDed with a cheap, mostly FALSE leaf
+    // that starts out second: the order flips and the large side is skipped
+    expr_node_t* root = calloc(1, sizeof(expr_node_t));
+    expr_node_t* guard = calloc(1, sizeof(expr_node_t));
+    assert(root && guard);
+    root->bits.op = OP_AND;
+    root->left = build_random_tree(9U, &seed);
+    root->right = guard;
+    guard->bits.op = OP_VALUE;
+    assert(root->left);
+
+    prog = rtka_compile(root, 1);
+    assert(prog);
+    const uint32_t guard_leaf = prog->num_leaves - 1U;
+    const uint32_t intervals = 8U;
+    uint64_t first_visits = 0U, last_visits = 0U;
+    for (uint32_t round = 0U; round < intervals * PROGRAM_REORDER_INTERVAL; round++) {
+        for (uint32_t l = 0U; l < guard_leaf; l++) {
+            rtka_program_set_leaf(prog, l, (test_lcg(&seed) % 8U) ? RTKA_TRUE : RTKA_UNKNOWN, 0.9f);
+        }
+        rtka_program_set_leaf(prog, guard_leaf, (test_lcg(&seed) % 10U) ? RTKA_FALSE : RTKA_TRUE, 0.9f);
+        rtka_value_t v = rtka_program_run_short(prog, NULL);
+        assert(v == rtka_program_run(prog, NULL));
+        if (round < PROGRAM_REORDER_INTERVAL) first_visits += prog->last_short_visits;
+        if (round >= (intervals - 1U) * PROGRAM_REORDER_INTERVAL) last_visits += prog->last_short_visits;
+    }
+    assert(prog->short_reorders > 0U);
+    assert(last_visits * 4U < first_visits);
+
+    const uint32_t runs = 2000U;
+    struct timespec t0, t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t r = 0U; r < runs; r++) {
+        rtka_program_set_leaf(prog, guard_leaf, (r % 10U) ? RTKA_FALSE : RTKA_TRUE, 0.9f);
+        (void)rtka_program_run(prog, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (uint32_t r = 0U; r < runs; r++) {
+        rtka_program_set_leaf(prog, guard_leaf, (r % 10U) ? RTKA_FALSE : RTKA_TRUE, 0.9f);
+        (void)rtka_program_run_short(prog, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    double full_ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / runs;
+    double short_ns = ((double)(t2.tv_sec - t1.tv_sec) * 1e9 + (double)(t2.tv_nsec - t1.tv_nsec)) / runs;
+
+    printf("Short-circuit test passed (%u nodes, %.1f -> %.1f nodes/run, %u reorders, %.1f ns vs %.1f full)\n",
+           prog->num_instr, (double)first_visits / PROGRAM_REORDER_INTERVAL,
+           (double)last_visits / PROGRAM_REORDER_INTERVAL, prog->short_reorders, short_ns, full_ns);
+    rtka_program_destroy(prog);
+    free_tree(root);
+    g_threshold.adaptive_enabled = adaptive;
+}
+
+// Threshold learning state, restored around tests that learn
+typedef struct {
+    float theta, alpha, beta, x0;
+#ifdef PARALLEL_ENABLED
+    threshold_local_t local;
+#endif
+} threshold_snapshot_t;
+
+static threshold_snapshot_t threshold_save(void) {
+    threshold_snapshot_t snap;
+#ifdef PARALLEL_ENABLED
+    snap.theta = atomic_load(&g_threshold.theta);
+    snap.alpha = atomic_load(&g_threshold.alpha);
+    snap.beta = atomic_load(&g_threshold.beta);
+    snap.x0 = atomic_load(&g_threshold.x0);
+    snap.local = tl_threshold;
+#else
+    snap.theta = g_threshold.theta;
+    snap.alpha = g_threshold.alpha;
+    snap.beta = g_threshold.beta;
+    snap.x0 = g_threshold.x0;
+#endif
+    return snap;
+}
+
+static void threshold_restore(const threshold_snapshot_t* snap) {
+#ifdef PARALLEL_ENABLED
+    atomic_store(&g_threshold.theta, snap->theta);
+    atomic_store(&g_threshold.alpha, snap->alpha);
+    atomic_store(&g_threshold.beta, snap->beta);
+    atomic_store(&g_threshold.x0, snap->x0);
+    tl_threshold = snap->local;
+    build_sigmoid_lut(atomic_load(&sigmoid_lut_live) ^ 1U);
+#else
+    g_threshold.theta = snap->theta;
+    g_threshold.alpha = snap->alpha;
+    g_threshold.beta = snap->beta;
+    g_threshold.x0 = snap->x0;
+    build_sigmoid_lut(sigmoid_lut_live ^ 1U);
+#endif
+}
+
+static void collect_postorder(const expr_node_t* node, int8_t* values, float* confs, uint32_t* n) {
+    if (!node) return;
+    if (node->bits.op != OP_VALUE) {
+        collect_postorder(node->left, values, confs, n);
+        collect_postorder(node->right, values, confs, n);
+    }
+    values[*n] = (int8_t)node->bits.value;
+    confs[*n] = node->confidence;
+    (*n)++;
+}
+
+static void test_packed_tree(void) {
+    uint32_t seed = 67U;
+    expr_node_t* root = build_random_tree(14U, &seed);
+    assert(root);
+    rtka_packed_tree_t* packed = rtka_pack_tree(root);
+    assert(packed);
+    const uint32_t n = packed->count - 1U;
+
+    // Compiled and batch paths from the packed array
+    rtka_program_t* from_tree = rtka_compile(root, 1);
+    rtka_program_t* from_packed = rtka_compile_packed(packed, 1);
+    assert(from_tree && from_packed && from_packed->num_instr == n);
+    assert(from_packed->num_leaves == from_tree->num_leaves);
+    float tree_conf = 0.0f, packed_conf = 0.0f;
+    assert(rtka_program_run(from_packed, &packed_conf) == rtka_program_run(from_tree, &tree_conf));
+    assert(packed_conf == tree_conf);
+    int8_t out_tree[2], out_packed[2];
+    float conf_tree[2], conf_packed[2];
+    int8_t* bv = malloc((size_t)from_tree->num_leaves * 2U);
+    float* bc = malloc((size_t)from_tree->num_leaves * 2U * sizeof(float));
+    assert(bv && bc);
+    for (uint32_t i = 0U; i < from_tree->num_leaves * 2U; i++) {
+        bv[i] = (int8_t)((int32_t)(test_lcg(&seed) % 3U) - 1);
+        bc[i] = (float)(test_lcg(&seed) % 1000U) / 1000.0f;
+    }
+    assert(rtka_program_run_batch(from_tree, bv, bc, 2U, out_tree, conf_tree));
+    assert(rtka_program_run_batch(from_packed, bv, bc, 2U, out_packed, conf_packed));
+    assert(memcmp(out_tree, out_packed, 2U) == 0 && memcmp(conf_tree, conf_packed, sizeof(conf_tree)) == 0);
+    free(bv);
+    free(bc);
+    rtka_program_destroy(from_tree);
+    rtka_program_destroy(from_packed);
+
+    // Scalar pass: identical node by node, learning included
+    int8_t* values = malloc(n + 1U);
+    float* confs = malloc((n + 1U) * sizeof(float));
+    assert(values && confs);
+    const threshold_snapshot_t snap = threshold_save();
+    rtka_value_t linked = rtka_evaluate_scalar(root, 0.5f);
+    threshold_snapshot_t after = threshold_save();
+    uint32_t count = 0U;
+    collect_postorder(root, values + 1, confs + 1, &count);
+    assert(count == n);
+    threshold_restore(&snap);
+    assert(rtka_evaluate_packed(packed, 0.5f) == linked);
+    threshold_snapshot_t packed_after = threshold_save();
+    assert(after.theta == packed_after.theta && after.x0 == packed_after.x0);
+    for (uint32_t i = 1U; i <= n; i++) {
+        assert(packed->nodes[i].value == values[i]);
+        assert(packed->nodes[i].confidence == confs[i]);
+    }
+
+    const uint32_t runs = 20U;
+    struct timespec t0, t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t r = 0U; r < runs; r++) (void)rtka_evaluate_scalar(root, 0.5f);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (uint32_t r = 0U; r < runs; r++) (void)rtka_evaluate_packed(packed, 0.5f);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    threshold_restore(&snap);
+    double linked_ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / ((double)runs * n);
+    double packed_ns = ((double)(t2.tv_sec - t1.tv_sec) * 1e9 + (double)(t2.tv_nsec - t1.tv_nsec)) / ((double)runs * n);
+
+    printf("Packed tree test passed (%u nodes, %zu -> %zu bytes/node, %.2f -> %.2f ns/node)\n",
+           n, sizeof(expr_node_t), sizeof(packed_node_t), linked_ns, packed_ns);
+    free(values);
+    free(confs);
+    rtka_packed_destroy(packed);
+    free_tree(root);
+}
+
+// Sensor rule of six inputs, written once as a tree and once as a fixed rule
+#define RULE_INTRUSION(F) F(rule_intrusion,                                               \
+    RULE_OR(RULE_AND(RULE_VAR(0), RULE_IMPLY(RULE_VAR(1), RULE_VAR(2))), RULE_AND(RULE_EQUIV(RULE_VAR(3), RULE_VAR(4)), RULE_NOT(RULE_VAR(5)))))
+#define RULE_TEXT(name, expr) #expr
+
+RULE_INTRUSION(RTKA_RULE)
+
+// An UNKNOWN operand of OR with NOT of itself: folds to the OR of the rest
+RTKA_RULE(rule_folded, RULE_OR(RULE_VAR(0), RULE_NOT(RULE_CONST(RTKA_UNKNOWN, 0.0f))))
+
+static expr_node_t* test_node(uint32_t op, expr_node_t* left, expr_node_t* right) {
+    expr_node_t* node = calloc(1, sizeof(expr_node_t));
+    assert(node);
+    node->bits.op = op;
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+static void test_fixed_rules(void) {
+    expr_node_t* root = test_node(OP_OR,
+        test_node(OP_AND, test_node(OP_VALUE, NULL, NULL),
+                  test_node(OP_IMPLY, test_node(OP_VALUE, NULL, NULL), test_node(OP_VALUE, NULL, NULL))),
+        test_node(OP_AND,
+                  test_node(OP_EQUIV, test_node(OP_VALUE, NULL, NULL), test_node(OP_VALUE, NULL, NULL)),
+                  test_node(OP_NOT, test_node(OP_VALUE, NULL, NULL), NULL)));
+
+    // The generator reproduces the rule text
+    char text[512];
+    FILE* out = fmemopen(text, sizeof(text), "w");
+    assert(out);
+    uint32_t leaves = rtka_rule_print(root, out);
+    fclose(out);
+    assert(leaves == 6U);
+    assert(strcmp(text, RULE_INTRUSION(RULE_TEXT)) == 0);
+
+    rtka_program_t* prog = rtka_compile(root, 1);
+    assert(prog && prog->num_leaves == leaves);
+
+    uint32_t seed = 31U;
+    const batch_coerce_t co = batch_coerce_load();
+    for (uint32_t round = 0U; round < 5000U; round++) {
+        for (uint32_t l = 0U; l < leaves; l++) {
+            rtka_value_t v = (rtka_value_t)((int32_t)(test_lcg(&seed) % 3U) - 1);
+            float c = (float)(test_lcg(&seed) % 1000U) / 1000.0f;
+            prog->leaf_nodes[l]->bits.value = v;
+            prog->leaf_nodes[l]->confidence = c;
+            rtka_program_set_leaf(prog, l, v, c);
+        }
+        float conf = 0.0f, ref_conf = 0.0f;
+        rtka_value_t v = rule_intrusion(prog->leaf_values, prog->leaf_confs, &co, &conf);
+        rtka_value_t ref = reference_eval(root, &ref_conf);
+        assert(v == ref);
+        assert(fabsf(conf - ref_conf) <= 1e-6f);
+
+        float fold_conf = 0.0f;
+        rtka_value_t folded = rule_folded(prog->leaf_values, prog->leaf_confs, &co, &fold_conf);
+        rtka_value_t lead = apply_threshold_coercion(prog->leaf_values[0], prog->leaf_confs[0]);
+        assert(folded == apply_threshold_coercion(rtka_or(lead, RTKA_UNKNOWN), fold_conf));
+    }
+
+    const uint32_t runs = 1000000U;
+    int32_t sink = 0;
+    struct timespec t0, t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t r = 0U; r < runs; r++) {
+        prog->leaf_values[r % leaves] = (rtka_value_t)((int32_t)(r % 3U) - 1);
+        sink += rule_intrusion(prog->leaf_values, prog->leaf_confs, &co, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (uint32_t r = 0U; r < runs; r++) {
+        prog->leaf_values[r % leaves] = (rtka_value_t)((int32_t)(r % 3U) - 1);
+        sink += rtka_program_run(prog, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    double rule_ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / runs;
+    double prog_ns = ((double)(t2.tv_sec - t1.tv_sec) * 1e9 + (double)(t2.tv_nsec - t1.tv_nsec)) / runs;
+
+    printf("Fixed rule test passed (%u nodes, %.1f ns/eval vs %.1f compiled, check %d)\n",
+           prog->num_instr, rule_ns, prog_ns, sink & 1);
+    rtka_program_destroy(prog);
+    free_tree(root);
+}
+
+// Random tree over a pool of inputs; leaf k (left to right) reads ids[k]
+static expr_node_t* build_input_tree(uint32_t depth, uint32_t inputs, uint32_t* seed,
+                                     uint32_t* ids, uint32_t* num_ids) {
+    if (depth == 0U) {
+        expr_node_t* leaf = calloc(1, sizeof(expr_node_t));
+        assert(leaf);
+        leaf->bits.op = OP_VALUE;
+        ids[(*num_ids)++] = test_lcg(seed) % inputs;
+        return leaf;
+    }
+    uint32_t r = test_lcg(seed) % 16U;
+    uint32_t op = (r == 0U) ? OP_NOT : (r < 7U ? OP_AND : (r < 13U ? OP_OR : (r < 15U ? OP_IMPLY : OP_EQUIV)));
+    expr_node_t* left = build_input_tree(depth - 1U, inputs, seed, ids, num_ids);
+    expr_node_t* right = (op != OP_NOT) ? build_input_tree(depth - 1U, inputs, seed, ids, num_ids) : NULL;
+    return test_node(op, left, right);
+}
+
+static expr_node_t* copy_input_tree(const expr_node_t* src, const uint32_t* src_ids, uint32_t* pos,
+                                    uint32_t* ids, uint32_t* num_ids) {
+    if (!src) return NULL;
+    if (src->bits.op == OP_VALUE) {
+        expr_node_t* leaf = calloc(1, sizeof(expr_node_t));
+        assert(leaf);
+        leaf->bits.op = OP_VALUE;
+        ids[(*num_ids)++] = src_ids[(*pos)++];
+        return leaf;
+    }
+    expr_node_t* left = copy_input_tree(src->left, src_ids, pos, ids, num_ids);
+    expr_node_t* right = copy_input_tree(src->right, src_ids, pos, ids, num_ids);
+    return test_node(src->bits.op, left, right);
+}
+
+#define DAG_TEST_RULES 32U
+#define DAG_TEST_INPUTS 24U
+#define DAG_TEST_MAX_LEAVES 256U
+
+// Rules sharing one large sub-rule, as trees and as one DAG
+static void test_shared_dag(void) {
+    uint32_t seed = 59U;
+    uint32_t shared_ids[DAG_TEST_MAX_LEAVES], num_shared = 0U;
+    expr_node_t* shared = build_input_tree(7U, DAG_TEST_INPUTS, &seed, shared_ids, &num_shared);
+
+    expr_node_t* rules[DAG_TEST_RULES];
+    rtka_program_t* progs[DAG_TEST_RULES];
+    uint32_t* ids = malloc(DAG_TEST_RULES * DAG_TEST_MAX_LEAVES * sizeof(uint32_t));
+    uint32_t roots[DAG_TEST_RULES];
+    rtka_dag_t* dag = rtka_dag_create(0U);
+    assert(ids && dag);
+
+    uint32_t tree_nodes = 0U;
+    for (uint32_t r = 0U; r < DAG_TEST_RULES; r++) {
+        uint32_t* rule_ids = ids + (size_t)r * DAG_TEST_MAX_LEAVES;
+        uint32_t n = 0U, pos = 0U;
+        expr_node_t* common = copy_input_tree(shared, shared_ids, &pos, rule_ids, &n);
+        expr_node_t* own = build_input_tree(4U, DAG_TEST_INPUTS, &seed, rule_ids, &n);
+        rules[r] = test_node((r & 1U) ? OP_OR : OP_AND, common, own);
+        progs[r] = rtka_compile(rules[r], 1);
+        roots[r] = rtka_dag_add_tree(dag, rules[r], rule_ids);
+        assert(progs[r] && progs[r]->num_leaves == n && roots[r] != DAG_INVALID);
+        tree_nodes += progs[r]->num_instr;
+    }
+    assert(dag->num_nodes * 4U < tree_nodes);
+
+    for (uint32_t round = 0U; round < 100U; round++) {
+        for (uint32_t i = 0U; i < DAG_TEST_INPUTS; i++) {
+            rtka_dag_set_input(dag, i, (rtka_value_t)((int32_t)(test_lcg(&seed) % 3U) - 1),
+                               (float)(test_lcg(&seed) % 1000U) / 1000.0f);
+        }
+        uint32_t visits = 0U;
+        for (uint32_t r = 0U; r < DAG_TEST_RULES; r++) {
+            const uint32_t* rule_ids = ids + (size_t)r * DAG_TEST_MAX_LEAVES;
+            for (uint32_t l = 0U; l < progs[r]->num_leaves; l++) {
+                rtka_program_set_leaf(progs[r], l, dag->input_values[rule_ids[l]], dag->input_confs[rule_ids[l]]);
+            }
+            float conf = 0.0f, ref_conf = 0.0f;
+            rtka_value_t v = rtka_dag_eval(dag, roots[r], &conf);
+            visits += dag->last_eval_visits;
+            rtka_value_t ref = rtka_program_run(progs[r], &ref_conf);
+            assert(v == ref);
+            assert(fabsf(conf - ref_conf) <= 1e-6f);
+        }
+        // Every node at most once per input change
+        assert(visits < dag->num_nodes);
+        (void)rtka_dag_eval(dag, roots[0], NULL);
+        assert(dag->last_eval_visits == 0U);
+    }
+
+    const uint32_t reps = 200U;
+    struct timespec t0, t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t k = 0U; k < reps; k++) {
+        rtka_dag_set_input(dag, k % DAG_TEST_INPUTS, (rtka_value_t)((int32_t)(k % 3U) - 1), 0.9f);
+        for (uint32_t r = 0U; r < DAG_TEST_RULES; r++) (void)rtka_dag_eval(dag, roots[r], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (uint32_t k = 0U; k < reps; k++) {
+        for (uint32_t r = 0U; r < DAG_TEST_RULES; r++) (void)rtka_program_run(progs[r], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    double dag_ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / reps;
+    double tree_ns = ((double)(t2.tv_sec - t1.tv_sec) * 1e9 + (double)(t2.tv_nsec - t1.tv_nsec)) / reps;
+
+    printf("Shared DAG test passed (%u rules, %u tree nodes -> %u DAG nodes, %.0f ns vs %.0f ns per rule base)\n",
+           DAG_TEST_RULES, tree_nodes, dag->num_nodes - 1U, dag_ns, tree_ns);
+    for (uint32_t r = 0U; r < DAG_TEST_RULES; r++) {
+        rtka_program_destroy(progs[r]);
+        free_tree(rules[r]);
+    }
+    free_tree(shared);
+    free(ids);
+    rtka_dag_destroy(dag);
+}
+
+#ifdef PARALLEL_ENABLED
+#define CONTENTION_THREADS 4U
+#define CONTENTION_CALLS 50000U
+
+// Every node of a parallel evaluation is pushed once and taken once, by a
+// pop or a steal; the export is one JSON document
+static void test_deque_trace(void) {
+    uint32_t seed = 2025U;
+    expr_node_t* root = build_random_tree(7U, &seed);
+    assert(root);
+    ws_trace_clear();
+    ws_trace_start();
+    rtka_value_t parallel = rtka_evaluate_parallel(root, 0.5f, 4);
+    ws_trace_stop();
+    float conf;
+    assert(parallel == reference_eval(root, &conf));
+
+#ifndef RTKA_TRACE_DISABLE
+    uint64_t nodes = root->bits.subtree_size;   // Set by the evaluation
+    uint64_t pushes = ws_trace_count(WS_TRACE_PUSH), pops = ws_trace_count(WS_TRACE_POP);
+    uint64_t steals = ws_trace_count(WS_TRACE_STEAL), fails = ws_trace_count(WS_TRACE_STEAL_FAIL);
+    uint64_t idles = ws_trace_count(WS_TRACE_IDLE);
+    assert(pushes == nodes && pops + steals == nodes);
+    const char* path = "/tmp/rtka_is_deque_trace.json";
+    assert(ws_trace_write(path));
+    printf("Deque trace test passed (%llu nodes: %llu pushes, %llu pops, %llu steals, %llu failed sweeps, "
+           "%llu idle spans -> %s)\n", (unsigned long long)nodes, (unsigned long long)pushes,
+           (unsigned long long)pops, (unsigned long long)steals, (unsigned long long)fails,
+           (unsigned long long)idles, path);
+#else
+    printf("Deque trace test passed (hooks compiled out)\n");
+#endif
+    ws_trace_clear();
+    free_tree(root);
+}
+
+static void* contention_worker(void* arg) {
+    unsigned int seed = (unsigned int)(uintptr_t)arg;
+    for (uint32_t call = 0U; call < CONTENTION_CALLS; call++) {
+        sensor_input_t sensors[NUM_SENSORS];
+        for (uint32_t i = 0U; i < NUM_SENSORS; i++) {
+            double r = (double)rand_r(&seed) / (double)RAND_MAX;
+            sensors[i].detection = (r < 0.35) ? RTKA_FALSE : (r < 0.65 ? RTKA_UNKNOWN : RTKA_TRUE);
+            sensors[i].confidence = (float)(r * 0.8 + 0.2);
+            sensors[i].variance = (float)(r * 0.2);
+        }
+        (void)fuse_sensors_adaptive(sensors, NUM_SENSORS);
+    }
+    merge_threshold_estimator();
+    return NULL;
+}
+
+// Fusion from several threads: per-thread estimators merge every
+// THRESHOLD_MERGE_INTERVAL updates and the LUT rebuilds only on x0 drift
+static void test_threshold_contention(void) {
+    pthread_t threads[CONTENTION_THREADS];
+    float alpha0 = atomic_load(&g_threshold.alpha), beta0 = atomic_load(&g_threshold.beta);
+    uint32_t rebuilds0 = sigmoid_lut_rebuilds;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint32_t started = 0U;
+    for (uint32_t t = 0U; t < CONTENTION_THREADS; t++) {
+        if (pthread_create(&threads[t], NULL, contention_worker, (void*)(uintptr_t)(t + 1U)) != 0) break;
+        started++;
+    }
+    for (uint32_t t = 0U; t < started; t++) pthread_join(threads[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    float theta = atomic_load(&g_threshold.theta);
+    float updates = atomic_load(&g_threshold.alpha) - alpha0 + atomic_load(&g_threshold.beta) - beta0;
+    float calls = (float)(started * CONTENTION_CALLS);
+    double ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / (double)calls;
+    assert(started > 0U && theta > 0.0f && theta < 1.0f);
+    assert(updates > 0.0f && updates <= calls);
+    assert(sigmoid_lut_rebuilds - rebuilds0 < (uint32_t)calls / THRESHOLD_MERGE_INTERVAL + 1U);
+    printf("Threshold contention test passed (%u threads, %.0f updates merged, %u LUT rebuilds, %.1f ns/fusion)\n",
+           started, updates, sigmoid_lut_rebuilds - rebuilds0, ns);
+}
+#endif
+
 int main(void) {
     srand(42U);
     init_sigmoid_lut();
@@ -998,6 +3356,13 @@ int main(void) {
     test_operators();
     test_tree_operations();
     test_parallel_tree();
+    test_compiled_program();
+    test_incremental_program();
+    test_batch_program();
+    test_packed_tree();
+    test_short_circuit_program();
+    test_fixed_rules();
+    test_shared_dag();
 
     uint32_t true_count = 0U, false_count = 0U, unknown_count = 0U;
     double avg_time = 0.0;
@@ -1050,6 +3415,8 @@ int main(void) {
     printf("UNKNOWN rate: %.2f%%\n", (double)unknown_count / (double)trials * 100.0);
 #ifdef PARALLEL_ENABLED
     printf("Parallel: Enabled with fixes.\n");
+    test_threshold_contention();
+    test_deque_trace();
 #else
     printf("Scalar: Enabled.\n");
 #endif
@@ -0,0 +1,483 @@
+/**
+ * File: rtka_pendulum_batch.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * RTKA Batched Pendulum Simulation - Implementation
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial implementation
+ *
+ * VALIDATION STATUS: Lanes checked against the scalar scenario loop
+ */
+
+#include "rtka_pendulum_batch.h"
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define L RTKA_SWEEP_LANES
+#define SWEEP_PI 3.14159265358979323846f
+#define SWEEP_TWO_PI (2.0f * SWEEP_PI)
+
+/* ============================================================================
+ * LANE BLOCK
+ * ============================================================================ */
+
+/**
+ * RTKA_SWEEP_LANES instances in SoA form; every per-step loop runs across
+ * the lanes, so each one compiles to straight-line vector code. Control
+ * maps are stored per mode and selected by each lane's current mode.
+ */
+typedef struct {
+    /* Plant */
+    float theta1[L], omega1[L], theta2[L], omega2[L];
+    float m1[L], m2[L], l1[L], l2[L], g[L], b1[L], b2[L], tau_max[L];
+
+    /* Mode configurations */
+    float confidence_low[4][L], confidence_high[4][L];
+    float u_min[4][L], u_nominal[4][L], u_max[4][L];
+    float gain_increase[4][L], gain_decrease[4][L];
+    float rate_limit[4][L], dwell[4][L];
+
+    /* Controller */
+    int32_t mode[L];
+    float time_in_mode[L];
+    float confidence[L];
+    float output[L];
+    float prev_output[L];
+    float torque[L];
+    uint32_t transitions[L];
+
+    /* Statistics */
+    float energy_sum[L];
+    float max_angle1[L], max_angle2[L];
+    float settle_time[L];
+    uint32_t uncontrollable[L];
+
+    uint64_t rng[L];
+} sweep_block_t;
+
+static inline uint64_t sweep_splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/* xorshift64*, uniform in (0, 1] from the top 24 bits */
+static inline float sweep_uniform(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (float)(((x * 0x2545F4914F6CDD1DULL) >> 40) + 1) * (1.0f / 16777216.0f);
+}
+
+static void sweep_block_load(
+    sweep_block_t* blk,
+    const rtka_pendulum_instance_t* instances,
+    uint32_t n,
+    float jitter
+) {
+    for (uint32_t i = 0; i < L; i++) {
+        /* Padding lanes repeat the last instance and are never reported */
+        const rtka_pendulum_instance_t* in = &instances[i < n ? i : n - 1];
+        const rtka_pendulum_params_t* p = &in->params;
+
+        uint64_t rng = sweep_splitmix64(in->seed);
+        blk->rng[i] = rng ? rng : 0x9E3779B97F4A7C15ULL;
+        float j1 = jitter > 0.0f ? jitter * (2.0f * sweep_uniform(&blk->rng[i]) - 1.0f) : 0.0f;
+        float j2 = jitter > 0.0f ? jitter * (2.0f * sweep_uniform(&blk->rng[i]) - 1.0f) : 0.0f;
+
+        blk->theta1[i] = in->theta1 + j1;
+        blk->theta2[i] = in->theta2 + j2;
+        blk->omega1[i] = in->omega1;
+        blk->omega2[i] = in->omega2;
+        blk->m1[i] = p->m1;
+        blk->m2[i] = p->m2;
+        blk->l1[i] = p->l1;
+        blk->l2[i] = p->l2;
+        blk->g[i] = p->g;
+        blk->b1[i] = p->b1;
+        blk->b2[i] = p->b2;
+        blk->tau_max[i] = p->tau_max;
+
+        for (uint32_t m = 0; m < 4; m++) {
+            const rtka_control_map_t* map = &in->modes[m].control_params;
+            blk->confidence_low[m][i] = map->confidence_low;
+            blk->confidence_high[m][i] = map->confidence_high;
+            blk->u_min[m][i] = map->u_min;
+            blk->u_nominal[m][i] = map->u_nominal;
+            blk->u_max[m][i] = map->u_max;
+            blk->gain_increase[m][i] = map->gain_increase;
+            blk->gain_decrease[m][i] = map->gain_decrease;
+            blk->rate_limit[m][i] = map->rate_limit;
+            blk->dwell[m][i] = in->modes[m].dwell_time_sec;
+        }
+
+        /* As rtka_init_pendulum_controller */
+        blk->mode[i] = RTKA_MODE_NOMINAL;
+        blk->time_in_mode[i] = 0.0f;
+        blk->confidence[i] = 1.0f;
+        blk->output[i] = 0.0f;
+        blk->prev_output[i] = 0.0f;
+        blk->transitions[i] = 0;
+        blk->energy_sum[i] = 0.0f;
+        blk->max_angle1[i] = 0.0f;
+        blk->max_angle2[i] = 0.0f;
+        blk->settle_time[i] = 0.0f;
+        blk->uncontrollable[i] = 0;
+    }
+}
+
+/* ============================================================================
+ * LANE STEP
+ * ============================================================================ */
+
+/* pendulum_derivatives of rtka_pendulum_sim.c on scalars */
+static inline void sweep_accel(
+    float theta1, float omega1, float theta2, float omega2,
+    float m1, float m2, float l1, float l2, float g, float b1, float b2,
+    float torque,
+    float* alpha1, float* alpha2
+) {
+    /* cos as a shifted sin: a sinf/cosf pair of one argument is folded
+     * into cexpif, which has no vector variant */
+    float delta = theta1 - theta2;
+    float sin_delta = sinf(delta);
+    float cos_delta = sinf(delta + 0.5f * SWEEP_PI);
+    float sin1 = sinf(theta1);
+    float sin2 = sinf(theta2);
+    float denom = m1 + m2 * sin_delta * sin_delta;
+
+    float num1 = -m2 * l1 * omega1 * omega1 * sin_delta * cos_delta;
+    num1 += m2 * g * sin2 * cos_delta;
+    num1 -= m2 * l2 * omega2 * omega2 * sin_delta;
+    num1 -= (m1 + m2) * g * sin1;
+    num1 -= b1 * omega1;
+    num1 += torque;
+    *alpha1 = num1 / (l1 * denom);
+
+    float num2 = (m1 + m2) * (l1 * omega1 * omega1 * sin_delta - g * sin2 + g * sin1 * cos_delta);
+    num2 += m2 * l2 * omega2 * omega2 * sin_delta * cos_delta;
+    num2 -= b2 * omega2;
+    num2 += torque * cos_delta;
+    *alpha2 = num2 / (l2 * denom);
+}
+
+/* fmodf(a + π, 2π) - π, as the scalar integrator wraps */
+static inline float sweep_wrap(float a) {
+    float x = a + SWEEP_PI;
+    return x - SWEEP_TWO_PI * truncf(x * (1.0f / SWEEP_TWO_PI)) - SWEEP_PI;
+}
+
+/* v[mode][i] as a sum of 0/1-weighted modes. Gathers do not vectorize
+ * here, and ?: chains leave masked loads (no masked libmvec calls) or a
+ * PHI too wide to if-convert */
+static inline float sweep_by_mode(const float (*v)[L], int32_t mode, uint32_t i) {
+    return v[RTKA_MODE_NOMINAL][i] * (float)(mode == RTKA_MODE_NOMINAL) +
+           v[RTKA_MODE_DEGRADED][i] * (float)(mode == RTKA_MODE_DEGRADED) +
+           v[RTKA_MODE_SAFE][i] * (float)(mode == RTKA_MODE_SAFE) +
+           v[RTKA_MODE_EMERGENCY][i] * (float)(mode == RTKA_MODE_EMERGENCY);
+}
+
+/**
+ * Sensors, mode controller and control map for every lane:
+ * rtka_update_pendulum_sensors followed by rtka_pendulum_control_step
+ */
+static void sweep_control(sweep_block_t* restrict blk, float dt) {
+    for (uint32_t i = 0; i < L; i++) {
+        float th1 = blk->theta1[i], th2 = blk->theta2[i];
+        float om1 = blk->omega1[i], om2 = blk->omega2[i];
+        float m1 = blk->m1[i], m2 = blk->m2[i], l1 = blk->l1[i], l2 = blk->l2[i], g = blk->g[i];
+
+        /* rtka_is_pendulum_controllable, rtka_compute_pendulum_energy */
+        bool controllable = (fabsf(th1) < 0.5f) & (fabsf(th2) < 0.5f) &
+                            (fabsf(om1) < 2.0f) & (fabsf(om2) < 2.0f);
+        float cos_delta = cosf(th1 - th2);
+        float energy = 0.5f * m1 * l1 * l1 * om1 * om1;
+        energy += 0.5f * m2 * (l1 * l1 * om1 * om1 + l2 * l2 * om2 * om2 +
+                               2.0f * l1 * l2 * om1 * om2 * cos_delta);
+        energy -= (m1 + m2) * g * l1 * cosf(th1);
+        energy -= m2 * g * l2 * cosf(th2);
+
+        /* Sensor confidences, degraded outside the controllable region and
+         * at high energy; all values are TRUE */
+        float s1 = controllable ? 1.0f : 0.3f;
+        float s2 = energy > 20.0f ? 0.5f : 1.0f;
+        float c_enc = (controllable ? 0.90f : 0.30f) * s1 * s2;
+        float c_gyro1 = (fabsf(om1) < 5.0f ? 0.85f : 0.40f) * s1 * s2;
+        float c_gyro2 = (fabsf(om2) < 5.0f ? 0.85f : 0.40f) * s1 * s2;
+        float c_accel = (energy < 10.0f ? 0.80f : 0.20f) * s1 * s2;
+
+        /* Mode update on the previous step's confidence */
+        float prior = blk->confidence[i];
+        int32_t mode = blk->mode[i];
+        float time_in_mode = blk->time_in_mode[i] + dt;
+        int32_t to_degraded = ((mode == RTKA_MODE_NOMINAL) & (prior < 0.65f)) |
+                              ((mode == RTKA_MODE_SAFE) & (prior > 0.45f));
+        int32_t to_nominal = (mode == RTKA_MODE_DEGRADED) & (prior > 0.75f);
+        int32_t to_safe = (mode == RTKA_MODE_DEGRADED) & (prior < 0.35f);
+        int32_t to_emergency = (prior < 0.05f) | (mode == RTKA_MODE_EMERGENCY);
+        int32_t target = mode + to_degraded * (RTKA_MODE_DEGRADED - mode) +
+                         to_nominal * (RTKA_MODE_NOMINAL - mode) + to_safe * (RTKA_MODE_SAFE - mode);
+        target += to_emergency * (RTKA_MODE_EMERGENCY - target);
+        int32_t transition = (target != mode) &
+                             ((time_in_mode >= sweep_by_mode(blk->dwell, mode, i)) | to_emergency);
+        mode += transition * (target - mode);
+        blk->time_in_mode[i] = time_in_mode * (float)(1 - transition);
+        blk->transitions[i] += (uint32_t)transition;
+        blk->mode[i] = mode;
+
+        /* rtka_compute_control_confidence: product with the early exit once
+         * it falls below 0.01 */
+        float conf = c_enc;
+        conf = conf < 0.01f ? conf : conf * c_enc;
+        conf = conf < 0.01f ? conf : conf * c_gyro1;
+        conf = conf < 0.01f ? conf : conf * c_gyro2;
+        conf = conf < 0.01f ? conf : conf * c_accel;
+        blk->confidence[i] = conf;
+
+        /* rtka_confidence_to_control for the lane's mode */
+        float lo = sweep_by_mode(blk->confidence_low, mode, i);
+        float hi = sweep_by_mode(blk->confidence_high, mode, i);
+        float u_min = sweep_by_mode(blk->u_min, mode, i);
+        float u_nom = sweep_by_mode(blk->u_nominal, mode, i);
+        float u_max = sweep_by_mode(blk->u_max, mode, i);
+        float up = u_nom + sweep_by_mode(blk->gain_increase, mode, i) * (lo - conf) * (u_max - u_nom);
+        float down = u_nom - sweep_by_mode(blk->gain_decrease, mode, i) * (conf - hi) * (u_nom - u_min);
+        float raw = conf < lo ? up : conf > hi ? down : u_nom;
+        raw = raw < u_min ? u_min : raw > u_max ? u_max : raw;
+
+        /* rtka_apply_rate_limit against the output before last */
+        float prev = blk->prev_output[i];
+        float rate = sweep_by_mode(blk->rate_limit, mode, i);
+        float delta = raw - prev;
+        float limited = fabsf(delta) > rate ? prev + copysignf(rate, delta) : raw;
+        blk->prev_output[i] = blk->output[i];
+        blk->output[i] = limited;
+
+        float tau = blk->tau_max[i];
+        float torque = limited < -tau ? -tau : limited > tau ? tau : limited;
+        blk->torque[i] = mode == RTKA_MODE_EMERGENCY ? 0.0f : torque;
+
+        blk->energy_sum[i] += energy;
+        blk->max_angle1[i] = fmaxf(blk->max_angle1[i], fabsf(th1));
+        blk->max_angle2[i] = fmaxf(blk->max_angle2[i], fabsf(th2));
+        blk->uncontrollable[i] += !controllable;
+    }
+}
+
+/* Gaussian torque disturbance by Box-Muller */
+static void sweep_disturb(sweep_block_t* restrict blk, float sigma) {
+    for (uint32_t i = 0; i < L; i++) {
+        float u1 = sweep_uniform(&blk->rng[i]);
+        float u2 = sweep_uniform(&blk->rng[i]);
+        blk->torque[i] += sigma * sqrtf(-2.0f * logf(u1)) * cosf(SWEEP_TWO_PI * u2);
+    }
+}
+
+/* rk4_step of rtka_pendulum_sim.c for every lane */
+static void sweep_physics(sweep_block_t* restrict blk, float dt, float t_next, float band) {
+    const float h = 0.5f * dt;
+    for (uint32_t i = 0; i < L; i++) {
+        float m1 = blk->m1[i], m2 = blk->m2[i], l1 = blk->l1[i], l2 = blk->l2[i];
+        float g = blk->g[i], b1 = blk->b1[i], b2 = blk->b2[i], tau = blk->torque[i];
+        float th1 = blk->theta1[i], om1 = blk->omega1[i];
+        float th2 = blk->theta2[i], om2 = blk->omega2[i];
+
+        float a1, a2, b1k, b2k, c1, c2, d1, d2;
+        sweep_accel(th1, om1, th2, om2, m1, m2, l1, l2, g, b1, b2, tau, &a1, &a2);
+        float k2_om1 = om1 + h * a1, k2_om2 = om2 + h * a2;
+        sweep_accel(th1 + h * om1, k2_om1, th2 + h * om2, k2_om2,
+                    m1, m2, l1, l2, g, b1, b2, tau, &b1k, &b2k);
+        float k3_om1 = om1 + h * b1k, k3_om2 = om2 + h * b2k;
+        sweep_accel(th1 + h * k2_om1, k3_om1, th2 + h * k2_om2, k3_om2,
+                    m1, m2, l1, l2, g, b1, b2, tau, &c1, &c2);
+        float k4_om1 = om1 + dt * c1, k4_om2 = om2 + dt * c2;
+        sweep_accel(th1 + dt * k3_om1, k4_om1, th2 + dt * k3_om2, k4_om2,
+                    m1, m2, l1, l2, g, b1, b2, tau, &d1, &d2);
+
+        th1 += (dt / 6.0f) * (om1 + 2.0f * k2_om1 + 2.0f * k3_om1 + k4_om1);
+        om1 += (dt / 6.0f) * (a1 + 2.0f * b1k + 2.0f * c1 + d1);
+        th2 += (dt / 6.0f) * (om2 + 2.0f * k2_om2 + 2.0f * k3_om2 + k4_om2);
+        om2 += (dt / 6.0f) * (a2 + 2.0f * b2k + 2.0f * c2 + d2);
+        th1 = sweep_wrap(th1);
+        th2 = sweep_wrap(th2);
+
+        blk->theta1[i] = th1;
+        blk->omega1[i] = om1;
+        blk->theta2[i] = th2;
+        blk->omega2[i] = om2;
+        bool outside = (fabsf(th1) > band) | (fabsf(th2) > band);
+        blk->settle_time[i] = outside ? t_next : blk->settle_time[i];
+    }
+}
+
+static void sweep_block_store(
+    const sweep_block_t* blk,
+    rtka_pendulum_outcome_t* out,
+    uint32_t n,
+    uint32_t steps,
+    float band
+) {
+    for (uint32_t i = 0; i < n; i++) {
+        float th1 = blk->theta1[i], th2 = blk->theta2[i];
+        bool controllable = fabsf(th1) < 0.5f && fabsf(th2) < 0.5f &&
+                            fabsf(blk->omega1[i]) < 2.0f && fabsf(blk->omega2[i]) < 2.0f;
+        out[i] = (rtka_pendulum_outcome_t){
+            .final_theta1 = th1,
+            .final_theta2 = th2,
+            .max_angle1 = blk->max_angle1[i],
+            .max_angle2 = blk->max_angle2[i],
+            .mean_energy = steps ? blk->energy_sum[i] / (float)steps : 0.0f,
+            .uncontrollable_fraction = steps ? (float)blk->uncontrollable[i] / (float)steps : 0.0f,
+            .settle_time = blk->settle_time[i],
+            .mode_transitions = blk->transitions[i],
+            .final_mode = (rtka_control_mode_t)blk->mode[i],
+            .stable = controllable && blk->mode[i] != RTKA_MODE_EMERGENCY &&
+                      fabsf(th1) <= band && fabsf(th2) <= band
+        };
+    }
+}
+
+/* ============================================================================
+ * SWEEP
+ * ============================================================================ */
+
+typedef struct {
+    const rtka_pendulum_instance_t* instances;
+    rtka_pendulum_outcome_t* outcomes;
+    uint32_t count;
+    uint32_t blocks;
+    uint32_t steps;
+    rtka_pendulum_sweep_config_t config;
+    atomic_uint next_block;
+} sweep_job_t;
+
+static void* sweep_worker(void* arg) {
+    sweep_job_t* job = (sweep_job_t*)arg;
+    const rtka_pendulum_sweep_config_t* cfg = &job->config;
+    sweep_block_t blk __attribute__((aligned(64)));
+
+    for (;;) {
+        uint32_t b = atomic_fetch_add_explicit(&job->next_block, 1, memory_order_relaxed);
+        if (b >= job->blocks) break;
+        uint32_t first = b * L;
+        uint32_t n = job->count - first < L ? job->count - first : L;
+
+        sweep_block_load(&blk, job->instances + first, n, cfg->initial_jitter);
+        for (uint32_t k = 0; k < job->steps; k++) {
+            sweep_control(&blk, cfg->dt);
+            if (cfg->disturbance > 0.0f) sweep_disturb(&blk, cfg->disturbance);
+            sweep_physics(&blk, cfg->dt, (float)(k + 1) * cfg->dt, cfg->settle_band);
+        }
+        sweep_block_store(&blk, job->outcomes + first, n, job->steps, cfg->settle_band);
+    }
+    return NULL;
+}
+
+void rtka_pendulum_instance_default(rtka_pendulum_instance_t* instance) {
+    rtka_pendulum_controller_t ctrl;
+    rtka_init_pendulum_controller(&ctrl, 0.01f);
+    memset(instance, 0, sizeof(*instance));
+    instance->params = ctrl.params;
+    memcpy(instance->modes, ctrl.mode_ctrl.configs, sizeof(instance->modes));
+}
+
+rtka_pendulum_sweep_config_t rtka_pendulum_sweep_default_config(void) {
+    return (rtka_pendulum_sweep_config_t){
+        .dt = 0.01f,
+        .duration = 10.0f,
+        .disturbance = 0.0f,
+        .initial_jitter = 0.0f,
+        .settle_band = 0.05f,
+        .threads = 0
+    };
+}
+
+int rtka_pendulum_sweep(
+    const rtka_pendulum_instance_t* instances,
+    uint32_t count,
+    const rtka_pendulum_sweep_config_t* config,
+    rtka_pendulum_outcome_t* outcomes,
+    rtka_pendulum_sweep_summary_t* summary
+) {
+    if (!instances || count == 0 || !config) return EINVAL;
+    if (!(config->dt > 0.0f) || !(config->duration >= 0.0f)) return EINVAL;
+
+    rtka_pendulum_outcome_t* out = outcomes;
+    if (!out) {
+        out = malloc((size_t)count * sizeof(*out));
+        if (!out) return ENOMEM;
+    }
+
+    sweep_job_t job = {
+        .instances = instances,
+        .outcomes = out,
+        .count = count,
+        .blocks = (count + L - 1) / L,
+        .steps = (uint32_t)(config->duration / config->dt),
+        .config = *config
+    };
+    atomic_init(&job.next_block, 0);
+
+    uint32_t threads = config->threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > job.blocks) threads = job.blocks;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    /* The caller's thread is worker 0; workers that cannot be created
+     * leave their share to the others */
+    pthread_t* tids = threads > 1 ? malloc((threads - 1) * sizeof(*tids)) : NULL;
+    uint32_t started = 0;
+    if (tids) {
+        while (started < threads - 1 &&
+               pthread_create(&tids[started], NULL, sweep_worker, &job) == 0) {
+            started++;
+        }
+    }
+    sweep_worker(&job);
+    for (uint32_t t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    free(tids);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (summary) {
+        memset(summary, 0, sizeof(*summary));
+        summary->count = count;
+        double max_sum = 0.0, settle_sum = 0.0, unctl_sum = 0.0;
+        for (uint32_t i = 0; i < count; i++) {
+            float peak = fmaxf(out[i].max_angle1, out[i].max_angle2);
+            max_sum += peak;
+            summary->worst_max_angle = fmaxf(summary->worst_max_angle, peak);
+            unctl_sum += out[i].uncontrollable_fraction;
+            summary->emergency += out[i].final_mode == RTKA_MODE_EMERGENCY;
+            if (out[i].stable) {
+                summary->stable++;
+                settle_sum += out[i].settle_time;
+            }
+        }
+        summary->mean_max_angle = (float)(max_sum / count);
+        summary->mean_uncontrollable_fraction = (float)(unctl_sum / count);
+        summary->mean_settle_time = summary->stable ? (float)(settle_sum / summary->stable) : 0.0f;
+        summary->seconds = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+        summary->steps_per_second = summary->seconds > 0.0
+            ? (double)count * job.steps / summary->seconds : 0.0;
+    }
+
+    if (!outcomes) free(out);
+    return 0;
+}
@@ -12,6 +12,9 @@
  *   - Accurate double pendulum dynamics
  *   - RTKA control integration
  *   - Multiple test scenarios
+ * v1.1.0 - --rt RATE SECONDS [CPU]: scenario 1 on the real-time runner
+ * v1.2.0 - --sweep COUNT [THREADS]: NOMINAL gain and rate limit grid on
+ *          the batched simulation
  * 
  * VALIDATION STATUS:
  * This implements verified double pendulum physics
@@ -27,8 +30,11 @@
  */
 
 #include "rtka_robotics_control.h"
+#include "rtka_rt_runner.h"
+#include "rtka_pendulum_batch.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <time.h>
 
@@ -398,11 +404,162 @@ static void scenario_sensor_failure(void) {
     rtka_print_pendulum_stats(&ctrl);
 }
 
+/* ============================================================================
+ * REAL-TIME RUN
+ * ============================================================================ */
+
+/**
+ * Preallocated loop state: on hardware the physics step is replaced by
+ * the actuator write and the sensor update by the driver reads
+ */
+typedef struct {
+    rtka_pendulum_controller_t ctrl;
+    float encoder_noise;
+    float gyro_noise;
+    float accel_noise;
+    float last_torque;
+} rt_pendulum_t;
+
+static bool rt_pendulum_step(void* ctx, uint64_t cycle) {
+    (void)cycle;
+    rt_pendulum_t* rt = (rt_pendulum_t*)ctx;
+    rtka_update_pendulum_sensors(&rt->ctrl, rt->encoder_noise, rt->gyro_noise, rt->accel_noise);
+    rt->last_torque = rtka_pendulum_control_step(&rt->ctrl);
+    integrate_pendulum_physics(&rt->ctrl, rt->last_torque);
+    return true;
+}
+
+/**
+ * Scenario 1 in real time: the simulated plant advances one period per
+ * release, so the controller runs at the rate it would on hardware
+ */
+static int run_realtime(uint32_t rate_hz, float seconds, int cpu) {
+    static rt_pendulum_t rt;
+    rtka_init_pendulum_controller(&rt.ctrl, 1.0f / (float)rate_hz);
+    rt.ctrl.state.theta1 = 0.1f;
+    rt.ctrl.state.theta2 = 0.05f;
+    rt.encoder_noise = 0.001f;
+    rt.gyro_noise = 0.01f;
+    rt.accel_noise = 0.1f;
+
+    rtka_rt_config_t config = rtka_rt_default_config();
+    config.rate_hz = rate_hz;
+    config.cycles = (uint64_t)(seconds * (float)rate_hz);
+    config.cpu = cpu;
+
+    rtka_rt_runner_t runner;
+    int err = rtka_rt_start(&runner, &config, rt_pendulum_step, &rt);
+    if (err) {
+        fprintf(stderr, "real-time start failed: %s\n", strerror(err));
+        return 1;
+    }
+    rtka_rt_join(&runner);
+
+    rtka_rt_print_stats(&runner.stats, rate_hz);
+    printf("Final: θ₁=%.4f, θ₂=%.4f, τ=%.3fNm [%s]\n", rt.ctrl.state.theta1, rt.ctrl.state.theta2,
+           rt.last_torque, rtka_get_mode_name(rt.ctrl.mode_ctrl.current_mode));
+    return runner.stats.cycles == config.cycles ? 0 : 1;
+}
+
+/* ============================================================================
+ * PARAMETER SWEEP
+ * ============================================================================ */
+
+/**
+ * Scenario 1 over a grid of NOMINAL gain_increase and rate_limit, each
+ * cell with its share of the instances: m2 spread ±10 %, initial angles
+ * jittered and a torque disturbance drawn from the instance seed
+ */
+static int run_sweep(uint32_t count, uint32_t threads) {
+    static const float gains[] = { 1.0f, 2.0f, 3.0f, 4.0f };
+    static const float rates[] = { 2.5f, 5.0f, 10.0f };
+    const uint32_t n_gain = sizeof(gains) / sizeof(gains[0]);
+    const uint32_t cells = n_gain * (sizeof(rates) / sizeof(rates[0]));
+    if (count < cells) count = cells;
+
+    rtka_pendulum_instance_t* instances = malloc((size_t)count * sizeof(*instances));
+    rtka_pendulum_outcome_t* outcomes = malloc((size_t)count * sizeof(*outcomes));
+    if (!instances || !outcomes) {
+        free(instances);
+        free(outcomes);
+        fprintf(stderr, "sweep: out of memory\n");
+        return 1;
+    }
+
+    rtka_pendulum_instance_t base;
+    rtka_pendulum_instance_default(&base);
+    base.theta1 = 0.1f;
+    base.theta2 = 0.05f;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t cell = i % cells;
+        float spread = (float)(i / cells) / (float)((count + cells - 1) / cells);
+        instances[i] = base;
+        instances[i].params.m2 *= 0.9f + 0.2f * spread;
+        instances[i].modes[RTKA_MODE_NOMINAL].control_params.gain_increase = gains[cell % n_gain];
+        instances[i].modes[RTKA_MODE_NOMINAL].control_params.rate_limit = rates[cell / n_gain];
+        instances[i].seed = i;
+    }
+
+    rtka_pendulum_sweep_config_t config = rtka_pendulum_sweep_default_config();
+    config.initial_jitter = 0.02f;
+    config.disturbance = 0.05f;
+    config.threads = threads;
+
+    rtka_pendulum_sweep_summary_t summary;
+    int err = rtka_pendulum_sweep(instances, count, &config, outcomes, &summary);
+    if (err) {
+        fprintf(stderr, "sweep failed: %s\n", strerror(err));
+        free(instances);
+        free(outcomes);
+        return 1;
+    }
+
+    printf("\n=== Parameter Sweep: %u instances, %.0f s at %.0f ms ===\n",
+           count, config.duration, config.dt * 1000.0f);
+    printf("%6s %6s %8s %10s %10s %10s\n", "gain", "rate", "stable", "emergency", "max |θ|", "settle");
+    for (uint32_t c = 0; c < cells; c++) {
+        uint32_t n = 0, stable = 0, emergency = 0;
+        float peak = 0.0f, settle = 0.0f;
+        for (uint32_t i = c; i < count; i += cells) {
+            n++;
+            stable += outcomes[i].stable;
+            emergency += outcomes[i].final_mode == RTKA_MODE_EMERGENCY;
+            peak += fmaxf(outcomes[i].max_angle1, outcomes[i].max_angle2);
+            if (outcomes[i].stable) settle += outcomes[i].settle_time;
+        }
+        printf("%6.1f %6.1f %7.1f%% %9.1f%% %10.4f %9.2fs\n", gains[c % n_gain], rates[c / n_gain],
+               100.0f * stable / n, 100.0f * emergency / n, peak / n, stable ? settle / stable : 0.0f);
+    }
+    printf("Overall: %.1f%% stable, %.1f%% emergency, mean max |θ| %.4f (worst %.4f), "
+           "uncontrollable %.1f%% of steps\n",
+           100.0f * summary.stable / summary.count, 100.0f * summary.emergency / summary.count,
+           summary.mean_max_angle, summary.worst_max_angle,
+           100.0f * summary.mean_uncontrollable_fraction);
+    printf("Wall time %.3f s, %.2f M instance steps/s\n", summary.seconds, summary.steps_per_second / 1e6);
+
+    free(instances);
+    free(outcomes);
+    return 0;
+}
+
 /* ============================================================================
  * MAIN
  * ============================================================================ */
 
-int main(void) {
+int main(int argc, char** argv) {
+    if (argc >= 4 && strcmp(argv[1], "--rt") == 0) {
+        return run_realtime((uint32_t)strtoul(argv[2], NULL, 10), strtof(argv[3], NULL),
+                            argc >= 5 ? atoi(argv[4]) : -1);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--sweep") == 0) {
+        return run_sweep((uint32_t)strtoul(argv[2], NULL, 10),
+                         argc >= 4 ? (uint32_t)strtoul(argv[3], NULL, 10) : 0);
+    }
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s [--rt RATE_HZ SECONDS [CPU] | --sweep COUNT [THREADS]]\n", argv[0]);
+        return 2;
+    }
+
     printf("======================================================================\n");
     printf("RTKA DOUBLE PENDULUM CONTROL SIMULATION\n");
     printf("Copyright (c) 2025 - H.Overman opsec.ee@pm.me\n");
@@ -12,6 +12,7 @@
  *   - Hierarchical mode switching
  *   - Double pendulum stabilization
  *   - Status: NEW - Requires validation
+ * v1.1.0 - Batched SoA fusion of many tracks (rtka_fuse_sensors_batch)
  * 
  * VALIDATION STATUS: UNTESTED
  * This implementation requires:
@@ -376,6 +377,9 @@ typedef struct {
 /**
  * Variance-weighted sensor fusion
  * Implements OPT-225 with LUT acceleration
+ * Variances index the LUT unclamped: above 1 the index saturates, below 0
+ * the float-to-unsigned cast is undefined. rtka_fuse_sensors_batch clamps
+ * variances to [0, 1] first, so it is defined for negative variances too.
  * 
  * @param sensors Array of sensor readings
  * @param n Number of sensors
@@ -386,6 +390,42 @@ rtka_fusion_result_t rtka_fuse_sensors_weighted(
     uint32_t n
 );
 
+/**
+ * Sensor planes of many independent tracks (structure of arrays)
+ * Plane s holds sensor s of every track: element [s * tracks + t]
+ */
+typedef struct {
+    const rtka_value_t* values;
+    const float* confidences;
+    const float* variances;
+    uint32_t tracks;
+    uint32_t sensors;      /* 0 fuses every track to UNKNOWN, confidence 0 */
+} rtka_sensor_batch_t;
+
+/**
+ * Fused planes, one element per track
+ */
+typedef struct {
+    rtka_value_t* fused;
+    float* confidence;             /* 1 - ∏(1 - cᵢ) */
+    float* geometric_confidence;   /* (∏cᵢ)^(1/n) in log domain; may be NULL */
+    float* total_variance;         /* Mean variance */
+} rtka_fusion_batch_t;
+
+/**
+ * Variance-weighted fusion of every track in one pass
+ * Same result per track as rtka_fuse_sensors_weighted over its sensors;
+ * tracks are processed in tiles that vectorize across tracks, LUT weights
+ * gathered per lane. Variances are clamped to [0, 1] for the LUT.
+ * 
+ * @param batch Sensor planes
+ * @param out Output planes of batch->tracks elements
+ */
+void rtka_fuse_sensors_batch(
+    const rtka_sensor_batch_t* batch,
+    const rtka_fusion_batch_t* out
+);
+
 /* ============================================================================
  * UTILITY FUNCTIONS
  * ============================================================================ */
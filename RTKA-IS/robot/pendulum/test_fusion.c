@@ -0,0 +1,107 @@
+/**
+ * File: test_fusion.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * Batched fusion check: random SoA sensor planes through
+ * rtka_fuse_sensors_batch and, track by track, rtka_fuse_sensors_weighted.
+ * Fused value must match exactly; OR confidence and mean variance to float
+ * rounding; the geometric confidence against a double-precision reference.
+ * Covers zero sensors, a single track and track counts that are not a
+ * multiple of the fusion tile, with zero and unit confidences and
+ * variances above 1 (where the LUT index saturates).
+ */
+
+#include "rtka_robotics_control.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define FUSION_TOLERANCE 1e-5f
+
+static uint32_t g_seed = 12345U;
+
+static float next_unit(void) {
+    g_seed = g_seed * 1664525U + 1013904223U;
+    return (float)(g_seed >> 8) / 16777216.0f;
+}
+
+static float random_confidence(void) {
+    float r = next_unit();
+    if (r < 0.05f) return 0.0f;
+    if (r < 0.10f) return 1.0f;
+    return next_unit();
+}
+
+static bool check_batch(uint32_t tracks, uint32_t sensors, bool geometric) {
+    size_t count = (size_t)tracks * sensors;
+    rtka_value_t* values = malloc((count + 1U) * sizeof(rtka_value_t));
+    float* confidences = malloc((count + 1U) * sizeof(float));
+    float* variances = malloc((count + 1U) * sizeof(float));
+    rtka_value_t* fused = malloc(tracks * sizeof(rtka_value_t));
+    float* confidence = malloc(tracks * sizeof(float));
+    float* geo = malloc(tracks * sizeof(float));
+    float* variance = malloc(tracks * sizeof(float));
+    rtka_sensor_reading_t* readings = malloc((sensors + 1U) * sizeof(rtka_sensor_reading_t));
+    bool ok = values && confidences && variances && fused && confidence && geo && variance && readings;
+
+    uint32_t value_errors = 0, geo_errors = 0;
+    float max_error = 0.0f;
+    if (ok) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = (rtka_value_t)((int32_t)(next_unit() * 3.0f) - 1);
+            confidences[i] = random_confidence();
+            variances[i] = next_unit() * 1.25f;
+        }
+        rtka_sensor_batch_t batch = { values, confidences, variances, tracks, sensors };
+        rtka_fusion_batch_t out = { fused, confidence, geometric ? geo : NULL, variance };
+        rtka_fuse_sensors_batch(&batch, &out);
+
+        for (uint32_t t = 0; t < tracks; t++) {
+            double log_sum = 0.0;
+            bool has_zero = false;
+            for (uint32_t s = 0; s < sensors; s++) {
+                size_t i = (size_t)s * tracks + t;
+                readings[s] = (rtka_sensor_reading_t){ values[i], confidences[i], variances[i] };
+                has_zero |= confidences[i] == 0.0f;
+                if (confidences[i] > 0.0f) log_sum += log((double)confidences[i]);
+            }
+            rtka_fusion_result_t expect = rtka_fuse_sensors_weighted(readings, sensors);
+
+            if (fused[t] != expect.fused) value_errors++;
+            max_error = fmaxf(max_error, fabsf(confidence[t] - expect.confidence));
+            max_error = fmaxf(max_error, fabsf(variance[t] - expect.total_variance));
+            if (geometric) {
+                double geo_expect = (sensors == 0 || has_zero) ? 0.0 : exp(log_sum / sensors);
+                if (fabs((double)geo[t] - geo_expect) > FUSION_TOLERANCE) geo_errors++;
+            }
+        }
+    }
+
+    ok = ok && value_errors == 0 && geo_errors == 0 && max_error <= FUSION_TOLERANCE;
+    printf("  %5u tracks x %u sensors%s: value mismatches %u, max error %.2e, geometric mismatches %u  %s\n",
+           tracks, sensors, geometric ? "" : " (no geometric)", value_errors, (double)max_error, geo_errors,
+           ok ? "OK" : "FAIL");
+
+    free(values);
+    free(confidences);
+    free(variances);
+    free(fused);
+    free(confidence);
+    free(geo);
+    free(variance);
+    free(readings);
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Batched Fusion Test ===\n");
+    bool ok = check_batch(1000U, 5U, true);
+    ok &= check_batch(1U, 5U, true);
+    ok &= check_batch(257U, 1U, true);
+    ok &= check_batch(513U, 7U, false);
+    ok &= check_batch(300U, 0U, true);
+
+    printf("\n%s\n", ok ? "All fusion checks passed" : "Fusion checks FAILED");
+    return ok ? 0 : 1;
+}
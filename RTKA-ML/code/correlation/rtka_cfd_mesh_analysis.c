@@ -0,0 +1,1143 @@
+/**
+ * File: rtka_cfd_mesh_analysis.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * RTKA CFD Mesh Quality Analysis - Implementation
+ *
+ * Mesh quality statistics and mesh-solution correlations as one blocked,
+ * threaded reduction over strided field views, so array-of-structs input,
+ * separate field arrays and mapped field files share the same code.
+ *
+ * Optimizations:
+ * - Every field read once; block means and centered sums from cache
+ * - Chan's update between blocks and threads keeps one pass accurate
+ * - Field files mapped read-only, never copied
+ * - Edge and face deduplication in partitions sized to stay in cache
+ *
+ * CHANGELOG:
+ * 2025-11-30: Initial implementation
+ *   - Quality statistics and mesh-solution correlation, AoS and SoA
+ *   - One-pass threaded assessment
+ *   - Field file writer and read-only mapping
+ * 2025-12-07: Topology from connectivity
+ *   - Euler characteristic and validation
+ *   - Edges and faces emitted per cell, hash-partitioned in two passes,
+ *     deduplicated per partition in open-addressing tables
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "rtka_cfd_mesh_analysis.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* ============================================================================
+ * INTERNAL DEFINITIONS
+ * ============================================================================ */
+
+/* Reduced fields: four mesh, then three solution */
+enum {
+    CFD_ASPECT, CFD_SKEWNESS, CFD_VOLUME, CFD_ORTHOGONALITY,
+    CFD_RESIDUAL, CFD_TRUNCATION, CFD_GRADIENT,
+    CFD_FIELDS
+};
+
+#define CFD_MESH_FIELDS 4U
+#define CFD_PAIRS 4U
+
+/* Correlated (mesh, solution) fields, in analysis order */
+static const unsigned int cfd_pair_fields[CFD_PAIRS][2] = {
+    { CFD_ASPECT, CFD_RESIDUAL },
+    { CFD_SKEWNESS, CFD_RESIDUAL },
+    { CFD_VOLUME, CFD_TRUNCATION },
+    { CFD_ORTHOGONALITY, CFD_GRADIENT }
+};
+
+#define CFD_FILE_MAGIC "RTKAMESH"
+#define CFD_FILE_VERSION 1U
+#define CFD_FILE_FIELDS 9U
+#define CFD_FILE_HEADER 64U
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t fields;
+    uint64_t num_cells;
+    uint8_t reserved[CFD_FILE_HEADER - 24U];
+} cfd_file_header_t;
+
+/**
+ * Field views: element i of field f is field[f][i * stride[f]]
+ */
+typedef struct {
+    const double* field[CFD_FIELDS];
+    size_t stride[CFD_FIELDS];
+    size_t num_fields;        /* CFD_MESH_FIELDS, or CFD_FIELDS with the solution */
+    size_t num_cells;
+    double quality_threshold;
+} cfd_view_t;
+
+/* Counts, means and centered sums of a set of cells */
+typedef struct {
+    size_t count;
+    size_t poor;
+    double mean[CFD_FIELDS];
+    double m2[CFD_FIELDS];
+    double cross[CFD_PAIRS];
+} cfd_moments_t;
+
+typedef struct {
+    const cfd_view_t* view;
+    size_t first;
+    size_t last;
+    cfd_moments_t moments;
+} cfd_task_t;
+
+/* ============================================================================
+ * REDUCTION
+ * ============================================================================ */
+
+/*
+ * Block sums over a strided field in CFD_LANES independent accumulators.
+ * Called with a literal stride of 1 for separate arrays, so the inlined
+ * copy vectorizes.
+ */
+#define CFD_LANES 8U
+
+static inline double cfd_lanes_total(const double* lanes) {
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+static inline double cfd_sum(const double* x, size_t count, size_t stride) {
+    double lanes[CFD_LANES] = {0.0};
+    size_t full = count - count % CFD_LANES;
+    for (size_t idx = 0U; idx < full; idx += CFD_LANES) {
+        for (size_t lane = 0U; lane < CFD_LANES; lane++) {
+            lanes[lane] += x[(idx + lane) * stride];
+        }
+    }
+    for (size_t idx = full; idx < count; idx++) {
+        lanes[idx - full] += x[idx * stride];
+    }
+    return cfd_lanes_total(lanes);
+}
+
+static inline double cfd_sum_squares(const double* x, size_t count, size_t stride, double mean) {
+    double lanes[CFD_LANES] = {0.0};
+    size_t full = count - count % CFD_LANES;
+    for (size_t idx = 0U; idx < full; idx += CFD_LANES) {
+        for (size_t lane = 0U; lane < CFD_LANES; lane++) {
+            double deviation = x[(idx + lane) * stride] - mean;
+            lanes[lane] += deviation * deviation;
+        }
+    }
+    for (size_t idx = full; idx < count; idx++) {
+        double deviation = x[idx * stride] - mean;
+        lanes[idx - full] += deviation * deviation;
+    }
+    return cfd_lanes_total(lanes);
+}
+
+static inline double cfd_sum_products(const double* x, const double* y, size_t count, size_t stride_x,
+                                      size_t stride_y, double x_mean, double y_mean) {
+    double lanes[CFD_LANES] = {0.0};
+    size_t full = count - count % CFD_LANES;
+    for (size_t idx = 0U; idx < full; idx += CFD_LANES) {
+        for (size_t lane = 0U; lane < CFD_LANES; lane++) {
+            lanes[lane] += (x[(idx + lane) * stride_x] - x_mean) * (y[(idx + lane) * stride_y] - y_mean);
+        }
+    }
+    for (size_t idx = full; idx < count; idx++) {
+        lanes[idx - full] += (x[idx * stride_x] - x_mean) * (y[idx * stride_y] - y_mean);
+    }
+    return cfd_lanes_total(lanes);
+}
+
+/* Poor: min(orthogonality, 1 - skewness) below the threshold */
+static inline size_t cfd_count_poor(const double* skew, const double* orth, size_t count, size_t stride_s,
+                                    size_t stride_o, double threshold) {
+    size_t poor = 0U;
+    for (size_t idx = 0U; idx < count; idx++) {
+        double quality = 1.0 - skew[idx * stride_s];
+        double orthogonality = orth[idx * stride_o];
+        quality = orthogonality < quality ? orthogonality : quality;
+        poor += quality < threshold ? 1U : 0U;
+    }
+    return poor;
+}
+
+/**
+ * Moments of cells [first, first + count), reading each field once from
+ * memory and again from cache
+ */
+static void cfd_reduce_block(const cfd_view_t* view, size_t first, size_t count, cfd_moments_t* out) {
+    out->count = count;
+
+    for (size_t fld = 0U; fld < view->num_fields; fld++) {
+        const double* x = view->field[fld] + first * view->stride[fld];
+        size_t stride = view->stride[fld];
+        double mean = (stride == 1U ? cfd_sum(x, count, 1U) : cfd_sum(x, count, stride)) / (double)count;
+        out->mean[fld] = mean;
+        out->m2[fld] = stride == 1U ? cfd_sum_squares(x, count, 1U, mean) : cfd_sum_squares(x, count, stride, mean);
+    }
+
+    for (size_t pair = 0U; view->num_fields == CFD_FIELDS && pair < CFD_PAIRS; pair++) {
+        unsigned int fx = cfd_pair_fields[pair][0];
+        unsigned int fy = cfd_pair_fields[pair][1];
+        size_t sx = view->stride[fx];
+        size_t sy = view->stride[fy];
+        const double* x = view->field[fx] + first * sx;
+        const double* y = view->field[fy] + first * sy;
+        out->cross[pair] = sx == 1U && sy == 1U ?
+            cfd_sum_products(x, y, count, 1U, 1U, out->mean[fx], out->mean[fy]) :
+            cfd_sum_products(x, y, count, sx, sy, out->mean[fx], out->mean[fy]);
+    }
+
+    size_t ss = view->stride[CFD_SKEWNESS];
+    size_t so = view->stride[CFD_ORTHOGONALITY];
+    const double* skew = view->field[CFD_SKEWNESS] + first * ss;
+    const double* orth = view->field[CFD_ORTHOGONALITY] + first * so;
+    out->poor = ss == 1U && so == 1U ?
+        cfd_count_poor(skew, orth, count, 1U, 1U, view->quality_threshold) :
+        cfd_count_poor(skew, orth, count, ss, so, view->quality_threshold);
+}
+
+/**
+ * Chan's update: fold the moments of other into acc
+ */
+static void cfd_moments_merge(cfd_moments_t* acc, const cfd_moments_t* other, size_t num_fields) {
+    if (other->count == 0U) {
+        return;
+    }
+    if (acc->count == 0U) {
+        *acc = *other;
+        return;
+    }
+
+    size_t total = acc->count + other->count;
+    double weight = (double)acc->count * (double)other->count / (double)total;
+    double share = (double)other->count / (double)total;
+    double delta[CFD_FIELDS];
+
+    for (size_t fld = 0U; fld < num_fields; fld++) {
+        delta[fld] = other->mean[fld] - acc->mean[fld];
+        acc->mean[fld] += delta[fld] * share;
+        acc->m2[fld] += other->m2[fld] + delta[fld] * delta[fld] * weight;
+    }
+    for (size_t pair = 0U; num_fields == CFD_FIELDS && pair < CFD_PAIRS; pair++) {
+        acc->cross[pair] += other->cross[pair] +
+                            delta[cfd_pair_fields[pair][0]] * delta[cfd_pair_fields[pair][1]] * weight;
+    }
+
+    acc->count = total;
+    acc->poor += other->poor;
+}
+
+static void* cfd_worker(void* arg) {
+    cfd_task_t* task = (cfd_task_t*)arg;
+    cfd_moments_t block;
+
+    memset(&task->moments, 0, sizeof(task->moments));
+    for (size_t first = task->first; first < task->last; first += RTKA_CFD_CHUNK_CELLS) {
+        size_t count = task->last - first;
+        if (count > RTKA_CFD_CHUNK_CELLS) {
+            count = RTKA_CFD_CHUNK_CELLS;
+        }
+        cfd_reduce_block(task->view, first, count, &block);
+        cfd_moments_merge(&task->moments, &block, task->view->num_fields);
+    }
+
+    return NULL;
+}
+
+static size_t cfd_default_threads(size_t num_threads) {
+    if (num_threads == 0U) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = online > 0 ? (size_t)online : 1U;
+    }
+    return num_threads;
+}
+
+/**
+ * Run fn on every task, task 0 on the calling thread; false when a
+ * thread could not be started, after joining the others
+ */
+static bool cfd_run_tasks(void* (*fn)(void*), void* tasks, size_t task_size, size_t count) {
+    pthread_t* threads = calloc(count, sizeof(pthread_t));
+    if (threads == NULL) {
+        return false;
+    }
+
+    size_t started = 0U;
+    bool ok = true;
+    for (size_t thr = 1U; thr < count; thr++) {
+        if (pthread_create(&threads[thr], NULL, fn, (char*)tasks + thr * task_size) != 0) {
+            ok = false;
+            break;
+        }
+        started = thr;
+    }
+    if (ok) {
+        fn(tasks);
+    }
+    for (size_t thr = 1U; thr <= started; thr++) {
+        pthread_join(threads[thr], NULL);
+    }
+
+    free(threads);
+    return ok;
+}
+
+/**
+ * Reduce all cells over up to num_threads threads, each taking whole
+ * blocks; merged in cell order
+ */
+static rtka_corr_error_t cfd_reduce(const cfd_view_t* view, size_t num_threads, cfd_moments_t* out) {
+    size_t blocks = (view->num_cells + RTKA_CFD_CHUNK_CELLS - 1U) / RTKA_CFD_CHUNK_CELLS;
+    num_threads = cfd_default_threads(num_threads);
+    if (num_threads > blocks) {
+        num_threads = blocks;
+    }
+
+    cfd_task_t* tasks = calloc(num_threads, sizeof(cfd_task_t));
+    if (tasks == NULL) {
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+
+    for (size_t thr = 0U; thr < num_threads; thr++) {
+        tasks[thr].view = view;
+        tasks[thr].first = blocks * thr / num_threads * RTKA_CFD_CHUNK_CELLS;
+        tasks[thr].last = blocks * (thr + 1U) / num_threads * RTKA_CFD_CHUNK_CELLS;
+        if (tasks[thr].last > view->num_cells) {
+            tasks[thr].last = view->num_cells;
+        }
+    }
+
+    bool ok = cfd_run_tasks(cfd_worker, tasks, sizeof(cfd_task_t), num_threads);
+    if (ok) {
+        memset(out, 0, sizeof(*out));
+        for (size_t thr = 0U; thr < num_threads; thr++) {
+            cfd_moments_merge(out, &tasks[thr].moments, view->num_fields);
+        }
+    }
+
+    free(tasks);
+    return ok ? RTKA_CORR_SUCCESS : RTKA_CORR_ERROR_ALLOCATION;
+}
+
+/* ============================================================================
+ * RESULTS
+ * ============================================================================ */
+
+static void cfd_fill_stats(const cfd_moments_t* moments, size_t fld, rtka_stats_t* out) {
+    out->mean = moments->mean[fld];
+    out->variance = moments->m2[fld] / (double)(moments->count - 1U);
+    out->std_dev = sqrt(out->variance);
+    out->count = moments->count;
+}
+
+static void cfd_fill_stats_all(const cfd_moments_t* moments, double quality_threshold, rtka_mesh_stats_t* out) {
+    cfd_fill_stats(moments, CFD_ASPECT, &out->aspect_ratio_stats);
+    cfd_fill_stats(moments, CFD_SKEWNESS, &out->skewness_stats);
+    cfd_fill_stats(moments, CFD_VOLUME, &out->volume_stats);
+    cfd_fill_stats(moments, CFD_ORTHOGONALITY, &out->orthogonality_stats);
+    out->num_cells = moments->count;
+    out->poor_quality_cells = moments->poor;
+    out->quality_threshold = quality_threshold;
+}
+
+static void cfd_fill_analysis(const cfd_moments_t* moments, rtka_cfd_correlation_analysis_t* out) {
+    static const char* const issues[CFD_PAIRS] = {
+        "Aspect ratio drives residuals",
+        "Skewness drives residuals",
+        "Cell size drives truncation error",
+        "Orthogonality drives gradient error"
+    };
+    static const char* const recommendations[CFD_PAIRS] = {
+        "Reduce cell stretching in high-residual regions or align cells with the flow",
+        "Smooth or re-mesh highly skewed cells",
+        "Refine cells where truncation error is largest",
+        "Improve face orthogonality or enable non-orthogonal correction"
+    };
+    double coefficient[CFD_PAIRS];
+    bool significant[CFD_PAIRS];
+    size_t strongest = CFD_PAIRS;
+
+    for (size_t pair = 0U; pair < CFD_PAIRS; pair++) {
+        unsigned int fx = cfd_pair_fields[pair][0];
+        unsigned int fy = cfd_pair_fields[pair][1];
+        double sx = sqrt(moments->m2[fx] / (double)(moments->count - 1U));
+        double sy = sqrt(moments->m2[fy] / (double)(moments->count - 1U));
+        double corr = 0.0;
+
+        /* Zero variance correlates 0.0, as in rtka_corr_matrix_compute() */
+        if (sx >= RTKA_CORR_EPSILON && sy >= RTKA_CORR_EPSILON) {
+            corr = moments->cross[pair] / sqrt(moments->m2[fx] * moments->m2[fy]);
+            if (corr > 1.0) {
+                corr = 1.0;
+            } else if (corr < -1.0) {
+                corr = -1.0;
+            }
+        }
+        coefficient[pair] = corr;
+        significant[pair] = rtka_corr_is_significant(corr, moments->count, 0.95);
+        if (significant[pair] && (strongest == CFD_PAIRS || fabs(corr) > fabs(coefficient[strongest]))) {
+            strongest = pair;
+        }
+    }
+
+    out->aspect_vs_residual = coefficient[0];
+    out->skewness_vs_residual = coefficient[1];
+    out->volume_vs_error = coefficient[2];
+    out->orthog_vs_convergence = coefficient[3];
+    out->aspect_significant = significant[0];
+    out->skewness_significant = significant[1];
+    out->volume_significant = significant[2];
+    out->orthog_significant = significant[3];
+
+    snprintf(out->primary_issue, sizeof(out->primary_issue), "%s",
+             strongest < CFD_PAIRS ? issues[strongest] : "No significant mesh quality influence");
+    snprintf(out->recommendation, sizeof(out->recommendation), "%s",
+             strongest < CFD_PAIRS ? recommendations[strongest] : "Mesh quality is adequate for this solution");
+}
+
+/* ============================================================================
+ * EULER CHARACTERISTIC VALIDATION - IMPLEMENTATION
+ * ============================================================================ */
+
+static long long mesh_euler(const rtka_mesh_topology_t* topology) {
+    return (long long)topology->vertices - (long long)topology->edges +
+           (long long)topology->faces - (long long)topology->cells;
+}
+
+rtka_corr_error_t rtka_mesh_euler_characteristic(
+    rtka_mesh_topology_t* topology
+) {
+    if (topology == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    topology->euler_char = (int)mesh_euler(topology);
+    topology->is_valid = topology->euler_char == topology->expected_char;
+    return RTKA_CORR_SUCCESS;
+}
+
+bool rtka_mesh_validate_topology(
+    const rtka_mesh_topology_t* topology,
+    int expected
+) {
+    return topology != NULL && mesh_euler(topology) == (long long)expected;
+}
+
+/* Cell edges and faces as local vertex numbers; triangles end in MESH_NONE */
+#define MESH_NONE 0xFFU
+#define MESH_PARTITION_BITS 10U
+#define MESH_PARTITIONS (1U << MESH_PARTITION_BITS)
+#define MESH_EMPTY UINT64_MAX
+
+typedef struct {
+    unsigned int edges;
+    unsigned int faces;
+    unsigned char edge[12][2];
+    unsigned char face[6][4];
+} mesh_shape_t;
+
+static const mesh_shape_t mesh_tetrahedron = {
+    6U, 4U,
+    { { 0, 1 }, { 1, 2 }, { 2, 0 }, { 0, 3 }, { 1, 3 }, { 2, 3 } },
+    { { 0, 1, 2, MESH_NONE }, { 0, 1, 3, MESH_NONE }, { 1, 2, 3, MESH_NONE }, { 0, 2, 3, MESH_NONE } }
+};
+
+static const mesh_shape_t mesh_pyramid = {
+    8U, 5U,
+    { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 0, 4 }, { 1, 4 }, { 2, 4 }, { 3, 4 } },
+    { { 0, 1, 2, 3 }, { 0, 1, 4, MESH_NONE }, { 1, 2, 4, MESH_NONE }, { 2, 3, 4, MESH_NONE },
+      { 3, 0, 4, MESH_NONE } }
+};
+
+static const mesh_shape_t mesh_wedge = {
+    9U, 5U,
+    { { 0, 1 }, { 1, 2 }, { 2, 0 }, { 3, 4 }, { 4, 5 }, { 5, 3 }, { 0, 3 }, { 1, 4 }, { 2, 5 } },
+    { { 0, 1, 2, MESH_NONE }, { 3, 4, 5, MESH_NONE }, { 0, 1, 4, 3 }, { 1, 2, 5, 4 }, { 2, 0, 3, 5 } }
+};
+
+static const mesh_shape_t mesh_hexahedron = {
+    12U, 6U,
+    { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },
+      { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } },
+    { { 0, 1, 2, 3 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 }, { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } }
+};
+
+static const mesh_shape_t* mesh_shape(size_t vertex_count) {
+    switch (vertex_count) {
+    case 4U:
+        return &mesh_tetrahedron;
+    case 5U:
+        return &mesh_pyramid;
+    case 6U:
+        return &mesh_wedge;
+    case 8U:
+        return &mesh_hexahedron;
+    default:
+        return NULL;
+    }
+}
+
+/* Face key: the sorted vertex indices, a triangle's fourth UINT32_MAX */
+typedef struct {
+    uint64_t lo;
+    uint64_t hi;
+} mesh_face_key_t;
+
+typedef struct {
+    const rtka_mesh_connectivity_t* mesh;
+    size_t num_threads;
+    bool faces;                   /* Round: edges, then faces */
+    size_t* cursor;               /* [thread][partition]: counts, then write positions */
+    size_t* start;                /* Partition starts, MESH_PARTITIONS + 1 */
+    uint64_t* edge_keys;
+    mesh_face_key_t* face_keys;
+    _Atomic uint64_t* referenced; /* Bitmap of vertices used */
+} mesh_build_t;
+
+typedef struct {
+    mesh_build_t* build;
+    size_t index;
+    size_t first_cell;
+    size_t last_cell;
+    rtka_corr_error_t status;
+    size_t distinct;
+    size_t boundary;
+    size_t nonmanifold;
+} mesh_task_t;
+
+static inline uint64_t mesh_mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27U)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31U);
+}
+
+static inline uint64_t mesh_face_hash(mesh_face_key_t key) {
+    return mesh_mix64(key.lo ^ mesh_mix64(key.hi));
+}
+
+static inline size_t mesh_partition(uint64_t hash) {
+    return (size_t)(hash >> (64U - MESH_PARTITION_BITS));
+}
+
+static inline uint64_t mesh_edge_key(unsigned int a, unsigned int b) {
+    return a < b ? ((uint64_t)b << 32U) | a : ((uint64_t)a << 32U) | b;
+}
+
+static inline mesh_face_key_t mesh_face_key(const unsigned int* cell, const unsigned char* face) {
+    uint32_t v[4];
+    for (size_t idx = 0U; idx < 4U; idx++) {
+        v[idx] = face[idx] == MESH_NONE ? UINT32_MAX : cell[face[idx]];
+    }
+    /* Sorting network for four */
+    static const unsigned char network[5][2] = { { 0, 1 }, { 2, 3 }, { 0, 2 }, { 1, 3 }, { 1, 2 } };
+    for (size_t idx = 0U; idx < 5U; idx++) {
+        uint32_t lo = v[network[idx][0]];
+        uint32_t hi = v[network[idx][1]];
+        v[network[idx][0]] = lo < hi ? lo : hi;
+        v[network[idx][1]] = lo < hi ? hi : lo;
+    }
+    return (mesh_face_key_t){ ((uint64_t)v[1] << 32U) | v[0], ((uint64_t)v[3] << 32U) | v[2] };
+}
+
+static inline const unsigned int* mesh_cell(const rtka_mesh_connectivity_t* mesh, size_t cell, size_t* count) {
+    if (mesh->cell_offsets == NULL) {
+        *count = mesh->vertices_per_cell;
+        return mesh->cell_vertices + cell * mesh->vertices_per_cell;
+    }
+    *count = mesh->cell_offsets[cell + 1U] - mesh->cell_offsets[cell];
+    return mesh->cell_vertices + mesh->cell_offsets[cell];
+}
+
+/**
+ * Count the keys of every partition in the task's cells (scatter false),
+ * or write them at the partition cursors (scatter true). The first count
+ * of the edge round also validates cells and marks vertices.
+ */
+static void mesh_emit(mesh_task_t* task, bool scatter) {
+    mesh_build_t* build = task->build;
+    const rtka_mesh_connectivity_t* mesh = build->mesh;
+    size_t* cursor = build->cursor + task->index * MESH_PARTITIONS;
+    bool validate = !build->faces && !scatter;
+
+    for (size_t cell = task->first_cell; cell < task->last_cell; cell++) {
+        size_t count = 0U;
+        const unsigned int* vertices = mesh_cell(mesh, cell, &count);
+        const mesh_shape_t* shape = mesh_shape(count);
+
+        if (validate) {
+            if (shape == NULL) {
+                task->status = RTKA_CORR_ERROR_INVALID_SIZE;
+                return;
+            }
+            for (size_t idx = 0U; idx < count; idx++) {
+                unsigned int vertex = vertices[idx];
+                if (vertex >= mesh->num_vertices) {
+                    task->status = RTKA_CORR_ERROR_INVALID_RANGE;
+                    return;
+                }
+                atomic_fetch_or_explicit(&build->referenced[vertex / 64U], 1ULL << (vertex % 64U),
+                                         memory_order_relaxed);
+            }
+        }
+
+        if (!build->faces) {
+            for (size_t idx = 0U; idx < shape->edges; idx++) {
+                uint64_t key = mesh_edge_key(vertices[shape->edge[idx][0]], vertices[shape->edge[idx][1]]);
+                size_t part = mesh_partition(mesh_mix64(key));
+                if (scatter) {
+                    build->edge_keys[cursor[part]++] = key;
+                } else {
+                    cursor[part]++;
+                }
+            }
+        } else {
+            for (size_t idx = 0U; idx < shape->faces; idx++) {
+                mesh_face_key_t key = mesh_face_key(vertices, shape->face[idx]);
+                size_t part = mesh_partition(mesh_face_hash(key));
+                if (scatter) {
+                    build->face_keys[cursor[part]++] = key;
+                } else {
+                    cursor[part]++;
+                }
+            }
+        }
+    }
+}
+
+static void* mesh_count_worker(void* arg) {
+    mesh_emit((mesh_task_t*)arg, false);
+    return NULL;
+}
+
+static void* mesh_scatter_worker(void* arg) {
+    mesh_emit((mesh_task_t*)arg, true);
+    return NULL;
+}
+
+/**
+ * Distinct keys of the task's partitions, through one table sized for
+ * the largest of them; linear probing on the low hash bits
+ */
+static void* mesh_dedupe_worker(void* arg) {
+    mesh_task_t* task = (mesh_task_t*)arg;
+    mesh_build_t* build = task->build;
+    size_t largest = 0U;
+
+    for (size_t part = task->index; part < MESH_PARTITIONS; part += build->num_threads) {
+        size_t size = build->start[part + 1U] - build->start[part];
+        largest = size > largest ? size : largest;
+    }
+
+    size_t capacity = 16U;
+    while (capacity < 2U * largest) {
+        capacity *= 2U;
+    }
+    mesh_face_key_t* table = malloc(capacity * sizeof(mesh_face_key_t));
+    uint32_t* uses = build->faces ? malloc(capacity * sizeof(uint32_t)) : NULL;
+    if (table == NULL || (build->faces && uses == NULL)) {
+        free(table);
+        free(uses);
+        task->status = RTKA_CORR_ERROR_ALLOCATION;
+        return NULL;
+    }
+
+    for (size_t part = task->index; part < MESH_PARTITIONS; part += build->num_threads) {
+        size_t first = build->start[part];
+        size_t size = build->start[part + 1U] - first;
+        size_t slots = 16U;
+        while (slots < 2U * size) {
+            slots *= 2U;
+        }
+        size_t mask = slots - 1U;
+
+        for (size_t slot = 0U; slot < slots; slot++) {
+            table[slot].lo = MESH_EMPTY;
+        }
+        if (!build->faces) {
+            for (size_t idx = 0U; idx < size; idx++) {
+                uint64_t key = build->edge_keys[first + idx];
+                size_t slot = (size_t)mesh_mix64(key) & mask;
+                while (table[slot].lo != MESH_EMPTY && table[slot].lo != key) {
+                    slot = (slot + 1U) & mask;
+                }
+                task->distinct += table[slot].lo == MESH_EMPTY ? 1U : 0U;
+                table[slot].lo = key;
+            }
+            continue;
+        }
+
+        for (size_t idx = 0U; idx < size; idx++) {
+            mesh_face_key_t key = build->face_keys[first + idx];
+            size_t slot = (size_t)mesh_face_hash(key) & mask;
+            while (table[slot].lo != MESH_EMPTY && (table[slot].lo != key.lo || table[slot].hi != key.hi)) {
+                slot = (slot + 1U) & mask;
+            }
+            if (table[slot].lo == MESH_EMPTY) {
+                table[slot] = key;
+                uses[slot] = 0U;
+                task->distinct++;
+            }
+            uses[slot]++;
+        }
+        for (size_t slot = 0U; slot < slots; slot++) {
+            if (table[slot].lo != MESH_EMPTY) {
+                task->boundary += uses[slot] == 1U ? 1U : 0U;
+                task->nonmanifold += uses[slot] > 2U ? 1U : 0U;
+            }
+        }
+    }
+
+    free(table);
+    free(uses);
+    return NULL;
+}
+
+/**
+ * One round over edges or faces: count, size partitions, scatter,
+ * deduplicate. Totals are summed into the first task.
+ */
+static rtka_corr_error_t mesh_round(mesh_build_t* build, mesh_task_t* tasks) {
+    size_t num_threads = build->num_threads;
+
+    memset(build->cursor, 0, num_threads * MESH_PARTITIONS * sizeof(size_t));
+    if (!cfd_run_tasks(mesh_count_worker, tasks, sizeof(mesh_task_t), num_threads)) {
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+    for (size_t thr = 0U; thr < num_threads; thr++) {
+        if (tasks[thr].status != RTKA_CORR_SUCCESS) {
+            return tasks[thr].status;
+        }
+    }
+
+    /* Partition-major layout; each thread writes its own span of each */
+    size_t total = 0U;
+    for (size_t part = 0U; part < MESH_PARTITIONS; part++) {
+        build->start[part] = total;
+        for (size_t thr = 0U; thr < num_threads; thr++) {
+            size_t count = build->cursor[thr * MESH_PARTITIONS + part];
+            build->cursor[thr * MESH_PARTITIONS + part] = total;
+            total += count;
+        }
+    }
+    build->start[MESH_PARTITIONS] = total;
+
+    if (build->faces) {
+        build->face_keys = malloc((total > 0U ? total : 1U) * sizeof(mesh_face_key_t));
+    } else {
+        build->edge_keys = malloc((total > 0U ? total : 1U) * sizeof(uint64_t));
+    }
+    if ((build->faces ? (void*)build->face_keys : (void*)build->edge_keys) == NULL) {
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+
+    bool ok = cfd_run_tasks(mesh_scatter_worker, tasks, sizeof(mesh_task_t), num_threads) &&
+              cfd_run_tasks(mesh_dedupe_worker, tasks, sizeof(mesh_task_t), num_threads);
+
+    free(build->edge_keys);
+    free(build->face_keys);
+    build->edge_keys = NULL;
+    build->face_keys = NULL;
+    if (!ok) {
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+
+    for (size_t thr = 1U; thr < num_threads; thr++) {
+        if (tasks[thr].status != RTKA_CORR_SUCCESS) {
+            return tasks[thr].status;
+        }
+        tasks[0].distinct += tasks[thr].distinct;
+        tasks[0].boundary += tasks[thr].boundary;
+        tasks[0].nonmanifold += tasks[thr].nonmanifold;
+    }
+    return tasks[0].status;
+}
+
+rtka_corr_error_t rtka_mesh_topology_from_connectivity(
+    const rtka_mesh_connectivity_t* connectivity,
+    size_t num_threads,
+    rtka_mesh_topology_t* topology
+) {
+    if (connectivity == NULL || topology == NULL ||
+        (connectivity->cell_vertices == NULL && connectivity->num_cells > 0U)) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    /* UINT32_MAX pads triangle keys, so it cannot be a vertex */
+    if (connectivity->num_cells == 0U || connectivity->num_vertices > UINT32_MAX) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+
+    num_threads = cfd_default_threads(num_threads);
+    if (num_threads > connectivity->num_cells) {
+        num_threads = connectivity->num_cells;
+    }
+    if (num_threads > MESH_PARTITIONS) {
+        num_threads = MESH_PARTITIONS;
+    }
+
+    size_t words = connectivity->num_vertices / 64U + 1U;
+    mesh_build_t build = { connectivity, num_threads, false, NULL, NULL, NULL, NULL, NULL };
+    build.cursor = malloc(num_threads * MESH_PARTITIONS * sizeof(size_t));
+    build.start = malloc((MESH_PARTITIONS + 1U) * sizeof(size_t));
+    build.referenced = calloc(words, sizeof(uint64_t));
+    mesh_task_t* tasks = calloc(num_threads, sizeof(mesh_task_t));
+    rtka_corr_error_t err = RTKA_CORR_SUCCESS;
+    if (build.cursor == NULL || build.start == NULL || build.referenced == NULL || tasks == NULL) {
+        err = RTKA_CORR_ERROR_ALLOCATION;
+    }
+
+    for (size_t thr = 0U; err == RTKA_CORR_SUCCESS && thr < num_threads; thr++) {
+        tasks[thr].build = &build;
+        tasks[thr].index = thr;
+        tasks[thr].first_cell = connectivity->num_cells * thr / num_threads;
+        tasks[thr].last_cell = connectivity->num_cells * (thr + 1U) / num_threads;
+    }
+
+    size_t edges = 0U;
+    if (err == RTKA_CORR_SUCCESS) {
+        err = mesh_round(&build, tasks);
+        edges = tasks[0].distinct;
+    }
+    if (err == RTKA_CORR_SUCCESS) {
+        for (size_t thr = 0U; thr < num_threads; thr++) {
+            tasks[thr].distinct = 0U;
+        }
+        build.faces = true;
+        err = mesh_round(&build, tasks);
+    }
+
+    if (err == RTKA_CORR_SUCCESS) {
+        size_t vertices = 0U;
+        for (size_t word = 0U; word < words; word++) {
+            vertices += (size_t)__builtin_popcountll(atomic_load_explicit(&build.referenced[word],
+                                                                          memory_order_relaxed));
+        }
+        topology->vertices = vertices;
+        topology->edges = edges;
+        topology->faces = tasks[0].distinct;
+        topology->cells = connectivity->num_cells;
+        topology->boundary_faces = tasks[0].boundary;
+        topology->nonmanifold_faces = tasks[0].nonmanifold;
+        err = rtka_mesh_euler_characteristic(topology);
+    }
+
+    free(build.cursor);
+    free(build.start);
+    free((void*)build.referenced);
+    free(tasks);
+    return err;
+}
+
+/* ============================================================================
+ * MESH QUALITY ANALYSIS - IMPLEMENTATION
+ * ============================================================================ */
+
+static void cfd_view_soa(
+    cfd_view_t* view,
+    const rtka_cell_quality_soa_t* mesh,
+    const rtka_solution_quality_soa_t* solution
+) {
+    view->field[CFD_ASPECT] = mesh->aspect_ratio;
+    view->field[CFD_SKEWNESS] = mesh->skewness;
+    view->field[CFD_VOLUME] = mesh->volume;
+    view->field[CFD_ORTHOGONALITY] = mesh->orthogonality;
+    view->num_fields = CFD_MESH_FIELDS;
+    if (solution != NULL) {
+        view->field[CFD_RESIDUAL] = solution->residual;
+        view->field[CFD_TRUNCATION] = solution->truncation_err;
+        view->field[CFD_GRADIENT] = solution->gradient_error;
+        view->num_fields = CFD_FIELDS;
+    }
+    for (size_t fld = 0U; fld < CFD_FIELDS; fld++) {
+        view->stride[fld] = 1U;
+    }
+}
+
+static void cfd_view_aos(
+    cfd_view_t* view,
+    const rtka_cell_quality_t* mesh,
+    const rtka_solution_quality_t* solution
+) {
+    size_t mesh_stride = sizeof(rtka_cell_quality_t) / sizeof(double);
+    size_t solution_stride = sizeof(rtka_solution_quality_t) / sizeof(double);
+
+    view->field[CFD_ASPECT] = &mesh->aspect_ratio;
+    view->field[CFD_SKEWNESS] = &mesh->skewness;
+    view->field[CFD_VOLUME] = &mesh->volume;
+    view->field[CFD_ORTHOGONALITY] = &mesh->orthogonality;
+    view->num_fields = CFD_MESH_FIELDS;
+    for (size_t fld = 0U; fld < CFD_MESH_FIELDS; fld++) {
+        view->stride[fld] = mesh_stride;
+    }
+    if (solution != NULL) {
+        view->field[CFD_RESIDUAL] = &solution->residual;
+        view->field[CFD_TRUNCATION] = &solution->truncation_err;
+        view->field[CFD_GRADIENT] = &solution->gradient_error;
+        view->num_fields = CFD_FIELDS;
+        for (size_t fld = CFD_MESH_FIELDS; fld < CFD_FIELDS; fld++) {
+            view->stride[fld] = solution_stride;
+        }
+    }
+}
+
+static rtka_corr_error_t cfd_assess_view(
+    cfd_view_t* view,
+    size_t num_cells,
+    double quality_threshold,
+    size_t num_threads,
+    rtka_mesh_stats_t* out_stats,
+    rtka_cfd_correlation_analysis_t* out_analysis
+) {
+    if (num_cells < RTKA_CORR_MIN_SAMPLES) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    if (!(quality_threshold >= 0.0 && quality_threshold <= 1.0)) {
+        return RTKA_CORR_ERROR_INVALID_RANGE;
+    }
+    for (size_t fld = 0U; fld < view->num_fields; fld++) {
+        if (view->field[fld] == NULL) {
+            return RTKA_CORR_ERROR_NULL_PTR;
+        }
+    }
+
+    view->num_cells = num_cells;
+    view->quality_threshold = quality_threshold;
+    cfd_moments_t moments;
+    rtka_corr_error_t err = cfd_reduce(view, num_threads, &moments);
+    if (err != RTKA_CORR_SUCCESS) {
+        return err;
+    }
+
+    if (out_stats != NULL) {
+        cfd_fill_stats_all(&moments, quality_threshold, out_stats);
+    }
+    if (out_analysis != NULL && view->num_fields == CFD_FIELDS) {
+        cfd_fill_analysis(&moments, out_analysis);
+    }
+
+    return RTKA_CORR_SUCCESS;
+}
+
+rtka_corr_error_t rtka_mesh_quality_statistics(
+    const rtka_cell_quality_t* quality_data,
+    size_t num_cells,
+    double quality_threshold,
+    rtka_mesh_stats_t* out_stats
+) {
+    if (quality_data == NULL || out_stats == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    cfd_view_t view;
+    cfd_view_aos(&view, quality_data, NULL);
+    return cfd_assess_view(&view, num_cells, quality_threshold, 0U, out_stats, NULL);
+}
+
+rtka_corr_error_t rtka_mesh_quality_statistics_soa(
+    const rtka_cell_quality_soa_t* quality_data,
+    size_t num_cells,
+    double quality_threshold,
+    rtka_mesh_stats_t* out_stats
+) {
+    return rtka_cfd_assess_mesh(quality_data, NULL, num_cells, quality_threshold, 0U, out_stats, NULL);
+}
+
+/* ============================================================================
+ * CORRELATION ANALYSIS FOR CFD - IMPLEMENTATION
+ * ============================================================================ */
+
+rtka_corr_error_t rtka_cfd_correlate_mesh_solution(
+    const rtka_cell_quality_t* mesh_quality,
+    const rtka_solution_quality_t* solution_quality,
+    size_t num_cells,
+    rtka_cfd_correlation_analysis_t* out_analysis
+) {
+    if (mesh_quality == NULL || solution_quality == NULL || out_analysis == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    cfd_view_t view;
+    cfd_view_aos(&view, mesh_quality, solution_quality);
+    return cfd_assess_view(&view, num_cells, 0.0, 0U, NULL, out_analysis);
+}
+
+rtka_corr_error_t rtka_cfd_correlate_mesh_solution_soa(
+    const rtka_cell_quality_soa_t* mesh_quality,
+    const rtka_solution_quality_soa_t* solution_quality,
+    size_t num_cells,
+    rtka_cfd_correlation_analysis_t* out_analysis
+) {
+    if (solution_quality == NULL || out_analysis == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    return rtka_cfd_assess_mesh(mesh_quality, solution_quality, num_cells, 0.0, 0U, NULL, out_analysis);
+}
+
+rtka_corr_error_t rtka_cfd_assess_mesh(
+    const rtka_cell_quality_soa_t* mesh_quality,
+    const rtka_solution_quality_soa_t* solution_quality,
+    size_t num_cells,
+    double quality_threshold,
+    size_t num_threads,
+    rtka_mesh_stats_t* out_stats,
+    rtka_cfd_correlation_analysis_t* out_analysis
+) {
+    if (mesh_quality == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    cfd_view_t view;
+    cfd_view_soa(&view, mesh_quality, solution_quality);
+    return cfd_assess_view(&view, num_cells, quality_threshold, num_threads, out_stats, out_analysis);
+}
+
+/* ============================================================================
+ * MESH FIELD FILES - IMPLEMENTATION
+ * ============================================================================ */
+
+/**
+ * Write one field, or zeros for a NULL field
+ */
+static bool cfd_write_field(FILE* file, const double* values, size_t num_cells) {
+    if (values != NULL) {
+        return fwrite(values, sizeof(double), num_cells, file) == num_cells;
+    }
+
+    static const double zeros[RTKA_CFD_CHUNK_CELLS] = {0.0};
+    for (size_t first = 0U; first < num_cells; first += RTKA_CFD_CHUNK_CELLS) {
+        size_t count = num_cells - first < RTKA_CFD_CHUNK_CELLS ? num_cells - first : RTKA_CFD_CHUNK_CELLS;
+        if (fwrite(zeros, sizeof(double), count, file) != count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+rtka_corr_error_t rtka_cfd_mesh_file_write(
+    const char* path,
+    const rtka_cell_quality_soa_t* mesh_quality,
+    const rtka_solution_quality_soa_t* solution_quality,
+    size_t num_cells
+) {
+    if (path == NULL || mesh_quality == NULL || solution_quality == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+
+    const double* fields[CFD_FILE_FIELDS] = {
+        mesh_quality->aspect_ratio, mesh_quality->skewness, mesh_quality->volume,
+        mesh_quality->orthogonality, mesh_quality->stretch,
+        solution_quality->residual, solution_quality->gradient_error,
+        solution_quality->truncation_err, solution_quality->y_plus
+    };
+    for (size_t fld = 0U; fld < CFD_FILE_FIELDS; fld++) {
+        /* Only stretch and y_plus are optional */
+        if (fields[fld] == NULL && fld != 4U && fld != 8U) {
+            return RTKA_CORR_ERROR_NULL_PTR;
+        }
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return RTKA_CORR_ERROR_IO;
+    }
+
+    cfd_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CFD_FILE_MAGIC, sizeof(header.magic));
+    header.version = CFD_FILE_VERSION;
+    header.fields = CFD_FILE_FIELDS;
+    header.num_cells = (uint64_t)num_cells;
+
+    bool ok = fwrite(&header, sizeof(header), 1U, file) == 1U;
+    for (size_t fld = 0U; ok && fld < CFD_FILE_FIELDS; fld++) {
+        ok = cfd_write_field(file, fields[fld], num_cells);
+    }
+    ok = fclose(file) == 0 && ok;
+
+    return ok ? RTKA_CORR_SUCCESS : RTKA_CORR_ERROR_IO;
+}
+
+rtka_corr_error_t rtka_cfd_mesh_file_open(
+    const char* path,
+    rtka_cfd_mesh_file_t* out_file
+) {
+    if (path == NULL || out_file == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    memset(out_file, 0, sizeof(*out_file));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return RTKA_CORR_ERROR_IO;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return RTKA_CORR_ERROR_IO;
+    }
+
+    cfd_file_header_t header;
+    if (info.st_size < (off_t)sizeof(header) ||
+        pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        close(fd);
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+
+    /* Header, then nine arrays of exactly num_cells doubles */
+    uint64_t max_cells = (SIZE_MAX - CFD_FILE_HEADER) / (CFD_FILE_FIELDS * sizeof(double));
+    if (memcmp(header.magic, CFD_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CFD_FILE_VERSION || header.fields != CFD_FILE_FIELDS ||
+        header.num_cells < RTKA_CORR_MIN_SAMPLES || header.num_cells > max_cells ||
+        (uint64_t)info.st_size != CFD_FILE_HEADER + header.num_cells * CFD_FILE_FIELDS * sizeof(double)) {
+        close(fd);
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+
+    size_t length = (size_t)info.st_size;
+    void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return RTKA_CORR_ERROR_IO;
+    }
+    posix_madvise(base, length, POSIX_MADV_SEQUENTIAL);
+
+    size_t n = (size_t)header.num_cells;
+    const double* fields = (const double*)((const char*)base + CFD_FILE_HEADER);
+    out_file->base = base;
+    out_file->length = length;
+    out_file->num_cells = n;
+    out_file->mesh = (rtka_cell_quality_soa_t){
+        fields, fields + n, fields + 2U * n, fields + 3U * n, fields + 4U * n
+    };
+    out_file->solution = (rtka_solution_quality_soa_t){
+        fields + 5U * n, fields + 6U * n, fields + 7U * n, fields + 8U * n
+    };
+
+    return RTKA_CORR_SUCCESS;
+}
+
+void rtka_cfd_mesh_file_close(rtka_cfd_mesh_file_t* file) {
+    if (file != NULL && file->base != NULL) {
+        munmap(file->base, file->length);
+        memset(file, 0, sizeof(*file));
+    }
+}
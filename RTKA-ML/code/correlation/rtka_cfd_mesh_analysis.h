@@ -21,6 +21,13 @@
  *   - Mesh quality metrics (aspect ratio, skewness, volume)
  *   - Correlation with solution metrics (residuals, errors)
  *   - Multi-mesh comparison analysis
+ * 2025-11-30: Large meshes
+ *   - Structure-of-arrays input views, AoS entry points on the same core
+ *   - Field files mapped read-only instead of loaded
+ *   - Statistics and correlations in one threaded pass
+ * 2025-12-07: Topology from connectivity
+ *   - V, E, F, C of tetrahedra, pyramids, wedges and hexahedra
+ *   - Hash-partitioned edge and face deduplication over threads
  */
 
 #ifndef RTKA_CFD_MESH_ANALYSIS_H
@@ -47,8 +54,25 @@ typedef struct {
     int euler_char;     /* χ = V - E + F - C */
     int expected_char;  /* Expected value (interior voids + 1) */
     bool is_valid;      /* Topology validation result */
+    size_t boundary_faces;     /* Faces of one cell (from connectivity) */
+    size_t nonmanifold_faces;  /* Faces of more than two cells (from connectivity) */
 } rtka_mesh_topology_t;
 
+/**
+ * Cell-to-vertex connectivity of an unstructured 3D mesh
+ *
+ * Cells are identified by their vertex count, vertices in VTK order:
+ *   4 tetrahedron, 5 pyramid (base 0-3, apex 4),
+ *   6 wedge (triangles 0-2 and 3-5), 8 hexahedron (faces 0-3 and 4-7)
+ */
+typedef struct {
+    const size_t* cell_offsets;        /* num_cells + 1 starts into cell_vertices, or NULL */
+    const unsigned int* cell_vertices; /* Vertex indices of every cell in turn */
+    size_t vertices_per_cell;          /* Every cell's count when cell_offsets is NULL */
+    size_t num_cells;
+    size_t num_vertices;               /* Indices must be below this */
+} rtka_mesh_connectivity_t;
+
 /**
  * Mesh quality metrics per cell
  */
@@ -70,6 +94,51 @@ typedef struct {
     double y_plus;          /* Wall distance metric (if applicable) */
 } rtka_solution_quality_t;
 
+/**
+ * Mesh quality fields as separate arrays (structure of arrays)
+ */
+typedef struct {
+    const double* aspect_ratio;
+    const double* skewness;
+    const double* volume;
+    const double* orthogonality;
+    const double* stretch;
+} rtka_cell_quality_soa_t;
+
+/**
+ * Solution quality fields as separate arrays (structure of arrays)
+ */
+typedef struct {
+    const double* residual;
+    const double* gradient_error;
+    const double* truncation_err;
+    const double* y_plus;
+} rtka_solution_quality_soa_t;
+
+/**
+ * Cell fields mapped from a file; the views point into the mapping
+ *
+ * File layout, native byte order:
+ *   bytes 0-7    magic "RTKAMESH"
+ *   bytes 8-11   version (1), 32-bit
+ *   bytes 12-15  field count (9), 32-bit
+ *   bytes 16-23  number of cells, 64-bit
+ *   bytes 24-63  zero
+ *   then one array of doubles per field, num_cells each, in the order
+ *   aspect_ratio, skewness, volume, orthogonality, stretch, residual,
+ *   gradient_error, truncation_err, y_plus
+ */
+typedef struct {
+    void* base;                             /* Mapping, NULL when closed */
+    size_t length;                          /* Bytes mapped */
+    size_t num_cells;
+    rtka_cell_quality_soa_t mesh;
+    rtka_solution_quality_soa_t solution;
+} rtka_cfd_mesh_file_t;
+
+/* Cells reduced per block before folding into a thread's totals */
+#define RTKA_CFD_CHUNK_CELLS 2048U
+
 /* ============================================================================
  * MESH STATISTICS
  * ============================================================================ */
@@ -141,6 +210,34 @@ bool rtka_mesh_validate_topology(
     int expected
 );
 
+/**
+ * Count vertices, edges, faces and cells from connectivity
+ * 
+ * @param connectivity Cells of the mesh
+ * @param num_threads Threads, 0 for one per online processor
+ * @param topology Receives the counts, χ and is_valid against its
+ *                 expected_char, which the caller sets
+ * @return Error code
+ * 
+ * Complexity: O(C) expected time, about 12 bytes per edge and 20 per
+ * face of every cell in flight, edges and faces in turn
+ * 
+ * V counts the distinct vertices referenced. Each thread takes a range of
+ * cells and emits every cell's edges and faces as sorted vertex keys,
+ * partitioned by hash; a count pass sizes the partitions so a second
+ * pass scatters without locks. Threads then deduplicate whole partitions
+ * in open-addressing tables, so shared edges and faces are counted once,
+ * and faces used by one cell (boundary) or more than two (non-manifold)
+ * are reported too. Returns RTKA_CORR_ERROR_INVALID_SIZE for an unknown
+ * cell vertex count or more than 2^32 - 1 vertices and
+ * RTKA_CORR_ERROR_INVALID_RANGE for a vertex index out of range.
+ */
+rtka_corr_error_t rtka_mesh_topology_from_connectivity(
+    const rtka_mesh_connectivity_t* connectivity,
+    size_t num_threads,
+    rtka_mesh_topology_t* topology
+);
+
 /* ============================================================================
  * MESH QUALITY ANALYSIS
  * ============================================================================ */
@@ -153,6 +250,10 @@ bool rtka_mesh_validate_topology(
  * @param quality_threshold Threshold for poor quality (typical: 0.3-0.5)
  * @param out_stats Output statistics structure
  * @return Error code
+ * 
+ * A cell is poor when min(orthogonality, 1 - skewness) is below the
+ * threshold. Returns RTKA_CORR_ERROR_INVALID_RANGE for a threshold
+ * outside [0, 1].
  */
 rtka_corr_error_t rtka_mesh_quality_statistics(
     const rtka_cell_quality_t* quality_data,
@@ -161,6 +262,24 @@ rtka_corr_error_t rtka_mesh_quality_statistics(
     rtka_mesh_stats_t* out_stats
 );
 
+/**
+ * Calculate mesh quality statistics from separate field arrays
+ * 
+ * @param quality_data Field arrays; stretch may be NULL
+ * @param num_cells Number of cells
+ * @param quality_threshold Threshold for poor quality (typical: 0.3-0.5)
+ * @param out_stats Output statistics structure
+ * @return Error code
+ * 
+ * Same results as rtka_mesh_quality_statistics(), on every online CPU.
+ */
+rtka_corr_error_t rtka_mesh_quality_statistics_soa(
+    const rtka_cell_quality_soa_t* quality_data,
+    size_t num_cells,
+    double quality_threshold,
+    rtka_mesh_stats_t* out_stats
+);
+
 /* ============================================================================
  * CORRELATION ANALYSIS FOR CFD
  * ============================================================================ */
@@ -189,6 +308,103 @@ rtka_corr_error_t rtka_cfd_correlate_mesh_solution(
     rtka_cfd_correlation_analysis_t* out_analysis
 );
 
+/**
+ * Correlate mesh quality with solution quality from separate field arrays
+ * 
+ * @param mesh_quality Mesh field arrays; stretch may be NULL
+ * @param solution_quality Solution field arrays; y_plus may be NULL
+ * @param num_cells Number of cells
+ * @param out_analysis Output correlation analysis
+ * @return Error code
+ * 
+ * Same results as rtka_cfd_correlate_mesh_solution(), on every online CPU.
+ */
+rtka_corr_error_t rtka_cfd_correlate_mesh_solution_soa(
+    const rtka_cell_quality_soa_t* mesh_quality,
+    const rtka_solution_quality_soa_t* solution_quality,
+    size_t num_cells,
+    rtka_cfd_correlation_analysis_t* out_analysis
+);
+
+/**
+ * Mesh statistics and mesh-solution correlations in one pass
+ * 
+ * @param mesh_quality Mesh field arrays; stretch may be NULL
+ * @param solution_quality Solution field arrays, or NULL for statistics only
+ * @param num_cells Number of cells
+ * @param quality_threshold Threshold for poor quality (typical: 0.3-0.5)
+ * @param num_threads Threads, 0 for one per online processor
+ * @param out_stats Output statistics (can be NULL)
+ * @param out_analysis Output correlation analysis (can be NULL)
+ * @return Error code
+ * 
+ * Complexity: O(n) in a single read of each field used
+ * 
+ * Each thread takes a contiguous range of cells and reduces it in blocks
+ * of RTKA_CFD_CHUNK_CELLS: means of the block, then centered squares and
+ * products while the block is in cache, folded into the thread's totals
+ * with Chan's update. Thread totals are merged in cell order, so results
+ * depend on the thread count only through rounding. Correlations are
+ * aspect ratio and skewness vs residual, volume vs truncation error and
+ * orthogonality vs gradient error; a zero-variance field correlates 0.0.
+ * Returns RTKA_CORR_ERROR_ALLOCATION when the threads cannot be started.
+ */
+rtka_corr_error_t rtka_cfd_assess_mesh(
+    const rtka_cell_quality_soa_t* mesh_quality,
+    const rtka_solution_quality_soa_t* solution_quality,
+    size_t num_cells,
+    double quality_threshold,
+    size_t num_threads,
+    rtka_mesh_stats_t* out_stats,
+    rtka_cfd_correlation_analysis_t* out_analysis
+);
+
+/* ============================================================================
+ * MESH FIELD FILES
+ * ============================================================================ */
+
+/**
+ * Write cell fields in the rtka_cfd_mesh_file_t layout
+ * 
+ * @param path File to create or replace
+ * @param mesh_quality Mesh field arrays; a NULL stretch is written as zeros
+ * @param solution_quality Solution field arrays; a NULL y_plus is written as zeros
+ * @param num_cells Number of cells
+ * @return Error code (RTKA_CORR_ERROR_IO when the file cannot be written)
+ */
+rtka_corr_error_t rtka_cfd_mesh_file_write(
+    const char* path,
+    const rtka_cell_quality_soa_t* mesh_quality,
+    const rtka_solution_quality_soa_t* solution_quality,
+    size_t num_cells
+);
+
+/**
+ * Map a cell field file read-only
+ * 
+ * @param path File written by rtka_cfd_mesh_file_write()
+ * @param out_file Receives the mapping and field views
+ * @return Error code
+ * 
+ * Pages are read on demand and shared with the page cache, so a mesh
+ * larger than memory can be assessed without a copy. Returns
+ * RTKA_CORR_ERROR_IO when the file cannot be opened or mapped and
+ * RTKA_CORR_ERROR_INVALID_SIZE for a bad header or truncated file.
+ * 
+ * Note: Caller must release with rtka_cfd_mesh_file_close()
+ */
+rtka_corr_error_t rtka_cfd_mesh_file_open(
+    const char* path,
+    rtka_cfd_mesh_file_t* out_file
+);
+
+/**
+ * Unmap a cell field file
+ * 
+ * @param file Mapped file; views are invalid afterwards
+ */
+void rtka_cfd_mesh_file_close(rtka_cfd_mesh_file_t* file);
+
 /**
  * Compare multiple meshes using correlation analysis
  * 
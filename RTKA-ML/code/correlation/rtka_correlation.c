@@ -10,7 +10,7 @@
  * 
  * Optimizations:
  * - Single-pass algorithms where possible
- * - Kahan summation for numerical stability
+ * - Pairwise summation in SIMD lanes for numerical stability
  * - Early validation to avoid unnecessary computation
  * - Leverages standard library math functions (sqrt, etc.)
  * - Cache-friendly access patterns
@@ -22,9 +22,23 @@
  *   - Correlation matrix computation
  *   - Numerical stability through Kahan summation
  *   - Comprehensive error handling
+ * 2025-11-02: Blocked correlation matrix
+ *   - Per-panel centered packing, SYRK micro-kernels over 8-variable groups
+ *   - Upper-triangle tiles split over POSIX threads
+ * 2025-11-09: Streaming correlation
+ *   - Welford/Chan accumulator with batched push and shard merge
+ * 2025-11-16: Pairwise summation
+ *   - Mean, variance and covariance sum 256-term blocks in 8 lanes and
+ *     combine blocks as a tree, replacing the scalar Kahan loops
+ * 2025-11-23: Sparse correlation
+ *   - Count-sketch estimates of every pair, tiled for cache reuse
+ *   - Threshold and top-k pruning, exact coefficients for candidates
  */
 
+#define _POSIX_C_SOURCE 200809L
 #include "rtka_correlation.h"
+#include <pthread.h>
+#include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -34,22 +48,113 @@
  * INTERNAL HELPER FUNCTIONS
  * ============================================================================ */
 
+/*
+ * Pairwise summation: blocks of CORR_SUM_BLOCK terms summed in
+ * CORR_SUM_LANES independent lanes, which vectorize, and block sums
+ * combined as a binary tree. The error bound grows with log2 of the block
+ * count instead of the term count, and it holds under -ffast-math, which
+ * folds a Kahan compensation term to zero.
+ */
+#define CORR_SUM_LANES 8U
+#define CORR_SUM_BLOCK 256U
+
+typedef enum {
+    CORR_SUM_VALUES,              /* Σ x */
+    CORR_SUM_SQUARES,             /* Σ (x - x̄)² */
+    CORR_SUM_PRODUCTS             /* Σ (x - x̄)(y - ȳ) */
+} corr_sum_kind_t;
+
+static inline double corr_lanes_total(const double* lanes) {
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+static inline double corr_block_sum(
+    corr_sum_kind_t kind,
+    const double* x_data,
+    const double* y_data,
+    size_t count,
+    double x_mean,
+    double y_mean
+) {
+    double lanes[CORR_SUM_LANES] = {0.0};
+    size_t full = count - count % CORR_SUM_LANES;
+    
+    switch (kind) {
+    case CORR_SUM_VALUES:
+        for (size_t idx = 0U; idx < full; idx += CORR_SUM_LANES) {
+            for (size_t lane = 0U; lane < CORR_SUM_LANES; lane++) {
+                lanes[lane] += x_data[idx + lane];
+            }
+        }
+        for (size_t idx = full; idx < count; idx++) {
+            lanes[idx - full] += x_data[idx];
+        }
+        break;
+    case CORR_SUM_SQUARES:
+        for (size_t idx = 0U; idx < full; idx += CORR_SUM_LANES) {
+            for (size_t lane = 0U; lane < CORR_SUM_LANES; lane++) {
+                double deviation = x_data[idx + lane] - x_mean;
+                lanes[lane] += deviation * deviation;
+            }
+        }
+        for (size_t idx = full; idx < count; idx++) {
+            double deviation = x_data[idx] - x_mean;
+            lanes[idx - full] += deviation * deviation;
+        }
+        break;
+    case CORR_SUM_PRODUCTS:
+        for (size_t idx = 0U; idx < full; idx += CORR_SUM_LANES) {
+            for (size_t lane = 0U; lane < CORR_SUM_LANES; lane++) {
+                lanes[lane] += (x_data[idx + lane] - x_mean) * (y_data[idx + lane] - y_mean);
+            }
+        }
+        for (size_t idx = full; idx < count; idx++) {
+            lanes[idx - full] += (x_data[idx] - x_mean) * (y_data[idx] - y_mean);
+        }
+        break;
+    }
+    
+    return corr_lanes_total(lanes);
+}
+
 /**
- * Kahan summation algorithm for numerically stable sum
+ * Pairwise sum of count terms of the given kind
  * OPT pattern for numerical stability
  */
-static inline double kahan_sum(const double* data, size_t count) {
-    double sum = 0.0;
-    double compensation = 0.0;
+static double corr_pairwise_sum(
+    corr_sum_kind_t kind,
+    const double* x_data,
+    const double* y_data,
+    size_t count,
+    double x_mean,
+    double y_mean
+) {
+    /* level[d] holds the sum of 2^d blocks while bit d of blocks is set */
+    double level[sizeof(size_t) * 8U];
+    size_t blocks = 0U;
     
-    for (size_t idx = 0U; idx < count; idx++) {
-        double corrected = data[idx] - compensation;
-        double new_sum = sum + corrected;
-        compensation = (new_sum - sum) - corrected;
-        sum = new_sum;
+    for (size_t first = 0U; first < count; first += CORR_SUM_BLOCK) {
+        size_t length = count - first < CORR_SUM_BLOCK ? count - first : CORR_SUM_BLOCK;
+        double sum = corr_block_sum(kind, x_data + first, y_data != NULL ? y_data + first : NULL,
+                                    length, x_mean, y_mean);
+        size_t carry = blocks++;
+        size_t depth = 0U;
+        while ((carry & 1U) != 0U) {
+            sum += level[depth++];
+            carry >>= 1U;
+        }
+        level[depth] = sum;
     }
     
-    return sum;
+    double total = 0.0;
+    for (size_t depth = 0U; blocks != 0U; depth++, blocks >>= 1U) {
+        if ((blocks & 1U) != 0U) {
+            total += level[depth];
+        }
+    }
+    
+    return total;
 }
 
 /**
@@ -88,8 +193,7 @@ rtka_corr_error_t rtka_corr_mean(
         return RTKA_CORR_ERROR_NULL_PTR;
     }
     
-    /* Use Kahan summation for numerical stability */
-    double sum = kahan_sum(data, count);
+    double sum = corr_pairwise_sum(CORR_SUM_VALUES, data, NULL, count, 0.0, 0.0);
     *out_mean = sum / (double)count;
     
     return RTKA_CORR_SUCCESS;
@@ -116,18 +220,7 @@ rtka_corr_error_t rtka_corr_variance(
         }
     }
     
-    /* Calculate sum of squared deviations using Kahan summation */
-    double sum_sq = 0.0;
-    double compensation = 0.0;
-    
-    for (size_t idx = 0U; idx < count; idx++) {
-        double deviation = data[idx] - mean_val;
-        double sq_dev = deviation * deviation;
-        double corrected = sq_dev - compensation;
-        double new_sum = sum_sq + corrected;
-        compensation = (new_sum - sum_sq) - corrected;
-        sum_sq = new_sum;
-    }
+    double sum_sq = corr_pairwise_sum(CORR_SUM_SQUARES, data, NULL, count, mean_val, 0.0);
     
     /* Sample variance uses (n-1) denominator */
     double variance = sum_sq / (double)(count - 1U);
@@ -179,19 +272,8 @@ rtka_corr_error_t rtka_corr_covariance(
         }
     }
     
-    /* Calculate sum of products of deviations using Kahan summation */
-    double sum_prod = 0.0;
-    double compensation = 0.0;
-    
-    for (size_t idx = 0U; idx < count; idx++) {
-        double x_dev = x_data[idx] - x_mean_val;
-        double y_dev = y_data[idx] - y_mean_val;
-        double product = x_dev * y_dev;
-        double corrected = product - compensation;
-        double new_sum = sum_prod + corrected;
-        compensation = (new_sum - sum_prod) - corrected;
-        sum_prod = new_sum;
-    }
+    double sum_prod = corr_pairwise_sum(CORR_SUM_PRODUCTS, x_data, y_data, count,
+                                        x_mean_val, y_mean_val);
     
     /* Sample covariance uses (n-1) denominator */
     *out_cov = sum_prod / (double)(count - 1U);
@@ -459,6 +541,1051 @@ rtka_corr_error_t rtka_corr_matrix_compute(
     return RTKA_CORR_SUCCESS;
 }
 
+/* ============================================================================
+ * BLOCKED CORRELATION MATRIX - IMPLEMENTATION
+ * ============================================================================ */
+
+/* Packed group: CORR_MR variables interleaved per sample, [k][r]. The
+ * kernels keep the sums in registers and broadcast one B value at a time;
+ * indexing B inside the inner loop makes GCC shuffle every iteration. */
+#define CORR_MR 8U
+/* Columns per double micro-kernel; the float kernel takes a whole group */
+#define CORR_NR 4U
+#define CORR_GROUPS_PER_TILE (RTKA_CORR_TILE_VARIABLES / CORR_MR)
+
+typedef struct {
+    const double* const* data;
+    size_t num_variables;
+    size_t num_samples;
+    size_t num_groups;            /* Groups of CORR_MR, last one zero-padded */
+    size_t num_tiles;
+    size_t num_pairs;             /* Tile pairs (ti <= tj) of the upper triangle */
+    size_t num_threads;
+    bool use_float;
+    double* means;
+    void* panel;                  /* num_groups x RTKA_CORR_PANEL_SAMPLES x CORR_MR */
+    double* cov;                  /* Upper triangle of Xc·Xcᵀ, n x n */
+    pthread_barrier_t barrier;
+    pthread_mutex_t lock;         /* Start gate: threads wait for the count */
+    pthread_cond_t start;
+    bool started;
+    bool failed;
+} corr_blocked_t;
+
+typedef struct {
+    corr_blocked_t* ctx;
+    size_t index;
+} corr_worker_t;
+
+/**
+ * 8 x 4 block of C from two packed groups, float64
+ */
+static void corr_kernel_double(
+    const double* restrict a,
+    const double* restrict b,
+    size_t kc,
+    double out[CORR_NR][CORR_MR]
+) {
+    double sum[CORR_NR][CORR_MR] = {{0.0}};
+    
+    for (size_t k = 0U; k < kc; k++) {
+        const double* ak = a + k * CORR_MR;
+        const double* bk = b + k * CORR_MR;
+        double column[CORR_MR];
+        for (size_t r = 0U; r < CORR_MR; r++) {
+            column[r] = ak[r];
+        }
+        for (size_t c = 0U; c < CORR_NR; c++) {
+            double scale = bk[c];
+            for (size_t r = 0U; r < CORR_MR; r++) {
+                sum[c][r] += column[r] * scale;
+            }
+        }
+    }
+    
+    for (size_t c = 0U; c < CORR_NR; c++) {
+        for (size_t r = 0U; r < CORR_MR; r++) {
+            out[c][r] = sum[c][r];
+        }
+    }
+}
+
+/**
+ * 8 x 8 block of C from two packed groups, float32
+ */
+static void corr_kernel_float(
+    const float* restrict a,
+    const float* restrict b,
+    size_t kc,
+    float out[CORR_MR][CORR_MR]
+) {
+    float sum[CORR_MR][CORR_MR] = {{0.0f}};
+    
+    for (size_t k = 0U; k < kc; k++) {
+        const float* ak = a + k * CORR_MR;
+        const float* bk = b + k * CORR_MR;
+        float column[CORR_MR];
+        for (size_t r = 0U; r < CORR_MR; r++) {
+            column[r] = ak[r];
+        }
+        for (size_t c = 0U; c < CORR_MR; c++) {
+            float scale = bk[c];
+            for (size_t r = 0U; r < CORR_MR; r++) {
+                sum[c][r] += column[r] * scale;
+            }
+        }
+    }
+    
+    for (size_t c = 0U; c < CORR_MR; c++) {
+        for (size_t r = 0U; r < CORR_MR; r++) {
+            out[c][r] = sum[c][r];
+        }
+    }
+}
+
+/**
+ * Center samples [k0, k0 + kc) of one group into the panel
+ */
+static void corr_pack_group(const corr_blocked_t* ctx, size_t group, size_t k0, size_t kc) {
+    size_t base = group * CORR_MR;
+    size_t offset = group * (size_t)RTKA_CORR_PANEL_SAMPLES * CORR_MR;
+    double* packed_d = (double*)ctx->panel + offset;
+    float* packed_f = (float*)ctx->panel + offset;
+    
+    for (size_t r = 0U; r < CORR_MR; r++) {
+        size_t var = base + r;
+        const double* row = var < ctx->num_variables ? ctx->data[var] + k0 : NULL;
+        double mean = row != NULL ? ctx->means[var] : 0.0;
+        
+        for (size_t k = 0U; k < kc; k++) {
+            double centered = row != NULL ? row[k] - mean : 0.0;
+            if (ctx->use_float) {
+                packed_f[k * CORR_MR + r] = (float)centered;
+            } else {
+                packed_d[k * CORR_MR + r] = centered;
+            }
+        }
+    }
+}
+
+/**
+ * Add one panel's groups (gi, gj) block into the covariance
+ */
+static void corr_group_pair(const corr_blocked_t* ctx, size_t gi, size_t gj, size_t kc) {
+    size_t n = ctx->num_variables;
+    size_t rows = n - gi * CORR_MR < CORR_MR ? n - gi * CORR_MR : CORR_MR;
+    size_t cols = n - gj * CORR_MR < CORR_MR ? n - gj * CORR_MR : CORR_MR;
+    size_t stride = (size_t)RTKA_CORR_PANEL_SAMPLES * CORR_MR;
+    double* cov = ctx->cov + gi * CORR_MR * n + gj * CORR_MR;
+    
+    if (ctx->use_float) {
+        const float* panel = (const float*)ctx->panel;
+        float block[CORR_MR][CORR_MR];
+        corr_kernel_float(panel + gi * stride, panel + gj * stride, kc, block);
+        for (size_t c = 0U; c < cols; c++) {
+            for (size_t r = 0U; r < rows; r++) {
+                cov[r * n + c] += (double)block[c][r];
+            }
+        }
+        return;
+    }
+    
+    const double* panel = (const double*)ctx->panel;
+    for (size_t half = 0U; half < CORR_MR; half += CORR_NR) {
+        if (half >= cols) {
+            break;
+        }
+        double block[CORR_NR][CORR_MR];
+        corr_kernel_double(panel + gi * stride, panel + gj * stride + half, kc, block);
+        size_t width = cols - half < CORR_NR ? cols - half : CORR_NR;
+        for (size_t c = 0U; c < width; c++) {
+            for (size_t r = 0U; r < rows; r++) {
+                cov[r * n + half + c] += block[c][r];
+            }
+        }
+    }
+}
+
+/**
+ * Upper-triangle tile pair index -> (ti, tj), row by row
+ */
+static void corr_pair_tiles(size_t pair, size_t num_tiles, size_t* ti, size_t* tj) {
+    size_t row = 0U;
+    size_t remaining = pair;
+    
+    while (remaining >= num_tiles - row) {
+        remaining -= num_tiles - row;
+        row++;
+    }
+    
+    *ti = row;
+    *tj = row + remaining;
+}
+
+static void* corr_worker(void* arg) {
+    corr_worker_t* worker = (corr_worker_t*)arg;
+    corr_blocked_t* ctx = worker->ctx;
+    size_t self = worker->index;
+    
+    pthread_mutex_lock(&ctx->lock);
+    while (!ctx->started) {
+        pthread_cond_wait(&ctx->start, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    if (ctx->failed) {
+        return NULL;
+    }
+    size_t step = ctx->num_threads;
+    
+    /* Means, summed as in rtka_corr_mean() */
+    for (size_t var = self; var < ctx->num_variables; var += step) {
+        ctx->means[var] = corr_pairwise_sum(CORR_SUM_VALUES, ctx->data[var], NULL, ctx->num_samples,
+                                            0.0, 0.0) / (double)ctx->num_samples;
+    }
+    pthread_barrier_wait(&ctx->barrier);
+    
+    for (size_t k0 = 0U; k0 < ctx->num_samples; k0 += RTKA_CORR_PANEL_SAMPLES) {
+        size_t kc = ctx->num_samples - k0;
+        if (kc > RTKA_CORR_PANEL_SAMPLES) {
+            kc = RTKA_CORR_PANEL_SAMPLES;
+        }
+        
+        for (size_t group = self; group < ctx->num_groups; group += step) {
+            corr_pack_group(ctx, group, k0, kc);
+        }
+        pthread_barrier_wait(&ctx->barrier);
+        
+        /* Each thread owns whole tiles of C, so no two write one entry */
+        for (size_t pair = self; pair < ctx->num_pairs; pair += step) {
+            size_t ti = 0U;
+            size_t tj = 0U;
+            corr_pair_tiles(pair, ctx->num_tiles, &ti, &tj);
+            
+            size_t gi_end = (ti + 1U) * CORR_GROUPS_PER_TILE;
+            size_t gj_end = (tj + 1U) * CORR_GROUPS_PER_TILE;
+            if (gi_end > ctx->num_groups) {
+                gi_end = ctx->num_groups;
+            }
+            if (gj_end > ctx->num_groups) {
+                gj_end = ctx->num_groups;
+            }
+            
+            for (size_t gi = ti * CORR_GROUPS_PER_TILE; gi < gi_end; gi++) {
+                size_t gj = ti == tj ? gi : tj * CORR_GROUPS_PER_TILE;
+                for (; gj < gj_end; gj++) {
+                    corr_group_pair(ctx, gi, gj, kc);
+                }
+            }
+        }
+        pthread_barrier_wait(&ctx->barrier);
+    }
+    
+    return NULL;
+}
+
+/**
+ * Co-moments in the upper triangle -> correlations, mirrored to the lower;
+ * inv_norm is scratch of n
+ */
+static void corr_normalize_comoments(double* corr, size_t n, size_t num_samples, double* inv_norm) {
+    for (size_t var_idx = 0U; var_idx < n; var_idx++) {
+        double sum_sq = corr[var_idx * n + var_idx];
+        double std_dev = sqrt(sum_sq / (double)(num_samples - 1U));
+        inv_norm[var_idx] = std_dev < RTKA_CORR_EPSILON ? 0.0 : 1.0 / sqrt(sum_sq);
+    }
+    
+    for (size_t row = 0U; row < n; row++) {
+        corr[row * n + row] = 1.0;
+        for (size_t col = row + 1U; col < n; col++) {
+            double value = corr[row * n + col] * inv_norm[row] * inv_norm[col];
+            if (value > 1.0) {
+                value = 1.0;
+            } else if (value < -1.0) {
+                value = -1.0;
+            }
+            corr[row * n + col] = value;
+            corr[col * n + row] = value;
+        }
+    }
+}
+
+static size_t corr_default_threads(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (size_t)online : 1U;
+}
+
+rtka_corr_error_t rtka_corr_matrix_compute_blocked(
+    const double* const* data,
+    size_t num_variables,
+    size_t num_samples,
+    const rtka_corr_matrix_options_t* options,
+    rtka_corr_matrix_t* out_matrix
+) {
+    if (data == NULL || out_matrix == NULL || out_matrix->matrix == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    
+    if (num_variables == 0U || num_samples < RTKA_CORR_MIN_SAMPLES) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    
+    if (out_matrix->dimension != num_variables ||
+        out_matrix->sample_count != num_samples) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    
+    for (size_t var_idx = 0U; var_idx < num_variables; var_idx++) {
+        if (data[var_idx] == NULL) {
+            return RTKA_CORR_ERROR_NULL_PTR;
+        }
+    }
+    
+    corr_blocked_t ctx = {0};
+    ctx.data = data;
+    ctx.num_variables = num_variables;
+    ctx.num_samples = num_samples;
+    ctx.num_groups = (num_variables + CORR_MR - 1U) / CORR_MR;
+    ctx.num_tiles = (ctx.num_groups + CORR_GROUPS_PER_TILE - 1U) / CORR_GROUPS_PER_TILE;
+    ctx.num_pairs = ctx.num_tiles * (ctx.num_tiles + 1U) / 2U;
+    ctx.use_float = options != NULL && options->accumulation == RTKA_CORR_ACCUM_FLOAT;
+    ctx.cov = out_matrix->matrix;
+    
+    /* No more threads than tile pairs: each is one unit of work */
+    size_t threads = options != NULL && options->num_threads > 0U ?
+                     options->num_threads : corr_default_threads();
+    if (threads > ctx.num_pairs) {
+        threads = ctx.num_pairs;
+    }
+    
+    size_t element = ctx.use_float ? sizeof(float) : sizeof(double);
+    size_t panel_bytes = ctx.num_groups * (size_t)RTKA_CORR_PANEL_SAMPLES * CORR_MR * element;
+    ctx.means = malloc(num_variables * sizeof(double));
+    ctx.panel = aligned_alloc(64U, (panel_bytes + 63U) & ~(size_t)63U);
+    pthread_t* handles = malloc(threads * sizeof(pthread_t));
+    corr_worker_t* workers = malloc(threads * sizeof(corr_worker_t));
+    
+    if (ctx.means == NULL || ctx.panel == NULL || handles == NULL || workers == NULL) {
+        free(ctx.means);
+        free(ctx.panel);
+        free(handles);
+        free(workers);
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+    
+    memset(out_matrix->matrix, 0, num_variables * num_variables * sizeof(double));
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.start, NULL);
+    
+    /* The barrier counts the threads that actually started */
+    size_t started = 1U;
+    for (; started < threads; started++) {
+        workers[started] = (corr_worker_t){ &ctx, started };
+        if (pthread_create(&handles[started], NULL, corr_worker, &workers[started]) != 0) {
+            break;
+        }
+    }
+    
+    pthread_mutex_lock(&ctx.lock);
+    ctx.num_threads = started;
+    ctx.failed = pthread_barrier_init(&ctx.barrier, NULL, (unsigned)started) != 0;
+    ctx.started = true;
+    pthread_cond_broadcast(&ctx.start);
+    pthread_mutex_unlock(&ctx.lock);
+    
+    workers[0] = (corr_worker_t){ &ctx, 0U };
+    corr_worker(&workers[0]);
+    for (size_t idx = 1U; idx < started; idx++) {
+        pthread_join(handles[idx], NULL);
+    }
+    if (!ctx.failed) {
+        pthread_barrier_destroy(&ctx.barrier);
+    }
+    pthread_cond_destroy(&ctx.start);
+    pthread_mutex_destroy(&ctx.lock);
+    free(handles);
+    free(workers);
+    
+    if (ctx.failed) {
+        free(ctx.means);
+        free(ctx.panel);
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+    
+    corr_normalize_comoments(out_matrix->matrix, num_variables, num_samples, ctx.means);
+    
+    free(ctx.means);
+    free(ctx.panel);
+    out_matrix->status = RTKA_CORR_SUCCESS;
+    return RTKA_CORR_SUCCESS;
+}
+
+/* ============================================================================
+ * STREAMING CORRELATION - IMPLEMENTATION
+ * ============================================================================ */
+
+rtka_corr_stream_t* rtka_corr_stream_create(size_t dimension) {
+    if (dimension == 0U) {
+        return NULL;
+    }
+    
+    rtka_corr_stream_t* stream = calloc(1U, sizeof(rtka_corr_stream_t));
+    if (stream == NULL) {
+        return NULL;
+    }
+    
+    /* Scratch: centered block, block means, mean differences */
+    stream->dimension = dimension;
+    stream->mean = calloc(dimension, sizeof(double));
+    stream->comoment = calloc(dimension * dimension, sizeof(double));
+    stream->scratch = malloc(dimension * (RTKA_CORR_STREAM_BATCH + 2U) * sizeof(double));
+    
+    if (stream->mean == NULL || stream->comoment == NULL || stream->scratch == NULL) {
+        rtka_corr_stream_free(stream);
+        return NULL;
+    }
+    
+    return stream;
+}
+
+void rtka_corr_stream_free(rtka_corr_stream_t* stream) {
+    if (stream != NULL) {
+        free(stream->mean);
+        free(stream->comoment);
+        free(stream->scratch);
+        free(stream);
+    }
+}
+
+void rtka_corr_stream_reset(rtka_corr_stream_t* stream) {
+    if (stream != NULL) {
+        stream->count = 0U;
+        memset(stream->mean, 0, stream->dimension * sizeof(double));
+        memset(stream->comoment, 0, stream->dimension * stream->dimension * sizeof(double));
+    }
+}
+
+/**
+ * Chan's update of count and means by a set of other_count samples:
+ * δ = x̄_b - x̄_a into delta, x̄_a += δ · n_b / n. Returns n_a n_b / n,
+ * the weight of δδᵀ in the co-moment.
+ */
+static double corr_stream_fold_means(
+    rtka_corr_stream_t* stream,
+    size_t other_count,
+    const double* other_mean,
+    double* delta
+) {
+    size_t total = stream->count + other_count;
+    double weight = (double)stream->count * (double)other_count / (double)total;
+    double share = (double)other_count / (double)total;
+    
+    for (size_t var = 0U; var < stream->dimension; var++) {
+        delta[var] = other_mean[var] - stream->mean[var];
+        stream->mean[var] += delta[var] * share;
+    }
+    
+    stream->count = total;
+    return weight;
+}
+
+/**
+ * One block of up to RTKA_CORR_STREAM_BATCH samples
+ */
+static void corr_stream_push_block(rtka_corr_stream_t* stream, const double* samples, size_t count) {
+    size_t n = stream->dimension;
+    double* centered = stream->scratch;          /* [variable][sample] */
+    double* block_mean = centered + n * RTKA_CORR_STREAM_BATCH;
+    double* delta = block_mean + n;
+    
+    /* Transpose the block and center it on its own means */
+    for (size_t var = 0U; var < n; var++) {
+        double* row = centered + var * RTKA_CORR_STREAM_BATCH;
+        double sum = 0.0;
+        for (size_t samp = 0U; samp < count; samp++) {
+            row[samp] = samples[samp * n + var];
+            sum += row[samp];
+        }
+        block_mean[var] = sum / (double)count;
+        for (size_t samp = 0U; samp < count; samp++) {
+            row[samp] -= block_mean[var];
+        }
+    }
+    
+    double weight = corr_stream_fold_means(stream, count, block_mean, delta);
+    
+    /* C += centered · centeredᵀ + δδᵀ · weight, upper triangle */
+    for (size_t row = 0U; row < n; row++) {
+        const double* x = centered + row * RTKA_CORR_STREAM_BATCH;
+        double* target = stream->comoment + row * n;
+        double scaled = delta[row] * weight;
+        for (size_t col = row; col < n; col++) {
+            const double* y = centered + col * RTKA_CORR_STREAM_BATCH;
+            double dot = 0.0;
+            for (size_t samp = 0U; samp < count; samp++) {
+                dot += x[samp] * y[samp];
+            }
+            target[col] += dot + scaled * delta[col];
+        }
+    }
+}
+
+rtka_corr_error_t rtka_corr_stream_push(
+    rtka_corr_stream_t* stream,
+    const double* samples,
+    size_t sample_count
+) {
+    if (stream == NULL || (samples == NULL && sample_count > 0U)) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    
+    for (size_t first = 0U; first < sample_count; first += RTKA_CORR_STREAM_BATCH) {
+        size_t count = sample_count - first;
+        if (count > RTKA_CORR_STREAM_BATCH) {
+            count = RTKA_CORR_STREAM_BATCH;
+        }
+        corr_stream_push_block(stream, samples + first * stream->dimension, count);
+    }
+    
+    return RTKA_CORR_SUCCESS;
+}
+
+rtka_corr_error_t rtka_corr_stream_merge(
+    rtka_corr_stream_t* stream,
+    const rtka_corr_stream_t* other
+) {
+    if (stream == NULL || other == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    
+    if (stream->dimension != other->dimension) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    
+    if (other->count == 0U) {
+        return RTKA_CORR_SUCCESS;
+    }
+    
+    size_t n = stream->dimension;
+    double* delta = stream->scratch + n * (RTKA_CORR_STREAM_BATCH + 1U);
+    double weight = corr_stream_fold_means(stream, other->count, other->mean, delta);
+    
+    for (size_t row = 0U; row < n; row++) {
+        double* target = stream->comoment + row * n;
+        const double* source = other->comoment + row * n;
+        double scaled = delta[row] * weight;
+        for (size_t col = row; col < n; col++) {
+            target[col] += source[col] + scaled * delta[col];
+        }
+    }
+    
+    return RTKA_CORR_SUCCESS;
+}
+
+rtka_corr_error_t rtka_corr_stream_statistics(
+    const rtka_corr_stream_t* stream,
+    size_t variable,
+    rtka_stats_t* out_stats
+) {
+    if (stream == NULL || out_stats == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    
+    if (stream->count < RTKA_CORR_MIN_SAMPLES) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    
+    if (variable >= stream->dimension) {
+        return RTKA_CORR_ERROR_INVALID_RANGE;
+    }
+    
+    double sum_sq = stream->comoment[variable * stream->dimension + variable];
+    out_stats->mean = stream->mean[variable];
+    out_stats->variance = sum_sq / (double)(stream->count - 1U);
+    out_stats->std_dev = sqrt(out_stats->variance);
+    out_stats->count = stream->count;
+    
+    return RTKA_CORR_SUCCESS;
+}
+
+rtka_corr_error_t rtka_corr_stream_matrix(
+    const rtka_corr_stream_t* stream,
+    rtka_corr_matrix_t* out_matrix
+) {
+    if (stream == NULL || out_matrix == NULL || out_matrix->matrix == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    
+    if (stream->count < RTKA_CORR_MIN_SAMPLES || out_matrix->dimension != stream->dimension) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    
+    size_t n = stream->dimension;
+    for (size_t row = 0U; row < n; row++) {
+        memcpy(out_matrix->matrix + row * n + row, stream->comoment + row * n + row,
+               (n - row) * sizeof(double));
+    }
+    
+    double* inv_norm = malloc(n * sizeof(double));
+    if (inv_norm == NULL) {
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+    corr_normalize_comoments(out_matrix->matrix, n, stream->count, inv_norm);
+    free(inv_norm);
+    
+    out_matrix->sample_count = stream->count;
+    out_matrix->status = RTKA_CORR_SUCCESS;
+    return RTKA_CORR_SUCCESS;
+}
+
+/* ============================================================================
+ * SPARSE CORRELATION - IMPLEMENTATION
+ * ============================================================================ */
+
+#define CORR_SPARSE_SIGMAS 5.0
+
+/* Exact top-k entry of one variable; a min-heap on magnitude */
+typedef struct {
+    double magnitude;
+    double coefficient;
+    size_t partner;
+} corr_top_t;
+
+typedef struct {
+    const double* const* data;
+    size_t n;
+    size_t m;
+    const rtka_corr_sparse_options_t* options;
+    double* mean;             /* n */
+    double* inv_norm;         /* 1 / √Σ(x - x̄)², 0 for zero variance */
+    float* sketch;            /* n x k, unit-norm variables */
+    float* sketch_kth;        /* k-th largest |estimate| per variable (top_k) */
+    float* sketch_heap;       /* n x top_k scratch for sketch_kth */
+    corr_top_t* top;          /* n x top_k exact heaps */
+    size_t* top_count;        /* Entries per heap */
+    rtka_corr_sparse_t* out;
+} corr_sparse_t;
+
+static inline unsigned long long corr_mix64(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27U)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31U);
+}
+
+rtka_corr_sparse_t* rtka_corr_sparse_create(
+    size_t dimension,
+    size_t sample_count
+) {
+    if (dimension == 0U || sample_count < RTKA_CORR_MIN_SAMPLES) {
+        return NULL;
+    }
+    
+    rtka_corr_sparse_t* sparse = calloc(1U, sizeof(rtka_corr_sparse_t));
+    if (sparse == NULL) {
+        return NULL;
+    }
+    
+    sparse->dimension = dimension;
+    sparse->sample_count = sample_count;
+    sparse->status = RTKA_CORR_SUCCESS;
+    
+    return sparse;
+}
+
+void rtka_corr_sparse_free(rtka_corr_sparse_t* sparse) {
+    if (sparse != NULL) {
+        free(sparse->pairs);
+        free(sparse);
+    }
+}
+
+static bool corr_sparse_append(rtka_corr_sparse_t* out, size_t row, size_t col, double coefficient) {
+    if (out->count == out->capacity) {
+        size_t capacity = out->capacity != 0U ? out->capacity * 2U : 1024U;
+        rtka_corr_pair_t* pairs = realloc(out->pairs, capacity * sizeof(rtka_corr_pair_t));
+        if (pairs == NULL) {
+            return false;
+        }
+        out->pairs = pairs;
+        out->capacity = capacity;
+    }
+    
+    out->pairs[out->count++] = (rtka_corr_pair_t){ row, col, coefficient };
+    return true;
+}
+
+/**
+ * Offer a value to a min-heap of at most capacity floats, keeping the
+ * largest values seen
+ */
+static void corr_heap_offer_float(float* heap, size_t* count, size_t capacity, float value) {
+    size_t idx;
+    
+    if (*count < capacity) {
+        idx = (*count)++;
+        while (idx > 0U && heap[(idx - 1U) / 2U] > value) {
+            heap[idx] = heap[(idx - 1U) / 2U];
+            idx = (idx - 1U) / 2U;
+        }
+        heap[idx] = value;
+        return;
+    }
+    
+    if (value <= heap[0]) {
+        return;
+    }
+    
+    idx = 0U;
+    for (;;) {
+        size_t child = 2U * idx + 1U;
+        if (child >= capacity) {
+            break;
+        }
+        if (child + 1U < capacity && heap[child + 1U] < heap[child]) {
+            child++;
+        }
+        if (heap[child] >= value) {
+            break;
+        }
+        heap[idx] = heap[child];
+        idx = child;
+    }
+    heap[idx] = value;
+}
+
+/* Same for exact entries, ordered by magnitude */
+static void corr_heap_offer_top(corr_top_t* heap, size_t* count, size_t capacity, corr_top_t entry) {
+    size_t idx;
+    
+    if (*count < capacity) {
+        idx = (*count)++;
+        while (idx > 0U && heap[(idx - 1U) / 2U].magnitude > entry.magnitude) {
+            heap[idx] = heap[(idx - 1U) / 2U];
+            idx = (idx - 1U) / 2U;
+        }
+        heap[idx] = entry;
+        return;
+    }
+    
+    if (entry.magnitude <= heap[0].magnitude) {
+        return;
+    }
+    
+    idx = 0U;
+    for (;;) {
+        size_t child = 2U * idx + 1U;
+        if (child >= capacity) {
+            break;
+        }
+        if (child + 1U < capacity && heap[child + 1U].magnitude < heap[child].magnitude) {
+            child++;
+        }
+        if (heap[child].magnitude >= entry.magnitude) {
+            break;
+        }
+        heap[idx] = heap[child];
+        idx = child;
+    }
+    heap[idx] = entry;
+}
+
+/**
+ * Count-sketch of every normalized variable: sample t adds sign(t) · z_t
+ * to bucket(t), both hashed from the seed once for all variables
+ */
+static bool corr_sparse_build_sketch(corr_sparse_t* ctx) {
+    size_t k = ctx->options->sketch_dimension;
+    unsigned int* bucket = malloc(ctx->m * sizeof(unsigned int));
+    double* sign = malloc(ctx->m * sizeof(double));
+    double* sums = malloc(k * sizeof(double));
+    
+    if (bucket == NULL || sign == NULL || sums == NULL) {
+        free(bucket);
+        free(sign);
+        free(sums);
+        return false;
+    }
+    
+    for (size_t samp = 0U; samp < ctx->m; samp++) {
+        unsigned long long hash = corr_mix64(ctx->options->seed ^ corr_mix64((unsigned long long)samp));
+        bucket[samp] = (unsigned int)((hash >> 1U) % k);
+        sign[samp] = (hash & 1U) != 0U ? 1.0 : -1.0;
+    }
+    
+    for (size_t var = 0U; var < ctx->n; var++) {
+        const double* x = ctx->data[var];
+        double mean = ctx->mean[var];
+        double scale = ctx->inv_norm[var];
+        float* target = ctx->sketch + var * k;
+        
+        memset(sums, 0, k * sizeof(double));
+        for (size_t samp = 0U; samp < ctx->m; samp++) {
+            sums[bucket[samp]] += sign[samp] * (x[samp] - mean);
+        }
+        for (size_t b = 0U; b < k; b++) {
+            target[b] = (float)(sums[b] * scale);
+        }
+    }
+    
+    free(bucket);
+    free(sign);
+    free(sums);
+    return true;
+}
+
+/**
+ * Visit every pair i < j with its sketch estimate. Rows are taken in
+ * tiles of RTKA_CORR_TILE_VARIABLES so each later sketch, loaded once,
+ * is reused against the whole tile from cache.
+ */
+static bool corr_sparse_scan(corr_sparse_t* ctx, bool (*visit)(corr_sparse_t*, size_t, size_t, float)) {
+    size_t k = ctx->options->sketch_dimension;
+    
+    for (size_t first = 0U; first < ctx->n; first += RTKA_CORR_TILE_VARIABLES) {
+        size_t last = first + RTKA_CORR_TILE_VARIABLES < ctx->n ? first + RTKA_CORR_TILE_VARIABLES : ctx->n;
+        for (size_t col = first + 1U; col < ctx->n; col++) {
+            const float* y = ctx->sketch + col * k;
+            size_t rows_end = col < last ? col : last;
+            for (size_t row = first; row < rows_end; row++) {
+                const float* x = ctx->sketch + row * k;
+                float dot = 0.0f;
+                for (size_t b = 0U; b < k; b++) {
+                    dot += x[b] * y[b];
+                }
+                if (!visit(ctx, row, col, dot)) {
+                    return false;
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+
+/* Margin of the threshold test: sketch_sigmas standard deviations at |r| = t */
+static inline double corr_sparse_margin(const corr_sparse_t* ctx, double t) {
+    double sigmas = ctx->options->sketch_sigmas > 0.0 ? ctx->options->sketch_sigmas : CORR_SPARSE_SIGMAS;
+    return sigmas * sqrt((1.0 + t * t) / (double)ctx->options->sketch_dimension);
+}
+
+static bool corr_sparse_rank_estimate(corr_sparse_t* ctx, size_t row, size_t col, float estimate) {
+    size_t top_k = ctx->options->top_k;
+    float magnitude = fabsf(estimate);
+    
+    corr_heap_offer_float(ctx->sketch_heap + row * top_k, &ctx->top_count[row], top_k, magnitude);
+    corr_heap_offer_float(ctx->sketch_heap + col * top_k, &ctx->top_count[col], top_k, magnitude);
+    return true;
+}
+
+/**
+ * Exact coefficient of a candidate pair, retained or offered to the
+ * top-k heaps of both variables
+ */
+static bool corr_sparse_exact(corr_sparse_t* ctx, size_t row, size_t col) {
+    ctx->out->candidates++;
+    if (ctx->inv_norm[row] == 0.0 || ctx->inv_norm[col] == 0.0) {
+        return true;
+    }
+    
+    double corr = corr_pairwise_sum(CORR_SUM_PRODUCTS, ctx->data[row], ctx->data[col], ctx->m,
+                                    ctx->mean[row], ctx->mean[col]) *
+                  ctx->inv_norm[row] * ctx->inv_norm[col];
+    if (corr > 1.0) {
+        corr = 1.0;
+    } else if (corr < -1.0) {
+        corr = -1.0;
+    }
+    
+    double magnitude = fabs(corr);
+    if (magnitude < ctx->options->threshold) {
+        return true;
+    }
+    
+    size_t top_k = ctx->options->top_k;
+    if (top_k == 0U) {
+        return corr_sparse_append(ctx->out, row, col, corr);
+    }
+    
+    corr_heap_offer_top(ctx->top + row * top_k, &ctx->top_count[row], top_k,
+                        (corr_top_t){ magnitude, corr, col });
+    corr_heap_offer_top(ctx->top + col * top_k, &ctx->top_count[col], top_k,
+                        (corr_top_t){ magnitude, corr, row });
+    return true;
+}
+
+/*
+ * A pair in the top-k of i has |r| >= the exact k-th of i, which is at
+ * least the sketch k-th minus one margin, so its estimate is at least
+ * the sketch k-th minus two margins (at the worst-case variance 2/k).
+ */
+static bool corr_sparse_filter(corr_sparse_t* ctx, size_t row, size_t col, float estimate) {
+    double magnitude = fabs((double)estimate);
+    double bound = ctx->options->threshold - corr_sparse_margin(ctx, ctx->options->threshold);
+    
+    if (ctx->options->top_k > 0U) {
+        double kth = ctx->sketch_kth[row] < ctx->sketch_kth[col] ? ctx->sketch_kth[row] : ctx->sketch_kth[col];
+        double rank_bound = kth - 2.0 * corr_sparse_margin(ctx, 1.0);
+        if (rank_bound > bound) {
+            bound = rank_bound;
+        }
+    }
+    
+    if (magnitude < bound) {
+        return true;
+    }
+    return corr_sparse_exact(ctx, row, col);
+}
+
+static int corr_pair_compare(const void* a, const void* b) {
+    const rtka_corr_pair_t* x = (const rtka_corr_pair_t*)a;
+    const rtka_corr_pair_t* y = (const rtka_corr_pair_t*)b;
+    
+    if (x->row != y->row) {
+        return x->row < y->row ? -1 : 1;
+    }
+    if (x->col != y->col) {
+        return x->col < y->col ? -1 : 1;
+    }
+    return 0;
+}
+
+/* Union of the exact heaps as pairs, each once */
+static bool corr_sparse_collect_top(corr_sparse_t* ctx) {
+    size_t top_k = ctx->options->top_k;
+    
+    for (size_t var = 0U; var < ctx->n; var++) {
+        const corr_top_t* heap = ctx->top + var * top_k;
+        for (size_t idx = 0U; idx < ctx->top_count[var]; idx++) {
+            size_t row = var < heap[idx].partner ? var : heap[idx].partner;
+            size_t col = var < heap[idx].partner ? heap[idx].partner : var;
+            if (!corr_sparse_append(ctx->out, row, col, heap[idx].coefficient)) {
+                return false;
+            }
+        }
+    }
+    
+    qsort(ctx->out->pairs, ctx->out->count, sizeof(rtka_corr_pair_t), corr_pair_compare);
+    size_t kept = 0U;
+    for (size_t idx = 0U; idx < ctx->out->count; idx++) {
+        if (kept == 0U || corr_pair_compare(&ctx->out->pairs[kept - 1U], &ctx->out->pairs[idx]) != 0) {
+            ctx->out->pairs[kept++] = ctx->out->pairs[idx];
+        }
+    }
+    ctx->out->count = kept;
+    return true;
+}
+
+static void corr_sparse_release(corr_sparse_t* ctx) {
+    free(ctx->mean);
+    free(ctx->inv_norm);
+    free(ctx->sketch);
+    free(ctx->sketch_kth);
+    free(ctx->sketch_heap);
+    free(ctx->top);
+    free(ctx->top_count);
+}
+
+rtka_corr_error_t rtka_corr_sparse_compute(
+    const double* const* data,
+    size_t num_variables,
+    size_t num_samples,
+    const rtka_corr_sparse_options_t* options,
+    rtka_corr_sparse_t* out_sparse
+) {
+    if (data == NULL || options == NULL || out_sparse == NULL) {
+        return RTKA_CORR_ERROR_NULL_PTR;
+    }
+    
+    if (num_variables == 0U || num_samples < RTKA_CORR_MIN_SAMPLES ||
+        out_sparse->dimension != num_variables || out_sparse->sample_count != num_samples) {
+        return RTKA_CORR_ERROR_INVALID_SIZE;
+    }
+    
+    if (!(options->threshold >= 0.0 && options->threshold <= 1.0) ||
+        (options->threshold == 0.0 && options->top_k == 0U)) {
+        return RTKA_CORR_ERROR_INVALID_RANGE;
+    }
+    
+    for (size_t var = 0U; var < num_variables; var++) {
+        if (data[var] == NULL) {
+            return RTKA_CORR_ERROR_NULL_PTR;
+        }
+    }
+    
+    size_t n = num_variables;
+    size_t k = options->sketch_dimension;
+    size_t top_k = options->top_k;
+    corr_sparse_t ctx = { data, n, num_samples, options, NULL, NULL, NULL, NULL, NULL, NULL, NULL, out_sparse };
+    ctx.mean = malloc(n * sizeof(double));
+    ctx.inv_norm = malloc(n * sizeof(double));
+    bool ok = ctx.mean != NULL && ctx.inv_norm != NULL;
+    if (ok && k > 0U) {
+        ctx.sketch = malloc(n * k * sizeof(float));
+        ok = ctx.sketch != NULL;
+    }
+    if (ok && top_k > 0U) {
+        ctx.top = malloc(n * top_k * sizeof(corr_top_t));
+        ctx.top_count = calloc(n, sizeof(size_t));
+        ok = ctx.top != NULL && ctx.top_count != NULL;
+        if (ok && k > 0U) {
+            ctx.sketch_kth = malloc(n * sizeof(float));
+            ctx.sketch_heap = malloc(n * top_k * sizeof(float));
+            ok = ctx.sketch_kth != NULL && ctx.sketch_heap != NULL;
+        }
+    }
+    if (!ok) {
+        corr_sparse_release(&ctx);
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+    
+    /* Means and norms, zero-variance variables as rtka_corr_matrix_compute() */
+    for (size_t var = 0U; var < n; var++) {
+        ctx.mean[var] = corr_pairwise_sum(CORR_SUM_VALUES, data[var], NULL, num_samples, 0.0, 0.0) /
+                        (double)num_samples;
+        double sum_sq = corr_pairwise_sum(CORR_SUM_SQUARES, data[var], NULL, num_samples, ctx.mean[var], 0.0);
+        bool constant = sqrt(sum_sq / (double)(num_samples - 1U)) < RTKA_CORR_EPSILON;
+        ctx.inv_norm[var] = constant ? 0.0 : 1.0 / sqrt(sum_sq);
+    }
+    
+    out_sparse->count = 0U;
+    out_sparse->candidates = 0U;
+    
+    if (k > 0U) {
+        ok = corr_sparse_build_sketch(&ctx);
+        if (ok && top_k > 0U) {
+            /* Rank the estimates first; the k-th of each variable bounds its exact k-th */
+            ok = corr_sparse_scan(&ctx, corr_sparse_rank_estimate);
+            for (size_t var = 0U; var < n; var++) {
+                ctx.sketch_kth[var] = ctx.top_count[var] == top_k ? ctx.sketch_heap[var * top_k] : 0.0f;
+                ctx.top_count[var] = 0U;
+            }
+        }
+        ok = ok && corr_sparse_scan(&ctx, corr_sparse_filter);
+    } else {
+        for (size_t row = 0U; ok && row < n; row++) {
+            for (size_t col = row + 1U; ok && col < n; col++) {
+                ok = corr_sparse_exact(&ctx, row, col);
+            }
+        }
+    }
+    
+    if (ok && top_k > 0U) {
+        ok = corr_sparse_collect_top(&ctx);
+    } else if (ok) {
+        qsort(out_sparse->pairs, out_sparse->count, sizeof(rtka_corr_pair_t), corr_pair_compare);
+    }
+    
+    corr_sparse_release(&ctx);
+    if (!ok) {
+        out_sparse->count = 0U;
+        out_sparse->status = RTKA_CORR_ERROR_ALLOCATION;
+        return RTKA_CORR_ERROR_ALLOCATION;
+    }
+    
+    out_sparse->status = RTKA_CORR_SUCCESS;
+    return RTKA_CORR_SUCCESS;
+}
+
 rtka_corr_error_t rtka_corr_matrix_get(
     const rtka_corr_matrix_t* matrix,
     size_t row,
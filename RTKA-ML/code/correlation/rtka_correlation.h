@@ -29,6 +29,18 @@
  *   - Full correlation matrix computation
  *   - Optimized single-pass algorithms where possible
  *   - Error handling for edge cases
+ * 2025-11-02: Blocked correlation matrix
+ *   - Centered data packed once per sample panel into contiguous blocks
+ *   - Upper triangle as a register-blocked SYRK, tiles split over threads
+ *   - Optional float32 accumulation within panels
+ * 2025-11-09: Streaming correlation
+ *   - rtka_corr_stream_t accumulates means and co-moments in O(n²) memory
+ *   - Batches folded in with Chan's update, shards combined with merge
+ * 2025-11-16: Pairwise summation in SIMD lanes for mean, variance and
+ *   covariance
+ * 2025-11-23: Sparse correlation
+ *   - Pairs above a threshold or in a variable's top-k as triplets
+ *   - Count-sketch estimates prune the pairs computed exactly
  */
 
 #ifndef RTKA_CORRELATION_H
@@ -48,6 +60,10 @@
 /* Epsilon for numerical stability checks */
 #define RTKA_CORR_EPSILON 1e-10
 
+/* Blocked matrix: samples per packed panel, variables per thread tile */
+#define RTKA_CORR_PANEL_SAMPLES 256U
+#define RTKA_CORR_TILE_VARIABLES 64U
+
 /* Error codes */
 typedef enum {
     RTKA_CORR_SUCCESS = 0,
@@ -55,7 +71,8 @@ typedef enum {
     RTKA_CORR_ERROR_INVALID_SIZE = -2,
     RTKA_CORR_ERROR_ZERO_VARIANCE = -3,
     RTKA_CORR_ERROR_ALLOCATION = -4,
-    RTKA_CORR_ERROR_INVALID_RANGE = -5
+    RTKA_CORR_ERROR_INVALID_RANGE = -5,
+    RTKA_CORR_ERROR_IO = -6
 } rtka_corr_error_t;
 
 /* ============================================================================
@@ -94,6 +111,71 @@ typedef struct {
     rtka_corr_error_t status; /* Computation status */
 } rtka_corr_matrix_t;
 
+/**
+ * Accumulation precision of the blocked matrix
+ */
+typedef enum {
+    RTKA_CORR_ACCUM_DOUBLE = 0,   /* float64 products and sums */
+    RTKA_CORR_ACCUM_FLOAT = 1     /* float32 within a panel, float64 across panels */
+} rtka_corr_accum_t;
+
+/**
+ * Blocked matrix options; zero-initialized is float64 on every online CPU
+ */
+typedef struct {
+    rtka_corr_accum_t accumulation;
+    size_t num_threads;           /* 0: one per online processor */
+} rtka_corr_matrix_options_t;
+
+/**
+ * Streaming accumulator: everything needed for the correlation matrix of
+ * the samples pushed so far, independent of their number. Fields are
+ * plain arrays so shards can be shipped between processes and merged.
+ */
+typedef struct {
+    size_t dimension;         /* Number of variables */
+    size_t count;             /* Samples accumulated */
+    double* mean;             /* Running means (n) */
+    double* comoment;         /* Σ(x_i - x̄_i)(x_j - x̄_j), upper triangle of n x n */
+    double* scratch;          /* Centered batch and block means, n x (BATCH + 2) */
+} rtka_corr_stream_t;
+
+/* Samples folded into the co-moments per update in push */
+#define RTKA_CORR_STREAM_BATCH 64U
+
+/**
+ * One retained entry of a sparse correlation result
+ */
+typedef struct {
+    size_t row;               /* Variable index, row < col */
+    size_t col;               /* Variable index */
+    double coefficient;       /* Pearson correlation coefficient [-1, 1] */
+} rtka_corr_pair_t;
+
+/**
+ * Sparse correlation result: the retained pairs as triplets
+ */
+typedef struct {
+    rtka_corr_pair_t* pairs;  /* Sorted by (row, col) */
+    size_t count;             /* Pairs retained */
+    size_t capacity;          /* Pairs allocated, grown as needed */
+    size_t dimension;         /* Number of variables */
+    size_t sample_count;      /* Number of samples per variable */
+    size_t candidates;        /* Pairs computed exactly after pruning */
+    rtka_corr_error_t status; /* Computation status */
+} rtka_corr_sparse_t;
+
+/**
+ * Which pairs a sparse result keeps and how candidates are pruned
+ */
+typedef struct {
+    double threshold;         /* Keep |r| >= threshold, in [0, 1] */
+    size_t top_k;             /* Also require a top-k |r| of row or col; 0: threshold only */
+    size_t sketch_dimension;  /* Count-sketch buckets; 0: every pair computed exactly */
+    double sketch_sigmas;     /* Pruning margin in standard deviations; 0: 5 */
+    unsigned long long seed;  /* Sketch hash seed */
+} rtka_corr_sparse_options_t;
+
 /* ============================================================================
  * CORE STATISTICS FUNCTIONS
  * ============================================================================ */
@@ -107,7 +189,8 @@ typedef struct {
  * @return Error code
  * 
  * Complexity: O(n)
- * Uses: Kahan summation for numerical stability
+ * Uses: pairwise summation (8 lanes, 256-term blocks) for numerical
+ *       stability; error O(ε log n)
  */
 rtka_corr_error_t rtka_corr_mean(
     const double* data,
@@ -274,6 +357,203 @@ rtka_corr_error_t rtka_corr_matrix_compute(
     rtka_corr_matrix_t* out_matrix
 );
 
+/**
+ * Calculate full correlation matrix as one blocked product
+ * 
+ * @param data 2D array of variables (row-major: [variable][sample])
+ * @param num_variables Number of variables (rows)
+ * @param num_samples Number of samples per variable (columns)
+ * @param options Precision and threads, NULL for the defaults
+ * @param out_matrix Pre-allocated matrix structure
+ * @return Error code
+ * 
+ * Complexity: O(n²m) flops, data read twice
+ * 
+ * Means come from one pass over the data. Each panel of
+ * RTKA_CORR_PANEL_SAMPLES samples is then centered and packed into a
+ * contiguous block, and C += Xc·Xcᵀ is accumulated for the upper triangle
+ * only, in tiles of RTKA_CORR_TILE_VARIABLES split over the threads. The
+ * diagonal of C gives the variances, so r_ij = C_ij / √(C_ii·C_jj).
+ * Sums are blocked by panel rather than pairwise; float32
+ * accumulation agrees with rtka_corr_matrix_compute() to about 1e-5.
+ * 
+ * Same results and conventions as rtka_corr_matrix_compute(): diagonal
+ * 1.0, rows of zero-variance variables 0.0, range clamped to [-1, 1].
+ * Returns RTKA_CORR_ERROR_NULL_PTR for a NULL variable row and
+ * RTKA_CORR_ERROR_ALLOCATION when the panels or threads cannot be set up.
+ */
+rtka_corr_error_t rtka_corr_matrix_compute_blocked(
+    const double* const* data,
+    size_t num_variables,
+    size_t num_samples,
+    const rtka_corr_matrix_options_t* options,
+    rtka_corr_matrix_t* out_matrix
+);
+
+/* ============================================================================
+ * STREAMING CORRELATION FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Create empty streaming accumulator
+ * 
+ * @param dimension Number of variables per sample
+ * @return Allocated accumulator or NULL on error
+ * 
+ * Note: Caller must free with rtka_corr_stream_free()
+ */
+rtka_corr_stream_t* rtka_corr_stream_create(size_t dimension);
+
+/**
+ * Free streaming accumulator
+ * 
+ * @param stream Pointer to accumulator to free
+ */
+void rtka_corr_stream_free(rtka_corr_stream_t* stream);
+
+/**
+ * Discard all accumulated samples
+ * 
+ * @param stream Accumulator to reset
+ */
+void rtka_corr_stream_reset(rtka_corr_stream_t* stream);
+
+/**
+ * Accumulate a batch of samples
+ * 
+ * @param stream Accumulator
+ * @param samples Sample-major batch: samples[s * dimension + variable]
+ * @param sample_count Number of samples in the batch (0 is a no-op)
+ * @return Error code
+ * 
+ * Complexity: O(n² · sample_count)
+ * 
+ * Each block of RTKA_CORR_STREAM_BATCH samples is centered on its own mean
+ * and combined with Chan's update:
+ *   C = C_a + C_b + δδᵀ · n_a n_b / (n_a + n_b),  δ = x̄_b - x̄_a
+ * which is Welford's update for a single sample and stays accurate when
+ * the means are large relative to the spread.
+ */
+rtka_corr_error_t rtka_corr_stream_push(
+    rtka_corr_stream_t* stream,
+    const double* samples,
+    size_t sample_count
+);
+
+/**
+ * Fold another accumulator into this one
+ * 
+ * @param stream Accumulator receiving the samples
+ * @param other Accumulator over the same variables, left unchanged
+ * @return Error code
+ * 
+ * Complexity: O(n²)
+ * 
+ * The result equals pushing both sample sets into one accumulator, in any
+ * order, so shards from threads or machines combine in any tree.
+ * Returns RTKA_CORR_ERROR_INVALID_SIZE for a different dimension.
+ */
+rtka_corr_error_t rtka_corr_stream_merge(
+    rtka_corr_stream_t* stream,
+    const rtka_corr_stream_t* other
+);
+
+/**
+ * Statistics of one variable over the accumulated samples
+ * 
+ * @param stream Accumulator
+ * @param variable Variable index (0-based)
+ * @param out_stats Pointer to store statistics
+ * @return Error code
+ * 
+ * Returns RTKA_CORR_ERROR_INVALID_SIZE below RTKA_CORR_MIN_SAMPLES and
+ * RTKA_CORR_ERROR_INVALID_RANGE for a variable out of range.
+ */
+rtka_corr_error_t rtka_corr_stream_statistics(
+    const rtka_corr_stream_t* stream,
+    size_t variable,
+    rtka_stats_t* out_stats
+);
+
+/**
+ * Correlation matrix of the accumulated samples
+ * 
+ * @param stream Accumulator
+ * @param out_matrix Matrix of the stream's dimension; its sample_count is
+ *                   set to the samples accumulated
+ * @return Error code
+ * 
+ * Complexity: O(n²)
+ * Same conventions as rtka_corr_matrix_compute().
+ */
+rtka_corr_error_t rtka_corr_stream_matrix(
+    const rtka_corr_stream_t* stream,
+    rtka_corr_matrix_t* out_matrix
+);
+
+/* ============================================================================
+ * SPARSE CORRELATION FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * Create empty sparse correlation result
+ * 
+ * @param dimension Number of variables
+ * @param sample_count Number of samples per variable
+ * @return Allocated result or NULL on error
+ * 
+ * Note: Caller must free with rtka_corr_sparse_free()
+ */
+rtka_corr_sparse_t* rtka_corr_sparse_create(
+    size_t dimension,
+    size_t sample_count
+);
+
+/**
+ * Free sparse correlation result
+ * 
+ * @param sparse Pointer to result to free
+ */
+void rtka_corr_sparse_free(rtka_corr_sparse_t* sparse);
+
+/**
+ * Calculate the strong correlations only, as (row, col, r) triplets
+ * 
+ * @param data 2D array of variables (row-major: [variable][sample])
+ * @param num_variables Number of variables (rows)
+ * @param num_samples Number of samples per variable (columns)
+ * @param options Threshold, top-k and sketch settings
+ * @param out_sparse Pre-allocated result; previous pairs are replaced
+ * @return Error code
+ * 
+ * Complexity: O(nm + n²k + cm) time for k sketch buckets and c
+ * candidates, O(n(k + top_k) + m) memory besides the output
+ * 
+ * Keeps pair i < j when |r_ij| >= threshold and, with top_k set, r_ij is
+ * among the top_k largest |r| of variable i or of variable j. Each
+ * normalized variable z_i is reduced to a count-sketch of k buckets
+ * (every sample hashed to one bucket with a random sign, the same for
+ * all variables), whose inner products estimate r_ij without bias and
+ * with variance at most (1 + r²)/k. Only pairs whose estimate lies
+ * within sketch_sigmas standard deviations of the threshold, or of the
+ * k-th largest estimates of i and j for top_k, are computed exactly;
+ * every retained coefficient is exact. The bound assumes no few samples
+ * dominate a variable's variance, and each qualifying pair is missed
+ * with probability about that of a normal tail beyond sketch_sigmas;
+ * sketch_dimension 0 computes every pair and misses none.
+ * 
+ * Zero-variance variables correlate 0.0 and are never retained.
+ * Returns RTKA_CORR_ERROR_INVALID_RANGE for a threshold outside [0, 1],
+ * or a threshold of 0 without top_k, which would keep the dense matrix.
+ */
+rtka_corr_error_t rtka_corr_sparse_compute(
+    const double* const* data,
+    size_t num_variables,
+    size_t num_samples,
+    const rtka_corr_sparse_options_t* options,
+    rtka_corr_sparse_t* out_sparse
+);
+
 /**
  * Get correlation value from matrix
  * 
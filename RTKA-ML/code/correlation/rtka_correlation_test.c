@@ -23,15 +23,29 @@
  *   - Correlation matrix tests
  *   - Error handling tests
  *   - Performance benchmarks
+ * 2025-11-02: Blocked matrix against the pairwise matrix, float64 and
+ *   float32, one and several threads; pairwise vs. blocked timing
+ * 2025-11-09: Streaming accumulator in uneven batches and merged shards
+ *   against the two-pass matrix and statistics; push throughput
+ * 2025-11-16: Pairwise mean accuracy against long double and speed
+ *   against scalar Kahan summation
+ * 2025-11-23: Sparse threshold and top-k pairs, exhaustive and sketched,
+ *   against the dense matrix; sketched vs. blocked timing
+ * 2025-11-30: CFD mesh assessment, AoS, SoA and mapped file, against
+ *   per-field statistics and correlations; one-pass timing
+ * 2025-12-07: Topology of block meshes of hexahedra, tetrahedra and
+ *   wedges against closed-form counts; deduplication timing
  */
 
 #include "rtka_correlation.h"
+#include "rtka_cfd_mesh_analysis.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
 #include <assert.h>
+#include <unistd.h>
 
 /* ============================================================================
  * TEST CONFIGURATION
@@ -381,10 +395,678 @@ static void test_correlation_matrix(void) {
     free(data);
 }
 
+/**
+ * Fill variables with a shared factor, an offset far from zero and noise;
+ * variable 3 is constant
+ */
+static double** generate_factor_data(size_t num_vars, size_t num_samples) {
+    double** data = malloc(num_vars * sizeof(double*));
+    for (size_t idx = 0U; idx < num_vars; idx++) {
+        data[idx] = malloc(num_samples * sizeof(double));
+    }
+    
+    for (size_t samp = 0U; samp < num_samples; samp++) {
+        double factor = (double)rand() / (double)RAND_MAX;
+        for (size_t var = 0U; var < num_vars; var++) {
+            double noise = (double)rand() / (double)RAND_MAX;
+            double weight = (double)(var % 5U) - 2.0;
+            data[var][samp] = var == 3U ? 42.0 : 1000.0 + weight * factor + 0.5 * noise;
+        }
+    }
+    
+    return data;
+}
+
+static void free_factor_data(double** data, size_t num_vars) {
+    for (size_t idx = 0U; idx < num_vars; idx++) {
+        free(data[idx]);
+    }
+    free(data);
+}
+
+static double max_matrix_difference(const rtka_corr_matrix_t* lhs, const rtka_corr_matrix_t* rhs) {
+    double worst = 0.0;
+    for (size_t idx = 0U; idx < lhs->dimension * lhs->dimension; idx++) {
+        double diff = fabs(lhs->matrix[idx] - rhs->matrix[idx]);
+        worst = diff > worst ? diff : worst;
+    }
+    return worst;
+}
+
+static void test_blocked_matrix(void) {
+    /* Not multiples of the 8-variable groups, 64-variable tiles or panels */
+    const size_t num_vars = 150U;
+    const size_t num_samples = 1003U;
+    
+    srand(24680U);
+    double** data = generate_factor_data(num_vars, num_samples);
+    rtka_corr_matrix_t* reference = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_matrix_t* blocked = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_error_t err = rtka_corr_matrix_compute(
+        (const double* const*)data, num_vars, num_samples, reference
+    );
+    bool passed = err == RTKA_CORR_SUCCESS;
+    
+    const rtka_corr_matrix_options_t variants[] = {
+        { RTKA_CORR_ACCUM_DOUBLE, 1U },
+        { RTKA_CORR_ACCUM_DOUBLE, 3U },
+        { RTKA_CORR_ACCUM_FLOAT, 1U },
+        { RTKA_CORR_ACCUM_FLOAT, 4U }
+    };
+    
+    for (size_t idx = 0U; idx < sizeof(variants) / sizeof(variants[0]); idx++) {
+        err = rtka_corr_matrix_compute_blocked(
+            (const double* const*)data, num_vars, num_samples, &variants[idx], blocked
+        );
+        double worst = max_matrix_difference(reference, blocked);
+        bool use_float = variants[idx].accumulation == RTKA_CORR_ACCUM_FLOAT;
+        bool ok = err == RTKA_CORR_SUCCESS && worst < (use_float ? 1e-4 : 1e-9);
+        
+        /* Zero-variance row stays 0.0 off the diagonal */
+        double constant_row = 0.0;
+        rtka_corr_matrix_get(blocked, 3U, 7U, &constant_row);
+        ok = ok && constant_row == 0.0;
+        
+        printf("  %s, %zu thread%s: max |difference| %.2e\n", use_float ? "float32" : "float64",
+               variants[idx].num_threads, variants[idx].num_threads == 1U ? "" : "s", worst);
+        passed = passed && ok;
+    }
+    
+    /* Errors as in rtka_corr_matrix_compute */
+    passed = passed && rtka_corr_matrix_compute_blocked(NULL, num_vars, num_samples, NULL, blocked) ==
+                       RTKA_CORR_ERROR_NULL_PTR;
+    passed = passed && rtka_corr_matrix_compute_blocked((const double* const*)data, num_vars, 1U, NULL, blocked) ==
+                       RTKA_CORR_ERROR_INVALID_SIZE;
+    double* saved = data[5];
+    data[5] = NULL;
+    passed = passed && rtka_corr_matrix_compute_blocked((const double* const*)data, num_vars, num_samples,
+                                                        NULL, blocked) == RTKA_CORR_ERROR_NULL_PTR;
+    data[5] = saved;
+    
+    report_test("Blocked Correlation Matrix", passed);
+    
+    rtka_corr_matrix_free(reference);
+    rtka_corr_matrix_free(blocked);
+    free_factor_data(data, num_vars);
+}
+
+/* ============================================================================
+ * STREAMING CORRELATION TESTS
+ * ============================================================================ */
+
+static void test_stream_correlation(void) {
+    const size_t num_vars = 37U;
+    const size_t num_samples = 2000U;
+    
+    /* Means of 1e6 with unit spread: one-pass sums of squares lose it */
+    srand(11223U);
+    double** data = generate_factor_data(num_vars, num_samples);
+    double* samples = malloc(num_vars * num_samples * sizeof(double));
+    for (size_t var = 0U; var < num_vars; var++) {
+        for (size_t samp = 0U; samp < num_samples; samp++) {
+            data[var][samp] += 1e6;
+            samples[samp * num_vars + var] = data[var][samp];
+        }
+    }
+    
+    rtka_corr_matrix_t* reference = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_matrix_t* streamed = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_error_t err = rtka_corr_matrix_compute(
+        (const double* const*)data, num_vars, num_samples, reference
+    );
+    
+    /* One stream fed batches of uneven sizes */
+    rtka_corr_stream_t* whole = rtka_corr_stream_create(num_vars);
+    const size_t batches[] = { 1U, 3U, 64U, 100U, 65U, 767U };
+    size_t fed = 0U;
+    for (size_t idx = 0U; idx < sizeof(batches) / sizeof(batches[0]); idx++) {
+        err = err != RTKA_CORR_SUCCESS ? err :
+              rtka_corr_stream_push(whole, samples + fed * num_vars, batches[idx]);
+        fed += batches[idx];
+    }
+    err = err != RTKA_CORR_SUCCESS ? err :
+          rtka_corr_stream_push(whole, samples + fed * num_vars, num_samples - fed);
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_matrix(whole, streamed);
+    double whole_diff = max_matrix_difference(reference, streamed);
+    
+    /* Four unequal shards merged as a tree */
+    const size_t bounds[] = { 0U, 300U, 1100U, 1111U, num_samples };
+    rtka_corr_stream_t* shards[4];
+    for (size_t idx = 0U; idx < 4U; idx++) {
+        shards[idx] = rtka_corr_stream_create(num_vars);
+        err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_push(
+            shards[idx], samples + bounds[idx] * num_vars, bounds[idx + 1U] - bounds[idx]
+        );
+    }
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_merge(shards[0], shards[1]);
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_merge(shards[2], shards[3]);
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_merge(shards[0], shards[2]);
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_matrix(shards[0], streamed);
+    double merged_diff = max_matrix_difference(reference, streamed);
+    
+    /* Per-variable statistics against the two-pass functions */
+    double worst_stat = 0.0;
+    for (size_t var = 0U; var < num_vars && err == RTKA_CORR_SUCCESS; var++) {
+        rtka_stats_t expected = {0};
+        rtka_stats_t actual = {0};
+        err = rtka_corr_statistics(data[var], num_samples, &expected);
+        err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_stream_statistics(shards[0], var, &actual);
+        double mean_diff = fabs(actual.mean - expected.mean) / 1e6;
+        double var_diff = fabs(actual.variance - expected.variance) / (expected.variance + 1.0);
+        worst_stat = fmax(worst_stat, fmax(mean_diff, var_diff));
+    }
+    
+    /* One-pass Σx and Σx² for comparison */
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (size_t samp = 0U; samp < num_samples; samp++) {
+        sum += data[0][samp];
+        sum_sq += data[0][samp] * data[0][samp];
+    }
+    double naive_variance = (sum_sq - sum * sum / (double)num_samples) / (double)(num_samples - 1U);
+    rtka_stats_t first = {0};
+    rtka_corr_stream_statistics(whole, 0U, &first);
+    
+    printf("  Streamed in batches: max |difference| %.2e\n", whole_diff);
+    printf("  Merged from 4 shards: max |difference| %.2e\n", merged_diff);
+    printf("  Means/variances vs two-pass: max relative difference %.2e\n", worst_stat);
+    printf("  Variance at mean 1e6: streamed %.6f, one-pass sums %.6f\n", first.variance, naive_variance);
+    
+    /* Errors */
+    rtka_corr_stream_t* other = rtka_corr_stream_create(num_vars + 1U);
+    rtka_corr_stream_t* empty = rtka_corr_stream_create(num_vars);
+    bool errors_ok = rtka_corr_stream_merge(whole, other) == RTKA_CORR_ERROR_INVALID_SIZE &&
+                     rtka_corr_stream_matrix(empty, streamed) == RTKA_CORR_ERROR_INVALID_SIZE &&
+                     rtka_corr_stream_statistics(whole, num_vars, &first) == RTKA_CORR_ERROR_INVALID_RANGE &&
+                     rtka_corr_stream_push(NULL, samples, 1U) == RTKA_CORR_ERROR_NULL_PTR &&
+                     rtka_corr_stream_merge(whole, empty) == RTKA_CORR_SUCCESS &&
+                     whole->count == num_samples &&
+                     rtka_corr_stream_create(0U) == NULL;
+    rtka_corr_stream_reset(whole);
+    errors_ok = errors_ok && whole->count == 0U &&
+                rtka_corr_stream_statistics(whole, 0U, &first) == RTKA_CORR_ERROR_INVALID_SIZE;
+    
+    bool passed = err == RTKA_CORR_SUCCESS && whole_diff < 1e-9 && merged_diff < 1e-9 &&
+                  worst_stat < 1e-9 && errors_ok;
+    report_test("Streaming Correlation", passed);
+    
+    rtka_corr_stream_free(whole);
+    rtka_corr_stream_free(other);
+    rtka_corr_stream_free(empty);
+    for (size_t idx = 0U; idx < 4U; idx++) {
+        rtka_corr_stream_free(shards[idx]);
+    }
+    rtka_corr_matrix_free(reference);
+    rtka_corr_matrix_free(streamed);
+    free(samples);
+    free_factor_data(data, num_vars);
+}
+
 /* ============================================================================
  * UTILITY FUNCTION TESTS
  * ============================================================================ */
 
+/**
+ * Variables in groups of four sharing a factor with loadings that vary by
+ * group, so within-group |r| spreads over (0, 1); variable 3 is constant
+ */
+static double** generate_group_data(size_t num_vars, size_t num_samples) {
+    double** data = malloc(num_vars * sizeof(double*));
+    for (size_t idx = 0U; idx < num_vars; idx++) {
+        data[idx] = malloc(num_samples * sizeof(double));
+    }
+    
+    for (size_t samp = 0U; samp < num_samples; samp++) {
+        double factor = 0.0;
+        for (size_t var = 0U; var < num_vars; var++) {
+            if (var % 4U == 0U) {
+                factor = (double)rand() / (double)RAND_MAX - 0.5;
+            }
+            double loading = (double)((var / 4U) % 7U) * 0.5 * (var % 2U == 0U ? 1.0 : -1.0);
+            double noise = (double)rand() / (double)RAND_MAX - 0.5;
+            data[var][samp] = var == 3U ? 7.0 : 10.0 + loading * factor + noise;
+        }
+    }
+    
+    return data;
+}
+
+/**
+ * Compare a sparse result with the pairs of a dense matrix that pass the
+ * threshold and are in the top_k |r| of either variable (top_k 0: all);
+ * the exact zeros of zero-variance rows are never retained
+ */
+static bool sparse_matches_dense(const rtka_corr_sparse_t* sparse, const rtka_corr_matrix_t* dense,
+                                 double threshold, size_t top_k) {
+    size_t n = dense->dimension;
+    bool* keep = calloc(n * n, sizeof(bool));
+    
+    for (size_t row = 0U; row < n; row++) {
+        for (size_t col = 0U; col < n; col++) {
+            double value = dense->matrix[row * n + col];
+            if (col == row || value == 0.0 || fabs(value) < threshold) {
+                continue;
+            }
+            /* Rank of (row, col) among the row's partners */
+            size_t stronger = 0U;
+            for (size_t other = 0U; top_k > 0U && other < n; other++) {
+                if (other != row &&
+                    fabs(dense->matrix[row * n + other]) > fabs(dense->matrix[row * n + col])) {
+                    stronger++;
+                }
+            }
+            if (top_k == 0U || stronger < top_k) {
+                keep[row < col ? row * n + col : col * n + row] = true;
+            }
+        }
+    }
+    
+    size_t expected = 0U;
+    for (size_t idx = 0U; idx < n * n; idx++) {
+        expected += keep[idx] ? 1U : 0U;
+    }
+    
+    bool ok = sparse->count == expected;
+    for (size_t idx = 0U; ok && idx < sparse->count; idx++) {
+        const rtka_corr_pair_t* pair = &sparse->pairs[idx];
+        ok = pair->row < pair->col && keep[pair->row * n + pair->col] &&
+             approx_equal(pair->coefficient, dense->matrix[pair->row * n + pair->col], 1e-9) &&
+             (idx == 0U || pair->row > sparse->pairs[idx - 1U].row ||
+              (pair->row == sparse->pairs[idx - 1U].row && pair->col > sparse->pairs[idx - 1U].col));
+    }
+    
+    free(keep);
+    return ok;
+}
+
+static void test_sparse_correlation(void) {
+    const size_t num_vars = 203U;
+    const size_t num_samples = 2000U;
+    
+    srand(8642U);
+    double** data = generate_group_data(num_vars, num_samples);
+    rtka_corr_matrix_t* dense = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_sparse_t* sparse = rtka_corr_sparse_create(num_vars, num_samples);
+    rtka_corr_matrix_options_t dense_options = { RTKA_CORR_ACCUM_DOUBLE, 1U };
+    rtka_corr_error_t err = rtka_corr_matrix_compute_blocked(
+        (const double* const*)data, num_vars, num_samples, &dense_options, dense
+    );
+    bool passed = err == RTKA_CORR_SUCCESS;
+    
+    const rtka_corr_sparse_options_t variants[] = {
+        { 0.5, 0U, 0U, 0.0, 0U },
+        { 0.5, 0U, 1024U, 0.0, 1U },
+        { 0.0, 2U, 0U, 0.0, 0U },
+        { 0.0, 2U, 1024U, 0.0, 2U },
+        { 0.3, 1U, 512U, 6.0, 3U }
+    };
+    
+    for (size_t idx = 0U; idx < sizeof(variants) / sizeof(variants[0]); idx++) {
+        const rtka_corr_sparse_options_t* options = &variants[idx];
+        err = rtka_corr_sparse_compute((const double* const*)data, num_vars, num_samples, options, sparse);
+        bool ok = err == RTKA_CORR_SUCCESS &&
+                  sparse_matches_dense(sparse, dense, options->threshold, options->top_k);
+        printf("  |r| >= %.1f, top-%zu, %zu buckets: %zu pairs, %zu of %zu computed exactly\n",
+               options->threshold, options->top_k, options->sketch_dimension, sparse->count,
+               sparse->candidates, num_vars * (num_vars - 1U) / 2U);
+        passed = passed && ok;
+    }
+    
+    /* Sketching must prune most pairs at a high threshold */
+    passed = passed && rtka_corr_sparse_compute((const double* const*)data, num_vars, num_samples,
+                                                &variants[1], sparse) == RTKA_CORR_SUCCESS &&
+             sparse->candidates < num_vars * (num_vars - 1U) / 20U;
+    
+    /* Errors */
+    rtka_corr_sparse_options_t bad = { 1.5, 0U, 0U, 0.0, 0U };
+    passed = passed && rtka_corr_sparse_compute((const double* const*)data, num_vars, num_samples,
+                                                &bad, sparse) == RTKA_CORR_ERROR_INVALID_RANGE;
+    bad.threshold = 0.0;
+    passed = passed && rtka_corr_sparse_compute((const double* const*)data, num_vars, num_samples,
+                                                &bad, sparse) == RTKA_CORR_ERROR_INVALID_RANGE;
+    passed = passed && rtka_corr_sparse_compute((const double* const*)data, num_vars, num_samples,
+                                                NULL, sparse) == RTKA_CORR_ERROR_NULL_PTR;
+    passed = passed && rtka_corr_sparse_compute((const double* const*)data, num_vars, 1U,
+                                                &variants[0], sparse) == RTKA_CORR_ERROR_INVALID_SIZE;
+    passed = passed && rtka_corr_sparse_create(0U, num_samples) == NULL;
+    
+    report_test("Sparse Correlation", passed);
+    
+    rtka_corr_sparse_free(sparse);
+    rtka_corr_matrix_free(dense);
+    free_factor_data(data, num_vars);
+}
+
+/**
+ * Cell fields with solution errors driven by aspect ratio, skewness and
+ * volume; organized as separate arrays and as structs
+ */
+typedef struct {
+    double* fields[9];
+    rtka_cell_quality_soa_t mesh;
+    rtka_solution_quality_soa_t solution;
+    rtka_cell_quality_t* mesh_aos;
+    rtka_solution_quality_t* solution_aos;
+} cfd_test_data_t;
+
+static void generate_cfd_data(cfd_test_data_t* data, size_t num_cells) {
+    for (size_t fld = 0U; fld < 9U; fld++) {
+        data->fields[fld] = malloc(num_cells * sizeof(double));
+    }
+    data->mesh_aos = malloc(num_cells * sizeof(rtka_cell_quality_t));
+    data->solution_aos = malloc(num_cells * sizeof(rtka_solution_quality_t));
+    
+    for (size_t idx = 0U; idx < num_cells; idx++) {
+        double u[6];
+        for (size_t k = 0U; k < 6U; k++) {
+            u[k] = (double)rand() / (double)RAND_MAX;
+        }
+        rtka_cell_quality_t cell = {
+            1.0 + 9.0 * u[0] * u[0], 0.6 * u[1], 1e-6 * (0.5 + u[2]), 0.6 + 0.4 * u[3], 1.0 + u[4]
+        };
+        rtka_solution_quality_t solution = {
+            1e-6 * (1.0 + 0.3 * cell.aspect_ratio + 4.0 * cell.skewness + u[5]),
+            1e-3 * (2.0 - cell.orthogonality + 0.5 * u[5]),
+            1e-4 * (cell.volume * 1e6 + 0.2 * u[4]),
+            30.0 + u[5]
+        };
+        data->mesh_aos[idx] = cell;
+        data->solution_aos[idx] = solution;
+        double values[9] = {
+            cell.aspect_ratio, cell.skewness, cell.volume, cell.orthogonality, cell.stretch,
+            solution.residual, solution.gradient_error, solution.truncation_err, solution.y_plus
+        };
+        for (size_t fld = 0U; fld < 9U; fld++) {
+            data->fields[fld][idx] = values[fld];
+        }
+    }
+    
+    data->mesh = (rtka_cell_quality_soa_t){
+        data->fields[0], data->fields[1], data->fields[2], data->fields[3], data->fields[4]
+    };
+    data->solution = (rtka_solution_quality_soa_t){
+        data->fields[5], data->fields[6], data->fields[7], data->fields[8]
+    };
+}
+
+static void free_cfd_data(cfd_test_data_t* data) {
+    for (size_t fld = 0U; fld < 9U; fld++) {
+        free(data->fields[fld]);
+    }
+    free(data->mesh_aos);
+    free(data->solution_aos);
+}
+
+static bool stats_match(const rtka_stats_t* lhs, const rtka_stats_t* rhs) {
+    return lhs->count == rhs->count &&
+           fabs(lhs->mean - rhs->mean) <= 1e-12 * fabs(rhs->mean) &&
+           fabs(lhs->variance - rhs->variance) <= 1e-9 * rhs->variance;
+}
+
+/**
+ * Compare an assessment with per-field rtka_corr_statistics() and
+ * rtka_corr_pearson_simple()
+ */
+static bool cfd_matches_reference(const cfd_test_data_t* data, size_t num_cells, double threshold,
+                                  const rtka_mesh_stats_t* stats, const rtka_cfd_correlation_analysis_t* analysis) {
+    bool ok = true;
+    
+    if (stats != NULL) {
+        rtka_stats_t reference[4];
+        for (size_t fld = 0U; fld < 4U; fld++) {
+            ok = ok && rtka_corr_statistics(data->fields[fld], num_cells, &reference[fld]) == RTKA_CORR_SUCCESS;
+        }
+        size_t poor = 0U;
+        for (size_t idx = 0U; idx < num_cells; idx++) {
+            double quality = fmin(data->mesh.orthogonality[idx], 1.0 - data->mesh.skewness[idx]);
+            poor += quality < threshold ? 1U : 0U;
+        }
+        ok = ok && stats_match(&stats->aspect_ratio_stats, &reference[0]) &&
+             stats_match(&stats->skewness_stats, &reference[1]) &&
+             stats_match(&stats->volume_stats, &reference[2]) &&
+             stats_match(&stats->orthogonality_stats, &reference[3]) &&
+             stats->num_cells == num_cells && stats->poor_quality_cells == poor;
+    }
+    
+    if (analysis != NULL) {
+        const double* pairs[4][2] = {
+            { data->mesh.aspect_ratio, data->solution.residual },
+            { data->mesh.skewness, data->solution.residual },
+            { data->mesh.volume, data->solution.truncation_err },
+            { data->mesh.orthogonality, data->solution.gradient_error }
+        };
+        const double found[4] = {
+            analysis->aspect_vs_residual, analysis->skewness_vs_residual,
+            analysis->volume_vs_error, analysis->orthog_vs_convergence
+        };
+        for (size_t pair = 0U; pair < 4U; pair++) {
+            double reference = 0.0;
+            ok = ok && rtka_corr_pearson_simple(pairs[pair][0], pairs[pair][1], num_cells, &reference) ==
+                       RTKA_CORR_SUCCESS && approx_equal(found[pair], reference, 1e-10);
+        }
+    }
+    
+    return ok;
+}
+
+static void test_cfd_mesh_analysis(void) {
+    const size_t num_cells = 100003U;
+    const double threshold = 0.5;
+    const char* path = "rtka_cfd_mesh_test.bin";
+    
+    srand(4242U);
+    cfd_test_data_t data;
+    generate_cfd_data(&data, num_cells);
+    
+    rtka_mesh_stats_t stats;
+    rtka_cfd_correlation_analysis_t analysis;
+    memset(&stats, 0, sizeof(stats));
+    memset(&analysis, 0, sizeof(analysis));
+    
+    /* Array-of-structs entry points */
+    bool passed = rtka_mesh_quality_statistics(data.mesh_aos, num_cells, threshold, &stats) == RTKA_CORR_SUCCESS &&
+                  rtka_cfd_correlate_mesh_solution(data.mesh_aos, data.solution_aos, num_cells, &analysis) ==
+                  RTKA_CORR_SUCCESS &&
+                  cfd_matches_reference(&data, num_cells, threshold, &stats, &analysis);
+    printf("  AoS: %zu poor cells, aspect/residual r = %.4f, orthogonality/gradient r = %.4f\n",
+           stats.poor_quality_cells, analysis.aspect_vs_residual, analysis.orthog_vs_convergence);
+    printf("  Primary issue: %s\n", analysis.primary_issue);
+    
+    /* One pass over separate arrays, one and several threads */
+    const size_t threads[] = { 1U, 3U };
+    for (size_t idx = 0U; idx < 2U; idx++) {
+        memset(&stats, 0, sizeof(stats));
+        memset(&analysis, 0, sizeof(analysis));
+        passed = passed && rtka_cfd_assess_mesh(&data.mesh, &data.solution, num_cells, threshold, threads[idx],
+                                                &stats, &analysis) == RTKA_CORR_SUCCESS &&
+                 cfd_matches_reference(&data, num_cells, threshold, &stats, &analysis);
+    }
+    passed = passed && rtka_mesh_quality_statistics_soa(&data.mesh, num_cells, threshold, &stats) ==
+                       RTKA_CORR_SUCCESS &&
+             rtka_cfd_correlate_mesh_solution_soa(&data.mesh, &data.solution, num_cells, &analysis) ==
+             RTKA_CORR_SUCCESS &&
+             cfd_matches_reference(&data, num_cells, threshold, &stats, &analysis);
+    
+    /* Mapped file gives the same fields */
+    rtka_cfd_mesh_file_t file;
+    passed = passed && rtka_cfd_mesh_file_write(path, &data.mesh, &data.solution, num_cells) == RTKA_CORR_SUCCESS &&
+             rtka_cfd_mesh_file_open(path, &file) == RTKA_CORR_SUCCESS && file.num_cells == num_cells &&
+             memcmp(file.solution.y_plus, data.solution.y_plus, num_cells * sizeof(double)) == 0 &&
+             memcmp(file.mesh.stretch, data.mesh.stretch, num_cells * sizeof(double)) == 0 &&
+             rtka_cfd_assess_mesh(&file.mesh, &file.solution, file.num_cells, threshold, 2U,
+                                  &stats, &analysis) == RTKA_CORR_SUCCESS &&
+             cfd_matches_reference(&data, num_cells, threshold, &stats, &analysis);
+    rtka_cfd_mesh_file_close(&file);
+    passed = passed && file.base == NULL;
+    
+    /* Errors: threshold, missing and truncated files, missing fields */
+    passed = passed && rtka_mesh_quality_statistics_soa(&data.mesh, num_cells, 1.5, &stats) ==
+                       RTKA_CORR_ERROR_INVALID_RANGE;
+    passed = passed && rtka_cfd_mesh_file_open("rtka_cfd_no_such_file.bin", &file) == RTKA_CORR_ERROR_IO;
+    passed = passed && truncate(path, 1000) == 0 &&
+             rtka_cfd_mesh_file_open(path, &file) == RTKA_CORR_ERROR_INVALID_SIZE;
+    remove(path);
+    rtka_cell_quality_soa_t partial = data.mesh;
+    partial.volume = NULL;
+    passed = passed && rtka_cfd_assess_mesh(&partial, NULL, num_cells, threshold, 1U, &stats, NULL) ==
+                       RTKA_CORR_ERROR_NULL_PTR;
+    passed = passed && rtka_mesh_quality_statistics(data.mesh_aos, 1U, threshold, &stats) ==
+                       RTKA_CORR_ERROR_INVALID_SIZE;
+    
+    report_test("CFD Mesh Quality Analysis", passed);
+    
+    free_cfd_data(&data);
+}
+
+/* Structured block meshes: tetrahedra, hexahedra, or hexahedra and wedges */
+typedef enum { BLOCK_HEXAHEDRA, BLOCK_TETRAHEDRA, BLOCK_MIXED } block_kind_t;
+
+typedef struct {
+    size_t* offsets;
+    unsigned int* vertices;
+    rtka_mesh_connectivity_t connectivity;
+} block_mesh_t;
+
+/**
+ * nx x ny x nz cubes, optionally without the center cube; tetrahedra
+ * split each cube into six along the main diagonal and wedges into two
+ * along the bottom diagonal, so neighbors share whole faces
+ */
+static void build_block_mesh(block_mesh_t* block, size_t nx, size_t ny, size_t nz, block_kind_t kind, bool hollow) {
+    static const unsigned char kuhn[6][4] = {
+        { 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 }, { 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 }
+    };
+    size_t cubes = nx * ny * nz;
+    block->offsets = malloc((6U * cubes + 1U) * sizeof(size_t));
+    block->vertices = malloc(24U * cubes * sizeof(unsigned int));
+    size_t cells = 0U;
+    size_t used = 0U;
+    block->offsets[0] = 0U;
+    
+    for (size_t k = 0U; k < nz; k++) {
+        for (size_t j = 0U; j < ny; j++) {
+            for (size_t i = 0U; i < nx; i++) {
+                if (hollow && i == nx / 2U && j == ny / 2U && k == nz / 2U) {
+                    continue;
+                }
+                /* Corner c has bits x, y, z */
+                unsigned int corner[8];
+                for (size_t c = 0U; c < 8U; c++) {
+                    corner[c] = (unsigned int)(((k + (c >> 2U)) * (ny + 1U) + j + ((c >> 1U) & 1U)) * (nx + 1U) +
+                                               i + (c & 1U));
+                }
+                unsigned int hex[8] = { corner[0], corner[1], corner[3], corner[2],
+                                        corner[4], corner[5], corner[7], corner[6] };
+                if (kind == BLOCK_TETRAHEDRA) {
+                    for (size_t t = 0U; t < 6U; t++) {
+                        for (size_t v = 0U; v < 4U; v++) {
+                            block->vertices[used++] = corner[kuhn[t][v]];
+                        }
+                        block->offsets[++cells] = used;
+                    }
+                } else if (kind == BLOCK_MIXED && i >= nx / 2U) {
+                    unsigned int wedges[2][6] = {
+                        { hex[0], hex[1], hex[2], hex[4], hex[5], hex[6] },
+                        { hex[0], hex[2], hex[3], hex[4], hex[6], hex[7] }
+                    };
+                    for (size_t w = 0U; w < 2U; w++) {
+                        memcpy(block->vertices + used, wedges[w], sizeof(wedges[w]));
+                        used += 6U;
+                        block->offsets[++cells] = used;
+                    }
+                } else {
+                    memcpy(block->vertices + used, hex, sizeof(hex));
+                    used += 8U;
+                    block->offsets[++cells] = used;
+                }
+            }
+        }
+    }
+    
+    block->connectivity = (rtka_mesh_connectivity_t){
+        block->offsets, block->vertices, 0U, cells, (nx + 1U) * (ny + 1U) * (nz + 1U)
+    };
+}
+
+static void free_block_mesh(block_mesh_t* block) {
+    free(block->offsets);
+    free(block->vertices);
+}
+
+static void test_mesh_topology(void) {
+    const size_t nx = 7U, ny = 5U, nz = 4U;
+    const size_t outer = 2U * (nx * ny + ny * nz + nx * nz);
+    block_mesh_t block;
+    rtka_mesh_topology_t topology;
+    bool passed = true;
+    
+    /* Hexahedra: closed-form counts, with and without offsets */
+    build_block_mesh(&block, nx, ny, nz, BLOCK_HEXAHEDRA, false);
+    memset(&topology, 0, sizeof(topology));
+    topology.expected_char = 1;
+    passed = passed && rtka_mesh_topology_from_connectivity(&block.connectivity, 1U, &topology) == RTKA_CORR_SUCCESS &&
+             topology.vertices == (nx + 1U) * (ny + 1U) * (nz + 1U) &&
+             topology.edges == nx * (ny + 1U) * (nz + 1U) + (nx + 1U) * ny * (nz + 1U) + (nx + 1U) * (ny + 1U) * nz &&
+             topology.faces == (nx + 1U) * ny * nz + nx * (ny + 1U) * nz + nx * ny * (nz + 1U) &&
+             topology.cells == nx * ny * nz && topology.euler_char == 1 && topology.is_valid &&
+             topology.boundary_faces == outer && topology.nonmanifold_faces == 0U;
+    printf("  Hexahedra: V=%zu E=%zu F=%zu C=%zu, χ = %d, %zu boundary faces\n", topology.vertices,
+           topology.edges, topology.faces, topology.cells, topology.euler_char, topology.boundary_faces);
+    rtka_mesh_topology_t uniform = topology;
+    rtka_mesh_connectivity_t fixed = block.connectivity;
+    fixed.cell_offsets = NULL;
+    fixed.vertices_per_cell = 8U;
+    passed = passed && rtka_mesh_topology_from_connectivity(&fixed, 3U, &uniform) == RTKA_CORR_SUCCESS &&
+             uniform.edges == topology.edges && uniform.faces == topology.faces &&
+             rtka_mesh_validate_topology(&uniform, 1) && !rtka_mesh_validate_topology(&uniform, 2);
+    free_block_mesh(&block);
+    
+    /* Tetrahedra and mixed hexahedra/wedges over several threads; split
+     * cube faces on the boundary count twice */
+    const block_kind_t kinds[] = { BLOCK_TETRAHEDRA, BLOCK_MIXED };
+    const size_t boundary[] = { 2U * outer, outer + 2U * (nx - nx / 2U) * ny };
+    for (size_t idx = 0U; idx < 2U; idx++) {
+        build_block_mesh(&block, nx, ny, nz, kinds[idx], false);
+        memset(&topology, 0, sizeof(topology));
+        topology.expected_char = 1;
+        passed = passed && rtka_mesh_topology_from_connectivity(&block.connectivity, 4U, &topology) ==
+                           RTKA_CORR_SUCCESS && topology.is_valid && topology.nonmanifold_faces == 0U &&
+                 topology.boundary_faces == boundary[idx];
+        printf("  %s: V=%zu E=%zu F=%zu C=%zu, χ = %d, %zu boundary faces\n",
+               idx == 0U ? "Tetrahedra" : "Hexahedra and wedges", topology.vertices, topology.edges,
+               topology.faces, topology.cells, topology.euler_char, topology.boundary_faces);
+        free_block_mesh(&block);
+    }
+    
+    /* One interior void: χ = 2, its six faces join the boundary */
+    build_block_mesh(&block, nx, ny, nz, BLOCK_HEXAHEDRA, true);
+    topology.expected_char = 2;
+    passed = passed && rtka_mesh_topology_from_connectivity(&block.connectivity, 2U, &topology) == RTKA_CORR_SUCCESS &&
+             topology.euler_char == 2 && topology.is_valid && topology.boundary_faces == outer + 6U;
+    printf("  Hollow hexahedra: χ = %d\n", topology.euler_char);
+    
+    /* Three copies of one cell: every face non-manifold */
+    unsigned int tripled[24];
+    for (size_t idx = 0U; idx < 24U; idx++) {
+        tripled[idx] = block.vertices[idx % 8U];
+    }
+    rtka_mesh_connectivity_t stacked = { NULL, tripled, 8U, 3U, block.connectivity.num_vertices };
+    passed = passed && rtka_mesh_topology_from_connectivity(&stacked, 1U, &topology) == RTKA_CORR_SUCCESS &&
+             topology.nonmanifold_faces == 6U && topology.boundary_faces == 0U;
+    
+    /* Errors: unknown cell size, vertex out of range */
+    stacked.vertices_per_cell = 7U;
+    passed = passed && rtka_mesh_topology_from_connectivity(&stacked, 1U, &topology) == RTKA_CORR_ERROR_INVALID_SIZE;
+    stacked.vertices_per_cell = 8U;
+    tripled[5] = (unsigned int)stacked.num_vertices;
+    passed = passed && rtka_mesh_topology_from_connectivity(&stacked, 2U, &topology) == RTKA_CORR_ERROR_INVALID_RANGE;
+    passed = passed && rtka_mesh_topology_from_connectivity(NULL, 1U, &topology) == RTKA_CORR_ERROR_NULL_PTR &&
+             rtka_mesh_euler_characteristic(NULL) == RTKA_CORR_ERROR_NULL_PTR;
+    free_block_mesh(&block);
+    
+    report_test("Mesh Topology from Connectivity", passed);
+}
+
 static void test_interpretation(void) {
     const char* result = NULL;
     bool passed = true;
@@ -441,6 +1123,275 @@ static void test_performance_large_dataset(void) {
     free(y_data);
 }
 
+static double elapsed_ms(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+}
+
+static void test_performance_matrix(void) {
+    const size_t num_vars = 256U;
+    const size_t num_samples = 8192U;
+    
+    srand(13579U);
+    double** data = generate_factor_data(num_vars, num_samples);
+    rtka_corr_matrix_t* reference = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_matrix_t* blocked = rtka_corr_matrix_create(num_vars, num_samples);
+    
+    clock_t start = clock();
+    rtka_corr_error_t err = rtka_corr_matrix_compute(
+        (const double* const*)data, num_vars, num_samples, reference
+    );
+    double pairwise = elapsed_ms(start);
+    
+    /* One thread, so clock() time compares like for like */
+    rtka_corr_matrix_options_t options = { RTKA_CORR_ACCUM_DOUBLE, 1U };
+    start = clock();
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_matrix_compute_blocked(
+        (const double* const*)data, num_vars, num_samples, &options, blocked
+    );
+    double blocked_double = elapsed_ms(start);
+    
+    options.accumulation = RTKA_CORR_ACCUM_FLOAT;
+    start = clock();
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_matrix_compute_blocked(
+        (const double* const*)data, num_vars, num_samples, &options, blocked
+    );
+    double blocked_float = elapsed_ms(start);
+    
+    /* Multiply-adds of the upper triangle */
+    double flops = (double)num_vars * (double)(num_vars + 1U) * (double)num_samples;
+    printf("  %zu variables x %zu samples\n", num_vars, num_samples);
+    printf("  Pairwise:        %.1f ms\n", pairwise);
+    printf("  Blocked float64: %.1f ms (%.1fx, %.2f GFLOP/s)\n",
+           blocked_double, pairwise / blocked_double, flops / blocked_double * 1e-6);
+    printf("  Blocked float32: %.1f ms (%.1fx, %.2f GFLOP/s)\n",
+           blocked_float, pairwise / blocked_float, flops / blocked_float * 1e-6);
+    
+    report_test("Correlation Matrix Performance", err == RTKA_CORR_SUCCESS && blocked_double < pairwise);
+    
+    rtka_corr_matrix_free(reference);
+    rtka_corr_matrix_free(blocked);
+    free_factor_data(data, num_vars);
+}
+
+/**
+ * Scalar Kahan summation as the library had it; the barriers keep
+ * -ffast-math from folding the compensation to zero
+ */
+static double scalar_kahan_sum(const double* data, size_t count) {
+    double sum = 0.0;
+    double compensation = 0.0;
+    for (size_t idx = 0U; idx < count; idx++) {
+        double corrected = data[idx] - compensation;
+        double new_sum = sum + corrected;
+        __asm__ volatile("" : "+x"(new_sum));
+        double added = new_sum - sum;
+        __asm__ volatile("" : "+x"(added));
+        compensation = added - corrected;
+        sum = new_sum;
+    }
+    return sum;
+}
+
+static void test_summation(void) {
+    const size_t count = 1U << 24;
+    double* data = malloc(count * sizeof(double));
+    
+    /* 0.1-scale terms on an offset of 1e8: sequential sums drop low bits */
+    srand(31415U);
+    long double exact = 0.0L;
+    for (size_t idx = 0U; idx < count; idx++) {
+        data[idx] = 1e8 + (double)rand() / (double)RAND_MAX * 0.1;
+        exact += (long double)data[idx];
+    }
+    double exact_mean = (double)(exact / (long double)count);
+    
+    double mean = 0.0;
+    rtka_corr_error_t err = rtka_corr_mean(data, count, &mean);
+    double kahan_mean = scalar_kahan_sum(data, count) / (double)count;
+    double sequential = 0.0;
+    for (size_t idx = 0U; idx < count; idx++) {
+        sequential += data[idx];
+        __asm__ volatile("" : "+x"(sequential));
+    }
+    double sequential_mean = sequential / (double)count;
+    
+    double variance = 0.0;
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_variance(data, count, mean, &variance, NULL);
+    
+    /* Throughput on 64K terms, resident in L2 */
+    const size_t resident = 1U << 16;
+    const size_t repeats = 512U;
+    double sink = 0.0;
+    clock_t start = clock();
+    for (size_t rep = 0U; rep < repeats && err == RTKA_CORR_SUCCESS; rep++) {
+        double value = 0.0;
+        err = rtka_corr_mean(data + rep, resident, &value);
+        sink += value;
+    }
+    double pairwise_ms = elapsed_ms(start);
+    start = clock();
+    for (size_t rep = 0U; rep < repeats; rep++) {
+        sink += scalar_kahan_sum(data + rep, resident);
+    }
+    double kahan_ms = elapsed_ms(start);
+    
+    double pairwise_error = fabs(mean - exact_mean) / exact_mean;
+    printf("  %zu terms, mean relative error: pairwise %.1e, Kahan %.1e, sequential %.1e\n",
+           count, pairwise_error, fabs(kahan_mean - exact_mean) / exact_mean,
+           fabs(sequential_mean - exact_mean) / exact_mean);
+    printf("  %zu-term mean: pairwise %.2f Gterms/s, scalar Kahan %.2f Gterms/s (%.1fx)%s\n",
+           resident, (double)(resident * repeats) / pairwise_ms * 1e-6,
+           (double)(resident * repeats) / kahan_ms * 1e-6, kahan_ms / pairwise_ms, sink == 0.0 ? " " : "");
+    
+    /* Uniform on [0, 0.1]: variance 0.01 / 12 */
+    bool passed = err == RTKA_CORR_SUCCESS && pairwise_error < 1e-15 &&
+                  fabs(variance - 0.01 / 12.0) < 1e-5;
+    report_test("Pairwise Summation", passed);
+    
+    free(data);
+}
+
+static void test_performance_stream(void) {
+    const size_t num_vars = 256U;
+    const size_t num_samples = 8192U;
+    
+    srand(97531U);
+    double* samples = malloc(num_vars * num_samples * sizeof(double));
+    for (size_t idx = 0U; idx < num_vars * num_samples; idx++) {
+        samples[idx] = (double)rand() / (double)RAND_MAX;
+    }
+    
+    rtka_corr_stream_t* stream = rtka_corr_stream_create(num_vars);
+    clock_t start = clock();
+    rtka_corr_error_t err = rtka_corr_stream_push(stream, samples, num_samples);
+    double elapsed = elapsed_ms(start);
+    
+    double flops = (double)num_vars * (double)(num_vars + 1U) * (double)num_samples;
+    printf("  Stream push, %zu variables x %zu samples: %.1f ms (%.2f GFLOP/s, %zu KB state)\n",
+           num_vars, num_samples, elapsed, flops / elapsed * 1e-6,
+           num_vars * (num_vars + RTKA_CORR_STREAM_BATCH + 3U) * sizeof(double) / 1024U);
+    report_test("Streaming Correlation Performance", err == RTKA_CORR_SUCCESS && stream->count == num_samples);
+    
+    rtka_corr_stream_free(stream);
+    free(samples);
+}
+
+static void test_performance_sparse(void) {
+    const size_t num_vars = 2048U;
+    const size_t num_samples = 8192U;
+    
+    srand(11235U);
+    double** data = generate_group_data(num_vars, num_samples);
+    rtka_corr_matrix_t* dense = rtka_corr_matrix_create(num_vars, num_samples);
+    rtka_corr_sparse_t* sparse = rtka_corr_sparse_create(num_vars, num_samples);
+    
+    rtka_corr_matrix_options_t dense_options = { RTKA_CORR_ACCUM_DOUBLE, 1U };
+    clock_t start = clock();
+    rtka_corr_error_t err = rtka_corr_matrix_compute_blocked(
+        (const double* const*)data, num_vars, num_samples, &dense_options, dense
+    );
+    double blocked = elapsed_ms(start);
+    
+    rtka_corr_sparse_options_t options = { 0.7, 0U, 512U, 0.0, 0U };
+    start = clock();
+    err = err != RTKA_CORR_SUCCESS ? err : rtka_corr_sparse_compute(
+        (const double* const*)data, num_vars, num_samples, &options, sparse
+    );
+    double sketched = elapsed_ms(start);
+    
+    bool passed = err == RTKA_CORR_SUCCESS && sparse_matches_dense(sparse, dense, options.threshold, 0U);
+    printf("  %zu variables x %zu samples, |r| >= %.1f\n", num_vars, num_samples, options.threshold);
+    printf("  Blocked float64 matrix: %.1f ms, %zu KB\n", blocked,
+           num_vars * num_vars * sizeof(double) / 1024U);
+    printf("  Sparse, %zu buckets:    %.1f ms (%.1fx), %zu pairs, %zu computed exactly, %zu KB sketch\n",
+           options.sketch_dimension, sketched, blocked / sketched, sparse->count, sparse->candidates,
+           num_vars * options.sketch_dimension * sizeof(float) / 1024U);
+    report_test("Sparse Correlation Performance", passed && sketched < blocked);
+    
+    rtka_corr_sparse_free(sparse);
+    rtka_corr_matrix_free(dense);
+    free_factor_data(data, num_vars);
+}
+
+static void test_performance_cfd(void) {
+    const size_t num_cells = 1U << 21;
+    const double threshold = 0.5;
+    const char* path = "rtka_cfd_mesh_perf.bin";
+    
+    srand(5151U);
+    cfd_test_data_t data;
+    generate_cfd_data(&data, num_cells);
+    rtka_cfd_mesh_file_t file;
+    bool passed = rtka_cfd_mesh_file_write(path, &data.mesh, &data.solution, num_cells) == RTKA_CORR_SUCCESS &&
+                  rtka_cfd_mesh_file_open(path, &file) == RTKA_CORR_SUCCESS;
+    
+    /* Separate calls: four field statistics and four correlations */
+    rtka_stats_t field_stats[4];
+    double coefficients[4];
+    const double* pairs[4][2] = {
+        { data.mesh.aspect_ratio, data.solution.residual },
+        { data.mesh.skewness, data.solution.residual },
+        { data.mesh.volume, data.solution.truncation_err },
+        { data.mesh.orthogonality, data.solution.gradient_error }
+    };
+    clock_t start = clock();
+    for (size_t idx = 0U; idx < 4U; idx++) {
+        passed = passed && rtka_corr_statistics(data.fields[idx], num_cells, &field_stats[idx]) == RTKA_CORR_SUCCESS &&
+                 rtka_corr_pearson_simple(pairs[idx][0], pairs[idx][1], num_cells, &coefficients[idx]) ==
+                 RTKA_CORR_SUCCESS;
+    }
+    double separate = elapsed_ms(start);
+    
+    /* Same results from the AoS entry points, two strided passes */
+    rtka_mesh_stats_t stats;
+    rtka_cfd_correlation_analysis_t analysis;
+    start = clock();
+    passed = passed && rtka_mesh_quality_statistics(data.mesh_aos, num_cells, threshold, &stats) == RTKA_CORR_SUCCESS &&
+             rtka_cfd_correlate_mesh_solution(data.mesh_aos, data.solution_aos, num_cells, &analysis) ==
+             RTKA_CORR_SUCCESS;
+    double aos = elapsed_ms(start);
+    
+    /* One thread, so clock() time compares like for like; pages cached by the write */
+    start = clock();
+    passed = passed && rtka_cfd_assess_mesh(&file.mesh, &file.solution, file.num_cells, threshold, 1U,
+                                            &stats, &analysis) == RTKA_CORR_SUCCESS;
+    double mapped = elapsed_ms(start);
+    passed = passed && cfd_matches_reference(&data, num_cells, threshold, &stats, &analysis);
+    
+    double bytes = (double)num_cells * 7.0 * sizeof(double);
+    printf("  %zu cells, 7 fields\n", num_cells);
+    printf("  Separate statistics and correlations: %.1f ms\n", separate);
+    printf("  AoS statistics + correlation:         %.1f ms (%.1fx)\n", aos, separate / aos);
+    printf("  One pass over the mapped file:        %.1f ms (%.1fx, %.2f GB/s)\n",
+           mapped, separate / mapped, bytes / mapped * 1e-6);
+    report_test("CFD Mesh Analysis Performance", passed && mapped < separate);
+    
+    rtka_cfd_mesh_file_close(&file);
+    remove(path);
+    free_cfd_data(&data);
+}
+
+static void test_performance_topology(void) {
+    const size_t edge_cells = 64U;
+    block_mesh_t block;
+    rtka_mesh_topology_t topology;
+    
+    build_block_mesh(&block, edge_cells, edge_cells, edge_cells, BLOCK_TETRAHEDRA, false);
+    memset(&topology, 0, sizeof(topology));
+    topology.expected_char = 1;
+    
+    /* One thread, so clock() time compares like for like */
+    clock_t start = clock();
+    rtka_corr_error_t err = rtka_mesh_topology_from_connectivity(&block.connectivity, 1U, &topology);
+    double elapsed = elapsed_ms(start);
+    
+    printf("  %zu tetrahedra, %zu edges and %zu faces deduplicated: %.1f ms (%.1f M cells/s)\n",
+           topology.cells, topology.edges, topology.faces, elapsed, (double)topology.cells / elapsed * 1e-3);
+    report_test("Mesh Topology Performance", err == RTKA_CORR_SUCCESS && topology.is_valid);
+    
+    free_block_mesh(&block);
+}
+
 /* ============================================================================
  * MAIN TEST RUNNER
  * ============================================================================ */
@@ -471,6 +1422,23 @@ int main(void) {
     /* Correlation matrix tests */
     printf("=== Correlation Matrix Tests ===\n");
     test_correlation_matrix();
+    test_blocked_matrix();
+    printf("\n");
+    
+    /* Streaming correlation tests */
+    printf("=== Streaming Correlation Tests ===\n");
+    test_stream_correlation();
+    printf("\n");
+    
+    /* Sparse correlation tests */
+    printf("=== Sparse Correlation Tests ===\n");
+    test_sparse_correlation();
+    printf("\n");
+    
+    /* CFD mesh analysis tests */
+    printf("=== CFD Mesh Analysis Tests ===\n");
+    test_cfd_mesh_analysis();
+    test_mesh_topology();
     printf("\n");
     
     /* Utility function tests */
@@ -481,6 +1449,12 @@ int main(void) {
     /* Performance tests */
     printf("=== Performance Tests ===\n");
     test_performance_large_dataset();
+    test_summation();
+    test_performance_matrix();
+    test_performance_stream();
+    test_performance_sparse();
+    test_performance_cfd();
+    test_performance_topology();
     printf("\n");
     
     /* Print summary */
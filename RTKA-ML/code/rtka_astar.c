@@ -9,14 +9,39 @@
  * RTKA A* Search Implementation
  * 
  * CHANGELOG:
+ * v1.3.1 - Expansions and generated neighbors counted, expansions timed
+ *          (rtka_perf.h, make perf)
+ * v1.3.0 - Inline fixed-size states in the node pool and the buffer-filling
+ *          neighbor callback; no allocation per expansion
+ * v1.2.0 - Bucket queue for integral costs (O(1) push / pop / decrease)
+ *          and bidirectional search; both run on frontier_t, so forward
+ *          and backward directions share the queue and table code.
+ * v1.1.0 - Indexed heap, hashed node table and pooled nodes: an expansion
+ *          costs O(log open) instead of O(open + closed). Improved paths
+ *          to open nodes now re-sort them (decrease-key).
  * v1.0.1 - Fixed memory management for neighbors
  *          Removed free(neighbors) for static arrays (line 144)
  *          Fixed neighbor state access (line 130)
  */
 
 #include "rtka_astar.h"
+#include "rtka_perf.h"
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+
+#define ASTAR_INITIAL_CAPACITY  1024U
+#define ASTAR_BLOCK_NODES       1024U
+#define ASTAR_MAX_BUCKETS       (1U << 24)    /* Integral f beyond this is refused */
+
+/* Node pool: blocks are chained and only released with the context. With
+ * inline states each block carries one state slot per node. */
+struct rtka_astar_block {
+    rtka_astar_block_t* next;
+    uint32_t used;
+    rtka_astar_node_t nodes[ASTAR_BLOCK_NODES];
+    uint8_t states[] RTKA_ALIGNED(16);
+};
 
 /* Create A* context */
 rtka_astar_t* rtka_astar_create(void) {
@@ -27,6 +52,41 @@ rtka_astar_t* rtka_astar_create(void) {
     return astar;
 }
 
+static rtka_astar_node_t* alloc_node(rtka_astar_t* astar) {
+    rtka_astar_block_t* block = astar->blocks;
+    if (!block || block->used == ASTAR_BLOCK_NODES) {
+        block = malloc(sizeof(rtka_astar_block_t) + ASTAR_BLOCK_NODES * astar->state_size);
+        if (!block) return NULL;
+        block->next = astar->blocks;
+        block->used = 0;
+        astar->blocks = block;
+    }
+    rtka_astar_node_t* node = &block->nodes[block->used];
+    memset(node, 0, sizeof(*node));
+    node->heap_index = ASTAR_NOT_OPEN;
+    if (astar->state_size) node->state = block->states + block->used * astar->state_size;
+    block->used++;
+    return node;
+}
+
+/* Neighbor states from the callback copies only matter outside inline mode */
+static inline void release_state(rtka_astar_t* astar, void* state) {
+    if (!astar->state_size) astar->free_state(state);
+}
+
+/* Score arithmetic: ternary OR by default, plain sums of integral
+ * confidences with ASTAR_INTEGER_COSTS */
+static inline rtka_state_t combine(const rtka_astar_t* astar, rtka_state_t a, rtka_state_t b) {
+    if (astar->flags & ASTAR_INTEGER_COSTS) {
+        return rtka_make_state(rtka_or(a.value, b.value), a.confidence + b.confidence);
+    }
+    return rtka_combine_or(a, b);
+}
+
+static inline uint32_t bucket_of(const rtka_astar_node_t* node) {
+    return (uint32_t)lrintf(node->f_score.confidence);
+}
+
 /* Compare nodes using ternary logic */
 static int compare_nodes(rtka_astar_node_t* a, rtka_astar_node_t* b) {
     /* Compare f_scores with ternary values */
@@ -36,91 +96,341 @@ static int compare_nodes(rtka_astar_node_t* a, rtka_astar_node_t* b) {
     return (a->f_score.confidence < b->f_score.confidence) ? -1 : 1;
 }
 
-/* Push to open set (min heap) */
-void rtka_astar_push(rtka_astar_t* astar, rtka_astar_node_t* node) {
-    if (astar->open_count >= ASTAR_MAX_NODES) return;
-    
-    astar->open_set[astar->open_count] = node;
-    
-    /* Bubble up */
-    uint32_t idx = astar->open_count;
+/* ============================================================================
+ * BINARY HEAP
+ * ============================================================================ */
+
+static inline void heap_place(rtka_astar_frontier_t* f, uint32_t idx, rtka_astar_node_t* node) {
+    f->open_set[idx] = node;
+    node->heap_index = idx;
+}
+
+static void sift_up(rtka_astar_frontier_t* f, uint32_t idx) {
+    rtka_astar_node_t* node = f->open_set[idx];
     while (idx > 0) {
         uint32_t parent_idx = (idx - 1) / 2;
-        if (compare_nodes(astar->open_set[idx], astar->open_set[parent_idx]) < 0) {
-            rtka_astar_node_t* temp = astar->open_set[idx];
-            astar->open_set[idx] = astar->open_set[parent_idx];
-            astar->open_set[parent_idx] = temp;
-            idx = parent_idx;
-        } else {
-            break;
+        if (compare_nodes(node, f->open_set[parent_idx]) >= 0) break;
+        heap_place(f, idx, f->open_set[parent_idx]);
+        idx = parent_idx;
+    }
+    heap_place(f, idx, node);
+}
+
+static void sift_down(rtka_astar_frontier_t* f, uint32_t idx) {
+    rtka_astar_node_t* node = f->open_set[idx];
+    while (2 * idx + 1 < f->open_count) {
+        uint32_t child = 2 * idx + 1;
+        if (child + 1 < f->open_count &&
+            compare_nodes(f->open_set[child + 1], f->open_set[child]) < 0) {
+            child++;
         }
+        if (compare_nodes(f->open_set[child], node) >= 0) break;
+        heap_place(f, idx, f->open_set[child]);
+        idx = child;
+    }
+    heap_place(f, idx, node);
+}
+
+static bool heap_reserve(rtka_astar_frontier_t* f) {
+    if (f->open_count < f->open_capacity) return true;
+    uint32_t capacity = f->open_capacity ? f->open_capacity * 2 : ASTAR_INITIAL_CAPACITY;
+    rtka_astar_node_t** grown = realloc(f->open_set, capacity * sizeof(rtka_astar_node_t*));
+    if (!grown) return false;
+    f->open_set = grown;
+    f->open_capacity = capacity;
+    return true;
+}
+
+/* ============================================================================
+ * BUCKET QUEUE
+ * One doubly linked list per integral f. Pushing to the head makes ties
+ * LIFO, which favours deeper nodes; pop scans up from bucket_min, which
+ * only moves back when a heuristic is inconsistent.
+ * ============================================================================ */
+
+static bool bucket_reserve(rtka_astar_frontier_t* f, uint32_t bucket) {
+    if (bucket < f->bucket_capacity) return true;
+    if (bucket >= ASTAR_MAX_BUCKETS) return false;
+    uint32_t capacity = f->bucket_capacity ? f->bucket_capacity : 64U;
+    while (capacity <= bucket) capacity *= 2;
+    rtka_astar_node_t** grown = realloc(f->buckets, capacity * sizeof(rtka_astar_node_t*));
+    if (!grown) return false;
+    memset(grown + f->bucket_capacity, 0, (capacity - f->bucket_capacity) * sizeof(rtka_astar_node_t*));
+    f->buckets = grown;
+    f->bucket_capacity = capacity;
+    return true;
+}
+
+static void bucket_link(rtka_astar_frontier_t* f, rtka_astar_node_t* node, uint32_t bucket) {
+    node->heap_index = bucket;
+    node->bucket_prev = NULL;
+    node->bucket_next = f->buckets[bucket];
+    if (node->bucket_next) node->bucket_next->bucket_prev = node;
+    f->buckets[bucket] = node;
+    if (bucket < f->bucket_min) f->bucket_min = bucket;
+}
+
+static void bucket_unlink(rtka_astar_frontier_t* f, rtka_astar_node_t* node) {
+    if (node->bucket_prev) node->bucket_prev->bucket_next = node->bucket_next;
+    else f->buckets[node->heap_index] = node->bucket_next;
+    if (node->bucket_next) node->bucket_next->bucket_prev = node->bucket_prev;
+    node->heap_index = ASTAR_NOT_OPEN;
+}
+
+/* ============================================================================
+ * FRONTIER QUEUE
+ * ============================================================================ */
+
+static bool queue_reserve(const rtka_astar_t* astar, rtka_astar_frontier_t* f, const rtka_astar_node_t* node) {
+    if (astar->flags & ASTAR_INTEGER_COSTS) return bucket_reserve(f, bucket_of(node));
+    return heap_reserve(f);
+}
+
+static bool queue_push(rtka_astar_t* astar, rtka_astar_frontier_t* f, rtka_astar_node_t* node) {
+    if (!queue_reserve(astar, f, node)) return false;
+    if (astar->flags & ASTAR_INTEGER_COSTS) {
+        if (f->open_count == 0) f->bucket_min = bucket_of(node);
+        bucket_link(f, node, bucket_of(node));
+        f->open_count++;
+    } else {
+        f->open_set[f->open_count++] = node;
+        sift_up(f, f->open_count - 1);
     }
-    
-    astar->open_count++;
     astar->rtka_transitions++;
+    return true;
+}
+
+static rtka_astar_node_t* queue_top(rtka_astar_t* astar, rtka_astar_frontier_t* f) {
+    if (f->open_count == 0) return NULL;
+    if (!(astar->flags & ASTAR_INTEGER_COSTS)) return f->open_set[0];
+    while (!f->buckets[f->bucket_min]) f->bucket_min++;
+    return f->buckets[f->bucket_min];
+}
+
+static rtka_astar_node_t* queue_pop(rtka_astar_t* astar, rtka_astar_frontier_t* f) {
+    rtka_astar_node_t* result = queue_top(astar, f);
+    if (!result) return NULL;
+    if (astar->flags & ASTAR_INTEGER_COSTS) {
+        bucket_unlink(f, result);
+        f->open_count--;
+        return result;
+    }
+    result->heap_index = ASTAR_NOT_OPEN;
+    if (--f->open_count > 0) {
+        f->open_set[0] = f->open_set[f->open_count];
+        sift_down(f, 0);
+    }
+    return result;
+}
+
+/* f_score of an open node dropped; a lower bucket always exists */
+static void queue_decrease(rtka_astar_t* astar, rtka_astar_frontier_t* f, rtka_astar_node_t* node) {
+    if (node->heap_index == ASTAR_NOT_OPEN) return;
+    if (astar->flags & ASTAR_INTEGER_COSTS) {
+        uint32_t bucket = bucket_of(node);
+        if (bucket == node->heap_index) return;
+        bucket_unlink(f, node);
+        bucket_link(f, node, bucket);
+    } else {
+        sift_up(f, node->heap_index);
+    }
+}
+
+/* Push to open set */
+bool rtka_astar_push(rtka_astar_t* astar, rtka_astar_node_t* node) {
+    return queue_push(astar, &astar->forward, node);
 }
 
 /* Pop from open set */
 rtka_astar_node_t* rtka_astar_pop(rtka_astar_t* astar) {
-    if (astar->open_count == 0) return NULL;
-    
-    rtka_astar_node_t* result = astar->open_set[0];
-    astar->open_set[0] = astar->open_set[--astar->open_count];
+    return queue_pop(astar, &astar->forward);
+}
+
+void rtka_astar_decrease(rtka_astar_t* astar, rtka_astar_node_t* node) {
+    queue_decrease(astar, &astar->forward, node);
+}
+
+/* ============================================================================
+ * NODE TABLE
+ * Linear probing over node pointers; nodes are never removed, so no
+ * tombstones. Kept at most half full.
+ * ============================================================================ */
+
+static uint64_t bytes_hash(const uint8_t* bytes, size_t size) {
+    uint64_t h = 0xCBF29CE484222325ULL;             /* FNV-1a */
+    for (size_t i = 0; i < size; i++) h = (h ^ bytes[i]) * 0x100000001B3ULL;
+    return h;
+}
+
+static inline uint64_t state_hash(rtka_astar_t* astar, void* state) {
+    if (astar->hash) return astar->hash(state);
+    return astar->state_size ? bytes_hash((const uint8_t*)state, astar->state_size) : 0;
+}
+
+static inline bool states_equal(rtka_astar_t* astar, void* a, void* b) {
+    return astar->equals ? astar->equals(a, b) : memcmp(a, b, astar->state_size) == 0;
+}
+
+static rtka_astar_node_t* table_find(rtka_astar_t* astar, rtka_astar_frontier_t* f, void* state, uint64_t hash) {
+    if (!f->table_capacity) return NULL;
+    uint32_t mask = f->table_capacity - 1;
+    for (uint32_t slot = (uint32_t)(hash ^ (hash >> 32)) & mask;; slot = (slot + 1) & mask) {
+        rtka_astar_node_t* node = f->node_table[slot];
+        if (!node) return NULL;
+        if (node->hash == hash && states_equal(astar, node->state, state)) return node;
+    }
+}
+
+static void table_place(rtka_astar_node_t** table, uint32_t capacity, rtka_astar_node_t* node) {
+    uint32_t mask = capacity - 1;
+    uint32_t slot = (uint32_t)(node->hash ^ (node->hash >> 32)) & mask;
+    while (table[slot]) slot = (slot + 1) & mask;
+    table[slot] = node;
+}
+
+static bool table_reserve(rtka_astar_frontier_t* f) {
+    if (2 * (f->node_count + 1) <= f->table_capacity) return true;
+    uint32_t capacity = f->table_capacity ? f->table_capacity * 2 : ASTAR_INITIAL_CAPACITY;
+    rtka_astar_node_t** table = calloc(capacity, sizeof(rtka_astar_node_t*));
+    if (!table) return false;
+    for (uint32_t i = 0; i < f->table_capacity; i++) {
+        if (f->node_table[i]) table_place(table, capacity, f->node_table[i]);
+    }
+    free(f->node_table);
+    f->node_table = table;
+    f->table_capacity = capacity;
+    return true;
+}
+
+static void table_insert(rtka_astar_frontier_t* f, rtka_astar_node_t* node) {
+    table_place(f->node_table, f->table_capacity, node);
+    f->node_count++;
+}
+
+/* New node for state (copied in inline mode), registered and queued; NULL
+ * when out of memory, the state then still being the caller's. target is
+ * what h estimates towards. */
+static rtka_astar_node_t* add_node(rtka_astar_t* astar, rtka_astar_frontier_t* f, void* state, uint64_t hash,
+                                   rtka_astar_node_t* parent, rtka_state_t g, void* target) {
+    rtka_astar_node_t probe = {.g_score = g, .h_score = astar->heuristic(state, target)};
+    probe.f_score = combine(astar, probe.g_score, probe.h_score);
+    if (!table_reserve(f) || !queue_reserve(astar, f, &probe)) return NULL;
+    rtka_astar_node_t* node = alloc_node(astar);
+    if (!node) return NULL;
+    if (astar->state_size) memcpy(node->state, state, astar->state_size);
+    else node->state = state;
+    node->parent = parent;
+    node->g_score = probe.g_score;
+    node->h_score = probe.h_score;
+    node->f_score = probe.f_score;
+    node->hash = hash;
+    table_insert(f, node);
+    (void)queue_push(astar, f, node);       /* Capacity reserved above */
+    return node;
+}
+
+/* ============================================================================
+ * EXPANSION
+ * ============================================================================ */
+
+typedef struct {
+    rtka_astar_frontier_t* self;
+    rtka_astar_frontier_t* other;       /* Bidirectional: the opposite direction */
+    void* target;
+    bool reverse;                       /* Edges walked backwards: cost(next, current) */
+} direction_t;
+
+/* Best meeting so far: forward and backward node on the same state */
+typedef struct {
+    rtka_astar_node_t* forward;
+    rtka_astar_node_t* backward;
+    float cost;
+} meeting_t;
+
+static void try_meeting(rtka_astar_t* astar, const direction_t* d, rtka_astar_node_t* node, meeting_t* best) {
+    if (!d->other) return;
+    rtka_astar_node_t* match = table_find(astar, d->other, node->state, node->hash);
+    if (!match) return;
+    float cost = combine(astar, node->g_score, match->g_score).confidence;
+    if (best->forward && cost >= best->cost) return;
+    best->forward = d->reverse ? match : node;
+    best->backward = d->reverse ? node : match;
+    best->cost = cost;
+}
+
+/* Expand current's neighbors into d; false when out of memory */
+static bool expand_neighbors(rtka_astar_t* astar, const direction_t* d, rtka_astar_node_t* current,
+                             meeting_t* best) {
+    uint32_t neighbor_count = 0;
+    void** neighbor_array = NULL;
+    uint8_t* neighbor_bytes = (uint8_t*)astar->neighbor_buffer;
+    if (astar->state_size) {
+        neighbor_count = astar->get_neighbors_into(current->state, neighbor_bytes, ASTAR_MAX_NEIGHBORS);
+        if (neighbor_count > ASTAR_MAX_NEIGHBORS) neighbor_count = ASTAR_MAX_NEIGHBORS;
+    } else {
+        /* Cast neighbors to array of pointers */
+        neighbor_array = (void**)astar->get_neighbors(current->state, &neighbor_count);
+    }
+    RTKA_PERF_COUNT(RTKA_PERF_ASTAR_NEIGHBORS, neighbor_count);
     
-    /* Bubble down */
-    uint32_t idx = 0;
-    while (2 * idx + 1 < astar->open_count) {
-        uint32_t left = 2 * idx + 1;
-        uint32_t right = 2 * idx + 2;
-        uint32_t smallest = idx;
+    for (uint32_t i = 0; i < neighbor_count; i++) {
+        void* neighbor_state = neighbor_array ? neighbor_array[i] : neighbor_bytes + i * astar->state_size;
+        uint64_t hash = state_hash(astar, neighbor_state);
+        rtka_astar_node_t* neighbor_node = table_find(astar, d->self, neighbor_state, hash);
         
-        if (compare_nodes(astar->open_set[left], astar->open_set[smallest]) < 0) {
-            smallest = left;
-        }
-        if (right < astar->open_count && 
-            compare_nodes(astar->open_set[right], astar->open_set[smallest]) < 0) {
-            smallest = right;
+        /* Check if in closed set */
+        if (neighbor_node && neighbor_node->closed) {
+            release_state(astar, neighbor_state);
+            continue;
         }
         
-        if (smallest != idx) {
-            rtka_astar_node_t* temp = astar->open_set[idx];
-            astar->open_set[idx] = astar->open_set[smallest];
-            astar->open_set[smallest] = temp;
-            idx = smallest;
+        /* Calculate tentative g_score */
+        rtka_state_t cost = d->reverse ? astar->cost(neighbor_state, current->state)
+                                       : astar->cost(current->state, neighbor_state);
+        rtka_state_t tentative_g = combine(astar, current->g_score, cost);
+        
+        if (!neighbor_node) {
+            /* New node */
+            neighbor_node = add_node(astar, d->self, neighbor_state, hash, current, tentative_g, d->target);
+            if (!neighbor_node) {
+                for (uint32_t j = i; neighbor_array && j < neighbor_count; j++) astar->free_state(neighbor_array[j]);
+                return false;
+            }
+            neighbor_node->id = ++astar->nodes_expanded;
+            astar->rtka_transitions++;
+        } else if (tentative_g.confidence < neighbor_node->g_score.confidence) {
+            /* Found better path */
+            release_state(astar, neighbor_state); /* Free duplicate */
+            neighbor_node->parent = current;
+            neighbor_node->g_score = tentative_g;
+            neighbor_node->f_score = combine(astar, neighbor_node->g_score, neighbor_node->h_score);
+            queue_decrease(astar, d->self, neighbor_node);
+            astar->rtka_transitions++;
         } else {
-            break;
+            release_state(astar, neighbor_state); /* Free unused */
+            continue;
         }
+        try_meeting(astar, d, neighbor_node, best);
     }
     
-    return result;
+    /* Don't free static array - neighbors is managed by caller */
+    return true;
 }
 
-/* Find node in set */
-static rtka_astar_node_t* find_in_set(rtka_astar_node_t** set, uint32_t count, 
-                                      void* state, rtka_astar_t* astar) {
-    for (uint32_t i = 0; i < count; i++) {
-        if (astar->equals(set[i]->state, state)) {
-            return set[i];
-        }
-    }
-    return NULL;
+static bool expand(rtka_astar_t* astar, const direction_t* d, rtka_astar_node_t* current, meeting_t* best) {
+    RTKA_PERF_TIMER_BEGIN(expand_timer, RTKA_PERF_TIMER_ASTAR_EXPAND);
+    bool expanded = expand_neighbors(astar, d, current, best);
+    RTKA_PERF_TIMER_END(expand_timer);
+    RTKA_PERF_COUNT(RTKA_PERF_ASTAR_EXPANSIONS, 1);
+    return expanded;
 }
 
-/* A* search with ternary logic */
-rtka_astar_node_t* rtka_astar_search(rtka_astar_t* astar, void* start, void* goal) {
-    /* Initialize start node */
-    rtka_astar_node_t* start_node = malloc(sizeof(rtka_astar_node_t));
-    start_node->state = astar->clone_state(start);
-    start_node->parent = NULL;
-    start_node->g_score = rtka_make_state(RTKA_TRUE, 0.0f);
-    start_node->h_score = astar->heuristic(start, goal);
-    start_node->f_score = rtka_combine_or(start_node->g_score, start_node->h_score);
-    start_node->id = 0;
-    
-    rtka_astar_push(astar, start_node);
+static rtka_astar_node_t* search_forward(rtka_astar_t* astar, void* goal) {
+    direction_t d = {&astar->forward, NULL, goal, false};
+    meeting_t unused = {0};
     
-    while (astar->open_count > 0) {
-        rtka_astar_node_t* current = rtka_astar_pop(astar);
+    while (astar->forward.open_count > 0) {
+        rtka_astar_node_t* current = queue_pop(astar, &astar->forward);
         astar->nodes_expanded++;
         
         /* Goal test */
@@ -129,68 +439,99 @@ rtka_astar_node_t* rtka_astar_search(rtka_astar_t* astar, void* start, void* goa
         }
         
         /* Add to closed set */
-        astar->closed_set[astar->closed_count++] = current;
-        
-        /* Expand neighbors */
-        uint32_t neighbor_count = 0;
-        void* neighbors = astar->get_neighbors(current->state, &neighbor_count);
-        
-        /* Cast neighbors to array of pointers */
-        void** neighbor_array = (void**)neighbors;
+        current->closed = true;
+        astar->forward.closed_count++;
         
-        for (uint32_t i = 0; i < neighbor_count; i++) {
-            void* neighbor_state = neighbor_array[i];
-            
-            /* Check if in closed set */
-            rtka_astar_node_t* closed_node = find_in_set(astar->closed_set, 
-                                                        astar->closed_count,
-                                                        neighbor_state, astar);
-            if (closed_node) {
-                astar->free_state(neighbor_state);
-                continue;
-            }
-            
-            /* Calculate tentative g_score */
-            rtka_state_t cost = astar->cost(current->state, neighbor_state);
-            rtka_state_t tentative_g = rtka_combine_or(current->g_score, cost);
-            
-            /* Check if in open set */
-            rtka_astar_node_t* neighbor_node = find_in_set(astar->open_set,
-                                                          astar->open_count,
-                                                          neighbor_state, astar);
-            
-            if (!neighbor_node) {
-                /* New node */
-                neighbor_node = malloc(sizeof(rtka_astar_node_t));
-                neighbor_node->state = neighbor_state;
-                neighbor_node->parent = current;
-                neighbor_node->g_score = tentative_g;
-                neighbor_node->h_score = astar->heuristic(neighbor_state, goal);
-                neighbor_node->f_score = rtka_combine_or(neighbor_node->g_score,
-                                                        neighbor_node->h_score);
-                neighbor_node->id = ++astar->nodes_expanded;
-                
-                rtka_astar_push(astar, neighbor_node);
-                astar->rtka_transitions++;
-            } else if (tentative_g.confidence < neighbor_node->g_score.confidence) {
-                /* Found better path */
-                astar->free_state(neighbor_state); /* Free duplicate */
-                neighbor_node->parent = current;
-                neighbor_node->g_score = tentative_g;
-                neighbor_node->f_score = rtka_combine_or(neighbor_node->g_score,
-                                                         neighbor_node->h_score);
-                astar->rtka_transitions++;
-            } else {
-                astar->free_state(neighbor_state); /* Free unused */
-            }
-        }
-        
-        /* Don't free static array - neighbors is managed by caller */
+        if (!expand(astar, &d, current, &unused)) return NULL;
     }
     
     return NULL;  /* No path found */
 }
 
+/* Lowest f still open, +inf when the frontier is exhausted */
+static float frontier_bound(rtka_astar_t* astar, rtka_astar_frontier_t* f) {
+    rtka_astar_node_t* top = queue_top(astar, f);
+    return top ? top->f_score.confidence : INFINITY;
+}
+
+/* Backward half of the meeting appended to the forward chain: its states
+ * move onto new forward nodes so rtka_astar_get_path sees one chain */
+static rtka_astar_node_t* splice_path(rtka_astar_t* astar, const meeting_t* m) {
+    rtka_astar_node_t* tail = m->forward;
+    for (rtka_astar_node_t* b = m->backward->parent; b; b = b->parent) {
+        if (!table_reserve(&astar->forward)) return NULL;
+        rtka_astar_node_t* node = alloc_node(astar);
+        if (!node) return NULL;
+        node->state = b->state;
+        b->state = NULL;
+        node->parent = tail;
+        node->g_score = combine(astar, tail->g_score, astar->cost(tail->state, node->state));
+        node->h_score = rtka_make_state(RTKA_TRUE, 0.0f);
+        node->f_score = node->g_score;
+        node->hash = b->hash;
+        node->closed = true;
+        node->id = ++astar->nodes_expanded;
+        table_insert(&astar->forward, node);
+        tail = node;
+    }
+    return tail;
+}
+
+/* Alternates on the smaller open set. A frontier's lowest f bounds every
+ * path through its open nodes, so once either bound reaches the best
+ * meeting nothing shorter remains (heuristics consistent). */
+static rtka_astar_node_t* search_bidirectional(rtka_astar_t* astar, rtka_astar_node_t* start_node,
+                                               void* start, void* goal) {
+    void* goal_state = astar->state_size ? goal : astar->clone_state(goal);
+    rtka_astar_node_t* goal_node = add_node(astar, &astar->backward, goal_state, state_hash(astar, goal_state),
+                                            NULL, rtka_make_state(RTKA_TRUE, 0.0f), start);
+    if (!goal_node) {
+        release_state(astar, goal_state);
+        return NULL;
+    }
+    
+    direction_t fwd = {&astar->forward, &astar->backward, goal, false};
+    direction_t bwd = {&astar->backward, &astar->forward, start, true};
+    meeting_t best = {0};
+    try_meeting(astar, &fwd, start_node, &best);
+    
+    while (astar->forward.open_count > 0 && astar->backward.open_count > 0) {
+        float bound_f = frontier_bound(astar, &astar->forward);
+        float bound_b = frontier_bound(astar, &astar->backward);
+        if (best.forward && (bound_f >= best.cost || bound_b >= best.cost)) break;
+        
+        const direction_t* d = astar->forward.open_count <= astar->backward.open_count ? &fwd : &bwd;
+        rtka_astar_node_t* current = queue_pop(astar, d->self);
+        astar->nodes_expanded++;
+        current->closed = true;
+        d->self->closed_count++;
+        if (!expand(astar, d, current, &best)) return NULL;
+    }
+    
+    return best.forward ? splice_path(astar, &best) : NULL;
+}
+
+/* A* search with ternary logic */
+rtka_astar_node_t* rtka_astar_search(rtka_astar_t* astar, void* start, void* goal) {
+    if (astar->state_size && !astar->neighbor_buffer) {
+        astar->neighbor_buffer = malloc(ASTAR_MAX_NEIGHBORS * astar->state_size);
+        if (!astar->neighbor_buffer) return NULL;
+    }
+    
+    /* Initialize start node */
+    void* start_state = astar->state_size ? start : astar->clone_state(start);
+    rtka_astar_node_t* start_node = add_node(astar, &astar->forward, start_state, state_hash(astar, start_state),
+                                             NULL, rtka_make_state(RTKA_TRUE, 0.0f), goal);
+    if (!start_node) {
+        release_state(astar, start_state);
+        return NULL;
+    }
+    start_node->id = 0;
+    
+    if (astar->flags & ASTAR_BIDIRECTIONAL) return search_bidirectional(astar, start_node, start, goal);
+    return search_forward(astar, goal);
+}
+
 /* Reconstruct path */
 void** rtka_astar_get_path(rtka_astar_node_t* goal_node, uint32_t* path_length) {
     if (!goal_node) return NULL;
@@ -214,19 +555,27 @@ void** rtka_astar_get_path(rtka_astar_node_t* goal_node, uint32_t* path_length)
     return path;
 }
 
+static void frontier_free(rtka_astar_t* astar, rtka_astar_frontier_t* f) {
+    for (uint32_t i = 0; i < f->table_capacity; i++) {
+        rtka_astar_node_t* node = f->node_table[i];
+        if (node && node->state && !astar->state_size) astar->free_state(node->state);
+    }
+    free(f->node_table);
+    free(f->open_set);
+    free(f->buckets);
+}
+
 /* Free A* context */
 void rtka_astar_free(rtka_astar_t* astar) {
     if (!astar) return;
     
-    for (uint32_t i = 0; i < astar->open_count; i++) {
-        astar->free_state(astar->open_set[i]->state);
-        free(astar->open_set[i]);
-    }
-    
-    for (uint32_t i = 0; i < astar->closed_count; i++) {
-        astar->free_state(astar->closed_set[i]->state);
-        free(astar->closed_set[i]);
+    frontier_free(astar, &astar->forward);
+    frontier_free(astar, &astar->backward);
+    while (astar->blocks) {
+        rtka_astar_block_t* next = astar->blocks->next;
+        free(astar->blocks);
+        astar->blocks = next;
     }
-    
+    free(astar->neighbor_buffer);
     free(astar);
 }
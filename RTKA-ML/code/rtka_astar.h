@@ -7,6 +7,27 @@
  * distributed, or used without explicit written permission.
  *
  * RTKA A* Search Algorithm
+ *
+ * CHANGELOG:
+ * v1.1.0 - Growable indexed heap with decrease-key, open-addressing node
+ *          table keyed by the optional hash callback (replacing the linear
+ *          find_in_set), nodes carved from pooled blocks. Every node the
+ *          search creates, the returned goal included, is owned by the
+ *          context and released by rtka_astar_free.
+ * v1.2.0 - Search modes on rtka_astar_t.flags, same callbacks:
+ *          ASTAR_INTEGER_COSTS  cost / heuristic confidences are small
+ *                               non-negative integers that add up; the open
+ *                               set becomes a bucket queue (Dial's) on f
+ *          ASTAR_BIDIRECTIONAL  searches from start and from goal and stops
+ *                               when neither frontier can beat the best
+ *                               meeting; neighbors and costs must be
+ *                               symmetric and is_goal is not consulted
+ * v1.3.0 - Inline states: with state_size set, states are fixed-size byte
+ *          copies kept in the node pool and neighbors come from
+ *          get_neighbors_into, written into a buffer the search owns, so
+ *          an expansion allocates nothing and clone_state / free_state go
+ *          unused. equals and hash default to memcmp and FNV-1a over the
+ *          bytes (padding must then be zeroed).
  */
 
 #ifndef RTKA_ASTAR_H
@@ -15,8 +36,12 @@
 #include "rtka_u_core.h"
 #include "rtka_types.h"
 
-#define ASTAR_MAX_NODES 10000
 #define ASTAR_MAX_NEIGHBORS 12
+#define ASTAR_NOT_OPEN      UINT32_MAX   /* heap_index of a node outside the open set */
+
+/* rtka_astar_t.flags */
+#define ASTAR_INTEGER_COSTS 0x1U
+#define ASTAR_BIDIRECTIONAL 0x2U
 
 typedef struct rtka_astar_node {
     void* state;
@@ -25,8 +50,30 @@ typedef struct rtka_astar_node {
     rtka_state_t h_score;  /* Heuristic - ternary */
     rtka_state_t f_score;  /* Total - ternary */
     uint32_t id;
+    uint32_t heap_index;   /* Position in open_set (bucket with ASTAR_INTEGER_COSTS),
+                              ASTAR_NOT_OPEN once popped */
+    uint64_t hash;
+    bool closed;
+    struct rtka_astar_node* bucket_next;
+    struct rtka_astar_node* bucket_prev;
 } rtka_astar_node_t;
 
+typedef struct rtka_astar_block rtka_astar_block_t;
+
+/* Open and closed sets of one search direction */
+typedef struct {
+    rtka_astar_node_t** open_set;       /* Min-heap on f_score */
+    uint32_t open_count;
+    uint32_t open_capacity;
+    rtka_astar_node_t** buckets;        /* ASTAR_INTEGER_COSTS: list heads by f */
+    uint32_t bucket_capacity;
+    uint32_t bucket_min;                /* No open node below this bucket */
+    uint32_t closed_count;
+    rtka_astar_node_t** node_table;     /* Every node, open or closed, by hash */
+    uint32_t table_capacity;            /* Power of two */
+    uint32_t node_count;
+} rtka_astar_frontier_t;
+
 typedef struct {
     /* Problem-specific functions */
     bool (*is_goal)(void* state);
@@ -36,12 +83,20 @@ typedef struct {
     bool (*equals)(void* a, void* b);
     void* (*clone_state)(void* state);
     void (*free_state)(void* state);
+    /* Optional: equal states must hash alike. Without it every state lands
+     * in one bucket and lookups fall back to scanning with equals. */
+    uint64_t (*hash)(void* state);
+    uint32_t flags;                     /* ASTAR_* modes, set before searching */
+    /* Inline states: state_size bytes each; get_neighbors_into writes up to
+     * max_neighbors of them back to back and returns how many */
+    size_t state_size;
+    uint32_t (*get_neighbors_into)(void* state, void* neighbors, uint32_t max_neighbors);
     
     /* Search state */
-    rtka_astar_node_t* open_set[ASTAR_MAX_NODES];
-    rtka_astar_node_t* closed_set[ASTAR_MAX_NODES];
-    uint32_t open_count;
-    uint32_t closed_count;
+    rtka_astar_frontier_t forward;
+    rtka_astar_frontier_t backward;     /* ASTAR_BIDIRECTIONAL only */
+    rtka_astar_block_t* blocks;         /* Node pool, inline states alongside */
+    void* neighbor_buffer;              /* ASTAR_MAX_NEIGHBORS inline states */
     
     /* Statistics */
     uint32_t nodes_expanded;
@@ -56,8 +111,11 @@ void rtka_astar_free(rtka_astar_t* astar);
 /* Path reconstruction */
 void** rtka_astar_get_path(rtka_astar_node_t* goal_node, uint32_t* path_length);
 
-/* Priority queue operations with ternary ordering */
-void rtka_astar_push(rtka_astar_t* astar, rtka_astar_node_t* node);
+/* Priority queue of the forward frontier, heap or buckets per flags. push
+ * returns false when it cannot grow; decrease re-sorts a node whose
+ * f_score dropped while open. */
+bool rtka_astar_push(rtka_astar_t* astar, rtka_astar_node_t* node);
 rtka_astar_node_t* rtka_astar_pop(rtka_astar_t* astar);
+void rtka_astar_decrease(rtka_astar_t* astar, rtka_astar_node_t* node);
 
 #endif
@@ -0,0 +1,165 @@
+/**
+ * File: rtka_bench.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Benchmark Suite Driver (make bench)
+ *
+ * Runs every library group plus Pearson correlation matrices, pairwise and
+ * blocked, from the correlation module, then writes CSV/JSON and compares against a saved
+ * baseline. Exits 1 on regressions.
+ *
+ *   rtka_bench [--quick] [--filter S] [--csv PATH] [--json PATH]
+ *              [--baseline PATH] [--tolerance X]
+ */
+
+#include "rtka_benchmark.h"
+#include "rtka_memory.h"
+#include "rtka_random.h"
+#include "correlation/rtka_correlation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PDB_PATH  "build/rubik_ida.pdb"
+
+typedef struct {
+    const double* const* rows;
+    size_t variables;
+    size_t samples;
+    rtka_corr_matrix_t* matrix;
+    const rtka_corr_matrix_options_t* blocked;  /* NULL: pairwise */
+    bool failed;
+} corr_data_t;
+
+static void corr_matrix(void* data) {
+    corr_data_t* d = (corr_data_t*)data;
+    rtka_corr_error_t err = d->blocked ?
+        rtka_corr_matrix_compute_blocked(d->rows, d->variables, d->samples, d->blocked, d->matrix) :
+        rtka_corr_matrix_compute(d->rows, d->variables, d->samples, d->matrix);
+    if (err != RTKA_CORR_SUCCESS) d->failed = true;
+}
+
+/* Correlated columns: each variable mixes a shared factor with noise.
+ * Pairwise stops at 128 variables, where one call is already ~0.1 s. */
+static void benchmark_correlation(rtka_benchmark_suite_t* suite) {
+    const size_t shapes[][2] = { { 32, 1000 }, { 128, 4096 }, { 512, 16384 } };
+    const rtka_corr_matrix_options_t f64 = { RTKA_CORR_ACCUM_DOUBLE, 0 }, f32 = { RTKA_CORR_ACCUM_FLOAT, 0 };
+    const rtka_corr_matrix_options_t* modes[] = { NULL, &f64, &f32 };
+    const char* mode_names[] = { "pairwise", "blocked f64", "blocked f32" };
+    printf("\ncorrelation\n");
+    for (uint32_t s = 0; s < 3; s++) {
+        size_t variables = shapes[s][0], samples = shapes[s][1];
+        char names[3][RTKA_BENCHMARK_NAME_MAX];
+        bool wanted = false;
+        for (uint32_t m = 0; m < 3; m++) {
+            snprintf(names[m], sizeof(names[m]), "corr/%s %zux%zu", mode_names[m], variables, samples);
+            wanted = wanted || ((m > 0 || s < 2) && rtka_benchmark_suite_wants(suite, names[m]));
+        }
+        if (!wanted || (suite->quick && s > 1)) continue;
+
+        double* values = (double*)malloc(variables * samples * sizeof(double));
+        const double** rows = (const double**)malloc(variables * sizeof(double*));
+        corr_data_t d = { NULL, variables, samples, rtka_corr_matrix_create(variables, samples), NULL, false };
+        if (values && rows && d.matrix) {
+            rtka_rng_t rng;
+            rtka_random_init_splitmix(&rng, 0x636f7272ULL + s);
+            for (size_t t = 0; t < samples; t++) {
+                double factor = rtka_random_uniform(&rng);
+                for (size_t v = 0; v < variables; v++) {
+                    values[v * samples + t] = factor * (double)(v % 4U) + rtka_random_uniform(&rng);
+                }
+            }
+            for (size_t v = 0; v < variables; v++) rows[v] = values + v * samples;
+            d.rows = rows;
+            /* Multiply-adds over the distinct pairs */
+            uint64_t pairs = (uint64_t)variables * (variables - 1U) / 2U;
+            for (uint32_t m = 0; m < 3; m++) {
+                if (m == 0 && s > 1) continue;
+                d.blocked = modes[m];
+                rtka_benchmark_suite_add(suite, names[m], corr_matrix, &d, pairs * samples,
+                                         variables * samples * sizeof(double));
+            }
+            if (d.failed) printf("  (a correlation matrix failed)\n");
+        }
+        rtka_corr_matrix_free(d.matrix);
+        free(rows);
+        free(values);
+    }
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--quick] [--filter S] [--csv PATH] [--json PATH] "
+                    "[--baseline PATH] [--tolerance X]\n", program);
+}
+
+static bool write_file(const char* path, const rtka_benchmark_suite_t* suite, bool json) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return false;
+    }
+    if (json) rtka_benchmark_write_json(out, suite->results, suite->count);
+    else rtka_benchmark_write_csv(out, suite->results, suite->count);
+    fclose(out);
+    printf("wrote %s\n", path);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = NULL;
+    const char* csv = NULL;
+    const char* json = NULL;
+    const char* baseline = NULL;
+    double tolerance = 0.10;
+    bool quick = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (strcmp(argv[i], "--filter") == 0 && has_value) filter = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0 && has_value) csv = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && has_value) json = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && has_value) baseline = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && has_value) tolerance = atof(argv[++i]);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    printf("=== RTKA Benchmark Suite%s ===\n", quick ? " (quick)" : "");
+    if (rtka_memory_init() != RTKA_SUCCESS) {
+        fprintf(stderr, "memory init failed\n");
+        return 1;
+    }
+    rtka_benchmark_suite_t suite;
+    rtka_benchmark_suite_init(&suite, filter, quick);
+    suite.pdb_path = PDB_PATH;
+    rtka_benchmark_all(&suite);
+    benchmark_correlation(&suite);
+    printf("\n%u benchmarks\n", suite.count);
+
+    bool ok = true;
+    if (csv) ok &= write_file(csv, &suite, false);
+    if (json) ok &= write_file(json, &suite, true);
+    if (baseline) {
+        uint32_t regressions = 0;
+        printf("\nagainst %s (tolerance %.0f%%)\n", baseline, tolerance * 100.0);
+        if (rtka_benchmark_compare(baseline, suite.results, suite.count, tolerance, stdout, &regressions) !=
+            RTKA_SUCCESS) {
+            fprintf(stderr, "cannot read baseline %s\n", baseline);
+            ok = false;
+        } else {
+            printf("%u regression%s\n", regressions, regressions == 1 ? "" : "s");
+            ok &= regressions == 0;
+        }
+    }
+    rtka_benchmark_suite_free(&suite);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,302 @@
+/**
+ * File: rtka_benchmark.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * RTKA Performance Benchmarking Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "rtka_benchmark.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define DEFAULT_WARMUP_TIME   0.05
+#define DEFAULT_SAMPLE_TIME   0.01
+#define DEFAULT_SAMPLES       21U
+#define TUKEY_FENCE           1.5
+#define LINE_MAX_BYTES        512U
+
+double rtka_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+uint64_t rtka_get_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return 0;
+#endif
+}
+
+static double run_batch(rtka_benchmark_fn fn, void* data, uint64_t n) {
+    double t0 = rtka_get_time();
+    for (uint64_t i = 0; i < n; i++) {
+        fn(data);
+        RTKA_CLOBBER_MEMORY();
+    }
+    return rtka_get_time() - t0;
+}
+
+/* Operations per sample so one sample takes about sample_time */
+static uint64_t calibrate(rtka_benchmark_fn fn, void* data, double sample_time) {
+    uint64_t n = 1;
+    for (;;) {
+        double elapsed = run_batch(fn, data, n);
+        if (elapsed >= sample_time || n > UINT64_MAX / 16U) return n;
+        double scale = elapsed > 0.0 ? 1.1 * sample_time / elapsed : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        if (scale < 1.5) scale = 1.5;
+        n = (uint64_t)((double)n * scale) + 1U;
+    }
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Linear interpolation between order statistics */
+static double quantile(const double* sorted, uint32_t count, double p) {
+    double position = p * (double)(count - 1U);
+    uint32_t below = (uint32_t)position;
+    if (below + 1U >= count) return sorted[count - 1U];
+    double fraction = position - (double)below;
+    return sorted[below] + fraction * (sorted[below + 1U] - sorted[below]);
+}
+
+rtka_benchmark_result_t rtka_benchmark_measure(const char* name,
+                                              rtka_benchmark_fn fn,
+                                              void* data,
+                                              const rtka_benchmark_config_t* config) {
+    rtka_benchmark_result_t result = { .name = name };
+    if (!fn) return result;
+
+    rtka_benchmark_config_t cfg = config ? *config : (rtka_benchmark_config_t){ 0 };
+    if (cfg.warmup_time <= 0.0) cfg.warmup_time = DEFAULT_WARMUP_TIME;
+    if (cfg.sample_time <= 0.0) cfg.sample_time = DEFAULT_SAMPLE_TIME;
+    if (cfg.samples == 0) cfg.samples = DEFAULT_SAMPLES;
+
+    double* times = (double*)malloc(cfg.samples * sizeof(double));
+    if (!times) return result;
+
+    /* Warm caches, branch predictors and clocks */
+    double warm_start = rtka_get_time();
+    for (uint64_t batch = 1; rtka_get_time() - warm_start < cfg.warmup_time; batch *= 2U) {
+        run_batch(fn, data, batch);
+    }
+    uint64_t n = cfg.iterations ? cfg.iterations : calibrate(fn, data, cfg.sample_time);
+
+    uint64_t ticks = 0;
+    for (uint32_t s = 0; s < cfg.samples; s++) {
+        uint64_t tick_start = rtka_get_ticks();
+        double elapsed = run_batch(fn, data, n);
+        ticks += rtka_get_ticks() - tick_start;
+        times[s] = elapsed / (double)n;
+        result.total_time += elapsed;
+    }
+
+    qsort(times, cfg.samples, sizeof(double), compare_double);
+    result.samples = cfg.samples;
+    result.iterations_per_sample = n;
+    result.iterations = n * cfg.samples;
+    result.min_time = times[0];
+    result.max_time = times[cfg.samples - 1U];
+    result.median_time = quantile(times, cfg.samples, 0.5);
+    result.p10_time = quantile(times, cfg.samples, 0.1);
+    result.p90_time = quantile(times, cfg.samples, 0.9);
+
+    /* Mean and deviation inside the Tukey fences */
+    double q1 = quantile(times, cfg.samples, 0.25), q3 = quantile(times, cfg.samples, 0.75);
+    double low = q1 - TUKEY_FENCE * (q3 - q1), high = q3 + TUKEY_FENCE * (q3 - q1);
+    double sum = 0.0, sum_sq = 0.0;
+    uint32_t kept = 0;
+    for (uint32_t s = 0; s < cfg.samples; s++) {
+        if (times[s] < low || times[s] > high) continue;
+        sum += times[s];
+        sum_sq += times[s] * times[s];
+        kept++;
+    }
+    result.outliers = cfg.samples - kept;
+    result.avg_time = sum / kept;
+    double variance = kept > 1U ? (sum_sq - sum * sum / kept) / (kept - 1U) : 0.0;
+    result.stddev_time = variance > 0.0 ? sqrt(variance) : 0.0;
+
+    result.ticks_per_op = (double)ticks / (double)result.iterations;
+    if (result.median_time > 0.0) {
+        result.ops_per_sec = (uint64_t)(1.0 / result.median_time);
+        result.elements_per_sec = (double)cfg.elements_per_op / result.median_time;
+        result.bytes_per_sec = (double)cfg.bytes_per_op / result.median_time;
+    }
+    free(times);
+    return result;
+}
+
+rtka_benchmark_result_t rtka_benchmark_run(const char* name,
+                                          rtka_benchmark_fn fn,
+                                          void* data,
+                                          uint64_t iterations) {
+    rtka_benchmark_config_t config = { 0 };
+    if (iterations) {
+        config.samples = iterations < DEFAULT_SAMPLES ? (uint32_t)iterations : DEFAULT_SAMPLES;
+        config.iterations = iterations / config.samples;
+    }
+    return rtka_benchmark_measure(name, fn, data, &config);
+}
+
+void rtka_benchmark_print_results(rtka_benchmark_result_t* result) {
+    if (!result) return;
+    printf("  %-28s %10.2f ns/op  [p10 %.2f, p90 %.2f]  mean %.2f +- %.2f",
+           result->name ? result->name : "", result->median_time * 1e9, result->p10_time * 1e9,
+           result->p90_time * 1e9, result->avg_time * 1e9, result->stddev_time * 1e9);
+    if (result->outliers) printf("  (%u outliers)", result->outliers);
+    if (result->ticks_per_op > 0.0) printf("  %.1f ticks", result->ticks_per_op);
+    if (result->elements_per_sec > 0.0) printf("  %.3g elem/s", result->elements_per_sec);
+    if (result->bytes_per_sec > 0.0) printf("  %.2f GB/s", result->bytes_per_sec * 1e-9);
+    printf("\n");
+}
+
+/* Names quoted, quotes doubled */
+static void write_csv_name(FILE* out, const char* name) {
+    fputc('"', out);
+    for (const char* c = name ? name : ""; *c; c++) {
+        if (*c == '"') fputc('"', out);
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+void rtka_benchmark_write_csv(FILE* out, const rtka_benchmark_result_t* results, uint32_t count) {
+    if (!out || (!results && count)) return;
+    fprintf(out, "name,samples,iterations_per_sample,median_ns,p10_ns,p90_ns,mean_ns,stddev_ns,"
+                 "min_ns,max_ns,outliers,ticks_per_op,elements_per_sec,bytes_per_sec\n");
+    for (uint32_t i = 0; i < count; i++) {
+        const rtka_benchmark_result_t* r = &results[i];
+        write_csv_name(out, r->name);
+        fprintf(out, ",%u,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%u,%.2f,%.6g,%.6g\n", r->samples,
+                (unsigned long long)r->iterations_per_sample, r->median_time * 1e9, r->p10_time * 1e9,
+                r->p90_time * 1e9, r->avg_time * 1e9, r->stddev_time * 1e9, r->min_time * 1e9,
+                r->max_time * 1e9, r->outliers, r->ticks_per_op, r->elements_per_sec, r->bytes_per_sec);
+    }
+}
+
+void rtka_benchmark_write_json(FILE* out, const rtka_benchmark_result_t* results, uint32_t count) {
+    if (!out || (!results && count)) return;
+    fprintf(out, "[\n");
+    for (uint32_t i = 0; i < count; i++) {
+        const rtka_benchmark_result_t* r = &results[i];
+        fprintf(out, "  {\"name\": \"");
+        for (const char* c = r->name ? r->name : ""; *c; c++) {
+            if (*c == '"' || *c == '\\') fputc('\\', out);
+            fputc(*c, out);
+        }
+        fprintf(out, "\", \"samples\": %u, \"iterations_per_sample\": %llu, \"median_ns\": %.4f, "
+                     "\"p10_ns\": %.4f, \"p90_ns\": %.4f, \"mean_ns\": %.4f, \"stddev_ns\": %.4f, "
+                     "\"min_ns\": %.4f, \"max_ns\": %.4f, \"outliers\": %u, \"ticks_per_op\": %.2f, "
+                     "\"elements_per_sec\": %.6g, \"bytes_per_sec\": %.6g}%s\n",
+                r->samples, (unsigned long long)r->iterations_per_sample, r->median_time * 1e9,
+                r->p10_time * 1e9, r->p90_time * 1e9, r->avg_time * 1e9, r->stddev_time * 1e9,
+                r->min_time * 1e9, r->max_time * 1e9, r->outliers, r->ticks_per_op, r->elements_per_sec,
+                r->bytes_per_sec, i + 1U < count ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+typedef struct {
+    char name[RTKA_BENCHMARK_NAME_MAX];
+    double median_ns;
+} baseline_entry_t;
+
+/* Name and median of one CSV row; false for the header or a bad row */
+static bool parse_row(const char* line, baseline_entry_t* entry) {
+    const char* c = line;
+    uint32_t length = 0;
+    if (*c != '"') return false;
+    for (c++; *c; c++) {
+        if (*c == '"') {
+            if (c[1] != '"') break;
+            c++;
+        }
+        if (length + 1U < RTKA_BENCHMARK_NAME_MAX) entry->name[length++] = *c;
+    }
+    entry->name[length] = '\0';
+    if (*c != '"') return false;
+
+    /* median_ns is the third field after the name */
+    for (uint32_t field = 0; field < 3U; field++) {
+        c = strchr(c + 1, ',');
+        if (!c) return false;
+    }
+    char* end = NULL;
+    entry->median_ns = strtod(c + 1, &end);
+    return end != c + 1;
+}
+
+rtka_error_t rtka_benchmark_compare(const char* baseline_path,
+                                    const rtka_benchmark_result_t* results,
+                                    uint32_t count,
+                                    double tolerance,
+                                    FILE* report,
+                                    uint32_t* regressions) {
+    if (!baseline_path || !regressions || (!results && count)) return RTKA_ERROR_NULL_POINTER;
+    *regressions = 0;
+    FILE* in = fopen(baseline_path, "r");
+    if (!in) return RTKA_ERROR_INVALID_VALUE;
+
+    baseline_entry_t* entries = NULL;
+    uint32_t entry_count = 0, capacity = 0;
+    char line[LINE_MAX_BYTES];
+    while (fgets(line, sizeof(line), in)) {
+        baseline_entry_t entry;
+        if (!parse_row(line, &entry)) continue;
+        if (entry_count == capacity) {
+            uint32_t grown = capacity ? capacity * 2U : 16U;
+            baseline_entry_t* resized = (baseline_entry_t*)realloc(entries, grown * sizeof(baseline_entry_t));
+            if (!resized) {
+                free(entries);
+                fclose(in);
+                return RTKA_ERROR_OUT_OF_MEMORY;
+            }
+            entries = resized;
+            capacity = grown;
+        }
+        entries[entry_count++] = entry;
+    }
+    fclose(in);
+
+    for (uint32_t i = 0; i < count; i++) {
+        const char* name = results[i].name ? results[i].name : "";
+        double median_ns = results[i].median_time * 1e9;
+        const baseline_entry_t* base = NULL;
+        for (uint32_t e = 0; e < entry_count && !base; e++) {
+            if (strncmp(entries[e].name, name, RTKA_BENCHMARK_NAME_MAX - 1U) == 0) base = &entries[e];
+        }
+        if (!base || base->median_ns <= 0.0) {
+            if (report) fprintf(report, "  %-28s %10.2f ns/op  (no baseline)\n", name, median_ns);
+            continue;
+        }
+        double change = median_ns / base->median_ns - 1.0;
+        bool regressed = change > tolerance;
+        *regressions += regressed;
+        if (report) {
+            fprintf(report, "  %-28s %10.2f ns/op vs %.2f  %+.1f%%%s\n", name, median_ns, base->median_ns,
+                    change * 100.0, regressed ? "  REGRESSION" : "");
+        }
+    }
+    free(entries);
+    return RTKA_SUCCESS;
+}
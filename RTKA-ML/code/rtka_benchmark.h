@@ -1,46 +1,144 @@
 /**
  * File: rtka_benchmark.h
  * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
- * 
+ *
  * PROPRIETARY AND CONFIDENTIAL
  * This file is proprietary to H. Overman and may not be reproduced,
  * distributed, or used without explicit written permission.
  *
  * RTKA Performance Benchmarking
+ *
+ * CHANGELOG:
+ * v1.1.0 - Measurement harness: warmup, iteration counts calibrated to a
+ *          target sample time, median and percentiles over samples with
+ *          Tukey outliers set aside for the mean, timestamp-counter ticks,
+ *          elements/s and bytes/s. Results write as CSV or JSON, and a
+ *          saved CSV serves as the baseline that flags regressions.
+ *          rtka_benchmark_run keeps its signature on top of the harness.
+ * v1.2.0 - Benchmark suite: named groups over the core ops (scalar, batch,
+ *          SIMD), vectors from L1 to DRAM sizes, matmul shapes, LSTM and
+ *          MDN-RNN training passes, the solvers on fixed instances and
+ *          PageRank, collected for output and baseline comparison
+ *          (make bench).
  */
 
 #ifndef RTKA_BENCHMARK_H
 #define RTKA_BENCHMARK_H
 
 #include "rtka_types.h"
+#include <stdio.h>
 #include <time.h>
 
+/* Keep a value, or everything in memory, from being optimized away. */
+#ifdef __GNUC__
+#define RTKA_DO_NOT_OPTIMIZE(x) __asm__ volatile("" : : "r,m"(x) : "memory")
+#define RTKA_CLOBBER_MEMORY()   __asm__ volatile("" : : : "memory")
+#else
+#define RTKA_DO_NOT_OPTIMIZE(x) do { volatile __typeof__(x) rtka_sink_ = (x); (void)rtka_sink_; } while (0)
+#define RTKA_CLOBBER_MEMORY()   do { } while (0)
+#endif
+
+#define RTKA_BENCHMARK_NAME_MAX  64U
+
+/* Times are seconds per operation */
 typedef struct {
     const char* name;
-    uint64_t iterations;
-    double total_time;
+    uint64_t iterations;            /* Operations measured, over all samples */
+    double total_time;              /* Seconds measured */
     double min_time;
     double max_time;
-    double avg_time;
-    uint64_t ops_per_sec;
+    double avg_time;                /* Mean of the samples inside the fences */
+    uint64_t ops_per_sec;           /* From the median */
+
+    uint64_t iterations_per_sample;
+    uint32_t samples;
+    uint32_t outliers;              /* Samples outside 1.5 IQR of the quartiles */
+    double median_time;
+    double p10_time;
+    double p90_time;
+    double stddev_time;
+    double ticks_per_op;            /* Timestamp counter, 0 where there is none */
+    double elements_per_sec;        /* With elements_per_op set */
+    double bytes_per_sec;           /* With bytes_per_op set */
 } rtka_benchmark_result_t;
 
 typedef void (*rtka_benchmark_fn)(void* data);
 
-/* Run benchmark */
-rtka_benchmark_result_t rtka_benchmark_run(const char* name, 
+/* Measurement settings; zero fields take the defaults */
+typedef struct {
+    double warmup_time;             /* Seconds run before measuring (0.05) */
+    double sample_time;             /* Target seconds per sample (0.01) */
+    uint32_t samples;               /* 21 */
+    uint64_t iterations;            /* Operations per sample; 0 calibrates to sample_time */
+    uint64_t elements_per_op;
+    uint64_t bytes_per_op;
+} rtka_benchmark_config_t;
+
+/* Measure fn, one operation per call */
+rtka_benchmark_result_t rtka_benchmark_measure(const char* name,
+                                              rtka_benchmark_fn fn,
+                                              void* data,
+                                              const rtka_benchmark_config_t* config);
+
+/* Run benchmark: iterations operations, rounded down to whole samples of
+ * the default count, after warmup; 0 calibrates */
+rtka_benchmark_result_t rtka_benchmark_run(const char* name,
                                           rtka_benchmark_fn fn,
                                           void* data,
                                           uint64_t iterations);
 
-/* Core operation benchmarks */
-void rtka_benchmark_core_ops(void);
-void rtka_benchmark_tensor_ops(void);
-void rtka_benchmark_solver(void);
-void rtka_benchmark_all(void);
+/* Benchmark suite: measurements by name, "group/what size" */
+typedef struct {
+    rtka_benchmark_result_t* results;   /* Names owned by the suite */
+    uint32_t count;
+    uint32_t capacity;
+    const char* filter;                 /* Substring of the names to run, NULL runs all */
+    const char* pdb_path;               /* Rubik pattern database cache, NULL rebuilds */
+    bool quick;                         /* Shorter samples, smaller instances */
+    rtka_benchmark_config_t config;     /* Settings of every measurement */
+} rtka_benchmark_suite_t;
+
+void rtka_benchmark_suite_init(rtka_benchmark_suite_t* suite, const char* filter, bool quick);
+void rtka_benchmark_suite_free(rtka_benchmark_suite_t* suite);
+
+/* Groups test this before building instances */
+bool rtka_benchmark_suite_wants(const rtka_benchmark_suite_t* suite, const char* name);
+
+/* Measure, print and keep one benchmark; false when filtered out or out of
+ * memory. elements_per_op and bytes_per_op may be 0. */
+bool rtka_benchmark_suite_add(rtka_benchmark_suite_t* suite, const char* name,
+                              rtka_benchmark_fn fn, void* data,
+                              uint64_t elements_per_op, uint64_t bytes_per_op);
+
+/* Benchmark groups */
+void rtka_benchmark_core_ops(rtka_benchmark_suite_t* suite);
+void rtka_benchmark_vector_ops(rtka_benchmark_suite_t* suite);
+void rtka_benchmark_tensor_ops(rtka_benchmark_suite_t* suite);
+void rtka_benchmark_sequence_models(rtka_benchmark_suite_t* suite);
+void rtka_benchmark_solver(rtka_benchmark_suite_t* suite);
+void rtka_benchmark_graph(rtka_benchmark_suite_t* suite);
+void rtka_benchmark_all(rtka_benchmark_suite_t* suite);
 
 /* Timing utilities */
 double rtka_get_time(void);
+uint64_t rtka_get_ticks(void);
 void rtka_benchmark_print_results(rtka_benchmark_result_t* result);
 
+/* Output: a header line and one row per result, or a JSON array. Times
+ * are written in nanoseconds per operation. */
+void rtka_benchmark_write_csv(FILE* out, const rtka_benchmark_result_t* results, uint32_t count);
+void rtka_benchmark_write_json(FILE* out, const rtka_benchmark_result_t* results, uint32_t count);
+
+/* Compare medians against a CSV written by rtka_benchmark_write_csv.
+ * A result slower than its baseline by more than tolerance (0.1 = 10%)
+ * is a regression; results missing from the baseline are reported and
+ * not counted. Prints one line per result when report is set; an
+ * unreadable baseline is RTKA_ERROR_INVALID_VALUE. */
+RTKA_NODISCARD rtka_error_t rtka_benchmark_compare(const char* baseline_path,
+                                                   const rtka_benchmark_result_t* results,
+                                                   uint32_t count,
+                                                   double tolerance,
+                                                   FILE* report,
+                                                   uint32_t* regressions);
+
 #endif /* RTKA_BENCHMARK_H */
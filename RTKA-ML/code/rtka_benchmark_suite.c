@@ -0,0 +1,703 @@
+/**
+ * File: rtka_benchmark_suite.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * RTKA Benchmark Suite
+ *
+ * Every group builds its instances from fixed seeds, so one name measures
+ * the same work on every run and machine. Sizes suffixed K and M are 1024
+ * and 1024^2 elements.
+ */
+
+#include "rtka_benchmark.h"
+#include "rtka_u_core.h"
+#include "rtka_vector.h"
+#include "rtka_tensor.h"
+#include "rtka_random.h"
+#include "rtka_lstm.h"
+#include "rtka_mdnrnn.h"
+#include "rtka_sat.h"
+#include "rtka_sudoku_729.h"
+#include "rtka_sudoku_nxn.h"
+#include "rtka_nqueens.h"
+#include "rtka_rubik_ida.h"
+#include "rtka_astar.h"
+#include "rtka_graph.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SUITE_SEED  0x62656e6368ULL
+
+/* ============================================================================
+ * SUITE
+ * ============================================================================ */
+
+void rtka_benchmark_suite_init(rtka_benchmark_suite_t* suite, const char* filter, bool quick) {
+    if (!suite) return;
+    memset(suite, 0, sizeof(*suite));
+    suite->filter = filter;
+    suite->quick = quick;
+    if (quick) {
+        suite->config.warmup_time = 0.01;
+        suite->config.sample_time = 0.002;
+        suite->config.samples = 7;
+    }
+}
+
+void rtka_benchmark_suite_free(rtka_benchmark_suite_t* suite) {
+    if (!suite) return;
+    for (uint32_t i = 0; i < suite->count; i++) free((char*)suite->results[i].name);
+    free(suite->results);
+    suite->results = NULL;
+    suite->count = suite->capacity = 0;
+}
+
+bool rtka_benchmark_suite_wants(const rtka_benchmark_suite_t* suite, const char* name) {
+    return suite && name && (!suite->filter || strstr(name, suite->filter));
+}
+
+/* Group-level filter: any benchmark of the group may match */
+static bool wants_group(const rtka_benchmark_suite_t* suite, const char* group) {
+    return suite && (!suite->filter || strstr(suite->filter, group) == suite->filter ||
+                     strchr(suite->filter, '/') == NULL);
+}
+
+bool rtka_benchmark_suite_add(rtka_benchmark_suite_t* suite, const char* name,
+                              rtka_benchmark_fn fn, void* data,
+                              uint64_t elements_per_op, uint64_t bytes_per_op) {
+    if (!rtka_benchmark_suite_wants(suite, name) || !fn) return false;
+    if (suite->count == suite->capacity) {
+        uint32_t grown = suite->capacity ? suite->capacity * 2U : 32U;
+        rtka_benchmark_result_t* results =
+            (rtka_benchmark_result_t*)realloc(suite->results, grown * sizeof(rtka_benchmark_result_t));
+        if (!results) return false;
+        suite->results = results;
+        suite->capacity = grown;
+    }
+    size_t length = strlen(name) + 1U;
+    char* owned = (char*)malloc(length);
+    if (!owned) return false;
+    memcpy(owned, name, length);
+
+    rtka_benchmark_config_t config = suite->config;
+    config.elements_per_op = elements_per_op;
+    config.bytes_per_op = bytes_per_op;
+    rtka_benchmark_result_t result = rtka_benchmark_measure(owned, fn, data, &config);
+    rtka_benchmark_print_results(&result);
+    fflush(stdout);
+    suite->results[suite->count++] = result;
+    return true;
+}
+
+static void* aligned_buffer(size_t bytes) {
+    size_t rounded = (bytes + 63U) & ~(size_t)63U;
+    return aligned_alloc(64, rounded ? rounded : 64U);
+}
+
+static void random_states(rtka_state_t* out, size_t count, uint64_t seed) {
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, seed);
+    rtka_random_fill_state(&rng, out, count);
+}
+
+/* ============================================================================
+ * CORE OPS: one AND per element through the inline API, the batch call and
+ * the SIMD vector planes
+ * ============================================================================ */
+
+typedef struct {
+    rtka_state_t* a;
+    rtka_state_t* b;
+    rtka_state_t* r;
+    rtka_vector_t va, vb, vr;
+    uint32_t n;
+} core_data_t;
+
+static void core_scalar(void* data) {
+    core_data_t* d = (core_data_t*)data;
+    for (uint32_t i = 0; i < d->n; i++) {
+        d->r[i] = rtka_combine_and(d->a[i], d->b[i]);
+        RTKA_CLOBBER_MEMORY();
+    }
+}
+
+static void core_batch(void* data) {
+    core_data_t* d = (core_data_t*)data;
+    rtka_and_batch(d->a, d->b, d->r, d->n);
+}
+
+static void core_simd(void* data) {
+    core_data_t* d = (core_data_t*)data;
+    rtka_vector_and(&d->va, &d->vb, &d->vr);
+}
+
+static void core_sequence(void* data) {
+    core_data_t* d = (core_data_t*)data;
+    rtka_state_t s = rtka_recursive_and_seq(d->r, d->n);
+    RTKA_DO_NOT_OPTIMIZE(s.confidence);
+}
+
+static bool vector_planes(rtka_vector_t* v, const rtka_state_t* states, uint32_t n) {
+    v->values = (rtka_value_t*)aligned_buffer(n * sizeof(rtka_value_t));
+    v->confidences = (rtka_confidence_t*)aligned_buffer(n * sizeof(rtka_confidence_t));
+    v->count = v->capacity = n;
+    if (!v->values || !v->confidences) return false;
+    for (uint32_t i = 0; i < n; i++) {
+        v->values[i] = states ? states[i].value : RTKA_UNKNOWN;
+        v->confidences[i] = states ? states[i].confidence : 0.0f;
+    }
+    return true;
+}
+
+static void vector_free_planes(rtka_vector_t* v) {
+    free(v->values);
+    free(v->confidences);
+}
+
+void rtka_benchmark_core_ops(rtka_benchmark_suite_t* suite) {
+    if (!wants_group(suite, "core/")) return;
+    const uint32_t n = 4096;
+    core_data_t d = { .n = n };
+    d.a = (rtka_state_t*)aligned_buffer(n * sizeof(rtka_state_t));
+    d.b = (rtka_state_t*)aligned_buffer(n * sizeof(rtka_state_t));
+    d.r = (rtka_state_t*)aligned_buffer(n * sizeof(rtka_state_t));
+    if (d.a && d.b && d.r) {
+        random_states(d.a, n, SUITE_SEED);
+        random_states(d.b, n, SUITE_SEED + 1U);
+    }
+    if (d.a && d.b && d.r && vector_planes(&d.va, d.a, n) && vector_planes(&d.vb, d.b, n) &&
+        vector_planes(&d.vr, NULL, n)) {
+        printf("\ncore (%s)\n", rtka_simd_level_name(rtka_simd_level()));
+        uint64_t bytes = 3U * (uint64_t)n * sizeof(rtka_state_t);
+        rtka_benchmark_suite_add(suite, "core/and scalar 4K", core_scalar, &d, n, bytes);
+        rtka_benchmark_suite_add(suite, "core/and batch 4K", core_batch, &d, n, bytes);
+        rtka_benchmark_suite_add(suite, "core/and simd 4K", core_simd, &d, n, bytes);
+        /* A FALSE ends the sequence early; all TRUE folds every element */
+        for (uint32_t i = 0; i < n; i++) d.r[i] = rtka_make_state(RTKA_TRUE, d.a[i].confidence);
+        rtka_benchmark_suite_add(suite, "core/and sequence 4K", core_sequence, &d, n, n * sizeof(rtka_state_t));
+    }
+    vector_free_planes(&d.va);
+    vector_free_planes(&d.vb);
+    vector_free_planes(&d.vr);
+    free(d.a);
+    free(d.b);
+    free(d.r);
+}
+
+/* ============================================================================
+ * VECTORS: three 8-byte-per-element operands for a binary op, sized to
+ * sit in L1, L2, L3 and DRAM
+ * ============================================================================ */
+
+typedef struct {
+    rtka_vector_t a, b, r;
+} vector_data_t;
+
+static void vector_and(void* data) {
+    vector_data_t* d = (vector_data_t*)data;
+    rtka_vector_and(&d->a, &d->b, &d->r);
+}
+
+static void vector_or(void* data) {
+    vector_data_t* d = (vector_data_t*)data;
+    rtka_vector_or(&d->a, &d->b, &d->r);
+}
+
+static void vector_not(void* data) {
+    vector_data_t* d = (vector_data_t*)data;
+    rtka_vector_not(&d->a, &d->r);
+}
+
+static void vector_reduce(void* data) {
+    vector_data_t* d = (vector_data_t*)data;
+    rtka_state_t s = rtka_vector_reduce_and(&d->a);
+    RTKA_DO_NOT_OPTIMIZE(s.confidence);
+}
+
+static const char* size_label(uint32_t n, char* label, size_t size) {
+    if (n >= (1U << 20) && n % (1U << 20) == 0) snprintf(label, size, "%uM", n >> 20);
+    else if (n >= 1024U && n % 1024U == 0) snprintf(label, size, "%uK", n >> 10);
+    else snprintf(label, size, "%u", n);
+    return label;
+}
+
+void rtka_benchmark_vector_ops(rtka_benchmark_suite_t* suite) {
+    if (!wants_group(suite, "vector/")) return;
+    /* 24 KB, 192 KB, 3 MB, 48 MB across the three operands */
+    const uint32_t sizes[] = { 1U << 10, 8U << 10, 128U << 10, 2U << 20 };
+    uint32_t count = suite->quick ? 3U : 4U;
+    printf("\nvector\n");
+    for (uint32_t s = 0; s < count; s++) {
+        uint32_t n = sizes[s];
+        rtka_state_t* states = (rtka_state_t*)malloc(n * sizeof(rtka_state_t));
+        vector_data_t d;
+        memset(&d, 0, sizeof(d));
+        bool ready = states != NULL;
+        if (ready) random_states(states, n, SUITE_SEED + s);
+        ready = ready && vector_planes(&d.a, states, n);
+        if (ready) random_states(states, n, SUITE_SEED + 100U + s);
+        ready = ready && vector_planes(&d.b, states, n) && vector_planes(&d.r, NULL, n);
+        if (ready) {
+            char label[16], name[RTKA_BENCHMARK_NAME_MAX];
+            size_label(n, label, sizeof(label));
+            uint64_t plane = (uint64_t)n * (sizeof(rtka_value_t) + sizeof(rtka_confidence_t));
+            snprintf(name, sizeof(name), "vector/and %s", label);
+            rtka_benchmark_suite_add(suite, name, vector_and, &d, n, 3U * plane);
+            snprintf(name, sizeof(name), "vector/or %s", label);
+            rtka_benchmark_suite_add(suite, name, vector_or, &d, n, 3U * plane);
+            snprintf(name, sizeof(name), "vector/not %s", label);
+            rtka_benchmark_suite_add(suite, name, vector_not, &d, n, 2U * plane);
+            /* A FALSE ends the reduction early; all TRUE scans the whole vector */
+            for (uint32_t i = 0; i < n; i++) d.a.values[i] = RTKA_TRUE;
+            snprintf(name, sizeof(name), "vector/reduce_and %s", label);
+            rtka_benchmark_suite_add(suite, name, vector_reduce, &d, n, plane);
+        }
+        vector_free_planes(&d.a);
+        vector_free_planes(&d.b);
+        vector_free_planes(&d.r);
+        free(states);
+    }
+}
+
+/* ============================================================================
+ * TENSORS: matmul at square, tall and vector shapes; elements are
+ * multiply-adds
+ * ============================================================================ */
+
+typedef struct {
+    rtka_tensor_t* a;
+    rtka_tensor_t* b;
+    rtka_tensor_t* out;
+    bool failed;
+} matmul_data_t;
+
+static void matmul(void* data) {
+    matmul_data_t* d = (matmul_data_t*)data;
+    if (rtka_tensor_matmul_into(d->out, d->a, d->b) != RTKA_SUCCESS) d->failed = true;
+}
+
+void rtka_benchmark_tensor_ops(rtka_benchmark_suite_t* suite) {
+    if (!wants_group(suite, "tensor/")) return;
+    const uint32_t shapes[][3] = {
+        { 64, 64, 64 }, { 256, 256, 256 }, { 512, 512, 512 }, { 4096, 64, 64 }, { 1, 1024, 1024 }
+    };
+    printf("\ntensor\n");
+    for (uint32_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        uint32_t m = shapes[s][0], k = shapes[s][1], n = shapes[s][2];
+        if (suite->quick && m * k * n > (256U * 256U * 256U)) continue;
+        uint32_t a_shape[] = { m, k }, b_shape[] = { k, n }, out_shape[] = { m, n };
+        matmul_data_t d = {
+            rtka_tensor_create(a_shape, 2), rtka_tensor_create(b_shape, 2), rtka_tensor_create(out_shape, 2), false
+        };
+        if (d.a && d.b && d.out) {
+            random_states(d.a->data, d.a->size, SUITE_SEED + s);
+            random_states(d.b->data, d.b->size, SUITE_SEED + 50U + s);
+            char name[RTKA_BENCHMARK_NAME_MAX];
+            snprintf(name, sizeof(name), "tensor/matmul %ux%ux%u", m, k, n);
+            uint64_t bytes = ((uint64_t)m * k + (uint64_t)k * n + (uint64_t)m * n) * sizeof(rtka_state_t);
+            rtka_benchmark_suite_add(suite, name, matmul, &d, (uint64_t)m * k * n, bytes);
+            if (d.failed) printf("  (matmul %ux%ux%u failed)\n", m, k, n);
+        }
+        rtka_tensor_free(d.a);
+        rtka_tensor_free(d.b);
+        rtka_tensor_free(d.out);
+    }
+}
+
+/* ============================================================================
+ * SEQUENCE MODELS: LSTM forward, forward + BPTT, MDN-RNN forward + BPTT;
+ * elements are timesteps over the batch
+ * ============================================================================ */
+
+typedef struct {
+    rtka_lstm_layer_t* lstm;
+    rtka_mdnrnn_t* mdnrnn;
+    rtka_grad_node_t* input;
+    rtka_tensor_t* z;
+    rtka_tensor_t* actions;
+    rtka_tensor_t* grad;
+    bool backward;
+    bool failed;
+} sequence_data_t;
+
+static void lstm_pass(void* data) {
+    sequence_data_t* d = (sequence_data_t*)data;
+    rtka_lstm_output_t out = rtka_lstm_forward(d->lstm, d->input, NULL, NULL);
+    if (!out.output) {
+        d->failed = true;
+        return;
+    }
+    if (d->backward && rtka_lstm_backward(d->lstm, d->input->data, d->grad, NULL) != RTKA_SUCCESS) {
+        d->failed = true;
+    }
+    rtka_grad_node_free(out.output);
+    rtka_tensor_free(out.hidden_state);
+    rtka_tensor_free(out.cell_state);
+}
+
+static void mdnrnn_pass(void* data) {
+    sequence_data_t* d = (sequence_data_t*)data;
+    rtka_mdnrnn_output_t out = rtka_mdnrnn_forward(d->mdnrnn, d->z, d->actions, NULL, NULL);
+    if (!out.mdn_params.pi) d->failed = true;
+    else if (rtka_mdnrnn_backward(d->mdnrnn, d->z, d->actions, d->grad) != RTKA_SUCCESS) d->failed = true;
+    rtka_mdnrnn_output_free(&out);
+}
+
+static rtka_tensor_t* random_tensor(const uint32_t* shape, uint32_t ndim, uint64_t seed) {
+    rtka_tensor_t* t = rtka_tensor_create(shape, ndim);
+    if (t) random_states(t->data, t->size, seed);
+    return t;
+}
+
+void rtka_benchmark_sequence_models(rtka_benchmark_suite_t* suite) {
+    if (!wants_group(suite, "seq/")) return;
+    const uint32_t batch = 8, seq_len = 32, input_size = 32, hidden = suite->quick ? 64U : 128U;
+    const uint32_t action_size = 3, gaussians = 5;
+    uint64_t steps = (uint64_t)batch * seq_len;
+    char name[RTKA_BENCHMARK_NAME_MAX];
+    printf("\nsequence models\n");
+
+    uint32_t in_shape[] = { batch, seq_len, input_size }, out_shape[] = { batch, seq_len, hidden };
+    uint32_t a_shape[] = { batch, seq_len, action_size };
+    sequence_data_t d = { 0 };
+    d.lstm = rtka_lstm_create(input_size, hidden, true);
+    rtka_tensor_t* input = random_tensor(in_shape, 3, SUITE_SEED);
+    d.input = input ? rtka_grad_node_create(input, false) : NULL;
+    d.grad = random_tensor(out_shape, 3, SUITE_SEED + 1U);
+    if (d.grad) {
+        for (uint32_t i = 0; i < d.grad->size; i++) d.grad->data[i].confidence *= 1e-2f;
+    }
+    if (d.lstm && d.input && d.grad && rtka_lstm_init_hidden(d.lstm, batch)) {
+        snprintf(name, sizeof(name), "seq/lstm forward b%u t%u h%u", batch, seq_len, hidden);
+        rtka_benchmark_suite_add(suite, name, lstm_pass, &d, steps, 0);
+        d.backward = true;
+        snprintf(name, sizeof(name), "seq/lstm train b%u t%u h%u", batch, seq_len, hidden);
+        rtka_benchmark_suite_add(suite, name, lstm_pass, &d, steps, 0);
+    }
+    rtka_lstm_free(d.lstm);
+    d.lstm = NULL;
+    if (d.input) rtka_grad_node_free(d.input);
+    else rtka_tensor_free(input);
+
+    d.mdnrnn = rtka_mdnrnn_create(input_size, action_size, hidden, gaussians);
+    d.z = random_tensor(in_shape, 3, SUITE_SEED + 2U);
+    d.actions = random_tensor(a_shape, 3, SUITE_SEED + 3U);
+    if (d.mdnrnn && d.z && d.actions && d.grad && rtka_mdnrnn_init_hidden(d.mdnrnn, batch)) {
+        snprintf(name, sizeof(name), "seq/mdnrnn train b%u t%u h%u k%u", batch, seq_len, hidden, gaussians);
+        rtka_benchmark_suite_add(suite, name, mdnrnn_pass, &d, steps, 0);
+    }
+    if (d.failed) printf("  (a sequence model pass failed)\n");
+    rtka_mdnrnn_free(d.mdnrnn);
+    rtka_tensor_free(d.z);
+    rtka_tensor_free(d.actions);
+    rtka_tensor_free(d.grad);
+}
+
+/* ============================================================================
+ * SOLVERS: planted 3-SAT, the hard 9x9 Sudoku set on both engines,
+ * N-Queens counting, two-phase Rubik IDA* on fixed scrambles, A* on a
+ * walled grid
+ * ============================================================================ */
+
+typedef struct {
+    const int32_t* clauses;
+    uint32_t vars;
+    uint32_t count;
+    bool failed;
+} sat_data_t;
+
+static void sat_solve(void* data) {
+    sat_data_t* d = (sat_data_t*)data;
+    sat_state_t state;
+    rtka_sat_init(&state, d->vars);
+    for (uint32_t c = 0; c < d->count; c++) rtka_sat_add_clause(&state, (int32_t*)&d->clauses[3U * c], 3);
+    if (!rtka_sat_solve(&state)) d->failed = true;
+    rtka_sat_free(&state);
+}
+
+/* Clauses that each agree with a hidden assignment in some literal */
+static int32_t* planted_3sat(uint32_t vars, uint32_t count, uint64_t seed) {
+    int32_t* clauses = (int32_t*)malloc(3U * (size_t)count * sizeof(int32_t));
+    bool* hidden = (bool*)malloc((vars + 1U) * sizeof(bool));
+    if (!clauses || !hidden) {
+        free(clauses);
+        free(hidden);
+        return NULL;
+    }
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, seed);
+    for (uint32_t v = 1; v <= vars; v++) hidden[v] = rtka_random_next(&rng) & 1U;
+    for (uint32_t c = 0; c < count; c++) {
+        bool agrees = false;
+        while (!agrees) {
+            for (uint32_t k = 0; k < 3; k++) {
+                int32_t v = (int32_t)rtka_random_range(&rng, 1, vars);
+                bool positive = rtka_random_next(&rng) & 1U;
+                clauses[3U * c + k] = positive ? v : -v;
+                agrees = agrees || positive == hidden[v];
+            }
+        }
+    }
+    free(hidden);
+    return clauses;
+}
+
+static const char* const hard_9x9[] = {
+    "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..",
+    "......12.....35......6...7.7.....3.....4..8..1...........12.....8.....4..5....6..",
+    ".......39.....1..5..3.5.8....8.9...6.7...2...1..4.......9.8..5..2....6..4..7....."
+};
+#define HARD_9X9_COUNT  (sizeof(hard_9x9) / sizeof(hard_9x9[0]))
+
+typedef struct {
+    uint8_t cells[HARD_9X9_COUNT][81];
+    bool failed;
+} sudoku_data_t;
+
+static void sudoku_bits(void* data) {
+    sudoku_data_t* d = (sudoku_data_t*)data;
+    for (uint32_t p = 0; p < HARD_9X9_COUNT; p++) {
+        sudoku_bits_t board;
+        if (!rtka_sudoku_bits_init(&board, d->cells[p]) || !rtka_sudoku_bits_solve(&board)) d->failed = true;
+    }
+}
+
+static void sudoku_nxn(void* data) {
+    sudoku_data_t* d = (sudoku_data_t*)data;
+    for (uint32_t p = 0; p < HARD_9X9_COUNT; p++) {
+        sudoku_nxn_t state;
+        if (rtka_sudoku_nxn_init(&state, 3, d->cells[p]) != RTKA_SUCCESS || !rtka_sudoku_nxn_solve(&state)) {
+            d->failed = true;
+        }
+        rtka_sudoku_nxn_free(&state);
+    }
+}
+
+typedef struct {
+    uint32_t n;
+    uint64_t expected;
+    bool failed;
+} nqueens_data_t;
+
+static void nqueens_count(void* data) {
+    nqueens_data_t* d = (nqueens_data_t*)data;
+    if (rtka_nqueens_count(d->n) != d->expected) d->failed = true;
+}
+
+#define RUBIK_SCRAMBLES  8U
+
+typedef struct {
+    const rubik_pdb_t* pdb;
+    rubik_cubie_t cubes[RUBIK_SCRAMBLES];
+    bool failed;
+} rubik_data_t;
+
+static void rubik_solve(void* data) {
+    rubik_data_t* d = (rubik_data_t*)data;
+    for (uint32_t i = 0; i < RUBIK_SCRAMBLES; i++) {
+        rubik_solution_t solution;
+        if (!rtka_rubik_ida_solve(&d->cubes[i], d->pdb, 22, &solution)) d->failed = true;
+    }
+}
+
+/* 20 random quarter or half turns, no face twice in a row */
+static void rubik_scrambles(rubik_data_t* d, uint64_t seed) {
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, seed);
+    for (uint32_t i = 0; i < RUBIK_SCRAMBLES; i++) {
+        rtka_rubik_cubie_solved(&d->cubes[i]);
+        uint32_t last_face = 6;
+        for (uint32_t m = 0; m < 20; m++) {
+            uint32_t face;
+            do face = rtka_random_range(&rng, 0, 5); while (face == last_face);
+            rtka_rubik_cubie_move(&d->cubes[i], face * 3U + rtka_random_range(&rng, 0, 2));
+            last_face = face;
+        }
+    }
+}
+
+#define GRID_SIZE  256U
+
+typedef struct {
+    uint16_t x, y;
+} grid_cell_t;
+
+static uint8_t grid_wall[GRID_SIZE][GRID_SIZE];
+
+static bool grid_goal(void* state) {
+    const grid_cell_t* c = (const grid_cell_t*)state;
+    return c->x == GRID_SIZE - 1U && c->y == GRID_SIZE - 1U;
+}
+
+static uint32_t grid_neighbors(void* state, void* neighbors, uint32_t max_neighbors) {
+    static const int dx[] = { 0, 1, 0, -1 };
+    static const int dy[] = { -1, 0, 1, 0 };
+    const grid_cell_t* c = (const grid_cell_t*)state;
+    grid_cell_t* out = (grid_cell_t*)neighbors;
+    uint32_t count = 0;
+    for (int i = 0; i < 4 && count < max_neighbors; i++) {
+        int nx = c->x + dx[i], ny = c->y + dy[i];
+        if (nx < 0 || ny < 0 || nx >= (int)GRID_SIZE || ny >= (int)GRID_SIZE || grid_wall[ny][nx]) continue;
+        out[count++] = (grid_cell_t){ (uint16_t)nx, (uint16_t)ny };
+    }
+    return count;
+}
+
+static rtka_state_t grid_heuristic(void* state, void* goal) {
+    const grid_cell_t* c = (const grid_cell_t*)state;
+    const grid_cell_t* g = (const grid_cell_t*)goal;
+    return rtka_make_state(RTKA_TRUE, (float)(abs(c->x - g->x) + abs(c->y - g->y)));
+}
+
+static rtka_state_t grid_cost(void* from, void* to) {
+    (void)from;
+    (void)to;
+    return rtka_make_state(RTKA_TRUE, 1.0f);
+}
+
+typedef struct {
+    uint32_t flags;
+    bool failed;
+} astar_data_t;
+
+static void astar_route(void* data) {
+    astar_data_t* d = (astar_data_t*)data;
+    rtka_astar_t* astar = rtka_astar_create();
+    if (!astar) {
+        d->failed = true;
+        return;
+    }
+    astar->flags = d->flags;
+    astar->is_goal = grid_goal;
+    astar->heuristic = grid_heuristic;
+    astar->cost = grid_cost;
+    astar->get_neighbors_into = grid_neighbors;
+    astar->state_size = sizeof(grid_cell_t);
+    grid_cell_t start = { 0, 0 }, goal = { GRID_SIZE - 1U, GRID_SIZE - 1U };
+    if (!rtka_astar_search(astar, &start, &goal)) d->failed = true;
+    rtka_astar_free(astar);
+}
+
+void rtka_benchmark_solver(rtka_benchmark_suite_t* suite) {
+    if (!wants_group(suite, "solver/")) return;
+    char name[RTKA_BENCHMARK_NAME_MAX];
+    printf("\nsolver\n");
+
+    /* Planted 3-SAT at clause ratio 3, the instance family of test_sat */
+    sat_data_t sat = { .vars = suite->quick ? 5000U : 20000U };
+    sat.count = sat.vars * 3U;
+    int32_t* clauses = planted_3sat(sat.vars, sat.count, SUITE_SEED);
+    sat.clauses = clauses;
+    if (clauses) {
+        snprintf(name, sizeof(name), "solver/sat planted %u", sat.vars);
+        rtka_benchmark_suite_add(suite, name, sat_solve, &sat, sat.count, 0);
+    }
+    free(clauses);
+
+    sudoku_data_t sudoku = { .failed = false };
+    for (uint32_t p = 0; p < HARD_9X9_COUNT; p++) {
+        for (uint32_t c = 0; c < 81; c++) {
+            char ch = hard_9x9[p][c];
+            sudoku.cells[p][c] = ch >= '1' && ch <= '9' ? (uint8_t)(ch - '0') : 0U;
+        }
+    }
+    rtka_benchmark_suite_add(suite, "solver/sudoku bits hard 3", sudoku_bits, &sudoku, HARD_9X9_COUNT, 0);
+    rtka_benchmark_suite_add(suite, "solver/sudoku nxn hard 3", sudoku_nxn, &sudoku, HARD_9X9_COUNT, 0);
+
+    nqueens_data_t queens = suite->quick ? (nqueens_data_t){ 10, 724, false } : (nqueens_data_t){ 12, 14200, false };
+    snprintf(name, sizeof(name), "solver/nqueens count %u", queens.n);
+    rtka_benchmark_suite_add(suite, name, nqueens_count, &queens, queens.expected, 0);
+
+    rubik_data_t rubik = { .pdb = NULL };
+    rubik_pdb_t* pdb = NULL;
+    if (rtka_benchmark_suite_wants(suite, "solver/rubik ida 20-move 8") &&
+        rtka_rubik_pdb_open(&pdb, suite->pdb_path, 0) == RTKA_SUCCESS) {
+        rubik.pdb = pdb;
+        rubik_scrambles(&rubik, SUITE_SEED);
+        rtka_benchmark_suite_add(suite, "solver/rubik ida 20-move 8", rubik_solve, &rubik, RUBIK_SCRAMBLES, 0);
+    }
+    rtka_rubik_pdb_free(pdb);
+
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, SUITE_SEED);
+    for (uint32_t y = 0; y < GRID_SIZE; y++) {
+        for (uint32_t x = 0; x < GRID_SIZE; x++) grid_wall[y][x] = rtka_random_range(&rng, 0, 99) < 25U;
+    }
+    grid_wall[0][0] = grid_wall[GRID_SIZE - 1U][GRID_SIZE - 1U] = 0;
+    astar_data_t astar = { ASTAR_INTEGER_COSTS, false };
+    rtka_benchmark_suite_add(suite, "solver/astar grid 256", astar_route, &astar, 0, 0);
+    astar.flags = ASTAR_INTEGER_COSTS | ASTAR_BIDIRECTIONAL;
+    rtka_benchmark_suite_add(suite, "solver/astar grid 256 bidirectional", astar_route, &astar, 0, 0);
+
+    if (sat.failed || sudoku.failed || queens.failed || rubik.failed || astar.failed) {
+        printf("  (a solver missed its instance: sat %d sudoku %d nqueens %d rubik %d astar %d)\n",
+               sat.failed, sudoku.failed, queens.failed, rubik.failed, astar.failed);
+    }
+}
+
+/* ============================================================================
+ * GRAPH: one PageRank iteration on a skewed random graph; elements are
+ * edges
+ * ============================================================================ */
+
+typedef struct {
+    rtka_graph_sparse_t* graph;
+    rtka_pagerank_t* pr;
+} pagerank_data_t;
+
+static void pagerank_iteration(void* data) {
+    pagerank_data_t* d = (pagerank_data_t*)data;
+    rtka_pagerank_iterate(d->pr, d->graph);
+}
+
+void rtka_benchmark_graph(rtka_benchmark_suite_t* suite) {
+    if (!wants_group(suite, "graph/")) return;
+    const uint32_t vertices = suite->quick ? (64U << 10) : (1U << 20), edges = vertices * 8U;
+    uint32_t* from = (uint32_t*)malloc(edges * sizeof(uint32_t));
+    uint32_t* to = (uint32_t*)malloc(edges * sizeof(uint32_t));
+    if (!from || !to) {
+        free(from);
+        free(to);
+        return;
+    }
+    /* Targets skewed toward low ids, as in-degree is in real graphs */
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, SUITE_SEED);
+    for (uint32_t e = 0; e < edges; e++) {
+        float u = rtka_random_uniform(&rng);
+        from[e] = rtka_random_range(&rng, 0, vertices - 1U);
+        to[e] = (uint32_t)(u * u * (float)vertices) % vertices;
+    }
+    printf("\ngraph\n");
+    pagerank_data_t d = { rtka_graph_build_csr(vertices, edges, from, to, NULL, NULL), NULL };
+    free(from);
+    free(to);
+    if (!d.graph) return;
+
+    char label[16], name[RTKA_BENCHMARK_NAME_MAX];
+    size_label(vertices, label, sizeof(label));
+    const rtka_pagerank_mode_t modes[] = { RTKA_PAGERANK_PULL, RTKA_PAGERANK_DELTA };
+    const char* mode_names[] = { "pull", "delta" };
+    for (uint32_t m = 0; m < 2; m++) {
+        d.pr = rtka_pagerank_init(d.graph);
+        if (!d.pr) break;
+        d.pr->mode = modes[m];
+        snprintf(name, sizeof(name), "graph/pagerank %s %s x8", mode_names[m], label);
+        rtka_benchmark_suite_add(suite, name, pagerank_iteration, &d, edges, 0);
+        rtka_pagerank_free(d.pr);
+    }
+    rtka_graph_free_sparse(d.graph);
+}
+
+void rtka_benchmark_all(rtka_benchmark_suite_t* suite) {
+    rtka_benchmark_core_ops(suite);
+    rtka_benchmark_vector_ops(suite);
+    rtka_benchmark_tensor_ops(suite);
+    rtka_benchmark_sequence_models(suite);
+    rtka_benchmark_solver(suite);
+    rtka_benchmark_graph(suite);
+}
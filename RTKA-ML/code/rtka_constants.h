@@ -31,6 +31,7 @@
 #define RTKA_STATE_POOL_SIZE 4096U
 #define RTKA_VECTOR_POOL_SIZE 256U
 #define RTKA_TEMP_STACK_SIZE (64U * 1024U)
+#define RTKA_STEP_ARENA_SIZE (16U * 1024U * 1024U)  /* Per-step tensors and grad nodes */
 
 /* Precision */
 #define RTKA_CONFIDENCE_EPSILON 1e-6f
@@ -39,6 +40,7 @@
 /* Optimization thresholds */
 #define RTKA_SIMD_THRESHOLD 32U        /* Min elements for SIMD */
 #define RTKA_PARALLEL_THRESHOLD 1024U  /* Min for threading */
+#define RTKA_PARALLEL_MIN_CHUNK 16384U /* Min elements per worker, streaming ops */
 #define RTKA_LOOKUP_TABLE_SIZE 256U    /* Precomputed operations */
 
 /* Algorithm tuning */
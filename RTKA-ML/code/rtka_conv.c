@@ -0,0 +1,455 @@
+/**
+ * File: rtka_conv.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA 2-D Convolution Implementation
+ *
+ * Winograd F(2x2, 3x3), per 4 x 4 input tile d and 3 x 3 filter g:
+ *   U = G g G^T, V = B^T d B, Y = A^T (U . V) A
+ *   B^T = | 1  0 -1  0 |   G = | 1    0    0   |   A^T = | 1  1  1  0 |
+ *         | 0  1  1  0 |       | 1/2  1/2  1/2 |         | 0  1 -1 -1 |
+ *         | 0 -1  1  0 |       | 1/2 -1/2  1/2 |
+ *         | 0  1  0 -1 |       | 0    0    1   |
+ * The elementwise product summed over channels is, per position xi of the
+ * 4 x 4 tile, an (O x C) * (C x tiles) matrix product.
+ */
+
+#include "rtka_conv.h"
+#include "rtka_memory.h"
+#include "rtka_threadpool.h"
+#include <stdlib.h>
+#include <string.h>
+
+rtka_conv_algo_t rtka_conv_select(const rtka_conv_shape_t* s, bool ternary_weights) {
+    bool winograd = s->kernel_h == 3U && s->kernel_w == 3U && s->stride_h == 1U && s->stride_w == 1U;
+    if (ternary_weights && s->stride_w == 1U &&
+        (!winograd || s->channels < RTKA_CONV_WINOGRAD_MIN_CHANNELS)) {
+        return RTKA_CONV_TERNARY;
+    }
+    return winograd ? RTKA_CONV_WINOGRAD : RTKA_CONV_IM2COL;
+}
+
+/* Output columns ox whose input column ox * stride + k - pad lies in [0, size) */
+static void valid_range(uint32_t out, uint32_t size, uint32_t stride, uint32_t k, uint32_t pad,
+                        uint32_t* lo, uint32_t* hi) {
+    uint32_t first = k >= pad ? 0U : (pad - k + stride - 1U) / stride;
+    uint32_t last = size + pad > k ? (size + pad - k - 1U) / stride + 1U : 0U;
+    *lo = first < out ? first : out;
+    *hi = last < out ? last : out;
+    if (*hi < *lo) *hi = *lo;
+}
+
+/* ============================================================================
+ * IM2COL
+ * ============================================================================ */
+
+void rtka_conv_im2col(const rtka_conv_shape_t* s, const float* image, float* cols) {
+    uint32_t oh = rtka_conv_out_height(s), ow = rtka_conv_out_width(s);
+    size_t n = (size_t)oh * ow;
+
+    for (uint32_t c = 0; c < s->channels; c++) {
+        const float* plane = image + (size_t)c * s->height * s->width;
+        for (uint32_t ky = 0; ky < s->kernel_h; ky++) {
+            for (uint32_t kx = 0; kx < s->kernel_w; kx++) {
+                float* row = cols + ((size_t)(c * s->kernel_h + ky) * s->kernel_w + kx) * n;
+                uint32_t lo, hi;
+                valid_range(ow, s->width, s->stride_w, kx, s->pad_w, &lo, &hi);
+                for (uint32_t oy = 0; oy < oh; oy++) {
+                    float* dst = row + (size_t)oy * ow;
+                    int64_t iy = (int64_t)oy * s->stride_h + ky - s->pad_h;
+                    if (iy < 0 || iy >= (int64_t)s->height) {
+                        memset(dst, 0, ow * sizeof(float));
+                        continue;
+                    }
+                    const float* src = plane + (size_t)iy * s->width;
+                    for (uint32_t ox = 0; ox < lo; ox++) dst[ox] = 0.0f;
+                    for (uint32_t ox = lo; ox < hi; ox++) {
+                        dst[ox] = src[ox * s->stride_w + kx - s->pad_w];
+                    }
+                    for (uint32_t ox = hi; ox < ow; ox++) dst[ox] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+rtka_error_t rtka_conv2d_im2col(const rtka_conv_shape_t* s, const float* x,
+                                const rtka_gemm_operand_t* w, float* y) {
+    if (!s || !x || !w || !y) return RTKA_ERROR_NULL_POINTER;
+    uint32_t oh = rtka_conv_out_height(s), ow = rtka_conv_out_width(s);
+    if (!oh || !ow || !s->channels || !s->filters) return RTKA_ERROR_INVALID_VALUE;
+
+    uint32_t k = s->channels * s->kernel_h * s->kernel_w;
+    uint32_t n = oh * ow;
+    rtka_allocator_t* owner = NULL;
+    float* cols = (float*)rtka_allocator_alloc(NULL, (size_t)k * n * sizeof(float), &owner);
+    if (!cols) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    rtka_gemm_operand_t b = { cols, n, 1, RTKA_GEMM_F32, NULL };
+    for (uint32_t img = 0; img < s->batch; img++) {
+        rtka_conv_im2col(s, x + (size_t)img * s->channels * s->height * s->width, cols);
+        rtka_gemm(s->filters, n, k, w, &b, y + (size_t)img * s->filters * n, n, false);
+    }
+
+    rtka_allocator_free(owner, cols);
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * WINOGRAD F(2x2, 3x3)
+ * ============================================================================ */
+
+void rtka_conv_winograd_weights(const rtka_conv_shape_t* s, const float* w, float* u) {
+    size_t stride = (size_t)s->filters * s->channels;
+
+    for (uint32_t o = 0; o < s->filters; o++) {
+        for (uint32_t c = 0; c < s->channels; c++) {
+            const float* g = w + ((size_t)o * s->channels + c) * 9U;
+
+            /* G g: 4 x 3 */
+            float t[4][3];
+            for (uint32_t j = 0; j < 3; j++) {
+                t[0][j] = g[j];
+                t[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+                t[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+                t[3][j] = g[6 + j];
+            }
+            /* (G g) G^T: 4 x 4 */
+            float* dst = u + (size_t)o * s->channels + c;
+            for (uint32_t i = 0; i < 4; i++) {
+                dst[(i * 4U + 0) * stride] = t[i][0];
+                dst[(i * 4U + 1) * stride] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                dst[(i * 4U + 2) * stride] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                dst[(i * 4U + 3) * stride] = t[i][2];
+            }
+        }
+    }
+}
+
+/* Rows [iy, iy + 4) of a plane into 4 rows of span floats starting at
+ * input column -pad_w, zero outside the plane */
+static void gather_rows(const float* plane, const rtka_conv_shape_t* s, int64_t iy,
+                        float* rows, uint32_t span) {
+    uint32_t lead = s->pad_w < span ? s->pad_w : span;
+    uint32_t copy = s->width < span - lead ? s->width : span - lead;
+    for (uint32_t r = 0; r < 4; r++) {
+        float* dst = rows + (size_t)r * span;
+        int64_t y = iy + r;
+        if (y < 0 || y >= (int64_t)s->height) {
+            memset(dst, 0, span * sizeof(float));
+            continue;
+        }
+        memset(dst, 0, lead * sizeof(float));
+        memcpy(dst + lead, plane + (size_t)y * s->width, copy * sizeof(float));
+        memset(dst + lead + copy, 0, (span - lead - copy) * sizeof(float));
+    }
+}
+
+/* V = B^T d B for one row of tiles: B^T down the 4 rows, then B across
+ * each tile's 4 columns. v[xi * stride + tx] for tile tx, contiguous
+ * along the row of tiles. */
+static void input_transform(const float* RTKA_RESTRICT rows, float* RTKA_RESTRICT t, uint32_t span,
+                            uint32_t tiles_w, float* RTKA_RESTRICT v, size_t stride) {
+    const float* r0 = rows;
+    const float* r1 = rows + span;
+    const float* r2 = rows + 2U * span;
+    const float* r3 = rows + 3U * span;
+    for (uint32_t q = 0; q < span; q++) {
+        t[q] = r0[q] - r2[q];
+        t[span + q] = r1[q] + r2[q];
+        t[2U * span + q] = r2[q] - r1[q];
+        t[3U * span + q] = r1[q] - r3[q];
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+        const float* ti = t + (size_t)i * span;
+        float* out = v + (size_t)i * 4U * stride;
+        for (uint32_t tx = 0; tx < tiles_w; tx++) {
+            float a0 = ti[2U * tx], a1 = ti[2U * tx + 1U];
+            float a2 = ti[2U * tx + 2U], a3 = ti[2U * tx + 3U];
+            out[tx] = a0 - a2;
+            out[stride + tx] = a1 + a2;
+            out[2U * stride + tx] = a2 - a1;
+            out[3U * stride + tx] = a1 - a3;
+        }
+    }
+}
+
+/* Y = A^T M A for one row of tiles into two output rows of 2 * tiles_w */
+static void output_transform(const float* RTKA_RESTRICT m, size_t stride, uint32_t tiles_w,
+                             float* RTKA_RESTRICT y0, float* RTKA_RESTRICT y1) {
+    for (uint32_t tx = 0; tx < tiles_w; tx++) {
+        float t0[4], t1[4];
+        for (uint32_t q = 0; q < 4; q++) {
+            float m0 = m[q * stride + tx], m1 = m[(4U + q) * stride + tx];
+            float m2 = m[(8U + q) * stride + tx], m3 = m[(12U + q) * stride + tx];
+            t0[q] = m0 + m1 + m2;
+            t1[q] = m1 - m2 - m3;
+        }
+        y0[2U * tx] = t0[0] + t0[1] + t0[2];
+        y0[2U * tx + 1U] = t0[1] - t0[2] - t0[3];
+        y1[2U * tx] = t1[0] + t1[1] + t1[2];
+        y1[2U * tx + 1U] = t1[1] - t1[2] - t1[3];
+    }
+}
+
+rtka_error_t rtka_conv2d_winograd(const rtka_conv_shape_t* s, const float* x,
+                                  const float* u, float* y) {
+    if (!s || !x || !u || !y) return RTKA_ERROR_NULL_POINTER;
+    if (s->kernel_h != 3U || s->kernel_w != 3U || s->stride_h != 1U || s->stride_w != 1U) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    uint32_t oh = rtka_conv_out_height(s), ow = rtka_conv_out_width(s);
+    if (!oh || !ow || !s->channels || !s->filters) return RTKA_ERROR_INVALID_VALUE;
+
+    /* Blocks of whole tile rows, about RTKA_CONV_WINOGRAD_TILES tiles each */
+    uint32_t tiles_w = (ow + 1U) / 2U, tiles_h = (oh + 1U) / 2U;
+    uint32_t block_rows = RTKA_CONV_WINOGRAD_TILES / tiles_w;
+    if (block_rows == 0) block_rows = 1;
+    if (block_rows > tiles_h) block_rows = tiles_h;
+    uint32_t span = 2U * tiles_w + 2U;
+    size_t block = (size_t)block_rows * tiles_w;
+    size_t v_floats = (size_t)16U * s->channels * block;
+    size_t m_floats = (size_t)16U * s->filters * block;
+    size_t floats = v_floats + m_floats + 8U * span + 4U * tiles_w;
+    rtka_allocator_t* owner = NULL;
+    float* v = (float*)rtka_allocator_alloc(NULL, floats * sizeof(float), &owner);
+    if (!v) return RTKA_ERROR_OUT_OF_MEMORY;
+    float* m = v + v_floats;
+    float* rows = m + m_floats;
+    float* t = rows + 4U * span;
+    float* y0 = t + 4U * span;
+    float* y1 = y0 + 2U * tiles_w;
+
+    size_t plane_in = (size_t)s->height * s->width;
+    size_t plane_out = (size_t)oh * ow;
+    for (uint32_t img = 0; img < s->batch; img++) {
+        const float* image = x + (size_t)img * s->channels * plane_in;
+        float* out = y + (size_t)img * s->filters * plane_out;
+
+        for (uint32_t ty0 = 0; ty0 < tiles_h; ty0 += block_rows) {
+            uint32_t nrows = tiles_h - ty0 < block_rows ? tiles_h - ty0 : block_rows;
+            uint32_t b = nrows * tiles_w;
+            size_t v_stride = (size_t)s->channels * b;
+            size_t m_stride = (size_t)s->filters * b;
+
+            /* V[xi] is (C x b) */
+            for (uint32_t c = 0; c < s->channels; c++) {
+                const float* plane = image + (size_t)c * plane_in;
+                for (uint32_t r = 0; r < nrows; r++) {
+                    gather_rows(plane, s, (int64_t)2 * (ty0 + r) - s->pad_h, rows, span);
+                    input_transform(rows, t, span, tiles_w, v + (size_t)c * b + (size_t)r * tiles_w, v_stride);
+                }
+            }
+
+            /* M[xi] = U[xi] (O x C) * V[xi] (C x b) */
+            for (uint32_t xi = 0; xi < 16U; xi++) {
+                rtka_gemm_operand_t a_op = { u + (size_t)xi * s->filters * s->channels, s->channels, 1,
+                                             RTKA_GEMM_F32, NULL };
+                rtka_gemm_operand_t b_op = { v + xi * v_stride, b, 1, RTKA_GEMM_F32, NULL };
+                rtka_gemm(s->filters, b, s->channels, &a_op, &b_op, m + xi * m_stride, b, false);
+            }
+
+            /* Y = A^T M A, cropped at the bottom and right edges */
+            for (uint32_t o = 0; o < s->filters; o++) {
+                float* plane = out + (size_t)o * plane_out;
+                for (uint32_t r = 0; r < nrows; r++) {
+                    output_transform(m + (size_t)o * b + (size_t)r * tiles_w, m_stride, tiles_w, y0, y1);
+                    uint32_t oy = 2U * (ty0 + r);
+                    memcpy(plane + (size_t)oy * ow, y0, ow * sizeof(float));
+                    if (oy + 1U < oh) memcpy(plane + (size_t)(oy + 1U) * ow, y1, ow * sizeof(float));
+                }
+            }
+        }
+    }
+
+    rtka_allocator_free(owner, v);
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * TERNARY DIRECT
+ * ============================================================================ */
+
+rtka_conv_taps_t* rtka_conv_taps_pack(const rtka_conv_shape_t* s, const rtka_state_t* w) {
+    if (!s || !w || !s->filters) return NULL;
+
+    uint32_t k = s->channels * s->kernel_h * s->kernel_w;
+    uint32_t nonzero = 0;
+    for (size_t i = 0; i < (size_t)s->filters * k; i++) nonzero += w[i].value != RTKA_UNKNOWN;
+
+    rtka_conv_taps_t* taps = (rtka_conv_taps_t*)calloc(1, sizeof(rtka_conv_taps_t));
+    if (!taps) return NULL;
+    taps->filters = s->filters;
+    taps->start = (uint32_t*)malloc((s->filters + 1U) * sizeof(uint32_t));
+    taps->split = (uint32_t*)malloc(s->filters * sizeof(uint32_t));
+    taps->taps = (uint32_t*)malloc((nonzero ? nonzero : 1U) * sizeof(uint32_t));
+    if (!taps->start || !taps->split || !taps->taps) {
+        rtka_conv_taps_free(taps);
+        return NULL;
+    }
+
+    uint32_t n = 0;
+    for (uint32_t o = 0; o < s->filters; o++) {
+        const rtka_state_t* filter = w + (size_t)o * k;
+        taps->start[o] = n;
+        for (uint32_t t = 0; t < k; t++) {
+            if (filter[t].value == RTKA_TRUE) taps->taps[n++] = t;
+        }
+        taps->split[o] = n;
+        for (uint32_t t = 0; t < k; t++) {
+            if (filter[t].value == RTKA_FALSE) taps->taps[n++] = t;
+        }
+    }
+    taps->start[s->filters] = n;
+    return taps;
+}
+
+void rtka_conv_taps_free(rtka_conv_taps_t* taps) {
+    if (!taps) return;
+    free(taps->start);
+    free(taps->split);
+    free(taps->taps);
+    free(taps);
+}
+
+typedef struct {
+    const rtka_conv_shape_t* s;
+    const float* xp;            /* Zero-padded input, (N, C, HP, WP) plus slack */
+    const rtka_conv_taps_t* taps;
+    const uint32_t* offsets;    /* Per tap: (c * HP + ky) * WP + kx */
+    float* y;
+    uint32_t oh;
+    uint32_t ow;
+    size_t padded_image;        /* C * HP * WP */
+    uint32_t padded_w;
+} rtka_conv_ternary_job_t;
+
+/* RTKA_CONV_LANES outputs of one row: the +1 taps added, the -1 taps
+ * subtracted, two taps at a time into two accumulator sets. Inlined with
+ * the stride a constant, the lanes stay in vector registers. */
+static RTKA_INLINE void ternary_lanes(const float* base, const uint32_t* off, uint32_t plus,
+                                      uint32_t count, uint32_t stride, float* out) {
+    float a[RTKA_CONV_LANES] = {0}, b[RTKA_CONV_LANES] = {0};
+    uint32_t t = 0;
+    for (; t + 1U < plus; t += 2U) {
+        const float* p = base + off[t];
+        const float* q = base + off[t + 1U];
+        for (uint32_t i = 0; i < RTKA_CONV_LANES; i++) {
+            a[i] += p[i * stride];
+            b[i] += q[i * stride];
+        }
+    }
+    if (t < plus) {
+        const float* p = base + off[t++];
+        for (uint32_t i = 0; i < RTKA_CONV_LANES; i++) a[i] += p[i * stride];
+    }
+    for (; t + 1U < count; t += 2U) {
+        const float* p = base + off[t];
+        const float* q = base + off[t + 1U];
+        for (uint32_t i = 0; i < RTKA_CONV_LANES; i++) {
+            a[i] -= p[i * stride];
+            b[i] -= q[i * stride];
+        }
+    }
+    if (t < count) {
+        const float* p = base + off[t];
+        for (uint32_t i = 0; i < RTKA_CONV_LANES; i++) a[i] -= p[i * stride];
+    }
+    for (uint32_t i = 0; i < RTKA_CONV_LANES; i++) out[i] = a[i] + b[i];
+}
+
+/* Output planes [begin, end) of the N * O planes */
+static void ternary_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const rtka_conv_ternary_job_t* job = (const rtka_conv_ternary_job_t*)ctx;
+    const rtka_conv_shape_t* s = job->s;
+    const rtka_conv_taps_t* taps = job->taps;
+    size_t plane_out = (size_t)job->oh * job->ow;
+    float lanes[RTKA_CONV_LANES];
+
+    for (uint32_t p = begin; p < end; p++) {
+        uint32_t img = p / s->filters, o = p % s->filters;
+        const float* image = job->xp + (size_t)img * job->padded_image;
+        float* plane = job->y + (size_t)p * plane_out;
+        const uint32_t* off = job->offsets + taps->start[o];
+        uint32_t plus = taps->split[o] - taps->start[o];
+        uint32_t count = taps->start[o + 1U] - taps->start[o];
+
+        for (uint32_t oy = 0; oy < job->oh; oy++) {
+            const float* row = image + (size_t)oy * s->stride_h * job->padded_w;
+            float* dst = plane + (size_t)oy * job->ow;
+            for (uint32_t ox = 0; ox < job->ow; ox += RTKA_CONV_LANES) {
+                const float* base = row + (size_t)ox * s->stride_w;
+                if (s->stride_w == 1U) {
+                    ternary_lanes(base, off, plus, count, 1U, lanes);
+                } else if (s->stride_w == 2U) {
+                    ternary_lanes(base, off, plus, count, 2U, lanes);
+                } else {
+                    ternary_lanes(base, off, plus, count, s->stride_w, lanes);
+                }
+                uint32_t n = job->ow - ox < RTKA_CONV_LANES ? job->ow - ox : RTKA_CONV_LANES;
+                memcpy(dst + ox, lanes, n * sizeof(float));
+            }
+        }
+    }
+}
+
+rtka_error_t rtka_conv2d_ternary(const rtka_conv_shape_t* s, const float* x,
+                                 const rtka_conv_taps_t* taps, float* y) {
+    if (!s || !x || !taps || !y) return RTKA_ERROR_NULL_POINTER;
+    uint32_t oh = rtka_conv_out_height(s), ow = rtka_conv_out_width(s);
+    if (!oh || !ow || !s->channels || taps->filters != s->filters) return RTKA_ERROR_INVALID_VALUE;
+
+    /* Padded copy, so no tap needs a bounds check; the slack covers the
+     * lanes past the last output of the last row */
+    uint32_t hp = s->height + 2U * s->pad_h, wp = s->width + 2U * s->pad_w;
+    size_t padded_image = (size_t)s->channels * hp * wp;
+    size_t slack = (size_t)RTKA_CONV_LANES * s->stride_w + wp;
+    uint32_t tap_count = taps->start[s->filters];
+    size_t bytes = ((size_t)s->batch * padded_image + slack) * sizeof(float) + (size_t)tap_count * sizeof(uint32_t);
+    rtka_allocator_t* owner = NULL;
+    float* xp = (float*)rtka_allocator_alloc(NULL, bytes, &owner);
+    if (!xp) return RTKA_ERROR_OUT_OF_MEMORY;
+    uint32_t* offsets = (uint32_t*)(void*)(xp + (size_t)s->batch * padded_image + slack);
+
+    memset(xp, 0, ((size_t)s->batch * padded_image + slack) * sizeof(float));
+    for (uint32_t img = 0; img < s->batch; img++) {
+        for (uint32_t c = 0; c < s->channels; c++) {
+            const float* src = x + ((size_t)img * s->channels + c) * s->height * s->width;
+            float* dst = xp + (size_t)img * padded_image + (size_t)c * hp * wp + (size_t)s->pad_h * wp + s->pad_w;
+            for (uint32_t r = 0; r < s->height; r++) {
+                memcpy(dst + (size_t)r * wp, src + (size_t)r * s->width, s->width * sizeof(float));
+            }
+        }
+    }
+
+    uint32_t taps_per_channel = s->kernel_h * s->kernel_w;
+    for (uint32_t t = 0; t < tap_count; t++) {
+        uint32_t tap = taps->taps[t];
+        uint32_t c = tap / taps_per_channel;
+        uint32_t ky = (tap / s->kernel_w) % s->kernel_h;
+        uint32_t kx = tap % s->kernel_w;
+        offsets[t] = (c * hp + ky) * wp + kx;
+    }
+
+    rtka_conv_ternary_job_t job = {
+        .s = s, .xp = xp, .taps = taps, .offsets = offsets, .y = y, .oh = oh, .ow = ow,
+        .padded_image = padded_image, .padded_w = wp
+    };
+    uint32_t planes = s->batch * s->filters;
+    uint64_t work = (uint64_t)tap_count * s->batch * oh * ow;
+    if (planes > 1U && work >= RTKA_GEMM_PARALLEL_MIN_FLOPS) {
+        rtka_pool_parallel_for(rtka_pool_default(), 0, planes, 0, ternary_range, &job);
+    } else {
+        ternary_range(&job, 0, planes, 0);
+    }
+
+    rtka_allocator_free(owner, xp);
+    return RTKA_SUCCESS;
+}
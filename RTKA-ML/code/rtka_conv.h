@@ -0,0 +1,113 @@
+/**
+ * File: rtka_conv.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA 2-D Convolution - y (N, O, OH, OW) = w (O, C, KH, KW) * x (N, C, H, W)
+ * on float planes, zero padded, cross-correlation as in every CNN framework
+ *
+ * CHANGELOG:
+ * v1.0.0 - Three kernels behind one shape descriptor:
+ *          im2col: each image unrolled to a (C*KH*KW) x (OH*OW) matrix,
+ *          one rtka_gemm against the (O, C*KH*KW) weight operand, which
+ *          may be read straight from rtka_state_t (signed or ternary)
+ *          Winograd F(2x2, 3x3) for 3 x 3 stride-1 kernels: 2 x 2 output
+ *          tiles from 4 x 4 input tiles, 16 multiplies instead of 36, as
+ *          16 rtka_gemm calls of (O x C) * (C x tiles) per tile block
+ *          Ternary direct: each filter's +1 and -1 taps as offset lists,
+ *          output rows built by adding and subtracting shifted rows of a
+ *          zero-padded copy of the input;
+ *          zero weights cost nothing and no multiply is issued
+ *
+ * Winograd rounds differently from the other two (its transforms carry
+ * halves), well within float tolerance for 3 x 3 kernels.
+ */
+
+#ifndef RTKA_CONV_H
+#define RTKA_CONV_H
+
+#include "rtka_types.h"
+#include "rtka_gemm.h"
+
+#define RTKA_CONV_WINOGRAD_TILES 128U   /* 2 x 2 output tiles transformed per block */
+#define RTKA_CONV_WINOGRAD_MIN_CHANNELS 8U  /* Below this ternary direct beats Winograd */
+#define RTKA_CONV_LANES 32U             /* Ternary direct outputs accumulated per pass */
+
+typedef enum {
+    RTKA_CONV_AUTO,         /* See rtka_conv_select */
+    RTKA_CONV_IM2COL,
+    RTKA_CONV_WINOGRAD,
+    RTKA_CONV_TERNARY
+} rtka_conv_algo_t;
+
+typedef struct {
+    uint32_t batch;
+    uint32_t channels;      /* C */
+    uint32_t height;
+    uint32_t width;
+    uint32_t filters;       /* O */
+    uint32_t kernel_h;
+    uint32_t kernel_w;
+    uint32_t stride_h;
+    uint32_t stride_w;
+    uint32_t pad_h;
+    uint32_t pad_w;
+} rtka_conv_shape_t;
+
+/* Output size; 0 when the padded input is smaller than the kernel */
+RTKA_INLINE uint32_t rtka_conv_out_height(const rtka_conv_shape_t* s) {
+    uint32_t padded = s->height + 2U * s->pad_h;
+    return padded < s->kernel_h || !s->stride_h ? 0U : (padded - s->kernel_h) / s->stride_h + 1U;
+}
+
+RTKA_INLINE uint32_t rtka_conv_out_width(const rtka_conv_shape_t* s) {
+    uint32_t padded = s->width + 2U * s->pad_w;
+    return padded < s->kernel_w || !s->stride_w ? 0U : (padded - s->kernel_w) / s->stride_w + 1U;
+}
+
+/* Kernel AUTO resolves to for this shape: WINOGRAD for 3 x 3 stride 1
+ * (ternary weights too, once there are RTKA_CONV_WINOGRAD_MIN_CHANNELS
+ * input channels), TERNARY for other ternary stride-1 shapes, else IM2COL.
+ * Strided ternary shapes go to IM2COL: the direct kernel's strided row
+ * reads lose to the packed GEMM there. */
+rtka_conv_algo_t rtka_conv_select(const rtka_conv_shape_t* s, bool ternary_weights);
+
+/* One image (C, H, W) to cols, (C*KH*KW) rows of OH*OW */
+void rtka_conv_im2col(const rtka_conv_shape_t* s, const float* image, float* cols);
+
+/* w is an (O, C*KH*KW) operand */
+RTKA_NODISCARD rtka_error_t rtka_conv2d_im2col(const rtka_conv_shape_t* s, const float* x,
+                                               const rtka_gemm_operand_t* w, float* y);
+
+/* Winograd filter transform: u holds 16 (O, C) matrices, 16 * O * C floats,
+ * from O x C x 3 x 3 float weights */
+RTKA_INLINE size_t rtka_conv_winograd_size(const rtka_conv_shape_t* s) {
+    return (size_t)16U * s->filters * s->channels;
+}
+void rtka_conv_winograd_weights(const rtka_conv_shape_t* s, const float* w, float* u);
+
+/* 3 x 3, stride 1 only (RTKA_ERROR_INVALID_VALUE otherwise) */
+RTKA_NODISCARD rtka_error_t rtka_conv2d_winograd(const rtka_conv_shape_t* s, const float* x,
+                                                 const float* u, float* y);
+
+/* Ternary filters by value alone, confidence dropped as in rtka_ternary_pack */
+typedef struct {
+    uint32_t filters;
+    uint32_t* start;        /* filters + 1 offsets into taps */
+    uint32_t* split;        /* Per filter: taps[start .. split) are +1, [split .. start + 1) are -1 */
+    uint32_t* taps;         /* (c * KH + ky) * KW + kx */
+} rtka_conv_taps_t;
+
+/* w is O x C x KH x KW states, contiguous */
+RTKA_NODISCARD rtka_conv_taps_t* rtka_conv_taps_pack(const rtka_conv_shape_t* s, const rtka_state_t* w);
+void rtka_conv_taps_free(rtka_conv_taps_t* taps);
+
+RTKA_NODISCARD rtka_error_t rtka_conv2d_ternary(const rtka_conv_shape_t* s, const float* x,
+                                                const rtka_conv_taps_t* taps, float* y);
+
+#endif /* RTKA_CONV_H */
@@ -0,0 +1,411 @@
+/**
+ * File: rtka_data_loader.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Data Loader Library
+ *
+ * The gathering side owns the permutation, the cursor and the generator;
+ * the consumer only takes filled batches. Batch b of the run goes into
+ * slot b % RTKA_DATA_LOADER_DEPTH; the slot comes back when the consumer
+ * asks for the batch after it, so the one being trained on is never
+ * overwritten.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_data_loader.h"
+#include "rtka_memory.h"
+#include "rtka_random.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DATA_MAGIC      "RTKADAT"
+#define DATA_ALIGN      64U
+#define DATA_ALIGN_UP(x) (((x) + DATA_ALIGN - 1U) & ~(uint64_t)(DATA_ALIGN - 1U))
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t state_size;                   /* sizeof(rtka_state_t) when written */
+    uint32_t num_samples;
+    uint32_t num_features;
+    uint32_t label_width;
+    uint32_t num_classes;
+    uint32_t is_ternary;
+    uint32_t reserved0;
+    uint64_t features;                     /* File positions of the blocks */
+    uint64_t labels;
+    uint8_t reserved[8];
+} data_header_t;
+
+_Static_assert(sizeof(data_header_t) == 64, "dataset header must be 64 bytes");
+
+struct rtka_data_loader {
+    /* Source: AoS rows when rows != NULL, else loads through the tensors */
+    const rtka_state_t* feature_rows;
+    const rtka_state_t* label_rows;
+    const rtka_tensor_t* feature_tensor;
+    const rtka_tensor_t* label_tensor;
+    uint32_t num_samples;
+    uint32_t num_features;
+    uint32_t label_width;
+    uint32_t batch_size;
+    uint8_t* map;                          /* Dataset file, or NULL */
+    size_t map_length;
+
+    /* Epoch state, touched only by whoever gathers */
+    uint32_t* order;
+    bool shuffled;
+    uint32_t cursor;
+    uint32_t epoch;
+    uint32_t index;
+    rtka_rng_t rng;
+
+    rtka_data_batch_t slots[RTKA_DATA_LOADER_DEPTH];
+    uint32_t served;                       /* Batches handed out this epoch */
+    bool holding;                          /* The consumer has the last batch */
+
+    /* Pipeline: batches gathered, taken and given back over the run */
+    bool threaded;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint64_t produced;
+    uint64_t consumed;
+    uint64_t released;
+    bool stop;
+};
+
+static void shuffle(rtka_data_loader_t* l) {
+    for (uint32_t i = l->num_samples; i > 1U; i--) {
+        uint32_t j = rtka_random_range(&l->rng, 0, i - 1U);
+        uint32_t t = l->order[i - 1U];
+        l->order[i - 1U] = l->order[j];
+        l->order[j] = t;
+    }
+}
+
+/* Row i of a (num_samples) or (num_samples, width) tensor */
+static void load_row(rtka_state_t* dst, const rtka_tensor_t* t, uint32_t i, uint32_t width) {
+    uint32_t base = i * t->strides[0];
+    uint32_t step = t->ndim == 2 ? t->strides[1] : 0U;
+    for (uint32_t j = 0; j < width; j++) dst[j] = rtka_tensor_load(t, base + j * step);
+}
+
+/* The next batch_size samples of the permutation into slot */
+static void gather(rtka_data_loader_t* l, rtka_data_batch_t* slot) {
+    if (l->cursor >= l->num_samples) {
+        l->cursor = 0;
+        l->index = 0;
+        l->epoch++;
+        if (l->shuffled) shuffle(l);
+    }
+    uint32_t rows = l->num_samples - l->cursor;
+    if (rows > l->batch_size) rows = l->batch_size;
+
+    uint32_t F = l->num_features, L = l->label_width;
+    rtka_state_t* features = slot->features->data;
+    rtka_state_t* labels = slot->labels->data;
+    for (uint32_t r = 0; r < rows; r++) {
+        uint32_t i = l->order[l->cursor + r];
+        if (l->feature_rows) {
+            memcpy(features + (size_t)r * F, l->feature_rows + (size_t)i * F, F * sizeof(rtka_state_t));
+        } else {
+            load_row(features + (size_t)r * F, l->feature_tensor, i, F);
+        }
+        if (l->label_rows) {
+            memcpy(labels + (size_t)r * L, l->label_rows + (size_t)i * L, L * sizeof(rtka_state_t));
+        } else {
+            load_row(labels + (size_t)r * L, l->label_tensor, i, L);
+        }
+    }
+
+    /* A short last batch is the leading rows of the preallocated one */
+    slot->features->shape[0] = rows;
+    slot->features->size = rows * F;
+    slot->labels->shape[0] = rows;
+    slot->labels->size = rows * L;
+    slot->rows = rows;
+    slot->epoch = l->epoch;
+    slot->index = l->index++;
+    l->cursor += rows;
+}
+
+static void* loader_main(void* arg) {
+    rtka_data_loader_t* l = (rtka_data_loader_t*)arg;
+
+    pthread_mutex_lock(&l->lock);
+    for (;;) {
+        while (l->produced - l->released == RTKA_DATA_LOADER_DEPTH && !l->stop) {
+            pthread_cond_wait(&l->changed, &l->lock);
+        }
+        if (l->stop) break;
+        rtka_data_batch_t* slot = &l->slots[l->produced % RTKA_DATA_LOADER_DEPTH];
+        pthread_mutex_unlock(&l->lock);
+
+        gather(l, slot);
+
+        pthread_mutex_lock(&l->lock);
+        l->produced++;
+        pthread_cond_broadcast(&l->changed);
+    }
+    pthread_mutex_unlock(&l->lock);
+    return NULL;
+}
+
+/* Everything but the source; takes over a map even on failure */
+static rtka_error_t loader_start(rtka_data_loader_t* l, rtka_data_loader_t** loader, uint64_t seed,
+                                 uint32_t flags) {
+    l->shuffled = !(flags & RTKA_DATA_LOADER_ORDERED);
+    rtka_random_init_stream(&l->rng, seed, 0);
+
+    /* Batches outlive any step arena the consumer runs */
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    uint32_t feature_shape[] = {l->batch_size, l->num_features};
+    uint32_t label_shape[] = {l->batch_size, l->label_width};
+    bool ok = true;
+    for (uint32_t s = 0; s < RTKA_DATA_LOADER_DEPTH; s++) {
+        l->slots[s].features = rtka_tensor_create_in(heap, feature_shape, 2);
+        l->slots[s].labels = rtka_tensor_create_in(heap, label_shape, 2);
+        ok &= l->slots[s].features && l->slots[s].labels;
+    }
+    l->order = (uint32_t*)malloc((size_t)l->num_samples * sizeof(uint32_t));
+    if (!ok || !l->order) {
+        rtka_data_loader_free(l);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < l->num_samples; i++) l->order[i] = i;
+    if (l->shuffled) shuffle(l);
+    if (l->map) madvise(l->map, l->map_length, l->shuffled ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+    if (!(flags & RTKA_DATA_LOADER_SYNC)) {
+        pthread_mutex_init(&l->lock, NULL);
+        pthread_cond_init(&l->changed, NULL);
+        if (pthread_create(&l->thread, NULL, loader_main, l) != 0) {
+            pthread_cond_destroy(&l->changed);
+            pthread_mutex_destroy(&l->lock);
+            rtka_data_loader_free(l);
+            return RTKA_ERROR_NOT_INITIALIZED;
+        }
+        l->threaded = true;
+    }
+
+    *loader = l;
+    return RTKA_SUCCESS;
+}
+
+static bool rows_of(const rtka_tensor_t* t) {
+    return !rtka_tensor_is_soa(t) && rtka_tensor_is_contiguous(t);
+}
+
+rtka_error_t rtka_data_loader_create(rtka_data_loader_t** loader, const rtka_dataset_t* data,
+                                     uint32_t batch_size, uint64_t seed, uint32_t flags) {
+    if (!loader || !data || !data->features || !data->labels) return RTKA_ERROR_NULL_POINTER;
+    *loader = NULL;
+    const rtka_tensor_t* x = data->features;
+    const rtka_tensor_t* y = data->labels;
+    if (x->ndim != 2 || (y->ndim != 1 && y->ndim != 2) || x->shape[0] == 0 ||
+        y->shape[0] != x->shape[0] || batch_size == 0) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    rtka_data_loader_t* l = (rtka_data_loader_t*)calloc(1, sizeof(rtka_data_loader_t));
+    if (!l) return RTKA_ERROR_OUT_OF_MEMORY;
+    l->feature_tensor = x;
+    l->label_tensor = y;
+    l->feature_rows = rows_of(x) ? x->data : NULL;
+    l->label_rows = rows_of(y) ? y->data : NULL;
+    l->num_samples = x->shape[0];
+    l->num_features = x->shape[1];
+    l->label_width = y->ndim == 2 ? y->shape[1] : 1U;
+    l->batch_size = batch_size < l->num_samples ? batch_size : l->num_samples;
+    return loader_start(l, loader, seed, flags);
+}
+
+rtka_error_t rtka_data_loader_open(rtka_data_loader_t** loader, const char* path,
+                                   uint32_t batch_size, uint64_t seed, uint32_t flags) {
+    if (!loader || !path) return RTKA_ERROR_NULL_POINTER;
+    *loader = NULL;
+    if (batch_size == 0) return RTKA_ERROR_INVALID_VALUE;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return RTKA_ERROR_INVALID_VALUE;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(data_header_t)) {
+        close(fd);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    size_t length = (size_t)st.st_size;
+    void* map = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    const data_header_t* h = (const data_header_t*)map;
+    uint64_t feature_bytes = (uint64_t)h->num_samples * h->num_features * sizeof(rtka_state_t);
+    uint64_t label_bytes = (uint64_t)h->num_samples * h->label_width * sizeof(rtka_state_t);
+    bool ok = memcmp(h->magic, DATA_MAGIC, sizeof(DATA_MAGIC)) == 0 &&
+              h->version == RTKA_DATA_FILE_VERSION && h->state_size == sizeof(rtka_state_t) &&
+              h->num_samples > 0 && h->num_features > 0 && h->label_width > 0 &&
+              h->features == DATA_ALIGN_UP(sizeof(data_header_t)) &&
+              h->labels == DATA_ALIGN_UP(h->features + feature_bytes) && h->labels <= length &&
+              label_bytes <= length - h->labels;
+    rtka_data_loader_t* l = ok ? (rtka_data_loader_t*)calloc(1, sizeof(rtka_data_loader_t)) : NULL;
+    if (!l) {
+        munmap(map, length);
+        return ok ? RTKA_ERROR_OUT_OF_MEMORY : RTKA_ERROR_INVALID_VALUE;
+    }
+    l->map = (uint8_t*)map;
+    l->map_length = length;
+    l->feature_rows = (const rtka_state_t*)(l->map + h->features);
+    l->label_rows = (const rtka_state_t*)(l->map + h->labels);
+    l->num_samples = h->num_samples;
+    l->num_features = h->num_features;
+    l->label_width = h->label_width;
+    l->batch_size = batch_size < l->num_samples ? batch_size : l->num_samples;
+    return loader_start(l, loader, seed, flags);
+}
+
+rtka_error_t rtka_data_loader_next(rtka_data_loader_t* loader, const rtka_data_batch_t** batch) {
+    if (!loader || !batch) return RTKA_ERROR_NULL_POINTER;
+    *batch = NULL;
+
+    bool end = loader->served == rtka_data_loader_batches(loader);
+    if (!loader->threaded) {
+        loader->holding = false;
+        if (end) {
+            loader->served = 0;
+            return RTKA_SUCCESS;
+        }
+        gather(loader, &loader->slots[0]);
+        loader->served++;
+        *batch = &loader->slots[0];
+        return RTKA_SUCCESS;
+    }
+
+    pthread_mutex_lock(&loader->lock);
+    if (loader->holding) {
+        loader->released++;
+        loader->holding = false;
+        pthread_cond_broadcast(&loader->changed);
+    }
+    if (end) {
+        loader->served = 0;
+    } else {
+        while (loader->produced == loader->consumed) pthread_cond_wait(&loader->changed, &loader->lock);
+        *batch = &loader->slots[loader->consumed % RTKA_DATA_LOADER_DEPTH];
+        loader->consumed++;
+        loader->served++;
+        loader->holding = true;
+    }
+    pthread_mutex_unlock(&loader->lock);
+    return RTKA_SUCCESS;
+}
+
+uint32_t rtka_data_loader_batches(const rtka_data_loader_t* loader) {
+    if (!loader) return 0;
+    return (loader->num_samples + loader->batch_size - 1U) / loader->batch_size;
+}
+
+uint32_t rtka_data_loader_samples(const rtka_data_loader_t* loader) {
+    return loader ? loader->num_samples : 0;
+}
+
+uint32_t rtka_data_loader_features(const rtka_data_loader_t* loader) {
+    return loader ? loader->num_features : 0;
+}
+
+uint32_t rtka_data_loader_label_width(const rtka_data_loader_t* loader) {
+    return loader ? loader->label_width : 0;
+}
+
+void rtka_data_loader_free(rtka_data_loader_t* loader) {
+    if (!loader) return;
+
+    if (loader->threaded) {
+        pthread_mutex_lock(&loader->lock);
+        loader->stop = true;
+        pthread_cond_broadcast(&loader->changed);
+        pthread_mutex_unlock(&loader->lock);
+        pthread_join(loader->thread, NULL);
+        pthread_cond_destroy(&loader->changed);
+        pthread_mutex_destroy(&loader->lock);
+    }
+
+    for (uint32_t s = 0; s < RTKA_DATA_LOADER_DEPTH; s++) {
+        rtka_tensor_free(loader->slots[s].features);
+        rtka_tensor_free(loader->slots[s].labels);
+    }
+    free(loader->order);
+    if (loader->map) munmap(loader->map, loader->map_length);
+    free(loader);
+}
+
+/* ----------------------------------------------------------------------------
+ * Writing
+ * -------------------------------------------------------------------------- */
+
+static bool write_rows(FILE* f, const rtka_tensor_t* t, uint32_t num_samples, uint32_t width,
+                       rtka_state_t* row) {
+    for (uint32_t i = 0; i < num_samples; i++) {
+        load_row(row, t, i, width);
+        if (fwrite(row, sizeof(rtka_state_t), width, f) != width) return false;
+    }
+    return true;
+}
+
+static bool pad_to(FILE* f, uint64_t pos) {
+    static const uint8_t zeros[DATA_ALIGN] = {0};
+    long here = ftell(f);
+    if (here < 0 || (uint64_t)here > pos || pos - (uint64_t)here > DATA_ALIGN) return false;
+    size_t gap = (size_t)(pos - (uint64_t)here);
+    return fwrite(zeros, 1, gap, f) == gap;
+}
+
+rtka_error_t rtka_dataset_save(const rtka_dataset_t* data, const char* path) {
+    if (!data || !data->features || !data->labels || !path) return RTKA_ERROR_NULL_POINTER;
+    const rtka_tensor_t* x = data->features;
+    const rtka_tensor_t* y = data->labels;
+    if (x->ndim != 2 || (y->ndim != 1 && y->ndim != 2) || x->shape[0] == 0 ||
+        y->shape[0] != x->shape[0]) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    data_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DATA_MAGIC, sizeof(DATA_MAGIC));
+    h.version = RTKA_DATA_FILE_VERSION;
+    h.state_size = sizeof(rtka_state_t);
+    h.num_samples = x->shape[0];
+    h.num_features = x->shape[1];
+    h.label_width = y->ndim == 2 ? y->shape[1] : 1U;
+    h.num_classes = data->num_classes;
+    h.is_ternary = data->is_ternary;
+    h.features = DATA_ALIGN_UP(sizeof(data_header_t));
+    h.labels = DATA_ALIGN_UP(h.features + (uint64_t)h.num_samples * h.num_features * sizeof(rtka_state_t));
+
+    uint32_t widest = h.num_features > h.label_width ? h.num_features : h.label_width;
+    rtka_state_t* row = (rtka_state_t*)malloc((size_t)widest * sizeof(rtka_state_t));
+    if (!row) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    FILE* f = fopen(path, "wb");
+    bool ok = f && fwrite(&h, sizeof(h), 1, f) == 1 && pad_to(f, h.features) &&
+              write_rows(f, x, h.num_samples, h.num_features, row) && pad_to(f, h.labels) &&
+              write_rows(f, y, h.num_samples, h.label_width, row);
+    if (f) {
+        ok &= fclose(f) == 0;
+        if (!ok) remove(path);
+    }
+    free(row);
+    return ok ? RTKA_SUCCESS : RTKA_ERROR_INVALID_VALUE;
+}
@@ -0,0 +1,84 @@
+/**
+ * File: rtka_data_loader.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Data Loader - shuffled, prefetched mini-batches
+ *
+ * CHANGELOG:
+ * v1.0.0 - Each epoch shuffles a permutation of the sample indices and
+ *          gathers batch_size rows at a time into one of two preallocated
+ *          batches; the samples themselves never move. A background thread
+ *          gathers batch k + 1 while the consumer trains on batch k. The
+ *          source is an rtka_dataset_t in memory or a dataset file, mapped
+ *          read-only so datasets larger than memory page in as they are
+ *          gathered.
+ *
+ *   rtka_data_loader_t* loader;
+ *   if (rtka_data_loader_create(&loader, data, 64, seed, 0) == RTKA_SUCCESS) {
+ *       const rtka_data_batch_t* batch;
+ *       while (rtka_data_loader_next(loader, &batch) == RTKA_SUCCESS && batch) {
+ *           rtka_ml_train_batch(model, batch->features, batch->labels);
+ *       }
+ *       rtka_data_loader_free(loader);
+ *   }
+ *
+ * A dataset file is a 64-byte header, then the feature rows and the label
+ * rows as rtka_state_t AoS, each block 64-byte aligned (native byte order,
+ * like the model files). The dataset must not change while a loader uses it.
+ */
+
+#ifndef RTKA_DATA_LOADER_H
+#define RTKA_DATA_LOADER_H
+
+#include "rtka_ml.h"
+
+#define RTKA_DATA_FILE_VERSION      1U
+#define RTKA_DATA_LOADER_DEPTH      2U          /* Batches: one trained on, one gathered */
+
+#define RTKA_DATA_LOADER_SYNC       0x1U        /* Gather inside next(), no thread */
+#define RTKA_DATA_LOADER_ORDERED    0x2U        /* Dataset order, no shuffle */
+
+typedef struct {
+    rtka_tensor_t* features;    /* (rows, num_features) */
+    rtka_tensor_t* labels;      /* (rows, label width) */
+    uint32_t rows;              /* batch_size, fewer in an epoch's last batch */
+    uint32_t epoch;
+    uint32_t index;             /* Batch within the epoch */
+} rtka_data_batch_t;
+
+typedef struct rtka_data_loader rtka_data_loader_t;
+
+/* data->features is (num_samples, F), data->labels (num_samples) or
+ * (num_samples, L), either layout. seed fixes the shuffles, which do not
+ * depend on RTKA_DATA_LOADER_SYNC. */
+RTKA_NODISCARD rtka_error_t rtka_data_loader_create(rtka_data_loader_t** loader, const rtka_dataset_t* data,
+                                                    uint32_t batch_size, uint64_t seed, uint32_t flags);
+
+/* Same over a dataset file written by rtka_dataset_save */
+RTKA_NODISCARD rtka_error_t rtka_data_loader_open(rtka_data_loader_t** loader, const char* path,
+                                                  uint32_t batch_size, uint64_t seed, uint32_t flags);
+
+/* The next batch, waiting for the gathering thread if it is behind; *batch
+ * is NULL once at the end of every epoch, after which the next epoch
+ * starts reshuffled. The batch belongs to the loader and stays valid until
+ * the next call. */
+RTKA_NODISCARD rtka_error_t rtka_data_loader_next(rtka_data_loader_t* loader, const rtka_data_batch_t** batch);
+
+/* Batches per epoch, samples, and the row widths of a batch */
+uint32_t rtka_data_loader_batches(const rtka_data_loader_t* loader);
+uint32_t rtka_data_loader_samples(const rtka_data_loader_t* loader);
+uint32_t rtka_data_loader_features(const rtka_data_loader_t* loader);
+uint32_t rtka_data_loader_label_width(const rtka_data_loader_t* loader);
+
+void rtka_data_loader_free(rtka_data_loader_t* loader);
+
+/* Write data as a dataset file */
+RTKA_NODISCARD rtka_error_t rtka_dataset_save(const rtka_dataset_t* data, const char* path);
+
+#endif /* RTKA_DATA_LOADER_H */
@@ -0,0 +1,410 @@
+/**
+ * File: rtka_data_parallel.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Data Parallel Implementation
+ *
+ * A step is two pool loops. The first runs one replica per index: its
+ * shard's forward, loss and backward, then, when asked, the quantization
+ * of its gradient. The second runs over the reduce segments: each adds
+ * replicas 1 .. R-1 into the model's gradient (replica 0's) and clears
+ * them for the next step. The joins of the two loops are the only
+ * synchronization.
+ */
+
+#include "rtka_data_parallel.h"
+#include "rtka_memory.h"
+#include "rtka_constants.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* One replica: a network over the model's parameter tensors */
+typedef struct {
+    rtka_sequential_t network;          /* Replica 0: the model's own */
+    rtka_grad_node_t* params[RTKA_DP_MAX_PARAMS];
+    rtka_grad_tape_t* tape;
+    rtka_arena_t* arena;
+
+    /* This step's shard */
+    uint32_t row_begin;
+    uint32_t rows;
+    rtka_confidence_t loss;
+    rtka_error_t status;
+} rtka_dp_replica_t;
+
+/* Range [begin, end) of the gradient of one parameter */
+typedef struct {
+    uint32_t param;
+    uint32_t begin;
+    uint32_t end;
+} rtka_dp_segment_t;
+
+struct rtka_dp_trainer {
+    rtka_model_t* model;
+    rtka_thread_pool_t* pool;
+    rtka_dp_replica_t* replicas;
+    uint32_t num_replicas;
+    uint32_t param_count;
+    rtka_dp_segment_t* segments;
+    uint32_t num_segments;
+    uint32_t flags;
+    rtka_confidence_t quantize_threshold;
+
+    /* This step's batch */
+    rtka_tensor_t* features;
+    rtka_tensor_t* labels;
+};
+
+/* A parameter of a replica: the model's data tensor, a gradient of its own
+ * from the heap, so it outlives every step */
+static rtka_grad_node_t* replica_param(const rtka_grad_node_t* param) {
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    rtka_allocator_t* owner = NULL;
+    rtka_grad_node_t* node = (rtka_grad_node_t*)rtka_allocator_alloc(heap, sizeof(rtka_grad_node_t), &owner);
+    if (!node) return NULL;
+
+    *node = *param;
+    node->grad = rtka_tensor_create_in(heap, param->data->shape, param->data->ndim);
+    if (!node->grad) {
+        rtka_allocator_free(owner, node);
+        return NULL;
+    }
+    memset(node->grad->data, 0, node->grad->size * sizeof(rtka_state_t));
+    node->op = GRAD_OP_NONE;
+    node->inputs[0] = node->inputs[1] = NULL;
+    node->tape_index = UINT32_MAX;
+    node->grad_computed = false;
+    node->grad_pooled = false;
+    node->ref_count = 1;
+    node->saved_tensors[0] = node->saved_tensors[1] = NULL;
+    node->allocator = owner;
+    return node;
+}
+
+/* The data tensor is the model's and stays */
+static void replica_param_free(rtka_grad_node_t* node) {
+    if (!node) return;
+    rtka_tensor_free(node->grad);
+    rtka_allocator_free(node->allocator, node);
+}
+
+/* Copy of a layer with replica parameters; NULL for other layer types */
+static rtka_layer_t* replica_layer(const rtka_layer_t* layer) {
+    rtka_layer_t* copy = NULL;
+    if (layer->type == LAYER_LINEAR) {
+        rtka_linear_layer_t* linear = (rtka_linear_layer_t*)malloc(sizeof(rtka_linear_layer_t));
+        if (linear) *linear = *(const rtka_linear_layer_t*)layer;
+        copy = (rtka_layer_t*)linear;
+    } else if (layer->type == LAYER_TERNARY) {
+        rtka_ternary_layer_t* ternary = (rtka_ternary_layer_t*)malloc(sizeof(rtka_ternary_layer_t));
+        if (ternary) {
+            *ternary = *(const rtka_ternary_layer_t*)layer;
+            ternary->packed = NULL;
+        }
+        copy = (rtka_layer_t*)ternary;
+    }
+    if (!copy) return NULL;
+
+    copy->weight = layer->weight ? replica_param(layer->weight) : NULL;
+    copy->bias = layer->bias ? replica_param(layer->bias) : NULL;
+    if ((layer->weight && !copy->weight) || (layer->bias && !copy->bias)) {
+        replica_param_free(copy->weight);
+        replica_param_free(copy->bias);
+        free(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+static void replica_layer_free(rtka_layer_t* layer) {
+    if (!layer) return;
+    if (layer->type == LAYER_TERNARY) {
+        rtka_ternary_matrix_free(((rtka_ternary_layer_t*)layer)->packed);
+    }
+    replica_param_free(layer->weight);
+    replica_param_free(layer->bias);
+    free(layer);
+}
+
+/* Weight and bias nodes in layer order, the order rtka_ml steps them in */
+static uint32_t collect_params(const rtka_sequential_t* network, rtka_grad_node_t** params) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < network->num_layers; i++) {
+        rtka_layer_t* layer = network->layers[i];
+        if (layer->weight) params[count++] = layer->weight;
+        if (layer->bias) params[count++] = layer->bias;
+    }
+    return count;
+}
+
+/* Segments of at most RTKA_DP_SEGMENT states over every gradient */
+static rtka_error_t build_segments(rtka_dp_trainer_t* dp) {
+    const rtka_grad_node_t* const* params = (const rtka_grad_node_t* const*)dp->replicas[0].params;
+    uint32_t count = 0;
+    for (uint32_t p = 0; p < dp->param_count; p++) {
+        count += (params[p]->data->size + RTKA_DP_SEGMENT - 1U) / RTKA_DP_SEGMENT;
+    }
+
+    dp->segments = (rtka_dp_segment_t*)calloc(count ? count : 1U, sizeof(rtka_dp_segment_t));
+    if (!dp->segments) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    for (uint32_t p = 0; p < dp->param_count; p++) {
+        uint32_t size = params[p]->data->size;
+        for (uint32_t begin = 0; begin < size; begin += RTKA_DP_SEGMENT) {
+            uint32_t end = size - begin > RTKA_DP_SEGMENT ? begin + RTKA_DP_SEGMENT : size;
+            dp->segments[dp->num_segments++] = (rtka_dp_segment_t){p, begin, end};
+        }
+    }
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_dp_create(rtka_dp_trainer_t** trainer, rtka_model_t* model,
+                            rtka_thread_pool_t* pool, uint32_t replicas,
+                            uint32_t flags, rtka_confidence_t quantize_threshold) {
+    if (!trainer || !model) return RTKA_ERROR_NULL_POINTER;
+    *trainer = NULL;
+    if (!model->compiled || !model->network || !model->network->num_layers) return RTKA_ERROR_INVALID_VALUE;
+
+    rtka_sequential_t* network = model->network;
+    uint32_t param_count = 0;
+    for (uint32_t i = 0; i < network->num_layers; i++) {
+        rtka_layer_t* layer = network->layers[i];
+        if (layer->type != LAYER_LINEAR && layer->type != LAYER_TERNARY) return RTKA_ERROR_INVALID_VALUE;
+        param_count += (layer->weight != NULL) + (layer->bias != NULL);
+    }
+    if (param_count > RTKA_DP_MAX_PARAMS) return RTKA_ERROR_INVALID_VALUE;
+
+    if (!pool) pool = rtka_pool_default();
+    if (replicas == 0) replicas = rtka_pool_size(pool) + 1U;
+
+    rtka_dp_trainer_t* dp = (rtka_dp_trainer_t*)calloc(1, sizeof(rtka_dp_trainer_t));
+    if (!dp) return RTKA_ERROR_OUT_OF_MEMORY;
+    dp->model = model;
+    dp->pool = pool;
+    dp->flags = flags;
+    dp->quantize_threshold = quantize_threshold;
+    dp->param_count = param_count;
+    dp->replicas = (rtka_dp_replica_t*)calloc(replicas, sizeof(rtka_dp_replica_t));
+    if (!dp->replicas) {
+        free(dp);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Replica 0 trains the model in place, on its tape and arena */
+    rtka_dp_replica_t* first = &dp->replicas[0];
+    first->network = *network;
+    first->tape = model->tape;
+    first->arena = model->arena;
+    collect_params(network, first->params);
+    dp->num_replicas = 1;
+
+    for (uint32_t r = 1; r < replicas; r++) {
+        rtka_dp_replica_t* replica = &dp->replicas[r];
+        replica->network.layers = (rtka_layer_t**)calloc(network->num_layers, sizeof(rtka_layer_t*));
+        replica->tape = rtka_grad_tape_create();
+        replica->arena = rtka_arena_create(RTKA_STEP_ARENA_SIZE);
+        dp->num_replicas++;
+        if (!replica->network.layers || !replica->tape || !replica->arena) {
+            rtka_dp_free(dp);
+            return RTKA_ERROR_OUT_OF_MEMORY;
+        }
+
+        replica->network.capacity = network->num_layers;
+        for (uint32_t i = 0; i < network->num_layers; i++) {
+            rtka_layer_t* layer = replica_layer(network->layers[i]);
+            if (!layer) {
+                rtka_dp_free(dp);
+                return RTKA_ERROR_OUT_OF_MEMORY;
+            }
+            replica->network.layers[replica->network.num_layers++] = layer;
+        }
+        collect_params(&replica->network, replica->params);
+    }
+
+    rtka_error_t err = build_segments(dp);
+    if (err != RTKA_SUCCESS) {
+        rtka_dp_free(dp);
+        return err;
+    }
+
+    *trainer = dp;
+    return RTKA_SUCCESS;
+}
+
+void rtka_dp_free(rtka_dp_trainer_t* trainer) {
+    if (!trainer) return;
+
+    /* Replica 0 is the model's */
+    for (uint32_t r = 1; r < trainer->num_replicas; r++) {
+        rtka_dp_replica_t* replica = &trainer->replicas[r];
+        for (uint32_t i = 0; i < replica->network.num_layers; i++) {
+            replica_layer_free(replica->network.layers[i]);
+        }
+        free(replica->network.layers);
+        if (replica->tape) rtka_grad_tape_free(replica->tape);
+        rtka_arena_destroy(replica->arena);
+    }
+    free(trainer->replicas);
+    free(trainer->segments);
+    free(trainer);
+}
+
+uint32_t rtka_dp_replicas(const rtka_dp_trainer_t* trainer) {
+    return trainer ? trainer->num_replicas : 0U;
+}
+
+/* Rows [row_begin, row_begin + rows) of a (rows, W) or (rows) tensor, a
+ * header in the current step arena */
+static rtka_tensor_t* shard_rows(rtka_tensor_t* tensor, uint32_t batch_rows,
+                                 uint32_t row_begin, uint32_t rows) {
+    uint32_t width = tensor->size / batch_rows;
+    uint32_t shape[2] = {rows, width};
+    return rtka_tensor_wrap(tensor->data + (size_t)row_begin * width, shape, tensor->ndim == 1 ? 1U : 2U);
+}
+
+/* Forward, loss and backward of one shard, as train_step in rtka_ml.c */
+static void replica_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    rtka_dp_trainer_t* dp = (rtka_dp_trainer_t*)ctx;
+    uint32_t batch_rows = dp->features->shape[0];
+
+    for (uint32_t r = begin; r < end; r++) {
+        rtka_dp_replica_t* replica = &dp->replicas[r];
+        replica->loss = 0.0f;
+        replica->status = RTKA_SUCCESS;
+        if (replica->rows == 0) continue;
+
+        rtka_arena_begin_step(replica->arena);
+        rtka_tensor_t* features = shard_rows(dp->features, batch_rows, replica->row_begin, replica->rows);
+        rtka_tensor_t* labels = shard_rows(dp->labels, batch_rows, replica->row_begin, replica->rows);
+
+        rtka_grad_tape_begin(replica->tape);
+        rtka_grad_node_t* input = features ? rtka_grad_node_create(features, false) : NULL;
+        rtka_grad_node_t* output = input ? rtka_nn_sequential_forward(&replica->network, input) : NULL;
+        if (output && labels) {
+            rtka_model_type_t type = dp->model->type;
+            replica->loss = (type == MODEL_CLASSIFIER || type == MODEL_TERNARY_NET)
+                          ? rtka_nn_ternary_cross_entropy(output, labels)
+                          : rtka_nn_ternary_mse(output, labels);
+            rtka_grad_backward(output);
+        } else {
+            replica->status = RTKA_ERROR_OUT_OF_MEMORY;
+        }
+        rtka_grad_tape_end(replica->tape);
+        rtka_arena_end_step(replica->arena);
+
+        /* What this replica puts on the wire */
+        if (replica->status == RTKA_SUCCESS && (dp->flags & RTKA_DP_QUANTIZE_GRADIENTS)) {
+            for (uint32_t p = 0; p < dp->param_count; p++) {
+                if (replica->params[p]->grad) {
+                    rtka_optimizer_quantize_gradients(replica->params[p]->grad, dp->quantize_threshold);
+                }
+            }
+        }
+    }
+}
+
+/* Sum the replica gradients of each segment into replica 0, in replica
+ * order, and clear them */
+static void reduce_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    rtka_dp_trainer_t* dp = (rtka_dp_trainer_t*)ctx;
+
+    for (uint32_t s = begin; s < end; s++) {
+        const rtka_dp_segment_t* seg = &dp->segments[s];
+        rtka_tensor_t* sum = dp->replicas[0].params[seg->param]->grad;
+        if (!sum) continue;
+
+        for (uint32_t r = 1; r < dp->num_replicas; r++) {
+            rtka_tensor_t* grad = dp->replicas[r].params[seg->param]->grad;
+            for (uint32_t i = seg->begin; i < seg->end; i++) {
+                sum->data[i].confidence += grad->data[i].confidence;
+            }
+            memset(grad->data + seg->begin, 0, (size_t)(seg->end - seg->begin) * sizeof(rtka_state_t));
+        }
+    }
+}
+
+/* Clear replicas 1 .. R-1 after a failed step */
+static void clear_replicas(rtka_dp_trainer_t* dp) {
+    for (uint32_t r = 1; r < dp->num_replicas; r++) {
+        for (uint32_t p = 0; p < dp->param_count; p++) {
+            rtka_grad_zero(dp->replicas[r].params[p]);
+        }
+    }
+}
+
+rtka_error_t rtka_dp_train_batch(rtka_dp_trainer_t* trainer,
+                                 rtka_tensor_t* batch_features,
+                                 rtka_tensor_t* batch_labels,
+                                 rtka_confidence_t* loss) {
+    if (!trainer || !batch_features || !batch_labels) return RTKA_ERROR_NULL_POINTER;
+    if (batch_features->ndim != 2 || !batch_features->data || !batch_labels->data ||
+        batch_features->shape[0] == 0 || batch_labels->size % batch_features->shape[0] != 0) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    rtka_dp_trainer_t* dp = trainer;
+    rtka_model_t* model = dp->model;
+    uint32_t rows = batch_features->shape[0];
+    dp->features = batch_features;
+    dp->labels = batch_labels;
+
+    /* Contiguous shards, the first rows % R one row longer */
+    uint32_t base = rows / dp->num_replicas;
+    uint32_t extra = rows % dp->num_replicas;
+    uint32_t row = 0;
+    for (uint32_t r = 0; r < dp->num_replicas; r++) {
+        dp->replicas[r].row_begin = row;
+        dp->replicas[r].rows = base + (r < extra ? 1U : 0U);
+        row += dp->replicas[r].rows;
+    }
+
+    rtka_pool_parallel_for(dp->pool, 0, dp->num_replicas, 1, replica_range, dp);
+
+    rtka_confidence_t total = 0.0f;
+    rtka_error_t status = RTKA_SUCCESS;
+    for (uint32_t r = 0; r < dp->num_replicas; r++) {
+        if (dp->replicas[r].status != RTKA_SUCCESS) status = dp->replicas[r].status;
+        total += dp->replicas[r].loss * (rtka_confidence_t)dp->replicas[r].rows;
+    }
+
+    rtka_grad_node_t** params = dp->replicas[0].params;
+    if (status != RTKA_SUCCESS) {
+        clear_replicas(dp);
+        rtka_optimizer_zero_grad(model->optimizer, params, dp->param_count);
+        return status;
+    }
+
+    rtka_pool_parallel_for(dp->pool, 0, dp->num_segments, 0, reduce_range, dp);
+
+    rtka_optimizer_step(model->optimizer, params, dp->param_count);
+    rtka_optimizer_zero_grad(model->optimizer, params, dp->param_count);
+    model->trained = true;
+
+    if (loss) *loss = total / (rtka_confidence_t)rows;
+    return RTKA_SUCCESS;
+}
+
+/* Step of rtka_ml_fit_loader_with; a failed step counts as zero loss */
+static rtka_confidence_t dp_step(void* ctx, rtka_tensor_t* batch_features, rtka_tensor_t* batch_labels) {
+    rtka_confidence_t loss = 0.0f;
+    if (rtka_dp_train_batch((rtka_dp_trainer_t*)ctx, batch_features, batch_labels, &loss) != RTKA_SUCCESS) {
+        return 0.0f;
+    }
+    return loss;
+}
+
+void rtka_dp_fit_loader(rtka_dp_trainer_t* trainer,
+                        rtka_data_loader_t* loader,
+                        rtka_dataset_t* val_data,
+                        rtka_training_config_t* config) {
+    if (!trainer) return;
+    rtka_ml_fit_loader_with(trainer->model, loader, val_data, config, dp_step, trainer);
+}
@@ -0,0 +1,79 @@
+/**
+ * File: rtka_data_parallel.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Data Parallel - one model trained by several replicas at once
+ *
+ * CHANGELOG:
+ * v1.0.0 - Every step splits the batch into contiguous row shards, one per
+ *          replica, and runs forward, loss and backward of all shards on
+ *          the pool, each replica on its own tape and step arena. The
+ *          replicas share the model's parameter tensors and own only their
+ *          gradients. The gradients are then all-reduced: the flattened
+ *          gradient is cut into segments and each participant sums its
+ *          segments over the replicas into the model's gradient (the
+ *          reduce-scatter half of a ring all-reduce; the all-gather half is
+ *          free, since every replica reads the same parameters). The
+ *          model's optimizer then takes one step.
+ *
+ *   rtka_dp_trainer_t* dp;
+ *   if (rtka_dp_create(&dp, model, NULL, 0, 0, 0.0f) == RTKA_SUCCESS) {
+ *       rtka_dp_fit_loader(dp, loader, val_data, &config);
+ *       rtka_dp_free(dp);
+ *   }
+ *
+ * Replica 0 is the model itself, so one replica steps exactly like
+ * rtka_ml_train_batch. Gradients are summed over the shards in replica
+ * order, whichever thread finishes first, so a step does not depend on
+ * the scheduling; against one replica it differs by float rounding only.
+ * With RTKA_DP_QUANTIZE_GRADIENTS each replica compresses its gradient
+ * with rtka_optimizer_quantize_gradients before the exchange. Only
+ * LAYER_LINEAR and LAYER_TERNARY networks replicate.
+ */
+
+#ifndef RTKA_DATA_PARALLEL_H
+#define RTKA_DATA_PARALLEL_H
+
+#include "rtka_ml.h"
+#include "rtka_threadpool.h"
+
+#define RTKA_DP_MAX_PARAMS          128U        /* Weight and bias nodes per model */
+#define RTKA_DP_SEGMENT             4096U       /* Gradient states per reduce segment */
+
+#define RTKA_DP_QUANTIZE_GRADIENTS  0x1U        /* Ternary gradient exchange */
+
+typedef struct rtka_dp_trainer rtka_dp_trainer_t;
+
+/* pool NULL = rtka_pool_default(), replicas 0 = one per pool participant.
+ * quantize_threshold is rtka_optimizer_quantize_gradients' threshold, read
+ * only with RTKA_DP_QUANTIZE_GRADIENTS. The model must be compiled and
+ * outlive the trainer. */
+RTKA_NODISCARD rtka_error_t rtka_dp_create(rtka_dp_trainer_t** trainer, rtka_model_t* model,
+                                           rtka_thread_pool_t* pool, uint32_t replicas,
+                                           uint32_t flags, rtka_confidence_t quantize_threshold);
+
+/* One optimizer step on a caller-owned AoS batch, like rtka_ml_train_batch;
+ * *loss (may be NULL) is the row-weighted mean of the shard losses. On an
+ * error no parameter changes. */
+RTKA_NODISCARD rtka_error_t rtka_dp_train_batch(rtka_dp_trainer_t* trainer,
+                                                rtka_tensor_t* batch_features,
+                                                rtka_tensor_t* batch_labels,
+                                                rtka_confidence_t* loss);
+
+/* rtka_ml_fit_loader with every batch stepped by rtka_dp_train_batch */
+void rtka_dp_fit_loader(rtka_dp_trainer_t* trainer,
+                        rtka_data_loader_t* loader,
+                        rtka_dataset_t* val_data,
+                        rtka_training_config_t* config);
+
+uint32_t rtka_dp_replicas(const rtka_dp_trainer_t* trainer);
+
+void rtka_dp_free(rtka_dp_trainer_t* trainer);
+
+#endif /* RTKA_DATA_PARALLEL_H */
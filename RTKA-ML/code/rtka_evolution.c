@@ -1,7 +1,7 @@
 /**
  * File: rtka_evolution.c
  * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
- * 
+ *
  * PROPRIETARY AND CONFIDENTIAL
  * This file is proprietary to H. Overman and may not be reproduced,
  * distributed, or used without explicit written permission.
@@ -14,115 +14,230 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define MAILBOX_BATCHES  2U     /* Migration events an inbox holds */
+
+/* Single producer (the ring predecessor), single consumer (the owner).
+ * Slot k holds the genes of migrant k % capacity; tail publishes written
+ * slots, head releases read ones. */
+struct rtka_island_mailbox {
+    RTKA_ALIGNED(64) _Atomic uint64_t head;
+    RTKA_ALIGNED(64) _Atomic uint64_t tail;
+    RTKA_ALIGNED(64) uint32_t capacity;
+    uint32_t length;
+    rtka_state_t* genes;        /* capacity x length */
+    rtka_confidence_t* fitness;
+};
+
+static void cache_free(rtka_fitness_cache_t* cache);
+static void nsga_free(rtka_nsga2_state_t* state);
+
+/* Chromosome and genes in one block */
+static rtka_chromosome_t* chromosome_create(uint32_t length) {
+    rtka_chromosome_t* chrom = (rtka_chromosome_t*)calloc(1, sizeof(rtka_chromosome_t) +
+                                                          (size_t)length * sizeof(rtka_state_t));
+    if (!chrom) return NULL;
+    chrom->genes = (rtka_state_t*)(chrom + 1);
+    chrom->length = length;
+    return chrom;
+}
 
-/* Create population */
+void rtka_evolution_free_chromosome(rtka_chromosome_t* chrom) {
+    free(chrom);
+}
+
+static rtka_state_t* gene_matrix(uint32_t rows, uint32_t length) {
+    size_t bytes = (size_t)(rows ? rows : 1U) * (length ? length : 1U) * sizeof(rtka_state_t);
+    rtka_state_t* genes = (rtka_state_t*)aligned_alloc(64, (bytes + 63U) & ~(size_t)63U);
+    if (genes) memset(genes, 0, bytes);
+    return genes;
+}
+
+/* Create population: two gene matrices, a record per row of each, and the
+ * pointer arrays over the two sets of records */
 rtka_population_t* rtka_evolution_create_population(uint32_t pop_size, uint32_t gene_length) {
-    rtka_population_t* pop = (rtka_population_t*)rtka_alloc_state();
+    rtka_population_t* pop = (rtka_population_t*)calloc(1, sizeof(rtka_population_t));
     if (!pop) return NULL;
-    
+
     pop->size = pop_size;
     pop->generation = 0;
     pop->mutation_rate = 0.01f;
     pop->crossover_rate = 0.7f;
     pop->elite_ratio = 0.1f;
-    
-    pop->individuals = (rtka_chromosome_t**)rtka_alloc_states(
-        pop_size * sizeof(void*) / sizeof(rtka_state_t));
-    
+    pop->gene_length = gene_length;
+    rtka_random_init_splitmix(&pop->rng, rtka_random_next(rtka_random_thread()));
+
+    uint32_t slots = pop_size ? pop_size : 1U;
+    pop->individuals = (rtka_chromosome_t**)calloc(slots, sizeof(rtka_chromosome_t*));
+    pop->spare = (rtka_chromosome_t**)calloc(slots, sizeof(rtka_chromosome_t*));
+    pop->records = (rtka_chromosome_t*)calloc(2U * (size_t)slots, sizeof(rtka_chromosome_t));
+    pop->scores = (rtka_confidence_t*)calloc(slots, sizeof(rtka_confidence_t));
+    pop->genes = gene_matrix(pop_size, gene_length);
+    pop->spare_genes = gene_matrix(pop_size, gene_length);
+    if (!pop->individuals || !pop->spare || !pop->records || !pop->scores || !pop->genes || !pop->spare_genes) {
+        rtka_evolution_free_population(pop);
+        return NULL;
+    }
+
     for (uint32_t i = 0; i < pop_size; i++) {
-        pop->individuals[i] = (rtka_chromosome_t*)rtka_alloc_state();
-        pop->individuals[i]->genes = rtka_alloc_states(gene_length);
-        pop->individuals[i]->length = gene_length;
-        pop->individuals[i]->fitness = 0.0f;
-        pop->individuals[i]->age = 0;
+        rtka_chromosome_t* live = &pop->records[i];
+        rtka_chromosome_t* next = &pop->records[pop_size + i];
+        live->genes = pop->genes + (size_t)i * gene_length;
+        next->genes = pop->spare_genes + (size_t)i * gene_length;
+        live->length = next->length = gene_length;
+        pop->individuals[i] = live;
+        pop->spare[i] = next;
     }
-    
+
     return pop;
 }
 
+void rtka_evolution_free_population(rtka_population_t* pop) {
+    if (!pop) return;
+    free(pop->individuals);
+    free(pop->spare);
+    free(pop->records);
+    free(pop->scores);
+    free(pop->genes);
+    free(pop->spare_genes);
+    cache_free(pop->cache);
+    nsga_free(pop->nsga);
+    free(pop);
+}
+
+/* The spare generation becomes current. Its records were written in row
+ * order, so individuals is the identity again; spare is reset to it too. */
+static void swap_generations(rtka_population_t* pop) {
+    rtka_chromosome_t** individuals = pop->spare;
+    pop->spare = pop->individuals;
+    pop->individuals = individuals;
+
+    rtka_state_t* genes = pop->spare_genes;
+    pop->spare_genes = pop->genes;
+    pop->genes = genes;
+
+    rtka_chromosome_t* spare_records = pop->individuals[0] == pop->records ? pop->records + pop->size : pop->records;
+    for (uint32_t i = 0; i < pop->size; i++) pop->spare[i] = spare_records + i;
+}
+
+/* Copy the first count of individuals, in their current order, to the
+ * first count rows of the spare generation */
+static void copy_to_spare(rtka_population_t* pop, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        const rtka_chromosome_t* from = pop->individuals[i];
+        rtka_chromosome_t* to = pop->spare[i];
+        memcpy(to->genes, from->genes, (size_t)pop->gene_length * sizeof(rtka_state_t));
+        to->fitness = from->fitness;
+        to->age = from->age;
+    }
+}
+
 /* Initialize with random ternary genes */
 void rtka_evolution_initialize_random(rtka_population_t* pop) {
     for (uint32_t i = 0; i < pop->size; i++) {
         rtka_chromosome_t* chrom = pop->individuals[i];
-        
+
         for (uint32_t g = 0; g < chrom->length; g++) {
-            float r = rtka_random_float();
+            float r = rtka_random_uniform(&pop->rng);
             if (r < 0.333f) {
-                chrom->genes[g] = rtka_make_state(RTKA_FALSE, rtka_random_float());
+                chrom->genes[g] = rtka_make_state(RTKA_FALSE, rtka_random_uniform(&pop->rng));
             } else if (r < 0.667f) {
                 chrom->genes[g] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
             } else {
-                chrom->genes[g] = rtka_make_state(RTKA_TRUE, rtka_random_float());
+                chrom->genes[g] = rtka_make_state(RTKA_TRUE, rtka_random_uniform(&pop->rng));
             }
         }
     }
 }
 
-/* Ternary crossover */
-rtka_chromosome_t* rtka_evolution_crossover(const rtka_chromosome_t* parent1,
-                                           const rtka_chromosome_t* parent2,
-                                           rtka_confidence_t rate) {
-    if (rtka_random_float() > rate) {
+/* Ternary crossover into an existing child of the same length */
+static void crossover_into(rtka_chromosome_t* child, const rtka_chromosome_t* parent1,
+                           const rtka_chromosome_t* parent2, rtka_confidence_t rate, rtka_rng_t* rng) {
+    child->age = 0;
+    child->fitness = 0.0f;
+
+    if (rtka_random_uniform(rng) > rate) {
         /* Clone parent1 */
-        rtka_chromosome_t* child = (rtka_chromosome_t*)rtka_alloc_state();
-        child->genes = rtka_alloc_states(parent1->length);
-        child->length = parent1->length;
         memcpy(child->genes, parent1->genes, parent1->length * sizeof(rtka_state_t));
-        return child;
+        return;
     }
-    
-    rtka_chromosome_t* child = (rtka_chromosome_t*)rtka_alloc_state();
-    child->genes = rtka_alloc_states(parent1->length);
-    child->length = parent1->length;
-    child->age = 0;
-    
+
     /* Ternary crossover: use UNKNOWN states as crossover points */
     for (uint32_t i = 0; i < parent1->length; i++) {
-        if (parent1->genes[i].value == RTKA_UNKNOWN || 
+        if (parent1->genes[i].value == RTKA_UNKNOWN ||
             parent2->genes[i].value == RTKA_UNKNOWN) {
             /* Crossover point - blend confidences */
             rtka_state_t blended = rtka_combine_or(parent1->genes[i], parent2->genes[i]);
             child->genes[i] = blended;
-        } else if (rtka_random_float() < 0.5f) {
+        } else if (rtka_random_uniform(rng) < 0.5f) {
             child->genes[i] = parent1->genes[i];
         } else {
             child->genes[i] = parent2->genes[i];
         }
     }
-    
+}
+
+rtka_chromosome_t* rtka_evolution_crossover(const rtka_chromosome_t* parent1,
+                                           const rtka_chromosome_t* parent2,
+                                           rtka_confidence_t rate) {
+    rtka_chromosome_t* child = chromosome_create(parent1->length);
+    if (!child) return NULL;
+    crossover_into(child, parent1, parent2, rate, rtka_random_thread());
     return child;
 }
 
-/* Mutate chromosome */
-void rtka_evolution_mutate(rtka_chromosome_t* chrom, rtka_confidence_t rate) {
+/* rtka_mutate_ternary on a given RNG */
+static void mutate_with(rtka_chromosome_t* chrom, rtka_confidence_t rate, rtka_rng_t* rng) {
     for (uint32_t i = 0; i < chrom->length; i++) {
-        if (rtka_random_float() < rate) {
-            rtka_mutate_ternary(&chrom->genes[i]);
+        if (rtka_random_uniform(rng) >= rate) continue;
+        rtka_state_t* gene = &chrom->genes[i];
+
+        /* Rotate through ternary states */
+        switch (gene->value) {
+            case RTKA_FALSE:
+                gene->value = RTKA_UNKNOWN;
+                gene->confidence *= 0.5f;
+                break;
+            case RTKA_UNKNOWN:
+                gene->value = (rtka_random_uniform(rng) > 0.5f) ? RTKA_TRUE : RTKA_FALSE;
+                gene->confidence = rtka_random_uniform(rng);
+                break;
+            case RTKA_TRUE:
+                gene->value = RTKA_FALSE;
+                gene->confidence *= 0.5f;
+                break;
         }
     }
 }
 
+/* Mutate chromosome */
+void rtka_evolution_mutate(rtka_chromosome_t* chrom, rtka_confidence_t rate) {
+    mutate_with(chrom, rate, rtka_random_thread());
+}
+
 /* Tournament selection */
 rtka_chromosome_t* rtka_evolution_select(rtka_population_t* pop,
                                         rtka_selection_t method,
                                         uint32_t tournament_size) {
     switch (method) {
         case SELECT_TOURNAMENT: {
-            rtka_chromosome_t* best = pop->individuals[rand() % pop->size];
-            
+            rtka_chromosome_t* best = pop->individuals[rtka_random_uint32(&pop->rng) % pop->size];
+
             for (uint32_t i = 1; i < tournament_size; i++) {
-                rtka_chromosome_t* competitor = pop->individuals[rand() % pop->size];
+                rtka_chromosome_t* competitor = pop->individuals[rtka_random_uint32(&pop->rng) % pop->size];
                 if (competitor->fitness > best->fitness) {
                     best = competitor;
                 }
             }
             return best;
         }
-        
+
         case SELECT_TERNARY: {
             /* Ternary selection based on state values */
             uint32_t true_count = 0, false_count = 0, unknown_count = 0;
-            
+
             for (uint32_t i = 0; i < pop->size; i++) {
                 rtka_state_t first_gene = pop->individuals[i]->genes[0];
                 switch (first_gene.value) {
@@ -131,7 +246,7 @@ rtka_chromosome_t* rtka_evolution_select(rtka_population_t* pop,
                     case RTKA_UNKNOWN: unknown_count++; break;
                 }
             }
-            
+
             /* Select from dominant group */
             rtka_value_t target;
             if (true_count >= false_count && true_count >= unknown_count) {
@@ -141,7 +256,7 @@ rtka_chromosome_t* rtka_evolution_select(rtka_population_t* pop,
             } else {
                 target = RTKA_UNKNOWN;
             }
-            
+
             for (uint32_t i = 0; i < pop->size; i++) {
                 if (pop->individuals[i]->genes[0].value == target) {
                     return pop->individuals[i];
@@ -149,108 +264,1174 @@ rtka_chromosome_t* rtka_evolution_select(rtka_population_t* pop,
             }
             break;
         }
-        
+
         default:
-            return pop->individuals[rand() % pop->size];
+            return pop->individuals[rtka_random_uint32(&pop->rng) % pop->size];
     }
-    
+
     return pop->individuals[0];
 }
 
-/* Evolution step */
-void rtka_evolution_step(rtka_population_t* pop,
-                        rtka_fitness_fn fitness,
-                        rtka_selection_t selection) {
-    /* Evaluate fitness */
+typedef struct {
+    rtka_population_t* pop;
+    rtka_fitness_fn fitness;
+    rtka_batch_fitness_fn batch;
+    const uint32_t* rows;       /* Individuals to score (NULL = all, in order) */
+    const rtka_state_t* genes;  /* Their rows, consecutive, for batch */
+} evaluate_ctx_t;
+
+/* Scores of the chosen individuals begin .. end - 1 into pop->scores */
+static void evaluate_range(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const evaluate_ctx_t* ctx = (const evaluate_ctx_t*)arg;
+    rtka_population_t* pop = ctx->pop;
+    if (ctx->batch) {
+        uint32_t length = pop->gene_length;
+        ctx->batch(ctx->genes + (size_t)begin * length, end - begin, length, pop->scores + begin);
+        return;
+    }
+    for (uint32_t k = begin; k < end; k++) {
+        pop->scores[k] = ctx->fitness(pop->individuals[ctx->rows ? ctx->rows[k] : k]);
+    }
+}
+
+/* ============================================================================
+ * FITNESS CACHE
+ * Linear probing over genome hashes, at most CACHE_PROBES slots from the
+ * home slot; a full window overwrites its home slot, so the cache keeps
+ * the recent genomes. Distinct genomes are told apart by their 64-bit hash
+ * alone. While a generation is being scored, an entry for a genome not yet
+ * evaluated is pending and names the miss that will score it, so
+ * duplicate offspring share one evaluation.
+ * ============================================================================ */
+
+#define CACHE_PROBES     8U
+
+typedef struct {
+    uint64_t key;               /* Genome hash, 0 = empty */
+    rtka_confidence_t fitness;
+    uint32_t pending;           /* Miss index + 1 while unscored */
+} cache_entry_t;
+
+struct rtka_fitness_cache {
+    cache_entry_t* entries;
+    uint32_t mask;
+    uint64_t hits;
+    uint64_t misses;
+    uint32_t* share;            /* Per individual: miss whose score it takes, or UINT32_MAX */
+    uint32_t* rows;             /* Per miss: its individual */
+    uint64_t* keys;             /* Per miss: its genome hash */
+};
+
+/* Word-at-a-time FNV-1a over the genes, finished with the splitmix mix */
+static uint64_t genome_hash(const rtka_state_t* genes, uint32_t length) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (uint32_t g = 0; g < length; g++) {
+        uint64_t word;
+        memcpy(&word, &genes[g], sizeof(word));
+        h = (h ^ word) * 0x100000001B3ULL;
+    }
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h ? h : 1U;
+}
+
+static cache_entry_t* cache_find(rtka_fitness_cache_t* cache, uint64_t key) {
+    uint32_t home = (uint32_t)(key ^ (key >> 32)) & cache->mask;
+    for (uint32_t p = 0; p < CACHE_PROBES; p++) {
+        cache_entry_t* entry = &cache->entries[(home + p) & cache->mask];
+        if (entry->key == key) return entry;
+        if (!entry->key) return NULL;
+    }
+    return NULL;
+}
+
+static void cache_store(rtka_fitness_cache_t* cache, uint64_t key, rtka_confidence_t fitness, uint32_t pending) {
+    uint32_t home = (uint32_t)(key ^ (key >> 32)) & cache->mask;
+    cache_entry_t* entry = &cache->entries[home];
+    for (uint32_t p = 0; p < CACHE_PROBES; p++) {
+        cache_entry_t* probe = &cache->entries[(home + p) & cache->mask];
+        if (!probe->key || probe->key == key) {
+            entry = probe;
+            break;
+        }
+    }
+    *entry = (cache_entry_t){ key, fitness, pending };
+}
+
+static void cache_free(rtka_fitness_cache_t* cache) {
+    if (!cache) return;
+    free(cache->entries);
+    free(cache->share);
+    free(cache->rows);
+    free(cache->keys);
+    free(cache);
+}
+
+rtka_error_t rtka_evolution_enable_cache(rtka_population_t* pop, uint32_t capacity) {
+    if (!pop) return RTKA_ERROR_NULL_POINTER;
+    if (capacity == 0) capacity = 4U * pop->size;
+    if (capacity > (1U << 30)) return RTKA_ERROR_INVALID_VALUE;
+    uint32_t slots = CACHE_PROBES;
+    while (slots < capacity) slots <<= 1;
+
+    rtka_fitness_cache_t* cache = (rtka_fitness_cache_t*)calloc(1, sizeof(rtka_fitness_cache_t));
+    if (!cache) return RTKA_ERROR_OUT_OF_MEMORY;
+    uint32_t rows = pop->size ? pop->size : 1U;
+    cache->entries = (cache_entry_t*)calloc(slots, sizeof(cache_entry_t));
+    cache->share = (uint32_t*)malloc(rows * sizeof(uint32_t));
+    cache->rows = (uint32_t*)malloc(rows * sizeof(uint32_t));
+    cache->keys = (uint64_t*)malloc(rows * sizeof(uint64_t));
+    if (!cache->entries || !cache->share || !cache->rows || !cache->keys) {
+        cache_free(cache);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    cache->mask = slots - 1U;
+
+    cache_free(pop->cache);
+    pop->cache = cache;
+    return RTKA_SUCCESS;
+}
+
+void rtka_evolution_disable_cache(rtka_population_t* pop) {
+    if (!pop) return;
+    cache_free(pop->cache);
+    pop->cache = NULL;
+}
+
+void rtka_evolution_cache_stats(const rtka_population_t* pop, uint64_t* hits, uint64_t* misses) {
+    const rtka_fitness_cache_t* cache = pop ? pop->cache : NULL;
+    if (hits) *hits = cache ? cache->hits : 0;
+    if (misses) *misses = cache ? cache->misses : 0;
+}
+
+/* Score ctx's rows (count of them), serially when pool is NULL */
+static void evaluate_rows(evaluate_ctx_t* ctx, uint32_t count, rtka_thread_pool_t* pool) {
+    if (count == 0) return;
+    if (pool) {
+        rtka_pool_parallel_for(pool, 0, count, 0, evaluate_range, ctx);
+    } else {
+        evaluate_range(ctx, 0, count, 0);
+    }
+}
+
+/* Look every individual up, score the misses once per distinct genome,
+ * batch rows gathered into the spare matrix, and remember the new scores */
+static void evaluate_cached(rtka_population_t* pop, evaluate_ctx_t* ctx, rtka_thread_pool_t* pool) {
+    rtka_fitness_cache_t* cache = pop->cache;
+    uint32_t length = pop->gene_length, misses = 0;
+
     for (uint32_t i = 0; i < pop->size; i++) {
-        pop->individuals[i]->fitness = fitness(pop->individuals[i]);
-        pop->individuals[i]->age++;
-    }
-    
-    /* Sort by fitness */
-    for (uint32_t i = 0; i < pop->size - 1; i++) {
-        for (uint32_t j = i + 1; j < pop->size; j++) {
-            if (pop->individuals[j]->fitness > pop->individuals[i]->fitness) {
-                rtka_chromosome_t* temp = pop->individuals[i];
-                pop->individuals[i] = pop->individuals[j];
-                pop->individuals[j] = temp;
+        rtka_chromosome_t* chrom = pop->individuals[i];
+        uint64_t key = genome_hash(chrom->genes, length);
+        cache_entry_t* entry = cache_find(cache, key);
+        if (entry && !entry->pending) {
+            chrom->fitness = entry->fitness;
+            cache->share[i] = UINT32_MAX;
+            cache->hits++;
+        } else if (entry) {
+            cache->share[i] = entry->pending - 1U;
+            cache->hits++;
+        } else {
+            cache->share[i] = misses;
+            cache->rows[misses] = i;
+            cache->keys[misses] = key;
+            cache_store(cache, key, 0.0f, misses + 1U);
+            if (ctx->batch) {
+                memcpy(pop->spare_genes + (size_t)misses * length, chrom->genes, (size_t)length * sizeof(rtka_state_t));
             }
+            misses++;
+            cache->misses++;
         }
     }
-    
-    /* New generation */
-    rtka_chromosome_t** new_pop = (rtka_chromosome_t**)rtka_alloc_states(
-        pop->size * sizeof(void*) / sizeof(rtka_state_t));
-    
-    /* Elitism */
-    uint32_t elite_count = (uint32_t)(pop->size * pop->elite_ratio);
-    for (uint32_t i = 0; i < elite_count; i++) {
-        new_pop[i] = pop->individuals[i];
+
+    ctx->rows = cache->rows;
+    ctx->genes = pop->spare_genes;
+    evaluate_rows(ctx, misses, pool);
+
+    for (uint32_t i = 0; i < pop->size; i++) {
+        if (cache->share[i] != UINT32_MAX) pop->individuals[i]->fitness = pop->scores[cache->share[i]];
     }
-    
-    /* Generate offspring */
+    for (uint32_t k = 0; k < misses; k++) {
+        cache_entry_t* entry = cache_find(cache, cache->keys[k]);
+        if (entry) {
+            entry->fitness = pop->scores[k];
+            entry->pending = 0;
+        } else {
+            cache_store(cache, cache->keys[k], pop->scores[k], 0);
+        }
+    }
+}
+
+/* Best first; ties are broken on the genes so the order depends only on
+ * the population's contents */
+static int compare_fitness(const void* a, const void* b) {
+    const rtka_chromosome_t* x = *(const rtka_chromosome_t* const*)a;
+    const rtka_chromosome_t* y = *(const rtka_chromosome_t* const*)b;
+    if (x->fitness != y->fitness) return x->fitness > y->fitness ? -1 : 1;
+    int genes = memcmp(x->genes, y->genes, x->length * sizeof(rtka_state_t));
+    if (genes != 0) return genes;
+    return (x->age > y->age) - (x->age < y->age);
+}
+
+/* Evaluate, serially when pool is NULL, then sort the pointers best first */
+static void evaluate_and_sort(rtka_population_t* pop, evaluate_ctx_t* ctx, rtka_thread_pool_t* pool) {
+    if (pop->cache) {
+        evaluate_cached(pop, ctx, pool);
+    } else {
+        ctx->rows = NULL;
+        ctx->genes = pop->genes;
+        evaluate_rows(ctx, pop->size, pool);
+        for (uint32_t i = 0; i < pop->size; i++) pop->individuals[i]->fitness = pop->scores[i];
+    }
+    for (uint32_t i = 0; i < pop->size; i++) pop->individuals[i]->age++;
+    qsort(pop->individuals, pop->size, sizeof(rtka_chromosome_t*), compare_fitness);
+}
+
+/* Rewrite the sorted population in row order */
+static void settle(rtka_population_t* pop) {
+    copy_to_spare(pop, pop->size);
+    swap_generations(pop);
+}
+
+/* Write the next generation into the spare rows, the elite first and then
+ * the offspring, and swap it in */
+static void breed(rtka_population_t* pop, rtka_selection_t selection) {
+    uint32_t elite_count = (uint32_t)(pop->size * pop->elite_ratio);
+    copy_to_spare(pop, elite_count);
+
     for (uint32_t i = elite_count; i < pop->size; i++) {
         rtka_chromosome_t* parent1 = rtka_evolution_select(pop, selection, 3);
         rtka_chromosome_t* parent2 = rtka_evolution_select(pop, selection, 3);
-        
-        rtka_chromosome_t* child = rtka_evolution_crossover(parent1, parent2, pop->crossover_rate);
-        rtka_evolution_mutate(child, pop->mutation_rate);
-        new_pop[i] = child;
+
+        crossover_into(pop->spare[i], parent1, parent2, pop->crossover_rate, &pop->rng);
+        mutate_with(pop->spare[i], pop->mutation_rate, &pop->rng);
     }
-    
-    pop->individuals = new_pop;
+
+    swap_generations(pop);
     pop->generation++;
 }
 
+/* Evolution step */
+void rtka_evolution_step(rtka_population_t* pop,
+                        rtka_fitness_fn fitness,
+                        rtka_selection_t selection) {
+    if (!pop || pop->size == 0) return;
+    evaluate_ctx_t ctx = { pop, fitness, NULL, NULL, NULL };
+    evaluate_and_sort(pop, &ctx, NULL);
+    breed(pop, selection);
+}
+
+void rtka_evolution_step_parallel(rtka_population_t* pop,
+                                  rtka_fitness_fn fitness,
+                                  rtka_selection_t selection,
+                                  rtka_thread_pool_t* pool) {
+    if (!pop || pop->size == 0) return;
+    evaluate_ctx_t ctx = { pop, fitness, NULL, NULL, NULL };
+    evaluate_and_sort(pop, &ctx, pool ? pool : rtka_pool_default());
+    breed(pop, selection);
+}
+
+void rtka_evolution_step_batch(rtka_population_t* pop,
+                               rtka_batch_fitness_fn fitness,
+                               rtka_selection_t selection,
+                               rtka_thread_pool_t* pool) {
+    if (!pop || pop->size == 0) return;
+    evaluate_ctx_t ctx = { pop, NULL, fitness, NULL, NULL };
+    evaluate_and_sort(pop, &ctx, pool);
+    breed(pop, selection);
+}
+
 /* Check convergence */
 bool rtka_evolution_converged(rtka_population_t* pop, rtka_confidence_t threshold) {
     rtka_confidence_t best = pop->individuals[0]->fitness;
     rtka_confidence_t worst = pop->individuals[pop->size - 1]->fitness;
-    
+
     return (best - worst) < threshold;
 }
 
 /* Get statistics */
 rtka_evolution_stats_t rtka_evolution_get_stats(rtka_population_t* pop) {
     rtka_evolution_stats_t stats = {0};
-    
+
     stats.best_fitness = pop->individuals[0]->fitness;
-    
+
     rtka_confidence_t sum = 0.0f;
     for (uint32_t i = 0; i < pop->size; i++) {
         sum += pop->individuals[i]->fitness;
     }
     stats.avg_fitness = sum / pop->size;
-    
+
     /* Diversity based on ternary states */
     uint32_t true_count = 0, false_count = 0, unknown_count = 0;
-    
-    for (uint32_t i = 0; i < pop->size; i++) {
-        for (uint32_t g = 0; g < pop->individuals[i]->length; g++) {
-            switch (pop->individuals[i]->genes[g].value) {
-                case RTKA_TRUE: true_count++; break;
-                case RTKA_FALSE: false_count++; break;
-                case RTKA_UNKNOWN: unknown_count++; break;
-            }
+
+    size_t cells = (size_t)pop->size * pop->gene_length;
+    for (size_t k = 0; k < cells; k++) {
+        switch (pop->genes[k].value) {
+            case RTKA_TRUE: true_count++; break;
+            case RTKA_FALSE: false_count++; break;
+            case RTKA_UNKNOWN: unknown_count++; break;
         }
     }
-    
+
     uint32_t total = true_count + false_count + unknown_count;
     float p_true = (float)true_count / total;
     float p_false = (float)false_count / total;
     float p_unknown = (float)unknown_count / total;
-    
+
     /* Shannon entropy for diversity */
     stats.diversity = 0.0f;
     if (p_true > 0) stats.diversity -= p_true * logf(p_true);
     if (p_false > 0) stats.diversity -= p_false * logf(p_false);
     if (p_unknown > 0) stats.diversity -= p_unknown * logf(p_unknown);
     stats.diversity /= logf(3.0f);  /* Normalize to [0,1] */
-    
+
     return stats;
 }
 
-/* Random float implementation */
-float rtka_random_float(void) {
-    return (float)rand() / RAND_MAX;
+/* ============================================================================
+ * NON-DOMINATED SORTING
+ * Jensen's divide and conquer, in the form of Fortin, Grenier and Parizeau
+ * that handles equal objective values. Inside, points are negated to
+ * minimization, deduplicated and renumbered in lexicographic order, so an
+ * earlier point is never worse on objective 0. helper_a ranks a set on
+ * objectives 0 .. k by splitting it at the median of objective k;
+ * helper_b lets a set L rank a set H that is no better on objectives
+ * above k. Two objectives are a sweep over a Fenwick tree of ranks.
+ * Every helper leaves its sets in point order.
+ * ============================================================================ */
+
+typedef int (*index_cmp_fn)(const void* ctx, uint32_t a, uint32_t b);
+
+/* Stable bottom-up merge sort of an index array */
+static void sort_indices(uint32_t* idx, uint32_t* tmp, uint32_t n, index_cmp_fn cmp, const void* ctx) {
+    uint32_t* from = idx;
+    uint32_t* to = tmp;
+    for (uint32_t width = 1; width < n; width *= 2U) {
+        for (uint32_t lo = 0; lo < n; lo += 2U * width) {
+            uint32_t mid = lo + width < n ? lo + width : n;
+            uint32_t hi = lo + 2U * width < n ? lo + 2U * width : n;
+            uint32_t a = lo, b = mid, out = lo;
+            while (a < mid && b < hi) to[out++] = cmp(ctx, from[b], from[a]) < 0 ? from[b++] : from[a++];
+            while (a < mid) to[out++] = from[a++];
+            while (b < hi) to[out++] = from[b++];
+        }
+        uint32_t* swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != idx) memcpy(idx, from, n * sizeof(uint32_t));
+}
+
+typedef struct {
+    const rtka_confidence_t* objectives;
+    size_t stride;
+    uint32_t count;
+} columns_t;
+
+/* Lexicographic, better (larger) values first */
+static int compare_lexicographic(const void* arg, uint32_t a, uint32_t b) {
+    const columns_t* c = (const columns_t*)arg;
+    for (uint32_t m = 0; m < c->count; m++) {
+        rtka_confidence_t x = c->objectives[m * c->stride + a], y = c->objectives[m * c->stride + b];
+        if (x != y) return x > y ? -1 : 1;
+    }
+    return 0;
+}
+
+/* One column, ascending */
+static int compare_column(const void* arg, uint32_t a, uint32_t b) {
+    const rtka_confidence_t* column = (const rtka_confidence_t*)arg;
+    return (column[a] > column[b]) - (column[a] < column[b]);
+}
+
+typedef struct {
+    uint32_t n;                 /* Distinct points */
+    const float* v;             /* Objective m of point p at v[m * n + p], minimized */
+    uint32_t* rank;
+    uint32_t* coord;            /* Dense rank of objective 1 */
+    uint32_t* fenwick;          /* n + 1 entries of rank + 1, prefix maxima */
+    uint32_t* tmp;              /* n */
+    float* values;              /* n, for medians */
+} nds_t;
+
+static RTKA_INLINE float nds_value(const nds_t* s, uint32_t m, uint32_t p) {
+    return s->v[(size_t)m * s->n + p];
+}
+
+static uint32_t fenwick_query(const nds_t* s, uint32_t coord) {
+    uint32_t best = 0;
+    for (uint32_t i = coord + 1U; i > 0; i -= i & (0U - i)) {
+        if (s->fenwick[i] > best) best = s->fenwick[i];
+    }
+    return best;
+}
+
+static void fenwick_raise(nds_t* s, uint32_t coord, uint32_t value) {
+    for (uint32_t i = coord + 1U; i <= s->n; i += i & (0U - i)) {
+        if (s->fenwick[i] < value) s->fenwick[i] = value;
+    }
+}
+
+static void fenwick_clear(nds_t* s, uint32_t coord) {
+    for (uint32_t i = coord + 1U; i <= s->n; i += i & (0U - i)) s->fenwick[i] = 0;
+}
+
+static RTKA_INLINE void raise_rank(nds_t* s, uint32_t p, uint32_t at_least) {
+    if (s->rank[p] < at_least) s->rank[p] = at_least;
+}
+
+/* a precedes b, so a dominates b on objectives 0 .. k when it is no worse
+ * on 1 .. k */
+static bool nds_dominates(const nds_t* s, uint32_t a, uint32_t b, uint32_t k) {
+    if (a > b) return false;
+    for (uint32_t m = 1; m <= k; m++) {
+        if (nds_value(s, m, a) > nds_value(s, m, b)) return false;
+    }
+    return true;
+}
+
+static void sweep_a(nds_t* s, const uint32_t* set, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t p = set[i];
+        raise_rank(s, p, fenwick_query(s, s->coord[p]));
+        fenwick_raise(s, s->coord[p], s->rank[p] + 1U);
+    }
+    for (uint32_t i = 0; i < count; i++) fenwick_clear(s, s->coord[set[i]]);
+}
+
+static void sweep_b(nds_t* s, const uint32_t* low, uint32_t nl, const uint32_t* high, uint32_t nh) {
+    uint32_t a = 0;
+    for (uint32_t b = 0; b < nh; b++) {
+        for (; a < nl && low[a] < high[b]; a++) fenwick_raise(s, s->coord[low[a]], s->rank[low[a]] + 1U);
+        raise_rank(s, high[b], fenwick_query(s, s->coord[high[b]]));
+    }
+    for (uint32_t i = 0; i < a; i++) fenwick_clear(s, s->coord[low[i]]);
+}
+
+/* Quickselect of the middle value, three-way partitioned */
+static float median_value(float* values, uint32_t count) {
+    uint32_t lo = 0, hi = count, target = count / 2U;
+    while (hi - lo > 1U) {
+        float pivot = values[lo + (hi - lo) / 2U];
+        uint32_t lt = lo, i = lo, gt = hi;
+        while (i < gt) {
+            float x = values[i];
+            if (x < pivot) {
+                values[i++] = values[lt];
+                values[lt++] = x;
+            } else if (x > pivot) {
+                values[i] = values[--gt];
+                values[gt] = x;
+            } else {
+                i++;
+            }
+        }
+        if (target < lt) hi = lt;
+        else if (target >= gt) lo = gt;
+        else return pivot;
+    }
+    return values[lo];
+}
+
+/* Stable split of a set on objective m: the low part first */
+static uint32_t nds_partition(nds_t* s, uint32_t* set, uint32_t count, uint32_t m, float pivot, bool ties_low) {
+    uint32_t low = 0, high = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        float x = nds_value(s, m, set[i]);
+        if (ties_low ? x <= pivot : x < pivot) set[low++] = set[i];
+        else s->tmp[high++] = set[i];
+    }
+    memcpy(set + low, s->tmp, high * sizeof(uint32_t));
+    return low;
+}
+
+/* Merge the two sorted parts of a split set back into point order */
+static void nds_merge(nds_t* s, uint32_t* set, uint32_t split, uint32_t count) {
+    uint32_t a = 0, b = split, out = 0;
+    while (a < split && b < count) s->tmp[out++] = set[a] < set[b] ? set[a++] : set[b++];
+    while (a < split) s->tmp[out++] = set[a++];
+    while (b < count) s->tmp[out++] = set[b++];
+    memcpy(set, s->tmp, count * sizeof(uint32_t));
+}
+
+static void value_range(const nds_t* s, const uint32_t* set, uint32_t count, uint32_t m, float* lo, float* hi) {
+    *lo = *hi = nds_value(s, m, set[0]);
+    for (uint32_t i = 1; i < count; i++) {
+        float x = nds_value(s, m, set[i]);
+        if (x < *lo) *lo = x;
+        if (x > *hi) *hi = x;
+    }
+}
+
+static void helper_b(nds_t* s, uint32_t* low, uint32_t nl, uint32_t* high, uint32_t nh, uint32_t k) {
+    if (nl == 0 || nh == 0) return;
+    if (nl == 1 || nh == 1) {
+        for (uint32_t b = 0; b < nh; b++) {
+            for (uint32_t a = 0; a < nl; a++) {
+                if (nds_dominates(s, low[a], high[b], k)) raise_rank(s, high[b], s->rank[low[a]] + 1U);
+            }
+        }
+        return;
+    }
+    if (k == 1) {
+        sweep_b(s, low, nl, high, nh);
+        return;
+    }
+
+    float lmin, lmax, hmin, hmax;
+    value_range(s, low, nl, k, &lmin, &lmax);
+    value_range(s, high, nh, k, &hmin, &hmax);
+    if (lmax <= hmin) {
+        helper_b(s, low, nl, high, nh, k - 1U);
+        return;
+    }
+    if (lmin > hmax) return;
+
+    for (uint32_t i = 0; i < nl; i++) s->values[i] = nds_value(s, k, low[i]);
+    for (uint32_t i = 0; i < nh; i++) s->values[nl + i] = nds_value(s, k, high[i]);
+    float pivot = median_value(s->values, nl + nh);
+    /* Both sides of the pivot must be non-empty */
+    bool ties_low = pivot < (lmax > hmax ? lmax : hmax);
+
+    uint32_t l1 = nds_partition(s, low, nl, k, pivot, ties_low);
+    uint32_t h1 = nds_partition(s, high, nh, k, pivot, ties_low);
+    helper_b(s, low, l1, high, h1, k);
+    helper_b(s, low, l1, high + h1, nh - h1, k - 1U);
+    helper_b(s, low + l1, nl - l1, high + h1, nh - h1, k);
+    nds_merge(s, low, l1, nl);
+    nds_merge(s, high, h1, nh);
+}
+
+static void helper_a(nds_t* s, uint32_t* set, uint32_t count, uint32_t k) {
+    if (count < 2) return;
+    if (count == 2) {
+        if (nds_dominates(s, set[0], set[1], k)) raise_rank(s, set[1], s->rank[set[0]] + 1U);
+        return;
+    }
+    if (k == 1) {
+        sweep_a(s, set, count);
+        return;
+    }
+
+    float lo, hi;
+    value_range(s, set, count, k, &lo, &hi);
+    if (lo == hi) {
+        helper_a(s, set, count, k - 1U);
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) s->values[i] = nds_value(s, k, set[i]);
+    float pivot = median_value(s->values, count);
+    uint32_t less = 0, greater = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        float x = nds_value(s, k, set[i]);
+        less += x < pivot;
+        greater += x > pivot;
+    }
+    /* Values equal to the pivot join the smaller side, never emptying one */
+    bool ties_low = greater != 0 && (less == 0 || less <= greater);
+
+    uint32_t split = nds_partition(s, set, count, k, pivot, ties_low);
+    helper_a(s, set, split, k);
+    helper_b(s, set, split, set + split, count - split, k - 1U);
+    helper_a(s, set + split, count - split, k);
+    nds_merge(s, set, split, count);
+}
+
+/* Fronts of n points whose objective m sits at objectives[m * stride + i] */
+static rtka_error_t nondominated_sort(const rtka_confidence_t* objectives, size_t stride, uint32_t n,
+                                      uint32_t num_objectives, uint32_t* rank) {
+    if (n == 0) return RTKA_SUCCESS;
+    if (num_objectives == 0) {
+        memset(rank, 0, n * sizeof(uint32_t));
+        return RTKA_SUCCESS;
+    }
+
+    uint32_t* ints = (uint32_t*)malloc((size_t)n * 7U * sizeof(uint32_t) + sizeof(uint32_t));
+    float* floats = (float*)malloc(((size_t)num_objectives + 1U) * n * sizeof(float));
+    if (!ints || !floats) {
+        free(ints);
+        free(floats);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    uint32_t* order = ints;             /* Input index of each sorted point */
+    uint32_t* unique = order + n;       /* Distinct point of each sorted point */
+    uint32_t* set = unique + n;
+    nds_t s = { .rank = set + n, .coord = set + 2U * n, .tmp = set + 3U * n, .fenwick = set + 4U * n,
+                .values = floats + (size_t)num_objectives * n };
+
+    columns_t columns = { objectives, stride, num_objectives };
+    for (uint32_t i = 0; i < n; i++) order[i] = i;
+    sort_indices(order, s.tmp, n, compare_lexicographic, &columns);
+
+    /* Distinct points in order, negated so smaller is better */
+    float* v = floats;
+    uint32_t distinct = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (i == 0 || compare_lexicographic(&columns, order[i - 1U], order[i]) != 0) distinct++;
+        unique[i] = distinct - 1U;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (i > 0 && unique[i] == unique[i - 1U]) continue;
+        for (uint32_t m = 0; m < num_objectives; m++) {
+            v[(size_t)m * distinct + unique[i]] = -objectives[m * stride + order[i]];
+        }
+    }
+    s.n = distinct;
+    s.v = v;
+    memset(s.rank, 0, distinct * sizeof(uint32_t));
+
+    if (num_objectives == 1) {
+        for (uint32_t p = 0; p < distinct; p++) s.rank[p] = p;
+    } else {
+        /* Dense coordinates of objective 1 for the sweeps */
+        for (uint32_t p = 0; p < distinct; p++) set[p] = p;
+        sort_indices(set, s.tmp, distinct, compare_column, v + distinct);
+        for (uint32_t i = 0, c = 0; i < distinct; i++) {
+            if (i > 0 && v[distinct + set[i]] != v[distinct + set[i - 1U]]) c++;
+            s.coord[set[i]] = c;
+        }
+        memset(s.fenwick, 0, ((size_t)distinct + 1U) * sizeof(uint32_t));
+        for (uint32_t p = 0; p < distinct; p++) set[p] = p;
+        helper_a(&s, set, distinct, num_objectives - 1U);
+    }
+
+    for (uint32_t i = 0; i < n; i++) rank[order[i]] = s.rank[unique[i]];
+    free(ints);
+    free(floats);
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_evolution_nondominated_sort(const rtka_confidence_t* objectives, uint32_t n,
+                                              uint32_t num_objectives, uint32_t* rank) {
+    if ((!objectives || !rank) && n) return RTKA_ERROR_NULL_POINTER;
+    return nondominated_sort(objectives, n, n, num_objectives, rank);
+}
+
+/* ============================================================================
+ * CROWDING DISTANCE
+ * Each objective sorts all points once and walks them, keeping the last
+ * two points seen of every front; a point's gap is known when the next
+ * point of its front arrives. Objectives write their own column of gaps,
+ * summed afterwards.
+ * ============================================================================ */
+
+#define NO_POINT  UINT32_MAX
+
+typedef struct {
+    const rtka_confidence_t* objectives;
+    size_t stride;
+    uint32_t n;
+    uint32_t fronts;
+    const uint32_t* rank;
+    uint32_t* scratch;          /* Per objective: 2n + 4 x fronts */
+    rtka_confidence_t* gaps;    /* Per objective: n */
+} crowding_ctx_t;
+
+static void crowding_objectives(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const crowding_ctx_t* ctx = (const crowding_ctx_t*)arg;
+    uint32_t n = ctx->n, fronts = ctx->fronts;
+    for (uint32_t m = begin; m < end; m++) {
+        const rtka_confidence_t* column = ctx->objectives + m * ctx->stride;
+        uint32_t* order = ctx->scratch + (size_t)m * (2U * n + 4U * fronts);
+        uint32_t* first = order + 2U * n;
+        uint32_t* last = first + fronts;
+        uint32_t* prev = last + fronts;
+        uint32_t* before = prev + fronts;
+        rtka_confidence_t* gaps = ctx->gaps + (size_t)m * n;
+
+        for (uint32_t i = 0; i < n; i++) order[i] = i;
+        sort_indices(order, order + n, n, compare_column, column);
+        for (uint32_t f = 0; f < fronts; f++) first[f] = last[f] = prev[f] = before[f] = NO_POINT;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t f = ctx->rank[order[i]];
+            if (first[f] == NO_POINT) first[f] = order[i];
+            last[f] = order[i];
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t p = order[i], f = ctx->rank[p];
+            gaps[p] = (p == first[f] || p == last[f]) ? RTKA_CROWDING_BOUNDARY : 0.0f;
+            uint32_t middle = prev[f];
+            if (middle != NO_POINT && before[f] != NO_POINT) {
+                rtka_confidence_t range = column[last[f]] - column[first[f]];
+                if (range > 0.0f) gaps[middle] = (column[p] - column[before[f]]) / range;
+            }
+            before[f] = middle;
+            prev[f] = p;
+        }
+    }
+}
+
+static rtka_error_t crowding_distance(const rtka_confidence_t* objectives, size_t stride, uint32_t n,
+                                      uint32_t num_objectives, const uint32_t* rank,
+                                      rtka_confidence_t* distance, rtka_thread_pool_t* pool) {
+    if (n == 0) return RTKA_SUCCESS;
+    uint32_t fronts = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (rank[i] >= n) return RTKA_ERROR_INVALID_VALUE;
+        if (rank[i] + 1U > fronts) fronts = rank[i] + 1U;
+    }
+    size_t per_objective = 2U * (size_t)n + 4U * (size_t)fronts;
+    crowding_ctx_t ctx = { objectives, stride, n, fronts, rank,
+                           (uint32_t*)malloc(per_objective * num_objectives * sizeof(uint32_t) + sizeof(uint32_t)),
+                           (rtka_confidence_t*)malloc((size_t)n * num_objectives * sizeof(rtka_confidence_t) + sizeof(float)) };
+    if (!ctx.scratch || !ctx.gaps) {
+        free(ctx.scratch);
+        free(ctx.gaps);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (pool && num_objectives > 1) {
+        rtka_pool_parallel_for(pool, 0, num_objectives, 1, crowding_objectives, &ctx);
+    } else {
+        crowding_objectives(&ctx, 0, num_objectives, 0);
+    }
+
+    for (uint32_t i = 0; i < n; i++) distance[i] = 0.0f;
+    for (uint32_t m = 0; m < num_objectives; m++) {
+        const rtka_confidence_t* gaps = ctx.gaps + (size_t)m * n;
+        for (uint32_t i = 0; i < n; i++) distance[i] += gaps[i];
+    }
+    free(ctx.scratch);
+    free(ctx.gaps);
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_evolution_crowding_distance(const rtka_confidence_t* objectives, uint32_t n,
+                                              uint32_t num_objectives, const uint32_t* rank,
+                                              rtka_confidence_t* distance, rtka_thread_pool_t* pool) {
+    if ((!objectives || !rank || !distance) && n) return RTKA_ERROR_NULL_POINTER;
+    return crowding_distance(objectives, n, n, num_objectives, rank, distance, pool);
+}
+
+/* ============================================================================
+ * NSGA-II
+ * Parents are points 0 .. size - 1 of the workspace and offspring, bred
+ * into the spare rows, points size .. 2 size - 1. Surviving offspring move
+ * into the rows of dropped parents, then the population is put in order.
+ * ============================================================================ */
+
+struct rtka_nsga2_state {
+    uint32_t size;
+    uint32_t num_objectives;
+    uint32_t generation;        /* pop->generation the parent points belong to */
+    bool valid;
+    rtka_fitness_fn* objectives;    /* The functions they were evaluated with */
+    rtka_confidence_t* points;      /* num_objectives x 2 size */
+    uint32_t* rank;                 /* 2 size */
+    rtka_confidence_t* crowding;    /* 2 size */
+    uint32_t* order;                /* 2 size */
+    uint32_t* sort_tmp;             /* 2 size */
+    uint8_t* keep;                  /* 2 size */
+};
+
+static void nsga_free(rtka_nsga2_state_t* state) {
+    if (!state) return;
+    free(state->objectives);
+    free(state->points);
+    free(state->rank);
+    free(state->crowding);
+    free(state->order);
+    free(state->sort_tmp);
+    free(state->keep);
+    free(state);
+}
+
+static rtka_nsga2_state_t* nsga_state(rtka_population_t* pop, rtka_fitness_fn* objectives, uint32_t num_objectives) {
+    rtka_nsga2_state_t* state = pop->nsga;
+    if (state && state->size == pop->size && state->num_objectives == num_objectives) {
+        if (state->generation != pop->generation ||
+            memcmp(state->objectives, objectives, num_objectives * sizeof(rtka_fitness_fn)) != 0) {
+            state->valid = false;
+        }
+        return state;
+    }
+
+    nsga_free(state);
+    pop->nsga = NULL;
+    state = (rtka_nsga2_state_t*)calloc(1, sizeof(rtka_nsga2_state_t));
+    if (!state) return NULL;
+    size_t points = 2U * (size_t)pop->size;
+    state->size = pop->size;
+    state->num_objectives = num_objectives;
+    state->objectives = (rtka_fitness_fn*)malloc(num_objectives * sizeof(rtka_fitness_fn));
+    state->points = (rtka_confidence_t*)malloc(points * num_objectives * sizeof(rtka_confidence_t));
+    state->rank = (uint32_t*)malloc(points * sizeof(uint32_t));
+    state->crowding = (rtka_confidence_t*)malloc(points * sizeof(rtka_confidence_t));
+    state->order = (uint32_t*)malloc(points * sizeof(uint32_t));
+    state->sort_tmp = (uint32_t*)malloc(points * sizeof(uint32_t));
+    state->keep = (uint8_t*)malloc(points);
+    if (!state->objectives || !state->points || !state->rank || !state->crowding ||
+        !state->order || !state->sort_tmp || !state->keep) {
+        nsga_free(state);
+        return NULL;
+    }
+    pop->nsga = state;
+    return state;
+}
+
+typedef struct {
+    rtka_chromosome_t** chromosomes;
+    rtka_fitness_fn* objectives;
+    uint32_t num_objectives;
+    rtka_confidence_t* points;  /* Point first + i of every objective column */
+    size_t stride;
+    uint32_t first;
+} objectives_ctx_t;
+
+static void evaluate_objectives(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const objectives_ctx_t* ctx = (const objectives_ctx_t*)arg;
+    for (uint32_t i = begin; i < end; i++) {
+        for (uint32_t m = 0; m < ctx->num_objectives; m++) {
+            ctx->points[m * ctx->stride + ctx->first + i] = ctx->objectives[m](ctx->chromosomes[i]);
+        }
+    }
+}
+
+static void nsga_evaluate(rtka_nsga2_state_t* state, rtka_chromosome_t** chromosomes, rtka_fitness_fn* objectives,
+                          uint32_t first, rtka_thread_pool_t* pool) {
+    objectives_ctx_t ctx = { chromosomes, objectives, state->num_objectives, state->points,
+                             2U * (size_t)state->size, first };
+    if (pool) {
+        rtka_pool_parallel_for(pool, 0, state->size, 0, evaluate_objectives, &ctx);
+    } else {
+        evaluate_objectives(&ctx, 0, state->size, 0);
+    }
+}
+
+static bool nsga_rank(rtka_nsga2_state_t* state, uint32_t count, rtka_thread_pool_t* pool) {
+    size_t stride = 2U * (size_t)state->size;
+    return nondominated_sort(state->points, stride, count, state->num_objectives, state->rank) == RTKA_SUCCESS &&
+           crowding_distance(state->points, stride, count, state->num_objectives, state->rank,
+                             state->crowding, pool) == RTKA_SUCCESS;
+}
+
+/* Lower front first, then the less crowded */
+static int compare_nsga(const void* arg, uint32_t a, uint32_t b) {
+    const rtka_nsga2_state_t* state = (const rtka_nsga2_state_t*)arg;
+    if (state->rank[a] != state->rank[b]) return state->rank[a] < state->rank[b] ? -1 : 1;
+    return (state->crowding[a] < state->crowding[b]) - (state->crowding[a] > state->crowding[b]);
+}
+
+static uint32_t nsga_tournament(rtka_population_t* pop, const rtka_nsga2_state_t* state) {
+    uint32_t a = rtka_random_uint32(&pop->rng) % pop->size;
+    uint32_t b = rtka_random_uint32(&pop->rng) % pop->size;
+    return compare_nsga(state, b, a) < 0 ? b : a;
+}
+
+/* Point from moves to point to */
+static void nsga_move_point(rtka_nsga2_state_t* state, uint32_t from, uint32_t to) {
+    size_t stride = 2U * (size_t)state->size;
+    for (uint32_t m = 0; m < state->num_objectives; m++) {
+        state->points[m * stride + to] = state->points[m * stride + from];
+    }
+    state->rank[to] = state->rank[from];
+    state->crowding[to] = state->crowding[from];
+}
+
+static void nsga2_generation(rtka_population_t* pop, rtka_fitness_fn* objectives, uint32_t num_objectives,
+                             rtka_thread_pool_t* pool) {
+    if (!pop || pop->size == 0 || !objectives || num_objectives == 0) return;
+    rtka_nsga2_state_t* state = nsga_state(pop, objectives, num_objectives);
+    if (!state) return;
+    uint32_t n = pop->size;
+
+    if (!state->valid) {
+        nsga_evaluate(state, pop->individuals, objectives, 0, pool);
+        if (!nsga_rank(state, n, pool)) return;
+        memcpy(state->objectives, objectives, num_objectives * sizeof(rtka_fitness_fn));
+        state->valid = true;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        const rtka_chromosome_t* parent1 = pop->individuals[nsga_tournament(pop, state)];
+        const rtka_chromosome_t* parent2 = pop->individuals[nsga_tournament(pop, state)];
+        crossover_into(pop->spare[i], parent1, parent2, pop->crossover_rate, &pop->rng);
+        mutate_with(pop->spare[i], pop->mutation_rate, &pop->rng);
+    }
+    nsga_evaluate(state, pop->spare, objectives, n, pool);
+    if (!nsga_rank(state, 2U * n, pool)) {
+        state->valid = false;
+        return;
+    }
+
+    /* Whole fronts while they fit, then the least crowded of the next */
+    for (uint32_t u = 0; u < 2U * n; u++) state->order[u] = u;
+    sort_indices(state->order, state->sort_tmp, 2U * n, compare_nsga, state);
+    memset(state->keep, 0, 2U * (size_t)n);
+    for (uint32_t i = 0; i < n; i++) state->keep[state->order[i]] = 1;
+
+    uint32_t arriving = n;
+    for (uint32_t row = 0; row < n; row++) {
+        if (state->keep[row]) {
+            pop->individuals[row]->age++;
+            continue;
+        }
+        while (!state->keep[arriving]) arriving++;
+        rtka_chromosome_t* child = pop->spare[arriving - n];
+        memcpy(pop->individuals[row]->genes, child->genes, (size_t)pop->gene_length * sizeof(rtka_state_t));
+        pop->individuals[row]->age = 0;
+        nsga_move_point(state, arriving, row);
+        arriving++;
+    }
+
+    /* Best first, the points following their rows through the spare half */
+    for (uint32_t i = 0; i < n; i++) state->order[i] = i;
+    sort_indices(state->order, state->sort_tmp, n, compare_nsga, state);
+    rtka_chromosome_t* rows = pop->individuals[0];
+    for (uint32_t i = 0; i < n; i++) {
+        pop->individuals[i] = rows + state->order[i];
+        pop->individuals[i]->fitness = 1.0f / (1.0f + (rtka_confidence_t)state->rank[state->order[i]]);
+        nsga_move_point(state, state->order[i], n + i);
+    }
+    for (uint32_t i = 0; i < n; i++) nsga_move_point(state, n + i, i);
+    settle(pop);
+
+    pop->generation++;
+    state->generation = pop->generation;
+}
+
+void rtka_evolution_nsga2(rtka_population_t* pop,
+                         rtka_fitness_fn* objectives,
+                         uint32_t num_objectives) {
+    nsga2_generation(pop, objectives, num_objectives, NULL);
+}
+
+void rtka_evolution_nsga2_parallel(rtka_population_t* pop,
+                                   rtka_fitness_fn* objectives,
+                                   uint32_t num_objectives,
+                                   rtka_thread_pool_t* pool) {
+    nsga2_generation(pop, objectives, num_objectives, pool ? pool : rtka_pool_default());
+}
+
+/* Island model */
+
+static uint32_t island_migrants(const rtka_island_model_t* model, const rtka_population_t* pop) {
+    uint32_t count = (uint32_t)(model->migration_rate * pop->size);
+    if (count == 0) count = 1;
+    return count < pop->size ? count : pop->size;
+}
+
+static rtka_island_mailbox_t* mailbox_create(uint32_t capacity, uint32_t length) {
+    rtka_island_mailbox_t* box = (rtka_island_mailbox_t*)aligned_alloc(64, (sizeof(rtka_island_mailbox_t) + 63U) & ~(size_t)63U);
+    if (!box) return NULL;
+    memset(box, 0, sizeof(*box));
+    atomic_init(&box->head, 0);
+    atomic_init(&box->tail, 0);
+    box->capacity = capacity;
+    box->length = length;
+    box->genes = (rtka_state_t*)malloc((size_t)capacity * length * sizeof(rtka_state_t) + 1U);
+    box->fitness = (rtka_confidence_t*)malloc((size_t)capacity * sizeof(rtka_confidence_t));
+    if (!box->genes || !box->fitness) {
+        free(box->genes);
+        free(box->fitness);
+        free(box);
+        return NULL;
+    }
+    return box;
+}
+
+static void mailbox_free(rtka_island_mailbox_t* box) {
+    if (!box) return;
+    free(box->genes);
+    free(box->fitness);
+    free(box);
+}
+
+/* Producer side: false when the inbox is full and the migrant is dropped */
+static bool mailbox_post(rtka_island_mailbox_t* box, const rtka_chromosome_t* chrom) {
+    uint64_t tail = atomic_load_explicit(&box->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&box->head, memory_order_acquire);
+    if (tail - head >= box->capacity || chrom->length != box->length) return false;
+
+    uint32_t slot = (uint32_t)(tail % box->capacity);
+    memcpy(box->genes + (size_t)slot * box->length, chrom->genes, box->length * sizeof(rtka_state_t));
+    box->fitness[slot] = chrom->fitness;
+    atomic_store_explicit(&box->tail, tail + 1U, memory_order_release);
+    return true;
+}
+
+/* Consumer side */
+static bool mailbox_take(rtka_island_mailbox_t* box, rtka_chromosome_t* chrom) {
+    uint64_t head = atomic_load_explicit(&box->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&box->tail, memory_order_acquire);
+    if (head == tail) return false;
+
+    uint32_t slot = (uint32_t)(head % box->capacity);
+    memcpy(chrom->genes, box->genes + (size_t)slot * box->length, box->length * sizeof(rtka_state_t));
+    chrom->fitness = box->fitness[slot];
+    chrom->age = 0;
+    atomic_store_explicit(&box->head, head + 1U, memory_order_release);
+    return true;
+}
+
+rtka_island_model_t* rtka_evolution_create_islands(uint32_t num_islands,
+                                                   uint32_t pop_per_island,
+                                                   uint32_t gene_length) {
+    if (num_islands == 0 || pop_per_island == 0) return NULL;
+    rtka_island_model_t* model = (rtka_island_model_t*)calloc(1, sizeof(rtka_island_model_t));
+    if (!model) return NULL;
+
+    model->num_islands = num_islands;
+    model->migration_rate = 0.1f;
+    model->migration_interval = 10;
+    model->islands = (rtka_population_t**)calloc(num_islands, sizeof(rtka_population_t*));
+    model->mailboxes = (rtka_island_mailbox_t**)calloc(num_islands, sizeof(rtka_island_mailbox_t*));
+    model->migrants_received = (uint64_t*)calloc(num_islands, sizeof(uint64_t));
+    model->migrants_dropped = (uint64_t*)calloc(num_islands, sizeof(uint64_t));
+    if (!model->islands || !model->mailboxes || !model->migrants_received || !model->migrants_dropped) {
+        rtka_evolution_free_islands(model);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < num_islands; i++) {
+        model->islands[i] = rtka_evolution_create_population(pop_per_island, gene_length);
+        if (!model->islands[i]) {
+            rtka_evolution_free_islands(model);
+            return NULL;
+        }
+        rtka_evolution_initialize_random(model->islands[i]);
+    }
+
+    return model;
+}
+
+void rtka_evolution_free_islands(rtka_island_model_t* model) {
+    if (!model) return;
+    for (uint32_t i = 0; i < model->num_islands; i++) {
+        if (model->islands) rtka_evolution_free_population(model->islands[i]);
+        if (model->mailboxes) mailbox_free(model->mailboxes[i]);
+    }
+    free(model->islands);
+    free(model->mailboxes);
+    free(model->migrants_received);
+    free(model->migrants_dropped);
+    free(model);
+}
+
+/* Inboxes sized for the current migration_rate */
+static bool ensure_mailboxes(rtka_island_model_t* model) {
+    for (uint32_t i = 0; i < model->num_islands; i++) {
+        const rtka_population_t* sender = model->islands[(i + model->num_islands - 1U) % model->num_islands];
+        uint32_t capacity = MAILBOX_BATCHES * island_migrants(model, sender);
+        uint32_t length = model->islands[i]->gene_length;
+        rtka_island_mailbox_t* box = model->mailboxes[i];
+        if (box && box->capacity == capacity && box->length == length) continue;
+
+        mailbox_free(box);
+        model->mailboxes[i] = mailbox_create(capacity, length);
+        if (!model->mailboxes[i]) return false;
+    }
+    return true;
+}
+
+/* Island i's best go to island i + 1's worst: every island posts before
+ * any takes in, so all migrants come from the same generation */
+void rtka_evolution_migrate(rtka_island_model_t* model) {
+    if (!model || model->num_islands < 2 || !ensure_mailboxes(model)) return;
+
+    for (uint32_t i = 0; i < model->num_islands; i++) {
+        rtka_population_t* pop = model->islands[i];
+        rtka_island_mailbox_t* inbox = model->mailboxes[(i + 1U) % model->num_islands];
+        uint32_t count = island_migrants(model, pop);
+        for (uint32_t m = 0; m < count; m++) {
+            if (!mailbox_post(inbox, pop->individuals[m])) model->migrants_dropped[i]++;
+        }
+    }
+    for (uint32_t i = 0; i < model->num_islands; i++) {
+        rtka_population_t* pop = model->islands[i];
+        uint32_t slot = pop->size;
+        while (slot > 0 && mailbox_take(model->mailboxes[i], pop->individuals[slot - 1U])) {
+            slot--;
+            model->migrants_received[i]++;
+        }
+    }
+}
+
+typedef struct {
+    rtka_island_model_t* model;
+    uint32_t island;
+    rtka_fitness_fn fitness;
+    rtka_selection_t selection;
+    uint32_t generations;
+    rtka_thread_pool_t* pool;
+} island_task_t;
+
+/* One island. Migrants replace the worst of the fresh generation; they get
+ * evaluated with it at the next step. */
+static void* island_main(void* arg) {
+    const island_task_t* task = (const island_task_t*)arg;
+    rtka_island_model_t* model = task->model;
+    uint32_t i = task->island, n = model->num_islands;
+    rtka_population_t* pop = model->islands[i];
+    rtka_island_mailbox_t* outbox = model->mailboxes[(i + 1U) % n];
+    rtka_island_mailbox_t* inbox = model->mailboxes[i];
+    uint32_t count = island_migrants(model, pop);
+    evaluate_ctx_t ctx = { pop, task->fitness, NULL, NULL, NULL };
+
+    for (uint32_t g = 0; g < task->generations; g++) {
+        evaluate_and_sort(pop, &ctx, task->pool);
+
+        bool migrate = n > 1 && model->migration_interval > 0 && (g + 1U) % model->migration_interval == 0;
+        if (migrate) {
+            for (uint32_t m = 0; m < count; m++) {
+                if (!mailbox_post(outbox, pop->individuals[m])) model->migrants_dropped[i]++;
+            }
+        }
+
+        breed(pop, task->selection);
+
+        if (migrate) {
+            uint32_t slot = pop->size;
+            while (slot > 0 && mailbox_take(inbox, pop->individuals[slot - 1U])) {
+                slot--;
+                model->migrants_received[i]++;
+            }
+        }
+    }
+
+    evaluate_and_sort(pop, &ctx, task->pool);
+    settle(pop);
+    return NULL;
+}
+
+rtka_error_t rtka_evolution_run_islands(rtka_island_model_t* model,
+                                        rtka_fitness_fn fitness,
+                                        rtka_selection_t selection,
+                                        uint32_t generations,
+                                        rtka_thread_pool_t* pool) {
+    if (!model || !fitness) return RTKA_ERROR_NULL_POINTER;
+    uint32_t n = model->num_islands;
+    if (!pool) pool = rtka_pool_default();
+    if (!ensure_mailboxes(model)) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    island_task_t* tasks = (island_task_t*)calloc(n, sizeof(island_task_t));
+    pthread_t* threads = (pthread_t*)calloc(n, sizeof(pthread_t));
+    if (!tasks || !threads) {
+        free(tasks);
+        free(threads);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* The caller runs island 0 */
+    uint32_t started = 1;
+    for (uint32_t i = 0; i < n; i++) {
+        tasks[i] = (island_task_t){ model, i, fitness, selection, generations, pool };
+    }
+    for (; started < n; started++) {
+        if (pthread_create(&threads[started], NULL, island_main, &tasks[started]) != 0) break;
+    }
+    /* Islands that did not get a thread run after island 0 */
+    island_main(&tasks[0]);
+    for (uint32_t i = started; i < n; i++) island_main(&tasks[i]);
+    for (uint32_t i = 1; i < started; i++) pthread_join(threads[i], NULL);
+
+    free(tasks);
+    free(threads);
+    return RTKA_SUCCESS;
 }
@@ -7,6 +7,32 @@
  * distributed, or used without explicit written permission.
  *
  * RTKA Evolutionary Algorithms with Ternary Genetics
+ *
+ * CHANGELOG:
+ * v1.1.0 - Populations own heap chromosomes (genes in the same block) and
+ *          a spare generation that offspring are bred into, so steps no
+ *          longer grow the temp stack. Each population draws from its own
+ *          rtka_rng_t. rtka_evolution_step_parallel evaluates fitness over
+ *          the thread pool. rtka_evolution_run_islands evolves every
+ *          island on its own thread; every migration_interval generations
+ *          an island posts copies of its best to the next island's
+ *          single-producer / single-consumer mailbox and takes in whatever
+ *          has arrived in its own, with no barrier between islands.
+ * v1.2.0 - A population stores its genes as one row-major size x
+ *          gene_length matrix, with a second matrix the next generation is
+ *          written into before the two are swapped. Chromosome records
+ *          point at their rows, so individuals[i]->genes is row i between
+ *          calls and a step allocates nothing. rtka_evolution_step_batch
+ *          hands the fitness function whole blocks of rows.
+ * v1.3.0 - Optional fitness cache keyed on a 64-bit genome hash: elite
+ *          survivors, offspring equal to an earlier genome and duplicates
+ *          within a generation are not evaluated again. With the cache on,
+ *          a batch fitness function sees only the distinct unscored rows,
+ *          gathered into one block.
+ * v1.4.0 - rtka_evolution_nsga2 implemented. Fronts come from Jensen's
+ *          divide-and-conquer non-dominated sort, O(N log^(M-1) N) for M
+ *          objectives. Crowding distance runs per front, over objective
+ *          columns, one objective per pool task.
  */
 
 #ifndef RTKA_EVOLUTION_H
@@ -14,6 +40,8 @@
 
 #include "rtka_types.h"
 #include "rtka_tensor.h"
+#include "rtka_random.h"
+#include "rtka_threadpool.h"
 
 /* Chromosome with ternary genes */
 typedef struct {
@@ -23,7 +51,12 @@ typedef struct {
     uint32_t age;
 } rtka_chromosome_t;
 
-/* Population */
+typedef struct rtka_fitness_cache rtka_fitness_cache_t;
+typedef struct rtka_nsga2_state rtka_nsga2_state_t;
+
+/* Population. Between calls individuals[i] is records[i] and its genes
+ * are row i of genes; sorting permutes only the pointers, and the next
+ * step writes the generation back in order into the spare matrix. */
 typedef struct {
     rtka_chromosome_t** individuals;
     uint32_t size;
@@ -31,13 +64,25 @@ typedef struct {
     rtka_confidence_t mutation_rate;
     rtka_confidence_t crossover_rate;
     rtka_confidence_t elite_ratio;
+    rtka_chromosome_t** spare;  /* Next generation is written here */
+    rtka_rng_t rng;             /* Seeded from the global RNG; reseed for repeatable runs */
+    uint32_t gene_length;
+    rtka_state_t* genes;        /* size x gene_length, 64-byte aligned */
+    rtka_state_t* spare_genes;
+    rtka_chromosome_t* records; /* Records over genes, then over spare_genes */
+    rtka_confidence_t* scores;  /* Fitness output, one per row */
+    rtka_fitness_cache_t* cache;    /* NULL unless rtka_evolution_enable_cache */
+    rtka_nsga2_state_t* nsga;       /* Objectives, fronts and crowding of the last NSGA-II generation */
 } rtka_population_t;
 
-/* Fitness function signature */
+/* Fitness function signature. The parallel step and the island model call
+ * it from several threads at once. */
 typedef rtka_confidence_t (*rtka_fitness_fn)(const rtka_chromosome_t*);
 
-/* Random float forward declaration */
-float rtka_random_float(void);
+/* Fitness of count consecutive rows of a row-major count x length gene
+ * matrix, written to fitness[0 .. count - 1]. Also called concurrently. */
+typedef void (*rtka_batch_fitness_fn)(const rtka_state_t* genes, uint32_t count,
+                                      uint32_t length, rtka_confidence_t* fitness);
 
 /* Selection strategies */
 typedef enum {
@@ -52,12 +97,14 @@ rtka_population_t* rtka_evolution_create_population(uint32_t pop_size, uint32_t
 void rtka_evolution_free_population(rtka_population_t* pop);
 void rtka_evolution_initialize_random(rtka_population_t* pop);
 
-/* Genetic operators */
+/* Genetic operators (global RNG); crossover children are freed with
+ * rtka_evolution_free_chromosome */
 rtka_chromosome_t* rtka_evolution_crossover(const rtka_chromosome_t* parent1,
                                            const rtka_chromosome_t* parent2,
                                            rtka_confidence_t rate);
 
 void rtka_evolution_mutate(rtka_chromosome_t* chrom, rtka_confidence_t rate);
+void rtka_evolution_free_chromosome(rtka_chromosome_t* chrom);
 
 /* Ternary-specific mutation */
 RTKA_INLINE void rtka_mutate_ternary(rtka_state_t* gene) {
@@ -83,11 +130,37 @@ rtka_chromosome_t* rtka_evolution_select(rtka_population_t* pop,
                                         rtka_selection_t method,
                                         uint32_t tournament_size);
 
-/* Evolution step */
+/* Evolution step: evaluate, sort best first, keep the elite, breed the
+ * rest. Offspring are left unevaluated until the next step. */
 void rtka_evolution_step(rtka_population_t* pop, 
                         rtka_fitness_fn fitness,
                         rtka_selection_t selection);
 
+/* The same step with fitness evaluated on pool (NULL = rtka_pool_default());
+ * selection and breeding stay on the caller's thread and pop->rng, so the
+ * result equals rtka_evolution_step's. */
+void rtka_evolution_step_parallel(rtka_population_t* pop,
+                                  rtka_fitness_fn fitness,
+                                  rtka_selection_t selection,
+                                  rtka_thread_pool_t* pool);
+
+/* The same step with fitness evaluated a block of rows at a time, the
+ * blocks spread over pool (NULL = one call on the caller's thread) */
+void rtka_evolution_step_batch(rtka_population_t* pop,
+                               rtka_batch_fitness_fn fitness,
+                               rtka_selection_t selection,
+                               rtka_thread_pool_t* pool);
+
+/* Remember fitness by genome in a table of about capacity entries
+ * (0 = four per individual), replacing any earlier cache. Only for
+ * fitness functions that depend on the genes alone; a different function
+ * needs a fresh cache. */
+RTKA_NODISCARD rtka_error_t rtka_evolution_enable_cache(rtka_population_t* pop, uint32_t capacity);
+void rtka_evolution_disable_cache(rtka_population_t* pop);
+
+/* Lookups answered without and with a fitness call */
+void rtka_evolution_cache_stats(const rtka_population_t* pop, uint64_t* hits, uint64_t* misses);
+
 /* Convergence detection */
 bool rtka_evolution_converged(rtka_population_t* pop, rtka_confidence_t threshold);
 
@@ -109,23 +182,72 @@ typedef struct {
     uint32_t num_objectives;
 } rtka_multiobjective_t;
 
+/* Crowding distance of a front's two extremes on any objective */
+#define RTKA_CROWDING_BOUNDARY  1e30f
+
+/* Fronts of n points, objective m of point i at objectives[m * n + i],
+ * every objective maximized: rank[i] is 0 for points nobody dominates, 1
+ * for those dominated only from front 0, and so on. Equal points share a
+ * rank. */
+RTKA_NODISCARD rtka_error_t rtka_evolution_nondominated_sort(const rtka_confidence_t* objectives, uint32_t n,
+                                                             uint32_t num_objectives, uint32_t* rank);
+
+/* Crowding distance of every point within its front: the sum over
+ * objectives of the gap between its neighbours, as a fraction of the
+ * front's range. Objectives are spread over pool (NULL = serial). */
+RTKA_NODISCARD rtka_error_t rtka_evolution_crowding_distance(const rtka_confidence_t* objectives, uint32_t n,
+                                                             uint32_t num_objectives, const uint32_t* rank,
+                                                             rtka_confidence_t* distance,
+                                                             rtka_thread_pool_t* pool);
+
+/* One NSGA-II generation, all objectives maximized: breed size offspring
+ * by binary tournament on (front, crowding), then keep the best size of
+ * parents and offspring by front and crowding. The population ends sorted
+ * that way, with fitness 1 / (1 + front). Parents are re-evaluated when
+ * the population or objectives changed since the previous call. */
 void rtka_evolution_nsga2(rtka_population_t* pop, 
                          rtka_fitness_fn* objectives,
                          uint32_t num_objectives);
 
-/* Island model for parallel evolution */
+/* The same with objective evaluation and crowding on pool (NULL =
+ * rtka_pool_default()) */
+void rtka_evolution_nsga2_parallel(rtka_population_t* pop,
+                                   rtka_fitness_fn* objectives,
+                                   uint32_t num_objectives,
+                                   rtka_thread_pool_t* pool);
+
+/* Island model for parallel evolution. Islands form a ring: island i
+ * sends migration_rate x its size (at least one) of its best to island
+ * i + 1, whose worst they replace. */
+typedef struct rtka_island_mailbox rtka_island_mailbox_t;
+
 typedef struct {
     rtka_population_t** islands;
     uint32_t num_islands;
     rtka_confidence_t migration_rate;
     uint32_t migration_interval;
+    rtka_island_mailbox_t** mailboxes;  /* Inbox of each island */
+    uint64_t* migrants_received;        /* Per island, by rtka_evolution_run_islands */
+    uint64_t* migrants_dropped;         /* Sent while the receiver's inbox was full */
 } rtka_island_model_t;
 
 rtka_island_model_t* rtka_evolution_create_islands(uint32_t num_islands,
                                                    uint32_t pop_per_island,
                                                    uint32_t gene_length);
+void rtka_evolution_free_islands(rtka_island_model_t* islands);
+
+/* One synchronous migration round around the ring */
 void rtka_evolution_migrate(rtka_island_model_t* islands);
 
+/* generations steps of every island, each island on its own thread and
+ * its fitness evaluations on pool (NULL = rtka_pool_default()), migrating
+ * through the mailboxes. Islands end evaluated and sorted. */
+RTKA_NODISCARD rtka_error_t rtka_evolution_run_islands(rtka_island_model_t* islands,
+                                                       rtka_fitness_fn fitness,
+                                                       rtka_selection_t selection,
+                                                       uint32_t generations,
+                                                       rtka_thread_pool_t* pool);
+
 /* Coevolution */
 void rtka_evolution_coevolve(rtka_population_t* pop1, 
                             rtka_population_t* pop2,
@@ -0,0 +1,635 @@
+/**
+ * File: rtka_gemm.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Blocked GEMM Implementation
+ *
+ * Loop nest per M x N tile of C (MC x NC):
+ *   for each KC slice of k:
+ *     pack B(slice, tile columns) into NR-wide panels
+ *     pack A(tile rows, slice) into MR-tall panels
+ *     for each NR panel, for each MR panel: micro-kernel on MR x NR of C
+ * Panels are zero padded, so the kernels never see a ragged edge; edge
+ * tiles of C go through a register-sized scratch tile instead.
+ */
+
+#include "rtka_gemm.h"
+#include "rtka_vector.h"
+#include "rtka_threadpool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RTKA_GEMM_X86 1
+#include <immintrin.h>
+#endif
+
+#define RTKA_GEMM_NR_MAX 32U
+
+/* ============================================================================
+ * KERNEL TABLE
+ * ============================================================================ */
+
+/* MR x nr tile: c (+)= pa (kc x MR panel) * pb (kc x nr panel) */
+typedef void (*rtka_gemm_kernel_fn)(uint32_t kc, const float* RTKA_RESTRICT pa,
+                                    const void* RTKA_RESTRICT pb,
+                                    float* RTKA_RESTRICT c, uint32_t ldc, bool accumulate);
+
+/* Dot product of one bit-plane row with words * 64 floats */
+typedef float (*rtka_ternary_dot_fn)(const uint64_t* RTKA_RESTRICT pos,
+                                     const uint64_t* RTKA_RESTRICT neg,
+                                     uint32_t words, const float* RTKA_RESTRICT x);
+
+typedef struct {
+    const char* name;
+    uint32_t nr;
+    rtka_gemm_kernel_fn f32;    /* float B panel */
+    rtka_gemm_kernel_fn i8;     /* int8 (ternary) B panel */
+    rtka_ternary_dot_fn ternary_dot;
+} rtka_gemm_kernels_t;
+
+#define MR RTKA_GEMM_MR
+
+/* ============================================================================
+ * SCALAR - fixed bounds, left to the auto-vectorizer
+ * ============================================================================ */
+
+#define SCALAR_NR 16U
+
+#define RTKA_GEMM_SCALAR_KERNEL(suffix, btype)                                  \
+static void rtka_gemm_kernel_##suffix##_scalar(uint32_t kc,                     \
+        const float* RTKA_RESTRICT pa, const void* RTKA_RESTRICT pb_v,          \
+        float* RTKA_RESTRICT c, uint32_t ldc, bool accumulate) {                \
+    const btype* RTKA_RESTRICT pb = (const btype*)pb_v;                         \
+    float acc[MR][SCALAR_NR] = {{0.0f}};                                        \
+    for (uint32_t p = 0; p < kc; p++) {                                         \
+        for (uint32_t i = 0; i < MR; i++) {                                     \
+            float av = pa[p * MR + i];                                          \
+            for (uint32_t j = 0; j < SCALAR_NR; j++) {                          \
+                acc[i][j] += av * (float)pb[p * SCALAR_NR + j];                 \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    for (uint32_t i = 0; i < MR; i++) {                                         \
+        for (uint32_t j = 0; j < SCALAR_NR; j++) {                              \
+            c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j]; \
+        }                                                                       \
+    }                                                                           \
+}
+
+RTKA_GEMM_SCALAR_KERNEL(f32, float)
+RTKA_GEMM_SCALAR_KERNEL(i8, int8_t)
+
+/* Walks the set bits: cost follows the non-zero weights */
+static float rtka_ternary_dot_scalar(const uint64_t* RTKA_RESTRICT pos,
+                                     const uint64_t* RTKA_RESTRICT neg,
+                                     uint32_t words, const float* RTKA_RESTRICT x) {
+    float sum = 0.0f;
+    for (uint32_t w = 0; w < words; w++, x += 64) {
+        for (uint64_t bits = pos[w]; bits; bits &= bits - 1U) sum += x[__builtin_ctzll(bits)];
+        for (uint64_t bits = neg[w]; bits; bits &= bits - 1U) sum -= x[__builtin_ctzll(bits)];
+    }
+    return sum;
+}
+
+static const rtka_gemm_kernels_t rtka_gemm_kernels_scalar = {
+    "scalar", SCALAR_NR, rtka_gemm_kernel_f32_scalar, rtka_gemm_kernel_i8_scalar,
+    rtka_ternary_dot_scalar
+};
+
+#ifdef RTKA_GEMM_X86
+
+/* ============================================================================
+ * AVX2 + FMA - 6 x 16 tile, 12 accumulators
+ * ============================================================================ */
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+static AVX2_TARGET RTKA_INLINE void rtka_gemm_store_avx2(__m256 acc[MR][2], float* c,
+                                                         uint32_t ldc, bool accumulate) {
+    for (uint32_t i = 0; i < MR; i++) {
+        float* row = c + (size_t)i * ldc;
+        if (accumulate) {
+            acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(row));
+            acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(row + 8));
+        }
+        _mm256_storeu_ps(row, acc[i][0]);
+        _mm256_storeu_ps(row + 8, acc[i][1]);
+    }
+}
+
+static AVX2_TARGET void rtka_gemm_kernel_f32_avx2(uint32_t kc, const float* RTKA_RESTRICT pa,
+                                                  const void* RTKA_RESTRICT pb_v,
+                                                  float* RTKA_RESTRICT c, uint32_t ldc,
+                                                  bool accumulate) {
+    const float* RTKA_RESTRICT pb = (const float*)pb_v;
+    __m256 acc[MR][2];
+    for (uint32_t i = 0; i < MR; i++) acc[i][0] = acc[i][1] = _mm256_setzero_ps();
+
+    for (uint32_t p = 0; p < kc; p++, pa += MR, pb += 16) {
+        __m256 b0 = _mm256_loadu_ps(pb);
+        __m256 b1 = _mm256_loadu_ps(pb + 8);
+        for (uint32_t i = 0; i < MR; i++) {
+            __m256 av = _mm256_broadcast_ss(pa + i);
+            acc[i][0] = _mm256_fmadd_ps(av, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(av, b1, acc[i][1]);
+        }
+    }
+    rtka_gemm_store_avx2(acc, c, ldc, accumulate);
+}
+
+static AVX2_TARGET void rtka_gemm_kernel_i8_avx2(uint32_t kc, const float* RTKA_RESTRICT pa,
+                                                 const void* RTKA_RESTRICT pb_v,
+                                                 float* RTKA_RESTRICT c, uint32_t ldc,
+                                                 bool accumulate) {
+    const int8_t* RTKA_RESTRICT pb = (const int8_t*)pb_v;
+    __m256 acc[MR][2];
+    for (uint32_t i = 0; i < MR; i++) acc[i][0] = acc[i][1] = _mm256_setzero_ps();
+
+    for (uint32_t p = 0; p < kc; p++, pa += MR, pb += 16) {
+        __m128i raw = _mm_loadu_si128((const __m128i*)(const void*)pb);
+        __m256 b0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(raw));
+        __m256 b1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(raw, 8)));
+        for (uint32_t i = 0; i < MR; i++) {
+            __m256 av = _mm256_broadcast_ss(pa + i);
+            acc[i][0] = _mm256_fmadd_ps(av, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(av, b1, acc[i][1]);
+        }
+    }
+    rtka_gemm_store_avx2(acc, c, ldc, accumulate);
+}
+
+/* Each byte of a plane word becomes an 8-lane mask: lane l keeps x when
+ * bit l is set, so +1 / -1 columns are an and + add / sub */
+static AVX2_TARGET float rtka_ternary_dot_avx2(const uint64_t* RTKA_RESTRICT pos,
+                                               const uint64_t* RTKA_RESTRICT neg,
+                                               uint32_t words, const float* RTKA_RESTRICT x) {
+    const __m256i lane_bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256 acc = _mm256_setzero_ps();
+
+    for (uint32_t w = 0; w < words; w++, x += 64) {
+        uint64_t p = pos[w], n = neg[w];
+        if (!(p | n)) continue;
+        for (uint32_t q = 0; q < 8; q++) {
+            uint32_t pb = (uint32_t)(p >> (8U * q)) & 0xFFU;
+            uint32_t nb = (uint32_t)(n >> (8U * q)) & 0xFFU;
+            if (!(pb | nb)) continue;
+            __m256 xv = _mm256_loadu_ps(x + 8U * q);
+            __m256 mp = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                _mm256_and_si256(_mm256_set1_epi32((int)pb), lane_bit), lane_bit));
+            __m256 mn = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                _mm256_and_si256(_mm256_set1_epi32((int)nb), lane_bit), lane_bit));
+            acc = _mm256_add_ps(acc, _mm256_and_ps(mp, xv));
+            acc = _mm256_sub_ps(acc, _mm256_and_ps(mn, xv));
+        }
+    }
+
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+}
+
+static const rtka_gemm_kernels_t rtka_gemm_kernels_avx2 = {
+    "avx2+fma", 16U, rtka_gemm_kernel_f32_avx2, rtka_gemm_kernel_i8_avx2,
+    rtka_ternary_dot_avx2
+};
+
+/* ============================================================================
+ * AVX-512 - 6 x 32 tile, 12 accumulators
+ * ============================================================================ */
+
+#define AVX512_TARGET __attribute__((target("avx512f")))
+
+static AVX512_TARGET RTKA_INLINE void rtka_gemm_store_avx512(__m512 acc[MR][2], float* c,
+                                                             uint32_t ldc, bool accumulate) {
+    for (uint32_t i = 0; i < MR; i++) {
+        float* row = c + (size_t)i * ldc;
+        if (accumulate) {
+            acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_loadu_ps(row));
+            acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_loadu_ps(row + 16));
+        }
+        _mm512_storeu_ps(row, acc[i][0]);
+        _mm512_storeu_ps(row + 16, acc[i][1]);
+    }
+}
+
+static AVX512_TARGET void rtka_gemm_kernel_f32_avx512(uint32_t kc, const float* RTKA_RESTRICT pa,
+                                                      const void* RTKA_RESTRICT pb_v,
+                                                      float* RTKA_RESTRICT c, uint32_t ldc,
+                                                      bool accumulate) {
+    const float* RTKA_RESTRICT pb = (const float*)pb_v;
+    __m512 acc[MR][2];
+    for (uint32_t i = 0; i < MR; i++) acc[i][0] = acc[i][1] = _mm512_setzero_ps();
+
+    for (uint32_t p = 0; p < kc; p++, pa += MR, pb += 32) {
+        __m512 b0 = _mm512_loadu_ps(pb);
+        __m512 b1 = _mm512_loadu_ps(pb + 16);
+        for (uint32_t i = 0; i < MR; i++) {
+            __m512 av = _mm512_set1_ps(pa[i]);
+            acc[i][0] = _mm512_fmadd_ps(av, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(av, b1, acc[i][1]);
+        }
+    }
+    rtka_gemm_store_avx512(acc, c, ldc, accumulate);
+}
+
+static AVX512_TARGET void rtka_gemm_kernel_i8_avx512(uint32_t kc, const float* RTKA_RESTRICT pa,
+                                                     const void* RTKA_RESTRICT pb_v,
+                                                     float* RTKA_RESTRICT c, uint32_t ldc,
+                                                     bool accumulate) {
+    const int8_t* RTKA_RESTRICT pb = (const int8_t*)pb_v;
+    __m512 acc[MR][2];
+    for (uint32_t i = 0; i < MR; i++) acc[i][0] = acc[i][1] = _mm512_setzero_ps();
+
+    for (uint32_t p = 0; p < kc; p++, pa += MR, pb += 32) {
+        __m512 b0 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128((const __m128i*)(const void*)pb)));
+        __m512 b1 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128((const __m128i*)(const void*)(pb + 16))));
+        for (uint32_t i = 0; i < MR; i++) {
+            __m512 av = _mm512_set1_ps(pa[i]);
+            acc[i][0] = _mm512_fmadd_ps(av, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(av, b1, acc[i][1]);
+        }
+    }
+    rtka_gemm_store_avx512(acc, c, ldc, accumulate);
+}
+
+/* 16 plane bits are directly a mask register for a masked add / sub */
+static AVX512_TARGET float rtka_ternary_dot_avx512(const uint64_t* RTKA_RESTRICT pos,
+                                                   const uint64_t* RTKA_RESTRICT neg,
+                                                   uint32_t words, const float* RTKA_RESTRICT x) {
+    __m512 acc = _mm512_setzero_ps();
+
+    for (uint32_t w = 0; w < words; w++, x += 64) {
+        uint64_t p = pos[w], n = neg[w];
+        if (!(p | n)) continue;
+        for (uint32_t q = 0; q < 4; q++) {
+            __mmask16 mp = (__mmask16)(p >> (16U * q));
+            __mmask16 mn = (__mmask16)(n >> (16U * q));
+            if (!(mp | mn)) continue;
+            __m512 xv = _mm512_loadu_ps(x + 16U * q);
+            acc = _mm512_mask_add_ps(acc, mp, acc, xv);
+            acc = _mm512_mask_sub_ps(acc, mn, acc, xv);
+        }
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+static const rtka_gemm_kernels_t rtka_gemm_kernels_avx512 = {
+    "avx512", 32U, rtka_gemm_kernel_f32_avx512, rtka_gemm_kernel_i8_avx512,
+    rtka_ternary_dot_avx512
+};
+
+#endif /* RTKA_GEMM_X86 */
+
+/* Follows the vector kernel set, so rtka_simd_set_level() also pins GEMM.
+ * SSE4.1 and NEON have no FMA kernel here and use the vectorized scalar one. */
+static const rtka_gemm_kernels_t* rtka_gemm_kernels(void) {
+    switch (rtka_simd_level()) {
+#ifdef RTKA_GEMM_X86
+        case RTKA_SIMD_AVX512:
+            return &rtka_gemm_kernels_avx512;
+        case RTKA_SIMD_AVX2:
+            return __builtin_cpu_supports("fma") ? &rtka_gemm_kernels_avx2 : &rtka_gemm_kernels_scalar;
+#endif
+        default:
+            return &rtka_gemm_kernels_scalar;
+    }
+}
+
+const char* rtka_gemm_kernel_name(void) {
+    return rtka_gemm_kernels()->name;
+}
+
+/* ============================================================================
+ * PACKING
+ * ============================================================================ */
+
+/* Expands to one loop per source format so the element read is not a
+ * per-element switch */
+#define RTKA_GEMM_READ(op, body_f32, body_signed, body_ternary, body_conf, body_planes) \
+    switch ((op)->format) {                                                     \
+        case RTKA_GEMM_F32: {                                                   \
+            const float* src = (const float*)(op)->data; body_f32; break;       \
+        }                                                                       \
+        case RTKA_GEMM_SIGNED: {                                                \
+            const rtka_state_t* src = (const rtka_state_t*)(op)->data; body_signed; break; \
+        }                                                                       \
+        case RTKA_GEMM_TERNARY: {                                               \
+            const rtka_state_t* src = (const rtka_state_t*)(op)->data; body_ternary; break; \
+        }                                                                       \
+        case RTKA_GEMM_PLANES: {                                                \
+            const rtka_value_t* src = (const rtka_value_t*)(op)->data;          \
+            const rtka_confidence_t* conf = (op)->confidences; body_planes; break; \
+        }                                                                       \
+        default: {                                                              \
+            const rtka_state_t* src = (const rtka_state_t*)(op)->data; body_conf; break; \
+        }                                                                       \
+    }
+
+#define PACK_A_LOOP(EXPR)                                                       \
+    for (uint32_t r = 0; r < mc; r += MR) {                                     \
+        uint32_t rows = mc - r < MR ? mc - r : MR;                              \
+        for (uint32_t p = 0; p < kc; p++) {                                     \
+            size_t base = (size_t)(p0 + p) * a->col_stride;                     \
+            for (uint32_t ii = 0; ii < rows; ii++) {                            \
+                size_t idx = base + (size_t)(i0 + r + ii) * a->row_stride;      \
+                dst[p * MR + ii] = (EXPR);                                      \
+            }                                                                   \
+            for (uint32_t ii = rows; ii < MR; ii++) dst[p * MR + ii] = 0.0f;    \
+        }                                                                       \
+        dst += (size_t)kc * MR;                                                 \
+    }
+
+static void rtka_gemm_pack_a(const rtka_gemm_operand_t* a, uint32_t i0, uint32_t mc,
+                             uint32_t p0, uint32_t kc, float* RTKA_RESTRICT dst) {
+    RTKA_GEMM_READ(a,
+        PACK_A_LOOP(src[idx]),
+        PACK_A_LOOP((float)src[idx].value * src[idx].confidence),
+        PACK_A_LOOP((float)src[idx].value),
+        PACK_A_LOOP(src[idx].confidence),
+        PACK_A_LOOP((float)src[idx] * conf[idx]))
+}
+
+#define PACK_B_LOOP(T, EXPR)                                                    \
+    for (uint32_t s = 0; s < nc; s += nr) {                                     \
+        uint32_t cols = nc - s < nr ? nc - s : nr;                              \
+        for (uint32_t p = 0; p < kc; p++) {                                     \
+            size_t base = (size_t)(p0 + p) * b->row_stride;                     \
+            T* out = (T*)dst + (size_t)s * kc + (size_t)p * nr;                 \
+            for (uint32_t jj = 0; jj < cols; jj++) {                            \
+                size_t idx = base + (size_t)(j0 + s + jj) * b->col_stride;      \
+                out[jj] = (T)(EXPR);                                            \
+            }                                                                   \
+            for (uint32_t jj = cols; jj < nr; jj++) out[jj] = (T)0;             \
+        }                                                                       \
+    }
+
+static void rtka_gemm_pack_b(const rtka_gemm_operand_t* b, uint32_t p0, uint32_t kc,
+                             uint32_t j0, uint32_t nc, uint32_t nr, void* RTKA_RESTRICT dst) {
+    RTKA_GEMM_READ(b,
+        PACK_B_LOOP(float, src[idx]),
+        PACK_B_LOOP(float, (float)src[idx].value * src[idx].confidence),
+        PACK_B_LOOP(int8_t, src[idx].value),
+        PACK_B_LOOP(float, src[idx].confidence),
+        PACK_B_LOOP(float, (float)src[idx] * conf[idx]))
+}
+
+/* ============================================================================
+ * TILE DRIVER
+ * ============================================================================ */
+
+typedef struct {
+    uint32_t m, n, k;
+    const rtka_gemm_operand_t* a;
+    const rtka_gemm_operand_t* b;
+    float* c;
+    uint32_t ldc;
+    bool accumulate;
+    uint32_t tiles_n;
+    const rtka_gemm_kernels_t* kernels;
+} rtka_gemm_job_t;
+
+/* Packing buffers, one pair per thread for the life of the thread */
+static _Thread_local float* rtka_gemm_pack_a_buf = NULL;
+static _Thread_local float* rtka_gemm_pack_b_buf = NULL;
+
+static bool rtka_gemm_workspace(void) {
+    if (RTKA_LIKELY(rtka_gemm_pack_a_buf && rtka_gemm_pack_b_buf)) return true;
+    if (!rtka_gemm_pack_a_buf) {
+        rtka_gemm_pack_a_buf = aligned_alloc(64, (size_t)RTKA_GEMM_MC * RTKA_GEMM_KC * sizeof(float));
+    }
+    if (!rtka_gemm_pack_b_buf) {
+        rtka_gemm_pack_b_buf = aligned_alloc(64, (size_t)RTKA_GEMM_KC * RTKA_GEMM_NC * sizeof(float));
+    }
+    return rtka_gemm_pack_a_buf && rtka_gemm_pack_b_buf;
+}
+
+static RTKA_INLINE float rtka_gemm_at(const rtka_gemm_operand_t* op, uint32_t r, uint32_t col) {
+    size_t idx = (size_t)r * op->row_stride + (size_t)col * op->col_stride;
+    float v = 0.0f;
+    RTKA_GEMM_READ(op, v = src[idx], v = (float)src[idx].value * src[idx].confidence,
+                   v = (float)src[idx].value, v = src[idx].confidence,
+                   v = (float)src[idx] * conf[idx])
+    return v;
+}
+
+/* Unpacked fallback when a thread cannot get its packing buffers */
+static void rtka_gemm_tile_naive(const rtka_gemm_job_t* job, uint32_t i0, uint32_t mc,
+                                 uint32_t j0, uint32_t nc) {
+    for (uint32_t i = i0; i < i0 + mc; i++) {
+        for (uint32_t j = j0; j < j0 + nc; j++) {
+            float sum = 0.0f;
+            for (uint32_t p = 0; p < job->k; p++) {
+                sum += rtka_gemm_at(job->a, i, p) * rtka_gemm_at(job->b, p, j);
+            }
+            float* out = &job->c[(size_t)i * job->ldc + j];
+            *out = job->accumulate ? *out + sum : sum;
+        }
+    }
+}
+
+static void rtka_gemm_tile(const rtka_gemm_job_t* job, uint32_t i0, uint32_t mc,
+                           uint32_t j0, uint32_t nc) {
+    if (!rtka_gemm_workspace()) {
+        rtka_gemm_tile_naive(job, i0, mc, j0, nc);
+        return;
+    }
+
+    const rtka_gemm_kernels_t* kern = job->kernels;
+    const uint32_t nr = kern->nr;
+    const bool ternary = job->b->format == RTKA_GEMM_TERNARY;
+    const rtka_gemm_kernel_fn kernel = ternary ? kern->i8 : kern->f32;
+    const size_t b_elem = ternary ? sizeof(int8_t) : sizeof(float);
+    float* pack_a = rtka_gemm_pack_a_buf;
+    char* pack_b = (char*)rtka_gemm_pack_b_buf;
+    float edge[MR * RTKA_GEMM_NR_MAX];
+
+    for (uint32_t p0 = 0; p0 < job->k; p0 += RTKA_GEMM_KC) {
+        uint32_t kc = job->k - p0 < RTKA_GEMM_KC ? job->k - p0 : RTKA_GEMM_KC;
+        bool acc = job->accumulate || p0 > 0;
+
+        rtka_gemm_pack_b(job->b, p0, kc, j0, nc, nr, pack_b);
+        rtka_gemm_pack_a(job->a, i0, mc, p0, kc, pack_a);
+
+        for (uint32_t s = 0; s < nc; s += nr) {
+            uint32_t cols = nc - s < nr ? nc - s : nr;
+            const void* pb = pack_b + (size_t)s * kc * b_elem;
+
+            for (uint32_t r = 0; r < mc; r += MR) {
+                uint32_t rows = mc - r < MR ? mc - r : MR;
+                const float* pa = pack_a + (size_t)r * kc;
+                float* c = job->c + (size_t)(i0 + r) * job->ldc + (j0 + s);
+
+                if (RTKA_LIKELY(rows == MR && cols == nr)) {
+                    kernel(kc, pa, pb, c, job->ldc, acc);
+                    continue;
+                }
+
+                kernel(kc, pa, pb, edge, nr, false);
+                for (uint32_t ii = 0; ii < rows; ii++) {
+                    for (uint32_t jj = 0; jj < cols; jj++) {
+                        float v = edge[ii * nr + jj];
+                        float* out = &c[(size_t)ii * job->ldc + jj];
+                        *out = acc ? *out + v : v;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void rtka_gemm_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const rtka_gemm_job_t* job = (const rtka_gemm_job_t*)ctx;
+
+    for (uint32_t t = begin; t < end; t++) {
+        uint32_t i0 = (t / job->tiles_n) * RTKA_GEMM_MC;
+        uint32_t j0 = (t % job->tiles_n) * RTKA_GEMM_NC;
+        uint32_t mc = job->m - i0 < RTKA_GEMM_MC ? job->m - i0 : RTKA_GEMM_MC;
+        uint32_t nc = job->n - j0 < RTKA_GEMM_NC ? job->n - j0 : RTKA_GEMM_NC;
+        rtka_gemm_tile(job, i0, mc, j0, nc);
+    }
+}
+
+void rtka_gemm(uint32_t m, uint32_t n, uint32_t k,
+               const rtka_gemm_operand_t* a, const rtka_gemm_operand_t* b,
+               float* c, uint32_t ldc, bool accumulate) {
+    if (!a || !b || !c || m == 0 || n == 0) return;
+
+    if (k == 0) {
+        if (!accumulate) {
+            for (uint32_t i = 0; i < m; i++) memset(c + (size_t)i * ldc, 0, n * sizeof(float));
+        }
+        return;
+    }
+
+    uint32_t tiles_m = (m + RTKA_GEMM_MC - 1U) / RTKA_GEMM_MC;
+    uint32_t tiles_n = (n + RTKA_GEMM_NC - 1U) / RTKA_GEMM_NC;
+    rtka_gemm_job_t job = {
+        .m = m, .n = n, .k = k, .a = a, .b = b, .c = c, .ldc = ldc,
+        .accumulate = accumulate, .tiles_n = tiles_n, .kernels = rtka_gemm_kernels()
+    };
+
+    uint32_t tiles = tiles_m * tiles_n;
+    if (tiles > 1U && (uint64_t)m * n * k >= RTKA_GEMM_PARALLEL_MIN_FLOPS) {
+        rtka_pool_parallel_for(rtka_pool_default(), 0, tiles, 1, rtka_gemm_range, &job);
+    } else {
+        rtka_gemm_range(&job, 0, tiles, 0);
+    }
+}
+
+/* ============================================================================
+ * TERNARY BIT-PLANES
+ * ============================================================================ */
+
+rtka_ternary_matrix_t* rtka_ternary_pack(const rtka_state_t* data, uint32_t rows, uint32_t cols,
+                                         uint32_t row_stride, uint32_t col_stride) {
+    if (!data || rows == 0 || cols == 0) return NULL;
+
+    uint32_t words = (cols + 63U) / 64U;
+    size_t header = (sizeof(rtka_ternary_matrix_t) + 63U) & ~(size_t)63U;
+    size_t plane = (size_t)rows * words * sizeof(uint64_t);
+    size_t bytes = (header + 2U * plane + 63U) & ~(size_t)63U;
+    rtka_ternary_matrix_t* m = aligned_alloc(64, bytes);
+    if (!m) return NULL;
+    memset(m, 0, bytes);
+
+    m->rows = rows;
+    m->cols = cols;
+    m->words = words;
+    m->pos = (uint64_t*)(void*)((char*)m + header);
+    m->neg = m->pos + (size_t)rows * words;
+
+    for (uint32_t r = 0; r < rows; r++) {
+        uint64_t* pos = m->pos + (size_t)r * words;
+        uint64_t* neg = m->neg + (size_t)r * words;
+        for (uint32_t c = 0; c < cols; c++) {
+            rtka_value_t v = data[(size_t)r * row_stride + (size_t)c * col_stride].value;
+            uint64_t bit = 1ULL << (c & 63U);
+            if (v == RTKA_TRUE) pos[c >> 6] |= bit;
+            else if (v == RTKA_FALSE) neg[c >> 6] |= bit;
+        }
+    }
+    return m;
+}
+
+void rtka_ternary_matrix_free(rtka_ternary_matrix_t* matrix) {
+    free(matrix);
+}
+
+typedef struct {
+    const rtka_ternary_matrix_t* w;
+    const rtka_ternary_matrix_t* x_bits;
+    const float* x;
+    uint32_t batch;
+    uint32_t ldx;
+    float* y;
+    uint32_t ldy;
+    rtka_ternary_dot_fn dot;
+} rtka_ternary_job_t;
+
+/* One weight row against every activation row, so the row stays in L1 */
+static void rtka_ternary_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const rtka_ternary_job_t* job = (const rtka_ternary_job_t*)ctx;
+    const uint32_t words = job->w->words;
+
+    for (uint32_t r = begin; r < end; r++) {
+        const uint64_t* wp = job->w->pos + (size_t)r * words;
+        const uint64_t* wn = job->w->neg + (size_t)r * words;
+
+        for (uint32_t b = 0; b < job->batch; b++) {
+            float sum;
+            if (job->x_bits) {
+                const uint64_t* xp = job->x_bits->pos + (size_t)b * words;
+                const uint64_t* xn = job->x_bits->neg + (size_t)b * words;
+                int64_t dot = 0;
+                for (uint32_t i = 0; i < words; i++) {
+                    dot += __builtin_popcountll((xp[i] & wp[i]) | (xn[i] & wn[i]));
+                    dot -= __builtin_popcountll((xp[i] & wn[i]) | (xn[i] & wp[i]));
+                }
+                sum = (float)dot;
+            } else {
+                sum = job->dot(wp, wn, words, job->x + (size_t)b * job->ldx);
+            }
+            job->y[(size_t)b * job->ldy + r] = sum;
+        }
+    }
+}
+
+static void rtka_ternary_run(rtka_ternary_job_t* job) {
+    uint64_t work = (uint64_t)job->batch * job->w->rows * job->w->cols;
+    if (job->w->rows > 1U && work >= RTKA_GEMM_PARALLEL_MIN_FLOPS) {
+        rtka_pool_parallel_for(rtka_pool_default(), 0, job->w->rows, 0, rtka_ternary_range, job);
+    } else {
+        rtka_ternary_range(job, 0, job->w->rows, 0);
+    }
+}
+
+void rtka_ternary_gemm(const rtka_ternary_matrix_t* w, const float* x, uint32_t batch,
+                       uint32_t ldx, float* y, uint32_t ldy) {
+    if (!w || !x || !y || batch == 0 || ldx < rtka_ternary_row_span(w)) return;
+
+    rtka_ternary_job_t job = {
+        .w = w, .x = x, .batch = batch, .ldx = ldx, .y = y, .ldy = ldy,
+        .dot = rtka_gemm_kernels()->ternary_dot
+    };
+    rtka_ternary_run(&job);
+}
+
+void rtka_ternary_gemm_bits(const rtka_ternary_matrix_t* x, const rtka_ternary_matrix_t* w,
+                            float* y, uint32_t ldy) {
+    if (!x || !w || !y || x->cols != w->cols) return;
+
+    rtka_ternary_job_t job = { .w = w, .x_bits = x, .batch = x->rows, .y = y, .ldy = ldy };
+    rtka_ternary_run(&job);
+}
@@ -0,0 +1,117 @@
+/**
+ * File: rtka_gemm.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Blocked GEMM - C (m x n) = A (m x k) * B (k x n) on the signed
+ * confidence plane, s = value * confidence
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial blocked GEMM
+ *          A and B packed into MR-row / NR-column panels per KC slice,
+ *          register-blocked micro-kernel (scalar / AVX2+FMA / AVX-512)
+ *          chosen from the rtka_simd_level() kernel set
+ *          Ternary operands pack to int8 panels, a quarter of the float
+ *          panel footprint, widened inside the micro-kernel
+ *          M x N tiles run in parallel on rtka_pool_default()
+ * v1.1.0 - Multiply-free ternary path
+ *          Weights as positive / negative bit-planes (2 bits per weight);
+ *          dot products are masked adds and subtracts (AVX-512 mask
+ *          registers, AVX2 blends, set-bit walk) or, with ternary
+ *          activations, popcounts of the plane intersections
+ * v1.1.1 - RTKA_GEMM_PLANES reads SoA tensors without conversion
+ *
+ * Operands are strided views, so transposes cost nothing: element (r, c)
+ * lives at data[r * row_stride + c * col_stride].
+ */
+
+#ifndef RTKA_GEMM_H
+#define RTKA_GEMM_H
+
+#include "rtka_types.h"
+
+/* Blocking parameters - a KC x NC slice of B stays in L2, an MC x KC
+ * slice of A in L1/L2, one MR x NR tile of C in registers */
+#define RTKA_GEMM_MR 6U
+#define RTKA_GEMM_KC 256U
+#define RTKA_GEMM_MC 72U    /* Multiple of MR */
+#define RTKA_GEMM_NC 256U   /* Multiple of every NR */
+
+/* Below this many multiply-adds a GEMM stays on the calling thread */
+#define RTKA_GEMM_PARALLEL_MIN_FLOPS (1U << 21)
+
+typedef enum {
+    RTKA_GEMM_F32,      /* float elements */
+    RTKA_GEMM_SIGNED,   /* rtka_state_t read as value * confidence */
+    RTKA_GEMM_TERNARY,  /* rtka_state_t read as value alone, {-1, 0, +1} */
+    RTKA_GEMM_CONFIDENCE, /* rtka_state_t read as confidence alone (gradients) */
+    RTKA_GEMM_PLANES    /* rtka_value_t plane times the confidences plane (SoA) */
+} rtka_gemm_format_t;
+
+typedef struct {
+    const void* data;
+    uint32_t row_stride;    /* In elements */
+    uint32_t col_stride;
+    rtka_gemm_format_t format;
+    const rtka_confidence_t* confidences;   /* RTKA_GEMM_PLANES only */
+} rtka_gemm_operand_t;
+
+/**
+ * c[i * ldc + j] (+)= sum_p A(i, p) * B(p, j)
+ * accumulate = false overwrites C. A ternary B takes the int8 panel path.
+ */
+void rtka_gemm(uint32_t m, uint32_t n, uint32_t k,
+               const rtka_gemm_operand_t* a, const rtka_gemm_operand_t* b,
+               float* c, uint32_t ldc, bool accumulate);
+
+/* Name of the micro-kernel set rtka_gemm currently uses */
+const char* rtka_gemm_kernel_name(void);
+
+/* ============================================================================
+ * TERNARY BIT-PLANE MATRICES
+ * ============================================================================ */
+
+/* rows x cols of {-1, 0, +1}: bit c of row r is set in pos for +1, in neg
+ * for -1. Rows are padded to whole 64-bit words, padding bits are clear. */
+typedef struct {
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t words;     /* uint64_t per row */
+    uint64_t* pos;
+    uint64_t* neg;
+} rtka_ternary_matrix_t;
+
+/**
+ * Pack element (r, c) = data[r * row_stride + c * col_stride] by its value
+ * alone; confidence is dropped, so packing is the quantization step.
+ * Use rtka_tensor_is_ternary() first when the packing must be exact.
+ */
+RTKA_NODISCARD rtka_ternary_matrix_t* rtka_ternary_pack(const rtka_state_t* data,
+                                                        uint32_t rows, uint32_t cols,
+                                                        uint32_t row_stride, uint32_t col_stride);
+void rtka_ternary_matrix_free(rtka_ternary_matrix_t* matrix);
+
+/* Floats per activation row the float kernel may read: words * 64 */
+RTKA_INLINE uint32_t rtka_ternary_row_span(const rtka_ternary_matrix_t* w) {
+    return w->words * 64U;
+}
+
+/**
+ * y[b * ldy + r] = sum_c w(r, c) * x[b * ldx + c] for b < batch, r < w->rows
+ * Only adds and subtracts. ldx >= rtka_ternary_row_span(w); the padding
+ * floats are read but never contribute, whatever they hold.
+ */
+void rtka_ternary_gemm(const rtka_ternary_matrix_t* w, const float* x, uint32_t batch,
+                       uint32_t ldx, float* y, uint32_t ldy);
+
+/* Both operands ternary: y[b * ldy + r] = <x row b, w row r> by popcount;
+ * x->cols must equal w->cols */
+void rtka_ternary_gemm_bits(const rtka_ternary_matrix_t* x, const rtka_ternary_matrix_t* w,
+                            float* y, uint32_t ldy);
+
+#endif /* RTKA_GEMM_H */
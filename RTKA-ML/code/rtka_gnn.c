@@ -11,52 +11,398 @@
 
 #include "rtka_gnn.h"
 #include "rtka_memory.h"
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GNN_X86 1
+#include <immintrin.h>
+#endif
+
+#define GNN_MIN_CAPACITY   16U
+#define SPMM_GRAIN         64U      /* Destination rows per claimed chunk */
+#define GAT_LEAKY_SLOPE    0.2f
 
 /* Create graph */
 rtka_graph_t* rtka_graph_create(uint32_t num_nodes, uint32_t num_edges) {
-    rtka_graph_t* graph = (rtka_graph_t*)rtka_alloc_state();
+    rtka_graph_t* graph = (rtka_graph_t*)calloc(1, sizeof(rtka_graph_t));
     if (!graph) return NULL;
     
     graph->num_nodes = num_nodes;
     graph->num_edges = 0;
-    graph->edge_index = (uint32_t*)rtka_alloc_states(2 * num_edges * sizeof(uint32_t) / sizeof(rtka_state_t));
+    graph->edge_capacity = num_edges > GNN_MIN_CAPACITY ? num_edges : GNN_MIN_CAPACITY;
+    graph->edge_index = (uint32_t*)malloc(2U * (size_t)graph->edge_capacity * sizeof(uint32_t));
     
     /* Initialize node features */
     uint32_t shape[] = {num_nodes, 1};
     graph->node_features = rtka_tensor_unknown(shape, 2);
     
+    if (!graph->edge_index || !graph->node_features) {
+        rtka_graph_free(graph);
+        return NULL;
+    }
+    
     return graph;
 }
 
 /* Add edge */
 void rtka_graph_add_edge(rtka_graph_t* graph, uint32_t src, uint32_t dst) {
-    if (graph->num_edges >= graph->num_nodes * graph->num_nodes) return;
+    if (!graph || src >= graph->num_nodes || dst >= graph->num_nodes) return;
+    
+    if (graph->num_edges == graph->edge_capacity) {
+        if (graph->edge_capacity > UINT32_MAX / 2U) return;
+        uint32_t capacity = graph->edge_capacity * 2U;
+        uint32_t* grown = (uint32_t*)realloc(graph->edge_index, 2U * (size_t)capacity * sizeof(uint32_t));
+        if (!grown) return;
+        graph->edge_index = grown;
+        graph->edge_capacity = capacity;
+    }
     
     graph->edge_index[2 * graph->num_edges] = src;
     graph->edge_index[2 * graph->num_edges + 1] = dst;
     graph->num_edges++;
 }
 
-/* Compute adjacency matrix */
-void rtka_graph_compute_adjacency(rtka_graph_t* graph) {
-    uint32_t shape[] = {graph->num_nodes, graph->num_nodes};
-    graph->adjacency = rtka_tensor_zeros(shape, 2);
+static void graph_release_csr(rtka_graph_t* graph) {
+    free(graph->in_offsets);
+    free(graph->in_sources);
+    free(graph->edge_norm);
+    free(graph->self_norm);
+    graph->in_offsets = NULL;
+    graph->in_sources = NULL;
+    graph->edge_norm = NULL;
+    graph->self_norm = NULL;
+}
+
+/* Destination-major CSR by two stable counting sorts (source, then
+ * destination), so every row comes out with its sources ascending and
+ * duplicates adjacent */
+rtka_error_t rtka_graph_compute_adjacency(rtka_graph_t* graph) {
+    if (!graph) return RTKA_ERROR_NULL_POINTER;
+    graph_release_csr(graph);
+    
+    uint32_t n = graph->num_nodes, m = graph->num_edges;
+    const uint32_t* edges = graph->edge_index;
+    
+    uint32_t* offsets = (uint32_t*)calloc((size_t)n + 1U, sizeof(uint32_t));
+    uint32_t* cursor = (uint32_t*)malloc(((size_t)n + 1U) * sizeof(uint32_t));
+    uint32_t* by_src = (uint32_t*)malloc(((size_t)m + 1U) * sizeof(uint32_t));
+    uint32_t* sources = (uint32_t*)malloc(((size_t)m + 1U) * sizeof(uint32_t));
+    float* self_norm = (float*)malloc(((size_t)n + 1U) * sizeof(float));
+    if (!offsets || !cursor || !by_src || !sources || !self_norm) {
+        free(offsets); free(cursor); free(by_src); free(sources); free(self_norm);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    
+    /* Edges ordered by source */
+    memset(cursor, 0, ((size_t)n + 1U) * sizeof(uint32_t));
+    for (uint32_t e = 0; e < m; e++) cursor[edges[2 * e] + 1U]++;
+    for (uint32_t v = 0; v < n; v++) cursor[v + 1U] += cursor[v];
+    for (uint32_t e = 0; e < m; e++) by_src[cursor[edges[2 * e]]++] = e;
+    
+    /* Then stably by destination */
+    for (uint32_t e = 0; e < m; e++) offsets[edges[2 * e + 1] + 1U]++;
+    for (uint32_t v = 0; v < n; v++) offsets[v + 1U] += offsets[v];
+    memcpy(cursor, offsets, (size_t)n * sizeof(uint32_t));
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t e = by_src[i];
+        sources[cursor[edges[2 * e + 1]]++] = edges[2 * e];
+    }
+    
+    /* Drop repeated edges, compacting rows in place */
+    uint32_t kept = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t begin = offsets[v], end = offsets[v + 1U];
+        offsets[v] = kept;
+        for (uint32_t i = begin; i < end; i++) {
+            if (i == begin || sources[i] != sources[i - 1U]) sources[kept++] = sources[i];
+        }
+    }
+    offsets[n] = kept;
+    free(cursor);
+    
+    free(by_src);
+    
+    float* inv_sqrt = (float*)malloc(((size_t)n + 1U) * sizeof(float));
+    float* edge_norm = (float*)malloc(((size_t)kept + 1U) * sizeof(float));
+    if (!inv_sqrt || !edge_norm) {
+        free(inv_sqrt); free(edge_norm); free(offsets); free(sources); free(self_norm);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    
+    for (uint32_t v = 0; v < n; v++) {
+        float degree = (float)(offsets[v + 1U] - offsets[v]) + 1.0f;
+        inv_sqrt[v] = 1.0f / sqrtf(degree);
+        self_norm[v] = 1.0f / degree;
+    }
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t i = offsets[v]; i < offsets[v + 1U]; i++) {
+            edge_norm[i] = inv_sqrt[sources[i]] * inv_sqrt[v];
+        }
+    }
+    free(inv_sqrt);
+    
+    graph->in_offsets = offsets;
+    graph->in_sources = sources;
+    graph->edge_norm = edge_norm;
+    graph->self_norm = self_norm;
+    graph->csr_edges = m;
+    return RTKA_SUCCESS;
+}
+
+void rtka_graph_free(rtka_graph_t* graph) {
+    if (!graph) return;
+    graph_release_csr(graph);
+    free(graph->edge_index);
+    if (graph->node_features) rtka_tensor_free(graph->node_features);
+    if (graph->edge_features) rtka_tensor_free(graph->edge_features);
+    free(graph);
+}
+
+/* MSG_SUM row fold: acc[f] = acc[f] OR ((TRUE, coef) AND msg[f]) */
+typedef void (*gnn_fold_fn)(rtka_state_t* acc, const rtka_state_t* msg, float coef, uint32_t count);
+
+typedef struct {
+    rtka_simd_level_t level;
+    gnn_fold_fn fold;
+} gnn_kernel_t;
+
+static void fold_scalar(rtka_state_t* acc, const rtka_state_t* msg, float coef, uint32_t count) {
+    const rtka_state_t weight = rtka_make_state(RTKA_TRUE, coef);
+    for (uint32_t f = 0; f < count; f++) {
+        acc[f] = rtka_combine_or(acc[f], rtka_combine_and(weight, msg[f]));
+    }
+}
+
+static const gnn_kernel_t kernel_scalar = {RTKA_SIMD_SCALAR, fold_scalar};
+
+#ifdef GNN_X86
+
+/* Four interleaved states per vector: even lanes are values, where AND
+ * with TRUE is the identity and OR is the maximum of -1 / 0 / 1; odd lanes
+ * are confidences. Value lanes are masked out of the float arithmetic. */
+__attribute__((target("avx2")))
+static void fold_avx2(rtka_state_t* acc, const rtka_state_t* msg, float coef, uint32_t count) {
+    const __m256 conf_lanes = _mm256_castsi256_ps(_mm256_set_epi32(-1, 0, -1, 0, -1, 0, -1, 0));
+    const __m256 weight = _mm256_set1_ps(coef);
+    uint32_t f = 0;
+    
+    for (; f + 4U <= count; f += 4U) {
+        __m256 a = _mm256_loadu_ps((const float*)(acc + f));
+        __m256 m = _mm256_loadu_ps((const float*)(msg + f));
+        __m256 ac = _mm256_and_ps(a, conf_lanes);
+        __m256 c = _mm256_mul_ps(weight, _mm256_and_ps(m, conf_lanes));
+        __m256 conf = _mm256_sub_ps(_mm256_add_ps(ac, c), _mm256_mul_ps(ac, c));
+        __m256 value = _mm256_castsi256_ps(_mm256_max_epi32(_mm256_castps_si256(a), _mm256_castps_si256(m)));
+        _mm256_storeu_ps((float*)(acc + f), _mm256_blend_ps(value, conf, 0xAA));
+    }
     
-    for (uint32_t e = 0; e < graph->num_edges; e++) {
-        uint32_t src = graph->edge_index[2 * e];
-        uint32_t dst = graph->edge_index[2 * e + 1];
-        uint32_t idx[] = {src, dst};
+    fold_scalar(acc + f, msg + f, coef, count - f);
+}
+
+static const gnn_kernel_t kernel_avx2 = {RTKA_SIMD_AVX2, fold_avx2};
+
+#endif /* GNN_X86 */
+
+static _Atomic(const gnn_kernel_t*) g_gnn_kernel = NULL;
+
+static const gnn_kernel_t* kernel_for_level(rtka_simd_level_t level) {
+    switch (level) {
+        case RTKA_SIMD_SCALAR:
+            return &kernel_scalar;
+#ifdef GNN_X86
+        case RTKA_SIMD_AVX2:
+            if (!__builtin_cpu_supports("avx2")) return NULL;
+            return &kernel_avx2;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static const gnn_kernel_t* select_kernel(void) {
+#ifdef GNN_X86
+    __builtin_cpu_init();
+#endif
+    const gnn_kernel_t* k = kernel_for_level(RTKA_SIMD_AVX2);
+    return k ? k : &kernel_scalar;
+}
+
+static RTKA_INLINE const gnn_kernel_t* gnn_kernel(void) {
+    const gnn_kernel_t* k = atomic_load_explicit(&g_gnn_kernel, memory_order_relaxed);
+    if (RTKA_UNLIKELY(!k)) {
+        k = select_kernel();
+        atomic_store_explicit(&g_gnn_kernel, k, memory_order_relaxed);
+    }
+    return k;
+}
+
+rtka_simd_level_t rtka_gnn_kernel(void) {
+    return gnn_kernel()->level;
+}
+
+bool rtka_gnn_set_kernel(rtka_simd_level_t level) {
+    const gnn_kernel_t* k = kernel_for_level(level);
+    if (!k) return false;
+    atomic_store_explicit(&g_gnn_kernel, k, memory_order_relaxed);
+    return true;
+}
+
+typedef struct {
+    const uint32_t* offsets;
+    const uint32_t* sources;
+    const rtka_state_t* messages;
+    const rtka_state_t* self_messages;  /* NULL: no self loop */
+    const float* edge_coef;             /* NULL: 1 on every edge */
+    const float* self_coef;
+    rtka_state_t* out;
+    uint32_t features;
+    rtka_aggregation_t aggregation;
+    gnn_fold_fn fold;
+    uint32_t* votes;                    /* MSG_TERNARY: true / false counts, 2 x features per worker */
+    float* vote_conf;                   /* and confidence sums, features per worker */
+} spmm_ctx_t;
+
+/* Folds one weighted message row into the accumulators of the row */
+static RTKA_INLINE void spmm_accumulate(const spmm_ctx_t* ctx, rtka_state_t* acc, uint32_t* votes,
+                                        float* vote_conf, const rtka_state_t* msg, float coef) {
+    uint32_t features = ctx->features;
+    
+    switch (ctx->aggregation) {
+        case MSG_SUM:
+        case MSG_MEAN:
+            ctx->fold(acc, msg, coef, features);
+            break;
+        case MSG_MAX:
+            for (uint32_t f = 0; f < features; f++) {
+                rtka_confidence_t c = coef * msg[f].confidence;
+                if (c > acc[f].confidence) acc[f] = rtka_make_state(msg[f].value, c);
+            }
+            break;
+        case MSG_TERNARY:
+            for (uint32_t f = 0; f < features; f++) {
+                votes[f] += msg[f].value == RTKA_TRUE;
+                votes[features + f] += msg[f].value == RTKA_FALSE;
+                vote_conf[f] += coef * msg[f].confidence;
+            }
+            break;
+    }
+}
+
+static void spmm_rows(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    const spmm_ctx_t* ctx = (const spmm_ctx_t*)arg;
+    uint32_t features = ctx->features;
+    uint32_t* votes = ctx->votes ? ctx->votes + (size_t)worker * 2U * features : NULL;
+    float* vote_conf = ctx->vote_conf ? ctx->vote_conf + (size_t)worker * features : NULL;
+    
+    for (uint32_t dst = begin; dst < end; dst++) {
+        rtka_state_t* acc = ctx->out + (size_t)dst * features;
+        uint32_t row_begin = ctx->offsets[dst], row_end = ctx->offsets[dst + 1U];
+        uint32_t count = row_end - row_begin + (ctx->self_messages != NULL);
+        
+        if (ctx->aggregation == MSG_TERNARY) {
+            memset(votes, 0, 2U * features * sizeof(uint32_t));
+            memset(vote_conf, 0, features * sizeof(float));
+        } else {
+            for (uint32_t f = 0; f < features; f++) acc[f] = rtka_make_state(RTKA_FALSE, 0.0f);
+        }
+        
+        for (uint32_t i = row_begin; i < row_end; i++) {
+            const rtka_state_t* msg = ctx->messages + (size_t)ctx->sources[i] * features;
+            float coef = ctx->edge_coef ? ctx->edge_coef[i] : 1.0f;
+            spmm_accumulate(ctx, acc, votes, vote_conf, msg, coef);
+        }
+        if (ctx->self_messages) {
+            float coef = ctx->self_coef ? ctx->self_coef[dst] : 1.0f;
+            spmm_accumulate(ctx, acc, votes, vote_conf, ctx->self_messages + (size_t)dst * features, coef);
+        }
         
-        rtka_tensor_set(graph->adjacency, idx, rtka_make_state(RTKA_TRUE, 1.0f));
+        if (ctx->aggregation == MSG_MEAN && count > 0) {
+            for (uint32_t f = 0; f < features; f++) acc[f].confidence /= (float)count;
+        } else if (ctx->aggregation == MSG_TERNARY) {
+            /* The vote of rtka_gnn_aggregate_ternary, counted row-wise */
+            for (uint32_t f = 0; f < features; f++) {
+                if (count == 0) {
+                    acc[f] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
+                    continue;
+                }
+                uint32_t t = votes[f], fl = votes[features + f], u = count - t - fl;
+                rtka_value_t result = RTKA_UNKNOWN;
+                if (t > fl && t > u) result = RTKA_TRUE;
+                else if (fl > t && fl > u) result = RTKA_FALSE;
+                acc[f] = rtka_make_state(result, vote_conf[f] / (float)count);
+            }
+        }
     }
 }
 
+/* messages-like tensor: num_nodes rows of features contiguous AoS states */
+static bool spmm_operand(const rtka_tensor_t* t, uint32_t rows, uint32_t features) {
+    return t && t->data && t->ndim == 2 && t->shape[0] == rows && t->shape[1] == features &&
+           t->strides[0] == features && t->strides[1] == 1U;
+}
+
+static rtka_error_t spmm_run(rtka_graph_t* graph, const rtka_tensor_t* messages,
+                             const rtka_tensor_t* self_messages, const float* edge_coef,
+                             const float* self_coef, rtka_aggregation_t aggregation,
+                             rtka_thread_pool_t* pool, rtka_tensor_t* out) {
+    if (!graph || !messages || !out) return RTKA_ERROR_NULL_POINTER;
+    uint32_t n = graph->num_nodes, features = messages->ndim == 2 ? messages->shape[1] : 0;
+    if (!spmm_operand(messages, n, features) || !spmm_operand(out, n, features) ||
+        (self_messages && !spmm_operand(self_messages, n, features))) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    if (!graph->in_offsets || graph->csr_edges != graph->num_edges) {
+        rtka_error_t err = rtka_graph_compute_adjacency(graph);
+        if (err != RTKA_SUCCESS) return err;
+    }
+    if (!pool) pool = rtka_pool_default();
+    
+    spmm_ctx_t ctx = {
+        .offsets = graph->in_offsets, .sources = graph->in_sources,
+        .messages = messages->data, .self_messages = self_messages ? self_messages->data : NULL,
+        .edge_coef = edge_coef, .self_coef = self_coef, .out = out->data,
+        .features = features, .aggregation = aggregation, .fold = gnn_kernel()->fold
+    };
+    
+    if (aggregation == MSG_TERNARY) {
+        size_t workers = (size_t)rtka_pool_size(pool) + 1U;
+        ctx.votes = (uint32_t*)malloc(workers * 2U * features * sizeof(uint32_t) + 1U);
+        ctx.vote_conf = (float*)malloc(workers * features * sizeof(float) + 1U);
+        if (!ctx.votes || !ctx.vote_conf) {
+            free(ctx.votes);
+            free(ctx.vote_conf);
+            return RTKA_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    
+    rtka_pool_parallel_for(pool, 0, n, SPMM_GRAIN, spmm_rows, &ctx);
+    
+    free(ctx.votes);
+    free(ctx.vote_conf);
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_gnn_spmm(rtka_graph_t* graph, const rtka_tensor_t* messages,
+                           const rtka_tensor_t* self_messages, rtka_aggregation_t aggregation,
+                           bool normalize, rtka_thread_pool_t* pool, rtka_tensor_t* out) {
+    if (!graph) return RTKA_ERROR_NULL_POINTER;
+    if (normalize && (!graph->in_offsets || graph->csr_edges != graph->num_edges)) {
+        rtka_error_t err = rtka_graph_compute_adjacency(graph);
+        if (err != RTKA_SUCCESS) return err;
+    }
+    return spmm_run(graph, messages, self_messages,
+                    normalize ? graph->edge_norm : NULL,
+                    normalize ? graph->self_norm : NULL,
+                    aggregation, pool, out);
+}
+
 /* Create GCN layer */
 rtka_gcn_layer_t* rtka_gnn_gcn(uint32_t in_features, uint32_t out_features, bool bias) {
     (void)bias;  /* Unused for now */
-    rtka_gcn_layer_t* layer = (rtka_gcn_layer_t*)rtka_alloc_state();
+    rtka_gcn_layer_t* layer = (rtka_gcn_layer_t*)calloc(1, sizeof(rtka_gcn_layer_t));
     if (!layer) return NULL;
     
     layer->base.base.type = LAYER_LINEAR;
@@ -72,10 +418,7 @@ rtka_gcn_layer_t* rtka_gnn_gcn(uint32_t in_features, uint32_t out_features, bool
     
     /* Xavier init */
     float scale = sqrtf(2.0f / (in_features + out_features));
-    for (uint32_t i = 0; i < weight->size; i++) {
-        weight->data[i].confidence = ((float)rand() / RAND_MAX - 0.5f) * 2.0f * scale;
-        weight->data[i].value = RTKA_UNKNOWN;
-    }
+    rtka_nn_init_uniform(weight, scale);
     
     layer->weight_neighbors = rtka_grad_node_create(weight, true);
     
@@ -90,7 +433,7 @@ rtka_gcn_layer_t* rtka_gnn_gcn(uint32_t in_features, uint32_t out_features, bool
 
 /* Create Ternary GNN layer */
 rtka_tgn_layer_t* rtka_gnn_ternary(uint32_t in_features, uint32_t out_features, rtka_confidence_t threshold) {
-    rtka_tgn_layer_t* layer = (rtka_tgn_layer_t*)rtka_alloc_state();
+    rtka_tgn_layer_t* layer = (rtka_tgn_layer_t*)calloc(1, sizeof(rtka_tgn_layer_t));
     if (!layer) return NULL;
     
     layer->base.base.type = LAYER_TERNARY;
@@ -104,16 +447,7 @@ rtka_tgn_layer_t* rtka_gnn_ternary(uint32_t in_features, uint32_t out_features,
     rtka_tensor_t* msg_weight = rtka_tensor_unknown(msg_shape, 2);
     
     /* Ternary initialization */
-    for (uint32_t i = 0; i < msg_weight->size; i++) {
-        float r = (float)rand() / RAND_MAX;
-        if (r < 0.333f) {
-            msg_weight->data[i] = rtka_make_state(RTKA_FALSE, 1.0f);
-        } else if (r < 0.667f) {
-            msg_weight->data[i] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
-        } else {
-            msg_weight->data[i] = rtka_make_state(RTKA_TRUE, 1.0f);
-        }
-    }
+    rtka_nn_init_ternary(msg_weight);
     
     layer->message_fn = rtka_grad_node_create(msg_weight, true);
     
@@ -128,110 +462,238 @@ rtka_tgn_layer_t* rtka_gnn_ternary(uint32_t in_features, uint32_t out_features,
     return layer;
 }
 
-/* Message passing for GCN */
+/* Create GAT layer */
+rtka_gat_layer_t* rtka_gnn_gat(uint32_t in_features, uint32_t out_features, uint32_t num_heads) {
+    rtka_gat_layer_t* layer = (rtka_gat_layer_t*)calloc(1, sizeof(rtka_gat_layer_t));
+    if (!layer) return NULL;
+    
+    layer->base.base.type = LAYER_ATTENTION;
+    layer->base.base.in_features = in_features;
+    layer->base.base.out_features = out_features;
+    layer->base.aggregation = MSG_SUM;
+    layer->num_heads = num_heads ? num_heads : 1U;
+    layer->dropout = 0.0f;
+    
+    uint32_t weight_shape[] = {in_features, out_features};
+    rtka_tensor_t* weight = rtka_tensor_unknown(weight_shape, 2);
+    uint32_t attention_shape[] = {layer->num_heads, 2U * out_features};
+    rtka_tensor_t* attention = rtka_tensor_unknown(attention_shape, 2);
+    if (!weight || !attention) {
+        if (weight) rtka_tensor_free(weight);
+        if (attention) rtka_tensor_free(attention);
+        free(layer);
+        return NULL;
+    }
+    
+    /* Xavier init, as for GCN */
+    float scale = sqrtf(2.0f / (in_features + out_features));
+    rtka_nn_init_uniform(weight, scale);
+    float attention_scale = sqrtf(2.0f / (2.0f * out_features + 1.0f));
+    rtka_nn_init_uniform(attention, attention_scale);
+    
+    layer->weight_linear = rtka_grad_node_create(weight, true);
+    layer->attention_weights = rtka_grad_node_create(attention, true);
+    
+    return layer;
+}
+
+/* Message passing for GCN: the neighbour term XW aggregated over the CSR
+ * with the precomputed normalization, the self loop from XW_self */
 static rtka_grad_node_t* gcn_forward(rtka_gcn_layer_t* layer, 
                                      rtka_grad_node_t* node_features,
                                      rtka_graph_t* graph) {
-    rtka_tensor_t* adj = graph->adjacency;
+    rtka_grad_node_t* messages = rtka_grad_matmul(node_features, layer->weight_neighbors);
+    if (!messages) return NULL;
+    
+    rtka_grad_node_t* self_messages = NULL;
+    if (layer->add_self_loops && layer->weight_self) {
+        self_messages = rtka_grad_matmul(node_features, layer->weight_self);
+        if (!self_messages) return NULL;
+    }
     
-    /* Compute degree normalization */
-    if (layer->normalize) {
-        rtka_tensor_t* degree = rtka_tensor_zeros((uint32_t[]){graph->num_nodes}, 1);
+    uint32_t out_shape[] = {graph->num_nodes, layer->base.base.out_features};
+    rtka_tensor_t* output = rtka_tensor_create(out_shape, 2);
+    if (!output) return NULL;
+    
+    if (rtka_gnn_spmm(graph, messages->data, self_messages ? self_messages->data : NULL,
+                      layer->base.aggregation, layer->normalize, NULL, output) != RTKA_SUCCESS) {
+        rtka_tensor_free(output);
+        return NULL;
+    }
+    
+    return rtka_grad_node_create(output, true);
+}
+
+typedef struct {
+    const uint32_t* offsets;
+    const uint32_t* sources;
+    const float* score_src;     /* a_src . h per node and head */
+    const float* score_dst;
+    float* edge_coef;
+    float* self_coef;
+    float* scratch;             /* Largest row + 1 scores per worker */
+    uint32_t scratch_stride;
+    uint32_t heads;
+} gat_ctx_t;
+
+static RTKA_INLINE float gat_leaky(float x) {
+    return x > 0.0f ? x : GAT_LEAKY_SLOPE * x;
+}
+
+/* Head-averaged softmax of every row's scores, self loop last */
+static void gat_rows(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    const gat_ctx_t* ctx = (const gat_ctx_t*)arg;
+    float* scores = ctx->scratch + (size_t)worker * ctx->scratch_stride;
+    uint32_t heads = ctx->heads;
+    float share = 1.0f / (float)heads;
+    
+    for (uint32_t dst = begin; dst < end; dst++) {
+        uint32_t row_begin = ctx->offsets[dst], len = ctx->offsets[dst + 1U] - row_begin;
+        for (uint32_t i = 0; i < len; i++) ctx->edge_coef[row_begin + i] = 0.0f;
+        ctx->self_coef[dst] = 0.0f;
         
-        for (uint32_t i = 0; i < graph->num_nodes; i++) {
-            rtka_confidence_t d = 0.0f;
-            for (uint32_t j = 0; j < graph->num_nodes; j++) {
-                uint32_t idx[] = {i, j};
-                d += rtka_tensor_get(adj, idx)->confidence;
+        for (uint32_t h = 0; h < heads; h++) {
+            float target = ctx->score_dst[(size_t)dst * heads + h];
+            float top = scores[len] = gat_leaky(ctx->score_src[(size_t)dst * heads + h] + target);
+            for (uint32_t i = 0; i < len; i++) {
+                scores[i] = gat_leaky(ctx->score_src[(size_t)ctx->sources[row_begin + i] * heads + h] + target);
+                if (scores[i] > top) top = scores[i];
+            }
+            
+            float total = 0.0f;
+            for (uint32_t i = 0; i <= len; i++) {
+                scores[i] = expf(scores[i] - top);
+                total += scores[i];
             }
-            degree->data[i].confidence = 1.0f / sqrtf(d + 1.0f);
+            float scale = share / total;
+            for (uint32_t i = 0; i < len; i++) ctx->edge_coef[row_begin + i] += scores[i] * scale;
+            ctx->self_coef[dst] += scores[len] * scale;
         }
     }
+}
+
+/* Message passing for GAT: attention coefficients per CSR edge, then the
+ * same sparse fold as GCN with h as both neighbour and self messages */
+static rtka_grad_node_t* gat_forward(rtka_gat_layer_t* layer,
+                                     rtka_grad_node_t* node_features,
+                                     rtka_graph_t* graph) {
+    uint32_t n = graph->num_nodes, features = layer->base.base.out_features, heads = layer->num_heads;
+    const rtka_tensor_t* attention = layer->attention_weights->data;
+    if (!attention->data || attention->size < heads * 2U * features) return NULL;
     
-    /* Message passing: AXW */
-    rtka_grad_node_t* messages = rtka_grad_matmul(node_features, layer->weight_neighbors);
+    rtka_grad_node_t* hidden = rtka_grad_matmul(node_features, layer->weight_linear);
+    if (!hidden || !spmm_operand(hidden->data, n, features)) return NULL;
+    if (!graph->in_offsets || graph->csr_edges != graph->num_edges) {
+        if (rtka_graph_compute_adjacency(graph) != RTKA_SUCCESS) return NULL;
+    }
     
-    /* Aggregate messages */
-    uint32_t out_shape[] = {graph->num_nodes, layer->base.base.out_features};
-    rtka_tensor_t* output = rtka_tensor_zeros(out_shape, 2);
+    rtka_thread_pool_t* pool = rtka_pool_default();
+    uint32_t widest = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t len = graph->in_offsets[v + 1U] - graph->in_offsets[v];
+        if (len > widest) widest = len;
+    }
+    size_t workers = (size_t)rtka_pool_size(pool) + 1U;
+    size_t edges = graph->in_offsets[n];
+    float* score_src = (float*)malloc(((size_t)n * heads + 1U) * sizeof(float));
+    float* score_dst = (float*)malloc(((size_t)n * heads + 1U) * sizeof(float));
+    float* edge_coef = (float*)malloc((edges + 1U) * sizeof(float));
+    float* self_coef = (float*)malloc(((size_t)n + 1U) * sizeof(float));
+    float* scratch = (float*)malloc(workers * ((size_t)widest + 1U) * sizeof(float));
+    uint32_t out_shape[] = {n, features};
+    rtka_tensor_t* output = rtka_tensor_create(out_shape, 2);
     
-    for (uint32_t dst = 0; dst < graph->num_nodes; dst++) {
-        for (uint32_t feat = 0; feat < layer->base.base.out_features; feat++) {
-            rtka_state_t agg = rtka_make_state(RTKA_FALSE, 0.0f);
-            
-            for (uint32_t src = 0; src < graph->num_nodes; src++) {
-                uint32_t adj_idx[] = {src, dst};
-                rtka_state_t edge = *rtka_tensor_get(adj, adj_idx);
-                
-                if (edge.value != RTKA_FALSE) {
-                    uint32_t msg_idx[] = {src, feat};
-                    rtka_state_t msg = *rtka_tensor_get(messages->data, msg_idx);
-                    agg = rtka_combine_or(agg, rtka_combine_and(edge, msg));
+    rtka_grad_node_t* result = NULL;
+    if (score_src && score_dst && edge_coef && self_coef && scratch && output) {
+        const rtka_state_t* h = hidden->data->data;
+        for (uint32_t v = 0; v < n; v++) {
+            for (uint32_t k = 0; k < heads; k++) {
+                const rtka_state_t* a = attention->data + (size_t)k * 2U * features;
+                float as = 0.0f, ad = 0.0f;
+                for (uint32_t f = 0; f < features; f++) {
+                    float c = h[(size_t)v * features + f].confidence;
+                    as += a[f].confidence * c;
+                    ad += a[features + f].confidence * c;
                 }
+                score_src[(size_t)v * heads + k] = as;
+                score_dst[(size_t)v * heads + k] = ad;
             }
-            
-            uint32_t out_idx[] = {dst, feat};
-            rtka_tensor_set(output, out_idx, agg);
+        }
+        
+        gat_ctx_t ctx = {
+            .offsets = graph->in_offsets, .sources = graph->in_sources,
+            .score_src = score_src, .score_dst = score_dst,
+            .edge_coef = edge_coef, .self_coef = self_coef,
+            .scratch = scratch, .scratch_stride = widest + 1U, .heads = heads
+        };
+        rtka_pool_parallel_for(pool, 0, n, SPMM_GRAIN, gat_rows, &ctx);
+        
+        if (spmm_run(graph, hidden->data, hidden->data, edge_coef, self_coef,
+                     layer->base.aggregation, pool, output) == RTKA_SUCCESS) {
+            result = rtka_grad_node_create(output, true);
         }
     }
     
-    return rtka_grad_node_create(output, true);
+    if (!result && output) rtka_tensor_free(output);
+    free(score_src);
+    free(score_dst);
+    free(edge_coef);
+    free(self_coef);
+    free(scratch);
+    return result;
 }
 
-/* Ternary message passing */
+/* Ternary message passing: every node sends (TRUE, threshold) AND its
+ * features; each destination takes the layer's aggregation (the ternary
+ * vote by default) over its in-edges, blended with its own features */
 static rtka_grad_node_t* ternary_forward(rtka_tgn_layer_t* layer,
                                          rtka_grad_node_t* node_features,
                                          rtka_graph_t* graph) {
     uint32_t num_nodes = graph->num_nodes;
     uint32_t hidden_dim = layer->base.base.out_features;
+    const rtka_tensor_t* x = node_features->data;
+    if (!x->data || x->ndim != 2 || x->shape[0] != num_nodes || x->shape[1] < hidden_dim) return NULL;
     
-    /* Allocate message buffer */
     uint32_t msg_shape[] = {num_nodes, hidden_dim};
-    rtka_tensor_t* messages = rtka_tensor_unknown(msg_shape, 2);
+    rtka_tensor_t* messages = rtka_tensor_create(msg_shape, 2);
+    rtka_tensor_t* aggregated = rtka_tensor_create(msg_shape, 2);
+    rtka_tensor_t* updated = rtka_tensor_create(msg_shape, 2);
+    if (!messages || !aggregated || !updated) {
+        if (messages) rtka_tensor_free(messages);
+        if (aggregated) rtka_tensor_free(aggregated);
+        if (updated) rtka_tensor_free(updated);
+        return NULL;
+    }
     
-    /* Compute messages for each edge */
-    for (uint32_t e = 0; e < graph->num_edges; e++) {
-        uint32_t src = graph->edge_index[2 * e];
-        uint32_t dst = graph->edge_index[2 * e + 1];
-        
-        /* Get source and destination features */
+    /* Ternary message computation, once per source */
+    const rtka_state_t gate = rtka_make_state(RTKA_TRUE, layer->threshold);
+    for (uint32_t n = 0; n < num_nodes; n++) {
+        const rtka_state_t* row = x->data + (size_t)n * x->strides[0];
         for (uint32_t f = 0; f < hidden_dim; f++) {
-            uint32_t src_idx[] = {src, f};
-            uint32_t dst_idx[] = {dst, f};
-            
-            rtka_state_t src_feat = *rtka_tensor_get(node_features->data, src_idx);
-            rtka_state_t dst_feat = *rtka_tensor_get(messages, dst_idx);
-            
-            /* Ternary message computation */
-            rtka_state_t msg = rtka_combine_and(src_feat, 
-                                               rtka_make_state(RTKA_TRUE, layer->threshold));
-            
-            /* Aggregate with existing messages */
-            rtka_state_t aggregated = rtka_gnn_aggregate_ternary(&msg, 1);
-            rtka_tensor_set(messages, dst_idx, 
-                          rtka_combine_or(dst_feat, aggregated));
+            messages->data[(size_t)n * hidden_dim + f] = rtka_combine_and(row[f * x->strides[1]], gate);
         }
     }
     
-    /* Update node features */
-    rtka_tensor_t* updated = rtka_tensor_unknown(msg_shape, 2);
+    if (rtka_gnn_spmm(graph, messages, NULL, layer->base.aggregation, false, NULL, aggregated) != RTKA_SUCCESS) {
+        rtka_tensor_free(messages);
+        rtka_tensor_free(aggregated);
+        rtka_tensor_free(updated);
+        return NULL;
+    }
     
+    /* Ternary update rule */
+    const rtka_state_t half = rtka_make_state(RTKA_TRUE, 0.5f);
     for (uint32_t n = 0; n < num_nodes; n++) {
+        const rtka_state_t* row = x->data + (size_t)n * x->strides[0];
         for (uint32_t f = 0; f < hidden_dim; f++) {
-            uint32_t idx[] = {n, f};
-            rtka_state_t old_feat = *rtka_tensor_get(node_features->data, idx);
-            rtka_state_t msg = *rtka_tensor_get(messages, idx);
-            
-            /* Ternary update rule */
-            rtka_state_t updated_feat = rtka_combine_or(
-                rtka_combine_and(old_feat, rtka_make_state(RTKA_TRUE, 0.5f)),
-                rtka_combine_and(msg, rtka_make_state(RTKA_TRUE, 0.5f))
-            );
-            
-            rtka_tensor_set(updated, idx, updated_feat);
+            size_t i = (size_t)n * hidden_dim + f;
+            updated->data[i] = rtka_combine_or(rtka_combine_and(row[f * x->strides[1]], half),
+                                               rtka_combine_and(aggregated->data[i], half));
         }
     }
     
+    rtka_tensor_free(messages);
+    rtka_tensor_free(aggregated);
     return rtka_grad_node_create(updated, true);
 }
 
@@ -244,6 +706,8 @@ rtka_grad_node_t* rtka_gnn_message_pass(rtka_gnn_layer_t* layer,
             return gcn_forward((rtka_gcn_layer_t*)layer, node_features, graph);
         case LAYER_TERNARY:
             return ternary_forward((rtka_tgn_layer_t*)layer, node_features, graph);
+        case LAYER_ATTENTION:
+            return gat_forward((rtka_gat_layer_t*)layer, node_features, graph);
         default:
             return NULL;
     }
@@ -7,6 +7,16 @@
  * distributed, or used without explicit written permission.
  *
  * RTKA Graph Neural Networks
+ *
+ * CHANGELOG:
+ * v1.1.0 - Message passing is sparse: rtka_graph_compute_adjacency builds a
+ *          destination-major CSR of the edge list with the GCN degree
+ *          normalization precomputed per edge, and GCN, GAT and ternary
+ *          layers aggregate over it with rtka_gnn_spmm, parallel over
+ *          destination rows, O(E x F) time and O(N + E) graph memory
+ *          instead of the N x N adjacency tensor. MSG_TERNARY is the
+ *          majority vote of rtka_gnn_aggregate_ternary over all in-edges.
+ *          rtka_gnn_gat is implemented on the same path.
  */
 
 #ifndef RTKA_GNN_H
@@ -16,15 +26,24 @@
 #include "rtka_tensor.h"
 #include "rtka_gradient.h"
 #include "rtka_nn.h"
+#include "rtka_vector.h"
+#include "rtka_threadpool.h"
 
-/* Graph structure */
+/* Graph structure. The CSR holds the in-edges of dst at
+ * in_sources[in_offsets[dst] .. in_offsets[dst + 1]), sources ascending and
+ * duplicates dropped; it is rebuilt when edges were added since. */
 typedef struct {
     uint32_t num_nodes;
     uint32_t num_edges;
-    uint32_t* edge_index;  /* 2 x num_edges */
+    uint32_t edge_capacity;
+    uint32_t* edge_index;  /* (src, dst) pairs, 2 x num_edges */
     rtka_tensor_t* node_features;
     rtka_tensor_t* edge_features;
-    rtka_tensor_t* adjacency;  /* Sparse or dense */
+    uint32_t* in_offsets;  /* num_nodes + 1 */
+    uint32_t* in_sources;
+    float* edge_norm;      /* deg(src)^-1/2 deg(dst)^-1/2, deg = in-degree + 1 */
+    float* self_norm;      /* 1 / deg, the self loop's coefficient */
+    uint32_t csr_edges;    /* num_edges the CSR was built from */
 } rtka_graph_t;
 
 /* Message passing types */
@@ -51,11 +70,13 @@ typedef struct {
     bool normalize;
 } rtka_gcn_layer_t;
 
-/* Graph Attention Network (GAT) layer */
+/* Graph Attention Network (GAT) layer. Each head scores an edge j -> i as
+ * LeakyReLU(a_src . h_j + a_dst . h_i) on the confidences of h = xW, softmaxed over the in-edges and self loop of i; the heads'
+ * coefficients are averaged and drive the MSG_SUM fold. */
 typedef struct {
     rtka_gnn_layer_t base;
     rtka_grad_node_t* weight_linear;
-    rtka_grad_node_t* attention_weights;
+    rtka_grad_node_t* attention_weights;  /* num_heads x 2 out_features: a_src, a_dst */
     uint32_t num_heads;
     rtka_confidence_t dropout;
 } rtka_gat_layer_t;
@@ -68,10 +89,12 @@ typedef struct {
     rtka_confidence_t threshold;
 } rtka_tgn_layer_t;
 
-/* Graph creation */
+/* Graph creation. num_edges is the initial edge capacity; the edge list
+ * grows past it. */
 rtka_graph_t* rtka_graph_create(uint32_t num_nodes, uint32_t num_edges);
 void rtka_graph_add_edge(rtka_graph_t* graph, uint32_t src, uint32_t dst);
-void rtka_graph_compute_adjacency(rtka_graph_t* graph);
+/* Builds the CSR and normalization; message passing calls it when stale */
+RTKA_NODISCARD rtka_error_t rtka_graph_compute_adjacency(rtka_graph_t* graph);
 void rtka_graph_free(rtka_graph_t* graph);
 
 /* Layer creation */
@@ -79,6 +102,20 @@ rtka_gcn_layer_t* rtka_gnn_gcn(uint32_t in_features, uint32_t out_features, bool
 rtka_gat_layer_t* rtka_gnn_gat(uint32_t in_features, uint32_t out_features, uint32_t num_heads);
 rtka_tgn_layer_t* rtka_gnn_ternary(uint32_t in_features, uint32_t out_features, rtka_confidence_t threshold);
 
+/* Sparse aggregation (SpMM) over the in-edges of every node: out[dst] is
+ * the aggregation of (TRUE, c) AND messages[src] over the edges src -> dst,
+ * c being edge_norm when normalize is set and 1 otherwise. self_messages,
+ * if given, adds the self loop with self_messages[dst] and c = self_norm
+ * (1). messages, self_messages and out are num_nodes x F AoS tensors; rows
+ * are split over pool (NULL = rtka_pool_default()). */
+RTKA_NODISCARD rtka_error_t rtka_gnn_spmm(rtka_graph_t* graph, const rtka_tensor_t* messages,
+                                          const rtka_tensor_t* self_messages, rtka_aggregation_t aggregation,
+                                          bool normalize, rtka_thread_pool_t* pool, rtka_tensor_t* out);
+
+/* Row kernel of the MSG_SUM fold (scalar or AVX2) */
+rtka_simd_level_t rtka_gnn_kernel(void);
+bool rtka_gnn_set_kernel(rtka_simd_level_t level);
+
 /* Message passing */
 rtka_grad_node_t* rtka_gnn_message_pass(rtka_gnn_layer_t* layer, 
                                         rtka_grad_node_t* node_features,
@@ -0,0 +1,372 @@
+/**
+ * File: rtka_gnn_sampler.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA GNN Neighbour Sampler Library
+ */
+
+#include "rtka_gnn_sampler.h"
+#include "rtka_memory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define SAMPLER_FLOYD_MAX   32U     /* Larger fanouts shuffle a copy of the row */
+#define SAMPLER_UNMAPPED    UINT32_MAX
+
+struct rtka_gnn_sampler {
+    rtka_graph_t* graph;
+    const rtka_tensor_t* features;
+    uint32_t fanouts[RTKA_GNN_MAX_HOPS];
+    uint32_t hops;
+    uint32_t batch_size;
+
+    /* Epoch state, touched only by whoever samples */
+    uint32_t* order;            /* Shuffled training nodes */
+    uint32_t num_train;
+    uint32_t cursor;
+    uint32_t epoch;
+    uint32_t index;
+    uint64_t rng;
+
+    /* Scratch for one batch */
+    uint32_t* local;            /* Original id -> subgraph id, SAMPLER_UNMAPPED outside */
+    uint32_t* nodes;
+    uint32_t nodes_capacity;
+    uint32_t* edges;            /* (src, dst) pairs in subgraph ids */
+    uint32_t edges_capacity;
+    uint32_t* picks;
+    uint32_t picks_capacity;
+
+    /* Pipeline: up to RTKA_GNN_SAMPLER_DEPTH results, NULL ending an epoch */
+    bool threaded;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    rtka_gnn_batch_t* queue[RTKA_GNN_SAMPLER_DEPTH];
+    uint32_t head;
+    uint32_t count;
+    bool stop;
+    rtka_error_t error;
+};
+
+static uint32_t next_random(rtka_gnn_sampler_t* s) {
+    s->rng ^= s->rng >> 12;
+    s->rng ^= s->rng << 25;
+    s->rng ^= s->rng >> 27;
+    return (uint32_t)((s->rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static RTKA_INLINE uint32_t random_below(rtka_gnn_sampler_t* s, uint32_t bound) {
+    return (uint32_t)(((uint64_t)next_random(s) * bound) >> 32);
+}
+
+static void shuffle(rtka_gnn_sampler_t* s) {
+    for (uint32_t i = s->num_train; i > 1U; i--) {
+        uint32_t j = random_below(s, i);
+        uint32_t t = s->order[i - 1U];
+        s->order[i - 1U] = s->order[j];
+        s->order[j] = t;
+    }
+}
+
+static bool reserve(uint32_t** buffer, uint32_t* capacity, uint64_t needed) {
+    if (needed <= *capacity) return true;
+    if (needed > UINT32_MAX) return false;
+    uint64_t grown = *capacity ? (uint64_t)*capacity * 2U : 64U;
+    while (grown < needed) grown *= 2U;
+    if (grown > UINT32_MAX) grown = UINT32_MAX;
+    uint32_t* p = (uint32_t*)realloc(*buffer, (size_t)grown * sizeof(uint32_t));
+    if (!p) return false;
+    *buffer = p;
+    *capacity = (uint32_t)grown;
+    return true;
+}
+
+/* Positions of k of the degree in-edges, distinct */
+static bool pick_neighbors(rtka_gnn_sampler_t* s, uint32_t degree, uint32_t k) {
+    if (!reserve(&s->picks, &s->picks_capacity, k <= SAMPLER_FLOYD_MAX ? k : degree)) return false;
+    uint32_t* picks = s->picks;
+
+    if (k <= SAMPLER_FLOYD_MAX) {
+        /* Floyd: one draw per pick, the duplicate check is over k entries */
+        for (uint32_t j = degree - k, c = 0; j < degree; j++, c++) {
+            uint32_t t = random_below(s, j + 1U);
+            for (uint32_t i = 0; i < c; i++) {
+                if (picks[i] == t) {
+                    t = j;
+                    break;
+                }
+            }
+            picks[c] = t;
+        }
+    } else {
+        for (uint32_t i = 0; i < degree; i++) picks[i] = i;
+        for (uint32_t i = 0; i < k; i++) {
+            uint32_t j = i + random_below(s, degree - i);
+            uint32_t t = picks[i];
+            picks[i] = picks[j];
+            picks[j] = t;
+        }
+    }
+    return true;
+}
+
+static rtka_gnn_batch_t* build_batch(rtka_gnn_sampler_t* s, uint32_t num_nodes, uint32_t num_edges,
+                                     uint32_t num_seeds) {
+    rtka_gnn_batch_t* batch = (rtka_gnn_batch_t*)calloc(1, sizeof(rtka_gnn_batch_t));
+    if (!batch) return NULL;
+    batch->num_seeds = num_seeds;
+    batch->epoch = s->epoch;
+    batch->index = s->index;
+    batch->node_ids = (uint32_t*)malloc((size_t)num_nodes * sizeof(uint32_t));
+    batch->graph = rtka_graph_create(num_nodes, num_edges);
+
+    const rtka_tensor_t* features = s->features;
+    uint32_t width = features->shape[1];
+    uint32_t shape[] = {num_nodes, width};
+    rtka_tensor_t* gathered = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+
+    if (!batch->node_ids || !batch->graph || !gathered) {
+        if (gathered) rtka_tensor_free(gathered);
+        rtka_gnn_batch_free(batch);
+        return NULL;
+    }
+
+    memcpy(batch->node_ids, s->nodes, (size_t)num_nodes * sizeof(uint32_t));
+    memcpy(batch->graph->edge_index, s->edges, 2U * (size_t)num_edges * sizeof(uint32_t));
+    batch->graph->num_edges = num_edges;
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        memcpy(gathered->data + (size_t)i * width, features->data + (size_t)s->nodes[i] * width,
+               (size_t)width * sizeof(rtka_state_t));
+    }
+    if (batch->graph->node_features) rtka_tensor_free(batch->graph->node_features);
+    batch->graph->node_features = gathered;
+
+    if (rtka_graph_compute_adjacency(batch->graph) != RTKA_SUCCESS) {
+        rtka_gnn_batch_free(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+/* Seeds, then hop by hop the sampled in-neighbours of the nodes the
+ * previous hop reached first */
+static rtka_error_t sample_batch(rtka_gnn_sampler_t* s, rtka_gnn_batch_t** out) {
+    const rtka_graph_t* graph = s->graph;
+    uint32_t num_seeds = s->num_train - s->cursor < s->batch_size ? s->num_train - s->cursor : s->batch_size;
+    uint32_t count = 0, num_edges = 0;
+    rtka_error_t err = RTKA_SUCCESS;
+
+    if (!reserve(&s->nodes, &s->nodes_capacity, num_seeds)) return RTKA_ERROR_OUT_OF_MEMORY;
+    for (uint32_t i = 0; i < num_seeds; i++) {
+        uint32_t v = s->order[s->cursor + i];
+        s->local[v] = count;
+        s->nodes[count++] = v;
+    }
+
+    uint32_t frontier_begin = 0, frontier_end = count;
+    for (uint32_t h = 0; h < s->hops && err == RTKA_SUCCESS; h++) {
+        for (uint32_t i = frontier_begin; i < frontier_end; i++) {
+            uint32_t v = s->nodes[i];
+            uint32_t row = graph->in_offsets[v], degree = graph->in_offsets[v + 1U] - row;
+            uint32_t k = degree < s->fanouts[h] ? degree : s->fanouts[h];
+            if (k == 0) continue;
+
+            if (!reserve(&s->nodes, &s->nodes_capacity, (uint64_t)count + k) ||
+                !reserve(&s->edges, &s->edges_capacity, 2U * ((uint64_t)num_edges + k)) ||
+                (k < degree && !pick_neighbors(s, degree, k))) {
+                err = RTKA_ERROR_OUT_OF_MEMORY;
+                break;
+            }
+
+            for (uint32_t j = 0; j < k; j++) {
+                uint32_t src = graph->in_sources[row + (k < degree ? s->picks[j] : j)];
+                if (s->local[src] == SAMPLER_UNMAPPED) {
+                    s->local[src] = count;
+                    s->nodes[count++] = src;
+                }
+                s->edges[2U * num_edges] = s->local[src];
+                s->edges[2U * num_edges + 1U] = i;
+                num_edges++;
+            }
+        }
+        frontier_begin = frontier_end;
+        frontier_end = count;
+    }
+
+    if (err == RTKA_SUCCESS) {
+        *out = build_batch(s, count, num_edges, num_seeds);
+        if (!*out) err = RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < count; i++) s->local[s->nodes[i]] = SAMPLER_UNMAPPED;
+
+    if (err == RTKA_SUCCESS) {
+        s->cursor += num_seeds;
+        s->index++;
+    }
+    return err;
+}
+
+/* The next result in order: a batch, or NULL closing the epoch */
+static rtka_error_t produce(rtka_gnn_sampler_t* s, rtka_gnn_batch_t** batch) {
+    *batch = NULL;
+    if (s->cursor >= s->num_train) {
+        s->cursor = 0;
+        s->index = 0;
+        s->epoch++;
+        shuffle(s);
+        return RTKA_SUCCESS;
+    }
+    return sample_batch(s, batch);
+}
+
+static void* sampler_main(void* arg) {
+    rtka_gnn_sampler_t* s = (rtka_gnn_sampler_t*)arg;
+
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        while (s->count == RTKA_GNN_SAMPLER_DEPTH && !s->stop) {
+            pthread_cond_wait(&s->changed, &s->lock);
+        }
+        if (s->stop) break;
+        pthread_mutex_unlock(&s->lock);
+
+        rtka_gnn_batch_t* batch;
+        rtka_error_t err = produce(s, &batch);
+
+        pthread_mutex_lock(&s->lock);
+        if (err != RTKA_SUCCESS) {
+            s->error = err;
+            pthread_cond_broadcast(&s->changed);
+            break;
+        }
+        s->queue[(s->head + s->count) % RTKA_GNN_SAMPLER_DEPTH] = batch;
+        s->count++;
+        pthread_cond_broadcast(&s->changed);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+rtka_error_t rtka_gnn_sampler_create(rtka_gnn_sampler_t** sampler, rtka_graph_t* graph,
+                                     const rtka_tensor_t* features,
+                                     const uint32_t* train_nodes, uint32_t num_train,
+                                     const uint32_t* fanouts, uint32_t hops,
+                                     uint32_t batch_size, uint64_t seed, uint32_t flags) {
+    if (!sampler || !graph || (hops > 0 && !fanouts)) return RTKA_ERROR_NULL_POINTER;
+    *sampler = NULL;
+    if (!features) features = graph->node_features;
+    if (!features || !features->data || features->ndim != 2 || features->shape[0] != graph->num_nodes ||
+        features->strides[0] != features->shape[1] || features->strides[1] != 1U ||
+        hops > RTKA_GNN_MAX_HOPS || batch_size == 0) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    if (!train_nodes) num_train = graph->num_nodes;
+    for (uint32_t i = 0; train_nodes && i < num_train; i++) {
+        if (train_nodes[i] >= graph->num_nodes) return RTKA_ERROR_INVALID_VALUE;
+    }
+    if (!graph->in_offsets || graph->csr_edges != graph->num_edges) {
+        rtka_error_t err = rtka_graph_compute_adjacency(graph);
+        if (err != RTKA_SUCCESS) return err;
+    }
+
+    rtka_gnn_sampler_t* s = (rtka_gnn_sampler_t*)calloc(1, sizeof(rtka_gnn_sampler_t));
+    if (!s) return RTKA_ERROR_OUT_OF_MEMORY;
+    s->graph = graph;
+    s->features = features;
+    s->hops = hops;
+    s->batch_size = batch_size;
+    s->num_train = num_train;
+    s->rng = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    for (uint32_t h = 0; h < hops; h++) s->fanouts[h] = fanouts[h];
+
+    s->order = (uint32_t*)malloc(((size_t)num_train + 1U) * sizeof(uint32_t));
+    s->local = (uint32_t*)malloc(((size_t)graph->num_nodes + 1U) * sizeof(uint32_t));
+    if (!s->order || !s->local) {
+        rtka_gnn_sampler_free(s);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < num_train; i++) s->order[i] = train_nodes ? train_nodes[i] : i;
+    memset(s->local, 0xFF, (size_t)graph->num_nodes * sizeof(uint32_t));
+    shuffle(s);
+
+    if (!(flags & RTKA_GNN_SAMPLER_SYNC)) {
+        pthread_mutex_init(&s->lock, NULL);
+        pthread_cond_init(&s->changed, NULL);
+        if (pthread_create(&s->thread, NULL, sampler_main, s) != 0) {
+            pthread_cond_destroy(&s->changed);
+            pthread_mutex_destroy(&s->lock);
+            rtka_gnn_sampler_free(s);
+            return RTKA_ERROR_NOT_INITIALIZED;
+        }
+        s->threaded = true;
+    }
+
+    *sampler = s;
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_gnn_sampler_next(rtka_gnn_sampler_t* sampler, rtka_gnn_batch_t** batch) {
+    if (!sampler || !batch) return RTKA_ERROR_NULL_POINTER;
+    *batch = NULL;
+    if (!sampler->threaded) return produce(sampler, batch);
+
+    pthread_mutex_lock(&sampler->lock);
+    while (sampler->count == 0 && sampler->error == RTKA_SUCCESS) {
+        pthread_cond_wait(&sampler->changed, &sampler->lock);
+    }
+    rtka_error_t err = RTKA_SUCCESS;
+    if (sampler->count > 0) {
+        *batch = sampler->queue[sampler->head];
+        sampler->head = (sampler->head + 1U) % RTKA_GNN_SAMPLER_DEPTH;
+        sampler->count--;
+        pthread_cond_broadcast(&sampler->changed);
+    } else {
+        err = sampler->error;
+    }
+    pthread_mutex_unlock(&sampler->lock);
+    return err;
+}
+
+uint32_t rtka_gnn_sampler_batches(const rtka_gnn_sampler_t* sampler) {
+    if (!sampler) return 0;
+    return (sampler->num_train + sampler->batch_size - 1U) / sampler->batch_size;
+}
+
+void rtka_gnn_sampler_free(rtka_gnn_sampler_t* sampler) {
+    if (!sampler) return;
+
+    if (sampler->threaded) {
+        pthread_mutex_lock(&sampler->lock);
+        sampler->stop = true;
+        pthread_cond_broadcast(&sampler->changed);
+        pthread_mutex_unlock(&sampler->lock);
+        pthread_join(sampler->thread, NULL);
+        pthread_cond_destroy(&sampler->changed);
+        pthread_mutex_destroy(&sampler->lock);
+        for (uint32_t i = 0; i < sampler->count; i++) {
+            rtka_gnn_batch_free(sampler->queue[(sampler->head + i) % RTKA_GNN_SAMPLER_DEPTH]);
+        }
+    }
+
+    free(sampler->order);
+    free(sampler->local);
+    free(sampler->nodes);
+    free(sampler->edges);
+    free(sampler->picks);
+    free(sampler);
+}
+
+void rtka_gnn_batch_free(rtka_gnn_batch_t* batch) {
+    if (!batch) return;
+    rtka_graph_free(batch->graph);
+    free(batch->node_ids);
+    free(batch);
+}
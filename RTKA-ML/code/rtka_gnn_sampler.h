@@ -0,0 +1,87 @@
+/**
+ * File: rtka_gnn_sampler.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA GNN Neighbour Sampler - GraphSAGE-style mini-batches
+ *
+ * CHANGELOG:
+ * v1.0.0 - Each batch takes batch_size seed nodes from a shuffled training
+ *          set and expands them hop by hop, sampling up to fanouts[h]
+ *          in-neighbours (without replacement) of every node first reached
+ *          at hop h. The result is an rtka_graph_t over the reached nodes,
+ *          relabelled so the seeds come first, with its CSR already built
+ *          and node_features gathered from the full feature tensor, ready
+ *          for rtka_gnn_message_pass. A background thread samples up to
+ *          RTKA_GNN_SAMPLER_DEPTH batches ahead of the consumer.
+ *
+ * Every node of a batch owns either all of its sampled in-edges or none,
+ * so with fanouts at least the largest in-degree the seed rows of an
+ * L-layer forward pass over an L-hop batch equal the full-graph rows
+ * (up to the degree normalization, which sees the subgraph).
+ *
+ *   rtka_gnn_sampler_t* sampler;
+ *   uint32_t fanouts[] = {10, 5};
+ *   if (rtka_gnn_sampler_create(&sampler, graph, features, NULL, 0, fanouts, 2, 512, 1, 0) == RTKA_SUCCESS) {
+ *       rtka_gnn_batch_t* batch;
+ *       while (rtka_gnn_sampler_next(sampler, &batch) == RTKA_SUCCESS && batch) {
+ *           rtka_arena_begin_step(arena);
+ *           x = rtka_grad_node_create(batch->graph->node_features, false);  (the batch owns it)
+ *           ... two layers of rtka_gnn_message_pass, loss on rows < batch->num_seeds
+ *           rtka_arena_end_step(arena);
+ *           rtka_gnn_batch_free(batch);
+ *       }
+ *       rtka_gnn_sampler_free(sampler);
+ *   }
+ *
+ * The graph and feature tensor must not change while a sampler uses them.
+ */
+
+#ifndef RTKA_GNN_SAMPLER_H
+#define RTKA_GNN_SAMPLER_H
+
+#include "rtka_gnn.h"
+
+#define RTKA_GNN_MAX_HOPS          8U
+#define RTKA_GNN_ALL_NEIGHBORS     UINT32_MAX   /* Fanout keeping every in-edge */
+#define RTKA_GNN_SAMPLER_DEPTH     2U           /* Batches sampled ahead */
+
+#define RTKA_GNN_SAMPLER_SYNC      0x1U         /* Sample inside next(), no thread */
+
+typedef struct {
+    rtka_graph_t* graph;        /* Relabelled subgraph, CSR built, node_features gathered */
+    uint32_t* node_ids;         /* Original id of every subgraph node */
+    uint32_t num_seeds;         /* Subgraph nodes 0 .. num_seeds - 1 */
+    uint32_t epoch;
+    uint32_t index;             /* Batch within the epoch */
+} rtka_gnn_batch_t;
+
+typedef struct rtka_gnn_sampler rtka_gnn_sampler_t;
+
+/* features is a num_nodes x F AoS tensor (NULL = graph->node_features);
+ * train_nodes lists the seed candidates (NULL = all nodes). The CSR of
+ * graph is built if stale. seed fixes the shuffles and samples, which do
+ * not depend on RTKA_GNN_SAMPLER_SYNC. */
+RTKA_NODISCARD rtka_error_t rtka_gnn_sampler_create(rtka_gnn_sampler_t** sampler, rtka_graph_t* graph,
+                                                    const rtka_tensor_t* features,
+                                                    const uint32_t* train_nodes, uint32_t num_train,
+                                                    const uint32_t* fanouts, uint32_t hops,
+                                                    uint32_t batch_size, uint64_t seed, uint32_t flags);
+
+/* The next batch, waiting for the sampling thread if it is behind; *batch
+ * is NULL once at the end of every epoch, after which the next epoch
+ * starts reshuffled. The caller owns the batch. */
+RTKA_NODISCARD rtka_error_t rtka_gnn_sampler_next(rtka_gnn_sampler_t* sampler, rtka_gnn_batch_t** batch);
+
+/* Batches per epoch */
+uint32_t rtka_gnn_sampler_batches(const rtka_gnn_sampler_t* sampler);
+
+void rtka_gnn_sampler_free(rtka_gnn_sampler_t* sampler);
+void rtka_gnn_batch_free(rtka_gnn_batch_t* batch);
+
+#endif /* RTKA_GNN_SAMPLER_H */
@@ -11,98 +11,245 @@
 
 #include "rtka_gradient.h"
 #include "rtka_memory.h"
+#include "rtka_gemm.h"
 #include <string.h>
 #include <math.h>
 
 /* Thread-local gradient tape */
 _Thread_local rtka_grad_tape_t* rtka_current_tape = NULL;
 
-/* Create gradient tape */
+/* Create gradient tape - heap-backed, it outlives every step it records */
 rtka_grad_tape_t* rtka_grad_tape_create(void) {
-    rtka_grad_tape_t* tape = (rtka_grad_tape_t*)rtka_alloc_state();
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    rtka_grad_tape_t* tape = (rtka_grad_tape_t*)heap->alloc(sizeof(rtka_grad_tape_t), heap->context);
     if (!tape) return NULL;
     
     tape->capacity = 256;
-    tape->nodes = (rtka_grad_node_t**)rtka_alloc_states(tape->capacity * sizeof(void*) / sizeof(rtka_state_t));
-    if (!tape->nodes) {
-        rtka_free_state((rtka_state_t*)tape);
+    tape->nodes = (rtka_grad_node_t**)heap->alloc(tape->capacity * sizeof(rtka_grad_node_t*), heap->context);
+    tape->first_use = (uint32_t*)heap->alloc(tape->capacity * sizeof(uint32_t), heap->context);
+    if (!tape->nodes || !tape->first_use) {
+        if (tape->nodes) heap->free(tape->nodes, heap->context);
+        if (tape->first_use) heap->free(tape->first_use, heap->context);
+        heap->free(tape, heap->context);
         return NULL;
     }
     
     tape->node_count = 0;
     tape->recording = false;
+    tape->release_activations = false;
+    tape->buffers = NULL;
+    tape->buffer_count = 0;
+    tape->buffer_capacity = 0;
+    tape->live_grad_bytes = 0;
+    tape->peak_grad_bytes = 0;
     return tape;
 }
 
 /* Begin recording */
 void rtka_grad_tape_begin(rtka_grad_tape_t* tape) {
+    tape->node_count = 0;
     tape->recording = true;
+    
+    /* The previous step's nodes are gone, take their gradients back */
+    for (uint32_t i = 0; i < tape->buffer_count; i++) {
+        tape->buffers[i].in_use = false;
+    }
+    tape->live_grad_bytes = 0;
+    tape->peak_grad_bytes = 0;
+    
     rtka_current_tape = tape;
 }
 
-/* Create gradient node */
-rtka_grad_node_t* rtka_grad_node_create(rtka_tensor_t* data, bool requires_grad) {
-    rtka_grad_node_t* node = (rtka_grad_node_t*)rtka_alloc_state();
+/* Stop recording */
+void rtka_grad_tape_end(rtka_grad_tape_t* tape) {
+    tape->recording = false;
+    if (rtka_current_tape == tape) rtka_current_tape = NULL;
+}
+
+/* Room for one more node, growing nodes and first_use together */
+static bool tape_reserve(rtka_grad_tape_t* tape) {
+    if (tape->node_count < tape->capacity) return true;
+    
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    uint32_t new_capacity = tape->capacity * 2;
+    rtka_grad_node_t** new_nodes = (rtka_grad_node_t**)heap->alloc(
+        new_capacity * sizeof(rtka_grad_node_t*), heap->context);
+    uint32_t* new_first_use = (uint32_t*)heap->alloc(new_capacity * sizeof(uint32_t), heap->context);
+    if (!new_nodes || !new_first_use) {
+        if (new_nodes) heap->free(new_nodes, heap->context);
+        if (new_first_use) heap->free(new_first_use, heap->context);
+        return false;
+    }
+    
+    memcpy(new_nodes, tape->nodes, tape->node_count * sizeof(rtka_grad_node_t*));
+    heap->free(tape->nodes, heap->context);
+    heap->free(tape->first_use, heap->context);
+    tape->nodes = new_nodes;
+    tape->first_use = new_first_use;
+    tape->capacity = new_capacity;
+    return true;
+}
+
+/* Bytes a gradient of this shape occupies */
+static size_t grad_bytes(const rtka_tensor_t* grad) {
+    return (size_t)grad->size * sizeof(rtka_state_t);
+}
+
+/* Lend a zeroed gradient of data's shape, recycling a free buffer of the
+ * same element count when there is one */
+static rtka_tensor_t* pool_take(rtka_grad_tape_t* tape, const rtka_tensor_t* data) {
+    rtka_tensor_t* grad = NULL;
+    
+    for (uint32_t i = 0; i < tape->buffer_count; i++) {
+        rtka_grad_buffer_t* buffer = &tape->buffers[i];
+        if (buffer->in_use || buffer->tensor->size != data->size) continue;
+        
+        grad = buffer->tensor;
+        buffer->in_use = true;
+        
+        /* Same element count, possibly another shape: contiguous strides */
+        uint32_t stride = 1;
+        grad->ndim = data->ndim;
+        for (int32_t d = (int32_t)data->ndim - 1; d >= 0; d--) {
+            grad->shape[d] = data->shape[d];
+            grad->strides[d] = stride;
+            stride *= data->shape[d];
+        }
+        break;
+    }
+    
+    if (!grad) {
+        if (tape->buffer_count >= tape->buffer_capacity) {
+            rtka_allocator_t* heap = rtka_heap_allocator();
+            uint32_t new_capacity = tape->buffer_capacity ? tape->buffer_capacity * 2 : 16;
+            rtka_grad_buffer_t* new_buffers = (rtka_grad_buffer_t*)heap->alloc(
+                new_capacity * sizeof(rtka_grad_buffer_t), heap->context);
+            if (!new_buffers) return NULL;
+            
+            if (tape->buffers) {
+                memcpy(new_buffers, tape->buffers, tape->buffer_count * sizeof(rtka_grad_buffer_t));
+                heap->free(tape->buffers, heap->context);
+            }
+            tape->buffers = new_buffers;
+            tape->buffer_capacity = new_capacity;
+        }
+        
+        grad = rtka_tensor_create_in(rtka_heap_allocator(), data->shape, data->ndim);
+        if (!grad) return NULL;
+        tape->buffers[tape->buffer_count].tensor = grad;
+        tape->buffers[tape->buffer_count].in_use = true;
+        tape->buffer_count++;
+    }
+    
+    /* UNKNOWN with zero confidence - nothing accumulated yet */
+    memset(grad->data, 0, grad_bytes(grad));
+    
+    tape->live_grad_bytes += grad_bytes(grad);
+    if (tape->live_grad_bytes > tape->peak_grad_bytes) {
+        tape->peak_grad_bytes = tape->live_grad_bytes;
+    }
+    return grad;
+}
+
+/* Hand a lent gradient back */
+static void pool_release(rtka_grad_tape_t* tape, rtka_grad_node_t* node) {
+    for (uint32_t i = 0; i < tape->buffer_count; i++) {
+        if (tape->buffers[i].tensor != node->grad) continue;
+        
+        tape->buffers[i].in_use = false;
+        tape->live_grad_bytes -= grad_bytes(node->grad);
+        break;
+    }
+    node->grad = NULL;
+    node->grad_pooled = false;
+}
+
+/* Allocate and initialise a node; own_grad gives it its own zeroed gradient */
+static rtka_grad_node_t* node_create(rtka_tensor_t* data, bool requires_grad, bool own_grad) {
+    rtka_allocator_t* owner = NULL;
+    rtka_grad_node_t* node = (rtka_grad_node_t*)rtka_allocator_alloc(
+        data->allocator, sizeof(rtka_grad_node_t), &owner);
     if (!node) return NULL;
     
     node->data = data;
-    node->grad = requires_grad ? rtka_tensor_zeros(data->shape, data->ndim) : NULL;
+    node->grad = NULL;
+    if (own_grad) {
+        node->grad = rtka_tensor_create_in(data->allocator, data->shape, data->ndim);
+        if (!node->grad) {
+            rtka_allocator_free(owner, node);
+            return NULL;
+        }
+        memset(node->grad->data, 0, grad_bytes(node->grad));
+    }
     node->op = GRAD_OP_NONE;
     node->inputs[0] = node->inputs[1] = NULL;
-    node->outputs = NULL;
-    node->output_count = 0;
+    node->tape_index = UINT32_MAX;
     node->requires_grad = requires_grad;
     node->grad_computed = false;
+    node->grad_pooled = false;
     node->ref_count = 1;
+    node->saved_tensors[0] = node->saved_tensors[1] = NULL;
+    node->allocator = owner;
     
     /* Add to tape if recording */
-    if (rtka_current_tape && rtka_current_tape->recording) {
-        if (rtka_current_tape->node_count >= rtka_current_tape->capacity) {
-            /* Expand capacity */
-            uint32_t new_capacity = rtka_current_tape->capacity * 2;
-            rtka_grad_node_t** new_nodes = (rtka_grad_node_t**)rtka_alloc_states(
-                new_capacity * sizeof(void*) / sizeof(rtka_state_t));
-            if (!new_nodes) return node;
-            
-            memcpy(new_nodes, rtka_current_tape->nodes, 
-                   rtka_current_tape->node_count * sizeof(rtka_grad_node_t*));
-            rtka_current_tape->nodes = new_nodes;
-            rtka_current_tape->capacity = new_capacity;
-        }
-        
-        rtka_current_tape->nodes[rtka_current_tape->node_count++] = node;
+    rtka_grad_tape_t* tape = rtka_current_tape;
+    if (tape && tape->recording && tape_reserve(tape)) {
+        node->tape_index = tape->node_count;
+        tape->nodes[tape->node_count++] = node;
     }
     
     return node;
 }
 
-/* Forward AND with gradient tracking */
-rtka_grad_node_t* rtka_grad_and(rtka_grad_node_t* a, rtka_grad_node_t* b) {
-    if (!a || !b) return NULL;
-    
-    rtka_tensor_t* result = rtka_tensor_and(a->data, b->data);
-    if (!result) return NULL;
+/* Create gradient node - a leaf, its gradient is its own */
+rtka_grad_node_t* rtka_grad_node_create(rtka_tensor_t* data, bool requires_grad) {
+    return node_create(data, requires_grad, requires_grad);
+}
+
+/* Free gradient node with its data and, unless lent by a tape, its gradient */
+void rtka_grad_node_free(rtka_grad_node_t* node) {
+    if (!node) return;
     
-    bool requires_grad = a->requires_grad || b->requires_grad;
-    rtka_grad_node_t* node = rtka_grad_node_create(result, requires_grad);
+    if (!node->grad_pooled) rtka_tensor_free(node->grad);
+    rtka_tensor_free(node->data);
+    rtka_allocator_free(node->allocator, node);
+}
+
+/* Wrap an op result. While a tape records, the gradient is left to the
+ * backward sweep; off-tape the node owns one as before. */
+static rtka_grad_node_t* record_op(rtka_tensor_t* result, rtka_grad_op_t op,
+                                   rtka_grad_node_t* a, rtka_grad_node_t* b) {
+    bool requires_grad = a->requires_grad || (b && b->requires_grad);
+    bool on_tape = rtka_current_tape && rtka_current_tape->recording;
+    rtka_grad_node_t* node = node_create(result, requires_grad, requires_grad && !on_tape);
     if (!node) {
         rtka_tensor_free(result);
         return NULL;
     }
     
-    node->op = GRAD_OP_AND;
+    node->op = op;
     node->inputs[0] = a;
     node->inputs[1] = b;
     
     /* Save inputs for backward pass */
     if (requires_grad) {
         node->saved_tensors[0] = a->data;
-        node->saved_tensors[1] = b->data;
+        node->saved_tensors[1] = b ? b->data : NULL;
     }
     
     return node;
 }
 
+/* Forward AND with gradient tracking */
+rtka_grad_node_t* rtka_grad_and(rtka_grad_node_t* a, rtka_grad_node_t* b) {
+    if (!a || !b) return NULL;
+    
+    rtka_tensor_t* result = rtka_tensor_and(a->data, b->data);
+    if (!result) return NULL;
+    
+    return record_op(result, GRAD_OP_AND, a, b);
+}
+
 /* Forward OR with gradient tracking */
 rtka_grad_node_t* rtka_grad_or(rtka_grad_node_t* a, rtka_grad_node_t* b) {
     if (!a || !b) return NULL;
@@ -110,23 +257,64 @@ rtka_grad_node_t* rtka_grad_or(rtka_grad_node_t* a, rtka_grad_node_t* b) {
     rtka_tensor_t* result = rtka_tensor_or(a->data, b->data);
     if (!result) return NULL;
     
-    bool requires_grad = a->requires_grad || b->requires_grad;
-    rtka_grad_node_t* node = rtka_grad_node_create(result, requires_grad);
-    if (!node) {
-        rtka_tensor_free(result);
-        return NULL;
+    return record_op(result, GRAD_OP_OR, a, b);
+}
+
+/* Forward NOT with gradient tracking - confidence passes through unchanged */
+rtka_grad_node_t* rtka_grad_not(rtka_grad_node_t* a) {
+    if (!a) return NULL;
+    
+    rtka_tensor_t* result = rtka_tensor_not(a->data);
+    if (!result) return NULL;
+    
+    return record_op(result, GRAD_OP_NOT, a, NULL);
+}
+
+/* Forward matmul on the signed plane: (m, k) x (k, n), as rtka_tensor_linear */
+rtka_grad_node_t* rtka_grad_matmul(rtka_grad_node_t* a, rtka_grad_node_t* b) {
+    if (!a || !b) return NULL;
+    
+    rtka_tensor_t* result = rtka_tensor_linear(a->data, b->data, NULL);
+    if (!result) return NULL;
+    
+    return record_op(result, GRAD_OP_MATMUL, a, b);
+}
+
+/* Adds a float plane into the gradient confidences of a node */
+static void accumulate_grad(rtka_grad_node_t* input, const float* delta) {
+    for (uint32_t i = 0; i < input->grad->size; i++) {
+        input->grad->data[i].confidence += delta[i];
     }
+}
+
+/* Backward pass for MATMUL: dA = G B^T, dB = A^T G on the signed planes,
+ * B^T and A^T being stride swaps of the saved inputs */
+static void backward_matmul(rtka_grad_node_t* node) {
+    rtka_tensor_t* a_data = (rtka_tensor_t*)node->saved_tensors[0];
+    rtka_tensor_t* b_data = (rtka_tensor_t*)node->saved_tensors[1];
+    uint32_t k = b_data->shape[0], n = b_data->shape[1];
+    uint32_t m = a_data->size / k;
     
-    node->op = GRAD_OP_OR;
-    node->inputs[0] = a;
-    node->inputs[1] = b;
+    size_t largest = (size_t)(a_data->size > b_data->size ? a_data->size : b_data->size);
+    rtka_allocator_t* owner = NULL;
+    float* delta = (float*)rtka_allocator_alloc(NULL, largest * sizeof(float), &owner);
+    if (!delta) return;
     
-    if (requires_grad) {
-        node->saved_tensors[0] = a->data;
-        node->saved_tensors[1] = b->data;
+    rtka_gemm_operand_t g = { node->grad->data, n, 1, RTKA_GEMM_CONFIDENCE, NULL };
+    
+    if (node->inputs[0] && node->inputs[0]->requires_grad) {
+        rtka_gemm_operand_t b_t = { b_data->data, b_data->strides[1], b_data->strides[0], RTKA_GEMM_SIGNED, NULL };
+        rtka_gemm(m, k, n, &g, &b_t, delta, k, false);
+        accumulate_grad(node->inputs[0], delta);
     }
     
-    return node;
+    if (node->inputs[1] && node->inputs[1]->requires_grad) {
+        rtka_gemm_operand_t a_t = { a_data->data, 1, k, RTKA_GEMM_SIGNED, NULL };
+        rtka_gemm(k, n, m, &a_t, &g, delta, n, false);
+        accumulate_grad(node->inputs[1], delta);
+    }
+    
+    rtka_allocator_free(owner, delta);
 }
 
 /* Backward pass for AND */
@@ -180,34 +368,99 @@ static void backward_or(rtka_grad_node_t* node) {
     }
 }
 
-/* Main backward pass */
+/* Backward pass for NOT */
+static void backward_not(rtka_grad_node_t* node) {
+    if (!node->inputs[0] || !node->inputs[0]->requires_grad) return;
+    
+    rtka_tensor_t* input_grad = node->inputs[0]->grad;
+    for (uint32_t i = 0; i < input_grad->size; i++) {
+        input_grad->data[i].confidence += node->grad->data[i].confidence;
+    }
+}
+
+/* Main backward pass - one reverse sweep over the tape */
 void rtka_grad_backward(rtka_grad_node_t* output) {
     if (!output || !output->requires_grad) return;
     
+    rtka_grad_tape_t* tape = rtka_current_tape;
+    if (!output->grad) {
+        if (!tape) return;
+        output->grad = pool_take(tape, output->data);
+        if (!output->grad) return;
+        output->grad_pooled = true;
+    }
+    
     /* Initialize output gradient to 1 */
     for (uint32_t i = 0; i < output->grad->size; i++) {
         output->grad->data[i].confidence = 1.0f;
     }
     
-    /* Traverse computation graph in reverse */
-    if (!rtka_current_tape) return;
+    if (!tape) return;
     
-    for (int32_t i = rtka_current_tape->node_count - 1; i >= 0; i--) {
-        rtka_grad_node_t* node = rtka_current_tape->nodes[i];
-        if (!node->requires_grad || node->grad_computed) continue;
+    /* Liveness: a node's data is last read by the backward of its first
+     * consumer on the tape, the last one the reverse sweep reaches */
+    for (uint32_t i = 0; i < tape->node_count; i++) {
+        tape->first_use[i] = UINT32_MAX;
+    }
+    for (uint32_t i = 0; i < tape->node_count; i++) {
+        rtka_grad_node_t* node = tape->nodes[i];
+        for (uint32_t j = 0; j < 2; j++) {
+            rtka_grad_node_t* input = node->inputs[j];
+            if (input && input->tape_index < i && tape->first_use[input->tape_index] == UINT32_MAX) {
+                tape->first_use[input->tape_index] = i;
+            }
+        }
+    }
+    
+    for (int32_t i = (int32_t)tape->node_count - 1; i >= 0; i--) {
+        rtka_grad_node_t* node = tape->nodes[i];
+        if (!node->requires_grad || node->grad_computed || node->op == GRAD_OP_NONE) continue;
         
-        switch (node->op) {
-            case GRAD_OP_AND:
-                backward_and(node);
-                break;
-            case GRAD_OP_OR:
-                backward_or(node);
-                break;
-            default:
-                break;
+        /* No gradient reached this node, nothing to propagate */
+        if (node->grad) {
+            bool ready = true;
+            for (uint32_t j = 0; j < 2; j++) {
+                rtka_grad_node_t* input = node->inputs[j];
+                if (!input || !input->requires_grad || input->grad) continue;
+                
+                input->grad = pool_take(tape, input->data);
+                input->grad_pooled = input->grad != NULL;
+                ready = ready && input->grad;
+            }
+            if (!ready) break;
+            
+            switch (node->op) {
+                case GRAD_OP_AND:
+                    backward_and(node);
+                    break;
+                case GRAD_OP_OR:
+                    backward_or(node);
+                    break;
+                case GRAD_OP_NOT:
+                    backward_not(node);
+                    break;
+                case GRAD_OP_MATMUL:
+                    backward_matmul(node);
+                    break;
+                default:
+                    break;
+            }
+            
+            if (node->grad_pooled && node != output) pool_release(tape, node);
         }
         
         node->grad_computed = true;
+        
+        /* Inputs whose last reader this was */
+        if (!tape->release_activations) continue;
+        for (uint32_t j = 0; j < 2; j++) {
+            rtka_grad_node_t* input = node->inputs[j];
+            if (!input || input == output || input->op == GRAD_OP_NONE || !input->data) continue;
+            if (input->tape_index >= tape->node_count || tape->first_use[input->tape_index] != (uint32_t)i) continue;
+            
+            rtka_tensor_free(input->data);
+            input->data = NULL;
+        }
     }
 }
 
@@ -242,9 +495,76 @@ void rtka_grad_zero(rtka_grad_node_t* node) {
 void rtka_grad_tape_free(rtka_grad_tape_t* tape) {
     if (!tape) return;
     
-    for (uint32_t i = 0; i < tape->node_count; i++) {
-        /* Nodes are managed by memory pools */
+    /* Nodes belong to whoever created them (usually a step arena), the
+     * pooled gradients to the tape */
+    if (rtka_current_tape == tape) rtka_current_tape = NULL;
+    
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    for (uint32_t i = 0; i < tape->buffer_count; i++) {
+        rtka_tensor_free(tape->buffers[i].tensor);
     }
+    if (tape->buffers) heap->free(tape->buffers, heap->context);
+    heap->free(tape->first_use, heap->context);
+    heap->free(tape->nodes, heap->context);
+    heap->free(tape, heap->context);
+}
+
+/* Create checkpoint manager - heap-backed like the tape */
+rtka_checkpoint_manager_t* rtka_checkpoint_create(uint32_t interval) {
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    rtka_checkpoint_manager_t* mgr = (rtka_checkpoint_manager_t*)heap->alloc(
+        sizeof(rtka_checkpoint_manager_t), heap->context);
+    if (!mgr) return NULL;
+    
+    mgr->checkpoints = NULL;
+    mgr->checkpoint_count = 0;
+    mgr->checkpoint_interval = interval;
+    mgr->capacity = 0;
+    return mgr;
+}
+
+/* Save a checkpoint, growing the list as needed */
+void rtka_checkpoint_save(rtka_checkpoint_manager_t* mgr, rtka_grad_node_t* node) {
+    if (!mgr || !node) return;
+    
+    if (mgr->checkpoint_count >= mgr->capacity) {
+        rtka_allocator_t* heap = rtka_heap_allocator();
+        uint32_t new_capacity = mgr->capacity ? mgr->capacity * 2 : 16;
+        rtka_grad_node_t** new_checkpoints = (rtka_grad_node_t**)heap->alloc(
+            new_capacity * sizeof(rtka_grad_node_t*), heap->context);
+        if (!new_checkpoints) {
+            rtka_grad_node_free(node);
+            return;
+        }
+        
+        if (mgr->checkpoints) {
+            memcpy(new_checkpoints, mgr->checkpoints, mgr->checkpoint_count * sizeof(rtka_grad_node_t*));
+            heap->free(mgr->checkpoints, heap->context);
+        }
+        mgr->checkpoints = new_checkpoints;
+        mgr->capacity = new_capacity;
+    }
+    
+    mgr->checkpoints[mgr->checkpoint_count++] = node;
+}
+
+/* Drop every saved checkpoint, keeping the list for the next sequence */
+void rtka_checkpoint_clear(rtka_checkpoint_manager_t* mgr) {
+    if (!mgr) return;
+    
+    for (uint32_t i = 0; i < mgr->checkpoint_count; i++) {
+        rtka_grad_node_free(mgr->checkpoints[i]);
+    }
+    mgr->checkpoint_count = 0;
+}
+
+/* Free checkpoint manager with its checkpoints */
+void rtka_checkpoint_free(rtka_checkpoint_manager_t* mgr) {
+    if (!mgr) return;
+    
+    rtka_checkpoint_clear(mgr);
     
-    rtka_free_state((rtka_state_t*)tape);
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    if (mgr->checkpoints) heap->free(mgr->checkpoints, heap->context);
+    heap->free(mgr, heap->context);
 }
@@ -7,6 +7,12 @@
  * distributed, or used without explicit written permission.
  *
  * RTKA Gradient Operations - Automatic Differentiation
+ *
+ * Ops record onto the current tape in execution order, so backward is one
+ * reverse sweep over it. Leaves (parameters, inputs) own their gradients;
+ * op results draw theirs from the tape's buffer pool when the first
+ * gradient reaches them and hand them back once their own backward has
+ * consumed them, so a deep chain keeps only a few gradient buffers live.
  */
 
 #ifndef RTKA_GRADIENT_H
@@ -38,23 +44,43 @@ struct rtka_grad_node {
     
     rtka_grad_op_t op;
     rtka_grad_node_t* inputs[2];
-    rtka_grad_node_t** outputs;
-    uint32_t output_count;
+    uint32_t tape_index;          /* Position on the recording tape, UINT32_MAX if off-tape */
     
     bool requires_grad;
     bool grad_computed;
+    bool grad_pooled;             /* grad is lent by the tape, not owned */
     uint32_t ref_count;
     
     /* Saved tensors for backward pass */
     void* saved_tensors[2];
+    
+    rtka_allocator_t* allocator;  /* Node and grad live with the data tensor */
 };
 
+/* Gradient buffer held by a tape, lent to one op node at a time */
+typedef struct {
+    rtka_tensor_t* tensor;
+    bool in_use;
+} rtka_grad_buffer_t;
+
 /* Gradient tape for automatic differentiation */
 typedef struct {
     rtka_grad_node_t** nodes;
     uint32_t node_count;
     uint32_t capacity;
     bool recording;
+    
+    /* Free op results' data once the last backward that reads it has run
+     * (off by default: callers often keep intermediate activations) */
+    bool release_activations;
+    
+    uint32_t* first_use;          /* Liveness: first consumer's tape index, per node */
+    
+    rtka_grad_buffer_t* buffers;  /* Heap-backed, recycled across steps */
+    uint32_t buffer_count;
+    uint32_t buffer_capacity;
+    size_t live_grad_bytes;       /* Lent right now */
+    size_t peak_grad_bytes;       /* High-water mark since begin */
 } rtka_grad_tape_t;
 
 /* Gradient functions for ternary operations */
@@ -69,13 +95,16 @@ typedef struct {
 /* Global gradient tape */
 extern _Thread_local rtka_grad_tape_t* rtka_current_tape;
 
-/* Tape operations */
+/* Tape operations - begin starts a fresh recording, so a tape can be
+ * reused across steps whose nodes lived in a released arena. Begin also
+ * takes back every pooled gradient, so op-node grads of the previous step
+ * are invalid after it. */
 rtka_grad_tape_t* rtka_grad_tape_create(void);
 void rtka_grad_tape_free(rtka_grad_tape_t* tape);
 void rtka_grad_tape_begin(rtka_grad_tape_t* tape);
 void rtka_grad_tape_end(rtka_grad_tape_t* tape);
 
-/* Node creation */
+/* Node creation - the node owns data and frees it with its gradient */
 rtka_grad_node_t* rtka_grad_node_create(rtka_tensor_t* data, bool requires_grad);
 void rtka_grad_node_free(rtka_grad_node_t* node);
 
@@ -85,7 +114,9 @@ rtka_grad_node_t* rtka_grad_or(rtka_grad_node_t* a, rtka_grad_node_t* b);
 rtka_grad_node_t* rtka_grad_not(rtka_grad_node_t* a);
 rtka_grad_node_t* rtka_grad_matmul(rtka_grad_node_t* a, rtka_grad_node_t* b);
 
-/* Backward pass */
+/* Backward pass - reverse sweep over the current tape. Leaf gradients
+ * accumulate; op-node gradients other than output's are returned to the
+ * pool (grad = NULL) once consumed. */
 void rtka_grad_backward(rtka_grad_node_t* output);
 void rtka_grad_zero(rtka_grad_node_t* node);
 
@@ -121,15 +152,24 @@ void rtka_grad_accumulate(rtka_tensor_t* grad, const rtka_tensor_t* delta);
 void rtka_grad_clip_norm(rtka_tensor_t* grad, rtka_confidence_t max_norm);
 void rtka_grad_clip_value(rtka_tensor_t* grad, rtka_confidence_t min_val, rtka_confidence_t max_val);
 
-/* Checkpointing for memory efficiency */
+/* Checkpointing for memory efficiency - keep every interval-th state and
+ * recompute the steps in between during backward */
 typedef struct {
     rtka_grad_node_t** checkpoints;
     uint32_t checkpoint_count;
     uint32_t checkpoint_interval;
+    uint32_t capacity;
 } rtka_checkpoint_manager_t;
 
 rtka_checkpoint_manager_t* rtka_checkpoint_create(uint32_t interval);
+/* The manager takes ownership of node and frees it on clear / free */
 void rtka_checkpoint_save(rtka_checkpoint_manager_t* mgr, rtka_grad_node_t* node);
+void rtka_checkpoint_clear(rtka_checkpoint_manager_t* mgr);
 void rtka_checkpoint_free(rtka_checkpoint_manager_t* mgr);
 
+/* Whether step starts a new segment */
+RTKA_INLINE bool rtka_checkpoint_due(const rtka_checkpoint_manager_t* mgr, uint32_t step) {
+    return mgr->checkpoint_interval <= 1 || step % mgr->checkpoint_interval == 0;
+}
+
 #endif /* RTKA_GRADIENT_H */
@@ -7,45 +7,648 @@
  * distributed, or used without explicit written permission.
  *
  * RTKA Graph Implementation - Confidence Propagation Networks
+ *
+ * PageRank keeps the original update: a vertex's rank confidence is the OR
+ * of its in-neighbours' confidences over their out-degree, its importance
+ * the plain sum, both damped by 0.85 with uniform teleport, self loops
+ * ignored. OR of confidences is 1 - prod(1 - c), so both accumulations are
+ * reductions over in-edges:
+ *
+ *   PULL   per-source terms (importance / degree, confidence / degree) are
+ *          written once, then every vertex gathers its in-edges from a
+ *          CSC transpose built on the first iteration. Vertex ranges are
+ *          cut by in-edge count so hub vertices do not stall one worker.
+ *   DELTA  the product is carried as a sum of logs, which makes both
+ *          accumulations linear: a vertex whose terms moved by more than
+ *          the tolerance pushes only the change along its CSR out-edges
+ *          (atomic double adds, work split by edge count over the active
+ *          vertices), so late iterations touch a shrinking frontier.
  */
 
+#define _GNU_SOURCE
 #include "rtka_graph.h"
 #include "rtka_memory.h"
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <float.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GRAPH_X86 1
+#include <immintrin.h>
+#endif
+
+#define GRAPH_MIN_CAPACITY   16U
+#define CSR_PARALLEL_EDGES   65536U     /* Smaller edge lists build serially */
+#define CSR_BLOCKS           4U         /* Edge blocks per participant */
+#define CSR_BUCKETS          16U        /* Source ranges per participant */
+#define PAGERANK_CHUNKS      16U        /* Vertex ranges per participant */
+#define PAGERANK_PUSH_GRAIN  16384U     /* Frontier edges per push piece */
+#define PAGERANK_DENSE       20U        /* Gather instead when 1/20 of the edges push */
+#define PAGERANK_MAX_MISS    0.999999f  /* Keeps log(1 - c / degree) finite */
+#define MARKOV_PARALLEL_MIN  65536U     /* Transitions x vectors below which a step runs serially */
+#define MARKOV_LANES         16U        /* Distributions accumulated together per row */
+
+/* ============================================================================
+ * SPARSE GRAPH
+ * ============================================================================ */
 
 /* Create sparse graph */
 rtka_graph_sparse_t* rtka_graph_create_sparse(uint32_t vertices) {
-    rtka_graph_sparse_t* graph = (rtka_graph_sparse_t*)rtka_alloc_state();
+    rtka_graph_sparse_t* graph = (rtka_graph_sparse_t*)calloc(1, sizeof(rtka_graph_sparse_t));
     if (!graph) return NULL;
     
     graph->num_vertices = vertices;
     graph->num_edges = 0;
-    graph->adjacency_list = (uint32_t*)rtka_alloc_states((vertices + 1) * sizeof(uint32_t) / sizeof(rtka_state_t));
-    graph->vertex_states = rtka_alloc_states(vertices);
-    graph->degree = (uint32_t*)rtka_alloc_states(vertices * sizeof(uint32_t) / sizeof(rtka_state_t));
+    graph->adjacency_list = (uint32_t*)calloc((size_t)vertices + 1U, sizeof(uint32_t));
+    graph->vertex_states = (rtka_state_t*)malloc(((size_t)vertices + 1U) * sizeof(rtka_state_t));
+    graph->degree = (uint32_t*)calloc((size_t)vertices + 1U, sizeof(uint32_t));
+    if (!graph->adjacency_list || !graph->vertex_states || !graph->degree) {
+        rtka_graph_free_sparse(graph);
+        return NULL;
+    }
     
     /* Initialize vertices to UNKNOWN */
     for (uint32_t i = 0; i < vertices; i++) {
         graph->vertex_states[i] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
-        graph->degree[i] = 0;
     }
     
     return graph;
 }
 
-/* Initialize PageRank for ternary graph */
+/* ----------------------------------------------------------------------------
+ * Bulk build, a stable two-level counting sort:
+ *   1. Edge blocks count their edges per source bucket (a contiguous vertex
+ *      range), then scatter them, block order kept.
+ *   2. One participant per bucket sorts its edges into rows by source,
+ *      merge sorts each row by target and drops repeats.
+ *   3. Every bucket's kept edges are copied to their final place.
+ * Each step is stable, so the graph does not depend on the thread count.
+ * -------------------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t vertices;
+    uint32_t edges;
+    const uint32_t* from;
+    const uint32_t* to;
+    const rtka_state_t* weights;
+    uint32_t blocks;
+    uint32_t buckets;
+    uint32_t* histogram;               /* blocks x buckets, then scatter cursors */
+    uint32_t* bucket_start;            /* buckets + 1 */
+    uint32_t* bucket_kept;             /* Then where the kept edges go */
+    uint32_t* src;                     /* Pass 1 output, bucket order */
+    uint32_t* dst;                     /* ... scratch of pass 2, output of pass 3 */
+    rtka_state_t* weight;
+    uint32_t* row_dst;                 /* Pass 2 output, rows within each bucket */
+    rtka_state_t* row_weight;
+    rtka_graph_sparse_t* graph;
+    atomic_bool invalid;
+} csr_build_t;
+
+static inline uint32_t csr_bucket(const csr_build_t* b, uint32_t vertex) {
+    return (uint32_t)((uint64_t)vertex * b->buckets / b->vertices);
+}
+
+static inline uint32_t csr_bucket_first(const csr_build_t* b, uint32_t bucket) {
+    return (uint32_t)(((uint64_t)bucket * b->vertices + b->buckets - 1U) / b->buckets);
+}
+
+static inline uint32_t csr_block_first(const csr_build_t* b, uint32_t block) {
+    return (uint32_t)((uint64_t)block * b->edges / b->blocks);
+}
+
+static void csr_count(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    csr_build_t* b = (csr_build_t*)arg;
+    for (uint32_t k = begin; k < end; k++) {
+        uint32_t* histogram = b->histogram + (size_t)k * b->buckets;
+        for (uint32_t e = csr_block_first(b, k); e < csr_block_first(b, k + 1U); e++) {
+            if (b->from[e] >= b->vertices || b->to[e] >= b->vertices) {
+                atomic_store_explicit(&b->invalid, true, memory_order_relaxed);
+                return;
+            }
+            histogram[csr_bucket(b, b->from[e])]++;
+        }
+    }
+}
+
+static void csr_scatter(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    csr_build_t* b = (csr_build_t*)arg;
+    for (uint32_t k = begin; k < end; k++) {
+        uint32_t* cursor = b->histogram + (size_t)k * b->buckets;
+        for (uint32_t e = csr_block_first(b, k); e < csr_block_first(b, k + 1U); e++) {
+            uint32_t slot = cursor[csr_bucket(b, b->from[e])]++;
+            b->src[slot] = b->from[e];
+            b->dst[slot] = b->to[e];
+            if (b->weights) b->weight[slot] = b->weights[e];
+        }
+    }
+}
+
+#define CSR_RUN 16U
+
+static void insertion_sort_row(uint32_t* keys, rtka_state_t* values, uint32_t n) {
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t key = keys[i];
+        rtka_state_t value = values ? values[i] : rtka_make_state(RTKA_UNKNOWN, 0.0f);
+        uint32_t j = i;
+        while (j > 0 && keys[j - 1U] > key) {
+            keys[j] = keys[j - 1U];
+            if (values) values[j] = values[j - 1U];
+            j--;
+        }
+        keys[j] = key;
+        if (values) values[j] = value;
+    }
+}
+
+/* Stable by target: insertion sorted runs, then bottom-up merges through
+ * the scratch arrays (values and value_scratch may be NULL) */
+static void sort_row(uint32_t* keys, rtka_state_t* values,
+                     uint32_t* key_scratch, rtka_state_t* value_scratch, uint32_t n) {
+    for (uint32_t i = 0; i < n; i += CSR_RUN) {
+        insertion_sort_row(keys + i, values ? values + i : NULL, n - i < CSR_RUN ? n - i : CSR_RUN);
+    }
+    if (n <= CSR_RUN) return;
+
+    uint32_t* in_keys = keys;
+    uint32_t* out_keys = key_scratch;
+    rtka_state_t* in_values = values;
+    rtka_state_t* out_values = value_scratch;
+    for (uint64_t width = CSR_RUN; width < n; width *= 2U) {
+        for (uint64_t lo = 0; lo < n; lo += 2U * width) {
+            uint32_t mid = (uint32_t)(lo + width < n ? lo + width : n);
+            uint32_t hi = (uint32_t)(lo + 2U * width < n ? lo + 2U * width : n);
+            uint32_t i = (uint32_t)lo, j = mid, o = (uint32_t)lo;
+            while (i < mid || j < hi) {
+                /* Right only when strictly smaller, so ties keep input order */
+                uint32_t s = (i == mid || (j < hi && in_keys[j] < in_keys[i])) ? j++ : i++;
+                out_keys[o] = in_keys[s];
+                if (values) out_values[o] = in_values[s];
+                o++;
+            }
+        }
+        uint32_t* k = in_keys; in_keys = out_keys; out_keys = k;
+        rtka_state_t* v = in_values; in_values = out_values; out_values = v;
+    }
+    if (in_keys != keys) {
+        memcpy(keys, in_keys, (size_t)n * sizeof(uint32_t));
+        if (values) memcpy(values, in_values, (size_t)n * sizeof(rtka_state_t));
+    }
+}
+
+/* Rows of the bucket's vertices, offsets left relative to the bucket */
+static void csr_rows(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    csr_build_t* b = (csr_build_t*)arg;
+    uint32_t* offsets = b->graph->adjacency_list;
+    uint32_t* degree = b->graph->degree;
+
+    for (uint32_t c = begin; c < end; c++) {
+        uint32_t first = csr_bucket_first(b, c), last = csr_bucket_first(b, c + 1U);
+        uint32_t base = b->bucket_start[c], stop = b->bucket_start[c + 1U];
+
+        for (uint32_t e = base; e < stop; e++) degree[b->src[e]]++;
+        uint32_t pos = base;
+        for (uint32_t v = first; v < last; v++) {
+            offsets[v] = pos;
+            pos += degree[v];
+            degree[v] = 0;
+        }
+        for (uint32_t e = base; e < stop; e++) {
+            uint32_t v = b->src[e];
+            uint32_t slot = offsets[v] + degree[v]++;
+            b->row_dst[slot] = b->dst[e];
+            if (b->weights) b->row_weight[slot] = b->weight[e];
+        }
+
+        /* dst / weight of this range are consumed and serve as scratch */
+        uint32_t kept = base;
+        for (uint32_t v = first; v < last; v++) {
+            uint32_t row = offsets[v], n = degree[v];
+            sort_row(b->row_dst + row, b->weights ? b->row_weight + row : NULL,
+                     b->dst + row, b->weights ? b->weight + row : NULL, n);
+            offsets[v] = kept - base;
+            uint32_t previous = UINT32_MAX;
+            for (uint32_t i = row; i < row + n; i++) {
+                if (b->row_dst[i] == previous) continue;
+                previous = b->row_dst[i];
+                b->row_dst[kept] = previous;
+                if (b->weights) b->row_weight[kept] = b->row_weight[i];
+                kept++;
+            }
+            degree[v] = kept - base - offsets[v];
+        }
+        b->bucket_kept[c] = kept - base;
+    }
+}
+
+static void csr_place(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    csr_build_t* b = (csr_build_t*)arg;
+    uint32_t* offsets = b->graph->adjacency_list;
+    for (uint32_t c = begin; c < end; c++) {
+        uint32_t from = b->bucket_start[c], to = b->bucket_kept[c];
+        uint32_t n = b->bucket_kept[c + 1U] - to;
+        memcpy(b->dst + to, b->row_dst + from, (size_t)n * sizeof(uint32_t));
+        if (b->weights) memcpy(b->weight + to, b->row_weight + from, (size_t)n * sizeof(rtka_state_t));
+        for (uint32_t v = csr_bucket_first(b, c); v < csr_bucket_first(b, c + 1U); v++) offsets[v] += to;
+    }
+}
+
+static void csr_build_free(csr_build_t* b) {
+    free(b->histogram);
+    free(b->bucket_start);
+    free(b->bucket_kept);
+    free(b->src);
+    free(b->dst);
+    free(b->weight);
+    free(b->row_dst);
+    free(b->row_weight);
+}
+
+rtka_graph_sparse_t* rtka_graph_build_csr(uint32_t vertices, uint32_t edges,
+                                          const uint32_t* from, const uint32_t* to,
+                                          const rtka_state_t* weights, rtka_thread_pool_t* pool) {
+    if (edges > 0 && (!from || !to || vertices == 0)) return NULL;
+    rtka_graph_sparse_t* graph = rtka_graph_create_sparse(vertices);
+    if (!graph || edges == 0) return graph;
+
+    if (!pool) pool = rtka_pool_default();
+    uint32_t participants = rtka_pool_size(pool) + 1U;
+    bool small = edges < CSR_PARALLEL_EDGES;
+    csr_build_t b = {
+        .vertices = vertices, .edges = edges, .from = from, .to = to, .weights = weights,
+        .blocks = small ? 1U : participants * CSR_BLOCKS,
+        .buckets = small ? 1U : participants * CSR_BUCKETS,
+        .graph = graph,
+    };
+    if (b.buckets > vertices) b.buckets = vertices;
+    atomic_init(&b.invalid, false);
+
+    b.histogram = (uint32_t*)calloc((size_t)b.blocks * b.buckets, sizeof(uint32_t));
+    b.bucket_start = (uint32_t*)malloc(((size_t)b.buckets + 1U) * sizeof(uint32_t));
+    b.bucket_kept = (uint32_t*)malloc(((size_t)b.buckets + 1U) * sizeof(uint32_t));
+    b.src = (uint32_t*)malloc((size_t)edges * sizeof(uint32_t));
+    b.dst = (uint32_t*)malloc((size_t)edges * sizeof(uint32_t));
+    b.row_dst = (uint32_t*)malloc((size_t)edges * sizeof(uint32_t));
+    if (weights) {
+        b.weight = (rtka_state_t*)malloc((size_t)edges * sizeof(rtka_state_t));
+        b.row_weight = (rtka_state_t*)malloc((size_t)edges * sizeof(rtka_state_t));
+    }
+    bool ok = b.histogram && b.bucket_start && b.bucket_kept && b.src && b.dst && b.row_dst &&
+              (!weights || (b.weight && b.row_weight));
+
+    if (ok) {
+        rtka_pool_parallel_for(pool, 0, b.blocks, 1, csr_count, &b);
+        ok = !atomic_load(&b.invalid);
+    }
+    if (ok) {
+        uint32_t running = 0;
+        for (uint32_t c = 0; c < b.buckets; c++) {
+            b.bucket_start[c] = running;
+            for (uint32_t k = 0; k < b.blocks; k++) {
+                uint32_t* cell = b.histogram + (size_t)k * b.buckets + c;
+                uint32_t count = *cell;
+                *cell = running;
+                running += count;
+            }
+        }
+        b.bucket_start[b.buckets] = running;
+        rtka_pool_parallel_for(pool, 0, b.blocks, 1, csr_scatter, &b);
+        rtka_pool_parallel_for(pool, 0, b.buckets, 1, csr_rows, &b);
+
+        uint32_t kept = 0;
+        for (uint32_t c = 0; c < b.buckets; c++) {
+            uint32_t n = b.bucket_kept[c];
+            b.bucket_kept[c] = kept;
+            kept += n;
+        }
+        b.bucket_kept[b.buckets] = kept;
+        rtka_pool_parallel_for(pool, 0, b.buckets, 1, csr_place, &b);
+
+        graph->adjacency_list[vertices] = kept;
+        graph->num_edges = kept;
+        graph->edge_capacity = edges;
+        graph->edge_indices = b.dst;
+        graph->edge_weights = b.weight;
+        b.dst = NULL;
+        b.weight = NULL;
+    }
+    csr_build_free(&b);
+    if (!ok) {
+        rtka_graph_free_sparse(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+rtka_graph_sparse_t* rtka_graph_create_csr(uint32_t vertices, uint32_t edges,
+                                           const uint32_t* from, const uint32_t* to,
+                                           const rtka_state_t* weights) {
+    return rtka_graph_build_csr(vertices, edges, from, to, weights, NULL);
+}
+
+/* Part of a loaded file rather than the heap */
+static inline bool graph_mapped(const rtka_graph_sparse_t* graph, const void* p) {
+    const uint8_t* base = (const uint8_t*)graph->map;
+    return base && (const uint8_t*)p >= base && (const uint8_t*)p < base + graph->map_length;
+}
+
+/* Grows both edge arrays; weights appear here for graphs built without them,
+ * with the TRUE / 1.0 the unweighted algorithms assume. Mapped arrays are
+ * copied out first. */
+static bool graph_reserve(rtka_graph_sparse_t* graph, uint32_t capacity) {
+    bool mapped = graph_mapped(graph, graph->edge_indices) || graph_mapped(graph, graph->edge_weights);
+    if (capacity <= graph->edge_capacity && graph->edge_weights && !mapped) return true;
+    if (capacity < graph->edge_capacity) capacity = graph->edge_capacity;
+    if (capacity < graph->num_edges) capacity = graph->num_edges;
+
+    uint32_t* indices = graph_mapped(graph, graph->edge_indices) ? NULL : graph->edge_indices;
+    indices = (uint32_t*)realloc(indices, ((size_t)capacity + 1U) * sizeof(uint32_t));
+    if (!indices) return false;
+    if (indices != graph->edge_indices && graph_mapped(graph, graph->edge_indices)) {
+        memcpy(indices, graph->edge_indices, (size_t)graph->num_edges * sizeof(uint32_t));
+    }
+    graph->edge_indices = indices;
+
+    const rtka_state_t* old = graph->edge_weights;
+    rtka_state_t* weights = graph_mapped(graph, old) ? NULL : graph->edge_weights;
+    weights = (rtka_state_t*)realloc(weights, ((size_t)capacity + 1U) * sizeof(rtka_state_t));
+    if (!weights) return false;
+    if (!old) {
+        for (uint32_t e = 0; e < graph->num_edges; e++) weights[e] = rtka_make_state(RTKA_TRUE, 1.0f);
+    } else if (graph_mapped(graph, old)) {
+        memcpy(weights, old, (size_t)graph->num_edges * sizeof(rtka_state_t));
+    }
+    graph->edge_weights = weights;
+
+    graph->edge_capacity = capacity;
+    return true;
+}
+
+/* Rows are sorted by target, so both lookup and insertion point are a
+ * binary search */
+void rtka_graph_add_edge_weighted(rtka_graph_sparse_t* graph, 
+                                  uint32_t from, uint32_t to, 
+                                  rtka_state_t weight) {
+    if (!graph || from >= graph->num_vertices || to >= graph->num_vertices) return;
+
+    uint32_t lo = graph->adjacency_list[from];
+    uint32_t hi = graph->adjacency_list[from + 1U];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2U;
+        if (graph->edge_indices[mid] < to) lo = mid + 1U;
+        else hi = mid;
+    }
+    uint32_t at = lo;
+    if (at < graph->adjacency_list[from + 1U] && graph->edge_indices[at] == to) {
+        if (graph_reserve(graph, graph->num_edges)) graph->edge_weights[at] = weight;
+        return;
+    }
+
+    if (graph->num_edges == UINT32_MAX) return;
+    uint32_t capacity = graph->edge_capacity;
+    if (graph->num_edges == capacity) {
+        capacity = capacity < GRAPH_MIN_CAPACITY ? GRAPH_MIN_CAPACITY
+                 : capacity > UINT32_MAX / 2U ? UINT32_MAX : capacity * 2U;
+    }
+    if (!graph_reserve(graph, capacity)) return;
+
+    uint32_t tail = graph->num_edges - at;
+    memmove(graph->edge_indices + at + 1U, graph->edge_indices + at, (size_t)tail * sizeof(uint32_t));
+    memmove(graph->edge_weights + at + 1U, graph->edge_weights + at, (size_t)tail * sizeof(rtka_state_t));
+    graph->edge_indices[at] = to;
+    graph->edge_weights[at] = weight;
+
+    for (uint32_t v = from + 1U; v <= graph->num_vertices; v++) graph->adjacency_list[v]++;
+    graph->degree[from]++;
+    graph->num_edges++;
+}
+
+void rtka_graph_free_sparse(rtka_graph_sparse_t* graph) {
+    if (!graph) return;
+    if (!graph_mapped(graph, graph->adjacency_list)) free(graph->adjacency_list);
+    if (!graph_mapped(graph, graph->edge_indices)) free(graph->edge_indices);
+    free(graph->vertex_states);
+    if (!graph_mapped(graph, graph->edge_weights)) free(graph->edge_weights);
+    if (!graph_mapped(graph, graph->degree)) free(graph->degree);
+    if (graph->map) munmap(graph->map, graph->map_length);
+    free(graph);
+}
+
+/* ----------------------------------------------------------------------------
+ * Binary file: a 64-byte header, then offsets, degree, targets and weights,
+ * each 64-byte aligned and in memory layout (native byte order, like the
+ * pattern databases), so loading is one private mapping
+ * -------------------------------------------------------------------------- */
+
+#define GRAPH_MAGIC      "RTKAGRF"
+#define GRAPH_VERSION    1U
+#define GRAPH_WEIGHTED   0x1U
+#define GRAPH_ALIGN      64U
+#define GRAPH_ALIGN_UP(x) (((x) + GRAPH_ALIGN - 1U) & ~(uint64_t)(GRAPH_ALIGN - 1U))
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    uint64_t offsets;                  /* File positions of the arrays */
+    uint64_t degree;
+    uint64_t targets;
+    uint64_t weights;                  /* 0 without weights */
+    uint32_t state_size;               /* sizeof(rtka_state_t) when written */
+    uint8_t reserved[4];
+} graph_header_t;
+
+static void graph_layout(graph_header_t* h) {
+    uint64_t pos = sizeof(graph_header_t);
+    h->offsets = pos;
+    pos = GRAPH_ALIGN_UP(pos + ((uint64_t)h->num_vertices + 1U) * sizeof(uint32_t));
+    h->degree = pos;
+    pos = GRAPH_ALIGN_UP(pos + (uint64_t)h->num_vertices * sizeof(uint32_t));
+    h->targets = pos;
+    pos = GRAPH_ALIGN_UP(pos + (uint64_t)h->num_edges * sizeof(uint32_t));
+    h->weights = (h->flags & GRAPH_WEIGHTED) ? pos : 0U;
+}
+
+static uint64_t graph_file_size(const graph_header_t* h) {
+    if (h->weights) return h->weights + (uint64_t)h->num_edges * sizeof(rtka_state_t);
+    return h->targets + (uint64_t)h->num_edges * sizeof(uint32_t);
+}
+
+static bool write_at(FILE* f, uint64_t pos, const void* data, size_t bytes) {
+    static const uint8_t zeros[GRAPH_ALIGN] = {0};
+    long here = ftell(f);
+    if (here < 0 || (uint64_t)here > pos || pos - (uint64_t)here > GRAPH_ALIGN) return false;
+    if (fwrite(zeros, 1, (size_t)(pos - (uint64_t)here), f) != (size_t)(pos - (uint64_t)here)) return false;
+    return bytes == 0 || fwrite(data, 1, bytes, f) == bytes;
+}
+
+rtka_error_t rtka_graph_save(const rtka_graph_sparse_t* graph, const char* path) {
+    if (!graph || !path) return RTKA_ERROR_NULL_POINTER;
+    graph_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC));
+    header.version = GRAPH_VERSION;
+    header.flags = graph->edge_weights ? GRAPH_WEIGHTED : 0U;
+    header.num_vertices = graph->num_vertices;
+    header.num_edges = graph->num_edges;
+    header.state_size = sizeof(rtka_state_t);
+    graph_layout(&header);
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return RTKA_ERROR_INVALID_VALUE;
+    size_t n = graph->num_vertices, m = graph->num_edges;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              write_at(f, header.offsets, graph->adjacency_list, (n + 1U) * sizeof(uint32_t)) &&
+              write_at(f, header.degree, graph->degree, n * sizeof(uint32_t)) &&
+              write_at(f, header.targets, graph->edge_indices, m * sizeof(uint32_t)) &&
+              (!header.weights || write_at(f, header.weights, graph->edge_weights, m * sizeof(rtka_state_t)));
+    ok &= fclose(f) == 0;
+    if (!ok) remove(path);
+    return ok ? RTKA_SUCCESS : RTKA_ERROR_INVALID_VALUE;
+}
+
+rtka_error_t rtka_graph_load(rtka_graph_sparse_t** out, const char* path) {
+    if (!out || !path) return RTKA_ERROR_NULL_POINTER;
+    *out = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return RTKA_ERROR_INVALID_VALUE;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(graph_header_t)) {
+        close(fd);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    size_t length = (size_t)st.st_size;
+    /* Private and writable: vertex updates or edge insertions copy pages,
+     * the file is never changed */
+    void* map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    graph_header_t header;
+    memcpy(&header, map, sizeof(header));
+    graph_header_t expect = header;
+    graph_layout(&expect);
+    const uint32_t* offsets = (const uint32_t*)((const uint8_t*)map + expect.offsets);
+    bool ok = memcmp(header.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) == 0 && header.version == GRAPH_VERSION &&
+              header.state_size == sizeof(rtka_state_t) && (header.flags & ~GRAPH_WEIGHTED) == 0 &&
+              header.offsets == expect.offsets && header.degree == expect.degree &&
+              header.targets == expect.targets && header.weights == expect.weights &&
+              length == graph_file_size(&header) &&
+              offsets[0] == 0 && offsets[header.num_vertices] == header.num_edges;
+
+    rtka_graph_sparse_t* graph = ok ? (rtka_graph_sparse_t*)calloc(1, sizeof(rtka_graph_sparse_t)) : NULL;
+    if (graph) {
+        graph->vertex_states = (rtka_state_t*)malloc(((size_t)header.num_vertices + 1U) * sizeof(rtka_state_t));
+        if (!graph->vertex_states) {
+            free(graph);
+            graph = NULL;
+        }
+    }
+    if (!graph) {
+        munmap(map, length);
+        return ok ? RTKA_ERROR_OUT_OF_MEMORY : RTKA_ERROR_INVALID_VALUE;
+    }
+
+    uint8_t* base = (uint8_t*)map;
+    graph->map = map;
+    graph->map_length = length;
+    graph->num_vertices = header.num_vertices;
+    graph->num_edges = header.num_edges;
+    graph->edge_capacity = header.num_edges;
+    graph->adjacency_list = (uint32_t*)(void*)(base + header.offsets);
+    graph->degree = (uint32_t*)(void*)(base + header.degree);
+    graph->edge_indices = (uint32_t*)(void*)(base + header.targets);
+    graph->edge_weights = header.weights ? (rtka_state_t*)(void*)(base + header.weights) : NULL;
+    for (uint32_t i = 0; i < graph->num_vertices; i++) {
+        graph->vertex_states[i] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
+    }
+    *out = graph;
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * PAGERANK
+ * ============================================================================ */
+
+struct rtka_pagerank_work {
+    rtka_pagerank_mode_t mode;
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    uint32_t chunks;
+    uint32_t* bounds;                  /* chunks + 1 vertex boundaries */
+    double* chunk_residual;
+    float* inv_degree;
+    /* PULL: in-edge transpose without self loops, per-source terms */
+    uint32_t* in_offsets;
+    uint32_t* in_sources;
+    float* out_importance;             /* importance / degree */
+    float* out_share;                  /* rank confidence / degree */
+    /* DELTA: what has arrived over in-edges and what each vertex has sent */
+    _Atomic double* sum_importance;
+    _Atomic double* sum_log_miss;
+    float* sent_importance;
+    float* sent_log_miss;
+    float* delta_importance;
+    float* delta_log_miss;
+    _Atomic uint8_t* touched;          /* Received something this iteration */
+    uint32_t* frontier;                /* Pushing vertices, packed from bounds[c] */
+    uint32_t* frontier_edges;          /* Inclusive out-edge prefix within the chunk */
+    uint32_t* chunk_active;
+    uint64_t* chunk_edges;             /* chunks + 1 prefix of frontier edges */
+    float tolerance;                   /* Per-vertex change that triggers a push */
+};
+
+typedef struct {
+    rtka_pagerank_t* pr;
+    const rtka_graph_sparse_t* graph;
+    rtka_pagerank_work_t* work;
+    float damping;
+    float teleport;
+    bool shared;                       /* Other threads push concurrently */
+    bool apply;                        /* DELTA: take in arrivals (false to seed) */
+    uint64_t push_total;
+    uint32_t push_pieces;
+} pagerank_ctx_t;
+
+typedef double (*pagerank_pull_fn)(const pagerank_ctx_t* ctx, uint32_t begin, uint32_t end);
+
+typedef struct {
+    rtka_simd_level_t level;
+    pagerank_pull_fn pull;
+} pagerank_kernel_t;
+
 rtka_pagerank_t* rtka_pagerank_init(rtka_graph_sparse_t* graph) {
-    rtka_pagerank_t* pr = (rtka_pagerank_t*)rtka_alloc_state();
+    if (!graph) return NULL;
+    rtka_pagerank_t* pr = (rtka_pagerank_t*)calloc(1, sizeof(rtka_pagerank_t));
     if (!pr) return NULL;
     
-    pr->ranks = rtka_alloc_states(graph->num_vertices);
-    pr->importance = (rtka_confidence_t*)rtka_alloc_states(graph->num_vertices * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
+    size_t n = (size_t)graph->num_vertices + 1U;
+    pr->ranks = (rtka_state_t*)malloc(n * sizeof(rtka_state_t));
+    pr->importance = (rtka_confidence_t*)malloc(n * sizeof(rtka_confidence_t));
+    if (!pr->ranks || !pr->importance) {
+        rtka_pagerank_free(pr);
+        return NULL;
+    }
     pr->iterations = 0;
     pr->convergence_threshold = 0.001f;
+    pr->mode = RTKA_PAGERANK_PULL;
+    pr->residual = FLT_MAX;
     
     /* Initialize with uniform distribution */
-    rtka_confidence_t initial = 1.0f / graph->num_vertices;
+    rtka_confidence_t initial = graph->num_vertices ? 1.0f / graph->num_vertices : 0.0f;
     for (uint32_t i = 0; i < graph->num_vertices; i++) {
         pr->ranks[i] = rtka_make_state(RTKA_UNKNOWN, initial);
         pr->importance[i] = initial;
@@ -54,239 +657,2079 @@ rtka_pagerank_t* rtka_pagerank_init(rtka_graph_sparse_t* graph) {
     return pr;
 }
 
-/* PageRank iteration with ternary logic */
-void rtka_pagerank_iterate(rtka_pagerank_t* pr, rtka_graph_sparse_t* graph) {
-    rtka_confidence_t damping = 0.85f;
-    rtka_confidence_t teleport = (1.0f - damping) / graph->num_vertices;
-    
-    rtka_state_t* new_ranks = rtka_alloc_states(graph->num_vertices);
-    rtka_confidence_t* new_importance = (rtka_confidence_t*)rtka_alloc_states(
-        graph->num_vertices * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
-    
-    for (uint32_t v = 0; v < graph->num_vertices; v++) {
-        rtka_state_t rank_sum = rtka_make_state(RTKA_FALSE, 0.0f);
-        rtka_confidence_t importance_sum = 0.0f;
-        
-        /* Iterate through incoming edges */
-        for (uint32_t u = 0; u < graph->num_vertices; u++) {
-            if (u == v) continue;
-            
-            /* Check edge existence in adjacency */
-            uint32_t start = graph->adjacency_list[u];
-            uint32_t end = graph->adjacency_list[u + 1];
-            
-            for (uint32_t e = start; e < end; e++) {
-                if (graph->edge_indices[e] == v) {
-                    /* Propagate confidence through edge */
-                    rtka_state_t contribution = pr->ranks[u];
-                    
-                    if (graph->degree[u] > 0) {
-                        contribution.confidence /= graph->degree[u];
-                        
-                        /* Ternary logic: combine contributions */
-                        rank_sum = rtka_combine_or(rank_sum, contribution);
-                        importance_sum += pr->importance[u] / graph->degree[u];
-                    }
-                    break;
-                }
-            }
+static void work_free(rtka_pagerank_work_t* work) {
+    if (!work) return;
+    free(work->bounds);
+    free(work->chunk_residual);
+    free(work->inv_degree);
+    free(work->in_offsets);
+    free(work->in_sources);
+    free(work->out_importance);
+    free(work->out_share);
+    free((void*)work->sum_importance);
+    free((void*)work->sum_log_miss);
+    free(work->sent_importance);
+    free(work->sent_log_miss);
+    free(work->delta_importance);
+    free(work->delta_log_miss);
+    free((void*)work->touched);
+    free(work->frontier);
+    free(work->frontier_edges);
+    free(work->chunk_active);
+    free(work->chunk_edges);
+    free(work);
+}
+
+void rtka_pagerank_free(rtka_pagerank_t* pr) {
+    if (!pr) return;
+    work_free(pr->work);
+    free(pr->ranks);
+    free(pr->importance);
+    free(pr);
+}
+
+/* Chunk c starts at the first vertex whose offsets[v] + v reaches c / chunks
+ * of the total, so every range holds about the same edges plus vertices */
+static void cut_ranges(rtka_pagerank_work_t* work, const uint32_t* offsets) {
+    uint32_t n = work->num_vertices;
+    uint64_t total = (uint64_t)offsets[n] + n;
+    work->bounds[0] = 0;
+    for (uint32_t c = 1; c < work->chunks; c++) {
+        uint64_t target = total * c / work->chunks;
+        uint32_t lo = work->bounds[c - 1U], hi = n;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2U;
+            if ((uint64_t)offsets[mid] + mid < target) lo = mid + 1U;
+            else hi = mid;
         }
-        
-        /* Apply damping and teleportation */
-        new_ranks[v].value = rank_sum.value;
-        new_ranks[v].confidence = damping * rank_sum.confidence + teleport;
-        new_importance[v] = damping * importance_sum + teleport;
-        
-        /* Ternary state transition based on confidence */
-        if (new_ranks[v].confidence > 0.66f) {
-            new_ranks[v].value = RTKA_TRUE;
-        } else if (new_ranks[v].confidence < 0.33f) {
-            new_ranks[v].value = RTKA_FALSE;
-        } else {
-            new_ranks[v].value = RTKA_UNKNOWN;
+        work->bounds[c] = lo;
+    }
+    work->bounds[work->chunks] = n;
+}
+
+static bool build_transpose(rtka_pagerank_work_t* work, const rtka_graph_sparse_t* graph) {
+    uint32_t n = graph->num_vertices;
+    uint32_t* offsets = work->in_offsets;
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1U]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            if (v != u) offsets[v + 1U]++;
         }
     }
-    
-    memcpy(pr->ranks, new_ranks, graph->num_vertices * sizeof(rtka_state_t));
-    memcpy(pr->importance, new_importance, graph->num_vertices * sizeof(rtka_confidence_t));
-    pr->iterations++;
+    for (uint32_t v = 0; v < n; v++) offsets[v + 1U] += offsets[v];
+
+    work->in_sources = (uint32_t*)malloc(((size_t)offsets[n] + 1U) * sizeof(uint32_t));
+    uint32_t* fill = (uint32_t*)malloc(((size_t)n + 1U) * sizeof(uint32_t));
+    if (!work->in_sources || !fill) {
+        free(fill);
+        return false;
+    }
+    memcpy(fill, offsets, (size_t)n * sizeof(uint32_t));
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1U]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            if (v != u) work->in_sources[fill[v]++] = u;
+        }
+    }
+    free(fill);
+    return true;
 }
 
-/* Check convergence */
-bool rtka_pagerank_converged(rtka_pagerank_t* pr) {
-    static rtka_confidence_t* prev_importance = NULL;
-    
-    if (!prev_importance) {
-        prev_importance = (rtka_confidence_t*)rtka_alloc_states(
-            pr->iterations * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
+static rtka_pagerank_work_t* work_create(const rtka_pagerank_t* pr, const rtka_graph_sparse_t* graph,
+                                         uint32_t participants) {
+    rtka_pagerank_work_t* work = (rtka_pagerank_work_t*)calloc(1, sizeof(rtka_pagerank_work_t));
+    if (!work) return NULL;
+
+    uint32_t n = graph->num_vertices;
+    size_t count = (size_t)n + 1U;
+    work->mode = pr->mode;
+    work->num_vertices = n;
+    work->num_edges = graph->num_edges;
+    work->chunks = participants * PAGERANK_CHUNKS;
+    if (work->chunks > n) work->chunks = n ? n : 1U;
+    work->tolerance = n ? pr->convergence_threshold / (4.0f * (float)n) : 0.0f;
+
+    work->bounds = (uint32_t*)malloc(((size_t)work->chunks + 1U) * sizeof(uint32_t));
+    work->chunk_residual = (double*)calloc(work->chunks, sizeof(double));
+    work->inv_degree = (float*)malloc(count * sizeof(float));
+    bool ok = work->bounds && work->chunk_residual && work->inv_degree;
+
+    if (ok) {
+        work->in_offsets = (uint32_t*)calloc(count, sizeof(uint32_t));
+        ok = work->in_offsets && build_transpose(work, graph);
+        if (ok) cut_ranges(work, work->in_offsets);
     }
-    
-    if (pr->iterations < 2) return false;
-    
-    rtka_confidence_t diff = 0.0f;
-    for (uint32_t i = 0; i < pr->iterations; i++) {
-        diff += fabsf(pr->importance[i] - prev_importance[i]);
+    if (ok && pr->mode == RTKA_PAGERANK_PULL) {
+        work->out_importance = (float*)malloc(count * sizeof(float));
+        work->out_share = (float*)malloc(count * sizeof(float));
+        ok = work->out_importance && work->out_share;
+    } else if (ok) {
+        work->sum_importance = (_Atomic double*)calloc(count, sizeof(double));
+        work->sum_log_miss = (_Atomic double*)calloc(count, sizeof(double));
+        work->sent_importance = (float*)calloc(count, sizeof(float));
+        work->sent_log_miss = (float*)calloc(count, sizeof(float));
+        work->delta_importance = (float*)malloc(count * sizeof(float));
+        work->delta_log_miss = (float*)malloc(count * sizeof(float));
+        /* The first update takes in every vertex, sources or not */
+        work->touched = (_Atomic uint8_t*)malloc(count * sizeof(uint8_t));
+        if (work->touched) memset((void*)work->touched, 1, count);
+        work->frontier = (uint32_t*)malloc(count * sizeof(uint32_t));
+        work->frontier_edges = (uint32_t*)malloc(count * sizeof(uint32_t));
+        work->chunk_active = (uint32_t*)calloc(work->chunks, sizeof(uint32_t));
+        work->chunk_edges = (uint64_t*)calloc((size_t)work->chunks + 1U, sizeof(uint64_t));
+        ok = work->sum_importance && work->sum_log_miss && work->sent_importance && work->sent_log_miss &&
+             work->delta_importance && work->delta_log_miss && work->touched &&
+             work->frontier && work->frontier_edges &&
+             work->chunk_active && work->chunk_edges;
     }
-    
-    memcpy(prev_importance, pr->importance, pr->iterations * sizeof(rtka_confidence_t));
-    return diff < pr->convergence_threshold;
+    if (!ok) {
+        work_free(work);
+        return NULL;
+    }
+
+    for (uint32_t v = 0; v < n; v++) {
+        work->inv_degree[v] = graph->degree[v] ? 1.0f / (float)graph->degree[v] : 0.0f;
+    }
+    return work;
 }
 
-/* Markov transition matrix from graph */
-rtka_transition_matrix_t* rtka_markov_from_graph(rtka_graph_sparse_t* graph) {
-    rtka_transition_matrix_t* tm = (rtka_transition_matrix_t*)rtka_alloc_state();
-    if (!tm) return NULL;
-    
-    tm->size = graph->num_vertices;
-    tm->damping_factor = 0.85f;
-    tm->matrix = (rtka_state_t**)rtka_alloc_states(tm->size * sizeof(void*) / sizeof(rtka_state_t));
-    
-    for (uint32_t i = 0; i < tm->size; i++) {
-        tm->matrix[i] = rtka_alloc_states(tm->size);
-        
-        for (uint32_t j = 0; j < tm->size; j++) {
-            /* Initialize transition probability */
-            if (i == j) {
-                tm->matrix[i][j] = rtka_make_state(RTKA_UNKNOWN, 0.1f);
-            } else {
-                tm->matrix[i][j] = rtka_make_state(RTKA_FALSE, 0.0f);
-            }
+/* Damping, teleport and the ternary state transition; returns |change| of
+ * the importance */
+static inline float finish_vertex(const pagerank_ctx_t* ctx, uint32_t v, float sum, float any) {
+    rtka_pagerank_t* pr = ctx->pr;
+    rtka_state_t* rank = &pr->ranks[v];
+    rank->confidence = ctx->damping * any + ctx->teleport;
+    if (rank->confidence > 0.66f) {
+        rank->value = RTKA_TRUE;
+    } else if (rank->confidence < 0.33f) {
+        rank->value = RTKA_FALSE;
+    } else {
+        rank->value = RTKA_UNKNOWN;
+    }
+
+    float importance = ctx->damping * sum + ctx->teleport;
+    float change = fabsf(importance - pr->importance[v]);
+    pr->importance[v] = importance;
+    return change;
+}
+
+static double pull_scalar(const pagerank_ctx_t* ctx, uint32_t begin, uint32_t end) {
+    const rtka_pagerank_work_t* work = ctx->work;
+    const uint32_t* RTKA_RESTRICT offsets = work->in_offsets;
+    const uint32_t* RTKA_RESTRICT sources = work->in_sources;
+    const float* RTKA_RESTRICT out_importance = work->out_importance;
+    const float* RTKA_RESTRICT out_share = work->out_share;
+
+    double residual = 0.0;
+    for (uint32_t v = begin; v < end; v++) {
+        float sum = 0.0f, any = 0.0f;
+        for (uint32_t e = offsets[v]; e < offsets[v + 1U]; e++) {
+            uint32_t u = sources[e];
+            sum += out_importance[u];
+            any = rtka_conf_or(any, out_share[u]);
         }
-        
-        /* Set transitions based on edges */
-        uint32_t start = graph->adjacency_list[i];
-        uint32_t end = graph->adjacency_list[i + 1];
-        uint32_t out_degree = end - start;
-        
-        if (out_degree > 0) {
-            rtka_confidence_t prob = 1.0f / out_degree;
-            
-            for (uint32_t e = start; e < end; e++) {
-                uint32_t j = graph->edge_indices[e];
-                rtka_state_t edge_weight = graph->edge_weights ? 
-                    graph->edge_weights[e] : rtka_make_state(RTKA_TRUE, prob);
-                
-                /* Ternary transition probability */
-                tm->matrix[i][j] = edge_weight;
-                tm->matrix[i][j].confidence *= prob;
+        residual += finish_vertex(ctx, v, sum, any);
+    }
+    return residual;
+}
+
+static const pagerank_kernel_t kernel_scalar = {RTKA_SIMD_SCALAR, pull_scalar};
+
+#ifdef GRAPH_X86
+
+__attribute__((target("avx2")))
+static inline float hsum_avx2(__m256 x) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+/* a + b - ab per lane, the form rtka_conf_or uses: 1 - prod(1 - c) would
+ * cancel for the small shares of large graphs */
+__attribute__((target("avx2")))
+static inline __m256 or_avx2(__m256 a, __m256 b) {
+    return _mm256_sub_ps(_mm256_add_ps(a, b), _mm256_mul_ps(a, b));
+}
+
+__attribute__((target("avx2")))
+static inline float hor_avx2(__m256 x) {
+    float lanes[8];
+    _mm256_storeu_ps(lanes, x);
+    float any = 0.0f;
+    for (uint32_t i = 0; i < 8; i++) any = rtka_conf_or(any, lanes[i]);
+    return any;
+}
+
+/* Eight in-edges per step; the tail is a masked gather whose inactive lanes
+ * hold 0, the identity of both */
+__attribute__((target("avx2")))
+static double pull_avx2(const pagerank_ctx_t* ctx, uint32_t begin, uint32_t end) {
+    const rtka_pagerank_work_t* work = ctx->work;
+    const uint32_t* RTKA_RESTRICT offsets = work->in_offsets;
+    const uint32_t* RTKA_RESTRICT sources = work->in_sources;
+    const float* RTKA_RESTRICT out_importance = work->out_importance;
+    const float* RTKA_RESTRICT out_share = work->out_share;
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 zero = _mm256_setzero_ps();
+
+    double residual = 0.0;
+    for (uint32_t v = begin; v < end; v++) {
+        uint32_t e = offsets[v];
+        uint32_t stop = offsets[v + 1U];
+        if (stop - e < 8U) {
+            /* Short rows: the scalar fold beats a masked gather */
+            float sum = 0.0f, any = 0.0f;
+            for (; e < stop; e++) {
+                uint32_t u = sources[e];
+                sum += out_importance[u];
+                any = rtka_conf_or(any, out_share[u]);
             }
+            residual += finish_vertex(ctx, v, sum, any);
+            continue;
+        }
+        __m256 sum = zero, any = zero;
+        for (; e + 8U <= stop; e += 8U) {
+            __m256i idx = _mm256_loadu_si256((const __m256i*)(const void*)(sources + e));
+            sum = _mm256_add_ps(sum, _mm256_i32gather_ps(out_importance, idx, 4));
+            any = or_avx2(any, _mm256_i32gather_ps(out_share, idx, 4));
+        }
+        if (e < stop) {
+            __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32((int)(stop - e)), lanes);
+            __m256i idx = _mm256_maskload_epi32((const int*)(const void*)(sources + e), mask);
+            __m256 fmask = _mm256_castsi256_ps(mask);
+            sum = _mm256_add_ps(sum, _mm256_mask_i32gather_ps(zero, out_importance, idx, fmask, 4));
+            any = or_avx2(any, _mm256_mask_i32gather_ps(zero, out_share, idx, fmask, 4));
         }
+        residual += finish_vertex(ctx, v, hsum_avx2(sum), hor_avx2(any));
     }
-    
-    return tm;
+    return residual;
 }
 
-/* Markov step with ternary states */
-void rtka_markov_step(rtka_state_t* current, rtka_transition_matrix_t* tm, rtka_state_t* next) {
-    for (uint32_t j = 0; j < tm->size; j++) {
-        rtka_state_t new_state = rtka_make_state(RTKA_FALSE, 0.0f);
-        
-        for (uint32_t i = 0; i < tm->size; i++) {
-            /* Ternary matrix multiplication */
-            rtka_state_t contribution = rtka_combine_and(current[i], tm->matrix[i][j]);
-            new_state = rtka_combine_or(new_state, contribution);
-        }
-        
-        /* Apply damping for stability */
-        new_state.confidence = tm->damping_factor * new_state.confidence + 
-                               (1.0f - tm->damping_factor) / tm->size;
-        
-        /* Quantize to ternary */
-        if (new_state.confidence > 0.66f) {
-            new_state.value = RTKA_TRUE;
-        } else if (new_state.confidence < 0.33f) {
-            new_state.value = RTKA_FALSE;
-        } else {
-            new_state.value = RTKA_UNKNOWN;
+static const pagerank_kernel_t kernel_avx2 = {RTKA_SIMD_AVX2, pull_avx2};
+
+#endif /* GRAPH_X86 */
+
+static _Atomic(const pagerank_kernel_t*) g_pagerank_kernel = NULL;
+
+static const pagerank_kernel_t* kernel_for_level(rtka_simd_level_t level) {
+    switch (level) {
+        case RTKA_SIMD_SCALAR:
+            return &kernel_scalar;
+#ifdef GRAPH_X86
+        case RTKA_SIMD_AVX2:
+            if (!__builtin_cpu_supports("avx2")) return NULL;
+            return &kernel_avx2;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static const pagerank_kernel_t* select_kernel(void) {
+#ifdef GRAPH_X86
+    __builtin_cpu_init();
+#endif
+    const pagerank_kernel_t* k = kernel_for_level(RTKA_SIMD_AVX2);
+    return k ? k : &kernel_scalar;
+}
+
+static RTKA_INLINE const pagerank_kernel_t* pagerank_kernel(void) {
+    const pagerank_kernel_t* k = atomic_load_explicit(&g_pagerank_kernel, memory_order_relaxed);
+    if (RTKA_UNLIKELY(!k)) {
+        k = select_kernel();
+        atomic_store_explicit(&g_pagerank_kernel, k, memory_order_relaxed);
+    }
+    return k;
+}
+
+rtka_simd_level_t rtka_pagerank_kernel(void) {
+    return pagerank_kernel()->level;
+}
+
+bool rtka_pagerank_set_kernel(rtka_simd_level_t level) {
+    const pagerank_kernel_t* k = kernel_for_level(level);
+    if (!k) return false;
+    atomic_store_explicit(&g_pagerank_kernel, k, memory_order_relaxed);
+    return true;
+}
+
+/* PULL, phase 1: what each vertex sends over every out-edge */
+static void pull_terms(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const pagerank_ctx_t* ctx = (const pagerank_ctx_t*)arg;
+    rtka_pagerank_work_t* work = ctx->work;
+    const rtka_pagerank_t* pr = ctx->pr;
+    for (uint32_t c = begin; c < end; c++) {
+        for (uint32_t u = work->bounds[c]; u < work->bounds[c + 1U]; u++) {
+            float inv = work->inv_degree[u];
+            work->out_importance[u] = pr->importance[u] * inv;
+            work->out_share[u] = pr->ranks[u].confidence * inv;
         }
-        
-        next[j] = new_state;
     }
 }
 
-/* Confidence propagation through graph */
-void rtka_propagate_confidence(rtka_graph_sparse_t* graph, uint32_t source, uint32_t max_depth) {
-    if (source >= graph->num_vertices) return;
-    
-    /* BFS-like propagation with confidence decay */
-    rtka_state_t* visited = rtka_alloc_states(graph->num_vertices);
-    uint32_t* queue = (uint32_t*)rtka_alloc_states(graph->num_vertices * sizeof(uint32_t) / sizeof(rtka_state_t));
-    uint32_t* depths = (uint32_t*)rtka_alloc_states(graph->num_vertices * sizeof(uint32_t) / sizeof(rtka_state_t));
-    
-    uint32_t head = 0, tail = 0;
-    queue[tail++] = source;
-    visited[source] = rtka_make_state(RTKA_TRUE, 1.0f);
-    depths[source] = 0;
-    
-    while (head < tail && depths[queue[head]] < max_depth) {
-        uint32_t v = queue[head++];
-        uint32_t current_depth = depths[v];
-        rtka_state_t v_state = graph->vertex_states[v];
-        
-        /* Propagate to neighbors */
-        uint32_t start = graph->adjacency_list[v];
-        uint32_t end = graph->adjacency_list[v + 1];
-        
-        for (uint32_t e = start; e < end; e++) {
-            uint32_t u = graph->edge_indices[e];
-            
-            if (visited[u].value == RTKA_FALSE) {
-                /* Calculate propagated confidence */
-                rtka_state_t edge_weight = graph->edge_weights ? 
-                    graph->edge_weights[e] : rtka_make_state(RTKA_TRUE, 1.0f);
-                
-                /* Ternary propagation rule */
-                rtka_state_t propagated = rtka_combine_and(v_state, edge_weight);
-                
-                /* Decay with depth */
-                rtka_confidence_t decay = powf(0.9f, current_depth + 1);
-                propagated.confidence *= decay;
-                
-                /* Update neighbor state */
-                graph->vertex_states[u] = rtka_combine_or(graph->vertex_states[u], propagated);
-                
-                if (current_depth + 1 < max_depth) {
-                    queue[tail++] = u;
-                    depths[u] = current_depth + 1;
-                    visited[u] = rtka_make_state(RTKA_TRUE, propagated.confidence);
+/* PULL, phase 2: every vertex gathers its in-edges */
+static void pull_gather(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const pagerank_ctx_t* ctx = (const pagerank_ctx_t*)arg;
+    rtka_pagerank_work_t* work = ctx->work;
+    /* 32-bit signed gather indices */
+    const pagerank_kernel_t* kernel = work->num_vertices <= (uint32_t)INT32_MAX ? pagerank_kernel() : &kernel_scalar;
+    for (uint32_t c = begin; c < end; c++) {
+        work->chunk_residual[c] = kernel->pull(ctx, work->bounds[c], work->bounds[c + 1U]);
+    }
+}
+
+static inline void add_double(_Atomic double* target, double value, bool shared) {
+    double old = atomic_load_explicit(target, memory_order_relaxed);
+    if (!shared) {
+        atomic_store_explicit(target, old + value, memory_order_relaxed);
+        return;
+    }
+    while (!atomic_compare_exchange_weak_explicit(target, &old, old + value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/* DELTA: the terms a vertex sends, the OR side as log(1 - c / degree) */
+static inline void delta_terms(const pagerank_ctx_t* ctx, uint32_t u, float* importance, float* log_miss) {
+    float inv = ctx->work->inv_degree[u];
+    float share = ctx->pr->ranks[u].confidence * inv;
+    *importance = ctx->pr->importance[u] * inv;
+    *log_miss = log1pf(-fminf(share, PAGERANK_MAX_MISS));
+}
+
+/* DELTA, phase 2 (and the seed): apply what has arrived, then queue every
+ * vertex whose terms drifted from what it last sent */
+static void delta_update(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const pagerank_ctx_t* ctx = (const pagerank_ctx_t*)arg;
+    rtka_pagerank_work_t* work = ctx->work;
+    const uint32_t* degree = ctx->graph->degree;
+    float tolerance = work->tolerance;
+
+    for (uint32_t c = begin; c < end; c++) {
+        uint32_t base = work->bounds[c];
+        uint32_t active = 0, edges = 0;
+        double residual = 0.0;
+        for (uint32_t v = base; v < work->bounds[c + 1U]; v++) {
+            if (ctx->apply) {
+                /* Nothing arrived: same terms, so still nothing to send */
+                if (!atomic_load_explicit(&work->touched[v], memory_order_relaxed)) {
+                    work->delta_importance[v] = 0.0f;
+                    work->delta_log_miss[v] = 0.0f;
+                    continue;
                 }
+                atomic_store_explicit(&work->touched[v], 0, memory_order_relaxed);
+                double sum = atomic_load_explicit(&work->sum_importance[v], memory_order_relaxed);
+                double log_miss = atomic_load_explicit(&work->sum_log_miss[v], memory_order_relaxed);
+                residual += finish_vertex(ctx, v, (float)sum, -expm1f((float)log_miss));
+            }
+            if (degree[v] == 0) continue;
+
+            float importance, log_miss;
+            delta_terms(ctx, v, &importance, &log_miss);
+            double d_importance = (double)importance - (double)work->sent_importance[v];
+            double d_log_miss = (double)log_miss - (double)work->sent_log_miss[v];
+            if (fabs(d_importance) <= tolerance && fabs(d_log_miss) <= tolerance) {
+                work->delta_importance[v] = 0.0f;
+                work->delta_log_miss[v] = 0.0f;
+                continue;
             }
+
+            work->delta_importance[v] = (float)d_importance;
+            work->delta_log_miss[v] = (float)d_log_miss;
+            work->sent_importance[v] = importance;
+            work->sent_log_miss[v] = log_miss;
+            edges += degree[v];
+            work->frontier[base + active] = v;
+            work->frontier_edges[base + active] = edges;
+            active++;
         }
+        work->chunk_active[c] = active;
+        work->chunk_edges[c + 1U] = edges;
+        work->chunk_residual[c] = residual;
     }
 }
 
-/* BFS with ternary states */
-rtka_state_t* rtka_graph_bfs_ternary(rtka_graph_sparse_t* graph, uint32_t start) {
-    rtka_state_t* distances = rtka_alloc_states(graph->num_vertices);
-    
-    for (uint32_t i = 0; i < graph->num_vertices; i++) {
-        distances[i] = rtka_make_state(RTKA_UNKNOWN, 0.0f);
+/* Out-edges [first, last) of the chunk's frontier, counted from the chunk's
+ * first active vertex */
+static void push_chunk(const pagerank_ctx_t* ctx, uint32_t c, uint32_t first, uint32_t last) {
+    rtka_pagerank_work_t* work = ctx->work;
+    const rtka_graph_sparse_t* graph = ctx->graph;
+    const uint32_t* frontier = work->frontier + work->bounds[c];
+    const uint32_t* ends = work->frontier_edges + work->bounds[c];
+
+    /* First vertex whose edges reach past first */
+    uint32_t lo = 0, hi = work->chunk_active[c];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2U;
+        if (ends[mid] <= first) lo = mid + 1U;
+        else hi = mid;
     }
-    
-    distances[start] = rtka_make_state(RTKA_TRUE, 1.0f);
-    
-    uint32_t* queue = (uint32_t*)rtka_alloc_states(graph->num_vertices * sizeof(uint32_t) / sizeof(rtka_state_t));
-    uint32_t head = 0, tail = 0;
-    queue[tail++] = start;
-    
-    while (head < tail) {
-        uint32_t v = queue[head++];
-        rtka_state_t v_dist = distances[v];
-        
-        uint32_t start_edge = graph->adjacency_list[v];
-        uint32_t end_edge = graph->adjacency_list[v + 1];
-        
-        for (uint32_t e = start_edge; e < end_edge; e++) {
-            uint32_t u = graph->edge_indices[e];
-            
-            if (distances[u].value == RTKA_UNKNOWN) {
-                /* Propagate distance with confidence decay */
-                distances[u].value = RTKA_TRUE;
-                distances[u].confidence = v_dist.confidence * 0.9f;
-                queue[tail++] = u;
+
+    for (uint32_t i = lo; i < work->chunk_active[c] && first < last; i++) {
+        uint32_t u = frontier[i];
+        uint32_t row = ends[i] - graph->degree[u];
+        uint32_t stop = ends[i] < last ? ends[i] : last;
+        const uint32_t* targets = graph->edge_indices + graph->adjacency_list[u];
+        double d_importance = work->delta_importance[u];
+        double d_log_miss = work->delta_log_miss[u];
+        for (uint32_t e = first; e < stop; e++) {
+            uint32_t v = targets[e - row];
+            if (v == u) continue;
+            add_double(&work->sum_importance[v], d_importance, ctx->shared);
+            add_double(&work->sum_log_miss[v], d_log_miss, ctx->shared);
+            atomic_store_explicit(&work->touched[v], 1, memory_order_relaxed);
+        }
+        first = stop;
+    }
+}
+
+/* DELTA, phase 1: piece p covers frontier edges [p, p + 1) / pieces of the
+ * total, whichever vertices and chunks they fall in */
+static void delta_push(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const pagerank_ctx_t* ctx = (const pagerank_ctx_t*)arg;
+    const rtka_pagerank_work_t* work = ctx->work;
+    const uint64_t* chunk_edges = work->chunk_edges;
+
+    for (uint32_t p = begin; p < end; p++) {
+        uint64_t first = ctx->push_total * p / ctx->push_pieces;
+        uint64_t last = ctx->push_total * (p + 1U) / ctx->push_pieces;
+        if (first == last) continue;
+
+        uint32_t lo = 0, hi = work->chunks;
+        while (lo + 1U < hi) {
+            uint32_t mid = lo + (hi - lo) / 2U;
+            if (chunk_edges[mid] <= first) lo = mid;
+            else hi = mid;
+        }
+        for (uint32_t c = lo; c < work->chunks && first < last; c++) {
+            uint64_t stop = chunk_edges[c + 1U] < last ? chunk_edges[c + 1U] : last;
+            if (stop > first) {
+                push_chunk(ctx, c, (uint32_t)(first - chunk_edges[c]), (uint32_t)(stop - chunk_edges[c]));
             }
+            first = stop;
         }
     }
-    
-    return distances;
+}
+
+/* DELTA, phase 1 for a large frontier: the same sums gathered over the
+ * transpose, without atomics; vertices that hold back have zero deltas */
+static void delta_gather(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const pagerank_ctx_t* ctx = (const pagerank_ctx_t*)arg;
+    rtka_pagerank_work_t* work = ctx->work;
+    const uint32_t* RTKA_RESTRICT offsets = work->in_offsets;
+    const uint32_t* RTKA_RESTRICT sources = work->in_sources;
+    const float* RTKA_RESTRICT d_importance = work->delta_importance;
+    const float* RTKA_RESTRICT d_log_miss = work->delta_log_miss;
+
+    for (uint32_t c = begin; c < end; c++) {
+        for (uint32_t v = work->bounds[c]; v < work->bounds[c + 1U]; v++) {
+            double sum = 0.0, log_miss = 0.0;
+            for (uint32_t e = offsets[v]; e < offsets[v + 1U]; e++) {
+                uint32_t u = sources[e];
+                sum += d_importance[u];
+                log_miss += d_log_miss[u];
+            }
+            if (sum == 0.0 && log_miss == 0.0) continue;
+            add_double(&work->sum_importance[v], sum, false);
+            add_double(&work->sum_log_miss[v], log_miss, false);
+            atomic_store_explicit(&work->touched[v], 1, memory_order_relaxed);
+        }
+    }
+}
+
+static void delta_frontier(pagerank_ctx_t* ctx) {
+    rtka_pagerank_work_t* work = ctx->work;
+    uint32_t active = 0;
+    for (uint32_t c = 0; c < work->chunks; c++) {
+        work->chunk_edges[c + 1U] += work->chunk_edges[c];
+        active += work->chunk_active[c];
+    }
+    ctx->pr->active = active;
+}
+
+/* PageRank iteration with ternary logic */
+void rtka_pagerank_iterate(rtka_pagerank_t* pr, rtka_graph_sparse_t* graph) {
+    if (!pr || !graph) return;
+    uint32_t n = graph->num_vertices;
+    if (n == 0) {
+        pr->residual = 0.0f;
+        pr->iterations++;
+        return;
+    }
+
+    rtka_thread_pool_t* pool = pr->pool ? pr->pool : rtka_pool_default();
+    pagerank_ctx_t ctx = {
+        .pr = pr,
+        .graph = graph,
+        .damping = RTKA_PAGERANK_DAMPING,
+        .teleport = (1.0f - RTKA_PAGERANK_DAMPING) / n,
+        .shared = rtka_pool_size(pool) > 0U,
+    };
+
+    rtka_pagerank_work_t* work = pr->work;
+    if (work && (work->mode != pr->mode || work->num_vertices != n || work->num_edges != graph->num_edges)) {
+        work_free(work);
+        pr->work = work = NULL;
+    }
+    if (!work) {
+        work = work_create(pr, graph, rtka_pool_size(pool) + 1U);
+        if (!work) return;
+        pr->work = work;
+        if (pr->mode == RTKA_PAGERANK_DELTA) {
+            ctx.work = work;
+            ctx.apply = false;
+            rtka_pool_parallel_for(pool, 0, work->chunks, 1, delta_update, &ctx);
+            delta_frontier(&ctx);
+        }
+    }
+    ctx.work = work;
+
+    if (pr->mode == RTKA_PAGERANK_DELTA) {
+        ctx.push_total = work->chunk_edges[work->chunks];
+        if (ctx.push_total > graph->num_edges / PAGERANK_DENSE) {
+            rtka_pool_parallel_for(pool, 0, work->chunks, 1, delta_gather, &ctx);
+        } else {
+            uint64_t pieces = ctx.push_total / PAGERANK_PUSH_GRAIN + 1U;
+            uint64_t cap = (uint64_t)(rtka_pool_size(pool) + 1U) * PAGERANK_CHUNKS;
+            ctx.push_pieces = (uint32_t)(pieces < cap ? pieces : cap);
+            rtka_pool_parallel_for(pool, 0, ctx.push_pieces, 1, delta_push, &ctx);
+        }
+
+        ctx.apply = true;
+        memset(work->chunk_edges, 0, ((size_t)work->chunks + 1U) * sizeof(uint64_t));
+        rtka_pool_parallel_for(pool, 0, work->chunks, 1, delta_update, &ctx);
+        delta_frontier(&ctx);
+    } else {
+        rtka_pool_parallel_for(pool, 0, work->chunks, 1, pull_terms, &ctx);
+        rtka_pool_parallel_for(pool, 0, work->chunks, 1, pull_gather, &ctx);
+    }
+
+    double residual = 0.0;
+    for (uint32_t c = 0; c < work->chunks; c++) residual += work->chunk_residual[c];
+    pr->residual = (rtka_confidence_t)residual;
+    pr->iterations++;
+}
+
+/* Check convergence */
+bool rtka_pagerank_converged(rtka_pagerank_t* pr) {
+    if (!pr || pr->iterations < 2) return false;
+    return pr->residual < pr->convergence_threshold;
+}
+
+/* Markov transition matrix from graph: the dense matrix held 0.1 on the
+ * diagonal and (FALSE, 0) off the edges, and (FALSE, 0) drops out of the
+ * AND/OR product, so only the edges and the diagonal are stored. Sources
+ * are appended in ascending order, the order the dense product combined
+ * them in. */
+rtka_transition_matrix_t* rtka_markov_from_graph(rtka_graph_sparse_t* graph) {
+    if (!graph) return NULL;
+    uint32_t n = graph->num_vertices;
+    const uint32_t* adj = graph->adjacency_list;
+    
+    rtka_transition_matrix_t* tm = (rtka_transition_matrix_t*)calloc(1, sizeof(rtka_transition_matrix_t));
+    if (!tm) return NULL;
+    tm->size = n;
+    tm->damping_factor = RTKA_PAGERANK_DAMPING;
+    tm->row_start = (uint32_t*)calloc((size_t)n + 1U, sizeof(uint32_t));
+    if (!tm->row_start) {
+        rtka_markov_free(tm);
+        return NULL;
+    }
+    
+    /* In-degree of every state plus the diagonal when there is no self loop */
+    for (uint32_t i = 0; i < n; i++) {
+        bool self = false;
+        for (uint32_t e = adj[i]; e < adj[i + 1]; e++) {
+            uint32_t j = graph->edge_indices[e];
+            self |= j == i;
+            tm->row_start[j + 1U]++;
+        }
+        if (!self) tm->row_start[i + 1U]++;
+    }
+    for (uint32_t j = 0; j < n; j++) tm->row_start[j + 1U] += tm->row_start[j];
+    tm->nnz = tm->row_start[n];
+    
+    tm->source = (uint32_t*)malloc((size_t)tm->nnz * sizeof(uint32_t));
+    tm->weight = (rtka_confidence_t*)malloc((size_t)tm->nnz * sizeof(rtka_confidence_t));
+    uint32_t* fill = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    if (!tm->source || !tm->weight || !fill) {
+        free(fill);
+        rtka_markov_free(tm);
+        return NULL;
+    }
+    memcpy(fill, tm->row_start, (size_t)n * sizeof(uint32_t));
+    
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t out_degree = adj[i + 1] - adj[i];
+        rtka_confidence_t prob = out_degree ? 1.0f / out_degree : 0.0f;
+        bool self = false;
+        for (uint32_t e = adj[i]; e < adj[i + 1]; e++) {
+            uint32_t j = graph->edge_indices[e];
+            rtka_state_t edge_weight = graph->edge_weights ?
+                graph->edge_weights[e] : rtka_make_state(RTKA_TRUE, prob);
+            self |= j == i;
+            tm->source[fill[j]] = i;
+            tm->weight[fill[j]++] = edge_weight.confidence * prob;
+        }
+        if (!self) {
+            tm->source[fill[i]] = i;
+            tm->weight[fill[i]++] = 0.1f;
+        }
+    }
+    free(fill);
+    
+    return tm;
+}
+
+void rtka_markov_free(rtka_transition_matrix_t* tm) {
+    if (!tm) return;
+    free(tm->row_start);
+    free(tm->source);
+    free(tm->weight);
+    free(tm);
+}
+
+typedef struct {
+    const rtka_transition_matrix_t* tm;
+    const rtka_state_t* current;
+    rtka_state_t* next;
+    uint32_t vectors;
+    uint32_t chunks;
+    rtka_confidence_t teleport;
+} markov_ctx_t;
+
+/* First row whose transitions start at or after position nnz */
+static uint32_t markov_row_at(const rtka_transition_matrix_t* tm, uint64_t nnz) {
+    uint32_t lo = 0, hi = tm->size;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2U;
+        if (tm->row_start[mid] < nnz) lo = mid + 1U;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Rows of chunks [begin, end), the chunks splitting the transitions evenly.
+ * Each state j ORs current[i] AND weight over its sources i; only the
+ * confidences are combined, the value is requantized from the result. */
+static void markov_rows(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const markov_ctx_t* ctx = (const markov_ctx_t*)arg;
+    const rtka_transition_matrix_t* tm = ctx->tm;
+    uint32_t vectors = ctx->vectors;
+    uint64_t nnz = tm->nnz;
+    uint32_t first = begin ? markov_row_at(tm, nnz * begin / ctx->chunks) : 0U;
+    uint32_t last = end < ctx->chunks ? markov_row_at(tm, nnz * end / ctx->chunks) : tm->size;
+    rtka_confidence_t damping = tm->damping_factor;
+    rtka_confidence_t acc[MARKOV_LANES];
+
+    for (uint32_t j = first; j < last; j++) {
+        uint32_t k0 = tm->row_start[j], k1 = tm->row_start[j + 1U];
+        rtka_state_t* out = ctx->next + (size_t)j * vectors;
+        for (uint32_t v0 = 0; v0 < vectors; v0 += MARKOV_LANES) {
+            uint32_t lanes = vectors - v0 < MARKOV_LANES ? vectors - v0 : MARKOV_LANES;
+            for (uint32_t v = 0; v < lanes; v++) acc[v] = 0.0f;
+            for (uint32_t k = k0; k < k1; k++) {
+                const rtka_state_t* src = ctx->current + (size_t)tm->source[k] * vectors + v0;
+                rtka_confidence_t w = tm->weight[k];
+                for (uint32_t v = 0; v < lanes; v++) {
+                    acc[v] = rtka_conf_or(acc[v], rtka_conf_and(src[v].confidence, w));
+                }
+            }
+            for (uint32_t v = 0; v < lanes; v++) {
+                rtka_confidence_t c = damping * acc[v] + ctx->teleport;
+                rtka_value_t value = c > 0.66f ? RTKA_TRUE : c < 0.33f ? RTKA_FALSE : RTKA_UNKNOWN;
+                out[v0 + v] = rtka_make_state(value, c);
+            }
+        }
+    }
+}
+
+static void markov_sweep(const rtka_transition_matrix_t* tm, const rtka_state_t* current,
+                         rtka_state_t* next, uint32_t vectors, rtka_thread_pool_t* pool) {
+    markov_ctx_t ctx = {
+        .tm = tm, .current = current, .next = next, .vectors = vectors, .chunks = 1,
+        .teleport = (1.0f - tm->damping_factor) / tm->size,
+    };
+    if (!pool) pool = rtka_pool_default();
+    if ((uint64_t)tm->nnz * vectors >= MARKOV_PARALLEL_MIN && rtka_pool_size(pool) > 0U) {
+        ctx.chunks = (rtka_pool_size(pool) + 1U) * PAGERANK_CHUNKS;
+        rtka_pool_parallel_for(pool, 0, ctx.chunks, 1, markov_rows, &ctx);
+    } else {
+        markov_rows(&ctx, 0, 1, 0);
+    }
+}
+
+/* Markov step with ternary states */
+void rtka_markov_step(const rtka_state_t* current, const rtka_transition_matrix_t* tm, rtka_state_t* next) {
+    if (!current || !tm || !next || !tm->size) return;
+    markov_sweep(tm, current, next, 1, NULL);
+}
+
+rtka_error_t rtka_markov_propagate(const rtka_transition_matrix_t* tm, rtka_state_t* states,
+                                   uint32_t vectors, uint32_t steps, rtka_thread_pool_t* pool) {
+    if (!tm || !states) return RTKA_ERROR_NULL_POINTER;
+    if (!vectors || !tm->size) return RTKA_ERROR_INVALID_VALUE;
+    if (!steps) return RTKA_SUCCESS;
+    
+    size_t count = (size_t)tm->size * vectors;
+    rtka_state_t* scratch = (rtka_state_t*)malloc(count * sizeof(rtka_state_t));
+    if (!scratch) return RTKA_ERROR_OUT_OF_MEMORY;
+    
+    rtka_state_t* src = states;
+    rtka_state_t* dst = scratch;
+    for (uint32_t s = 0; s < steps; s++) {
+        markov_sweep(tm, src, dst, vectors, pool);
+        rtka_state_t* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != states) memcpy(states, src, count * sizeof(rtka_state_t));
+    free(scratch);
+    return RTKA_SUCCESS;
+}
+
+/* Steps from uniform (UNKNOWN, 0.5) until no confidence moves by more than
+ * RTKA_MARKOV_TOLERANCE, at most RTKA_MARKOV_MAX_STEPS */
+rtka_state_t* rtka_markov_steady_state(rtka_transition_matrix_t* tm) {
+    if (!tm || !tm->size) return NULL;
+    rtka_state_t* current = (rtka_state_t*)malloc((size_t)tm->size * sizeof(rtka_state_t));
+    rtka_state_t* next = (rtka_state_t*)malloc((size_t)tm->size * sizeof(rtka_state_t));
+    if (!current || !next) {
+        free(current);
+        free(next);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < tm->size; i++) current[i] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
+    
+    for (uint32_t s = 0; s < RTKA_MARKOV_MAX_STEPS; s++) {
+        markov_sweep(tm, current, next, 1, NULL);
+        rtka_confidence_t change = 0.0f;
+        for (uint32_t i = 0; i < tm->size; i++) {
+            change = fmaxf(change, fabsf(next[i].confidence - current[i].confidence));
+        }
+        rtka_state_t* t = current;
+        current = next;
+        next = t;
+        if (change < RTKA_MARKOV_TOLERANCE) break;
+    }
+    free(next);
+    return current;
+}
+
+/* ============================================================================
+ * LEVEL-SYNCHRONOUS TRAVERSAL
+ *
+ * Direction-optimizing BFS: the frontier is a bitmap plus a packed list.
+ * Small frontiers push top-down over out-edges, claiming vertices with an
+ * atomic OR on the visited bitmap; once the frontier's out-edges exceed
+ * 1/TRAVERSE_ALPHA of the unexplored ones, every unvisited vertex pulls
+ * bottom-up over its in-edges and stops at the first parent in the
+ * frontier, until the frontier falls below 1/TRAVERSE_BETA of the
+ * vertices. Bitmap words are split over the pool so bottom-up writes stay
+ * within a piece.
+ * ============================================================================ */
+
+#define TRAVERSE_ALPHA   14U        /* Bottom-up once frontier edges > unexplored / 14 */
+#define TRAVERSE_BETA    24U        /* Top-down again once frontier < vertices / 24 */
+#define TRAVERSE_GRAIN   64U        /* Frontier vertices per top-down piece */
+#define TRAVERSE_WORDS   64U        /* Bitmap words per bottom-up / packing piece */
+#define SSSP_GRAIN       64U        /* Bucket vertices per relaxation piece */
+
+struct rtka_traversal_work {
+    uint32_t num_vertices;
+    uint32_t num_edges;
+    bool weighted;
+    uint32_t words;                    /* 64-bit words per bitmap */
+    uint32_t pieces;                   /* Of TRAVERSE_WORDS words */
+    /* In-edge transpose without self loops; in_edges only when weighted */
+    uint32_t* in_offsets;
+    uint32_t* in_sources;
+    uint32_t* in_edges;                /* Out-edge index of each in-edge */
+    _Atomic uint64_t* visited;
+    _Atomic uint64_t* frontier_bits;
+    _Atomic uint64_t* next_bits;
+    uint32_t* frontier;                /* Frontier list, packed from the bitmap */
+    uint32_t frontier_size;
+    uint32_t* piece_count;             /* pieces + 1: vertices, then offsets */
+    uint64_t* piece_edges;             /* Out-edges of those vertices */
+    /* Delta-stepping */
+    _Atomic uint32_t* dist;            /* Float bits; ordered as integers when >= 0 */
+    uint32_t* bucket;                  /* Vertices of the current bucket, repeats allowed */
+    size_t bucket_capacity;
+};
+
+typedef struct {
+    uint32_t* items;
+    uint32_t count;
+    uint32_t capacity;
+} sssp_bin_t;
+
+typedef struct {
+    sssp_bin_t* bins;                  /* Indexed by bucket */
+    uint32_t bin_count;
+    bool failed;
+} sssp_local_t;
+
+static void traversal_work_free(rtka_traversal_work_t* work) {
+    if (!work) return;
+    free(work->in_offsets);
+    free(work->in_sources);
+    free(work->in_edges);
+    free((void*)work->visited);
+    free((void*)work->frontier_bits);
+    free((void*)work->next_bits);
+    free(work->frontier);
+    free(work->piece_count);
+    free(work->piece_edges);
+    free((void*)work->dist);
+    free(work->bucket);
+    free(work);
+}
+
+static rtka_traversal_work_t* traversal_work_create(const rtka_graph_sparse_t* graph) {
+    rtka_traversal_work_t* work = (rtka_traversal_work_t*)calloc(1, sizeof(rtka_traversal_work_t));
+    if (!work) return NULL;
+    uint32_t n = graph->num_vertices;
+    const uint32_t* adj = graph->adjacency_list;
+    work->num_vertices = n;
+    work->num_edges = graph->num_edges;
+    work->weighted = graph->edge_weights != NULL;
+    work->words = (n + 63U) / 64U;
+    work->pieces = (work->words + TRAVERSE_WORDS - 1U) / TRAVERSE_WORDS;
+
+    size_t words = work->words ? work->words : 1U;
+    work->in_offsets = (uint32_t*)calloc((size_t)n + 1U, sizeof(uint32_t));
+    work->visited = (_Atomic uint64_t*)calloc(words, sizeof(uint64_t));
+    work->frontier_bits = (_Atomic uint64_t*)calloc(words, sizeof(uint64_t));
+    work->next_bits = (_Atomic uint64_t*)calloc(words, sizeof(uint64_t));
+    work->frontier = (uint32_t*)malloc(((size_t)n + 1U) * sizeof(uint32_t));
+    work->piece_count = (uint32_t*)calloc((size_t)work->pieces + 1U, sizeof(uint32_t));
+    work->piece_edges = (uint64_t*)calloc((size_t)work->pieces + 1U, sizeof(uint64_t));
+    work->dist = (_Atomic uint32_t*)malloc(((size_t)n + 1U) * sizeof(uint32_t));
+    bool ok = work->in_offsets && work->visited && work->frontier_bits && work->next_bits &&
+              work->frontier && work->piece_count && work->piece_edges && work->dist;
+
+    if (ok) {
+        uint32_t* offsets = work->in_offsets;
+        for (uint32_t u = 0; u < n; u++) {
+            for (uint32_t e = adj[u]; e < adj[u + 1U]; e++) {
+                uint32_t v = graph->edge_indices[e];
+                if (v != u) offsets[v + 1U]++;
+            }
+        }
+        for (uint32_t v = 0; v < n; v++) offsets[v + 1U] += offsets[v];
+        size_t in_count = (size_t)offsets[n] + 1U;
+        work->in_sources = (uint32_t*)malloc(in_count * sizeof(uint32_t));
+        if (work->weighted) work->in_edges = (uint32_t*)malloc(in_count * sizeof(uint32_t));
+        uint32_t* fill = (uint32_t*)malloc(((size_t)n + 1U) * sizeof(uint32_t));
+        ok = work->in_sources && (!work->weighted || work->in_edges) && fill;
+        if (ok) {
+            memcpy(fill, offsets, (size_t)n * sizeof(uint32_t));
+            for (uint32_t u = 0; u < n; u++) {
+                for (uint32_t e = adj[u]; e < adj[u + 1U]; e++) {
+                    uint32_t v = graph->edge_indices[e];
+                    if (v == u) continue;
+                    if (work->in_edges) work->in_edges[fill[v]] = e;
+                    work->in_sources[fill[v]++] = u;
+                }
+            }
+        }
+        free(fill);
+    }
+    if (!ok) {
+        traversal_work_free(work);
+        return NULL;
+    }
+    return work;
+}
+
+rtka_graph_traversal_t* rtka_graph_traversal_init(rtka_thread_pool_t* pool) {
+    rtka_graph_traversal_t* t = (rtka_graph_traversal_t*)calloc(1, sizeof(rtka_graph_traversal_t));
+    if (t) t->pool = pool;
+    return t;
+}
+
+void rtka_graph_traversal_free(rtka_graph_traversal_t* t) {
+    if (!t) return;
+    traversal_work_free(t->work);
+    free(t);
+}
+
+/* The work for this graph, rebuilt when its shape changed */
+static rtka_traversal_work_t* traversal_work(rtka_graph_traversal_t* t, const rtka_graph_sparse_t* graph) {
+    rtka_traversal_work_t* work = t->work;
+    if (work && (work->num_vertices != graph->num_vertices || work->num_edges != graph->num_edges ||
+                 work->weighted != (graph->edge_weights != NULL))) {
+        traversal_work_free(work);
+        t->work = work = NULL;
+    }
+    if (!work) t->work = work = traversal_work_create(graph);
+    return work;
+}
+
+RTKA_INLINE bool bit_test(const _Atomic uint64_t* bits, uint32_t v) {
+    return (atomic_load_explicit(&bits[v >> 6], memory_order_relaxed) >> (v & 63U)) & 1U;
+}
+
+/* Called once a level's vertices are packed into work->frontier; the
+ * previous level is still in work->frontier_bits */
+typedef void (*traversal_level_fn)(void* ctx, const rtka_graph_sparse_t* graph,
+                                   const rtka_traversal_work_t* work, uint32_t level);
+
+typedef struct {
+    const rtka_graph_sparse_t* graph;
+    rtka_traversal_work_t* work;
+    uint32_t* depth;
+    uint32_t level;                    /* Of the vertices being claimed */
+} traversal_ctx_t;
+
+static void fill_unreached(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const traversal_ctx_t* ctx = (const traversal_ctx_t*)arg;
+    for (uint32_t v = begin; v < end; v++) ctx->depth[v] = RTKA_GRAPH_UNREACHED;
+}
+
+static void top_down(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const traversal_ctx_t* ctx = (const traversal_ctx_t*)arg;
+    rtka_traversal_work_t* work = ctx->work;
+    const uint32_t* adj = ctx->graph->adjacency_list;
+    const uint32_t* targets = ctx->graph->edge_indices;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t v = work->frontier[i];
+        for (uint32_t e = adj[v]; e < adj[v + 1U]; e++) {
+            uint32_t u = targets[e];
+            uint64_t bit = 1ULL << (u & 63U);
+            if (atomic_load_explicit(&work->visited[u >> 6], memory_order_relaxed) & bit) continue;
+            if (atomic_fetch_or_explicit(&work->visited[u >> 6], bit, memory_order_relaxed) & bit) continue;
+            atomic_fetch_or_explicit(&work->next_bits[u >> 6], bit, memory_order_relaxed);
+            ctx->depth[u] = ctx->level;
+        }
+    }
+}
+
+/* Pieces of bitmap words; each word is written by its piece only */
+static void bottom_up(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const traversal_ctx_t* ctx = (const traversal_ctx_t*)arg;
+    rtka_traversal_work_t* work = ctx->work;
+    uint32_t n = work->num_vertices;
+    uint32_t w_end = end * TRAVERSE_WORDS < work->words ? end * TRAVERSE_WORDS : work->words;
+    for (uint32_t w = begin * TRAVERSE_WORDS; w < w_end; w++) {
+        uint64_t seen = atomic_load_explicit(&work->visited[w], memory_order_relaxed);
+        uint64_t open = ~seen;
+        if ((uint64_t)w * 64U + 64U > n) open &= (1ULL << (n & 63U)) - 1U;
+        uint64_t found = 0;
+        while (open) {
+            uint32_t u = w * 64U + (uint32_t)__builtin_ctzll(open);
+            open &= open - 1U;
+            for (uint32_t k = work->in_offsets[u]; k < work->in_offsets[u + 1U]; k++) {
+                if (bit_test(work->frontier_bits, work->in_sources[k])) {
+                    found |= 1ULL << (u & 63U);
+                    ctx->depth[u] = ctx->level;
+                    break;
+                }
+            }
+        }
+        if (found) {
+            atomic_store_explicit(&work->visited[w], seen | found, memory_order_relaxed);
+            atomic_store_explicit(&work->next_bits[w], found, memory_order_relaxed);
+        }
+    }
+}
+
+static void count_piece(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const traversal_ctx_t* ctx = (const traversal_ctx_t*)arg;
+    rtka_traversal_work_t* work = ctx->work;
+    const uint32_t* adj = ctx->graph->adjacency_list;
+    for (uint32_t p = begin; p < end; p++) {
+        uint32_t w_end = (p + 1U) * TRAVERSE_WORDS < work->words ? (p + 1U) * TRAVERSE_WORDS : work->words;
+        uint32_t count = 0;
+        uint64_t edges = 0;
+        for (uint32_t w = p * TRAVERSE_WORDS; w < w_end; w++) {
+            uint64_t bits = atomic_load_explicit(&work->next_bits[w], memory_order_relaxed);
+            count += (uint32_t)__builtin_popcountll(bits);
+            while (bits) {
+                uint32_t v = w * 64U + (uint32_t)__builtin_ctzll(bits);
+                bits &= bits - 1U;
+                edges += adj[v + 1U] - adj[v];
+            }
+        }
+        work->piece_count[p + 1U] = count;
+        work->piece_edges[p + 1U] = edges;
+    }
+}
+
+static void pack_piece(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const traversal_ctx_t* ctx = (const traversal_ctx_t*)arg;
+    rtka_traversal_work_t* work = ctx->work;
+    for (uint32_t p = begin; p < end; p++) {
+        uint32_t w_end = (p + 1U) * TRAVERSE_WORDS < work->words ? (p + 1U) * TRAVERSE_WORDS : work->words;
+        uint32_t* out = work->frontier + work->piece_count[p];
+        for (uint32_t w = p * TRAVERSE_WORDS; w < w_end; w++) {
+            uint64_t bits = atomic_load_explicit(&work->next_bits[w], memory_order_relaxed);
+            while (bits) {
+                *out++ = w * 64U + (uint32_t)__builtin_ctzll(bits);
+                bits &= bits - 1U;
+            }
+        }
+    }
+}
+
+/* depth[v] = level of v, RTKA_GRAPH_UNREACHED beyond max_depth */
+static rtka_error_t traversal_bfs(rtka_graph_traversal_t* t, const rtka_graph_sparse_t* graph,
+                                  uint32_t source, uint32_t max_depth, uint32_t* depth,
+                                  traversal_level_fn on_level, void* level_ctx) {
+    if (!t || !graph || !depth) return RTKA_ERROR_NULL_POINTER;
+    uint32_t n = graph->num_vertices;
+    if (source >= n) return RTKA_ERROR_INVALID_VALUE;
+    rtka_traversal_work_t* work = traversal_work(t, graph);
+    if (!work) return RTKA_ERROR_OUT_OF_MEMORY;
+    rtka_thread_pool_t* pool = t->pool ? t->pool : rtka_pool_default();
+    const uint32_t* adj = graph->adjacency_list;
+
+    traversal_ctx_t ctx = { .graph = graph, .work = work, .depth = depth, .level = 0 };
+    rtka_pool_parallel_for(pool, 0, n, 0, fill_unreached, &ctx);
+    size_t bytes = (size_t)work->words * sizeof(uint64_t);
+    memset((void*)work->visited, 0, bytes);
+    memset((void*)work->frontier_bits, 0, bytes);
+    memset((void*)work->next_bits, 0, bytes);
+
+    depth[source] = 0;
+    atomic_store_explicit(&work->visited[source >> 6], 1ULL << (source & 63U), memory_order_relaxed);
+    atomic_store_explicit(&work->frontier_bits[source >> 6], 1ULL << (source & 63U), memory_order_relaxed);
+    work->frontier[0] = source;
+    work->frontier_size = 1;
+    uint64_t frontier_edges = adj[source + 1U] - adj[source];
+    uint64_t unexplored = graph->num_edges - frontier_edges;
+    bool pull = false;
+
+    t->levels = 0;
+    t->bottom_up_levels = 0;
+    while (work->frontier_size && ctx.level < max_depth) {
+        if (!pull && frontier_edges > unexplored / TRAVERSE_ALPHA) {
+            pull = true;
+        } else if (pull && work->frontier_size < n / TRAVERSE_BETA) {
+            pull = false;
+        }
+
+        ctx.level++;
+        if (pull) {
+            rtka_pool_parallel_for(pool, 0, work->pieces, 1, bottom_up, &ctx);
+            t->bottom_up_levels++;
+        } else {
+            rtka_pool_parallel_for(pool, 0, work->frontier_size, TRAVERSE_GRAIN, top_down, &ctx);
+        }
+
+        /* Pack the new level and count its out-edges */
+        rtka_pool_parallel_for(pool, 0, work->pieces, 1, count_piece, &ctx);
+        work->piece_count[0] = 0;
+        frontier_edges = 0;
+        for (uint32_t p = 0; p < work->pieces; p++) {
+            work->piece_count[p + 1U] += work->piece_count[p];
+            frontier_edges += work->piece_edges[p + 1U];
+        }
+        work->frontier_size = work->piece_count[work->pieces];
+        if (!work->frontier_size) break;
+        rtka_pool_parallel_for(pool, 0, work->pieces, 1, pack_piece, &ctx);
+        unexplored = unexplored > frontier_edges ? unexplored - frontier_edges : 0U;
+        t->levels = ctx.level;
+
+        if (on_level) on_level(level_ctx, graph, work, ctx.level);
+
+        _Atomic uint64_t* swap = work->frontier_bits;
+        work->frontier_bits = work->next_bits;
+        work->next_bits = swap;
+        memset((void*)work->next_bits, 0, bytes);
+    }
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_graph_bfs(rtka_graph_traversal_t* t, const rtka_graph_sparse_t* graph,
+                            uint32_t source, uint32_t max_depth, uint32_t* depth) {
+    return traversal_bfs(t, graph, source, max_depth, depth, NULL, NULL);
+}
+
+/* ============================================================================
+ * DELTA-STEPPING
+ *
+ * Buckets of width delta, processed in order. Every vertex of the current
+ * bucket relaxes its out-edges with an atomic minimum on the distance
+ * bits; a vertex that improves goes into the bucket of its new distance,
+ * kept per worker. Entries left behind by a later improvement into an
+ * earlier bucket are skipped. The current bucket is re-run until nothing
+ * lands in it, then the lowest bucket any worker holds is next.
+ * ============================================================================ */
+
+typedef struct {
+    const rtka_graph_sparse_t* graph;
+    rtka_traversal_work_t* work;
+    const float* lengths;
+    sssp_local_t* locals;
+    float inv_delta;
+    uint32_t current;
+} sssp_ctx_t;
+
+RTKA_INLINE uint32_t float_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+RTKA_INLINE float bits_float(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+RTKA_INLINE uint32_t sssp_bucket(const sssp_ctx_t* ctx, float d) {
+    float b = d * ctx->inv_delta;
+    return b < (float)UINT32_MAX ? (uint32_t)b : UINT32_MAX - 1U;
+}
+
+static void sssp_push(sssp_local_t* local, uint32_t bucket, uint32_t v) {
+    if (bucket >= local->bin_count) {
+        uint32_t count = local->bin_count ? local->bin_count : 16U;
+        while (count <= bucket) count = count > UINT32_MAX / 2U ? UINT32_MAX : count * 2U;
+        sssp_bin_t* bins = (sssp_bin_t*)realloc(local->bins, (size_t)count * sizeof(sssp_bin_t));
+        if (!bins) {
+            local->failed = true;
+            return;
+        }
+        memset(bins + local->bin_count, 0, (size_t)(count - local->bin_count) * sizeof(sssp_bin_t));
+        local->bins = bins;
+        local->bin_count = count;
+    }
+    sssp_bin_t* bin = &local->bins[bucket];
+    if (bin->count == bin->capacity) {
+        uint32_t capacity = bin->capacity ? bin->capacity * 2U : 64U;
+        uint32_t* items = (uint32_t*)realloc(bin->items, (size_t)capacity * sizeof(uint32_t));
+        if (!items) {
+            local->failed = true;
+            return;
+        }
+        bin->items = items;
+        bin->capacity = capacity;
+    }
+    bin->items[bin->count++] = v;
+}
+
+static void sssp_relax(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    const sssp_ctx_t* ctx = (const sssp_ctx_t*)arg;
+    rtka_traversal_work_t* work = ctx->work;
+    const uint32_t* adj = ctx->graph->adjacency_list;
+    const uint32_t* targets = ctx->graph->edge_indices;
+    sssp_local_t* local = &ctx->locals[worker];
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t v = work->bucket[i];
+        float dv = bits_float(atomic_load_explicit(&work->dist[v], memory_order_relaxed));
+        if (sssp_bucket(ctx, dv) < ctx->current) continue;
+        for (uint32_t e = adj[v]; e < adj[v + 1U]; e++) {
+            float nd = dv + (ctx->lengths ? ctx->lengths[e] : 1.0f);
+            if (!(nd < INFINITY)) continue;
+            uint32_t u = targets[e];
+            uint32_t old = atomic_load_explicit(&work->dist[u], memory_order_relaxed);
+            uint32_t want = float_bits(nd);
+            while (want < old) {
+                if (atomic_compare_exchange_weak_explicit(&work->dist[u], &old, want,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    sssp_push(local, sssp_bucket(ctx, nd), u);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+rtka_error_t rtka_graph_sssp(rtka_graph_traversal_t* t, const rtka_graph_sparse_t* graph,
+                             uint32_t source, const float* lengths, float delta, float* dist) {
+    if (!t || !graph || !dist) return RTKA_ERROR_NULL_POINTER;
+    uint32_t n = graph->num_vertices;
+    if (source >= n) return RTKA_ERROR_INVALID_VALUE;
+    rtka_traversal_work_t* work = traversal_work(t, graph);
+    if (!work) return RTKA_ERROR_OUT_OF_MEMORY;
+    rtka_thread_pool_t* pool = t->pool ? t->pool : rtka_pool_default();
+    uint32_t participants = rtka_pool_size(pool) + 1U;
+
+    /* Default width: the mean finite length */
+    if (!(delta > 0.0f)) {
+        double sum = 0.0;
+        uint64_t finite = 0;
+        for (uint32_t e = 0; lengths && e < graph->num_edges; e++) {
+            if (lengths[e] < INFINITY) {
+                sum += lengths[e];
+                finite++;
+            }
+        }
+        delta = lengths && finite && sum > 0.0 ? (float)(sum / (double)finite) : 1.0f;
+    }
+
+    sssp_local_t* locals = (sssp_local_t*)calloc(participants, sizeof(sssp_local_t));
+    if (!locals) return RTKA_ERROR_OUT_OF_MEMORY;
+    sssp_ctx_t ctx = {
+        .graph = graph, .work = work, .lengths = lengths, .locals = locals,
+        .inv_delta = 1.0f / delta, .current = 0,
+    };
+    uint32_t infinite = float_bits(INFINITY);
+    for (uint32_t v = 0; v < n; v++) atomic_store_explicit(&work->dist[v], infinite, memory_order_relaxed);
+    atomic_store_explicit(&work->dist[source], float_bits(0.0f), memory_order_relaxed);
+
+    rtka_error_t err = RTKA_SUCCESS;
+    size_t size = 1;
+    if (!work->bucket) {
+        work->bucket_capacity = 1024U;
+        work->bucket = (uint32_t*)malloc(work->bucket_capacity * sizeof(uint32_t));
+        if (!work->bucket) err = RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    if (work->bucket) work->bucket[0] = source;
+
+    while (err == RTKA_SUCCESS && size) {
+        rtka_pool_parallel_for(pool, 0, (uint32_t)size, SSSP_GRAIN, sssp_relax, &ctx);
+
+        uint32_t next = UINT32_MAX;
+        for (uint32_t w = 0; w < participants; w++) {
+            if (locals[w].failed) err = RTKA_ERROR_OUT_OF_MEMORY;
+            for (uint32_t b = ctx.current; b < locals[w].bin_count && b < next; b++) {
+                if (locals[w].bins[b].count) {
+                    next = b;
+                    break;
+                }
+            }
+        }
+        size = 0;
+        if (next == UINT32_MAX || err != RTKA_SUCCESS) break;
+
+        for (uint32_t w = 0; w < participants; w++) {
+            if (next < locals[w].bin_count) size += locals[w].bins[next].count;
+        }
+        if (size > UINT32_MAX) {
+            err = RTKA_ERROR_OUT_OF_MEMORY;
+            break;
+        }
+        if (size > work->bucket_capacity) {
+            size_t capacity = work->bucket_capacity;
+            while (capacity < size) capacity *= 2U;
+            uint32_t* bucket = (uint32_t*)realloc(work->bucket, capacity * sizeof(uint32_t));
+            if (!bucket) {
+                err = RTKA_ERROR_OUT_OF_MEMORY;
+                break;
+            }
+            work->bucket = bucket;
+            work->bucket_capacity = capacity;
+        }
+        size_t at = 0;
+        for (uint32_t w = 0; w < participants; w++) {
+            if (next >= locals[w].bin_count || !locals[w].bins[next].count) continue;
+            sssp_bin_t* bin = &locals[w].bins[next];
+            memcpy(work->bucket + at, bin->items, (size_t)bin->count * sizeof(uint32_t));
+            at += bin->count;
+            bin->count = 0;
+        }
+        ctx.current = next;
+    }
+
+    for (uint32_t w = 0; w < participants; w++) {
+        for (uint32_t b = 0; b < locals[w].bin_count; b++) free(locals[w].bins[b].items);
+        free(locals[w].bins);
+    }
+    free(locals);
+    if (err != RTKA_SUCCESS) return err;
+    for (uint32_t v = 0; v < n; v++) {
+        dist[v] = bits_float(atomic_load_explicit(&work->dist[v], memory_order_relaxed));
+    }
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * TERNARY TRAVERSALS
+ * ============================================================================ */
+
+typedef struct {
+    rtka_thread_pool_t* pool;
+    const rtka_graph_sparse_t* graph;
+    const rtka_traversal_work_t* work;
+    rtka_state_t* states;
+    rtka_confidence_t decay;
+} propagate_ctx_t;
+
+/* Vertices of the new level OR in every parent of the previous one */
+static void propagate_piece(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const propagate_ctx_t* ctx = (const propagate_ctx_t*)arg;
+    const rtka_traversal_work_t* work = ctx->work;
+    const rtka_state_t* weights = ctx->graph->edge_weights;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t u = work->frontier[i];
+        rtka_state_t acc = ctx->states[u];
+        for (uint32_t k = work->in_offsets[u]; k < work->in_offsets[u + 1U]; k++) {
+            uint32_t p = work->in_sources[k];
+            if (!bit_test(work->frontier_bits, p)) continue;
+            rtka_state_t edge_weight = weights ? weights[work->in_edges[k]] : rtka_make_state(RTKA_TRUE, 1.0f);
+            rtka_state_t propagated = rtka_combine_and(ctx->states[p], edge_weight);
+            propagated.confidence *= ctx->decay;
+            acc = rtka_combine_or(acc, propagated);
+        }
+        ctx->states[u] = acc;
+    }
+}
+
+static void propagate_level(void* arg, const rtka_graph_sparse_t* graph,
+                            const rtka_traversal_work_t* work, uint32_t level) {
+    propagate_ctx_t* ctx = (propagate_ctx_t*)arg;
+    ctx->graph = graph;
+    ctx->work = work;
+    ctx->decay = powf(0.9f, (float)level);
+    rtka_pool_parallel_for(ctx->pool, 0, work->frontier_size, TRAVERSE_GRAIN, propagate_piece, ctx);
+}
+
+/* Confidence propagation through graph: level by level from the source,
+ * each newly reached vertex ORs in AND(parent, edge) decayed by 0.9 per
+ * level, over all its parents in the previous level */
+void rtka_propagate_confidence(rtka_graph_sparse_t* graph, uint32_t source, uint32_t max_depth) {
+    if (!graph || !graph->vertex_states || source >= graph->num_vertices || !max_depth) return;
+    rtka_graph_traversal_t* t = rtka_graph_traversal_init(NULL);
+    uint32_t* depth = (uint32_t*)malloc((size_t)graph->num_vertices * sizeof(uint32_t));
+    if (t && depth) {
+        propagate_ctx_t ctx = { .pool = rtka_pool_default(), .states = graph->vertex_states };
+        (void)traversal_bfs(t, graph, source, max_depth, depth, propagate_level, &ctx);
+    }
+    free(depth);
+    rtka_graph_traversal_free(t);
+}
+
+/* BFS with ternary states */
+rtka_state_t* rtka_graph_bfs_ternary(rtka_graph_sparse_t* graph, uint32_t start) {
+    if (!graph || start >= graph->num_vertices) return NULL;
+    uint32_t n = graph->num_vertices;
+    rtka_graph_traversal_t* t = rtka_graph_traversal_init(NULL);
+    uint32_t* depth = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    rtka_state_t* distances = (rtka_state_t*)malloc((size_t)n * sizeof(rtka_state_t));
+    rtka_confidence_t* level_confidence = NULL;
+    bool ok = t && depth && distances &&
+              rtka_graph_bfs(t, graph, start, RTKA_GRAPH_UNREACHED, depth) == RTKA_SUCCESS;
+    if (ok) {
+        /* 0.9 per level, multiplied out as the queue version did */
+        level_confidence = (rtka_confidence_t*)malloc(((size_t)t->levels + 1U) * sizeof(rtka_confidence_t));
+        ok = level_confidence != NULL;
+    }
+    if (ok) {
+        level_confidence[0] = 1.0f;
+        for (uint32_t d = 1; d <= t->levels; d++) level_confidence[d] = level_confidence[d - 1U] * 0.9f;
+        for (uint32_t v = 0; v < n; v++) {
+            distances[v] = depth[v] == RTKA_GRAPH_UNREACHED ? rtka_make_state(RTKA_UNKNOWN, 0.0f)
+                                                            : rtka_make_state(RTKA_TRUE, level_confidence[depth[v]]);
+        }
+    }
+    free(level_confidence);
+    free(depth);
+    rtka_graph_traversal_free(t);
+    if (!ok) {
+        free(distances);
+        return NULL;
+    }
+    return distances;
+}
+
+/* Most confident path: edge lengths -log(0.9 * confidence), so an unweighted
+ * graph gives the BFS confidences */
+rtka_state_t* rtka_graph_dijkstra_ternary(rtka_graph_sparse_t* graph, uint32_t start) {
+    if (!graph || start >= graph->num_vertices) return NULL;
+    uint32_t n = graph->num_vertices;
+    rtka_graph_traversal_t* t = rtka_graph_traversal_init(NULL);
+    float* lengths = (float*)malloc(((size_t)graph->num_edges + 1U) * sizeof(float));
+    float* dist = (float*)malloc((size_t)n * sizeof(float));
+    rtka_state_t* result = (rtka_state_t*)malloc((size_t)n * sizeof(rtka_state_t));
+    bool ok = t && lengths && dist && result;
+    if (ok) {
+        for (uint32_t e = 0; e < graph->num_edges; e++) {
+            rtka_confidence_t c = graph->edge_weights ? graph->edge_weights[e].confidence : 1.0f;
+            lengths[e] = c > 0.0f ? -logf(0.9f * c) : INFINITY;
+        }
+        ok = rtka_graph_sssp(t, graph, start, lengths, 0.0f, dist) == RTKA_SUCCESS;
+    }
+    if (ok) {
+        for (uint32_t v = 0; v < n; v++) {
+            result[v] = dist[v] < INFINITY ? rtka_make_state(RTKA_TRUE, expf(-dist[v]))
+                                           : rtka_make_state(RTKA_UNKNOWN, 0.0f);
+        }
+    }
+    free(lengths);
+    free(dist);
+    rtka_graph_traversal_free(t);
+    if (!ok) {
+        free(result);
+        return NULL;
+    }
+    return result;
+}
+
+/* ============================================================================
+ * MAXIMUM FLOW
+ *
+ * Highest-label push-relabel, first phase: the preflow it leaves carries
+ * the maximum flow value into the sink and marks the minimum cut. The
+ * residual graph is CSR: every edge u -> v is an arc in u's row and a
+ * reverse arc in v's, paired through rev. Global relabeling recomputes
+ * exact distances to the sink with a level-synchronous BFS over reverse
+ * residual arcs on the pool, at the start and after FLOW_GLOBAL_FACTOR * n
+ * + m arcs of relabel scans; the gap heuristic lifts everything above an
+ * emptied label to n. Pushes move min(excess, residual), so the one that
+ * hits zero hits it exactly and doubles terminate as integers would.
+ * ============================================================================ */
+
+#define FLOW_NIL            UINT32_MAX
+#define FLOW_GLOBAL_FACTOR  6U
+#define FLOW_BFS_BATCH      64U     /* Vertices claimed before one append */
+
+typedef struct {
+    uint32_t n;
+    uint32_t num_arcs;
+    uint32_t source;
+    uint32_t sink;
+    uint32_t* first;                   /* n + 1 arc offsets */
+    uint32_t* head;
+    uint32_t* rev;
+    double* residual;
+    double* excess;
+    uint32_t* label;
+    uint32_t* current;                 /* Next arc to try */
+    /* Per label: active vertices as a stack, all vertices doubly linked */
+    uint32_t* active_head;
+    uint32_t* active_next;
+    uint32_t* all_head;
+    uint32_t* all_next;
+    uint32_t* all_prev;
+    uint32_t max_active;
+    uint32_t max_label;
+    /* Global relabel */
+    rtka_thread_pool_t* pool;
+    _Atomic uint32_t* seen;
+    uint32_t stamp;
+    uint32_t* queue;
+    uint32_t* next_queue;
+    _Atomic uint32_t next_size;
+    uint32_t queue_size;
+    uint32_t level;
+    uint64_t scans;                    /* Arcs scanned by relabels since the last global relabel */
+} flow_t;
+
+static void flow_free(flow_t* f) {
+    free(f->first);
+    free(f->head);
+    free(f->rev);
+    free(f->residual);
+    free(f->excess);
+    free(f->label);
+    free(f->current);
+    free(f->active_head);
+    free(f->active_next);
+    free(f->all_head);
+    free(f->all_next);
+    free(f->all_prev);
+    free((void*)f->seen);
+    free(f->queue);
+    free(f->next_queue);
+}
+
+static bool flow_build(flow_t* f, const rtka_graph_sparse_t* graph, const float* capacities) {
+    uint32_t n = graph->num_vertices;
+    const uint32_t* adj = graph->adjacency_list;
+    size_t count = (size_t)n + 1U;
+    f->n = n;
+    f->first = (uint32_t*)calloc(count, sizeof(uint32_t));
+    f->excess = (double*)calloc(count, sizeof(double));
+    f->label = (uint32_t*)calloc(count, sizeof(uint32_t));
+    f->current = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->active_head = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->active_next = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->all_head = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->all_next = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->all_prev = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->seen = (_Atomic uint32_t*)calloc(count, sizeof(uint32_t));
+    f->queue = (uint32_t*)malloc(count * sizeof(uint32_t));
+    f->next_queue = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (!f->first || !f->excess || !f->label || !f->current || !f->active_head || !f->active_next ||
+        !f->all_head || !f->all_next || !f->all_prev || !f->seen || !f->queue || !f->next_queue) {
+        return false;
+    }
+
+    /* Both ends of every edge with capacity; self loops carry nothing */
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = adj[u]; e < adj[u + 1U]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            if (v == u) continue;
+            f->first[u + 1U]++;
+            f->first[v + 1U]++;
+        }
+    }
+    for (uint32_t v = 0; v < n; v++) f->first[v + 1U] += f->first[v];
+    f->num_arcs = f->first[n];
+    size_t arcs = (size_t)f->num_arcs + 1U;
+    f->head = (uint32_t*)malloc(arcs * sizeof(uint32_t));
+    f->rev = (uint32_t*)malloc(arcs * sizeof(uint32_t));
+    f->residual = (double*)malloc(arcs * sizeof(double));
+    if (!f->head || !f->rev || !f->residual) return false;
+
+    memcpy(f->current, f->first, (size_t)n * sizeof(uint32_t));
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = adj[u]; e < adj[u + 1U]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            if (v == u) continue;
+            float c = capacities ? capacities[e] : graph->edge_weights ? graph->edge_weights[e].confidence : 1.0f;
+            uint32_t a = f->current[u]++, b = f->current[v]++;
+            f->head[a] = v;
+            f->rev[a] = b;
+            f->residual[a] = c > 0.0f ? (double)c : 0.0;
+            f->head[b] = u;
+            f->rev[b] = a;
+            f->residual[b] = 0.0;
+        }
+    }
+    return true;
+}
+
+RTKA_INLINE void flow_all_insert(flow_t* f, uint32_t label, uint32_t v) {
+    uint32_t next = f->all_head[label];
+    f->all_next[v] = next;
+    f->all_prev[v] = FLOW_NIL;
+    if (next != FLOW_NIL) f->all_prev[next] = v;
+    f->all_head[label] = v;
+    if (label > f->max_label || f->max_label == FLOW_NIL) f->max_label = label;
+}
+
+RTKA_INLINE void flow_all_remove(flow_t* f, uint32_t label, uint32_t v) {
+    uint32_t prev = f->all_prev[v], next = f->all_next[v];
+    if (prev == FLOW_NIL) f->all_head[label] = next;
+    else f->all_next[prev] = next;
+    if (next != FLOW_NIL) f->all_prev[next] = prev;
+}
+
+RTKA_INLINE void flow_activate(flow_t* f, uint32_t v) {
+    uint32_t label = f->label[v];
+    f->active_next[v] = f->active_head[label];
+    f->active_head[label] = v;
+    if (label > f->max_active || f->max_active == FLOW_NIL) f->max_active = label;
+}
+
+/* Frontier vertices w: every u with residual on u -> w is one level out */
+static void flow_bfs_piece(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    flow_t* f = (flow_t*)arg;
+    uint32_t batch[FLOW_BFS_BATCH];
+    uint32_t held = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t w = f->queue[i];
+        for (uint32_t a = f->first[w]; a < f->first[w + 1U]; a++) {
+            uint32_t u = f->head[a];
+            if (f->residual[f->rev[a]] <= 0.0) continue;
+            uint32_t mark = atomic_load_explicit(&f->seen[u], memory_order_relaxed);
+            if (mark == f->stamp) continue;
+            if (!atomic_compare_exchange_strong_explicit(&f->seen[u], &mark, f->stamp,
+                                                         memory_order_relaxed, memory_order_relaxed)) {
+                continue;
+            }
+            f->label[u] = f->level;
+            batch[held++] = u;
+            if (held == FLOW_BFS_BATCH) {
+                uint32_t at = atomic_fetch_add_explicit(&f->next_size, held, memory_order_relaxed);
+                memcpy(f->next_queue + at, batch, held * sizeof(uint32_t));
+                held = 0;
+            }
+        }
+    }
+    if (held) {
+        uint32_t at = atomic_fetch_add_explicit(&f->next_size, held, memory_order_relaxed);
+        memcpy(f->next_queue + at, batch, held * sizeof(uint32_t));
+    }
+}
+
+/* Exact distances to the sink; vertices that cannot reach it go to n */
+static void flow_global_relabel(flow_t* f) {
+    uint32_t n = f->n;
+    f->stamp++;
+    atomic_store_explicit(&f->seen[f->sink], f->stamp, memory_order_relaxed);
+    atomic_store_explicit(&f->seen[f->source], f->stamp, memory_order_relaxed);
+    for (uint32_t v = 0; v < n; v++) f->label[v] = n;
+    f->label[f->sink] = 0;
+    f->queue[0] = f->sink;
+    f->queue_size = 1;
+    f->level = 0;
+    while (f->queue_size) {
+        f->level++;
+        atomic_store_explicit(&f->next_size, 0, memory_order_relaxed);
+        rtka_pool_parallel_for(f->pool, 0, f->queue_size, TRAVERSE_GRAIN, flow_bfs_piece, f);
+        uint32_t* swap = f->queue;
+        f->queue = f->next_queue;
+        f->next_queue = swap;
+        f->queue_size = atomic_load_explicit(&f->next_size, memory_order_relaxed);
+    }
+
+    for (uint32_t l = 0; l <= n; l++) {
+        f->active_head[l] = FLOW_NIL;
+        f->all_head[l] = FLOW_NIL;
+    }
+    f->max_active = f->max_label = FLOW_NIL;
+    for (uint32_t v = 0; v < n; v++) {
+        f->current[v] = f->first[v];
+        if (v == f->source || v == f->sink || f->label[v] >= n) continue;
+        flow_all_insert(f, f->label[v], v);
+        if (f->excess[v] > 0.0) flow_activate(f, v);
+    }
+    f->scans = 0;
+}
+
+/* No vertex is left at label gap: nothing above it reaches the sink */
+static void flow_gap(flow_t* f, uint32_t gap) {
+    for (uint32_t l = gap + 1U; f->max_label != FLOW_NIL && l <= f->max_label; l++) {
+        for (uint32_t v = f->all_head[l]; v != FLOW_NIL; v = f->all_next[v]) f->label[v] = f->n;
+        f->all_head[l] = FLOW_NIL;
+        f->active_head[l] = FLOW_NIL;
+    }
+    f->max_label = gap - 1U;
+    if (f->max_active != FLOW_NIL && f->max_active > f->max_label) f->max_active = f->max_label;
+}
+
+static void flow_relabel(flow_t* f, uint32_t v) {
+    uint32_t old = f->label[v], lowest = f->n, arc = f->first[v];
+    for (uint32_t a = f->first[v]; a < f->first[v + 1U]; a++) {
+        if (f->residual[a] > 0.0 && f->label[f->head[a]] + 1U < lowest) {
+            lowest = f->label[f->head[a]] + 1U;
+            arc = a;
+        }
+    }
+    f->scans += f->first[v + 1U] - f->first[v] + 1U;
+    flow_all_remove(f, old, v);
+    if (f->all_head[old] == FLOW_NIL) {
+        f->label[v] = f->n;
+        flow_gap(f, old);
+        return;
+    }
+    f->label[v] = lowest;
+    f->current[v] = arc;
+    if (lowest < f->n) flow_all_insert(f, lowest, v);
+}
+
+static void flow_discharge(flow_t* f, uint32_t v) {
+    while (f->excess[v] > 0.0 && f->label[v] < f->n) {
+        uint32_t end = f->first[v + 1U], a = f->current[v];
+        uint32_t want = f->label[v] - 1U;
+        for (; a < end; a++) {
+            double r = f->residual[a];
+            uint32_t w = f->head[a];
+            if (r <= 0.0 || f->label[w] != want) continue;
+            double delta = f->excess[v] < r ? f->excess[v] : r;
+            f->residual[a] = r - delta;
+            f->residual[f->rev[a]] += delta;
+            if (f->excess[w] <= 0.0 && w != f->sink && w != f->source) flow_activate(f, w);
+            f->excess[w] += delta;
+            f->excess[v] -= delta;
+            if (f->excess[v] <= 0.0) break;
+        }
+        f->current[v] = a < end ? a : f->first[v];
+        if (a >= end) flow_relabel(f, v);
+    }
+}
+
+rtka_error_t rtka_graph_max_flow_value(const rtka_graph_sparse_t* graph, uint32_t source, uint32_t sink,
+                                       const float* capacities, rtka_thread_pool_t* pool,
+                                       double* value, uint8_t* source_side) {
+    if (!graph || !value) return RTKA_ERROR_NULL_POINTER;
+    if (source >= graph->num_vertices || sink >= graph->num_vertices || source == sink) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    flow_t f = { .source = source, .sink = sink, .pool = pool ? pool : rtka_pool_default() };
+    if (!flow_build(&f, graph, capacities)) {
+        flow_free(&f);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Saturate the source's arcs */
+    for (uint32_t a = f.first[source]; a < f.first[source + 1U]; a++) {
+        double c = f.residual[a];
+        if (c <= 0.0) continue;
+        f.residual[a] = 0.0;
+        f.residual[f.rev[a]] += c;
+        f.excess[f.head[a]] += c;
+        f.excess[source] -= c;
+    }
+    flow_global_relabel(&f);
+
+    uint64_t budget = (uint64_t)FLOW_GLOBAL_FACTOR * f.n + f.num_arcs;
+    while (f.max_active != FLOW_NIL) {
+        uint32_t v = f.active_head[f.max_active];
+        if (v == FLOW_NIL) {
+            f.max_active = f.max_active ? f.max_active - 1U : FLOW_NIL;
+            continue;
+        }
+        f.active_head[f.max_active] = f.active_next[v];
+        if (f.label[v] != f.max_active || f.excess[v] <= 0.0) continue;
+        flow_discharge(&f, v);
+        if (f.scans > budget) flow_global_relabel(&f);
+    }
+
+    *value = f.excess[sink];
+    if (source_side) {
+        flow_global_relabel(&f);
+        for (uint32_t v = 0; v < f.n; v++) source_side[v] = f.label[v] >= f.n && v != sink;
+    }
+    flow_free(&f);
+    return RTKA_SUCCESS;
+}
+
+/* Maximum flow with ternary capacities: TRUE with the share of the source's
+ * out-capacity that reaches the sink, FALSE when none does */
+rtka_state_t rtka_graph_max_flow(rtka_graph_sparse_t* graph, uint32_t source, uint32_t sink) {
+    double value = 0.0;
+    if (rtka_graph_max_flow_value(graph, source, sink, NULL, NULL, &value, NULL) != RTKA_SUCCESS) {
+        return rtka_make_state(RTKA_UNKNOWN, 0.0f);
+    }
+    if (!(value > 0.0)) return rtka_make_state(RTKA_FALSE, 1.0f);
+    double out = 0.0;
+    for (uint32_t e = graph->adjacency_list[source]; e < graph->adjacency_list[source + 1U]; e++) {
+        if (graph->edge_indices[e] == source) continue;
+        float c = graph->edge_weights ? graph->edge_weights[e].confidence : 1.0f;
+        if (c > 0.0f) out += c;
+    }
+    return rtka_make_state(RTKA_TRUE, (rtka_confidence_t)fmin(value / out, 1.0));
+}
+
+/* ============================================================================
+ * LOUVAIN
+ *
+ * Undirected weights w(u, v) = conf(u -> v) + conf(v -> u), FALSE edges
+ * dropped. Each level moves vertices to the neighbouring community with
+ * the best modularity gain, all vertices in parallel with moves visible
+ * as they land (volumes by atomic add), for rounds until fewer than
+ * 1 / LOUVAIN_SETTLED of them move.
+ * Communities are then contracted: members are bucketed by community and
+ * every coarse row is merged on the pool through a per-worker dense map.
+ * The partition can differ with the thread count; one participant makes
+ * it deterministic.
+ * ============================================================================ */
+
+#define LOUVAIN_GRAIN       256U   /* Vertices per local moving piece */
+#define LOUVAIN_MAX_ROUNDS  32U
+#define LOUVAIN_MAX_LEVELS  32U
+#define LOUVAIN_MIN_GAIN    1e-7   /* Modularity a level must add */
+#define LOUVAIN_SETTLED     1000U  /* A level stops moving below n / 1000 moves a round */
+
+typedef struct {
+    uint32_t n;
+    uint32_t* offsets;
+    uint32_t* nbr;                     /* Self loops kept apart in self */
+    double* weight;
+    double* self;                      /* Internal weight, counted once */
+    double* degree;                    /* Row sum + 2 * self */
+} louvain_level_t;
+
+typedef struct {
+    double* to;                        /* Weight to each community touched */
+    uint32_t* touched;
+    uint32_t count;
+    uint32_t moved;
+} louvain_map_t;
+
+typedef struct {
+    const louvain_level_t* g;
+    _Atomic uint32_t* community;
+    _Atomic double* volume;
+    louvain_map_t* maps;
+    double total;
+    bool shared;
+    /* Contraction */
+    const uint32_t* coarse_id;         /* Community -> coarse vertex */
+    const uint32_t* member_start;
+    const uint32_t* members;
+    louvain_level_t* out;
+    uint32_t* row_count;
+} louvain_ctx_t;
+
+static void louvain_level_free(louvain_level_t* g) {
+    free(g->offsets);
+    free(g->nbr);
+    free(g->weight);
+    free(g->self);
+    free(g->degree);
+    memset(g, 0, sizeof(*g));
+}
+
+static bool louvain_level_alloc(louvain_level_t* g, uint32_t n) {
+    g->n = n;
+    g->offsets = (uint32_t*)calloc((size_t)n + 1U, sizeof(uint32_t));
+    g->self = (double*)calloc((size_t)n + 1U, sizeof(double));
+    g->degree = (double*)calloc((size_t)n + 1U, sizeof(double));
+    return g->offsets && g->self && g->degree;
+}
+
+static bool louvain_level_rows(louvain_level_t* g) {
+    size_t entries = (size_t)g->offsets[g->n] + 1U;
+    g->nbr = (uint32_t*)malloc(entries * sizeof(uint32_t));
+    g->weight = (double*)malloc(entries * sizeof(double));
+    return g->nbr && g->weight;
+}
+
+/* Symmetrized level 0; a pair linked both ways keeps two entries, merged
+ * by the first contraction */
+static bool louvain_level_from_graph(louvain_level_t* g, const rtka_graph_sparse_t* graph) {
+    uint32_t n = graph->num_vertices;
+    const uint32_t* adj = graph->adjacency_list;
+    if (!louvain_level_alloc(g, n)) return false;
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = adj[u]; e < adj[u + 1U]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            if (v == u) continue;
+            if (graph->edge_weights && (graph->edge_weights[e].value == RTKA_FALSE ||
+                                        !(graph->edge_weights[e].confidence > 0.0f))) continue;
+            g->offsets[u + 1U]++;
+            g->offsets[v + 1U]++;
+        }
+    }
+    for (uint32_t v = 0; v < n; v++) g->offsets[v + 1U] += g->offsets[v];
+    if (!louvain_level_rows(g)) return false;
+    uint32_t* fill = (uint32_t*)malloc(((size_t)n + 1U) * sizeof(uint32_t));
+    if (!fill) return false;
+    memcpy(fill, g->offsets, (size_t)n * sizeof(uint32_t));
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = adj[u]; e < adj[u + 1U]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            double w = graph->edge_weights ? (double)graph->edge_weights[e].confidence : 1.0;
+            if (graph->edge_weights && (graph->edge_weights[e].value == RTKA_FALSE || !(w > 0.0))) continue;
+            if (v == u) {
+                g->self[u] += w;
+                continue;
+            }
+            g->nbr[fill[u]] = v;
+            g->weight[fill[u]++] = w;
+            g->nbr[fill[v]] = u;
+            g->weight[fill[v]++] = w;
+        }
+    }
+    free(fill);
+    for (uint32_t u = 0; u < n; u++) {
+        double k = 2.0 * g->self[u];
+        for (uint32_t i = g->offsets[u]; i < g->offsets[u + 1U]; i++) k += g->weight[i];
+        g->degree[u] = k;
+    }
+    return true;
+}
+
+/* Modularity of the level's vertices as communities */
+static double louvain_singletons(const louvain_level_t* g, double total) {
+    double q = 0.0;
+    for (uint32_t c = 0; c < g->n; c++) {
+        double share = g->degree[c] / total;
+        q += 2.0 * g->self[c] / total - share * share;
+    }
+    return q;
+}
+
+RTKA_INLINE void louvain_touch(louvain_map_t* map, uint32_t c, double w) {
+    if (map->to[c] == 0.0) map->touched[map->count++] = c;
+    map->to[c] += w;
+}
+
+RTKA_INLINE void louvain_clear(louvain_map_t* map) {
+    for (uint32_t i = 0; i < map->count; i++) map->to[map->touched[i]] = 0.0;
+    map->count = 0;
+}
+
+static void louvain_move(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    const louvain_ctx_t* ctx = (const louvain_ctx_t*)arg;
+    const louvain_level_t* g = ctx->g;
+    louvain_map_t* map = &ctx->maps[worker];
+    for (uint32_t u = begin; u < end; u++) {
+        uint32_t own = atomic_load_explicit(&ctx->community[u], memory_order_relaxed);
+        double k = g->degree[u];
+        if (!(k > 0.0)) continue;
+        for (uint32_t i = g->offsets[u]; i < g->offsets[u + 1U]; i++) {
+            louvain_touch(map, atomic_load_explicit(&ctx->community[g->nbr[i]], memory_order_relaxed), g->weight[i]);
+        }
+
+        /* Gain against u standing alone: w(u, C) - k * vol(C) / 2m */
+        double scale = k / ctx->total;
+        double own_volume = atomic_load_explicit(&ctx->volume[own], memory_order_relaxed) - k;
+        double best_gain = map->to[own] - scale * own_volume;
+        uint32_t best = own;
+        for (uint32_t i = 0; i < map->count; i++) {
+            uint32_t c = map->touched[i];
+            if (c == own) continue;
+            double gain = map->to[c] - scale * atomic_load_explicit(&ctx->volume[c], memory_order_relaxed);
+            if (gain > best_gain || (gain == best_gain && c < best && best != own)) {
+                best_gain = gain;
+                best = c;
+            }
+        }
+        louvain_clear(map);
+
+        if (best != own) {
+            add_double(&ctx->volume[own], -k, ctx->shared);
+            add_double(&ctx->volume[best], k, ctx->shared);
+            atomic_store_explicit(&ctx->community[u], best, memory_order_relaxed);
+            map->moved++;
+        }
+    }
+}
+
+/* Coarse vertices [begin, end): pass 1 counts distinct neighbours, pass 2
+ * (out->nbr set) writes them in the same touch order */
+static void louvain_contract(void* arg, uint32_t begin, uint32_t end, uint32_t worker) {
+    const louvain_ctx_t* ctx = (const louvain_ctx_t*)arg;
+    const louvain_level_t* g = ctx->g;
+    louvain_level_t* out = ctx->out;
+    louvain_map_t* map = &ctx->maps[worker];
+    for (uint32_t c = begin; c < end; c++) {
+        double internal = 0.0, self = 0.0;
+        for (uint32_t m = ctx->member_start[c]; m < ctx->member_start[c + 1U]; m++) {
+            uint32_t u = ctx->members[m];
+            self += g->self[u];
+            for (uint32_t i = g->offsets[u]; i < g->offsets[u + 1U]; i++) {
+                uint32_t d = ctx->coarse_id[atomic_load_explicit(&ctx->community[g->nbr[i]], memory_order_relaxed)];
+                if (d == c) internal += g->weight[i];
+                else louvain_touch(map, d, g->weight[i]);
+            }
+        }
+        if (!out->nbr) {
+            ctx->row_count[c] = map->count;
+        } else {
+            uint32_t at = out->offsets[c];
+            double k = 0.0;
+            for (uint32_t i = 0; i < map->count; i++) {
+                uint32_t d = map->touched[i];
+                out->nbr[at + i] = d;
+                out->weight[at + i] = map->to[d];
+                k += map->to[d];
+            }
+            /* Each internal edge was seen from both ends */
+            out->self[c] = self + 0.5 * internal;
+            out->degree[c] = k + 2.0 * out->self[c];
+        }
+        louvain_clear(map);
+    }
+}
+
+rtka_error_t rtka_graph_louvain(const rtka_graph_sparse_t* graph, rtka_thread_pool_t* pool,
+                                uint32_t* community, double* modularity) {
+    if (!graph || !community) return RTKA_ERROR_NULL_POINTER;
+    uint32_t n0 = graph->num_vertices;
+    if (!n0) return RTKA_ERROR_INVALID_VALUE;
+    if (!pool) pool = rtka_pool_default();
+    uint32_t participants = rtka_pool_size(pool) + 1U;
+
+    louvain_level_t g = {0}, next = {0};
+    louvain_map_t* maps = (louvain_map_t*)calloc(participants, sizeof(louvain_map_t));
+    _Atomic uint32_t* comm = (_Atomic uint32_t*)malloc(((size_t)n0 + 1U) * sizeof(uint32_t));
+    _Atomic double* volume = (_Atomic double*)malloc(((size_t)n0 + 1U) * sizeof(double));
+    uint32_t* coarse_id = (uint32_t*)malloc(((size_t)n0 + 1U) * sizeof(uint32_t));
+    uint32_t* member_start = (uint32_t*)malloc(((size_t)n0 + 2U) * sizeof(uint32_t));
+    uint32_t* members = (uint32_t*)malloc(((size_t)n0 + 1U) * sizeof(uint32_t));
+    bool ok = maps && comm && volume && coarse_id && member_start && members &&
+              louvain_level_from_graph(&g, graph);
+    for (uint32_t w = 0; ok && w < participants; w++) {
+        maps[w].to = (double*)calloc((size_t)n0 + 1U, sizeof(double));
+        maps[w].touched = (uint32_t*)malloc(((size_t)n0 + 1U) * sizeof(uint32_t));
+        ok = maps[w].to && maps[w].touched;
+    }
+
+    double total = 0.0;
+    for (uint32_t u = 0; ok && u < n0; u++) total += g.degree[u];
+    for (uint32_t v = 0; v < n0; v++) community[v] = v;
+    double q = ok && total > 0.0 ? louvain_singletons(&g, total) : 0.0;
+
+    for (uint32_t level = 0; ok && total > 0.0 && level < LOUVAIN_MAX_LEVELS; level++) {
+        uint32_t n = g.n;
+        for (uint32_t u = 0; u < n; u++) {
+            atomic_store_explicit(&comm[u], u, memory_order_relaxed);
+            atomic_store_explicit(&volume[u], g.degree[u], memory_order_relaxed);
+        }
+        louvain_ctx_t ctx = {
+            .g = &g, .community = comm, .volume = volume, .maps = maps, .total = total,
+            .shared = participants > 1U, .coarse_id = coarse_id, .member_start = member_start,
+            .members = members,
+        };
+
+        /* Local moving */
+        uint32_t moved_total = 0;
+        for (uint32_t round = 0; round < LOUVAIN_MAX_ROUNDS; round++) {
+            for (uint32_t w = 0; w < participants; w++) maps[w].moved = 0;
+            rtka_pool_parallel_for(pool, 0, n, LOUVAIN_GRAIN, louvain_move, &ctx);
+            uint32_t moved = 0;
+            for (uint32_t w = 0; w < participants; w++) moved += maps[w].moved;
+            moved_total += moved;
+            if (moved <= n / LOUVAIN_SETTLED) break;
+        }
+        if (!moved_total) break;
+
+        /* Number the communities and bucket their members */
+        uint32_t coarse = 0;
+        for (uint32_t c = 0; c < n; c++) coarse_id[c] = FLOW_NIL;
+        for (uint32_t u = 0; u < n; u++) {
+            uint32_t c = atomic_load_explicit(&comm[u], memory_order_relaxed);
+            if (coarse_id[c] == FLOW_NIL) coarse_id[c] = coarse++;
+        }
+        memset(member_start, 0, ((size_t)coarse + 2U) * sizeof(uint32_t));
+        for (uint32_t u = 0; u < n; u++) member_start[coarse_id[atomic_load_explicit(&comm[u], memory_order_relaxed)] + 2U]++;
+        for (uint32_t c = 0; c < coarse; c++) member_start[c + 2U] += member_start[c + 1U];
+        for (uint32_t u = 0; u < n; u++) {
+            members[member_start[coarse_id[atomic_load_explicit(&comm[u], memory_order_relaxed)] + 1U]++] = u;
+        }
+
+        /* Contract on the pool: count, prefix, fill */
+        ok = louvain_level_alloc(&next, coarse);
+        if (!ok) break;
+        ctx.out = &next;
+        ctx.row_count = next.offsets + 1;
+        rtka_pool_parallel_for(pool, 0, coarse, LOUVAIN_GRAIN, louvain_contract, &ctx);
+        for (uint32_t c = 0; c < coarse; c++) next.offsets[c + 1U] += next.offsets[c];
+        ok = louvain_level_rows(&next);
+        if (!ok) break;
+        rtka_pool_parallel_for(pool, 0, coarse, LOUVAIN_GRAIN, louvain_contract, &ctx);
+
+        for (uint32_t v = 0; v < n0; v++) {
+            community[v] = coarse_id[atomic_load_explicit(&comm[community[v]], memory_order_relaxed)];
+        }
+        louvain_level_free(&g);
+        g = next;
+        memset(&next, 0, sizeof(next));
+
+        double q_next = louvain_singletons(&g, total);
+        bool gained = q_next - q > LOUVAIN_MIN_GAIN;
+        q = q_next;
+        if (!gained || coarse == n) break;
+    }
+
+    louvain_level_free(&g);
+    louvain_level_free(&next);
+    for (uint32_t w = 0; maps && w < participants; w++) {
+        free(maps[w].to);
+        free(maps[w].touched);
+    }
+    free(maps);
+    free((void*)comm);
+    free((void*)volume);
+    free(coarse_id);
+    free(member_start);
+    free(members);
+    if (!ok) return RTKA_ERROR_OUT_OF_MEMORY;
+    if (modularity) *modularity = q;
+    return RTKA_SUCCESS;
+}
+
+/* Community detection with ternary states */
+uint32_t* rtka_graph_louvain_ternary(rtka_graph_sparse_t* graph) {
+    if (!graph || !graph->num_vertices) return NULL;
+    uint32_t* community = (uint32_t*)malloc((size_t)graph->num_vertices * sizeof(uint32_t));
+    if (community && rtka_graph_louvain(graph, NULL, community, NULL) != RTKA_SUCCESS) {
+        free(community);
+        return NULL;
+    }
+    return community;
 }
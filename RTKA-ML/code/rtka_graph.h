@@ -7,6 +7,34 @@
  * distributed, or used without explicit written permission.
  *
  * RTKA Graph Framework - PageRank-inspired Confidence Propagation
+ *
+ * CHANGELOG:
+ * v1.1.0 - Graphs own calloc'd CSR arrays (rtka_graph_create_csr, edge
+ *          insertion, free). PageRank is O(E) per iteration: a pull sweep
+ *          over the in-edge transpose with AVX2 gathers, or a push mode in
+ *          which only vertices whose contribution moved by more than the
+ *          tolerance send the change along their out-edges, split by edge
+ *          count over the thread pool. The residual is kept in the state,
+ *          so rtka_pagerank_converged no longer needs a shared buffer.
+ * v1.2.0 - rtka_graph_build_csr sorts edge lists into CSR on the thread
+ *          pool; rows are sorted by target. rtka_graph_save writes the
+ *          arrays in memory layout and rtka_graph_load maps the file
+ *          straight into the graph, copy-on-write.
+ * v1.3.0 - rtka_transition_matrix_t is CSR by target instead of a dense
+ *          size x size matrix; rtka_markov_step is a row-parallel SpMV and
+ *          rtka_markov_propagate steps many distributions at once (SpMM).
+ *          rtka_markov_steady_state and rtka_markov_free are implemented.
+ * v1.4.0 - rtka_graph_traversal_t: direction-optimizing parallel BFS with
+ *          bitmap frontiers and parallel delta-stepping SSSP. The ternary
+ *          BFS, Dijkstra (previously undefined) and confidence propagation
+ *          run on them; propagation takes every parent of the previous
+ *          level rather than the first dequeued, so it no longer depends
+ *          on visiting order.
+ * v1.5.0 - Highest-label push-relabel maximum flow over a CSR residual
+ *          graph with parallel global relabeling and gap heuristic, and
+ *          parallel Louvain (local moving and contraction on the pool);
+ *          rtka_graph_max_flow and rtka_graph_louvain_ternary were
+ *          declared without definitions.
  */
 
 #ifndef RTKA_GRAPH_H
@@ -15,6 +43,7 @@
 #include "rtka_types.h"
 #include "rtka_tensor.h"
 #include "rtka_vector.h"
+#include "rtka_threadpool.h"
 
 /* Graph representation */
 typedef struct {
@@ -24,42 +53,130 @@ typedef struct {
     uint32_t* edge_indices;
     rtka_state_t* vertex_states;
     rtka_state_t* edge_weights;
-    uint32_t* degree;
+    uint32_t* degree;          /* Out-degree, self loops included */
+    uint32_t edge_capacity;
+    void* map;                 /* Loaded file backing the arrays, or NULL */
+    size_t map_length;
 } rtka_graph_sparse_t;
 
-/* Transition matrix for Markov-like processes */
+/* Transition matrix for Markov-like processes, CSR by target: row j lists
+ * the transitions into state j. Only the confidence of a transition is
+ * kept; a step requantizes the value from the combined confidence. */
 typedef struct {
-    rtka_state_t** matrix;  /* Ternary transition probabilities */
     uint32_t size;
+    uint32_t nnz;
+    uint32_t* row_start;               /* size + 1 offsets */
+    uint32_t* source;                  /* Source state, ascending within a row */
+    rtka_confidence_t* weight;         /* Ternary transition probabilities */
     rtka_confidence_t damping_factor;  /* Like PageRank damping */
 } rtka_transition_matrix_t;
 
+#define RTKA_MARKOV_MAX_STEPS 1000U
+#define RTKA_MARKOV_TOLERANCE 1e-6f
+
+#define RTKA_PAGERANK_DAMPING 0.85f
+
+typedef enum {
+    RTKA_PAGERANK_PULL = 0,    /* Every vertex sums its in-edges each iteration */
+    RTKA_PAGERANK_DELTA        /* Vertices push changes above the tolerance */
+} rtka_pagerank_mode_t;
+
+typedef struct rtka_pagerank_work rtka_pagerank_work_t;
+
 /* PageRank-style algorithms for ternary */
 typedef struct {
     rtka_state_t* ranks;
     rtka_confidence_t* importance;
     uint32_t iterations;
     rtka_confidence_t convergence_threshold;
+    rtka_pagerank_mode_t mode;         /* Fixed once iterating */
+    rtka_thread_pool_t* pool;          /* NULL = rtka_pool_default() */
+    rtka_confidence_t residual;        /* L1 change of importance in the last iteration */
+    uint32_t active;                   /* DELTA: vertices that push next iteration */
+    rtka_pagerank_work_t* work;        /* Transpose and scratch, built on first iterate */
 } rtka_pagerank_t;
 
 /* Graph creation */
 rtka_graph_sparse_t* rtka_graph_create_sparse(uint32_t vertices);
+/* From edge lists (weights may be NULL): rows sorted by target, repeated
+ * edges keep the first weight, NULL for an out-of-range vertex. Built on
+ * pool (NULL = rtka_pool_default()); create_csr uses the default pool. */
+rtka_graph_sparse_t* rtka_graph_build_csr(uint32_t vertices, uint32_t edges,
+                                          const uint32_t* from, const uint32_t* to,
+                                          const rtka_state_t* weights, rtka_thread_pool_t* pool);
+rtka_graph_sparse_t* rtka_graph_create_csr(uint32_t vertices, uint32_t edges,
+                                           const uint32_t* from, const uint32_t* to,
+                                           const rtka_state_t* weights);
+/* O(V + E) insertion keeping the row sorted; an existing edge only has its
+ * weight replaced */
 void rtka_graph_add_edge_weighted(rtka_graph_sparse_t* graph, 
                                   uint32_t from, uint32_t to, 
                                   rtka_state_t weight);
 void rtka_graph_free_sparse(rtka_graph_sparse_t* graph);
 
-/* Ternary PageRank - confidence flows through graph */
+/* Binary graph file. load maps it privately: no parsing, pages are read on
+ * first touch and writes stay in memory. Vertex states are not stored. */
+RTKA_NODISCARD rtka_error_t rtka_graph_save(const rtka_graph_sparse_t* graph, const char* path);
+RTKA_NODISCARD rtka_error_t rtka_graph_load(rtka_graph_sparse_t** graph, const char* path);
+
+/* Ternary PageRank - confidence flows through graph. Each vertex takes the
+ * OR of its in-neighbours' rank confidences and the sum of their importance,
+ * both divided by the neighbour's out-degree, then damps and quantizes. */
 rtka_pagerank_t* rtka_pagerank_init(rtka_graph_sparse_t* graph);
 void rtka_pagerank_iterate(rtka_pagerank_t* pr, rtka_graph_sparse_t* graph);
 bool rtka_pagerank_converged(rtka_pagerank_t* pr);
+void rtka_pagerank_free(rtka_pagerank_t* pr);
 
-/* Markov chain operations with ternary states */
+/* Gather kernel of the pull sweep (scalar or AVX2) */
+rtka_simd_level_t rtka_pagerank_kernel(void);
+bool rtka_pagerank_set_kernel(rtka_simd_level_t level);
+
+/* Markov chain operations with ternary states. A step ORs, for every state,
+ * current[i] AND weight over its sources, then damps and quantizes; states
+ * are independent rows, split by transition count over the thread pool.
+ * steady_state returns size malloc'd states. */
 rtka_transition_matrix_t* rtka_markov_from_graph(rtka_graph_sparse_t* graph);
+void rtka_markov_free(rtka_transition_matrix_t* tm);
 rtka_state_t* rtka_markov_steady_state(rtka_transition_matrix_t* tm);
-void rtka_markov_step(rtka_state_t* current, rtka_transition_matrix_t* tm, rtka_state_t* next);
+void rtka_markov_step(const rtka_state_t* current, const rtka_transition_matrix_t* tm, rtka_state_t* next);
+/* steps steps of vectors distributions at once, in place: states[i * vectors
+ * + v] is state i of distribution v, so each transition is read once per
+ * step for all of them. Scratch of the same size; pool NULL = default. */
+RTKA_NODISCARD rtka_error_t rtka_markov_propagate(const rtka_transition_matrix_t* tm, rtka_state_t* states,
+                                                  uint32_t vectors, uint32_t steps, rtka_thread_pool_t* pool);
+
+/* Level-synchronous traversal over the CSR graph on the thread pool.
+ * Holds the in-edge transpose and frontier bitmaps, built on first use and
+ * rebuilt when the graph's size changes; keep one across traversals of
+ * the same graph. */
+#define RTKA_GRAPH_UNREACHED UINT32_MAX
+
+typedef struct rtka_traversal_work rtka_traversal_work_t;
 
-/* Confidence propagation - recursive like belief propagation */
+typedef struct {
+    rtka_thread_pool_t* pool;          /* NULL = rtka_pool_default() */
+    uint32_t levels;                   /* Deepest level of the last BFS */
+    uint32_t bottom_up_levels;         /* Of those, pulled over in-edges */
+    rtka_traversal_work_t* work;
+} rtka_graph_traversal_t;
+
+rtka_graph_traversal_t* rtka_graph_traversal_init(rtka_thread_pool_t* pool);
+void rtka_graph_traversal_free(rtka_graph_traversal_t* t);
+
+/* Direction-optimizing BFS: depth[v] is the level of v, or
+ * RTKA_GRAPH_UNREACHED past max_depth (RTKA_GRAPH_UNREACHED = no limit) */
+RTKA_NODISCARD rtka_error_t rtka_graph_bfs(rtka_graph_traversal_t* t, const rtka_graph_sparse_t* graph,
+                                           uint32_t source, uint32_t max_depth, uint32_t* depth);
+
+/* Delta-stepping shortest paths over non-negative edge lengths (NULL = all
+ * 1), buckets of width delta (<= 0: the mean finite length); dist[v] is
+ * INFINITY when unreached */
+RTKA_NODISCARD rtka_error_t rtka_graph_sssp(rtka_graph_traversal_t* t, const rtka_graph_sparse_t* graph,
+                                            uint32_t source, const float* lengths, float delta, float* dist);
+
+/* Confidence propagation - level by level like belief propagation: a
+ * vertex first reached at level d ORs in AND(parent, edge) * 0.9^d over
+ * all its parents at level d - 1 */
 void rtka_propagate_confidence(rtka_graph_sparse_t* graph, 
                               uint32_t source,
                               uint32_t max_depth);
@@ -75,11 +192,21 @@ typedef struct {
 rtka_random_walk_t* rtka_random_walk_init(rtka_graph_sparse_t* graph, uint32_t start);
 uint32_t rtka_random_walk_step(rtka_random_walk_t* walk, rtka_graph_sparse_t* graph);
 
-/* Graph algorithms with ternary logic */
+/* Graph algorithms with ternary logic, n malloc'd states: (TRUE, c) when
+ * reached, (UNKNOWN, 0) otherwise. BFS: c = 0.9^depth. Dijkstra: c is the
+ * largest product of 0.9 * edge confidence along a path. */
 rtka_state_t* rtka_graph_bfs_ternary(rtka_graph_sparse_t* graph, uint32_t start);
 rtka_state_t* rtka_graph_dijkstra_ternary(rtka_graph_sparse_t* graph, uint32_t start);
 
-/* Community detection with ternary states */
+/* Parallel Louvain on the undirected graph w(u, v) = conf(u -> v) +
+ * conf(v -> u), FALSE edges dropped (1 per edge without weights): local
+ * moving and contraction on pool (NULL = default). community[v] numbered
+ * from 0; modularity may be NULL. With more than one participant, moves
+ * race and the partition can differ between runs. */
+RTKA_NODISCARD rtka_error_t rtka_graph_louvain(const rtka_graph_sparse_t* graph, rtka_thread_pool_t* pool,
+                                               uint32_t* community, double* modularity);
+
+/* Community detection with ternary states: n malloc'd community ids */
 uint32_t* rtka_graph_louvain_ternary(rtka_graph_sparse_t* graph);
 
 /* Centrality measures */
@@ -90,7 +217,17 @@ rtka_confidence_t* rtka_graph_eigenvector_centrality(rtka_graph_sparse_t* graph)
 /* Graph coloring with ternary constraints */
 rtka_value_t* rtka_graph_color(rtka_graph_sparse_t* graph, uint32_t max_colors);
 
-/* Maximum flow with ternary capacities */
+/* Highest-label push-relabel on a CSR residual graph, global relabeling on
+ * pool (NULL = default) and the gap heuristic. capacities per out-edge
+ * (NULL = edge confidences, 1 without weights); source_side (may be NULL)
+ * marks the source side of a minimum cut. */
+RTKA_NODISCARD rtka_error_t rtka_graph_max_flow_value(const rtka_graph_sparse_t* graph, uint32_t source,
+                                                      uint32_t sink, const float* capacities,
+                                                      rtka_thread_pool_t* pool, double* value,
+                                                      uint8_t* source_side);
+
+/* Maximum flow with ternary capacities: TRUE with the share of the source's
+ * out-capacity that arrives, FALSE (1.0) when none does */
 rtka_state_t rtka_graph_max_flow(rtka_graph_sparse_t* graph, uint32_t source, uint32_t sink);
 
 #endif /* RTKA_GRAPH_H */
@@ -11,81 +11,179 @@
  *   - Xavier weight initialization
  *   - Batch sequence processing
  *   - Memory-efficient state management
+ * v1.0.1 - Gate and output projections through rtka_tensor_linear
+ *   (blocked SIMD GEMM) instead of the per-element helper
+ * v1.0.2 - Cell update through the tensor _into / _inplace ops, reusing
+ *   the gate buffers: two fewer allocations and passes per timestep
+ * v1.0.3 - Timesteps read and written through strided views of the
+ *   sequence tensors, concat filled by view copies
+ * v1.1.0 - Checkpointed BPTT: forward saves (h, c) every K timesteps,
+ *   backward recomputes one K-step segment at a time from its checkpoint
+ *   leaving ceil(T / K) + K timesteps live instead of T
+ * v1.2.0 - Fused cell: gate weights packed as one (4H, I + H) matrix, the
+ *   gate nodes views into it; one GEMM yields all four gates batch-major,
+ *   one pointwise pass the activations, c_next and h_next
+ * v1.3.0 - rtka_lstm_create_from builds the layer over given packed
+ *   tensors (a model file mapping); create is create_from + reset
+ * v1.3.1 - rtka_lstm_cell_step: the fused cell in place on float rows
  */
 
 #include "rtka_lstm.h"
 #include "rtka_memory.h"
+#include "rtka_gemm.h"
+#include "rtka_random.h"
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 
-/* Xavier/Glorot initialization for LSTM weights */
+/* Xavier/Glorot initialization for LSTM weights, in logical element order
+ * whatever the strides */
 static void init_xavier(rtka_tensor_t* tensor, uint32_t fan_in, uint32_t fan_out) {
     rtka_confidence_t limit = sqrtf(6.0f / (fan_in + fan_out));
     
-    for (uint32_t i = 0; i < tensor->size; i++) {
-        /* Uniform distribution in [-limit, limit] */
-        rtka_confidence_t value = ((rtka_confidence_t)rand() / RAND_MAX) * 2.0f * limit - limit;
-        tensor->data[i].value = (value > 0.0f) ? RTKA_TRUE : 
-                               (value < 0.0f) ? RTKA_FALSE : RTKA_UNKNOWN;
-        tensor->data[i].confidence = fabsf(value);
+    float u[256];
+    
+    for (uint32_t base = 0; base < tensor->size; base += 256U) {
+        uint32_t n = tensor->size - base < 256U ? tensor->size - base : 256U;
+        rtka_random_fill_float(rtka_random_thread(), u, n);
+        for (uint32_t i = 0; i < n; i++) {
+            /* Uniform distribution in [-limit, limit) */
+            rtka_confidence_t value = u[i] * 2.0f * limit - limit;
+            rtka_state_t* s = &tensor->data[rtka_tensor_offset(tensor, base + i)];
+            s->value = (value > 0.0f) ? RTKA_TRUE : 
+                       (value < 0.0f) ? RTKA_FALSE : RTKA_UNKNOWN;
+            s->confidence = fabsf(value);
+        }
     }
 }
 
-/* Initialize gate parameters */
-static bool init_gate(rtka_lstm_gate_t* gate, uint32_t input_dim, uint32_t output_dim) {
+/* Strides and the contiguous flag of dst follow layout, so dst->data[i] and
+ * layout->data[i] are the same logical element (optimizers walk both flat) */
+static void match_layout(rtka_tensor_t* dst, const rtka_tensor_t* layout) {
+    memcpy(dst->strides, layout->strides, sizeof(dst->strides));
+    dst->flags = (dst->flags & ~RTKA_TENSOR_CONTIGUOUS) | (layout->flags & RTKA_TENSOR_CONTIGUOUS);
+}
+
+/* Heap header over packed storage starting at offset; freeing it frees only
+ * the header, the layer frees the packed tensor */
+static rtka_tensor_t* packed_view(const rtka_tensor_t* packed, uint32_t offset,
+                                  const uint32_t* shape, const uint32_t* strides, uint32_t ndim) {
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    rtka_tensor_t* view = (rtka_tensor_t*)heap->alloc(sizeof(rtka_tensor_t), heap->context);
+    if (!view) return NULL;
+    
+    *view = *packed;
+    view->data = packed->data + offset;
+    view->ndim = ndim;
+    view->size = 1;
+    bool contiguous = true;
+    uint32_t expected = 1;
+    for (int32_t d = (int32_t)ndim - 1; d >= 0; d--) {
+        view->shape[d] = shape[d];
+        view->strides[d] = strides[d];
+        view->size *= shape[d];
+        contiguous = contiguous && (shape[d] == 1 || strides[d] == expected);
+        expected *= shape[d];
+    }
+    view->flags = contiguous ? (packed->flags | RTKA_TENSOR_CONTIGUOUS)
+                             : (packed->flags & ~RTKA_TENSOR_CONTIGUOUS);
+    view->allocator = heap;
+    return view;
+}
+
+/* Gate g's (I + H, H) weight is the transpose of rows [gH, (g + 1)H) of the
+ * packed (4H, I + H) matrix, its bias entries [gH, (g + 1)H) of the packed
+ * bias; the gradients get the same memory order. Values are left as the
+ * packed storage holds them. */
+static bool init_gate(rtka_lstm_layer_t* lstm, rtka_lstm_gate_t* gate, uint32_t g, bool requires_grad) {
+    uint32_t input_dim = lstm->input_size + lstm->hidden_size;
+    uint32_t output_dim = lstm->hidden_size;
+    
     uint32_t weight_shape[] = {input_dim, output_dim};
-    rtka_tensor_t* weight_data = rtka_tensor_create(weight_shape, 2);
+    uint32_t weight_strides[] = {1, input_dim};
+    rtka_tensor_t* weight_data = packed_view(lstm->weight_packed, g * output_dim * input_dim,
+                                             weight_shape, weight_strides, 2);
     if (!weight_data) return false;
     
-    gate->weight = rtka_grad_node_create(weight_data, true);
+    gate->weight = rtka_grad_node_create(weight_data, requires_grad);
     if (!gate->weight) {
         rtka_tensor_free(weight_data);
         return false;
     }
+    if (gate->weight->grad) match_layout(gate->weight->grad, weight_data);
     
-    /* Initialize weights */
-    init_xavier(weight_data, input_dim, output_dim);
-    
-    /* Create and initialize bias */
     uint32_t bias_shape[] = {output_dim};
-    rtka_tensor_t* bias_data = rtka_tensor_create(bias_shape, 1);
+    uint32_t bias_strides[] = {1};
+    rtka_tensor_t* bias_data = packed_view(lstm->bias_packed, g * output_dim, bias_shape, bias_strides, 1);
     if (!bias_data) {
         rtka_grad_node_free(gate->weight);
+        gate->weight = NULL;
         return false;
     }
     
-    gate->bias = rtka_grad_node_create(bias_data, true);
+    gate->bias = rtka_grad_node_create(bias_data, requires_grad);
     if (!gate->bias) {
         rtka_tensor_free(bias_data);
         rtka_grad_node_free(gate->weight);
+        gate->weight = NULL;
         return false;
     }
     
-    /* Initialize bias to zero for forget gate, others near zero */
-    memset(bias_data->data, 0, bias_data->size * sizeof(rtka_state_t));
-    
     return true;
 }
 
 rtka_lstm_layer_t* rtka_lstm_create(uint32_t input_size, 
                                     uint32_t hidden_size,
                                     bool batch_first) {
+    /* Packed gate parameters, gates in i, f, g, o order */
+    uint32_t weight_shape[] = {4 * hidden_size, input_size + hidden_size};
+    uint32_t bias_shape[] = {4 * hidden_size};
+    rtka_tensor_t* weight_packed = rtka_tensor_create_in(rtka_heap_allocator(), weight_shape, 2);
+    rtka_tensor_t* bias_packed = rtka_tensor_create_in(rtka_heap_allocator(), bias_shape, 1);
+    
+    rtka_lstm_layer_t* lstm = rtka_lstm_create_from(input_size, hidden_size, batch_first,
+                                                    weight_packed, bias_packed, true);
+    if (lstm) rtka_lstm_reset_parameters(lstm);
+    return lstm;
+}
+
+rtka_lstm_layer_t* rtka_lstm_create_from(uint32_t input_size,
+                                         uint32_t hidden_size,
+                                         bool batch_first,
+                                         rtka_tensor_t* weight_packed,
+                                         rtka_tensor_t* bias_packed,
+                                         bool requires_grad) {
     rtka_lstm_layer_t* lstm = (rtka_lstm_layer_t*)calloc(1, sizeof(rtka_lstm_layer_t));
-    if (!lstm) return NULL;
+    if (!lstm) {
+        rtka_tensor_free(weight_packed);
+        rtka_tensor_free(bias_packed);
+        return NULL;
+    }
     
     lstm->input_size = input_size;
     lstm->hidden_size = hidden_size;
     lstm->batch_first = batch_first;
     lstm->initialized = false;
-    
-    uint32_t combined_size = input_size + hidden_size;
+    lstm->weight_packed = weight_packed;
+    lstm->bias_packed = bias_packed;
+    
+    /* The gates are views, so the storage must be contiguous AoS */
+    bool packed = weight_packed && bias_packed && weight_packed->data && bias_packed->data &&
+                  (weight_packed->flags & bias_packed->flags & RTKA_TENSOR_CONTIGUOUS) &&
+                  weight_packed->ndim == 2 && weight_packed->shape[0] == 4 * hidden_size &&
+                  weight_packed->shape[1] == input_size + hidden_size &&
+                  bias_packed->ndim == 1 && bias_packed->shape[0] == 4 * hidden_size;
+    if (!packed) {
+        rtka_lstm_free(lstm);
+        return NULL;
+    }
     
     /* Initialize all gates */
-    if (!init_gate(&lstm->gate_i, combined_size, hidden_size) ||
-        !init_gate(&lstm->gate_f, combined_size, hidden_size) ||
-        !init_gate(&lstm->gate_g, combined_size, hidden_size) ||
-        !init_gate(&lstm->gate_o, combined_size, hidden_size)) {
+    if (!init_gate(lstm, &lstm->gate_i, 0, requires_grad) ||
+        !init_gate(lstm, &lstm->gate_f, 1, requires_grad) ||
+        !init_gate(lstm, &lstm->gate_g, 2, requires_grad) ||
+        !init_gate(lstm, &lstm->gate_o, 3, requires_grad)) {
         rtka_lstm_free(lstm);
         return NULL;
     }
@@ -93,6 +191,12 @@ rtka_lstm_layer_t* rtka_lstm_create(uint32_t input_size,
     lstm->h_prev = NULL;
     lstm->c_prev = NULL;
     
+    lstm->checkpoints = rtka_checkpoint_create(0);
+    if (!lstm->checkpoints) {
+        rtka_lstm_free(lstm);
+        return NULL;
+    }
+    
     return lstm;
 }
 
@@ -106,10 +210,10 @@ bool rtka_lstm_init_hidden(rtka_lstm_layer_t* lstm, uint32_t batch_size) {
     /* Create new hidden and cell states initialized to zero */
     uint32_t shape[] = {batch_size, lstm->hidden_size};
     
-    lstm->h_prev = rtka_tensor_create(shape, 2);
+    lstm->h_prev = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
     if (!lstm->h_prev) return false;
     
-    lstm->c_prev = rtka_tensor_create(shape, 2);
+    lstm->c_prev = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
     if (!lstm->c_prev) {
         rtka_tensor_free(lstm->h_prev);
         lstm->h_prev = NULL;
@@ -143,121 +247,61 @@ void rtka_lstm_reset_parameters(rtka_lstm_layer_t* lstm) {
     memset(lstm->gate_o.bias->data->data, 0, hidden_size * sizeof(rtka_state_t));
 }
 
-/* Matrix-vector multiplication helper */
-static rtka_tensor_t* matmul_add_bias(rtka_tensor_t* input, 
-                                      rtka_tensor_t* weight,
-                                      rtka_tensor_t* bias) {
-    /* input: (batch, input_dim), weight: (input_dim, output_dim) */
-    if (!input || !weight) return NULL;
-    
-    uint32_t batch = input->shape[0];
-    uint32_t input_dim = input->shape[1];
-    uint32_t output_dim = weight->shape[1];
-    
-    uint32_t out_shape[] = {batch, output_dim};
-    rtka_tensor_t* output = rtka_tensor_create(out_shape, 2);
-    if (!output) return NULL;
-    
-    /* Perform matrix multiplication */
-    for (uint32_t b = 0; b < batch; b++) {
-        for (uint32_t j = 0; j < output_dim; j++) {
-            rtka_confidence_t sum = 0.0f;
-            
-            for (uint32_t i = 0; i < input_dim; i++) {
-                uint32_t in_idx[] = {b, i};
-                uint32_t w_idx[] = {i, j};
-                
-                rtka_state_t* in_val = rtka_tensor_get(input, in_idx);
-                rtka_state_t* w_val = rtka_tensor_get(weight, w_idx);
-                
-                sum += in_val->confidence * w_val->confidence * 
-                       (rtka_confidence_t)in_val->value * (rtka_confidence_t)w_val->value;
-            }
-            
-            /* Add bias if provided */
-            if (bias) {
-                uint32_t b_idx[] = {j};
-                rtka_state_t* b_val = rtka_tensor_get(bias, b_idx);
-                sum += b_val->confidence * (rtka_confidence_t)b_val->value;
-            }
-            
-            uint32_t out_idx[] = {b, j};
-            rtka_tensor_set(output, out_idx, rtka_make_state(
-                sum > 0.0f ? RTKA_TRUE : sum < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN,
-                fabsf(sum)
-            ));
-        }
-    }
-    
-    return output;
+/* Gate activation as the cell stores it on the signed plane: sigmoid
+ * above 0.5 is TRUE, below it UNKNOWN, which reads as 0 */
+static float gate_value(float z) {
+    return z > 0.0f ? rtka_lstm_sigmoid(z) : 0.0f;
 }
 
-/* Element-wise sigmoid application */
-static void apply_sigmoid_inplace(rtka_tensor_t* tensor) {
-    for (uint32_t i = 0; i < tensor->size; i++) {
-        rtka_confidence_t val = tensor->data[i].confidence * 
-                               (rtka_confidence_t)tensor->data[i].value;
-        rtka_confidence_t result = rtka_lstm_sigmoid(val);
-        
-        tensor->data[i] = rtka_make_state(
-            result > 0.5f ? RTKA_TRUE : RTKA_UNKNOWN,
-            result
-        );
-    }
+static float gate_slope(float z) {
+    if (z <= 0.0f) return 0.0f;
+    float s = rtka_lstm_sigmoid(z);
+    return s * (1.0f - s);
 }
 
-/* Element-wise tanh application */
-static void apply_tanh_inplace(rtka_tensor_t* tensor) {
-    for (uint32_t i = 0; i < tensor->size; i++) {
-        rtka_confidence_t val = tensor->data[i].confidence * 
-                               (rtka_confidence_t)tensor->data[i].value;
-        rtka_confidence_t result = rtka_lstm_tanh(val);
-        
-        tensor->data[i] = rtka_make_state(
-            result > 0.0f ? RTKA_TRUE : result < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN,
-            fabsf(result)
-        );
-    }
+static rtka_state_t signed_state(float s) {
+    return rtka_make_state(s > 0.0f ? RTKA_TRUE : s < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN, fabsf(s));
 }
 
-/* Element-wise multiplication */
-static rtka_tensor_t* elemwise_mul(rtka_tensor_t* a, rtka_tensor_t* b) {
-    if (!a || !b || a->size != b->size) return NULL;
-    
-    rtka_tensor_t* result = rtka_tensor_create(a->shape, a->ndim);
-    if (!result) return NULL;
-    
-    for (uint32_t i = 0; i < a->size; i++) {
-        rtka_confidence_t val = (a->data[i].confidence * (rtka_confidence_t)a->data[i].value) *
-                               (b->data[i].confidence * (rtka_confidence_t)b->data[i].value);
-        
-        result->data[i] = rtka_make_state(
-            val > 0.0f ? RTKA_TRUE : val < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN,
-            fabsf(val)
-        );
+/* Signed plane of a 2-D (rows, cols) tensor of any strides into rows of ld floats */
+static void load_signed_rows(float* dst, uint32_t ld, const rtka_tensor_t* src,
+                             uint32_t rows, uint32_t cols) {
+    for (uint32_t r = 0; r < rows; r++) {
+        for (uint32_t c = 0; c < cols; c++) {
+            rtka_state_t s = rtka_tensor_load(src, r * src->strides[0] + c * src->strides[1]);
+            dst[(size_t)r * ld + c] = s.confidence * (rtka_confidence_t)s.value;
+        }
     }
-    
-    return result;
 }
 
-/* Element-wise addition */
-static rtka_tensor_t* elemwise_add(rtka_tensor_t* a, rtka_tensor_t* b) {
-    if (!a || !b || a->size != b->size) return NULL;
-    
-    rtka_tensor_t* result = rtka_tensor_create(a->shape, a->ndim);
-    if (!result) return NULL;
-    
-    for (uint32_t i = 0; i < a->size; i++) {
-        rtka_confidence_t val = (a->data[i].confidence * (rtka_confidence_t)a->data[i].value) +
-                               (b->data[i].confidence * (rtka_confidence_t)b->data[i].value);
+/* z (batch, 4H) = [x, h] W^T - all four gates from one GEMM over the packed
+ * weights, batch-major with the gates side by side in each row */
+static void gate_gemm(const rtka_lstm_layer_t* lstm, const float* concat, uint32_t batch, float* z) {
+    uint32_t d = lstm->input_size + lstm->hidden_size;
+    uint32_t n = 4 * lstm->hidden_size;
+    rtka_gemm_operand_t x = { concat, d, 1, RTKA_GEMM_F32, NULL };
+    rtka_gemm_operand_t w = { lstm->weight_packed->data, 1, d, RTKA_GEMM_SIGNED, NULL };
+    rtka_gemm(batch, n, d, &x, &w, z, n, false);
+}
+
+/* One batch row: adds the bias into the i | f | g | o pre-activations of z,
+ * then the activations, c = f c_prev + i g and h = o tanh(c) in one pass */
+static void cell_pointwise(const rtka_state_t* bias, uint32_t hidden, float* z,
+                           const float* c_prev, float* c, float* h) {
+    float* zi = z;
+    float* zf = z + hidden;
+    float* zg = z + 2 * hidden;
+    float* zo = z + 3 * hidden;
+    
+    for (uint32_t j = 0; j < hidden; j++) {
+        zi[j] += bias[j].confidence * (rtka_confidence_t)bias[j].value;
+        zf[j] += bias[hidden + j].confidence * (rtka_confidence_t)bias[hidden + j].value;
+        zg[j] += bias[2 * hidden + j].confidence * (rtka_confidence_t)bias[2 * hidden + j].value;
+        zo[j] += bias[3 * hidden + j].confidence * (rtka_confidence_t)bias[3 * hidden + j].value;
         
-        result->data[i] = rtka_make_state(
-            val > 0.0f ? RTKA_TRUE : val < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN,
-            fabsf(val)
-        );
+        c[j] = gate_value(zf[j]) * c_prev[j] + gate_value(zi[j]) * rtka_lstm_tanh(zg[j]);
+        h[j] = gate_value(zo[j]) * rtka_lstm_tanh(c[j]);
     }
-    
-    return result;
 }
 
 bool rtka_lstm_cell_forward(rtka_lstm_layer_t* lstm,
@@ -267,91 +311,112 @@ bool rtka_lstm_cell_forward(rtka_lstm_layer_t* lstm,
                             rtka_tensor_t** h_next,
                             rtka_tensor_t** c_next) {
     if (!lstm || !x_t || !h_t || !c_t) return false;
+    if (x_t->ndim != 2 || h_t->ndim != 2 || c_t->ndim != 2) return false;
     
-    /* Concatenate input and hidden state */
     uint32_t batch = x_t->shape[0];
-    uint32_t concat_shape[] = {batch, lstm->input_size + lstm->hidden_size};
-    rtka_tensor_t* concat = rtka_tensor_create(concat_shape, 2);
+    uint32_t in = lstm->input_size, hidden = lstm->hidden_size, d = in + hidden;
+    
+    /* Scratch: [x, h] rows, the (batch, 4H) gate block, c_prev, one c / h row */
+    size_t floats = (size_t)batch * (d + 5 * (size_t)hidden) + 2 * (size_t)hidden;
+    rtka_allocator_t* owner = NULL;
+    float* concat = (float*)rtka_allocator_alloc(NULL, floats * sizeof(float), &owner);
     if (!concat) return false;
+    float* z = concat + (size_t)batch * d;
+    float* c_prev = z + (size_t)batch * 4 * hidden;
+    float* c = c_prev + (size_t)batch * hidden;
+    float* h = c + hidden;
+    
+    *h_next = rtka_tensor_create(h_t->shape, 2);
+    *c_next = rtka_tensor_create(c_t->shape, 2);
+    if (!*h_next || !*c_next) {
+        rtka_tensor_free(*h_next);
+        rtka_tensor_free(*c_next);
+        *h_next = *c_next = NULL;
+        rtka_allocator_free(owner, concat);
+        return false;
+    }
+    
+    load_signed_rows(concat, d, x_t, batch, in);
+    load_signed_rows(concat + in, d, h_t, batch, hidden);
+    load_signed_rows(c_prev, hidden, c_t, batch, hidden);
+    gate_gemm(lstm, concat, batch, z);
     
-    /* Copy x_t and h_t into concatenated tensor */
     for (uint32_t b = 0; b < batch; b++) {
-        for (uint32_t i = 0; i < lstm->input_size; i++) {
-            uint32_t src_idx[] = {b, i};
-            uint32_t dst_idx[] = {b, i};
-            rtka_tensor_set(concat, dst_idx, *rtka_tensor_get(x_t, src_idx));
-        }
-        for (uint32_t i = 0; i < lstm->hidden_size; i++) {
-            uint32_t src_idx[] = {b, i};
-            uint32_t dst_idx[] = {b, lstm->input_size + i};
-            rtka_tensor_set(concat, dst_idx, *rtka_tensor_get(h_t, src_idx));
+        cell_pointwise(lstm->bias_packed->data, hidden, z + (size_t)b * 4 * hidden,
+                       c_prev + (size_t)b * hidden, c, h);
+        
+        rtka_state_t* c_row = (*c_next)->data + (size_t)b * hidden;
+        rtka_state_t* h_row = (*h_next)->data + (size_t)b * hidden;
+        for (uint32_t j = 0; j < hidden; j++) {
+            c_row[j] = signed_state(c[j]);
+            h_row[j] = signed_state(h[j]);
         }
     }
     
-    /* Compute gates */
-    rtka_tensor_t* i_t = matmul_add_bias(concat, lstm->gate_i.weight->data, 
-                                         lstm->gate_i.bias->data);
-    rtka_tensor_t* f_t = matmul_add_bias(concat, lstm->gate_f.weight->data, 
-                                         lstm->gate_f.bias->data);
-    rtka_tensor_t* g_t = matmul_add_bias(concat, lstm->gate_g.weight->data, 
-                                         lstm->gate_g.bias->data);
-    rtka_tensor_t* o_t = matmul_add_bias(concat, lstm->gate_o.weight->data, 
-                                         lstm->gate_o.bias->data);
-    
-    rtka_tensor_free(concat);
-    
-    if (!i_t || !f_t || !g_t || !o_t) {
-        if (i_t) rtka_tensor_free(i_t);
-        if (f_t) rtka_tensor_free(f_t);
-        if (g_t) rtka_tensor_free(g_t);
-        if (o_t) rtka_tensor_free(o_t);
-        return false;
-    }
+    rtka_allocator_free(owner, concat);
+    return true;
+}
+
+void rtka_lstm_cell_step(const rtka_lstm_layer_t* lstm, float* concat, uint32_t batch,
+                         float* gates, float* cell) {
+    uint32_t in = lstm->input_size, hidden = lstm->hidden_size, d = in + hidden;
     
-    /* Apply activations */
-    apply_sigmoid_inplace(i_t);  /* Input gate */
-    apply_sigmoid_inplace(f_t);  /* Forget gate */
-    apply_tanh_inplace(g_t);     /* Cell gate */
-    apply_sigmoid_inplace(o_t);  /* Output gate */
-    
-    /* Compute new cell state: c_next = f_t * c_t + i_t * g_t */
-    rtka_tensor_t* forget_term = elemwise_mul(f_t, c_t);
-    rtka_tensor_t* input_term = elemwise_mul(i_t, g_t);
-    *c_next = elemwise_add(forget_term, input_term);
-    
-    rtka_tensor_free(forget_term);
-    rtka_tensor_free(input_term);
-    rtka_tensor_free(i_t);
-    rtka_tensor_free(f_t);
-    rtka_tensor_free(g_t);
-    
-    if (!*c_next) {
-        rtka_tensor_free(o_t);
-        return false;
+    /* The GEMM has read every h_t before the first h_next lands on it */
+    gate_gemm(lstm, concat, batch, gates);
+    for (uint32_t b = 0; b < batch; b++) {
+        float* c = cell + (size_t)b * hidden;
+        cell_pointwise(lstm->bias_packed->data, hidden, gates + (size_t)b * 4 * hidden, c, c,
+                       concat + (size_t)b * d + in);
     }
-    
-    /* Compute new hidden state: h_next = o_t * tanh(c_next) */
-    rtka_tensor_t* c_next_tanh = rtka_tensor_create((*c_next)->shape, (*c_next)->ndim);
-    if (!c_next_tanh) {
-        rtka_tensor_free(*c_next);
-        rtka_tensor_free(o_t);
-        return false;
+}
+
+/* Timesteps per checkpoint segment for a sequence of seq_len */
+static uint32_t segment_length(const rtka_lstm_layer_t* lstm, uint32_t seq_len) {
+    if (seq_len == 0) return 1;
+    if (lstm->checkpoint_segment) {
+        return lstm->checkpoint_segment < seq_len ? lstm->checkpoint_segment : seq_len;
     }
     
-    memcpy(c_next_tanh->data, (*c_next)->data, (*c_next)->size * sizeof(rtka_state_t));
-    apply_tanh_inplace(c_next_tanh);
-    
-    *h_next = elemwise_mul(o_t, c_next_tanh);
-    
-    rtka_tensor_free(c_next_tanh);
-    rtka_tensor_free(o_t);
+    uint32_t k = (uint32_t)sqrtf((float)seq_len);
+    while (k * k < seq_len) k++;
+    return k ? k : 1;
+}
+
+/* (h, c) entering a segment as one heap (2, batch, hidden) node, kept off
+ * the tape: the layer owns it across steps, not the step arena */
+static bool save_checkpoint(rtka_lstm_layer_t* lstm, const rtka_tensor_t* h, const rtka_tensor_t* c) {
+    if (h->size != c->size || h->size % lstm->hidden_size != 0) return false;
+    
+    uint32_t shape[] = {2, h->size / lstm->hidden_size, lstm->hidden_size};
+    rtka_tensor_t* state = rtka_tensor_create_in(rtka_heap_allocator(), shape, 3);
+    if (!state) return false;
+    
+    for (uint32_t i = 0; i < h->size; i++) {
+        state->data[i] = rtka_tensor_load(h, rtka_tensor_offset(h, i));
+        state->data[h->size + i] = rtka_tensor_load(c, rtka_tensor_offset(c, i));
+    }
     
-    if (!*h_next) {
-        rtka_tensor_free(*c_next);
+    rtka_grad_tape_t* tape = rtka_current_tape;
+    rtka_current_tape = NULL;
+    rtka_grad_node_t* node = rtka_grad_node_create(state, false);
+    rtka_current_tape = tape;
+    if (!node) {
+        rtka_tensor_free(state);
         return false;
     }
     
-    return true;
+    uint32_t saved = lstm->checkpoints->checkpoint_count;
+    rtka_checkpoint_save(lstm->checkpoints, node);
+    return lstm->checkpoints->checkpoint_count > saved;
+}
+
+/* (batch, 1, dim) timestep slice as a 2-D (batch, dim) header */
+static rtka_tensor_t step_view(const rtka_tensor_view_t* view) {
+    rtka_tensor_view_t step = *view;
+    step.shape[1] = view->shape[2];
+    step.strides[1] = view->strides[2];
+    step.ndim = 2;
+    return rtka_tensor_view_as_tensor(&step);
 }
 
 rtka_lstm_output_t rtka_lstm_forward(rtka_lstm_layer_t* lstm,
@@ -381,45 +446,37 @@ rtka_lstm_output_t rtka_lstm_forward(rtka_lstm_layer_t* lstm,
     rtka_tensor_t* output_seq = rtka_tensor_create(out_shape, 3);
     if (!output_seq) return result;
     
-    /* Process sequence */
+    /* Checkpoints of this sequence replace the previous forward's */
+    rtka_checkpoint_clear(lstm->checkpoints);
+    lstm->checkpoints->checkpoint_interval = segment_length(lstm, seq_len);
+    lstm->checkpoint_seq_len = 0;
+    
+    /* Process sequence - timestep t of input and output are (batch, dim)
+     * views with row stride seq_len * dim, no copies */
     for (uint32_t t = 0; t < seq_len; t++) {
-        /* Extract timestep t */
-        uint32_t x_t_shape[] = {batch, lstm->input_size};
-        rtka_tensor_t* x_t = rtka_tensor_create(x_t_shape, 2);
-        if (!x_t) {
+        if (rtka_checkpoint_due(lstm->checkpoints, t) && !save_checkpoint(lstm, h_t, c_t)) {
             rtka_tensor_free(output_seq);
             return result;
         }
         
-        for (uint32_t b = 0; b < batch; b++) {
-            for (uint32_t i = 0; i < lstm->input_size; i++) {
-                uint32_t src_idx[] = {b, t, i};
-                uint32_t dst_idx[] = {b, i};
-                rtka_tensor_set(x_t, dst_idx, *rtka_tensor_get(input_data, src_idx));
-            }
-        }
+
+        uint32_t in_start[] = {0, t, 0}, in_stop[] = {batch, t + 1, lstm->input_size};
+        uint32_t out_start[] = {0, t, 0}, out_stop[] = {batch, t + 1, lstm->hidden_size};
+        rtka_tensor_view_t in_view = rtka_tensor_slice(input_data, in_start, in_stop);
+        rtka_tensor_view_t out_view = rtka_tensor_slice(output_seq, out_start, out_stop);
+        rtka_tensor_t x_t = step_view(&in_view);
+        rtka_tensor_t y_t = step_view(&out_view);
         
         /* LSTM cell forward */
         rtka_tensor_t* h_next = NULL;
         rtka_tensor_t* c_next = NULL;
         
-        if (!rtka_lstm_cell_forward(lstm, x_t, h_t, c_t, &h_next, &c_next)) {
-            rtka_tensor_free(x_t);
+        if (!rtka_lstm_cell_forward(lstm, &x_t, h_t, c_t, &h_next, &c_next) ||
+            rtka_tensor_copy_into(&y_t, h_next) != RTKA_SUCCESS) {
             rtka_tensor_free(output_seq);
             return result;
         }
         
-        rtka_tensor_free(x_t);
-        
-        /* Copy h_next to output sequence */
-        for (uint32_t b = 0; b < batch; b++) {
-            for (uint32_t i = 0; i < lstm->hidden_size; i++) {
-                uint32_t src_idx[] = {b, i};
-                uint32_t dst_idx[] = {b, t, i};
-                rtka_tensor_set(output_seq, dst_idx, *rtka_tensor_get(h_next, src_idx));
-            }
-        }
-        
         /* Update states for next iteration */
         if (t > 0 || h_0 == NULL) {
             if (h_t != h_0 && h_t != lstm->h_prev) rtka_tensor_free(h_t);
@@ -429,24 +486,256 @@ rtka_lstm_output_t rtka_lstm_forward(rtka_lstm_layer_t* lstm,
         c_t = c_next;
     }
     
+    lstm->checkpoint_seq_len = seq_len;
+    
     /* Create gradient node for output */
     result.output = rtka_grad_node_create(output_seq, true);
     result.hidden_state = h_t;
     result.cell_state = c_t;
     
     /* Update layer's hidden states */
-    if (lstm->h_prev && lstm->h_prev != h_0) rtka_tensor_free(lstm->h_prev);
-    if (lstm->c_prev && lstm->c_prev != c_0) rtka_tensor_free(lstm->c_prev);
+    rtka_lstm_set_state(lstm, h_t, c_t);
     
-    lstm->h_prev = rtka_tensor_create(h_t->shape, h_t->ndim);
-    lstm->c_prev = rtka_tensor_create(c_t->shape, c_t->ndim);
+    return result;
+}
+
+/* Copy into heap-owned state tensors, reused while the shape holds */
+static rtka_tensor_t* store_state(rtka_tensor_t* slot, const rtka_tensor_t* src) {
+    if (slot == src) return slot;
+    
+    if (!slot || slot->size != src->size || slot->allocator != rtka_heap_allocator()) {
+        rtka_tensor_free(slot);
+        slot = rtka_tensor_create_in(rtka_heap_allocator(), src->shape, src->ndim);
+        if (!slot) return NULL;
+    }
     
-    if (lstm->h_prev && lstm->c_prev) {
-        memcpy(lstm->h_prev->data, h_t->data, h_t->size * sizeof(rtka_state_t));
-        memcpy(lstm->c_prev->data, c_t->data, c_t->size * sizeof(rtka_state_t));
+    slot->ndim = src->ndim;
+    memcpy(slot->shape, src->shape, sizeof(slot->shape));
+    memcpy(slot->strides, src->strides, sizeof(slot->strides));
+    memcpy(slot->data, src->data, src->size * sizeof(rtka_state_t));
+    return slot;
+}
+
+bool rtka_lstm_set_state(rtka_lstm_layer_t* lstm, const rtka_tensor_t* h, const rtka_tensor_t* c) {
+    if (!lstm || !h || !c) return false;
+    
+    lstm->h_prev = store_state(lstm->h_prev, h);
+    lstm->c_prev = store_state(lstm->c_prev, c);
+    return lstm->h_prev && lstm->c_prev;
+}
+
+void rtka_lstm_set_checkpoint_segment(rtka_lstm_layer_t* lstm, uint32_t segment) {
+    if (lstm) lstm->checkpoint_segment = segment;
+}
+
+/* ============================================================================
+ * BACKPROPAGATION THROUGH TIME
+ * ============================================================================ */
+
+/* One recomputed timestep - signed planes, batch rows */
+typedef struct {
+    float* concat;    /* batch x (input + hidden) */
+    float* z;         /* batch x 4H pre-activations, i | f | g | o per row */
+    float* c_prev;    /* batch x hidden */
+    float* c;
+} lstm_step_t;
+
+/* Scratch layout of one backward call, in floats */
+typedef struct {
+    size_t step;      /* One lstm_step_t */
+    size_t total;
+} lstm_scratch_t;
+
+static lstm_scratch_t scratch_layout(uint32_t batch, uint32_t segment, uint32_t input_size, uint32_t hidden) {
+    size_t bh = (size_t)batch * hidden;
+    size_t bd = (size_t)batch * (input_size + hidden);
+    size_t d = (size_t)input_size + hidden;
+    lstm_scratch_t layout;
+    layout.step = bd + 6 * bh;
+    layout.total = segment * layout.step            /* Segment cache */
+                 + 4 * d * hidden + 4 * (size_t)hidden  /* dW, db packed */
+                 + 7 * bh + bd;                         /* h, dh, dc, dz, dconcat */
+    return layout;
+}
+
+static lstm_step_t step_at(float* cache, size_t stride, uint32_t s, size_t bd, size_t bh) {
+    float* base = cache + (size_t)s * stride;
+    lstm_step_t step;
+    step.concat = base;
+    step.z = base + bd;
+    step.c_prev = base + bd + 4 * bh;
+    step.c = base + bd + 5 * bh;
+    return step;
+}
+
+static float signed_at(const rtka_tensor_t* t, uint32_t offset) {
+    rtka_state_t s = rtka_tensor_load(t, offset);
+    return s.confidence * (rtka_confidence_t)s.value;
+}
+
+size_t rtka_lstm_backward_bytes(const rtka_lstm_layer_t* lstm, uint32_t batch, uint32_t seq_len) {
+    if (!lstm || seq_len == 0) return 0;
+    
+    uint32_t segment = segment_length(lstm, seq_len);
+    size_t segments = (seq_len + segment - 1) / segment;
+    lstm_scratch_t layout = scratch_layout(batch, segment, lstm->input_size, lstm->hidden_size);
+    return segments * 2 * (size_t)batch * lstm->hidden_size * sizeof(rtka_state_t) +
+           layout.total * sizeof(float);
+}
+
+rtka_error_t rtka_lstm_backward(rtka_lstm_layer_t* lstm,
+                                const rtka_tensor_t* input,
+                                const rtka_tensor_t* grad_output,
+                                rtka_tensor_t* grad_input) {
+    if (!lstm || !input || !grad_output || input->ndim != 3 || grad_output->ndim != 3) {
+        return RTKA_ERROR_INVALID_VALUE;
     }
     
-    return result;
+    uint32_t batch = input->shape[0], seq_len = input->shape[1];
+    uint32_t in = lstm->input_size, hidden = lstm->hidden_size, d = in + hidden, n = 4 * hidden;
+    rtka_checkpoint_manager_t* mgr = lstm->checkpoints;
+    uint32_t segment = mgr->checkpoint_interval ? mgr->checkpoint_interval : 1;
+    
+    /* Only the sequence the last forward checkpointed can be replayed */
+    if (input->shape[2] != in || seq_len == 0 || seq_len != lstm->checkpoint_seq_len ||
+        mgr->checkpoint_count != (seq_len + segment - 1) / segment ||
+        mgr->checkpoints[0]->data->shape[1] != batch ||
+        grad_output->shape[0] != batch || grad_output->shape[1] != seq_len ||
+        grad_output->shape[2] != hidden) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    if (grad_input && (grad_input->ndim != 3 || grad_input->shape[0] != batch ||
+                       grad_input->shape[1] != seq_len || grad_input->shape[2] != in)) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    
+    /* Gradients must share the packed memory order to take the packed sums */
+    const rtka_lstm_gate_t* gates[4] = {&lstm->gate_i, &lstm->gate_f, &lstm->gate_g, &lstm->gate_o};
+    for (uint32_t g = 0; g < 4; g++) {
+        const rtka_tensor_t* w_grad = gates[g]->weight->grad;
+        if (!w_grad || !gates[g]->bias->grad || rtka_tensor_is_soa(w_grad) ||
+            memcmp(w_grad->strides, gates[g]->weight->data->strides, sizeof(w_grad->strides)) != 0) {
+            return RTKA_ERROR_INVALID_VALUE;
+        }
+    }
+    
+    size_t bh = (size_t)batch * hidden, bd = (size_t)batch * d;
+    lstm_scratch_t layout = scratch_layout(batch, segment, in, hidden);
+    rtka_allocator_t* owner = NULL;
+    float* block = (float*)rtka_allocator_alloc(NULL, layout.total * sizeof(float), &owner);
+    if (!block) return RTKA_ERROR_OUT_OF_MEMORY;
+    
+    float* cache = block;
+    float* dw = cache + (size_t)segment * layout.step;   /* (4H, I + H) like the weights */
+    float* db = dw + (size_t)n * d;
+    float* h = db + n;
+    float* dh = h + bh;
+    float* dc = dh + bh;
+    float* dz = dc + bh;                                 /* (batch, 4H) */
+    float* dconcat = dz + 4 * bh;
+    
+    memset(dw, 0, ((size_t)n * d + n) * sizeof(float));
+    memset(dh, 0, 2 * bh * sizeof(float));
+    
+    rtka_gemm_operand_t w_op = { lstm->weight_packed->data, d, 1, RTKA_GEMM_SIGNED, NULL };
+    
+    uint32_t segments = mgr->checkpoint_count;
+    for (int32_t seg = (int32_t)segments - 1; seg >= 0; seg--) {
+        uint32_t start = (uint32_t)seg * segment;
+        uint32_t len = seq_len - start < segment ? seq_len - start : segment;
+        const rtka_tensor_t* state = mgr->checkpoints[seg]->data;
+        
+        /* Replay the segment forward from its checkpoint */
+        for (uint32_t i = 0; i < bh; i++) h[i] = signed_at(state, i);
+        for (uint32_t s = 0; s < len; s++) {
+            uint32_t t = start + s;
+            lstm_step_t st = step_at(cache, layout.step, s, bd, bh);
+            
+            if (s == 0) {
+                for (uint32_t i = 0; i < bh; i++) st.c_prev[i] = signed_at(state, (uint32_t)bh + i);
+            } else {
+                memcpy(st.c_prev, step_at(cache, layout.step, s - 1, bd, bh).c, bh * sizeof(float));
+            }
+            
+            uint32_t x_start[] = {0, t, 0}, x_stop[] = {batch, t + 1, in};
+            rtka_tensor_view_t x_view = rtka_tensor_slice(input, x_start, x_stop);
+            rtka_tensor_t x_t = step_view(&x_view);
+            load_signed_rows(st.concat, d, &x_t, batch, in);
+            for (uint32_t b = 0; b < batch; b++) {
+                memcpy(st.concat + (size_t)b * d + in, h + (size_t)b * hidden, hidden * sizeof(float));
+            }
+            
+            gate_gemm(lstm, st.concat, batch, st.z);
+            for (uint32_t b = 0; b < batch; b++) {
+                cell_pointwise(lstm->bias_packed->data, hidden, st.z + (size_t)b * n,
+                               st.c_prev + (size_t)b * hidden, st.c + (size_t)b * hidden,
+                               h + (size_t)b * hidden);
+            }
+        }
+        
+        /* BPTT through the segment, newest timestep first */
+        for (int32_t s = (int32_t)len - 1; s >= 0; s--) {
+            uint32_t t = start + (uint32_t)s;
+            lstm_step_t st = step_at(cache, layout.step, (uint32_t)s, bd, bh);
+            
+            for (uint32_t b = 0; b < batch; b++) {
+                const float* z = st.z + (size_t)b * n;
+                float* dz_row = dz + (size_t)b * n;
+                for (uint32_t j = 0; j < hidden; j++) {
+                    size_t i = (size_t)b * hidden + j;
+                    float dh_t = dh[i] + rtka_tensor_load(grad_output,
+                        b * grad_output->strides[0] + t * grad_output->strides[1] +
+                        j * grad_output->strides[2]).confidence;
+                    
+                    float zi = z[j], zf = z[hidden + j], zg = z[2 * hidden + j], zo = z[3 * hidden + j];
+                    float gg = rtka_lstm_tanh(zg), tc = rtka_lstm_tanh(st.c[i]);
+                    
+                    float dc_t = dc[i] + dh_t * gate_value(zo) * (1.0f - tc * tc);
+                    dz_row[j] = dc_t * gg * gate_slope(zi);
+                    dz_row[hidden + j] = dc_t * st.c_prev[i] * gate_slope(zf);
+                    dz_row[2 * hidden + j] = dc_t * gate_value(zi) * (1.0f - gg * gg);
+                    dz_row[3 * hidden + j] = dh_t * tc * gate_slope(zo);
+                    dc[i] = dc_t * gate_value(zf);
+                }
+                for (uint32_t j = 0; j < n; j++) db[j] += dz_row[j];
+            }
+            
+            /* dW += dz^T [x, h] and d[x, h] = dz W, one GEMM each for all gates */
+            rtka_gemm_operand_t dz_t = { dz, 1, n, RTKA_GEMM_F32, NULL };
+            rtka_gemm_operand_t dz_op = { dz, n, 1, RTKA_GEMM_F32, NULL };
+            rtka_gemm_operand_t x_op = { st.concat, d, 1, RTKA_GEMM_F32, NULL };
+            rtka_gemm(n, d, batch, &dz_t, &x_op, dw, d, true);
+            rtka_gemm(batch, d, n, &dz_op, &w_op, dconcat, d, false);
+            
+            for (uint32_t b = 0; b < batch; b++) {
+                const float* row = dconcat + (size_t)b * d;
+                memcpy(dh + (size_t)b * hidden, row + in, hidden * sizeof(float));
+                if (!grad_input) continue;
+                for (uint32_t i = 0; i < in; i++) {
+                    uint32_t offset = b * grad_input->strides[0] + t * grad_input->strides[1] +
+                                      i * grad_input->strides[2];
+                    rtka_state_t g = rtka_tensor_load(grad_input, offset);
+                    g.confidence += row[i];
+                    rtka_tensor_store(grad_input, offset, g);
+                }
+            }
+        }
+    }
+    
+    /* Accumulate into the parameter gradients - gate g's block of the
+     * packed sums is its gradient in memory order */
+    for (uint32_t g = 0; g < 4; g++) {
+        rtka_tensor_t* w_grad = gates[g]->weight->grad;
+        rtka_tensor_t* b_grad = gates[g]->bias->grad;
+        const float* dw_g = dw + (size_t)g * hidden * d;
+        for (uint32_t i = 0; i < w_grad->size; i++) w_grad->data[i].confidence += dw_g[i];
+        for (uint32_t j = 0; j < hidden; j++) {
+            b_grad->data[rtka_tensor_offset(b_grad, j)].confidence += db[g * hidden + j];
+        }
+    }
+    
+    rtka_allocator_free(owner, block);
+    return RTKA_SUCCESS;
 }
 
 void rtka_lstm_free(rtka_lstm_layer_t* lstm) {
@@ -466,6 +755,13 @@ void rtka_lstm_free(rtka_lstm_layer_t* lstm) {
     if (lstm->h_prev) rtka_tensor_free(lstm->h_prev);
     if (lstm->c_prev) rtka_tensor_free(lstm->c_prev);
     
+    rtka_checkpoint_free(lstm->checkpoints);
+    
+    /* The gate nodes held views, the storage is the packed tensors */
+    rtka_tensor_free(lstm->weight_packed);
+    rtka_tensor_free(lstm->bias_packed);
+    if (lstm->map) munmap(lstm->map, lstm->map_length);
+    
     free(lstm);
 }
 
@@ -13,6 +13,17 @@
  *   - Batch processing support
  *   - Standard weight initialization
  *   - Integration with RTKA tensor operations
+ * v1.1.0 - Backpropagation through time with segment checkpointing
+ *   - Forward keeps (h, c) at the start of every segment only
+ *   - Backward recomputes one segment at a time, newest first
+ * v1.2.0 - Fused cell over packed gate parameters
+ *   - One (4H, I + H) GEMM per timestep, one pointwise pass for the
+ *     activations and the c / h update
+ * v1.2.1 - Gate sigmoid and tanh on the rtka_fast_* polynomials, so the
+ *   pointwise passes vectorize
+ * v1.3.0 - Layer over existing packed parameters (rtka_lstm_create_from),
+ *   used by the mapped model files of rtka_model_io.h
+ * v1.3.1 - In-place cell step on float rows (rtka_lstm_cell_step)
  */
 
 #ifndef RTKA_LSTM_H
@@ -21,12 +32,14 @@
 #include "rtka_types.h"
 #include "rtka_tensor.h"
 #include "rtka_gradient.h"
+#include "rtka_vector.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <math.h>
 
-/* LSTM gate parameters structure */
+/* LSTM gate parameters structure - views into the layer's packed tensors */
 typedef struct {
-    rtka_grad_node_t* weight;  /* (input_size + hidden_size) x hidden_size */
+    rtka_grad_node_t* weight;  /* (input_size + hidden_size) x hidden_size, strides (1, I + H) */
     rtka_grad_node_t* bias;    /* hidden_size */
 } rtka_lstm_gate_t;
 
@@ -42,10 +55,24 @@ typedef struct {
     rtka_lstm_gate_t gate_g;  /* Cell gate */
     rtka_lstm_gate_t gate_o;  /* Output gate */
     
+    /* Packed storage behind the gates: row g * H + j of weight_packed is
+     * column j of gate g's weight, gates in i, f, g, o order */
+    rtka_tensor_t* weight_packed;  /* (4 * hidden_size, input_size + hidden_size) */
+    rtka_tensor_t* bias_packed;    /* 4 * hidden_size */
+    
     /* Hidden states */
     rtka_tensor_t* h_prev;    /* Previous hidden state */
     rtka_tensor_t* c_prev;    /* Previous cell state */
     
+    /* BPTT checkpoints of the last forward: (h, c) entering each segment,
+     * one (2, batch, hidden) node per segment */
+    rtka_checkpoint_manager_t* checkpoints;
+    uint32_t checkpoint_segment;  /* Timesteps per segment, 0 = ceil(sqrt(seq_len)) */
+    uint32_t checkpoint_seq_len;  /* Sequence length the checkpoints cover */
+    
+    void* map;                    /* Loaded model file backing the packed tensors, or NULL */
+    size_t map_length;
+    
     bool initialized;
 } rtka_lstm_layer_t;
 
@@ -68,6 +95,22 @@ rtka_lstm_layer_t* rtka_lstm_create(uint32_t input_size,
                                     uint32_t hidden_size,
                                     bool batch_first);
 
+/**
+ * Create LSTM layer over existing packed parameters, left as they are
+ * 
+ * @param weight_packed (4 * hidden_size, input_size + hidden_size), contiguous AoS
+ * @param bias_packed   (4 * hidden_size), contiguous AoS
+ * @param requires_grad false for frozen (read-only mapped) parameters: no
+ *                      gradient tensors are allocated
+ * @return LSTM layer or NULL; the tensors are taken over either way
+ */
+rtka_lstm_layer_t* rtka_lstm_create_from(uint32_t input_size,
+                                         uint32_t hidden_size,
+                                         bool batch_first,
+                                         rtka_tensor_t* weight_packed,
+                                         rtka_tensor_t* bias_packed,
+                                         bool requires_grad);
+
 /**
  * Initialize LSTM hidden and cell states
  * 
@@ -116,6 +159,73 @@ bool rtka_lstm_cell_forward(rtka_lstm_layer_t* lstm,
                             rtka_tensor_t** h_next,
                             rtka_tensor_t** c_next);
 
+/**
+ * Single LSTM cell step on the signed plane (value * confidence), in place
+ * Same arithmetic as rtka_lstm_cell_forward without allocating, for
+ * streaming inference; the layer is only read.
+ * 
+ * @param lstm   LSTM layer
+ * @param concat (batch, input_size + hidden_size) rows [x_t, h_t]; the h_t
+ *               part is overwritten with h_next
+ * @param batch  Number of rows
+ * @param gates  (batch, 4 * hidden_size) scratch
+ * @param cell   (batch, hidden_size) c_t, overwritten with c_next
+ */
+void rtka_lstm_cell_step(const rtka_lstm_layer_t* lstm, float* concat, uint32_t batch,
+                         float* gates, float* cell);
+
+/**
+ * Carry h and c into the next forward pass
+ * The layer keeps heap-owned copies, so h and c may live in a step arena
+ * 
+ * @param lstm LSTM layer
+ * @param h    Hidden state to carry
+ * @param c    Cell state to carry
+ * @return true on success, false on error
+ */
+bool rtka_lstm_set_state(rtka_lstm_layer_t* lstm,
+                         const rtka_tensor_t* h,
+                         const rtka_tensor_t* c);
+
+/**
+ * Set the BPTT checkpoint segment length
+ * Backward holds ceil(T / K) checkpoints plus K timesteps of activations and
+ * recomputes every timestep once, so K = sqrt(T) (segment 0) bounds memory
+ * at O(sqrt(T)) for one extra forward. segment >= seq_len keeps everything.
+ * 
+ * @param lstm    LSTM layer
+ * @param segment Timesteps per segment, 0 for ceil(sqrt(seq_len))
+ */
+void rtka_lstm_set_checkpoint_segment(rtka_lstm_layer_t* lstm, uint32_t segment);
+
+/**
+ * Backward pass through the last rtka_lstm_forward
+ * Recomputes each segment from its checkpoint, then runs BPTT through it.
+ * Gradients are w.r.t. the signed planes (value * confidence) and
+ * accumulate into the gate weight and bias gradients.
+ * 
+ * @param lstm        LSTM layer
+ * @param input       The input sequence the forward pass was given
+ * @param grad_output dL/d output (batch, seq_len, hidden), in the confidences
+ * @param grad_input  Optional dL/d input (batch, seq_len, input), accumulated
+ * @return RTKA_SUCCESS, RTKA_ERROR_INVALID_VALUE when no forward of this
+ *         shape was checkpointed, RTKA_ERROR_OUT_OF_MEMORY
+ */
+RTKA_NODISCARD rtka_error_t rtka_lstm_backward(rtka_lstm_layer_t* lstm,
+                                               const rtka_tensor_t* input,
+                                               const rtka_tensor_t* grad_output,
+                                               rtka_tensor_t* grad_input);
+
+/**
+ * Bytes rtka_lstm_backward needs for a sequence, checkpoints included
+ * 
+ * @param lstm    LSTM layer
+ * @param batch   Batch size
+ * @param seq_len Sequence length
+ * @return Checkpoint plus scratch bytes at the current segment length
+ */
+size_t rtka_lstm_backward_bytes(const rtka_lstm_layer_t* lstm, uint32_t batch, uint32_t seq_len);
+
 /**
  * Free LSTM layer and all associated resources
  * 
@@ -136,7 +246,7 @@ uint32_t rtka_lstm_param_count(const rtka_lstm_layer_t* lstm);
  * Inline for performance
  */
 RTKA_INLINE rtka_confidence_t rtka_lstm_sigmoid(rtka_confidence_t x) {
-    return 1.0f / (1.0f + expf(-x));
+    return rtka_fast_sigmoidf(x);
 }
 
 /**
@@ -144,7 +254,7 @@ RTKA_INLINE rtka_confidence_t rtka_lstm_sigmoid(rtka_confidence_t x) {
  * Inline for performance
  */
 RTKA_INLINE rtka_confidence_t rtka_lstm_tanh(rtka_confidence_t x) {
-    return tanhf(x);
+    return rtka_fast_tanhf(x);
 }
 
 #endif /* RTKA_LSTM_H */
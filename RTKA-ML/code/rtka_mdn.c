@@ -11,10 +11,20 @@
  *   - Softmax for mixture weights
  *   - Exponential transform for sigmas
  *   - Gaussian mixture sampling
+ * v1.0.1 - Gate and output projections through rtka_tensor_linear
+ *   (blocked SIMD GEMM) instead of the per-element helper
+ * v1.0.2 - Mixture softmax on rtka_vector_softmax_f32, any mixture count
+ * v1.1.0 - rtka_mdn_create_from over given weight and bias tensors;
+ *   create is create_from + reset
+ * v1.1.1 - rtka_mdn_finish_into: bias, softmax and exp into preallocated
+ *   outputs, no allocation
  */
 
+#define _GNU_SOURCE  /* For M_PI */
 #include "rtka_mdn.h"
 #include "rtka_memory.h"
+#include "rtka_random.h"
+#include "rtka_vector.h"
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
@@ -23,11 +33,18 @@
 static void init_xavier(rtka_tensor_t* tensor, uint32_t fan_in, uint32_t fan_out) {
     rtka_confidence_t limit = sqrtf(6.0f / (fan_in + fan_out));
     
-    for (uint32_t i = 0; i < tensor->size; i++) {
-        rtka_confidence_t value = ((rtka_confidence_t)rand() / RAND_MAX) * 2.0f * limit - limit;
-        tensor->data[i].value = (value > 0.0f) ? RTKA_TRUE : 
-                               (value < 0.0f) ? RTKA_FALSE : RTKA_UNKNOWN;
-        tensor->data[i].confidence = fabsf(value);
+    float u[256];
+    
+    for (uint32_t base = 0; base < tensor->size; base += 256U) {
+        uint32_t n = tensor->size - base < 256U ? tensor->size - base : 256U;
+        rtka_random_fill_float(rtka_random_thread(), u, n);
+        for (uint32_t i = 0; i < n; i++) {
+            rtka_confidence_t value = u[i] * 2.0f * limit - limit;
+            rtka_state_t* s = &tensor->data[base + i];
+            s->value = (value > 0.0f) ? RTKA_TRUE : 
+                       (value < 0.0f) ? RTKA_FALSE : RTKA_UNKNOWN;
+            s->confidence = fabsf(value);
+        }
     }
 }
 
@@ -36,53 +53,62 @@ rtka_mdn_layer_t* rtka_mdn_create(uint32_t input_size,
                                   uint32_t num_gaussians) {
     if (input_size == 0 || output_size == 0 || num_gaussians == 0) return NULL;
     
-    rtka_mdn_layer_t* mdn = (rtka_mdn_layer_t*)calloc(1, sizeof(rtka_mdn_layer_t));
-    if (!mdn) return NULL;
-    
-    mdn->input_size = input_size;
-    mdn->output_size = output_size;
-    mdn->num_gaussians = num_gaussians;
-    mdn->initialized = false;
-    
     /* Calculate total number of output parameters */
     /* pi: K, mu: K*output_size, log_sigma: K*output_size */
     uint32_t num_params = num_gaussians * (1 + 2 * output_size);
     
     /* Create weight and bias */
     uint32_t weight_shape[] = {input_size, num_params};
-    rtka_tensor_t* weight_data = rtka_tensor_create(weight_shape, 2);
-    if (!weight_data) {
-        free(mdn);
-        return NULL;
-    }
+    uint32_t bias_shape[] = {num_params};
+    rtka_tensor_t* weight_data = rtka_tensor_create_in(rtka_heap_allocator(), weight_shape, 2);
+    rtka_tensor_t* bias_data = rtka_tensor_create_in(rtka_heap_allocator(), bias_shape, 1);
     
-    mdn->fc_weight = rtka_grad_node_create(weight_data, true);
-    if (!mdn->fc_weight) {
-        rtka_tensor_free(weight_data);
-        free(mdn);
+    rtka_mdn_layer_t* mdn = rtka_mdn_create_from(input_size, output_size, num_gaussians,
+                                                 weight_data, bias_data, true);
+    
+    /* Initialize parameters */
+    if (mdn) rtka_mdn_reset_parameters(mdn);
+    return mdn;
+}
+
+rtka_mdn_layer_t* rtka_mdn_create_from(uint32_t input_size,
+                                       uint32_t output_size,
+                                       uint32_t num_gaussians,
+                                       rtka_tensor_t* weight,
+                                       rtka_tensor_t* bias,
+                                       bool requires_grad) {
+    uint32_t num_params = num_gaussians * (1 + 2 * output_size);
+    bool shaped = input_size != 0 && output_size != 0 && num_gaussians != 0 &&
+                  weight && weight->ndim == 2 && weight->shape[0] == input_size &&
+                  weight->shape[1] == num_params && bias && bias->ndim == 1 &&
+                  bias->shape[0] == num_params;
+    rtka_mdn_layer_t* mdn = shaped ? (rtka_mdn_layer_t*)calloc(1, sizeof(rtka_mdn_layer_t)) : NULL;
+    if (!mdn) {
+        rtka_tensor_free(weight);
+        rtka_tensor_free(bias);
         return NULL;
     }
     
-    uint32_t bias_shape[] = {num_params};
-    rtka_tensor_t* bias_data = rtka_tensor_create(bias_shape, 1);
-    if (!bias_data) {
-        rtka_grad_node_free(mdn->fc_weight);
+    mdn->input_size = input_size;
+    mdn->output_size = output_size;
+    mdn->num_gaussians = num_gaussians;
+    
+    mdn->fc_weight = rtka_grad_node_create(weight, requires_grad);
+    if (!mdn->fc_weight) {
+        rtka_tensor_free(weight);
+        rtka_tensor_free(bias);
         free(mdn);
         return NULL;
     }
     
-    mdn->fc_bias = rtka_grad_node_create(bias_data, true);
+    mdn->fc_bias = rtka_grad_node_create(bias, requires_grad);
     if (!mdn->fc_bias) {
-        rtka_tensor_free(bias_data);
+        rtka_tensor_free(bias);
         rtka_grad_node_free(mdn->fc_weight);
         free(mdn);
         return NULL;
     }
     
-    /* Initialize parameters */
-    init_xavier(weight_data, input_size, num_params);
-    memset(bias_data->data, 0, bias_data->size * sizeof(rtka_state_t));
-    
     mdn->initialized = true;
     return mdn;
 }
@@ -96,87 +122,34 @@ void rtka_mdn_reset_parameters(rtka_mdn_layer_t* mdn) {
            mdn->fc_bias->data->size * sizeof(rtka_state_t));
 }
 
-/* Matrix multiplication helper */
-static rtka_tensor_t* matmul_add_bias(rtka_tensor_t* input, 
-                                      rtka_tensor_t* weight,
-                                      rtka_tensor_t* bias) {
-    if (!input || !weight) return NULL;
-    
-    uint32_t batch = input->shape[0];
-    uint32_t input_dim = input->shape[1];
-    uint32_t output_dim = weight->shape[1];
-    
-    uint32_t out_shape[] = {batch, output_dim};
-    rtka_tensor_t* output = rtka_tensor_create(out_shape, 2);
-    if (!output) return NULL;
-    
-    for (uint32_t b = 0; b < batch; b++) {
-        for (uint32_t j = 0; j < output_dim; j++) {
-            rtka_confidence_t sum = 0.0f;
-            
-            for (uint32_t i = 0; i < input_dim; i++) {
-                uint32_t in_idx[] = {b, i};
-                uint32_t w_idx[] = {i, j};
-                
-                rtka_state_t* in_val = rtka_tensor_get(input, in_idx);
-                rtka_state_t* w_val = rtka_tensor_get(weight, w_idx);
-                
-                sum += in_val->confidence * w_val->confidence * 
-                       (rtka_confidence_t)in_val->value * (rtka_confidence_t)w_val->value;
-            }
-            
-            if (bias) {
-                uint32_t b_idx[] = {j};
-                rtka_state_t* b_val = rtka_tensor_get(bias, b_idx);
-                sum += b_val->confidence * (rtka_confidence_t)b_val->value;
-            }
-            
-            uint32_t out_idx[] = {b, j};
-            rtka_tensor_set(output, out_idx, rtka_make_state(
-                sum > 0.0f ? RTKA_TRUE : sum < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN,
-                fabsf(sum)
-            ));
-        }
-    }
-    
-    return output;
-}
-
 void rtka_mdn_softmax_pi(rtka_tensor_t* pi) {
     if (!pi || pi->ndim != 2) return;
     
     uint32_t batch = pi->shape[0];
     uint32_t num_gaussians = pi->shape[1];
     
+    /* One row of logits at a time; the stack holds the usual mixtures */
+    rtka_confidence_t row[64];
+    rtka_confidence_t* logits = num_gaussians <= 64 ? row :
+        (rtka_confidence_t*)malloc(num_gaussians * sizeof(rtka_confidence_t));
+    if (!logits) return;
+    
     for (uint32_t b = 0; b < batch; b++) {
-        /* Find max for numerical stability */
-        rtka_confidence_t max_val = -INFINITY;
         for (uint32_t k = 0; k < num_gaussians; k++) {
             uint32_t idx[] = {b, k};
             rtka_state_t* val = rtka_tensor_get(pi, idx);
-            rtka_confidence_t logit = val->confidence * (rtka_confidence_t)val->value;
-            if (logit > max_val) max_val = logit;
+            logits[k] = val->confidence * (rtka_confidence_t)val->value;
         }
         
-        /* Compute exp(x - max) and sum */
-        rtka_confidence_t sum = 0.0f;
-        rtka_confidence_t exp_vals[64];  /* Assuming num_gaussians <= 64 */
-        
-        for (uint32_t k = 0; k < num_gaussians; k++) {
-            uint32_t idx[] = {b, k};
-            rtka_state_t* val = rtka_tensor_get(pi, idx);
-            rtka_confidence_t logit = val->confidence * (rtka_confidence_t)val->value;
-            exp_vals[k] = expf(logit - max_val);
-            sum += exp_vals[k];
-        }
+        rtka_vector_softmax_f32(logits, logits, num_gaussians);
         
-        /* Normalize */
         for (uint32_t k = 0; k < num_gaussians; k++) {
             uint32_t idx[] = {b, k};
-            rtka_confidence_t prob = exp_vals[k] / sum;
-            rtka_tensor_set(pi, idx, rtka_make_state(RTKA_TRUE, prob));
+            rtka_tensor_set(pi, idx, rtka_make_state(RTKA_TRUE, logits[k]));
         }
     }
+    
+    if (logits != row) free(logits);
 }
 
 rtka_tensor_t* rtka_mdn_exp_sigma(rtka_tensor_t* log_sigma) {
@@ -279,6 +252,47 @@ rtka_mdn_output_t rtka_mdn_split_params(rtka_tensor_t* params,
     return result;
 }
 
+static bool output_fits(const rtka_tensor_t* t, uint32_t size) {
+    return t && t->data && t->size == size && rtka_tensor_is_contiguous(t);
+}
+
+rtka_error_t rtka_mdn_finish_into(const rtka_mdn_layer_t* mdn, float* params,
+                                  uint32_t batch, rtka_mdn_output_t* output) {
+    if (!mdn || !params || !output) return RTKA_ERROR_NULL_POINTER;
+    
+    uint32_t K = mdn->num_gaussians;
+    uint32_t Z = mdn->output_size;
+    uint32_t num_params = K * (1 + 2 * Z);
+    if (!output_fits(output->pi, batch * K) || !output_fits(output->mu, batch * K * Z) ||
+        !output_fits(output->sigma, batch * K * Z)) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    
+    const rtka_tensor_t* bias = mdn->fc_bias->data;
+    for (uint32_t b = 0; b < batch; b++) {
+        float* row = params + (size_t)b * num_params;
+        for (uint32_t j = 0; j < num_params; j++) {
+            rtka_state_t b_val = rtka_tensor_load(bias, j * bias->strides[0]);
+            row[j] += b_val.confidence * (rtka_confidence_t)b_val.value;
+        }
+        
+        /* Row layout: K logits, K * Z means, K * Z log sigmas */
+        rtka_vector_softmax_f32(row, row, K);
+        rtka_state_t* pi = output->pi->data + (size_t)b * K;
+        for (uint32_t k = 0; k < K; k++) pi[k] = rtka_make_state(RTKA_TRUE, row[k]);
+        
+        rtka_state_t* mu = output->mu->data + (size_t)b * K * Z;
+        rtka_state_t* sigma = output->sigma->data + (size_t)b * K * Z;
+        for (uint32_t i = 0; i < K * Z; i++) {
+            float m = row[K + i];
+            mu[i] = rtka_make_state(m > 0.0f ? RTKA_TRUE : m < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN, fabsf(m));
+        }
+        const float* log_sigma = row + K + K * Z;
+        for (uint32_t i = 0; i < K * Z; i++) sigma[i] = rtka_make_state(RTKA_TRUE, expf(log_sigma[i]));
+    }
+    return RTKA_SUCCESS;
+}
+
 rtka_mdn_output_t rtka_mdn_forward(rtka_mdn_layer_t* mdn, 
                                    rtka_grad_node_t* input) {
     rtka_mdn_output_t result = {NULL, NULL, NULL};
@@ -286,9 +300,9 @@ rtka_mdn_output_t rtka_mdn_forward(rtka_mdn_layer_t* mdn,
     if (!mdn || !mdn->initialized || !input || !input->data) return result;
     
     /* Linear transformation */
-    rtka_tensor_t* params = matmul_add_bias(input->data, 
-                                            mdn->fc_weight->data,
-                                            mdn->fc_bias->data);
+    rtka_tensor_t* params = rtka_tensor_linear(input->data, 
+                                               mdn->fc_weight->data,
+                                               mdn->fc_bias->data);
     if (!params) return result;
     
     /* Split into pi, mu, sigma */
@@ -335,7 +349,8 @@ rtka_tensor_t* rtka_mdn_sample(const rtka_mdn_output_t* output, uint32_t batch_i
     uint32_t Z = output->mu->shape[2];
     
     /* Sample gaussian index according to pi */
-    rtka_confidence_t rand_val = (rtka_confidence_t)rand() / RAND_MAX;
+    rtka_rng_t* rng = rtka_random_thread();
+    rtka_confidence_t rand_val = rtka_random_uniform(rng);
     rtka_confidence_t cumsum = 0.0f;
     uint32_t selected_k = 0;
     
@@ -366,8 +381,8 @@ rtka_tensor_t* rtka_mdn_sample(const rtka_mdn_output_t* output, uint32_t batch_i
         rtka_confidence_t sigma = sigma_val->confidence;
         
         /* Box-Muller transform for normal distribution */
-        rtka_confidence_t u1 = (rtka_confidence_t)rand() / RAND_MAX;
-        rtka_confidence_t u2 = (rtka_confidence_t)rand() / RAND_MAX;
+        rtka_confidence_t u1 = 1.0f - rtka_random_uniform(rng);     /* (0, 1] for the log */
+        rtka_confidence_t u2 = rtka_random_uniform(rng);
         rtka_confidence_t z0 = sqrtf(-2.0f * logf(u1)) * cosf(2.0f * M_PI * u2);
         
         rtka_confidence_t sampled_val = mu + sigma * z0;
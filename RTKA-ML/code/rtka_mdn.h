@@ -13,6 +13,8 @@
  *   - Softmax for mixture weights
  *   - Log-sigma to sigma conversion
  *   - Integration with LSTM outputs
+ * v1.1.0 - Layer over existing parameters (rtka_mdn_create_from)
+ * v1.1.1 - Allocation-free split into preallocated outputs (rtka_mdn_finish_into)
  */
 
 #ifndef RTKA_MDN_H
@@ -62,6 +64,21 @@ rtka_mdn_layer_t* rtka_mdn_create(uint32_t input_size,
                                   uint32_t output_size,
                                   uint32_t num_gaussians);
 
+/**
+ * Create MDN layer over existing parameters, left as they are
+ * 
+ * @param weight        (input_size, num_gaussians * (1 + 2 * output_size))
+ * @param bias          (num_gaussians * (1 + 2 * output_size))
+ * @param requires_grad false for frozen (read-only mapped) parameters
+ * @return MDN layer or NULL; the tensors are taken over either way
+ */
+rtka_mdn_layer_t* rtka_mdn_create_from(uint32_t input_size,
+                                       uint32_t output_size,
+                                       uint32_t num_gaussians,
+                                       rtka_tensor_t* weight,
+                                       rtka_tensor_t* bias,
+                                       bool requires_grad);
+
 /**
  * Initialize MDN parameters with Xavier/Glorot initialization
  * 
@@ -93,6 +110,20 @@ rtka_mdn_output_t rtka_mdn_split_params(rtka_tensor_t* params,
                                         uint32_t num_gaussians,
                                         uint32_t output_size);
 
+/**
+ * Finish an MDN forward from the pre-bias sums input x fc_weight on the
+ * signed plane, into preallocated outputs; same values as rtka_mdn_forward,
+ * sigma to the last bit of expf
+ * 
+ * @param mdn    MDN layer
+ * @param params (batch, num_params) sums, overwritten
+ * @param batch  Number of rows
+ * @param output pi (batch, K), mu and sigma (batch, K, Z), contiguous AoS
+ * @return RTKA_SUCCESS, or RTKA_ERROR_INVALID_VALUE on mismatched outputs
+ */
+RTKA_NODISCARD rtka_error_t rtka_mdn_finish_into(const rtka_mdn_layer_t* mdn, float* params,
+                                                 uint32_t batch, rtka_mdn_output_t* output);
+
 /**
  * Apply softmax to mixture weights
  * Ensures pi sums to 1.0 across gaussians
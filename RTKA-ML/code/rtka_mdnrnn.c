@@ -11,11 +11,22 @@
  *   - Input concatenation (z + actions)
  *   - Sequence processing pipeline
  *   - Single-step prediction support
+ * v1.1.0 - Checkpointed LSTM backward from a caller-supplied gradient
+ *   of the LSTM output sequence; forward releases its LSTM input and
+ *   output nodes instead of leaking them
+ * v1.2.0 - rtka_mdnrnn_create_from assembles built components; free
+ *   releases a model file mapping behind them
+ * v1.3.0 - Streaming inference: one float block and three output tensors
+ *   per stream, steps through rtka_lstm_cell_step and rtka_mdn_finish_into
  */
 
+#define _GNU_SOURCE  /* For M_PI */
 #include "rtka_mdnrnn.h"
+#include "rtka_memory.h"
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 
 rtka_mdnrnn_t* rtka_mdnrnn_create(uint32_t z_size,
                                   uint32_t action_size,
@@ -23,32 +34,38 @@ rtka_mdnrnn_t* rtka_mdnrnn_create(uint32_t z_size,
                                   uint32_t num_gaussians) {
     if (z_size == 0 || hidden_size == 0 || num_gaussians == 0) return NULL;
     
-    rtka_mdnrnn_t* model = (rtka_mdnrnn_t*)calloc(1, sizeof(rtka_mdnrnn_t));
-    if (!model) return NULL;
-    
-    model->z_size = z_size;
-    model->action_size = action_size;
-    model->hidden_size = hidden_size;
-    model->num_gaussians = num_gaussians;
-    model->batch_first = true;
-    model->initialized = false;
-    
     /* Create LSTM: input is z + actions */
     uint32_t lstm_input_size = z_size + action_size;
-    model->lstm = rtka_lstm_create(lstm_input_size, hidden_size, true);
-    if (!model->lstm) {
-        free(model);
+    rtka_lstm_layer_t* lstm = rtka_lstm_create(lstm_input_size, hidden_size, true);
+    if (!lstm) return NULL;
+    
+    /* Create MDN: input is LSTM hidden output, output is z_size predictions */
+    rtka_mdn_layer_t* mdn = rtka_mdn_create(hidden_size, z_size, num_gaussians);
+    if (!mdn) {
+        rtka_lstm_free(lstm);
         return NULL;
     }
     
-    /* Create MDN: input is LSTM hidden output, output is z_size predictions */
-    model->mdn = rtka_mdn_create(hidden_size, z_size, num_gaussians);
-    if (!model->mdn) {
-        rtka_lstm_free(model->lstm);
-        free(model);
+    return rtka_mdnrnn_create_from(lstm, mdn);
+}
+
+rtka_mdnrnn_t* rtka_mdnrnn_create_from(rtka_lstm_layer_t* lstm, rtka_mdn_layer_t* mdn) {
+    bool fits = lstm && mdn && mdn->input_size == lstm->hidden_size &&
+                lstm->input_size >= mdn->output_size;
+    rtka_mdnrnn_t* model = fits ? (rtka_mdnrnn_t*)calloc(1, sizeof(rtka_mdnrnn_t)) : NULL;
+    if (!model) {
+        rtka_lstm_free(lstm);
+        rtka_mdn_free(mdn);
         return NULL;
     }
     
+    model->z_size = mdn->output_size;
+    model->action_size = lstm->input_size - mdn->output_size;
+    model->hidden_size = lstm->hidden_size;
+    model->num_gaussians = mdn->num_gaussians;
+    model->batch_first = lstm->batch_first;
+    model->lstm = lstm;
+    model->mdn = mdn;
     model->initialized = true;
     return model;
 }
@@ -141,11 +158,32 @@ rtka_mdnrnn_output_t rtka_mdnrnn_forward(rtka_mdnrnn_t* model,
     result.hidden_state = lstm_out.hidden_state;
     result.cell_state = lstm_out.cell_state;
     
-    /* Note: lstm_input and lstm_out.output are freed by caller or gradient system */
+    /* The MDN parameters are fresh tensors, and backward rebuilds the LSTM
+     * input from z and actions, so neither node outlives the pass */
+    rtka_grad_node_free(lstm_out.output);
+    rtka_grad_node_free(lstm_input);
     
     return result;
 }
 
+void rtka_mdnrnn_set_checkpoint_segment(rtka_mdnrnn_t* model, uint32_t segment) {
+    if (model) rtka_lstm_set_checkpoint_segment(model->lstm, segment);
+}
+
+rtka_error_t rtka_mdnrnn_backward(rtka_mdnrnn_t* model,
+                                  rtka_tensor_t* z,
+                                  rtka_tensor_t* actions,
+                                  const rtka_tensor_t* grad_hidden) {
+    if (!model || !model->initialized || !grad_hidden) return RTKA_ERROR_INVALID_VALUE;
+    
+    rtka_tensor_t* concat_input = concatenate_inputs(z, actions);
+    if (!concat_input) return RTKA_ERROR_INVALID_VALUE;
+    
+    rtka_error_t err = rtka_lstm_backward(model->lstm, concat_input, grad_hidden, NULL);
+    rtka_tensor_free(concat_input);
+    return err;
+}
+
 rtka_mdn_output_t rtka_mdnrnn_step(rtka_mdnrnn_t* model,
                                    rtka_tensor_t* z_t,
                                    rtka_tensor_t* a_t) {
@@ -192,14 +230,15 @@ rtka_mdn_output_t rtka_mdnrnn_step(rtka_mdnrnn_t* model,
     if (!success) return result;
     
     /* Update LSTM hidden states */
-    if (model->lstm->h_prev) rtka_tensor_free(model->lstm->h_prev);
-    if (model->lstm->c_prev) rtka_tensor_free(model->lstm->c_prev);
-    model->lstm->h_prev = h_next;
-    model->lstm->c_prev = c_next;
+    rtka_lstm_set_state(model->lstm, h_next, c_next);
+    rtka_tensor_free(c_next);
     
     /* Forward through MDN */
     rtka_grad_node_t* mdn_input = rtka_grad_node_create(h_next, false);
-    if (!mdn_input) return result;
+    if (!mdn_input) {
+        rtka_tensor_free(h_next);
+        return result;
+    }
     
     result = rtka_mdn_forward(model->mdn, mdn_input);
     
@@ -213,6 +252,7 @@ void rtka_mdnrnn_free(rtka_mdnrnn_t* model) {
     
     if (model->lstm) rtka_lstm_free(model->lstm);
     if (model->mdn) rtka_mdn_free(model->mdn);
+    if (model->map) munmap(model->map, model->map_length);
     
     free(model);
 }
@@ -243,3 +283,154 @@ rtka_tensor_t* rtka_mdnrnn_sample_next(const rtka_mdnrnn_output_t* output,
     if (!output) return NULL;
     return rtka_mdn_sample(&output->mdn_params, batch_idx);
 }
+
+/* ============================================================================
+ * STREAMING INFERENCE
+ * ============================================================================ */
+
+rtka_mdnrnn_stream_t* rtka_mdnrnn_stream_create(const rtka_mdnrnn_t* model, uint32_t batch) {
+    if (!model || !model->initialized || batch == 0) return NULL;
+    
+    rtka_mdnrnn_stream_t* stream = (rtka_mdnrnn_stream_t*)calloc(1, sizeof(rtka_mdnrnn_stream_t));
+    if (!stream) return NULL;
+    
+    uint32_t Z = model->z_size, H = model->hidden_size, K = model->num_gaussians;
+    uint32_t num_params = K * (1 + 2 * Z);
+    stream->model = model;
+    stream->batch = batch;
+    stream->row = Z + model->action_size + H;
+    
+    /* State outlives any step arena: everything comes from the heap */
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    size_t floats = (size_t)batch * (stream->row + 5 * (size_t)H + num_params);
+    stream->concat = (float*)rtka_allocator_alloc(heap, floats * sizeof(float), &stream->owner);
+    uint32_t pi_shape[] = {batch, K};
+    uint32_t mu_shape[] = {batch, K, Z};
+    stream->output.pi = rtka_tensor_create_in(heap, pi_shape, 2);
+    stream->output.mu = rtka_tensor_create_in(heap, mu_shape, 3);
+    stream->output.sigma = rtka_tensor_create_in(heap, mu_shape, 3);
+    if (!stream->concat || !stream->output.pi || !stream->output.mu || !stream->output.sigma) {
+        rtka_mdnrnn_stream_free(stream);
+        return NULL;
+    }
+    stream->gates = stream->concat + (size_t)batch * stream->row;
+    stream->cell = stream->gates + (size_t)batch * 4 * H;
+    stream->params = stream->cell + (size_t)batch * H;
+    
+    /* The per-call ternary scan of rtka_tensor_linear, done once */
+    const rtka_tensor_t* weight = model->mdn->fc_weight->data;
+    stream->mdn_weight = (rtka_gemm_operand_t){ weight->data, weight->strides[0], weight->strides[1],
+                                                RTKA_GEMM_SIGNED, NULL };
+    if (rtka_tensor_is_soa(weight)) {
+        stream->mdn_weight.data = weight->values;
+        stream->mdn_weight.confidences = weight->confidences;
+        stream->mdn_weight.format = RTKA_GEMM_PLANES;
+    } else if (rtka_tensor_is_ternary(weight)) {
+        stream->mdn_weight.format = RTKA_GEMM_TERNARY;
+    }
+    
+    rtka_mdnrnn_stream_reset(stream);
+    return stream;
+}
+
+void rtka_mdnrnn_stream_free(rtka_mdnrnn_stream_t* stream) {
+    if (!stream) return;
+    
+    rtka_mdn_output_free(&stream->output);
+    if (stream->concat) rtka_allocator_free(stream->owner, stream->concat);
+    free(stream);
+}
+
+void rtka_mdnrnn_stream_reset(rtka_mdnrnn_stream_t* stream) {
+    if (!stream) return;
+    
+    for (uint32_t b = 0; b < stream->batch; b++) rtka_mdnrnn_stream_reset_row(stream, b);
+}
+
+void rtka_mdnrnn_stream_reset_row(rtka_mdnrnn_stream_t* stream, uint32_t row) {
+    if (!stream || row >= stream->batch) return;
+    
+    uint32_t H = stream->model->hidden_size;
+    memset(stream->concat + (size_t)row * stream->row + (stream->row - H), 0, H * sizeof(float));
+    memset(stream->cell + (size_t)row * H, 0, H * sizeof(float));
+}
+
+rtka_error_t rtka_mdnrnn_stream_step(rtka_mdnrnn_stream_t* stream, const float* z,
+                                     const float* actions) {
+    if (!stream || !z) return RTKA_ERROR_NULL_POINTER;
+    
+    const rtka_mdnrnn_t* model = stream->model;
+    uint32_t Z = model->z_size, A = model->action_size, H = model->hidden_size;
+    if (A > 0 && !actions) return RTKA_ERROR_NULL_POINTER;
+    
+    for (uint32_t b = 0; b < stream->batch; b++) {
+        float* row = stream->concat + (size_t)b * stream->row;
+        memcpy(row, z + (size_t)b * Z, Z * sizeof(float));
+        if (A > 0) memcpy(row + Z, actions + (size_t)b * A, A * sizeof(float));
+    }
+    rtka_lstm_cell_step(model->lstm, stream->concat, stream->batch, stream->gates, stream->cell);
+    
+    /* MDN sums straight off the h_next columns of the concat rows */
+    uint32_t num_params = model->num_gaussians * (1 + 2 * Z);
+    rtka_gemm_operand_t h = { stream->concat + Z + A, stream->row, 1, RTKA_GEMM_F32, NULL };
+    rtka_gemm(stream->batch, num_params, H, &h, &stream->mdn_weight, stream->params, num_params, false);
+    return rtka_mdn_finish_into(model->mdn, stream->params, stream->batch, &stream->output);
+}
+
+const float* rtka_mdnrnn_stream_hidden(const rtka_mdnrnn_stream_t* stream, uint32_t row) {
+    if (!stream || row >= stream->batch) return NULL;
+    
+    return stream->concat + (size_t)row * stream->row + (stream->row - stream->model->hidden_size);
+}
+
+void rtka_mdnrnn_stream_sample(const rtka_mdnrnn_stream_t* stream, rtka_rng_t* rng, float* z_next) {
+    if (!stream || !z_next) return;
+    if (!rng) rng = rtka_random_thread();
+    
+    uint32_t K = stream->model->num_gaussians, Z = stream->model->z_size;
+    for (uint32_t b = 0; b < stream->batch; b++) {
+        const rtka_state_t* pi = stream->output.pi->data + (size_t)b * K;
+        
+        /* Rounding may leave the cumulative sum short of the draw */
+        rtka_confidence_t rand_val = rtka_random_uniform(rng);
+        rtka_confidence_t cumsum = 0.0f;
+        uint32_t selected_k = K - 1;
+        for (uint32_t k = 0; k < K; k++) {
+            cumsum += pi[k].confidence;
+            if (rand_val <= cumsum) {
+                selected_k = k;
+                break;
+            }
+        }
+        
+        size_t base = ((size_t)b * K + selected_k) * Z;
+        const rtka_state_t* mu = stream->output.mu->data + base;
+        const rtka_state_t* sigma = stream->output.sigma->data + base;
+        float* out = z_next + (size_t)b * Z;
+        for (uint32_t z = 0; z < Z; z++) {
+            rtka_confidence_t u1 = 1.0f - rtka_random_uniform(rng);     /* (0, 1] for the log */
+            rtka_confidence_t u2 = rtka_random_uniform(rng);
+            rtka_confidence_t z0 = sqrtf(-2.0f * logf(u1)) * cosf(2.0f * M_PI * u2);
+            out[z] = mu[z].confidence * (rtka_confidence_t)mu[z].value + sigma[z].confidence * z0;
+        }
+    }
+}
+
+rtka_error_t rtka_mdnrnn_stream_rollout(rtka_mdnrnn_stream_t* stream, const float* z_0,
+                                        const float* actions, uint32_t steps,
+                                        rtka_rng_t* rng, float* z_out) {
+    if (!stream || !z_0 || !z_out) return RTKA_ERROR_NULL_POINTER;
+    
+    size_t z_block = (size_t)stream->batch * stream->model->z_size;
+    size_t a_block = (size_t)stream->batch * stream->model->action_size;
+    const float* z = z_0;
+    for (uint32_t t = 0; t < steps; t++) {
+        rtka_error_t err = rtka_mdnrnn_stream_step(stream, z, actions ? actions + t * a_block : NULL);
+        if (err != RTKA_SUCCESS) return err;
+        
+        float* next = z_out + t * z_block;
+        rtka_mdnrnn_stream_sample(stream, rng, next);
+        z = next;
+    }
+    return RTKA_SUCCESS;
+}
@@ -15,6 +15,11 @@
  *   - Sequence-to-sequence processing
  *   - Probabilistic trajectory prediction
  *   - Integrated forward pass
+ * v1.1.0 - Checkpointed backward through the LSTM
+ * v1.2.0 - Assembly from built components (rtka_mdnrnn_create_from), for
+ *   the mapped model files of rtka_model_io.h
+ * v1.3.0 - Streaming inference (rtka_mdnrnn_stream_t): preallocated state
+ *   and outputs, allocation-free steps, batched rollouts
  */
 
 #ifndef RTKA_MDNRNN_H
@@ -24,6 +29,8 @@
 #include "rtka_tensor.h"
 #include "rtka_lstm.h"
 #include "rtka_mdn.h"
+#include "rtka_gemm.h"
+#include "rtka_random.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -39,6 +46,9 @@ typedef struct {
     rtka_lstm_layer_t* lstm;   /* LSTM for temporal dynamics */
     rtka_mdn_layer_t* mdn;     /* MDN for probabilistic output */
     
+    void* map;                 /* Loaded model file backing both, or NULL */
+    size_t map_length;
+    
     bool batch_first;
     bool initialized;
 } rtka_mdnrnn_t;
@@ -64,6 +74,16 @@ rtka_mdnrnn_t* rtka_mdnrnn_create(uint32_t z_size,
                                   uint32_t hidden_size,
                                   uint32_t num_gaussians);
 
+/**
+ * Assemble an MDNRNN from built components: z_size is the MDN's output,
+ * action_size the rest of the LSTM input
+ * 
+ * @param lstm LSTM over z + actions
+ * @param mdn  MDN over the LSTM hidden state
+ * @return MDNRNN or NULL; the components are taken over either way
+ */
+rtka_mdnrnn_t* rtka_mdnrnn_create_from(rtka_lstm_layer_t* lstm, rtka_mdn_layer_t* mdn);
+
 /**
  * Initialize MDNRNN hidden states for a batch
  * 
@@ -96,6 +116,31 @@ rtka_mdnrnn_output_t rtka_mdnrnn_forward(rtka_mdnrnn_t* model,
                                          rtka_tensor_t* h_0,
                                          rtka_tensor_t* c_0);
 
+/**
+ * Set the LSTM's BPTT checkpoint segment length
+ * 
+ * @param model   MDNRNN model
+ * @param segment Timesteps per segment, 0 for ceil(sqrt(seq_len))
+ */
+void rtka_mdnrnn_set_checkpoint_segment(rtka_mdnrnn_t* model, uint32_t segment);
+
+/**
+ * Backward pass through the LSTM of the last rtka_mdnrnn_forward
+ * The gradient of the LSTM output sequence comes from the caller's loss
+ * on the MDN parameters; memory is bounded by the checkpoint segment
+ * (see rtka_lstm_backward), gradients accumulate into the LSTM gates.
+ * 
+ * @param model       MDNRNN model
+ * @param z           Latent states the forward pass was given
+ * @param actions     Actions the forward pass was given
+ * @param grad_hidden dL/d LSTM output (batch, seq_len, hidden_size)
+ * @return RTKA_SUCCESS or the rtka_lstm_backward error
+ */
+RTKA_NODISCARD rtka_error_t rtka_mdnrnn_backward(rtka_mdnrnn_t* model,
+                                                 rtka_tensor_t* z,
+                                                 rtka_tensor_t* actions,
+                                                 const rtka_tensor_t* grad_hidden);
+
 /**
  * Single-step prediction
  * Used for autoregressive generation
@@ -141,4 +186,88 @@ uint32_t rtka_mdnrnn_param_count(const rtka_mdnrnn_t* model);
 rtka_tensor_t* rtka_mdnrnn_sample_next(const rtka_mdnrnn_output_t* output, 
                                        uint32_t batch_idx);
 
+/* ============================================================================
+ * STREAMING INFERENCE
+ * ============================================================================ */
+
+/*
+ * Inference over batch independent sequences with everything preallocated:
+ * a step writes the LSTM state and the MDN outputs in place and allocates
+ * nothing, so its latency is flat. Rows are on the signed plane (value *
+ * confidence) as floats. Steps compute what rtka_mdnrnn_step does (sigma
+ * may differ in the last bit where expf vectorizes differently). The
+ * model is only read, so streams of one model may run on separate threads;
+ * the MDN weight format is fixed at creation, recreate the stream after the
+ * parameters change.
+ */
+typedef struct {
+    const rtka_mdnrnn_t* model;
+    uint32_t batch;
+    uint32_t row;                    /* z_size + action_size + hidden_size */
+    
+    float* concat;                   /* (batch, row): [z_t, a_t, h_t] */
+    float* gates;                    /* (batch, 4 * hidden_size) scratch */
+    float* cell;                     /* (batch, hidden_size) c_t */
+    float* params;                   /* (batch, MDN parameters) scratch */
+    
+    rtka_gemm_operand_t mdn_weight;  /* Classified once */
+    rtka_mdn_output_t output;        /* pi, mu, sigma of the last step */
+    
+    rtka_allocator_t* owner;         /* Of the float block */
+} rtka_mdnrnn_stream_t;
+
+/**
+ * Create a stream with zero hidden and cell state
+ * 
+ * @param model MDNRNN model, outlives the stream
+ * @param batch Number of independent sequences
+ * @return Stream or NULL on error
+ */
+rtka_mdnrnn_stream_t* rtka_mdnrnn_stream_create(const rtka_mdnrnn_t* model, uint32_t batch);
+
+void rtka_mdnrnn_stream_free(rtka_mdnrnn_stream_t* stream);
+
+/* Zero the state of every sequence, or of one row (an episode restart) */
+void rtka_mdnrnn_stream_reset(rtka_mdnrnn_stream_t* stream);
+void rtka_mdnrnn_stream_reset_row(rtka_mdnrnn_stream_t* stream, uint32_t row);
+
+/**
+ * One step of every sequence; stream->output holds the MDN parameters
+ * 
+ * @param stream  Stream
+ * @param z       (batch, z_size) latent states
+ * @param actions (batch, action_size) actions, NULL when action_size is 0
+ * @return RTKA_SUCCESS or RTKA_ERROR_NULL_POINTER
+ */
+RTKA_NODISCARD rtka_error_t rtka_mdnrnn_stream_step(rtka_mdnrnn_stream_t* stream, const float* z,
+                                                    const float* actions);
+
+/* Current hidden state of one row (hidden_size floats) */
+const float* rtka_mdnrnn_stream_hidden(const rtka_mdnrnn_stream_t* stream, uint32_t row);
+
+/**
+ * Sample the next latent state of every row from the last step's mixture,
+ * as rtka_mdn_sample does
+ * 
+ * @param stream Stream
+ * @param rng    Generator, NULL for the calling thread's
+ * @param z_next (batch, z_size) samples
+ */
+void rtka_mdnrnn_stream_sample(const rtka_mdnrnn_stream_t* stream, rtka_rng_t* rng, float* z_next);
+
+/**
+ * Autoregressive rollout: each step's sample is the next step's z
+ * 
+ * @param stream  Stream, carries its state in and out
+ * @param z_0     (batch, z_size) first latent states
+ * @param actions (steps, batch, action_size), NULL when action_size is 0
+ * @param steps   Number of steps
+ * @param rng     Generator, NULL for the calling thread's
+ * @param z_out   (steps, batch, z_size) sampled latent states
+ * @return RTKA_SUCCESS or RTKA_ERROR_NULL_POINTER
+ */
+RTKA_NODISCARD rtka_error_t rtka_mdnrnn_stream_rollout(rtka_mdnrnn_stream_t* stream, const float* z_0,
+                                                       const float* actions, uint32_t steps,
+                                                       rtka_rng_t* rng, float* z_out);
+
 #endif /* RTKA_MDNRNN_H */
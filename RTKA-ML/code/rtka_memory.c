@@ -14,6 +14,7 @@
 #include "rtka_memory.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 
 /* Helper macro for alignment */
 #define RTKA_ALIGN(size, align) (((size) + (align) - 1) & ~((align) - 1))
@@ -27,7 +28,8 @@ static rtka_stack_t g_temp_stack = {0};
 
 /* Initialize pool allocator */
 static rtka_error_t pool_init(rtka_pool_t* pool, size_t block_size, size_t block_count) {
-    pool->block_size = RTKA_ALIGN(block_size, RTKA_CACHE_LINE_SIZE);
+    /* Room for the link header: data starts a cache line into each block */
+    pool->block_size = RTKA_ALIGN(offsetof(rtka_pool_block_t, data) + block_size, RTKA_CACHE_LINE_SIZE);
     pool->block_count = block_count;
     pool->total_size = pool->block_size * block_count;
     
@@ -138,6 +140,99 @@ void rtka_stack_reset(rtka_stack_t* stack) {
     atomic_store(&stack->current_offset, 0);
 }
 
+void* rtka_stack_save_point(rtka_stack_t* stack) {
+    return (uint8_t*)stack->memory_base + atomic_load(&stack->current_offset);
+}
+
+void rtka_stack_restore(rtka_stack_t* stack, void* save_point) {
+    if (RTKA_UNLIKELY(!save_point)) return;
+    atomic_store(&stack->current_offset, (size_t)((uint8_t*)save_point - (uint8_t*)stack->memory_base));
+}
+
+/* Heap allocator - cache-line aligned so tensor headers keep their alignment */
+static void* heap_alloc(size_t size, void* context) {
+    (void)context;
+    return aligned_alloc(RTKA_CACHE_LINE_SIZE, RTKA_ALIGN(size, RTKA_CACHE_LINE_SIZE));
+}
+
+static void heap_free(void* ptr, void* context) {
+    (void)context;
+    free(ptr);
+}
+
+static rtka_allocator_t g_heap_allocator = { heap_alloc, heap_free, NULL };
+
+rtka_allocator_t* rtka_heap_allocator(void) {
+    return &g_heap_allocator;
+}
+
+/* Arena allocator - released wholesale by rtka_arena_end_step */
+static void* arena_alloc(size_t size, void* context) {
+    return rtka_stack_alloc(&((rtka_arena_t*)context)->stack, size);
+}
+
+static void arena_free(void* ptr, void* context) {
+    (void)ptr;
+    (void)context;
+}
+
+rtka_arena_t* rtka_arena_create(size_t size) {
+    rtka_arena_t* arena = aligned_alloc(RTKA_CACHE_LINE_SIZE, RTKA_ALIGN(sizeof(rtka_arena_t), RTKA_CACHE_LINE_SIZE));
+    if (!arena) return NULL;
+    memset(arena, 0, sizeof(*arena));
+
+    if (stack_init(&arena->stack, size) != RTKA_SUCCESS) {
+        free(arena);
+        return NULL;
+    }
+    arena->stack.alignment = RTKA_CACHE_LINE_SIZE;  /* Tensor headers are 64-byte aligned */
+    arena->allocator = (rtka_allocator_t){ arena_alloc, arena_free, arena };
+    return arena;
+}
+
+void rtka_arena_destroy(rtka_arena_t* arena) {
+    if (!arena) return;
+    if (rtka_tls_memory.arena == arena) rtka_arena_end_step(arena);
+    free(arena->stack.memory_base);
+    free(arena);
+}
+
+void rtka_arena_begin_step(rtka_arena_t* arena) {
+    if (RTKA_UNLIKELY(!arena || rtka_tls_memory.arena == arena)) return;
+
+    arena->step_mark = rtka_stack_save_point(&arena->stack);
+    arena->outer = rtka_tls_memory.allocator;
+    arena->outer_arena = rtka_tls_memory.arena;
+    rtka_tls_memory.allocator = &arena->allocator;
+    rtka_tls_memory.arena = arena;
+}
+
+void rtka_arena_end_step(rtka_arena_t* arena) {
+    if (RTKA_UNLIKELY(!arena || rtka_tls_memory.arena != arena)) return;
+
+    size_t used = atomic_load(&arena->stack.current_offset);
+    if (used > arena->high_water) arena->high_water = used;
+    arena->steps++;
+
+    rtka_stack_restore(&arena->stack, arena->step_mark);
+    rtka_tls_memory.allocator = arena->outer;
+    rtka_tls_memory.arena = arena->outer_arena;
+}
+
+void* rtka_allocator_alloc(rtka_allocator_t* allocator, size_t size, rtka_allocator_t** owner) {
+    if (!allocator) allocator = rtka_current_allocator();
+
+    void* ptr = allocator->alloc(size, allocator->context);
+    if (RTKA_UNLIKELY(!ptr) && allocator != &g_heap_allocator) {
+        if (allocator->alloc == arena_alloc) ((rtka_arena_t*)allocator->context)->overflows++;
+        allocator = &g_heap_allocator;
+        ptr = heap_alloc(size, NULL);
+    }
+
+    *owner = ptr ? allocator : NULL;
+    return ptr;
+}
+
 /* Vector allocation */
 rtka_vector_t* rtka_alloc_vector(uint32_t size) {
     rtka_vector_t* vec = (rtka_vector_t*)rtka_pool_alloc(rtka_tls_memory.state_pool);
@@ -49,10 +49,35 @@ typedef struct RTKA_ALIGNED(RTKA_CACHE_LINE_SIZE) {
     bool initialized;
 } rtka_stack_t;
 
+/* Step arena - a stack allocator behind rtka_allocator_t. Between
+ * rtka_arena_begin_step and rtka_arena_end_step it is the calling thread's
+ * allocator, so the intermediate tensors and gradient nodes of one training
+ * step are pointer bumps and end_step releases all of them in O(1):
+ *
+ *   rtka_arena_begin_step(arena);
+ *   ... forward, loss, rtka_grad_backward ...
+ *   rtka_optimizer_step(opt, params, count);
+ *   rtka_arena_end_step(arena);
+ *
+ * Anything that must outlive the step (parameters, optimizer state, LSTM
+ * carried state) is allocated from rtka_heap_allocator(). */
+typedef struct rtka_arena {
+    rtka_stack_t stack;
+    rtka_allocator_t allocator;     /* alloc bumps the stack, free is a no-op */
+    void* step_mark;
+    rtka_allocator_t* outer;        /* Thread allocator restored by end_step */
+    struct rtka_arena* outer_arena;
+    size_t high_water;
+    uint64_t steps;
+    uint64_t overflows;             /* Requests that fell back to the heap */
+} rtka_arena_t;
+
 /* Thread-local storage for per-thread pools */
 typedef struct {
     rtka_pool_t* state_pool;
     rtka_stack_t* temp_stack;
+    rtka_allocator_t* allocator;    /* NULL = heap */
+    rtka_arena_t* arena;            /* Arena of the open step, if any */
     uint32_t thread_id;
 } rtka_thread_memory_t;
 
@@ -75,6 +100,29 @@ void rtka_stack_reset(rtka_stack_t* stack);
 void* rtka_stack_save_point(rtka_stack_t* stack);
 void rtka_stack_restore(rtka_stack_t* stack, void* save_point);
 
+/* Step arenas */
+RTKA_NODISCARD rtka_arena_t* rtka_arena_create(size_t size);
+void rtka_arena_destroy(rtka_arena_t* arena);
+void rtka_arena_begin_step(rtka_arena_t* arena);
+void rtka_arena_end_step(rtka_arena_t* arena);
+
+/* Cache-aligned system allocator, the thread default outside any step */
+RTKA_NODISCARD rtka_allocator_t* rtka_heap_allocator(void);
+
+/* Allocator new tensors and gradient nodes come from on this thread */
+RTKA_NODISCARD RTKA_INLINE rtka_allocator_t* rtka_current_allocator(void) {
+    return rtka_tls_memory.allocator ? rtka_tls_memory.allocator : rtka_heap_allocator();
+}
+
+/* Allocate from allocator (NULL = current); an exhausted arena falls back
+ * to the heap. *owner receives the allocator to release the block with. */
+RTKA_NODISCARD void* rtka_allocator_alloc(rtka_allocator_t* allocator, size_t size,
+                                          rtka_allocator_t** owner);
+
+RTKA_INLINE void rtka_allocator_free(rtka_allocator_t* owner, void* ptr) {
+    if (ptr && owner && owner->free) owner->free(ptr, owner->context);
+}
+
 /* Specialized allocators */
 RTKA_NODISCARD RTKA_INLINE rtka_state_t* rtka_alloc_state(void) {
     return (rtka_state_t*)rtka_pool_alloc(rtka_tls_memory.state_pool);
@@ -12,20 +12,24 @@
  */
 
 #include "rtka_ml.h"
+#include "rtka_data_loader.h"
 #include "rtka_memory.h"
+#include "rtka_random.h"
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 
 /* Create model */
 rtka_model_t* rtka_ml_create_model(rtka_model_type_t type) {
-    rtka_model_t* model = (rtka_model_t*)rtka_alloc_state();
+    rtka_model_t* model = (rtka_model_t*)calloc(1, sizeof(rtka_model_t));
     if (!model) return NULL;
     
     model->type = type;
     model->network = rtka_nn_sequential();
     model->tape = rtka_grad_tape_create();
+    model->arena = rtka_arena_create(RTKA_STEP_ARENA_SIZE);
     model->epochs_trained = 0;
     model->compiled = false;
     model->trained = false;
@@ -33,6 +37,34 @@ rtka_model_t* rtka_ml_create_model(rtka_model_type_t type) {
     return model;
 }
 
+/* Free model with its layers; the optimizer was lent by rtka_ml_compile */
+void rtka_ml_free_model(rtka_model_t* model) {
+    if (!model) return;
+    
+    if (model->network) {
+        for (uint32_t i = 0; i < model->network->num_layers; i++) {
+            rtka_layer_t* layer = model->network->layers[i];
+            if (!layer) continue;
+            if (layer->type == LAYER_TERNARY) {
+                rtka_ternary_matrix_free(((rtka_ternary_layer_t*)layer)->packed);
+            } else if (layer->type == LAYER_CONV2D) {
+                rtka_nn_conv2d_release((rtka_conv2d_layer_t*)layer);
+            }
+            rtka_grad_node_free(layer->weight);
+            rtka_grad_node_free(layer->bias);
+            free(layer);
+        }
+        free(model->network->layers);
+        free(model->network);
+    }
+    free(model->train_loss);
+    free(model->val_loss);
+    rtka_grad_tape_free(model->tape);
+    rtka_arena_destroy(model->arena);
+    if (model->map) munmap(model->map, model->map_length);
+    free(model);
+}
+
 /* Add layer */
 void rtka_ml_add_layer(rtka_model_t* model, rtka_layer_t* layer) {
     rtka_nn_sequential_add(model->network, layer);
@@ -63,6 +95,7 @@ static rtka_confidence_t train_step(rtka_model_t* model,
     
     /* Backward pass */
     rtka_grad_backward(output);
+    rtka_grad_tape_end(model->tape);
     
     /* Update parameters */
     rtka_grad_node_t* params[128];
@@ -77,58 +110,87 @@ static rtka_confidence_t train_step(rtka_model_t* model,
     rtka_optimizer_step(model->optimizer, params, param_count);
     rtka_optimizer_zero_grad(model->optimizer, params, param_count);
     
+    /* The input leaf follows the batch's allocator; the batch stays the caller's */
+    if (input_node) rtka_allocator_free(input_node->allocator, input_node);
+    
+    return loss;
+}
+
+/* One step on a caller-owned batch; intermediates live in the step arena */
+rtka_confidence_t rtka_ml_train_batch(rtka_model_t* model,
+                                     rtka_tensor_t* batch_features,
+                                     rtka_tensor_t* batch_labels) {
+    if (!model || !model->compiled || !batch_features || !batch_labels) return 0.0f;
+    
+    rtka_arena_begin_step(model->arena);
+    rtka_confidence_t loss = train_step(model, batch_features, batch_labels);
+    rtka_arena_end_step(model->arena);
+    model->trained = true;
+    
     return loss;
 }
 
-/* Fit model */
+/* Fit model: batches from a loader over train_data, shuffled when asked */
 void rtka_ml_fit(rtka_model_t* model,
                 rtka_dataset_t* train_data,
                 rtka_dataset_t* val_data,
                 rtka_training_config_t* config) {
     if (!model->compiled) return;
     
-    uint32_t num_batches = (train_data->num_samples + config->batch_size - 1) / config->batch_size;
-    
-    model->train_loss = (rtka_confidence_t*)rtka_alloc_states(
-        config->epochs * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
-    model->val_loss = (rtka_confidence_t*)rtka_alloc_states(
-        config->epochs * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
+    rtka_data_loader_t* loader = NULL;
+    uint32_t flags = config->shuffle ? 0U : RTKA_DATA_LOADER_ORDERED;
+    if (rtka_data_loader_create(&loader, train_data, config->batch_size,
+                                rtka_random_next(rtka_random_thread()), flags) != RTKA_SUCCESS) {
+        return;
+    }
+    rtka_ml_fit_loader(model, loader, val_data, config);
+    rtka_data_loader_free(loader);
+}
+
+/* The rtka_ml_fit_loader step: the model's own arena and tape */
+static rtka_confidence_t model_step(void* ctx, rtka_tensor_t* batch_features,
+                                    rtka_tensor_t* batch_labels) {
+    rtka_model_t* model = (rtka_model_t*)ctx;
+    rtka_arena_begin_step(model->arena);
+    rtka_confidence_t loss = train_step(model, batch_features, batch_labels);
+    rtka_arena_end_step(model->arena);
+    return loss;
+}
+
+/* Fit from a loader; config->batch_size and shuffle are the loader's */
+void rtka_ml_fit_loader(rtka_model_t* model,
+                        rtka_data_loader_t* loader,
+                        rtka_dataset_t* val_data,
+                        rtka_training_config_t* config) {
+    rtka_ml_fit_loader_with(model, loader, val_data, config, model_step, model);
+}
+
+/* Fit loop of rtka_ml_fit_loader over any step */
+void rtka_ml_fit_loader_with(rtka_model_t* model,
+                             rtka_data_loader_t* loader,
+                             rtka_dataset_t* val_data,
+                             rtka_training_config_t* config,
+                             rtka_ml_step_fn step, void* ctx) {
+    if (!model->compiled || !loader || !step) return;
+    
+    uint32_t num_batches = rtka_data_loader_batches(loader);
+    /* History of this fit, owned by the model */
+    free(model->train_loss);
+    free(model->val_loss);
+    model->train_loss = (rtka_confidence_t*)calloc(config->epochs ? config->epochs : 1U,
+                                                   sizeof(rtka_confidence_t));
+    model->val_loss = (rtka_confidence_t*)calloc(config->epochs ? config->epochs : 1U,
+                                                 sizeof(rtka_confidence_t));
+    if (!model->train_loss || !model->val_loss) return;
     
     for (uint32_t epoch = 0; epoch < config->epochs; epoch++) {
         rtka_confidence_t epoch_loss = 0.0f;
         
-        /* Shuffle if requested */
-        if (config->shuffle) {
-            rtka_ml_shuffle_dataset(train_data);
-        }
-        
-        /* Training batches */
-        for (uint32_t batch = 0; batch < num_batches; batch++) {
-            uint32_t start = batch * config->batch_size;
-            uint32_t end = start + config->batch_size;
-            if (end > train_data->num_samples) end = train_data->num_samples;
-            
-            /* Extract batch */
-            uint32_t batch_shape[] = {end - start, train_data->num_features};
-            rtka_tensor_t* batch_features = rtka_tensor_create(batch_shape, 2);
-            rtka_tensor_t* batch_labels = rtka_tensor_create(batch_shape, 2);
-            
-            for (uint32_t i = start; i < end; i++) {
-                for (uint32_t j = 0; j < train_data->num_features; j++) {
-                    uint32_t src_idx[] = {i, j};
-                    uint32_t dst_idx[] = {i - start, j};
-                    rtka_tensor_set(batch_features, dst_idx, 
-                                   *rtka_tensor_get(train_data->features, src_idx));
-                    rtka_tensor_set(batch_labels, dst_idx,
-                                   *rtka_tensor_get(train_data->labels, src_idx));
-                }
-            }
-            
-            rtka_confidence_t loss = train_step(model, batch_features, batch_labels);
-            epoch_loss += loss;
-            
-            rtka_tensor_free(batch_features);
-            rtka_tensor_free(batch_labels);
+        /* The loader gathers the next batch while this one trains; every
+         * intermediate comes from a step arena */
+        const rtka_data_batch_t* batch;
+        while (rtka_data_loader_next(loader, &batch) == RTKA_SUCCESS && batch) {
+            epoch_loss += step(ctx, batch->features, batch->labels);
         }
         
         model->train_loss[epoch] = epoch_loss / num_batches;
@@ -294,7 +356,7 @@ rtka_model_t* rtka_ml_create_ternary_classifier(uint32_t input_dim,
 /* Shuffle dataset */
 void rtka_ml_shuffle_dataset(rtka_dataset_t* data) {
     for (uint32_t i = data->num_samples - 1; i > 0; i--) {
-        uint32_t j = rand() % (i + 1);
+        uint32_t j = rtka_random_range(rtka_random_thread(), 0, i);
         
         /* Swap rows i and j */
         for (uint32_t k = 0; k < data->num_features; k++) {
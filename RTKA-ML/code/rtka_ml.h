@@ -56,6 +56,7 @@ typedef struct {
     rtka_sequential_t* network;
     rtka_optimizer_t* optimizer;
     rtka_grad_tape_t* tape;
+    rtka_arena_t* arena;  /* Intermediates of one training step */
     
     /* Training history */
     rtka_confidence_t* train_loss;
@@ -64,6 +65,10 @@ typedef struct {
     rtka_confidence_t* val_acc;
     uint32_t epochs_trained;
     
+    /* Loaded model file backing the layer parameters, or NULL */
+    void* map;
+    size_t map_length;
+    
     /* Model state */
     bool compiled;
     bool trained;
@@ -75,11 +80,35 @@ void rtka_ml_add_layer(rtka_model_t* model, rtka_layer_t* layer);
 void rtka_ml_compile(rtka_model_t* model, rtka_optimizer_t* optimizer);
 void rtka_ml_free_model(rtka_model_t* model);
 
-/* Training */
+/* Training: rtka_ml_fit gathers shuffled batches through an
+ * rtka_data_loader_t and leaves train_data in its order; fit_loader
+ * trains from any loader (rtka_data_loader.h), a dataset file included */
+typedef struct rtka_data_loader rtka_data_loader_t;
+
 void rtka_ml_fit(rtka_model_t* model, 
                 rtka_dataset_t* train_data,
                 rtka_dataset_t* val_data,
                 rtka_training_config_t* config);
+void rtka_ml_fit_loader(rtka_model_t* model,
+                        rtka_data_loader_t* loader,
+                        rtka_dataset_t* val_data,
+                        rtka_training_config_t* config);
+
+/* The same loop with step(ctx, features, labels) training each batch and
+ * returning its loss, e.g. a data-parallel step (rtka_data_parallel.h) */
+typedef rtka_confidence_t (*rtka_ml_step_fn)(void* ctx, rtka_tensor_t* batch_features,
+                                             rtka_tensor_t* batch_labels);
+void rtka_ml_fit_loader_with(rtka_model_t* model,
+                             rtka_data_loader_t* loader,
+                             rtka_dataset_t* val_data,
+                             rtka_training_config_t* config,
+                             rtka_ml_step_fn step, void* ctx);
+
+/* One optimizer step on batch_features / batch_labels, which the caller
+ * keeps; marks the model trained */
+rtka_confidence_t rtka_ml_train_batch(rtka_model_t* model,
+                                     rtka_tensor_t* batch_features,
+                                     rtka_tensor_t* batch_labels);
 
 /* Prediction */
 rtka_tensor_t* rtka_ml_predict(rtka_model_t* model, rtka_tensor_t* input);
@@ -98,7 +127,8 @@ void rtka_ml_quantize_model(rtka_model_t* model, rtka_confidence_t threshold);
 size_t rtka_ml_model_size(rtka_model_t* model);
 rtka_confidence_t rtka_ml_compression_ratio(rtka_model_t* model);
 
-/* Model persistence */
+/* Model persistence, the rtka_model_io.h format: save adds ternary
+ * bit-planes, load maps the file copy-on-write so the model trains on */
 bool rtka_ml_save_model(rtka_model_t* model, const char* path);
 rtka_model_t* rtka_ml_load_model(const char* path);
 
@@ -0,0 +1,589 @@
+/**
+ * File: rtka_model_io.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Model Files
+ *
+ * Layout: the header, one record per sequential layer, the section table,
+ * then the blobs, each 64-byte aligned. A section names its owner (layer
+ * index; LSTM 0 and MDN 1 in MDN-RNN files) and what it holds: a weight or
+ * bias tensor as rtka_state_t, or a ternary weight as two bit-planes of
+ * rows x words uint64_t, positive first. Loading validates the tables
+ * against the file length, then wraps each blob in a tensor header; no
+ * parameter is copied or converted.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_model_io.h"
+#include "rtka_nn.h"
+#include "rtka_gemm.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MODEL_MAGIC      "RTKAMDL"
+#define MODEL_ALIGN      64U
+#define MODEL_ALIGN_UP(x) (((x) + MODEL_ALIGN - 1U) & ~(uint64_t)(MODEL_ALIGN - 1U))
+#define MODEL_MAX_DIMS   4U
+
+/* Section contents */
+#define SECTION_WEIGHT   1U
+#define SECTION_BIAS     2U
+#define SECTION_PLANES   3U                /* Bit-planes of the owner's weight */
+
+/* Layer record flags */
+#define LAYER_HAS_BIAS   0x1U
+#define LAYER_QUANTIZE   0x2U              /* Ternary: quantize_activations */
+
+/* MDN-RNN owners */
+#define OWNER_LSTM       0U
+#define OWNER_MDN        1U
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;                         /* rtka_model_file_kind_t */
+    uint32_t state_size;                   /* sizeof(rtka_state_t) when written */
+    uint32_t num_layers;
+    uint32_t num_sections;
+    uint32_t arch[5];                      /* Per kind, see the savers */
+    uint64_t layers;                       /* File positions of the tables */
+    uint64_t sections;
+} model_header_t;
+
+typedef struct {
+    uint32_t type;                         /* rtka_layer_type_t */
+    uint32_t in_features;
+    uint32_t out_features;
+    uint32_t flags;
+    float threshold;
+    uint8_t reserved[12];
+} model_layer_t;
+
+typedef struct {
+    uint32_t kind;                         /* SECTION_* */
+    uint32_t owner;
+    uint32_t ndim;
+    uint32_t reserved0;
+    uint32_t shape[MODEL_MAX_DIMS];        /* Planes: rows, cols, words */
+    uint64_t offset;
+    uint64_t bytes;
+    uint8_t reserved[16];
+} model_section_t;
+
+_Static_assert(sizeof(model_header_t) == 64, "model header must be 64 bytes");
+_Static_assert(sizeof(model_layer_t) == 32, "layer record must be 32 bytes");
+_Static_assert(sizeof(model_section_t) == 64, "section record must be 64 bytes");
+
+/* ----------------------------------------------------------------------------
+ * Writing: sections are queued with their source memory, laid out, written
+ * in order
+ * -------------------------------------------------------------------------- */
+
+typedef struct {
+    model_header_t header;
+    model_layer_t* layers;
+    model_section_t* sections;
+    const void** blobs;
+    rtka_ternary_matrix_t** planes;        /* Packed for the file, freed after */
+    uint32_t capacity;
+    bool ok;
+} model_writer_t;
+
+static bool writer_init(model_writer_t* w, rtka_model_file_kind_t kind, uint32_t num_layers,
+                        uint32_t max_sections) {
+    memset(w, 0, sizeof(*w));
+    memcpy(w->header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    w->header.version = RTKA_MODEL_FILE_VERSION;
+    w->header.kind = (uint32_t)kind;
+    w->header.state_size = sizeof(rtka_state_t);
+    w->header.num_layers = num_layers;
+    w->capacity = max_sections;
+    w->layers = (model_layer_t*)calloc(num_layers ? num_layers : 1U, sizeof(model_layer_t));
+    w->sections = (model_section_t*)calloc(max_sections, sizeof(model_section_t));
+    w->blobs = (const void**)calloc(max_sections, sizeof(const void*));
+    w->planes = (rtka_ternary_matrix_t**)calloc(max_sections, sizeof(rtka_ternary_matrix_t*));
+    w->ok = w->layers && w->sections && w->blobs && w->planes;
+    return w->ok;
+}
+
+static void writer_free(model_writer_t* w) {
+    for (uint32_t i = 0; w->planes && i < w->header.num_sections; i++) {
+        rtka_ternary_matrix_free(w->planes[i]);
+    }
+    free(w->layers);
+    free(w->sections);
+    free(w->blobs);
+    free(w->planes);
+}
+
+static model_section_t* writer_section(model_writer_t* w, uint32_t kind, uint32_t owner) {
+    if (!w->ok || w->header.num_sections == w->capacity) {
+        w->ok = false;
+        return NULL;
+    }
+    model_section_t* s = &w->sections[w->header.num_sections++];
+    s->kind = kind;
+    s->owner = owner;
+    return s;
+}
+
+/* Parameters are written as they lie, so they must be contiguous AoS */
+static void writer_states(model_writer_t* w, uint32_t kind, uint32_t owner, const rtka_tensor_t* t) {
+    if (!t || !t->data || !(t->flags & RTKA_TENSOR_CONTIGUOUS) || t->ndim == 0 ||
+        t->ndim > MODEL_MAX_DIMS) {
+        w->ok = false;
+        return;
+    }
+    model_section_t* s = writer_section(w, kind, owner);
+    if (!s) return;
+    s->ndim = t->ndim;
+    memcpy(s->shape, t->shape, t->ndim * sizeof(uint32_t));
+    s->bytes = (uint64_t)t->size * sizeof(rtka_state_t);
+    w->blobs[w->header.num_sections - 1U] = t->data;
+}
+
+/* Bit-planes of an (in, out) weight, rows = out as rtka_nn_ternary_pack
+ * lays them; pos and neg are adjacent in the packed block */
+static void writer_planes(model_writer_t* w, uint32_t owner, const rtka_tensor_t* weight) {
+    if (!w->ok) return;
+    rtka_ternary_matrix_t* m = rtka_ternary_pack(weight->data, weight->shape[1], weight->shape[0],
+                                                 weight->strides[1], weight->strides[0]);
+    model_section_t* s = m ? writer_section(w, SECTION_PLANES, owner) : NULL;
+    if (!s) {
+        rtka_ternary_matrix_free(m);
+        w->ok = false;
+        return;
+    }
+    s->ndim = 3;
+    s->shape[0] = m->rows;
+    s->shape[1] = m->cols;
+    s->shape[2] = m->words;
+    s->bytes = 2U * (uint64_t)m->rows * m->words * sizeof(uint64_t);
+    w->blobs[w->header.num_sections - 1U] = m->pos;
+    w->planes[w->header.num_sections - 1U] = m;
+}
+
+static bool write_at(FILE* f, uint64_t pos, const void* data, size_t bytes) {
+    static const uint8_t zeros[MODEL_ALIGN] = {0};
+    long here = ftell(f);
+    if (here < 0 || (uint64_t)here > pos || pos - (uint64_t)here > MODEL_ALIGN) return false;
+    if (fwrite(zeros, 1, (size_t)(pos - (uint64_t)here), f) != (size_t)(pos - (uint64_t)here)) return false;
+    return bytes == 0 || fwrite(data, 1, bytes, f) == bytes;
+}
+
+static rtka_error_t writer_finish(model_writer_t* w, const char* path) {
+    if (!w->ok) {
+        writer_free(w);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    model_header_t* h = &w->header;
+    h->layers = sizeof(model_header_t);
+    h->sections = MODEL_ALIGN_UP(h->layers + (uint64_t)h->num_layers * sizeof(model_layer_t));
+    uint64_t pos = MODEL_ALIGN_UP(h->sections + (uint64_t)h->num_sections * sizeof(model_section_t));
+    for (uint32_t i = 0; i < h->num_sections; i++) {
+        w->sections[i].offset = pos;
+        pos = MODEL_ALIGN_UP(pos + w->sections[i].bytes);
+    }
+
+    FILE* f = fopen(path, "wb");
+    bool ok = f && fwrite(h, sizeof(*h), 1, f) == 1 &&
+              write_at(f, h->layers, w->layers, h->num_layers * sizeof(model_layer_t)) &&
+              write_at(f, h->sections, w->sections, h->num_sections * sizeof(model_section_t));
+    for (uint32_t i = 0; ok && i < h->num_sections; i++) {
+        ok = write_at(f, w->sections[i].offset, w->blobs[i], (size_t)w->sections[i].bytes);
+    }
+    if (f) {
+        ok &= fclose(f) == 0;
+        if (!ok) remove(path);
+    }
+    writer_free(w);
+    return ok ? RTKA_SUCCESS : RTKA_ERROR_INVALID_VALUE;
+}
+
+/* ----------------------------------------------------------------------------
+ * Reading
+ * -------------------------------------------------------------------------- */
+
+typedef struct {
+    uint8_t* map;
+    size_t length;
+    const model_header_t* header;
+    const model_layer_t* layers;
+    const model_section_t* sections;
+} model_file_t;
+
+static bool header_valid(const model_header_t* h) {
+    return memcmp(h->magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) == 0 &&
+           h->version == RTKA_MODEL_FILE_VERSION && h->state_size == sizeof(rtka_state_t) &&
+           h->kind >= RTKA_MODEL_FILE_SEQUENTIAL && h->kind <= RTKA_MODEL_FILE_MDNRNN;
+}
+
+static bool section_valid(const model_section_t* s, uint64_t blobs, uint64_t length) {
+    if (s->ndim == 0 || s->ndim > MODEL_MAX_DIMS || s->offset % MODEL_ALIGN != 0 ||
+        s->offset < blobs || s->offset > length || s->bytes > length - s->offset) {
+        return false;
+    }
+    uint64_t count = 1;
+    for (uint32_t d = 0; d < s->ndim; d++) count *= s->shape[d];
+    switch (s->kind) {
+        case SECTION_WEIGHT:
+        case SECTION_BIAS:
+            return count <= UINT32_MAX && s->bytes == count * sizeof(rtka_state_t);
+        case SECTION_PLANES:
+            return s->ndim == 3 && s->shape[2] == (s->shape[1] + 63U) / 64U &&
+                   s->bytes == 2U * (uint64_t)s->shape[0] * s->shape[2] * sizeof(uint64_t);
+        default:
+            return false;
+    }
+}
+
+static void model_close(model_file_t* file) {
+    if (file->map) munmap(file->map, file->length);
+    file->map = NULL;
+}
+
+static rtka_error_t model_open(model_file_t* file, const char* path, rtka_model_file_kind_t kind,
+                               uint32_t flags) {
+    memset(file, 0, sizeof(*file));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return RTKA_ERROR_INVALID_VALUE;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(model_header_t)) {
+        close(fd);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    file->length = (size_t)st.st_size;
+    bool private_map = (flags & RTKA_MODEL_LOAD_PRIVATE) != 0;
+    int prot = private_map ? PROT_READ | PROT_WRITE : PROT_READ;
+    int share = (private_map ? MAP_PRIVATE : MAP_SHARED) |
+                ((flags & RTKA_MODEL_LOAD_POPULATE) ? MAP_POPULATE : 0);
+    void* map = mmap(NULL, file->length, prot, share, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return RTKA_ERROR_OUT_OF_MEMORY;
+    file->map = (uint8_t*)map;
+
+    const model_header_t* h = (const model_header_t*)map;
+    uint64_t sections = MODEL_ALIGN_UP(sizeof(model_header_t) + (uint64_t)h->num_layers * sizeof(model_layer_t));
+    uint64_t blobs = MODEL_ALIGN_UP(sections + (uint64_t)h->num_sections * sizeof(model_section_t));
+    bool ok = header_valid(h) && h->kind == (uint32_t)kind && h->layers == sizeof(model_header_t) &&
+              h->sections == sections && blobs <= file->length;
+    for (uint32_t i = 0; ok && i < h->num_sections; i++) {
+        ok = section_valid((const model_section_t*)(file->map + sections) + i, blobs, file->length);
+    }
+    if (!ok) {
+        model_close(file);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    file->header = h;
+    file->layers = (const model_layer_t*)(file->map + h->layers);
+    file->sections = (const model_section_t*)(file->map + h->sections);
+    return RTKA_SUCCESS;
+}
+
+static const model_section_t* find_section(const model_file_t* file, uint32_t kind, uint32_t owner) {
+    for (uint32_t i = 0; i < file->header->num_sections; i++) {
+        const model_section_t* s = &file->sections[i];
+        if (s->kind == kind && s->owner == owner) return s;
+    }
+    return NULL;
+}
+
+/* States section of exactly this shape, or NULL */
+static const model_section_t* find_states(const model_file_t* file, uint32_t kind, uint32_t owner,
+                                          const uint32_t* shape, uint32_t ndim) {
+    const model_section_t* s = find_section(file, kind, owner);
+    if (!s || s->ndim != ndim) return NULL;
+    return memcmp(s->shape, shape, ndim * sizeof(uint32_t)) == 0 ? s : NULL;
+}
+
+/* Header over the mapped states; read-only mappings fault on writes */
+static rtka_tensor_t* section_tensor(const model_file_t* file, const model_section_t* s) {
+    return rtka_tensor_wrap((rtka_state_t*)(void*)(file->map + s->offset), s->shape, s->ndim);
+}
+
+rtka_error_t rtka_model_file_kind(const char* path, rtka_model_file_kind_t* kind) {
+    if (!path || !kind) return RTKA_ERROR_NULL_POINTER;
+    FILE* f = fopen(path, "rb");
+    if (!f) return RTKA_ERROR_INVALID_VALUE;
+    model_header_t header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 && header_valid(&header);
+    fclose(f);
+    if (!ok) return RTKA_ERROR_INVALID_VALUE;
+    *kind = (rtka_model_file_kind_t)header.kind;
+    return RTKA_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Sequential models: arch = {model type, epochs trained}
+ * -------------------------------------------------------------------------- */
+
+rtka_error_t rtka_ml_model_save(const rtka_model_t* model, const char* path, uint32_t flags) {
+    if (!model || !model->network || !path) return RTKA_ERROR_NULL_POINTER;
+    const rtka_sequential_t* net = model->network;
+
+    model_writer_t w;
+    if (!writer_init(&w, RTKA_MODEL_FILE_SEQUENTIAL, net->num_layers, 3U * net->num_layers + 1U)) {
+        writer_free(&w);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    w.header.arch[0] = (uint32_t)model->type;
+    w.header.arch[1] = model->epochs_trained;
+
+    for (uint32_t i = 0; i < net->num_layers && w.ok; i++) {
+        const rtka_layer_t* layer = net->layers[i];
+        model_layer_t* record = &w.layers[i];
+        if (!layer || !layer->weight || (layer->type != LAYER_LINEAR && layer->type != LAYER_TERNARY)) {
+            w.ok = false;
+            break;
+        }
+        record->type = (uint32_t)layer->type;
+        record->in_features = layer->weight->data->shape[0];
+        record->out_features = layer->weight->data->shape[1];
+        writer_states(&w, SECTION_WEIGHT, i, layer->weight->data);
+
+        if (layer->type == LAYER_LINEAR) {
+            const rtka_linear_layer_t* linear = (const rtka_linear_layer_t*)layer;
+            if (linear->use_bias && layer->bias) {
+                record->flags |= LAYER_HAS_BIAS;
+                writer_states(&w, SECTION_BIAS, i, layer->bias->data);
+            }
+        } else {
+            const rtka_ternary_layer_t* ternary = (const rtka_ternary_layer_t*)layer;
+            record->threshold = ternary->threshold;
+            if (ternary->quantize_activations) record->flags |= LAYER_QUANTIZE;
+            if (flags & RTKA_MODEL_SAVE_TERNARY) writer_planes(&w, i, layer->weight->data);
+        }
+    }
+    return writer_finish(&w, path);
+}
+
+/* A layer not (yet) owned by a model */
+static void free_layer(rtka_layer_t* layer) {
+    if (layer->type == LAYER_TERNARY) rtka_ternary_matrix_free(((rtka_ternary_layer_t*)layer)->packed);
+    rtka_grad_node_free(layer->weight);
+    rtka_grad_node_free(layer->bias);
+    free(layer);
+}
+
+/* Layer i over its sections; NULL with *malformed set when they are
+ * missing or misshapen */
+static rtka_layer_t* load_layer(const model_file_t* file, uint32_t i, bool trainable, bool* malformed) {
+    const model_layer_t* record = &file->layers[i];
+    uint32_t weight_shape[] = {record->in_features, record->out_features};
+    uint32_t bias_shape[] = {record->out_features};
+    const model_section_t* weight = find_states(file, SECTION_WEIGHT, i, weight_shape, 2);
+    *malformed = true;
+    if (!weight) return NULL;
+
+    if (record->type == LAYER_LINEAR) {
+        const model_section_t* bias = NULL;
+        if (record->flags & LAYER_HAS_BIAS) {
+            bias = find_states(file, SECTION_BIAS, i, bias_shape, 1);
+            if (!bias) return NULL;
+        }
+        *malformed = false;
+        rtka_tensor_t* bias_data = bias ? section_tensor(file, bias) : NULL;
+        if (bias && !bias_data) return NULL;
+        return (rtka_layer_t*)rtka_nn_linear_from(section_tensor(file, weight), bias_data, trainable);
+    }
+    if (record->type != LAYER_TERNARY) return NULL;
+
+    const model_section_t* planes = find_section(file, SECTION_PLANES, i);
+    if (planes && (planes->shape[0] != record->out_features || planes->shape[1] != record->in_features)) {
+        return NULL;
+    }
+    *malformed = false;
+    rtka_ternary_layer_t* layer = rtka_nn_ternary_from(section_tensor(file, weight), record->threshold,
+                                                       trainable);
+    if (!layer) return NULL;
+    layer->quantize_activations = (record->flags & LAYER_QUANTIZE) != 0;
+
+    /* Inference runs straight on the mapped planes; freeing the matrix
+     * releases this header only */
+    if (planes) {
+        rtka_ternary_matrix_t* m = (rtka_ternary_matrix_t*)malloc(sizeof(rtka_ternary_matrix_t));
+        if (!m) {
+            free_layer((rtka_layer_t*)layer);
+            return NULL;
+        }
+        m->rows = planes->shape[0];
+        m->cols = planes->shape[1];
+        m->words = planes->shape[2];
+        m->pos = (uint64_t*)(void*)(file->map + planes->offset);
+        m->neg = m->pos + (size_t)m->rows * m->words;
+        layer->packed = m;
+    }
+    return (rtka_layer_t*)layer;
+}
+
+rtka_error_t rtka_ml_model_load(rtka_model_t** out, const char* path, uint32_t flags) {
+    if (!out || !path) return RTKA_ERROR_NULL_POINTER;
+    *out = NULL;
+    model_file_t file;
+    rtka_error_t err = model_open(&file, path, RTKA_MODEL_FILE_SEQUENTIAL, flags);
+    if (err != RTKA_SUCCESS) return err;
+
+    bool trainable = (flags & RTKA_MODEL_LOAD_PRIVATE) != 0;
+    rtka_model_t* model = rtka_ml_create_model((rtka_model_type_t)file.header->arch[0]);
+    if (!model || !model->network || !model->tape || !model->arena) {
+        rtka_ml_free_model(model);
+        model_close(&file);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    model->map = file.map;
+    model->map_length = file.length;
+    model->epochs_trained = file.header->arch[1];
+    model->trained = true;
+
+    for (uint32_t i = 0; i < file.header->num_layers; i++) {
+        bool malformed = false;
+        rtka_layer_t* layer = load_layer(&file, i, trainable, &malformed);
+        if (layer) rtka_ml_add_layer(model, layer);
+        if (!layer || model->network->num_layers != i + 1U) {
+            if (layer) free_layer(layer);
+            rtka_ml_free_model(model);
+            return malformed ? RTKA_ERROR_INVALID_VALUE : RTKA_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    *out = model;
+    return RTKA_SUCCESS;
+}
+
+bool rtka_ml_save_model(rtka_model_t* model, const char* path) {
+    return rtka_ml_model_save(model, path, RTKA_MODEL_SAVE_TERNARY) == RTKA_SUCCESS;
+}
+
+rtka_model_t* rtka_ml_load_model(const char* path) {
+    rtka_model_t* model = NULL;
+    if (rtka_ml_model_load(&model, path, RTKA_MODEL_LOAD_PRIVATE) != RTKA_SUCCESS) return NULL;
+    return model;
+}
+
+/* ----------------------------------------------------------------------------
+ * LSTM: arch = {input size, hidden size, batch first}
+ * MDN-RNN: arch = {z size, action size, hidden size, gaussians, batch first}
+ * -------------------------------------------------------------------------- */
+
+static void write_lstm(model_writer_t* w, const rtka_lstm_layer_t* lstm, uint32_t owner) {
+    writer_states(w, SECTION_WEIGHT, owner, lstm->weight_packed);
+    writer_states(w, SECTION_BIAS, owner, lstm->bias_packed);
+}
+
+/* NULL with *malformed set when the sections do not fit the sizes */
+static rtka_lstm_layer_t* load_lstm(const model_file_t* file, uint32_t owner, uint32_t input_size,
+                                    uint32_t hidden_size, bool batch_first, bool trainable,
+                                    bool* malformed) {
+    uint32_t weight_shape[] = {4U * hidden_size, input_size + hidden_size};
+    uint32_t bias_shape[] = {4U * hidden_size};
+    const model_section_t* weight = find_states(file, SECTION_WEIGHT, owner, weight_shape, 2);
+    const model_section_t* bias = find_states(file, SECTION_BIAS, owner, bias_shape, 1);
+    *malformed = !weight || !bias || hidden_size == 0;
+    if (*malformed) return NULL;
+    return rtka_lstm_create_from(input_size, hidden_size, batch_first, section_tensor(file, weight),
+                                 section_tensor(file, bias), trainable);
+}
+
+rtka_error_t rtka_lstm_save(const rtka_lstm_layer_t* lstm, const char* path) {
+    if (!lstm || !path) return RTKA_ERROR_NULL_POINTER;
+    model_writer_t w;
+    if (!writer_init(&w, RTKA_MODEL_FILE_LSTM, 0, 2U)) {
+        writer_free(&w);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    w.header.arch[0] = lstm->input_size;
+    w.header.arch[1] = lstm->hidden_size;
+    w.header.arch[2] = lstm->batch_first ? 1U : 0U;
+    write_lstm(&w, lstm, 0);
+    return writer_finish(&w, path);
+}
+
+rtka_error_t rtka_lstm_load(rtka_lstm_layer_t** out, const char* path, uint32_t flags) {
+    if (!out || !path) return RTKA_ERROR_NULL_POINTER;
+    *out = NULL;
+    model_file_t file;
+    rtka_error_t err = model_open(&file, path, RTKA_MODEL_FILE_LSTM, flags);
+    if (err != RTKA_SUCCESS) return err;
+
+    const uint32_t* arch = file.header->arch;
+    bool malformed = false;
+    rtka_lstm_layer_t* lstm = load_lstm(&file, 0, arch[0], arch[1], arch[2] != 0,
+                                        (flags & RTKA_MODEL_LOAD_PRIVATE) != 0, &malformed);
+    if (!lstm) {
+        model_close(&file);
+        return malformed ? RTKA_ERROR_INVALID_VALUE : RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    lstm->map = file.map;
+    lstm->map_length = file.length;
+    *out = lstm;
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_mdnrnn_save(const rtka_mdnrnn_t* model, const char* path) {
+    if (!model || !model->lstm || !model->mdn || !path) return RTKA_ERROR_NULL_POINTER;
+    model_writer_t w;
+    if (!writer_init(&w, RTKA_MODEL_FILE_MDNRNN, 0, 4U)) {
+        writer_free(&w);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    w.header.arch[0] = model->z_size;
+    w.header.arch[1] = model->action_size;
+    w.header.arch[2] = model->hidden_size;
+    w.header.arch[3] = model->num_gaussians;
+    w.header.arch[4] = model->lstm->batch_first ? 1U : 0U;
+    write_lstm(&w, model->lstm, OWNER_LSTM);
+    writer_states(&w, SECTION_WEIGHT, OWNER_MDN, model->mdn->fc_weight->data);
+    writer_states(&w, SECTION_BIAS, OWNER_MDN, model->mdn->fc_bias->data);
+    return writer_finish(&w, path);
+}
+
+rtka_error_t rtka_mdnrnn_load(rtka_mdnrnn_t** out, const char* path, uint32_t flags) {
+    if (!out || !path) return RTKA_ERROR_NULL_POINTER;
+    *out = NULL;
+    model_file_t file;
+    rtka_error_t err = model_open(&file, path, RTKA_MODEL_FILE_MDNRNN, flags);
+    if (err != RTKA_SUCCESS) return err;
+
+    const uint32_t* arch = file.header->arch;
+    uint32_t z_size = arch[0], action_size = arch[1], hidden_size = arch[2], gaussians = arch[3];
+    uint32_t num_params = gaussians * (1U + 2U * z_size);
+    uint32_t weight_shape[] = {hidden_size, num_params};
+    uint32_t bias_shape[] = {num_params};
+    const model_section_t* weight = find_states(&file, SECTION_WEIGHT, OWNER_MDN, weight_shape, 2);
+    const model_section_t* bias = find_states(&file, SECTION_BIAS, OWNER_MDN, bias_shape, 1);
+    bool trainable = (flags & RTKA_MODEL_LOAD_PRIVATE) != 0;
+
+    bool malformed = !weight || !bias || z_size == 0 || gaussians == 0;
+    rtka_lstm_layer_t* lstm = NULL;
+    if (!malformed) {
+        lstm = load_lstm(&file, OWNER_LSTM, z_size + action_size, hidden_size, arch[4] != 0,
+                         trainable, &malformed);
+    }
+    rtka_mdnrnn_t* model = NULL;
+    if (lstm) {
+        rtka_mdn_layer_t* mdn = rtka_mdn_create_from(hidden_size, z_size, gaussians,
+                                                     section_tensor(&file, weight),
+                                                     section_tensor(&file, bias), trainable);
+        if (mdn) model = rtka_mdnrnn_create_from(lstm, mdn);
+        else rtka_lstm_free(lstm);
+    }
+    if (!model) {
+        model_close(&file);
+        return malformed ? RTKA_ERROR_INVALID_VALUE : RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    model->map = file.map;
+    model->map_length = file.length;
+    *out = model;
+    return RTKA_SUCCESS;
+}
@@ -0,0 +1,68 @@
+/**
+ * File: rtka_model_io.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Model Files - mappable parameters for sequential models, LSTM and
+ * MDN-RNN
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial format
+ *          64-byte header, layer records, a section table, then one
+ *          64-byte aligned blob per parameter tensor in memory layout
+ *          (rtka_state_t AoS, native byte order, like the graph files)
+ *          Optional sections with the positive / negative bit-planes of
+ *          ternary layers, ready for rtka_ternary_gemm
+ *          Loading maps the file and points tensor headers into it
+ *
+ * A shared load maps the file read-only: every process on the host reads
+ * one page-cache copy and cold start costs a few header allocations. Its
+ * parameters are frozen (no gradients, layers in inference mode) and must
+ * not be written. RTKA_MODEL_LOAD_PRIVATE maps copy-on-write instead, for
+ * models that train on; pages are copied only as they are written.
+ */
+
+#ifndef RTKA_MODEL_IO_H
+#define RTKA_MODEL_IO_H
+
+#include "rtka_types.h"
+#include "rtka_ml.h"
+#include "rtka_lstm.h"
+#include "rtka_mdnrnn.h"
+
+#define RTKA_MODEL_FILE_VERSION 1U
+
+/* What a file holds */
+typedef enum {
+    RTKA_MODEL_FILE_SEQUENTIAL = 1,    /* rtka_model_t, linear and ternary layers */
+    RTKA_MODEL_FILE_LSTM = 2,
+    RTKA_MODEL_FILE_MDNRNN = 3
+} rtka_model_file_kind_t;
+
+/* Save flags */
+#define RTKA_MODEL_SAVE_TERNARY   (1U << 0)  /* Bit-planes for every ternary layer */
+
+/* Load flags */
+#define RTKA_MODEL_LOAD_PRIVATE   (1U << 0)  /* Copy-on-write, trainable parameters */
+#define RTKA_MODEL_LOAD_POPULATE  (1U << 1)  /* Fault every page in up front */
+
+/* Kind of a model file, RTKA_ERROR_INVALID_VALUE when it is not one */
+RTKA_NODISCARD rtka_error_t rtka_model_file_kind(const char* path, rtka_model_file_kind_t* kind);
+
+/* Sequential models: LAYER_LINEAR and LAYER_TERNARY only, other layers
+ * make the save fail */
+RTKA_NODISCARD rtka_error_t rtka_ml_model_save(const rtka_model_t* model, const char* path, uint32_t flags);
+RTKA_NODISCARD rtka_error_t rtka_ml_model_load(rtka_model_t** model, const char* path, uint32_t flags);
+
+RTKA_NODISCARD rtka_error_t rtka_lstm_save(const rtka_lstm_layer_t* lstm, const char* path);
+RTKA_NODISCARD rtka_error_t rtka_lstm_load(rtka_lstm_layer_t** lstm, const char* path, uint32_t flags);
+
+RTKA_NODISCARD rtka_error_t rtka_mdnrnn_save(const rtka_mdnrnn_t* model, const char* path);
+RTKA_NODISCARD rtka_error_t rtka_mdnrnn_load(rtka_mdnrnn_t** model, const char* path, uint32_t flags);
+
+#endif /* RTKA_MODEL_IO_H */
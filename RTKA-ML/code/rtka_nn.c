@@ -16,14 +16,42 @@
 #include "rtka_random.h"
 #include <math.h>
 #include <string.h>
+#include <stdlib.h>
 
 /* Forward declarations */
 rtka_grad_node_t* rtka_nn_linear_forward(rtka_linear_layer_t* layer, rtka_grad_node_t* input);
 rtka_grad_node_t* rtka_nn_ternary_forward(rtka_ternary_layer_t* layer, rtka_grad_node_t* input);
+rtka_grad_node_t* rtka_nn_conv2d_forward(rtka_conv2d_layer_t* layer, rtka_grad_node_t* input);
+
+#define INIT_CHUNK  256U
+
+void rtka_nn_init_uniform(rtka_tensor_t* weight, rtka_confidence_t scale) {
+    if (!weight) return;
+    float u[INIT_CHUNK];
+    for (uint32_t base = 0; base < weight->size; base += INIT_CHUNK) {
+        uint32_t n = weight->size - base < INIT_CHUNK ? weight->size - base : INIT_CHUNK;
+        rtka_random_fill_float(rtka_random_thread(), u, n);
+        for (uint32_t i = 0; i < n; i++) {
+            weight->data[base + i] = rtka_make_state(RTKA_UNKNOWN, (u[i] - 0.5f) * 2.0f * scale);
+        }
+    }
+}
+
+void rtka_nn_init_ternary(rtka_tensor_t* weight) {
+    if (!weight) return;
+    rtka_value_t v[INIT_CHUNK];
+    for (uint32_t base = 0; base < weight->size; base += INIT_CHUNK) {
+        uint32_t n = weight->size - base < INIT_CHUNK ? weight->size - base : INIT_CHUNK;
+        rtka_random_fill_ternary(rtka_random_thread(), v, n);
+        for (uint32_t i = 0; i < n; i++) {
+            weight->data[base + i] = rtka_make_state(v[i], v[i] == RTKA_UNKNOWN ? 0.5f : 1.0f);
+        }
+    }
+}
 
 /* Create linear layer */
 rtka_linear_layer_t* rtka_nn_linear(uint32_t in_features, uint32_t out_features, bool bias) {
-    rtka_linear_layer_t* layer = (rtka_linear_layer_t*)rtka_alloc_state();
+    rtka_linear_layer_t* layer = (rtka_linear_layer_t*)calloc(1, sizeof(rtka_linear_layer_t));
     if (!layer) return NULL;
     
     layer->base.type = LAYER_LINEAR;
@@ -33,15 +61,12 @@ rtka_linear_layer_t* rtka_nn_linear(uint32_t in_features, uint32_t out_features,
     layer->use_bias = bias;
     
     /* Initialize weights */
-    uint32_t weight_shape[] = {out_features, in_features};
+    uint32_t weight_shape[] = {in_features, out_features};
     rtka_tensor_t* weight = rtka_tensor_unknown(weight_shape, 2);
     
     /* Xavier initialization */
     float scale = sqrtf(2.0f / (in_features + out_features));
-    for (uint32_t i = 0; i < weight->size; i++) {
-        weight->data[i].confidence = (rtka_random_float() - 0.5f) * 2.0f * scale;
-        weight->data[i].value = RTKA_UNKNOWN;
-    }
+    rtka_nn_init_uniform(weight, scale);
     
     layer->base.weight = rtka_grad_node_create(weight, true);
     
@@ -57,7 +82,7 @@ rtka_linear_layer_t* rtka_nn_linear(uint32_t in_features, uint32_t out_features,
 
 /* Create ternary layer */
 rtka_ternary_layer_t* rtka_nn_ternary(uint32_t in_features, uint32_t out_features, rtka_confidence_t threshold) {
-    rtka_ternary_layer_t* layer = (rtka_ternary_layer_t*)rtka_alloc_state();
+    rtka_ternary_layer_t* layer = (rtka_ternary_layer_t*)calloc(1, sizeof(rtka_ternary_layer_t));
     if (!layer) return NULL;
     
     layer->base.type = LAYER_TERNARY;
@@ -68,20 +93,11 @@ rtka_ternary_layer_t* rtka_nn_ternary(uint32_t in_features, uint32_t out_feature
     layer->quantize_activations = true;
     
     /* Initialize ternary weights */
-    uint32_t weight_shape[] = {out_features, in_features};
+    uint32_t weight_shape[] = {in_features, out_features};
     rtka_tensor_t* weight = rtka_tensor_unknown(weight_shape, 2);
     
     /* Ternary initialization */
-    for (uint32_t i = 0; i < weight->size; i++) {
-        float r = rtka_random_float();
-        if (r < 0.333f) {
-            weight->data[i] = rtka_make_state(RTKA_FALSE, 1.0f);
-        } else if (r < 0.667f) {
-            weight->data[i] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
-        } else {
-            weight->data[i] = rtka_make_state(RTKA_TRUE, 1.0f);
-        }
-    }
+    rtka_nn_init_ternary(weight);
     
     layer->base.weight = rtka_grad_node_create(weight, true);
     layer->base.forward = (void*)rtka_nn_ternary_forward;
@@ -89,6 +105,101 @@ rtka_ternary_layer_t* rtka_nn_ternary(uint32_t in_features, uint32_t out_feature
     return layer;
 }
 
+/* Create convolutional layer, square kernel, stride and padding */
+rtka_conv2d_layer_t* rtka_nn_conv2d(uint32_t in_channels, uint32_t out_channels,
+                                    uint32_t kernel_size, uint32_t stride, uint32_t padding) {
+    if (!in_channels || !out_channels || !kernel_size || !stride) return NULL;
+    rtka_conv2d_layer_t* layer = (rtka_conv2d_layer_t*)calloc(1, sizeof(rtka_conv2d_layer_t));
+    if (!layer) return NULL;
+    
+    layer->base.type = LAYER_CONV2D;
+    layer->base.in_features = in_channels;
+    layer->base.out_features = out_channels;
+    layer->base.training = true;
+    layer->kernel_size[0] = layer->kernel_size[1] = kernel_size;
+    layer->stride[0] = layer->stride[1] = stride;
+    layer->padding[0] = layer->padding[1] = padding;
+    layer->in_channels = in_channels;
+    layer->out_channels = out_channels;
+    layer->algo = RTKA_CONV_AUTO;
+    
+    /* Xavier over the receptive field */
+    uint32_t weight_shape[] = {out_channels, in_channels, kernel_size, kernel_size};
+    rtka_tensor_t* weight = rtka_tensor_unknown(weight_shape, 4);
+    uint32_t field = kernel_size * kernel_size;
+    rtka_nn_init_uniform(weight, sqrtf(2.0f / (float)((in_channels + out_channels) * field)));
+    layer->base.weight = weight ? rtka_grad_node_create(weight, true) : NULL;
+    
+    uint32_t bias_shape[] = {out_channels};
+    rtka_tensor_t* bias = rtka_tensor_zeros(bias_shape, 1);
+    layer->base.bias = bias ? rtka_grad_node_create(bias, true) : NULL;
+    
+    if (!layer->base.weight || !layer->base.bias) {
+        if (!layer->base.weight) rtka_tensor_free(weight);
+        if (!layer->base.bias) rtka_tensor_free(bias);
+        rtka_grad_node_free(layer->base.weight);
+        rtka_grad_node_free(layer->base.bias);
+        free(layer);
+        return NULL;
+    }
+    
+    layer->base.forward = (void*)rtka_nn_conv2d_forward;
+    return layer;
+}
+
+/* Layers over existing parameters; frozen layers start in inference mode,
+ * so a ternary one runs on its bit-planes */
+rtka_linear_layer_t* rtka_nn_linear_from(rtka_tensor_t* weight, rtka_tensor_t* bias, bool requires_grad) {
+    bool shaped = weight && weight->ndim == 2 &&
+                  (!bias || (bias->ndim == 1 && bias->shape[0] == weight->shape[1]));
+    rtka_linear_layer_t* layer = shaped ? (rtka_linear_layer_t*)calloc(1, sizeof(rtka_linear_layer_t)) : NULL;
+    if (layer) layer->base.weight = rtka_grad_node_create(weight, requires_grad);
+    if (!layer || !layer->base.weight) {
+        rtka_tensor_free(weight);
+        rtka_tensor_free(bias);
+        free(layer);
+        return NULL;
+    }
+    if (bias) {
+        layer->base.bias = rtka_grad_node_create(bias, requires_grad);
+        if (!layer->base.bias) {
+            rtka_tensor_free(bias);
+            rtka_grad_node_free(layer->base.weight);
+            free(layer);
+            return NULL;
+        }
+    }
+    
+    layer->base.type = LAYER_LINEAR;
+    layer->base.in_features = weight->shape[0];
+    layer->base.out_features = weight->shape[1];
+    layer->base.training = requires_grad;
+    layer->use_bias = bias != NULL;
+    layer->base.forward = (void*)rtka_nn_linear_forward;
+    return layer;
+}
+
+rtka_ternary_layer_t* rtka_nn_ternary_from(rtka_tensor_t* weight, rtka_confidence_t threshold,
+                                           bool requires_grad) {
+    rtka_ternary_layer_t* layer = weight && weight->ndim == 2
+        ? (rtka_ternary_layer_t*)calloc(1, sizeof(rtka_ternary_layer_t)) : NULL;
+    if (layer) layer->base.weight = rtka_grad_node_create(weight, requires_grad);
+    if (!layer || !layer->base.weight) {
+        rtka_tensor_free(weight);
+        free(layer);
+        return NULL;
+    }
+    
+    layer->base.type = LAYER_TERNARY;
+    layer->base.in_features = weight->shape[0];
+    layer->base.out_features = weight->shape[1];
+    layer->base.training = requires_grad;
+    layer->threshold = threshold;
+    layer->quantize_activations = true;
+    layer->base.forward = (void*)rtka_nn_ternary_forward;
+    return layer;
+}
+
 /* Linear forward pass */
 rtka_grad_node_t* rtka_nn_linear_forward(rtka_linear_layer_t* layer, rtka_grad_node_t* input) {
     rtka_grad_node_t* output = rtka_grad_matmul(input, layer->base.weight);
@@ -109,8 +220,81 @@ rtka_grad_node_t* rtka_nn_linear_forward(rtka_linear_layer_t* layer, rtka_grad_n
     return output;
 }
 
+bool rtka_nn_ternary_pack(rtka_ternary_layer_t* layer) {
+    rtka_tensor_t* weight = layer->base.weight->data;
+    rtka_ternary_matrix_free(layer->packed);
+    /* Weight is (in, out); a bit-plane row is one output over every input */
+    layer->packed = rtka_ternary_pack(weight->data, weight->shape[1], weight->shape[0],
+                                      weight->strides[1], weight->strides[0]);
+    return layer->packed != NULL;
+}
+
+/* Pre-activation z enters rtka_ternary_sigmoid in the confidence slot,
+ * which it reads as a signed value */
+rtka_tensor_t* rtka_nn_ternary_infer(rtka_ternary_layer_t* layer, const rtka_tensor_t* input) {
+    if (!layer->packed && !rtka_nn_ternary_pack(layer)) return NULL;
+    
+    const rtka_ternary_matrix_t* w = layer->packed;
+    uint32_t rows = input->size / w->cols;
+    if (input->shape[input->ndim - 1] != w->cols) return NULL;
+    
+    uint32_t out_shape[] = {rows, w->rows};
+    rtka_tensor_t* output = rtka_tensor_create(out_shape, 2);
+    if (!output) return NULL;
+    
+    /* Activation plane doubles as the output scratch: rows x max(span, out) */
+    uint32_t span = rtka_ternary_row_span(w);
+    rtka_allocator_t* owner = NULL;
+    float* x = (float*)rtka_allocator_alloc(
+        NULL, (size_t)rows * (span + w->rows) * sizeof(float), &owner);
+    if (!x) {
+        rtka_tensor_free(output);
+        return NULL;
+    }
+    float* z = x + (size_t)rows * span;
+    
+    if (!layer->quantize_activations && rtka_tensor_is_ternary(input)) {
+        /* Both sides ternary: popcounts of the plane intersections */
+        rtka_ternary_matrix_t* x_bits = rtka_ternary_pack(input->data, rows, w->cols, w->cols, 1);
+        if (x_bits) rtka_ternary_gemm_bits(x_bits, w, z, w->rows);
+        rtka_ternary_matrix_free(x_bits);
+        if (!x_bits) {
+            rtka_allocator_free(owner, x);
+            rtka_tensor_free(output);
+            return NULL;
+        }
+    } else {
+        for (uint32_t r = 0; r < rows; r++) {
+            float* row = x + (size_t)r * span;
+            for (uint32_t c = 0; c < w->cols; c++) {
+                rtka_state_t s = input->data[(size_t)r * w->cols + c];
+                if (layer->quantize_activations) s = rtka_ternary_sigmoid(s, layer->threshold);
+                row[c] = (float)s.value * s.confidence;
+            }
+            for (uint32_t c = w->cols; c < span; c++) row[c] = 0.0f;
+        }
+        rtka_ternary_gemm(w, x, rows, span, z, w->rows);
+    }
+    
+    for (uint32_t i = 0; i < output->size; i++) {
+        output->data[i] = rtka_ternary_sigmoid(rtka_make_state(RTKA_UNKNOWN, z[i]), layer->threshold);
+    }
+    
+    rtka_allocator_free(owner, x);
+    return output;
+}
+
 /* Ternary forward pass with quantization */
 rtka_grad_node_t* rtka_nn_ternary_forward(rtka_ternary_layer_t* layer, rtka_grad_node_t* input) {
+    if (!layer->base.training) {
+        rtka_tensor_t* out = rtka_nn_ternary_infer(layer, input->data);
+        return out ? rtka_grad_node_create(out, false) : NULL;
+    }
+    
+    /* Weights are about to train: the next inference re-packs them */
+    rtka_ternary_matrix_free(layer->packed);
+    layer->packed = NULL;
+    
     /* Quantize input if needed */
     if (layer->quantize_activations) {
         rtka_tensor_t* in_data = input->data;
@@ -131,14 +315,164 @@ rtka_grad_node_t* rtka_nn_ternary_forward(rtka_ternary_layer_t* layer, rtka_grad
     return output;
 }
 
+/* Shape of one convolution over input, batch 1 for (C, H, W) */
+static bool conv_shape(const rtka_conv2d_layer_t* layer, const rtka_tensor_t* input, rtka_conv_shape_t* s) {
+    if (!input || (input->ndim != 3 && input->ndim != 4)) return false;
+    const uint32_t* dims = input->shape + input->ndim - 3U;
+    *s = (rtka_conv_shape_t){
+        .batch = input->ndim == 4 ? input->shape[0] : 1U,
+        .channels = dims[0], .height = dims[1], .width = dims[2],
+        .filters = layer->out_channels,
+        .kernel_h = layer->kernel_size[0], .kernel_w = layer->kernel_size[1],
+        .stride_h = layer->stride[0], .stride_w = layer->stride[1],
+        .pad_h = layer->padding[0], .pad_w = layer->padding[1]
+    };
+    return s->channels == layer->in_channels && rtka_conv_out_height(s) && rtka_conv_out_width(s);
+}
+
+/* Kernel for these weights; ternary tap lists need AoS weights */
+static rtka_conv_algo_t conv_algo(const rtka_conv2d_layer_t* layer, const rtka_conv_shape_t* s) {
+    if (layer->algo != RTKA_CONV_AUTO) return layer->algo;
+    const rtka_tensor_t* weight = layer->base.weight->data;
+    return rtka_conv_select(s, !rtka_tensor_is_soa(weight) && rtka_tensor_is_ternary(weight));
+}
+
+void rtka_nn_conv2d_release(rtka_conv2d_layer_t* layer) {
+    if (!layer) return;
+    free(layer->winograd);
+    rtka_conv_taps_free(layer->taps);
+    layer->winograd = NULL;
+    layer->taps = NULL;
+}
+
+bool rtka_nn_conv2d_prepare(rtka_conv2d_layer_t* layer) {
+    rtka_nn_conv2d_release(layer);
+    
+    rtka_tensor_t* weight = layer->base.weight->data;
+    rtka_conv_shape_t s = {
+        .channels = layer->in_channels, .filters = layer->out_channels,
+        .kernel_h = layer->kernel_size[0], .kernel_w = layer->kernel_size[1],
+        .stride_h = layer->stride[0], .stride_w = layer->stride[1]
+    };
+    switch (conv_algo(layer, &s)) {
+        case RTKA_CONV_WINOGRAD: {
+            if (rtka_conv_select(&s, false) != RTKA_CONV_WINOGRAD) return false;
+            size_t n = (size_t)s.filters * s.channels * 9U;
+            float* w = (float*)malloc(n * sizeof(float));
+            layer->winograd = (float*)malloc(rtka_conv_winograd_size(&s) * sizeof(float));
+            if (w && layer->winograd) {
+                for (size_t i = 0; i < n; i++) {
+                    rtka_state_t st = rtka_tensor_load(weight, rtka_tensor_offset(weight, (uint32_t)i));
+                    w[i] = (float)st.value * st.confidence;
+                }
+                rtka_conv_winograd_weights(&s, w, layer->winograd);
+            }
+            free(w);
+            if (!w) rtka_nn_conv2d_release(layer);
+            return layer->winograd != NULL;
+        }
+        case RTKA_CONV_TERNARY:
+            if (rtka_tensor_is_soa(weight)) return false;
+            layer->taps = rtka_conv_taps_pack(&s, weight->data);
+            return layer->taps != NULL;
+        default:
+            return true;    /* im2col reads the weights as they are */
+    }
+}
+
+/* Pre-activations enter the output as signed states, as in rtka_tensor_linear */
+rtka_tensor_t* rtka_nn_conv2d_infer(rtka_conv2d_layer_t* layer, const rtka_tensor_t* input) {
+    rtka_conv_shape_t s;
+    if (!layer || !conv_shape(layer, input, &s)) return NULL;
+    
+    /* Training weights move every step: build the weight form per call */
+    bool transient = layer->base.training;
+    rtka_conv_algo_t algo = conv_algo(layer, &s);
+    bool cached = algo == RTKA_CONV_IM2COL || (algo == RTKA_CONV_WINOGRAD ? layer->winograd != NULL
+                                                                          : layer->taps != NULL);
+    if ((transient || !cached) && !rtka_nn_conv2d_prepare(layer)) return NULL;
+    
+    uint32_t oh = rtka_conv_out_height(&s), ow = rtka_conv_out_width(&s);
+    size_t in_count = (size_t)s.batch * s.channels * s.height * s.width;
+    size_t out_count = (size_t)s.batch * s.filters * oh * ow;
+    uint32_t out_shape[] = {s.batch, s.filters, oh, ow};
+    rtka_tensor_t* output = input->ndim == 4 ? rtka_tensor_create(out_shape, 4)
+                                             : rtka_tensor_create(out_shape + 1, 3);
+    rtka_allocator_t* owner = NULL;
+    float* x = output ? (float*)rtka_allocator_alloc(NULL, (in_count + out_count) * sizeof(float), &owner)
+                      : NULL;
+    if (!x) {
+        rtka_tensor_free(output);
+        if (transient) rtka_nn_conv2d_release(layer);
+        return NULL;
+    }
+    float* y = x + in_count;
+    
+    for (size_t i = 0; i < in_count; i++) {
+        rtka_state_t st = rtka_tensor_load(input, rtka_tensor_offset(input, (uint32_t)i));
+        x[i] = (float)st.value * st.confidence;
+    }
+    
+    rtka_error_t err = RTKA_SUCCESS;
+    const rtka_tensor_t* weight = layer->base.weight->data;
+    if (algo == RTKA_CONV_WINOGRAD) {
+        err = rtka_conv2d_winograd(&s, x, layer->winograd, y);
+    } else if (algo == RTKA_CONV_TERNARY) {
+        err = rtka_conv2d_ternary(&s, x, layer->taps, y);
+    } else {
+        uint32_t k = s.channels * s.kernel_h * s.kernel_w;
+        rtka_gemm_operand_t w = { weight->data, k, 1, RTKA_GEMM_SIGNED, NULL };
+        if (rtka_tensor_is_soa(weight)) {
+            w.data = weight->values;
+            w.confidences = weight->confidences;
+            w.format = RTKA_GEMM_PLANES;
+        } else if (rtka_tensor_is_ternary(weight)) {
+            w.format = RTKA_GEMM_TERNARY;
+        }
+        err = rtka_conv2d_im2col(&s, x, &w, y);
+    }
+    
+    if (err == RTKA_SUCCESS) {
+        const rtka_tensor_t* bias = layer->base.bias ? layer->base.bias->data : NULL;
+        size_t plane = (size_t)oh * ow;
+        for (size_t i = 0; i < out_count; i++) {
+            float z = y[i];
+            if (bias) {
+                rtka_state_t b = rtka_tensor_load(bias, rtka_tensor_offset(bias, (uint32_t)((i / plane) % s.filters)));
+                z += (float)b.value * b.confidence;
+            }
+            rtka_tensor_store(output, (uint32_t)i, rtka_make_state(
+                z > 0.0f ? RTKA_TRUE : z < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN, fabsf(z)));
+        }
+    }
+    
+    rtka_allocator_free(owner, x);
+    if (transient) rtka_nn_conv2d_release(layer);
+    if (err != RTKA_SUCCESS) {
+        rtka_tensor_free(output);
+        return NULL;
+    }
+    return output;
+}
+
+/* Convolution forward pass; no gradient flows through it yet */
+rtka_grad_node_t* rtka_nn_conv2d_forward(rtka_conv2d_layer_t* layer, rtka_grad_node_t* input) {
+    rtka_tensor_t* out = rtka_nn_conv2d_infer(layer, input->data);
+    return out ? rtka_grad_node_create(out, false) : NULL;
+}
+
 /* Sequential model */
 rtka_sequential_t* rtka_nn_sequential(void) {
-    rtka_sequential_t* model = (rtka_sequential_t*)rtka_alloc_state();
+    rtka_sequential_t* model = (rtka_sequential_t*)calloc(1, sizeof(rtka_sequential_t));
     if (!model) return NULL;
     
     model->capacity = 16;
-    model->layers = (rtka_layer_t**)rtka_alloc_states(model->capacity * sizeof(void*) / sizeof(rtka_state_t));
+    model->layers = (rtka_layer_t**)calloc(model->capacity, sizeof(rtka_layer_t*));
     model->num_layers = 0;
+    if (!model->layers) {
+        free(model);
+        return NULL;
+    }
     
     return model;
 }
@@ -146,10 +480,10 @@ rtka_sequential_t* rtka_nn_sequential(void) {
 void rtka_nn_sequential_add(rtka_sequential_t* model, rtka_layer_t* layer) {
     if (model->num_layers >= model->capacity) {
         /* Expand capacity */
+        rtka_layer_t** new_layers = (rtka_layer_t**)realloc(model->layers,
+                                                            2U * model->capacity * sizeof(rtka_layer_t*));
+        if (!new_layers) return;
         model->capacity *= 2;
-        rtka_layer_t** new_layers = (rtka_layer_t**)rtka_alloc_states(
-            model->capacity * sizeof(void*) / sizeof(rtka_state_t));
-        memcpy(new_layers, model->layers, model->num_layers * sizeof(rtka_layer_t*));
         model->layers = new_layers;
     }
     
@@ -201,8 +535,3 @@ rtka_confidence_t rtka_nn_ternary_mse(rtka_grad_node_t* output, rtka_tensor_t* t
     
     return loss / out_data->size;
 }
-
-/* Random number generator stub - should link with rtka_random.c */
-float rtka_random_float(void) {
-    return (float)rand() / RAND_MAX;
-}
@@ -17,6 +17,9 @@
 #include "rtka_types.h"
 #include "rtka_tensor.h"
 #include "rtka_gradient.h"
+#include "rtka_gemm.h"
+#include "rtka_conv.h"
+#include "rtka_vector.h"
 #include <math.h>
 
 /* Layer types */
@@ -27,7 +30,8 @@ typedef enum {
     LAYER_POOL,
     LAYER_DROPOUT,
     LAYER_BATCHNORM,
-    LAYER_ACTIVATION
+    LAYER_ACTIVATION,
+    LAYER_ATTENTION
 } rtka_layer_type_t;
 
 /* Base layer structure */
@@ -55,14 +59,19 @@ typedef struct {
     bool use_bias;
 } rtka_linear_layer_t;
 
-/* Ternary layer - optimized for ternary weights */
+/* Ternary layer - optimized for ternary weights
+ * Outside training the forward pass runs on `packed`, the weights as
+ * bit-planes (2 bits each), multiply-free. */
 typedef struct {
     rtka_layer_t base;
     rtka_confidence_t threshold;
     bool quantize_activations;
+    rtka_ternary_matrix_t* packed;  /* NULL until first inference */
 } rtka_ternary_layer_t;
 
-/* Convolutional layer */
+/* Convolutional layer - weight (out, in, kh, kw), bias (out), input and
+ * output NCHW. Outside training the kernel's weight form is cached:
+ * Winograd transforms or ternary tap lists, NULL until first inference. */
 typedef struct {
     rtka_layer_t base;
     uint32_t kernel_size[2];
@@ -70,6 +79,9 @@ typedef struct {
     uint32_t padding[2];
     uint32_t in_channels;
     uint32_t out_channels;
+    rtka_conv_algo_t algo;          /* RTKA_CONV_AUTO picks from the weights */
+    float* winograd;                /* rtka_conv_winograd_size floats */
+    rtka_conv_taps_t* taps;
 } rtka_conv2d_layer_t;
 
 /* Activation functions for ternary logic */
@@ -86,20 +98,41 @@ rtka_ternary_layer_t* rtka_nn_ternary(uint32_t in_features, uint32_t out_feature
 rtka_conv2d_layer_t* rtka_nn_conv2d(uint32_t in_channels, uint32_t out_channels, 
                                     uint32_t kernel_size, uint32_t stride, uint32_t padding);
 
+/* Layers over existing (in, out) weight and (out) bias tensors, taken over
+ * even on failure. requires_grad false freezes them (no gradients, layer
+ * starts in inference mode), as for read-only mapped model files. */
+rtka_linear_layer_t* rtka_nn_linear_from(rtka_tensor_t* weight, rtka_tensor_t* bias, bool requires_grad);
+rtka_ternary_layer_t* rtka_nn_ternary_from(rtka_tensor_t* weight, rtka_confidence_t threshold,
+                                           bool requires_grad);
+
 /* Forward pass */
 rtka_grad_node_t* rtka_nn_forward(rtka_layer_t* layer, rtka_grad_node_t* input);
 
+/* Ternary inference: (rows, in) -> (rows, out) without touching input.
+ * The bit-planes are packed on first use; call rtka_nn_ternary_pack again
+ * after the weights change. */
+rtka_tensor_t* rtka_nn_ternary_infer(rtka_ternary_layer_t* layer, const rtka_tensor_t* input);
+bool rtka_nn_ternary_pack(rtka_ternary_layer_t* layer);
+
+/* Convolution: (N, C, H, W) or (C, H, W) -> (N, O, OH, OW) signed states,
+ * bias added, without touching input. Forward only: the output node
+ * carries no gradient. rtka_nn_conv2d_prepare rebuilds the cached weight
+ * form; call it after the weights of an inference layer change. */
+rtka_tensor_t* rtka_nn_conv2d_infer(rtka_conv2d_layer_t* layer, const rtka_tensor_t* input);
+bool rtka_nn_conv2d_prepare(rtka_conv2d_layer_t* layer);
+void rtka_nn_conv2d_release(rtka_conv2d_layer_t* layer);
+
 /* Activation functions */
 rtka_grad_node_t* rtka_nn_ternary_activation(rtka_grad_node_t* input, rtka_activation_t type, rtka_confidence_t threshold);
 
-/* Ternary-specific activation - smooth approximation */
+/* Ternary-specific activation - smooth approximation, tanh polynomial */
 RTKA_INLINE rtka_state_t rtka_ternary_sigmoid(rtka_state_t x, rtka_confidence_t threshold) {
     rtka_confidence_t conf = x.confidence;
     
     if (conf > threshold) {
-        return rtka_make_state(RTKA_TRUE, tanhf(conf));
+        return rtka_make_state(RTKA_TRUE, rtka_fast_tanhf(conf));
     } else if (conf < -threshold) {
-        return rtka_make_state(RTKA_FALSE, tanhf(-conf));
+        return rtka_make_state(RTKA_FALSE, rtka_fast_tanhf(-conf));
     } else {
         return rtka_make_state(RTKA_UNKNOWN, fabsf(conf) / threshold);
     }
@@ -134,6 +167,12 @@ rtka_grad_node_t* rtka_nn_sequential_forward(rtka_sequential_t* model, rtka_grad
 void rtka_nn_init_ternary_uniform(rtka_tensor_t* weight, rtka_confidence_t threshold);
 void rtka_nn_init_ternary_normal(rtka_tensor_t* weight, rtka_confidence_t std);
 
+/* Bulk draws from the calling thread's stream (rtka_random_thread):
+ * confidences uniform in [-scale, scale) on UNKNOWN, or equiprobable
+ * ternary values with UNKNOWN at half confidence */
+void rtka_nn_init_uniform(rtka_tensor_t* weight, rtka_confidence_t scale);
+void rtka_nn_init_ternary(rtka_tensor_t* weight);
+
 /* Loss functions for ternary outputs */
 rtka_confidence_t rtka_nn_ternary_cross_entropy(rtka_grad_node_t* output, rtka_tensor_t* target);
 rtka_confidence_t rtka_nn_ternary_mse(rtka_grad_node_t* output, rtka_tensor_t* target);
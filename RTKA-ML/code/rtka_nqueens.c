@@ -12,7 +12,10 @@
  */
 
 #include "rtka_nqueens.h"
+#include "rtka_random.h"
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
@@ -309,12 +312,328 @@ bool rtka_nqueens_solve(nqueens_state_t* state) {
     return solve_recursive_enhanced(state, 0);
 }
 
+/* ============================================================================
+ * BITMASK ENGINE
+ * ============================================================================ */
+
+/* Bit c is column c; ld moves one column right per row, rd one left */
+static inline uint64_t nq_all(uint32_t n) {
+    return n >= 64U ? ~0ULL : (1ULL << n) - 1U;
+}
+
+static uint64_t nq_count(uint64_t all, uint64_t cols, uint64_t ld, uint64_t rd) {
+    if (cols == all) return 1;
+    uint64_t count = 0;
+    uint64_t avail = all & ~(cols | ld | rd);
+    while (avail) {
+        uint64_t bit = avail & (~avail + 1U);
+        avail ^= bit;
+        count += nq_count(all, cols | bit, (ld | bit) << 1, (rd | bit) >> 1);
+    }
+    return count;
+}
+
+/* Rows 0-1 fixed; weight 2 stands for the mirror image */
+typedef struct {
+    uint64_t cols, ld, rd;
+    uint32_t weight;
+} nq_prefix_t;
+
+/* Prefixes with the row-0 queen in the left half, plus the middle column
+ * of an odd board with the row-1 queen in the left half */
+static uint32_t nq_prefixes(uint32_t n, nq_prefix_t* out) {
+    uint32_t count = 0, mid = n / 2U;
+    for (uint32_t c0 = 0; c0 < mid + (n & 1U); c0++) {
+        for (uint32_t c1 = 0; c1 < n; c1++) {
+            if (c1 + 1U >= c0 && c1 <= c0 + 1U) continue;     /* Same column or diagonal */
+            if (c0 == mid && c1 > mid) continue;
+            uint64_t b0 = 1ULL << c0, b1 = 1ULL << c1;
+            out[count++] = (nq_prefix_t){b0 | b1, ((b0 << 1) | b1) << 1, ((b0 >> 1) | b1) >> 1, 2U};
+        }
+    }
+    return count;
+}
+
+uint64_t rtka_nqueens_count(uint32_t n) {
+    if (n == 0 || n > NQUEENS_BITS_MAX_SIZE) return 0;
+    if (n == 1) return 1;
+    nq_prefix_t prefixes[NQUEENS_BITS_MAX_SIZE * NQUEENS_BITS_MAX_SIZE / 2U + NQUEENS_BITS_MAX_SIZE];
+    uint32_t count = nq_prefixes(n, prefixes);
+    uint64_t all = nq_all(n), total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        total += prefixes[i].weight * nq_count(all, prefixes[i].cols, prefixes[i].ld, prefixes[i].rd);
+    }
+    return total;
+}
+
+/* Fork-join over the pool's deques: a board with more than NQ_SERIAL_ROWS
+ * rows left spawns one task per free column and waits for them, helping;
+ * the rest is counted serially. Idle workers steal the oldest, shallowest
+ * boards, which hold the most work. */
+#define NQ_SERIAL_ROWS 12U
+
+typedef struct {
+    rtka_thread_pool_t* pool;
+    uint64_t all;
+    uint32_t n;
+    atomic_uint_fast64_t total;
+} nq_parallel_t;
+
+typedef struct {
+    nq_parallel_t* job;
+    uint64_t cols, ld, rd;
+    uint32_t weight;
+} nq_task_t;
+
+static void nq_fork(void* arg) {
+    const nq_task_t* t = (const nq_task_t*)arg;
+    nq_parallel_t* p = t->job;
+    if (p->n - (uint32_t)__builtin_popcountll(t->cols) <= NQ_SERIAL_ROWS) {
+        atomic_fetch_add_explicit(&p->total, t->weight * nq_count(p->all, t->cols, t->ld, t->rd),
+                                  memory_order_relaxed);
+        return;
+    }
+
+    nq_task_t children[NQUEENS_BITS_MAX_SIZE];
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    uint32_t count = 0;
+    uint64_t avail = p->all & ~(t->cols | t->ld | t->rd);
+    while (avail) {
+        uint64_t bit = avail & (~avail + 1U);
+        avail ^= bit;
+        nq_task_t* c = &children[count++];
+        *c = (nq_task_t){p, t->cols | bit, (t->ld | bit) << 1, (t->rd | bit) >> 1, t->weight};
+        if (rtka_pool_spawn(p->pool, &group, nq_fork, c) != RTKA_SUCCESS) nq_fork(c);
+    }
+    rtka_pool_wait_group(p->pool, &group);
+}
+
+uint64_t rtka_nqueens_count_parallel(uint32_t n, rtka_thread_pool_t* pool) {
+    if (n == 0 || n > NQUEENS_BITS_MAX_SIZE) return 0;
+    if (!pool) pool = rtka_pool_default();
+    if (n < 6 || !pool) return rtka_nqueens_count(n);
+
+    nq_prefix_t prefixes[NQUEENS_BITS_MAX_SIZE * NQUEENS_BITS_MAX_SIZE / 2U + NQUEENS_BITS_MAX_SIZE];
+    nq_task_t tasks[NQUEENS_BITS_MAX_SIZE * NQUEENS_BITS_MAX_SIZE / 2U + NQUEENS_BITS_MAX_SIZE];
+    nq_parallel_t p = {.pool = pool, .all = nq_all(n), .n = n};
+    atomic_init(&p.total, 0);
+
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    uint32_t count = nq_prefixes(n, prefixes);
+    for (uint32_t i = 0; i < count; i++) {
+        tasks[i] = (nq_task_t){&p, prefixes[i].cols, prefixes[i].ld, prefixes[i].rd, prefixes[i].weight};
+        if (rtka_pool_spawn(pool, &group, nq_fork, &tasks[i]) != RTKA_SUCCESS) nq_fork(&tasks[i]);
+    }
+    rtka_pool_wait_group(pool, &group);
+    return atomic_load(&p.total);
+}
+
+typedef struct {
+    uint32_t n;
+    uint64_t all;
+    uint64_t max;
+    uint64_t found;
+    nqueens_visit_fn visit;
+    void* ctx;
+    bool stop;
+    uint8_t cols[NQUEENS_BITS_MAX_SIZE];
+} nq_enum_t;
+
+static void nq_enumerate(nq_enum_t* e, uint32_t row, uint64_t cols, uint64_t ld, uint64_t rd) {
+    if (row == e->n) {
+        e->found++;
+        if ((e->visit && !e->visit(e->ctx, e->cols, e->n)) || e->found == e->max) e->stop = true;
+        return;
+    }
+    uint64_t avail = e->all & ~(cols | ld | rd);
+    while (avail && !e->stop) {
+        uint64_t bit = avail & (~avail + 1U);
+        avail ^= bit;
+        e->cols[row] = (uint8_t)__builtin_ctzll(bit);
+        nq_enumerate(e, row + 1U, cols | bit, (ld | bit) << 1, (rd | bit) >> 1);
+    }
+}
+
+uint64_t rtka_nqueens_enumerate(uint32_t n, uint64_t max_solutions, nqueens_visit_fn visit, void* ctx) {
+    if (n == 0 || n > NQUEENS_BITS_MAX_SIZE) return 0;
+    nq_enum_t e = {.n = n, .all = nq_all(n), .max = max_solutions, .visit = visit, .ctx = ctx};
+    nq_enumerate(&e, 0, 0, 0, 0);
+    return e.found;
+}
+
+bool rtka_nqueens_load(nqueens_state_t* state, const uint8_t* cols, uint32_t n) {
+    if (n == 0 || n > NQUEENS_MAX_SIZE) return false;
+    rtka_nqueens_init(state, n);
+    for (uint32_t row = 0; row < n; row++) {
+        if (cols[row] >= n || !rtka_nqueens_place_queen_propagate(state, row, cols[row])) return false;
+    }
+    return true;
+}
+
+/* ============================================================================
+ * MIN-CONFLICTS
+ * ============================================================================ */
+
+/* Greedy placement attempts per row before accepting a conflict */
+#define NQ_MC_ATTEMPTS 32U
+
+typedef struct {
+    uint32_t n;
+    uint32_t* cols;
+    uint32_t* d1;                   /* Queens on diagonal r + c */
+    uint32_t* d2;                   /* Queens on anti-diagonal r - c + n - 1 */
+    uint32_t* work;                 /* Rows to repair */
+    rtka_rng_t rng;
+} nq_mc_t;
+
+static inline uint32_t nq_mc_below(nq_mc_t* m, uint32_t bound) {
+    return (uint32_t)(((uint64_t)rtka_random_uint32(&m->rng) * bound) >> 32);
+}
+
+static inline void nq_mc_add(nq_mc_t* m, uint32_t row, uint32_t col, uint32_t delta) {
+    m->d1[row + col] += delta;
+    m->d2[row + m->n - 1U - col] += delta;
+}
+
+static inline bool nq_mc_attacked(const nq_mc_t* m, uint32_t row) {
+    uint32_t col = m->cols[row];
+    return m->d1[row + col] > 1U || m->d2[row + m->n - 1U - col] > 1U;
+}
+
+/* Random permutation placed row by row, swapping in a later column that
+ * lands on two empty diagonals when one is found within the attempt limit */
+static uint32_t nq_mc_place(nq_mc_t* m) {
+    uint32_t n = m->n;
+    for (uint32_t r = 0; r < n; r++) m->cols[r] = r;
+    memset(m->d1, 0, (2U * (size_t)n - 1U) * sizeof(uint32_t));
+    memset(m->d2, 0, (2U * (size_t)n - 1U) * sizeof(uint32_t));
+
+    for (uint32_t r = 0; r < n; r++) {
+        for (uint32_t a = 0; a < NQ_MC_ATTEMPTS; a++) {
+            uint32_t j = r + nq_mc_below(m, n - r);
+            uint32_t c = m->cols[j];
+            if (m->d1[r + c] == 0 && m->d2[r + n - 1U - c] == 0) {
+                m->cols[j] = m->cols[r];
+                m->cols[r] = c;
+                break;
+            }
+        }
+        nq_mc_add(m, r, m->cols[r], 1U);
+    }
+
+    uint32_t attacked = 0;
+    for (uint32_t r = 0; r < n; r++) attacked += nq_mc_attacked(m, r);
+    return attacked;
+}
+
+/* Swap the columns of rows i and j when that lowers the attacking pairs;
+ * both queens are lifted off the board to price their placements. The two
+ * share a diagonal after the swap exactly when they did before, so only
+ * the other queens decide. */
+static bool nq_mc_try_swap(nq_mc_t* m, uint32_t i, uint32_t j) {
+    uint32_t n = m->n, ci = m->cols[i], cj = m->cols[j];
+    nq_mc_add(m, i, ci, (uint32_t)-1);
+    nq_mc_add(m, j, cj, (uint32_t)-1);
+
+    uint32_t before = m->d1[i + ci] + m->d2[i + n - 1U - ci] + m->d1[j + cj] + m->d2[j + n - 1U - cj];
+    uint32_t after = m->d1[i + cj] + m->d2[i + n - 1U - cj] + m->d1[j + ci] + m->d2[j + n - 1U - ci];
+    bool keep = after < before;
+    if (keep) {
+        m->cols[i] = cj;
+        m->cols[j] = ci;
+    }
+    nq_mc_add(m, i, m->cols[i], 1U);
+    nq_mc_add(m, j, m->cols[j], 1U);
+    return keep;
+}
+
+bool rtka_nqueens_min_conflicts(uint32_t n, uint32_t* cols, uint64_t seed, uint64_t max_steps,
+                                nqueens_mc_stats_t* stats) {
+    nqueens_mc_stats_t local = {0};
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(nqueens_mc_stats_t));
+    if (!cols || n == 0 || n == 2 || n == 3 || n > UINT32_MAX / 2U) return false;
+    if (n == 1) {
+        cols[0] = 0;
+        return true;
+    }
+    if (max_steps == 0) max_steps = 100ULL * n + 1000000ULL;
+
+    nq_mc_t m = {.n = n, .cols = cols};
+    m.d1 = (uint32_t*)malloc((2U * (size_t)n - 1U) * sizeof(uint32_t));
+    m.d2 = (uint32_t*)malloc((2U * (size_t)n - 1U) * sizeof(uint32_t));
+    m.work = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    if (!m.d1 || !m.d2 || !m.work) {
+        free(m.d1);
+        free(m.d2);
+        free(m.work);
+        return false;
+    }
+    rtka_random_init_splitmix(&m.rng, seed);
+
+    bool solved = false;
+    while (!solved && stats->steps < max_steps) {
+        uint32_t attacked = nq_mc_place(&m);
+        if (stats->restarts == 0) stats->initial_conflicts = attacked;
+
+        /* Repair from a stack of attacked rows; a swap can also expose queens
+         * already on the new diagonals, so an empty stack is refilled by a
+         * full scan, and only a scan that finds nothing ends the search.
+         * Small boards can stall in a local minimum, hence a per-restart
+         * budget. */
+        uint64_t budget = stats->steps + 20ULL * n + 10000ULL;
+        while (stats->steps < max_steps && stats->steps < budget) {
+            uint32_t top = 0;
+            for (uint32_t r = 0; r < n; r++) {
+                if (nq_mc_attacked(&m, r)) m.work[top++] = r;
+            }
+            if (top == 0) {
+                solved = true;
+                break;
+            }
+            while (top && stats->steps < max_steps && stats->steps < budget) {
+                uint32_t i = m.work[--top];
+                if (!nq_mc_attacked(&m, i)) continue;
+                uint32_t j = nq_mc_below(&m, n);
+                stats->steps++;
+                if (j != i && nq_mc_try_swap(&m, i, j)) {
+                    stats->swaps++;
+                    if (top < n - 1U && nq_mc_attacked(&m, j)) m.work[top++] = j;
+                }
+                if (nq_mc_attacked(&m, i)) m.work[top++] = i;
+            }
+        }
+        if (!solved) stats->restarts++;
+    }
+    free(m.d1);
+    free(m.d2);
+    free(m.work);
+    return solved;
+}
+
+static bool nq_keep_first(void* ctx, const uint8_t* cols, uint32_t n) {
+    uint8_t* first = (uint8_t*)ctx;
+    if (first[NQUEENS_BITS_MAX_SIZE] == 0) {
+        memcpy(first, cols, n);
+        first[NQUEENS_BITS_MAX_SIZE] = 1;
+    }
+    return true;
+}
+
 /* Find all solutions */
 bool rtka_nqueens_solve_all(nqueens_state_t* state, uint32_t* solution_count, uint32_t max_solutions) {
-    (void)max_solutions; /* TODO: implement all solutions */
-    *solution_count = 0;
-    /* Implementation would recursively find all solutions */
-    return solve_recursive_enhanced(state, 0);
+    uint8_t first[NQUEENS_BITS_MAX_SIZE + 1U] = {0};
+    uint64_t count;
+    if (max_solutions == 0) {
+        count = rtka_nqueens_count(state->n);
+        if (count) rtka_nqueens_enumerate(state->n, 1, nq_keep_first, first);
+    } else {
+        count = rtka_nqueens_enumerate(state->n, max_solutions, nq_keep_first, first);
+    }
+    *solution_count = count > UINT32_MAX ? UINT32_MAX : (uint32_t)count;
+    return count > 0 && rtka_nqueens_load(state, first, state->n);
 }
 
 /* Validate solution */
@@ -9,6 +9,21 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA N-Queens Solver - Enhanced with full ternary propagation
+ *
+ * CHANGELOG:
+ * v2.1.0 - Bitmask engine for counting and enumeration: columns and both
+ *          diagonals as uint64_t masks, boards up to NQUEENS_BITS_MAX_SIZE.
+ *          Counting folds the left-right mirror and splits the first two
+ *          rows into tasks for rtka_pool_parallel_for. The ternary board is
+ *          kept for rtka_nqueens_solve() and as a diagnostic view of any
+ *          bitmask solution via rtka_nqueens_load().
+ * v2.2.0 - Min-conflicts local search for very large boards: one column per
+ *          row kept as a permutation plus two diagonal counters, O(n)
+ *          memory in all. Greedy conflict-free placement, then swap repair
+ *          of attacked queens.
+ * v2.2.1 - Parallel counting forks on the pool's work-stealing deques: one
+ *          task per two-row prefix, each splitting again per free column
+ *          while more than 12 rows are left.
  */
 
 #ifndef RTKA_NQUEENS_H
@@ -16,10 +31,12 @@
 
 #include "rtka_types.h"
 #include "rtka_u_core.h"
+#include "rtka_threadpool.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 #define NQUEENS_MAX_SIZE 32
+#define NQUEENS_BITS_MAX_SIZE 64    /* One uint64_t per constraint family */
 
 typedef struct {
     /* Ternary board state: TRUE=queen, FALSE=threatened, UNKNOWN=possible */
@@ -54,8 +71,42 @@ typedef struct {
 /* Core functions */
 void rtka_nqueens_init(nqueens_state_t* state, uint32_t n);
 bool rtka_nqueens_solve(nqueens_state_t* state);
+/* Counts solutions up to max_solutions (0 = all, saturating at UINT32_MAX)
+ * with the bitmask engine and loads the first into the ternary board */
 bool rtka_nqueens_solve_all(nqueens_state_t* state, uint32_t* solution_count, uint32_t max_solutions);
 
+/* Bitmask engine, n <= NQUEENS_BITS_MAX_SIZE (0 solutions outside 1..64) */
+typedef bool (*nqueens_visit_fn)(void* ctx, const uint8_t* cols, uint32_t n);
+
+uint64_t rtka_nqueens_count(uint32_t n);
+
+/* Same count, forked over pool (NULL = default) from the two-row prefixes */
+uint64_t rtka_nqueens_count_parallel(uint32_t n, rtka_thread_pool_t* pool);
+
+/* Calls visit with cols[row] = column for each solution in lexicographic
+ * order until it returns false or max_solutions (0 = no limit) were seen;
+ * returns the number visited */
+uint64_t rtka_nqueens_enumerate(uint32_t n, uint64_t max_solutions, nqueens_visit_fn visit, void* ctx);
+
+/* Min-conflicts search statistics */
+typedef struct {
+    uint32_t initial_conflicts;     /* Attacked queens after greedy placement */
+    uint64_t steps;                 /* Swaps evaluated */
+    uint64_t swaps;                 /* Swaps kept */
+    uint32_t restarts;
+} nqueens_mc_stats_t;
+
+/* Single solution by min-conflicts for any n >= 4 up to UINT32_MAX / 2;
+ * cols receives n columns. max_steps bounds evaluated swaps over all
+ * restarts (0 = 100n + 10^6). false when n has no solution or the budget
+ * runs out; stats may be NULL. */
+bool rtka_nqueens_min_conflicts(uint32_t n, uint32_t* cols, uint64_t seed, uint64_t max_steps,
+                                nqueens_mc_stats_t* stats);
+
+/* Ternary diagnostic view of a solution: init, then place row by row with
+ * propagation. false if n > NQUEENS_MAX_SIZE or a queen is attacked. */
+bool rtka_nqueens_load(nqueens_state_t* state, const uint8_t* cols, uint32_t n);
+
 /* Enhanced RTKA operations */
 bool rtka_nqueens_place_queen_propagate(nqueens_state_t* state, uint32_t row, uint32_t col);
 void rtka_nqueens_remove_queen_restore(nqueens_state_t* state, uint32_t row, uint32_t col);
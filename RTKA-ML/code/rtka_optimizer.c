@@ -15,11 +15,12 @@
 #include "rtka_optimizer.h"
 #include "rtka_memory.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* Create SGD optimizer */
 rtka_optimizer_t* rtka_optimizer_sgd(rtka_confidence_t lr, rtka_confidence_t momentum) {
-    rtka_optimizer_t* opt = (rtka_optimizer_t*)rtka_alloc_state();
+    rtka_optimizer_t* opt = (rtka_optimizer_t*)calloc(1, sizeof(rtka_optimizer_t));
     if (!opt) return NULL;
     
     opt->type = OPT_SGD;
@@ -29,13 +30,14 @@ rtka_optimizer_t* rtka_optimizer_sgd(rtka_confidence_t lr, rtka_confidence_t mom
     opt->step = 0;
     opt->buffer_count = 0;
     opt->momentum_buffers = NULL;
+    opt->velocity_buffers = NULL;
     
     return opt;
 }
 
 /* Create Adam optimizer */
 rtka_optimizer_t* rtka_optimizer_adam(rtka_confidence_t lr, rtka_confidence_t beta1, rtka_confidence_t beta2) {
-    rtka_optimizer_t* opt = (rtka_optimizer_t*)rtka_alloc_state();
+    rtka_optimizer_t* opt = (rtka_optimizer_t*)calloc(1, sizeof(rtka_optimizer_t));
     if (!opt) return NULL;
     
     opt->type = OPT_ADAM;
@@ -53,7 +55,7 @@ rtka_optimizer_t* rtka_optimizer_adam(rtka_confidence_t lr, rtka_confidence_t be
 
 /* Create ternary optimizer */
 rtka_optimizer_t* rtka_optimizer_ternary(rtka_confidence_t lr, rtka_confidence_t threshold) {
-    rtka_optimizer_t* opt = (rtka_optimizer_t*)rtka_alloc_state();
+    rtka_optimizer_t* opt = (rtka_optimizer_t*)calloc(1, sizeof(rtka_optimizer_t));
     if (!opt) return NULL;
     
     opt->type = OPT_TERNARY;
@@ -61,15 +63,36 @@ rtka_optimizer_t* rtka_optimizer_ternary(rtka_confidence_t lr, rtka_confidence_t
     opt->confidence_threshold = threshold;
     opt->use_ternary_quantization = true;
     opt->step = 0;
+    opt->buffer_count = 0;
+    opt->momentum_buffers = NULL;
+    opt->velocity_buffers = NULL;
     
     return opt;
 }
 
+/* Optimizer state outlives the step arena the update runs in */
+static rtka_tensor_t* state_buffer(const rtka_tensor_t* param) {
+    return rtka_tensor_zeros_in(rtka_heap_allocator(), param->shape, param->ndim);
+}
+
+static rtka_tensor_t** state_buffer_array(rtka_tensor_t** old, uint32_t old_count, uint32_t count) {
+    rtka_allocator_t* heap = rtka_heap_allocator();
+    rtka_tensor_t** buffers = (rtka_tensor_t**)heap->alloc(count * sizeof(rtka_tensor_t*), heap->context);
+    if (!buffers) return old;
+    
+    memset(buffers, 0, count * sizeof(rtka_tensor_t*));
+    if (old) {
+        memcpy(buffers, old, old_count * sizeof(rtka_tensor_t*));
+        heap->free(old, heap->context);
+    }
+    return buffers;
+}
+
 /* SGD update step */
 static void sgd_step(rtka_optimizer_t* opt, rtka_tensor_t* param, rtka_tensor_t* grad, uint32_t idx) {
     /* Initialize momentum buffer if needed */
     if (opt->momentum > 0 && !opt->momentum_buffers[idx]) {
-        opt->momentum_buffers[idx] = rtka_tensor_zeros(param->shape, param->ndim);
+        opt->momentum_buffers[idx] = state_buffer(param);
     }
     
     for (uint32_t i = 0; i < param->size; i++) {
@@ -95,8 +118,8 @@ static void adam_step(rtka_optimizer_t* opt, rtka_tensor_t* param, rtka_tensor_t
     
     /* Initialize buffers */
     if (!opt->momentum_buffers[idx]) {
-        opt->momentum_buffers[idx] = rtka_tensor_zeros(param->shape, param->ndim);
-        opt->velocity_buffers[idx] = rtka_tensor_zeros(param->shape, param->ndim);
+        opt->momentum_buffers[idx] = state_buffer(param);
+        opt->velocity_buffers[idx] = state_buffer(param);
     }
     
     /* Bias correction */
@@ -150,8 +173,8 @@ static void ternary_step(rtka_optimizer_t* opt, rtka_tensor_t* param, rtka_tenso
 void rtka_optimizer_step(rtka_optimizer_t* opt, rtka_grad_node_t** parameters, uint32_t param_count) {
     /* Allocate buffers if needed */
     if (opt->buffer_count < param_count) {
-        opt->momentum_buffers = (rtka_tensor_t**)rtka_alloc_states(param_count * sizeof(void*) / sizeof(rtka_state_t));
-        opt->velocity_buffers = (rtka_tensor_t**)rtka_alloc_states(param_count * sizeof(void*) / sizeof(rtka_state_t));
+        opt->momentum_buffers = state_buffer_array(opt->momentum_buffers, opt->buffer_count, param_count);
+        opt->velocity_buffers = state_buffer_array(opt->velocity_buffers, opt->buffer_count, param_count);
         opt->buffer_count = param_count;
     }
     
@@ -185,9 +208,57 @@ void rtka_optimizer_zero_grad(rtka_optimizer_t* opt, rtka_grad_node_t** paramete
     }
 }
 
+/* Snap every parameter to the nearest of {-1, 0, +1} on the signed plane,
+ * so rtka_tensor_is_ternary holds and the bit-plane kernels are exact */
+void rtka_optimizer_apply_ternary_constraint(rtka_tensor_t* params) {
+    for (uint32_t i = 0; i < params->size; i++) {
+        rtka_confidence_t s = params->data[i].confidence * (rtka_confidence_t)params->data[i].value;
+        if (s >= 0.5f) {
+            params->data[i] = rtka_make_state(RTKA_TRUE, 1.0f);
+        } else if (s <= -0.5f) {
+            params->data[i] = rtka_make_state(RTKA_FALSE, 1.0f);
+        } else {
+            params->data[i].value = RTKA_UNKNOWN;
+        }
+    }
+}
+
+/* Ternary gradient compression: entries under threshold * max|g| drop to
+ * zero, the rest become sign(g) times the mean magnitude of the kept
+ * entries, so the gradient travels as two bit-planes and one scale. The
+ * kept entries keep their sum of magnitudes. */
+void rtka_optimizer_quantize_gradients(rtka_tensor_t* grad, rtka_confidence_t threshold) {
+    if (!grad || !grad->data || grad->size == 0) return;
+    
+    rtka_confidence_t max_abs = 0.0f;
+    for (uint32_t i = 0; i < grad->size; i++) {
+        rtka_confidence_t a = fabsf(grad->data[i].confidence);
+        if (a > max_abs) max_abs = a;
+    }
+    if (max_abs == 0.0f) return;
+    
+    rtka_confidence_t cut = threshold * max_abs;
+    rtka_confidence_t kept_sum = 0.0f;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < grad->size; i++) {
+        rtka_confidence_t a = fabsf(grad->data[i].confidence);
+        if (a > 0.0f && a >= cut) {
+            kept_sum += a;
+            kept++;
+        }
+    }
+    
+    rtka_confidence_t scale = kept_sum / (rtka_confidence_t)kept;
+    for (uint32_t i = 0; i < grad->size; i++) {
+        rtka_confidence_t g = grad->data[i].confidence;
+        rtka_confidence_t a = fabsf(g);
+        grad->data[i].confidence = (a > 0.0f && a >= cut) ? (g > 0.0f ? scale : -scale) : 0.0f;
+    }
+}
+
 /* Create scheduler */
 rtka_lr_scheduler_t* rtka_scheduler_create(rtka_confidence_t initial_lr, uint32_t schedule_type) {
-    rtka_lr_scheduler_t* scheduler = (rtka_lr_scheduler_t*)rtka_alloc_state();
+    rtka_lr_scheduler_t* scheduler = (rtka_lr_scheduler_t*)calloc(1, sizeof(rtka_lr_scheduler_t));
     if (!scheduler) return NULL;
     
     scheduler->initial_lr = initial_lr;
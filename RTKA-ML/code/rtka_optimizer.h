@@ -80,7 +80,8 @@ void rtka_optimizer_free(rtka_optimizer_t* opt);
 void rtka_optimizer_step(rtka_optimizer_t* opt, rtka_grad_node_t** parameters, uint32_t param_count);
 void rtka_optimizer_zero_grad(rtka_optimizer_t* opt, rtka_grad_node_t** parameters, uint32_t param_count);
 
-/* Ternary-specific optimization */
+/* Ternary-specific optimization; quantize_gradients maps every entry to
+ * {-s, 0, +s} in place, zero below threshold * max|g| (threshold in [0, 1]) */
 void rtka_optimizer_quantize_gradients(rtka_tensor_t* grad, rtka_confidence_t threshold);
 void rtka_optimizer_apply_ternary_constraint(rtka_tensor_t* params);
 
@@ -0,0 +1,268 @@
+/**
+ * File: rtka_perf.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Search Instrumentation Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "rtka_perf.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char* const g_counter_names[RTKA_PERF_COUNTER_COUNT] = {
+    [RTKA_PERF_SAT_PROPAGATIONS]  = "sat_propagations",
+    [RTKA_PERF_SAT_DECISIONS]     = "sat_decisions",
+    [RTKA_PERF_SAT_CONFLICTS]     = "sat_conflicts",
+    [RTKA_PERF_SUDOKU_NODES]      = "sudoku_nodes",
+    [RTKA_PERF_SUDOKU_BACKTRACKS] = "sudoku_backtracks",
+    [RTKA_PERF_IDA_ITERATIONS]    = "ida_iterations",
+    [RTKA_PERF_IDA_NODES]         = "ida_nodes",
+    [RTKA_PERF_ASTAR_EXPANSIONS]  = "astar_expansions",
+    [RTKA_PERF_ASTAR_NEIGHBORS]   = "astar_neighbors",
+};
+
+static const char* const g_counter_help[RTKA_PERF_COUNTER_COUNT] = {
+    [RTKA_PERF_SAT_PROPAGATIONS]  = "Literals propagated by SAT search",
+    [RTKA_PERF_SAT_DECISIONS]     = "Branching literals picked by SAT search",
+    [RTKA_PERF_SAT_CONFLICTS]     = "Conflicts met by SAT search",
+    [RTKA_PERF_SUDOKU_NODES]      = "Search nodes of rtka_solve_recursive",
+    [RTKA_PERF_SUDOKU_BACKTRACKS] = "Sudoku guesses undone",
+    [RTKA_PERF_IDA_ITERATIONS]    = "IDA* thresholds searched",
+    [RTKA_PERF_IDA_NODES]         = "IDA* nodes visited",
+    [RTKA_PERF_ASTAR_EXPANSIONS]  = "A* nodes expanded",
+    [RTKA_PERF_ASTAR_NEIGHBORS]   = "A* neighbors generated",
+};
+
+static const char* const g_timer_names[RTKA_PERF_TIMER_COUNT] = {
+    [RTKA_PERF_TIMER_SAT_PROPAGATE] = "sat_propagate",
+    [RTKA_PERF_TIMER_SAT_DECIDE]    = "sat_decide",
+    [RTKA_PERF_TIMER_SUDOKU_SOLVE]  = "sudoku_solve",
+    [RTKA_PERF_TIMER_IDA_THRESHOLD] = "ida_threshold",
+    [RTKA_PERF_TIMER_ASTAR_EXPAND]  = "astar_expand",
+};
+
+const char* rtka_perf_counter_name(rtka_perf_counter_t counter) {
+    return (unsigned)counter < RTKA_PERF_COUNTER_COUNT ? g_counter_names[counter] : "unknown";
+}
+
+const char* rtka_perf_timer_name(rtka_perf_timer_t timer) {
+    return (unsigned)timer < RTKA_PERF_TIMER_COUNT ? g_timer_names[timer] : "unknown";
+}
+
+#ifdef RTKA_PERF_ENABLED
+
+_Thread_local rtka_perf_slot_t* rtka_perf_tls_slot = NULL;
+atomic_uint_fast32_t rtka_perf_generation = 0;
+
+/* Slots are pushed, never unlinked: readers walk the list without a lock */
+static _Atomic(rtka_perf_slot_t*) g_perf_slots = NULL;
+static pthread_once_t g_perf_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_perf_key;
+static bool g_perf_key_valid = false;
+
+/* Tick / nanosecond pair of the first attach, for calibration */
+static uint64_t g_epoch_ticks;
+static uint64_t g_epoch_ns;
+
+/* Raw totals at the last reset, subtracted from every snapshot */
+static pthread_mutex_t g_baseline_mutex = PTHREAD_MUTEX_INITIALIZER;
+static rtka_perf_snapshot_t g_baseline;
+
+static uint64_t perf_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void perf_thread_exit(void* arg) {
+    rtka_perf_slot_t* slot = (rtka_perf_slot_t*)arg;
+    /* Events from later destructors attach afresh instead of sharing a slot
+     * the next thread may adopt */
+    rtka_perf_tls_slot = NULL;
+    atomic_store_explicit(&slot->attached, false, memory_order_release);
+}
+
+static void perf_init(void) {
+    g_perf_key_valid = pthread_key_create(&g_perf_key, perf_thread_exit) == 0;
+    g_epoch_ns = perf_monotonic_ns();
+    g_epoch_ticks = rtka_perf_ticks();
+}
+
+static rtka_perf_slot_t* perf_slot_create(void) {
+    rtka_perf_slot_t* slot = aligned_alloc(RTKA_CACHE_LINE_SIZE, sizeof(rtka_perf_slot_t));
+    if (!slot) return NULL;
+
+    for (uint32_t i = 0U; i < RTKA_PERF_COUNTER_COUNT; i++) atomic_init(&slot->counters[i], 0U);
+    for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+        atomic_init(&slot->timer_calls[i], 0U);
+        atomic_init(&slot->timer_ticks[i], 0U);
+    }
+    atomic_init(&slot->depth_max, 0U);
+    atomic_init(&slot->depth_generation,
+                atomic_load_explicit(&rtka_perf_generation, memory_order_relaxed));
+    atomic_init(&slot->attached, true);
+
+    rtka_perf_slot_t* head = atomic_load_explicit(&g_perf_slots, memory_order_relaxed);
+    do {
+        slot->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_perf_slots, &head, slot,
+                                                    memory_order_release, memory_order_relaxed));
+    return slot;
+}
+
+rtka_perf_slot_t* rtka_perf_attach(void) {
+    pthread_once(&g_perf_once, perf_init);
+
+    /* Adopt the slot of an exited thread before growing the registry */
+    rtka_perf_slot_t* slot = atomic_load_explicit(&g_perf_slots, memory_order_acquire);
+    for (; slot; slot = slot->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&slot->attached, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&slot->attached, &expected, true,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (!slot) slot = perf_slot_create();
+    if (!slot) return NULL;
+
+    if (g_perf_key_valid) pthread_setspecific(g_perf_key, slot);
+    rtka_perf_tls_slot = slot;
+    return slot;
+}
+
+/* Raw totals since start; caller holds g_baseline_mutex */
+static void perf_collect(rtka_perf_snapshot_t* raw) {
+    memset(raw, 0, sizeof(*raw));
+    uint_fast32_t generation = atomic_load_explicit(&rtka_perf_generation, memory_order_relaxed);
+
+    for (rtka_perf_slot_t* slot = atomic_load_explicit(&g_perf_slots, memory_order_acquire);
+         slot; slot = slot->next) {
+        for (uint32_t i = 0U; i < RTKA_PERF_COUNTER_COUNT; i++) {
+            raw->counters[i] += atomic_load_explicit(&slot->counters[i], memory_order_relaxed);
+        }
+        for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+            raw->timer_calls[i] += atomic_load_explicit(&slot->timer_calls[i], memory_order_relaxed);
+            raw->timer_ticks[i] += atomic_load_explicit(&slot->timer_ticks[i], memory_order_relaxed);
+        }
+        if (atomic_load_explicit(&slot->depth_generation, memory_order_relaxed) == generation) {
+            uint32_t depth = (uint32_t)atomic_load_explicit(&slot->depth_max, memory_order_relaxed);
+            if (depth > raw->depth_max) raw->depth_max = depth;
+        }
+        raw->threads++;
+    }
+}
+
+void rtka_perf_snapshot(rtka_perf_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    pthread_once(&g_perf_once, perf_init);
+
+    pthread_mutex_lock(&g_baseline_mutex);
+    perf_collect(snapshot);
+    for (uint32_t i = 0U; i < RTKA_PERF_COUNTER_COUNT; i++) {
+        snapshot->counters[i] -= g_baseline.counters[i];
+    }
+    for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+        snapshot->timer_calls[i] -= g_baseline.timer_calls[i];
+        snapshot->timer_ticks[i] -= g_baseline.timer_ticks[i];
+    }
+    pthread_mutex_unlock(&g_baseline_mutex);
+
+    uint64_t elapsed_ticks = rtka_perf_ticks() - g_epoch_ticks;
+    uint64_t elapsed_ns = perf_monotonic_ns() - g_epoch_ns;
+    snapshot->ns_per_tick = elapsed_ticks > 0U ? (double)elapsed_ns / (double)elapsed_ticks : 1.0;
+    for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+        snapshot->timer_ns[i] = (uint64_t)((double)snapshot->timer_ticks[i] * snapshot->ns_per_tick);
+    }
+    snapshot->enabled = true;
+}
+
+void rtka_perf_reset(void) {
+    pthread_once(&g_perf_once, perf_init);
+
+    pthread_mutex_lock(&g_baseline_mutex);
+    perf_collect(&g_baseline);
+    atomic_fetch_add_explicit(&rtka_perf_generation, 1U, memory_order_relaxed);
+    pthread_mutex_unlock(&g_baseline_mutex);
+}
+
+#else /* !RTKA_PERF_ENABLED */
+
+void rtka_perf_snapshot(rtka_perf_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->ns_per_tick = 1.0;
+}
+
+void rtka_perf_reset(void) {
+}
+
+#endif /* RTKA_PERF_ENABLED */
+
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+} perf_writer_t;
+
+static void perf_write(perf_writer_t* w, const char* format, ...) {
+    size_t room = w->length < w->size ? w->size - w->length : 0U;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(room > 0U ? w->buffer + w->length : NULL, room, format, args);
+    va_end(args);
+    if (n > 0) w->length += (size_t)n;
+}
+
+size_t rtka_perf_export(char* buffer, size_t size) {
+    rtka_perf_snapshot_t snap;
+    rtka_perf_snapshot(&snap);
+
+    perf_writer_t w = { .buffer = buffer, .size = buffer ? size : 0U, .length = 0U };
+    if (w.size > 0U) buffer[0] = '\0';
+
+    perf_write(&w, "# HELP rtka_perf_enabled Instrumentation compiled in\n"
+                   "# TYPE rtka_perf_enabled gauge\n"
+                   "rtka_perf_enabled %d\n", snap.enabled ? 1 : 0);
+
+    for (uint32_t i = 0U; i < RTKA_PERF_COUNTER_COUNT; i++) {
+        perf_write(&w, "# HELP rtka_%s_total %s\n"
+                       "# TYPE rtka_%s_total counter\n"
+                       "rtka_%s_total %llu\n",
+                   g_counter_names[i], g_counter_help[i], g_counter_names[i],
+                   g_counter_names[i], (unsigned long long)snap.counters[i]);
+    }
+
+    perf_write(&w, "# HELP rtka_timer_seconds_total Time inside instrumented scopes\n"
+                   "# TYPE rtka_timer_seconds_total counter\n");
+    for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+        perf_write(&w, "rtka_timer_seconds_total{timer=\"%s\"} %.9f\n",
+                   g_timer_names[i], (double)snap.timer_ns[i] * 1e-9);
+    }
+    perf_write(&w, "# HELP rtka_timer_calls_total Instrumented scopes completed\n"
+                   "# TYPE rtka_timer_calls_total counter\n");
+    for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+        perf_write(&w, "rtka_timer_calls_total{timer=\"%s\"} %llu\n",
+                   g_timer_names[i], (unsigned long long)snap.timer_calls[i]);
+    }
+
+    perf_write(&w, "# HELP rtka_search_depth_max Deepest SAT decision level or Sudoku recursion since reset\n"
+                   "# TYPE rtka_search_depth_max gauge\n"
+                   "rtka_search_depth_max %u\n"
+                   "# HELP rtka_perf_threads Per-thread counter slots\n"
+                   "# TYPE rtka_perf_threads gauge\n"
+                   "rtka_perf_threads %u\n",
+               snap.depth_max, snap.threads);
+    return w.length;
+}
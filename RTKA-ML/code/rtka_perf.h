@@ -0,0 +1,189 @@
+/**
+ * File: rtka_perf.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Search Instrumentation
+ * Counters and cycle-counter timers of the solver hot paths
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial instrumentation layer, the counterpart of code/core's
+ *          rtka_perf.h for the solvers
+ *          Compile-time switch: define RTKA_PERF_ENABLED (make perf) to
+ *          collect; otherwise every RTKA_PERF_* macro expands to nothing
+ *          Per-thread counter slots, single writer, summed on read
+ *          Scoped timers on the cycle counter, calibrated to ns against
+ *          CLOCK_MONOTONIC when a snapshot is taken
+ *          Hooks in SAT propagate / decide, rtka_solve_recursive, the
+ *          IDA* threshold loops and A* expansion
+ *          Snapshot and Prometheus text export
+ *
+ * Where rtka_trace.h records when each event happened, this layer keeps
+ * totals cheap enough to leave on in production builds. A thread's first
+ * event attaches it to a slot; the slot returns to the registry at thread
+ * exit and is adopted by the next new thread, so pool workers' counts
+ * outlive them. Writes are a relaxed load/store pair on the thread's own
+ * cache line, never a locked RMW. Reset records a baseline instead of
+ * clearing slots another thread is writing.
+ *
+ *   RTKA_PERF_TIMER_BEGIN(t, RTKA_PERF_TIMER_SAT_DECIDE);
+ *   ... work ...
+ *   RTKA_PERF_TIMER_END(t);
+ *   RTKA_PERF_COUNT(RTKA_PERF_SAT_DECISIONS, 1);
+ */
+
+#ifndef RTKA_PERF_H
+#define RTKA_PERF_H
+
+#include "rtka_types.h"
+#include "rtka_constants.h"
+
+typedef enum {
+    RTKA_PERF_SAT_PROPAGATIONS,     /* Literals propagated */
+    RTKA_PERF_SAT_DECISIONS,        /* Branching literals picked */
+    RTKA_PERF_SAT_CONFLICTS,
+    RTKA_PERF_SUDOKU_NODES,         /* rtka_solve_recursive calls */
+    RTKA_PERF_SUDOKU_BACKTRACKS,    /* Guesses undone */
+    RTKA_PERF_IDA_ITERATIONS,       /* Thresholds searched */
+    RTKA_PERF_IDA_NODES,            /* Nodes visited over all thresholds */
+    RTKA_PERF_ASTAR_EXPANSIONS,     /* Nodes popped and expanded */
+    RTKA_PERF_ASTAR_NEIGHBORS,      /* Neighbors generated by expansions */
+    RTKA_PERF_COUNTER_COUNT
+} rtka_perf_counter_t;
+
+typedef enum {
+    RTKA_PERF_TIMER_SAT_PROPAGATE,  /* One unit propagation pass */
+    RTKA_PERF_TIMER_SAT_DECIDE,     /* One branching literal pick */
+    RTKA_PERF_TIMER_SUDOKU_SOLVE,   /* Outermost rtka_solve_recursive call */
+    RTKA_PERF_TIMER_IDA_THRESHOLD,  /* One IDA* iteration */
+    RTKA_PERF_TIMER_ASTAR_EXPAND,   /* One node expansion */
+    RTKA_PERF_TIMER_COUNT
+} rtka_perf_timer_t;
+
+/* Totals over every thread since start or the last rtka_perf_reset */
+typedef struct {
+    uint64_t counters[RTKA_PERF_COUNTER_COUNT];
+    uint64_t timer_calls[RTKA_PERF_TIMER_COUNT];
+    uint64_t timer_ticks[RTKA_PERF_TIMER_COUNT];
+    uint64_t timer_ns[RTKA_PERF_TIMER_COUNT];
+    uint32_t depth_max;             /* Deepest SAT decision level or Sudoku recursion */
+    uint32_t threads;               /* Slots in the registry */
+    double ns_per_tick;
+    bool enabled;                   /* Built with RTKA_PERF_ENABLED */
+} rtka_perf_snapshot_t;
+
+/* Declared either way; without RTKA_PERF_ENABLED they report zeros */
+void rtka_perf_snapshot(rtka_perf_snapshot_t* snapshot);
+void rtka_perf_reset(void);
+
+/* Prometheus text exposition of a snapshot. Returns the length of the full
+ * text, as snprintf does; output is truncated when it exceeds size. */
+size_t rtka_perf_export(char* buffer, size_t size);
+
+const char* rtka_perf_counter_name(rtka_perf_counter_t counter);
+const char* rtka_perf_timer_name(rtka_perf_timer_t timer);
+
+#ifdef RTKA_PERF_ENABLED
+
+#include <stdatomic.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef struct rtka_perf_slot rtka_perf_slot_t;
+struct rtka_perf_slot {
+    atomic_uint_fast64_t counters[RTKA_PERF_COUNTER_COUNT];
+    atomic_uint_fast64_t timer_calls[RTKA_PERF_TIMER_COUNT];
+    atomic_uint_fast64_t timer_ticks[RTKA_PERF_TIMER_COUNT];
+    atomic_uint_fast32_t depth_max;
+    atomic_uint_fast32_t depth_generation;  /* Reset generation depth_max belongs to */
+    atomic_bool attached;
+    rtka_perf_slot_t* next;
+} RTKA_ALIGNED(RTKA_CACHE_LINE_SIZE);
+
+extern _Thread_local rtka_perf_slot_t* rtka_perf_tls_slot;
+extern atomic_uint_fast32_t rtka_perf_generation;
+
+/* Slow path of the first event on a thread; NULL if no slot could be had */
+rtka_perf_slot_t* rtka_perf_attach(void);
+
+static inline rtka_perf_slot_t* rtka_perf_slot(void) {
+    rtka_perf_slot_t* slot = rtka_perf_tls_slot;
+    return RTKA_LIKELY(slot != NULL) ? slot : rtka_perf_attach();
+}
+
+/* Single writer: a plain load/store pair avoids a locked RMW */
+static inline void rtka_perf_add(atomic_uint_fast64_t* counter, uint64_t n) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+static inline uint64_t rtka_perf_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline void rtka_perf_count(rtka_perf_counter_t counter, uint64_t n) {
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_LIKELY(slot != NULL)) rtka_perf_add(&slot->counters[counter], n);
+}
+
+static inline void rtka_perf_depth(uint32_t depth) {
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_UNLIKELY(slot == NULL)) return;
+    uint_fast32_t generation = atomic_load_explicit(&rtka_perf_generation, memory_order_relaxed);
+    if (RTKA_UNLIKELY(atomic_load_explicit(&slot->depth_generation, memory_order_relaxed) != generation)) {
+        atomic_store_explicit(&slot->depth_max, depth, memory_order_relaxed);
+        atomic_store_explicit(&slot->depth_generation, generation, memory_order_relaxed);
+    } else if (depth > atomic_load_explicit(&slot->depth_max, memory_order_relaxed)) {
+        atomic_store_explicit(&slot->depth_max, depth, memory_order_relaxed);
+    }
+}
+
+typedef struct {
+    rtka_perf_timer_t timer;
+    uint64_t start;
+} rtka_perf_scope_t;
+
+static inline rtka_perf_scope_t rtka_perf_scope_begin(rtka_perf_timer_t timer) {
+    return (rtka_perf_scope_t){ .timer = timer, .start = rtka_perf_ticks() };
+}
+
+static inline void rtka_perf_scope_end(const rtka_perf_scope_t* scope) {
+    uint64_t elapsed = rtka_perf_ticks() - scope->start;
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_UNLIKELY(slot == NULL)) return;
+    rtka_perf_add(&slot->timer_ticks[scope->timer], elapsed);
+    rtka_perf_add(&slot->timer_calls[scope->timer], 1U);
+}
+
+#define RTKA_PERF_COUNT(counter, n) rtka_perf_count((counter), (uint64_t)(n))
+#define RTKA_PERF_DEPTH(depth) rtka_perf_depth((uint32_t)(depth))
+#define RTKA_PERF_TIMER_BEGIN(name, timer) const rtka_perf_scope_t name = rtka_perf_scope_begin(timer)
+#define RTKA_PERF_TIMER_END(name) rtka_perf_scope_end(&(name))
+
+#else /* !RTKA_PERF_ENABLED */
+
+#define RTKA_PERF_COUNT(counter, n) ((void)0)
+#define RTKA_PERF_DEPTH(depth) ((void)0)
+#define RTKA_PERF_TIMER_BEGIN(name, timer) ((void)0)
+#define RTKA_PERF_TIMER_END(name) ((void)0)
+
+#endif /* RTKA_PERF_ENABLED */
+
+#endif /* RTKA_PERF_H */
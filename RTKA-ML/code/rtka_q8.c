@@ -0,0 +1,44 @@
+/**
+ * File: rtka_q8.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Quantized Confidence - batch operations
+ *
+ * Plain loops over the inline operations: without branches or float they
+ * vectorize into byte and 16-bit lanes, 16 states per 256-bit register.
+ */
+
+#include "rtka_q8.h"
+
+#define RTKA_Q8_BATCH(name)                                                           \
+void rtka_q8_##name##_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,          \
+                            rtka_state_q8_t* result, uint32_t count) {                 \
+    for (uint32_t i = 0; i < count; i++) {                                            \
+        result[i] = rtka_q8_##name(a[i], b[i]);                                       \
+    }                                                                                 \
+}
+
+RTKA_Q8_BATCH(and)
+RTKA_Q8_BATCH(or)
+RTKA_Q8_BATCH(nand)
+RTKA_Q8_BATCH(nor)
+RTKA_Q8_BATCH(implies)
+RTKA_Q8_BATCH(equiv)
+
+void rtka_q8_quantize(const rtka_state_t* states, rtka_state_q8_t* result, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        result[i] = rtka_q8_from_state(states[i]);
+    }
+}
+
+void rtka_q8_dequantize(const rtka_state_q8_t* states, rtka_state_t* result, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        result[i] = rtka_q8_to_state(states[i]);
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * File: rtka_q8.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Quantized Confidence: 2-byte states
+ *
+ * Confidence c in [0, 1] is stored as q = round(255 c). The combinations
+ * are integer-only and exactly the rounded real result for every pair of
+ * inputs: AND is round(ab / 255) by the divide-free (t + (t >> 8)) >> 8
+ * with t = ab + 128, OR is a + b - AND, equivalence is the rounded mean.
+ * Operations pair values and confidences as the vector kernels do: NAND
+ * takes AND's confidence, NOR and implication take OR's.
+ *
+ * CHANGELOG:
+ * v1.0.0 - rtka_state_q8_t, scalar operations, batches and conversion
+ *          to and from rtka_state_t
+ */
+
+#ifndef RTKA_Q8_H
+#define RTKA_Q8_H
+
+#include "rtka_types.h"
+
+#define RTKA_Q8_ONE 255U
+
+/* Quarter of rtka_state_t; value is an rtka_value_t */
+typedef struct {
+    int8_t value;
+    uint8_t confidence;
+} rtka_state_q8_t;
+
+/* Confidence combinations */
+static inline uint8_t rtka_q8_conf_and(uint8_t a, uint8_t b) {
+    uint32_t t = (uint32_t)a * b + 128U;
+    return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+static inline uint8_t rtka_q8_conf_or(uint8_t a, uint8_t b) {
+    return (uint8_t)(a + b - rtka_q8_conf_and(a, b));
+}
+
+static inline uint8_t rtka_q8_conf_equiv(uint8_t a, uint8_t b) {
+    return (uint8_t)(((uint32_t)a + b + 1U) >> 1);
+}
+
+/* Kleene values as min / max / negation / product of -1, 0, 1 */
+static inline int8_t rtka_q8_min(int8_t a, int8_t b) { return a < b ? a : b; }
+static inline int8_t rtka_q8_max(int8_t a, int8_t b) { return a > b ? a : b; }
+
+/* State operations */
+static inline rtka_state_q8_t rtka_q8_and(rtka_state_q8_t a, rtka_state_q8_t b) {
+    return (rtka_state_q8_t){ rtka_q8_min(a.value, b.value), rtka_q8_conf_and(a.confidence, b.confidence) };
+}
+
+static inline rtka_state_q8_t rtka_q8_or(rtka_state_q8_t a, rtka_state_q8_t b) {
+    return (rtka_state_q8_t){ rtka_q8_max(a.value, b.value), rtka_q8_conf_or(a.confidence, b.confidence) };
+}
+
+static inline rtka_state_q8_t rtka_q8_not(rtka_state_q8_t a) {
+    return (rtka_state_q8_t){ (int8_t)-a.value, a.confidence };
+}
+
+static inline rtka_state_q8_t rtka_q8_nand(rtka_state_q8_t a, rtka_state_q8_t b) {
+    return (rtka_state_q8_t){ (int8_t)-rtka_q8_min(a.value, b.value),
+                              rtka_q8_conf_and(a.confidence, b.confidence) };
+}
+
+static inline rtka_state_q8_t rtka_q8_nor(rtka_state_q8_t a, rtka_state_q8_t b) {
+    return (rtka_state_q8_t){ (int8_t)-rtka_q8_max(a.value, b.value),
+                              rtka_q8_conf_or(a.confidence, b.confidence) };
+}
+
+static inline rtka_state_q8_t rtka_q8_implies(rtka_state_q8_t a, rtka_state_q8_t b) {
+    return (rtka_state_q8_t){ rtka_q8_max((int8_t)-a.value, b.value),
+                              rtka_q8_conf_or(a.confidence, b.confidence) };
+}
+
+static inline rtka_state_q8_t rtka_q8_equiv(rtka_state_q8_t a, rtka_state_q8_t b) {
+    return (rtka_state_q8_t){ (int8_t)(a.value * b.value), rtka_q8_conf_equiv(a.confidence, b.confidence) };
+}
+
+/* Conversion; confidence is clamped to [0, 1], half a step (1/510) of error */
+static inline rtka_state_q8_t rtka_q8_from_state(rtka_state_t s) {
+    float c = s.confidence < 0.0f ? 0.0f : s.confidence > 1.0f ? 1.0f : s.confidence;
+    return (rtka_state_q8_t){ (int8_t)s.value, (uint8_t)(c * (float)RTKA_Q8_ONE + 0.5f) };
+}
+
+static inline rtka_state_t rtka_q8_to_state(rtka_state_q8_t s) {
+    return rtka_make_state((rtka_value_t)s.value, (float)s.confidence * (1.0f / (float)RTKA_Q8_ONE));
+}
+
+/* Batch operations - defined in rtka_q8.c; result may alias a or b */
+void rtka_q8_and_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,
+                       rtka_state_q8_t* result, uint32_t count);
+void rtka_q8_or_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,
+                      rtka_state_q8_t* result, uint32_t count);
+void rtka_q8_nand_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,
+                        rtka_state_q8_t* result, uint32_t count);
+void rtka_q8_nor_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,
+                       rtka_state_q8_t* result, uint32_t count);
+void rtka_q8_implies_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,
+                           rtka_state_q8_t* result, uint32_t count);
+void rtka_q8_equiv_batch(const rtka_state_q8_t* a, const rtka_state_q8_t* b,
+                         rtka_state_q8_t* result, uint32_t count);
+
+void rtka_q8_quantize(const rtka_state_t* states, rtka_state_q8_t* result, uint32_t count);
+void rtka_q8_dequantize(const rtka_state_q8_t* states, rtka_state_t* result, uint32_t count);
+
+#endif /* RTKA_Q8_H */
@@ -12,6 +12,11 @@
  */
 
 #include "rtka_random.h"
+#include <stdatomic.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 /* Global RNG */
 rtka_rng_t g_rtka_rng = {{0x12345678, 0x87654321, 0xFEDCBA98, 0x98FEDCBA}};
@@ -48,14 +53,80 @@ void rtka_random_init_splitmix(rtka_rng_t* rng, uint64_t seed) {
     }
 }
 
+/* Jump polynomials of xoshiro256 */
+static void jump_with(rtka_rng_t* rng, const uint64_t polynomial[4]) {
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (polynomial[i] & ((uint64_t)1 << b)) {
+                s0 ^= rng->s[0];
+                s1 ^= rng->s[1];
+                s2 ^= rng->s[2];
+                s3 ^= rng->s[3];
+            }
+            rtka_random_next(rng);
+        }
+    }
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+}
+
+void rtka_random_jump(rtka_rng_t* rng) {
+    static const uint64_t polynomial[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    jump_with(rng, polynomial);
+}
+
+void rtka_random_long_jump(rtka_rng_t* rng) {
+    static const uint64_t polynomial[4] = {
+        0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL
+    };
+    jump_with(rng, polynomial);
+}
+
+void rtka_random_init_stream(rtka_rng_t* rng, uint64_t seed, uint32_t index) {
+    rtka_random_init_splitmix(rng, seed);
+    for (uint32_t i = 0; i < index; i++) rtka_random_jump(rng);
+}
+
+/* Thread streams: long jumps apart, so they never meet the indexed streams
+ * of the same seed either */
+#define THREAD_STREAM_SEED  0x52544b415f524e47ULL
+
+static _Atomic uint32_t g_thread_streams = 0;
+static _Thread_local rtka_rng_t t_rng;
+static _Thread_local bool t_rng_ready = false;
+
+rtka_rng_t* rtka_random_thread(void) {
+    if (RTKA_UNLIKELY(!t_rng_ready)) {
+        uint32_t index = atomic_fetch_add_explicit(&g_thread_streams, 1U, memory_order_relaxed);
+        rtka_random_init_splitmix(&t_rng, THREAD_STREAM_SEED);
+        for (uint32_t i = 0; i < index; i++) rtka_random_long_jump(&t_rng);
+        t_rng_ready = true;
+    }
+    return &t_rng;
+}
+
+void rtka_random_seed_thread(uint64_t seed) {
+    rtka_random_init_splitmix(&t_rng, seed);
+    t_rng_ready = true;
+}
+
 /* Get 32-bit value */
 uint32_t rtka_random_uint32(rtka_rng_t* rng) {
     return (uint32_t)(rtka_random_next(rng) >> 32);
 }
 
 /* Get float [0, 1) */
+float rtka_random_uniform(rtka_rng_t* rng) {
+    return (float)(rtka_random_next(rng) >> 40) * 0x1.0p-24f;
+}
+
 float rtka_random_float(void) {
-    return (rtka_random_uint32(&g_rtka_rng) >> 8) * 0x1.0p-24f;
+    return rtka_random_uniform(rtka_random_thread());
 }
 
 /* Get double [0, 1) */
@@ -63,6 +134,13 @@ double rtka_random_double(rtka_rng_t* rng) {
     return (rtka_random_next(rng) >> 11) * 0x1.0p-53;
 }
 
+/* Uniform in [min, max] by multiply-shift */
+uint32_t rtka_random_range(rtka_rng_t* rng, uint32_t min, uint32_t max) {
+    if (max <= min) return min;
+    uint64_t span = (uint64_t)max - min + 1U;
+    return min + (uint32_t)(((rtka_random_next(rng) >> 32) * span) >> 32);
+}
+
 /* Random ternary value */
 rtka_value_t rtka_random_ternary(rtka_rng_t* rng) {
     uint32_t r = rtka_random_uint32(rng) % 3;
@@ -76,3 +154,151 @@ rtka_state_t rtka_random_state(rtka_rng_t* rng) {
         .confidence = (float)rtka_random_double(rng)
     };
 }
+
+/* Bulk generation: four xoshiro256** lanes, s[word][lane] */
+typedef struct {
+    uint64_t s[4][4];
+} lanes_t;
+
+static void lanes_seed(lanes_t* lanes, rtka_rng_t* rng) {
+    for (int lane = 0; lane < 4; lane++) {
+        rtka_rng_t seeded;
+        rtka_random_init_splitmix(&seeded, rtka_random_next(rng));
+        for (int w = 0; w < 4; w++) lanes->s[w][lane] = seeded.s[w];
+    }
+}
+
+static inline void lanes_next(lanes_t* lanes, uint64_t out[4]) {
+    for (int lane = 0; lane < 4; lane++) {
+        rtka_rng_t one = {{ lanes->s[0][lane], lanes->s[1][lane], lanes->s[2][lane], lanes->s[3][lane] }};
+        out[lane] = rtka_random_next(&one);
+        for (int w = 0; w < 4; w++) lanes->s[w][lane] = one.s[w];
+    }
+}
+
+static inline float float_of(uint64_t x) {
+    return (float)(x >> 40) * 0x1.0p-24f;
+}
+
+static inline rtka_value_t ternary_of(uint64_t x) {
+    return (rtka_value_t)((int32_t)(((x >> 32) * 3U) >> 32) - 1);
+}
+
+static inline rtka_state_t state_of(uint64_t x) {
+    return (rtka_state_t){ ternary_of(x), (float)(x & 0xFFFFFFU) * 0x1.0p-24f };
+}
+
+#ifdef __AVX2__
+typedef struct {
+    __m256i s0, s1, s2, s3;
+} lanes_avx_t;
+
+static inline lanes_avx_t lanes_load(const lanes_t* lanes) {
+    return (lanes_avx_t){
+        _mm256_loadu_si256((const __m256i*)lanes->s[0]), _mm256_loadu_si256((const __m256i*)lanes->s[1]),
+        _mm256_loadu_si256((const __m256i*)lanes->s[2]), _mm256_loadu_si256((const __m256i*)lanes->s[3])
+    };
+}
+
+static inline void lanes_store(lanes_t* lanes, const lanes_avx_t* v) {
+    _mm256_storeu_si256((__m256i*)lanes->s[0], v->s0);
+    _mm256_storeu_si256((__m256i*)lanes->s[1], v->s1);
+    _mm256_storeu_si256((__m256i*)lanes->s[2], v->s2);
+    _mm256_storeu_si256((__m256i*)lanes->s[3], v->s3);
+}
+
+#define ROTL_EPI64(x, k) _mm256_or_si256(_mm256_slli_epi64((x), (k)), _mm256_srli_epi64((x), 64 - (k)))
+
+/* rtka_random_next on four lanes; no 64-bit multiply, so *5 and *9 are
+ * shift-adds */
+static inline __m256i lanes_avx_next(lanes_avx_t* v) {
+    __m256i x5 = _mm256_add_epi64(_mm256_slli_epi64(v->s1, 2), v->s1);
+    __m256i r = ROTL_EPI64(x5, 7);
+    __m256i result = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+    __m256i t = _mm256_slli_epi64(v->s1, 17);
+
+    v->s2 = _mm256_xor_si256(v->s2, v->s0);
+    v->s3 = _mm256_xor_si256(v->s3, v->s1);
+    v->s1 = _mm256_xor_si256(v->s1, v->s2);
+    v->s0 = _mm256_xor_si256(v->s0, v->s3);
+    v->s2 = _mm256_xor_si256(v->s2, t);
+    v->s3 = ROTL_EPI64(v->s3, 45);
+    return result;
+}
+
+/* Low dword of each 64-bit lane into the low 128 bits */
+static inline __m128i low_dwords(__m256i x) {
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7)));
+}
+
+static inline __m256i ternary_lanes(__m256i x) {
+    __m256i scaled = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), _mm256_set1_epi64x(3)), 32);
+    return _mm256_sub_epi32(scaled, _mm256_set1_epi32(1));
+}
+#endif
+
+void rtka_random_fill_float(rtka_rng_t* rng, float* out, size_t count) {
+    if (!rng || !out || count == 0) return;
+    lanes_t lanes;
+    lanes_seed(&lanes, rng);
+    size_t i = 0;
+#ifdef __AVX2__
+    lanes_avx_t v = lanes_load(&lanes);
+    const __m128 scale = _mm_set1_ps(0x1.0p-24f);
+    for (; i + 4 <= count; i += 4) {
+        __m128i bits = low_dwords(_mm256_srli_epi64(lanes_avx_next(&v), 40));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(bits), scale));
+    }
+    lanes_store(&lanes, &v);
+#endif
+    uint64_t x[4];
+    for (; i < count; i += 4) {
+        lanes_next(&lanes, x);
+        for (size_t k = 0; k < 4 && i + k < count; k++) out[i + k] = float_of(x[k]);
+    }
+}
+
+void rtka_random_fill_ternary(rtka_rng_t* rng, rtka_value_t* out, size_t count) {
+    if (!rng || !out || count == 0) return;
+    lanes_t lanes;
+    lanes_seed(&lanes, rng);
+    size_t i = 0;
+#ifdef __AVX2__
+    lanes_avx_t v = lanes_load(&lanes);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(out + i), low_dwords(ternary_lanes(lanes_avx_next(&v))));
+    }
+    lanes_store(&lanes, &v);
+#endif
+    uint64_t x[4];
+    for (; i < count; i += 4) {
+        lanes_next(&lanes, x);
+        for (size_t k = 0; k < 4 && i + k < count; k++) out[i + k] = ternary_of(x[k]);
+    }
+}
+
+void rtka_random_fill_state(rtka_rng_t* rng, rtka_state_t* out, size_t count) {
+    if (!rng || !out || count == 0) return;
+    lanes_t lanes;
+    lanes_seed(&lanes, rng);
+    size_t i = 0;
+#ifdef __AVX2__
+    lanes_avx_t v = lanes_load(&lanes);
+    const __m256 scale = _mm256_set1_ps(0x1.0p-24f);
+    for (; i + 4 <= count; i += 4) {
+        __m256i x = lanes_avx_next(&v);
+        /* Confidence converts in the low dword (the high dword is zero),
+         * then moves up beside the value */
+        __m256 confidence = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(x, _mm256_set1_epi64x(0xFFFFFF))), scale);
+        __m256i packed = _mm256_blend_epi32(ternary_lanes(x),
+                                            _mm256_slli_epi64(_mm256_castps_si256(confidence), 32), 0xAA);
+        _mm256_storeu_si256((__m256i*)(out + i), packed);
+    }
+    lanes_store(&lanes, &v);
+#endif
+    uint64_t x[4];
+    for (; i < count; i += 4) {
+        lanes_next(&lanes, x);
+        for (size_t k = 0; k < 4 && i + k < count; k++) out[i + k] = state_of(x[k]);
+    }
+}
@@ -9,6 +9,14 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Random Number Generation - xoshiro256**
+ *
+ * CHANGELOG:
+ * v1.1.0 - Jumps and indexed streams, so parallel work draws from
+ *          generators 2^128 outputs apart and stays reproducible whatever
+ *          thread runs it. Every thread has its own stream for code without
+ *          a generator of its own (rtka_random_float among it); none of the
+ *          library touches g_rtka_rng or rand() any more. Bulk fills run
+ *          four xoshiro256** lanes, in AVX2 registers where available.
  */
 
 #ifndef RTKA_RANDOM_H
@@ -28,9 +36,23 @@ void rtka_random_init_splitmix(rtka_rng_t* rng, uint64_t seed);
 /* Core xoshiro256** */
 uint64_t rtka_random_next(rtka_rng_t* rng);
 
+/* Advance by 2^128 (jump) or 2^192 (long_jump) outputs */
+void rtka_random_jump(rtka_rng_t* rng);
+void rtka_random_long_jump(rtka_rng_t* rng);
+
+/* Stream index of seed: the splitmix state of seed jumped index times.
+ * Streams of one seed never overlap for 2^128 outputs each. */
+void rtka_random_init_stream(rtka_rng_t* rng, uint64_t seed, uint32_t index);
+
+/* Calling thread's generator. The n-th thread to ask gets stream n of a
+ * fixed seed until it reseeds; the pointer is valid for the thread's life. */
+rtka_rng_t* rtka_random_thread(void);
+void rtka_random_seed_thread(uint64_t seed);
+
 /* Derived generators */
 uint32_t rtka_random_uint32(rtka_rng_t* rng);
-float rtka_random_float(void);
+float rtka_random_uniform(rtka_rng_t* rng);     /* [0, 1), 24 bits */
+float rtka_random_float(void);                  /* Uniform from the thread's stream */
 double rtka_random_double(rtka_rng_t* rng);
 
 /* Range generators */
@@ -38,7 +60,15 @@ uint32_t rtka_random_range(rtka_rng_t* rng, uint32_t min, uint32_t max);
 rtka_value_t rtka_random_ternary(rtka_rng_t* rng);
 rtka_state_t rtka_random_state(rtka_rng_t* rng);
 
-/* Global RNG */
+/* Bulk generation. Four lanes seeded from rng (which advances by four
+ * outputs) fill the output; the values follow the scalar generators'
+ * distributions but not their sequence. States pair a ternary value with
+ * a 24-bit confidence in [0, 1), both from one output. */
+void rtka_random_fill_float(rtka_rng_t* rng, float* out, size_t count);
+void rtka_random_fill_ternary(rtka_rng_t* rng, rtka_value_t* out, size_t count);
+void rtka_random_fill_state(rtka_rng_t* rng, rtka_state_t* out, size_t count);
+
+/* Global RNG, for single-threaded callers that want one shared sequence */
 extern rtka_rng_t g_rtka_rng;
 
 #endif /* RTKA_RANDOM_H */
@@ -11,29 +11,36 @@
  * RTKA Reinforcement Learning Implementation
  */
 
+#define _GNU_SOURCE  /* For sched_yield */
 #include "rtka_reinforcement.h"
 #include "rtka_ml.h"
 #include "rtka_memory.h"
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+
+static rtka_model_t* dqn_network(uint32_t state_dim, uint32_t action_dim);
 
 /* Create DQN agent */
 rtka_dqn_agent_t* rtka_rl_create_dqn(uint32_t state_dim, uint32_t action_dim,
                                      rtka_confidence_t epsilon, rtka_confidence_t gamma) {
-    rtka_dqn_agent_t* agent = (rtka_dqn_agent_t*)rtka_alloc_state();
+    rtka_dqn_agent_t* agent = (rtka_dqn_agent_t*)calloc(1, sizeof(rtka_dqn_agent_t));
     if (!agent) return NULL;
     
     /* Q-network: state -> Q(s,a) for each action */
-    uint32_t hidden[] = {128, 64};
-    agent->q_network = rtka_ml_create_mlp(state_dim, hidden, 2, action_dim);
-    agent->target_network = rtka_ml_create_mlp(state_dim, hidden, 2, action_dim);
+    agent->q_network = dqn_network(state_dim, action_dim);
+    agent->target_network = dqn_network(state_dim, action_dim);
+    agent->state_dim = state_dim;
+    agent->action_dim = action_dim;
     
     /* Initialize with Adam optimizer */
     agent->q_network->optimizer = rtka_optimizer_adam(0.001f, 0.9f, 0.999f);
     rtka_ml_compile(agent->q_network, agent->q_network->optimizer);
     
-    agent->buffer = rtka_rl_create_buffer(10000);
+    agent->buffer = rtka_rl_create_buffer(10000, state_dim);
     agent->epsilon = epsilon;
     agent->gamma = gamma;
     agent->update_frequency = 100;
@@ -43,7 +50,7 @@ rtka_dqn_agent_t* rtka_rl_create_dqn(uint32_t state_dim, uint32_t action_dim,
 
 /* Create Policy Gradient agent */
 rtka_pg_agent_t* rtka_rl_create_pg(uint32_t state_dim, uint32_t action_dim) {
-    rtka_pg_agent_t* agent = (rtka_pg_agent_t*)rtka_alloc_state();
+    rtka_pg_agent_t* agent = (rtka_pg_agent_t*)calloc(1, sizeof(rtka_pg_agent_t));
     if (!agent) return NULL;
     
     /* Policy network: state -> action probabilities */
@@ -60,190 +67,1026 @@ rtka_pg_agent_t* rtka_rl_create_pg(uint32_t state_dim, uint32_t action_dim) {
     return agent;
 }
 
-/* Create replay buffer */
-rtka_replay_buffer_t* rtka_rl_create_buffer(uint32_t capacity) {
-    rtka_replay_buffer_t* buffer = (rtka_replay_buffer_t*)rtka_alloc_state();
+/* ============================================================================
+ * EXPERIENCE REPLAY
+ * ============================================================================ */
+
+#define PRIORITY_EPSILON  1e-6f
+
+static RTKA_INLINE rtka_state_t* replay_row(const rtka_replay_buffer_t* buffer, uint32_t row) {
+    return buffer->observations + (size_t)row * buffer->observation_size;
+}
+
+/* Leaf row to priority, refreshing the sums above it */
+static void tree_set(rtka_replay_buffer_t* buffer, uint32_t row, rtka_confidence_t priority) {
+    uint32_t node = buffer->leaves + row;
+    buffer->tree[node] = priority;
+    for (node >>= 1; node > 0; node >>= 1) buffer->tree[node] = buffer->tree[2U * node] + buffer->tree[2U * node + 1U];
+}
+
+/* Leaf whose prefix range of the total holds mass */
+static uint32_t tree_find(const rtka_replay_buffer_t* buffer, rtka_confidence_t mass) {
+    uint32_t node = 1;
+    while (node < buffer->leaves) {
+        rtka_confidence_t left = buffer->tree[2U * node];
+        if (mass < left || buffer->tree[2U * node + 1U] <= 0.0f) {
+            node = 2U * node;
+        } else {
+            mass -= left;
+            node = 2U * node + 1U;
+        }
+    }
+    return node - buffer->leaves;
+}
+
+static void retire(rtka_replay_buffer_t* buffer, uint32_t row) {
+    if (!buffer->valid[row]) return;
+    buffer->valid[row] = 0;
+    buffer->size--;
+    if (buffer->tree) tree_set(buffer, row, 0.0f);
+}
+
+rtka_replay_buffer_t* rtka_rl_create_buffer(uint32_t capacity, uint32_t observation_size) {
+    if (capacity == 0 || capacity == UINT32_MAX || observation_size == 0) return NULL;
+    rtka_replay_buffer_t* buffer = (rtka_replay_buffer_t*)calloc(1, sizeof(rtka_replay_buffer_t));
     if (!buffer) return NULL;
-    
+
     buffer->capacity = capacity;
-    buffer->size = 0;
-    buffer->position = 0;
-    
-    buffer->states = (rtka_tensor_t**)rtka_alloc_states(capacity * sizeof(void*) / sizeof(rtka_state_t));
-    buffer->actions = (rtka_value_t*)rtka_alloc_states(capacity * sizeof(rtka_value_t) / sizeof(rtka_state_t));
-    buffer->rewards = (rtka_confidence_t*)rtka_alloc_states(capacity * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
-    buffer->next_states = (rtka_tensor_t**)rtka_alloc_states(capacity * sizeof(void*) / sizeof(rtka_state_t));
-    buffer->dones = (bool*)rtka_alloc_states(capacity * sizeof(bool) / sizeof(rtka_state_t));
-    
+    buffer->rows = capacity + 1U;
+    buffer->observation_size = observation_size;
+    buffer->alpha = 1.0f;
+    buffer->max_priority = 1.0f;
+    rtka_random_init_splitmix(&buffer->rng, rtka_random_next(rtka_random_thread()));
+
+    buffer->observations = (rtka_state_t*)malloc((size_t)buffer->rows * observation_size * sizeof(rtka_state_t));
+    buffer->actions = (rtka_value_t*)calloc(buffer->rows, sizeof(rtka_value_t));
+    buffer->rewards = (rtka_confidence_t*)calloc(buffer->rows, sizeof(rtka_confidence_t));
+    buffer->dones = (bool*)calloc(buffer->rows, sizeof(bool));
+    buffer->valid = (uint8_t*)calloc(buffer->rows, 1);
+    if (!buffer->observations || !buffer->actions || !buffer->rewards || !buffer->dones || !buffer->valid) {
+        rtka_rl_free_buffer(buffer);
+        return NULL;
+    }
     return buffer;
 }
 
-/* Store experience */
-void rtka_rl_store_experience(rtka_replay_buffer_t* buffer,
-                             rtka_tensor_t* state,
-                             rtka_value_t action,
-                             rtka_confidence_t reward,
-                             rtka_tensor_t* next_state,
-                             bool done) {
-    buffer->states[buffer->position] = state;
-    buffer->actions[buffer->position] = action;
-    buffer->rewards[buffer->position] = reward;
-    buffer->next_states[buffer->position] = next_state;
-    buffer->dones[buffer->position] = done;
-    
-    buffer->position = (buffer->position + 1) % buffer->capacity;
-    if (buffer->size < buffer->capacity) buffer->size++;
+rtka_replay_buffer_t* rtka_rl_create_prioritized_buffer(uint32_t capacity, uint32_t observation_size,
+                                                        rtka_confidence_t alpha) {
+    rtka_replay_buffer_t* buffer = rtka_rl_create_buffer(capacity, observation_size);
+    if (!buffer) return NULL;
+    if (buffer->rows > (1U << 30)) {
+        rtka_rl_free_buffer(buffer);
+        return NULL;
+    }
+
+    buffer->alpha = alpha;
+    buffer->leaves = 1;
+    while (buffer->leaves < buffer->rows) buffer->leaves <<= 1;
+    buffer->tree = (rtka_confidence_t*)calloc(2U * (size_t)buffer->leaves, sizeof(rtka_confidence_t));
+    if (!buffer->tree) {
+        rtka_rl_free_buffer(buffer);
+        return NULL;
+    }
+    return buffer;
 }
 
-/* Sample batch from buffer */
-void rtka_rl_sample_batch(rtka_replay_buffer_t* buffer,
-                         rtka_tensor_t** states,
-                         rtka_value_t* actions,
-                         rtka_confidence_t* rewards,
-                         rtka_tensor_t** next_states,
-                         bool* dones,
-                         uint32_t batch_size) {
-    for (uint32_t i = 0; i < batch_size; i++) {
-        uint32_t idx = rand() % buffer->size;
-        states[i] = buffer->states[idx];
-        actions[i] = buffer->actions[idx];
-        rewards[i] = buffer->rewards[idx];
-        next_states[i] = buffer->next_states[idx];
-        dones[i] = buffer->dones[idx];
+void rtka_rl_free_buffer(rtka_replay_buffer_t* buffer) {
+    if (!buffer) return;
+    free(buffer->observations);
+    free(buffer->actions);
+    free(buffer->rewards);
+    free(buffer->dones);
+    free(buffer->valid);
+    free(buffer->tree);
+    free(buffer);
+}
+
+rtka_error_t rtka_rl_store_states(rtka_replay_buffer_t* buffer,
+                                  const rtka_state_t* state,
+                                  rtka_value_t action,
+                                  rtka_confidence_t reward,
+                                  const rtka_state_t* next_state,
+                                  bool done) {
+    if (!buffer || !state || !next_state) return RTKA_ERROR_NULL_POINTER;
+    size_t bytes = (size_t)buffer->observation_size * sizeof(rtka_state_t);
+    uint32_t row = buffer->position;
+
+    if (buffer->open && memcmp(replay_row(buffer, row), state, bytes) != 0) {
+        /* Keep the previous next state; this transition starts one row on */
+        row = (row + 1U) % buffer->rows;
+        retire(buffer, row);
+        buffer->open = false;
+    }
+    if (!buffer->open) memcpy(replay_row(buffer, row), state, bytes);
+
+    uint32_t next = (row + 1U) % buffer->rows;
+    retire(buffer, next);
+    memcpy(replay_row(buffer, next), next_state, bytes);
+
+    buffer->actions[row] = action;
+    buffer->rewards[row] = reward;
+    buffer->dones[row] = done;
+    buffer->valid[row] = 1;
+    buffer->size++;
+    if (buffer->tree) tree_set(buffer, row, powf(buffer->max_priority, buffer->alpha));
+
+    if (next + 1U > buffer->filled) buffer->filled = next + 1U;
+    if (row + 1U > buffer->filled) buffer->filled = row + 1U;
+    buffer->position = next;
+    buffer->open = !done;
+    return RTKA_SUCCESS;
+}
+
+/* A tensor's elements in storage order as AoS, into row */
+static rtka_error_t observation_copy(rtka_state_t* row, const rtka_tensor_t* tensor, uint32_t size) {
+    if (tensor->size != size) return RTKA_ERROR_INVALID_VALUE;
+    if (rtka_tensor_is_contiguous(tensor)) {
+        if (!rtka_tensor_is_soa(tensor)) {
+            memcpy(row, tensor->data, (size_t)size * sizeof(rtka_state_t));
+        } else {
+            for (uint32_t i = 0; i < size; i++) row[i] = rtka_tensor_load(tensor, i);
+        }
+        return RTKA_SUCCESS;
+    }
+
+    /* Strided: copy into a contiguous header over the row */
+    rtka_tensor_t header = { .data = row, .ndim = tensor->ndim, .size = size };
+    uint32_t stride = 1;
+    for (uint32_t d = tensor->ndim; d-- > 0;) {
+        header.shape[d] = tensor->shape[d];
+        header.strides[d] = stride;
+        stride *= tensor->shape[d];
+    }
+    return rtka_tensor_copy_into(&header, tensor);
+}
+
+rtka_error_t rtka_rl_store_experience(rtka_replay_buffer_t* buffer,
+                                      const rtka_tensor_t* state,
+                                      rtka_value_t action,
+                                      rtka_confidence_t reward,
+                                      const rtka_tensor_t* next_state,
+                                      bool done) {
+    if (!buffer || !state || !next_state) return RTKA_ERROR_NULL_POINTER;
+    uint32_t size = buffer->observation_size;
+    bool direct = rtka_tensor_is_contiguous(state) && !rtka_tensor_is_soa(state) &&
+                  rtka_tensor_is_contiguous(next_state) && !rtka_tensor_is_soa(next_state);
+    if (direct) {
+        if (state->size != size || next_state->size != size) return RTKA_ERROR_INVALID_VALUE;
+        return rtka_rl_store_states(buffer, state->data, action, reward, next_state->data, done);
+    }
+
+    rtka_state_t* rows = (rtka_state_t*)malloc(2U * (size_t)size * sizeof(rtka_state_t));
+    if (!rows) return RTKA_ERROR_OUT_OF_MEMORY;
+    rtka_error_t err = observation_copy(rows, state, size);
+    if (err == RTKA_SUCCESS) err = observation_copy(rows + size, next_state, size);
+    if (err == RTKA_SUCCESS) err = rtka_rl_store_states(buffer, rows, action, reward, rows + size, done);
+    free(rows);
+    return err;
+}
+
+rtka_replay_batch_t* rtka_rl_create_batch(uint32_t batch_size, uint32_t observation_size) {
+    if (batch_size == 0 || observation_size == 0) return NULL;
+    rtka_replay_batch_t* batch = (rtka_replay_batch_t*)calloc(1, sizeof(rtka_replay_batch_t));
+    if (!batch) return NULL;
+
+    uint32_t shape[2] = { batch_size, observation_size };
+    batch->batch_size = batch_size;
+    batch->observation_size = observation_size;
+    batch->states = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    batch->next_states = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    batch->actions = (rtka_value_t*)malloc(batch_size * sizeof(rtka_value_t));
+    batch->rewards = (rtka_confidence_t*)malloc(batch_size * sizeof(rtka_confidence_t));
+    batch->dones = (bool*)malloc(batch_size * sizeof(bool));
+    batch->indices = (uint32_t*)malloc(batch_size * sizeof(uint32_t));
+    batch->weights = (rtka_confidence_t*)malloc(batch_size * sizeof(rtka_confidence_t));
+    if (!batch->states || !batch->next_states || !batch->actions || !batch->rewards ||
+        !batch->dones || !batch->indices || !batch->weights) {
+        rtka_rl_free_batch(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+void rtka_rl_free_batch(rtka_replay_batch_t* batch) {
+    if (!batch) return;
+    rtka_tensor_free(batch->states);
+    rtka_tensor_free(batch->next_states);
+    free(batch->actions);
+    free(batch->rewards);
+    free(batch->dones);
+    free(batch->indices);
+    free(batch->weights);
+    free(batch);
+}
+
+/* A kept row with uniform probability: rows written so far, rejecting the
+ * few that start no transition */
+static uint32_t sample_uniform(rtka_replay_buffer_t* buffer) {
+    for (;;) {
+        uint32_t row = (uint32_t)(((uint64_t)rtka_random_uint32(&buffer->rng) * buffer->filled) >> 32);
+        if (buffer->valid[row]) return row;
+    }
+}
+
+rtka_error_t rtka_rl_sample_batch(rtka_replay_buffer_t* buffer,
+                                  rtka_replay_batch_t* batch,
+                                  rtka_confidence_t beta) {
+    if (!buffer || !batch) return RTKA_ERROR_NULL_POINTER;
+    if (batch->observation_size != buffer->observation_size) return RTKA_ERROR_INVALID_VALUE;
+    if (buffer->size == 0) return RTKA_ERROR_INVALID_VALUE;
+
+    uint32_t count = batch->batch_size;
+    if (buffer->tree) {
+        rtka_confidence_t total = buffer->tree[1];
+        rtka_confidence_t slice = total / (rtka_confidence_t)count;
+        rtka_confidence_t largest = 0.0f;
+        for (uint32_t i = 0; i < count; i++) {
+            rtka_confidence_t mass = ((rtka_confidence_t)i + rtka_random_uniform(&buffer->rng)) * slice;
+            uint32_t row = tree_find(buffer, mass < total ? mass : total * 0.999999f);
+            if (!buffer->valid[row]) row = sample_uniform(buffer);   /* Rounding at a slice edge */
+
+            rtka_confidence_t p = buffer->tree[buffer->leaves + row] / total;
+            rtka_confidence_t w = powf((rtka_confidence_t)buffer->size * p, -beta);
+            batch->indices[i] = row;
+            batch->weights[i] = w;
+            if (w > largest) largest = w;
+        }
+        for (uint32_t i = 0; i < count; i++) batch->weights[i] /= largest;
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            batch->indices[i] = sample_uniform(buffer);
+            batch->weights[i] = 1.0f;
+        }
+    }
+
+    size_t bytes = (size_t)buffer->observation_size * sizeof(rtka_state_t);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t row = batch->indices[i];
+        memcpy(batch->states->data + (size_t)i * buffer->observation_size, replay_row(buffer, row), bytes);
+        memcpy(batch->next_states->data + (size_t)i * buffer->observation_size,
+               replay_row(buffer, (row + 1U) % buffer->rows), bytes);
+        batch->actions[i] = buffer->actions[row];
+        batch->rewards[i] = buffer->rewards[row];
+        batch->dones[i] = buffer->dones[row];
+    }
+    return RTKA_SUCCESS;
+}
+
+void rtka_rl_update_priorities(rtka_replay_buffer_t* buffer,
+                               const uint32_t* indices,
+                               const rtka_confidence_t* td_errors,
+                               uint32_t count) {
+    if (!buffer || !buffer->tree || !indices || !td_errors) return;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t row = indices[i];
+        if (row >= buffer->rows || !buffer->valid[row]) continue;
+        rtka_confidence_t priority = fabsf(td_errors[i]) + PRIORITY_EPSILON;
+        if (priority > buffer->max_priority) buffer->max_priority = priority;
+        tree_set(buffer, row, powf(priority, buffer->alpha));
+    }
+}
+
+/* ============================================================================
+ * VECTORIZED ENVIRONMENTS
+ * ============================================================================ */
+
+rtka_error_t rtka_vec_env_create(rtka_vec_env_t** vec, const rtka_environment_t* envs,
+                                 uint32_t num_envs, rtka_thread_pool_t* pool) {
+    if (!vec || !envs) return RTKA_ERROR_NULL_POINTER;
+    *vec = NULL;
+    if (num_envs == 0 || envs[0].observation_dim == 0) return RTKA_ERROR_INVALID_VALUE;
+    for (uint32_t i = 0; i < num_envs; i++) {
+        if (!envs[i].reset || !envs[i].step) return RTKA_ERROR_NULL_POINTER;
+        if (envs[i].observation_dim != envs[0].observation_dim) return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    rtka_vec_env_t* v = (rtka_vec_env_t*)calloc(1, sizeof(rtka_vec_env_t));
+    if (!v) return RTKA_ERROR_OUT_OF_MEMORY;
+    uint32_t shape[2] = { num_envs, envs[0].observation_dim };
+    v->num_envs = num_envs;
+    v->observation_dim = envs[0].observation_dim;
+    v->pool = pool;
+    v->envs = (rtka_environment_t*)malloc(num_envs * sizeof(rtka_environment_t));
+    v->observations = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    v->previous = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    v->next_observations = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    v->rewards = (rtka_confidence_t*)calloc(num_envs, sizeof(rtka_confidence_t));
+    v->dones = (bool*)calloc(num_envs, sizeof(bool));
+    v->status = (rtka_error_t*)calloc(num_envs, sizeof(rtka_error_t));
+    if (!v->envs || !v->observations || !v->previous || !v->next_observations ||
+        !v->rewards || !v->dones || !v->status) {
+        rtka_vec_env_free(v);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(v->envs, envs, num_envs * sizeof(rtka_environment_t));
+    *vec = v;
+    return RTKA_SUCCESS;
+}
+
+void rtka_vec_env_free(rtka_vec_env_t* vec) {
+    if (!vec) return;
+    rtka_tensor_free(vec->observations);
+    rtka_tensor_free(vec->previous);
+    rtka_tensor_free(vec->next_observations);
+    free(vec->envs);
+    free(vec->rewards);
+    free(vec->dones);
+    free(vec->status);
+    free(vec);
+}
+
+/* Environment output into its row; the tensor is consumed */
+static rtka_error_t vec_env_take(rtka_state_t* row, rtka_tensor_t* observation, uint32_t size) {
+    if (!observation) return RTKA_ERROR_NULL_POINTER;
+    rtka_error_t err = observation_copy(row, observation, size);
+    rtka_tensor_free(observation);
+    return err;
+}
+
+typedef struct {
+    rtka_vec_env_t* vec;
+    const rtka_value_t* actions;    /* NULL = reset */
+} vec_env_ctx_t;
+
+static void vec_env_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    vec_env_ctx_t* c = (vec_env_ctx_t*)ctx;
+    rtka_vec_env_t* vec = c->vec;
+    uint32_t size = vec->observation_dim;
+    for (uint32_t i = begin; i < end; i++) {
+        rtka_environment_t* env = &vec->envs[i];
+        rtka_state_t* current = vec->observations->data + (size_t)i * size;
+        rtka_state_t* next = vec->next_observations->data + (size_t)i * size;
+        if (!c->actions) {
+            vec->status[i] = vec_env_take(current, env->reset(env->env_data), size);
+            continue;
+        }
+
+        rtka_confidence_t reward = 0.0f;
+        bool done = false;
+        rtka_error_t err = vec_env_take(next, env->step(env->env_data, c->actions[i], &reward, &done), size);
+        vec->rewards[i] = reward;
+        vec->dones[i] = done;
+        if (err == RTKA_SUCCESS) {
+            if (done) {
+                err = vec_env_take(current, env->reset(env->env_data), size);
+            } else {
+                memcpy(current, next, (size_t)size * sizeof(rtka_state_t));
+            }
+        }
+        vec->status[i] = err;
+    }
+}
+
+static rtka_error_t vec_env_run(rtka_vec_env_t* vec, const rtka_value_t* actions) {
+    vec_env_ctx_t ctx = { vec, actions };
+    if (vec->pool) {
+        rtka_pool_parallel_for(vec->pool, 0, vec->num_envs, 1, vec_env_range, &ctx);
+    } else {
+        vec_env_range(&ctx, 0, vec->num_envs, 0);
+    }
+    for (uint32_t i = 0; i < vec->num_envs; i++) {
+        if (vec->status[i] != RTKA_SUCCESS) return vec->status[i];
+    }
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_vec_env_reset(rtka_vec_env_t* vec) {
+    if (!vec) return RTKA_ERROR_NULL_POINTER;
+    memset(vec->dones, 0, vec->num_envs * sizeof(bool));
+    return vec_env_run(vec, NULL);
+}
+
+rtka_error_t rtka_vec_env_step(rtka_vec_env_t* vec, const rtka_value_t* actions) {
+    if (!vec || !actions) return RTKA_ERROR_NULL_POINTER;
+    memcpy(vec->previous->data, vec->observations->data, vec->observations->size * sizeof(rtka_state_t));
+    return vec_env_run(vec, actions);
+}
+
+/* ============================================================================
+ * ACTION SELECTION
+ * ============================================================================ */
+
+/* Q-network output a scores action a - 1: FALSE, UNKNOWN, TRUE */
+static RTKA_INLINE rtka_value_t q_action(uint32_t output) {
+    return (rtka_value_t)((int)(output % 3U) - 1);
+}
+
+static RTKA_INLINE uint32_t q_output(rtka_value_t action) {
+    return (uint32_t)((int)action + 1);
+}
+
+/* rng NULL = the calling thread's stream */
+static RTKA_INLINE float exploration_float(rtka_rng_t* rng) {
+    return rtka_random_uniform(rng ? rng : rtka_random_thread());
+}
+
+static rtka_value_t random_action(rtka_rng_t* rng) {
+    /* Random action with ternary values */
+    float r = exploration_float(rng);
+    if (r < 0.333f) return RTKA_FALSE;
+    else if (r < 0.667f) return RTKA_UNKNOWN;
+    else return RTKA_TRUE;
+}
+
+/* Action of the highest-confidence output in each of rows rows */
+static void greedy_rows(const rtka_tensor_t* q_values, uint32_t rows, const bool* explore,
+                        rtka_value_t* actions) {
+    uint32_t outputs = q_values->size / rows;
+    for (uint32_t i = 0; i < rows; i++) {
+        if (explore[i]) continue;
+        const rtka_state_t* q = q_values->data + (size_t)i * outputs;
+        uint32_t best = q_output(RTKA_UNKNOWN) < outputs ? q_output(RTKA_UNKNOWN) : 0;
+        for (uint32_t a = 0; a < outputs; a++) {
+            if (q[a].confidence > q[best].confidence) best = a;
+        }
+        actions[i] = q_action(best);
     }
 }
 
 /* Epsilon-greedy action selection */
 rtka_value_t rtka_rl_select_action_epsilon_greedy(rtka_dqn_agent_t* agent, rtka_tensor_t* state) {
-    if ((float)rand() / RAND_MAX < agent->epsilon) {
-        /* Random action with ternary values */
-        float r = (float)rand() / RAND_MAX;
-        if (r < 0.333f) return RTKA_FALSE;
-        else if (r < 0.667f) return RTKA_UNKNOWN;
-        else return RTKA_TRUE;
-    }
+    rtka_value_t action = RTKA_UNKNOWN;
+    bool explore = exploration_float(NULL) < agent->epsilon;
+    if (explore) return random_action(NULL);
     
-    /* Greedy action from Q-network */
+    /* Greedy action from Q-network; one row whatever the state's shape */
     rtka_tensor_t* q_values = rtka_ml_predict(agent->q_network, state);
-    
-    rtka_value_t best_action = RTKA_UNKNOWN;
-    rtka_confidence_t best_value = -1000.0f;
-    
-    for (uint32_t a = 0; a < q_values->shape[0]; a++) {
-        if (q_values->data[a].confidence > best_value) {
-            best_value = q_values->data[a].confidence;
-            best_action = q_values->data[a].value;
+    if (!q_values) return random_action(NULL);
+    greedy_rows(q_values, 1, &explore, &action);
+    rtka_tensor_free(q_values);
+    return action;
+}
+
+static rtka_error_t epsilon_greedy(rtka_model_t* q_network, rtka_confidence_t epsilon, rtka_rng_t* rng,
+                                   rtka_tensor_t* states, rtka_value_t* actions) {
+    if (states->ndim != 2) return RTKA_ERROR_INVALID_VALUE;
+    uint32_t rows = states->shape[0];
+    bool* explore = (bool*)malloc(rows * sizeof(bool));
+    if (!explore) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    bool greedy = false;
+    for (uint32_t i = 0; i < rows; i++) {
+        explore[i] = exploration_float(rng) < epsilon;
+        if (explore[i]) actions[i] = random_action(rng);
+        greedy |= !explore[i];
+    }
+    if (greedy) {
+        /* Every greedy row from one forward pass */
+        rtka_tensor_t* q_values = rtka_ml_predict(q_network, states);
+        if (q_values && q_values->size % rows == 0) {
+            greedy_rows(q_values, rows, explore, actions);
+        } else {
+            for (uint32_t i = 0; i < rows; i++) {
+                if (!explore[i]) actions[i] = random_action(rng);
+            }
         }
+        rtka_tensor_free(q_values);
+    }
+    free(explore);
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_rl_select_actions_epsilon_greedy(rtka_dqn_agent_t* agent, rtka_tensor_t* states,
+                                                   rtka_value_t* actions) {
+    if (!agent || !states || !actions) return RTKA_ERROR_NULL_POINTER;
+    return epsilon_greedy(agent->q_network, agent->epsilon, NULL, states, actions);
+}
+
+/* Sample from the ternary distribution of one row of probabilities */
+static rtka_value_t sample_policy_row(const rtka_state_t* probs, uint32_t outputs) {
+    rtka_confidence_t total = 0.0f;
+    for (uint32_t i = 0; i < outputs; i++) {
+        total += probs[i].confidence;
     }
     
-    rtka_tensor_free(q_values);
-    return best_action;
+    float r = exploration_float(NULL) * total;
+    rtka_confidence_t cumsum = 0.0f;
+    
+    for (uint32_t i = 0; i < outputs; i++) {
+        cumsum += probs[i].confidence;
+        if (r <= cumsum) return probs[i].value;
+    }
+    return RTKA_UNKNOWN;
 }
 
 /* Policy-based action selection */
 rtka_value_t rtka_rl_select_action_policy(rtka_pg_agent_t* agent, rtka_tensor_t* state) {
     rtka_tensor_t* action_probs = rtka_ml_predict(agent->policy_network, state);
+    if (!action_probs) return RTKA_UNKNOWN;
+    rtka_value_t action = sample_policy_row(action_probs->data, action_probs->size);
+    rtka_tensor_free(action_probs);
+    return action;
+}
+
+rtka_error_t rtka_rl_select_actions_policy(rtka_pg_agent_t* agent, rtka_tensor_t* states,
+                                           rtka_value_t* actions) {
+    if (!agent || !states || !actions) return RTKA_ERROR_NULL_POINTER;
+    if (states->ndim != 2) return RTKA_ERROR_INVALID_VALUE;
+    uint32_t rows = states->shape[0];
+    rtka_tensor_t* action_probs = rtka_ml_predict(agent->policy_network, states);
+    if (!action_probs) return RTKA_ERROR_NOT_INITIALIZED;
+    if (action_probs->size % rows != 0) {
+        rtka_tensor_free(action_probs);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    uint32_t outputs = action_probs->size / rows;
+    for (uint32_t i = 0; i < rows; i++) {
+        actions[i] = sample_policy_row(action_probs->data + (size_t)i * outputs, outputs);
+    }
+    rtka_tensor_free(action_probs);
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * DQN TRAINING
+ * ============================================================================ */
+
+/* Scratch of the learner: the sampled batch and its regression targets */
+typedef struct {
+    rtka_replay_batch_t* batch;
+    rtka_tensor_t* targets;         /* batch_size x action_dim */
+    rtka_confidence_t* td;          /* TD targets, then TD errors */
+} dqn_learner_t;
+
+static void learner_free(dqn_learner_t* learner) {
+    rtka_rl_free_batch(learner->batch);
+    rtka_tensor_free(learner->targets);
+    free(learner->td);
+}
+
+static bool learner_init(dqn_learner_t* learner, const rtka_dqn_agent_t* agent, uint32_t batch_size) {
+    uint32_t shape[2] = { batch_size, agent->action_dim };
+    learner->batch = rtka_rl_create_batch(batch_size, agent->buffer->observation_size);
+    learner->targets = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    learner->td = (rtka_confidence_t*)malloc(batch_size * sizeof(rtka_confidence_t));
+    if (learner->batch && learner->targets && learner->td) return true;
+    learner_free(learner);
+    return false;
+}
+
+/* One replay batch: TD targets from the target network, then one optimizer
+ * step of the Q-network towards them on the taken actions. Before the first
+ * target sync the target network bootstraps from zero. */
+static void dqn_learn(rtka_dqn_agent_t* agent, dqn_learner_t* learner) {
+    rtka_replay_batch_t* batch = learner->batch;
+    if (rtka_rl_sample_batch(agent->buffer, batch, 0.4f) != RTKA_SUCCESS) return;
+    uint32_t actions = agent->action_dim, count = batch->batch_size;
     
-    /* Sample from ternary distribution */
-    rtka_confidence_t total = 0.0f;
-    for (uint32_t i = 0; i < action_probs->size; i++) {
-        total += action_probs->data[i].confidence;
+    /* Q-targets for the whole batch in one pass */
+    rtka_arena_begin_step(agent->target_network->arena);
+    rtka_tensor_t* next_q = rtka_ml_predict(agent->target_network, batch->next_states);
+    if (next_q && next_q->size != count * actions) {
+        rtka_tensor_free(next_q);
+        next_q = NULL;
     }
+    for (uint32_t i = 0; i < count; i++) {
+        rtka_confidence_t max_next_q = 0.0f;
+        for (uint32_t a = 0; next_q && a < actions; a++) {
+            if (next_q->data[i * actions + a].confidence > max_next_q) {
+                max_next_q = next_q->data[i * actions + a].confidence;
+            }
+        }
+        
+        rtka_confidence_t target = batch->rewards[i];
+        if (!batch->dones[i]) {
+            target += agent->gamma * max_next_q;
+        }
+        learner->td[i] = target;
+    }
+    rtka_tensor_free(next_q);
+    rtka_arena_end_step(agent->target_network->arena);
     
-    float r = (float)rand() / RAND_MAX * total;
-    rtka_confidence_t cumsum = 0.0f;
+    /* Untaken actions regress onto the current prediction */
+    rtka_tensor_t* targets = learner->targets;
+    rtka_arena_begin_step(agent->q_network->arena);
+    rtka_tensor_t* q_values = rtka_ml_predict(agent->q_network, batch->states);
+    if (q_values && q_values->size == targets->size) {
+        memcpy(targets->data, q_values->data, targets->size * sizeof(rtka_state_t));
+    } else {
+        for (uint32_t i = 0; i < targets->size; i++) targets->data[i] = rtka_make_state(RTKA_UNKNOWN, 0.0f);
+    }
+    rtka_tensor_free(q_values);
+    rtka_arena_end_step(agent->q_network->arena);
     
-    for (uint32_t i = 0; i < action_probs->size; i++) {
-        cumsum += action_probs->data[i].confidence;
-        if (r <= cumsum) {
-            rtka_value_t action = action_probs->data[i].value;
-            rtka_tensor_free(action_probs);
-            return action;
-        }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t a = q_output(batch->actions[i]);
+        rtka_state_t* q = &targets->data[(size_t)i * actions + (a < actions ? a : 0)];
+        rtka_confidence_t target = learner->td[i];
+        learner->td[i] = target - q->confidence;
+        q->confidence = target;
     }
     
-    rtka_tensor_free(action_probs);
-    return RTKA_UNKNOWN;
+    /* Update Q-network */
+    rtka_ml_train_batch(agent->q_network, batch->states, targets);
+    if (agent->buffer->tree) rtka_rl_update_priorities(agent->buffer, batch->indices, learner->td, count);
+}
+
+/* Weight and bias tensors in layer order; returns how many */
+static uint32_t model_parameters(const rtka_model_t* model, rtka_tensor_t** params, uint32_t max) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < model->network->num_layers; i++) {
+        rtka_layer_t* layer = model->network->layers[i];
+        if (layer->weight && count < max) params[count++] = layer->weight->data;
+        if (layer->bias && count < max) params[count++] = layer->bias->data;
+    }
+    return count;
+}
+
+static void dqn_sync_target(rtka_dqn_agent_t* agent) {
+    /* Copy weights and biases from Q to target */
+    rtka_tensor_t* q_params[128];
+    rtka_tensor_t* target_params[128];
+    uint32_t count = model_parameters(agent->q_network, q_params, 128);
+    if (model_parameters(agent->target_network, target_params, 128) != count) return;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        if (q_params[i]->size != target_params[i]->size) return;
+        memcpy(target_params[i]->data, q_params[i]->data, q_params[i]->size * sizeof(rtka_state_t));
+    }
+    agent->target_network->trained = agent->q_network->trained;
+}
+
+static void decay_epsilon(rtka_confidence_t* epsilon) {
+    *epsilon *= 0.995f;
+    if (*epsilon < 0.01f) *epsilon = 0.01f;
 }
 
 /* Train DQN */
 void rtka_rl_train_dqn(rtka_dqn_agent_t* agent, rtka_environment_t* env, uint32_t episodes) {
+    rtka_vec_env_t* vec;
+    if (rtka_vec_env_create(&vec, env, 1, NULL) != RTKA_SUCCESS) return;
+    rtka_rl_train_dqn_vectorized(agent, vec, episodes);
+    rtka_vec_env_free(vec);
+}
+
+void rtka_rl_train_dqn_vectorized(rtka_dqn_agent_t* agent, rtka_vec_env_t* vec, uint32_t episodes) {
     uint32_t batch_size = 32;
-    uint32_t total_steps = 0;
-    
-    for (uint32_t episode = 0; episode < episodes; episode++) {
-        rtka_tensor_t* state = env->reset(env->env_data);
-        rtka_confidence_t episode_reward = 0.0f;
-        bool done = false;
+    uint32_t total_steps = 0, finished = 0, n = vec->num_envs, size = vec->observation_dim;
+    dqn_learner_t learner;
+    if (size != agent->buffer->observation_size || !learner_init(&learner, agent, batch_size)) return;
+    rtka_value_t* actions = (rtka_value_t*)malloc(n * sizeof(rtka_value_t));
+    if (!actions || rtka_vec_env_reset(vec) != RTKA_SUCCESS) {
+        learner_free(&learner);
+        free(actions);
+        return;
+    }
+
+    while (finished < episodes) {
+        /* One forward pass selects every environment's action */
+        if (rtka_rl_select_actions_epsilon_greedy(agent, vec->observations, actions) != RTKA_SUCCESS ||
+            rtka_vec_env_step(vec, actions) != RTKA_SUCCESS) {
+            break;
+        }
+
+        bool stored = true;
+        for (uint32_t i = 0; i < n && stored; i++) {
+            stored = rtka_rl_store_states(agent->buffer, vec->previous->data + (size_t)i * size, actions[i],
+                                          vec->rewards[i], vec->next_observations->data + (size_t)i * size,
+                                          vec->dones[i]) == RTKA_SUCCESS;
+        }
+        if (!stored) break;
         
-        while (!done) {
-            /* Select action */
-            rtka_value_t action = rtka_rl_select_action_epsilon_greedy(agent, state);
-            
-            /* Take action */
-            rtka_confidence_t reward;
-            rtka_tensor_t* next_state = env->step(env->env_data, action, &reward, &done);
-            
-            /* Store experience */
-            rtka_rl_store_experience(agent->buffer, state, action, reward, next_state, done);
-            
-            /* Train if enough experiences */
-            if (agent->buffer->size >= batch_size) {
-                /* Sample batch */
-                rtka_tensor_t** batch_states = (rtka_tensor_t**)rtka_alloc_states(batch_size * sizeof(void*) / sizeof(rtka_state_t));
-                rtka_value_t* batch_actions = (rtka_value_t*)rtka_alloc_states(batch_size * sizeof(rtka_value_t) / sizeof(rtka_state_t));
-                rtka_confidence_t* batch_rewards = (rtka_confidence_t*)rtka_alloc_states(batch_size * sizeof(rtka_confidence_t) / sizeof(rtka_state_t));
-                rtka_tensor_t** batch_next_states = (rtka_tensor_t**)rtka_alloc_states(batch_size * sizeof(void*) / sizeof(rtka_state_t));
-                bool* batch_dones = (bool*)rtka_alloc_states(batch_size * sizeof(bool) / sizeof(rtka_state_t));
-                
-                rtka_rl_sample_batch(agent->buffer, batch_states, batch_actions, 
-                                   batch_rewards, batch_next_states, batch_dones, batch_size);
-                
-                /* Compute Q-targets */
-                for (uint32_t i = 0; i < batch_size; i++) {
-                    rtka_tensor_t* next_q = rtka_ml_predict(agent->target_network, batch_next_states[i]);
-                    
-                    rtka_confidence_t max_next_q = 0.0f;
-                    for (uint32_t a = 0; a < next_q->shape[0]; a++) {
-                        if (next_q->data[a].confidence > max_next_q) {
-                            max_next_q = next_q->data[a].confidence;
-                        }
-                    }
-                    
-                    rtka_confidence_t target = batch_rewards[i];
-                    if (!batch_dones[i]) {
-                        target += agent->gamma * max_next_q;
-                    }
-                    
-                    /* Update Q-network (simplified) */
-                    rtka_tensor_free(next_q);
-                }
-            }
-            
-            state = next_state;
-            episode_reward += reward;
-            total_steps++;
-            
-            /* Update target network */
-            if (total_steps % agent->update_frequency == 0) {
-                /* Copy weights from Q to target (simplified) */
-                for (uint32_t i = 0; i < agent->q_network->network->num_layers; i++) {
-                    rtka_layer_t* q_layer = agent->q_network->network->layers[i];
-                    rtka_layer_t* target_layer = agent->target_network->network->layers[i];
-                    
-                    if (q_layer->weight && target_layer->weight) {
-                        memcpy(target_layer->weight->data->data, 
-                              q_layer->weight->data->data,
-                              q_layer->weight->data->size * sizeof(rtka_state_t));
-                    }
-                }
+        /* Train if enough experiences */
+        if (agent->buffer->size >= batch_size) dqn_learn(agent, &learner);
+        
+        /* Update target network */
+        uint32_t before = total_steps / agent->update_frequency;
+        total_steps += n;
+        if (total_steps / agent->update_frequency != before) dqn_sync_target(agent);
+        
+        /* Decay epsilon per finished episode */
+        for (uint32_t i = 0; i < n; i++) {
+            if (!vec->dones[i]) continue;
+            finished++;
+            decay_epsilon(&agent->epsilon);
+        }
+    }
+    learner_free(&learner);
+    free(actions);
+}
+
+/* ============================================================================
+ * ASYNCHRONOUS ACTORS AND LEARNER
+ * ============================================================================ */
+
+/* The learner's latest parameters as rtka_state_t bit patterns. The learner
+ * makes sequence odd, writes, and makes it even again; a copy taken under an
+ * even sequence that has not moved by the end is consistent. */
+typedef struct {
+    RTKA_ALIGNED(64) _Atomic uint64_t sequence;
+    RTKA_ALIGNED(64) _Atomic uint64_t* words;
+    size_t count;
+} param_board_t;
+
+static size_t model_parameter_count(const rtka_model_t* model) {
+    rtka_tensor_t* params[128];
+    uint32_t count = model_parameters(model, params, 128);
+    size_t total = 0;
+    for (uint32_t i = 0; i < count; i++) total += params[i]->size;
+    return total;
+}
+
+static void board_publish(param_board_t* board, const rtka_model_t* model) {
+    rtka_tensor_t* params[128];
+    uint32_t count = model_parameters(model, params, 128);
+    uint64_t sequence = atomic_load_explicit(&board->sequence, memory_order_relaxed);
+    atomic_store_explicit(&board->sequence, sequence + 1U, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    size_t w = 0;
+    for (uint32_t p = 0; p < count; p++) {
+        for (uint32_t i = 0; i < params[p]->size && w < board->count; i++, w++) {
+            uint64_t bits;
+            memcpy(&bits, &params[p]->data[i], sizeof(bits));
+            atomic_store_explicit(&board->words[w], bits, memory_order_relaxed);
+        }
+    }
+    atomic_store_explicit(&board->sequence, sequence + 2U, memory_order_release);
+}
+
+/* Copies a newer snapshot than seen into model; returns the sequence held */
+static uint64_t board_fetch(param_board_t* board, uint64_t seen, uint64_t* scratch, rtka_model_t* model) {
+    for (;;) {
+        uint64_t sequence = atomic_load_explicit(&board->sequence, memory_order_acquire);
+        if (sequence == seen) return seen;
+        if (sequence & 1U) {
+            sched_yield();
+            continue;
+        }
+        for (size_t w = 0; w < board->count; w++) {
+            scratch[w] = atomic_load_explicit(&board->words[w], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&board->sequence, memory_order_relaxed) != sequence) continue;
+
+        rtka_tensor_t* params[128];
+        uint32_t count = model_parameters(model, params, 128);
+        size_t w = 0;
+        for (uint32_t p = 0; p < count; p++) {
+            for (uint32_t i = 0; i < params[p]->size && w < board->count; i++, w++) {
+                memcpy(&params[p]->data[i], &scratch[w], sizeof(rtka_state_t));
             }
         }
-        
-        /* Decay epsilon */
-        agent->epsilon *= 0.995f;
-        if (agent->epsilon < 0.01f) agent->epsilon = 0.01f;
+        model->trained = true;
+        return sequence;
+    }
+}
+
+/* Single producer (an actor), single consumer (the learner). Slot k holds
+ * transition k % capacity, state then next state; tail publishes written
+ * slots, head releases stored ones. */
+typedef struct {
+    RTKA_ALIGNED(64) _Atomic uint64_t head;
+    RTKA_ALIGNED(64) _Atomic uint64_t tail;
+    RTKA_ALIGNED(64) uint32_t capacity;
+    uint32_t observation_size;
+    rtka_state_t* observations;     /* capacity x 2 observation_size */
+    rtka_value_t* actions;
+    rtka_confidence_t* rewards;
+    bool* dones;
+} transition_mailbox_t;
+
+static void mailbox_free(transition_mailbox_t* box) {
+    if (!box) return;
+    free(box->observations);
+    free(box->actions);
+    free(box->rewards);
+    free(box->dones);
+    free(box);
+}
+
+static transition_mailbox_t* mailbox_create(uint32_t capacity, uint32_t observation_size) {
+    transition_mailbox_t* box =
+        (transition_mailbox_t*)aligned_alloc(64, (sizeof(transition_mailbox_t) + 63U) & ~(size_t)63U);
+    if (!box) return NULL;
+    memset(box, 0, sizeof(*box));
+    atomic_init(&box->head, 0);
+    atomic_init(&box->tail, 0);
+    box->capacity = capacity;
+    box->observation_size = observation_size;
+    box->observations = (rtka_state_t*)malloc((size_t)capacity * 2U * observation_size * sizeof(rtka_state_t));
+    box->actions = (rtka_value_t*)malloc(capacity * sizeof(rtka_value_t));
+    box->rewards = (rtka_confidence_t*)malloc(capacity * sizeof(rtka_confidence_t));
+    box->dones = (bool*)malloc(capacity * sizeof(bool));
+    if (!box->observations || !box->actions || !box->rewards || !box->dones) {
+        mailbox_free(box);
+        return NULL;
+    }
+    return box;
+}
+
+/* Producer side: false while the mailbox is full */
+static bool mailbox_post(transition_mailbox_t* box, const rtka_state_t* state, rtka_value_t action,
+                         rtka_confidence_t reward, const rtka_state_t* next_state, bool done) {
+    uint64_t tail = atomic_load_explicit(&box->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&box->head, memory_order_acquire);
+    if (tail - head >= box->capacity) return false;
+
+    uint32_t slot = (uint32_t)(tail % box->capacity);
+    size_t size = box->observation_size;
+    rtka_state_t* row = box->observations + (size_t)slot * 2U * size;
+    memcpy(row, state, size * sizeof(rtka_state_t));
+    memcpy(row + size, next_state, size * sizeof(rtka_state_t));
+    box->actions[slot] = action;
+    box->rewards[slot] = reward;
+    box->dones[slot] = done;
+    atomic_store_explicit(&box->tail, tail + 1U, memory_order_release);
+    return true;
+}
+
+/* Consumer side: every posted transition into the replay buffer */
+static uint32_t mailbox_drain(transition_mailbox_t* box, rtka_replay_buffer_t* buffer) {
+    uint64_t head = atomic_load_explicit(&box->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&box->tail, memory_order_acquire);
+    size_t size = box->observation_size;
+    uint32_t stored = 0;
+    for (; head != tail; head++) {
+        uint32_t slot = (uint32_t)(head % box->capacity);
+        const rtka_state_t* row = box->observations + (size_t)slot * 2U * size;
+        stored += rtka_rl_store_states(buffer, row, box->actions[slot], box->rewards[slot], row + size,
+                                       box->dones[slot]) == RTKA_SUCCESS;
+    }
+    atomic_store_explicit(&box->head, head, memory_order_release);
+    return stored;
+}
+
+typedef struct {
+    param_board_t board;
+    RTKA_ALIGNED(64) _Atomic uint32_t finished;     /* Episodes finished across actors */
+    _Atomic uint32_t running;                       /* Actors still stepping */
+    _Atomic bool stop;
+    uint32_t episodes;
+} async_shared_t;
+
+typedef struct {
+    async_shared_t* shared;
+    rtka_vec_env_t* vec;
+    transition_mailbox_t* mailbox;
+    rtka_model_t* network;          /* Private copy of the Q-network */
+    uint64_t* scratch;              /* board.count words */
+    rtka_rng_t rng;
+    rtka_confidence_t epsilon;
+    rtka_error_t status;
+} async_actor_t;
+
+static bool actor_post(async_actor_t* actor, uint32_t i, rtka_value_t action) {
+    rtka_vec_env_t* vec = actor->vec;
+    size_t offset = (size_t)i * vec->observation_dim;
+    while (!mailbox_post(actor->mailbox, vec->previous->data + offset, action, vec->rewards[i],
+                         vec->next_observations->data + offset, vec->dones[i])) {
+        if (atomic_load_explicit(&actor->shared->stop, memory_order_relaxed)) return false;
+        sched_yield();
+    }
+    return true;
+}
+
+static void* actor_main(void* arg) {
+    async_actor_t* actor = (async_actor_t*)arg;
+    async_shared_t* shared = actor->shared;
+    rtka_vec_env_t* vec = actor->vec;
+    uint64_t seen = 0;
+    rtka_value_t* actions = (rtka_value_t*)malloc(vec->num_envs * sizeof(rtka_value_t));
+    actor->status = actions ? rtka_vec_env_reset(vec) : RTKA_ERROR_OUT_OF_MEMORY;
+
+    while (actor->status == RTKA_SUCCESS && !atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        /* Until the first publication the untrained copy explores */
+        seen = board_fetch(&shared->board, seen, actor->scratch, actor->network);
+        actor->status = epsilon_greedy(actor->network, actor->epsilon, &actor->rng, vec->observations, actions);
+        if (actor->status != RTKA_SUCCESS) break;
+        actor->status = rtka_vec_env_step(vec, actions);
+        if (actor->status != RTKA_SUCCESS) break;
+
+        uint32_t done = 0;
+        bool posted = true;
+        for (uint32_t i = 0; i < vec->num_envs && posted; i++) {
+            posted = actor_post(actor, i, actions[i]);
+            done += vec->dones[i];
+        }
+        if (!posted) break;
+        for (uint32_t d = 0; d < done; d++) decay_epsilon(&actor->epsilon);
+        if (done) atomic_fetch_add_explicit(&shared->finished, done, memory_order_release);
     }
+    free(actions);
+    atomic_fetch_sub_explicit(&shared->running, 1U, memory_order_release);
+    return NULL;
+}
+
+/* A Q-network of the agent's shape */
+static rtka_model_t* dqn_network(uint32_t state_dim, uint32_t action_dim) {
+    uint32_t hidden[] = {128, 64};
+    rtka_model_t* model = rtka_ml_create_mlp(state_dim, hidden, 2, action_dim);
+    if (model) model->type = MODEL_REGRESSOR;
+    return model;
+}
+
+static void actors_free(async_actor_t* actors, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        mailbox_free(actors[i].mailbox);
+        free(actors[i].scratch);
+        rtka_ml_free_model(actors[i].network);
+    }
+    free(actors);
+}
+
+rtka_error_t rtka_rl_train_dqn_async(rtka_dqn_agent_t* agent, rtka_vec_env_t** actor_envs, uint32_t num_actors,
+                                     uint32_t episodes, const rtka_async_config_t* config) {
+    if (!agent || !actor_envs || !agent->buffer) return RTKA_ERROR_NULL_POINTER;
+    if (num_actors == 0) return RTKA_ERROR_INVALID_VALUE;
+    rtka_async_config_t settings = config ? *config : (rtka_async_config_t){0};
+    if (settings.batch_size == 0) settings.batch_size = 32;
+    if (settings.learn_start < settings.batch_size) settings.learn_start = settings.batch_size;
+    if (settings.publish_interval == 0) settings.publish_interval = 1;
+    if (settings.mailbox_capacity == 0) settings.mailbox_capacity = 1024;
+    for (uint32_t i = 0; i < num_actors; i++) {
+        if (!actor_envs[i]) return RTKA_ERROR_NULL_POINTER;
+        if (actor_envs[i]->observation_dim != agent->buffer->observation_size) return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    async_shared_t shared;
+    memset(&shared, 0, sizeof(shared));
+    atomic_init(&shared.board.sequence, 0);
+    atomic_init(&shared.finished, 0);
+    atomic_init(&shared.running, 0);
+    atomic_init(&shared.stop, false);
+    shared.episodes = episodes;
+    shared.board.count = model_parameter_count(agent->q_network);
+    shared.board.words = (_Atomic uint64_t*)malloc(shared.board.count * sizeof(_Atomic uint64_t));
+    async_actor_t* actors = (async_actor_t*)calloc(num_actors, sizeof(async_actor_t));
+    pthread_t* threads = (pthread_t*)calloc(num_actors, sizeof(pthread_t));
+    dqn_learner_t learner;
+    bool learning = shared.board.words && actors && threads && learner_init(&learner, agent, settings.batch_size);
+    bool prepared = learning;
+    for (size_t w = 0; prepared && w < shared.board.count; w++) atomic_init(&shared.board.words[w], 0);
+    for (uint32_t i = 0; prepared && i < num_actors; i++) {
+        async_actor_t* actor = &actors[i];
+        actor->shared = &shared;
+        actor->vec = actor_envs[i];
+        actor->epsilon = agent->epsilon;
+        actor->mailbox = mailbox_create(settings.mailbox_capacity, agent->buffer->observation_size);
+        actor->network = dqn_network(agent->state_dim, agent->action_dim);
+        actor->scratch = (uint64_t*)malloc(shared.board.count * sizeof(uint64_t));
+        rtka_random_init_splitmix(&actor->rng, rtka_random_next(rtka_random_thread()));
+        prepared = actor->mailbox && actor->network && actor->scratch &&
+                   model_parameter_count(actor->network) == shared.board.count;
+    }
+    if (!prepared) {
+        if (learning) learner_free(&learner);
+        if (actors) actors_free(actors, num_actors);
+        free(threads);
+        free((void*)shared.board.words);
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    /* A network already trained goes out before the actors start */
+    if (agent->q_network->trained) board_publish(&shared.board, agent->q_network);
+
+    uint32_t started = 0;
+    for (; started < num_actors; started++) {
+        atomic_fetch_add_explicit(&shared.running, 1U, memory_order_relaxed);
+        if (pthread_create(&threads[started], NULL, actor_main, &actors[started]) != 0) {
+            atomic_fetch_sub_explicit(&shared.running, 1U, memory_order_relaxed);
+            break;
+        }
+    }
+
+    /* The caller is the learner */
+    uint64_t total_steps = 0, updates = 0;
+    bool idle_exit = started == 0;
+    while (!idle_exit && atomic_load_explicit(&shared.finished, memory_order_acquire) < episodes) {
+        bool live = atomic_load_explicit(&shared.running, memory_order_acquire) > 0;
+        uint32_t stored = 0;
+        for (uint32_t i = 0; i < started; i++) stored += mailbox_drain(actors[i].mailbox, agent->buffer);
+
+        uint64_t before = total_steps / agent->update_frequency;
+        total_steps += stored;
+        if (total_steps / agent->update_frequency != before) dqn_sync_target(agent);
+
+        if (agent->buffer->size >= settings.learn_start) {
+            dqn_learn(agent, &learner);
+            if (++updates % settings.publish_interval == 0) board_publish(&shared.board, agent->q_network);
+        } else if (!stored) {
+            sched_yield();
+        }
+        idle_exit = !live && !stored;
+    }
+
+    atomic_store_explicit(&shared.stop, true, memory_order_relaxed);
+    for (uint32_t i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    for (uint32_t i = 0; i < started; i++) mailbox_drain(actors[i].mailbox, agent->buffer);
+
+    rtka_error_t status = started == num_actors ? RTKA_SUCCESS : RTKA_ERROR_OUT_OF_MEMORY;
+    for (uint32_t i = 0; i < started && status == RTKA_SUCCESS; i++) {
+        if (actors[i].status != RTKA_SUCCESS) status = actors[i].status;
+    }
+    uint32_t finished = atomic_load_explicit(&shared.finished, memory_order_acquire);
+    for (uint32_t e = 0; e < finished; e++) decay_epsilon(&agent->epsilon);
+    agent->async_updates = updates;
+
+    learner_free(&learner);
+    actors_free(actors, num_actors);
+    free(threads);
+    free((void*)shared.board.words);
+    return status;
 }
 
 /* Compute advantages */
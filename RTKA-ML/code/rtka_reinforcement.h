@@ -9,6 +9,15 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Reinforcement Learning
+ *
+ * CHANGELOG:
+ * v1.1.0 - The replay buffer is one preallocated ring of observation rows.
+ *          A transition starts from its row and ends in the next one, so
+ *          a chained episode stores every observation once. Sampling
+ *          gathers straight into the batch x observation tensors of a
+ *          reusable rtka_replay_batch_t. Prioritized replay draws
+ *          transitions in proportion to priority^alpha from a sum tree in
+ *          O(log n) and returns importance weights.
  */
 
 #ifndef RTKA_REINFORCEMENT_H
@@ -18,8 +27,10 @@
 #include "rtka_tensor.h"
 #include "rtka_nn.h"
 #include "rtka_ml.h"
+#include "rtka_random.h"
+#include "rtka_threadpool.h"
 
-/* Environment interface */
+/* Environment interface; reset and step return tensors the caller owns */
 typedef struct {
     rtka_tensor_t* (*reset)(void* env_data);
     rtka_tensor_t* (*step)(void* env_data, rtka_value_t action, rtka_confidence_t* reward, bool* done);
@@ -28,18 +39,65 @@ typedef struct {
     void* env_data;
 } rtka_environment_t;
 
-/* Experience replay buffer */
+/* N environments stepped as one. Every instance needs its own env_data;
+ * with a pool, reset and step run on worker threads, so they must not
+ * share unsynchronized state. A done environment is reset inside the step,
+ * so observations always holds the states the next actions act on. */
+typedef struct {
+    rtka_environment_t* envs;           /* Copy of the num_envs descriptors */
+    uint32_t num_envs;
+    uint32_t observation_dim;
+    rtka_tensor_t* observations;        /* num_envs x observation_dim */
+    rtka_tensor_t* previous;            /* Observations the last step's actions saw */
+    rtka_tensor_t* next_observations;   /* Last step's results, the final one where done */
+    rtka_confidence_t* rewards;
+    bool* dones;
+    rtka_error_t* status;               /* Per environment, for the worker threads */
+    rtka_thread_pool_t* pool;           /* NULL = every environment on the caller's thread */
+} rtka_vec_env_t;
+
+/* Experience replay buffer. Rows are capacity + 1 observations; the
+ * transition stored at row i goes from row i to row i + 1 (mod rows).
+ * Writing a next state over a row retires the transition that started
+ * there, so the newest capacity transitions are kept. A store whose state
+ * differs from the previous next state (an episode cut without done)
+ * leaves that row alone and starts one row later. The next state of a
+ * done transition is overwritten by the following reset and must be
+ * masked by dones. */
 typedef struct {
-    rtka_tensor_t** states;
+    rtka_state_t* observations;     /* rows x observation_size */
     rtka_value_t* actions;
     rtka_confidence_t* rewards;
-    rtka_tensor_t** next_states;
     bool* dones;
+    uint8_t* valid;                 /* Row starts a kept transition */
+    uint32_t observation_size;
     uint32_t capacity;
-    uint32_t size;
-    uint32_t position;
+    uint32_t size;                  /* Kept transitions */
+    uint32_t position;              /* Row the next transition starts from */
+    uint32_t rows;
+    uint32_t filled;                /* Rows written at least once */
+    bool open;                      /* position holds a next state not yet done */
+    rtka_rng_t rng;                 /* Seeded from the global RNG */
+    /* Prioritized replay; tree is NULL for uniform sampling */
+    rtka_confidence_t* tree;        /* Sum tree, leaf i at tree[leaves + i] */
+    uint32_t leaves;
+    rtka_confidence_t alpha;
+    rtka_confidence_t max_priority; /* New transitions get the largest so far */
 } rtka_replay_buffer_t;
 
+/* A sampled batch, reused across samples */
+typedef struct {
+    rtka_tensor_t* states;          /* batch_size x observation_size */
+    rtka_tensor_t* next_states;
+    rtka_value_t* actions;
+    rtka_confidence_t* rewards;
+    bool* dones;
+    uint32_t* indices;              /* Rows, for rtka_rl_update_priorities */
+    rtka_confidence_t* weights;     /* Importance weights, largest 1; all 1 when uniform */
+    uint32_t batch_size;
+    uint32_t observation_size;
+} rtka_replay_batch_t;
+
 /* Q-Network for ternary actions */
 typedef struct {
     rtka_model_t* q_network;
@@ -47,9 +105,20 @@ typedef struct {
     rtka_replay_buffer_t* buffer;
     rtka_confidence_t epsilon;
     rtka_confidence_t gamma;
-    uint32_t update_frequency;
+    uint32_t update_frequency;      /* Transitions between target syncs */
+    uint32_t state_dim;
+    uint32_t action_dim;
+    uint64_t async_updates;         /* Learner steps of the last asynchronous run */
 } rtka_dqn_agent_t;
 
+/* Asynchronous training; zero fields take the defaults */
+typedef struct {
+    uint32_t batch_size;            /* 32 */
+    uint32_t learn_start;           /* Stored transitions before the first update (batch_size) */
+    uint32_t publish_interval;      /* Learner steps between publications to the actors (1) */
+    uint32_t mailbox_capacity;      /* Transitions an actor queues before it waits (1024) */
+} rtka_async_config_t;
+
 /* Policy gradient agent */
 typedef struct {
     rtka_model_t* policy_network;
@@ -69,10 +138,46 @@ rtka_pg_agent_t* rtka_rl_create_pg(uint32_t state_dim, uint32_t action_dim);
 void rtka_rl_train_dqn(rtka_dqn_agent_t* agent, rtka_environment_t* env, uint32_t episodes);
 void rtka_rl_train_pg(rtka_pg_agent_t* agent, rtka_environment_t* env, uint32_t episodes);
 
+/* Runs until episodes episodes have finished across the vector. Stores of
+ * different environments interleave in the replay ring, so with more than
+ * one environment every transition takes two rows. */
+void rtka_rl_train_dqn_vectorized(rtka_dqn_agent_t* agent, rtka_vec_env_t* vec, uint32_t episodes);
+
+/* One actor thread per vector while the caller learns, until episodes
+ * episodes have finished across the actors. Actors act on their own copy
+ * of the Q-network, refreshed from each publication, and explore until the
+ * first one. Their vectors must not share environments or pools. */
+RTKA_NODISCARD rtka_error_t rtka_rl_train_dqn_async(rtka_dqn_agent_t* agent,
+                                                    rtka_vec_env_t** actor_envs,
+                                                    uint32_t num_actors,
+                                                    uint32_t episodes,
+                                                    const rtka_async_config_t* config);
+
+/* Vectorized environments; envs is copied */
+RTKA_NODISCARD rtka_error_t rtka_vec_env_create(rtka_vec_env_t** vec, const rtka_environment_t* envs,
+                                                uint32_t num_envs, rtka_thread_pool_t* pool);
+void rtka_vec_env_free(rtka_vec_env_t* vec);
+
+/* Resets every environment into observations */
+RTKA_NODISCARD rtka_error_t rtka_vec_env_reset(rtka_vec_env_t* vec);
+
+/* actions[i] to environment i: copies observations to previous, fills
+ * next_observations, rewards and dones, and resets the done environments */
+RTKA_NODISCARD rtka_error_t rtka_vec_env_step(rtka_vec_env_t* vec, const rtka_value_t* actions);
+
 /* Action selection */
 rtka_value_t rtka_rl_select_action_epsilon_greedy(rtka_dqn_agent_t* agent, rtka_tensor_t* state);
 rtka_value_t rtka_rl_select_action_policy(rtka_pg_agent_t* agent, rtka_tensor_t* state);
 
+/* One action per row of an N x observation_dim tensor from a single forward
+ * pass. Greedy rows of an untrained Q-network explore instead. */
+RTKA_NODISCARD rtka_error_t rtka_rl_select_actions_epsilon_greedy(rtka_dqn_agent_t* agent,
+                                                                  rtka_tensor_t* states,
+                                                                  rtka_value_t* actions);
+RTKA_NODISCARD rtka_error_t rtka_rl_select_actions_policy(rtka_pg_agent_t* agent,
+                                                          rtka_tensor_t* states,
+                                                          rtka_value_t* actions);
+
 /* Ternary Q-learning update */
 RTKA_INLINE void rtka_rl_update_q_ternary(rtka_state_t* q_value, 
                                          rtka_confidence_t reward,
@@ -97,20 +202,41 @@ RTKA_INLINE void rtka_rl_update_q_ternary(rtka_state_t* q_value,
 }
 
 /* Experience replay operations */
-rtka_replay_buffer_t* rtka_rl_create_buffer(uint32_t capacity);
-void rtka_rl_store_experience(rtka_replay_buffer_t* buffer,
-                             rtka_tensor_t* state,
-                             rtka_value_t action,
-                             rtka_confidence_t reward,
-                             rtka_tensor_t* next_state,
-                             bool done);
-void rtka_rl_sample_batch(rtka_replay_buffer_t* buffer,
-                         rtka_tensor_t** states,
-                         rtka_value_t* actions,
-                         rtka_confidence_t* rewards,
-                         rtka_tensor_t** next_states,
-                         bool* dones,
-                         uint32_t batch_size);
+rtka_replay_buffer_t* rtka_rl_create_buffer(uint32_t capacity, uint32_t observation_size);
+rtka_replay_buffer_t* rtka_rl_create_prioritized_buffer(uint32_t capacity, uint32_t observation_size,
+                                                        rtka_confidence_t alpha);
+void rtka_rl_free_buffer(rtka_replay_buffer_t* buffer);
+
+/* Copies both observations (observation_size elements, either layout);
+ * the caller keeps the tensors */
+RTKA_NODISCARD rtka_error_t rtka_rl_store_experience(rtka_replay_buffer_t* buffer,
+                                                     const rtka_tensor_t* state,
+                                                     rtka_value_t action,
+                                                     rtka_confidence_t reward,
+                                                     const rtka_tensor_t* next_state,
+                                                     bool done);
+RTKA_NODISCARD rtka_error_t rtka_rl_store_states(rtka_replay_buffer_t* buffer,
+                                                 const rtka_state_t* state,
+                                                 rtka_value_t action,
+                                                 rtka_confidence_t reward,
+                                                 const rtka_state_t* next_state,
+                                                 bool done);
+
+rtka_replay_batch_t* rtka_rl_create_batch(uint32_t batch_size, uint32_t observation_size);
+void rtka_rl_free_batch(rtka_replay_batch_t* batch);
+
+/* batch->batch_size transitions into batch, with replacement. Prioritized
+ * buffers draw one from each of batch_size equal slices of the total
+ * priority and weight it by (size x P(i))^-beta. */
+RTKA_NODISCARD rtka_error_t rtka_rl_sample_batch(rtka_replay_buffer_t* buffer,
+                                                 rtka_replay_batch_t* batch,
+                                                 rtka_confidence_t beta);
+
+/* New priorities |td_error| + a small epsilon for sampled rows */
+void rtka_rl_update_priorities(rtka_replay_buffer_t* buffer,
+                               const uint32_t* indices,
+                               const rtka_confidence_t* td_errors,
+                               uint32_t count);
 
 /* Advantage computation */
 rtka_confidence_t* rtka_rl_compute_advantages(rtka_confidence_t* rewards,
@@ -12,6 +12,16 @@
  * Bit-based constraint propagation inspired by 729-state Sudoku
  * 
  * CHANGELOG:
+ * v1.3.0 - The 54 sticker colors are the state, one byte each in a 64-byte
+ *   vector. A quarter turn is a table permutation of that vector: move_perm
+ *   below is generated from the cubie model, and the kernel is picked from
+ *   CPUID (8 vpshufb on AVX2, 16 pshufb on SSSE3, scalar otherwise). The 324
+ *   bits are expanded from the colors, and propagation only runs while some
+ *   state is still UNKNOWN. Cubies are derived from the colors on demand.
+ * v1.2.0 - The cube is tracked as cubies and the sticker bits derived from
+ *   them on every turn; the old sticker permutation tables did not form a
+ *   cube group (R and L did not commute). rtka_rubik_324_solve_ida runs the
+ *   pattern-database IDA* of rtka_rubik_ida on the cubies.
  * v1.1.0 - 2025-09-28
  *   - Completed all move permutations (U, D, F, B, L, R)
  *   - Fixed character encoding issues
@@ -21,10 +31,18 @@
  */
 
 #include "rtka_rubik_324.h"
+#include "rtka_random.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RUBIK_324_X86 1
+#include <immintrin.h>
+#endif
 
 /* ============================================================================
  * 324-STATE BIT REPRESENTATION
@@ -80,8 +98,41 @@ static const uint8_t corner_triplets[8][3] = {
     {53, 42, 17}  /* DOWN-BACK-LEFT */
 };
 
+/* Sticker vector: color of sticker 0..53, bytes 54..63 padding */
+#define RUBIK_VECTOR_BYTES 64
+
+/* Quarter turn of each face: new[i] = old[move_perm[move][i]]. Generated from
+ * rtka_rubik_cubie_move; padding bytes map to themselves. */
+static const uint8_t move_perm[MOVE_324_COUNT][RUBIK_VECTOR_BYTES] = {
+    { 6,  3,  0,  7,  4,  1,  8,  5,  2, 18, 19, 20, 12, 13, 14, 15,
+     16, 17, 27, 28, 29, 21, 22, 23, 24, 25, 26, 36, 37, 38, 30, 31,
+     32, 33, 34, 35,  9, 10, 11, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+     48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63},
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 42,
+     43, 44, 18, 19, 20, 21, 22, 23, 15, 16, 17, 27, 28, 29, 30, 31,
+     32, 24, 25, 26, 36, 37, 38, 39, 40, 41, 33, 34, 35, 51, 48, 45,
+     52, 49, 46, 53, 50, 47, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63},
+    { 0,  1,  2,  3,  4,  5, 17, 14, 11,  9, 10, 45, 12, 13, 46, 15,
+     16, 47, 24, 21, 18, 25, 22, 19, 26, 23, 20,  6, 28, 29,  7, 31,
+     32,  8, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 30, 27,
+     48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63},
+    {29, 32, 35,  3,  4,  5,  6,  7,  8,  2, 10, 11,  1, 13, 14,  0,
+     16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 53, 30, 31,
+     52, 33, 34, 51, 42, 39, 36, 43, 40, 37, 44, 41, 38, 45, 46, 47,
+     48, 49, 50,  9, 12, 15, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63},
+    {44,  1,  2, 41,  4,  5, 38,  7,  8, 15, 12,  9, 16, 13, 10, 17,
+     14, 11,  0, 19, 20,  3, 22, 23,  6, 25, 26, 27, 28, 29, 30, 31,
+     32, 33, 34, 35, 36, 37, 51, 39, 40, 48, 42, 43, 45, 18, 46, 47,
+     21, 49, 50, 24, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63},
+    { 0,  1, 20,  3,  4, 23,  6,  7, 26,  9, 10, 11, 12, 13, 14, 15,
+     16, 17, 18, 19, 47, 21, 22, 50, 24, 25, 53, 33, 30, 27, 34, 31,
+     28, 35, 32, 29,  8, 37, 38,  5, 40, 41,  2, 43, 44, 45, 46, 42,
+     48, 49, 39, 51, 52, 36, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63}
+};
+
 /* 324-State Rubik's Cube */
 struct rubik_324_state {
+    uint8_t colors[RUBIK_VECTOR_BYTES] RTKA_ALIGNED(16);   /* Authoritative; the bits are derived */
     rubik_bitset_t true_states;     /* Sticker-color pairs that ARE here */
     rubik_bitset_t false_states;    /* Sticker-color pairs that CANNOT be here */
     rubik_bitset_t unknown_states;  /* Sticker-color pairs that MIGHT be here */
@@ -116,31 +167,154 @@ static uint32_t count_bits(const rubik_bitset_t bits) {
     return count;
 }
 
+/* ============================================================================
+ * MOVE KERNELS
+ * A 64-byte sticker permutation. pshufb only indexes within 16 bytes, so
+ * each destination chunk ORs one shuffle per source chunk, with the bytes
+ * that come from elsewhere masked to 0x80 (zero).
+ * ============================================================================ */
+
+typedef void (*rubik_permute_fn)(uint8_t* RTKA_RESTRICT colors, uint32_t move);
+
+typedef struct {
+    rtka_simd_level_t level;
+    rubik_permute_fn permute;
+} rubik_324_kernel_t;
+
+static void permute_scalar(uint8_t* RTKA_RESTRICT colors, uint32_t move) {
+    uint8_t old[RUBIK_VECTOR_BYTES];
+    memcpy(old, colors, sizeof(old));
+    for (uint32_t i = 0; i < 54; i++) colors[i] = old[move_perm[move][i]];
+}
+
+static const rubik_324_kernel_t kernel_scalar = {RTKA_SIMD_SCALAR, permute_scalar};
+
+#ifdef RUBIK_324_X86
+
+/* shuffle_mask[move][k][i]: low nibble of move_perm[move][i] when that byte
+ * comes from source chunk k, else 0x80 */
+static uint8_t shuffle_mask[MOVE_324_COUNT][4][RUBIK_VECTOR_BYTES] RTKA_ALIGNED(32);
+static pthread_once_t shuffle_once = PTHREAD_ONCE_INIT;
+
+static void init_shuffle_mask(void) {
+    for (uint32_t m = 0; m < MOVE_324_COUNT; m++) {
+        for (uint32_t k = 0; k < 4; k++) {
+            for (uint32_t i = 0; i < RUBIK_VECTOR_BYTES; i++) {
+                uint8_t src = move_perm[m][i];
+                shuffle_mask[m][k][i] = src / 16U == k ? (uint8_t)(src % 16U) : 0x80U;
+            }
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+static void permute_ssse3(uint8_t* RTKA_RESTRICT colors, uint32_t move) {
+    __m128i src[4], dst[4];
+    for (uint32_t k = 0; k < 4; k++) src[k] = _mm_loadu_si128((const __m128i*)(const void*)(colors + 16U * k));
+    for (uint32_t d = 0; d < 4; d++) {
+        dst[d] = _mm_setzero_si128();
+        for (uint32_t k = 0; k < 4; k++) {
+            __m128i mask = _mm_load_si128((const __m128i*)(const void*)(shuffle_mask[move][k] + 16U * d));
+            dst[d] = _mm_or_si128(dst[d], _mm_shuffle_epi8(src[k], mask));
+        }
+    }
+    for (uint32_t d = 0; d < 4; d++) _mm_storeu_si128((__m128i*)(void*)(colors + 16U * d), dst[d]);
+}
+
+/* Each source chunk broadcast to both lanes, so one vpshufb serves 32
+ * destination bytes */
+__attribute__((target("avx2")))
+static void permute_avx2(uint8_t* RTKA_RESTRICT colors, uint32_t move) {
+    __m256i src[4], dst[2];
+    for (uint32_t k = 0; k < 4; k++) {
+        src[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(const void*)(colors + 16U * k)));
+    }
+    for (uint32_t d = 0; d < 2; d++) {
+        dst[d] = _mm256_setzero_si256();
+        for (uint32_t k = 0; k < 4; k++) {
+            __m256i mask = _mm256_load_si256((const __m256i*)(const void*)(shuffle_mask[move][k] + 32U * d));
+            dst[d] = _mm256_or_si256(dst[d], _mm256_shuffle_epi8(src[k], mask));
+        }
+    }
+    for (uint32_t d = 0; d < 2; d++) _mm256_storeu_si256((__m256i*)(void*)(colors + 32U * d), dst[d]);
+}
+
+static const rubik_324_kernel_t kernel_ssse3 = {RTKA_SIMD_SSE41, permute_ssse3};
+static const rubik_324_kernel_t kernel_avx2 = {RTKA_SIMD_AVX2, permute_avx2};
+
+#endif /* RUBIK_324_X86 */
+
+static _Atomic(const rubik_324_kernel_t*) g_rubik_324_kernel = NULL;
+
+static const rubik_324_kernel_t* kernel_for_level(rtka_simd_level_t level) {
+    switch (level) {
+        case RTKA_SIMD_SCALAR:
+            return &kernel_scalar;
+#ifdef RUBIK_324_X86
+        case RTKA_SIMD_SSE41:
+            if (!__builtin_cpu_supports("ssse3")) return NULL;
+            pthread_once(&shuffle_once, init_shuffle_mask);
+            return &kernel_ssse3;
+        case RTKA_SIMD_AVX2:
+            if (!__builtin_cpu_supports("avx2")) return NULL;
+            pthread_once(&shuffle_once, init_shuffle_mask);
+            return &kernel_avx2;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static const rubik_324_kernel_t* select_kernel(void) {
+#ifdef RUBIK_324_X86
+    __builtin_cpu_init();
+#endif
+    const rubik_324_kernel_t* k = kernel_for_level(RTKA_SIMD_AVX2);
+    if (!k) k = kernel_for_level(RTKA_SIMD_SSE41);
+    return k ? k : &kernel_scalar;
+}
+
+static RTKA_INLINE const rubik_324_kernel_t* rubik_kernel(void) {
+    const rubik_324_kernel_t* k = atomic_load_explicit(&g_rubik_324_kernel, memory_order_relaxed);
+    if (RTKA_UNLIKELY(!k)) {
+        k = select_kernel();
+        atomic_store_explicit(&g_rubik_324_kernel, k, memory_order_relaxed);
+    }
+    return k;
+}
+
+rtka_simd_level_t rtka_rubik_324_kernel(void) {
+    return rubik_kernel()->level;
+}
+
+bool rtka_rubik_324_set_kernel(rtka_simd_level_t level) {
+    const rubik_324_kernel_t* k = kernel_for_level(level);
+    if (!k) return false;
+    atomic_store_explicit(&g_rubik_324_kernel, k, memory_order_relaxed);
+    return true;
+}
+
+/* TRUE for each sticker's color, FALSE for the other five, nothing UNKNOWN */
+static void expand_bits(rubik_324_state_t* cube) {
+    memset(cube->true_states, 0, sizeof(rubik_bitset_t));
+    memset(cube->unknown_states, 0, sizeof(rubik_bitset_t));
+    for (uint8_t sticker = 0; sticker < 54; sticker++) {
+        set_bit(cube->true_states, state_index(sticker, cube->colors[sticker]));
+    }
+    for (int i = 0; i < RUBIK_BIT_WORDS - 1; i++) cube->false_states[i] = ~cube->true_states[i];
+    cube->false_states[RUBIK_BIT_WORDS - 1] = ~cube->true_states[RUBIK_BIT_WORDS - 1] & 0xFU;  /* Bits 320..323 */
+}
+
 /* Create solved cube */
 rubik_324_state_t* rtka_rubik_324_create_solved(void) {
     rubik_324_state_t* cube = calloc(1, sizeof(rubik_324_state_t));
+    if (!cube) return NULL;
     
-    /* Set TRUE states for solved configuration */
-    for (int face = 0; face < 6; face++) {
-        uint8_t color = face;  /* Face index = color in solved state */
-        for (int i = 0; i < 9; i++) {
-            uint8_t sticker = face_offset[face] + i;
-            uint16_t idx = state_index(sticker, color);
-            set_bit(cube->true_states, idx);
-        }
-    }
-    
-    /* Set FALSE states for impossible positions */
-    for (int sticker = 0; sticker < 54; sticker++) {
-        uint8_t face = sticker / 9;
-        uint8_t correct_color = face;
-        for (uint8_t color = 0; color < 6; color++) {
-            if (color != correct_color) {
-                uint16_t idx = state_index(sticker, color);
-                set_bit(cube->false_states, idx);
-            }
-        }
+    /* Face index = color in solved state; padding bytes hold their index */
+    for (uint8_t i = 0; i < RUBIK_VECTOR_BYTES; i++) {
+        cube->colors[i] = i < 54 ? i / 9 : i;
     }
+    expand_bits(cube);
     
     cube->confidence = 1.0f;
     return cube;
@@ -264,268 +438,21 @@ static void propagate_constraints(rubik_324_state_t* cube) {
     } while (changed);
 }
 
-/* Apply rotation as bit permutation */
+/* Quarter turn as one sticker permutation, reflected into the 324 bits */
 void rtka_rubik_324_rotate(rubik_324_state_t* cube, rubik_324_move_t move) {
-    rubik_bitset_t new_true = {0};
-    rubik_bitset_t new_false = {0};
-    rubik_bitset_t new_unknown = {0};
-    
-    /* Copy unchanged stickers first */
-    memcpy(new_true, cube->true_states, sizeof(rubik_bitset_t));
-    memcpy(new_false, cube->false_states, sizeof(rubik_bitset_t));
-    memcpy(new_unknown, cube->unknown_states, sizeof(rubik_bitset_t));
-    
-    /* Define rotation permutations for each move */
-    /* Format: from_sticker, to_sticker pairs */
-    
-    if (move == MOVE_324_U) {
-        /* UP face clockwise rotation */
-        static const uint8_t perm_U[] = {
-            /* Face rotation (UP face indices 0-8) */
-            0,2, 1,5, 2,8, 3,1, 4,4, 5,7, 6,0, 7,3, 8,6,
-            /* Edge cycle: Front->Left->Back->Right->Front */
-            18,9, 19,10, 20,11,  /* Front top to Left top */
-            9,36, 10,37, 11,38,  /* Left top to Back top */
-            36,27, 37,28, 38,29, /* Back top to Right top */
-            27,18, 28,19, 29,20  /* Right top to Front top */
-        };
-        
-        /* Clear affected positions */
-        for (int i = 0; i < sizeof(perm_U)/sizeof(perm_U[0]); i += 2) {
-            uint8_t from = perm_U[i];
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t idx = state_index(from, color);
-                clear_bit(new_true, idx);
-                clear_bit(new_false, idx);
-                clear_bit(new_unknown, idx);
-            }
-        }
-        
-        /* Apply permutation */
-        for (int i = 0; i < sizeof(perm_U)/sizeof(perm_U[0]); i += 2) {
-            uint8_t from = perm_U[i];
-            uint8_t to = perm_U[i + 1];
-            
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t from_idx = state_index(from, color);
-                uint16_t to_idx = state_index(to, color);
-                
-                if (test_bit(cube->true_states, from_idx))
-                    set_bit(new_true, to_idx);
-                if (test_bit(cube->false_states, from_idx))
-                    set_bit(new_false, to_idx);
-                if (test_bit(cube->unknown_states, from_idx))
-                    set_bit(new_unknown, to_idx);
-            }
-        }
-    }
-    else if (move == MOVE_324_R) {
-        /* RIGHT face clockwise rotation */
-        static const uint8_t perm_R[] = {
-            /* Face rotation (RIGHT face indices 27-35) */
-            27,29, 28,32, 29,35, 30,28, 31,31, 32,34, 33,27, 34,30, 35,33,
-            /* Edge cycle: Front->Up->Back->Down->Front */
-            20,2, 23,5, 26,8,    /* Front right to Up right */
-            2,38, 5,41, 8,44,    /* Up right to Back left */
-            38,47, 41,50, 44,53, /* Back left to Down right */
-            47,20, 50,23, 53,26  /* Down right to Front right */
-        };
-        
-        /* Clear and apply similar to U move */
-        for (int i = 0; i < sizeof(perm_R)/sizeof(perm_R[0]); i += 2) {
-            uint8_t from = perm_R[i];
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t idx = state_index(from, color);
-                clear_bit(new_true, idx);
-                clear_bit(new_false, idx);
-                clear_bit(new_unknown, idx);
-            }
-        }
-        
-        for (int i = 0; i < sizeof(perm_R)/sizeof(perm_R[0]); i += 2) {
-            uint8_t from = perm_R[i];
-            uint8_t to = perm_R[i + 1];
-            
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t from_idx = state_index(from, color);
-                uint16_t to_idx = state_index(to, color);
-                
-                if (test_bit(cube->true_states, from_idx))
-                    set_bit(new_true, to_idx);
-                if (test_bit(cube->false_states, from_idx))
-                    set_bit(new_false, to_idx);
-                if (test_bit(cube->unknown_states, from_idx))
-                    set_bit(new_unknown, to_idx);
-            }
-        }
-    }
-    else if (move == MOVE_324_F) {
-        /* FRONT face clockwise rotation */
-        static const uint8_t perm_F[] = {
-            /* Face rotation (FRONT face indices 18-26) */
-            18,20, 19,23, 20,26, 21,19, 22,22, 23,25, 24,18, 25,21, 26,24,
-            /* Edge cycle: Up->Right->Down->Left->Up */
-            6,27, 7,30, 8,33,    /* Up bottom to Right left */
-            27,47, 30,46, 33,45, /* Right left to Down top */
-            47,17, 46,14, 45,11, /* Down top to Left right */
-            17,6, 14,7, 11,8     /* Left right to Up bottom */
-        };
-        
-        for (int i = 0; i < sizeof(perm_F)/sizeof(perm_F[0]); i += 2) {
-            uint8_t from = perm_F[i];
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t idx = state_index(from, color);
-                clear_bit(new_true, idx);
-                clear_bit(new_false, idx);
-                clear_bit(new_unknown, idx);
-            }
-        }
-        
-        for (int i = 0; i < sizeof(perm_F)/sizeof(perm_F[0]); i += 2) {
-            uint8_t from = perm_F[i];
-            uint8_t to = perm_F[i + 1];
-            
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t from_idx = state_index(from, color);
-                uint16_t to_idx = state_index(to, color);
-                
-                if (test_bit(cube->true_states, from_idx))
-                    set_bit(new_true, to_idx);
-                if (test_bit(cube->false_states, from_idx))
-                    set_bit(new_false, to_idx);
-                if (test_bit(cube->unknown_states, from_idx))
-                    set_bit(new_unknown, to_idx);
-            }
-        }
-    }
-    else if (move == MOVE_324_B) {
-        /* BACK face clockwise rotation */
-        static const uint8_t perm_B[] = {
-            /* Face rotation (BACK face indices 36-44) */
-            36,38, 37,41, 38,44, 39,37, 40,40, 41,43, 42,36, 43,39, 44,42,
-            /* Edge cycle: Up->Left->Down->Right->Up */
-            0,29, 1,32, 2,35,    /* Up top to Right right */
-            29,53, 32,52, 35,51, /* Right right to Down bottom */
-            53,9, 52,12, 51,15,  /* Down bottom to Left left */
-            9,0, 12,1, 15,2      /* Left left to Up top */
-        };
-        
-        for (int i = 0; i < sizeof(perm_B)/sizeof(perm_B[0]); i += 2) {
-            uint8_t from = perm_B[i];
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t idx = state_index(from, color);
-                clear_bit(new_true, idx);
-                clear_bit(new_false, idx);
-                clear_bit(new_unknown, idx);
-            }
-        }
-        
-        for (int i = 0; i < sizeof(perm_B)/sizeof(perm_B[0]); i += 2) {
-            uint8_t from = perm_B[i];
-            uint8_t to = perm_B[i + 1];
-            
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t from_idx = state_index(from, color);
-                uint16_t to_idx = state_index(to, color);
-                
-                if (test_bit(cube->true_states, from_idx))
-                    set_bit(new_true, to_idx);
-                if (test_bit(cube->false_states, from_idx))
-                    set_bit(new_false, to_idx);
-                if (test_bit(cube->unknown_states, from_idx))
-                    set_bit(new_unknown, to_idx);
-            }
-        }
-    }
-    else if (move == MOVE_324_L) {
-        /* LEFT face clockwise rotation */
-        static const uint8_t perm_L[] = {
-            /* Face rotation (LEFT face indices 9-17) */
-            9,11, 10,14, 11,17, 12,10, 13,13, 14,16, 15,9, 16,12, 17,15,
-            /* Edge cycle: Front->Down->Back->Up->Front */
-            18,45, 21,48, 24,51, /* Front left to Down left */
-            45,44, 48,41, 51,38, /* Down left to Back right */
-            44,6, 41,3, 38,0,    /* Back right to Up left */
-            6,18, 3,21, 0,24     /* Up left to Front left */
-        };
-        
-        for (int i = 0; i < sizeof(perm_L)/sizeof(perm_L[0]); i += 2) {
-            uint8_t from = perm_L[i];
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t idx = state_index(from, color);
-                clear_bit(new_true, idx);
-                clear_bit(new_false, idx);
-                clear_bit(new_unknown, idx);
-            }
-        }
-        
-        for (int i = 0; i < sizeof(perm_L)/sizeof(perm_L[0]); i += 2) {
-            uint8_t from = perm_L[i];
-            uint8_t to = perm_L[i + 1];
-            
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t from_idx = state_index(from, color);
-                uint16_t to_idx = state_index(to, color);
-                
-                if (test_bit(cube->true_states, from_idx))
-                    set_bit(new_true, to_idx);
-                if (test_bit(cube->false_states, from_idx))
-                    set_bit(new_false, to_idx);
-                if (test_bit(cube->unknown_states, from_idx))
-                    set_bit(new_unknown, to_idx);
-            }
-        }
-    }
-    else if (move == MOVE_324_D) {
-        /* DOWN face clockwise rotation */
-        static const uint8_t perm_D[] = {
-            /* Face rotation (DOWN face indices 45-53) */
-            45,47, 46,50, 47,53, 48,46, 49,49, 50,52, 51,45, 52,48, 53,51,
-            /* Edge cycle: Front->Right->Back->Left->Front */
-            24,33, 25,34, 26,35, /* Front bottom to Right bottom */
-            33,42, 34,43, 35,44, /* Right bottom to Back bottom */
-            42,15, 43,16, 44,17, /* Back bottom to Left bottom */
-            15,24, 16,25, 17,26  /* Left bottom to Front bottom */
-        };
-        
-        for (int i = 0; i < sizeof(perm_D)/sizeof(perm_D[0]); i += 2) {
-            uint8_t from = perm_D[i];
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t idx = state_index(from, color);
-                clear_bit(new_true, idx);
-                clear_bit(new_false, idx);
-                clear_bit(new_unknown, idx);
-            }
-        }
-        
-        for (int i = 0; i < sizeof(perm_D)/sizeof(perm_D[0]); i += 2) {
-            uint8_t from = perm_D[i];
-            uint8_t to = perm_D[i + 1];
-            
-            for (uint8_t color = 0; color < 6; color++) {
-                uint16_t from_idx = state_index(from, color);
-                uint16_t to_idx = state_index(to, color);
-                
-                if (test_bit(cube->true_states, from_idx))
-                    set_bit(new_true, to_idx);
-                if (test_bit(cube->false_states, from_idx))
-                    set_bit(new_false, to_idx);
-                if (test_bit(cube->unknown_states, from_idx))
-                    set_bit(new_unknown, to_idx);
-            }
-        }
-    }
-    
-    /* Update cube state */
-    memcpy(cube->true_states, new_true, sizeof(rubik_bitset_t));
-    memcpy(cube->false_states, new_false, sizeof(rubik_bitset_t));
-    memcpy(cube->unknown_states, new_unknown, sizeof(rubik_bitset_t));
-    
+    rubik_kernel()->permute(cube->colors, (uint32_t)move);
+    expand_bits(cube);
+
     cube->moves++;
     cube->confidence *= 0.95f;  /* Decay confidence with moves */
     
-    /* Propagate constraints after move */
-    propagate_constraints(cube);
+    /* Propagate constraints after move; a fully known cube has nothing to
+     * deduce, which still counts as one pass */
+    if (count_bits(cube->unknown_states) != 0) {
+        propagate_constraints(cube);
+    } else {
+        cube->rtka_transitions++;
+    }
 }
 
 /* Check if solved using ternary logic */
@@ -628,6 +555,31 @@ bool rtka_rubik_324_solve(rubik_324_state_t* cube, uint32_t max_depth) {
     return false;
 }
 
+bool rtka_rubik_324_solve_ida(rubik_324_state_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                              bool optimal, rubik_solution_t* solution) {
+    if (!cube || !solution) return false;
+    rubik_cubie_t cubies;
+    if (!rtka_rubik_324_cubies(cube, &cubies)) return false;
+    bool found = optimal ? rtka_rubik_ida_solve_optimal(&cubies, pdb, max_length, solution)
+                         : rtka_rubik_ida_solve(&cubies, pdb, max_length, solution);
+    if (!found) return false;
+
+    /* Play it back as quarter turns so the 324 view and counters follow */
+    for (uint32_t i = 0; i < solution->length; i++) {
+        rubik_324_move_t face = (rubik_324_move_t)(solution->moves[i] / 3U);
+        for (uint32_t q = 0; q <= solution->moves[i] % 3U; q++) rtka_rubik_324_rotate(cube, face);
+    }
+    return rtka_rubik_324_is_solved(cube);
+}
+
+bool rtka_rubik_324_cubies(const rubik_324_state_t* cube, rubik_cubie_t* cubies) {
+    return rtka_rubik_cubie_from_stickers(cubies, cube->colors);
+}
+
+const uint8_t* rtka_rubik_324_colors(const rubik_324_state_t* cube) {
+    return cube->colors;
+}
+
 /* Get transition count */
 uint32_t rtka_rubik_324_get_transitions(const rubik_324_state_t* cube) {
     return cube->rtka_transitions;
@@ -646,7 +598,7 @@ void rtka_rubik_324_free(rubik_324_state_t* cube) {
 /* Scramble cube */
 void rtka_rubik_324_scramble(rubik_324_state_t* cube, uint32_t moves) {
     for (uint32_t i = 0; i < moves; i++) {
-        rubik_324_move_t move = rand() % MOVE_324_COUNT;
+        rubik_324_move_t move = (rubik_324_move_t)rtka_random_range(rtka_random_thread(), 0, MOVE_324_COUNT - 1);
         rtka_rubik_324_rotate(cube, move);
     }
 }
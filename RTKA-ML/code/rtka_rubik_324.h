@@ -9,6 +9,10 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA 324-State Rubik's Cube - Bit-based constraint solver
+ *
+ * CHANGELOG:
+ * v1.3.0 - Table-driven SIMD rotate; kernel query / override, color view
+ * v1.2.0 - Cubie-backed state and rtka_rubik_324_solve_ida
  */
 
 #ifndef RTKA_RUBIK_324_H
@@ -16,6 +20,8 @@
 
 #include "rtka_u_core.h"
 #include "rtka_types.h"
+#include "rtka_rubik_ida.h"
+#include "rtka_vector.h"
 #include <stdbool.h>
 
 /* Forward declaration */
@@ -36,11 +42,26 @@ typedef enum {
 rubik_324_state_t* rtka_rubik_324_create_solved(void);
 void rtka_rubik_324_free(rubik_324_state_t* cube);
 
-/* Operations */
+/* Operations. A rotate is one 64-byte shuffle of the sticker colors. */
 void rtka_rubik_324_rotate(rubik_324_state_t* cube, rubik_324_move_t move);
 bool rtka_rubik_324_is_solved(const rubik_324_state_t* cube);
 rtka_confidence_t rtka_rubik_324_heuristic(const rubik_324_state_t* cube);
+/* Depth-limited search over the 324 bits, guided by the heuristic above */
 bool rtka_rubik_324_solve(rubik_324_state_t* cube, uint32_t max_depth);
+/* Pattern-database IDA* on the cube's cubies (two-phase, or shortest with
+ * optimal); the solution is played on cube, true once it is solved */
+bool rtka_rubik_324_solve_ida(rubik_324_state_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                              bool optimal, rubik_solution_t* solution);
+/* Cubies read back from the stickers; false if they are not a real cube */
+bool rtka_rubik_324_cubies(const rubik_324_state_t* cube, rubik_cubie_t* cubies);
+/* Color of stickers 0..53 (face U L F R B D, 9 each) */
+const uint8_t* rtka_rubik_324_colors(const rubik_324_state_t* cube);
+
+/* Move kernel: AVX2, SSSE3 (reported as RTKA_SIMD_SSE41) or scalar, chosen
+ * from CPUID on first use. set_kernel forces one (benchmarks, testing) and
+ * returns false if the CPU lacks it. */
+rtka_simd_level_t rtka_rubik_324_kernel(void);
+bool rtka_rubik_324_set_kernel(rtka_simd_level_t level);
 
 /* Analysis */
 void rtka_rubik_324_print_analysis(const rubik_324_state_t* cube);
@@ -0,0 +1,952 @@
+/**
+ * File: rtka_rubik_ida.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Rubik's Cube IDA* Implementation
+ */
+
+#define _GNU_SOURCE
+#include "rtka_rubik_ida.h"
+#include "rtka_trace.h"
+#include "rtka_perf.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * CUBIE MOVES
+ * Corner / edge positions follow the usual URF.. / UR.. order. A move is
+ * stored as the cube it produces from solved: cp[i] is the corner that ends
+ * up at position i, co[i] the twist it picks up on the way.
+ * ============================================================================ */
+
+enum { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+enum { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+static const rubik_cubie_t face_turn[6] = {
+    /* U */ {{UBR, URF, UFL, ULB, DFR, DLF, DBL, DRB}, {0, 0, 0, 0, 0, 0, 0, 0},
+             {UB, UR, UF, UL, DR, DF, DL, DB, FR, FL, BL, BR}, {0}},
+    /* D */ {{URF, UFL, ULB, UBR, DLF, DBL, DRB, DFR}, {0, 0, 0, 0, 0, 0, 0, 0},
+             {UR, UF, UL, UB, DF, DL, DB, DR, FR, FL, BL, BR}, {0}},
+    /* F */ {{UFL, DLF, ULB, UBR, URF, DFR, DBL, DRB}, {1, 2, 0, 0, 2, 1, 0, 0},
+             {UR, FL, UL, UB, DR, FR, DL, DB, UF, DF, BL, BR}, {0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0}},
+    /* B */ {{URF, UFL, UBR, DRB, DFR, DLF, ULB, DBL}, {0, 0, 1, 2, 0, 0, 2, 1},
+             {UR, UF, UL, BR, DR, DF, DL, BL, FR, FL, UB, DB}, {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1}},
+    /* L */ {{URF, ULB, DBL, UBR, DFR, UFL, DLF, DRB}, {0, 1, 2, 0, 0, 2, 1, 0},
+             {UR, UF, BL, UB, DR, DF, FL, DB, FR, UL, DL, BR}, {0}},
+    /* R */ {{DFR, UFL, ULB, URF, DRB, DLF, DBL, UBR}, {2, 0, 0, 1, 1, 0, 0, 2},
+             {FR, UF, UL, UB, BR, DF, DL, DB, DR, FL, BL, UR}, {0}}
+};
+
+/* Sticker of each corner / edge position in the 324-state layout (U L F R
+ * B D, 9 per face), U or D sticker first, then clockwise */
+static const uint8_t corner_sticker[8][3] = {
+    {8, 27, 20}, {6, 18, 11}, {0, 9, 38}, {2, 36, 29},
+    {47, 26, 33}, {45, 17, 24}, {51, 44, 15}, {53, 35, 42}
+};
+static const uint8_t edge_sticker[12][2] = {
+    {5, 28}, {7, 19}, {3, 10}, {1, 37}, {50, 34}, {46, 25},
+    {48, 16}, {52, 43}, {23, 30}, {21, 14}, {41, 12}, {39, 32}
+};
+
+static const char* const move_names[RUBIK_IDA_MOVES] = {
+    "U", "U2", "U'", "D", "D2", "D'", "F", "F2", "F'",
+    "B", "B2", "B'", "L", "L2", "L'", "R", "R2", "R'"
+};
+
+/* Phase 2 keeps the slice edges in the slice: quarter turns of U and D,
+ * half turns of the rest */
+static const uint8_t phase2_moves[10] = {0, 1, 2, 3, 4, 5, 7, 10, 13, 16};
+#define PHASE2_MOVE_COUNT 10U
+
+static void cubie_multiply(rubik_cubie_t* a, const rubik_cubie_t* b) {
+    rubik_cubie_t r;
+    for (uint32_t i = 0; i < 8; i++) {
+        r.cp[i] = a->cp[b->cp[i]];
+        r.co[i] = (uint8_t)((a->co[b->cp[i]] + b->co[i]) % 3U);
+    }
+    for (uint32_t i = 0; i < 12; i++) {
+        r.ep[i] = a->ep[b->ep[i]];
+        r.eo[i] = (uint8_t)(a->eo[b->ep[i]] ^ b->eo[i]);
+    }
+    *a = r;
+}
+
+void rtka_rubik_cubie_solved(rubik_cubie_t* cube) {
+    for (uint8_t i = 0; i < 8; i++) {
+        cube->cp[i] = i;
+        cube->co[i] = 0;
+    }
+    for (uint8_t i = 0; i < 12; i++) {
+        cube->ep[i] = i;
+        cube->eo[i] = 0;
+    }
+}
+
+void rtka_rubik_cubie_move(rubik_cubie_t* cube, uint32_t move) {
+    const rubik_cubie_t* turn = &face_turn[move / 3U];
+    for (uint32_t q = 0; q <= move % 3U; q++) cubie_multiply(cube, turn);
+}
+
+void rtka_rubik_cubie_apply(rubik_cubie_t* cube, const uint8_t* moves, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) rtka_rubik_cubie_move(cube, moves[i]);
+}
+
+bool rtka_rubik_cubie_is_solved(const rubik_cubie_t* cube) {
+    for (uint8_t i = 0; i < 8; i++) {
+        if (cube->cp[i] != i || cube->co[i]) return false;
+    }
+    for (uint8_t i = 0; i < 12; i++) {
+        if (cube->ep[i] != i || cube->eo[i]) return false;
+    }
+    return true;
+}
+
+static uint32_t permutation_parity(const uint8_t* p, uint32_t n) {
+    uint32_t parity = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = i + 1U; j < n; j++) parity ^= p[i] > p[j];
+    }
+    return parity;
+}
+
+bool rtka_rubik_cubie_is_valid(const rubik_cubie_t* cube) {
+    uint32_t seen_c = 0, seen_e = 0, twist = 0, flip = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+        if (cube->cp[i] >= 8 || cube->co[i] >= 3) return false;
+        seen_c |= 1U << cube->cp[i];
+        twist += cube->co[i];
+    }
+    for (uint32_t i = 0; i < 12; i++) {
+        if (cube->ep[i] >= 12 || cube->eo[i] >= 2) return false;
+        seen_e |= 1U << cube->ep[i];
+        flip += cube->eo[i];
+    }
+    return seen_c == 0xFFU && seen_e == 0xFFFU && twist % 3U == 0 && flip % 2U == 0 &&
+           permutation_parity(cube->cp, 8) == permutation_parity(cube->ep, 12);
+}
+
+void rtka_rubik_cubie_stickers(const rubik_cubie_t* cube, uint8_t colors[54]) {
+    for (uint32_t s = 0; s < 54; s++) colors[s] = (uint8_t)(s / 9U);
+    for (uint32_t i = 0; i < 8; i++) {
+        for (uint32_t n = 0; n < 3; n++) {
+            colors[corner_sticker[i][(n + cube->co[i]) % 3U]] = (uint8_t)(corner_sticker[cube->cp[i]][n] / 9U);
+        }
+    }
+    for (uint32_t i = 0; i < 12; i++) {
+        for (uint32_t n = 0; n < 2; n++) {
+            colors[edge_sticker[i][(n + cube->eo[i]) % 2U]] = (uint8_t)(edge_sticker[cube->ep[i]][n] / 9U);
+        }
+    }
+}
+
+/* Inverse of the above: each corner is named by its colors read from the
+ * U/D sticker on, each edge by its two colors; false unless a real cube */
+bool rtka_rubik_cubie_from_stickers(rubik_cubie_t* cube, const uint8_t colors[54]) {
+    for (uint32_t i = 0; i < 8; i++) {
+        uint32_t twist = 0;
+        while (twist < 3U && colors[corner_sticker[i][twist]] % 5U != 0) twist++;  /* U = 0, D = 5 */
+        if (twist == 3U) return false;
+        cube->cp[i] = 8;
+        for (uint8_t j = 0; j < 8; j++) {
+            uint32_t n = 0;
+            while (n < 3U && colors[corner_sticker[i][(n + twist) % 3U]] == corner_sticker[j][n] / 9U) n++;
+            if (n == 3U) cube->cp[i] = j;
+        }
+        cube->co[i] = (uint8_t)twist;
+    }
+    for (uint32_t i = 0; i < 12; i++) {
+        cube->ep[i] = 12;
+        cube->eo[i] = 0;
+        for (uint8_t j = 0; j < 12; j++) {
+            for (uint8_t flip = 0; flip < 2; flip++) {
+                if (colors[edge_sticker[i][flip]] == edge_sticker[j][0] / 9U &&
+                    colors[edge_sticker[i][1U - flip]] == edge_sticker[j][1] / 9U) {
+                    cube->ep[i] = j;
+                    cube->eo[i] = flip;
+                }
+            }
+        }
+    }
+    return rtka_rubik_cubie_is_valid(cube);
+}
+
+const char* rtka_rubik_move_name(uint32_t move) {
+    return move < RUBIK_IDA_MOVES ? move_names[move] : "?";
+}
+
+/* ============================================================================
+ * COORDINATES
+ * ============================================================================ */
+
+#define N_TWIST        2187U        /* 3^7 */
+#define N_FLIP         2048U        /* 2^11 */
+#define N_SLICE        495U         /* C(12, 4) positions of the slice edges */
+#define N_PERM8        40320U       /* 8! */
+#define N_PERM4        24U
+#define N_CORNERS      (N_PERM8 * N_TWIST)
+
+static uint32_t perm_rank(const uint8_t* p, uint32_t n) {
+    uint32_t rank = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t smaller = 0;
+        for (uint32_t j = i + 1U; j < n; j++) smaller += p[j] < p[i];
+        rank = rank * (n - i) + smaller;
+    }
+    return rank;
+}
+
+static void perm_unrank(uint32_t rank, uint8_t* p, uint32_t n) {
+    uint8_t digit[12];
+    for (uint32_t i = n; i > 0; i--) {
+        digit[i - 1U] = (uint8_t)(rank % (n - i + 1U));
+        rank /= n - i + 1U;
+    }
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t k = digit[i];
+        for (uint32_t v = 0; v < n; v++) {
+            if (used & (1U << v)) continue;
+            if (k-- == 0) {
+                p[i] = (uint8_t)v;
+                used |= 1U << v;
+                break;
+            }
+        }
+    }
+}
+
+/* Slice coordinate: rank of the 12-bit mask of positions holding FR..BR */
+static uint16_t slice_index[4096];
+static uint16_t slice_mask[N_SLICE];
+static uint16_t slice_solved;
+static pthread_once_t slice_once = PTHREAD_ONCE_INIT;
+
+static uint32_t get_twist(const rubik_cubie_t* c) {
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < 7; i++) t = t * 3U + c->co[i];
+    return t;
+}
+
+static void set_twist(rubik_cubie_t* c, uint32_t t) {
+    uint32_t sum = 0;
+    for (uint32_t i = 7; i > 0; i--) {
+        c->co[i - 1U] = (uint8_t)(t % 3U);
+        sum += c->co[i - 1U];
+        t /= 3U;
+    }
+    c->co[7] = (uint8_t)((3U - sum % 3U) % 3U);
+}
+
+static uint32_t get_flip(const rubik_cubie_t* c) {
+    uint32_t f = 0;
+    for (uint32_t i = 0; i < 11; i++) f = f * 2U + c->eo[i];
+    return f;
+}
+
+static void set_flip(rubik_cubie_t* c, uint32_t f) {
+    uint32_t sum = 0;
+    for (uint32_t i = 11; i > 0; i--) {
+        c->eo[i - 1U] = (uint8_t)(f & 1U);
+        sum += f & 1U;
+        f >>= 1;
+    }
+    c->eo[11] = (uint8_t)(sum & 1U);
+}
+
+static uint32_t get_slice(const rubik_cubie_t* c) {
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < 12; i++) mask |= (uint32_t)(c->ep[i] >= FR) << i;
+    return slice_index[mask];
+}
+
+static void set_slice(rubik_cubie_t* c, uint32_t s) {
+    uint32_t mask = slice_mask[s];
+    uint8_t slice_edge = FR, other = UR;
+    for (uint32_t i = 0; i < 12; i++) c->ep[i] = (mask >> i) & 1U ? slice_edge++ : other++;
+}
+
+static uint32_t get_slice_perm(const rubik_cubie_t* c) {
+    uint8_t p[4];
+    for (uint32_t i = 0; i < 4; i++) p[i] = (uint8_t)(c->ep[FR + i] - FR);
+    return perm_rank(p, 4);
+}
+
+/* ============================================================================
+ * DATABASES
+ * ============================================================================ */
+
+#define PDB_MAGIC      "RTKAPDB"
+#define PDB_VERSION    1U
+#define PDB_TABLES     5U
+#define PDB_UNSEEN     0xFFU
+
+enum { T_TWIST_SLICE, T_FLIP_SLICE, T_CORNER_SLICEPERM, T_EDGE_SLICEPERM, T_CORNERS };
+
+static const uint64_t table_bytes[PDB_TABLES] = {
+    (uint64_t)N_TWIST * N_SLICE, (uint64_t)N_FLIP * N_SLICE,
+    (uint64_t)N_PERM8 * N_PERM4, (uint64_t)N_PERM8 * N_PERM4, ((uint64_t)N_CORNERS + 1U) / 2U
+};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t bytes[PDB_TABLES];
+    uint8_t reserved[8];
+} pdb_header_t;                     /* 64 bytes, tables follow back to back */
+
+struct rubik_pdb {
+    uint32_t flags;
+    const uint8_t* table[PDB_TABLES];
+
+    /* Move tables, rebuilt on load */
+    uint16_t (*twist_move)[RUBIK_IDA_MOVES];
+    uint16_t (*flip_move)[RUBIK_IDA_MOVES];
+    uint16_t (*slice_move)[RUBIK_IDA_MOVES];
+    uint16_t (*corner_move)[RUBIK_IDA_MOVES];
+    uint16_t (*edge8_move)[PHASE2_MOVE_COUNT];
+    uint8_t (*slice_perm_move)[PHASE2_MOVE_COUNT];
+
+    uint8_t* owned;                 /* Generated tables, or NULL */
+    void* map;                      /* Loaded file, or NULL */
+    size_t map_length;
+};
+
+static void init_slice_index(void) {
+    uint32_t n = 0;
+    for (uint32_t mask = 0; mask < 4096U; mask++) {
+        if (__builtin_popcount(mask) != 4) continue;
+        slice_index[mask] = (uint16_t)n;
+        slice_mask[n++] = (uint16_t)mask;
+    }
+    slice_solved = slice_index[0xF00U];
+}
+
+static rtka_error_t build_move_tables(rubik_pdb_t* pdb) {
+    pthread_once(&slice_once, init_slice_index);
+    pdb->twist_move = malloc(sizeof(*pdb->twist_move) * N_TWIST);
+    pdb->flip_move = malloc(sizeof(*pdb->flip_move) * N_FLIP);
+    pdb->slice_move = malloc(sizeof(*pdb->slice_move) * N_SLICE);
+    pdb->corner_move = malloc(sizeof(*pdb->corner_move) * N_PERM8);
+    pdb->edge8_move = malloc(sizeof(*pdb->edge8_move) * N_PERM8);
+    pdb->slice_perm_move = malloc(sizeof(*pdb->slice_perm_move) * N_PERM4);
+    if (!pdb->twist_move || !pdb->flip_move || !pdb->slice_move || !pdb->corner_move ||
+        !pdb->edge8_move || !pdb->slice_perm_move) {
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+
+    rubik_cubie_t c;
+    for (uint32_t move = 0; move < RUBIK_IDA_MOVES; move++) {
+        for (uint32_t t = 0; t < N_TWIST; t++) {
+            rtka_rubik_cubie_solved(&c);
+            set_twist(&c, t);
+            rtka_rubik_cubie_move(&c, move);
+            pdb->twist_move[t][move] = (uint16_t)get_twist(&c);
+        }
+        for (uint32_t f = 0; f < N_FLIP; f++) {
+            rtka_rubik_cubie_solved(&c);
+            set_flip(&c, f);
+            rtka_rubik_cubie_move(&c, move);
+            pdb->flip_move[f][move] = (uint16_t)get_flip(&c);
+        }
+        for (uint32_t s = 0; s < N_SLICE; s++) {
+            rtka_rubik_cubie_solved(&c);
+            set_slice(&c, s);
+            rtka_rubik_cubie_move(&c, move);
+            pdb->slice_move[s][move] = (uint16_t)get_slice(&c);
+        }
+    }
+    for (uint32_t p = 0; p < N_PERM8; p++) {
+        for (uint32_t move = 0; move < RUBIK_IDA_MOVES; move++) {
+            rtka_rubik_cubie_solved(&c);
+            perm_unrank(p, c.cp, 8);
+            rtka_rubik_cubie_move(&c, move);
+            pdb->corner_move[p][move] = (uint16_t)perm_rank(c.cp, 8);
+        }
+        for (uint32_t k = 0; k < PHASE2_MOVE_COUNT; k++) {
+            rtka_rubik_cubie_solved(&c);
+            perm_unrank(p, c.ep, 8);
+            rtka_rubik_cubie_move(&c, phase2_moves[k]);
+            pdb->edge8_move[p][k] = (uint16_t)perm_rank(c.ep, 8);
+        }
+    }
+    for (uint32_t p = 0; p < N_PERM4; p++) {
+        for (uint32_t k = 0; k < PHASE2_MOVE_COUNT; k++) {
+            rtka_rubik_cubie_solved(&c);
+            uint8_t perm[4] = {0};
+            perm_unrank(p, perm, 4);
+            for (uint32_t i = 0; i < 4; i++) c.ep[FR + i] = (uint8_t)(FR + perm[i]);
+            rtka_rubik_cubie_move(&c, phase2_moves[k]);
+            pdb->slice_perm_move[p][k] = (uint8_t)get_slice_perm(&c);
+        }
+    }
+    return RTKA_SUCCESS;
+}
+
+/* Byte-per-entry BFS over a pair of coordinates (a * nb + b); phase 2
+ * tables expand only phase-2 moves */
+static void bfs_pair(const rubik_pdb_t* pdb, uint32_t id, uint8_t* dist) {
+    uint32_t na, nb, moves;
+    switch (id) {
+        case T_TWIST_SLICE: na = N_TWIST; nb = N_SLICE; moves = RUBIK_IDA_MOVES; break;
+        case T_FLIP_SLICE:  na = N_FLIP;  nb = N_SLICE; moves = RUBIK_IDA_MOVES; break;
+        default:            na = N_PERM8; nb = N_PERM4; moves = PHASE2_MOVE_COUNT; break;
+    }
+    uint32_t size = na * nb;
+    memset(dist, PDB_UNSEEN, size);
+    dist[id <= T_FLIP_SLICE ? slice_solved : 0U] = 0;
+
+    uint32_t filled = 1;
+    for (uint8_t depth = 0; filled < size; depth++) {
+        for (uint32_t i = 0; i < size; i++) {
+            if (dist[i] != depth) continue;
+            uint32_t a = i / nb, b = i % nb;
+            for (uint32_t m = 0; m < moves; m++) {
+                uint32_t na2, nb2;
+                switch (id) {
+                    case T_TWIST_SLICE: na2 = pdb->twist_move[a][m]; nb2 = pdb->slice_move[b][m]; break;
+                    case T_FLIP_SLICE:  na2 = pdb->flip_move[a][m];  nb2 = pdb->slice_move[b][m]; break;
+                    case T_CORNER_SLICEPERM:
+                        na2 = pdb->corner_move[a][phase2_moves[m]];
+                        nb2 = pdb->slice_perm_move[b][m];
+                        break;
+                    default:
+                        na2 = pdb->edge8_move[a][m];
+                        nb2 = pdb->slice_perm_move[b][m];
+                        break;
+                }
+                uint32_t j = na2 * nb + nb2;
+                if (dist[j] == PDB_UNSEEN) {
+                    dist[j] = (uint8_t)(depth + 1U);
+                    filled++;
+                }
+            }
+        }
+    }
+}
+
+static inline uint32_t nibble_get(const uint8_t* t, uint32_t i) {
+    return (t[i >> 1] >> ((i & 1U) << 2)) & 0xFU;
+}
+
+static inline void nibble_set(uint8_t* t, uint32_t i, uint32_t v) {
+    uint32_t shift = (i & 1U) << 2;
+    t[i >> 1] = (uint8_t)((t[i >> 1] & ~(0xFU << shift)) | (v << shift));
+}
+
+/* 4-bit BFS over (corner permutation, twist). Once over half the states are
+ * reached, open states look for a neighbour at the current depth instead
+ * of the frontier expanding outward. */
+static void bfs_corners(const rubik_pdb_t* pdb, uint8_t* dist) {
+    memset(dist, 0xFF, table_bytes[T_CORNERS]);
+    nibble_set(dist, 0, 0);
+    uint32_t filled = 1;
+    for (uint32_t depth = 0; filled < N_CORNERS; depth++) {
+        bool backward = filled > N_CORNERS / 2U;
+        for (uint32_t i = 0; i < N_CORNERS; i++) {
+            uint32_t d = nibble_get(dist, i);
+            if (backward ? d != 0xFU : d != depth) continue;
+            uint32_t p = i / N_TWIST, t = i % N_TWIST;
+            for (uint32_t m = 0; m < RUBIK_IDA_MOVES; m++) {
+                uint32_t j = pdb->corner_move[p][m] * N_TWIST + pdb->twist_move[t][m];
+                if (backward) {
+                    if (nibble_get(dist, j) == depth) {
+                        nibble_set(dist, i, depth + 1U);
+                        filled++;
+                        break;
+                    }
+                } else if (nibble_get(dist, j) == 0xFU) {
+                    nibble_set(dist, j, depth + 1U);
+                    filled++;
+                }
+            }
+        }
+    }
+}
+
+static void set_table_pointers(rubik_pdb_t* pdb, const uint8_t* base) {
+    for (uint32_t t = 0; t < PDB_TABLES; t++) {
+        bool present = t != T_CORNERS || (pdb->flags & RUBIK_PDB_CORNERS);
+        pdb->table[t] = present ? base : NULL;
+        if (present) base += table_bytes[t];
+    }
+}
+
+static size_t tables_size(uint32_t flags) {
+    size_t total = 0;
+    for (uint32_t t = 0; t < PDB_TABLES; t++) {
+        if (t != T_CORNERS || (flags & RUBIK_PDB_CORNERS)) total += (size_t)table_bytes[t];
+    }
+    return total;
+}
+
+void rtka_rubik_pdb_free(rubik_pdb_t* pdb) {
+    if (!pdb) return;
+    free(pdb->twist_move);
+    free(pdb->flip_move);
+    free(pdb->slice_move);
+    free(pdb->corner_move);
+    free(pdb->edge8_move);
+    free(pdb->slice_perm_move);
+    free(pdb->owned);
+    if (pdb->map) munmap(pdb->map, pdb->map_length);
+    free(pdb);
+}
+
+uint32_t rtka_rubik_pdb_flags(const rubik_pdb_t* pdb) {
+    return pdb ? pdb->flags : 0U;
+}
+
+rtka_error_t rtka_rubik_pdb_generate(rubik_pdb_t** out, uint32_t flags) {
+    if (!out) return RTKA_ERROR_NULL_POINTER;
+    *out = NULL;
+    rubik_pdb_t* pdb = calloc(1, sizeof(rubik_pdb_t));
+    if (!pdb) return RTKA_ERROR_OUT_OF_MEMORY;
+    pdb->flags = flags & RUBIK_PDB_CORNERS;
+
+    rtka_error_t err = build_move_tables(pdb);
+    if (err == RTKA_SUCCESS) {
+        pdb->owned = malloc(tables_size(pdb->flags));
+        if (!pdb->owned) err = RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    if (err != RTKA_SUCCESS) {
+        rtka_rubik_pdb_free(pdb);
+        return err;
+    }
+    set_table_pointers(pdb, pdb->owned);
+    for (uint32_t t = 0; t < T_CORNERS; t++) bfs_pair(pdb, t, (uint8_t*)pdb->table[t]);
+    if (pdb->table[T_CORNERS]) bfs_corners(pdb, (uint8_t*)pdb->table[T_CORNERS]);
+    *out = pdb;
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_rubik_pdb_save(const rubik_pdb_t* pdb, const char* path) {
+    if (!pdb || !path) return RTKA_ERROR_NULL_POINTER;
+    pdb_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PDB_MAGIC, sizeof(PDB_MAGIC));
+    header.version = PDB_VERSION;
+    header.flags = pdb->flags;
+    for (uint32_t t = 0; t < PDB_TABLES; t++) header.bytes[t] = pdb->table[t] ? table_bytes[t] : 0U;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return RTKA_ERROR_INVALID_VALUE;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (uint32_t t = 0; ok && t < PDB_TABLES; t++) {
+        if (pdb->table[t]) ok = fwrite(pdb->table[t], 1, table_bytes[t], f) == table_bytes[t];
+    }
+    ok &= fclose(f) == 0;
+    if (!ok) remove(path);
+    return ok ? RTKA_SUCCESS : RTKA_ERROR_INVALID_VALUE;
+}
+
+rtka_error_t rtka_rubik_pdb_load(rubik_pdb_t** out, const char* path) {
+    if (!out || !path) return RTKA_ERROR_NULL_POINTER;
+    *out = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return RTKA_ERROR_INVALID_VALUE;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(pdb_header_t)) {
+        close(fd);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    size_t length = (size_t)st.st_size;
+    void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    pdb_header_t header;
+    memcpy(&header, map, sizeof(header));
+    uint32_t flags = header.flags & RUBIK_PDB_CORNERS;
+    bool ok = memcmp(header.magic, PDB_MAGIC, sizeof(PDB_MAGIC)) == 0 && header.version == PDB_VERSION &&
+              length == sizeof(header) + tables_size(flags);
+    for (uint32_t t = 0; ok && t < PDB_TABLES; t++) {
+        bool present = t != T_CORNERS || flags;
+        ok = header.bytes[t] == (present ? table_bytes[t] : 0U);
+    }
+    rubik_pdb_t* pdb = ok ? calloc(1, sizeof(rubik_pdb_t)) : NULL;
+    if (!pdb) {
+        munmap(map, length);
+        return ok ? RTKA_ERROR_OUT_OF_MEMORY : RTKA_ERROR_INVALID_VALUE;
+    }
+    pdb->flags = flags;
+    pdb->map = map;
+    pdb->map_length = length;
+    set_table_pointers(pdb, (const uint8_t*)map + sizeof(header));
+
+    rtka_error_t err = build_move_tables(pdb);
+    if (err != RTKA_SUCCESS) {
+        rtka_rubik_pdb_free(pdb);
+        return err;
+    }
+    *out = pdb;
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_rubik_pdb_open(rubik_pdb_t** out, const char* path, uint32_t flags) {
+    if (!out) return RTKA_ERROR_NULL_POINTER;
+    flags &= RUBIK_PDB_CORNERS;
+    if (path && rtka_rubik_pdb_load(out, path) == RTKA_SUCCESS) {
+        if (((*out)->flags & flags) == flags) return RTKA_SUCCESS;
+        rtka_rubik_pdb_free(*out);
+    }
+    rtka_error_t err = rtka_rubik_pdb_generate(out, flags);
+    if (err == RTKA_SUCCESS && path) {
+        rtka_error_t saved = rtka_rubik_pdb_save(*out, path);  /* Cache is best effort */
+        (void)saved;
+    }
+    return err;
+}
+
+/* ============================================================================
+ * SEARCH
+ * Successive turns of one face are merged, and of two opposite faces (which
+ * commute) only one order is searched.
+ * ============================================================================ */
+
+static inline bool move_allowed(uint32_t face, uint32_t last_face) {
+    return face != last_face && !(face == (last_face ^ 1U) && face < last_face);
+}
+
+static inline uint32_t max_u32(uint32_t a, uint32_t b) { return a > b ? a : b; }
+
+typedef struct {
+    const rubik_pdb_t* pdb;
+    const rubik_cubie_t* start;
+    uint8_t moves[RUBIK_IDA_MAX_LENGTH];
+    uint32_t max_length;
+    uint32_t phase1_length;
+    uint64_t nodes;
+} ida_search_t;
+
+static inline uint32_t phase1_h(const rubik_pdb_t* pdb, uint32_t twist, uint32_t flip, uint32_t slice) {
+    return max_u32(pdb->table[T_TWIST_SLICE][twist * N_SLICE + slice],
+                   pdb->table[T_FLIP_SLICE][flip * N_SLICE + slice]);
+}
+
+static bool phase2(ida_search_t* s, uint32_t corner, uint32_t edge8, uint32_t sp, uint32_t depth,
+                   uint32_t togo, uint32_t last_face) {
+    s->nodes++;
+    if (togo == 0) return corner == 0 && edge8 == 0 && sp == 0;
+    for (uint32_t k = 0; k < PHASE2_MOVE_COUNT; k++) {
+        uint32_t m = phase2_moves[k];
+        if (!move_allowed(m / 3U, last_face)) continue;
+        uint32_t c2 = s->pdb->corner_move[corner][m];
+        uint32_t e2 = s->pdb->edge8_move[edge8][k];
+        uint32_t sp2 = s->pdb->slice_perm_move[sp][k];
+        uint32_t h = max_u32(s->pdb->table[T_CORNER_SLICEPERM][c2 * N_PERM4 + sp2],
+                             s->pdb->table[T_EDGE_SLICEPERM][e2 * N_PERM4 + sp2]);
+        if (h >= togo) continue;
+        s->moves[depth] = (uint8_t)m;
+        if (phase2(s, c2, e2, sp2, depth + 1U, togo - 1U, m / 3U)) return true;
+    }
+    return false;
+}
+
+/* A phase-1 path reached the group: play it on the cube and look for a
+ * phase-2 finish within the remaining budget */
+static bool phase1_leaf(ida_search_t* s, uint32_t depth) {
+    rubik_cubie_t c = *s->start;
+    rtka_rubik_cubie_apply(&c, s->moves, depth);
+    uint32_t corner = perm_rank(c.cp, 8), edge8 = perm_rank(c.ep, 8), sp = get_slice_perm(&c);
+    uint32_t last_face = depth ? s->moves[depth - 1U] / 3U : 6U;
+    uint32_t h = max_u32(s->pdb->table[T_CORNER_SLICEPERM][corner * N_PERM4 + sp],
+                         s->pdb->table[T_EDGE_SLICEPERM][edge8 * N_PERM4 + sp]);
+    for (uint32_t togo = h; depth + togo <= s->max_length; togo++) {
+        if (phase2(s, corner, edge8, sp, depth, togo, last_face)) {
+            s->phase1_length = depth + togo;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool phase1(ida_search_t* s, uint32_t twist, uint32_t flip, uint32_t slice, uint32_t depth,
+                   uint32_t togo, uint32_t last_face) {
+    s->nodes++;
+    if (togo == 0) {
+        /* Ending on a phase-2 move only repeats a shorter phase-1 path */
+        if (depth > 0) {
+            uint32_t last = s->moves[depth - 1U];
+            if (last / 3U <= 1U || last % 3U == 1U) return false;
+        }
+        return phase1_leaf(s, depth);
+    }
+    for (uint32_t m = 0; m < RUBIK_IDA_MOVES; m++) {
+        if (!move_allowed(m / 3U, last_face)) continue;
+        uint32_t t2 = s->pdb->twist_move[twist][m];
+        uint32_t f2 = s->pdb->flip_move[flip][m];
+        uint32_t s2 = s->pdb->slice_move[slice][m];
+        uint32_t h = phase1_h(s->pdb, t2, f2, s2);
+        if (h > togo - 1U) continue;
+        s->moves[depth] = (uint8_t)m;
+        if (phase1(s, t2, f2, s2, depth + 1U, togo - 1U, m / 3U)) return true;
+    }
+    return false;
+}
+
+bool rtka_rubik_ida_solve(const rubik_cubie_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                          rubik_solution_t* solution) {
+    if (!cube || !pdb || !solution || !rtka_rubik_cubie_is_valid(cube)) return false;
+    if (max_length > RUBIK_IDA_MAX_LENGTH) max_length = RUBIK_IDA_MAX_LENGTH;
+    memset(solution, 0, sizeof(*solution));
+
+    ida_search_t s = {.pdb = pdb, .start = cube, .max_length = max_length};
+    uint32_t twist = get_twist(cube), flip = get_flip(cube), slice = get_slice(cube);
+    bool found = false;
+    for (uint32_t depth = phase1_h(pdb, twist, flip, slice); !found && depth <= max_length; depth++) {
+        uint64_t span = rtka_trace_begin();
+        RTKA_PERF_TIMER_BEGIN(threshold_timer, RTKA_PERF_TIMER_IDA_THRESHOLD);
+        found = phase1(&s, twist, flip, slice, 0, depth, 6U);
+        RTKA_PERF_TIMER_END(threshold_timer);
+        rtka_trace_end(RTKA_TRACE_IDA_THRESHOLD, span, depth);
+        RTKA_PERF_COUNT(RTKA_PERF_IDA_ITERATIONS, 1);
+    }
+    solution->nodes = s.nodes;
+    RTKA_PERF_COUNT(RTKA_PERF_IDA_NODES, s.nodes);
+    if (!found) return false;
+    solution->length = s.phase1_length;
+    memcpy(solution->moves, s.moves, s.phase1_length);
+    return true;
+}
+
+/* Optimal search: coordinates ride along as arguments, the cube itself is
+ * turned and turned back, and only needs checking where the bound is 0 */
+typedef struct {
+    const rubik_pdb_t* pdb;
+    rubik_cubie_t cube;
+    uint8_t moves[RUBIK_IDA_MAX_LENGTH];
+    uint64_t nodes;
+    const _Atomic uint32_t* winner;     /* Parallel: lowest subtree with a solution */
+    uint32_t subtree;
+} optimal_search_t;
+
+static inline uint32_t optimal_h(const rubik_pdb_t* pdb, uint32_t corner, uint32_t twist, uint32_t flip,
+                                 uint32_t slice) {
+    uint32_t h = phase1_h(pdb, twist, flip, slice);
+    if (pdb->table[T_CORNERS]) h = max_u32(h, nibble_get(pdb->table[T_CORNERS], corner * N_TWIST + twist));
+    return h;
+}
+
+static bool optimal_dfs(optimal_search_t* s, uint32_t corner, uint32_t twist, uint32_t flip, uint32_t slice,
+                        uint32_t depth, uint32_t togo, uint32_t last_face) {
+    s->nodes++;
+    if (togo == 0) return rtka_rubik_cubie_is_solved(&s->cube);
+    /* An earlier subtree already holds the answer */
+    if (s->winner && atomic_load_explicit(s->winner, memory_order_relaxed) < s->subtree) return false;
+    for (uint32_t m = 0; m < RUBIK_IDA_MOVES; m++) {
+        if (!move_allowed(m / 3U, last_face)) continue;
+        uint32_t c2 = s->pdb->corner_move[corner][m];
+        uint32_t t2 = s->pdb->twist_move[twist][m];
+        uint32_t f2 = s->pdb->flip_move[flip][m];
+        uint32_t s2 = s->pdb->slice_move[slice][m];
+        if (optimal_h(s->pdb, c2, t2, f2, s2) > togo - 1U) continue;
+        rtka_rubik_cubie_move(&s->cube, m);
+        s->moves[depth] = (uint8_t)m;
+        bool found = optimal_dfs(s, c2, t2, f2, s2, depth + 1U, togo - 1U, m / 3U);
+        rtka_rubik_cubie_move(&s->cube, rtka_rubik_move_inverse(m));
+        if (found) return true;
+    }
+    return false;
+}
+
+bool rtka_rubik_ida_solve_optimal(const rubik_cubie_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                                  rubik_solution_t* solution) {
+    if (!cube || !pdb || !solution || !rtka_rubik_cubie_is_valid(cube)) return false;
+    if (max_length > RUBIK_IDA_MAX_LENGTH) max_length = RUBIK_IDA_MAX_LENGTH;
+    memset(solution, 0, sizeof(*solution));
+
+    optimal_search_t s = {.pdb = pdb, .cube = *cube};
+    uint32_t corner = perm_rank(cube->cp, 8), twist = get_twist(cube);
+    uint32_t flip = get_flip(cube), slice = get_slice(cube);
+    for (uint32_t depth = optimal_h(pdb, corner, twist, flip, slice); depth <= max_length; depth++) {
+        uint64_t span = rtka_trace_begin();
+        RTKA_PERF_TIMER_BEGIN(threshold_timer, RTKA_PERF_TIMER_IDA_THRESHOLD);
+        bool found = optimal_dfs(&s, corner, twist, flip, slice, 0, depth, 6U);
+        RTKA_PERF_TIMER_END(threshold_timer);
+        rtka_trace_end(RTKA_TRACE_IDA_THRESHOLD, span, depth);
+        RTKA_PERF_COUNT(RTKA_PERF_IDA_ITERATIONS, 1);
+        if (found) {
+            solution->length = depth;
+            memcpy(solution->moves, s.moves, depth);
+            solution->nodes = s.nodes;
+            RTKA_PERF_COUNT(RTKA_PERF_IDA_NODES, s.nodes);
+            return true;
+        }
+    }
+    solution->nodes = s.nodes;
+    RTKA_PERF_COUNT(RTKA_PERF_IDA_NODES, s.nodes);
+    return false;
+}
+
+/* ============================================================================
+ * PARALLEL OPTIMAL SEARCH
+ * Each threshold expands the first two plies on the caller (at most 18 x 15
+ * prefixes) and hands the subtrees to the pool as one range task that
+ * splits in halves on the deques: a worker walks its run in serial order
+ * while idle workers steal the largest runs left. A worker
+ * that solves subtree i lowers the winner to i; subtrees above the winner
+ * stop, those below keep going, so the answer is the one the serial search
+ * gives.
+ * ============================================================================ */
+
+#define SPLIT_PLIES     2U
+#define MAX_SUBTREES    (RUBIK_IDA_MOVES * 15U)
+
+typedef struct {
+    uint8_t moves[SPLIT_PLIES];
+    uint32_t corner, twist, flip, slice;
+} ida_subtree_t;
+
+typedef struct {
+    const rubik_pdb_t* pdb;
+    const rubik_cubie_t* start;
+    ida_subtree_t subtrees[MAX_SUBTREES];
+    uint32_t num_subtrees;
+    uint32_t togo;                       /* Moves left below the prefix */
+    _Atomic uint32_t winner;
+    uint8_t solutions[MAX_SUBTREES][RUBIK_IDA_MAX_LENGTH];   /* Per subtree, so finders never share */
+    rubik_ida_worker_stats_t* stats;
+    uint32_t stats_count;
+    _Atomic uint64_t nodes;
+} ida_parallel_t;
+
+static double ida_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void ida_subtree_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    ida_parallel_t* job = (ida_parallel_t*)ctx;
+    for (uint32_t i = begin; i < end; i++) {
+        if (atomic_load_explicit(&job->winner, memory_order_relaxed) < i) return;
+        const ida_subtree_t* t = &job->subtrees[i];
+        optimal_search_t s = {.pdb = job->pdb, .cube = *job->start, .winner = &job->winner, .subtree = i};
+        rtka_rubik_cubie_apply(&s.cube, t->moves, SPLIT_PLIES);
+        memcpy(s.moves, t->moves, SPLIT_PLIES);
+
+        double start = ida_seconds();
+        uint64_t span = rtka_trace_begin();
+        bool found = optimal_dfs(&s, t->corner, t->twist, t->flip, t->slice, SPLIT_PLIES, job->togo,
+                                 t->moves[SPLIT_PLIES - 1U] / 3U);
+        rtka_trace_end(RTKA_TRACE_IDA_SUBTREE, span, i);
+        if (job->stats && worker < job->stats_count) {
+            job->stats[worker].nodes += s.nodes;
+            job->stats[worker].subtrees++;
+            job->stats[worker].seconds += ida_seconds() - start;
+        }
+        atomic_fetch_add_explicit(&job->nodes, s.nodes, memory_order_relaxed);
+        RTKA_PERF_COUNT(RTKA_PERF_IDA_NODES, s.nodes);
+        if (!found) continue;
+
+        memcpy(job->solutions[i], s.moves, SPLIT_PLIES + job->togo);
+        uint32_t cur = atomic_load_explicit(&job->winner, memory_order_relaxed);
+        while (i < cur && !atomic_compare_exchange_weak(&job->winner, &cur, i)) {}
+    }
+}
+
+/* Surviving two-ply prefixes for a threshold, in serial search order */
+static void ida_split(ida_parallel_t* job, uint32_t corner, uint32_t twist, uint32_t flip, uint32_t slice,
+                      uint32_t depth) {
+    const rubik_pdb_t* pdb = job->pdb;
+    job->num_subtrees = 0;
+    for (uint32_t m1 = 0; m1 < RUBIK_IDA_MOVES; m1++) {
+        uint32_t c1 = pdb->corner_move[corner][m1], t1 = pdb->twist_move[twist][m1];
+        uint32_t f1 = pdb->flip_move[flip][m1], s1 = pdb->slice_move[slice][m1];
+        if (optimal_h(pdb, c1, t1, f1, s1) > depth - 1U) continue;
+        for (uint32_t m2 = 0; m2 < RUBIK_IDA_MOVES; m2++) {
+            if (!move_allowed(m2 / 3U, m1 / 3U)) continue;
+            ida_subtree_t* t = &job->subtrees[job->num_subtrees];
+            t->corner = pdb->corner_move[c1][m2];
+            t->twist = pdb->twist_move[t1][m2];
+            t->flip = pdb->flip_move[f1][m2];
+            t->slice = pdb->slice_move[s1][m2];
+            if (optimal_h(pdb, t->corner, t->twist, t->flip, t->slice) > depth - SPLIT_PLIES) continue;
+            t->moves[0] = (uint8_t)m1;
+            t->moves[1] = (uint8_t)m2;
+            job->num_subtrees++;
+        }
+    }
+}
+
+bool rtka_rubik_ida_solve_optimal_parallel(const rubik_cubie_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                                           rtka_thread_pool_t* pool, rubik_solution_t* solution,
+                                           rubik_ida_worker_stats_t* stats, uint32_t stats_count) {
+    if (!cube || !pdb || !solution || !rtka_rubik_cubie_is_valid(cube)) return false;
+    if (max_length > RUBIK_IDA_MAX_LENGTH) max_length = RUBIK_IDA_MAX_LENGTH;
+    if (stats) memset(stats, 0, stats_count * sizeof(*stats));
+    if (!pool) pool = rtka_pool_default();
+
+    uint32_t corner = perm_rank(cube->cp, 8), twist = get_twist(cube);
+    uint32_t flip = get_flip(cube), slice = get_slice(cube);
+    uint32_t depth = optimal_h(pdb, corner, twist, flip, slice);
+
+    if (!pool) return rtka_rubik_ida_solve_optimal(cube, pdb, max_length, solution);
+
+    /* Thresholds too shallow to split run serially; they are instant */
+    if (depth <= SPLIT_PLIES) {
+        bool found = rtka_rubik_ida_solve_optimal(cube, pdb, max_length < SPLIT_PLIES ? max_length : SPLIT_PLIES,
+                                                  solution);
+        if (stats && stats_count) {
+            stats[0].nodes = solution->nodes;
+            stats[0].subtrees = 1;
+        }
+        if (found || max_length <= SPLIT_PLIES) return found;
+        depth = SPLIT_PLIES + 1U;
+    }
+
+    ida_parallel_t* job = (ida_parallel_t*)calloc(1, sizeof(ida_parallel_t));
+    if (!job) return false;
+    job->pdb = pdb;
+    job->start = cube;
+    job->stats = stats;
+    job->stats_count = stats_count;
+    atomic_init(&job->nodes, stats && stats_count ? stats[0].nodes : 0U);
+
+    bool found = false;
+    for (; !found && depth <= max_length; depth++) {
+        ida_split(job, corner, twist, flip, slice, depth);
+        job->togo = depth - SPLIT_PLIES;
+        atomic_store(&job->winner, UINT32_MAX);
+        uint64_t span = rtka_trace_begin();
+        RTKA_PERF_TIMER_BEGIN(threshold_timer, RTKA_PERF_TIMER_IDA_THRESHOLD);
+        rtka_task_group_t group;
+        rtka_task_group_init(&group);
+        if (rtka_pool_spawn_range(pool, &group, 0, job->num_subtrees, 1, ida_subtree_range, job) == RTKA_SUCCESS) {
+            rtka_pool_wait_group(pool, &group);
+        } else {
+            ida_subtree_range(job, 0, job->num_subtrees, rtka_pool_worker_index(pool));
+        }
+        RTKA_PERF_TIMER_END(threshold_timer);
+        rtka_trace_end(RTKA_TRACE_IDA_THRESHOLD, span, depth);
+        RTKA_PERF_COUNT(RTKA_PERF_IDA_ITERATIONS, 1);
+        found = atomic_load(&job->winner) != UINT32_MAX;
+    }
+
+    memset(solution, 0, sizeof(*solution));
+    solution->nodes = atomic_load(&job->nodes);
+    if (found) {
+        solution->length = depth - 1U;
+        memcpy(solution->moves, job->solutions[atomic_load(&job->winner)], solution->length);
+    }
+    for (uint32_t w = 0; stats && w < stats_count; w++) {
+        if (stats[w].seconds > 0.0) stats[w].nodes_per_second = (double)stats[w].nodes / stats[w].seconds;
+    }
+    free(job);
+    return found;
+}
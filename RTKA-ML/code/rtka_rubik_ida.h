@@ -0,0 +1,128 @@
+/**
+ * File: rtka_rubik_ida.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Rubik's Cube IDA* - cubie-level search with pattern databases
+ *
+ * CHANGELOG:
+ * v1.0.0 - Cubie representation (corner / edge permutation and
+ *          orientation, 40 bytes) with 18 face turns; searches apply a move
+ *          and undo it with the inverse move instead of copying the cube.
+ *          Pattern databases are distance tables over coordinates of the
+ *          cube, built by breadth-first search from the solved state,
+ *          written to disk once and mmapped when loaded:
+ *            twist x slice, flip x slice     phase 1 (reach <U, D, R2, L2, F2, B2>)
+ *            corners x slice perm,
+ *            U/D edges x slice perm           phase 2 (solve inside that group)
+ *            corners (8! x 3^7, 4 bits)       optional, for optimal search
+ *          rtka_rubik_ida_solve is two-phase IDA*: 20-move scrambles
+ *          solve in well under a second to ~22 moves. The optimal search
+ *          is plain IDA* on the maximum of the corner and phase-1 tables.
+ * v1.0.1 - rtka_rubik_cubie_from_stickers, the inverse of the sticker view
+ * v1.1.0 - rtka_rubik_ida_solve_optimal_parallel: each threshold splits the
+ *          first two plies into subtrees shared over the thread pool, with
+ *          cancellation once a solution is known and per-worker node rates
+ * v1.1.1 - Thresholds and parallel subtrees are trace spans (rtka_trace.h)
+ * v1.1.2 - Parallel subtrees run on the pool's work-stealing deques
+ * v1.1.3 - Threshold iterations are counted and timed, nodes counted
+ *          (rtka_perf.h, make perf)
+ *
+ *   rubik_pdb_t* pdb;
+ *   if (rtka_rubik_pdb_open(&pdb, "rubik.pdb", 0) == RTKA_SUCCESS) {
+ *       rubik_solution_t s;
+ *       if (rtka_rubik_ida_solve(&cube, pdb, 24, &s)) print s.moves;
+ *       rtka_rubik_pdb_free(pdb);
+ *   }
+ */
+
+#ifndef RTKA_RUBIK_IDA_H
+#define RTKA_RUBIK_IDA_H
+
+#include "rtka_types.h"
+#include "rtka_threadpool.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Moves: face * 3 + (quarter turns - 1), faces in rubik_324_move_t order
+ * U D F B L R, so 0 = U, 1 = U2, 2 = U', 3 = D ... 17 = R' */
+#define RUBIK_IDA_MOVES        18U
+#define RUBIK_IDA_MAX_LENGTH   32U
+
+#define RUBIK_PDB_CORNERS      0x1U     /* Also build the 44 MB corner table */
+
+typedef struct {
+    uint8_t cp[8];      /* Corner at each corner position (URF UFL ULB UBR DFR DLF DBL DRB) */
+    uint8_t co[8];      /* Its twist, 0..2 */
+    uint8_t ep[12];     /* Edge at each edge position (UR UF UL UB DR DF DL DB FR FL BL BR) */
+    uint8_t eo[12];     /* Its flip, 0..1 */
+} rubik_cubie_t;
+
+typedef struct {
+    uint8_t moves[RUBIK_IDA_MAX_LENGTH];
+    uint32_t length;
+    uint64_t nodes;     /* Search nodes expanded */
+} rubik_solution_t;
+
+typedef struct rubik_pdb rubik_pdb_t;
+
+/* One participant of a parallel search (index 0 is the calling thread) */
+typedef struct {
+    uint64_t nodes;
+    uint32_t subtrees;
+    double seconds;             /* Inside subtrees */
+    double nodes_per_second;
+} rubik_ida_worker_stats_t;
+
+/* Cubie level */
+void rtka_rubik_cubie_solved(rubik_cubie_t* cube);
+void rtka_rubik_cubie_move(rubik_cubie_t* cube, uint32_t move);
+void rtka_rubik_cubie_apply(rubik_cubie_t* cube, const uint8_t* moves, uint32_t count);
+bool rtka_rubik_cubie_is_solved(const rubik_cubie_t* cube);
+/* Permutations, orientation sums and permutation parity of a real cube */
+bool rtka_rubik_cubie_is_valid(const rubik_cubie_t* cube);
+/* Color (face index U L F R B D = 0..5 as in the 324-state layout) of the
+ * 54 stickers, 9 per face in that face order */
+void rtka_rubik_cubie_stickers(const rubik_cubie_t* cube, uint8_t colors[54]);
+/* Cubies from the same 54 colors; false when they are not a reachable cube */
+bool rtka_rubik_cubie_from_stickers(rubik_cubie_t* cube, const uint8_t colors[54]);
+
+static inline uint32_t rtka_rubik_move_inverse(uint32_t move) {
+    return move / 3U * 3U + 2U - move % 3U;
+}
+const char* rtka_rubik_move_name(uint32_t move);
+
+/* Pattern databases. open loads path when it holds the requested tables
+ * and otherwise generates them and saves to path (NULL: memory only). */
+RTKA_NODISCARD rtka_error_t rtka_rubik_pdb_generate(rubik_pdb_t** pdb, uint32_t flags);
+RTKA_NODISCARD rtka_error_t rtka_rubik_pdb_save(const rubik_pdb_t* pdb, const char* path);
+RTKA_NODISCARD rtka_error_t rtka_rubik_pdb_load(rubik_pdb_t** pdb, const char* path);
+RTKA_NODISCARD rtka_error_t rtka_rubik_pdb_open(rubik_pdb_t** pdb, const char* path, uint32_t flags);
+void rtka_rubik_pdb_free(rubik_pdb_t* pdb);
+uint32_t rtka_rubik_pdb_flags(const rubik_pdb_t* pdb);
+
+/* Two-phase IDA*: the first solution of at most max_length moves (capped at
+ * RUBIK_IDA_MAX_LENGTH). Lengths from 22 up return quickly; much tighter
+ * bounds approach optimal search cost. false for an invalid cube or no
+ * solution within the bound. */
+bool rtka_rubik_ida_solve(const rubik_cubie_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                          rubik_solution_t* solution);
+
+/* Shortest solution up to max_length by IDA*; uses the corner table when
+ * the databases have it. Cost grows ~13x per move of solution length. */
+bool rtka_rubik_ida_solve_optimal(const rubik_cubie_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                                  rubik_solution_t* solution);
+
+/* The same search on pool (NULL = rtka_pool_default()); returns the
+ * solution the serial search finds. stats, if given, holds stats_count
+ * workers, rtka_pool_size(pool) + 1 for all of them. */
+bool rtka_rubik_ida_solve_optimal_parallel(const rubik_cubie_t* cube, const rubik_pdb_t* pdb, uint32_t max_length,
+                                           rtka_thread_pool_t* pool, rubik_solution_t* solution,
+                                           rubik_ida_worker_stats_t* stats, uint32_t stats_count);
+
+#endif /* RTKA_RUBIK_IDA_H */
@@ -1,7 +1,7 @@
 /**
  * File: rtka_sat.c
  * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
- * 
+ *
  * PROPRIETARY AND CONFIDENTIAL
  * This file is proprietary to H. Overman and may not be reproduced,
  * distributed, or used without explicit written permission.
@@ -13,129 +13,933 @@
 
 #include <stdlib.h>
 #include "rtka_sat.h"
+#include "rtka_sat_dimacs.h"
+#include "rtka_sat_portfolio.h"
+#include "rtka_trace.h"
+#include "rtka_perf.h"
 #include <string.h>
 
-void rtka_sat_init(sat_state_t* state, uint32_t vars) {
-    memset(state, 0, sizeof(sat_state_t));
-    state->num_vars = vars;
-    
-    for (uint32_t v = 1; v <= vars; v++) {
-        state->variables[v].value = RTKA_UNKNOWN;
-        state->variables[v].confidence = 0.5f;
+#define SAT_VAR_DECAY      0.95
+#define SAT_CLAUSE_DECAY   0.999f
+#define SAT_RESTART_BASE   100U     /* Conflicts per Luby unit */
+#define SAT_LEARNTS_MIN    2000U
+#define SAT_HEAP_NONE      UINT32_MAX
+
+static inline uint32_t lit_var(sat_lit_t l) { return l >> 1; }
+static inline sat_lit_t lit_make(int32_t l) {
+    return l > 0 ? (sat_lit_t)l << 1 : ((sat_lit_t)(-l) << 1) | 1U;
+}
+
+static inline uint32_t* clause_at(const sat_state_t* state, sat_cref_t cref) {
+    return state->arena + cref;
+}
+static inline sat_lit_t* clause_lits(uint32_t* c) { return c + SAT_CLAUSE_HEADER; }
+static inline float clause_activity(const uint32_t* c) {
+    float a;
+    memcpy(&a, &c[2], sizeof(a));
+    return a;
+}
+static inline void clause_set_activity(uint32_t* c, float a) { memcpy(&c[2], &a, sizeof(a)); }
+
+static bool grow(void** ptr, uint32_t* capacity, uint64_t need, size_t elem) {
+    if (need <= *capacity) return true;
+    if (need > UINT32_MAX) return false;
+    uint64_t cap = *capacity ? *capacity : 16U;
+    while (cap < need) cap *= 2;
+    if (cap > UINT32_MAX) cap = UINT32_MAX;
+    void* p = realloc(*ptr, (size_t)cap * elem);
+    if (!p) return false;
+    *ptr = p;
+    *capacity = (uint32_t)cap;
+    return true;
+}
+
+static void fail(sat_state_t* state, rtka_error_t error) {
+    if (state->error == RTKA_SUCCESS) state->error = error;
+}
+
+/* xorshift32 over state->rng */
+static uint32_t next_random(sat_state_t* state) {
+    uint32_t x = state->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return state->rng = x;
+}
+
+static float random_unit(sat_state_t* state) {
+    return (float)(next_random(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+/* ---------------------------------------------------------------------
+ * Variable order heap
+ * ------------------------------------------------------------------- */
+
+static void heap_up(sat_state_t* state, uint32_t i) {
+    uint32_t v = state->heap[i];
+    double a = state->activity[v];
+    while (i > 0) {
+        uint32_t parent = (i - 1) >> 1;
+        uint32_t pv = state->heap[parent];
+        if (state->activity[pv] >= a) break;
+        state->heap[i] = pv;
+        state->heap_index[pv] = i;
+        i = parent;
     }
+    state->heap[i] = v;
+    state->heap_index[v] = i;
 }
 
-void rtka_sat_add_clause(sat_state_t* state, int32_t* literals, uint32_t size) {
-    if (state->num_clauses >= SAT_MAX_CLAUSES) return;
-    
-    sat_clause_t* c = &state->clauses[state->num_clauses++];
-    c->size = size;
-    c->satisfied = false;
-    memcpy(c->literals, literals, size * sizeof(int32_t));
-}
-
-static bool unit_propagate(sat_state_t* state) {
-    bool progress = true;
-    
-    while (progress) {
-        progress = false;
-        
-        for (uint32_t c = 0; c < state->num_clauses; c++) {
-            if (state->clauses[c].satisfied) continue;
-            
-            int32_t unit_lit = 0;
-            uint32_t unknowns = 0;
-            
-            for (uint32_t i = 0; i < state->clauses[c].size; i++) {
-                int32_t lit = state->clauses[c].literals[i];
-                uint32_t var = abs(lit);
-                rtka_value_t val = state->variables[var].value;
-                
-                if (val == RTKA_UNKNOWN) {
-                    unit_lit = lit;
-                    unknowns++;
-                } else if ((lit > 0 && val == RTKA_TRUE) || 
-                          (lit < 0 && val == RTKA_FALSE)) {
-                    state->clauses[c].satisfied = true;
+static void heap_down(sat_state_t* state, uint32_t i) {
+    uint32_t v = state->heap[i];
+    double a = state->activity[v];
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= state->heap_size) break;
+        if (child + 1 < state->heap_size &&
+            state->activity[state->heap[child + 1]] > state->activity[state->heap[child]]) {
+            child++;
+        }
+        uint32_t cv = state->heap[child];
+        if (state->activity[cv] <= a) break;
+        state->heap[i] = cv;
+        state->heap_index[cv] = i;
+        i = child;
+    }
+    state->heap[i] = v;
+    state->heap_index[v] = i;
+}
+
+static void heap_insert(sat_state_t* state, uint32_t v) {
+    if (state->heap_index[v] != SAT_HEAP_NONE) return;
+    state->heap[state->heap_size] = v;
+    state->heap_index[v] = state->heap_size++;
+    heap_up(state, state->heap_index[v]);
+}
+
+static uint32_t heap_pop(sat_state_t* state) {
+    uint32_t v = state->heap[0];
+    state->heap_index[v] = SAT_HEAP_NONE;
+    if (--state->heap_size > 0) {
+        state->heap[0] = state->heap[state->heap_size];
+        heap_down(state, 0);
+    }
+    return v;
+}
+
+static void bump_var(sat_state_t* state, uint32_t v) {
+    if ((state->activity[v] += state->var_inc) > 1e100) {
+        for (uint32_t u = 1; u <= state->num_vars; u++) state->activity[u] *= 1e-100;
+        state->var_inc *= 1e-100;
+    }
+    if (state->heap_index[v] != SAT_HEAP_NONE) heap_up(state, state->heap_index[v]);
+}
+
+static void bump_clause(sat_state_t* state, uint32_t* c) {
+    float a = clause_activity(c) + state->clause_inc;
+    clause_set_activity(c, a);
+    if (a > 1e20f) {
+        for (uint32_t i = 0; i < state->num_learnts; i++) {
+            uint32_t* l = clause_at(state, state->learnts[i]);
+            clause_set_activity(l, clause_activity(l) * 1e-20f);
+        }
+        state->clause_inc *= 1e-20f;
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * Trail
+ * ------------------------------------------------------------------- */
+
+static inline int8_t lit_value(const sat_state_t* state, sat_lit_t l) {
+    return state->lit_value[l];
+}
+
+static inline void enqueue(sat_state_t* state, sat_lit_t l, sat_cref_t from) {
+    uint32_t v = lit_var(l);
+    state->lit_value[l] = 1;
+    state->lit_value[l ^ 1U] = -1;
+    state->level[v] = state->decision_level;
+    state->reason[v] = from;
+    state->trail[state->trail_size++] = l;
+    state->rtka_transitions++;
+}
+
+static void cancel_until(sat_state_t* state, uint32_t level) {
+    if (state->decision_level <= level) return;
+    uint32_t bottom = state->trail_lim[level];
+    for (uint32_t i = state->trail_size; i-- > bottom;) {
+        sat_lit_t l = state->trail[i];
+        uint32_t v = lit_var(l);
+        state->phase[v] = (uint8_t)(l & 1U);
+        state->lit_value[l] = 0;
+        state->lit_value[l ^ 1U] = 0;
+        state->reason[v] = SAT_CREF_NONE;
+        heap_insert(state, v);
+    }
+    state->trail_size = bottom;
+    state->qhead = bottom;
+    state->decision_level = level;
+}
+
+/* Unassign everything, level 0 included, so clauses can be added freely */
+static void clear_trail(sat_state_t* state) {
+    cancel_until(state, 0);
+    for (uint32_t i = 0; i < state->trail_size; i++) {
+        sat_lit_t l = state->trail[i];
+        state->lit_value[l] = 0;
+        state->lit_value[l ^ 1U] = 0;
+        state->reason[lit_var(l)] = SAT_CREF_NONE;
+        heap_insert(state, lit_var(l));
+    }
+    state->trail_size = 0;
+    state->qhead = 0;
+}
+
+/* ---------------------------------------------------------------------
+ * Clause arena and watches
+ * ------------------------------------------------------------------- */
+
+static bool watch(sat_state_t* state, sat_lit_t l, sat_cref_t cref, sat_lit_t blocker) {
+    sat_watch_list_t* wl = &state->watches[l];
+    if (!grow((void**)&wl->items, &wl->capacity, (uint64_t)wl->count + 1, sizeof(sat_watch_t))) {
+        return false;
+    }
+    wl->items[wl->count++] = (sat_watch_t){cref, blocker};
+    return true;
+}
+
+static bool attach(sat_state_t* state, sat_cref_t cref) {
+    uint32_t* c = clause_at(state, cref);
+    if (c[0] < 2) return true;
+    sat_lit_t* lits = clause_lits(c);
+    return watch(state, lits[0], cref, lits[1]) && watch(state, lits[1], cref, lits[0]);
+}
+
+static sat_cref_t clause_alloc(sat_state_t* state, const sat_lit_t* lits, uint32_t size,
+                               bool learnt, uint32_t lbd) {
+    uint64_t need = (uint64_t)state->arena_size + SAT_CLAUSE_HEADER + size;
+    if (need >= SAT_CREF_NONE ||
+        !grow((void**)&state->arena, &state->arena_capacity, need, sizeof(uint32_t))) {
+        fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+        return SAT_CREF_NONE;
+    }
+    sat_cref_t cref = state->arena_size;
+    uint32_t* c = state->arena + cref;
+    c[0] = size;
+    c[1] = (learnt ? SAT_CLAUSE_LEARNT : 0U) | (lbd & SAT_CLAUSE_LBD);
+    clause_set_activity(c, 0.0f);
+    memcpy(clause_lits(c), lits, size * sizeof(sat_lit_t));
+    state->arena_size = (uint32_t)need;
+    if (!attach(state, cref)) {
+        fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+        return SAT_CREF_NONE;
+    }
+    return cref;
+}
+
+static bool clause_locked(const sat_state_t* state, sat_cref_t cref) {
+    sat_lit_t first = clause_lits(clause_at(state, cref))[0];
+    return lit_value(state, first) > 0 && state->reason[lit_var(first)] == cref;
+}
+
+/* Copy live clauses into a fresh arena, forward reasons and learnts to the
+ * new offsets, and rebuild every watch list from the two watched literals */
+static void compact(sat_state_t* state) {
+    uint32_t live = 0;
+    for (uint32_t off = 0; off < state->arena_size;) {
+        uint32_t words = SAT_CLAUSE_HEADER + state->arena[off];
+        if (!(state->arena[off + 1] & SAT_CLAUSE_DELETED)) live += words;
+        off += words;
+    }
+    uint32_t* fresh = (uint32_t*)malloc((size_t)(live ? live : 1) * sizeof(uint32_t));
+    if (!fresh) return;     /* Deleted clauses stay marked; retried next reduction */
+
+    uint32_t to = 0;
+    for (uint32_t off = 0; off < state->arena_size;) {
+        uint32_t* c = state->arena + off;
+        uint32_t words = SAT_CLAUSE_HEADER + c[0];
+        if (!(c[1] & SAT_CLAUSE_DELETED)) {
+            memcpy(fresh + to, c, words * sizeof(uint32_t));
+            c[2] = to;      /* Forwarding offset in the old copy */
+            to += words;
+        }
+        off += words;
+    }
+    for (uint32_t i = 0; i < state->trail_size; i++) {
+        uint32_t v = lit_var(state->trail[i]);
+        if (state->reason[v] != SAT_CREF_NONE) state->reason[v] = state->arena[state->reason[v] + 2];
+    }
+    for (uint32_t i = 0; i < state->num_learnts; i++) {
+        state->learnts[i] = state->arena[state->learnts[i] + 2];
+    }
+
+    free(state->arena);
+    state->arena = fresh;
+    state->arena_size = live;
+    state->arena_capacity = live ? live : 1;
+
+    for (uint32_t l = 0; l < 2 * (state->num_vars + 1); l++) state->watches[l].count = 0;
+    for (uint32_t off = 0; off < state->arena_size; off += SAT_CLAUSE_HEADER + state->arena[off]) {
+        if (!attach(state, off)) fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+    }
+}
+
+typedef struct {
+    uint32_t lbd;
+    float activity;
+    sat_cref_t cref;
+} sat_rank_t;
+
+/* Worst first: high LBD, then low activity */
+static int rank_compare(const void* a, const void* b) {
+    const sat_rank_t* x = (const sat_rank_t*)a;
+    const sat_rank_t* y = (const sat_rank_t*)b;
+    if (x->lbd != y->lbd) return x->lbd > y->lbd ? -1 : 1;
+    if (x->activity != y->activity) return x->activity < y->activity ? -1 : 1;
+    return 0;
+}
+
+/* Drop the worse half of the learned clauses, keeping glue clauses
+ * (LBD <= 2) and any clause that is currently a reason */
+static void reduce_learnts(sat_state_t* state) {
+    sat_rank_t* ranks = (sat_rank_t*)malloc(state->num_learnts * sizeof(sat_rank_t));
+    if (!ranks) return;
+    for (uint32_t i = 0; i < state->num_learnts; i++) {
+        uint32_t* c = clause_at(state, state->learnts[i]);
+        ranks[i] = (sat_rank_t){c[1] & SAT_CLAUSE_LBD, clause_activity(c), state->learnts[i]};
+    }
+    qsort(ranks, state->num_learnts, sizeof(sat_rank_t), rank_compare);
+
+    uint32_t target = state->num_learnts / 2, kept = 0;
+    for (uint32_t i = 0; i < state->num_learnts; i++) {
+        uint32_t* c = clause_at(state, ranks[i].cref);
+        if (i < target && ranks[i].lbd > 2 && !clause_locked(state, ranks[i].cref)) {
+            c[1] |= SAT_CLAUSE_DELETED;
+            state->deleted++;
+            if (state->proof) rtka_sat_proof_clause(state, clause_lits(c), c[0], true);
+        } else {
+            state->learnts[kept++] = ranks[i].cref;
+        }
+    }
+    state->num_learnts = kept;
+    free(ranks);
+    compact(state);
+}
+
+/* ---------------------------------------------------------------------
+ * Search
+ * ------------------------------------------------------------------- */
+
+/* Two-watched-literal unit propagation; returns the conflict clause or
+ * SAT_CREF_NONE */
+static sat_cref_t propagate(sat_state_t* state) {
+    sat_cref_t conflict = SAT_CREF_NONE;
+    while (state->qhead < state->trail_size) {
+        sat_lit_t false_lit = state->trail[state->qhead++] ^ 1U;
+        sat_watch_list_t* wl = &state->watches[false_lit];
+        sat_watch_t* items = wl->items;
+        uint32_t i = 0, j = 0, n = wl->count;
+        state->propagations++;
+
+        while (i < n) {
+            sat_watch_t w = items[i++];
+            if (lit_value(state, w.blocker) > 0) {
+                items[j++] = w;
+                continue;
+            }
+            uint32_t* c = clause_at(state, w.cref);
+            sat_lit_t* lits = clause_lits(c);
+            if (lits[0] == false_lit) {
+                lits[0] = lits[1];
+                lits[1] = false_lit;
+            }
+            sat_lit_t first = lits[0];
+            sat_watch_t keep = {w.cref, first};
+            if (first != w.blocker && lit_value(state, first) > 0) {
+                items[j++] = keep;
+                continue;
+            }
+
+            bool moved = false;
+            for (uint32_t k = 2; k < c[0]; k++) {
+                if (lit_value(state, lits[k]) >= 0) {
+                    lits[1] = lits[k];
+                    lits[k] = false_lit;
+                    if (!watch(state, lits[1], w.cref, first)) {
+                        fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+                        lits[k] = lits[1];
+                        lits[1] = false_lit;
+                        break;
+                    }
+                    moved = true;
                     break;
                 }
             }
-            
-            if (!state->clauses[c].satisfied && unknowns == 1) {
-                uint32_t var = abs(unit_lit);
-                state->variables[var].value = (unit_lit > 0) ? RTKA_TRUE : RTKA_FALSE;
-                state->variables[var].confidence = 1.0f;
-                state->assigned++;
-                state->rtka_transitions++;
-                state->clauses[c].satisfied = true;
-                progress = true;
+            if (moved) continue;
+
+            items[j++] = keep;
+            if (lit_value(state, first) < 0) {
+                conflict = w.cref;
+                state->qhead = state->trail_size;
+                while (i < n) items[j++] = items[i++];
+            } else {
+                enqueue(state, first, w.cref);
             }
-            
-            if (!state->clauses[c].satisfied && unknowns == 0) {
-                return false;
+        }
+        wl->count = j;
+        if (conflict != SAT_CREF_NONE) break;
+    }
+    return conflict;
+}
+
+/* A literal is redundant when every other literal of its reason is
+ * already in the learned clause or fixed at level 0 */
+static bool redundant(const sat_state_t* state, sat_lit_t l) {
+    sat_cref_t r = state->reason[lit_var(l)];
+    if (r == SAT_CREF_NONE) return false;
+    uint32_t* c = clause_at(state, r);
+    sat_lit_t* lits = clause_lits(c);
+    for (uint32_t k = 1; k < c[0]; k++) {
+        uint32_t v = lit_var(lits[k]);
+        if (!state->seen[v] && state->level[v] > 0) return false;
+    }
+    return true;
+}
+
+/* First-UIP analysis into state->learnt; returns the clause size and the
+ * backjump level, with the asserting literal at [0] and the highest
+ * remaining level at [1] */
+static uint32_t analyze(sat_state_t* state, sat_cref_t conflict, uint32_t* backjump, uint32_t* lbd) {
+    sat_lit_t* out = state->learnt;
+    uint32_t size = 1, paths = 0, index = state->trail_size;
+    sat_lit_t p = 0;
+    bool first = true;
+
+    do {
+        uint32_t* c = clause_at(state, conflict);
+        if (c[1] & SAT_CLAUSE_LEARNT) bump_clause(state, c);
+        sat_lit_t* lits = clause_lits(c);
+        for (uint32_t k = first ? 0 : 1; k < c[0]; k++) {
+            uint32_t v = lit_var(lits[k]);
+            if (state->seen[v] || state->level[v] == 0) continue;
+            state->seen[v] = 1;
+            bump_var(state, v);
+            if (state->level[v] >= state->decision_level) {
+                paths++;
+            } else {
+                out[size++] = lits[k];
             }
         }
+        while (!state->seen[lit_var(state->trail[--index])]) {}
+        p = state->trail[index];
+        conflict = state->reason[lit_var(p)];
+        state->seen[lit_var(p)] = 0;
+        paths--;
+        first = false;
+    } while (paths > 0);
+    out[0] = p ^ 1U;
+
+    /* seen[] still marks out[1..]; redundant literals are swapped past the
+     * end so every mark can be cleared afterwards */
+    uint32_t end = size;
+    for (uint32_t i = 1; i < end;) {
+        if (redundant(state, out[i])) {
+            sat_lit_t t = out[i];
+            out[i] = out[--end];
+            out[end] = t;
+        } else {
+            i++;
+        }
+    }
+    for (uint32_t i = 1; i < size; i++) state->seen[lit_var(out[i])] = 0;
+    size = end;
+
+    *backjump = 0;
+    if (size > 1) {
+        uint32_t best = 1;
+        for (uint32_t i = 2; i < size; i++) {
+            if (state->level[lit_var(out[i])] > state->level[lit_var(out[best])]) best = i;
+        }
+        sat_lit_t t = out[1];
+        out[1] = out[best];
+        out[best] = t;
+        *backjump = state->level[lit_var(out[1])];
     }
-    
+
+    state->stamp++;
+    uint32_t distinct = 0;
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t lv = state->level[lit_var(out[i])];
+        if (state->level_stamp[lv] != state->stamp) {
+            state->level_stamp[lv] = state->stamp;
+            distinct++;
+        }
+    }
+    *lbd = distinct;
+    return size;
+}
+
+/* Learned clause into the arena: units as unwatched 1-literal clauses kept
+ * across solves, longer ones watched and listed for reduction */
+static bool store_learnt(sat_state_t* state, const sat_lit_t* lits, uint32_t size, uint32_t lbd,
+                         sat_cref_t* cref) {
+    *cref = clause_alloc(state, lits, size, true, lbd);
+    if (*cref == SAT_CREF_NONE) return false;
+    if (size == 1) return true;
+    if (!grow((void**)&state->learnts, &state->learnts_capacity,
+              (uint64_t)state->num_learnts + 1, sizeof(sat_cref_t))) {
+        fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    state->learnts[state->num_learnts++] = *cref;
     return true;
 }
 
-static uint32_t choose_variable(const sat_state_t* state) {
-    uint32_t best = 0;
-    rtka_confidence_t min_conf = 1.1f;
-    
+/* Peer clauses arrive at level 0 right after a restart: literals fixed
+ * false are dropped, satisfied clauses skipped, units enqueued */
+static void import_shared(sat_state_t* state) {
+    sat_lit_t lits[SAT_SHARE_MAX_LITS];
+    uint32_t size;
+    while (rtka_sat_share_next(state->share, state->share_id, &state->share_cursor, lits, &size)) {
+        uint32_t kept = 0;
+        bool satisfied = false;
+        for (uint32_t k = 0; k < size && !satisfied; k++) {
+            int8_t v = lit_value(state, lits[k]);
+            if (v > 0) satisfied = true;
+            else if (v == 0) lits[kept++] = lits[k];
+        }
+        if (satisfied) continue;
+        if (kept == 0) {
+            state->inconsistent = true;
+            return;
+        }
+        sat_cref_t cref;
+        if (!store_learnt(state, lits, kept, kept, &cref)) return;
+        state->imported++;
+        if (kept == 1) enqueue(state, lits[0], SAT_CREF_NONE);
+    }
+}
+
+/* Initial activities from the confidences and polarities from the preset
+ * values, diversified by seed / polarity mode */
+static void seed_priors(sat_state_t* state) {
+    state->rng = state->seed ? state->seed : 1U;
     for (uint32_t v = 1; v <= state->num_vars; v++) {
-        if (state->variables[v].value == RTKA_UNKNOWN) {
-            rtka_confidence_t uncertainty = 1.0f - state->variables[v].confidence;
-            if (uncertainty < min_conf) {
-                min_conf = uncertainty;
-                best = v;
-            }
+        rtka_state_t hint = state->variables[v];
+        state->activity[v] = hint.confidence;
+        if (state->seed) state->activity[v] += 1e-3 * random_unit(state);
+
+        switch (state->polarity) {
+            case SAT_POLARITY_INVERTED:
+                state->phase[v] = hint.value != RTKA_FALSE;
+                break;
+            case SAT_POLARITY_RANDOM:
+                if (hint.value == RTKA_UNKNOWN) {
+                    state->phase[v] = (uint8_t)(next_random(state) & 1U);
+                } else {
+                    bool keep = random_unit(state) < hint.confidence;
+                    state->phase[v] = keep == (hint.value == RTKA_FALSE);
+                }
+                break;
+            default:
+                state->phase[v] = hint.value == RTKA_FALSE;
+                break;
+        }
+    }
+}
+
+/* Luby sequence 1 1 2 1 1 2 4 ... */
+static uint32_t luby(uint32_t x) {
+    uint32_t size = 1, seq = 0;
+    while (size < x + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    return 1U << seq;
+}
+
+static bool pick_branch(sat_state_t* state, sat_lit_t* out) {
+    while (state->heap_size > 0) {
+        uint32_t v = heap_pop(state);
+        if (state->lit_value[v << 1] == 0) {
+            *out = (v << 1) | state->phase[v];
+            return true;
         }
     }
-    
-    return best;
-}
-
-static bool dpll(sat_state_t* state) {
-    if (!unit_propagate(state)) return false;
-    
-    bool all_sat = true;
-    for (uint32_t c = 0; c < state->num_clauses; c++) {
-        if (!state->clauses[c].satisfied) {
-            all_sat = false;
-            break;
-        }
-    }
-    if (all_sat) return true;
-    
-    uint32_t var = choose_variable(state);
-    if (var == 0) return false;
-    
-    for (int attempt = 0; attempt < 2; attempt++) {
-        sat_state_t backup;
-        memcpy(&backup, state, sizeof(sat_state_t));
-        
-        state->variables[var].value = (attempt == 0) ? RTKA_TRUE : RTKA_FALSE;
-        state->variables[var].confidence = 0.5f;
-        state->assigned++;
-        state->rtka_transitions++;
-        
-        if (dpll(state)) return true;
-        
-        memcpy(state, &backup, sizeof(sat_state_t));
-    }
-    
     return false;
 }
 
+/* Room for `levels` decision levels in trail_lim and level_stamp */
+static bool ensure_levels(sat_state_t* state, uint64_t levels) {
+    if (levels <= state->level_capacity) return true;
+    if (levels > UINT32_MAX) return false;
+    uint32_t* lim = (uint32_t*)realloc(state->trail_lim, (size_t)levels * sizeof(uint32_t));
+    if (!lim) return false;
+    state->trail_lim = lim;
+    uint32_t* stamp = (uint32_t*)realloc(state->level_stamp, (size_t)levels * sizeof(uint32_t));
+    if (!stamp) return false;
+    memset(stamp + state->level_capacity, 0,
+           (size_t)(levels - state->level_capacity) * sizeof(uint32_t));
+    state->level_stamp = stamp;
+    state->level_capacity = (uint32_t)levels;
+    return true;
+}
+
+/* Assumption p is false: collect the assumptions its falsity follows from */
+static void analyze_final(sat_state_t* state, sat_lit_t p) {
+    state->num_failed = 0;
+    int32_t v = (int32_t)lit_var(p);
+    state->failed[state->num_failed++] = (p & 1U) ? -v : v;
+    if (state->decision_level == 0) return;
+
+    state->seen[lit_var(p)] = 1;
+    for (uint32_t i = state->trail_size; i-- > state->trail_lim[0];) {
+        uint32_t x = lit_var(state->trail[i]);
+        if (!state->seen[x]) continue;
+        sat_cref_t r = state->reason[x];
+        if (r == SAT_CREF_NONE) {
+            int32_t a = (int32_t)x;
+            state->failed[state->num_failed++] = (state->trail[i] & 1U) ? -a : a;
+        } else {
+            uint32_t* c = clause_at(state, r);
+            sat_lit_t* lits = clause_lits(c);
+            for (uint32_t k = 1; k < c[0]; k++) {
+                if (state->level[lit_var(lits[k])] > 0) state->seen[lit_var(lits[k])] = 1;
+            }
+        }
+        state->seen[x] = 0;
+    }
+    state->seen[lit_var(p)] = 0;
+}
+
+static void publish(sat_state_t* state) {
+    state->assigned = state->trail_size;
+    for (uint32_t v = 1; v <= state->num_vars; v++) {
+        int8_t val = state->lit_value[v << 1];
+        rtka_state_t* s = &state->variables[v];
+        if (val == 0) {
+            s->value = RTKA_UNKNOWN;
+        } else {
+            s->value = val > 0 ? RTKA_TRUE : RTKA_FALSE;
+            bool decided = state->reason[v] == SAT_CREF_NONE &&
+                           state->level[v] > state->num_assumptions;
+            s->confidence = decided ? 0.5f : 1.0f;
+        }
+    }
+}
+
+void rtka_sat_init(sat_state_t* state, uint32_t vars) {
+    memset(state, 0, sizeof(sat_state_t));
+    state->num_vars = vars;
+    state->var_inc = 1.0;
+    state->clause_inc = 1.0f;
+
+    size_t n = (size_t)vars + 1, lits = 2 * n;
+    state->variables = (rtka_state_t*)calloc(n, sizeof(rtka_state_t));
+    state->watches = (sat_watch_list_t*)calloc(lits, sizeof(sat_watch_list_t));
+    state->lit_value = (int8_t*)calloc(lits, sizeof(int8_t));
+    state->level = (uint32_t*)calloc(n, sizeof(uint32_t));
+    state->reason = (sat_cref_t*)malloc(n * sizeof(sat_cref_t));
+    state->trail = (sat_lit_t*)malloc(n * sizeof(sat_lit_t));
+    state->trail_lim = (uint32_t*)malloc(n * sizeof(uint32_t));
+    state->level_capacity = (uint32_t)n;
+    state->activity = (double*)calloc(n, sizeof(double));
+    state->heap = (uint32_t*)malloc(n * sizeof(uint32_t));
+    state->heap_index = (uint32_t*)malloc(n * sizeof(uint32_t));
+    state->phase = (uint8_t*)calloc(n, sizeof(uint8_t));
+    state->seen = (uint8_t*)calloc(n, sizeof(uint8_t));
+    state->learnt = (sat_lit_t*)malloc(n * sizeof(sat_lit_t));
+    state->level_stamp = (uint32_t*)calloc(n, sizeof(uint32_t));
+    if (!state->variables || !state->watches || !state->lit_value || !state->level ||
+        !state->reason || !state->trail || !state->trail_lim || !state->activity ||
+        !state->heap || !state->heap_index || !state->phase || !state->seen ||
+        !state->learnt || !state->level_stamp) {
+        fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+        return;
+    }
+
+    state->heap_index[0] = SAT_HEAP_NONE;
+    for (uint32_t v = 1; v <= vars; v++) {
+        state->variables[v].value = RTKA_UNKNOWN;
+        state->variables[v].confidence = 0.5f;
+        state->reason[v] = SAT_CREF_NONE;
+        state->heap_index[v] = SAT_HEAP_NONE;
+    }
+}
+
+void rtka_sat_free(sat_state_t* state) {
+    if (state->watches) {
+        for (uint32_t l = 0; l < 2 * (state->num_vars + 1); l++) free(state->watches[l].items);
+    }
+    free(state->variables);
+    free(state->arena);
+    free(state->learnts);
+    free(state->watches);
+    free(state->lit_value);
+    free(state->level);
+    free(state->reason);
+    free(state->trail);
+    free(state->trail_lim);
+    free(state->activity);
+    free(state->heap);
+    free(state->heap_index);
+    free(state->phase);
+    free(state->seen);
+    free(state->learnt);
+    free(state->level_stamp);
+    free(state->assumptions);
+    free(state->failed);
+    memset(state, 0, sizeof(sat_state_t));
+}
+
+rtka_error_t rtka_sat_clone(sat_state_t* dst, const sat_state_t* src) {
+    rtka_sat_init(dst, src->num_vars);
+    if (dst->error != RTKA_SUCCESS) return dst->error;
+    memcpy(dst->variables, src->variables, ((size_t)src->num_vars + 1) * sizeof(rtka_state_t));
+    rtka_error_t err = rtka_sat_reserve(dst, 0, src->arena_size);
+    if (err != RTKA_SUCCESS) return err;
+
+    /* Original clauses and learned units; other learned clauses stay behind */
+    for (uint32_t off = 0; off < src->arena_size; off += SAT_CLAUSE_HEADER + src->arena[off]) {
+        const uint32_t* c = src->arena + off;
+        bool learnt = (c[1] & SAT_CLAUSE_LEARNT) != 0;
+        if ((c[1] & SAT_CLAUSE_DELETED) || (learnt && c[0] != 1)) continue;
+        if (clause_alloc(dst, c + SAT_CLAUSE_HEADER, c[0], learnt, c[1] & SAT_CLAUSE_LBD) ==
+            SAT_CREF_NONE) {
+            return dst->error;
+        }
+        if (!learnt) dst->num_clauses++;
+    }
+    dst->inconsistent = src->inconsistent;
+    dst->error = src->error;
+    return dst->error;
+}
+
+rtka_error_t rtka_sat_reserve(sat_state_t* state, uint32_t clauses, uint64_t literals) {
+    if (state->error != RTKA_SUCCESS) return state->error;
+    uint64_t need = (uint64_t)state->arena_size + (uint64_t)clauses * SAT_CLAUSE_HEADER + literals;
+    if (need >= SAT_CREF_NONE ||
+        !grow((void**)&state->arena, &state->arena_capacity, need, sizeof(uint32_t))) {
+        return RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    return RTKA_SUCCESS;
+}
+
+void rtka_sat_add_clause(sat_state_t* state, int32_t* literals, uint32_t size) {
+    if (state->error != RTKA_SUCCESS) return;
+    for (uint32_t i = 0; i < size; i++) {
+        int32_t l = literals[i];
+        if (l == 0 || (uint32_t)abs(l) > state->num_vars) {
+            fail(state, RTKA_ERROR_INVALID_VALUE);
+            return;
+        }
+    }
+    clear_trail(state);
+
+    /* seen[v]: 1 seen positive, 2 seen negative */
+    sat_lit_t* lits = state->learnt;
+    uint32_t kept = 0;
+    bool tautology = false;
+    for (uint32_t i = 0; i < size && !tautology; i++) {
+        sat_lit_t l = lit_make(literals[i]);
+        uint8_t mark = (uint8_t)(1U + (l & 1U));
+        uint8_t* seen = &state->seen[lit_var(l)];
+        if (*seen == mark) continue;
+        if (*seen) tautology = true;
+        *seen = mark;
+        lits[kept++] = l;
+    }
+    for (uint32_t i = 0; i < kept; i++) state->seen[lit_var(lits[i])] = 0;
+    if (tautology) return;
+    if (kept == 0) {
+        state->inconsistent = true;
+        return;
+    }
+    if (clause_alloc(state, lits, kept, false, 0) != SAT_CREF_NONE) state->num_clauses++;
+}
+
 bool rtka_sat_solve(sat_state_t* state) {
-    return dpll(state);
+    return rtka_sat_solve_assuming(state, NULL, 0);
+}
+
+bool rtka_sat_solve_assuming(sat_state_t* state, const int32_t* lits, uint32_t n) {
+    if (state->error != RTKA_SUCCESS) return false;
+    for (uint32_t i = 0; i < n; i++) {
+        if (lits[i] == 0 || (uint32_t)abs(lits[i]) > state->num_vars) {
+            fail(state, RTKA_ERROR_INVALID_VALUE);
+            return false;
+        }
+    }
+    if (n > state->assumptions_capacity) {
+        uint32_t cap = state->assumptions_capacity;
+        sat_lit_t* a = state->assumptions;
+        if (!grow((void**)&a, &cap, n, sizeof(sat_lit_t))) {
+            fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        state->assumptions = a;
+        int32_t* f = (int32_t*)realloc(state->failed, (size_t)cap * sizeof(int32_t));
+        if (!f) {
+            fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        state->failed = f;
+        state->assumptions_capacity = cap;
+    }
+    if (!ensure_levels(state, (uint64_t)state->num_vars + n + 1U)) {
+        fail(state, RTKA_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    clear_trail(state);
+    for (uint32_t i = 0; i < n; i++) state->assumptions[i] = lit_make(lits[i]);
+    state->num_assumptions = n;
+    state->num_failed = 0;
+    if (state->inconsistent) {
+        publish(state);
+        return false;
+    }
+
+    /* Confidence priors and preferred polarities, read once */
+    if (state->conflicts == 0 && state->decisions == 0) seed_priors(state);
+    state->heap_size = 0;
+    for (uint32_t v = 1; v <= state->num_vars; v++) state->heap_index[v] = SAT_HEAP_NONE;
+    for (uint32_t v = 1; v <= state->num_vars; v++) heap_insert(state, v);
+
+    for (uint32_t off = 0; off < state->arena_size; off += SAT_CLAUSE_HEADER + state->arena[off]) {
+        if (state->arena[off] != 1) continue;
+        sat_lit_t l = clause_lits(state->arena + off)[0];
+        if (lit_value(state, l) < 0) state->inconsistent = true;
+        else if (lit_value(state, l) == 0) enqueue(state, l, SAT_CREF_NONE);
+    }
+    if (state->inconsistent && state->proof) rtka_sat_proof_clause(state, NULL, 0, false);
+    if (state->max_learnts == 0) {
+        state->max_learnts = state->num_clauses / 3 > SAT_LEARNTS_MIN ? state->num_clauses / 3
+                                                                      : SAT_LEARNTS_MIN;
+    }
+
+    uint64_t restart_unit = state->restart_base ? state->restart_base : SAT_RESTART_BASE;
+    uint32_t restart_index = 0;
+    uint64_t restart_budget = restart_unit * luby(restart_index);
+    uint64_t since_restart = 0;
+    bool result = false;
+
+    while (!state->inconsistent && state->error == RTKA_SUCCESS) {
+        if (state->stop && atomic_load_explicit(state->stop, memory_order_relaxed)) break;
+        uint64_t span = rtka_trace_begin();
+        uint64_t propagated = state->propagations;
+        RTKA_PERF_TIMER_BEGIN(propagate_timer, RTKA_PERF_TIMER_SAT_PROPAGATE);
+        sat_cref_t conflict = propagate(state);
+        RTKA_PERF_TIMER_END(propagate_timer);
+        rtka_trace_end(RTKA_TRACE_SAT_PROPAGATE, span, (uint32_t)(state->propagations - propagated));
+        RTKA_PERF_COUNT(RTKA_PERF_SAT_PROPAGATIONS, state->propagations - propagated);
+        if (conflict != SAT_CREF_NONE) {
+            state->conflicts++;
+            RTKA_PERF_COUNT(RTKA_PERF_SAT_CONFLICTS, 1);
+            since_restart++;
+            if (state->decision_level == 0) {
+                state->inconsistent = true;
+                if (state->proof) rtka_sat_proof_clause(state, NULL, 0, false);
+                break;
+            }
+            uint32_t backjump, lbd;
+            uint32_t size = analyze(state, conflict, &backjump, &lbd);
+            rtka_trace_instant(RTKA_TRACE_SAT_CONFLICT, backjump);
+            cancel_until(state, backjump);
+
+            sat_lit_t* out = state->learnt;
+            if (state->proof) rtka_sat_proof_clause(state, out, size, false);
+            if (state->share && size <= SAT_SHARE_MAX_LITS) {
+                rtka_sat_share_export(state->share, state->share_id, out, size);
+            }
+            sat_cref_t cref;
+            if (!store_learnt(state, out, size, lbd, &cref)) break;
+            if (size == 1) {
+                enqueue(state, out[0], SAT_CREF_NONE);
+            } else {
+                bump_clause(state, clause_at(state, cref));
+                enqueue(state, out[0], cref);
+            }
+            state->learned++;
+            state->var_inc /= SAT_VAR_DECAY;
+            state->clause_inc /= SAT_CLAUSE_DECAY;
+            continue;
+        }
+
+        if (since_restart >= restart_budget) {
+            cancel_until(state, 0);
+            state->restarts++;
+            rtka_trace_instant(RTKA_TRACE_SAT_RESTART, (uint32_t)state->restarts);
+            since_restart = 0;
+            restart_budget = restart_unit * luby(++restart_index);
+            if (state->share) {
+                import_shared(state);
+                if (state->qhead < state->trail_size || state->inconsistent) continue;
+            }
+        }
+        if (state->num_learnts >= state->max_learnts + state->trail_size) {
+            reduce_learnts(state);
+            state->max_learnts += state->max_learnts / 10;
+        }
+
+        /* Assumptions first, one level each; an already true one still
+         * opens an empty level so level i + 1 always belongs to assumption i */
+        sat_lit_t next = 0;
+        bool refuted = false, assumed = false;
+        while (state->decision_level < state->num_assumptions) {
+            sat_lit_t a = state->assumptions[state->decision_level];
+            int8_t v = lit_value(state, a);
+            if (v > 0) {
+                state->trail_lim[state->decision_level++] = state->trail_size;
+            } else if (v < 0) {
+                analyze_final(state, a);
+                refuted = true;
+                break;
+            } else {
+                next = a;
+                assumed = true;
+                break;
+            }
+        }
+        if (refuted) break;
+        if (!assumed) {
+            RTKA_PERF_TIMER_BEGIN(decide_timer, RTKA_PERF_TIMER_SAT_DECIDE);
+            bool picked = pick_branch(state, &next);
+            RTKA_PERF_TIMER_END(decide_timer);
+            if (!picked) {
+                result = true;
+                break;
+            }
+            state->decisions++;
+            RTKA_PERF_COUNT(RTKA_PERF_SAT_DECISIONS, 1);
+        }
+        state->trail_lim[state->decision_level++] = state->trail_size;
+        RTKA_PERF_DEPTH(state->decision_level);
+        enqueue(state, next, SAT_CREF_NONE);
+    }
+
+    publish(state);
+    return result;
 }
 
 bool rtka_sat_is_satisfied(const sat_state_t* state) {
-    for (uint32_t c = 0; c < state->num_clauses; c++) {
-        if (!state->clauses[c].satisfied) return false;
+    if (state->inconsistent || state->error != RTKA_SUCCESS) return false;
+    for (uint32_t off = 0; off < state->arena_size; off += SAT_CLAUSE_HEADER + state->arena[off]) {
+        const uint32_t* c = state->arena + off;
+        if (c[1] & (SAT_CLAUSE_LEARNT | SAT_CLAUSE_DELETED)) continue;
+        const sat_lit_t* lits = c + SAT_CLAUSE_HEADER;
+        bool sat = false;
+        for (uint32_t k = 0; k < c[0] && !sat; k++) {
+            rtka_value_t want = (lits[k] & 1U) ? RTKA_FALSE : RTKA_TRUE;
+            sat = state->variables[lit_var(lits[k])].value == want;
+        }
+        if (!sat) return false;
     }
     return true;
 }
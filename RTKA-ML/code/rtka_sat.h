@@ -8,6 +8,38 @@
  *
  * For licensing inquiries: opsec.ee@pm.me
  *
+ * RTKA SAT Solver - conflict-driven clause learning
+ *
+ * CHANGELOG:
+ * v1.1.0 - CDCL engine replaces the recursive DPLL
+ *          Clauses live in one growable arena, so instance size is bounded
+ *          only by memory. Two-watched-literal propagation, first-UIP
+ *          learning with local minimization, non-chronological backjumping,
+ *          VSIDS branching seeded from the variables' confidences, phase
+ *          saving, Luby restarts and LBD / activity based learned-clause
+ *          deletion with arena compaction.
+ *          rtka_sat_free() releases the storage taken by rtka_sat_init().
+ * v1.1.1 - rtka_sat_reserve() presizes the arena for bulk loads; setting
+ *          state->proof streams a DRAT proof of every learned and deleted
+ *          clause during solve (see rtka_sat_dimacs.h for I/O)
+ * v1.2.0 - Diversification knobs (seed, polarity mode, restart unit), a
+ *          stop flag and learned-clause sharing hooks for the parallel
+ *          portfolio in rtka_sat_portfolio.h; rtka_sat_clone()
+ * v1.3.0 - rtka_sat_solve_assuming(): assumptions are decided first, at
+ *          levels 1..n, so learned clauses and activities carry over to the
+ *          next call; a refuted call reports the responsible assumptions
+ * v1.3.1 - Search emits trace events (rtka_trace.h): a span per
+ *          propagation with the literals propagated, conflicts with their
+ *          backjump level, restarts
+ * v1.3.2 - Search counters and timers (rtka_perf.h, make perf):
+ *          propagations, decisions and conflicts; propagate and decide
+ *          timed; deepest decision level
+ *
+ * The public assignment is variables[1..num_vars]: after a satisfiable
+ * solve every variable is TRUE or FALSE, with confidence 1.0 when it was
+ * implied and 0.5 when it was a free decision. Before the first solve a
+ * caller may raise a variable's confidence to have it branched on earlier,
+ * and set its value to pick the polarity tried first.
  */
 
 #ifndef RTKA_SAT_H
@@ -15,29 +47,145 @@
 
 #include "rtka_u_core.h"
 #include "rtka_types.h"
+#include <stdio.h>
+#include <stdatomic.h>
+
+/* Solver literal: 2 * var for x, 2 * var + 1 for NOT x */
+typedef uint32_t sat_lit_t;
+
+/* Word offset of a clause header in the arena */
+typedef uint32_t sat_cref_t;
+#define SAT_CREF_NONE UINT32_MAX
+
+/* Learned clauses up to this length are offered to portfolio peers */
+#define SAT_SHARE_MAX_LITS 8U
+
+/* Initial polarity of each variable before phase saving takes over */
+typedef enum {
+    SAT_POLARITY_HINT,          /* Preset value, TRUE when UNKNOWN */
+    SAT_POLARITY_INVERTED,      /* Opposite of the preset value, FALSE when UNKNOWN */
+    SAT_POLARITY_RANDOM         /* Keeps the preset value with probability = confidence,
+                                 * coin flip when UNKNOWN */
+} sat_polarity_t;
 
-#define SAT_MAX_VARS 100
-#define SAT_MAX_CLAUSES 500
-#define SAT_MAX_LITERALS 10
+typedef struct sat_share sat_share_t;
+
+/* Arena clause layout: [size, flags | lbd, activity, literals...] */
+#define SAT_CLAUSE_HEADER  3U
+#define SAT_CLAUSE_LEARNT  0x80000000U
+#define SAT_CLAUSE_DELETED 0x40000000U
+#define SAT_CLAUSE_LBD     0x3FFFFFFFU
+
+typedef struct {
+    sat_cref_t cref;
+    sat_lit_t blocker;      /* Other watched literal; clause skipped while it is true */
+} sat_watch_t;
 
 typedef struct {
-    int32_t literals[SAT_MAX_LITERALS];
-    uint32_t size;
-    bool satisfied;
-} sat_clause_t;
+    sat_watch_t* items;
+    uint32_t count;
+    uint32_t capacity;
+} sat_watch_list_t;
 
 typedef struct {
-    rtka_state_t variables[SAT_MAX_VARS + 1];
-    sat_clause_t clauses[SAT_MAX_CLAUSES];
+    rtka_state_t* variables;        /* 1-based public assignment, num_vars + 1 */
     uint32_t num_vars;
-    uint32_t num_clauses;
+    uint32_t num_clauses;           /* Original clauses stored */
     uint32_t assigned;
     uint32_t rtka_transitions;
+
+    /* Clause storage */
+    uint32_t* arena;
+    uint32_t arena_size;
+    uint32_t arena_capacity;
+    sat_cref_t* learnts;
+    uint32_t num_learnts;
+    uint32_t learnts_capacity;
+    uint32_t max_learnts;
+    sat_watch_list_t* watches;      /* Per literal: clauses watching it */
+
+    /* Assignment trail */
+    int8_t* lit_value;              /* Per literal: 1 true, -1 false, 0 open */
+    uint32_t* level;
+    sat_cref_t* reason;
+    sat_lit_t* trail;
+    uint32_t trail_size;
+    uint32_t qhead;
+    uint32_t* trail_lim;
+    uint32_t decision_level;
+    uint32_t level_capacity;        /* trail_lim / level_stamp entries */
+
+    /* Assumptions of the current call, decided first at levels 1..n */
+    sat_lit_t* assumptions;
+    uint32_t num_assumptions;
+    uint32_t assumptions_capacity;
+    int32_t* failed;                /* Assumptions refuted together, as given */
+    uint32_t num_failed;
+
+    /* Branching */
+    double* activity;
+    double var_inc;
+    float clause_inc;
+    uint32_t* heap;                 /* Max-heap of variables on activity */
+    uint32_t* heap_index;
+    uint32_t heap_size;
+    uint8_t* phase;                 /* Saved polarity, 1 = negative */
+
+    /* Conflict analysis scratch */
+    uint8_t* seen;
+    sat_lit_t* learnt;
+    uint32_t* level_stamp;
+    uint32_t stamp;
+
+    bool inconsistent;              /* Empty clause derived or added */
+    rtka_error_t error;             /* First allocation / literal error, sticky */
+    FILE* proof;                    /* DRAT output while solving, NULL for none */
+
+    /* Diversification: the zero defaults give the plain sequential search */
+    uint32_t seed;                  /* Nonzero: jittered initial activities */
+    sat_polarity_t polarity;
+    uint32_t restart_base;          /* Conflicts per Luby unit, 0 = 100 */
+    uint32_t rng;
+
+    /* Portfolio hooks; solve returns false with inconsistent unset when stopped */
+    atomic_bool* stop;
+    sat_share_t* share;
+    uint32_t share_id;
+    uint64_t share_cursor;
+
+    uint64_t conflicts;
+    uint64_t decisions;
+    uint64_t propagations;
+    uint32_t restarts;
+    uint32_t learned;
+    uint32_t deleted;
+    uint32_t imported;              /* Peer clauses taken from the share ring */
 } sat_state_t;
 
 void rtka_sat_init(sat_state_t* state, uint32_t vars);
+void rtka_sat_free(sat_state_t* state);
+
+/* Fresh state over the same variables, hints and original clauses */
+RTKA_NODISCARD rtka_error_t rtka_sat_clone(sat_state_t* dst, const sat_state_t* src);
+
+/* Room for `clauses` more clauses holding `literals` literals in total */
+RTKA_NODISCARD rtka_error_t rtka_sat_reserve(sat_state_t* state, uint32_t clauses, uint64_t literals);
+
+/* Literals are +v / -v for v in 1..num_vars. Duplicates are merged and
+ * tautologies dropped; a clause with an out-of-range literal is rejected
+ * and recorded in state->error. */
 void rtka_sat_add_clause(sat_state_t* state, int32_t* literals, uint32_t size);
+
 bool rtka_sat_solve(sat_state_t* state);
+
+/* Solve with lits (+v / -v) temporarily forced. false with
+ * state->num_failed > 0 means unsatisfiable under these assumptions only:
+ * failed[] lists a subset of them that cannot hold together, and the
+ * formula itself stays usable (state->inconsistent is only set when it is
+ * unsatisfiable outright). Clauses may be added between calls. */
+bool rtka_sat_solve_assuming(sat_state_t* state, const int32_t* lits, uint32_t n);
+
+/* Every original clause holds under the public assignment */
 bool rtka_sat_is_satisfied(const sat_state_t* state);
 
 #endif
@@ -0,0 +1,242 @@
+/**
+ * File: rtka_sat_dimacs.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA SAT I/O Library
+ */
+
+#define _GNU_SOURCE
+#include "rtka_sat_dimacs.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DIMACS_BUFFER   4096U       /* Text staged per fwrite */
+#define DIMACS_LINE     78U         /* Wrap column for "v" lines */
+#define DIMACS_MAX_VARS (UINT32_MAX / 2U - 1U)
+
+typedef struct {
+    const char* p;
+    const char* end;
+} dimacs_scanner_t;
+
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline bool is_digit(char c) {
+    return (unsigned char)(c - '0') < 10U;
+}
+
+static inline void skip_space(dimacs_scanner_t* s) {
+    while (s->p < s->end && is_space(*s->p)) s->p++;
+}
+
+static void skip_line(dimacs_scanner_t* s) {
+    const char* nl = (const char*)memchr(s->p, '\n', (size_t)(s->end - s->p));
+    s->p = nl ? nl + 1 : s->end;
+}
+
+/* Signed decimal token with |value| <= limit, ending at whitespace or EOF */
+static bool scan_int(dimacs_scanner_t* s, uint64_t limit, int64_t* out) {
+    const char* p = s->p;
+    bool negative = p < s->end && *p == '-';
+    if (negative) p++;
+    if (p == s->end || !is_digit(*p)) return false;
+
+    uint64_t v = 0;
+    while (p < s->end && is_digit(*p)) {
+        v = v * 10U + (uint64_t)(*p++ - '0');
+        if (v > limit) return false;
+    }
+    if (p < s->end && !is_space(*p)) return false;
+    s->p = p;
+    *out = negative ? -(int64_t)v : (int64_t)v;
+    return true;
+}
+
+static bool scan_header(dimacs_scanner_t* s, uint32_t* vars, uint32_t* clauses) {
+    s->p++;                                         /* 'p' */
+    skip_space(s);
+    if (s->end - s->p < 3 || memcmp(s->p, "cnf", 3) != 0) return false;
+    s->p += 3;
+    if (s->p < s->end && !is_space(*s->p)) return false;
+
+    int64_t v, c;
+    skip_space(s);
+    if (!scan_int(s, DIMACS_MAX_VARS, &v) || v < 0) return false;
+    skip_space(s);
+    if (!scan_int(s, UINT32_MAX, &c) || c < 0) return false;
+    *vars = (uint32_t)v;
+    *clauses = (uint32_t)c;
+    return true;
+}
+
+rtka_error_t rtka_sat_parse_dimacs(sat_state_t* state, const char* data, size_t length) {
+    if (!state) return RTKA_ERROR_NULL_POINTER;
+    memset(state, 0, sizeof(sat_state_t));
+    if (!data && length) return RTKA_ERROR_NULL_POINTER;
+
+    dimacs_scanner_t s = {data, data + length};
+    uint32_t vars = 0, clauses = 0;
+    for (;;) {
+        skip_space(&s);
+        if (s.p == s.end) return RTKA_ERROR_INVALID_VALUE;
+        if (*s.p == 'c') {
+            skip_line(&s);
+        } else if (*s.p == 'p' && scan_header(&s, &vars, &clauses)) {
+            break;
+        } else {
+            return RTKA_ERROR_INVALID_VALUE;
+        }
+    }
+
+    rtka_sat_init(state, vars);
+    if (state->error != RTKA_SUCCESS) return state->error;
+
+    /* Literals take at least two bytes each; four is typical of real
+     * instances, and the arena still grows past the estimate if needed */
+    rtka_error_t err = rtka_sat_reserve(state, clauses, (uint64_t)(s.end - s.p) / 4U);
+    if (err != RTKA_SUCCESS) return err;
+
+    uint32_t capacity = 64, size = 0;
+    int32_t* clause = (int32_t*)malloc(capacity * sizeof(int32_t));
+    if (!clause) return RTKA_ERROR_OUT_OF_MEMORY;
+
+    while (state->error == RTKA_SUCCESS) {
+        skip_space(&s);
+        if (s.p == s.end || *s.p == '%') break;     /* SATLIB files end in "%" */
+        if (*s.p == 'c') {
+            skip_line(&s);
+            continue;
+        }
+        int64_t lit;
+        if (!scan_int(&s, vars, &lit)) {
+            err = RTKA_ERROR_INVALID_VALUE;
+            break;
+        }
+        if (lit == 0) {
+            rtka_sat_add_clause(state, clause, size);
+            size = 0;
+            continue;
+        }
+        if (size == capacity) {
+            int32_t* grown = (capacity <= UINT32_MAX / 2U)
+                ? (int32_t*)realloc(clause, 2U * capacity * sizeof(int32_t)) : NULL;
+            if (!grown) {
+                err = RTKA_ERROR_OUT_OF_MEMORY;
+                break;
+            }
+            clause = grown;
+            capacity *= 2U;
+        }
+        clause[size++] = (int32_t)lit;
+    }
+    if (err == RTKA_SUCCESS && size > 0) rtka_sat_add_clause(state, clause, size);
+    free(clause);
+    return err != RTKA_SUCCESS ? err : state->error;
+}
+
+rtka_error_t rtka_sat_load_dimacs(sat_state_t* state, const char* path) {
+    if (!state || !path) return RTKA_ERROR_NULL_POINTER;
+    memset(state, 0, sizeof(sat_state_t));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return RTKA_ERROR_INVALID_VALUE;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    size_t length = (size_t)st.st_size;
+    void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return RTKA_ERROR_OUT_OF_MEMORY;
+    madvise(map, length, MADV_SEQUENTIAL);
+
+    rtka_error_t err = rtka_sat_parse_dimacs(state, (const char*)map, length);
+    munmap(map, length);
+    return err;
+}
+
+/* Decimal text of v at p; returns the end */
+static char* put_int(char* p, int64_t v) {
+    char digits[24];
+    uint32_t n = 0;
+    uint64_t u = v < 0 ? (uint64_t)(-v) : (uint64_t)v;
+    do {
+        digits[n++] = (char)('0' + u % 10U);
+        u /= 10U;
+    } while (u);
+    if (v < 0) *p++ = '-';
+    while (n) *p++ = digits[--n];
+    return p;
+}
+
+static inline int64_t dimacs_literal(sat_lit_t l) {
+    int64_t v = (int64_t)(l >> 1);
+    return (l & 1U) ? -v : v;
+}
+
+rtka_error_t rtka_sat_write_model(const sat_state_t* state, bool satisfiable, FILE* out) {
+    if (!state || !out) return RTKA_ERROR_NULL_POINTER;
+    if (!satisfiable) {
+        fputs("s UNSATISFIABLE\n", out);
+        return ferror(out) ? RTKA_ERROR_INVALID_VALUE : RTKA_SUCCESS;
+    }
+
+    char buf[DIMACS_BUFFER];
+    char* p = buf;
+    memcpy(p, "s SATISFIABLE\nv", 15);
+    p += 15;
+    uint32_t column = 1;
+    for (uint32_t v = 1; v <= state->num_vars; v++) {
+        if (p - buf > (ptrdiff_t)(DIMACS_BUFFER - 32U)) {
+            fwrite(buf, 1, (size_t)(p - buf), out);
+            p = buf;
+        }
+        if (column > DIMACS_LINE - 12U) {
+            memcpy(p, "\nv", 2);
+            p += 2;
+            column = 1;
+        }
+        char* start = p;
+        *p++ = ' ';
+        p = put_int(p, state->variables[v].value == RTKA_FALSE ? -(int64_t)v : (int64_t)v);
+        column += (uint32_t)(p - start);
+    }
+    memcpy(p, " 0\n", 3);
+    p += 3;
+    fwrite(buf, 1, (size_t)(p - buf), out);
+    return ferror(out) ? RTKA_ERROR_INVALID_VALUE : RTKA_SUCCESS;
+}
+
+void rtka_sat_proof_clause(sat_state_t* state, const sat_lit_t* lits, uint32_t size, bool deleted) {
+    char buf[DIMACS_BUFFER];
+    char* p = buf;
+    if (deleted) {
+        *p++ = 'd';
+        *p++ = ' ';
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        if (p - buf > (ptrdiff_t)(DIMACS_BUFFER - 32U)) {
+            fwrite(buf, 1, (size_t)(p - buf), state->proof);
+            p = buf;
+        }
+        p = put_int(p, dimacs_literal(lits[i]));
+        *p++ = ' ';
+    }
+    *p++ = '0';
+    *p++ = '\n';
+    fwrite(buf, 1, (size_t)(p - buf), state->proof);
+}
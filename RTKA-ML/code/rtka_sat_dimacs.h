@@ -0,0 +1,53 @@
+/**
+ * File: rtka_sat_dimacs.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA SAT I/O - DIMACS CNF loading, competition-format model output and
+ * DRAT proof logging
+ *
+ * CHANGELOG:
+ * v1.0.0 - Memory-mapped DIMACS loader with a handwritten integer scanner;
+ *          the "p cnf" header sizes the solver and its clause arena before
+ *          the first clause is read. Model writer prints "s" / "v" lines,
+ *          proof logger writes textual DRAT.
+ *
+ *   sat_state_t sat;
+ *   if (rtka_sat_load_dimacs(&sat, "instance.cnf") == RTKA_SUCCESS) {
+ *       sat.proof = fopen("instance.drat", "w");
+ *       bool ok = rtka_sat_solve(&sat);
+ *       (void)rtka_sat_write_model(&sat, ok, stdout);
+ *   }
+ *   rtka_sat_free(&sat);
+ */
+
+#ifndef RTKA_SAT_DIMACS_H
+#define RTKA_SAT_DIMACS_H
+
+#include "rtka_sat.h"
+
+/* Initialize state from a CNF image: "c" comment lines, one "p cnf V C"
+ * header, then 0-terminated clauses that may span lines. A trailing clause
+ * without its 0 and a clause count that disagrees with the header are
+ * accepted; a missing header or a literal outside 1..V is
+ * RTKA_ERROR_INVALID_VALUE. state must be freed with rtka_sat_free()
+ * whatever the result. */
+RTKA_NODISCARD rtka_error_t rtka_sat_parse_dimacs(sat_state_t* state, const char* data, size_t length);
+
+/* rtka_sat_parse_dimacs() over a read-only mapping of the file */
+RTKA_NODISCARD rtka_error_t rtka_sat_load_dimacs(sat_state_t* state, const char* path);
+
+/* "s SATISFIABLE" followed by the model as "v" lines ending in 0, or
+ * "s UNSATISFIABLE" */
+RTKA_NODISCARD rtka_error_t rtka_sat_write_model(const sat_state_t* state, bool satisfiable, FILE* out);
+
+/* One DRAT line to state->proof: the clause, or "d" and the clause when
+ * deleted; size 0 writes the empty clause */
+void rtka_sat_proof_clause(sat_state_t* state, const sat_lit_t* lits, uint32_t size, bool deleted);
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * File: rtka_sat_portfolio.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA SAT Portfolio Library
+ */
+
+#include "rtka_sat_portfolio.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* One shared clause. seq is 2t + 1 while ticket t is being written and
+ * 2t + 2 once it is complete. */
+typedef struct RTKA_ALIGNED(64) {
+    atomic_uint_fast64_t seq;
+    atomic_uint size;
+    atomic_uint source;
+    atomic_uint lits[SAT_SHARE_MAX_LITS];
+} sat_share_slot_t;
+
+struct sat_share {
+    RTKA_ALIGNED(64) atomic_uint_fast64_t head;     /* Next ticket */
+    sat_share_slot_t slots[SAT_SHARE_SLOTS];
+};
+
+/* Restart units cycled across instances */
+static const uint32_t portfolio_restart_units[] = {100U, 50U, 200U, 400U};
+
+sat_share_t* rtka_sat_share_create(void) {
+    sat_share_t* share = (sat_share_t*)aligned_alloc(64, sizeof(sat_share_t));
+    if (!share) return NULL;
+    atomic_init(&share->head, 0);
+    for (uint32_t i = 0; i < SAT_SHARE_SLOTS; i++) {
+        sat_share_slot_t* slot = &share->slots[i];
+        atomic_init(&slot->seq, 0);
+        atomic_init(&slot->size, 0);
+        atomic_init(&slot->source, 0);
+        for (uint32_t k = 0; k < SAT_SHARE_MAX_LITS; k++) atomic_init(&slot->lits[k], 0);
+    }
+    return share;
+}
+
+void rtka_sat_share_free(sat_share_t* share) {
+    free(share);
+}
+
+void rtka_sat_share_export(sat_share_t* share, uint32_t source, const sat_lit_t* lits, uint32_t size) {
+    if (size > SAT_SHARE_MAX_LITS) return;
+    uint64_t ticket = atomic_fetch_add_explicit(&share->head, 1, memory_order_relaxed);
+    sat_share_slot_t* slot = &share->slots[ticket & (SAT_SHARE_SLOTS - 1U)];
+
+    /* Claim the slot only if it is idle and older than this ticket; a
+     * writer that lapped or is lapping us wins and this clause is dropped */
+    uint64_t writing = 2U * ticket + 1U;
+    uint64_t seen = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    if ((seen & 1U) || seen > writing ||
+        !atomic_compare_exchange_strong_explicit(&slot->seq, &seen, writing,
+                                                 memory_order_relaxed, memory_order_relaxed)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->size, size, memory_order_relaxed);
+    atomic_store_explicit(&slot->source, source, memory_order_relaxed);
+    for (uint32_t k = 0; k < size; k++) atomic_store_explicit(&slot->lits[k], lits[k], memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, writing + 1U, memory_order_release);
+}
+
+bool rtka_sat_share_next(sat_share_t* share, uint32_t reader, uint64_t* cursor,
+                         sat_lit_t* lits, uint32_t* size) {
+    uint64_t head = atomic_load_explicit(&share->head, memory_order_acquire);
+    if (head - *cursor > SAT_SHARE_SLOTS) *cursor = head - SAT_SHARE_SLOTS;
+
+    while (*cursor < head) {
+        uint64_t ticket = (*cursor)++;
+        sat_share_slot_t* slot = &share->slots[ticket & (SAT_SHARE_SLOTS - 1U)];
+        uint64_t done = 2U * ticket + 2U;
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != done) continue;
+
+        uint32_t n = atomic_load_explicit(&slot->size, memory_order_relaxed);
+        uint32_t from = atomic_load_explicit(&slot->source, memory_order_relaxed);
+        if (n > SAT_SHARE_MAX_LITS) continue;
+        for (uint32_t k = 0; k < n; k++) lits[k] = atomic_load_explicit(&slot->lits[k], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != done) continue;
+
+        if (from == reader) continue;
+        *size = n;
+        return true;
+    }
+    return false;
+}
+
+typedef struct {
+    sat_state_t** states;
+    atomic_bool stop;
+    atomic_int winner;
+    bool result;
+} sat_portfolio_t;
+
+static void portfolio_worker(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    sat_portfolio_t* p = (sat_portfolio_t*)ctx;
+    for (uint32_t i = begin; i < end; i++) {
+        if (atomic_load_explicit(&p->stop, memory_order_relaxed)) return;
+        sat_state_t* s = p->states[i];
+        bool sat = rtka_sat_solve(s);
+        if (!sat && !s->inconsistent) continue;     /* Stopped or failed */
+
+        int expected = -1;
+        if (atomic_compare_exchange_strong(&p->winner, &expected, (int)i)) {
+            p->result = sat;
+            atomic_store(&p->stop, true);
+        }
+    }
+}
+
+bool rtka_sat_solve_portfolio(sat_state_t* state, rtka_thread_pool_t* pool, uint32_t instances) {
+    if (state->error != RTKA_SUCCESS) return false;
+    if (!pool) pool = rtka_pool_default();
+    if (instances == 0) instances = pool ? rtka_pool_size(pool) + 1U : 1U;
+    if (!pool || instances <= 1) return rtka_sat_solve(state);
+
+    sat_share_t* share = rtka_sat_share_create();
+    sat_state_t* clones = (sat_state_t*)calloc(instances - 1U, sizeof(sat_state_t));
+    sat_state_t** states = (sat_state_t**)malloc(instances * sizeof(sat_state_t*));
+    uint32_t cloned = 0;
+    bool ready = share && clones && states;
+    while (ready && cloned < instances - 1U) {
+        sat_state_t* c = &clones[cloned++];
+        ready = rtka_sat_clone(c, state) == RTKA_SUCCESS;
+
+        uint32_t i = cloned;
+        c->polarity = (sat_polarity_t)(i % 3U);
+        c->seed = (i * 0x9E3779B9U) | 1U;
+        c->restart_base = portfolio_restart_units[i % 4U];
+    }
+
+    bool result = false;
+    if (ready) {
+        sat_portfolio_t p = {.states = states, .result = false};
+        atomic_init(&p.stop, false);
+        atomic_init(&p.winner, -1);
+
+        states[0] = state;
+        for (uint32_t i = 1; i < instances; i++) states[i] = &clones[i - 1U];
+        for (uint32_t i = 0; i < instances; i++) {
+            states[i]->stop = &p.stop;
+            states[i]->share = share;
+            states[i]->share_id = i;
+            states[i]->share_cursor = 0;
+        }
+
+        FILE* proof = state->proof;
+        state->proof = NULL;
+        rtka_pool_parallel_for(pool, 0, instances, 1, portfolio_worker, &p);
+        state->proof = proof;
+        state->stop = NULL;
+        state->share = NULL;
+
+        int w = atomic_load(&p.winner);
+        if (w > 0) {
+            const sat_state_t* won = states[w];
+            memcpy(state->variables, won->variables,
+                   ((size_t)state->num_vars + 1U) * sizeof(rtka_state_t));
+            state->assigned = won->assigned;
+            state->inconsistent = won->inconsistent;
+        }
+        result = w >= 0 && p.result;
+    }
+
+    for (uint32_t i = 0; i < cloned; i++) rtka_sat_free(&clones[i]);
+    free(clones);
+    free(states);
+    rtka_sat_share_free(share);
+    if (!ready) return rtka_sat_solve(state);
+    return result;
+}
@@ -0,0 +1,53 @@
+/**
+ * File: rtka_sat_portfolio.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA SAT Portfolio - diversified CDCL instances racing on the thread
+ * pool, sharing short learned clauses
+ *
+ * CHANGELOG:
+ * v1.0.0 - Portfolio solve over rtka_pool_parallel_for. Instance 0 is the
+ *          caller's state with its own settings; the others are clones
+ *          cycling polarity mode, seed and restart unit. Learned clauses of
+ *          at most SAT_SHARE_MAX_LITS literals are published to a
+ *          fixed-size broadcast ring (one ticket counter, a sequence word
+ *          per slot, no locks) and imported by peers at their restarts.
+ *          The first instance to finish stops the rest.
+ *
+ * Sharing is best-effort: a reader that is lapped, or that meets a slot
+ * still being written, skips those clauses. Proof logging does not cover
+ * imported clauses, so state->proof is ignored while the portfolio runs.
+ */
+
+#ifndef RTKA_SAT_PORTFOLIO_H
+#define RTKA_SAT_PORTFOLIO_H
+
+#include "rtka_sat.h"
+#include "rtka_threadpool.h"
+
+#define SAT_SHARE_SLOTS 4096U       /* Ring capacity, power of two */
+
+/**
+ * Solve with `instances` diversified solvers (0 = one per pool participant,
+ * i.e. rtka_pool_size() + 1) on `pool` (NULL = rtka_pool_default()).
+ * The winning assignment is published to state->variables, and an UNSAT
+ * result sets state->inconsistent, exactly as rtka_sat_solve() would.
+ */
+bool rtka_sat_solve_portfolio(sat_state_t* state, rtka_thread_pool_t* pool, uint32_t instances);
+
+/* Ring used by rtka_sat_solve() when state->share is set */
+RTKA_NODISCARD sat_share_t* rtka_sat_share_create(void);
+void rtka_sat_share_free(sat_share_t* share);
+void rtka_sat_share_export(sat_share_t* share, uint32_t source, const sat_lit_t* lits, uint32_t size);
+
+/* Next clause after *cursor published by someone other than reader */
+bool rtka_sat_share_next(sat_share_t* share, uint32_t reader, uint64_t* cursor,
+                         sat_lit_t* lits, uint32_t* size);
+
+#endif
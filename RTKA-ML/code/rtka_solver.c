@@ -13,12 +13,15 @@
 
 #include "rtka_solver.h"
 #include "rtka_memory.h"
+#include "rtka_random.h"
+#include "rtka_threadpool.h"
 #include <string.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <time.h>
 
-/* Global statistics */
-static rtka_solver_stats_t g_stats = {0};
+/* Statistics of the calling thread; parallel workers fold theirs back */
+static _Thread_local rtka_solver_stats_t g_stats = {0};
 
 /* Create CSP */
 rtka_csp_t* rtka_solver_create_csp(uint32_t num_vars) {
@@ -28,7 +31,7 @@ rtka_csp_t* rtka_solver_create_csp(uint32_t num_vars) {
     csp->num_variables = num_vars;
     csp->variables = rtka_alloc_states(num_vars);
     csp->domain_sizes = (uint32_t*)rtka_alloc_states(num_vars * sizeof(uint32_t) / sizeof(rtka_state_t));
-    csp->domains = (rtka_value_t**)rtka_alloc_states(num_vars * sizeof(void*) / sizeof(rtka_state_t));
+    csp->domains = NULL;  /* Derived from the variables by the AC search */
     
     /* Initialize to UNKNOWN */
     for (uint32_t i = 0; i < num_vars; i++) {
@@ -65,7 +68,12 @@ static bool check_constraint(rtka_constraint_t* constraint, const rtka_state_t*
         
         case CONSTRAINT_TERNARY: {
             if (constraint->check_fn) {
-                rtka_state_t* constraint_vars = rtka_alloc_states(constraint->num_vars);
+                /* Small scopes gather on the C stack, keeping repeated
+                 * checks from local search off the temp stack */
+                rtka_state_t local[16];
+                rtka_state_t* constraint_vars = constraint->num_vars <= 16 ? local
+                    : rtka_alloc_states(constraint->num_vars);
+                if (!constraint_vars) return true;
                 for (uint32_t i = 0; i < constraint->num_vars; i++) {
                     constraint_vars[i] = vars[constraint->variables[i]];
                 }
@@ -280,12 +288,728 @@ static bool backtrack(rtka_csp_t* csp, uint32_t depth, rtka_search_strategy_t st
     return false;
 }
 
+/* CSR index from variables to the constraints over them; both arrays are
+ * left NULL on failure or an out-of-range scope */
+static bool build_var_index(const rtka_csp_t* csp, uint32_t** var_start, uint32_t** var_cons) {
+    uint32_t nv = csp->num_variables, nc = csp->num_constraints;
+    size_t refs = 0;
+    for (uint32_t c = 0; c < nc; c++) refs += csp->constraints[c]->num_vars;
+    uint32_t* start = (uint32_t*)calloc((size_t)nv + 1U, sizeof(uint32_t));
+    uint32_t* cons = (uint32_t*)malloc((refs ? refs : 1U) * sizeof(uint32_t));
+    bool ok = start && cons && refs <= UINT32_MAX;
+
+    for (uint32_t c = 0; ok && c < nc; c++) {
+        for (uint32_t j = 0; ok && j < csp->constraints[c]->num_vars; j++) {
+            uint32_t v = csp->constraints[c]->variables[j];
+            ok = v < nv;
+            if (ok) start[v + 1]++;
+        }
+    }
+    if (!ok) {
+        free(start);
+        free(cons);
+        *var_start = *var_cons = NULL;
+        return false;
+    }
+    for (uint32_t v = 0; v < nv; v++) start[v + 1] += start[v];
+    for (uint32_t c = 0; c < nc; c++) {
+        for (uint32_t j = 0; j < csp->constraints[c]->num_vars; j++) {
+            cons[start[csp->constraints[c]->variables[j]]++] = c;
+        }
+    }
+    for (uint32_t v = nv; v > 0; v--) start[v] = start[v - 1];
+    start[0] = 0;
+    *var_start = start;
+    *var_cons = cons;
+    return true;
+}
+
+/* ============================================================================
+ * ARC CONSISTENCY WITH A TRAIL
+ *
+ * Domains are 3-bit masks over FALSE / UNKNOWN / TRUE. Narrowing a domain
+ * pushes its old mask on the trail, so a failed branch is undone by popping
+ * back to its save point - only the domains that changed are touched. Along
+ * one path a mask shrinks at most three times, which bounds the trail at
+ * 3 * num_variables entries.
+ *
+ * Propagation is queue driven: a constraint is revised when a domain in its
+ * scope shrank, and every (constraint, position, value) remembers the last
+ * tuple found to support it. The constraint is fixed, so that residue stays
+ * valid for as long as its values remain in their domains and most revisions
+ * succeed without evaluating the constraint at all.
+ * ============================================================================ */
+
+#define AC_MAX_ARITY        16U     /* Residue tuples packed base 3 in 32 bits (3^16 < 2^32) */
+#define AC_NO_RESIDUE       UINT32_MAX
+
+typedef struct {
+    uint32_t var;
+    rtka_domain_t mask;
+} ac_trail_t;
+
+typedef struct ac_state {
+    rtka_csp_t* csp;
+    rtka_domain_t* dom;
+    uint32_t* var_start;            /* CSR variable -> constraints, as in min-conflicts */
+    uint32_t* var_cons;
+    uint32_t* residue_start;        /* Constraint c's residues at residue_start[c] + 3 * pos + value */
+    uint32_t* residues;
+    uint32_t* queue;                /* Ring of constraint ids */
+    uint8_t* queued;
+    uint32_t queue_head;
+    uint32_t queue_count;
+    ac_trail_t* trail;
+    uint32_t trail_size;
+
+    /* Leaf handling: visit returns true to stop the search. NULL stops at
+     * the first solution. Leaves also include nodes at split_depth. */
+    bool (*visit)(struct ac_state* a);
+    void* ctx;
+    uint32_t split_depth;
+    const atomic_bool* stop;        /* Raised by another worker, or NULL */
+} ac_state_t;
+
+static inline uint32_t dom_index(rtka_value_t v) { return (uint32_t)(v + 1); }
+static inline rtka_value_t dom_value(uint32_t index) { return (rtka_value_t)((int)index - 1); }
+static inline uint32_t dom_count(rtka_domain_t d) { return (uint32_t)__builtin_popcount(d); }
+
+/* Constraint over already gathered scope values; same semantics as
+ * check_constraint */
+static bool scope_holds(const rtka_constraint_t* constraint, const rtka_state_t* vals) {
+    g_stats.constraint_checks++;
+    switch (constraint->type) {
+        case CONSTRAINT_ALLDIFF:
+            for (uint32_t i = 0; i + 1 < constraint->num_vars; i++) {
+                for (uint32_t j = i + 1; j < constraint->num_vars; j++) {
+                    if (vals[i].value != RTKA_UNKNOWN && vals[i].value == vals[j].value) return false;
+                }
+            }
+            return true;
+        case CONSTRAINT_TERNARY:
+            return constraint->check_fn ? constraint->check_fn(vals, constraint->num_vars) : true;
+        default:
+            return true;
+    }
+}
+
+static void ac_enqueue(ac_state_t* a, uint32_t c) {
+    if (a->queued[c]) return;
+    a->queued[c] = 1;
+    a->queue[(a->queue_head + a->queue_count++) % a->csp->num_constraints] = c;
+}
+
+static void ac_queue_clear(ac_state_t* a) {
+    while (a->queue_count) {
+        a->queued[a->queue[a->queue_head]] = 0;
+        a->queue_head = (a->queue_head + 1U) % a->csp->num_constraints;
+        a->queue_count--;
+    }
+}
+
+/* Narrow v's domain, trailing the old mask and waking its constraints */
+static void ac_narrow(ac_state_t* a, uint32_t v, rtka_domain_t mask) {
+    a->trail[a->trail_size++] = (ac_trail_t){v, a->dom[v]};
+    g_stats.ternary_transitions += dom_count(a->dom[v]) - dom_count(mask);
+    a->dom[v] = mask;
+    for (uint32_t k = a->var_start[v]; k < a->var_start[v + 1]; k++) {
+        ac_enqueue(a, a->var_cons[k]);
+    }
+}
+
+static void ac_undo(ac_state_t* a, uint32_t save_point) {
+    while (a->trail_size > save_point) {
+        ac_trail_t t = a->trail[--a->trail_size];
+        a->dom[t.var] = t.mask;
+    }
+}
+
+/* Support for value index `want` at position pos: the cached residue if its
+ * values are all still live, otherwise an odometer walk over the other
+ * positions' domains, whose first satisfying tuple becomes the residue */
+static bool ac_supported(ac_state_t* a, uint32_t c, uint32_t pos, uint32_t want) {
+    const rtka_constraint_t* k = a->csp->constraints[c];
+    uint32_t arity = k->num_vars;
+    uint32_t* residue = arity <= AC_MAX_ARITY ? &a->residues[a->residue_start[c] + 3U * pos + want] : NULL;
+
+    if (residue && *residue != AC_NO_RESIDUE) {
+        uint32_t code = *residue;
+        bool live = true;
+        for (uint32_t j = 0; j < arity && live; j++, code /= 3U) {
+            live = (a->dom[k->variables[j]] >> (code % 3U)) & 1U;
+        }
+        if (live) return true;
+    }
+
+    rtka_state_t local[AC_MAX_ARITY];
+    uint8_t digit[AC_MAX_ARITY];
+    rtka_state_t* vals = arity <= AC_MAX_ARITY ? local : (rtka_state_t*)malloc(arity * sizeof(rtka_state_t));
+    uint8_t* idx = arity <= AC_MAX_ARITY ? digit : (uint8_t*)malloc(arity);
+    bool found = false;
+    if (!vals || !idx) {
+        found = true;               /* No scratch: keep the value rather than prune wrongly */
+        goto done;
+    }
+
+    /* Start every position at its lowest live value */
+    for (uint32_t j = 0; j < arity; j++) {
+        rtka_domain_t d = j == pos ? (rtka_domain_t)(1U << want) : a->dom[k->variables[j]];
+        if (!d) goto done;
+        idx[j] = (uint8_t)__builtin_ctz(d);
+        vals[j] = rtka_make_state(dom_value(idx[j]), 1.0f);
+    }
+    for (;;) {
+        if (scope_holds(k, vals)) {
+            found = true;
+            if (residue) {
+                uint32_t code = 0;
+                for (uint32_t j = arity; j > 0; j--) code = code * 3U + idx[j - 1];
+                *residue = code;
+            }
+            break;
+        }
+        /* Advance the odometer, skipping the fixed position */
+        uint32_t j = 0;
+        for (; j < arity; j++) {
+            if (j == pos) continue;
+            rtka_domain_t d = a->dom[k->variables[j]];
+            rtka_domain_t above = (rtka_domain_t)(d & ~((2U << idx[j]) - 1U));
+            if (above) {
+                idx[j] = (uint8_t)__builtin_ctz(above);
+                vals[j].value = dom_value(idx[j]);
+                break;
+            }
+            idx[j] = (uint8_t)__builtin_ctz(d);
+            vals[j].value = dom_value(idx[j]);
+        }
+        if (j == arity) break;
+    }
+
+done:
+    if (vals != local) free(vals);
+    if (idx != digit) free(idx);
+    return found;
+}
+
+/* Drain the queue; false on a wiped-out domain */
+static bool ac_propagate(ac_state_t* a) {
+    rtka_csp_t* csp = a->csp;
+    while (a->queue_count) {
+        uint32_t c = a->queue[a->queue_head];
+        a->queue_head = (a->queue_head + 1U) % csp->num_constraints;
+        a->queue_count--;
+        a->queued[c] = 0;
+
+        const rtka_constraint_t* k = csp->constraints[c];
+        if (k->num_vars == 0) {
+            if (scope_holds(k, NULL)) continue;
+            ac_queue_clear(a);
+            return false;
+        }
+        for (uint32_t pos = 0; pos < k->num_vars; pos++) {
+            uint32_t v = k->variables[pos];
+            rtka_domain_t d = a->dom[v], keep = d;
+            for (rtka_domain_t rest = d; rest; rest &= (rtka_domain_t)(rest - 1U)) {
+                uint32_t want = (uint32_t)__builtin_ctz(rest);
+                if (!ac_supported(a, c, pos, want)) keep &= (rtka_domain_t)~(1U << want);
+            }
+            if (keep == d) continue;
+            if (!keep) {
+                ac_queue_clear(a);
+                return false;
+            }
+            ac_narrow(a, v, keep);
+        }
+    }
+    return true;
+}
+
+/* Smallest open domain first, ties to the most constrained variable */
+static uint32_t ac_select(const ac_state_t* a) {
+    uint32_t best = UINT32_MAX, best_count = 4, best_degree = 0;
+    for (uint32_t v = 0; v < a->csp->num_variables; v++) {
+        uint32_t count = dom_count(a->dom[v]);
+        if (count < 2) continue;
+        uint32_t degree = a->var_start[v + 1] - a->var_start[v];
+        if (count < best_count || (count == best_count && degree > best_degree)) {
+            best = v;
+            best_count = count;
+            best_degree = degree;
+        }
+    }
+    return best;
+}
+
+static bool ac_search(ac_state_t* a, uint32_t depth) {
+    if (a->stop && atomic_load_explicit(a->stop, memory_order_relaxed)) return true;
+    g_stats.nodes_explored++;
+    uint32_t v = ac_select(a);
+    if (v == UINT32_MAX || depth == a->split_depth) return a->visit ? a->visit(a) : true;
+
+    static const uint32_t order[3] = {2, 0, 1};   /* TRUE, FALSE, UNKNOWN as in backtrack() */
+    rtka_domain_t d = a->dom[v];
+    for (uint32_t i = 0; i < 3; i++) {
+        if (!((d >> order[i]) & 1U)) continue;
+        uint32_t save_point = a->trail_size;
+        ac_narrow(a, v, (rtka_domain_t)(1U << order[i]));
+        if (ac_propagate(a) && ac_search(a, depth + 1U)) return true;
+        ac_undo(a, save_point);
+        g_stats.backtracks++;
+    }
+    return false;
+}
+
+static void ac_free(ac_state_t* a) {
+    free(a->dom);
+    free(a->var_start);
+    free(a->var_cons);
+    free(a->residue_start);
+    free(a->residues);
+    free(a->queue);
+    free(a->queued);
+    free(a->trail);
+}
+
+/* Starting domains: csp->domains when given, else the singleton of a
+ * definite variable and TRUE | FALSE for an UNKNOWN one */
+static bool ac_init(ac_state_t* a, rtka_csp_t* csp) {
+    uint32_t nv = csp->num_variables, nc = csp->num_constraints;
+    memset(a, 0, sizeof(*a));
+    a->csp = csp;
+    a->split_depth = UINT32_MAX;
+    if (nc && !csp->constraints) return false;
+
+    size_t residue_count = 0;
+    for (uint32_t c = 0; c < nc; c++) {
+        if (csp->constraints[c]->num_vars <= AC_MAX_ARITY) residue_count += 3U * csp->constraints[c]->num_vars;
+    }
+    a->dom = (rtka_domain_t*)malloc((nv ? nv : 1U) * sizeof(rtka_domain_t));
+    a->residue_start = (uint32_t*)malloc((nc ? nc : 1U) * sizeof(uint32_t));
+    a->residues = (uint32_t*)malloc((residue_count ? residue_count : 1U) * sizeof(uint32_t));
+    a->queue = (uint32_t*)malloc((nc ? nc : 1U) * sizeof(uint32_t));
+    a->queued = (uint8_t*)calloc(nc ? nc : 1U, 1);
+    a->trail = (ac_trail_t*)malloc(((size_t)nv * 3U + 1U) * sizeof(ac_trail_t));
+    if (!build_var_index(csp, &a->var_start, &a->var_cons) || !a->dom || !a->residue_start ||
+        !a->residues || !a->queue || !a->queued || !a->trail || residue_count > UINT32_MAX) {
+        ac_free(a);
+        return false;
+    }
+
+    for (uint32_t v = 0; v < nv; v++) {
+        rtka_value_t value = csp->variables[v].value;
+        a->dom[v] = csp->domains ? (rtka_domain_t)(csp->domains[v] & RTKA_DOMAIN_ALL)
+                  : value == RTKA_UNKNOWN ? (rtka_domain_t)(RTKA_DOMAIN_FALSE | RTKA_DOMAIN_TRUE)
+                  : (rtka_domain_t)(1U << dom_index(value));
+    }
+    uint32_t offset = 0;
+    for (uint32_t c = 0; c < nc; c++) {
+        a->residue_start[c] = offset;
+        if (csp->constraints[c]->num_vars <= AC_MAX_ARITY) offset += 3U * csp->constraints[c]->num_vars;
+        ac_enqueue(a, c);
+    }
+    memset(a->residues, 0xFF, (residue_count ? residue_count : 1U) * sizeof(uint32_t));
+    return true;
+}
+
+/* Singleton domains become definite values; csp->domains follows the masks */
+static void write_domains(rtka_csp_t* csp, const rtka_domain_t* dom) {
+    for (uint32_t v = 0; v < csp->num_variables; v++) {
+        if (csp->domains) csp->domains[v] = dom[v];
+        if (dom_count(dom[v]) == 1) {
+            csp->variables[v] = rtka_make_state(dom_value((uint32_t)__builtin_ctz(dom[v])), 1.0f);
+        }
+    }
+}
+
+static void write_states(rtka_state_t* out, const rtka_domain_t* dom, uint32_t nv) {
+    for (uint32_t v = 0; v < nv; v++) {
+        out[v] = rtka_make_state(dom_value((uint32_t)__builtin_ctz(dom[v])), 1.0f);
+    }
+}
+
+bool rtka_solver_arc_consistency(rtka_csp_t* csp) {
+    if (!csp) return false;
+    ac_state_t a;
+    if (!ac_init(&a, csp)) return false;
+    bool ok = ac_propagate(&a);
+    for (uint32_t v = 0; ok && v < csp->num_variables; v++) ok = a.dom[v] != 0;
+    if (ok) write_domains(csp, a.dom);
+    ac_free(&a);
+    return ok;
+}
+
+static bool ac_root(ac_state_t* a) {
+    for (uint32_t v = 0; v < a->csp->num_variables; v++) {
+        if (!a->dom[v]) return false;
+    }
+    return ac_propagate(a);
+}
+
+static bool ac_solve(rtka_csp_t* csp) {
+    ac_state_t a;
+    if (!ac_init(&a, csp)) return false;
+    bool ok = ac_root(&a) && ac_search(&a, 0);
+    if (ok) write_domains(csp, a.dom);
+    ac_free(&a);
+    return ok;
+}
+
+typedef struct {
+    rtka_state_t** solutions;
+    uint32_t max_solutions;
+    uint32_t count;
+} ac_collect_t;
+
+static bool ac_collect(ac_state_t* a) {
+    ac_collect_t* c = (ac_collect_t*)a->ctx;
+    if (c->solutions && c->count < c->max_solutions) {
+        write_states(c->solutions[c->count], a->dom, a->csp->num_variables);
+    }
+    c->count++;
+    return c->max_solutions && c->count >= c->max_solutions;
+}
+
+uint32_t rtka_solver_find_all_solutions(rtka_csp_t* csp, rtka_state_t** solutions, uint32_t max_solutions) {
+    memset(&g_stats, 0, sizeof(g_stats));
+    ac_state_t a;
+    if (!csp || (solutions && !max_solutions) || !ac_init(&a, csp)) return 0;
+    ac_collect_t collect = {solutions, max_solutions, 0};
+    a.visit = ac_collect;
+    a.ctx = &collect;
+    if (ac_root(&a)) (void)ac_search(&a, 0);
+    ac_free(&a);
+    return collect.count;
+}
+
+/* ============================================================================
+ * PARALLEL SEARCH
+ *
+ * The tree is expanded to split_depth on the calling thread. Every open
+ * node there is saved as a full set of domain masks, already arc
+ * consistent. The subtree list goes to the pool as one range task that
+ * keeps splitting in halves on the running worker's deque, so idle workers
+ * steal the largest untouched runs of subtrees. Each participant keeps its own ac_state_t (index, residues, trail)
+ * for the whole job and its own statistics, and those are summed into the
+ * caller's at the end.
+ * ============================================================================ */
+
+#define PAR_SUBTREES_PER_THREAD  16U
+
+typedef struct {
+    rtka_csp_t* csp;
+    uint32_t nv;
+
+    rtka_domain_t* subtrees;         /* nv masks per subtree */
+    uint32_t num_subtrees;
+    uint32_t subtree_capacity;
+    bool split_failed;
+    atomic_bool setup_failed;
+
+    ac_state_t* workers;             /* Per participant, set up on first use */
+    bool* worker_ready;
+    rtka_solver_stats_t* worker_stats;
+
+    /* Results */
+    atomic_bool stop;
+    atomic_uint found;               /* Solutions claimed so far */
+    rtka_domain_t* first;            /* Solve: winning leaf */
+    rtka_state_t** solutions;        /* Find all */
+    uint32_t max_solutions;          /* 0 = unbounded */
+} par_job_t;
+
+static bool par_record_subtree(ac_state_t* a) {
+    par_job_t* job = (par_job_t*)a->ctx;
+    if (job->num_subtrees == job->subtree_capacity) {
+        uint32_t capacity = job->subtree_capacity ? job->subtree_capacity * 2U : 64U;
+        rtka_domain_t* grown = (rtka_domain_t*)realloc(job->subtrees, (size_t)capacity * job->nv);
+        if (!grown) {
+            job->split_failed = true;
+            return true;
+        }
+        job->subtrees = grown;
+        job->subtree_capacity = capacity;
+    }
+    memcpy(job->subtrees + (size_t)job->num_subtrees++ * job->nv, a->dom, job->nv);
+    return false;
+}
+
+static bool par_first(ac_state_t* a) {
+    par_job_t* job = (par_job_t*)a->ctx;
+    unsigned expected = 0;
+    if (atomic_compare_exchange_strong(&job->found, &expected, 1U)) {
+        memcpy(job->first, a->dom, job->nv);
+        atomic_store(&job->stop, true);
+    }
+    return true;
+}
+
+static bool par_collect(ac_state_t* a) {
+    par_job_t* job = (par_job_t*)a->ctx;
+    uint32_t slot = atomic_fetch_add(&job->found, 1U);
+    if (job->max_solutions && slot >= job->max_solutions) {
+        atomic_store(&job->stop, true);
+        return true;
+    }
+    if (job->solutions) write_states(job->solutions[slot], a->dom, job->nv);
+    if (job->max_solutions && slot + 1U == job->max_solutions) {
+        atomic_store(&job->stop, true);
+        return true;
+    }
+    return false;
+}
+
+static void par_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    par_job_t* job = (par_job_t*)ctx;
+    ac_state_t* a = &job->workers[worker];
+    if (!job->worker_ready[worker]) {
+        if (!ac_init(a, job->csp)) {
+            /* Fail the job rather than report these subtrees empty */
+            atomic_store(&job->setup_failed, true);
+            atomic_store(&job->stop, true);
+            return;
+        }
+        a->visit = job->first ? par_first : par_collect;
+        a->ctx = job;
+        a->stop = &job->stop;
+        job->worker_ready[worker] = true;
+    }
+
+    rtka_solver_stats_t saved = g_stats;
+    memset(&g_stats, 0, sizeof(g_stats));
+    for (uint32_t i = begin; i < end && !atomic_load_explicit(&job->stop, memory_order_relaxed); i++) {
+        memcpy(a->dom, job->subtrees + (size_t)i * job->nv, job->nv);
+        a->trail_size = 0;
+        (void)ac_search(a, 0);
+    }
+    rtka_solver_stats_add(&job->worker_stats[worker], &g_stats);
+    g_stats = saved;
+}
+
+/* Split, run the subtrees, merge statistics; returns false when setup failed */
+static bool par_run(par_job_t* job, uint32_t split_depth, rtka_thread_pool_t* pool) {
+    if (!pool) pool = rtka_pool_default();
+    uint32_t threads = pool ? rtka_pool_size(pool) + 1U : 1U;
+    if (split_depth == 0) {
+        while ((1ULL << split_depth) < (uint64_t)threads * PAR_SUBTREES_PER_THREAD) split_depth++;
+    }
+
+    ac_state_t root;
+    if (!ac_init(&root, job->csp)) return false;
+    root.visit = par_record_subtree;
+    root.ctx = job;
+    root.split_depth = split_depth;
+    if (ac_root(&root)) (void)ac_search(&root, 0);
+    ac_free(&root);
+    if (job->split_failed) return false;
+
+    job->workers = (ac_state_t*)calloc(threads, sizeof(ac_state_t));
+    job->worker_ready = (bool*)calloc(threads, sizeof(bool));
+    job->worker_stats = (rtka_solver_stats_t*)calloc(threads, sizeof(rtka_solver_stats_t));
+    bool ok = job->workers && job->worker_ready && job->worker_stats;
+    if (ok && pool) {
+        rtka_task_group_t group;
+        rtka_task_group_init(&group);
+        if (rtka_pool_spawn_range(pool, &group, 0, job->num_subtrees, 1, par_range, job) == RTKA_SUCCESS) {
+            rtka_pool_wait_group(pool, &group);
+        } else {
+            par_range(job, 0, job->num_subtrees, rtka_pool_worker_index(pool));
+        }
+    } else if (ok) {
+        par_range(job, 0, job->num_subtrees, 0U);
+    }
+
+    for (uint32_t w = 0; ok && w < threads; w++) {
+        rtka_solver_stats_add(&g_stats, &job->worker_stats[w]);
+        if (job->worker_ready[w]) ac_free(&job->workers[w]);
+    }
+    free(job->workers);
+    free(job->worker_ready);
+    free(job->worker_stats);
+    free(job->subtrees);
+    return ok && !atomic_load(&job->setup_failed);
+}
+
+bool rtka_solver_solve_parallel(rtka_csp_t* csp, uint32_t split_depth, rtka_thread_pool_t* pool) {
+    memset(&g_stats, 0, sizeof(g_stats));
+    if (!csp) return false;
+    clock_t start = clock();
+    par_job_t job = {.csp = csp, .nv = csp->num_variables};
+    job.first = (rtka_domain_t*)malloc(csp->num_variables ? csp->num_variables : 1U);
+    atomic_init(&job.stop, false);
+    atomic_init(&job.setup_failed, false);
+    atomic_init(&job.found, 0U);
+    bool ok = job.first && par_run(&job, split_depth, pool) && atomic_load(&job.found);
+    if (ok) write_domains(csp, job.first);
+    free(job.first);
+    g_stats.solve_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return ok;
+}
+
+uint32_t rtka_solver_find_all_parallel(rtka_csp_t* csp, rtka_state_t** solutions, uint32_t max_solutions,
+                                       uint32_t split_depth, rtka_thread_pool_t* pool) {
+    memset(&g_stats, 0, sizeof(g_stats));
+    if (!csp || (solutions && !max_solutions)) return 0;
+    clock_t start = clock();
+    par_job_t job = {.csp = csp, .nv = csp->num_variables, .solutions = solutions, .max_solutions = max_solutions};
+    atomic_init(&job.stop, false);
+    atomic_init(&job.setup_failed, false);
+    atomic_init(&job.found, 0U);
+    uint32_t count = 0;
+    if (par_run(&job, split_depth, pool)) {
+        count = atomic_load(&job.found);
+        if (max_solutions && count > max_solutions) count = max_solutions;
+    }
+    g_stats.solve_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return count;
+}
+
+void rtka_solver_stats_add(rtka_solver_stats_t* total, const rtka_solver_stats_t* part) {
+    total->nodes_explored += part->nodes_explored;
+    total->backtracks += part->backtracks;
+    total->constraint_checks += part->constraint_checks;
+    total->ternary_transitions += part->ternary_transitions;
+    total->solve_time += part->solve_time;
+}
+
+/* ============================================================================
+ * MIN-CONFLICTS
+ * ============================================================================ */
+
+#define MC_NOISE            0.1     /* Probability of a random flip */
+#define MC_STEPS_PER_VAR    100U
+#define MC_RESTARTS         8U
+
+typedef struct {
+    rtka_csp_t* csp;
+    uint32_t* var_start;            /* CSR: constraints of variable v are */
+    uint32_t* var_cons;             /* var_cons[var_start[v] .. var_start[v + 1]) */
+    uint32_t* violated;             /* Violated constraint ids */
+    uint32_t* position;             /* Index in violated, UINT32_MAX if satisfied */
+    uint32_t num_violated;
+    rtka_rng_t rng;
+} mc_state_t;
+
+static inline uint32_t mc_below(mc_state_t* m, uint32_t bound) {
+    return (uint32_t)(((uint64_t)rtka_random_uint32(&m->rng) * bound) >> 32);
+}
+
+static void mc_mark(mc_state_t* m, uint32_t c, bool satisfied) {
+    if (satisfied && m->position[c] != UINT32_MAX) {
+        uint32_t last = m->violated[--m->num_violated];
+        m->violated[m->position[c]] = last;
+        m->position[last] = m->position[c];
+        m->position[c] = UINT32_MAX;
+    } else if (!satisfied && m->position[c] == UINT32_MAX) {
+        m->position[c] = m->num_violated;
+        m->violated[m->num_violated++] = c;
+    }
+}
+
+/* Constraints of v that the flip would leave violated, minus those violated now */
+static int32_t mc_flip_delta(mc_state_t* m, uint32_t v) {
+    rtka_csp_t* csp = m->csp;
+    int32_t delta = 0;
+    rtka_value_t current = csp->variables[v].value;
+    for (uint32_t k = m->var_start[v]; k < m->var_start[v + 1]; k++) {
+        delta -= m->position[m->var_cons[k]] != UINT32_MAX;
+    }
+    csp->variables[v].value = (rtka_value_t)-current;
+    for (uint32_t k = m->var_start[v]; k < m->var_start[v + 1]; k++) {
+        delta += !check_constraint(csp->constraints[m->var_cons[k]], csp->variables);
+    }
+    csp->variables[v].value = current;
+    return delta;
+}
+
+static void mc_flip(mc_state_t* m, uint32_t v) {
+    rtka_csp_t* csp = m->csp;
+    csp->variables[v].value = (rtka_value_t)-csp->variables[v].value;
+    g_stats.ternary_transitions++;
+    for (uint32_t k = m->var_start[v]; k < m->var_start[v + 1]; k++) {
+        uint32_t c = m->var_cons[k];
+        mc_mark(m, c, check_constraint(csp->constraints[c], csp->variables));
+    }
+}
+
+/* Starting assignment: definite values kept with probability = confidence */
+static void mc_assign(mc_state_t* m, const rtka_state_t* start) {
+    rtka_csp_t* csp = m->csp;
+    for (uint32_t v = 0; v < csp->num_variables; v++) {
+        rtka_state_t s = start[v];
+        bool keep = s.value != RTKA_UNKNOWN && rtka_random_double(&m->rng) < (double)s.confidence;
+        csp->variables[v].value = keep ? s.value : ((rtka_random_uint32(&m->rng) & 1U) ? RTKA_TRUE : RTKA_FALSE);
+        csp->variables[v].confidence = s.value != RTKA_UNKNOWN ? s.confidence : 0.5f;
+    }
+    m->num_violated = 0;
+    for (uint32_t c = 0; c < csp->num_constraints; c++) {
+        m->position[c] = UINT32_MAX;
+        mc_mark(m, c, check_constraint(csp->constraints[c], csp->variables));
+    }
+}
+
+bool rtka_solver_min_conflicts(rtka_csp_t* csp, uint64_t max_steps, uint64_t seed) {
+    if (!csp || (csp->num_constraints && !csp->constraints)) return false;
+    uint32_t nv = csp->num_variables, nc = csp->num_constraints;
+    if (max_steps == 0) max_steps = (uint64_t)MC_STEPS_PER_VAR * (nv ? nv : 1U);
+
+    mc_state_t m = {.csp = csp};
+    m.violated = (uint32_t*)malloc((nc ? nc : 1U) * sizeof(uint32_t));
+    m.position = (uint32_t*)malloc((nc ? nc : 1U) * sizeof(uint32_t));
+    rtka_state_t* start = (rtka_state_t*)malloc((nv ? nv : 1U) * sizeof(rtka_state_t));
+    bool solved = false;
+    if (!build_var_index(csp, &m.var_start, &m.var_cons) || !m.violated || !m.position || !start) goto done;
+
+    memcpy(start, csp->variables, (size_t)nv * sizeof(rtka_state_t));
+    rtka_random_init_splitmix(&m.rng, seed);
+    uint64_t per_restart = max_steps / MC_RESTARTS + 1U;
+
+    for (uint32_t restart = 0; restart < MC_RESTARTS && !solved; restart++) {
+        if (restart) g_stats.backtracks++;
+        mc_assign(&m, start);
+        for (uint64_t step = 0; step < per_restart && m.num_violated; step++) {
+            g_stats.nodes_explored++;
+            const rtka_constraint_t* c = csp->constraints[m.violated[mc_below(&m, m.num_violated)]];
+            if (c->num_vars == 0) break;
+            uint32_t pick = c->variables[mc_below(&m, c->num_vars)];
+            if (rtka_random_double(&m.rng) >= MC_NOISE) {
+                int32_t best = INT32_MAX;
+                for (uint32_t j = 0; j < c->num_vars; j++) {
+                    uint32_t v = c->variables[j];
+                    int32_t d = mc_flip_delta(&m, v);
+                    if (d < best || (d == best &&
+                                     csp->variables[v].confidence < csp->variables[pick].confidence)) {
+                        best = d;
+                        pick = v;
+                    }
+                }
+            }
+            mc_flip(&m, pick);
+            /* A flipped variable loses its starting certainty */
+            csp->variables[pick].confidence = 0.5f;
+        }
+        solved = m.num_violated == 0;
+    }
+    if (solved) {
+        for (uint32_t v = 0; v < nv; v++) csp->variables[v].confidence = 1.0f;
+    }
+
+done:
+    free(m.var_start);
+    free(m.var_cons);
+    free(m.violated);
+    free(m.position);
+    free(start);
+    return solved;
+}
+
 /* Main solve function */
 bool rtka_solver_solve(rtka_csp_t* csp, rtka_search_strategy_t strategy) {
     memset(&g_stats, 0, sizeof(g_stats));
     
     clock_t start = clock();
-    bool result = backtrack(csp, 0, strategy);
+    bool result = strategy == SEARCH_MIN_CONFLICTS ? rtka_solver_min_conflicts(csp, 0, (uint64_t)start)
+                : strategy == SEARCH_ARC_CONSISTENCY ? ac_solve(csp)
+                : backtrack(csp, 0, strategy);
     g_stats.solve_time = (double)(clock() - start) / CLOCKS_PER_SEC;
     
     return result;
@@ -337,7 +1061,7 @@ rtka_constraint_t* rtka_constraint_alldiff(uint32_t* vars, uint32_t count) {
     return constraint;
 }
 
-/* Get stats */
+/* Get stats of the calling thread */
 rtka_solver_stats_t* rtka_solver_get_stats(void) {
     return &g_stats;
 }
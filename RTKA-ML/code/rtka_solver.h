@@ -9,6 +9,25 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Generic Constraint Satisfaction Framework
+ *
+ * CHANGELOG:
+ * v1.1.0 - SEARCH_MIN_CONFLICTS: local search over complete TRUE / FALSE
+ *          assignments for problems too large to backtrack. Definite
+ *          starting values are kept with probability equal to their
+ *          confidence, and among the variables of a violated constraint
+ *          the least confident one wins ties.
+ * v1.2.0 - SEARCH_ARC_CONSISTENCY: domains as 3-bit masks with a trail of
+ *          changed masks, so backtracking undoes only what a branch
+ *          narrowed. Queue-driven generalized arc consistency with a
+ *          cached supporting tuple per (constraint, variable, value).
+ * v1.3.0 - Parallel AC search: the tree is split at a given depth and the
+ *          subtrees handed out one at a time to the pool's workers, each
+ *          with its own trail, residues and statistics. Statistics are
+ *          per thread and the workers' are summed into the caller's.
+ *          rtka_solver_find_all_solutions returns the solution count.
+ * v1.3.1 - Parallel AC subtrees run on the pool's work-stealing deques as
+ *          a range task split in halves, so idle workers steal the largest
+ *          runs left.
  */
 
 #ifndef RTKA_SOLVER_H
@@ -16,6 +35,7 @@
 
 #include "rtka_types.h"
 #include "rtka_u_core.h"
+#include "rtka_threadpool.h"
 
 /* Constraint types */
 typedef enum {
@@ -35,6 +55,14 @@ typedef struct {
     void* data;
 } rtka_constraint_t;
 
+/* Domain bitset: bit (value + 1) set while the value is still possible */
+typedef uint8_t rtka_domain_t;
+
+#define RTKA_DOMAIN_FALSE   0x1U
+#define RTKA_DOMAIN_UNKNOWN 0x2U
+#define RTKA_DOMAIN_TRUE    0x4U
+#define RTKA_DOMAIN_ALL     0x7U
+
 /* CSP problem */
 typedef struct {
     rtka_state_t* variables;
@@ -42,7 +70,8 @@ typedef struct {
     rtka_constraint_t** constraints;
     uint32_t num_constraints;
     uint32_t* domain_sizes;
-    rtka_value_t** domains;
+    rtka_domain_t* domains;           /* Optional; NULL: TRUE | FALSE for UNKNOWN variables,
+                                       * the value itself for definite ones */
 } rtka_csp_t;
 
 /* Search strategies */
@@ -50,7 +79,8 @@ typedef enum {
     SEARCH_BACKTRACK,
     SEARCH_FORWARD_CHECK,
     SEARCH_ARC_CONSISTENCY,
-    SEARCH_TERNARY_PROPAGATE
+    SEARCH_TERNARY_PROPAGATE,
+    SEARCH_MIN_CONFLICTS
 } rtka_search_strategy_t;
 
 /* CSP creation */
@@ -60,9 +90,32 @@ void rtka_solver_free_csp(rtka_csp_t* csp);
 
 /* Solving */
 bool rtka_solver_solve(rtka_csp_t* csp, rtka_search_strategy_t strategy);
-bool rtka_solver_find_all_solutions(rtka_csp_t* csp, rtka_state_t** solutions, uint32_t max_solutions);
+/* Min-conflicts from the current assignment: a violated constraint is
+ * picked at random and one of its variables flipped to the value breaking
+ * the fewest constraints (a random one of them with 10% probability).
+ * max_steps = 0 uses 100 flips per variable; stats count flips as
+ * nodes_explored and restarts as backtracks. A solution is left in
+ * csp->variables with confidence 1. */
+bool rtka_solver_min_conflicts(rtka_csp_t* csp, uint64_t max_steps, uint64_t seed);
+/* Every solution by AC search, up to max_solutions copied to solutions[i]
+ * (num_variables states each). With solutions NULL the search only counts,
+ * and max_solutions = 0 counts them all.
+ * Returns the number found; csp->variables is left untouched. */
+uint32_t rtka_solver_find_all_solutions(rtka_csp_t* csp, rtka_state_t** solutions, uint32_t max_solutions);
+
+/* Parallel AC search on pool (NULL = rtka_pool_default()): split_depth
+ * levels are expanded on the caller (0 = enough for 16 subtrees per
+ * participant) and the subtrees shared among the workers. Check functions
+ * must be thread-safe. solve_parallel writes the first solution any
+ * worker finds; find_all_parallel fills solutions in the order they are
+ * found. Statistics cover the split and every worker. */
+bool rtka_solver_solve_parallel(rtka_csp_t* csp, uint32_t split_depth, rtka_thread_pool_t* pool);
+uint32_t rtka_solver_find_all_parallel(rtka_csp_t* csp, rtka_state_t** solutions, uint32_t max_solutions,
+                                       uint32_t split_depth, rtka_thread_pool_t* pool);
 
-/* Constraint propagation */
+/* Constraint propagation. Arc consistency from csp->domains (or the
+ * defaults above): narrowed masks are written back when domains is set and
+ * singletons become definite values. false on a wiped-out domain. */
 bool rtka_solver_arc_consistency(rtka_csp_t* csp);
 bool rtka_solver_propagate_ternary(rtka_csp_t* csp);
 
@@ -86,6 +139,8 @@ typedef struct {
     double solve_time;
 } rtka_solver_stats_t;
 
+/* Statistics of the last solve on the calling thread */
 rtka_solver_stats_t* rtka_solver_get_stats(void);
+void rtka_solver_stats_add(rtka_solver_stats_t* total, const rtka_solver_stats_t* part);
 
 #endif /* RTKA_SOLVER_H */
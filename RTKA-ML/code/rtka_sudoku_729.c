@@ -14,9 +14,13 @@
  */
 
 #include "rtka_sudoku_729.h"
+#include "rtka_trace.h"
+#include "rtka_perf.h"
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 /* ============================================================================
  * PEER CALCULATION
@@ -368,7 +372,11 @@ uint32_t rtka_find_best_guess(sudoku_729_t* puzzle) {
     return best_cell;
 }
 
-bool rtka_solve_recursive(sudoku_729_t* puzzle) {
+/* depth counts the guesses above this call */
+static bool solve_recursive(sudoku_729_t* puzzle, uint32_t depth) {
+    RTKA_PERF_COUNT(RTKA_PERF_SUDOKU_NODES, 1);
+    RTKA_PERF_DEPTH(depth);
+
     /* Try constraint propagation first */
     if (rtka_propagate_constraints(puzzle)) {
         return true;  /* Solved! */
@@ -403,13 +411,15 @@ bool rtka_solve_recursive(sudoku_729_t* puzzle) {
         
         /* Try placing this digit */
         if (rtka_place_digit(puzzle, guess_cell, digit)) {
-            if (rtka_solve_recursive(puzzle)) {
+            if (solve_recursive(puzzle, depth + 1U)) {
                 free(backup);
                 return true;  /* Solution found! */
             }
         }
         
         /* Backtrack - restore complete state */
+        rtka_trace_instant(RTKA_TRACE_SUDOKU_BACKTRACK, guess_cell);
+        RTKA_PERF_COUNT(RTKA_PERF_SUDOKU_BACKTRACKS, 1);
         memcpy(puzzle, backup, sizeof(sudoku_729_t));
         free(backup);
     }
@@ -417,6 +427,13 @@ bool rtka_solve_recursive(sudoku_729_t* puzzle) {
     return false;  /* No solution */
 }
 
+bool rtka_solve_recursive(sudoku_729_t* puzzle) {
+    RTKA_PERF_TIMER_BEGIN(solve_timer, RTKA_PERF_TIMER_SUDOKU_SOLVE);
+    bool solved = solve_recursive(puzzle, 0U);
+    RTKA_PERF_TIMER_END(solve_timer);
+    return solved;
+}
+
 /* ============================================================================
  * RTKA CONSTRAINT COMBINATION
  * ============================================================================ */
@@ -543,3 +560,356 @@ bool rtka_validate_solution(sudoku_729_t* puzzle) {
     
     return true;
 }
+
+/* ============================================================================
+ * BITBOARD MODE
+ * ============================================================================ */
+
+#define BITS_ALL        0x1FFU
+#define BITS_OPEN       0xFFU
+#define BATCH_LINE      81U
+#define BATCH_GRAIN     256U
+
+/* Cells of unit u in row order: rows 0-8, columns 9-17, boxes 18-26 */
+static const uint8_t unit_cells[27][9] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8},
+    { 9, 10, 11, 12, 13, 14, 15, 16, 17},
+    {18, 19, 20, 21, 22, 23, 24, 25, 26},
+    {27, 28, 29, 30, 31, 32, 33, 34, 35},
+    {36, 37, 38, 39, 40, 41, 42, 43, 44},
+    {45, 46, 47, 48, 49, 50, 51, 52, 53},
+    {54, 55, 56, 57, 58, 59, 60, 61, 62},
+    {63, 64, 65, 66, 67, 68, 69, 70, 71},
+    {72, 73, 74, 75, 76, 77, 78, 79, 80},
+    { 0,  9, 18, 27, 36, 45, 54, 63, 72},
+    { 1, 10, 19, 28, 37, 46, 55, 64, 73},
+    { 2, 11, 20, 29, 38, 47, 56, 65, 74},
+    { 3, 12, 21, 30, 39, 48, 57, 66, 75},
+    { 4, 13, 22, 31, 40, 49, 58, 67, 76},
+    { 5, 14, 23, 32, 41, 50, 59, 68, 77},
+    { 6, 15, 24, 33, 42, 51, 60, 69, 78},
+    { 7, 16, 25, 34, 43, 52, 61, 70, 79},
+    { 8, 17, 26, 35, 44, 53, 62, 71, 80},
+    { 0,  1,  2,  9, 10, 11, 18, 19, 20},
+    { 3,  4,  5, 12, 13, 14, 21, 22, 23},
+    { 6,  7,  8, 15, 16, 17, 24, 25, 26},
+    {27, 28, 29, 36, 37, 38, 45, 46, 47},
+    {30, 31, 32, 39, 40, 41, 48, 49, 50},
+    {33, 34, 35, 42, 43, 44, 51, 52, 53},
+    {54, 55, 56, 63, 64, 65, 72, 73, 74},
+    {57, 58, 59, 66, 67, 68, 75, 76, 77},
+    {60, 61, 62, 69, 70, 71, 78, 79, 80},
+};
+
+static inline uint16_t unit_used(const sudoku_bits_t* b, uint32_t u) {
+    return u < 9 ? b->row_used[u] : (u < 18 ? b->col_used[u - 9] : b->box_used[u - 18]);
+}
+
+/* Place and strike the digit from the 20 peers, chaining into any peer left
+ * with a single candidate; false on a peer left empty */
+static bool bits_place(sudoku_bits_t* b, uint32_t cell, uint32_t digit) {
+    uint16_t bit = (uint16_t)(1U << digit);
+    uint32_t row = cell / 9, col = cell % 9, box = get_box(row, col);
+    if (!(b->possible[cell] & bit) ||
+        ((b->row_used[row] | b->col_used[col] | b->box_used[box]) & bit)) {
+        return false;
+    }
+
+    b->solution[cell] = (uint8_t)digit;
+    b->possible[cell] = bit;
+    b->filled_count++;
+    b->row_used[row] |= bit;
+    b->col_used[col] |= bit;
+    b->box_used[box] |= bit;
+
+    const uint8_t* units[3] = {unit_cells[row], unit_cells[9 + col], unit_cells[18 + box]};
+    for (uint32_t k = 0; k < 3; k++) {
+        for (uint32_t i = 0; i < 9; i++) {
+            uint32_t peer = units[k][i];
+            if (b->solution[peer] != BITS_OPEN || !(b->possible[peer] & bit)) continue;
+            uint16_t left = b->possible[peer] &= (uint16_t)~bit;
+            if (!left) return false;
+            if (!(left & (left - 1U)) && !bits_place(b, peer, (uint32_t)__builtin_ctz(left))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Hidden singles of one unit: digits with exactly one candidate cell, found
+ * by accumulating "seen once" / "seen twice" masks. A placed cell holds just
+ * its own digit, which no peer still has, so placed cells need no test. */
+static bool bits_hidden_singles(sudoku_bits_t* b, uint32_t u, bool* changed) {
+    const uint8_t* cells = unit_cells[u];
+    uint16_t once = 0, twice = 0;
+    for (uint32_t i = 0; i < 9; i++) {
+        twice |= once & b->possible[cells[i]];
+        once |= b->possible[cells[i]];
+    }
+    if (once != BITS_ALL) return false;                 /* A digit has nowhere to go */
+
+    uint16_t hidden = once & (uint16_t)~twice & (uint16_t)~unit_used(b, u);
+    while (hidden) {
+        uint32_t digit = (uint32_t)__builtin_ctz(hidden);
+        hidden &= (uint16_t)(hidden - 1U);
+        if (unit_used(b, u) & (1U << digit)) continue;  /* Placed by a chain */
+        uint32_t i = 0;
+        while (i < 9 && !(b->possible[cells[i]] & (1U << digit))) i++;
+        if (i == 9 || !bits_place(b, cells[i], digit)) return false;
+        *changed = true;
+    }
+    return true;
+}
+
+/* Two cells of a unit sharing the same two candidates own them */
+static bool bits_naked_pairs(sudoku_bits_t* b, uint32_t u, bool* changed) {
+    const uint8_t* cells = unit_cells[u];
+    for (uint32_t i = 0; i < 8; i++) {
+        uint16_t pair = b->possible[cells[i]];
+        if (count_bits(pair) != 2) continue;
+        for (uint32_t j = i + 1; j < 9; j++) {
+            if (b->possible[cells[j]] != pair) continue;
+            for (uint32_t k = 0; k < 9; k++) {
+                uint32_t other = cells[k];
+                if (k == i || k == j || !(b->possible[other] & pair)) continue;
+                uint16_t left = b->possible[other] &= (uint16_t)~pair;
+                if (!left) return false;
+                if (!(left & (left - 1U)) && !bits_place(b, other, (uint32_t)__builtin_ctz(left))) {
+                    return false;
+                }
+                *changed = true;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+/* Naked singles are chained by bits_place(); this runs hidden singles to a
+ * fixpoint and falls back to naked pairs when they stall */
+static bool bits_propagate(sudoku_bits_t* b) {
+    bool changed = true;
+    while (changed && b->filled_count < 81) {
+        changed = false;
+        for (uint32_t u = 0; u < 27; u++) {
+            if (!bits_hidden_singles(b, u, &changed)) return false;
+        }
+        if (changed) continue;
+        for (uint32_t u = 0; u < 27; u++) {
+            if (!bits_naked_pairs(b, u, &changed)) return false;
+        }
+    }
+    return true;
+}
+
+static bool bits_search(sudoku_bits_t* b, uint32_t* guesses) {
+    if (!bits_propagate(b)) return false;
+    if (b->filled_count == 81) return true;
+
+    uint32_t best = 81, fewest = 10;
+    for (uint32_t cell = 0; cell < 81 && fewest > 2; cell++) {
+        if (b->solution[cell] != BITS_OPEN) continue;
+        uint32_t n = (uint32_t)count_bits(b->possible[cell]);
+        if (n < fewest) {
+            fewest = n;
+            best = cell;
+        }
+    }
+
+    uint16_t candidates = b->possible[best];
+    while (candidates) {
+        uint32_t digit = (uint32_t)__builtin_ctz(candidates);
+        candidates &= (uint16_t)(candidates - 1U);
+        sudoku_bits_t snapshot = *b;
+        (*guesses)++;
+        if (bits_place(b, best, digit) && bits_search(b, guesses)) return true;
+        rtka_trace_instant(RTKA_TRACE_SUDOKU_BACKTRACK, best);
+        *b = snapshot;
+    }
+    return false;
+}
+
+bool rtka_sudoku_bits_init(sudoku_bits_t* board, const uint8_t cells[81]) {
+    memset(board, 0, sizeof(sudoku_bits_t));
+    for (uint32_t cell = 0; cell < 81; cell++) {
+        board->possible[cell] = BITS_ALL;
+        board->solution[cell] = BITS_OPEN;
+    }
+    for (uint32_t cell = 0; cell < 81; cell++) {
+        if (cells[cell] > 9) return false;
+        if (!cells[cell] || board->solution[cell] == cells[cell] - 1U) continue;
+        if (!bits_place(board, cell, cells[cell] - 1U)) return false;
+    }
+    return true;
+}
+
+bool rtka_sudoku_bits_solve(sudoku_bits_t* board) {
+    uint32_t guesses = 0;
+    bool solved = bits_search(board, &guesses);
+    board->guesses = guesses;
+    return solved;
+}
+
+void rtka_sudoku_bits_materialize(const sudoku_bits_t* board, sudoku_729_t* puzzle) {
+    memset(puzzle, 0, sizeof(sudoku_729_t));
+    memcpy(puzzle->possible, board->possible, sizeof(puzzle->possible));
+    memcpy(puzzle->row_used, board->row_used, sizeof(puzzle->row_used));
+    memcpy(puzzle->col_used, board->col_used, sizeof(puzzle->col_used));
+    memcpy(puzzle->box_used, board->box_used, sizeof(puzzle->box_used));
+    memcpy(puzzle->solution, board->solution, sizeof(puzzle->solution));
+    puzzle->filled_count = board->filled_count;
+
+    for (uint32_t cell = 0; cell < 81; cell++) {
+        bool filled = board->solution[cell] != BITS_OPEN;
+        uint32_t remaining = (uint32_t)count_bits(board->possible[cell]);
+        for (uint32_t d = 0; d < 9; d++) {
+            rtka_state_t* s = &puzzle->cell_digit[cell][d];
+            if (!bit_set(board->possible[cell], d)) {
+                *s = (rtka_state_t){.value = RTKA_FALSE, .confidence = 1.0f};
+            } else if (filled) {
+                *s = (rtka_state_t){.value = RTKA_TRUE, .confidence = 1.0f};
+            } else {
+                *s = (rtka_state_t){.value = RTKA_UNKNOWN, .confidence = 1.0f / (float)remaining};
+                puzzle->unknown_count++;
+            }
+        }
+        if (filled) {
+            puzzle->cell_confidence[cell] = 1.0f;
+        } else if (remaining < 9) {
+            puzzle->cell_confidence[cell] = 1.0f - 1.0f / (float)remaining;
+        }
+    }
+}
+
+typedef struct {
+    char* text;
+    const size_t* lines;
+    atomic_uint_fast64_t solved;
+    atomic_uint_fast64_t guesses;
+} sudoku_batch_t;
+
+static void batch_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    sudoku_batch_t* batch = (sudoku_batch_t*)ctx;
+    uint64_t solved = 0, guesses = 0;
+    for (uint32_t p = begin; p < end; p++) {
+        char* line = batch->text + batch->lines[p];
+        uint8_t cells[81];
+        for (uint32_t i = 0; i < 81; i++) {
+            cells[i] = (line[i] >= '1' && line[i] <= '9') ? (uint8_t)(line[i] - '0') : 0U;
+        }
+        sudoku_bits_t board;
+        if (!rtka_sudoku_bits_init(&board, cells)) continue;
+        bool ok = rtka_sudoku_bits_solve(&board);
+        guesses += board.guesses;
+        if (!ok) continue;
+        for (uint32_t i = 0; i < 81; i++) line[i] = (char)('1' + board.solution[i]);
+        solved++;
+    }
+    atomic_fetch_add_explicit(&batch->solved, solved, memory_order_relaxed);
+    atomic_fetch_add_explicit(&batch->guesses, guesses, memory_order_relaxed);
+}
+
+static bool batch_line_ok(const char* line, size_t length) {
+    if (length != BATCH_LINE) return false;
+    for (uint32_t i = 0; i < BATCH_LINE; i++) {
+        char c = line[i];
+        if (c != '.' && (c < '0' || c > '9')) return false;
+    }
+    return true;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+rtka_error_t rtka_sudoku_solve_batch(char* text, size_t length, rtka_thread_pool_t* pool,
+                                     sudoku_batch_stats_t* stats) {
+    if (!text && length) return RTKA_ERROR_NULL_POINTER;
+    double start = wall_seconds();
+
+    /* Offsets of the well-formed lines; a trailing '\r' is tolerated */
+    size_t count = 0, capacity = length / (BATCH_LINE + 1U) + 1U;
+    size_t* lines = (size_t*)malloc(capacity * sizeof(size_t));
+    if (!lines) return RTKA_ERROR_OUT_OF_MEMORY;
+    for (size_t pos = 0; pos < length;) {
+        const char* nl = (const char*)memchr(text + pos, '\n', length - pos);
+        size_t end = nl ? (size_t)(nl - text) : length;
+        size_t len = end - pos;
+        if (len > 0 && text[end - 1] == '\r') len--;
+        if (batch_line_ok(text + pos, len)) {
+            if (count == capacity) {
+                size_t* grown = (size_t*)realloc(lines, 2 * capacity * sizeof(size_t));
+                if (!grown) {
+                    free(lines);
+                    return RTKA_ERROR_OUT_OF_MEMORY;
+                }
+                lines = grown;
+                capacity *= 2;
+            }
+            lines[count++] = pos;
+        }
+        pos = end + 1;
+    }
+    if (count > UINT32_MAX) {
+        free(lines);
+        return RTKA_ERROR_OVERFLOW;
+    }
+
+    sudoku_batch_t batch = {.text = text, .lines = lines};
+    atomic_init(&batch.solved, 0);
+    atomic_init(&batch.guesses, 0);
+    if (!pool) pool = rtka_pool_default();
+    rtka_pool_parallel_for(pool, 0, (uint32_t)count, BATCH_GRAIN, batch_range, &batch);
+    free(lines);
+
+    if (stats) {
+        stats->puzzles = count;
+        stats->solved = atomic_load(&batch.solved);
+        stats->guesses = atomic_load(&batch.guesses);
+        stats->seconds = wall_seconds() - start;
+        stats->puzzles_per_sec = stats->seconds > 0.0 ? (double)count / stats->seconds : 0.0;
+    }
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_sudoku_solve_file(const char* in_path, const char* out_path,
+                                    rtka_thread_pool_t* pool, sudoku_batch_stats_t* stats) {
+    if (!in_path) return RTKA_ERROR_NULL_POINTER;
+    FILE* in = fopen(in_path, "rb");
+    if (!in) return RTKA_ERROR_INVALID_VALUE;
+
+    size_t capacity = 1U << 20, length = 0;
+    char* text = (char*)malloc(capacity);
+    while (text) {
+        length += fread(text + length, 1, capacity - length, in);
+        if (length < capacity) break;
+        char* grown = (char*)realloc(text, 2 * capacity);
+        if (!grown) {
+            free(text);
+            text = NULL;
+            break;
+        }
+        text = grown;
+        capacity *= 2;
+    }
+    bool read_error = ferror(in) != 0;
+    fclose(in);
+    if (!text) return RTKA_ERROR_OUT_OF_MEMORY;
+    if (read_error) {
+        free(text);
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    rtka_error_t err = rtka_sudoku_solve_batch(text, length, pool, stats);
+    if (err == RTKA_SUCCESS && out_path) {
+        FILE* out = fopen(out_path, "wb");
+        if (!out || fwrite(text, 1, length, out) != length) err = RTKA_ERROR_INVALID_VALUE;
+        if (out && fclose(out) != 0) err = RTKA_ERROR_INVALID_VALUE;
+    }
+    free(text);
+    return err;
+}
@@ -9,6 +9,15 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA 729-State Sudoku Solver
+ *
+ * CHANGELOG:
+ * v1.1.0 - Bitboard mode: sudoku_bits_t keeps only candidate and unit
+ *          masks, propagates naked / hidden singles and naked pairs with
+ *          bit operations, and backtracks by restoring a plain struct copy.
+ *          The 729 ternary states are materialized on demand. Batch solver
+ *          for 81-character puzzle lines across the thread pool.
+ * v1.1.1 - rtka_solve_recursive counts calls, backtracks and guess depth
+ *          and times each solve (rtka_perf.h, make perf)
  */
 
 #ifndef RTKA_SUDOKU_729_H
@@ -16,8 +25,10 @@
 
 #include "rtka_types.h"
 #include "rtka_u_core.h"
+#include "rtka_threadpool.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /* Peer list for constraint propagation */
 typedef struct {
@@ -78,4 +89,50 @@ static inline uint32_t get_box(uint32_t row, uint32_t col) {
 
 peer_list_t get_peers(uint32_t cell);
 
+/* ============================================================================
+ * BITBOARD MODE
+ * ============================================================================ */
+
+/* Whole search state in ~300 bytes; a struct copy is the backtrack snapshot */
+typedef struct {
+    uint16_t possible[81];            /* Candidates; the placed digit's bit once filled */
+    uint16_t row_used[9];
+    uint16_t col_used[9];
+    uint16_t box_used[9];
+    uint8_t solution[81];             /* 0-8, 0xFF while open */
+    uint32_t filled_count;
+    uint32_t guesses;                 /* Branches tried by the last solve */
+} sudoku_bits_t;
+
+/* Clues as 81 cells in row order, 0 for blank; false if they conflict */
+bool rtka_sudoku_bits_init(sudoku_bits_t* board, const uint8_t cells[81]);
+
+/* Singles and naked pairs to a fixpoint, then minimum-remaining-values
+ * branching; the filled board is left in place on success */
+bool rtka_sudoku_bits_solve(sudoku_bits_t* board);
+
+/* Ternary view of a bitboard for analysis and display: placed digits TRUE,
+ * eliminated FALSE, candidates UNKNOWN with confidence 1 / remaining */
+void rtka_sudoku_bits_materialize(const sudoku_bits_t* board, sudoku_729_t* puzzle);
+
+typedef struct {
+    uint64_t puzzles;                 /* Well-formed lines seen */
+    uint64_t solved;
+    uint64_t guesses;
+    double seconds;                   /* Wall clock */
+    double puzzles_per_sec;
+} sudoku_batch_stats_t;
+
+/**
+ * Solve every 81-character line of text in place ('1'-'9' clues, '0' or '.'
+ * blank; other lines are skipped) across pool (NULL = rtka_pool_default()).
+ * Unsolvable puzzles are left unchanged. stats may be NULL.
+ */
+RTKA_NODISCARD rtka_error_t rtka_sudoku_solve_batch(char* text, size_t length, rtka_thread_pool_t* pool,
+                                                    sudoku_batch_stats_t* stats);
+
+/* rtka_sudoku_solve_batch over a file; solved lines go to out_path unless NULL */
+RTKA_NODISCARD rtka_error_t rtka_sudoku_solve_file(const char* in_path, const char* out_path,
+                                                   rtka_thread_pool_t* pool, sudoku_batch_stats_t* stats);
+
 #endif /* RTKA_SUDOKU_729_H */
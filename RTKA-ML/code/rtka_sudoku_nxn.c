@@ -0,0 +1,359 @@
+/**
+ * File: rtka_sudoku_nxn.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA n²×n² Sudoku Implementation
+ */
+
+#include "rtka_sudoku_nxn.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NXN_SIDE(B)     ((B) * (B))
+#define NXN_CELLS(B)    (NXN_SIDE(B) * NXN_SIDE(B))
+#define NXN_PEERS(B)    (2U * (NXN_SIDE(B) - 1U) + ((B) - 1U) * ((B) - 1U))
+
+static inline sudoku_mask_t nxn_all(uint32_t side) {
+    return side >= 64U ? ~(sudoku_mask_t)0 : (((sudoku_mask_t)1 << side) - 1U);
+}
+
+static inline uint32_t nxn_box_of(uint32_t box, uint32_t row, uint32_t col) {
+    return (row / box) * box + col / box;
+}
+
+/* ============================================================================
+ * SIZE-GENERIC KERNELS - always inlined into the per-size entry points below
+ * so side, peer count and table strides are constants
+ * ============================================================================ */
+
+/* Set the digit and strike it from the peers, queueing peers left with a
+ * single candidate; false on a peer left empty. A placed peer holds only its
+ * own digit, which cannot be this one once the used-mask test passes. */
+static RTKA_INLINE bool nxn_place(sudoku_nxn_t* s, const uint32_t B, const uint16_t* peers,
+                                  uint32_t cell, uint32_t digit) {
+    const uint32_t side = NXN_SIDE(B);
+    sudoku_mask_t bit = (sudoku_mask_t)1 << digit;
+    uint32_t row = cell / side, col = cell % side, box = nxn_box_of(B, row, col);
+    sudoku_mask_t* used = s->used;
+    if (!(s->possible[cell] & bit) || ((used[row] | used[side + col] | used[2U * side + box]) & bit)) {
+        return false;
+    }
+
+    s->solution[cell] = (uint8_t)digit;
+    s->possible[cell] = bit;
+    s->filled_count++;
+    used[row] |= bit;
+    used[side + col] |= bit;
+    used[2U * side + box] |= bit;
+
+    const uint16_t* p = peers + (size_t)cell * NXN_PEERS(B);
+    for (uint32_t i = 0; i < NXN_PEERS(B); i++) {
+        sudoku_mask_t m = s->possible[p[i]];
+        if (!(m & bit)) continue;
+        m &= ~bit;
+        s->possible[p[i]] = m;
+        if (!m) return false;
+        if (!(m & (m - 1U))) s->pending[s->num_pending++] = p[i];
+    }
+    return true;
+}
+
+/* Naked singles: place queued cells until the queue is empty. A cell enters
+ * the queue once, when its last alternative goes. */
+static RTKA_INLINE bool nxn_drain(sudoku_nxn_t* s, const uint32_t B, const uint16_t* peers) {
+    while (s->num_pending) {
+        uint32_t cell = s->pending[--s->num_pending];
+        if (s->solution[cell] != SUDOKU_NXN_OPEN) continue;
+        if (!nxn_place(s, B, peers, cell, (uint32_t)__builtin_ctzll(s->possible[cell]))) return false;
+    }
+    return true;
+}
+
+/* Hidden singles of one unit from "seen once" / "seen twice" masks */
+static RTKA_INLINE bool nxn_hidden_singles(sudoku_nxn_t* s, const uint32_t B, const uint16_t* peers,
+                                           const uint16_t* cells, uint32_t u, bool* changed) {
+    const uint32_t side = NXN_SIDE(B);
+    sudoku_mask_t once = 0, twice = 0;
+    for (uint32_t i = 0; i < side; i++) {
+        twice |= once & s->possible[cells[i]];
+        once |= s->possible[cells[i]];
+    }
+    if (once != nxn_all(side)) return false;            /* A digit has nowhere to go */
+
+    sudoku_mask_t hidden = once & ~twice & ~s->used[u];
+    while (hidden) {
+        uint32_t digit = (uint32_t)__builtin_ctzll(hidden);
+        hidden &= hidden - 1U;
+        sudoku_mask_t bit = (sudoku_mask_t)1 << digit;
+        if (s->used[u] & bit) continue;                 /* Placed by a chain */
+        uint32_t i = 0;
+        while (i < side && !(s->possible[cells[i]] & bit)) i++;
+        if (i == side || !nxn_place(s, B, peers, cells[i], digit) || !nxn_drain(s, B, peers)) return false;
+        *changed = true;
+    }
+    return true;
+}
+
+/* Two cells of a unit with the same two candidates own them */
+static RTKA_INLINE bool nxn_naked_pairs(sudoku_nxn_t* s, const uint32_t B, const uint16_t* peers,
+                                        const uint16_t* cells, bool* changed) {
+    const uint32_t side = NXN_SIDE(B);
+    for (uint32_t i = 0; i + 1U < side; i++) {
+        sudoku_mask_t pair = s->possible[cells[i]];
+        if (__builtin_popcountll(pair) != 2) continue;
+        for (uint32_t j = i + 1U; j < side; j++) {
+            if (s->possible[cells[j]] != pair) continue;
+            for (uint32_t k = 0; k < side; k++) {
+                sudoku_mask_t m = s->possible[cells[k]];
+                if (k == i || k == j || !(m & pair)) continue;
+                m &= ~pair;
+                s->possible[cells[k]] = m;
+                if (!m) return false;
+                if (!(m & (m - 1U))) s->pending[s->num_pending++] = cells[k];
+                *changed = true;
+            }
+            break;
+        }
+    }
+    return nxn_drain(s, B, peers);
+}
+
+static RTKA_INLINE bool nxn_propagate(sudoku_nxn_t* s, const uint32_t B, const uint16_t* peers,
+                                      const uint16_t* units) {
+    const uint32_t side = NXN_SIDE(B);
+    if (!nxn_drain(s, B, peers)) return false;
+    bool changed = true;
+    while (changed && s->filled_count < NXN_CELLS(B)) {
+        changed = false;
+        for (uint32_t u = 0; u < 3U * side; u++) {
+            if (!nxn_hidden_singles(s, B, peers, units + (size_t)u * side, u, &changed)) return false;
+        }
+        if (changed) continue;
+        for (uint32_t u = 0; u < 3U * side; u++) {
+            if (!nxn_naked_pairs(s, B, peers, units + (size_t)u * side, &changed)) return false;
+        }
+    }
+    return true;
+}
+
+/* Open a branch on cell: save the board and its untried candidates */
+static bool nxn_push(sudoku_nxn_t* s, uint32_t cell) {
+    if (s->depth == s->depth_capacity) {
+        uint32_t capacity = s->depth_capacity ? 2U * s->depth_capacity : 16U;
+        if (capacity > s->cells) capacity = s->cells;
+        uint8_t* snapshots = (uint8_t*)realloc(s->snapshots, (size_t)capacity * s->board_bytes);
+        if (snapshots) s->snapshots = snapshots;
+        uint32_t* cells = (uint32_t*)realloc(s->branch_cell, capacity * sizeof(uint32_t));
+        if (cells) s->branch_cell = cells;
+        sudoku_mask_t* left = (sudoku_mask_t*)realloc(s->branch_left, capacity * sizeof(sudoku_mask_t));
+        if (left) s->branch_left = left;
+        uint32_t* filled = (uint32_t*)realloc(s->branch_filled, capacity * sizeof(uint32_t));
+        if (filled) s->branch_filled = filled;
+        if (!snapshots || !cells || !left || !filled) {
+            s->error = RTKA_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
+        s->depth_capacity = capacity;
+    }
+    memcpy(s->snapshots + (size_t)s->depth * s->board_bytes, s->possible, s->board_bytes);
+    s->branch_cell[s->depth] = cell;
+    s->branch_left[s->depth] = s->possible[cell];
+    s->branch_filled[s->depth] = s->filled_count;
+    s->depth++;
+    return true;
+}
+
+/* Depth-first over an explicit branch stack: minimum-remaining-values cell,
+ * candidates in digit order. The last candidate of a branch pops it. */
+static RTKA_INLINE bool nxn_search(sudoku_nxn_t* s, const uint32_t B, const uint16_t* peers,
+                                   const uint16_t* units) {
+    s->depth = 0;
+    bool ok = nxn_propagate(s, B, peers, units);
+    for (;;) {
+        if (ok) {
+            if (s->filled_count == NXN_CELLS(B)) return true;
+            uint32_t best = 0, fewest = 65;
+            for (uint32_t cell = 0; cell < NXN_CELLS(B) && fewest > 2U; cell++) {
+                uint32_t n = (uint32_t)__builtin_popcountll(s->possible[cell]);
+                if (n > 1U && n < fewest) {
+                    fewest = n;
+                    best = cell;
+                }
+            }
+            if (!nxn_push(s, best)) return false;
+        }
+
+        ok = false;
+        while (!ok) {
+            if (s->depth == 0) return false;
+            uint32_t d = s->depth - 1U;
+            sudoku_mask_t left = s->branch_left[d];
+            s->branch_left[d] = left & (left - 1U);
+            memcpy(s->possible, s->snapshots + (size_t)d * s->board_bytes, s->board_bytes);
+            s->filled_count = s->branch_filled[d];
+            s->num_pending = 0;
+            uint32_t cell = s->branch_cell[d];
+            if (!s->branch_left[d]) s->depth--;
+            s->guesses++;
+            ok = nxn_place(s, B, peers, cell, (uint32_t)__builtin_ctzll(left)) &&
+                 nxn_propagate(s, B, peers, units);
+        }
+    }
+}
+
+/* ============================================================================
+ * PER-SIZE INSTANCES
+ * ============================================================================ */
+
+typedef struct {
+    bool (*place)(sudoku_nxn_t* s, uint32_t cell, uint32_t digit);
+    bool (*search)(sudoku_nxn_t* s);
+    uint16_t* peers;                  /* [cells][NXN_PEERS] */
+    uint16_t* units;                  /* [3 * side][side] rows, columns, boxes */
+} nxn_kernels_t;
+
+#define NXN_INSTANCE(B)                                                         \
+static uint16_t nxn_peers_##B[NXN_CELLS(B##U)][NXN_PEERS(B##U)];                \
+static uint16_t nxn_units_##B[3U * NXN_SIDE(B##U)][NXN_SIDE(B##U)];             \
+static bool nxn_place_##B(sudoku_nxn_t* s, uint32_t cell, uint32_t digit) {     \
+    return nxn_place(s, B##U, nxn_peers_##B[0], cell, digit) &&                 \
+           nxn_drain(s, B##U, nxn_peers_##B[0]);                                \
+}                                                                               \
+static bool nxn_search_##B(sudoku_nxn_t* s) {                                   \
+    return nxn_search(s, B##U, nxn_peers_##B[0], nxn_units_##B[0]);             \
+}
+
+NXN_INSTANCE(2)
+NXN_INSTANCE(3)
+NXN_INSTANCE(4)
+NXN_INSTANCE(5)
+NXN_INSTANCE(6)
+NXN_INSTANCE(7)
+NXN_INSTANCE(8)
+
+#define NXN_KERNELS(B) {nxn_place_##B, nxn_search_##B, nxn_peers_##B[0], nxn_units_##B[0]}
+
+static const nxn_kernels_t nxn_kernels[SUDOKU_NXN_MAX_BOX + 1U] = {
+    [2] = NXN_KERNELS(2), [3] = NXN_KERNELS(3), [4] = NXN_KERNELS(4), [5] = NXN_KERNELS(5),
+    [6] = NXN_KERNELS(6), [7] = NXN_KERNELS(7), [8] = NXN_KERNELS(8)
+};
+
+static pthread_once_t nxn_tables_once = PTHREAD_ONCE_INIT;
+
+static void build_tables(uint32_t box, uint16_t* peers, uint16_t* units) {
+    uint32_t side = box * box, cells = side * side, n = NXN_PEERS(box);
+    for (uint32_t i = 0; i < side; i++) {
+        for (uint32_t k = 0; k < side; k++) {
+            units[i * side + k] = (uint16_t)(i * side + k);
+            units[(side + i) * side + k] = (uint16_t)(k * side + i);
+            units[(2U * side + i) * side + k] =
+                (uint16_t)(((i / box) * box + k / box) * side + (i % box) * box + k % box);
+        }
+    }
+    for (uint32_t cell = 0; cell < cells; cell++) {
+        uint32_t row = cell / side, col = cell % side, count = 0;
+        uint16_t* p = peers + (size_t)cell * n;
+        for (uint32_t k = 0; k < side; k++) {
+            if (k != col) p[count++] = (uint16_t)(row * side + k);
+            if (k != row) p[count++] = (uint16_t)(k * side + col);
+        }
+        const uint16_t* b = units + (size_t)(2U * side + nxn_box_of(box, row, col)) * side;
+        for (uint32_t k = 0; k < side; k++) {
+            if (b[k] / side != row && b[k] % side != col) p[count++] = b[k];
+        }
+    }
+}
+
+static void tables_init(void) {
+    for (uint32_t box = SUDOKU_NXN_MIN_BOX; box <= SUDOKU_NXN_MAX_BOX; box++) {
+        build_tables(box, nxn_kernels[box].peers, nxn_kernels[box].units);
+    }
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ============================================================================ */
+
+rtka_error_t rtka_sudoku_nxn_init(sudoku_nxn_t* state, uint32_t box, const uint8_t* clues) {
+    if (!state) return RTKA_ERROR_NULL_POINTER;
+    memset(state, 0, sizeof(sudoku_nxn_t));
+    if (!clues) return state->error = RTKA_ERROR_NULL_POINTER;
+    if (box < SUDOKU_NXN_MIN_BOX || box > SUDOKU_NXN_MAX_BOX) return state->error = RTKA_ERROR_INVALID_VALUE;
+    pthread_once(&nxn_tables_once, tables_init);
+
+    uint32_t side = box * box, cells = side * side;
+    state->box = box;
+    state->side = side;
+    state->cells = cells;
+    state->board_bytes = ((size_t)cells + 3U * side) * sizeof(sudoku_mask_t) + cells;
+
+    uint8_t* board = (uint8_t*)malloc(state->board_bytes);
+    state->pending = (uint16_t*)malloc(cells * sizeof(uint16_t));
+    if (!board || !state->pending) {
+        free(board);
+        return state->error = RTKA_ERROR_OUT_OF_MEMORY;
+    }
+    state->possible = (sudoku_mask_t*)board;
+    state->used = state->possible + cells;
+    state->solution = (uint8_t*)(state->used + 3U * side);
+
+    sudoku_mask_t all = nxn_all(side);
+    for (uint32_t cell = 0; cell < cells; cell++) state->possible[cell] = all;
+    memset(state->used, 0, 3U * side * sizeof(sudoku_mask_t));
+    memset(state->solution, SUDOKU_NXN_OPEN, cells);
+
+    const nxn_kernels_t* k = &nxn_kernels[box];
+    for (uint32_t cell = 0; cell < cells; cell++) {
+        if (clues[cell] > side) return state->error = RTKA_ERROR_INVALID_VALUE;
+        if (!clues[cell] || state->solution[cell] == clues[cell] - 1U) continue;
+        if (!k->place(state, cell, clues[cell] - 1U)) return state->error = RTKA_ERROR_INVALID_VALUE;
+    }
+    return RTKA_SUCCESS;
+}
+
+void rtka_sudoku_nxn_free(sudoku_nxn_t* state) {
+    if (!state) return;
+    free(state->possible);
+    free(state->pending);
+    free(state->snapshots);
+    free(state->branch_cell);
+    free(state->branch_left);
+    free(state->branch_filled);
+    memset(state, 0, sizeof(sudoku_nxn_t));
+}
+
+bool rtka_sudoku_nxn_solve(sudoku_nxn_t* state) {
+    if (!state || state->error != RTKA_SUCCESS) return false;
+    state->guesses = 0;
+    return nxn_kernels[state->box].search(state);
+}
+
+rtka_state_t rtka_sudoku_nxn_state(const sudoku_nxn_t* state, uint32_t cell, uint32_t digit) {
+    sudoku_mask_t m = state->possible[cell];
+    if (!(m & ((sudoku_mask_t)1 << digit))) return (rtka_state_t){.value = RTKA_FALSE, .confidence = 1.0f};
+    if (state->solution[cell] != SUDOKU_NXN_OPEN) return (rtka_state_t){.value = RTKA_TRUE, .confidence = 1.0f};
+    return (rtka_state_t){.value = RTKA_UNKNOWN, .confidence = 1.0f / (float)__builtin_popcountll(m)};
+}
+
+bool rtka_sudoku_nxn_validate(const sudoku_nxn_t* state) {
+    if (!state || !state->possible || state->filled_count != state->cells) return false;
+    const uint16_t* units = nxn_kernels[state->box].units;
+    uint32_t side = state->side;
+    for (uint32_t u = 0; u < 3U * side; u++) {
+        sudoku_mask_t seen = 0;
+        for (uint32_t i = 0; i < side; i++) {
+            uint8_t d = state->solution[units[u * side + i]];
+            if (d >= side) return false;
+            seen |= (sudoku_mask_t)1 << d;
+        }
+        if (seen != nxn_all(side)) return false;
+    }
+    return true;
+}
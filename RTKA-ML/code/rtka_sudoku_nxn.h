@@ -0,0 +1,96 @@
+/**
+ * File: rtka_sudoku_nxn.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA n²×n² Sudoku - the 729-state model generalized to box sizes 2-8
+ * (4×4 up to 64×64), side³ ternary states per grid
+ *
+ * CHANGELOG:
+ * v1.0.0 - 64-bit candidate word per cell, one used-mask per row, column
+ *          and box. Each box size gets its own propagation and search
+ *          code, specialized from one inline body with the size as a
+ *          compile-time constant, and its own peer and unit tables whose
+ *          dimensions are fixed at compile time (filled once on first use).
+ *          Naked singles chain through a worklist, hidden singles use
+ *          once/twice unit masks, naked pairs run when singles stall, and
+ *          the search backtracks by restoring board snapshots from a
+ *          growable stack rather than recursing.
+ *
+ *   sudoku_nxn_t s;
+ *   if (rtka_sudoku_nxn_init(&s, 4, clues) == RTKA_SUCCESS && rtka_sudoku_nxn_solve(&s)) {
+ *       uint32_t digit = s.solution[0] + 1;
+ *   }
+ *   rtka_sudoku_nxn_free(&s);
+ */
+
+#ifndef RTKA_SUDOKU_NXN_H
+#define RTKA_SUDOKU_NXN_H
+
+#include "rtka_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SUDOKU_NXN_MIN_BOX  2U
+#define SUDOKU_NXN_MAX_BOX  8U          /* 64 digits fill the candidate word */
+#define SUDOKU_NXN_OPEN     0xFFU       /* solution[] of an open cell */
+
+typedef uint64_t sudoku_mask_t;
+
+typedef struct {
+    uint32_t box;                     /* n */
+    uint32_t side;                    /* n²: digits per cell, cells per unit */
+    uint32_t cells;                   /* n⁴ */
+
+    /* Board, one allocation; a snapshot is a copy of these arrays */
+    sudoku_mask_t* possible;          /* [cells] candidates; the placed digit's bit once filled */
+    sudoku_mask_t* used;              /* [3 * side] rows, then columns, then boxes */
+    uint8_t* solution;                /* [cells] 0..side-1, SUDOKU_NXN_OPEN while open */
+    uint32_t filled_count;
+    size_t board_bytes;
+
+    /* Search scratch */
+    uint16_t* pending;                /* [cells] cells left with one candidate */
+    uint32_t num_pending;
+    uint8_t* snapshots;               /* board_bytes per open branch */
+    uint32_t* branch_cell;
+    sudoku_mask_t* branch_left;       /* Candidates of branch_cell not yet tried */
+    uint32_t* branch_filled;
+    uint32_t depth;
+    uint32_t depth_capacity;
+
+    uint64_t guesses;                 /* Branches tried by the last solve */
+    rtka_error_t error;
+} sudoku_nxn_t;
+
+/**
+ * Set up a (box²)×(box²) grid from clues in row order: 0 for blank,
+ * 1..box² for a digit. RTKA_ERROR_INVALID_VALUE for a box size outside
+ * SUDOKU_NXN_MIN_BOX..SUDOKU_NXN_MAX_BOX, an out-of-range clue or clues that
+ * conflict. state must be freed with rtka_sudoku_nxn_free() whatever the
+ * result.
+ */
+RTKA_NODISCARD rtka_error_t rtka_sudoku_nxn_init(sudoku_nxn_t* state, uint32_t box, const uint8_t* clues);
+
+void rtka_sudoku_nxn_free(sudoku_nxn_t* state);
+
+/* Propagate and search; on success every solution[] entry is set. false on
+ * an unsolvable grid, or with state->error set when the snapshot stack
+ * cannot grow. */
+bool rtka_sudoku_nxn_solve(sudoku_nxn_t* state);
+
+/* Ternary state of (cell, digit), built on demand as in the 729 view:
+ * placed TRUE, eliminated FALSE, candidates UNKNOWN with confidence
+ * 1 / remaining */
+rtka_state_t rtka_sudoku_nxn_state(const sudoku_nxn_t* state, uint32_t cell, uint32_t digit);
+
+/* Every unit holds each digit exactly once */
+bool rtka_sudoku_nxn_validate(const sudoku_nxn_t* state);
+
+#endif /* RTKA_SUDOKU_NXN_H */
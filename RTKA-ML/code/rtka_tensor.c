@@ -12,8 +12,12 @@
  */
 
 #include "rtka_tensor.h"
+#include "rtka_tensor_expr.h"
+#include "rtka_gemm.h"
+#include "rtka_threadpool.h"
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 /* Calculate strides from shape */
 static void calculate_strides(uint32_t* strides, const uint32_t* shape, uint32_t ndim) {
@@ -34,31 +38,64 @@ static uint32_t calculate_size(const uint32_t* shape, uint32_t ndim) {
     return size;
 }
 
-/* Create tensor */
-rtka_tensor_t* rtka_tensor_create(const uint32_t* shape, uint32_t ndim) {
+/* Row-major strides for shape, size-1 dims excepted */
+static bool strides_contiguous(const uint32_t* shape, const uint32_t* strides, uint32_t ndim) {
+    uint32_t expected = 1;
+    for (int32_t d = (int32_t)ndim - 1; d >= 0; d--) {
+        if (shape[d] != 1 && strides[d] != expected) return false;
+        expected *= shape[d];
+    }
+    return true;
+}
+
+/* Header over another tensor's storage, from the current allocator */
+static rtka_tensor_t* alias_header(const rtka_tensor_t* base) {
+    rtka_allocator_t* owner = NULL;
+    rtka_tensor_t* tensor = (rtka_tensor_t*)rtka_allocator_alloc(NULL, sizeof(rtka_tensor_t), &owner);
+    if (!tensor) return NULL;
+    *tensor = *base;
+    tensor->allocator = owner;
+    return tensor;
+}
+
+static void update_contiguous(rtka_tensor_t* tensor) {
+    if (strides_contiguous(tensor->shape, tensor->strides, tensor->ndim)) {
+        tensor->flags |= RTKA_TENSOR_CONTIGUOUS;
+    } else {
+        tensor->flags &= ~RTKA_TENSOR_CONTIGUOUS;
+    }
+}
+
+/* Create tensor - header and data in one block from allocator (NULL = the
+ * thread's current allocator, a step arena inside rtka_arena_begin_step) */
+rtka_tensor_t* rtka_tensor_create_in(rtka_allocator_t* allocator, const uint32_t* shape, uint32_t ndim) {
     if (ndim > RTKA_MAX_DIMENSIONS) return NULL;
     
-    rtka_tensor_t* tensor = (rtka_tensor_t*)rtka_alloc_state();
+    uint32_t size = calculate_size(shape, ndim);
+    rtka_allocator_t* owner = NULL;
+    rtka_tensor_t* tensor = (rtka_tensor_t*)rtka_allocator_alloc(
+        allocator, sizeof(rtka_tensor_t) + (size_t)size * sizeof(rtka_state_t), &owner);
     if (!tensor) return NULL;
     
     tensor->ndim = ndim;
     memcpy(tensor->shape, shape, ndim * sizeof(uint32_t));
     calculate_strides(tensor->strides, shape, ndim);
-    tensor->size = calculate_size(shape, ndim);
-    
-    tensor->data = rtka_alloc_states(tensor->size);
-    if (!tensor->data) {
-        rtka_free_state((rtka_state_t*)tensor);
-        return NULL;
-    }
-    
+    tensor->size = size;
+    tensor->data = (rtka_state_t*)(tensor + 1);
+    tensor->values = NULL;
+    tensor->confidences = NULL;
     tensor->flags = RTKA_TENSOR_CONTIGUOUS;
+    tensor->allocator = owner;
     return tensor;
 }
 
+rtka_tensor_t* rtka_tensor_create(const uint32_t* shape, uint32_t ndim) {
+    return rtka_tensor_create_in(NULL, shape, ndim);
+}
+
 /* Create zeros tensor */
-rtka_tensor_t* rtka_tensor_zeros(const uint32_t* shape, uint32_t ndim) {
-    rtka_tensor_t* tensor = rtka_tensor_create(shape, ndim);
+rtka_tensor_t* rtka_tensor_zeros_in(rtka_allocator_t* allocator, const uint32_t* shape, uint32_t ndim) {
+    rtka_tensor_t* tensor = rtka_tensor_create_in(allocator, shape, ndim);
     if (!tensor) return NULL;
     
     rtka_state_t zero_state = rtka_make_state(RTKA_FALSE, 1.0f);
@@ -69,6 +106,10 @@ rtka_tensor_t* rtka_tensor_zeros(const uint32_t* shape, uint32_t ndim) {
     return tensor;
 }
 
+rtka_tensor_t* rtka_tensor_zeros(const uint32_t* shape, uint32_t ndim) {
+    return rtka_tensor_zeros_in(NULL, shape, ndim);
+}
+
 /* Create unknown tensor */
 rtka_tensor_t* rtka_tensor_unknown(const uint32_t* shape, uint32_t ndim) {
     rtka_tensor_t* tensor = rtka_tensor_create(shape, ndim);
@@ -82,92 +123,770 @@ rtka_tensor_t* rtka_tensor_unknown(const uint32_t* shape, uint32_t ndim) {
     return tensor;
 }
 
+/* Create SoA tensor - values plane then confidence plane after the header,
+ * each starting on a cache line */
+static size_t soa_plane_bytes(uint32_t size) {
+    return ((size_t)size * sizeof(rtka_value_t) + RTKA_CACHE_LINE_SIZE - 1U) &
+           ~(size_t)(RTKA_CACHE_LINE_SIZE - 1U);
+}
+
+rtka_tensor_t* rtka_tensor_create_soa_in(rtka_allocator_t* allocator, const uint32_t* shape, uint32_t ndim) {
+    if (ndim > RTKA_MAX_DIMENSIONS) return NULL;
+    
+    uint32_t size = calculate_size(shape, ndim);
+    size_t plane = soa_plane_bytes(size);
+    rtka_allocator_t* owner = NULL;
+    rtka_tensor_t* tensor = (rtka_tensor_t*)rtka_allocator_alloc(
+        allocator, sizeof(rtka_tensor_t) + 2U * plane, &owner);
+    if (!tensor) return NULL;
+    
+    tensor->ndim = ndim;
+    memcpy(tensor->shape, shape, ndim * sizeof(uint32_t));
+    calculate_strides(tensor->strides, shape, ndim);
+    tensor->size = size;
+    tensor->data = NULL;
+    tensor->values = (rtka_value_t*)(void*)(tensor + 1);
+    tensor->confidences = (rtka_confidence_t*)(void*)((char*)(tensor + 1) + plane);
+    tensor->flags = RTKA_TENSOR_CONTIGUOUS | RTKA_TENSOR_SOA;
+    tensor->allocator = owner;
+    return tensor;
+}
+
+rtka_tensor_t* rtka_tensor_create_soa(const uint32_t* shape, uint32_t ndim) {
+    return rtka_tensor_create_soa_in(NULL, shape, ndim);
+}
+
+/* Layout conversion - strided sources are gathered in index order */
+static rtka_tensor_t* tensor_convert(const rtka_tensor_t* tensor, bool soa) {
+    rtka_tensor_t* out = soa ? rtka_tensor_create_soa(tensor->shape, tensor->ndim)
+                             : rtka_tensor_create(tensor->shape, tensor->ndim);
+    if (!out) return NULL;
+    
+    uint32_t indices[RTKA_MAX_DIMENSIONS] = {0};
+    for (uint32_t i = 0; i < tensor->size; i++) {
+        uint32_t offset = 0;
+        for (uint32_t d = 0; d < tensor->ndim; d++) offset += indices[d] * tensor->strides[d];
+        rtka_tensor_store(out, i, rtka_tensor_load(tensor, offset));
+        
+        for (int32_t d = tensor->ndim - 1; d >= 0; d--) {
+            if (++indices[d] < tensor->shape[d]) break;
+            indices[d] = 0;
+        }
+    }
+    return out;
+}
+
+rtka_tensor_t* rtka_tensor_to_soa(const rtka_tensor_t* tensor) {
+    return tensor_convert(tensor, true);
+}
+
+rtka_tensor_t* rtka_tensor_to_aos(const rtka_tensor_t* tensor) {
+    return tensor_convert(tensor, false);
+}
+
+bool rtka_tensor_as_vector(const rtka_tensor_t* tensor, rtka_vector_t* vec) {
+    if (!rtka_tensor_is_soa(tensor) || !rtka_tensor_is_contiguous(tensor)) return false;
+    vec->values = tensor->values;
+    vec->confidences = tensor->confidences;
+    vec->count = tensor->size;
+    vec->capacity = tensor->size;
+    return true;
+}
+
+rtka_tensor_t* rtka_tensor_wrap_vector(const rtka_vector_t* vec, const uint32_t* shape, uint32_t ndim) {
+    if (ndim > RTKA_MAX_DIMENSIONS || calculate_size(shape, ndim) != vec->count) return NULL;
+    
+    rtka_allocator_t* owner = NULL;
+    rtka_tensor_t* tensor = (rtka_tensor_t*)rtka_allocator_alloc(NULL, sizeof(rtka_tensor_t), &owner);
+    if (!tensor) return NULL;
+    
+    tensor->ndim = ndim;
+    memcpy(tensor->shape, shape, ndim * sizeof(uint32_t));
+    calculate_strides(tensor->strides, shape, ndim);
+    tensor->size = vec->count;
+    tensor->data = NULL;
+    tensor->values = vec->values;
+    tensor->confidences = vec->confidences;
+    tensor->flags = RTKA_TENSOR_CONTIGUOUS | RTKA_TENSOR_SOA;
+    tensor->allocator = owner;
+    return tensor;
+}
+
+rtka_tensor_t* rtka_tensor_wrap(rtka_state_t* data, const uint32_t* shape, uint32_t ndim) {
+    if (!data || ndim > RTKA_MAX_DIMENSIONS) return NULL;
+    
+    rtka_allocator_t* owner = NULL;
+    rtka_tensor_t* tensor = (rtka_tensor_t*)rtka_allocator_alloc(NULL, sizeof(rtka_tensor_t), &owner);
+    if (!tensor) return NULL;
+    
+    tensor->ndim = ndim;
+    memcpy(tensor->shape, shape, ndim * sizeof(uint32_t));
+    calculate_strides(tensor->strides, shape, ndim);
+    tensor->size = calculate_size(shape, ndim);
+    tensor->data = data;
+    tensor->values = NULL;
+    tensor->confidences = NULL;
+    tensor->flags = RTKA_TENSOR_CONTIGUOUS;
+    tensor->allocator = owner;
+    return tensor;
+}
+
+/* Result tensor of a's layout */
+static rtka_tensor_t* create_like(const rtka_tensor_t* a, const uint32_t* shape, uint32_t ndim) {
+    return rtka_tensor_is_soa(a) ? rtka_tensor_create_soa(shape, ndim)
+                                 : rtka_tensor_create(shape, ndim);
+}
+
+/* Allocating wrapper: a's shape when sizes agree, else the broadcast shape */
+static rtka_tensor_t* create_binary_result(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    if (!a || !b) return NULL;
+    if (a->size == b->size) return create_like(a, a->shape, a->ndim);
+    
+    uint32_t shape[RTKA_MAX_DIMENSIONS];
+    uint32_t ndim = 0;
+    rtka_tensor_broadcast_shapes(a->shape, a->ndim, b->shape, b->ndim, shape, &ndim);
+    if (ndim == 0) return NULL;
+    return create_like(a, shape, ndim);
+}
+
+static rtka_tensor_t* finish(rtka_tensor_t* result, rtka_error_t error) {
+    if (error != RTKA_SUCCESS) {
+        rtka_tensor_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+/* One-node expression a op b into out: broadcasting, mixed layouts and
+ * aliasing out with an input are all handled by the fused evaluator */
+static rtka_error_t expr_binary_into(rtka_tensor_t* out, const rtka_tensor_t* a,
+                                     const rtka_tensor_t* b,
+                                     rtka_expr_t (*op)(rtka_tensor_expr_t*, rtka_expr_t, rtka_expr_t)) {
+    rtka_tensor_expr_t expr;
+    rtka_expr_init(&expr);
+    rtka_expr_t x = rtka_expr_input(&expr, a);
+    rtka_expr_t root = op(&expr, x, rtka_expr_input(&expr, b));
+    return rtka_expr_eval_into(&expr, root, out);
+}
+
+/* Element-wise ops - equal sizes and no aliasing: the vector kernels on
+ * SoA planes or the state batch ops on AoS; mixed layouts or out aliasing
+ * an input element by element; different shapes broadcast */
+static rtka_error_t elementwise_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b,
+                                     rtka_state_t (*combine)(rtka_state_t, rtka_state_t),
+                                     void (*batch)(const rtka_state_t*, const rtka_state_t*,
+                                                   rtka_state_t*, uint32_t),
+                                     void (*planes)(const rtka_vector_t*, const rtka_vector_t*,
+                                                    rtka_vector_t*),
+                                     rtka_expr_t (*op)(rtka_tensor_expr_t*, rtka_expr_t, rtka_expr_t)) {
+    if (!out || !a || !b) return RTKA_ERROR_NULL_POINTER;
+    if (a->size != b->size || out->size != a->size || !rtka_tensor_is_contiguous(a) ||
+        !rtka_tensor_is_contiguous(b) || !rtka_tensor_is_contiguous(out)) {
+        return expr_binary_into(out, a, b, op);
+    }
+    
+    bool aliased = out == a || out == b;
+    rtka_vector_t va, vb, vr;
+    if (!aliased && rtka_tensor_as_vector(a, &va) && rtka_tensor_as_vector(b, &vb) &&
+        rtka_tensor_as_vector(out, &vr)) {
+        planes(&va, &vb, &vr);
+    } else if (!aliased && !rtka_tensor_is_soa(a) && !rtka_tensor_is_soa(b) && !rtka_tensor_is_soa(out)) {
+        batch(a->data, b->data, out->data, a->size);
+    } else {
+        for (uint32_t i = 0; i < a->size; i++) {
+            rtka_tensor_store(out, i, combine(rtka_tensor_load(a, i), rtka_tensor_load(b, i)));
+        }
+    }
+    
+    return RTKA_SUCCESS;
+}
+
 /* Element-wise AND */
+rtka_error_t rtka_tensor_and_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return elementwise_into(out, a, b, rtka_combine_and, rtka_and_batch, rtka_vector_and, rtka_expr_and);
+}
+
 rtka_tensor_t* rtka_tensor_and(const rtka_tensor_t* a, const rtka_tensor_t* b) {
-    if (a->size != b->size) return NULL;
+    rtka_tensor_t* result = create_binary_result(a, b);
+    return result ? finish(result, rtka_tensor_and_into(result, a, b)) : NULL;
+}
+
+rtka_error_t rtka_tensor_and_inplace(rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return rtka_tensor_and_into(a, a, b);
+}
+
+/* Element-wise OR */
+rtka_error_t rtka_tensor_or_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return elementwise_into(out, a, b, rtka_combine_or, rtka_or_batch, rtka_vector_or, rtka_expr_or);
+}
+
+rtka_tensor_t* rtka_tensor_or(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    rtka_tensor_t* result = create_binary_result(a, b);
+    return result ? finish(result, rtka_tensor_or_into(result, a, b)) : NULL;
+}
+
+rtka_error_t rtka_tensor_or_inplace(rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return rtka_tensor_or_into(a, a, b);
+}
+
+/* Element-wise NOT - confidence unchanged */
+rtka_error_t rtka_tensor_not_into(rtka_tensor_t* out, const rtka_tensor_t* a) {
+    if (!out || !a) return RTKA_ERROR_NULL_POINTER;
+    if (out->size != a->size) return RTKA_ERROR_INVALID_VALUE;
     
-    rtka_tensor_t* result = rtka_tensor_create(a->shape, a->ndim);
-    if (!result) return NULL;
+    rtka_vector_t va, vr;
+    if (out != a && rtka_tensor_as_vector(a, &va) && rtka_tensor_as_vector(out, &vr)) {
+        rtka_vector_not(&va, &vr);
+    } else if (rtka_tensor_is_contiguous(a) && rtka_tensor_is_contiguous(out)) {
+        for (uint32_t i = 0; i < a->size; i++) {
+            rtka_state_t s = rtka_tensor_load(a, i);
+            rtka_tensor_store(out, i, rtka_make_state(rtka_not(s.value), s.confidence));
+        }
+    } else {
+        rtka_tensor_expr_t expr;
+        rtka_expr_init(&expr);
+        return rtka_expr_eval_into(&expr, rtka_expr_not(&expr, rtka_expr_input(&expr, a)), out);
+    }
     
-    /* Use batch operations for efficiency */
-    rtka_and_batch(a->data, b->data, result->data, a->size);
+    return RTKA_SUCCESS;
+}
+
+rtka_tensor_t* rtka_tensor_not(const rtka_tensor_t* a) {
+    rtka_tensor_t* result = create_like(a, a->shape, a->ndim);
+    return result ? finish(result, rtka_tensor_not_into(result, a)) : NULL;
+}
+
+rtka_error_t rtka_tensor_not_inplace(rtka_tensor_t* a) {
+    return rtka_tensor_not_into(a, a);
+}
+
+/* Signed-plane arithmetic - one-node expressions, so they broadcast */
+rtka_error_t rtka_tensor_add_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    if (!out || !a || !b) return RTKA_ERROR_NULL_POINTER;
+    return expr_binary_into(out, a, b, rtka_expr_add);
+}
+
+rtka_tensor_t* rtka_tensor_add(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    rtka_tensor_t* result = create_binary_result(a, b);
+    return result ? finish(result, rtka_tensor_add_into(result, a, b)) : NULL;
+}
+
+rtka_error_t rtka_tensor_add_inplace(rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return rtka_tensor_add_into(a, a, b);
+}
+
+rtka_error_t rtka_tensor_multiply_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    if (!out || !a || !b) return RTKA_ERROR_NULL_POINTER;
+    return expr_binary_into(out, a, b, rtka_expr_mul);
+}
+
+rtka_tensor_t* rtka_tensor_multiply(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    rtka_tensor_t* result = create_binary_result(a, b);
+    return result ? finish(result, rtka_tensor_multiply_into(result, a, b)) : NULL;
+}
+
+rtka_error_t rtka_tensor_multiply_inplace(rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return rtka_tensor_multiply_into(a, a, b);
+}
+
+/* Per-thread scratch for matmul plane splits and GEMM sums - grows to the
+ * largest request and is kept, so steady-state calls allocate nothing */
+static _Thread_local void* tensor_scratch_block = NULL;
+static _Thread_local size_t tensor_scratch_bytes = 0;
+
+static void* tensor_scratch(size_t bytes) {
+    if (bytes <= tensor_scratch_bytes) return tensor_scratch_block;
     
-    return result;
+    bytes = (bytes + RTKA_CACHE_LINE_SIZE - 1U) & ~(size_t)(RTKA_CACHE_LINE_SIZE - 1U);
+    void* grown = aligned_alloc(RTKA_CACHE_LINE_SIZE, bytes);
+    if (!grown) return NULL;
+    free(tensor_scratch_block);
+    tensor_scratch_block = grown;
+    tensor_scratch_bytes = bytes;
+    return grown;
+}
+
+/* Matrix multiplication - Kleene OR of ANDs over k, seeded with (FALSE, 1.0)
+ *
+ * Rows of C are independent: B is split into value and confidence planes
+ * once (an SoA B already is), then each worker streams i-k-j so the inner
+ * loop is a contiguous min/max and multiply-add over a row of B
+ * (vectorized). The k order of the OR fold is the same as the
+ * element-by-element loop. */
+#define RTKA_MATMUL_COLS 512U   /* Accumulator row: 4 KiB, stays in L1 */
+
+typedef struct {
+    const rtka_tensor_t* a;
+    const rtka_tensor_t* b;
+    rtka_tensor_t* result;
+    const rtka_value_t* b_values;   /* k x n planes of B */
+    const float* b_confs;
+} rtka_matmul_job_t;
+
+static void matmul_rows(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const rtka_matmul_job_t* job = (const rtka_matmul_job_t*)ctx;
+    const uint32_t k = job->a->shape[1], n = job->b->shape[1];
+    const uint32_t a_row = job->a->strides[0], a_col = job->a->strides[1];
+    const uint32_t c_row = job->result->strides[0], c_col = job->result->strides[1];
+    rtka_value_t acc_v[RTKA_MATMUL_COLS];
+    float acc_c[RTKA_MATMUL_COLS];
+    
+    for (uint32_t j0 = 0; j0 < n; j0 += RTKA_MATMUL_COLS) {
+        uint32_t cols = (n - j0 < RTKA_MATMUL_COLS) ? n - j0 : RTKA_MATMUL_COLS;
+        
+        for (uint32_t i = begin; i < end; i++) {
+            for (uint32_t j = 0; j < cols; j++) {
+                acc_v[j] = RTKA_FALSE;
+                acc_c[j] = 1.0f;
+            }
+            
+            for (uint32_t kk = 0; kk < k; kk++) {
+                rtka_state_t a_val = rtka_tensor_load(job->a, i * a_row + kk * a_col);
+                const rtka_value_t* RTKA_RESTRICT bv = job->b_values + (size_t)kk * n + j0;
+                const float* RTKA_RESTRICT bc = job->b_confs + (size_t)kk * n + j0;
+                
+                for (uint32_t j = 0; j < cols; j++) {
+                    rtka_value_t prod_v = a_val.value < bv[j] ? a_val.value : bv[j];
+                    float prod_c = a_val.confidence * bc[j];
+                    acc_v[j] = acc_v[j] > prod_v ? acc_v[j] : prod_v;
+                    acc_c[j] = acc_c[j] + prod_c - acc_c[j] * prod_c;
+                }
+            }
+            
+            for (uint32_t j = 0; j < cols; j++) {
+                rtka_tensor_store(job->result, i * c_row + (j0 + j) * c_col,
+                                  rtka_make_state(acc_v[j], acc_c[j]));
+            }
+        }
+    }
+}
+
+rtka_error_t rtka_tensor_matmul_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    if (!out || !a || !b) return RTKA_ERROR_NULL_POINTER;
+    if (a->ndim != 2 || b->ndim != 2 || a->shape[1] != b->shape[0]) return RTKA_ERROR_INVALID_VALUE;
+    
+    uint32_t m = a->shape[0], k = a->shape[1], n = b->shape[1];
+    if (out == a || out == b || out->ndim != 2 || out->shape[0] != m || out->shape[1] != n) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    
+    rtka_matmul_job_t job = { .a = a, .b = b, .result = out };
+    if (rtka_tensor_is_soa(b) && rtka_tensor_is_contiguous(b)) {
+        job.b_values = b->values;
+        job.b_confs = b->confidences;
+    } else {
+        /* Split (and for a view of B, gather) into row-major planes */
+        void* planes = tensor_scratch((size_t)k * n * (sizeof(rtka_value_t) + sizeof(float)));
+        if (!planes) return RTKA_ERROR_OUT_OF_MEMORY;
+        rtka_value_t* values = (rtka_value_t*)planes;
+        float* confs = (float*)(values + (size_t)k * n);
+        for (uint32_t p = 0; p < k; p++) {
+            for (uint32_t j = 0; j < n; j++) {
+                rtka_state_t s = rtka_tensor_load(b, p * b->strides[0] + j * b->strides[1]);
+                values[(size_t)p * n + j] = s.value;
+                confs[(size_t)p * n + j] = s.confidence;
+            }
+        }
+        job.b_values = values;
+        job.b_confs = confs;
+    }
+    
+    uint64_t work = (uint64_t)m * n * k;
+    if (m > 1 && work >= RTKA_GEMM_PARALLEL_MIN_FLOPS) {
+        rtka_pool_parallel_for(rtka_pool_default(), 0, m, 0, matmul_rows, &job);
+    } else {
+        matmul_rows(&job, 0, m, 0);
+    }
+    
+    return RTKA_SUCCESS;
 }
 
-/* Matrix multiplication - optimized with tiling */
 rtka_tensor_t* rtka_tensor_matmul(const rtka_tensor_t* a, const rtka_tensor_t* b) {
     if (a->ndim != 2 || b->ndim != 2) return NULL;
     if (a->shape[1] != b->shape[0]) return NULL;
     
-    uint32_t m = a->shape[0], k = a->shape[1], n = b->shape[1];
-    uint32_t out_shape[] = {m, n};
-    rtka_tensor_t* result = rtka_tensor_zeros(out_shape, 2);
-    if (!result) return NULL;
-    
-    /* Tiled multiplication for cache efficiency */
-    const uint32_t TILE = 64;
-    
-    for (uint32_t i0 = 0; i0 < m; i0 += TILE) {
-        for (uint32_t j0 = 0; j0 < n; j0 += TILE) {
-            for (uint32_t k0 = 0; k0 < k; k0 += TILE) {
-                /* Process tile */
-                uint32_t i_max = (i0 + TILE < m) ? i0 + TILE : m;
-                uint32_t j_max = (j0 + TILE < n) ? j0 + TILE : n;
-                uint32_t k_max = (k0 + TILE < k) ? k0 + TILE : k;
-                
-                for (uint32_t i = i0; i < i_max; i++) {
-                    for (uint32_t j = j0; j < j_max; j++) {
-                        rtka_state_t sum = result->data[i * n + j];
-                        
-                        for (uint32_t kk = k0; kk < k_max; kk++) {
-                            rtka_state_t a_val = a->data[i * k + kk];
-                            rtka_state_t b_val = b->data[kk * n + j];
-                            rtka_state_t prod = rtka_combine_and(a_val, b_val);
-                            sum = rtka_combine_or(sum, prod);
-                        }
-                        
-                        result->data[i * n + j] = sum;
-                    }
-                }
+    uint32_t out_shape[] = {a->shape[0], b->shape[1]};
+    rtka_tensor_t* result = create_like(a, out_shape, 2);
+    return result ? finish(result, rtka_tensor_matmul_into(result, a, b)) : NULL;
+}
+
+/* Signed plane is exactly {-1, 0, +1}: every TRUE / FALSE has confidence
+ * 1, so the values alone are the weights. Exits at the first fractional
+ * confidence, so dense float weights pay for one element or so. */
+bool rtka_tensor_is_ternary(const rtka_tensor_t* tensor) {
+    for (uint32_t i = 0; i < tensor->size; i++) {
+        rtka_state_t s = rtka_tensor_load(tensor, rtka_tensor_offset(tensor, i));
+        if (s.value != RTKA_UNKNOWN && s.confidence != 1.0f) return false;
+    }
+    return true;
+}
+
+/* GEMM operand over either layout, signed plane */
+static rtka_gemm_operand_t signed_operand(const rtka_tensor_t* tensor, uint32_t row_stride,
+                                          uint32_t col_stride) {
+    rtka_gemm_operand_t op = { tensor->data, row_stride, col_stride, RTKA_GEMM_SIGNED, NULL };
+    if (rtka_tensor_is_soa(tensor)) {
+        op.data = tensor->values;
+        op.confidences = tensor->confidences;
+        op.format = RTKA_GEMM_PLANES;
+    }
+    return op;
+}
+
+/* Dense layer on the signed confidence plane through the blocked GEMM */
+rtka_error_t rtka_tensor_linear_into(rtka_tensor_t* out, const rtka_tensor_t* input,
+                                     const rtka_tensor_t* weight, const rtka_tensor_t* bias) {
+    if (!out || !input || !weight) return RTKA_ERROR_NULL_POINTER;
+    if (input->ndim == 0 || weight->ndim != 2) return RTKA_ERROR_INVALID_VALUE;
+    
+    /* Leading dimensions are rows: (batch, seq, hidden) maps every timestep */
+    uint32_t input_dim = input->shape[input->ndim - 1];
+    if (input_dim != weight->shape[0]) return RTKA_ERROR_INVALID_VALUE;
+    uint32_t rows = input->size / input_dim;
+    uint32_t output_dim = weight->shape[1];
+    if (out == input || out->size != rows * output_dim || out->shape[out->ndim - 1] != output_dim) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+    
+    /* Rows are strided views only in 2-D; more leading dims must collapse */
+    if (input->ndim > 2 && !rtka_tensor_is_contiguous(input)) return RTKA_ERROR_INVALID_VALUE;
+    if (out->ndim > 2 && !rtka_tensor_is_contiguous(out)) return RTKA_ERROR_INVALID_VALUE;
+    uint32_t out_row = out->ndim == 2 ? out->strides[0] : output_dim;
+    uint32_t out_col = out->strides[out->ndim - 1];
+    
+    float* sums = (float*)tensor_scratch((size_t)rows * output_dim * sizeof(float));
+    if (!sums) return RTKA_ERROR_OUT_OF_MEMORY;
+    
+    rtka_gemm_operand_t a_op = signed_operand(input, input->ndim == 2 ? input->strides[0] : input_dim,
+                                              input->strides[input->ndim - 1]);
+    rtka_gemm_operand_t b_op = signed_operand(weight, weight->strides[0], weight->strides[1]);
+    if (!rtka_tensor_is_soa(weight) && rtka_tensor_is_ternary(weight)) b_op.format = RTKA_GEMM_TERNARY;
+    rtka_gemm(rows, output_dim, input_dim, &a_op, &b_op, sums, output_dim, false);
+    
+    for (uint32_t r = 0; r < rows; r++) {
+        const float* row = sums + (size_t)r * output_dim;
+        for (uint32_t j = 0; j < output_dim; j++) {
+            float sum = row[j];
+            if (bias) {
+                rtka_state_t b_val = rtka_tensor_load(bias, j * bias->strides[bias->ndim - 1]);
+                sum += b_val.confidence * (rtka_confidence_t)b_val.value;
             }
+            rtka_tensor_store(out, r * out_row + j * out_col, rtka_make_state(
+                sum > 0.0f ? RTKA_TRUE : sum < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN,
+                fabsf(sum)));
         }
     }
     
-    return result;
+    return RTKA_SUCCESS;
+}
+
+rtka_tensor_t* rtka_tensor_linear(const rtka_tensor_t* input, const rtka_tensor_t* weight,
+                                  const rtka_tensor_t* bias) {
+    if (!input || !weight || input->ndim == 0 || weight->ndim != 2) return NULL;
+    
+    uint32_t input_dim = input->shape[input->ndim - 1];
+    if (input_dim != weight->shape[0]) return NULL;
+    
+    uint32_t out_shape[] = {input->size / input_dim, weight->shape[1]};
+    rtka_tensor_t* output = create_like(input, out_shape, 2);
+    return output ? finish(output, rtka_tensor_linear_into(output, input, weight, bias)) : NULL;
 }
 
-/* Reduce along axis */
+/* Reduce along axis - contiguous SoA uses the blocked vector reductions */
 rtka_state_t rtka_tensor_reduce_and(const rtka_tensor_t* tensor) {
     if (tensor->size == 0) return rtka_make_state(RTKA_TRUE, 1.0f);
     
-    rtka_state_t result = tensor->data[0];
+    rtka_vector_t vec;
+    if (rtka_tensor_as_vector(tensor, &vec)) return rtka_vector_reduce_and(&vec);
+    
+    rtka_state_t result = rtka_tensor_load(tensor, rtka_tensor_offset(tensor, 0));
     
     for (uint32_t i = 1; i < tensor->size; i++) {
         if (RTKA_UNLIKELY(result.value == RTKA_FALSE)) break;
-        result = rtka_combine_and(result, tensor->data[i]);
+        result = rtka_combine_and(result, rtka_tensor_load(tensor, rtka_tensor_offset(tensor, i)));
     }
     
     return result;
 }
 
+rtka_state_t rtka_tensor_reduce_or(const rtka_tensor_t* tensor) {
+    if (tensor->size == 0) return rtka_make_state(RTKA_FALSE, 1.0f);
+    
+    rtka_vector_t vec;
+    if (rtka_tensor_as_vector(tensor, &vec)) return rtka_vector_reduce_or(&vec);
+    
+    rtka_state_t result = rtka_tensor_load(tensor, rtka_tensor_offset(tensor, 0));
+    
+    for (uint32_t i = 1; i < tensor->size; i++) {
+        if (RTKA_UNLIKELY(result.value == RTKA_TRUE)) break;
+        result = rtka_combine_or(result, rtka_tensor_load(tensor, rtka_tensor_offset(tensor, i)));
+    }
+    
+    return result;
+}
+
+/* Reduce along axis - the axis is dropped from the shape (a 1-D input
+ * reduces to shape {1}). Each fiber is gathered into scratch unless it is
+ * already a contiguous AoS run. */
+static void reduced_shape(const rtka_tensor_t* tensor, uint32_t axis, uint32_t* shape, uint32_t* ndim) {
+    *ndim = 0;
+    for (uint32_t d = 0; d < tensor->ndim; d++) {
+        if (d != axis) shape[(*ndim)++] = tensor->shape[d];
+    }
+    if (*ndim == 0) shape[(*ndim)++] = 1;
+}
+
+rtka_error_t rtka_tensor_reduce_along_axis_into(rtka_tensor_t* out, const rtka_tensor_t* tensor, uint32_t axis,
+                                                rtka_state_t (*reduce_fn)(const rtka_state_t*, uint32_t)) {
+    if (!out || !tensor || !reduce_fn) return RTKA_ERROR_NULL_POINTER;
+    if (axis >= tensor->ndim || out == tensor) return RTKA_ERROR_INVALID_VALUE;
+    
+    uint32_t len = tensor->shape[axis];
+    uint32_t fibers = len ? tensor->size / len : 0;
+    if (out->size != fibers) return RTKA_ERROR_INVALID_VALUE;
+    
+    uint32_t stride = tensor->strides[axis];
+    bool direct = !rtka_tensor_is_soa(tensor) && stride == 1;
+    rtka_state_t* fiber = direct ? NULL : (rtka_state_t*)tensor_scratch((size_t)len * sizeof(rtka_state_t));
+    if (!direct && !fiber && len) return RTKA_ERROR_OUT_OF_MEMORY;
+    
+    /* Walk the other dims in index order, carrying the fiber base offset */
+    uint32_t idx[RTKA_MAX_DIMENSIONS] = {0};
+    uint32_t base = 0;
+    for (uint32_t f = 0; f < fibers; f++) {
+        if (direct) {
+            rtka_tensor_store(out, rtka_tensor_offset(out, f), reduce_fn(tensor->data + base, len));
+        } else {
+            for (uint32_t p = 0; p < len; p++) fiber[p] = rtka_tensor_load(tensor, base + p * stride);
+            rtka_tensor_store(out, rtka_tensor_offset(out, f), reduce_fn(fiber, len));
+        }
+        
+        for (int32_t d = (int32_t)tensor->ndim - 1; d >= 0; d--) {
+            if ((uint32_t)d == axis) continue;
+            base += tensor->strides[d];
+            if (++idx[d] < tensor->shape[d]) break;
+            base -= idx[d] * tensor->strides[d];
+            idx[d] = 0;
+        }
+    }
+    
+    return RTKA_SUCCESS;
+}
+
+rtka_tensor_t* rtka_tensor_reduce_along_axis(const rtka_tensor_t* tensor, uint32_t axis,
+                                            rtka_state_t (*reduce_fn)(const rtka_state_t*, uint32_t)) {
+    if (!tensor || axis >= tensor->ndim) return NULL;
+    
+    uint32_t shape[RTKA_MAX_DIMENSIONS];
+    uint32_t ndim = 0;
+    reduced_shape(tensor, axis, shape, &ndim);
+    rtka_tensor_t* result = create_like(tensor, shape, ndim);
+    return result ? finish(result, rtka_tensor_reduce_along_axis_into(result, tensor, axis, reduce_fn)) : NULL;
+}
+
+/* Confidence operations - an SoA tensor touches only its confidence plane */
+void rtka_tensor_apply_confidence(rtka_tensor_t* tensor, rtka_confidence_t (*fn)(rtka_confidence_t)) {
+    if (rtka_tensor_is_soa(tensor)) {
+        for (uint32_t i = 0; i < tensor->size; i++) {
+            uint32_t offset = rtka_tensor_offset(tensor, i);
+            tensor->confidences[offset] = fn(tensor->confidences[offset]);
+        }
+        return;
+    }
+    
+    for (uint32_t i = 0; i < tensor->size; i++) {
+        uint32_t offset = rtka_tensor_offset(tensor, i);
+        tensor->data[offset].confidence = fn(tensor->data[offset].confidence);
+    }
+}
+
+/* Clamp to [0, 1] */
+void rtka_tensor_normalize_confidence(rtka_tensor_t* tensor) {
+    rtka_vector_t vec;
+    if (rtka_tensor_as_vector(tensor, &vec)) {
+        rtka_vector_conf_normalize(&vec);
+        return;
+    }
+    
+    for (uint32_t i = 0; i < tensor->size; i++) {
+        uint32_t offset = rtka_tensor_offset(tensor, i);
+        rtka_state_t s = rtka_tensor_load(tensor, offset);
+        s.confidence = s.confidence < 0.0f ? 0.0f : s.confidence > 1.0f ? 1.0f : s.confidence;
+        rtka_tensor_store(tensor, offset, s);
+    }
+}
+
+/* Header plus element storage */
+size_t rtka_tensor_memory_size(const rtka_tensor_t* tensor) {
+    if (rtka_tensor_is_soa(tensor)) {
+        return sizeof(rtka_tensor_t) + 2U * soa_plane_bytes(tensor->size);
+    }
+    return sizeof(rtka_tensor_t) + (size_t)tensor->size * sizeof(rtka_state_t);
+}
+
 /* Check contiguous */
 bool rtka_tensor_is_contiguous(const rtka_tensor_t* tensor) {
     return (tensor->flags & RTKA_TENSOR_CONTIGUOUS) != 0;
 }
 
-/* Make contiguous */
+/* Shape operations - headers over the same storage */
+rtka_tensor_t* rtka_tensor_transpose(rtka_tensor_t* tensor, const uint32_t* axes) {
+    if (!tensor || !axes) return NULL;
+    
+    uint32_t seen = 0;
+    for (uint32_t d = 0; d < tensor->ndim; d++) {
+        if (axes[d] >= tensor->ndim || (seen & (1U << axes[d]))) return NULL;
+        seen |= 1U << axes[d];
+    }
+    
+    rtka_tensor_t* view = alias_header(tensor);
+    if (!view) return NULL;
+    for (uint32_t d = 0; d < tensor->ndim; d++) {
+        view->shape[d] = tensor->shape[axes[d]];
+        view->strides[d] = tensor->strides[axes[d]];
+    }
+    view->flags |= RTKA_TENSOR_TRANSPOSED;
+    update_contiguous(view);
+    return view;
+}
+
+rtka_tensor_t* rtka_tensor_reshape(rtka_tensor_t* tensor, const uint32_t* new_shape, uint32_t new_ndim) {
+    if (!tensor || new_ndim > RTKA_MAX_DIMENSIONS || !rtka_tensor_is_contiguous(tensor)) return NULL;
+    if (calculate_size(new_shape, new_ndim) != tensor->size) return NULL;
+    
+    rtka_tensor_t* view = alias_header(tensor);
+    if (!view) return NULL;
+    view->ndim = new_ndim;
+    memcpy(view->shape, new_shape, new_ndim * sizeof(uint32_t));
+    calculate_strides(view->strides, new_shape, new_ndim);
+    return view;
+}
+
+rtka_tensor_t* rtka_tensor_squeeze(rtka_tensor_t* tensor) {
+    if (!tensor) return NULL;
+    
+    rtka_tensor_t* view = alias_header(tensor);
+    if (!view) return NULL;
+    view->ndim = 0;
+    for (uint32_t d = 0; d < tensor->ndim; d++) {
+        if (tensor->shape[d] == 1) continue;
+        view->shape[view->ndim] = tensor->shape[d];
+        view->strides[view->ndim++] = tensor->strides[d];
+    }
+    if (view->ndim == 0) {
+        view->shape[0] = 1;
+        view->strides[0] = 1;
+        view->ndim = 1;
+    }
+    return view;
+}
+
+rtka_tensor_t* rtka_tensor_unsqueeze(rtka_tensor_t* tensor, uint32_t axis) {
+    if (!tensor || axis > tensor->ndim || tensor->ndim == RTKA_MAX_DIMENSIONS) return NULL;
+    
+    rtka_tensor_t* view = alias_header(tensor);
+    if (!view) return NULL;
+    for (uint32_t d = tensor->ndim; d > axis; d--) {
+        view->shape[d] = tensor->shape[d - 1];
+        view->strides[d] = tensor->strides[d - 1];
+    }
+    view->shape[axis] = 1;
+    view->strides[axis] = axis < tensor->ndim ? tensor->shape[axis] * tensor->strides[axis] : 1;
+    view->ndim = tensor->ndim + 1;
+    return view;
+}
+
+/* Slicing - [start, stop) per dim, strides of the base */
+rtka_tensor_view_t rtka_tensor_slice(const rtka_tensor_t* tensor, 
+                                     const uint32_t* start, 
+                                     const uint32_t* stop) {
+    rtka_tensor_view_t view = {
+        .data = tensor->data, .values = tensor->values, .confidences = tensor->confidences,
+        .offset = 0, .ndim = tensor->ndim
+    };
+    for (uint32_t d = 0; d < tensor->ndim; d++) {
+        uint32_t hi = stop[d] < tensor->shape[d] ? stop[d] : tensor->shape[d];
+        uint32_t lo = start[d] < hi ? start[d] : hi;
+        view.offset += lo * tensor->strides[d];
+        view.shape[d] = hi - lo;
+        view.strides[d] = tensor->strides[d];
+    }
+    return view;
+}
+
+rtka_tensor_t rtka_tensor_view_as_tensor(const rtka_tensor_view_t* view) {
+    rtka_tensor_t tensor;
+    memset(&tensor, 0, sizeof(tensor));
+    tensor.ndim = view->ndim;
+    memcpy(tensor.shape, view->shape, view->ndim * sizeof(uint32_t));
+    memcpy(tensor.strides, view->strides, view->ndim * sizeof(uint32_t));
+    tensor.size = calculate_size(view->shape, view->ndim);
+    if (view->data) {
+        tensor.data = view->data + view->offset;
+    } else {
+        tensor.values = view->values + view->offset;
+        tensor.confidences = view->confidences + view->offset;
+        tensor.flags = RTKA_TENSOR_SOA;
+    }
+    update_contiguous(&tensor);
+    return tensor;
+}
+
+rtka_tensor_t* rtka_tensor_from_view(const rtka_tensor_view_t* view) {
+    rtka_tensor_t tensor = rtka_tensor_view_as_tensor(view);
+    return tensor_convert(&tensor, rtka_tensor_is_soa(&tensor));
+}
+
+rtka_error_t rtka_tensor_copy_into(rtka_tensor_t* out, const rtka_tensor_t* src) {
+    if (!out || !src) return RTKA_ERROR_NULL_POINTER;
+    rtka_tensor_expr_t expr;
+    rtka_expr_init(&expr);
+    return rtka_expr_eval_into(&expr, rtka_expr_input(&expr, src), out);
+}
+
+/* Broadcasting - NumPy rules, dims aligned from the right */
+bool rtka_tensor_broadcast_compatible(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    uint32_t ndim = a->ndim < b->ndim ? a->ndim : b->ndim;
+    for (uint32_t i = 1; i <= ndim; i++) {
+        uint32_t da = a->shape[a->ndim - i], db = b->shape[b->ndim - i];
+        if (da != db && da != 1 && db != 1) return false;
+    }
+    return true;
+}
+
+void rtka_tensor_broadcast_shapes(const uint32_t* shape_a, uint32_t ndim_a,
+                                  const uint32_t* shape_b, uint32_t ndim_b,
+                                  uint32_t* out_shape, uint32_t* out_ndim) {
+    uint32_t ndim = ndim_a > ndim_b ? ndim_a : ndim_b;
+    for (uint32_t i = 1; i <= ndim; i++) {
+        uint32_t da = i <= ndim_a ? shape_a[ndim_a - i] : 1U;
+        uint32_t db = i <= ndim_b ? shape_b[ndim_b - i] : 1U;
+        if (da != db && da != 1 && db != 1) {
+            *out_ndim = 0;
+            return;
+        }
+        out_shape[ndim - i] = da == 1 ? db : da;
+    }
+    *out_ndim = ndim;
+}
+
+/* Make contiguous - gathers through a scratch block, data stays in place */
 void rtka_tensor_make_contiguous(rtka_tensor_t* tensor) {
     if (rtka_tensor_is_contiguous(tensor)) return;
     
-    rtka_state_t* new_data = rtka_alloc_states(tensor->size);
-    if (!new_data) return;
+    rtka_allocator_t* owner = NULL;
+    rtka_state_t* gathered = (rtka_state_t*)rtka_allocator_alloc(
+        NULL, (size_t)tensor->size * sizeof(rtka_state_t), &owner);
+    if (!gathered) return;
     
     /* Copy with new strides */
     uint32_t indices[RTKA_MAX_DIMENSIONS] = {0};
     
     for (uint32_t i = 0; i < tensor->size; i++) {
-        new_data[i] = *rtka_tensor_get(tensor, indices);
+        uint32_t offset = 0;
+        for (uint32_t d = 0; d < tensor->ndim; d++) offset += indices[d] * tensor->strides[d];
+        gathered[i] = rtka_tensor_load(tensor, offset);
         
         /* Increment indices */
         for (int32_t d = tensor->ndim - 1; d >= 0; d--) {
@@ -177,14 +896,21 @@ void rtka_tensor_make_contiguous(rtka_tensor_t* tensor) {
         }
     }
     
-    tensor->data = new_data;
+    if (rtka_tensor_is_soa(tensor)) {
+        for (uint32_t i = 0; i < tensor->size; i++) {
+            tensor->values[i] = gathered[i].value;
+            tensor->confidences[i] = gathered[i].confidence;
+        }
+    } else {
+        memcpy(tensor->data, gathered, (size_t)tensor->size * sizeof(rtka_state_t));
+    }
+    rtka_allocator_free(owner, gathered);
     calculate_strides(tensor->strides, tensor->shape, tensor->ndim);
     tensor->flags |= RTKA_TENSOR_CONTIGUOUS;
 }
 
-/* Free tensor */
+/* Free tensor - a no-op for tensors living in a step arena */
 void rtka_tensor_free(rtka_tensor_t* tensor) {
     if (!tensor) return;
-    /* Memory is managed by pool/stack allocators */
-    rtka_free_state((rtka_state_t*)tensor);
+    rtka_allocator_free(tensor->allocator, tensor);
 }
@@ -9,6 +9,19 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Tensor Operations - N-dimensional arrays for ML
+ *
+ * Storage is array-of-structs (data, one rtka_state_t per element) by
+ * default. With RTKA_TENSOR_SOA the tensor instead holds a value plane and
+ * a confidence plane, the rtka_vector_t layout, and data is NULL; strides
+ * index both planes alike. Tensor ops accept either layout and mixes of
+ * the two; results take the layout of the first operand. Layers and the
+ * autograd index data directly and stay on AoS tensors.
+ *
+ * Element (i0, i1, ...) lives at offset sum(i_d * strides[d]) from data
+ * (or the planes). Slices, transposes and reshapes are headers over the
+ * same storage, RTKA_TENSOR_CONTIGUOUS clear unless the strides happen to
+ * be row-major, and every op iterates them stride by stride - runs of the
+ * innermost dim when its stride is 1 - so they cost no copies.
  */
 
 #ifndef RTKA_TENSOR_H
@@ -22,10 +35,13 @@
 #define RTKA_TENSOR_CONTIGUOUS (1U << 0)
 #define RTKA_TENSOR_TRANSPOSED (1U << 1)
 #define RTKA_TENSOR_BROADCAST  (1U << 2)
+#define RTKA_TENSOR_SOA        (1U << 3)  /* values / confidences planes */
 
 /* Tensor structure - optimized for ML operations */
 typedef struct RTKA_ALIGNED(64) {
-    rtka_state_t* data;
+    rtka_state_t* data;                 /* AoS storage, NULL with RTKA_TENSOR_SOA */
+    rtka_value_t* values;               /* SoA planes, NULL otherwise */
+    rtka_confidence_t* confidences;
     uint32_t shape[RTKA_MAX_DIMENSIONS];
     uint32_t strides[RTKA_MAX_DIMENSIONS];
     uint32_t ndim;
@@ -34,29 +50,91 @@ typedef struct RTKA_ALIGNED(64) {
     rtka_allocator_t* allocator;
 } rtka_tensor_t;
 
-/* Tensor view for zero-copy operations */
+/* Tensor view for zero-copy operations - offset is in elements from data
+ * (or from both planes of an SoA base) */
 typedef struct {
     rtka_state_t* data;
+    rtka_value_t* values;
+    rtka_confidence_t* confidences;
     uint32_t offset;
     uint32_t shape[RTKA_MAX_DIMENSIONS];
     uint32_t strides[RTKA_MAX_DIMENSIONS];
     uint32_t ndim;
 } rtka_tensor_view_t;
 
-/* Creation and destruction */
+/* Creation and destruction - header and data are one block from the
+ * thread's current allocator (a step arena while one is open) */
 rtka_tensor_t* rtka_tensor_create(const uint32_t* shape, uint32_t ndim);
 rtka_tensor_t* rtka_tensor_zeros(const uint32_t* shape, uint32_t ndim);
 rtka_tensor_t* rtka_tensor_ones(const uint32_t* shape, uint32_t ndim);
 rtka_tensor_t* rtka_tensor_unknown(const uint32_t* shape, uint32_t ndim);
 void rtka_tensor_free(rtka_tensor_t* tensor);
 
-/* Shape operations */
+/* Explicit allocator, e.g. rtka_heap_allocator() for state that outlives a step */
+rtka_tensor_t* rtka_tensor_create_in(rtka_allocator_t* allocator, const uint32_t* shape, uint32_t ndim);
+rtka_tensor_t* rtka_tensor_zeros_in(rtka_allocator_t* allocator, const uint32_t* shape, uint32_t ndim);
+
+/* Structure-of-arrays storage - header and both planes in one block */
+rtka_tensor_t* rtka_tensor_create_soa(const uint32_t* shape, uint32_t ndim);
+rtka_tensor_t* rtka_tensor_create_soa_in(rtka_allocator_t* allocator, const uint32_t* shape, uint32_t ndim);
+
+/* Contiguous copies in the other layout */
+rtka_tensor_t* rtka_tensor_to_soa(const rtka_tensor_t* tensor);
+rtka_tensor_t* rtka_tensor_to_aos(const rtka_tensor_t* tensor);
+
+/* Zero-copy interop with rtka_vector_t
+ * as_vector: false unless the tensor is contiguous SoA.
+ * wrap_vector: a header aliasing vec's planes (vec->count elements);
+ * rtka_tensor_free releases the header only. */
+bool rtka_tensor_as_vector(const rtka_tensor_t* tensor, rtka_vector_t* vec);
+rtka_tensor_t* rtka_tensor_wrap_vector(const rtka_vector_t* vec, const uint32_t* shape, uint32_t ndim);
+
+/* Contiguous AoS header over external states (a model file mapping, say);
+ * rtka_tensor_free releases the header only */
+rtka_tensor_t* rtka_tensor_wrap(rtka_state_t* data, const uint32_t* shape, uint32_t ndim);
+
+RTKA_INLINE bool rtka_tensor_is_soa(const rtka_tensor_t* tensor) {
+    return (tensor->flags & RTKA_TENSOR_SOA) != 0;
+}
+
+/* Element at a storage offset (sum of index * stride), either layout */
+RTKA_INLINE rtka_state_t rtka_tensor_load(const rtka_tensor_t* tensor, uint32_t offset) {
+    if (rtka_tensor_is_soa(tensor)) {
+        return rtka_make_state(tensor->values[offset], tensor->confidences[offset]);
+    }
+    return tensor->data[offset];
+}
+
+RTKA_INLINE void rtka_tensor_store(rtka_tensor_t* tensor, uint32_t offset, rtka_state_t state) {
+    if (rtka_tensor_is_soa(tensor)) {
+        tensor->values[offset] = state.value;
+        tensor->confidences[offset] = state.confidence;
+    } else {
+        tensor->data[offset] = state;
+    }
+}
+
+/* Shape operations - new headers over tensor's storage, freed with
+ * rtka_tensor_free (which leaves the storage alone) before tensor is.
+ * axes permutes the dims (out dim d is input dim axes[d]); reshape needs a
+ * contiguous tensor of the same size. */
 rtka_tensor_t* rtka_tensor_reshape(rtka_tensor_t* tensor, const uint32_t* new_shape, uint32_t new_ndim);
 rtka_tensor_t* rtka_tensor_transpose(rtka_tensor_t* tensor, const uint32_t* axes);
 rtka_tensor_t* rtka_tensor_squeeze(rtka_tensor_t* tensor);
 rtka_tensor_t* rtka_tensor_unsqueeze(rtka_tensor_t* tensor, uint32_t axis);
 
-/* Element access - optimized for cache */
+/* Storage offset of the element at row-major position linear */
+RTKA_INLINE uint32_t rtka_tensor_offset(const rtka_tensor_t* tensor, uint32_t linear) {
+    if (RTKA_LIKELY(tensor->flags & RTKA_TENSOR_CONTIGUOUS)) return linear;
+    uint32_t offset = 0;
+    for (int32_t d = (int32_t)tensor->ndim - 1; d >= 0; d--) {
+        offset += (linear % tensor->shape[d]) * tensor->strides[d];
+        linear /= tensor->shape[d];
+    }
+    return offset;
+}
+
+/* Element access - optimized for cache; rtka_tensor_get is AoS only */
 RTKA_INLINE rtka_state_t* rtka_tensor_get(rtka_tensor_t* tensor, const uint32_t* indices) {
     uint32_t offset = 0;
     for (uint32_t i = 0; i < tensor->ndim; i++) {
@@ -70,36 +148,76 @@ RTKA_INLINE void rtka_tensor_set(rtka_tensor_t* tensor, const uint32_t* indices,
     for (uint32_t i = 0; i < tensor->ndim; i++) {
         offset += indices[i] * tensor->strides[i];
     }
-    tensor->data[offset] = value;
+    rtka_tensor_store(tensor, offset, value);
 }
 
-/* Tensor operations */
+/* Tensor operations - add and multiply act on the signed plane
+ * s = value * confidence, stored as (sign, |s|), and broadcast. For
+ * chains of element-wise ops see rtka_tensor_expr.h. */
 rtka_tensor_t* rtka_tensor_add(const rtka_tensor_t* a, const rtka_tensor_t* b);
 rtka_tensor_t* rtka_tensor_multiply(const rtka_tensor_t* a, const rtka_tensor_t* b);
 rtka_tensor_t* rtka_tensor_matmul(const rtka_tensor_t* a, const rtka_tensor_t* b);
 
+/* Dense layer: out(r, j) = sum_p s(in(r, p)) * s(w(p, j)) + s(bias(j)) with
+ * s = value * confidence, stored as (sign, |sum|). Leading input dims are
+ * rows; weight is (in, out), bias (out) or NULL. Ternary weights take the
+ * int8 panel path of rtka_gemm. */
+rtka_tensor_t* rtka_tensor_linear(const rtka_tensor_t* input, const rtka_tensor_t* weight,
+                                  const rtka_tensor_t* bias);
+bool rtka_tensor_is_ternary(const rtka_tensor_t* tensor);
+
 /* Ternary logic operations on tensors */
 rtka_tensor_t* rtka_tensor_and(const rtka_tensor_t* a, const rtka_tensor_t* b);
 rtka_tensor_t* rtka_tensor_or(const rtka_tensor_t* a, const rtka_tensor_t* b);
 rtka_tensor_t* rtka_tensor_not(const rtka_tensor_t* a);
 
-/* Reductions */
+/* Reductions - reduce_along_axis drops the axis (1-D reduces to {1}) */
 rtka_state_t rtka_tensor_reduce_and(const rtka_tensor_t* tensor);
 rtka_state_t rtka_tensor_reduce_or(const rtka_tensor_t* tensor);
 rtka_tensor_t* rtka_tensor_reduce_along_axis(const rtka_tensor_t* tensor, uint32_t axis, 
                                             rtka_state_t (*reduce_fn)(const rtka_state_t*, uint32_t));
 
-/* Broadcasting */
+/* Out-parameter variants - out is a caller-owned tensor or view of the
+ * result's shape, either layout, that is overwritten. Element-wise ops may
+ * take out == a (or == b when b is not broadcast); matmul, linear and the
+ * axis reduction need out distinct from their inputs. Nothing is
+ * allocated: matmul's plane split and linear's GEMM sums use a per-thread
+ * scratch that is kept between calls. */
+RTKA_NODISCARD rtka_error_t rtka_tensor_add_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_multiply_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_and_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_or_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_not_into(rtka_tensor_t* out, const rtka_tensor_t* a);
+RTKA_NODISCARD rtka_error_t rtka_tensor_matmul_into(rtka_tensor_t* out, const rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_linear_into(rtka_tensor_t* out, const rtka_tensor_t* input,
+                                                    const rtka_tensor_t* weight, const rtka_tensor_t* bias);
+RTKA_NODISCARD rtka_error_t rtka_tensor_reduce_along_axis_into(rtka_tensor_t* out, const rtka_tensor_t* tensor,
+                                                               uint32_t axis,
+                                                               rtka_state_t (*reduce_fn)(const rtka_state_t*, uint32_t));
+
+/* In-place variants - a op= b, b broadcast to a's shape */
+RTKA_NODISCARD rtka_error_t rtka_tensor_add_inplace(rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_multiply_inplace(rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_and_inplace(rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_or_inplace(rtka_tensor_t* a, const rtka_tensor_t* b);
+RTKA_NODISCARD rtka_error_t rtka_tensor_not_inplace(rtka_tensor_t* a);
+
+/* Broadcasting - out_ndim is 0 when the shapes are incompatible */
 bool rtka_tensor_broadcast_compatible(const rtka_tensor_t* a, const rtka_tensor_t* b);
 void rtka_tensor_broadcast_shapes(const uint32_t* shape_a, uint32_t ndim_a,
                                   const uint32_t* shape_b, uint32_t ndim_b,
                                   uint32_t* out_shape, uint32_t* out_ndim);
 
-/* Slicing and indexing */
+/* Slicing and indexing - slice keeps [start, stop) of every dim. A view
+ * goes to any op through rtka_tensor_view_as_tensor, a header on the
+ * stack that must not be freed; from_view copies to a new contiguous
+ * tensor. copy_into moves src into out, either may be strided. */
 rtka_tensor_view_t rtka_tensor_slice(const rtka_tensor_t* tensor, 
                                      const uint32_t* start, 
                                      const uint32_t* stop);
+rtka_tensor_t rtka_tensor_view_as_tensor(const rtka_tensor_view_t* view);
 rtka_tensor_t* rtka_tensor_from_view(const rtka_tensor_view_t* view);
+RTKA_NODISCARD rtka_error_t rtka_tensor_copy_into(rtka_tensor_t* out, const rtka_tensor_t* src);
 
 /* Confidence operations */
 void rtka_tensor_apply_confidence(rtka_tensor_t* tensor, rtka_confidence_t (*fn)(rtka_confidence_t));
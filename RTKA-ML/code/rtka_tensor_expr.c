@@ -0,0 +1,343 @@
+/**
+ * File: rtka_tensor_expr.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Tensor Expressions Implementation
+ */
+
+#include "rtka_tensor_expr.h"
+#include "rtka_threadpool.h"
+#include <string.h>
+#include <math.h>
+
+/* ============================================================================
+ * BUILDING
+ * ============================================================================ */
+
+void rtka_expr_init(rtka_tensor_expr_t* expr) {
+    expr->count = 0;
+    expr->error = RTKA_SUCCESS;
+}
+
+static rtka_expr_t fail(rtka_tensor_expr_t* expr, rtka_error_t error) {
+    if (expr->error == RTKA_SUCCESS) expr->error = error;
+    return RTKA_EXPR_INVALID;
+}
+
+static rtka_expr_t push_node(rtka_tensor_expr_t* expr, rtka_expr_op_t op, rtka_expr_t lhs,
+                             rtka_expr_t rhs, const rtka_tensor_t* tensor,
+                             const uint32_t* shape, uint32_t ndim) {
+    if (expr->count == RTKA_EXPR_MAX_NODES) return fail(expr, RTKA_ERROR_OVERFLOW);
+
+    rtka_expr_node_t* node = &expr->nodes[expr->count];
+    node->op = op;
+    node->lhs = lhs;
+    node->rhs = rhs;
+    node->tensor = tensor;
+    memcpy(node->shape, shape, ndim * sizeof(uint32_t));
+    node->ndim = ndim;
+    return expr->count++;
+}
+
+rtka_expr_t rtka_expr_input(rtka_tensor_expr_t* expr, const rtka_tensor_t* tensor) {
+    if (expr->error != RTKA_SUCCESS) return RTKA_EXPR_INVALID;
+    if (!tensor) return fail(expr, RTKA_ERROR_NULL_POINTER);
+    return push_node(expr, RTKA_EXPR_INPUT, RTKA_EXPR_INVALID, RTKA_EXPR_INVALID,
+                     tensor, tensor->shape, tensor->ndim);
+}
+
+static rtka_expr_t push_binary(rtka_tensor_expr_t* expr, rtka_expr_op_t op,
+                               rtka_expr_t a, rtka_expr_t b) {
+    if (expr->error != RTKA_SUCCESS) return RTKA_EXPR_INVALID;
+    if (a >= expr->count || b >= expr->count) return fail(expr, RTKA_ERROR_INVALID_VALUE);
+
+    const rtka_expr_node_t* na = &expr->nodes[a];
+    const rtka_expr_node_t* nb = &expr->nodes[b];
+    uint32_t shape[RTKA_MAX_DIMENSIONS];
+    uint32_t ndim = 0;
+    rtka_tensor_broadcast_shapes(na->shape, na->ndim, nb->shape, nb->ndim, shape, &ndim);
+    if (ndim == 0 && (na->ndim | nb->ndim) != 0) return fail(expr, RTKA_ERROR_INVALID_VALUE);
+
+    return push_node(expr, op, a, b, NULL, shape, ndim);
+}
+
+rtka_expr_t rtka_expr_and(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b) {
+    return push_binary(expr, RTKA_EXPR_AND, a, b);
+}
+
+rtka_expr_t rtka_expr_or(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b) {
+    return push_binary(expr, RTKA_EXPR_OR, a, b);
+}
+
+rtka_expr_t rtka_expr_add(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b) {
+    return push_binary(expr, RTKA_EXPR_ADD, a, b);
+}
+
+rtka_expr_t rtka_expr_mul(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b) {
+    return push_binary(expr, RTKA_EXPR_MUL, a, b);
+}
+
+rtka_expr_t rtka_expr_not(rtka_tensor_expr_t* expr, rtka_expr_t a) {
+    if (expr->error != RTKA_SUCCESS) return RTKA_EXPR_INVALID;
+    if (a >= expr->count) return fail(expr, RTKA_ERROR_INVALID_VALUE);
+
+    const rtka_expr_node_t* na = &expr->nodes[a];
+    return push_node(expr, RTKA_EXPR_NOT, a, RTKA_EXPR_INVALID, NULL, na->shape, na->ndim);
+}
+
+/* ============================================================================
+ * FUSED EVALUATION
+ * ============================================================================ */
+
+typedef struct {
+    const rtka_tensor_expr_t* expr;
+    rtka_tensor_t* out;
+    rtka_expr_t root;
+    uint32_t live[RTKA_EXPR_MAX_NODES];     /* Nodes reaching root, in build order */
+    uint32_t live_count;
+    /* Per input: element strides against the output shape, 0 on broadcast
+     * dims; linear when the input is contiguous and of the output shape */
+    uint32_t strides[RTKA_EXPR_MAX_NODES][RTKA_MAX_DIMENSIONS];
+    bool linear[RTKA_EXPR_MAX_NODES];
+} rtka_expr_job_t;
+
+/* Splits output positions [start, start + len) into runs of consecutive
+ * storage for an operand with the given per-dim strides (0 = broadcast).
+ * A unit innermost stride yields one run per output row, anything else one
+ * run per element. Returns the run count (at most len). */
+static uint32_t block_runs(const rtka_tensor_t* out, const uint32_t* strides, uint32_t start,
+                           uint32_t len, uint32_t* run_offset, uint32_t* run_len) {
+    uint32_t ndim = out->ndim;
+    uint32_t idx[RTKA_MAX_DIMENSIONS];
+    uint32_t offset = 0, rest = start;
+    for (int32_t d = (int32_t)ndim - 1; d >= 0; d--) {
+        idx[d] = rest % out->shape[d];
+        rest /= out->shape[d];
+        offset += idx[d] * strides[d];
+    }
+    
+    uint32_t last = ndim ? ndim - 1U : 0U;
+    bool unit = ndim > 0 && strides[last] == 1;
+    uint32_t runs = 0;
+    for (uint32_t i = 0; i < len;) {
+        uint32_t run = 1;
+        if (unit) {
+            run = out->shape[last] - idx[last];
+            if (run > len - i) run = len - i;
+        }
+        run_offset[runs] = offset;
+        run_len[runs++] = run;
+        i += run;
+        if (ndim == 0) break;
+        
+        /* Step run positions along the innermost dim, then carry */
+        idx[last] += run - 1U;
+        offset += (run - 1U) * strides[last];
+        for (int32_t d = (int32_t)last; d >= 0; d--) {
+            offset += strides[d];
+            if (++idx[d] < out->shape[d]) break;
+            offset -= idx[d] * strides[d];
+            idx[d] = 0;
+        }
+    }
+    return runs;
+}
+
+static void load_input(const rtka_expr_job_t* job, uint32_t node, uint32_t start, uint32_t len,
+                       rtka_value_t* RTKA_RESTRICT values, float* RTKA_RESTRICT confs) {
+    const rtka_tensor_t* t = job->expr->nodes[node].tensor;
+    uint32_t run_offset[RTKA_EXPR_BLOCK], run_len[RTKA_EXPR_BLOCK];
+    uint32_t runs = 1;
+    run_offset[0] = start;
+    run_len[0] = len;
+    if (!job->linear[node]) {
+        runs = block_runs(job->out, job->strides[node], start, len, run_offset, run_len);
+    }
+    
+    for (uint32_t r = 0, i = 0; r < runs; i += run_len[r++]) {
+        if (rtka_tensor_is_soa(t)) {
+            memcpy(values + i, t->values + run_offset[r], run_len[r] * sizeof(rtka_value_t));
+            memcpy(confs + i, t->confidences + run_offset[r], run_len[r] * sizeof(float));
+        } else {
+            const rtka_state_t* src = t->data + run_offset[r];
+            for (uint32_t p = 0; p < run_len[r]; p++) {
+                values[i + p] = src[p].value;
+                confs[i + p] = src[p].confidence;
+            }
+        }
+    }
+}
+
+static void store_output(const rtka_expr_job_t* job, uint32_t start, uint32_t len,
+                         const rtka_value_t* RTKA_RESTRICT values, const float* RTKA_RESTRICT confs) {
+    rtka_tensor_t* out = job->out;
+    uint32_t run_offset[RTKA_EXPR_BLOCK], run_len[RTKA_EXPR_BLOCK];
+    uint32_t runs = 1;
+    run_offset[0] = start;
+    run_len[0] = len;
+    if (!rtka_tensor_is_contiguous(out)) {
+        runs = block_runs(out, out->strides, start, len, run_offset, run_len);
+    }
+    
+    for (uint32_t r = 0, i = 0; r < runs; i += run_len[r++]) {
+        if (rtka_tensor_is_soa(out)) {
+            memcpy(out->values + run_offset[r], values + i, run_len[r] * sizeof(rtka_value_t));
+            memcpy(out->confidences + run_offset[r], confs + i, run_len[r] * sizeof(float));
+        } else {
+            rtka_state_t* dst = out->data + run_offset[r];
+            for (uint32_t p = 0; p < run_len[r]; p++) dst[p] = rtka_make_state(values[i + p], confs[i + p]);
+        }
+    }
+}
+
+static void expr_blocks(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const rtka_expr_job_t* job = (const rtka_expr_job_t*)ctx;
+    const rtka_expr_node_t* nodes = job->expr->nodes;
+    rtka_tensor_t* out = job->out;
+
+    /* One value / confidence slot per node: 16 KB, stays in L1 */
+    RTKA_ALIGNED(64) rtka_value_t values[RTKA_EXPR_MAX_NODES][RTKA_EXPR_BLOCK];
+    RTKA_ALIGNED(64) float confs[RTKA_EXPR_MAX_NODES][RTKA_EXPR_BLOCK];
+
+    for (uint32_t blk = begin; blk < end; blk++) {
+        uint32_t start = blk * RTKA_EXPR_BLOCK;
+        uint32_t len = out->size - start < RTKA_EXPR_BLOCK ? out->size - start : RTKA_EXPR_BLOCK;
+
+        for (uint32_t l = 0; l < job->live_count; l++) {
+            uint32_t n = job->live[l];
+            const rtka_expr_node_t* node = &nodes[n];
+            rtka_value_t* RTKA_RESTRICT v = values[n];
+            float* RTKA_RESTRICT c = confs[n];
+            const rtka_value_t* va = node->lhs != RTKA_EXPR_INVALID ? values[node->lhs] : NULL;
+            const float* ca = node->lhs != RTKA_EXPR_INVALID ? confs[node->lhs] : NULL;
+            const rtka_value_t* vb = node->rhs != RTKA_EXPR_INVALID ? values[node->rhs] : NULL;
+            const float* cb = node->rhs != RTKA_EXPR_INVALID ? confs[node->rhs] : NULL;
+
+            switch (node->op) {
+                case RTKA_EXPR_INPUT:
+                    load_input(job, n, start, len, v, c);
+                    break;
+                case RTKA_EXPR_AND:
+                    for (uint32_t i = 0; i < len; i++) {
+                        v[i] = va[i] < vb[i] ? va[i] : vb[i];
+                        c[i] = ca[i] * cb[i];
+                    }
+                    break;
+                case RTKA_EXPR_OR:
+                    for (uint32_t i = 0; i < len; i++) {
+                        v[i] = va[i] > vb[i] ? va[i] : vb[i];
+                        c[i] = ca[i] + cb[i] - ca[i] * cb[i];
+                    }
+                    break;
+                case RTKA_EXPR_NOT:
+                    for (uint32_t i = 0; i < len; i++) {
+                        v[i] = -va[i];
+                        c[i] = ca[i];
+                    }
+                    break;
+                case RTKA_EXPR_ADD:
+                    for (uint32_t i = 0; i < len; i++) {
+                        float s = (float)va[i] * ca[i] + (float)vb[i] * cb[i];
+                        v[i] = (rtka_value_t)((s > 0.0f) - (s < 0.0f));
+                        c[i] = fabsf(s);
+                    }
+                    break;
+                case RTKA_EXPR_MUL:
+                    for (uint32_t i = 0; i < len; i++) {
+                        float s = (float)va[i] * ca[i] * (float)vb[i] * cb[i];
+                        v[i] = (rtka_value_t)((s > 0.0f) - (s < 0.0f));
+                        c[i] = fabsf(s);
+                    }
+                    break;
+            }
+        }
+
+        store_output(job, start, len, values[job->root], confs[job->root]);
+    }
+}
+
+rtka_error_t rtka_expr_eval_into(const rtka_tensor_expr_t* expr, rtka_expr_t root,
+                                 rtka_tensor_t* out) {
+    if (!expr || !out) return RTKA_ERROR_NULL_POINTER;
+    if (expr->error != RTKA_SUCCESS) return expr->error;
+    if (root >= expr->count) return RTKA_ERROR_INVALID_VALUE;
+
+    const rtka_expr_node_t* top = &expr->nodes[root];
+    if (out->ndim != top->ndim ||
+        memcmp(out->shape, top->shape, top->ndim * sizeof(uint32_t)) != 0) {
+        return RTKA_ERROR_INVALID_VALUE;
+    }
+
+    rtka_expr_job_t job = { .expr = expr, .out = out, .root = root };
+
+    /* Children precede parents, so one backward sweep marks everything live */
+    bool live[RTKA_EXPR_MAX_NODES] = {false};
+    live[root] = true;
+    for (int32_t n = (int32_t)root; n >= 0; n--) {
+        if (!live[n]) continue;
+        if (expr->nodes[n].lhs != RTKA_EXPR_INVALID) live[expr->nodes[n].lhs] = true;
+        if (expr->nodes[n].rhs != RTKA_EXPR_INVALID) live[expr->nodes[n].rhs] = true;
+    }
+
+    for (uint32_t n = 0; n <= root; n++) {
+        if (!live[n]) continue;
+        job.live[job.live_count++] = n;
+
+        const rtka_expr_node_t* node = &expr->nodes[n];
+        if (node->op != RTKA_EXPR_INPUT) continue;
+
+        /* Right-align the input's dims against the output's */
+        const rtka_tensor_t* t = node->tensor;
+        uint32_t lead = out->ndim - t->ndim;
+        bool linear = rtka_tensor_is_contiguous(t) && t->ndim == out->ndim;
+        for (uint32_t d = 0; d < out->ndim; d++) {
+            uint32_t stride = 0;
+            if (d >= lead && t->shape[d - lead] != 1) stride = t->strides[d - lead];
+            if (d < lead || t->shape[d - lead] != out->shape[d]) linear = false;
+            job.strides[n][d] = stride;
+        }
+        job.linear[n] = linear;
+    }
+
+    uint32_t blocks = (out->size + RTKA_EXPR_BLOCK - 1U) / RTKA_EXPR_BLOCK;
+    rtka_thread_pool_t* pool = rtka_pool_default();
+    if (pool && rtka_pool_size(pool) > 0 && out->size >= 2U * RTKA_PARALLEL_MIN_CHUNK) {
+        rtka_pool_parallel_for(pool, 0, blocks, RTKA_PARALLEL_MIN_CHUNK / RTKA_EXPR_BLOCK,
+                               expr_blocks, &job);
+    } else {
+        expr_blocks(&job, 0, blocks, 0);
+    }
+
+    return RTKA_SUCCESS;
+}
+
+rtka_tensor_t* rtka_expr_eval(const rtka_tensor_expr_t* expr, rtka_expr_t root) {
+    if (!expr || expr->error != RTKA_SUCCESS || root >= expr->count) return NULL;
+
+    /* Layout of the first input */
+    bool soa = false;
+    for (uint32_t n = 0; n <= root; n++) {
+        if (expr->nodes[n].op == RTKA_EXPR_INPUT) {
+            soa = rtka_tensor_is_soa(expr->nodes[n].tensor);
+            break;
+        }
+    }
+
+    const rtka_expr_node_t* top = &expr->nodes[root];
+    rtka_tensor_t* out = soa ? rtka_tensor_create_soa(top->shape, top->ndim)
+                             : rtka_tensor_create(top->shape, top->ndim);
+    if (!out) return NULL;
+
+    if (rtka_expr_eval_into(expr, root, out) != RTKA_SUCCESS) {
+        rtka_tensor_free(out);
+        return NULL;
+    }
+    return out;
+}
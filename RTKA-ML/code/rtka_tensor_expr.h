@@ -0,0 +1,91 @@
+/**
+ * File: rtka_tensor_expr.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Tensor Expressions - lazily recorded element-wise chains executed
+ * as one fused loop with one output allocation
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial expression builder
+ *          AND / OR / NOT / ADD / MUL nodes over tensor inputs of either
+ *          layout, NumPy-style broadcasting checked at build time
+ *          Evaluation walks the output in RTKA_EXPR_BLOCK element blocks;
+ *          every live node of a block is computed into L1-resident
+ *          value / confidence scratch, so memory is read once per input
+ *          and written once for the result
+ * v1.0.1 - Strided inputs and outputs (views) move in runs of the
+ *          innermost dim when its stride is 1, element-wise otherwise
+ *
+ *   rtka_tensor_expr_t e;
+ *   rtka_expr_init(&e);
+ *   rtka_expr_t x = rtka_expr_or(&e, rtka_expr_not(&e, rtka_expr_and(&e,
+ *                       rtka_expr_input(&e, a), rtka_expr_input(&e, b))),
+ *                       rtka_expr_input(&e, c));
+ *   rtka_tensor_t* out = rtka_expr_eval(&e, x);
+ *
+ * The builder lives on the stack and allocates nothing; input tensors are
+ * borrowed until evaluation. Build errors are sticky: once a node fails
+ * (bad shape, full builder) every later handle is RTKA_EXPR_INVALID and
+ * evaluation reports the first error.
+ */
+
+#ifndef RTKA_TENSOR_EXPR_H
+#define RTKA_TENSOR_EXPR_H
+
+#include "rtka_tensor.h"
+
+#define RTKA_EXPR_MAX_NODES 32U
+#define RTKA_EXPR_BLOCK     64U     /* Elements per fused block */
+#define RTKA_EXPR_INVALID   UINT32_MAX
+
+typedef uint32_t rtka_expr_t;       /* Node handle */
+
+typedef enum {
+    RTKA_EXPR_INPUT,
+    RTKA_EXPR_AND,      /* min, conf a * b */
+    RTKA_EXPR_OR,       /* max, conf a + b - ab */
+    RTKA_EXPR_NOT,      /* -v, conf unchanged */
+    RTKA_EXPR_ADD,      /* signed plane sum, (sign, |sum|) */
+    RTKA_EXPR_MUL       /* signed plane product, (sign, |product|) */
+} rtka_expr_op_t;
+
+typedef struct {
+    rtka_expr_op_t op;
+    rtka_expr_t lhs;
+    rtka_expr_t rhs;
+    const rtka_tensor_t* tensor;    /* RTKA_EXPR_INPUT */
+    uint32_t shape[RTKA_MAX_DIMENSIONS];
+    uint32_t ndim;
+} rtka_expr_node_t;
+
+typedef struct {
+    rtka_expr_node_t nodes[RTKA_EXPR_MAX_NODES];
+    uint32_t count;
+    rtka_error_t error;
+} rtka_tensor_expr_t;
+
+void rtka_expr_init(rtka_tensor_expr_t* expr);
+
+rtka_expr_t rtka_expr_input(rtka_tensor_expr_t* expr, const rtka_tensor_t* tensor);
+rtka_expr_t rtka_expr_and(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b);
+rtka_expr_t rtka_expr_or(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b);
+rtka_expr_t rtka_expr_not(rtka_tensor_expr_t* expr, rtka_expr_t a);
+rtka_expr_t rtka_expr_add(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b);
+rtka_expr_t rtka_expr_mul(rtka_tensor_expr_t* expr, rtka_expr_t a, rtka_expr_t b);
+
+/* New tensor of root's shape, SoA when the first input is SoA; NULL on a
+ * build error or allocation failure */
+RTKA_NODISCARD rtka_tensor_t* rtka_expr_eval(const rtka_tensor_expr_t* expr, rtka_expr_t root);
+
+/* Into an existing tensor or view of root's shape. out may be one of the
+ * inputs as long as that input is not broadcast. */
+RTKA_NODISCARD rtka_error_t rtka_expr_eval_into(const rtka_tensor_expr_t* expr, rtka_expr_t root,
+                                                rtka_tensor_t* out);
+
+#endif /* RTKA_TENSOR_EXPR_H */
@@ -0,0 +1,908 @@
+/**
+ * File: rtka_threadpool.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Persistent Thread Pool Implementation
+ */
+
+#define _GNU_SOURCE
+#include "rtka_threadpool.h"
+#include "rtka_constants.h"
+#include "rtka_trace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RTKA_POOL_QUEUE_SIZE 1024U
+#define RTKA_POOL_MAX_NODES 64U
+#define RTKA_POOL_MAX_CPUS 1024U
+#define RTKA_POOL_DEQUE_INITIAL 256U     /* Per-worker deque slots, power of two, grows */
+#define RTKA_POOL_SPIN_ROUNDS 64U        /* Failed find-work rounds before parking */
+#define RTKA_POOL_FREE_TASKS_MAX 1024U   /* Recycled spawned tasks kept per worker */
+
+typedef struct {
+    rtka_task_fn fn;
+    void* arg;
+} rtka_task_t;
+
+/* Spawned task: fn(arg), or range(arg, begin, end, worker) split on the way */
+typedef struct rtka_spawned rtka_spawned_t;
+struct rtka_spawned {
+    rtka_task_fn fn;
+    rtka_range_fn range;
+    void* arg;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t grain;
+    rtka_task_group_t* group;
+    rtka_spawned_t* next;                /* Free list / injection list link */
+};
+
+/* Circular array; replaced arrays stay alive until destroy, thieves may still read them */
+typedef struct rtka_deque_ring rtka_deque_ring_t;
+struct rtka_deque_ring {
+    int64_t mask;
+    rtka_deque_ring_t* older;
+    _Atomic(rtka_spawned_t*) slots[];
+};
+
+/* Chase-Lev deque: owner pushes and takes at bottom, thieves steal at top */
+typedef struct {
+    RTKA_ALIGNED(RTKA_CACHE_LINE_SIZE) atomic_int_fast64_t top;
+    RTKA_ALIGNED(RTKA_CACHE_LINE_SIZE) atomic_int_fast64_t bottom;
+    _Atomic(rtka_deque_ring_t*) ring;
+} rtka_deque_t;
+
+/* Per-thread identity: lets nested parallel_for run inline */
+typedef struct RTKA_ALIGNED(RTKA_CACHE_LINE_SIZE) {
+    struct rtka_thread_pool* pool;
+    uint32_t index;
+    rtka_deque_t deque;
+    uint64_t rng;
+    rtka_spawned_t* free_tasks;
+    uint32_t free_count;
+    /* Owner-written counters */
+    atomic_uint_fast64_t executed;
+    atomic_uint_fast64_t stolen;
+    atomic_uint_fast64_t grows;
+} rtka_worker_arg_t;
+
+struct rtka_thread_pool {
+    rtka_worker_arg_t workers[RTKA_POOL_MAX_THREADS];
+    pthread_t threads[RTKA_POOL_MAX_THREADS];
+    uint32_t worker_node[RTKA_POOL_MAX_THREADS];
+    uint32_t num_threads;
+    uint32_t num_deques;                 /* Set before any worker starts; steal victims */
+
+    /* Bounded FIFO of submitted tasks, guarded by lock; queued is also
+     * read without the lock by spinning workers */
+    pthread_mutex_t lock;
+    pthread_cond_t has_work;
+    pthread_cond_t has_space;
+    pthread_cond_t idle;
+    rtka_task_t queue[RTKA_POOL_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    _Atomic uint32_t queued;
+    uint32_t running;
+    bool shutdown;
+
+    /* Spawns from threads without a deque, guarded by lock */
+    rtka_spawned_t* inject_head;
+    rtka_spawned_t* inject_tail;
+    atomic_uint inject_count;
+
+    atomic_uint epoch;                   /* Bumped on every spawn */
+    atomic_uint sleepers;
+    pthread_cond_t drained;              /* A group reached zero while outside threads blocked */
+    atomic_uint outside_waiters;
+    atomic_flag caller_slot;             /* Held by the one outside thread helping as worker 0 */
+
+    atomic_uint_fast64_t caller_executed;
+    atomic_uint_fast64_t caller_stolen;
+    atomic_uint_fast64_t injected;
+};
+
+static _Thread_local const rtka_worker_arg_t* rtka_tls_worker = NULL;
+static _Thread_local const rtka_thread_pool_t* rtka_tls_caller_pool = NULL;
+static _Thread_local uint64_t rtka_tls_caller_rng = 0x9E3779B97F4A7C15ULL;
+
+/* Calling thread's participant index in pool: its worker index when it is
+ * one of pool's workers, else 0. Callers size per-worker state from the
+ * pool they pass, so an index from another pool must never leak through. */
+static uint32_t worker_index_in(const rtka_thread_pool_t* pool) {
+    return rtka_tls_worker && rtka_tls_worker->pool == pool ? rtka_tls_worker->index : 0U;
+}
+
+/* Worker record of the calling thread when it belongs to pool */
+static rtka_worker_arg_t* own_worker(rtka_thread_pool_t* pool) {
+    return rtka_tls_worker && rtka_tls_worker->pool == pool ? &pool->workers[rtka_tls_worker->index - 1U] : NULL;
+}
+
+/* ============================================================================
+ * TOPOLOGY
+ * ============================================================================ */
+
+typedef struct {
+    uint32_t cpus[RTKA_POOL_MAX_CPUS];
+    uint32_t nodes[RTKA_POOL_MAX_CPUS];
+    uint32_t count;
+} rtka_cpu_order_t;
+
+/* Parse a sysfs cpulist ("0-3,8,10-11"), tagging each CPU with its node */
+static void parse_cpulist(const char* list, uint32_t node, uint32_t* cpu_node) {
+    const char* p = list;
+    while (*p) {
+        char* end;
+        unsigned long lo = strtoul(p, &end, 10);
+        if (end == p) break;
+        unsigned long hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtoul(p, &end, 10);
+        }
+        for (unsigned long c = lo; c <= hi && c < RTKA_POOL_MAX_CPUS; c++) {
+            cpu_node[c] = node;
+        }
+        p = (*end == ',') ? end + 1 : end;
+        if (*p == '\n') break;
+    }
+}
+
+/* CPUs allowed for this process, grouped by NUMA node */
+static void build_cpu_order(rtka_cpu_order_t* order, bool spread) {
+    uint32_t cpu_node[RTKA_POOL_MAX_CPUS] = {0};   /* CPUs absent from sysfs: node 0 */
+
+    uint32_t num_nodes = 0;
+    for (uint32_t n = 0; n < RTKA_POOL_MAX_NODES; n++) {
+        char path[64];
+        char buf[512];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", n);
+        FILE* f = fopen(path, "r");
+        if (!f) continue;
+        if (fgets(buf, sizeof(buf), f)) {
+            parse_cpulist(buf, n, cpu_node);
+            num_nodes = n + 1;
+        }
+        fclose(f);
+    }
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        for (uint32_t c = 0; c < CPU_SETSIZE; c++) CPU_SET(c, &allowed);
+    }
+
+    if (num_nodes == 0) num_nodes = 1;
+
+    /* Compact: node 0's CPUs, then node 1's, ... */
+    uint32_t node_start[RTKA_POOL_MAX_NODES + 1U] = {0};
+    order->count = 0;
+    for (uint32_t n = 0; n < num_nodes; n++) {
+        node_start[n] = order->count;
+        for (uint32_t c = 0; c < RTKA_POOL_MAX_CPUS && c < CPU_SETSIZE; c++) {
+            if (!CPU_ISSET(c, &allowed) || cpu_node[c] != n) continue;
+            order->cpus[order->count] = c;
+            order->nodes[order->count] = n;
+            order->count++;
+        }
+    }
+    node_start[num_nodes] = order->count;
+    if (!spread || num_nodes == 1) return;
+
+    /* Spread: interleave, taking the r-th CPU of every node in turn */
+    rtka_cpu_order_t* compact = malloc(sizeof(rtka_cpu_order_t));
+    if (!compact) return;
+    memcpy(compact, order, sizeof(rtka_cpu_order_t));
+
+    uint32_t out = 0;
+    for (uint32_t r = 0; out < compact->count; r++) {
+        for (uint32_t n = 0; n < num_nodes; n++) {
+            uint32_t idx = node_start[n] + r;
+            if (idx >= node_start[n + 1U]) continue;
+            order->cpus[out] = compact->cpus[idx];
+            order->nodes[out] = compact->nodes[idx];
+            out++;
+        }
+    }
+    free(compact);
+}
+
+/* ============================================================================
+ * CHASE-LEV DEQUE
+ * C11 fencing after Le et al., "Correct and Efficient Work-Stealing for
+ * Weak Memory Models" (PPoPP'13)
+ * ============================================================================ */
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static inline void counter_inc(atomic_uint_fast64_t* counter) {
+    /* Single writer: a plain load/store pair avoids a locked RMW */
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + 1U,
+                          memory_order_relaxed);
+}
+
+static inline uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static rtka_deque_ring_t* ring_create(int64_t capacity) {
+    rtka_deque_ring_t* ring = malloc(sizeof(rtka_deque_ring_t) + (size_t)capacity * sizeof(_Atomic(rtka_spawned_t*)));
+    if (!ring) return NULL;
+    ring->mask = capacity - 1;
+    ring->older = NULL;
+    for (int64_t i = 0; i < capacity; i++) atomic_init(&ring->slots[i], NULL);
+    return ring;
+}
+
+static bool deque_init(rtka_deque_t* dq) {
+    rtka_deque_ring_t* ring = ring_create((int64_t)RTKA_POOL_DEQUE_INITIAL);
+    if (!ring) return false;
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+    atomic_init(&dq->ring, ring);
+    return true;
+}
+
+static void deque_destroy(rtka_deque_t* dq) {
+    rtka_deque_ring_t* ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    while (ring) {
+        rtka_deque_ring_t* older = ring->older;
+        free(ring);
+        ring = older;
+    }
+}
+
+/* Owner only: double the ring, copying the live range [t, b) */
+static rtka_deque_ring_t* deque_grow(rtka_deque_t* dq, rtka_deque_ring_t* ring, int64_t t, int64_t b) {
+    rtka_deque_ring_t* bigger = ring_create((ring->mask + 1) * 2);
+    if (!bigger) return NULL;
+    for (int64_t i = t; i < b; i++) {
+        atomic_store_explicit(&bigger->slots[i & bigger->mask],
+                              atomic_load_explicit(&ring->slots[i & ring->mask], memory_order_relaxed),
+                              memory_order_relaxed);
+    }
+    bigger->older = ring;
+    atomic_store_explicit(&dq->ring, bigger, memory_order_release);
+    return bigger;
+}
+
+/* Owner only */
+static bool deque_push(rtka_worker_arg_t* self, rtka_spawned_t* task) {
+    rtka_deque_t* dq = &self->deque;
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    rtka_deque_ring_t* ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+
+    if (RTKA_UNLIKELY(b - t > ring->mask)) {
+        ring = deque_grow(dq, ring, t, b);
+        if (!ring) return false;
+        counter_inc(&self->grows);
+    }
+    atomic_store_explicit(&ring->slots[b & ring->mask], task, memory_order_relaxed);
+    /* Release store in place of the paper's fence + relaxed store: same cost
+     * on x86, and visible to ThreadSanitizer */
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+/* Owner only: newest task (LIFO) */
+static rtka_spawned_t* deque_take(rtka_deque_t* dq) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    rtka_deque_ring_t* ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    rtka_spawned_t* task = atomic_load_explicit(&ring->slots[b & ring->mask], memory_order_relaxed);
+    if (t == b) {
+        /* Last task: race thieves for it */
+        int64_t expected = t;
+        if (!atomic_compare_exchange_strong_explicit(&dq->top, &expected, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+/* Any thread: oldest task (FIFO); *contended set when another thread won the race */
+static rtka_spawned_t* deque_steal(rtka_deque_t* dq, bool* contended) {
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+
+    if (t >= b) return NULL;
+
+    rtka_deque_ring_t* ring = atomic_load_explicit(&dq->ring, memory_order_acquire);
+    rtka_spawned_t* task = atomic_load_explicit(&ring->slots[t & ring->mask], memory_order_relaxed);
+    int64_t expected = t;
+    if (!atomic_compare_exchange_strong_explicit(&dq->top, &expected, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        *contended = true;
+        return NULL;
+    }
+    return task;
+}
+
+/* ============================================================================
+ * SPAWNED TASKS
+ * Workers push their spawns onto their own deque and run them newest first
+ * (depth-first); idle workers steal the oldest (the biggest pieces of a
+ * split). Threads without a deque hand spawns to a locked injection list.
+ * ============================================================================ */
+
+static rtka_spawned_t* spawned_alloc(rtka_worker_arg_t* self) {
+    if (self && self->free_tasks) {
+        rtka_spawned_t* task = self->free_tasks;
+        self->free_tasks = task->next;
+        self->free_count--;
+        return task;
+    }
+    return malloc(sizeof(rtka_spawned_t));
+}
+
+static void spawned_release(rtka_worker_arg_t* self, rtka_spawned_t* task) {
+    if (self && self->free_count < RTKA_POOL_FREE_TASKS_MAX) {
+        task->next = self->free_tasks;
+        self->free_tasks = task;
+        self->free_count++;
+        return;
+    }
+    free(task);
+}
+
+/* Dekker pairing with the park in worker_main: one side always sees the other */
+static void notify_spawn(rtka_thread_pool_t* pool) {
+    atomic_fetch_add_explicit(&pool->epoch, 1U, memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->sleepers, memory_order_seq_cst) > 0U) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->has_work);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void push_spawned(rtka_thread_pool_t* pool, rtka_worker_arg_t* self, rtka_spawned_t* task) {
+    atomic_fetch_add_explicit(&task->group->pending, 1U, memory_order_relaxed);
+    if (!self || !deque_push(self, task)) {
+        /* No deque of our own, or it failed to grow */
+        task->next = NULL;
+        pthread_mutex_lock(&pool->lock);
+        if (pool->inject_tail) {
+            pool->inject_tail->next = task;
+        } else {
+            pool->inject_head = task;
+        }
+        pool->inject_tail = task;
+        atomic_fetch_add_explicit(&pool->inject_count, 1U, memory_order_release);
+        pthread_mutex_unlock(&pool->lock);
+        atomic_fetch_add_explicit(&pool->injected, 1U, memory_order_relaxed);
+    }
+    notify_spawn(pool);
+}
+
+static rtka_spawned_t* pop_injected(rtka_thread_pool_t* pool) {
+    if (atomic_load_explicit(&pool->inject_count, memory_order_acquire) == 0U) return NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    rtka_spawned_t* task = pool->inject_head;
+    if (task) {
+        pool->inject_head = task->next;
+        if (!pool->inject_head) pool->inject_tail = NULL;
+        atomic_fetch_sub_explicit(&pool->inject_count, 1U, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return task;
+}
+
+/* Own deque, then the injection list, then sweeps over random victims */
+static rtka_spawned_t* find_spawned(rtka_thread_pool_t* pool, rtka_worker_arg_t* self) {
+    rtka_spawned_t* task = self ? deque_take(&self->deque) : NULL;
+    if (task) return task;
+
+    task = pop_injected(pool);
+    if (task) return task;
+
+    uint32_t n = pool->num_deques;        /* Deques of workers that failed to start stay empty */
+    uint64_t* rng = self ? &self->rng : &rtka_tls_caller_rng;
+    uint32_t start = (uint32_t)(next_random(rng) % n);
+    bool contended;
+    do {
+        contended = false;
+        for (uint32_t k = 0; k < n; k++) {
+            uint32_t v = (start + k) % n;
+            if (self && v == self->index - 1U) continue;
+            task = deque_steal(&pool->workers[v].deque, &contended);
+            if (task) {
+                if (self) {
+                    counter_inc(&self->stolen);
+                } else {
+                    atomic_fetch_add_explicit(&pool->caller_stolen, 1U, memory_order_relaxed);
+                }
+                rtka_trace_instant(RTKA_TRACE_POOL_STEAL, v + 1U);
+                return task;
+            }
+        }
+    } while (contended);
+    return NULL;
+}
+
+/* Range task: keep halving, spawning the upper half, then run what is left */
+static void run_range(rtka_thread_pool_t* pool, rtka_worker_arg_t* self, rtka_spawned_t* task) {
+    uint32_t begin = task->begin, end = task->end;
+    while (end - begin > task->grain) {
+        uint32_t mid = begin + (end - begin) / 2U;
+        rtka_spawned_t* half = spawned_alloc(self);
+        if (!half) break;
+        *half = *task;
+        half->begin = mid;
+        half->end = end;
+        push_spawned(pool, self, half);
+        end = mid;
+    }
+    uint64_t span = rtka_trace_begin();
+    task->range(task->arg, begin, end, self ? self->index : 0U);
+    rtka_trace_end(RTKA_TRACE_POOL_CHUNK, span, begin);
+}
+
+static void run_spawned(rtka_thread_pool_t* pool, rtka_worker_arg_t* self, rtka_spawned_t* task) {
+    rtka_task_group_t* group = task->group;
+    if (task->fn) {
+        uint64_t span = rtka_trace_begin();
+        task->fn(task->arg);
+        rtka_trace_end(RTKA_TRACE_POOL_TASK, span, 0U);
+    } else {
+        run_range(pool, self, task);
+    }
+    spawned_release(self, task);
+    if (self) {
+        counter_inc(&self->executed);
+    } else {
+        atomic_fetch_add_explicit(&pool->caller_executed, 1U, memory_order_relaxed);
+    }
+    /* Release: the task's effects are visible to whoever observes the group drained */
+    if (atomic_fetch_sub_explicit(&group->pending, 1U, memory_order_seq_cst) == 1U &&
+        atomic_load_explicit(&pool->outside_waiters, memory_order_seq_cst) > 0U) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->drained);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/* One task off the submit FIFO; false when it is empty */
+static bool run_submitted(rtka_thread_pool_t* pool) {
+    if (atomic_load_explicit(&pool->queued, memory_order_relaxed) == 0U) return false;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->queued == 0) {
+        pthread_mutex_unlock(&pool->lock);
+        return false;
+    }
+    rtka_task_t task = pool->queue[pool->head];
+    pool->head = (pool->head + 1U) % RTKA_POOL_QUEUE_SIZE;
+    pool->queued--;
+    pool->running++;
+    pthread_cond_signal(&pool->has_space);
+    pthread_mutex_unlock(&pool->lock);
+
+    uint64_t span = rtka_trace_begin();
+    task.fn(task.arg);
+    rtka_trace_end(RTKA_TRACE_POOL_TASK, span, 0U);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->running--;
+    if (pool->queued == 0 && pool->running == 0) {
+        pthread_cond_broadcast(&pool->idle);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return true;
+}
+
+/* ============================================================================
+ * WORKERS
+ * ============================================================================ */
+
+static void* worker_main(void* arg) {
+    rtka_worker_arg_t* self = (rtka_worker_arg_t*)arg;
+    rtka_thread_pool_t* pool = self->pool;
+    rtka_tls_worker = self;
+
+    char name[RTKA_TRACE_NAME_MAX];
+    snprintf(name, sizeof(name), "rtka-pool %u", self->index);
+    rtka_trace_name_thread(name);
+
+    uint32_t idle_rounds = 0;
+    uint32_t seen_epoch = atomic_load_explicit(&pool->epoch, memory_order_acquire);
+    for (;;) {
+        rtka_spawned_t* task = find_spawned(pool, self);
+        if (task) {
+            run_spawned(pool, self, task);
+        } else if (!run_submitted(pool)) {
+            if (++idle_rounds < RTKA_POOL_SPIN_ROUNDS) {
+                cpu_relax();
+                continue;
+            }
+
+            pthread_mutex_lock(&pool->lock);
+            if (pool->queued == 0 && pool->shutdown) {
+                pthread_mutex_unlock(&pool->lock);
+                break;
+            }
+            atomic_fetch_add_explicit(&pool->sleepers, 1U, memory_order_seq_cst);
+            if (pool->queued == 0 && !pool->shutdown &&
+                atomic_load_explicit(&pool->epoch, memory_order_seq_cst) == seen_epoch) {
+                uint64_t idle = rtka_trace_begin();
+                pthread_cond_wait(&pool->has_work, &pool->lock);
+                rtka_trace_end(RTKA_TRACE_POOL_IDLE, idle, 0U);
+            }
+            atomic_fetch_sub_explicit(&pool->sleepers, 1U, memory_order_relaxed);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        idle_rounds = 0;
+        seen_epoch = atomic_load_explicit(&pool->epoch, memory_order_acquire);
+    }
+
+    while (self->free_tasks) {
+        rtka_spawned_t* next = self->free_tasks->next;
+        free(self->free_tasks);
+        self->free_tasks = next;
+    }
+    return NULL;
+}
+
+rtka_thread_pool_t* rtka_pool_create(uint32_t num_threads, uint32_t flags) {
+    if (num_threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = online > 0 ? (uint32_t)online : 1U;
+    }
+    if (num_threads > RTKA_POOL_MAX_THREADS) num_threads = RTKA_POOL_MAX_THREADS;
+
+    rtka_thread_pool_t* pool = aligned_alloc(RTKA_CACHE_LINE_SIZE, sizeof(rtka_thread_pool_t));
+    if (!pool) return NULL;
+    memset(pool, 0, sizeof(*pool));
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->has_work, NULL);
+    pthread_cond_init(&pool->has_space, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    pthread_cond_init(&pool->drained, NULL);
+    atomic_init(&pool->queued, 0U);
+    atomic_init(&pool->inject_count, 0U);
+    atomic_init(&pool->epoch, 0U);
+    atomic_init(&pool->sleepers, 0U);
+    atomic_init(&pool->outside_waiters, 0U);
+    atomic_flag_clear(&pool->caller_slot);
+    atomic_init(&pool->caller_executed, 0U);
+    atomic_init(&pool->caller_stolen, 0U);
+    atomic_init(&pool->injected, 0U);
+
+    /* Every deque exists before any worker may try to steal from it */
+    for (uint32_t i = 0; i < num_threads; i++) {
+        rtka_worker_arg_t* w = &pool->workers[i];
+        w->pool = pool;
+        w->index = i + 1U;   /* 0 is the thread calling parallel_for */
+        w->rng = 0x2545F4914F6CDD1DULL * (i + 1U);
+        atomic_init(&w->executed, 0U);
+        atomic_init(&w->stolen, 0U);
+        atomic_init(&w->grows, 0U);
+        if (!deque_init(&w->deque)) {
+            for (uint32_t j = 0; j < i; j++) deque_destroy(&pool->workers[j].deque);
+            free(pool);
+            return NULL;
+        }
+    }
+    pool->num_deques = num_threads;
+
+    rtka_cpu_order_t* order = NULL;
+    if (flags & RTKA_POOL_PIN_THREADS) {
+        order = malloc(sizeof(rtka_cpu_order_t));
+        if (order) build_cpu_order(order, (flags & RTKA_POOL_NUMA_SPREAD) != 0);
+        if (order && order->count == 0) {
+            free(order);
+            order = NULL;
+        }
+    }
+
+    for (uint32_t i = 0; i < num_threads; i++) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (order) {
+            /* Pin before start so first-touch allocations land on the right node */
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(order->cpus[i % order->count], &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+            pool->worker_node[i] = order->nodes[i % order->count];
+        }
+
+        int rc = pthread_create(&pool->threads[i], &attr, worker_main, &pool->workers[i]);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) break;
+        pool->num_threads++;
+    }
+    free(order);
+
+    if (pool->num_threads == 0) {
+        rtka_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void rtka_pool_destroy(rtka_thread_pool_t* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->has_work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (uint32_t i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (uint32_t i = 0; i < pool->num_deques; i++) {
+        deque_destroy(&pool->workers[i].deque);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->has_work);
+    pthread_cond_destroy(&pool->has_space);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->drained);
+    free(pool);
+}
+
+static rtka_thread_pool_t* rtka_default_pool = NULL;
+static pthread_once_t rtka_default_once = PTHREAD_ONCE_INIT;
+
+static void default_pool_init(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    /* Caller of parallel_for is the extra participant */
+    uint32_t workers = online > 1 ? (uint32_t)(online - 1) : 1U;
+    rtka_default_pool = rtka_pool_create(workers, RTKA_POOL_PIN_THREADS);
+}
+
+rtka_thread_pool_t* rtka_pool_default(void) {
+    pthread_once(&rtka_default_once, default_pool_init);
+    return rtka_default_pool;
+}
+
+uint32_t rtka_pool_size(const rtka_thread_pool_t* pool) {
+    return pool ? pool->num_threads : 0U;
+}
+
+uint32_t rtka_pool_worker_node(const rtka_thread_pool_t* pool, uint32_t worker) {
+    if (!pool || worker >= pool->num_threads) return 0U;
+    return pool->worker_node[worker];
+}
+
+uint32_t rtka_pool_worker_index(const rtka_thread_pool_t* pool) {
+    return worker_index_in(pool);
+}
+
+/* ============================================================================
+ * TASKS
+ * ============================================================================ */
+
+rtka_error_t rtka_pool_submit(rtka_thread_pool_t* pool, rtka_task_fn fn, void* arg) {
+    if (!pool || !fn) return RTKA_ERROR_NULL_POINTER;
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->queued == RTKA_POOL_QUEUE_SIZE && !pool->shutdown) {
+        pthread_cond_wait(&pool->has_space, &pool->lock);
+    }
+    if (pool->shutdown) {
+        pthread_mutex_unlock(&pool->lock);
+        return RTKA_ERROR_NOT_INITIALIZED;
+    }
+
+    pool->queue[pool->tail] = (rtka_task_t){ .fn = fn, .arg = arg };
+    pool->tail = (pool->tail + 1U) % RTKA_POOL_QUEUE_SIZE;
+    pool->queued++;
+    pthread_cond_signal(&pool->has_work);
+    pthread_mutex_unlock(&pool->lock);
+    return RTKA_SUCCESS;
+}
+
+void rtka_pool_wait(rtka_thread_pool_t* pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->queued > 0 || pool->running > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+rtka_error_t rtka_pool_spawn(rtka_thread_pool_t* pool, rtka_task_group_t* group, rtka_task_fn fn, void* arg) {
+    if (!pool || !group || !fn) return RTKA_ERROR_NULL_POINTER;
+    rtka_worker_arg_t* self = own_worker(pool);
+    rtka_spawned_t* task = spawned_alloc(self);
+    if (!task) return RTKA_ERROR_OUT_OF_MEMORY;
+    *task = (rtka_spawned_t){ .fn = fn, .arg = arg, .group = group };
+    push_spawned(pool, self, task);
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_pool_spawn_range(rtka_thread_pool_t* pool, rtka_task_group_t* group, uint32_t begin,
+                                   uint32_t end, uint32_t grain, rtka_range_fn fn, void* ctx) {
+    if (!pool || !group || !fn) return RTKA_ERROR_NULL_POINTER;
+    if (begin >= end) return RTKA_SUCCESS;
+    rtka_worker_arg_t* self = own_worker(pool);
+    rtka_spawned_t* task = spawned_alloc(self);
+    if (!task) return RTKA_ERROR_OUT_OF_MEMORY;
+    *task = (rtka_spawned_t){ .range = fn, .arg = ctx, .begin = begin, .end = end,
+                              .grain = grain ? grain : 1U, .group = group };
+    push_spawned(pool, self, task);
+    return RTKA_SUCCESS;
+}
+
+void rtka_pool_wait_group(rtka_thread_pool_t* pool, rtka_task_group_t* group) {
+    if (!pool || !group) return;
+
+    rtka_worker_arg_t* self = own_worker(pool);
+    bool claimed = false;
+    if (!self && rtka_tls_caller_pool != pool) {
+        claimed = !atomic_flag_test_and_set_explicit(&pool->caller_slot, memory_order_acquire);
+        if (claimed) rtka_tls_caller_pool = pool;
+    }
+
+    if (self || rtka_tls_caller_pool == pool) {
+        /* Help instead of blocking: own deque first, so the common case runs
+         * this group's own children; nested waits stay live */
+        uint32_t idle_rounds = 0;
+        while (!rtka_task_group_done(group)) {
+            rtka_spawned_t* task = find_spawned(pool, self);
+            if (task) {
+                run_spawned(pool, self, task);
+                idle_rounds = 0;
+            } else if (++idle_rounds < RTKA_POOL_SPIN_ROUNDS) {
+                cpu_relax();
+            } else {
+                sched_yield();
+            }
+        }
+        if (claimed) {
+            rtka_tls_caller_pool = NULL;
+            atomic_flag_clear_explicit(&pool->caller_slot, memory_order_release);
+        }
+        return;
+    }
+
+    /* Another outside thread already helps as worker 0: block until drained */
+    uint64_t join = rtka_trace_begin();
+    pthread_mutex_lock(&pool->lock);
+    atomic_fetch_add_explicit(&pool->outside_waiters, 1U, memory_order_seq_cst);
+    while (atomic_load_explicit(&group->pending, memory_order_seq_cst) != 0U) {
+        pthread_cond_wait(&pool->drained, &pool->lock);
+    }
+    atomic_fetch_sub_explicit(&pool->outside_waiters, 1U, memory_order_relaxed);
+    pthread_mutex_unlock(&pool->lock);
+    rtka_trace_end(RTKA_TRACE_POOL_JOIN, join, 0U);
+}
+
+rtka_pool_stats_t rtka_pool_get_stats(const rtka_thread_pool_t* pool) {
+    rtka_pool_stats_t stats = {0U, 0U, 0U, 0U};
+    if (!pool) return stats;
+    for (uint32_t i = 0; i < pool->num_threads; i++) {
+        const rtka_worker_arg_t* w = &pool->workers[i];
+        stats.executed += atomic_load_explicit(&w->executed, memory_order_relaxed);
+        stats.stolen += atomic_load_explicit(&w->stolen, memory_order_relaxed);
+        stats.deque_grows += atomic_load_explicit(&w->grows, memory_order_relaxed);
+    }
+    stats.executed += atomic_load_explicit(&pool->caller_executed, memory_order_relaxed);
+    stats.stolen += atomic_load_explicit(&pool->caller_stolen, memory_order_relaxed);
+    stats.injected = atomic_load_explicit(&pool->injected, memory_order_relaxed);
+    return stats;
+}
+
+/* ============================================================================
+ * PARALLEL FOR
+ * ============================================================================ */
+
+typedef struct {
+    rtka_thread_pool_t* pool;
+    rtka_range_fn fn;
+    void* ctx;
+    uint32_t end;
+    uint32_t grain;
+    atomic_uint next;
+
+    /* Helpers still referencing this frame */
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    uint32_t helpers;
+} rtka_range_job_t;
+
+static void range_claim_loop(rtka_range_job_t* job, uint32_t worker) {
+    for (;;) {
+        uint32_t begin = atomic_fetch_add_explicit(&job->next, job->grain, memory_order_relaxed);
+        if (begin >= job->end) break;
+        uint32_t stop = (job->end - begin > job->grain) ? begin + job->grain : job->end;
+        uint64_t span = rtka_trace_begin();
+        job->fn(job->ctx, begin, stop, worker);
+        rtka_trace_end(RTKA_TRACE_POOL_CHUNK, span, begin);
+    }
+}
+
+static void range_helper(void* arg) {
+    rtka_range_job_t* job = (rtka_range_job_t*)arg;
+    range_claim_loop(job, worker_index_in(job->pool));
+
+    pthread_mutex_lock(&job->lock);
+    if (--job->helpers == 0) pthread_cond_signal(&job->done);
+    pthread_mutex_unlock(&job->lock);
+}
+
+void rtka_pool_parallel_for(rtka_thread_pool_t* pool, uint32_t begin, uint32_t end,
+                            uint32_t grain, rtka_range_fn fn, void* ctx) {
+    if (!fn || begin >= end) return;
+
+    uint32_t n = end - begin;
+    uint32_t threads = pool ? pool->num_threads + 1U : 1U;
+    if (grain == 0) {
+        /* ~4 chunks per participant for balance */
+        grain = n / (threads * 4U);
+        if (grain == 0) grain = 1;
+    }
+
+    uint32_t chunks = (n + grain - 1U) / grain;
+    if (!pool || chunks <= 1U || rtka_tls_worker != NULL) {
+        fn(ctx, begin, end, worker_index_in(pool));
+        return;
+    }
+
+    rtka_range_job_t job = { .pool = pool, .fn = fn, .ctx = ctx, .end = end, .grain = grain };
+    atomic_init(&job.next, begin);
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.done, NULL);
+
+    uint32_t helpers = chunks - 1U < pool->num_threads ? chunks - 1U : pool->num_threads;
+    job.helpers = helpers;
+    for (uint32_t h = 0; h < helpers; h++) {
+        if (rtka_pool_submit(pool, range_helper, &job) != RTKA_SUCCESS) {
+            pthread_mutex_lock(&job.lock);
+            job.helpers -= helpers - h;
+            pthread_mutex_unlock(&job.lock);
+            break;
+        }
+    }
+
+    range_claim_loop(&job, 0U);
+
+    uint64_t join = rtka_trace_begin();
+    pthread_mutex_lock(&job.lock);
+    while (job.helpers > 0) {
+        pthread_cond_wait(&job.done, &job.lock);
+    }
+    pthread_mutex_unlock(&job.lock);
+    rtka_trace_end(RTKA_TRACE_POOL_JOIN, join, 0U);
+
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.done);
+}
@@ -0,0 +1,147 @@
+/**
+ * File: rtka_threadpool.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Persistent Thread Pool
+ * Shared workers for vector, tensor, correlation and solver modules
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial persistent pool
+ *          Workers created once, parked on a condition variable between jobs
+ *          Task queue (submit/wait) and blocking chunked parallel_for
+ *          Optional NUMA-aware pinning from /sys/devices/system/node
+ * v1.0.1 - Trace spans for tasks, idle waits, parallel_for chunks and joins
+ *          (rtka_trace.h); workers are labelled "rtka-pool N"
+ * v1.1.0 - Work stealing: a growable Chase-Lev deque per worker
+ *          Task groups; rtka_pool_spawn from a worker pushes onto its own
+ *          deque (run newest first), idle workers steal the oldest from
+ *          random victims; spawns from other threads are injected
+ *          rtka_pool_spawn_range splits a range in halves as it runs
+ *          rtka_pool_wait_group helps with tasks until the group drains
+ *
+ * Typical search use - one group per branching point:
+ *
+ *   rtka_task_group_t group;
+ *   rtka_task_group_init(&group);
+ *   for (each branch) rtka_pool_spawn(pool, &group, search_branch, branch);
+ *   rtka_pool_wait_group(pool, &group);
+ *
+ * Tasks may spawn and wait on their own groups; a waiting worker keeps
+ * executing other tasks, so nested parallelism cannot deadlock.
+ *
+ * Note: rtka_pool_t in rtka_memory.h is the state memory pool; the thread
+ * pool type is rtka_thread_pool_t.
+ */
+
+#ifndef RTKA_THREADPOOL_H
+#define RTKA_THREADPOOL_H
+
+#include "rtka_types.h"
+#include <stdatomic.h>
+
+/* Creation flags */
+#define RTKA_POOL_PIN_THREADS  (1U << 0)  /* Pin each worker to one CPU */
+#define RTKA_POOL_NUMA_SPREAD  (1U << 1)  /* Round-robin workers across nodes */
+
+/* Upper bound on workers per pool */
+#define RTKA_POOL_MAX_THREADS 256U
+
+typedef struct rtka_thread_pool rtka_thread_pool_t;
+
+/* Queued task */
+typedef void (*rtka_task_fn)(void* arg);
+
+/* Range body: processes [begin, end); worker is 0 for the calling thread */
+typedef void (*rtka_range_fn)(void* ctx, uint32_t begin, uint32_t end, uint32_t worker);
+
+/* Completion counter shared by a set of spawned tasks */
+typedef struct {
+    atomic_uint pending;
+} rtka_task_group_t;
+
+/* Work-stealing counters since creation */
+typedef struct {
+    uint64_t executed;      /* Spawned tasks run */
+    uint64_t stolen;        /* Of those, taken from another worker's deque */
+    uint64_t injected;      /* Spawned from threads without a deque */
+    uint64_t deque_grows;
+} rtka_pool_stats_t;
+
+/**
+ * Create pool with num_threads workers (0 = online CPUs)
+ * With RTKA_POOL_PIN_THREADS, CPUs are ordered node by node so that
+ * neighbouring workers share a NUMA node (compact), or interleaved across
+ * nodes with RTKA_POOL_NUMA_SPREAD.
+ */
+RTKA_NODISCARD rtka_thread_pool_t* rtka_pool_create(uint32_t num_threads, uint32_t flags);
+void rtka_pool_destroy(rtka_thread_pool_t* pool);
+
+/* Process-wide pool, created on first use with all CPUs, pinned compact */
+RTKA_NODISCARD rtka_thread_pool_t* rtka_pool_default(void);
+
+uint32_t rtka_pool_size(const rtka_thread_pool_t* pool);
+
+/* NUMA node of worker (0 when unknown or unpinned) */
+uint32_t rtka_pool_worker_node(const rtka_thread_pool_t* pool, uint32_t worker);
+
+/**
+ * Participant index of the calling thread: 1..rtka_pool_size(pool) on a
+ * worker of pool, 0 anywhere else. Spawned tasks and range bodies see the
+ * index of the thread running them, so per-participant state sized
+ * rtka_pool_size(pool) + 1 can be indexed by it.
+ */
+uint32_t rtka_pool_worker_index(const rtka_thread_pool_t* pool);
+
+/* Asynchronous task; rtka_pool_wait blocks until every submitted task finished */
+RTKA_NODISCARD rtka_error_t rtka_pool_submit(rtka_thread_pool_t* pool, rtka_task_fn fn, void* arg);
+void rtka_pool_wait(rtka_thread_pool_t* pool);
+
+/**
+ * Blocking parallel loop over [begin, end) in chunks of `grain` (0 = auto)
+ * The caller participates. Called from inside a pool worker the loop runs
+ * inline on that worker, so nested use cannot deadlock. The worker index
+ * passed to fn is always below rtka_pool_size(pool) + 1: inline on one of
+ * pool's own workers it is that worker's index, on any other thread it is 0.
+ */
+void rtka_pool_parallel_for(rtka_thread_pool_t* pool, uint32_t begin, uint32_t end,
+                            uint32_t grain, rtka_range_fn fn, void* ctx);
+
+static inline void rtka_task_group_init(rtka_task_group_t* group) {
+    atomic_init(&group->pending, 0U);
+}
+
+static inline bool rtka_task_group_done(const rtka_task_group_t* group) {
+    return atomic_load_explicit(&group->pending, memory_order_acquire) == 0U;
+}
+
+/* Queue fn(arg) as part of group; from a worker of pool it goes on that
+ * worker's deque */
+RTKA_NODISCARD rtka_error_t rtka_pool_spawn(rtka_thread_pool_t* pool, rtka_task_group_t* group,
+                                            rtka_task_fn fn, void* arg);
+
+/**
+ * Queue fn over [begin, end) as part of group. The running task keeps the
+ * lower half and spawns the upper half until at most `grain` (0 = 1)
+ * indices remain, so thieves take the largest pieces left while the owner
+ * walks the range in order.
+ */
+RTKA_NODISCARD rtka_error_t rtka_pool_spawn_range(rtka_thread_pool_t* pool, rtka_task_group_t* group,
+                                                  uint32_t begin, uint32_t end, uint32_t grain,
+                                                  rtka_range_fn fn, void* ctx);
+
+/**
+ * Run tasks until every task of group has finished. Workers of pool, and
+ * one outside thread at a time (as participant 0), help; further outside
+ * threads block. Wait for every group before destroying the pool.
+ */
+void rtka_pool_wait_group(rtka_thread_pool_t* pool, rtka_task_group_t* group);
+
+rtka_pool_stats_t rtka_pool_get_stats(const rtka_thread_pool_t* pool);
+
+#endif /* RTKA_THREADPOOL_H */
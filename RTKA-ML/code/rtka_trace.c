@@ -0,0 +1,295 @@
+/**
+ * File: rtka_trace.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Event Trace Recorder Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "rtka_trace.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    uint64_t start;
+    uint64_t duration;
+    uint32_t arg;
+    uint16_t event;
+    uint16_t instant;
+} trace_record_t;
+
+/* Written by the thread it belongs to only; rings are never unlinked */
+typedef struct trace_ring {
+    trace_record_t* records;
+    uint32_t mask;
+    uint32_t tid;
+    _Atomic uint64_t head;              /* Events ever written */
+    atomic_bool live;                   /* Bound to a running thread */
+    char name[RTKA_TRACE_NAME_MAX];
+    struct trace_ring* next;
+} trace_ring_t;
+
+typedef struct {
+    const char* name;
+    const char* category;
+    const char* arg_name;               /* NULL: arg unused */
+} trace_event_info_t;
+
+static const trace_event_info_t g_event_info[RTKA_TRACE_EVENT_COUNT] = {
+    [RTKA_TRACE_POOL_TASK]        = {"pool_task", "pool", NULL},
+    [RTKA_TRACE_POOL_IDLE]        = {"pool_idle", "pool", NULL},
+    [RTKA_TRACE_POOL_CHUNK]       = {"pool_chunk", "pool", "first"},
+    [RTKA_TRACE_POOL_JOIN]        = {"pool_join", "pool", NULL},
+    [RTKA_TRACE_POOL_STEAL]       = {"pool_steal", "pool", "victim"},
+    [RTKA_TRACE_SAT_PROPAGATE]    = {"sat_propagate", "sat", "literals"},
+    [RTKA_TRACE_SAT_CONFLICT]     = {"sat_conflict", "sat", "backjump"},
+    [RTKA_TRACE_SAT_RESTART]      = {"sat_restart", "sat", "restarts"},
+    [RTKA_TRACE_SUDOKU_BACKTRACK] = {"sudoku_backtrack", "sudoku", "cell"},
+    [RTKA_TRACE_IDA_THRESHOLD]    = {"ida_threshold", "ida", "bound"},
+    [RTKA_TRACE_IDA_SUBTREE]      = {"ida_subtree", "ida", "subtree"},
+};
+
+atomic_bool rtka_trace_enabled = false;
+
+static _Atomic(trace_ring_t*) g_rings = NULL;
+static atomic_uint g_ring_count = 0;
+static atomic_uint g_ring_events = RTKA_TRACE_DEFAULT_EVENTS;
+static _Atomic uint64_t g_dropped = 0;
+
+static pthread_once_t g_trace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_trace_key;
+static bool g_trace_key_valid = false;
+
+/* Tick / nanosecond pair of the first start, for calibration */
+static uint64_t g_epoch_ticks;
+static uint64_t g_epoch_ns;
+
+static _Thread_local trace_ring_t* t_ring = NULL;
+static _Thread_local char t_name[RTKA_TRACE_NAME_MAX];
+
+static uint64_t trace_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void trace_thread_exit(void* arg) {
+    trace_ring_t* ring = (trace_ring_t*)arg;
+    /* Events from later destructors find a ring of their own */
+    t_ring = NULL;
+    atomic_store_explicit(&ring->live, false, memory_order_release);
+}
+
+static void trace_init(void) {
+    g_trace_key_valid = pthread_key_create(&g_trace_key, trace_thread_exit) == 0;
+    g_epoch_ns = trace_monotonic_ns();
+    g_epoch_ticks = rtka_trace_ticks();
+}
+
+static void trace_ring_label(trace_ring_t* ring) {
+    if (t_name[0]) {
+        memcpy(ring->name, t_name, RTKA_TRACE_NAME_MAX);
+    } else {
+        snprintf(ring->name, RTKA_TRACE_NAME_MAX, "thread %u", ring->tid);
+    }
+}
+
+/* Empty ring of an exited thread, at least as large as rings made now */
+static trace_ring_t* trace_adopt(void) {
+    uint32_t events = atomic_load_explicit(&g_ring_events, memory_order_relaxed);
+    for (trace_ring_t* ring = atomic_load_explicit(&g_rings, memory_order_acquire); ring; ring = ring->next) {
+        if (ring->mask + 1U < events || atomic_load_explicit(&ring->live, memory_order_relaxed) ||
+            atomic_load_explicit(&ring->head, memory_order_relaxed) != 0U) continue;
+        bool expected = false;
+        if (!atomic_compare_exchange_strong_explicit(&ring->live, &expected, true,
+                                                     memory_order_acquire, memory_order_relaxed)) continue;
+        if (atomic_load_explicit(&ring->head, memory_order_relaxed) == 0U) return ring;
+        atomic_store_explicit(&ring->live, false, memory_order_release);
+    }
+    return NULL;
+}
+
+static trace_ring_t* trace_create(void) {
+    uint32_t index = atomic_fetch_add_explicit(&g_ring_count, 1U, memory_order_relaxed);
+    if (index >= RTKA_TRACE_MAX_THREADS) {
+        atomic_fetch_sub_explicit(&g_ring_count, 1U, memory_order_relaxed);
+        return NULL;
+    }
+
+    uint32_t events = atomic_load_explicit(&g_ring_events, memory_order_relaxed);
+    trace_ring_t* ring = (trace_ring_t*)calloc(1, sizeof(trace_ring_t));
+    trace_record_t* records = (trace_record_t*)malloc((size_t)events * sizeof(trace_record_t));
+    if (!ring || !records) {
+        free(ring);
+        free(records);
+        atomic_fetch_sub_explicit(&g_ring_count, 1U, memory_order_relaxed);
+        return NULL;
+    }
+    ring->records = records;
+    ring->mask = events - 1U;
+    ring->tid = index + 1U;
+    atomic_init(&ring->head, 0U);
+    atomic_init(&ring->live, true);
+
+    trace_ring_t* head = atomic_load_explicit(&g_rings, memory_order_relaxed);
+    do {
+        ring->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_rings, &head, ring,
+                                                    memory_order_release, memory_order_relaxed));
+    return ring;
+}
+
+static trace_ring_t* trace_attach(void) {
+    pthread_once(&g_trace_once, trace_init);
+    trace_ring_t* ring = trace_adopt();
+    if (!ring) ring = trace_create();
+    if (!ring) return NULL;
+
+    trace_ring_label(ring);
+    if (g_trace_key_valid) pthread_setspecific(g_trace_key, ring);
+    t_ring = ring;
+    return ring;
+}
+
+void rtka_trace_record(rtka_trace_event_t event, uint64_t start, uint64_t duration, uint32_t arg,
+                       bool instant) {
+    trace_ring_t* ring = t_ring;
+    if (RTKA_UNLIKELY(!ring)) {
+        ring = trace_attach();
+        if (!ring) {
+            atomic_fetch_add_explicit(&g_dropped, 1U, memory_order_relaxed);
+            return;
+        }
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    ring->records[head & ring->mask] = (trace_record_t){
+        .start = start, .duration = duration, .arg = arg,
+        .event = (uint16_t)event, .instant = instant ? 1U : 0U
+    };
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+}
+
+/* ============================================================================
+ * CONTROL
+ * ============================================================================ */
+
+void rtka_trace_start(uint32_t events_per_thread) {
+    pthread_once(&g_trace_once, trace_init);
+
+    uint32_t events = events_per_thread ? events_per_thread : RTKA_TRACE_DEFAULT_EVENTS;
+    if (events > (1U << 24)) events = 1U << 24;
+    uint32_t rounded = 1U;
+    while (rounded < events) rounded <<= 1;
+    atomic_store_explicit(&g_ring_events, rounded, memory_order_relaxed);
+    atomic_store_explicit(&rtka_trace_enabled, true, memory_order_release);
+}
+
+void rtka_trace_stop(void) {
+    atomic_store_explicit(&rtka_trace_enabled, false, memory_order_release);
+}
+
+void rtka_trace_clear(void) {
+    for (trace_ring_t* ring = atomic_load_explicit(&g_rings, memory_order_acquire); ring; ring = ring->next) {
+        atomic_store_explicit(&ring->head, 0U, memory_order_relaxed);
+    }
+    atomic_store_explicit(&g_dropped, 0U, memory_order_relaxed);
+}
+
+void rtka_trace_name_thread(const char* name) {
+    if (!name) name = "";
+    snprintf(t_name, RTKA_TRACE_NAME_MAX, "%s", name);
+    if (t_ring) trace_ring_label(t_ring);
+}
+
+const char* rtka_trace_event_name(rtka_trace_event_t event) {
+    return (unsigned)event < RTKA_TRACE_EVENT_COUNT ? g_event_info[event].name : "unknown";
+}
+
+void rtka_trace_get_stats(rtka_trace_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    for (trace_ring_t* ring = atomic_load_explicit(&g_rings, memory_order_acquire); ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t held = head < (uint64_t)ring->mask + 1U ? head : (uint64_t)ring->mask + 1U;
+        stats->recorded += held;
+        stats->overwritten += head - held;
+        stats->threads++;
+    }
+    stats->dropped = atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
+
+/* ============================================================================
+ * EXPORT
+ * ============================================================================ */
+
+static void write_json_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20U) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+rtka_error_t rtka_trace_export_json(FILE* out) {
+    if (!out) return RTKA_ERROR_NULL_POINTER;
+    pthread_once(&g_trace_once, trace_init);
+
+    /* Microseconds per tick over the whole session so far */
+    uint64_t ticks = rtka_trace_ticks() - g_epoch_ticks;
+    uint64_t ns = trace_monotonic_ns() - g_epoch_ns;
+    double us_per_tick = ticks > 0U ? (double)ns / (double)ticks * 1e-3 : 1e-3;
+    long pid = (long)getpid();
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool first = true;
+    for (trace_ring_t* ring = atomic_load_explicit(&g_rings, memory_order_acquire); ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t capacity = (uint64_t)ring->mask + 1U;
+        uint64_t begin = head > capacity ? head - capacity : 0U;
+
+        fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",", pid, ring->tid);
+        write_json_string(out, ring->name);
+        fprintf(out, "}}");
+        first = false;
+
+        for (uint64_t i = begin; i < head; i++) {
+            const trace_record_t* r = &ring->records[i & ring->mask];
+            const trace_event_info_t* info = &g_event_info[r->event];
+            /* Stamps of other cores may precede the epoch by the TSC skew */
+            double ts = (double)(int64_t)(r->start - g_epoch_ticks) * us_per_tick;
+            fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%ld,\"tid\":%u,\"ts\":%.3f,",
+                    info->name, info->category, pid, ring->tid, ts);
+            if (r->instant) {
+                fprintf(out, "\"ph\":\"i\",\"s\":\"t\"");
+            } else {
+                fprintf(out, "\"ph\":\"X\",\"dur\":%.3f", (double)r->duration * us_per_tick);
+            }
+            if (info->arg_name) fprintf(out, ",\"args\":{\"%s\":%u}", info->arg_name, r->arg);
+            fputc('}', out);
+        }
+    }
+    fprintf(out, "\n]}\n");
+    return ferror(out) ? RTKA_ERROR_INVALID_VALUE : RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_trace_write(const char* path) {
+    if (!path) return RTKA_ERROR_NULL_POINTER;
+    FILE* out = fopen(path, "w");
+    if (!out) return RTKA_ERROR_INVALID_VALUE;
+    rtka_error_t err = rtka_trace_export_json(out);
+    if (fclose(out) != 0 && err == RTKA_SUCCESS) err = RTKA_ERROR_INVALID_VALUE;
+    return err;
+}
@@ -0,0 +1,145 @@
+/**
+ * File: rtka_trace.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * RTKA Event Trace Recorder
+ * Per-thread timelines of pool scheduling and solver search
+ *
+ * CHANGELOG:
+ * v1.0.0 - Initial recorder
+ *          One single-writer ring per thread, no locks or RMWs on the
+ *          record path; the oldest events are overwritten when a ring fills
+ *          Spans and instants stamped with the cycle counter, calibrated
+ *          against CLOCK_MONOTONIC at export
+ *          Chrome trace / Perfetto JSON export (chrome://tracing,
+ *          ui.perfetto.dev)
+ *          Hooks in the thread pool, SAT search, Sudoku backtracking and
+ *          the IDA* threshold loops
+ *
+ * Recording is off until rtka_trace_start; a disabled hook costs one
+ * relaxed load and a branch. Define RTKA_TRACE_DISABLE to compile the
+ * hooks out entirely. A thread's ring is created on its first event and
+ * kept after the thread exits, so pool workers can be exported after the
+ * pool is destroyed. Export and clear while no thread is recording, e.g.
+ * after rtka_trace_stop and rtka_pool_wait.
+ */
+
+#ifndef RTKA_TRACE_H
+#define RTKA_TRACE_H
+
+#include "rtka_types.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define RTKA_TRACE_DEFAULT_EVENTS  (1U << 16)   /* Per thread ring */
+#define RTKA_TRACE_MAX_THREADS     1024U
+#define RTKA_TRACE_NAME_MAX        32U
+
+typedef enum {
+    RTKA_TRACE_POOL_TASK,          /* Span: queued task on a worker */
+    RTKA_TRACE_POOL_IDLE,          /* Span: worker parked with an empty queue */
+    RTKA_TRACE_POOL_CHUNK,         /* Span: parallel_for chunk, arg = first index */
+    RTKA_TRACE_POOL_JOIN,          /* Span: parallel_for caller waiting for helpers */
+    RTKA_TRACE_POOL_STEAL,         /* Instant: spawned task stolen, arg = victim worker */
+    RTKA_TRACE_SAT_PROPAGATE,      /* Span: unit propagation, arg = literals propagated */
+    RTKA_TRACE_SAT_CONFLICT,       /* Instant: arg = backjump level */
+    RTKA_TRACE_SAT_RESTART,        /* Instant: arg = restart count */
+    RTKA_TRACE_SUDOKU_BACKTRACK,   /* Instant: guess undone, arg = cell */
+    RTKA_TRACE_IDA_THRESHOLD,      /* Span: one IDA* iteration, arg = bound */
+    RTKA_TRACE_IDA_SUBTREE,        /* Span: parallel subtree, arg = subtree index */
+    RTKA_TRACE_EVENT_COUNT
+} rtka_trace_event_t;
+
+typedef struct {
+    uint64_t recorded;             /* Events held in the rings */
+    uint64_t overwritten;          /* Lost to ring wrap-around */
+    uint64_t dropped;              /* Lost because no ring could be had */
+    uint32_t threads;              /* Rings */
+} rtka_trace_stats_t;
+
+/* Start recording; events_per_thread sizes rings created from now on
+ * (rounded up to a power of two, 0 = default) */
+void rtka_trace_start(uint32_t events_per_thread);
+void rtka_trace_stop(void);
+
+/* Discard recorded events; rings of exited threads become reusable */
+void rtka_trace_clear(void);
+
+/* Label the calling thread's timeline (default "thread N") */
+void rtka_trace_name_thread(const char* name);
+
+void rtka_trace_get_stats(rtka_trace_stats_t* stats);
+
+/* Chrome trace event format, one timeline per thread */
+RTKA_NODISCARD rtka_error_t rtka_trace_export_json(FILE* out);
+RTKA_NODISCARD rtka_error_t rtka_trace_write(const char* path);
+
+const char* rtka_trace_event_name(rtka_trace_event_t event);
+
+/* Record path */
+extern atomic_bool rtka_trace_enabled;
+
+void rtka_trace_record(rtka_trace_event_t event, uint64_t start, uint64_t duration, uint32_t arg,
+                       bool instant);
+
+static inline uint64_t rtka_trace_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#ifndef RTKA_TRACE_DISABLE
+
+static inline bool rtka_trace_active(void) {
+    return RTKA_UNLIKELY(atomic_load_explicit(&rtka_trace_enabled, memory_order_relaxed));
+}
+
+/* Start of a span, 0 when recording is off */
+static inline uint64_t rtka_trace_begin(void) {
+    return rtka_trace_active() ? rtka_trace_ticks() | 1U : 0U;
+}
+
+static inline void rtka_trace_end(rtka_trace_event_t event, uint64_t start, uint32_t arg) {
+    if (RTKA_UNLIKELY(start != 0U)) {
+        uint64_t now = rtka_trace_ticks();
+        rtka_trace_record(event, start, now > start ? now - start : 0U, arg, false);
+    }
+}
+
+static inline void rtka_trace_instant(rtka_trace_event_t event, uint32_t arg) {
+    if (rtka_trace_active()) rtka_trace_record(event, rtka_trace_ticks(), 0U, arg, true);
+}
+
+#else
+
+static inline bool rtka_trace_active(void) { return false; }
+static inline uint64_t rtka_trace_begin(void) { return 0U; }
+static inline void rtka_trace_end(rtka_trace_event_t event, uint64_t start, uint32_t arg) {
+    (void)event; (void)start; (void)arg;
+}
+static inline void rtka_trace_instant(rtka_trace_event_t event, uint32_t arg) {
+    (void)event; (void)arg;
+}
+
+#endif /* RTKA_TRACE_DISABLE */
+
+#endif /* RTKA_TRACE_H */
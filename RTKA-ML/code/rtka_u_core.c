@@ -9,6 +9,9 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Core Implementation - Optimized
+ *
+ * CHANGELOG:
+ * v1.1.0 - Blocked sequence reductions with log-space variants
  */
 
 #include "rtka_u_core.h"
@@ -81,50 +84,167 @@ void rtka_or_batch(const rtka_state_t* RTKA_RESTRICT a,
     }
 }
 
-/* Recursive AND with early termination */
-rtka_state_t rtka_recursive_and_seq(const rtka_state_t* states, uint32_t count) {
-    if (RTKA_UNLIKELY(count == 0)) 
-        return rtka_make_state(RTKA_TRUE, 1.0f);
-    if (count == 1) 
-        return states[0];
-
-    rtka_value_t result_value = states[0].value;
-    rtka_confidence_t result_conf = states[0].confidence;
-
-    for (uint32_t i = 1; i < count; i++) {
-        #if RTKA_EARLY_TERMINATION
-        if (RTKA_UNLIKELY(result_value == RTKA_FALSE)) 
-            break;  /* Early exit on FALSE */
-        #endif
-        
-        result_value = rtka_and(result_value, states[i].value);
-        result_conf = rtka_conf_and(result_conf, states[i].confidence);
+/* ============================================================================
+ * SEQUENCE REDUCTIONS
+ *
+ * Blocked form of the left fold. Each block of RTKA_SEQ_BLOCK states is first
+ * scanned for its minimum value (vectorizable, no early branch); only a block
+ * holding the absorbing element drops to the exact element-wise fold, so the
+ * result — including where confidence stops accumulating — matches the
+ * one-state-at-a-time loop. Confidences multiply into RTKA_SEQ_LANES
+ * independent accumulators that are combined as a tree at the end.
+ *
+ * OR is evaluated as AND over negated values: the absorbing TRUE becomes
+ * FALSE, and a + b - ab becomes the product of complements 1 - c.
+ * ============================================================================ */
+
+#define RTKA_SEQ_BLOCK 64U
+#define RTKA_SEQ_LANES 8U
+#define RTKA_SEQ_LN2 0.69314718055994530942
+
+/* Sign applied to values: +1 for AND, -1 for OR (mapped onto AND) */
+static RTKA_INLINE float seq_conf_term(float c, int32_t sign) {
+    return (sign > 0) ? c : 1.0f - c;
+}
+
+static RTKA_INLINE int32_t seq_block_min(const rtka_state_t* states, int32_t sign) {
+    int32_t block_min = RTKA_TRUE;
+    for (uint32_t j = 0; j < RTKA_SEQ_BLOCK; j++) {
+        int32_t v = sign * (int32_t)states[j].value;
+        block_min = v < block_min ? v : block_min;
+    }
+    return block_min;
+}
+
+/* Exact element-wise fold from `start`; stops after the absorbing element */
+static RTKA_INLINE uint32_t seq_fold_tail(const rtka_state_t* states, uint32_t start, uint32_t count,
+                                          int32_t sign, int32_t* value) {
+    uint32_t i = start;
+    for (; i < count; i++) {
+        int32_t v = sign * (int32_t)states[i].value;
+        *value = v < *value ? v : *value;
+        if (RTKA_UNLIKELY(*value == RTKA_FALSE)) return i + 1U;
+    }
+    return count;
+}
+
+static RTKA_INLINE rtka_state_t seq_reduce(const rtka_state_t* states, uint32_t count, int32_t sign) {
+    float acc[RTKA_SEQ_LANES];
+    for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) acc[k] = 1.0f;
+
+    int32_t value = sign * (int32_t)states[0].value;
+    acc[0] = seq_conf_term(states[0].confidence, sign);
+
+    uint32_t i = 1;
+    if (value != RTKA_FALSE) {
+        for (; i + RTKA_SEQ_BLOCK <= count; i += RTKA_SEQ_BLOCK) {
+            int32_t block_min = seq_block_min(&states[i], sign);
+            if (RTKA_UNLIKELY(block_min == RTKA_FALSE)) break;
+
+            for (uint32_t j = 0; j < RTKA_SEQ_BLOCK; j += RTKA_SEQ_LANES) {
+                for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) {
+                    acc[k] *= seq_conf_term(states[i + j + k].confidence, sign);
+                }
+            }
+            value = block_min < value ? block_min : value;
+        }
+    } else {
+        i = count;
+    }
+
+    uint32_t end = seq_fold_tail(states, i, count, sign, &value);
+    for (uint32_t j = i; j < end; j++) {
+        acc[0] *= seq_conf_term(states[j].confidence, sign);
     }
 
-    return rtka_make_state(result_value, result_conf);
+    /* Tree combine: 8 -> 4 -> 2 -> 1 */
+    for (uint32_t width = RTKA_SEQ_LANES / 2U; width > 0U; width /= 2U) {
+        for (uint32_t k = 0; k < width; k++) acc[k] *= acc[k + width];
+    }
+
+    float conf = (sign > 0) ? acc[0] : 1.0f - acc[0];
+    return rtka_make_state((rtka_value_t)(sign * value), conf);
+}
+
+/*
+ * Log-space variant. Accumulators are double and renormalized with frexp
+ * after every block, so the running product keeps full precision for any
+ * chain length; the result is ln of the product.
+ */
+static RTKA_INLINE rtka_value_t seq_reduce_log(const rtka_state_t* states, uint32_t count,
+                                               int32_t sign, double* log_product) {
+    double acc[RTKA_SEQ_LANES];
+    for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) acc[k] = 1.0;
+    int64_t exponent = 0;
+
+    int32_t value = sign * (int32_t)states[0].value;
+    acc[0] = (double)seq_conf_term(states[0].confidence, sign);
+
+    uint32_t i = 1;
+    if (value != RTKA_FALSE) {
+        for (; i + RTKA_SEQ_BLOCK <= count; i += RTKA_SEQ_BLOCK) {
+            int32_t block_min = seq_block_min(&states[i], sign);
+            if (RTKA_UNLIKELY(block_min == RTKA_FALSE)) break;
+
+            for (uint32_t j = 0; j < RTKA_SEQ_BLOCK; j += RTKA_SEQ_LANES) {
+                for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) {
+                    acc[k] *= (double)seq_conf_term(states[i + j + k].confidence, sign);
+                }
+            }
+            for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) {
+                int e;
+                acc[k] = frexp(acc[k], &e);
+                exponent += e;
+            }
+            value = block_min < value ? block_min : value;
+        }
+    } else {
+        i = count;
+    }
+
+    uint32_t end = seq_fold_tail(states, i, count, sign, &value);
+    for (uint32_t j = i; j < end; j++) {
+        acc[0] *= (double)seq_conf_term(states[j].confidence, sign);
+    }
+
+    /* Sum of logs rather than log of product: the combined mantissas may still underflow */
+    double log_sum = (double)exponent * RTKA_SEQ_LN2;
+    for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) log_sum += log(acc[k]);
+
+    *log_product = log_sum;
+    return (rtka_value_t)(sign * value);
+}
+
+/* Recursive AND with early termination */
+rtka_state_t rtka_recursive_and_seq(const rtka_state_t* states, uint32_t count) {
+    if (count == 0) return rtka_make_state(RTKA_TRUE, 1.0f);
+    if (count == 1) return states[0];
+    return seq_reduce(states, count, 1);
 }
 
 /* Recursive OR with early termination */
 rtka_state_t rtka_recursive_or_seq(const rtka_state_t* states, uint32_t count) {
-    if (RTKA_UNLIKELY(count == 0)) 
-        return rtka_make_state(RTKA_FALSE, 1.0f);
-    if (count == 1) 
-        return states[0];
-
-    rtka_value_t result_value = states[0].value;
-    rtka_confidence_t result_conf = states[0].confidence;
-
-    for (uint32_t i = 1; i < count; i++) {
-        #if RTKA_EARLY_TERMINATION
-        if (RTKA_UNLIKELY(result_value == RTKA_TRUE)) 
-            break;  /* Early exit on TRUE */
-        #endif
-        
-        result_value = rtka_or(result_value, states[i].value);
-        result_conf = rtka_conf_or(result_conf, states[i].confidence);
+    if (count == 0) return rtka_make_state(RTKA_FALSE, 1.0f);
+    if (count == 1) return states[0];
+    return seq_reduce(states, count, -1);
+}
+
+rtka_value_t rtka_recursive_and_seq_log(const rtka_state_t* states, uint32_t count,
+                                        double* log_confidence) {
+    if (count == 0) {
+        *log_confidence = 0.0;
+        return RTKA_TRUE;
     }
+    return seq_reduce_log(states, count, 1, log_confidence);
+}
 
-    return rtka_make_state(result_value, result_conf);
+rtka_value_t rtka_recursive_or_seq_log(const rtka_state_t* states, uint32_t count,
+                                       double* log_complement) {
+    if (count == 0) {
+        *log_complement = -INFINITY;   /* confidence 1.0 as in rtka_recursive_or_seq */
+        return RTKA_FALSE;
+    }
+    return seq_reduce_log(states, count, -1, log_complement);
 }
 
 /* UNKNOWN preservation check */
@@ -14,6 +14,7 @@
  * v1.0.1 - Added missing recursive function declarations
  *          Added missing confidence operations (rtka_conf_not, rtka_conf_equiv)
  *          Lines added: 48-52, 68-72
+ * v1.1.0 - Blocked sequence reductions, log-space variants
  */
 
 #ifndef RTKA_U_CORE_H
@@ -89,4 +90,11 @@ void rtka_or_batch(const rtka_state_t* a, const rtka_state_t* b,
 rtka_state_t rtka_recursive_and_seq(const rtka_state_t* states, uint32_t count);
 rtka_state_t rtka_recursive_or_seq(const rtka_state_t* states, uint32_t count);
 
+/* Log-space variants for very long chains - defined in rtka_u_core.c
+ * AND stores ln(confidence); OR stores ln(1 - confidence) */
+rtka_value_t rtka_recursive_and_seq_log(const rtka_state_t* states, uint32_t count,
+                                        double* log_confidence);
+rtka_value_t rtka_recursive_or_seq_log(const rtka_state_t* states, uint32_t count,
+                                       double* log_complement);
+
 #endif /* RTKA_U_CORE_H */
@@ -1,7 +1,7 @@
 /**
  * File: rtka_vector.c
  * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
- * 
+ *
  * PROPRIETARY AND CONFIDENTIAL
  * This file is proprietary to H. Overman and may not be reproduced,
  * distributed, or used without explicit written permission.
@@ -9,97 +9,729 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Vector Operations Implementation
+ *
+ * CHANGELOG:
+ * v1.1.0 - Runtime SIMD dispatch
+ *          Kernel table (scalar / SSE4.1 / AVX2 / AVX-512 / NEON) chosen once
+ *          from CPUID, independent of the -march used at build time
+ *          Value plane vectorized: AND = min, OR = max, NOT = negate
+ *          Unaligned loads throughout, scalar tail for the remainder
+ *          Added NAND / NOR / IMPLIES, reduce_or, fill_range, conf ops
+ * v1.1.1 - Blocked reduce_and / reduce_or with per-block early exit
+ * v1.1.2 - rtka_vector_parallel_and on the shared persistent thread pool
+ * v1.2.0 - Activation kernels: exp / sigmoid / tanh loops over the inline
+ *          approximations, compiled per kernel set; softmax and fused
+ *          log-softmax in register-sized chunks
  */
 
 #include "rtka_vector.h"
 #include "rtka_memory.h"
+#include "rtka_threadpool.h"
 #include <string.h>
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RTKA_VECTOR_X86 1
+#include <immintrin.h>
+#endif
+
+/* Lane loads reinterpret the enum array as int32 */
+_Static_assert(sizeof(rtka_value_t) == sizeof(int32_t), "rtka_value_t must be 32-bit");
+
+/* ============================================================================
+ * KERNEL TABLE
+ * ============================================================================ */
+
+typedef void (*rtka_vec_binary_fn)(const rtka_value_t* RTKA_RESTRICT va,
+                                   const float* RTKA_RESTRICT ca,
+                                   const rtka_value_t* RTKA_RESTRICT vb,
+                                   const float* RTKA_RESTRICT cb,
+                                   rtka_value_t* RTKA_RESTRICT vr,
+                                   float* RTKA_RESTRICT cr,
+                                   uint32_t count);
+
+typedef void (*rtka_vec_unary_fn)(const rtka_value_t* RTKA_RESTRICT va,
+                                  const float* RTKA_RESTRICT ca,
+                                  rtka_value_t* RTKA_RESTRICT vr,
+                                  float* RTKA_RESTRICT cr,
+                                  uint32_t count);
+
+typedef void (*rtka_vec_map_fn)(const float* RTKA_RESTRICT input,
+                                float* RTKA_RESTRICT output,
+                                uint32_t count);
+
+typedef struct {
+    rtka_simd_level_t level;
+    uint32_t width;             /* Floats per register */
+    rtka_vec_binary_fn and_fn;
+    rtka_vec_binary_fn or_fn;
+    rtka_vec_binary_fn nand_fn;
+    rtka_vec_binary_fn nor_fn;
+    rtka_vec_binary_fn implies_fn;
+    rtka_vec_unary_fn not_fn;
+    rtka_vec_map_fn exp_fn;
+    rtka_vec_map_fn sigmoid_fn;
+    rtka_vec_map_fn tanh_fn;
+} rtka_vector_kernels_t;
+
+/*
+ * Every operation is "value expression, confidence expression" over the
+ * generic helpers VMIN/VMAX/VNEG and CAND/COR. Each ISA section defines the
+ * helpers for its register type and instantiates the list once.
+ *
+ * On {-1, 0, 1}: AND = min, OR = max, NOT = 0 - x. IMPLIES is ¬a ∨ b.
+ */
+#define RTKA_VECTOR_BINARY_OPS(X)                       \
+    X(and,     VMIN(va, vb),       CAND(ca, cb))        \
+    X(or,      VMAX(va, vb),       COR(ca, cb))         \
+    X(nand,    VNEG(VMIN(va, vb)), CAND(ca, cb))        \
+    X(nor,     VNEG(VMAX(va, vb)), COR(ca, cb))         \
+    X(implies, VMAX(VNEG(va), vb), COR(ca, cb))
+
+#define RTKA_CAT_(a, b) a##b
+#define RTKA_CAT(a, b) RTKA_CAT_(a, b)
+#define RTKA_KERNEL(op) RTKA_CAT(RTKA_CAT(rtka_vec_, op), RTKA_CAT(_, RTKA_ISA))
+
+/* Register-wide loop followed by a scalar remainder */
+#define RTKA_DEFINE_BINARY(op, vexpr, cexpr)                                   \
+static RTKA_TARGET void RTKA_KERNEL(op)(const rtka_value_t* RTKA_RESTRICT a_v, \
+                                        const float* RTKA_RESTRICT a_c,        \
+                                        const rtka_value_t* RTKA_RESTRICT b_v, \
+                                        const float* RTKA_RESTRICT b_c,        \
+                                        rtka_value_t* RTKA_RESTRICT r_v,       \
+                                        float* RTKA_RESTRICT r_c,              \
+                                        uint32_t count) {                      \
+    uint32_t i = 0;                                                            \
+    for (; i + LANES <= count; i += LANES) {                                   \
+        IVEC va = ILOAD(a_v + i);                                              \
+        IVEC vb = ILOAD(b_v + i);                                              \
+        FVEC ca = FLOAD(a_c + i);                                              \
+        FVEC cb = FLOAD(b_c + i);                                              \
+        ISTORE(r_v + i, (vexpr));                                              \
+        FSTORE(r_c + i, (cexpr));                                              \
+    }                                                                          \
+    if (i < count) {                                                           \
+        RTKA_CAT(rtka_vec_, RTKA_CAT(op, _scalar))(a_v + i, a_c + i,           \
+                                                   b_v + i, b_c + i,           \
+                                                   r_v + i, r_c + i,           \
+                                                   count - i);                 \
+    }                                                                          \
+}
+
+/* NOT: negate values, confidences pass through */
+#define RTKA_DEFINE_NOT()                                                      \
+static RTKA_TARGET void RTKA_KERNEL(not)(const rtka_value_t* RTKA_RESTRICT a_v, \
+                                         const float* RTKA_RESTRICT a_c,       \
+                                         rtka_value_t* RTKA_RESTRICT r_v,      \
+                                         float* RTKA_RESTRICT r_c,             \
+                                         uint32_t count) {                     \
+    uint32_t i = 0;                                                            \
+    for (; i + LANES <= count; i += LANES) {                                   \
+        ISTORE(r_v + i, VNEG(ILOAD(a_v + i)));                                 \
+        FSTORE(r_c + i, FLOAD(a_c + i));                                       \
+    }                                                                          \
+    if (i < count) {                                                           \
+        rtka_vec_not_scalar(a_v + i, a_c + i, r_v + i, r_c + i, count - i);    \
+    }                                                                          \
+}
+
+/* Activations: the compiler vectorizes the inline approximation for the
+ * target of each kernel set */
+#define RTKA_DEFINE_MAP(op, fn)                                                \
+static RTKA_TARGET void RTKA_KERNEL(op)(const float* RTKA_RESTRICT input,      \
+                                        float* RTKA_RESTRICT output,           \
+                                        uint32_t count) {                      \
+    for (uint32_t i = 0; i < count; i++) {                                     \
+        output[i] = fn(input[i]);                                              \
+    }                                                                          \
+}
+
+#define RTKA_DEFINE_ACTIVATIONS()                                              \
+    RTKA_DEFINE_MAP(exp, rtka_fast_expf)                                       \
+    RTKA_DEFINE_MAP(sigmoid, rtka_fast_sigmoidf)                               \
+    RTKA_DEFINE_MAP(tanh, rtka_fast_tanhf)
+
+#define RTKA_KERNEL_TABLE(lvl, w)                                              \
+    { (lvl), (w), RTKA_KERNEL(and), RTKA_KERNEL(or), RTKA_KERNEL(nand),        \
+      RTKA_KERNEL(nor), RTKA_KERNEL(implies), RTKA_KERNEL(not),                \
+      RTKA_KERNEL(exp), RTKA_KERNEL(sigmoid), RTKA_KERNEL(tanh) }
+
+/* ============================================================================
+ * SCALAR KERNELS
+ * Branch-free form; also the remainder path for every SIMD kernel
+ * ============================================================================ */
+
+#define VMIN(a, b) ((a) < (b) ? (a) : (b))
+#define VMAX(a, b) ((a) > (b) ? (a) : (b))
+#define VNEG(a)    (-(a))
+#define CAND(a, b) rtka_conf_and((a), (b))
+#define COR(a, b)  rtka_conf_or((a), (b))
+
+#define RTKA_SCALAR_BINARY(op, vexpr, cexpr)                                   \
+static void rtka_vec_##op##_scalar(const rtka_value_t* RTKA_RESTRICT a_v,      \
+                                   const float* RTKA_RESTRICT a_c,             \
+                                   const rtka_value_t* RTKA_RESTRICT b_v,      \
+                                   const float* RTKA_RESTRICT b_c,             \
+                                   rtka_value_t* RTKA_RESTRICT r_v,            \
+                                   float* RTKA_RESTRICT r_c,                   \
+                                   uint32_t count) {                           \
+    for (uint32_t i = 0; i < count; i++) {                                     \
+        int32_t va = (int32_t)a_v[i];                                          \
+        int32_t vb = (int32_t)b_v[i];                                          \
+        float ca = a_c[i];                                                     \
+        float cb = b_c[i];                                                     \
+        r_v[i] = (rtka_value_t)(vexpr);                                        \
+        r_c[i] = (cexpr);                                                      \
+    }                                                                          \
+}
+
+RTKA_VECTOR_BINARY_OPS(RTKA_SCALAR_BINARY)
+
+static void rtka_vec_not_scalar(const rtka_value_t* RTKA_RESTRICT a_v,
+                                const float* RTKA_RESTRICT a_c,
+                                rtka_value_t* RTKA_RESTRICT r_v,
+                                float* RTKA_RESTRICT r_c,
+                                uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        r_v[i] = rtka_not(a_v[i]);
+        r_c[i] = rtka_conf_not(a_c[i]);
+    }
+}
+
+#undef RTKA_SCALAR_BINARY
+#undef VMIN
+#undef VMAX
+#undef VNEG
+#undef CAND
+#undef COR
+
+#define RTKA_ISA scalar
+#define RTKA_TARGET
+RTKA_DEFINE_ACTIVATIONS()
+#undef RTKA_ISA
+#undef RTKA_TARGET
+
+static const rtka_vector_kernels_t rtka_kernels_scalar = {
+    RTKA_SIMD_SCALAR, 1, rtka_vec_and_scalar, rtka_vec_or_scalar,
+    rtka_vec_nand_scalar, rtka_vec_nor_scalar, rtka_vec_implies_scalar,
+    rtka_vec_not_scalar, rtka_vec_exp_scalar, rtka_vec_sigmoid_scalar,
+    rtka_vec_tanh_scalar
+};
+
+#ifdef RTKA_VECTOR_X86
+
+/* ============================================================================
+ * SSE4.1 KERNELS (4 lanes)
+ * ============================================================================ */
+
+#define RTKA_ISA sse41
+#define RTKA_TARGET __attribute__((target("sse4.1")))
+#define LANES 4U
+#define IVEC __m128i
+#define FVEC __m128
+#define ILOAD(p)     _mm_loadu_si128((const __m128i*)(const void*)(p))
+#define ISTORE(p, v) _mm_storeu_si128((__m128i*)(void*)(p), (v))
+#define FLOAD(p)     _mm_loadu_ps(p)
+#define FSTORE(p, v) _mm_storeu_ps((p), (v))
+#define VMIN(a, b)   _mm_min_epi32((a), (b))
+#define VMAX(a, b)   _mm_max_epi32((a), (b))
+#define VNEG(a)      _mm_sub_epi32(_mm_setzero_si128(), (a))
+#define CAND(a, b)   _mm_mul_ps((a), (b))
+#define COR(a, b)    _mm_sub_ps(_mm_add_ps((a), (b)), _mm_mul_ps((a), (b)))
+
+RTKA_VECTOR_BINARY_OPS(RTKA_DEFINE_BINARY)
+RTKA_DEFINE_NOT()
+RTKA_DEFINE_ACTIVATIONS()
+
+static const rtka_vector_kernels_t rtka_kernels_sse41 = RTKA_KERNEL_TABLE(RTKA_SIMD_SSE41, 4);
+
+#undef RTKA_ISA
+#undef RTKA_TARGET
+#undef LANES
+#undef IVEC
+#undef FVEC
+#undef ILOAD
+#undef ISTORE
+#undef FLOAD
+#undef FSTORE
+#undef VMIN
+#undef VMAX
+#undef VNEG
+#undef CAND
+#undef COR
+
+/* ============================================================================
+ * AVX2 KERNELS (8 lanes)
+ * ============================================================================ */
+
+#define RTKA_ISA avx2
+#define RTKA_TARGET __attribute__((target("avx2")))
+#define LANES 8U
+#define IVEC __m256i
+#define FVEC __m256
+#define ILOAD(p)     _mm256_loadu_si256((const __m256i*)(const void*)(p))
+#define ISTORE(p, v) _mm256_storeu_si256((__m256i*)(void*)(p), (v))
+#define FLOAD(p)     _mm256_loadu_ps(p)
+#define FSTORE(p, v) _mm256_storeu_ps((p), (v))
+#define VMIN(a, b)   _mm256_min_epi32((a), (b))
+#define VMAX(a, b)   _mm256_max_epi32((a), (b))
+#define VNEG(a)      _mm256_sub_epi32(_mm256_setzero_si256(), (a))
+#define CAND(a, b)   _mm256_mul_ps((a), (b))
+#define COR(a, b)    _mm256_sub_ps(_mm256_add_ps((a), (b)), _mm256_mul_ps((a), (b)))
+
+RTKA_VECTOR_BINARY_OPS(RTKA_DEFINE_BINARY)
+RTKA_DEFINE_NOT()
+RTKA_DEFINE_ACTIVATIONS()
+
+static const rtka_vector_kernels_t rtka_kernels_avx2 = RTKA_KERNEL_TABLE(RTKA_SIMD_AVX2, 8);
+
+#undef RTKA_ISA
+#undef RTKA_TARGET
+#undef LANES
+#undef IVEC
+#undef FVEC
+#undef ILOAD
+#undef ISTORE
+#undef FLOAD
+#undef FSTORE
+#undef VMIN
+#undef VMAX
+#undef VNEG
+#undef CAND
+#undef COR
+
+/* ============================================================================
+ * AVX-512 KERNELS (16 lanes)
+ * ============================================================================ */
+
+#define RTKA_ISA avx512
+#define RTKA_TARGET __attribute__((target("avx512f")))
+#define LANES 16U
+#define IVEC __m512i
+#define FVEC __m512
+#define ILOAD(p)     _mm512_loadu_si512((const void*)(p))
+#define ISTORE(p, v) _mm512_storeu_si512((void*)(p), (v))
+#define FLOAD(p)     _mm512_loadu_ps(p)
+#define FSTORE(p, v) _mm512_storeu_ps((p), (v))
+#define VMIN(a, b)   _mm512_min_epi32((a), (b))
+#define VMAX(a, b)   _mm512_max_epi32((a), (b))
+#define VNEG(a)      _mm512_sub_epi32(_mm512_setzero_si512(), (a))
+#define CAND(a, b)   _mm512_mul_ps((a), (b))
+#define COR(a, b)    _mm512_sub_ps(_mm512_add_ps((a), (b)), _mm512_mul_ps((a), (b)))
+
+RTKA_VECTOR_BINARY_OPS(RTKA_DEFINE_BINARY)
+RTKA_DEFINE_NOT()
+RTKA_DEFINE_ACTIVATIONS()
+
+static const rtka_vector_kernels_t rtka_kernels_avx512 = RTKA_KERNEL_TABLE(RTKA_SIMD_AVX512, 16);
+
+#undef RTKA_ISA
+#undef RTKA_TARGET
+#undef LANES
+#undef IVEC
+#undef FVEC
+#undef ILOAD
+#undef ISTORE
+#undef FLOAD
+#undef FSTORE
+#undef VMIN
+#undef VMAX
+#undef VNEG
+#undef CAND
+#undef COR
+
+#endif /* RTKA_VECTOR_X86 */
+
+#ifdef __ARM_NEON
+
+/* ============================================================================
+ * NEON KERNELS (4 lanes)
+ * ============================================================================ */
+
+#define RTKA_ISA neon
+#define RTKA_TARGET
+#define LANES 4U
+#define IVEC int32x4_t
+#define FVEC float32x4_t
+#define ILOAD(p)     vld1q_s32((const int32_t*)(const void*)(p))
+#define ISTORE(p, v) vst1q_s32((int32_t*)(void*)(p), (v))
+#define FLOAD(p)     vld1q_f32(p)
+#define FSTORE(p, v) vst1q_f32((p), (v))
+#define VMIN(a, b)   vminq_s32((a), (b))
+#define VMAX(a, b)   vmaxq_s32((a), (b))
+#define VNEG(a)      vnegq_s32(a)
+#define CAND(a, b)   vmulq_f32((a), (b))
+#define COR(a, b)    vsubq_f32(vaddq_f32((a), (b)), vmulq_f32((a), (b)))
+
+RTKA_VECTOR_BINARY_OPS(RTKA_DEFINE_BINARY)
+RTKA_DEFINE_NOT()
+RTKA_DEFINE_ACTIVATIONS()
+
+static const rtka_vector_kernels_t rtka_kernels_neon = RTKA_KERNEL_TABLE(RTKA_SIMD_NEON, 4);
+
+#undef RTKA_ISA
+#undef RTKA_TARGET
+#undef LANES
+#undef IVEC
+#undef FVEC
+#undef ILOAD
+#undef ISTORE
+#undef FLOAD
+#undef FSTORE
+#undef VMIN
+#undef VMAX
+#undef VNEG
+#undef CAND
+#undef COR
+
+#endif /* __ARM_NEON */
+
+/* ============================================================================
+ * DISPATCH
+ * ============================================================================ */
+
+static _Atomic(const rtka_vector_kernels_t*) g_rtka_vector_kernels = NULL;
+
+static const rtka_vector_kernels_t* rtka_kernels_for_level(rtka_simd_level_t level) {
+    switch (level) {
+        case RTKA_SIMD_SCALAR:
+            return &rtka_kernels_scalar;
+#ifdef RTKA_VECTOR_X86
+        case RTKA_SIMD_SSE41:
+            return __builtin_cpu_supports("sse4.1") ? &rtka_kernels_sse41 : NULL;
+        case RTKA_SIMD_AVX2:
+            return __builtin_cpu_supports("avx2") ? &rtka_kernels_avx2 : NULL;
+        case RTKA_SIMD_AVX512:
+            return __builtin_cpu_supports("avx512f") ? &rtka_kernels_avx512 : NULL;
+#endif
+#ifdef __ARM_NEON
+        case RTKA_SIMD_NEON:
+            return &rtka_kernels_neon;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static const rtka_vector_kernels_t* rtka_select_kernels(void) {
+    static const rtka_simd_level_t preference[] = {
+        RTKA_SIMD_AVX512, RTKA_SIMD_AVX2, RTKA_SIMD_SSE41, RTKA_SIMD_NEON
+    };
+
+#ifdef RTKA_VECTOR_X86
+    __builtin_cpu_init();
+#endif
+
+    for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++) {
+        const rtka_vector_kernels_t* k = rtka_kernels_for_level(preference[i]);
+        if (k) return k;
+    }
+    return &rtka_kernels_scalar;
+}
+
+/* Racing first callers all compute the same table, so a relaxed publish suffices */
+static RTKA_INLINE const rtka_vector_kernels_t* rtka_kernels(void) {
+    const rtka_vector_kernels_t* k =
+        atomic_load_explicit(&g_rtka_vector_kernels, memory_order_relaxed);
+    if (RTKA_UNLIKELY(!k)) {
+        k = rtka_select_kernels();
+        atomic_store_explicit(&g_rtka_vector_kernels, k, memory_order_relaxed);
+    }
+    return k;
+}
+
+bool rtka_simd_available(void) {
+    return rtka_kernels()->level != RTKA_SIMD_SCALAR;
+}
+
+uint32_t rtka_simd_width(void) {
+    return rtka_kernels()->width;
+}
+
+rtka_simd_level_t rtka_simd_level(void) {
+    return rtka_kernels()->level;
+}
+
+bool rtka_simd_set_level(rtka_simd_level_t level) {
+    const rtka_vector_kernels_t* k = rtka_kernels_for_level(level);
+    if (!k) return false;
+    atomic_store_explicit(&g_rtka_vector_kernels, k, memory_order_relaxed);
+    return true;
+}
+
+const char* rtka_simd_level_name(rtka_simd_level_t level) {
+    switch (level) {
+        case RTKA_SIMD_SCALAR: return "scalar";
+        case RTKA_SIMD_SSE41:  return "sse4.1";
+        case RTKA_SIMD_AVX2:   return "avx2";
+        case RTKA_SIMD_AVX512: return "avx512";
+        case RTKA_SIMD_NEON:   return "neon";
+        default:               return "unknown";
+    }
+}
+
+/* ============================================================================
+ * ELEMENT-WISE OPERATIONS
+ * ============================================================================ */
+
+#define RTKA_VECTOR_BINARY_ENTRY(op)                                           \
+void rtka_vector_##op(const rtka_vector_t* RTKA_RESTRICT a,                    \
+                      const rtka_vector_t* RTKA_RESTRICT b,                    \
+                      rtka_vector_t* RTKA_RESTRICT result) {                   \
+    uint32_t count = a->count < b->count ? a->count : b->count;                \
+    if (count > result->capacity) count = result->capacity;                    \
+    rtka_kernels()->op##_fn(a->values, a->confidences,                         \
+                            b->values, b->confidences,                         \
+                            result->values, result->confidences, count);       \
+    result->count = count;                                                     \
+}
 
-/* Generic vector AND */
-void rtka_vector_and(const rtka_vector_t* RTKA_RESTRICT a,
-                    const rtka_vector_t* RTKA_RESTRICT b,
+RTKA_VECTOR_BINARY_ENTRY(and)
+RTKA_VECTOR_BINARY_ENTRY(or)
+RTKA_VECTOR_BINARY_ENTRY(nand)
+RTKA_VECTOR_BINARY_ENTRY(nor)
+RTKA_VECTOR_BINARY_ENTRY(implies)
+
+#undef RTKA_VECTOR_BINARY_ENTRY
+
+void rtka_vector_not(const rtka_vector_t* RTKA_RESTRICT input,
                     rtka_vector_t* RTKA_RESTRICT result) {
+    uint32_t count = input->count < result->capacity ? input->count : result->capacity;
+    rtka_kernels()->not_fn(input->values, input->confidences,
+                           result->values, result->confidences, count);
+    result->count = count;
+}
+
+/* ============================================================================
+ * ACTIVATIONS
+ * ============================================================================ */
+
+#define RTKA_ACTIVATION_CHUNK 256U   /* Shifted inputs staged on the stack */
+
+void rtka_vector_exp_f32(const float* RTKA_RESTRICT input, float* RTKA_RESTRICT output, uint32_t count) {
+    rtka_kernels()->exp_fn(input, output, count);
+}
+
+void rtka_vector_sigmoid_f32(const float* RTKA_RESTRICT input, float* RTKA_RESTRICT output, uint32_t count) {
+    rtka_kernels()->sigmoid_fn(input, output, count);
+}
+
+void rtka_vector_tanh_f32(const float* RTKA_RESTRICT input, float* RTKA_RESTRICT output, uint32_t count) {
+    rtka_kernels()->tanh_fn(input, output, count);
+}
+
+static float rtka_vector_max_f32(const float* input, uint32_t count) {
+    float top = input[0];
+    for (uint32_t i = 1; i < count; i++) {
+        top = input[i] > top ? input[i] : top;
+    }
+    return top;
+}
+
+void rtka_vector_softmax_f32(const float* input, float* output, uint32_t count) {
+    if (count == 0) return;
+    rtka_vec_map_fn exp_fn = rtka_kernels()->exp_fn;
+    float top = rtka_vector_max_f32(input, count);
+    float shifted[RTKA_ACTIVATION_CHUNK];
+    float sum = 0.0f;
+
+    for (uint32_t first = 0; first < count; first += RTKA_ACTIVATION_CHUNK) {
+        uint32_t n = count - first < RTKA_ACTIVATION_CHUNK ? count - first : RTKA_ACTIVATION_CHUNK;
+        for (uint32_t i = 0; i < n; i++) shifted[i] = input[first + i] - top;
+        exp_fn(shifted, output + first, n);
+        for (uint32_t i = 0; i < n; i++) sum += output[first + i];
+    }
+
+    float scale = 1.0f / sum;
+    for (uint32_t i = 0; i < count; i++) output[i] *= scale;
+}
+
+/* One exp pass for the sum, none stored: x - (max + log(sum(exp(x - max)))) */
+void rtka_vector_log_softmax_f32(const float* input, float* output, uint32_t count) {
+    if (count == 0) return;
+    rtka_vec_map_fn exp_fn = rtka_kernels()->exp_fn;
+    float top = rtka_vector_max_f32(input, count);
+    float shifted[RTKA_ACTIVATION_CHUNK];
+    float exps[RTKA_ACTIVATION_CHUNK];
+    float sum = 0.0f;
+
+    for (uint32_t first = 0; first < count; first += RTKA_ACTIVATION_CHUNK) {
+        uint32_t n = count - first < RTKA_ACTIVATION_CHUNK ? count - first : RTKA_ACTIVATION_CHUNK;
+        for (uint32_t i = 0; i < n; i++) shifted[i] = input[first + i] - top;
+        exp_fn(shifted, exps, n);
+        for (uint32_t i = 0; i < n; i++) sum += exps[i];
+    }
+
+    float log_sum = top + logf(sum);
+    for (uint32_t i = 0; i < count; i++) output[i] = input[i] - log_sum;
+}
+
+/* ============================================================================
+ * PARALLEL OPERATIONS
+ * ============================================================================ */
+
+typedef struct {
+    const rtka_vector_t* a;
+    const rtka_vector_t* b;
+    rtka_vector_t* result;
+    rtka_vec_binary_fn kernel;
+} rtka_vector_range_job_t;
+
+static void rtka_vector_range_binary(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    const rtka_vector_range_job_t* job = (const rtka_vector_range_job_t*)ctx;
+    job->kernel(job->a->values + begin, job->a->confidences + begin,
+                job->b->values + begin, job->b->confidences + begin,
+                job->result->values + begin, job->result->confidences + begin,
+                end - begin);
+}
+
+void rtka_vector_parallel_and(const rtka_vector_t* RTKA_RESTRICT a,
+                             const rtka_vector_t* RTKA_RESTRICT b,
+                             rtka_vector_t* RTKA_RESTRICT result,
+                             uint32_t num_threads) {
     uint32_t count = a->count < b->count ? a->count : b->count;
-    
-    #ifdef __AVX2__
-    if (count >= RTKA_SIMD_THRESHOLD) {
-        rtka_vector_and_avx2(a->confidences, b->confidences, 
-                           result->confidences, count);
-        /* Handle values separately */
-        for (uint32_t i = 0; i < count; i++) {
-            result->values[i] = rtka_and(a->values[i], b->values[i]);
-        }
-        result->count = count;
+    if (count > result->capacity) count = result->capacity;
+
+    rtka_thread_pool_t* pool = rtka_pool_default();
+    uint32_t threads = pool ? rtka_pool_size(pool) + 1U : 1U;
+    if (num_threads > 0 && num_threads < threads) threads = num_threads;
+
+    /* Streaming op: below a few chunks the wake-up costs more than it saves */
+    if (!pool || threads < 2U || count < 2U * RTKA_PARALLEL_MIN_CHUNK) {
+        rtka_vector_and(a, b, result);
         return;
     }
-    #endif
-    
-    /* Scalar fallback with unrolling */
+
+    /* One contiguous, cache-line-multiple slice per participant */
+    uint32_t grain = (count + threads - 1U) / threads;
+    if (grain < RTKA_PARALLEL_MIN_CHUNK) grain = RTKA_PARALLEL_MIN_CHUNK;
+    grain = (grain + 15U) & ~15U;
+
+    rtka_vector_range_job_t job = { a, b, result, rtka_kernels()->and_fn };
+    rtka_pool_parallel_for(pool, 0, count, grain, rtka_vector_range_binary, &job);
+    result->count = count;
+}
+
+/* ============================================================================
+ * REDUCTIONS
+ * Blocked like rtka_recursive_and_seq: min over a block of values, check the
+ * absorbing element once per block, confidence into independent accumulators.
+ * OR runs as AND over negated values and complemented confidences.
+ * ============================================================================ */
+
+#define RTKA_REDUCE_BLOCK 64U
+#define RTKA_REDUCE_LANES 16U
+
+static RTKA_INLINE rtka_state_t rtka_vector_reduce(const rtka_vector_t* vec, int32_t sign) {
+    const int32_t* RTKA_RESTRICT values = (const int32_t*)(const void*)vec->values;
+    const float* RTKA_RESTRICT confs = vec->confidences;
+    uint32_t count = vec->count;
+
+    float acc[RTKA_REDUCE_LANES];
+    for (uint32_t k = 0; k < RTKA_REDUCE_LANES; k++) acc[k] = 1.0f;
+    int32_t value = RTKA_TRUE;
+
     uint32_t i = 0;
-    for (; i + 3 < count; i += 4) {
-        result->values[i] = rtka_and(a->values[i], b->values[i]);
-        result->values[i+1] = rtka_and(a->values[i+1], b->values[i+1]);
-        result->values[i+2] = rtka_and(a->values[i+2], b->values[i+2]);
-        result->values[i+3] = rtka_and(a->values[i+3], b->values[i+3]);
-        
-        result->confidences[i] = rtka_conf_and(a->confidences[i], b->confidences[i]);
-        result->confidences[i+1] = rtka_conf_and(a->confidences[i+1], b->confidences[i+1]);
-        result->confidences[i+2] = rtka_conf_and(a->confidences[i+2], b->confidences[i+2]);
-        result->confidences[i+3] = rtka_conf_and(a->confidences[i+3], b->confidences[i+3]);
-    }
-    
+    for (; i + RTKA_REDUCE_BLOCK <= count; i += RTKA_REDUCE_BLOCK) {
+        int32_t block_min = RTKA_TRUE;
+        for (uint32_t j = 0; j < RTKA_REDUCE_BLOCK; j++) {
+            int32_t v = sign * values[i + j];
+            block_min = v < block_min ? v : block_min;
+        }
+        if (RTKA_UNLIKELY(block_min == RTKA_FALSE)) break;
+
+        for (uint32_t j = 0; j < RTKA_REDUCE_BLOCK; j += RTKA_REDUCE_LANES) {
+            for (uint32_t k = 0; k < RTKA_REDUCE_LANES; k++) {
+                float c = confs[i + j + k];
+                acc[k] *= (sign > 0) ? c : 1.0f - c;
+            }
+        }
+        value = block_min < value ? block_min : value;
+    }
+
+    /* Remainder, or the block holding the absorbing element: exact fold */
     for (; i < count; i++) {
-        result->values[i] = rtka_and(a->values[i], b->values[i]);
-        result->confidences[i] = rtka_conf_and(a->confidences[i], b->confidences[i]);
+        int32_t v = sign * values[i];
+        value = v < value ? v : value;
+        acc[0] *= (sign > 0) ? confs[i] : 1.0f - confs[i];
+        if (value == RTKA_FALSE) break;  /* Early termination */
     }
-    
-    result->count = count;
+
+    for (uint32_t width = RTKA_REDUCE_LANES / 2U; width > 0U; width /= 2U) {
+        for (uint32_t k = 0; k < width; k++) acc[k] *= acc[k + width];
+    }
+
+    float conf = (sign > 0) ? acc[0] : 1.0f - acc[0];
+    return rtka_make_state((rtka_value_t)(sign * value), conf);
 }
 
 /* Vector reduction AND */
 rtka_state_t rtka_vector_reduce_and(const rtka_vector_t* vec) {
     if (vec->count == 0) return rtka_make_state(RTKA_TRUE, 1.0f);
-    
-    rtka_value_t val = vec->values[0];
-    rtka_confidence_t conf = vec->confidences[0];
-    
-    for (uint32_t i = 1; i < vec->count; i++) {
-        if (val == RTKA_FALSE) break;  /* Early termination */
-        val = rtka_and(val, vec->values[i]);
-        conf = rtka_conf_and(conf, vec->confidences[i]);
-    }
-    
-    return rtka_make_state(val, conf);
+    return rtka_vector_reduce(vec, 1);
+}
+
+/* Vector reduction OR */
+rtka_state_t rtka_vector_reduce_or(const rtka_vector_t* vec) {
+    if (vec->count == 0) return rtka_make_state(RTKA_FALSE, 1.0f);
+    return rtka_vector_reduce(vec, -1);
 }
 
+/* ============================================================================
+ * BROADCAST
+ * ============================================================================ */
+
 /* Vector broadcast */
 void rtka_vector_broadcast(rtka_vector_t* vec, rtka_state_t value) {
     /* Use memset for special cases */
     if (value.value == RTKA_FALSE && value.confidence == 0.0f) {
-        memset(vec->values, RTKA_FALSE, vec->capacity * sizeof(rtka_value_t));
+        memset(vec->values, 0xFF, vec->capacity * sizeof(rtka_value_t));
         memset(vec->confidences, 0, vec->capacity * sizeof(rtka_confidence_t));
         vec->count = vec->capacity;
         return;
     }
-    
-    /* General case with unrolling */
-    uint32_t i = 0;
-    for (; i + 7 < vec->capacity; i += 8) {
-        vec->values[i] = vec->values[i+1] = vec->values[i+2] = vec->values[i+3] = 
-        vec->values[i+4] = vec->values[i+5] = vec->values[i+6] = vec->values[i+7] = value.value;
-        
-        vec->confidences[i] = vec->confidences[i+1] = vec->confidences[i+2] = vec->confidences[i+3] =
-        vec->confidences[i+4] = vec->confidences[i+5] = vec->confidences[i+6] = vec->confidences[i+7] = value.confidence;
-    }
-    
-    for (; i < vec->capacity; i++) {
+
+    rtka_vector_fill_range(vec, 0, vec->capacity, value);
+    vec->count = vec->capacity;
+}
+
+void rtka_vector_fill_range(rtka_vector_t* vec, uint32_t start, uint32_t end, rtka_state_t value) {
+    if (end > vec->capacity) end = vec->capacity;
+    if (start >= end) return;
+
+    /* Simple stores; the compiler vectorizes this for the build target */
+    for (uint32_t i = start; i < end; i++) {
         vec->values[i] = value.value;
         vec->confidences[i] = value.confidence;
     }
-    
-    vec->count = vec->capacity;
+
+    if (end > vec->count) vec->count = end;
+}
+
+/* ============================================================================
+ * CONFIDENCE OPERATIONS
+ * ============================================================================ */
+
+void rtka_vector_conf_multiply(rtka_vector_t* vec, rtka_confidence_t scalar) {
+    for (uint32_t i = 0; i < vec->count; i++) {
+        vec->confidences[i] *= scalar;
+    }
 }
 
+void rtka_vector_conf_normalize(rtka_vector_t* vec) {
+    for (uint32_t i = 0; i < vec->count; i++) {
+        float c = vec->confidences[i];
+        c = c < 0.0f ? 0.0f : c;
+        vec->confidences[i] = c > 1.0f ? 1.0f : c;
+    }
+}
+
+/* ============================================================================
+ * DIRECT CONFIDENCE KERNELS
+ * Kept for callers that manage the planes themselves
+ * ============================================================================ */
+
 #ifdef __AVX2__
 /* AVX2 confidence multiplication */
 void rtka_vector_and_avx2(const float* RTKA_RESTRICT conf_a,
@@ -107,14 +739,14 @@ void rtka_vector_and_avx2(const float* RTKA_RESTRICT conf_a,
                          float* RTKA_RESTRICT conf_result,
                          uint32_t count) {
     uint32_t simd_count = count & ~7u;  /* Round down to multiple of 8 */
-    
+
     for (uint32_t i = 0; i < simd_count; i += 8) {
-        __m256 a = _mm256_load_ps(&conf_a[i]);
-        __m256 b = _mm256_load_ps(&conf_b[i]);
+        __m256 a = _mm256_loadu_ps(&conf_a[i]);
+        __m256 b = _mm256_loadu_ps(&conf_b[i]);
         __m256 result = _mm256_mul_ps(a, b);  /* AND confidence = multiply */
-        _mm256_store_ps(&conf_result[i], result);
+        _mm256_storeu_ps(&conf_result[i], result);
     }
-    
+
     /* Handle remainder */
     for (uint32_t i = simd_count; i < count; i++) {
         conf_result[i] = conf_a[i] * conf_b[i];
@@ -126,39 +758,35 @@ void rtka_vector_or_avx2(const float* RTKA_RESTRICT conf_a,
                         float* RTKA_RESTRICT conf_result,
                         uint32_t count) {
     uint32_t simd_count = count & ~7u;
-    
+
     for (uint32_t i = 0; i < simd_count; i += 8) {
-        __m256 a = _mm256_load_ps(&conf_a[i]);
-        __m256 b = _mm256_load_ps(&conf_b[i]);
+        __m256 a = _mm256_loadu_ps(&conf_a[i]);
+        __m256 b = _mm256_loadu_ps(&conf_b[i]);
         __m256 ab = _mm256_mul_ps(a, b);
         __m256 sum = _mm256_add_ps(a, b);
         __m256 result = _mm256_sub_ps(sum, ab);  /* OR confidence = a + b - ab */
-        _mm256_store_ps(&conf_result[i], result);
+        _mm256_storeu_ps(&conf_result[i], result);
     }
-    
+
     for (uint32_t i = simd_count; i < count; i++) {
         conf_result[i] = conf_a[i] + conf_b[i] - conf_a[i] * conf_b[i];
     }
 }
 #endif
 
-/* SIMD detection */
-bool rtka_simd_available(void) {
-    #ifdef __AVX2__
-    return true;
-    #elif defined(__ARM_NEON)
-    return true;
-    #else
-    return false;
-    #endif
-}
+#ifdef __ARM_NEON
+void rtka_vector_and_neon(const float* RTKA_RESTRICT conf_a,
+                         const float* RTKA_RESTRICT conf_b,
+                         float* RTKA_RESTRICT conf_result,
+                         uint32_t count) {
+    uint32_t simd_count = count & ~3u;
 
-uint32_t rtka_simd_width(void) {
-    #ifdef __AVX2__
-    return 8;  /* 8 floats in AVX */
-    #elif defined(__ARM_NEON)
-    return 4;  /* 4 floats in NEON */
-    #else
-    return 1;
-    #endif
+    for (uint32_t i = 0; i < simd_count; i += 4) {
+        vst1q_f32(&conf_result[i], vmulq_f32(vld1q_f32(&conf_a[i]), vld1q_f32(&conf_b[i])));
+    }
+
+    for (uint32_t i = simd_count; i < count; i++) {
+        conf_result[i] = conf_a[i] * conf_b[i];
+    }
 }
+#endif
@@ -9,6 +9,12 @@
  * For licensing inquiries: opsec.ee@pm.me
  *
  * RTKA Vector Operations - SIMD Optimized
+ *
+ * CHANGELOG:
+ * v1.1.0 - Runtime-dispatched kernels for both value and confidence planes
+ *          Added rtka_vector_nand / nor / implies and SIMD level control
+ * v1.2.0 - Activation kernels: polynomial exp / sigmoid / tanh in float
+ *          with bounded error, softmax and fused log-softmax
  */
 
 #ifndef RTKA_VECTOR_H
@@ -16,6 +22,7 @@
 
 #include "rtka_types.h"
 #include "rtka_u_core.h"
+#include <math.h>
 
 #ifdef __AVX2__
 #include <immintrin.h>
@@ -42,6 +49,19 @@ void rtka_vector_or(const rtka_vector_t* RTKA_RESTRICT a,
 void rtka_vector_not(const rtka_vector_t* RTKA_RESTRICT input,
                     rtka_vector_t* RTKA_RESTRICT result);
 
+void rtka_vector_nand(const rtka_vector_t* RTKA_RESTRICT a,
+                     const rtka_vector_t* RTKA_RESTRICT b,
+                     rtka_vector_t* RTKA_RESTRICT result);
+
+void rtka_vector_nor(const rtka_vector_t* RTKA_RESTRICT a,
+                    const rtka_vector_t* RTKA_RESTRICT b,
+                    rtka_vector_t* RTKA_RESTRICT result);
+
+/* ¬a ∨ b; confidence combines as in OR */
+void rtka_vector_implies(const rtka_vector_t* RTKA_RESTRICT a,
+                        const rtka_vector_t* RTKA_RESTRICT b,
+                        rtka_vector_t* RTKA_RESTRICT result);
+
 /* Reduction operations */
 rtka_state_t rtka_vector_reduce_and(const rtka_vector_t* vec);
 rtka_state_t rtka_vector_reduce_or(const rtka_vector_t* vec);
@@ -52,11 +72,94 @@ void rtka_vector_fill_range(rtka_vector_t* vec, uint32_t start, uint32_t end, rt
 
 /* Element-wise confidence operations */
 void rtka_vector_conf_multiply(rtka_vector_t* vec, rtka_confidence_t scalar);
-void rtka_vector_conf_normalize(rtka_vector_t* vec);
+void rtka_vector_conf_normalize(rtka_vector_t* vec);  /* Clamp to [0, 1] */
+
+/* Activation approximations
+ * Branch-free, so loops calling them vectorize. Worst error against
+ * double libm over every float input, vectorized under -ffast-math (its
+ * reciprocal estimates included):
+ *   rtka_fast_expf      1.2 ulp on [-87.33, 88.37], clamped to it outside
+ *   rtka_fast_sigmoidf  4.2 ulp
+ *   rtka_fast_tanhf     2.2 ulp
+ */
+
+/* x - n ln2 in two parts (Cody-Waite); fused or in double so that
+ * -ffast-math cannot fold the parts back into one rounded product */
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+#define RTKA_EXP_REDUCE(x, n) fmaf((n), 2.12194440e-4f, fmaf((n), -0.693359375f, (x)))
+#else
+#define RTKA_EXP_REDUCE(x, n) ((float)((double)(x) - (double)(n) * 0.693147180559945309))
+#endif
+
+RTKA_INLINE rtka_confidence_t rtka_fast_expf(rtka_confidence_t x) {
+    x = x < -87.33654f ? -87.33654f : x;
+    x = x > 88.37626f ? 88.37626f : x;
+    float n = floorf(x * 1.44269504089f + 0.5f);
+    float r = RTKA_EXP_REDUCE(x, n);
+
+    /* Cephes expf: e^r on [-ln2 / 2, ln2 / 2] */
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+
+    union { uint32_t bits; float value; } scale = { (uint32_t)((int32_t)n + 127) << 23 };
+    return p * scale.value;
+}
+
+RTKA_INLINE rtka_confidence_t rtka_fast_sigmoidf(rtka_confidence_t x) {
+    return 1.0f / (1.0f + rtka_fast_expf(-x));
+}
+
+/* Odd polynomial below 0.625, where 1 - 2 / (e^2x + 1) would cancel */
+RTKA_INLINE rtka_confidence_t rtka_fast_tanhf(rtka_confidence_t x) {
+    float a = fabsf(x);
+    float z = x * x;
+    float p = -5.70498872745e-3f;
+    p = p * z + 2.06390887954e-2f;
+    p = p * z - 5.37397155531e-2f;
+    p = p * z + 1.33314422036e-1f;
+    p = p * z - 3.33332819422e-1f;
+    float small = x + x * z * p;
+    float large = 1.0f - 2.0f / (rtka_fast_expf(2.0f * a) + 1.0f);
+    large = x < 0.0f ? -large : large;
+    return a < 0.625f ? small : large;
+}
+
+/* Activations over float arrays, on the dispatched kernel set; input and
+ * output must not overlap */
+void rtka_vector_exp_f32(const float* RTKA_RESTRICT input, float* RTKA_RESTRICT output, uint32_t count);
+void rtka_vector_sigmoid_f32(const float* RTKA_RESTRICT input, float* RTKA_RESTRICT output, uint32_t count);
+void rtka_vector_tanh_f32(const float* RTKA_RESTRICT input, float* RTKA_RESTRICT output, uint32_t count);
+
+/* Softmax and x - log(sum(exp(x))), shifted by the maximum; output may be
+ * input. count 0 does nothing. */
+void rtka_vector_softmax_f32(const float* input, float* output, uint32_t count);
+void rtka_vector_log_softmax_f32(const float* input, float* output, uint32_t count);
+
+/* SIMD detection and dispatch
+ * The kernel set is chosen from CPUID on first use and shared by all threads.
+ * Element-wise ops accept unaligned planes; result->count is clamped to
+ * result->capacity.
+ */
+typedef enum {
+    RTKA_SIMD_SCALAR = 0,
+    RTKA_SIMD_SSE41,
+    RTKA_SIMD_AVX2,
+    RTKA_SIMD_AVX512,
+    RTKA_SIMD_NEON
+} rtka_simd_level_t;
 
-/* SIMD detection and dispatch */
 bool rtka_simd_available(void);
 uint32_t rtka_simd_width(void);
+rtka_simd_level_t rtka_simd_level(void);
+const char* rtka_simd_level_name(rtka_simd_level_t level);
+
+/* Force a kernel set (benchmarks, testing); false if the CPU lacks it */
+bool rtka_simd_set_level(rtka_simd_level_t level);
 
 #ifdef __AVX2__
 /* AVX2 implementations */
@@ -79,7 +182,8 @@ void rtka_vector_and_neon(const float* RTKA_RESTRICT conf_a,
                          uint32_t count);
 #endif
 
-/* Parallel operations for large vectors */
+/* Parallel operations for large vectors
+ * Runs on rtka_pool_default(); num_threads caps participants (0 = all) */
 void rtka_vector_parallel_and(const rtka_vector_t* RTKA_RESTRICT a,
                              const rtka_vector_t* RTKA_RESTRICT b,
                              rtka_vector_t* RTKA_RESTRICT result,
@@ -11,6 +11,9 @@
  * Test RTKA A* Search with Grid Pathfinding
  * 
  * CHANGELOG:
+ * v1.1.0 - Large grid routing check: hashed states, path length against BFS
+ * v1.2.0 - The same route in bucket-queue, bidirectional and combined modes
+ * v1.3.0 - And with inline states filled by get_neighbors_into
  * v1.0.1 - Fixed memory management for path states
  *          All path states are cloned so all must be freed
  */
@@ -20,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 
 #define GRID_WIDTH 10
 #define GRID_HEIGHT 10
@@ -120,6 +124,185 @@ rtka_state_t cost_grid(void* from, void* to) {
     }
 }
 
+/* Routing on a large random grid. Step and heuristic confidences combine
+ * as 1 - (1 - c)^n under conf_or, so f orders by steps + Manhattan and the
+ * path is a shortest one. */
+#define ROUTE_SIZE  400
+#define ROUTE_STEP  0.0005f
+
+typedef struct {
+    uint16_t x, y;
+} route_cell_t;
+
+static uint8_t route_wall[ROUTE_SIZE][ROUTE_SIZE];
+static bool route_integer;      /* ASTAR_INTEGER_COSTS: unit steps, Manhattan h */
+
+static void* clone_route(void* state) {
+    route_cell_t* clone = malloc(sizeof(route_cell_t));
+    *clone = *(route_cell_t*)state;
+    return clone;
+}
+
+static bool equals_route(void* a, void* b) {
+    route_cell_t* ca = (route_cell_t*)a;
+    route_cell_t* cb = (route_cell_t*)b;
+    return ca->x == cb->x && ca->y == cb->y;
+}
+
+static uint64_t hash_route(void* state) {
+    route_cell_t* c = (route_cell_t*)state;
+    return ((uint64_t)c->y * ROUTE_SIZE + c->x) * 0x9E3779B97F4A7C15ULL;
+}
+
+static bool is_goal_route(void* state) {
+    route_cell_t* c = (route_cell_t*)state;
+    return c->x == ROUTE_SIZE - 1 && c->y == ROUTE_SIZE - 1;
+}
+
+static void* get_neighbors_route(void* state, uint32_t* count) {
+    static route_cell_t* neighbors[4];
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {-1, 0, 1, 0};
+    route_cell_t* c = (route_cell_t*)state;
+    *count = 0;
+    for (int i = 0; i < 4; i++) {
+        int nx = c->x + dx[i], ny = c->y + dy[i];
+        if (nx < 0 || nx >= ROUTE_SIZE || ny < 0 || ny >= ROUTE_SIZE || route_wall[ny][nx]) continue;
+        route_cell_t* n = malloc(sizeof(route_cell_t));
+        n->x = (uint16_t)nx;
+        n->y = (uint16_t)ny;
+        neighbors[(*count)++] = n;
+    }
+    return neighbors;
+}
+
+/* Inline variant: neighbors written into the search's buffer */
+static uint32_t get_neighbors_route_into(void* state, void* neighbors, uint32_t max_neighbors) {
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {-1, 0, 1, 0};
+    route_cell_t* c = (route_cell_t*)state;
+    route_cell_t* out = (route_cell_t*)neighbors;
+    uint32_t count = 0;
+    for (int i = 0; i < 4 && count < max_neighbors; i++) {
+        int nx = c->x + dx[i], ny = c->y + dy[i];
+        if (nx < 0 || nx >= ROUTE_SIZE || ny < 0 || ny >= ROUTE_SIZE || route_wall[ny][nx]) continue;
+        out[count++] = (route_cell_t){(uint16_t)nx, (uint16_t)ny};
+    }
+    return count;
+}
+
+static rtka_state_t heuristic_route(void* state, void* goal) {
+    route_cell_t* c = (route_cell_t*)state;
+    route_cell_t* g = (route_cell_t*)goal;
+    int dist = abs(c->x - g->x) + abs(c->y - g->y);
+    if (route_integer) return rtka_make_state(RTKA_TRUE, (float)dist);
+    return rtka_make_state(RTKA_TRUE, 1.0f - powf(1.0f - ROUTE_STEP, (float)dist));
+}
+
+static rtka_state_t cost_route(void* from, void* to) {
+    (void)from;
+    (void)to;
+    return rtka_make_state(RTKA_TRUE, route_integer ? 1.0f : ROUTE_STEP);
+}
+
+/* Reference shortest path length in cells, 0 if unreachable */
+static uint32_t bfs_route(void) {
+    static int32_t dist[ROUTE_SIZE * ROUTE_SIZE];
+    static uint32_t queue[ROUTE_SIZE * ROUTE_SIZE];
+    memset(dist, -1, sizeof(dist));
+    uint32_t head = 0, tail = 0;
+    dist[0] = 1;
+    queue[tail++] = 0;
+    while (head < tail) {
+        uint32_t cur = queue[head++];
+        int x = (int)(cur % ROUTE_SIZE), y = (int)(cur / ROUTE_SIZE);
+        int next[4][2] = {{x, y - 1}, {x + 1, y}, {x, y + 1}, {x - 1, y}};
+        for (int i = 0; i < 4; i++) {
+            int nx = next[i][0], ny = next[i][1];
+            if (nx < 0 || nx >= ROUTE_SIZE || ny < 0 || ny >= ROUTE_SIZE || route_wall[ny][nx]) continue;
+            uint32_t idx = (uint32_t)(ny * ROUTE_SIZE + nx);
+            if (dist[idx] >= 0) continue;
+            dist[idx] = dist[cur] + 1;
+            queue[tail++] = idx;
+        }
+    }
+    int32_t d = dist[ROUTE_SIZE * ROUTE_SIZE - 1];
+    return d > 0 ? (uint32_t)d : 0;
+}
+
+static bool route_once(const char* name, uint32_t flags, bool inline_states, uint32_t expected) {
+    route_integer = (flags & ASTAR_INTEGER_COSTS) != 0;
+    rtka_astar_t* astar = rtka_astar_create();
+    astar->flags = flags;
+    astar->is_goal = is_goal_route;
+    astar->get_neighbors = get_neighbors_route;
+    astar->heuristic = heuristic_route;
+    astar->cost = cost_route;
+    astar->equals = equals_route;
+    astar->clone_state = clone_route;
+    astar->free_state = free;
+    astar->hash = hash_route;
+    if (inline_states) {
+        /* Bytes only: no clone / free / equals / hash callbacks needed */
+        astar->get_neighbors_into = get_neighbors_route_into;
+        astar->state_size = sizeof(route_cell_t);
+        astar->clone_state = NULL;
+        astar->free_state = NULL;
+        astar->equals = NULL;
+        astar->hash = NULL;
+    }
+
+    route_cell_t start = {0, 0}, goal = {ROUTE_SIZE - 1, ROUTE_SIZE - 1};
+    clock_t begin = clock();
+    rtka_astar_node_t* result = rtka_astar_search(astar, &start, &goal);
+    double elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+    uint32_t length = 0;
+    bool ok = (result != NULL) == (expected != 0);
+    if (result) {
+        void** path = rtka_astar_get_path(result, &length);
+        ok &= equals_route(path[0], &start) && equals_route(path[length - 1], &goal);
+        for (uint32_t i = 1; i < length; i++) {
+            route_cell_t* a = (route_cell_t*)path[i - 1];
+            route_cell_t* b = (route_cell_t*)path[i];
+            ok &= abs(a->x - b->x) + abs(a->y - b->y) == 1 && !route_wall[b->y][b->x];
+        }
+        free(path);
+    }
+    ok &= length == expected;
+    printf("  %-14s path %u (BFS %u), %6u nodes, %.3f s\n", name, length, expected,
+           astar->forward.node_count + astar->backward.node_count, elapsed);
+    rtka_astar_free(astar);
+    return ok;
+}
+
+static bool check_large_grid(void) {
+    srand(34);
+    for (int y = 0; y < ROUTE_SIZE; y++) {
+        for (int x = 0; x < ROUTE_SIZE; x++) route_wall[y][x] = (uint8_t)(rand() % 100 < 25);
+    }
+    route_wall[0][0] = 0;
+    route_wall[ROUTE_SIZE - 1][ROUTE_SIZE - 1] = 0;
+    uint32_t expected = bfs_route();
+
+    printf("%dx%d grid:\n", ROUTE_SIZE, ROUTE_SIZE);
+    bool ok = route_once("heap", 0, false, expected);
+    ok &= route_once("buckets", ASTAR_INTEGER_COSTS, false, expected);
+    ok &= route_once("bidirectional", ASTAR_BIDIRECTIONAL, false, expected);
+    ok &= route_once("both", ASTAR_INTEGER_COSTS | ASTAR_BIDIRECTIONAL, false, expected);
+    ok &= route_once("inline heap", 0, true, expected);
+    ok &= route_once("inline buckets", ASTAR_INTEGER_COSTS, true, expected);
+    ok &= route_once("inline both", ASTAR_INTEGER_COSTS | ASTAR_BIDIRECTIONAL, true, expected);
+
+    /* A walled-in goal: every mode exhausts and reports no path */
+    route_wall[ROUTE_SIZE - 2][ROUTE_SIZE - 1] = 1;
+    route_wall[ROUTE_SIZE - 1][ROUTE_SIZE - 2] = 1;
+    ok &= bfs_route() == 0;
+    ok &= route_once("blocked", ASTAR_BIDIRECTIONAL, false, 0);
+    ok &= route_once("blocked", ASTAR_INTEGER_COSTS, true, 0);
+    return ok;
+}
+
 int main(void) {
     printf("RTKA A* Search Test\n");
     printf("===================\n\n");
@@ -209,5 +392,9 @@ int main(void) {
     free(start);
     free(goal);
     
-    return 0;
+    printf("\nLarge grid routing:\n");
+    bool routed = check_large_grid();
+    printf("%s\n", routed ? "✅ Shortest route verified" : "❌ Route mismatch");
+    
+    return routed ? 0 : 1;
 }
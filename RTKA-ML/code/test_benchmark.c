@@ -0,0 +1,197 @@
+/**
+ * File: test_benchmark.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Benchmark harness: statistics, barriers, output, baselines
+ *
+ * A dependency chain of n multiply-adds must measure four times longer at
+ * 4n, with ordered percentiles and a calibrated sample near the target
+ * time. Occasional slow calls must land outside the fences without moving
+ * the median. Barriers must keep a discarded sum alive, copies report
+ * bytes/s, and results must survive CSV and JSON output and be judged
+ * against a saved baseline.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_benchmark.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    uint32_t n;
+    uint32_t slow_every;            /* Every slow_every-th call runs 400 chains */
+    uint64_t calls;
+    float acc;
+} chain_t;
+
+static void chain(void* data) {
+    chain_t* c = (chain_t*)data;
+    uint32_t n = c->n;
+    if (c->slow_every && ++c->calls % c->slow_every == 0) n *= 400U;
+    float x = c->acc;
+    for (uint32_t k = 0; k < n; k++) x = x * 0.999f + 0.001f;
+    c->acc = x;
+}
+
+typedef struct {
+    float values[1024];
+    bool barrier;
+} sum_t;
+
+static void sum_discarded(void* data) {
+    sum_t* s = (sum_t*)data;
+    float total = 0.0f;
+    for (uint32_t i = 0; i < 1024; i++) total += s->values[i];
+    if (s->barrier) RTKA_DO_NOT_OPTIMIZE(total);
+}
+
+typedef struct {
+    uint8_t* src;
+    uint8_t* dst;
+    size_t bytes;
+} copy_t;
+
+static void copy(void* data) {
+    copy_t* c = (copy_t*)data;
+    memcpy(c->dst, c->src, c->bytes);
+}
+
+static bool check_statistics(rtka_benchmark_result_t* results) {
+    printf("\n--- Statistics ---\n");
+    chain_t short_chain = { .n = 1000, .acc = 0.5f }, long_chain = { .n = 4000, .acc = 0.5f };
+    rtka_benchmark_config_t config = { .elements_per_op = 1000 };
+    results[0] = rtka_benchmark_measure("chain 1000", chain, &short_chain, &config);
+    config.elements_per_op = 4000;
+    results[1] = rtka_benchmark_measure("chain 4000", chain, &long_chain, &config);
+    rtka_benchmark_print_results(&results[0]);
+    rtka_benchmark_print_results(&results[1]);
+
+    double ratio = results[1].median_time / results[0].median_time;
+    double sample = results[0].median_time * (double)results[0].iterations_per_sample;
+    bool ordered = true;
+    for (int i = 0; i < 2; i++) {
+        const rtka_benchmark_result_t* r = &results[i];
+        ordered &= r->min_time <= r->p10_time && r->p10_time <= r->median_time &&
+                   r->median_time <= r->p90_time && r->p90_time <= r->max_time && r->samples == 21;
+    }
+    printf("  4x the work: %.2fx the median; calibrated sample %.1f ms for a 10 ms target\n", ratio, sample * 1e3);
+
+    /* Fixed counts through rtka_benchmark_run */
+    rtka_benchmark_result_t fixed = rtka_benchmark_run("chain 1000 fixed", chain, &short_chain, 1000);
+    bool counted = fixed.iterations <= 1000 && fixed.iterations > 1000 - fixed.samples;
+    printf("  rtka_benchmark_run of 1000: %llu operations in %u samples\n",
+           (unsigned long long)fixed.iterations, fixed.samples);
+    return ordered && ratio > 3.0 && ratio < 5.0 && sample > 0.003 && sample < 0.05 && counted;
+}
+
+static bool check_outliers(const rtka_benchmark_result_t* clean) {
+    printf("\n--- Outliers ---\n");
+    chain_t noisy = { .n = 1000, .slow_every = 1000, .acc = 0.5f };
+    rtka_benchmark_config_t config = { .iterations = 100 };
+    rtka_benchmark_result_t r = rtka_benchmark_measure("chain 1000 noisy", chain, &noisy, &config);
+    rtka_benchmark_print_results(&r);
+    double shift = r.median_time / clean->median_time;
+    printf("  one call in 1000 at 400x: %u of %u samples set aside, median %.2fx the clean one, max %.1fx\n",
+           r.outliers, r.samples, shift, r.max_time / clean->median_time);
+    return r.outliers >= 1 && shift < 1.3 && r.avg_time < 1.3 * clean->median_time &&
+           r.max_time > 2.0 * clean->median_time;
+}
+
+static bool check_barriers(rtka_benchmark_result_t* result) {
+    printf("\n--- Barriers and throughput ---\n");
+    sum_t* sum = (sum_t*)calloc(1, sizeof(sum_t));
+    copy_t c = { .bytes = 1U << 20 };
+    c.src = (uint8_t*)malloc(c.bytes);
+    c.dst = (uint8_t*)malloc(c.bytes);
+    if (!sum || !c.src || !c.dst) return false;
+    for (uint32_t i = 0; i < 1024; i++) sum->values[i] = (float)i;
+    memset(c.src, 1, c.bytes);
+
+    rtka_benchmark_result_t discarded = rtka_benchmark_measure("sum discarded", sum_discarded, sum, NULL);
+    sum->barrier = true;
+    rtka_benchmark_result_t kept = rtka_benchmark_measure("sum kept", sum_discarded, sum, NULL);
+    rtka_benchmark_config_t config = { .bytes_per_op = c.bytes, .elements_per_op = c.bytes };
+    *result = rtka_benchmark_measure("memcpy 1 MiB", copy, &c, &config);
+    rtka_benchmark_print_results(&discarded);
+    rtka_benchmark_print_results(&kept);
+    rtka_benchmark_print_results(result);
+
+    bool ok = kept.median_time > 1024 * 0.05e-9 && result->bytes_per_sec > 1e8 &&
+              result->elements_per_sec == result->bytes_per_sec;
+    free(sum);
+    free(c.src);
+    free(c.dst);
+    return ok;
+}
+
+static bool check_output(const rtka_benchmark_result_t* results, uint32_t count) {
+    printf("\n--- Output and baselines ---\n");
+    char csv_path[64], json_path[64];
+    snprintf(csv_path, sizeof(csv_path), "/tmp/rtka_benchmark_%d.csv", (int)getpid());
+    snprintf(json_path, sizeof(json_path), "/tmp/rtka_benchmark_%d.json", (int)getpid());
+
+    /* A name that needs quoting rides along */
+    rtka_benchmark_result_t* saved = (rtka_benchmark_result_t*)malloc((count + 1U) * sizeof(*saved));
+    if (!saved) return false;
+    memcpy(saved, results, count * sizeof(*saved));
+    saved[count] = results[0];
+    saved[count].name = "chain, \"quoted\"";
+
+    FILE* out = fopen(csv_path, "w");
+    FILE* json = fopen(json_path, "w+");
+    if (!out || !json) return false;
+    rtka_benchmark_write_csv(out, saved, count + 1U);
+    rtka_benchmark_write_json(json, saved, count + 1U);
+    fclose(out);
+
+    char text[4096];
+    rewind(json);
+    size_t length = fread(text, 1, sizeof(text) - 1U, json);
+    text[length] = '\0';
+    fclose(json);
+    uint32_t objects = 0;
+    for (const char* c = text; (c = strstr(c, "\"median_ns\"")); c++) objects++;
+    bool json_ok = text[0] == '[' && objects == count + 1U && strstr(text, "chain, \\\"quoted\\\"");
+
+    /* Against itself, slowed by half, and with an unknown name */
+    uint32_t same = 99, slowed = 0, unknown = 99;
+    rtka_benchmark_result_t* slow = (rtka_benchmark_result_t*)malloc((count + 1U) * sizeof(*slow));
+    if (!slow) return false;
+    for (uint32_t i = 0; i <= count; i++) {
+        slow[i] = saved[i];
+        slow[i].median_time *= 1.5;
+    }
+    rtka_benchmark_result_t renamed = results[0];
+    renamed.name = "not in the baseline";
+    bool compared = rtka_benchmark_compare(csv_path, saved, count + 1U, 0.1, stdout, &same) == RTKA_SUCCESS &&
+                    rtka_benchmark_compare(csv_path, slow, count + 1U, 0.1, NULL, &slowed) == RTKA_SUCCESS &&
+                    rtka_benchmark_compare(csv_path, &renamed, 1, 0.1, stdout, &unknown) == RTKA_SUCCESS;
+    bool missing = rtka_benchmark_compare("/nonexistent/baseline.csv", saved, 1, 0.1, NULL, &same) ==
+                   RTKA_ERROR_INVALID_VALUE;
+    printf("  JSON: %u objects%s\n", objects, json_ok ? "" : ", MALFORMED");
+    printf("  baseline regressions: itself %u, 1.5x slower %u of %u, unknown name %u\n", same, slowed, count + 1U,
+           unknown);
+    remove(csv_path);
+    remove(json_path);
+    free(saved);
+    free(slow);
+    return json_ok && compared && missing && same == 0 && slowed == count + 1U && unknown == 0;
+}
+
+int main(void) {
+    printf("=== RTKA Benchmark Harness Test ===\n");
+    rtka_benchmark_result_t results[3];
+    bool ok = check_statistics(results);
+    ok &= check_outliers(&results[0]);
+    ok &= check_barriers(&results[2]);
+    ok &= check_output(results, 3);
+    printf("\n%s\n", ok ? "All benchmark harness checks passed" : "Benchmark harness checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,398 @@
+/**
+ * File: test_conv.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA 2-D Convolution: im2col, Winograd and ternary kernels, conv2d layer
+ *
+ * Every kernel is checked against a direct double-precision convolution
+ * over shapes with odd sizes, padding and strides; the ternary kernel must
+ * equal the im2col result on the same {-1, 0, +1} weights. The layer picks
+ * its kernel from the weights, adds the bias, accepts (C, H, W) input and
+ * keeps its weight form cached only outside training. Then a small
+ * ternary CNN is timed per frame, one kernel against the others.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_nn.h"
+#include "rtka_conv.h"
+#include "rtka_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t lcg = 12345U;
+static float next_float(void) {
+    lcg = lcg * 1664525U + 1013904223U;
+    return (float)(lcg >> 8) / (float)(1U << 24) * 2.0f - 1.0f;
+}
+
+static size_t out_count(const rtka_conv_shape_t* s) {
+    return (size_t)s->batch * s->filters * rtka_conv_out_height(s) * rtka_conv_out_width(s);
+}
+
+/* Direct convolution, double accumulation */
+static void reference(const rtka_conv_shape_t* s, const float* x, const float* w, float* y) {
+    uint32_t oh = rtka_conv_out_height(s), ow = rtka_conv_out_width(s);
+    for (uint32_t n = 0; n < s->batch; n++) {
+        for (uint32_t o = 0; o < s->filters; o++) {
+            for (uint32_t oy = 0; oy < oh; oy++) {
+                for (uint32_t ox = 0; ox < ow; ox++) {
+                    double sum = 0.0;
+                    for (uint32_t c = 0; c < s->channels; c++) {
+                        for (uint32_t ky = 0; ky < s->kernel_h; ky++) {
+                            for (uint32_t kx = 0; kx < s->kernel_w; kx++) {
+                                int64_t iy = (int64_t)oy * s->stride_h + ky - s->pad_h;
+                                int64_t ix = (int64_t)ox * s->stride_w + kx - s->pad_w;
+                                if (iy < 0 || ix < 0 || iy >= s->height || ix >= s->width) continue;
+                                sum += (double)x[((size_t)(n * s->channels + c) * s->height + iy) * s->width + ix] *
+                                       w[((size_t)(o * s->channels + c) * s->kernel_h + ky) * s->kernel_w + kx];
+                            }
+                        }
+                    }
+                    y[((size_t)(n * s->filters + o) * oh + oy) * ow + ox] = (float)sum;
+                }
+            }
+        }
+    }
+}
+
+static float max_error(const float* a, const float* b, size_t n) {
+    float worst = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        float e = fabsf(a[i] - b[i]) / fmaxf(1.0f, fabsf(b[i]));
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+typedef struct {
+    rtka_conv_shape_t s;
+    const char* name;
+} conv_case_t;
+
+static bool check_kernels(void) {
+    printf("\n--- Kernels against direct convolution ---\n");
+    const conv_case_t cases[] = {
+        { {2, 3, 9, 11, 5, 3, 3, 1, 1, 1, 1}, "3x3 s1 p1, odd sizes" },
+        { {1, 8, 16, 16, 16, 3, 3, 1, 1, 0, 0}, "3x3 s1 p0" },
+        { {1, 4, 7, 7, 3, 3, 3, 1, 1, 2, 2}, "3x3 s1 p2" },
+        { {2, 3, 15, 13, 6, 5, 5, 2, 2, 2, 2}, "5x5 s2 p2" },
+        { {1, 6, 10, 10, 4, 1, 1, 1, 1, 0, 0}, "1x1 s1" },
+        { {1, 2, 12, 9, 3, 3, 2, 3, 2, 1, 0}, "3x2 s3x2 p1x0" },
+    };
+    bool ok = true;
+
+    for (uint32_t t = 0; t < sizeof(cases) / sizeof(cases[0]); t++) {
+        const rtka_conv_shape_t* s = &cases[t].s;
+        size_t nx = (size_t)s->batch * s->channels * s->height * s->width;
+        size_t nw = (size_t)s->filters * s->channels * s->kernel_h * s->kernel_w;
+        size_t ny = out_count(s);
+        float* x = malloc(nx * sizeof(float));
+        float* w = malloc(nw * sizeof(float));
+        float* wt = malloc(nw * sizeof(float));
+        rtka_state_t* ws = malloc(nw * sizeof(rtka_state_t));
+        rtka_state_t* wts = malloc(nw * sizeof(rtka_state_t));
+        float* ref = malloc(ny * sizeof(float));
+        float* ref_t = malloc(ny * sizeof(float));
+        float* y = malloc(ny * sizeof(float));
+        if (!x || !w || !wt || !ws || !wts || !ref || !ref_t || !y) return false;
+
+        for (size_t i = 0; i < nx; i++) x[i] = next_float();
+        for (size_t i = 0; i < nw; i++) {
+            w[i] = next_float();
+            ws[i] = rtka_make_state(w[i] >= 0.0f ? RTKA_TRUE : RTKA_FALSE, fabsf(w[i]));
+            float r = next_float();
+            rtka_value_t v = r > 0.33f ? RTKA_TRUE : r < -0.33f ? RTKA_FALSE : RTKA_UNKNOWN;
+            wt[i] = (float)v;
+            wts[i] = rtka_make_state(v, 1.0f);
+        }
+        reference(s, x, w, ref);
+        reference(s, x, wt, ref_t);
+
+        uint32_t k = s->channels * s->kernel_h * s->kernel_w;
+        rtka_gemm_operand_t op = { ws, k, 1, RTKA_GEMM_SIGNED, NULL };
+        bool im2col_ok = rtka_conv2d_im2col(s, x, &op, y) == RTKA_SUCCESS;
+        float e_im2col = max_error(y, ref, ny);
+
+        rtka_gemm_operand_t op_t = { wts, k, 1, RTKA_GEMM_TERNARY, NULL };
+        im2col_ok &= rtka_conv2d_im2col(s, x, &op_t, y) == RTKA_SUCCESS;
+        float e_im2col_t = max_error(y, ref_t, ny);
+
+        rtka_conv_taps_t* taps = rtka_conv_taps_pack(s, wts);
+        memset(y, 0xff, ny * sizeof(float));
+        bool ternary_ok = taps && rtka_conv2d_ternary(s, x, taps, y) == RTKA_SUCCESS;
+        float e_ternary = ternary_ok ? max_error(y, ref_t, ny) : INFINITY;
+        rtka_conv_taps_free(taps);
+
+        bool winograd = rtka_conv_select(s, false) == RTKA_CONV_WINOGRAD;
+        float e_winograd = 0.0f;
+        if (winograd) {
+            float* u = malloc(rtka_conv_winograd_size(s) * sizeof(float));
+            if (!u) return false;
+            rtka_conv_winograd_weights(s, w, u);
+            winograd = rtka_conv2d_winograd(s, x, u, y) == RTKA_SUCCESS;
+            e_winograd = winograd ? max_error(y, ref, ny) : INFINITY;
+            free(u);
+        } else {
+            winograd = rtka_conv2d_winograd(s, x, w, y) == RTKA_ERROR_INVALID_VALUE;
+        }
+
+        bool pass = im2col_ok && winograd && e_im2col < 1e-5f && e_im2col_t < 1e-5f &&
+                    e_ternary < 1e-5f && e_winograd < 1e-5f;
+        printf("  %-22s im2col %.1e, ternary im2col %.1e, direct %.1e, winograd %s %.1e %s\n",
+               cases[t].name, (double)e_im2col, (double)e_im2col_t, (double)e_ternary,
+               rtka_conv_select(s, false) == RTKA_CONV_WINOGRAD ? "" : "(refused)",
+               (double)e_winograd, pass ? "" : "FAIL");
+        ok &= pass;
+
+        free(x); free(w); free(wt); free(ws); free(wts); free(ref); free(ref_t); free(y);
+    }
+
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+/* Layer output against direct convolution of the same weights plus bias */
+static float layer_error(rtka_conv2d_layer_t* layer, const rtka_tensor_t* input, bool batched) {
+    rtka_tensor_t* out = rtka_nn_conv2d_infer(layer, input);
+    if (!out) return INFINITY;
+
+    rtka_conv_shape_t s = {
+        batched ? input->shape[0] : 1U, layer->in_channels,
+        input->shape[input->ndim - 2], input->shape[input->ndim - 1], layer->out_channels,
+        layer->kernel_size[0], layer->kernel_size[1], layer->stride[0], layer->stride[1],
+        layer->padding[0], layer->padding[1]
+    };
+    size_t nx = input->size, nw = layer->base.weight->data->size, ny = out_count(&s);
+    float* x = malloc(nx * sizeof(float));
+    float* w = malloc(nw * sizeof(float));
+    float* ref = malloc(ny * sizeof(float));
+    float* y = malloc(ny * sizeof(float));
+    float err = INFINITY;
+    if (x && w && ref && y && out->size == ny && out->ndim == input->ndim) {
+        for (size_t i = 0; i < nx; i++) x[i] = (float)input->data[i].value * input->data[i].confidence;
+        const rtka_state_t* ws = layer->base.weight->data->data;
+        for (size_t i = 0; i < nw; i++) w[i] = (float)ws[i].value * ws[i].confidence;
+        reference(&s, x, w, ref);
+        const rtka_state_t* b = layer->base.bias->data->data;
+        size_t plane = ny / ((size_t)s.batch * s.filters);
+        for (size_t i = 0; i < ny; i++) {
+            ref[i] += (float)b[(i / plane) % s.filters].value * b[(i / plane) % s.filters].confidence;
+            y[i] = (float)out->data[i].value * out->data[i].confidence;
+        }
+        err = max_error(y, ref, ny);
+    }
+    free(x); free(w); free(ref); free(y);
+    rtka_tensor_free(out);
+    return err;
+}
+
+static void fill_weights(rtka_conv2d_layer_t* layer, bool ternary) {
+    rtka_tensor_t* w = layer->base.weight->data;
+    for (uint32_t i = 0; i < w->size; i++) {
+        float r = next_float();
+        w->data[i] = ternary
+            ? rtka_make_state(r > 0.3f ? RTKA_TRUE : r < -0.3f ? RTKA_FALSE : RTKA_UNKNOWN, 1.0f)
+            : rtka_make_state(r >= 0.0f ? RTKA_TRUE : RTKA_FALSE, fabsf(r));
+    }
+    rtka_tensor_t* b = layer->base.bias->data;
+    for (uint32_t i = 0; i < b->size; i++) {
+        float r = next_float() * 0.5f;
+        b->data[i] = rtka_make_state(r >= 0.0f ? RTKA_TRUE : RTKA_FALSE, fabsf(r));
+    }
+}
+
+static rtka_tensor_t* make_input(uint32_t ndim, const uint32_t* shape) {
+    rtka_tensor_t* x = rtka_tensor_create(shape, ndim);
+    if (!x) return NULL;
+    for (uint32_t i = 0; i < x->size; i++) {
+        float r = next_float();
+        x->data[i] = rtka_make_state(r >= 0.0f ? RTKA_TRUE : RTKA_FALSE, fabsf(r));
+    }
+    return x;
+}
+
+static bool check_layer(void) {
+    printf("\n--- rtka_conv2d_layer_t ---\n");
+    uint32_t shape4[] = {2, 4, 12, 10};
+    uint32_t shape3[] = {4, 12, 10};
+    rtka_tensor_t* x4 = make_input(4, shape4);
+    rtka_tensor_t* x3 = make_input(3, shape3);
+    rtka_conv2d_layer_t* real3 = rtka_nn_conv2d(4, 6, 3, 1, 1);
+    rtka_conv2d_layer_t* tern3 = rtka_nn_conv2d(4, 6, 3, 1, 1);
+    rtka_conv2d_layer_t* real5 = rtka_nn_conv2d(4, 3, 5, 2, 2);
+    rtka_conv2d_layer_t* head = rtka_nn_conv2d(6, 3, 5, 2, 2);
+    if (!x4 || !x3 || !real3 || !tern3 || !real5 || !head) return false;
+    fill_weights(real3, false);
+    fill_weights(tern3, true);
+    fill_weights(real5, false);
+    fill_weights(head, false);
+
+    rtka_conv_shape_t s = { .kernel_h = 3, .kernel_w = 3, .stride_h = 1, .stride_w = 1 };
+    rtka_conv_shape_t s5 = { .kernel_h = 5, .kernel_w = 5, .stride_h = 2, .stride_w = 2 };
+    rtka_conv_shape_t s32 = { .channels = 32, .kernel_h = 3, .kernel_w = 3, .stride_h = 1, .stride_w = 1 };
+    rtka_conv_shape_t s1 = { .channels = 32, .kernel_h = 1, .kernel_w = 1, .stride_h = 1, .stride_w = 1 };
+    bool picks = rtka_conv_select(&s, false) == RTKA_CONV_WINOGRAD &&
+                 rtka_conv_select(&s, true) == RTKA_CONV_TERNARY &&
+                 rtka_conv_select(&s32, true) == RTKA_CONV_WINOGRAD &&
+                 rtka_conv_select(&s1, true) == RTKA_CONV_TERNARY &&
+                 rtka_conv_select(&s5, true) == RTKA_CONV_IM2COL &&
+                 rtka_conv_select(&s5, false) == RTKA_CONV_IM2COL;
+
+    /* Training: nothing stays cached */
+    float e_train = layer_error(real3, x4, true);
+    bool uncached = !real3->winograd && !real3->taps;
+
+    /* Inference: Winograd transforms and tap lists are kept */
+    real3->base.training = tern3->base.training = real5->base.training = false;
+    float e_winograd = layer_error(real3, x4, true);
+    float e_ternary = layer_error(tern3, x4, true);
+    float e_im2col = layer_error(real5, x4, true);
+    float e_single = layer_error(tern3, x3, false);
+    bool cached = real3->winograd && tern3->taps && !real5->winograd && !real5->taps;
+
+    /* Forced kernels agree with the automatic choice */
+    real3->algo = RTKA_CONV_IM2COL;
+    float e_forced = rtka_nn_conv2d_prepare(real3) ? layer_error(real3, x4, true) : INFINITY;
+    tern3->algo = RTKA_CONV_IM2COL;
+    float e_forced_t = rtka_nn_conv2d_prepare(tern3) ? layer_error(tern3, x4, true) : INFINITY;
+    real5->algo = RTKA_CONV_WINOGRAD;
+    bool refused = !rtka_nn_conv2d_prepare(real5) && !rtka_nn_conv2d_infer(real5, x4);
+
+    /* Forward through a sequential model, intermediates in a step arena */
+    rtka_sequential_t* net = rtka_nn_sequential();
+    rtka_grad_node_t* in = rtka_grad_node_create(x4, false);
+    rtka_arena_t* arena = rtka_arena_create(1U << 20);
+    bool forward = false;
+    if (net && in && arena) {
+        rtka_nn_sequential_add(net, (rtka_layer_t*)tern3);
+        rtka_nn_sequential_add(net, (rtka_layer_t*)head);
+        rtka_arena_begin_step(arena);
+        rtka_grad_node_t* out = rtka_nn_sequential_forward(net, in);
+        forward = out && out->data->ndim == 4 && out->data->shape[0] == 2 && out->data->shape[1] == 3 &&
+                  out->data->shape[2] == 6 && out->data->shape[3] == 5;
+        rtka_arena_end_step(arena);
+    }
+    rtka_arena_destroy(arena);
+
+    printf("  kernel choice %s; training leaves no cache %s, inference caches %s\n",
+           picks ? "as documented" : "WRONG", uncached ? "yes" : "NO", cached ? "yes" : "NO");
+    printf("  errors: training %.1e, winograd %.1e, ternary %.1e, im2col %.1e, (C,H,W) %.1e\n",
+           (double)e_train, (double)e_winograd, (double)e_ternary, (double)e_im2col, (double)e_single);
+    printf("  forced im2col %.1e / %.1e, winograd on 5x5 s2 refused %s, sequential forward %s\n",
+           (double)e_forced, (double)e_forced_t, refused ? "yes" : "NO", forward ? "yes" : "NO");
+
+    bool ok = picks && uncached && cached && refused && forward &&
+              e_train < 1e-5f && e_winograd < 1e-5f && e_ternary < 1e-5f && e_im2col < 1e-5f &&
+              e_single < 1e-5f && e_forced < 1e-5f && e_forced_t < 1e-5f;
+
+    if (in) rtka_grad_node_free(in); else rtka_tensor_free(x4);
+    rtka_tensor_free(x3);
+    rtka_conv2d_layer_t* layers[] = {real3, tern3, real5, head};
+    for (uint32_t i = 0; i < 4; i++) {
+        rtka_nn_conv2d_release(layers[i]);
+        rtka_grad_node_free(layers[i]->base.weight);
+        rtka_grad_node_free(layers[i]->base.bias);
+        free(layers[i]);
+    }
+    if (net) {
+        free(net->layers);
+        free(net);
+    }
+
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+/* Frames per second of a 3 -> 16 -> 32 channel 3x3 CNN on 64 x 64 input */
+static double time_net(rtka_conv2d_layer_t** layers, uint32_t count, const rtka_tensor_t* frame, uint32_t frames) {
+    double t0 = now_seconds();
+    for (uint32_t f = 0; f < frames; f++) {
+        const rtka_tensor_t* x = frame;
+        rtka_tensor_t* prev = NULL;
+        for (uint32_t l = 0; l < count; l++) {
+            rtka_tensor_t* y = rtka_nn_conv2d_infer(layers[l], x);
+            rtka_tensor_free(prev);
+            if (!y) return 0.0;
+            x = prev = y;
+        }
+        rtka_tensor_free(prev);
+    }
+    double elapsed = now_seconds() - t0;
+    return elapsed > 0.0 ? frames / elapsed : 0.0;
+}
+
+static bool benchmark(void) {
+    printf("\n--- Ternary CNN frame rate ---\n");
+    uint32_t shape[] = {1, 3, 64, 64};
+    rtka_tensor_t* frame = make_input(4, shape);
+    rtka_conv2d_layer_t* layers[3] = {
+        rtka_nn_conv2d(3, 16, 3, 1, 1), rtka_nn_conv2d(16, 32, 3, 2, 1), rtka_nn_conv2d(32, 32, 3, 1, 1)
+    };
+    if (!frame || !layers[0] || !layers[1] || !layers[2]) return false;
+    for (uint32_t l = 0; l < 3; l++) {
+        fill_weights(layers[l], true);
+        layers[l]->base.training = false;
+    }
+
+    const struct { rtka_conv_algo_t algo; const char* name; } runs[] = {
+        { RTKA_CONV_TERNARY, "ternary direct" }, { RTKA_CONV_IM2COL, "im2col GEMM" },
+        { RTKA_CONV_AUTO, "auto" },
+    };
+    bool ok = true;
+    for (uint32_t r = 0; r < 3; r++) {
+        for (uint32_t l = 0; l < 3; l++) {
+            layers[l]->algo = runs[r].algo;
+            ok &= rtka_nn_conv2d_prepare(layers[l]);
+        }
+        double fps = time_net(layers, 3, frame, 50);
+        printf("  %-15s %8.1f frames/s\n", runs[r].name, fps);
+        ok &= fps > 0.0;
+    }
+
+    /* Winograd on the stride-1 layers with real-valued weights */
+    for (uint32_t l = 0; l < 3; l++) {
+        fill_weights(layers[l], false);
+        layers[l]->algo = RTKA_CONV_AUTO;
+        ok &= rtka_nn_conv2d_prepare(layers[l]);
+    }
+    double fps_w = time_net(layers, 3, frame, 50);
+    for (uint32_t l = 0; l < 3; l++) {
+        layers[l]->algo = RTKA_CONV_IM2COL;
+        ok &= rtka_nn_conv2d_prepare(layers[l]);
+    }
+    double fps_i = time_net(layers, 3, frame, 50);
+    printf("  real weights: winograd/auto %.1f frames/s, im2col %.1f frames/s\n", fps_w, fps_i);
+
+    for (uint32_t l = 0; l < 3; l++) {
+        rtka_nn_conv2d_release(layers[l]);
+        rtka_grad_node_free(layers[l]->base.weight);
+        rtka_grad_node_free(layers[l]->base.bias);
+        free(layers[l]);
+    }
+    rtka_tensor_free(frame);
+    return ok && fps_w > 0.0 && fps_i > 0.0;
+}
+
+int main(void) {
+    printf("=== RTKA Convolution Test ===\n");
+    bool ok = check_kernels();
+    ok &= check_layer();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All convolution checks passed" : "Convolution checks FAILED");
+    return ok ? 0 : 1;
+}
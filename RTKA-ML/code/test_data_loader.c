@@ -0,0 +1,324 @@
+/**
+ * File: test_data_loader.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Data Loader: epochs, layouts, dataset files and rtka_ml_fit
+ *
+ * Every epoch hands out each sample exactly once, in ceil(N / B) batches
+ * whose rows are the source rows, reshuffled between epochs and in
+ * dataset order when asked. One seed gives the same batches threaded or
+ * synchronous, from AoS or SoA tensors and from a mapped dataset file.
+ * Truncated files are refused. rtka_ml_fit trains through a loader and
+ * leaves its dataset in place. Then an epoch with a busy consumer is
+ * timed, gathering in line against gathering ahead.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_data_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DATA_PATH    "/tmp/rtka_data_loader.bin"
+#define BAD_PATH     "/tmp/rtka_data_loader_bad.bin"
+#define SAMPLES      1000U
+#define FEATURES     8U
+#define LABELS       2U
+#define BATCH        64U
+#define EPOCHS       3U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sample i: feature 0 carries i, the rest and the labels follow from it */
+static rtka_dataset_t make_dataset(uint32_t samples, uint32_t features, bool soa) {
+    uint32_t x_shape[] = {samples, features};
+    uint32_t y_shape[] = {samples, LABELS};
+    rtka_dataset_t data = {0};
+    data.features = soa ? rtka_tensor_create_soa(x_shape, 2) : rtka_tensor_create(x_shape, 2);
+    data.labels = rtka_tensor_create(y_shape, 2);
+    data.num_samples = samples;
+    data.num_features = features;
+    data.num_classes = LABELS;
+    if (!data.features || !data.labels) return data;
+    for (uint32_t i = 0; i < samples; i++) {
+        for (uint32_t j = 0; j < features; j++) {
+            rtka_value_t v = (rtka_value_t)((int)((i + j) % 3U) - 1);
+            rtka_tensor_store(data.features, i * features + j,
+                              rtka_make_state(v, j == 0 ? (float)i : 0.5f + 0.01f * (float)j));
+        }
+        for (uint32_t k = 0; k < LABELS; k++) {
+            data.labels->data[i * LABELS + k] = rtka_make_state((i + k) % 2U ? RTKA_TRUE : RTKA_FALSE, 1.0f);
+        }
+    }
+    return data;
+}
+
+static void free_dataset(rtka_dataset_t* data) {
+    rtka_tensor_free(data->features);
+    rtka_tensor_free(data->labels);
+}
+
+static bool same_state(rtka_state_t a, rtka_state_t b) {
+    return a.value == b.value && a.confidence == b.confidence;
+}
+
+typedef struct {
+    uint32_t ids[EPOCHS * SAMPLES];
+    uint32_t batches[EPOCHS];
+    bool rows;                  /* Every batch row equals its source row */
+    bool shapes;                /* Batch tensors are (rows, F) and (rows, L) */
+} epoch_record_t;
+
+/* EPOCHS epochs of the sample ids, checked against data */
+static bool record(rtka_data_loader_t* loader, const rtka_dataset_t* data, epoch_record_t* rec) {
+    memset(rec, 0, sizeof(*rec));
+    rec->rows = rec->shapes = true;
+    uint32_t n = 0;
+    for (uint32_t e = 0; e < EPOCHS; e++) {
+        const rtka_data_batch_t* batch;
+        while (rtka_data_loader_next(loader, &batch) == RTKA_SUCCESS && batch) {
+            rec->shapes &= batch->epoch == e && batch->index == rec->batches[e] &&
+                           batch->features->shape[0] == batch->rows &&
+                           batch->features->shape[1] == FEATURES &&
+                           batch->labels->shape[0] == batch->rows && batch->labels->shape[1] == LABELS &&
+                           batch->features->size == batch->rows * FEATURES;
+            for (uint32_t r = 0; r < batch->rows && n < EPOCHS * SAMPLES; r++) {
+                uint32_t id = (uint32_t)batch->features->data[r * FEATURES].confidence;
+                rec->ids[n++] = id;
+                for (uint32_t j = 0; j < FEATURES; j++) {
+                    rec->rows &= same_state(batch->features->data[r * FEATURES + j],
+                                            rtka_tensor_load(data->features, id * FEATURES + j));
+                }
+                for (uint32_t k = 0; k < LABELS; k++) {
+                    rec->rows &= same_state(batch->labels->data[r * LABELS + k],
+                                            data->labels->data[id * LABELS + k]);
+                }
+            }
+            rec->batches[e]++;
+        }
+    }
+    return n == EPOCHS * SAMPLES;
+}
+
+/* Each epoch a permutation of 0 .. SAMPLES - 1 */
+static bool permutations(const epoch_record_t* rec) {
+    for (uint32_t e = 0; e < EPOCHS; e++) {
+        uint8_t seen[SAMPLES] = {0};
+        for (uint32_t i = 0; i < SAMPLES; i++) {
+            uint32_t id = rec->ids[e * SAMPLES + i];
+            if (id >= SAMPLES || seen[id]) return false;
+            seen[id] = 1;
+        }
+    }
+    return true;
+}
+
+static bool check_epochs(void) {
+    printf("\n--- Epochs ---\n");
+    rtka_dataset_t data = make_dataset(SAMPLES, FEATURES, false);
+    epoch_record_t* threaded = (epoch_record_t*)malloc(sizeof(epoch_record_t));
+    epoch_record_t* sync = (epoch_record_t*)malloc(sizeof(epoch_record_t));
+    epoch_record_t* ordered = (epoch_record_t*)malloc(sizeof(epoch_record_t));
+    if (!data.features || !data.labels || !threaded || !sync || !ordered) return false;
+
+    rtka_data_loader_t* loader = NULL;
+    bool recorded = rtka_data_loader_create(&loader, &data, BATCH, 7, 0) == RTKA_SUCCESS &&
+                    record(loader, &data, threaded);
+    uint32_t expect_batches = (SAMPLES + BATCH - 1U) / BATCH;
+    bool counted = rtka_data_loader_batches(loader) == expect_batches &&
+                   rtka_data_loader_samples(loader) == SAMPLES &&
+                   rtka_data_loader_features(loader) == FEATURES && rtka_data_loader_label_width(loader) == LABELS;
+    rtka_data_loader_free(loader);
+    for (uint32_t e = 0; e < EPOCHS; e++) counted &= threaded->batches[e] == expect_batches;
+
+    bool each_once = recorded && permutations(threaded);
+    bool reshuffled = memcmp(threaded->ids, threaded->ids + SAMPLES, SAMPLES * sizeof(uint32_t)) != 0;
+    printf("  %u epochs of %u batches: each sample once %s, rows %s, reshuffled %s\n", EPOCHS,
+           threaded->batches[0], each_once ? "yes" : "NO", threaded->rows ? "match" : "DIFFER",
+           reshuffled ? "yes" : "NO");
+
+    loader = NULL;
+    recorded &= rtka_data_loader_create(&loader, &data, BATCH, 7, RTKA_DATA_LOADER_SYNC) == RTKA_SUCCESS &&
+                record(loader, &data, sync);
+    rtka_data_loader_free(loader);
+    bool same_seed = recorded && memcmp(threaded->ids, sync->ids, sizeof(threaded->ids)) == 0;
+
+    loader = NULL;
+    recorded &= rtka_data_loader_create(&loader, &data, BATCH, 7, RTKA_DATA_LOADER_ORDERED) == RTKA_SUCCESS &&
+                record(loader, &data, ordered);
+    rtka_data_loader_free(loader);
+    bool in_order = recorded;
+    for (uint32_t i = 0; i < EPOCHS * SAMPLES; i++) in_order &= ordered->ids[i] == i % SAMPLES;
+    printf("  threaded = synchronous %s, ordered %s\n", same_seed ? "yes" : "NO", in_order ? "yes" : "NO");
+
+    bool ok = recorded && counted && each_once && reshuffled && same_seed && in_order &&
+              threaded->rows && threaded->shapes && sync->rows && ordered->shapes;
+    free(threaded);
+    free(sync);
+    free(ordered);
+    free_dataset(&data);
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_sources(void) {
+    printf("\n--- SoA tensors and dataset files ---\n");
+    rtka_dataset_t aos = make_dataset(SAMPLES, FEATURES, false);
+    rtka_dataset_t soa = make_dataset(SAMPLES, FEATURES, true);
+    epoch_record_t* expect = (epoch_record_t*)malloc(sizeof(epoch_record_t));
+    epoch_record_t* got = (epoch_record_t*)malloc(sizeof(epoch_record_t));
+    if (!aos.features || !soa.features || !expect || !got) return false;
+
+    rtka_data_loader_t* loader = NULL;
+    bool ok = rtka_data_loader_create(&loader, &aos, BATCH, 11, 0) == RTKA_SUCCESS && record(loader, &aos, expect);
+    rtka_data_loader_free(loader);
+
+    loader = NULL;
+    bool soa_ok = rtka_data_loader_create(&loader, &soa, BATCH, 11, 0) == RTKA_SUCCESS &&
+                  record(loader, &soa, got) && got->rows &&
+                  memcmp(expect->ids, got->ids, sizeof(expect->ids)) == 0;
+    rtka_data_loader_free(loader);
+
+    /* The file holds SoA features as AoS rows */
+    loader = NULL;
+    bool file_ok = rtka_dataset_save(&soa, DATA_PATH) == RTKA_SUCCESS &&
+                   rtka_data_loader_open(&loader, DATA_PATH, BATCH, 11, 0) == RTKA_SUCCESS &&
+                   record(loader, &aos, got) && got->rows && got->shapes &&
+                   memcmp(expect->ids, got->ids, sizeof(expect->ids)) == 0;
+    rtka_data_loader_free(loader);
+    printf("  same batches from SoA %s, from the mapped file %s\n", soa_ok ? "yes" : "NO",
+           file_ok ? "yes" : "NO");
+
+    /* Truncated past its label block */
+    bool refused = false;
+    FILE* in = fopen(DATA_PATH, "rb");
+    FILE* out = fopen(BAD_PATH, "wb");
+    if (in && out) {
+        char buffer[4096];
+        size_t n = fread(buffer, 1, sizeof(buffer), in);
+        refused = fwrite(buffer, 1, n, out) == n;
+    }
+    if (in) fclose(in);
+    if (out) fclose(out);
+    loader = NULL;
+    refused = refused && rtka_data_loader_open(&loader, BAD_PATH, BATCH, 11, 0) == RTKA_ERROR_INVALID_VALUE &&
+              !loader && rtka_data_loader_open(&loader, "/tmp/rtka_no_such_file", BATCH, 11, 0) ==
+                         RTKA_ERROR_INVALID_VALUE;
+    printf("  truncated and missing files refused %s\n", refused ? "yes" : "NO");
+    remove(BAD_PATH);
+
+    ok = ok && soa_ok && file_ok && refused;
+    free(expect);
+    free(got);
+    free_dataset(&aos);
+    free_dataset(&soa);
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static rtka_model_t* make_model(rtka_optimizer_t* opt) {
+    rtka_model_t* model = rtka_ml_create_model(MODEL_REGRESSOR);
+    if (!model) return NULL;
+    rtka_ml_add_layer(model, (rtka_layer_t*)rtka_nn_linear(FEATURES, LABELS, true));
+    rtka_ml_compile(model, opt);
+    return model;
+}
+
+static bool check_fit(void) {
+    printf("\n--- rtka_ml_fit ---\n");
+    rtka_dataset_t data = make_dataset(SAMPLES, FEATURES, false);
+    rtka_tensor_t* before = data.features ? rtka_tensor_create(data.features->shape, 2) : NULL;
+    if (before && rtka_tensor_copy_into(before, data.features) != RTKA_SUCCESS) return false;
+    rtka_optimizer_t* opt = rtka_optimizer_sgd(0.01f, 0.0f);
+    rtka_model_t* model = make_model(opt);
+    if (!before || !model) return false;
+
+    rtka_training_config_t config = {0};
+    config.epochs = EPOCHS;
+    config.batch_size = BATCH;
+    config.shuffle = true;
+    rtka_ml_fit(model, &data, NULL, &config);
+    bool trained = model->trained && model->epochs_trained == EPOCHS;
+    for (uint32_t e = 0; e < EPOCHS; e++) trained &= isfinite(model->train_loss[e]);
+    bool in_place = memcmp(before->data, data.features->data, before->size * sizeof(rtka_state_t)) == 0;
+    printf("  %u epochs, dataset left in order %s\n", model->epochs_trained, in_place ? "yes" : "NO");
+    rtka_ml_free_model(model);
+
+    /* From the dataset file written by check_sources */
+    model = make_model(opt);
+    rtka_data_loader_t* loader = NULL;
+    bool from_file = model && rtka_data_loader_open(&loader, DATA_PATH, BATCH, 3, 0) == RTKA_SUCCESS;
+    if (from_file) {
+        rtka_ml_fit_loader(model, loader, &data, &config);
+        from_file = model->epochs_trained == EPOCHS && isfinite(model->train_loss[EPOCHS - 1]) &&
+                    isfinite(model->val_loss[EPOCHS - 1]);
+    }
+    printf("  fit from the mapped file %s\n", from_file ? "yes" : "NO");
+    rtka_data_loader_free(loader);
+    rtka_ml_free_model(model);
+    rtka_tensor_free(before);
+    free_dataset(&data);
+    remove(DATA_PATH);
+
+    bool ok = trained && in_place && from_file;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+/* Stands in for a training step over the batch */
+static uint64_t consume(const rtka_data_batch_t* batch, uint32_t rounds) {
+    uint64_t sink = 0;
+    for (uint32_t k = 0; k < rounds; k++) {
+        for (uint32_t i = 0; i < batch->features->size; i += 16U) {
+            sink += (uint64_t)(batch->features->data[i].confidence * 1000.0f) ^ k;
+        }
+    }
+    return sink;
+}
+
+static double time_epoch(const rtka_dataset_t* data, uint32_t flags, volatile uint64_t* sink) {
+    rtka_data_loader_t* loader = NULL;
+    if (rtka_data_loader_create(&loader, data, 256, 5, flags) != RTKA_SUCCESS) return 0.0;
+    const rtka_data_batch_t* batch;
+    double t0 = now_seconds();
+    while (rtka_data_loader_next(loader, &batch) == RTKA_SUCCESS && batch) *sink += consume(batch, 32);
+    double elapsed = now_seconds() - t0;
+    rtka_data_loader_free(loader);
+    return elapsed;
+}
+
+static bool benchmark(void) {
+    printf("\n--- Epoch with a busy consumer ---\n");
+    rtka_dataset_t data = make_dataset(20000, 256, false);
+    if (!data.features || !data.labels) return false;
+    volatile uint64_t sink = 0;
+    double sync = time_epoch(&data, RTKA_DATA_LOADER_SYNC, &sink);
+    double threaded = time_epoch(&data, 0, &sink);
+    printf("  20000 x 256 states, batch 256: gather in line %.1f ms, ahead %.1f ms (%.2fx, %ld cores)\n",
+           sync * 1e3, threaded * 1e3, threaded > 0.0 ? sync / threaded : 0.0, sysconf(_SC_NPROCESSORS_ONLN));
+    free_dataset(&data);
+    return true;
+}
+
+int main(void) {
+    printf("=== RTKA Data Loader Test ===\n");
+    bool ok = check_epochs();
+    ok &= check_sources();
+    ok &= check_fit();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All data loader checks passed" : "Data loader checks FAILED");
+    return ok ? 0 : 1;
+}
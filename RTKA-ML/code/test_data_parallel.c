@@ -0,0 +1,307 @@
+/**
+ * File: test_data_parallel.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Data Parallel: replicated steps, all-reduce and compression
+ *
+ * One replica steps bitwise like rtka_ml_train_batch. Four replicas on a
+ * pool land on the same parameters up to float rounding, and bitwise the
+ * same from run to run. Ternary gradient compression keeps its contract
+ * and still trains; unsupported layers are refused. rtka_dp_fit_loader
+ * trains through a loader. Then steps are timed, one replica against one
+ * per pool participant.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_data_parallel.h"
+#include "rtka_data_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SAMPLES      512U
+#define FEATURES     32U
+#define HIDDEN       64U
+#define LABELS       4U
+#define BATCH        256U
+#define STEPS        5U
+#define EPOCHS       3U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static rtka_dataset_t make_dataset(uint32_t samples) {
+    uint32_t x_shape[] = {samples, FEATURES};
+    uint32_t y_shape[] = {samples, LABELS};
+    rtka_dataset_t data = {0};
+    data.features = rtka_tensor_create(x_shape, 2);
+    data.labels = rtka_tensor_create(y_shape, 2);
+    data.num_samples = samples;
+    data.num_features = FEATURES;
+    data.num_classes = LABELS;
+    if (!data.features || !data.labels) return data;
+    for (uint32_t i = 0; i < samples; i++) {
+        for (uint32_t j = 0; j < FEATURES; j++) {
+            rtka_value_t v = (rtka_value_t)((int)((i * 7U + j) % 3U) - 1);
+            data.features->data[i * FEATURES + j] = rtka_make_state(v, 0.25f + 0.02f * (float)((i + j) % 32U));
+        }
+        for (uint32_t k = 0; k < LABELS; k++) {
+            data.labels->data[i * LABELS + k] = rtka_make_state((i + k) % 3U ? RTKA_TRUE : RTKA_FALSE, 1.0f);
+        }
+    }
+    return data;
+}
+
+static void free_dataset(rtka_dataset_t* data) {
+    rtka_tensor_free(data->features);
+    rtka_tensor_free(data->labels);
+}
+
+/* Two-layer regressor; every model gets the same deterministic weights */
+static rtka_model_t* make_model(rtka_optimizer_t* opt) {
+    rtka_model_t* model = rtka_ml_create_model(MODEL_REGRESSOR);
+    if (!model) return NULL;
+    rtka_ml_add_layer(model, (rtka_layer_t*)rtka_nn_linear(FEATURES, HIDDEN, true));
+    rtka_ml_add_layer(model, (rtka_layer_t*)rtka_nn_linear(HIDDEN, LABELS, true));
+    for (uint32_t l = 0; l < model->network->num_layers; l++) {
+        rtka_tensor_t* w = model->network->layers[l]->weight->data;
+        for (uint32_t i = 0; i < w->size; i++) {
+            rtka_value_t v = (rtka_value_t)((int)((i * 5U + l) % 3U) - 1);
+            w->data[i] = rtka_make_state(v, 0.1f + 0.8f * (float)((i * 37U + l) % 101U) / 101.0f);
+        }
+    }
+    rtka_ml_compile(model, opt);
+    return model;
+}
+
+/* Largest parameter difference, relative to max(1, |a|) */
+static float param_diff(const rtka_model_t* a, const rtka_model_t* b, bool* bitwise) {
+    float worst = 0.0f;
+    *bitwise = true;
+    for (uint32_t l = 0; l < a->network->num_layers; l++) {
+        rtka_layer_t* la = a->network->layers[l];
+        rtka_layer_t* lb = b->network->layers[l];
+        rtka_grad_node_t* pa[] = {la->weight, la->bias};
+        rtka_grad_node_t* pb[] = {lb->weight, lb->bias};
+        for (uint32_t p = 0; p < 2; p++) {
+            if (!pa[p]) continue;
+            const rtka_tensor_t* ta = pa[p]->data;
+            const rtka_tensor_t* tb = pb[p]->data;
+            *bitwise &= memcmp(ta->data, tb->data, ta->size * sizeof(rtka_state_t)) == 0;
+            for (uint32_t i = 0; i < ta->size; i++) {
+                float x = ta->data[i].confidence;
+                float d = fabsf(x - tb->data[i].confidence) / fmaxf(1.0f, fabsf(x));
+                if (ta->data[i].value != tb->data[i].value) d = INFINITY;
+                if (d > worst) worst = d;
+            }
+        }
+    }
+    return worst;
+}
+
+/* STEPS steps of model on data through a trainer of `replicas` */
+static bool run_dp(rtka_model_t* model, const rtka_dataset_t* data, rtka_thread_pool_t* pool,
+                   uint32_t replicas, uint32_t flags, rtka_confidence_t* losses) {
+    rtka_dp_trainer_t* dp = NULL;
+    if (rtka_dp_create(&dp, model, pool, replicas, flags, 0.5f) != RTKA_SUCCESS) return false;
+    bool ok = rtka_dp_replicas(dp) == replicas;
+    for (uint32_t s = 0; s < STEPS && ok; s++) {
+        ok = rtka_dp_train_batch(dp, data->features, data->labels, &losses[s]) == RTKA_SUCCESS;
+    }
+    rtka_dp_free(dp);
+    return ok;
+}
+
+static bool check_equivalence(rtka_thread_pool_t* pool) {
+    printf("\n--- Replicated steps ---\n");
+    rtka_dataset_t data = make_dataset(BATCH);
+    rtka_optimizer_t* opt[4] = {
+        rtka_optimizer_sgd(0.01f, 0.9f), rtka_optimizer_sgd(0.01f, 0.9f),
+        rtka_optimizer_sgd(0.01f, 0.9f), rtka_optimizer_sgd(0.01f, 0.9f)
+    };
+    rtka_model_t* serial = make_model(opt[0]);
+    rtka_model_t* single = make_model(opt[1]);
+    rtka_model_t* four = make_model(opt[2]);
+    rtka_model_t* again = make_model(opt[3]);
+    if (!data.features || !serial || !single || !four || !again) return false;
+
+    rtka_confidence_t serial_loss[STEPS], single_loss[STEPS], four_loss[STEPS], again_loss[STEPS];
+    for (uint32_t s = 0; s < STEPS; s++) {
+        serial_loss[s] = rtka_ml_train_batch(serial, data.features, data.labels);
+    }
+    bool ran = run_dp(single, &data, pool, 1, 0, single_loss) &&
+               run_dp(four, &data, pool, 4, 0, four_loss) &&
+               run_dp(again, &data, pool, 4, 0, again_loss);
+
+    bool single_bitwise = false, four_bitwise = false, repeat_bitwise = false;
+    param_diff(serial, single, &single_bitwise);
+    single_bitwise &= memcmp(serial_loss, single_loss, sizeof(serial_loss)) == 0;
+    float four_diff = param_diff(serial, four, &four_bitwise);
+    param_diff(four, again, &repeat_bitwise);
+    repeat_bitwise &= memcmp(four_loss, again_loss, sizeof(four_loss)) == 0;
+
+    float loss_diff = 0.0f;
+    for (uint32_t s = 0; s < STEPS; s++) {
+        loss_diff = fmaxf(loss_diff, fabsf(serial_loss[s] - four_loss[s]) / fmaxf(1.0f, serial_loss[s]));
+    }
+
+    printf("  1 replica vs rtka_ml_train_batch: %s\n", single_bitwise ? "bitwise" : "DIFFER");
+    printf("  4 replicas after %u steps: params within %.2e, losses within %.2e\n", STEPS,
+           (double)four_diff, (double)loss_diff);
+    printf("  4 replicas run to run: %s\n", repeat_bitwise ? "bitwise" : "DIFFER");
+
+    rtka_ml_free_model(serial);
+    rtka_ml_free_model(single);
+    rtka_ml_free_model(four);
+    rtka_ml_free_model(again);
+    for (uint32_t i = 0; i < 4; i++) free(opt[i]);
+    free_dataset(&data);
+
+    bool ok = ran && single_bitwise && four_diff < 1e-4f && loss_diff < 1e-4f && repeat_bitwise;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_quantized(rtka_thread_pool_t* pool) {
+    printf("\n--- Ternary gradient exchange ---\n");
+
+    /* {-s, 0, +s}, zero below threshold * max|g|, kept magnitudes summed */
+    uint32_t shape[] = {8};
+    rtka_tensor_t* grad = rtka_tensor_create(shape, 1);
+    if (!grad) return false;
+    const float g[8] = {0.9f, -0.1f, 0.5f, -0.6f, 0.0f, 0.05f, -1.0f, 0.4f};
+    for (uint32_t i = 0; i < 8; i++) grad->data[i] = rtka_make_state(RTKA_UNKNOWN, g[i]);
+    rtka_optimizer_quantize_gradients(grad, 0.45f);
+    float s = (0.9f + 0.5f + 0.6f + 1.0f) / 4.0f;
+    const float expect[8] = {s, 0.0f, s, -s, 0.0f, 0.0f, -s, 0.0f};
+    bool contract = true;
+    for (uint32_t i = 0; i < 8; i++) contract &= fabsf(grad->data[i].confidence - expect[i]) < 1e-6f;
+    rtka_tensor_free(grad);
+    printf("  quantize_gradients contract %s\n", contract ? "holds" : "BROKEN");
+
+    rtka_dataset_t data = make_dataset(BATCH);
+    rtka_optimizer_t* opt = rtka_optimizer_sgd(0.001f, 0.0f);
+    rtka_model_t* model = make_model(opt);
+    rtka_model_t* fresh = make_model(opt);
+    if (!data.features || !model || !fresh) return false;
+
+    rtka_confidence_t losses[STEPS];
+    bool trained = run_dp(model, &data, pool, 4, RTKA_DP_QUANTIZE_GRADIENTS, losses);
+    for (uint32_t i = 0; i < STEPS; i++) trained &= isfinite(losses[i]);
+    bool unchanged = false;
+    param_diff(model, fresh, &unchanged);
+    printf("  %u quantized steps: loss %.4f -> %.4f, parameters moved %s\n", STEPS, (double)losses[0],
+           (double)losses[STEPS - 1], unchanged ? "NO" : "yes");
+
+    /* Only linear and ternary layers replicate */
+    rtka_dp_trainer_t* dp = NULL;
+    rtka_layer_type_t type = model->network->layers[1]->type;
+    model->network->layers[1]->type = LAYER_CONV2D;
+    bool refused = rtka_dp_create(&dp, model, pool, 2, 0, 0.0f) == RTKA_ERROR_INVALID_VALUE && !dp;
+    model->network->layers[1]->type = type;
+    printf("  unsupported layer refused %s\n", refused ? "yes" : "NO");
+
+    rtka_ml_free_model(model);
+    rtka_ml_free_model(fresh);
+    free(opt);
+    free_dataset(&data);
+
+    bool ok = contract && trained && !unchanged && refused;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_fit(rtka_thread_pool_t* pool) {
+    printf("\n--- rtka_dp_fit_loader ---\n");
+    rtka_dataset_t data = make_dataset(SAMPLES);
+    rtka_optimizer_t* opt = rtka_optimizer_sgd(0.01f, 0.0f);
+    rtka_model_t* model = make_model(opt);
+    rtka_data_loader_t* loader = NULL;
+    rtka_dp_trainer_t* dp = NULL;
+    if (!data.features || !model) return false;
+
+    bool ok = rtka_data_loader_create(&loader, &data, 64, 11, 0) == RTKA_SUCCESS &&
+              rtka_dp_create(&dp, model, pool, 3, 0, 0.0f) == RTKA_SUCCESS;
+    if (ok) {
+        rtka_training_config_t config = {0};
+        config.epochs = EPOCHS;
+        config.batch_size = 64;
+        config.shuffle = true;
+        rtka_dp_fit_loader(dp, loader, &data, &config);
+        ok = model->trained && model->epochs_trained == EPOCHS;
+        for (uint32_t e = 0; e < EPOCHS && ok; e++) {
+            ok = isfinite(model->train_loss[e]) && isfinite(model->val_loss[e]);
+        }
+        if (model->epochs_trained == EPOCHS) {
+            printf("  %u epochs over 3 replicas, loss %.4f -> %.4f\n", EPOCHS, (double)model->train_loss[0],
+                   (double)model->train_loss[EPOCHS - 1]);
+        }
+    }
+    rtka_dp_free(dp);
+    rtka_data_loader_free(loader);
+    rtka_ml_free_model(model);
+    free(opt);
+    free_dataset(&data);
+
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static double time_steps(rtka_thread_pool_t* pool, uint32_t replicas, const rtka_dataset_t* data) {
+    rtka_optimizer_t* opt = rtka_optimizer_sgd(0.001f, 0.0f);
+    rtka_model_t* model = make_model(opt);
+    rtka_dp_trainer_t* dp = NULL;
+    double elapsed = 0.0;
+    if (model && rtka_dp_create(&dp, model, pool, replicas, 0, 0.0f) == RTKA_SUCCESS) {
+        rtka_confidence_t loss;
+        double t0 = now_seconds();
+        for (uint32_t s = 0; s < 20U; s++) {
+            if (rtka_dp_train_batch(dp, data->features, data->labels, &loss) != RTKA_SUCCESS) break;
+        }
+        elapsed = now_seconds() - t0;
+    }
+    rtka_dp_free(dp);
+    rtka_ml_free_model(model);
+    free(opt);
+    return elapsed;
+}
+
+static bool benchmark(rtka_thread_pool_t* pool) {
+    printf("\n--- Throughput ---\n");
+    rtka_dataset_t data = make_dataset(2048);
+    if (!data.features) return false;
+
+    uint32_t participants = rtka_pool_size(pool) + 1U;
+    double one = time_steps(pool, 1, &data);
+    double all = time_steps(pool, participants, &data);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("  20 steps of 2048 rows on %ld CPUs: 1 replica %.1f ms, %u replicas %.1f ms (%.2fx)\n", cpus,
+           one * 1e3, participants, all * 1e3, all > 0.0 ? one / all : 0.0);
+    free_dataset(&data);
+    return one > 0.0 && all > 0.0;
+}
+
+int main(void) {
+    printf("=== RTKA Data Parallel Test ===\n");
+    rtka_thread_pool_t* pool = rtka_pool_create(3, 0);
+    if (!pool) return 1;
+    bool ok = check_equivalence(pool);
+    ok &= check_quantized(pool);
+    ok &= check_fit(pool);
+    ok &= benchmark(rtka_pool_default());
+    rtka_pool_destroy(pool);
+    printf("\n%s\n", ok ? "All data parallel checks passed" : "Data parallel checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,596 @@
+/**
+ * File: test_evolution.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Evolution: flat storage, parallel fitness and the threaded
+ * island model
+ *
+ * Every step must leave individual i on row i of the population's gene
+ * matrix, alternating between the same two matrices, and a batched
+ * fitness step must reproduce the per-chromosome one. The fitness cache
+ * must not change a run, only skip calls. The divide-and-conquer
+ * non-dominated sort and the crowding distance must match direct
+ * quadratic versions, and NSGA-II must spread a front between two
+ * conflicting objectives. A step with fitness
+ * on a thread pool must reproduce the serial step exactly. Synchronous migration must move an island's best into its
+ * neighbour's worst. The threaded island model must improve on its start
+ * and exchange migrants. Then an expensive fitness function is timed
+ * serially, on the pool and across islands.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_evolution.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define GENES            64U
+#define POPULATION       96U
+#define POOL_THREADS     3U
+#define ISLANDS          4U
+#define ISLAND_SIZE      48U
+#define COSTLY_ROUNDS    40000U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Mean confidence of TRUE genes: the ternary OneMax */
+static rtka_confidence_t onemax(const rtka_chromosome_t* chrom) {
+    rtka_confidence_t sum = 0.0f;
+    for (uint32_t g = 0; g < chrom->length; g++) {
+        if (chrom->genes[g].value == RTKA_TRUE) sum += chrom->genes[g].confidence;
+    }
+    return sum / (rtka_confidence_t)chrom->length;
+}
+
+/* OneMax behind forty thousand dependent multiply-adds per call, standing
+ * in for a simulation-sized fitness */
+static rtka_confidence_t costly(const rtka_chromosome_t* chrom) {
+    float x = onemax(chrom), y = 0.0f;
+    for (uint32_t r = 0; r < COSTLY_ROUNDS; r++) y = y * 0.999f + x * 1e-3f;
+    return x + y * 1e-9f;
+}
+
+/* onemax over a block of rows, through a chromosome view of each row */
+static void onemax_rows(const rtka_state_t* genes, uint32_t count, uint32_t length, rtka_confidence_t* fitness) {
+    for (uint32_t r = 0; r < count; r++) {
+        rtka_chromosome_t row = { (rtka_state_t*)(genes + (size_t)r * length), length, 0.0f, 0 };
+        fitness[r] = onemax(&row);
+    }
+}
+
+/* onemax as one branch-free pass over the block */
+static void onemax_block(const rtka_state_t* genes, uint32_t count, uint32_t length, rtka_confidence_t* fitness) {
+    for (uint32_t r = 0; r < count; r++) {
+        const rtka_state_t* row = genes + (size_t)r * length;
+        float sum = 0.0f;
+        for (uint32_t g = 0; g < length; g++) sum += row[g].value == RTKA_TRUE ? row[g].confidence : 0.0f;
+        fitness[r] = sum / (float)length;
+    }
+}
+
+static uint64_t fitness_calls;
+
+static rtka_confidence_t counted_onemax(const rtka_chromosome_t* chrom) {
+    fitness_calls++;
+    return onemax(chrom);
+}
+
+static void counted_rows(const rtka_state_t* genes, uint32_t count, uint32_t length, rtka_confidence_t* fitness) {
+    fitness_calls += count;
+    onemax_rows(genes, count, length, fitness);
+}
+
+static bool rows_in_order(const rtka_population_t* pop) {
+    for (uint32_t i = 0; i < pop->size; i++) {
+        if (pop->individuals[i]->genes != pop->genes + (size_t)i * pop->gene_length) return false;
+    }
+    return true;
+}
+
+static bool same_population(const rtka_population_t* a, const rtka_population_t* b) {
+    if (a->size != b->size) return false;
+    for (uint32_t i = 0; i < a->size; i++) {
+        const rtka_chromosome_t* x = a->individuals[i];
+        const rtka_chromosome_t* y = b->individuals[i];
+        if (x->fitness != y->fitness || memcmp(x->genes, y->genes, x->length * sizeof(rtka_state_t)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static rtka_population_t* seeded_population(uint64_t seed) {
+    rtka_population_t* pop = rtka_evolution_create_population(POPULATION, GENES);
+    if (!pop) return NULL;
+    rtka_random_init_splitmix(&pop->rng, seed);
+    pop->mutation_rate = 0.02f;
+    rtka_evolution_initialize_random(pop);
+    return pop;
+}
+
+static bool check_layout(void) {
+    printf("\n--- Flat population ---\n");
+    rtka_population_t* single = seeded_population(7);
+    rtka_population_t* batched = seeded_population(7);
+    if (!single || !batched) return false;
+
+    const rtka_state_t* banks[2] = { single->genes, single->spare_genes };
+    bool rows = rows_in_order(single), fixed = true;
+    for (uint32_t g = 0; g < 100; g++) {
+        rtka_evolution_step(single, onemax, SELECT_TOURNAMENT);
+        rtka_evolution_step_batch(batched, onemax_rows, SELECT_TOURNAMENT, NULL);
+        rows &= rows_in_order(single) && rows_in_order(batched);
+        fixed &= single->genes == banks[(g + 1U) % 2U] && single->spare_genes == banks[g % 2U];
+    }
+    bool same = same_population(single, batched);
+    printf("  100 steps: %s, %s, batched fitness %s\n",
+           rows ? "individual i on row i" : "ROWS OUT OF ORDER",
+           fixed ? "two gene matrices swapped" : "GENE MATRICES REALLOCATED",
+           same ? "matches per-chromosome fitness" : "DIFFERS FROM PER-CHROMOSOME FITNESS");
+
+    rtka_evolution_free_population(single);
+    rtka_evolution_free_population(batched);
+    return rows && fixed && same;
+}
+
+/* Cached against uncached runs from the same seed, both fitness forms */
+static bool check_cache(void) {
+    printf("\n--- Fitness cache ---\n");
+    bool ok = true;
+    for (int batch = 0; batch < 2; batch++) {
+        rtka_population_t* plain = seeded_population(11);
+        rtka_population_t* cached = seeded_population(11);
+        if (!plain || !cached || rtka_evolution_enable_cache(cached, 0) != RTKA_SUCCESS) return false;
+        plain->mutation_rate = cached->mutation_rate = 0.005f;
+
+        uint64_t uncached_calls = 0, cached_calls = 0;
+        for (uint32_t g = 0; g < 150; g++) {
+            fitness_calls = 0;
+            if (batch) rtka_evolution_step_batch(plain, counted_rows, SELECT_TOURNAMENT, NULL);
+            else rtka_evolution_step(plain, counted_onemax, SELECT_TOURNAMENT);
+            uncached_calls += fitness_calls;
+
+            fitness_calls = 0;
+            if (batch) rtka_evolution_step_batch(cached, counted_rows, SELECT_TOURNAMENT, NULL);
+            else rtka_evolution_step(cached, counted_onemax, SELECT_TOURNAMENT);
+            cached_calls += fitness_calls;
+        }
+        uint64_t hits, misses;
+        rtka_evolution_cache_stats(cached, &hits, &misses);
+        bool same = same_population(plain, cached);
+        bool counted = misses == cached_calls && hits + misses == uncached_calls && hits > 0;
+        printf("  %s: %s; %llu of %llu calls skipped (%.0f%%)%s\n",
+               batch ? "batched fitness  " : "per-chromosome   ",
+               same ? "same run as uncached" : "RUN DIFFERS FROM UNCACHED",
+               (unsigned long long)hits, (unsigned long long)uncached_calls,
+               100.0 * (double)hits / (double)uncached_calls, counted ? "" : ", COUNTS DISAGREE");
+        ok &= same && counted;
+        rtka_evolution_free_population(plain);
+        rtka_evolution_free_population(cached);
+    }
+    return ok;
+}
+
+/* ---- Multi-objective ---- */
+
+static uint64_t point_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t next_point(void) {
+    point_state ^= point_state << 13;
+    point_state ^= point_state >> 7;
+    point_state ^= point_state << 17;
+    return (uint32_t)(point_state >> 32);
+}
+
+/* levels = 0 draws continuous values, otherwise one of levels values */
+static rtka_confidence_t* random_points(uint32_t n, uint32_t objectives, uint32_t levels) {
+    rtka_confidence_t* points = (rtka_confidence_t*)malloc((size_t)n * objectives * sizeof(rtka_confidence_t));
+    if (!points) return NULL;
+    for (size_t i = 0; i < (size_t)n * objectives; i++) {
+        points[i] = levels ? (rtka_confidence_t)(next_point() % levels) : (next_point() >> 8) * 0x1.0p-24f;
+    }
+    return points;
+}
+
+static bool point_dominates(const rtka_confidence_t* points, uint32_t n, uint32_t objectives, uint32_t a, uint32_t b) {
+    bool better = false;
+    for (uint32_t m = 0; m < objectives; m++) {
+        rtka_confidence_t x = points[(size_t)m * n + a], y = points[(size_t)m * n + b];
+        if (x < y) return false;
+        better |= x > y;
+    }
+    return better;
+}
+
+static const rtka_confidence_t* sum_points;
+static uint32_t sum_n;
+
+static int by_objective_sum(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    rtka_confidence_t sx = 0.0f, sy = 0.0f;
+    for (uint32_t m = 0; m < 4; m++) {
+        sx += sum_points[(size_t)m * sum_n + x];
+        sy += sum_points[(size_t)m * sum_n + y];
+    }
+    return (sx < sy) - (sx > sy);
+}
+
+/* Direct O(M N^2) fronts: visiting points by decreasing objective sum,
+ * every dominator of a point comes before it */
+static void reference_sort(const rtka_confidence_t* points, uint32_t n, uint32_t objectives, uint32_t* rank) {
+    uint32_t* order = (uint32_t*)malloc(n * sizeof(uint32_t));
+    rtka_confidence_t* padded = (rtka_confidence_t*)calloc((size_t)n * 4U, sizeof(rtka_confidence_t));
+    memcpy(padded, points, (size_t)n * objectives * sizeof(rtka_confidence_t));
+    for (uint32_t i = 0; i < n; i++) order[i] = i;
+    sum_points = padded;
+    sum_n = n;
+    qsort(order, n, sizeof(uint32_t), by_objective_sum);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t p = order[i];
+        rank[p] = 0;
+        for (uint32_t j = 0; j < i; j++) {
+            uint32_t q = order[j];
+            if (rank[q] + 1U > rank[p] && point_dominates(points, n, objectives, q, p)) rank[p] = rank[q] + 1U;
+        }
+    }
+    free(order);
+    free(padded);
+}
+
+static const rtka_confidence_t* column_points;
+
+static int by_column_value(const void* a, const void* b) {
+    rtka_confidence_t x = column_points[*(const uint32_t*)a], y = column_points[*(const uint32_t*)b];
+    return (x > y) - (x < y);
+}
+
+/* Textbook crowding: sort each front on each objective */
+static void reference_crowding(const rtka_confidence_t* points, uint32_t n, uint32_t objectives,
+                               const uint32_t* rank, rtka_confidence_t* distance) {
+    uint32_t* members = (uint32_t*)malloc(n * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) distance[i] = 0.0f;
+    for (uint32_t f = 0;; f++) {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < n; i++) if (rank[i] == f) members[count++] = i;
+        if (count == 0) break;
+        for (uint32_t m = 0; m < objectives; m++) {
+            column_points = points + (size_t)m * n;
+            qsort(members, count, sizeof(uint32_t), by_column_value);
+            rtka_confidence_t range = column_points[members[count - 1U]] - column_points[members[0]];
+            distance[members[0]] += RTKA_CROWDING_BOUNDARY;
+            if (count > 1) distance[members[count - 1U]] += RTKA_CROWDING_BOUNDARY;
+            for (uint32_t k = 1; k + 1U < count && range > 0.0f; k++) {
+                distance[members[k]] += (column_points[members[k + 1U]] - column_points[members[k - 1U]]) / range;
+            }
+        }
+    }
+    free(members);
+}
+
+static bool check_nondominated_sort(rtka_thread_pool_t* pool) {
+    printf("\n--- Non-dominated sorting ---\n");
+    bool ok = true;
+    for (uint32_t objectives = 1; objectives <= 4; objectives++) {
+        uint32_t mismatches = 0, fronts = 0;
+        for (uint32_t trial = 0; trial < 6; trial++) {
+            uint32_t n = 50U + trial * 150U, levels = trial % 2U ? 6U : 0U;
+            rtka_confidence_t* points = random_points(n, objectives, levels);
+            uint32_t* rank = (uint32_t*)malloc(n * sizeof(uint32_t));
+            uint32_t* expect = (uint32_t*)malloc(n * sizeof(uint32_t));
+            if (!points || !rank || !expect ||
+                rtka_evolution_nondominated_sort(points, n, objectives, rank) != RTKA_SUCCESS) return false;
+            reference_sort(points, n, objectives, expect);
+            for (uint32_t i = 0; i < n; i++) {
+                mismatches += rank[i] != expect[i];
+                if (expect[i] + 1U > fronts) fronts = expect[i] + 1U;
+            }
+            free(points);
+            free(rank);
+            free(expect);
+        }
+        printf("  %u objective%s, 6 point sets with and without ties: %s (up to %u fronts)\n", objectives,
+               objectives > 1 ? "s" : "", mismatches ? "FRONTS DIFFER FROM DIRECT SORT" : "fronts match direct sort",
+               fronts);
+        ok &= mismatches == 0;
+    }
+
+    const uint32_t n = 2000, objectives = 3;
+    rtka_confidence_t* points = random_points(n, objectives, 0);
+    uint32_t* rank = (uint32_t*)malloc(n * sizeof(uint32_t));
+    rtka_confidence_t* distance = (rtka_confidence_t*)malloc(n * sizeof(rtka_confidence_t));
+    rtka_confidence_t* expect = (rtka_confidence_t*)malloc(n * sizeof(rtka_confidence_t));
+    if (!points || !rank || !distance || !expect ||
+        rtka_evolution_nondominated_sort(points, n, objectives, rank) != RTKA_SUCCESS ||
+        rtka_evolution_crowding_distance(points, n, objectives, rank, distance, pool) != RTKA_SUCCESS) return false;
+    reference_crowding(points, n, objectives, rank, expect);
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        float error = fabsf(distance[i] - expect[i]) / (expect[i] > 1.0f ? expect[i] : 1.0f);
+        if (error > worst) worst = error;
+    }
+    printf("  crowding distance, %u points on the pool: largest relative error %.2g\n", n, (double)worst);
+    ok &= worst < 1e-5f;
+    free(points);
+    free(rank);
+    free(distance);
+    free(expect);
+    return ok;
+}
+
+/* Two conflicting objectives: confident TRUE genes against confident FALSE ones */
+static rtka_confidence_t true_mass(const rtka_chromosome_t* chrom) {
+    return onemax(chrom);
+}
+
+static rtka_confidence_t false_mass(const rtka_chromosome_t* chrom) {
+    rtka_confidence_t sum = 0.0f;
+    for (uint32_t g = 0; g < chrom->length; g++) {
+        if (chrom->genes[g].value == RTKA_FALSE) sum += chrom->genes[g].confidence;
+    }
+    return sum / (rtka_confidence_t)chrom->length;
+}
+
+static bool check_nsga2(rtka_thread_pool_t* pool) {
+    printf("\n--- NSGA-II ---\n");
+    rtka_fitness_fn objectives[2] = { true_mass, false_mass };
+    rtka_population_t* pop = seeded_population(5);
+    if (!pop) return false;
+
+    for (uint32_t g = 0; g < 150; g++) rtka_evolution_nsga2_parallel(pop, objectives, 2, pool);
+
+    /* Front 0 leads the sorted population and nobody dominates it */
+    bool sorted = rows_in_order(pop), undominated = true;
+    uint32_t front = 0;
+    float lowest = 1.0f, highest = 0.0f, total = 0.0f;
+    for (uint32_t i = 1; i < pop->size; i++) sorted &= pop->individuals[i - 1U]->fitness >= pop->individuals[i]->fitness;
+    while (front < pop->size && pop->individuals[front]->fitness == 1.0f) {
+        const rtka_chromosome_t* a = pop->individuals[front];
+        float t = true_mass(a), f = false_mass(a);
+        for (uint32_t j = 0; j < pop->size; j++) {
+            float tj = true_mass(pop->individuals[j]), fj = false_mass(pop->individuals[j]);
+            undominated &= !(tj >= t && fj >= f && (tj > t || fj > f));
+        }
+        if (t < lowest) lowest = t;
+        if (t > highest) highest = t;
+        total += t + f;
+        front++;
+    }
+    float mean = front ? total / (float)front : 0.0f;
+    printf("  150 generations of %u: front of %u, %s, %s; true mass %.2f .. %.2f, mean true + false %.3f\n",
+           pop->size, front, sorted ? "population sorted by front" : "NOT SORTED",
+           undominated ? "front undominated" : "FRONT DOMINATED", (double)lowest, (double)highest, (double)mean);
+    rtka_evolution_free_population(pop);
+    return sorted && undominated && front > 1 && highest - lowest > 0.5f && mean > 0.7f;
+}
+
+static bool benchmark_nondominated_sort(rtka_thread_pool_t* pool) {
+    printf("\n--- Non-dominated sort, 20000 points ---\n");
+    const uint32_t n = 20000;
+    bool ok = true;
+    for (uint32_t objectives = 2; objectives <= 3; objectives++) {
+        rtka_confidence_t* points = random_points(n, objectives, 0);
+        uint32_t* rank = (uint32_t*)malloc(n * sizeof(uint32_t));
+        uint32_t* expect = (uint32_t*)malloc(n * sizeof(uint32_t));
+        if (!points || !rank || !expect) return false;
+        double t0 = now_seconds();
+        ok &= rtka_evolution_nondominated_sort(points, n, objectives, rank) == RTKA_SUCCESS;
+        double fast = now_seconds() - t0;
+        t0 = now_seconds();
+        reference_sort(points, n, objectives, expect);
+        double direct = now_seconds() - t0;
+        ok &= memcmp(rank, expect, n * sizeof(uint32_t)) == 0;
+        printf("  %u objectives: divide and conquer %.1f ms, direct %.1f ms (%.0fx)\n",
+               objectives, fast * 1e3, direct * 1e3, direct / fast);
+        free(points);
+        free(rank);
+        free(expect);
+    }
+
+    rtka_fitness_fn objectives[2] = { true_mass, false_mass };
+    rtka_population_t* pop = rtka_evolution_create_population(n / 2U, GENES);
+    if (!pop) return false;
+    rtka_evolution_initialize_random(pop);
+    rtka_evolution_nsga2_parallel(pop, objectives, 2, pool);
+    double t0 = now_seconds();
+    for (uint32_t g = 0; g < 10; g++) rtka_evolution_nsga2_parallel(pop, objectives, 2, pool);
+    printf("  NSGA-II generation, %u parents: %.1f ms\n", pop->size, (now_seconds() - t0) * 1e2);
+    rtka_evolution_free_population(pop);
+    return ok;
+}
+
+static bool check_parallel_step(rtka_thread_pool_t* pool) {
+    printf("\n--- Parallel fitness ---\n");
+    rtka_population_t* serial = seeded_population(42);
+    rtka_population_t* parallel = seeded_population(42);
+    if (!serial || !parallel) return false;
+
+    rtka_evolution_step(serial, onemax, SELECT_TOURNAMENT);
+    rtka_confidence_t first = serial->individuals[0]->fitness;
+    rtka_evolution_step_parallel(parallel, onemax, SELECT_TOURNAMENT, pool);
+    for (uint32_t g = 1; g < 150; g++) {
+        rtka_evolution_step(serial, onemax, SELECT_TOURNAMENT);
+        rtka_evolution_step_parallel(parallel, onemax, SELECT_TOURNAMENT, pool);
+    }
+    /* A final evaluation sorts both */
+    rtka_evolution_step(serial, onemax, SELECT_TOURNAMENT);
+    rtka_evolution_step_parallel(parallel, onemax, SELECT_TOURNAMENT, pool);
+
+    bool same = same_population(serial, parallel);
+    rtka_evolution_stats_t stats = rtka_evolution_get_stats(serial);
+    bool improved = stats.best_fitness > first;
+    printf("  150 generations: %s; best %.3f (from %.3f), gene diversity %.3f\n",
+           same ? "pool matches serial exactly" : "POOL DIFFERS FROM SERIAL",
+           (double)stats.best_fitness, (double)first, (double)stats.diversity);
+
+    rtka_evolution_free_population(serial);
+    rtka_evolution_free_population(parallel);
+    return same && improved;
+}
+
+static bool check_migrate(void) {
+    printf("\n--- Migration ---\n");
+    rtka_island_model_t* model = rtka_evolution_create_islands(3, 20, GENES);
+    if (!model) return false;
+    model->migration_rate = 0.1f;   /* Two migrants */
+
+    for (uint32_t i = 0; i < model->num_islands; i++) {
+        rtka_population_t* pop = model->islands[i];
+        rtka_evolution_step(pop, onemax, SELECT_TOURNAMENT);
+        rtka_evolution_step(pop, onemax, SELECT_TOURNAMENT);
+        for (uint32_t k = 0; k < pop->size; k++) pop->individuals[k]->fitness = onemax(pop->individuals[k]);
+    }
+    rtka_state_t best[3][2][GENES];
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint32_t m = 0; m < 2; m++) {
+            memcpy(best[i][m], model->islands[i]->individuals[m]->genes, sizeof(best[i][m]));
+        }
+    }
+
+    rtka_evolution_migrate(model);
+
+    bool ok = true;
+    for (uint32_t i = 0; i < 3; i++) {
+        const rtka_population_t* to = model->islands[(i + 1U) % 3U];
+        for (uint32_t m = 0; m < 2; m++) {
+            ok &= memcmp(to->individuals[to->size - 1U - m]->genes, best[i][m], sizeof(best[i][m])) == 0;
+        }
+        ok &= model->migrants_received[i] == 2 && model->migrants_dropped[i] == 0;
+    }
+    printf("  ring of 3, two migrants: %s\n", ok ? "best of each island replace the next island's worst"
+                                               : "MIGRANTS MISPLACED");
+    rtka_evolution_free_islands(model);
+    return ok;
+}
+
+static bool check_islands(rtka_thread_pool_t* pool) {
+    printf("\n--- Threaded islands ---\n");
+    rtka_island_model_t* model = rtka_evolution_create_islands(ISLANDS, ISLAND_SIZE, GENES);
+    if (!model) return false;
+    model->migration_interval = 5;
+
+    rtka_confidence_t start = 0.0f;
+    for (uint32_t i = 0; i < ISLANDS; i++) {
+        model->islands[i]->mutation_rate = 0.02f;
+        for (uint32_t k = 0; k < ISLAND_SIZE; k++) {
+            rtka_confidence_t f = onemax(model->islands[i]->individuals[k]);
+            if (f > start) start = f;
+        }
+    }
+
+    bool ok = rtka_evolution_run_islands(model, onemax, SELECT_TOURNAMENT, 200, pool) == RTKA_SUCCESS;
+    for (uint32_t i = 0; i < ISLANDS && ok; i++) {
+        const rtka_population_t* pop = model->islands[i];
+        bool sorted = true;
+        for (uint32_t k = 1; k < pop->size; k++) sorted &= pop->individuals[k - 1U]->fitness >= pop->individuals[k]->fitness;
+        printf("  island %u: best %.3f (all islands started at most %.3f), %u generations, %llu migrants in, %llu dropped%s\n",
+               i, (double)pop->individuals[0]->fitness, (double)start, pop->generation,
+               (unsigned long long)model->migrants_received[i], (unsigned long long)model->migrants_dropped[i],
+               sorted ? "" : ", NOT SORTED");
+        sorted &= rows_in_order(pop);
+        ok &= sorted && pop->generation == 200 && pop->individuals[0]->fitness > start &&
+              model->migrants_received[i] > 0;
+    }
+    rtka_evolution_free_islands(model);
+    return ok;
+}
+
+static double time_steps(rtka_population_t* pop, rtka_fitness_fn fitness, rtka_batch_fitness_fn batch,
+                         uint32_t generations) {
+    double t0 = now_seconds();
+    for (uint32_t g = 0; g < generations; g++) {
+        if (batch) rtka_evolution_step_batch(pop, batch, SELECT_TOURNAMENT, NULL);
+        else rtka_evolution_step(pop, fitness, SELECT_TOURNAMENT);
+    }
+    return now_seconds() - t0;
+}
+
+static bool benchmark_flat(void) {
+    const uint32_t size = 2000, length = 512, generations = 30;
+    printf("\n--- Flat steps, %u x %u genes ---\n", size, length);
+    rtka_population_t* pop = rtka_evolution_create_population(size, length);
+    if (!pop) return false;
+    rtka_evolution_initialize_random(pop);
+
+    double single = time_steps(pop, onemax, NULL, generations);
+    double block = time_steps(pop, NULL, onemax_block, generations);
+    double t0 = now_seconds();
+    rtka_evolution_stats_t stats = {0};
+    for (uint32_t g = 0; g < generations; g++) stats = rtka_evolution_get_stats(pop);
+    double scan = now_seconds() - t0;
+
+    printf("  per-chromosome fitness: %.2f ms/generation\n", single * 1e3 / generations);
+    printf("  batched fitness:        %.2f ms/generation\n", block * 1e3 / generations);
+    printf("  statistics scan:        %.2f ms (diversity %.3f)\n", scan * 1e3 / generations, (double)stats.diversity);
+    rtka_evolution_free_population(pop);
+    return true;
+}
+
+static bool benchmark(rtka_thread_pool_t* pool) {
+    printf("\n--- Costly fitness, %u evaluations per generation ---\n", ISLANDS * ISLAND_SIZE);
+    const uint32_t generations = 40;
+    double t0 = now_seconds();
+    rtka_population_t* pop = rtka_evolution_create_population(ISLANDS * ISLAND_SIZE, GENES);
+    if (!pop) return false;
+    rtka_evolution_initialize_random(pop);
+    for (uint32_t g = 0; g < generations; g++) rtka_evolution_step(pop, costly, SELECT_TOURNAMENT);
+    double serial = now_seconds() - t0;
+
+    t0 = now_seconds();
+    for (uint32_t g = 0; g < generations; g++) rtka_evolution_step_parallel(pop, costly, SELECT_TOURNAMENT, pool);
+    double parallel = now_seconds() - t0;
+
+    if (rtka_evolution_enable_cache(pop, 0) != RTKA_SUCCESS) return false;
+    t0 = now_seconds();
+    for (uint32_t g = 0; g < generations; g++) rtka_evolution_step(pop, costly, SELECT_TOURNAMENT);
+    double cached = now_seconds() - t0;
+    uint64_t hits, misses;
+    rtka_evolution_cache_stats(pop, &hits, &misses);
+    rtka_evolution_free_population(pop);
+
+    rtka_island_model_t* model = rtka_evolution_create_islands(ISLANDS, ISLAND_SIZE, GENES);
+    if (!model) return false;
+    t0 = now_seconds();
+    bool ok = rtka_evolution_run_islands(model, costly, SELECT_TOURNAMENT, generations, pool) == RTKA_SUCCESS;
+    double islands = now_seconds() - t0;
+    rtka_evolution_free_islands(model);
+
+    printf("  serial step:           %.3f s\n", serial);
+    printf("  pool (%u participants): %.3f s (%.2fx)\n", rtka_pool_size(pool) + 1U, parallel, serial / parallel);
+    printf("  %u threaded islands:    %.3f s (%.2fx)\n", ISLANDS, islands, serial / islands);
+    printf("  serial, cached:        %.3f s (%.2fx, %.0f%% of lookups hit)\n", cached, serial / cached,
+           100.0 * (double)hits / (double)(hits + misses));
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Evolution Test ===\n");
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    if (!pool) return 1;
+
+    bool ok = check_layout();
+    ok &= check_cache();
+    ok &= check_nondominated_sort(pool);
+    ok &= check_nsga2(pool);
+    ok &= check_parallel_step(pool);
+    ok &= check_migrate();
+    ok &= check_islands(pool);
+    ok &= benchmark_flat();
+    ok &= benchmark_nondominated_sort(pool);
+    ok &= benchmark(pool);
+
+    rtka_pool_destroy(pool);
+    printf("\n%s\n", ok ? "All evolution checks passed" : "Evolution checks FAILED");
+    return ok ? 0 : 1;
+}
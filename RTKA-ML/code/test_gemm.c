@@ -0,0 +1,350 @@
+/**
+ * File: test_gemm.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Checks the blocked GEMM of every micro-kernel set the CPU supports
+ * against a double-precision reference, on ragged shapes, strided
+ * (transposed) operands and ternary weights; the multiply-free bit-plane
+ * kernels likewise; then rtka_tensor_linear, ternary layer inference and
+ * the Kleene rtka_tensor_matmul against their element-by-element forms.
+ */
+
+#include "rtka_gemm.h"
+#include "rtka_tensor.h"
+#include "rtka_nn.h"
+#include "rtka_optimizer.h"
+#include "rtka_threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+static float frand(void) {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+static rtka_state_t random_state(bool ternary) {
+    return rtka_make_state((rtka_value_t)((rand() % 3) - 1), ternary ? 1.0f : frand());
+}
+
+static double elem(const rtka_gemm_operand_t* op, uint32_t r, uint32_t c) {
+    size_t idx = (size_t)r * op->row_stride + (size_t)c * op->col_stride;
+    if (op->format == RTKA_GEMM_F32) return ((const float*)op->data)[idx];
+    const rtka_state_t* s = &((const rtka_state_t*)op->data)[idx];
+    return op->format == RTKA_GEMM_SIGNED ? (double)s->value * s->confidence : (double)s->value;
+}
+
+/* C = A * B (+ C) against the naive sum; B transposed through its strides */
+static bool check_shape(uint32_t m, uint32_t n, uint32_t k, rtka_gemm_format_t b_format,
+                        bool transpose_b, bool accumulate) {
+    rtka_state_t* a = malloc((size_t)m * k * sizeof(rtka_state_t));
+    rtka_state_t* b = malloc((size_t)k * n * sizeof(rtka_state_t));
+    float* c = malloc((size_t)m * n * sizeof(float));
+    for (size_t i = 0; i < (size_t)m * k; i++) a[i] = random_state(false);
+    for (size_t i = 0; i < (size_t)k * n; i++) b[i] = random_state(b_format == RTKA_GEMM_TERNARY);
+    for (size_t i = 0; i < (size_t)m * n; i++) c[i] = frand();
+
+    rtka_gemm_operand_t a_op = { a, k, 1, RTKA_GEMM_SIGNED, NULL };
+    rtka_gemm_operand_t b_op = { b, transpose_b ? 1 : n, transpose_b ? k : 1, b_format, NULL };
+
+    double* expect = malloc((size_t)m * n * sizeof(double));
+    for (uint32_t i = 0; i < m; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            double sum = accumulate ? c[(size_t)i * n + j] : 0.0;
+            for (uint32_t p = 0; p < k; p++) sum += elem(&a_op, i, p) * elem(&b_op, p, j);
+            expect[(size_t)i * n + j] = sum;
+        }
+    }
+
+    rtka_gemm(m, n, k, &a_op, &b_op, c, n, accumulate);
+
+    bool ok = true;
+    for (size_t i = 0; i < (size_t)m * n && ok; i++) {
+        double tol = 1e-4 * (k + 1);
+        if (fabs(c[i] - expect[i]) > tol) {
+            printf("  FAIL %ux%ux%u%s%s%s at %zu: %f vs %f\n", m, n, k,
+                   b_format == RTKA_GEMM_TERNARY ? " ternary" : "",
+                   transpose_b ? " B^T" : "", accumulate ? " acc" : "", i, c[i], expect[i]);
+            ok = false;
+        }
+    }
+
+    free(a);
+    free(b);
+    free(c);
+    free(expect);
+    return ok;
+}
+
+static bool check_kernels(void) {
+    static const uint32_t shapes[][3] = {
+        {1, 1, 1}, {6, 16, 8}, {5, 17, 3}, {7, 33, 257}, {73, 40, 31},
+        {2, 300, 290}, {150, 257, 600}, {64, 512, 64}
+    };
+
+    bool ok = true;
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        uint32_t m = shapes[s][0], n = shapes[s][1], k = shapes[s][2];
+        ok &= check_shape(m, n, k, RTKA_GEMM_SIGNED, false, false);
+        ok &= check_shape(m, n, k, RTKA_GEMM_SIGNED, true, true);
+        ok &= check_shape(m, n, k, RTKA_GEMM_TERNARY, false, false);
+        ok &= check_shape(m, n, k, RTKA_GEMM_TERNARY, true, true);
+    }
+    return ok;
+}
+
+/* Bit-plane GEMM with NaN in the activation padding, and the popcount form */
+static bool check_ternary_planes(uint32_t rows, uint32_t cols, uint32_t batch) {
+    rtka_state_t* w = malloc((size_t)rows * cols * sizeof(rtka_state_t));
+    rtka_state_t* xs = malloc((size_t)batch * cols * sizeof(rtka_state_t));
+    for (size_t i = 0; i < (size_t)rows * cols; i++) w[i] = random_state(true);
+    for (size_t i = 0; i < (size_t)batch * cols; i++) xs[i] = random_state(true);
+
+    rtka_ternary_matrix_t* wm = rtka_ternary_pack(w, rows, cols, cols, 1);
+    rtka_ternary_matrix_t* xm = rtka_ternary_pack(xs, batch, cols, cols, 1);
+    uint32_t span = rtka_ternary_row_span(wm);
+    float* x = malloc((size_t)batch * span * sizeof(float));
+    float* y = malloc((size_t)batch * rows * sizeof(float));
+    float* y_bits = malloc((size_t)batch * rows * sizeof(float));
+    for (uint32_t b = 0; b < batch; b++) {
+        for (uint32_t c = 0; c < span; c++) x[(size_t)b * span + c] = c < cols ? frand() - 0.5f : NAN;
+    }
+
+    rtka_ternary_gemm(wm, x, batch, span, y, rows);
+    rtka_ternary_gemm_bits(xm, wm, y_bits, rows);
+
+    bool ok = true;
+    for (uint32_t b = 0; b < batch && ok; b++) {
+        for (uint32_t r = 0; r < rows && ok; r++) {
+            double sum = 0.0, dot = 0.0;
+            for (uint32_t c = 0; c < cols; c++) {
+                double wv = (double)w[(size_t)r * cols + c].value;
+                sum += wv * x[(size_t)b * span + c];
+                dot += wv * (double)xs[(size_t)b * cols + c].value;
+            }
+            ok = fabs(y[(size_t)b * rows + r] - sum) <= 1e-4 * cols &&
+                 y_bits[(size_t)b * rows + r] == (float)dot;
+            if (!ok) printf("  FAIL ternary %ux%u batch %u at (%u, %u)\n", rows, cols, batch, b, r);
+        }
+    }
+
+    rtka_ternary_matrix_free(wm);
+    rtka_ternary_matrix_free(xm);
+    free(w);
+    free(xs);
+    free(x);
+    free(y);
+    free(y_bits);
+    return ok;
+}
+
+static bool check_ternary_kernels(void) {
+    return check_ternary_planes(1, 1, 1) && check_ternary_planes(5, 64, 3) &&
+           check_ternary_planes(37, 300, 2) && check_ternary_planes(130, 1000, 9);
+}
+
+/* Weight-vector product at n x n: float GEMM vs bit-planes, products per ns */
+static void time_ternary_gemv(uint32_t n) {
+    rtka_state_t* w = malloc((size_t)n * n * sizeof(rtka_state_t));
+    float* x = malloc((size_t)n * sizeof(float));
+    float* y = malloc((size_t)n * sizeof(float));
+    for (size_t i = 0; i < (size_t)n * n; i++) w[i] = random_state(true);
+    for (uint32_t i = 0; i < n; i++) x[i] = frand();
+
+    rtka_ternary_matrix_t* wm = rtka_ternary_pack(w, n, n, n, 1);
+    rtka_gemm_operand_t x_op = { x, n, 1, RTKA_GEMM_F32, NULL };
+    rtka_gemm_operand_t w_op = { w, 1, n, RTKA_GEMM_SIGNED, NULL };   /* (out, in) read as (in, out) */
+
+    const int iters = 50;
+    clock_t start = clock();
+    for (int it = 0; it < iters; it++) rtka_gemm(1, n, n, &x_op, &w_op, y, n, false);
+    double dense = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    for (int it = 0; it < iters; it++) rtka_ternary_gemm(wm, x, 1, n, y, n);
+    double planes = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("         gemv %u: dense %.2f, bit-planes %.2f MAC/ns (weights %zu KiB -> %zu KiB)\n", n,
+           (double)n * n * iters / dense * 1e-9, (double)n * n * iters / planes * 1e-9,
+           (size_t)n * n * sizeof(rtka_state_t) / 1024U,
+           (size_t)2U * n * wm->words * sizeof(uint64_t) / 1024U);
+
+    rtka_ternary_matrix_free(wm);
+    free(w);
+    free(x);
+    free(y);
+}
+
+static double time_gemm(uint32_t size, rtka_gemm_format_t b_format) {
+    size_t count = (size_t)size * size;
+    rtka_state_t* a = malloc(count * sizeof(rtka_state_t));
+    rtka_state_t* b = malloc(count * sizeof(rtka_state_t));
+    float* c = malloc(count * sizeof(float));
+    for (size_t i = 0; i < count; i++) {
+        a[i] = random_state(false);
+        b[i] = random_state(b_format == RTKA_GEMM_TERNARY);
+    }
+    rtka_gemm_operand_t a_op = { a, size, 1, RTKA_GEMM_SIGNED, NULL };
+    rtka_gemm_operand_t b_op = { b, size, 1, b_format, NULL };
+
+    const int iters = 10;
+    clock_t start = clock();
+    for (int it = 0; it < iters; it++) rtka_gemm(size, size, size, &a_op, &b_op, c, size, false);
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    free(a);
+    free(b);
+    free(c);
+    return 2.0 * size * size * size * iters / secs * 1e-9;
+}
+
+/* Dense layer on 3-D input with a bias against the per-element sum */
+static bool check_linear(void) {
+    uint32_t in_shape[] = {3, 4, 37};
+    uint32_t w_shape[] = {37, 45};
+    uint32_t b_shape[] = {45};
+    rtka_tensor_t* input = rtka_tensor_create(in_shape, 3);
+    rtka_tensor_t* weight = rtka_tensor_create(w_shape, 2);
+    rtka_tensor_t* bias = rtka_tensor_create(b_shape, 1);
+    for (uint32_t i = 0; i < input->size; i++) input->data[i] = random_state(false);
+    for (uint32_t i = 0; i < weight->size; i++) weight->data[i] = random_state(false);
+    for (uint32_t i = 0; i < bias->size; i++) bias->data[i] = random_state(false);
+
+    bool ok = true;
+    for (int ternary = 0; ternary < 2 && ok; ternary++) {
+        if (ternary) {
+            for (uint32_t i = 0; i < weight->size; i++) weight->data[i].confidence = 1.0f;
+        }
+        ok = rtka_tensor_is_ternary(weight) == (ternary != 0);
+
+        rtka_tensor_t* out = rtka_tensor_linear(input, weight, bias);
+        ok = ok && out && out->shape[0] == 12 && out->shape[1] == 45;
+        for (uint32_t r = 0; r < 12 && ok; r++) {
+            for (uint32_t j = 0; j < 45 && ok; j++) {
+                float sum = bias->data[j].confidence * (float)bias->data[j].value;
+                for (uint32_t p = 0; p < 37; p++) {
+                    rtka_state_t x = input->data[r * 37 + p], w = weight->data[p * 45 + j];
+                    sum += x.confidence * w.confidence * (float)x.value * (float)w.value;
+                }
+                rtka_state_t got = out->data[r * 45 + j];
+                float signed_got = got.confidence * (float)got.value;
+                ok = fabsf(signed_got - sum) <= 1e-4f &&
+                     (got.value == RTKA_UNKNOWN || (sum > 0.0f) == (got.value == RTKA_TRUE));
+            }
+        }
+        rtka_tensor_free(out);
+    }
+
+    printf("linear   %s\n", ok ? "PASS" : "FAIL");
+    rtka_tensor_free(input);
+    rtka_tensor_free(weight);
+    rtka_tensor_free(bias);
+    return ok;
+}
+
+/* Inference of a ternary layer against the dense signed product */
+static bool check_ternary_layer(void) {
+    const uint32_t in = 70, out = 33, rows = 4;
+    rtka_ternary_layer_t* layer = rtka_nn_ternary(in, out, 0.5f);
+    if (!layer) return false;
+    rtka_tensor_t* weight = layer->base.weight->data;
+    for (uint32_t i = 0; i < weight->size; i++) weight->data[i] = random_state(false);
+    rtka_optimizer_apply_ternary_constraint(weight);
+    layer->base.training = false;
+    layer->quantize_activations = false;
+
+    uint32_t in_shape[] = {rows, in};
+    rtka_tensor_t* input = rtka_tensor_create(in_shape, 2);
+    bool ok = rtka_tensor_is_ternary(weight);
+    for (int ternary_input = 0; ternary_input < 2 && ok; ternary_input++) {
+        for (uint32_t i = 0; i < input->size; i++) input->data[i] = random_state(ternary_input != 0);
+
+        rtka_tensor_t* got = rtka_nn_ternary_infer(layer, input);
+        ok = got && got->shape[0] == rows && got->shape[1] == out;
+        for (uint32_t r = 0; r < rows && ok; r++) {
+            for (uint32_t o = 0; o < out && ok; o++) {
+                float z = 0.0f;
+                for (uint32_t c = 0; c < in; c++) {
+                    rtka_state_t x = input->data[r * in + c], w = weight->data[c * out + o];
+                    z += x.confidence * (float)x.value * w.confidence * (float)w.value;
+                }
+                rtka_state_t expect = rtka_ternary_sigmoid(rtka_make_state(RTKA_UNKNOWN, z), 0.5f);
+                rtka_state_t s = got->data[r * out + o];
+                ok = s.value == expect.value && fabsf(s.confidence - expect.confidence) <= 1e-4f;
+            }
+        }
+        rtka_tensor_free(got);
+    }
+
+    printf("ternary  %s  (layer inference, float and ternary activations)\n", ok ? "PASS" : "FAIL");
+    rtka_tensor_free(input);
+    return ok;
+}
+
+/* Kleene OR of ANDs against the fold of rtka_combine_or / rtka_combine_and */
+static bool check_kleene_matmul(void) {
+    uint32_t a_shape[] = {9, 70};
+    uint32_t b_shape[] = {70, 600};
+    rtka_tensor_t* a = rtka_tensor_create(a_shape, 2);
+    rtka_tensor_t* b = rtka_tensor_create(b_shape, 2);
+    for (uint32_t i = 0; i < a->size; i++) a->data[i] = random_state(false);
+    for (uint32_t i = 0; i < b->size; i++) b->data[i] = random_state(false);
+
+    rtka_tensor_t* c = rtka_tensor_matmul(a, b);
+    bool ok = c != NULL;
+    for (uint32_t i = 0; i < 9 && ok; i++) {
+        for (uint32_t j = 0; j < 600 && ok; j++) {
+            rtka_state_t sum = rtka_make_state(RTKA_FALSE, 1.0f);
+            for (uint32_t p = 0; p < 70; p++) {
+                sum = rtka_combine_or(sum, rtka_combine_and(a->data[i * 70 + p], b->data[p * 600 + j]));
+            }
+            rtka_state_t got = c->data[i * 600 + j];
+            ok = got.value == sum.value && fabsf(got.confidence - sum.confidence) <= 1e-5f;
+        }
+    }
+
+    printf("matmul   %s\n", ok ? "PASS" : "FAIL");
+    rtka_tensor_free(a);
+    rtka_tensor_free(b);
+    rtka_tensor_free(c);
+    return ok;
+}
+
+int main(void) {
+    printf("RTKA Blocked GEMM Test\n");
+    printf("======================\n\n");
+
+    srand(42);
+    rtka_simd_level_t native = rtka_simd_level();
+    printf("Selected kernels: %s, %u pool workers\n\n", rtka_gemm_kernel_name(),
+           rtka_pool_size(rtka_pool_default()));
+
+    const rtka_simd_level_t levels[] = {
+        RTKA_SIMD_SCALAR, RTKA_SIMD_SSE41, RTKA_SIMD_AVX2, RTKA_SIMD_AVX512, RTKA_SIMD_NEON
+    };
+
+    bool all_ok = true;
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        if (!rtka_simd_set_level(levels[l])) continue;
+
+        bool ok = check_kernels() && check_ternary_kernels();
+        printf("%-8s %-9s %s  (256^3 %.1f GFLOP/s, ternary B %.1f GFLOP/s)\n",
+               rtka_simd_level_name(levels[l]), rtka_gemm_kernel_name(), ok ? "PASS" : "FAIL",
+               time_gemm(256, RTKA_GEMM_SIGNED), time_gemm(256, RTKA_GEMM_TERNARY));
+        time_ternary_gemv(1024);
+        all_ok &= ok;
+    }
+    bool restored = rtka_simd_set_level(native);
+
+    all_ok &= check_linear();
+    all_ok &= check_ternary_layer();
+    all_ok &= check_kleene_matmul();
+
+    printf("\n%s\n", (all_ok && restored) ? "All GEMM paths match reference" : "Mismatch detected");
+    return (all_ok && restored) ? 0 : 1;
+}
@@ -0,0 +1,583 @@
+/**
+ * File: test_gnn.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA GNN: sparse message passing
+ *
+ * rtka_gnn_spmm is checked against aggregation over a dense N x N
+ * adjacency for every aggregation, with and without normalization and
+ * self loops, per kernel and on a thread pool. The GCN, GAT and ternary
+ * layers are checked against the same reference. The neighbour sampler is
+ * checked for valid, complete epochs and, at full fanout, for seed rows
+ * equal to the full-graph forward pass. Then SpMM and a pipelined
+ * sample-and-forward epoch run on a graph far too large for a dense
+ * adjacency (node count from argv[1], default 200000).
+ */
+
+#define _GNU_SOURCE
+#include "rtka_gnn.h"
+#include "rtka_gnn_sampler.h"
+#include "rtka_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define SMALL_NODES      300U
+#define SMALL_EDGES      2400U
+#define SMALL_FEATURES   19U        /* Not a multiple of the AVX2 width */
+#define POOL_THREADS     3U
+#define BENCH_DEGREE     16U
+#define BENCH_FEATURES   32U
+#define TOLERANCE        1e-5f
+#define SAMPLER_TRAIN    20000U
+#define SAMPLER_BATCH    1000U
+#define SAMPLER_ARENA    (512U << 20)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 16);
+}
+
+static rtka_state_t random_state(void) {
+    static const rtka_value_t values[] = {RTKA_FALSE, RTKA_UNKNOWN, RTKA_TRUE};
+    return rtka_make_state(values[next_random() % 3U], (float)(next_random() % 1001U) / 1000.0f);
+}
+
+static rtka_tensor_t* random_tensor(uint32_t rows, uint32_t cols) {
+    uint32_t shape[] = {rows, cols};
+    rtka_tensor_t* t = rtka_tensor_create(shape, 2);
+    if (t) {
+        for (uint32_t i = 0; i < t->size; i++) t->data[i] = random_state();
+    }
+    return t;
+}
+
+/* Repeated edges and self loops occur; a few nodes have no in-edges */
+static rtka_graph_t* random_graph(uint32_t nodes, uint32_t edges) {
+    rtka_graph_t* graph = rtka_graph_create(nodes, 8U);
+    if (!graph) return NULL;
+    for (uint32_t e = 0; e < edges; e++) {
+        uint32_t dst = next_random() % nodes;
+        if (dst % 37U == 5U) dst++;
+        rtka_graph_add_edge(graph, next_random() % nodes, dst % nodes);
+    }
+    return graph;
+}
+
+/* Aggregation the original way: an N x N adjacency, sources scanned in
+ * order for every destination. coef NULL: the GCN normalization */
+static void reference_aggregate(const rtka_graph_t* graph, const uint8_t* adj, const rtka_state_t* messages,
+                                const rtka_state_t* self_messages, rtka_aggregation_t aggregation,
+                                bool normalize, const float* self_coef, uint32_t features, rtka_state_t* out) {
+    uint32_t n = graph->num_nodes;
+    float* inv_sqrt = malloc(n * sizeof(float));
+    rtka_state_t* votes = malloc((n + 1U) * sizeof(rtka_state_t));
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t degree = 1;
+        for (uint32_t u = 0; u < n; u++) degree += adj[(size_t)u * n + v];
+        inv_sqrt[v] = 1.0f / sqrtf((float)degree);
+    }
+
+    for (uint32_t dst = 0; dst < n; dst++) {
+        for (uint32_t f = 0; f < features; f++) {
+            rtka_state_t acc = rtka_make_state(RTKA_FALSE, 0.0f);
+            uint32_t count = 0;
+            for (uint32_t src = 0; src <= n; src++) {
+                const rtka_state_t* msg;
+                float coef;
+                if (src < n) {
+                    if (!adj[(size_t)src * n + dst]) continue;
+                    msg = &messages[(size_t)src * features + f];
+                    coef = normalize ? inv_sqrt[src] * inv_sqrt[dst] : 1.0f;
+                } else {
+                    if (!self_messages) continue;
+                    msg = &self_messages[(size_t)dst * features + f];
+                    coef = self_coef ? self_coef[dst] : normalize ? inv_sqrt[dst] * inv_sqrt[dst] : 1.0f;
+                }
+                rtka_state_t weighted = rtka_combine_and(rtka_make_state(RTKA_TRUE, coef), *msg);
+                switch (aggregation) {
+                    case MSG_SUM:
+                    case MSG_MEAN:
+                        acc = rtka_combine_or(acc, weighted);
+                        break;
+                    case MSG_MAX:
+                        if (weighted.confidence > acc.confidence) acc = weighted;
+                        break;
+                    case MSG_TERNARY:
+                        votes[count] = weighted;
+                        break;
+                }
+                count++;
+            }
+            if (aggregation == MSG_MEAN && count > 0) acc.confidence /= (float)count;
+            if (aggregation == MSG_TERNARY) acc = rtka_gnn_aggregate_ternary(votes, count);
+            out[(size_t)dst * features + f] = acc;
+        }
+    }
+    free(inv_sqrt);
+    free(votes);
+}
+
+static uint8_t* dense_adjacency(const rtka_graph_t* graph) {
+    uint32_t n = graph->num_nodes;
+    uint8_t* adj = calloc((size_t)n * n, 1);
+    if (!adj) return NULL;
+    for (uint32_t e = 0; e < graph->num_edges; e++) {
+        adj[(size_t)graph->edge_index[2 * e] * n + graph->edge_index[2 * e + 1]] = 1;
+    }
+    return adj;
+}
+
+static bool same_states(const rtka_state_t* a, const rtka_state_t* b, size_t count, float* worst) {
+    *worst = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        if (a[i].value != b[i].value) return false;
+        float d = fabsf(a[i].confidence - b[i].confidence);
+        if (d > *worst) *worst = d;
+    }
+    return *worst <= TOLERANCE;
+}
+
+static const char* aggregation_name(rtka_aggregation_t a) {
+    switch (a) {
+        case MSG_SUM: return "sum";
+        case MSG_MEAN: return "mean";
+        case MSG_MAX: return "max";
+        case MSG_TERNARY: return "ternary";
+    }
+    return "?";
+}
+
+static bool check_csr(void) {
+    printf("\n--- CSR ---\n");
+    rtka_graph_t* graph = rtka_graph_create(4, 2);
+    const uint32_t edges[][2] = {{2, 1}, {0, 1}, {2, 1}, {3, 3}, {1, 0}, {0, 1}, {9, 1}};
+    for (uint32_t e = 0; e < 7; e++) rtka_graph_add_edge(graph, edges[e][0], edges[e][1]);
+    bool ok = graph->num_edges == 6 && rtka_graph_compute_adjacency(graph) == RTKA_SUCCESS;
+
+    const uint32_t offsets[] = {0, 1, 3, 3, 4};
+    const uint32_t sources[] = {1, 0, 2, 3};
+    ok = ok && memcmp(graph->in_offsets, offsets, sizeof(offsets)) == 0 &&
+         memcmp(graph->in_sources, sources, sizeof(sources)) == 0;
+    /* Edge 0 -> 1: deg(0) = 2, deg(1) = 3 */
+    ok = ok && fabsf(graph->edge_norm[1] - 1.0f / sqrtf(6.0f)) < 1e-6f && fabsf(graph->self_norm[1] - 1.0f / 3.0f) < 1e-6f;
+    printf("  %s: rows sorted, duplicates and out-of-range edges dropped, normalization\n", ok ? "ok" : "FAILED");
+    rtka_graph_free(graph);
+    return ok;
+}
+
+static bool check_spmm(rtka_simd_level_t level, rtka_thread_pool_t* pool) {
+    if (!rtka_gnn_set_kernel(level)) {
+        printf("  %s kernel: not supported here, skipped\n", level == RTKA_SIMD_AVX2 ? "avx2" : "scalar");
+        return true;
+    }
+    rtka_graph_t* graph = random_graph(SMALL_NODES, SMALL_EDGES);
+    uint8_t* adj = graph ? dense_adjacency(graph) : NULL;
+    rtka_tensor_t* messages = random_tensor(SMALL_NODES, SMALL_FEATURES);
+    rtka_tensor_t* self_messages = random_tensor(SMALL_NODES, SMALL_FEATURES);
+    rtka_tensor_t* out = random_tensor(SMALL_NODES, SMALL_FEATURES);
+    rtka_state_t* expect = malloc((size_t)SMALL_NODES * SMALL_FEATURES * sizeof(rtka_state_t));
+    if (!adj || !messages || !self_messages || !out || !expect) return false;
+
+    bool ok = true;
+    float worst_all = 0.0f;
+    for (uint32_t a = MSG_SUM; a <= MSG_TERNARY; a++) {
+        for (uint32_t variant = 0; variant < 4; variant++) {
+            bool normalize = variant & 1U;
+            const rtka_tensor_t* self = variant & 2U ? self_messages : NULL;
+            reference_aggregate(graph, adj, messages->data, self ? self->data : NULL, (rtka_aggregation_t)a,
+                                normalize, NULL, SMALL_FEATURES, expect);
+            float worst;
+            bool same = rtka_gnn_spmm(graph, messages, self, (rtka_aggregation_t)a, normalize, pool, out) == RTKA_SUCCESS &&
+                        same_states(out->data, expect, out->size, &worst);
+            if (!same) {
+                printf("  %s, normalize %d, self loops %d: MISMATCH\n", aggregation_name((rtka_aggregation_t)a),
+                       normalize, self != NULL);
+                ok = false;
+            }
+            if (worst > worst_all) worst_all = worst;
+        }
+    }
+    printf("  %s kernel, %s: %s (all aggregations, max confidence error %.1e)\n",
+           level == RTKA_SIMD_AVX2 ? "avx2" : "scalar", pool ? "3-thread pool" : "default pool",
+           ok ? "matches dense" : "FAILED", (double)worst_all);
+
+    free(expect);
+    free(adj);
+    rtka_tensor_free(messages);
+    rtka_tensor_free(self_messages);
+    rtka_tensor_free(out);
+    rtka_graph_free(graph);
+    return ok;
+}
+
+static bool check_layers(void) {
+    printf("\n--- Layers ---\n");
+    const uint32_t in = 7, hidden = 12;
+    rtka_graph_t* graph = random_graph(SMALL_NODES, SMALL_EDGES);
+    uint8_t* adj = graph ? dense_adjacency(graph) : NULL;
+    rtka_grad_node_t* x = rtka_grad_node_create(random_tensor(SMALL_NODES, in), false);
+    rtka_state_t* expect = malloc((size_t)SMALL_NODES * hidden * sizeof(rtka_state_t));
+    if (!adj || !x || !expect) return false;
+    bool ok = true;
+    float worst;
+
+    /* GCN: normalized neighbour term plus the self loop */
+    rtka_gcn_layer_t* gcn = rtka_gnn_gcn(in, hidden, false);
+    rtka_grad_node_t* out = rtka_gnn_message_pass(&gcn->base, x, graph);
+    rtka_grad_node_t* m = rtka_grad_matmul(x, gcn->weight_neighbors);
+    rtka_grad_node_t* s = rtka_grad_matmul(x, gcn->weight_self);
+    reference_aggregate(graph, adj, m->data->data, s->data->data, MSG_SUM, true, NULL, hidden, expect);
+    bool same = out && same_states(out->data->data, expect, out->data->size, &worst);
+    printf("  GCN: %s\n", same ? "matches dense" : "MISMATCH");
+    ok &= same;
+
+    /* GAT with zero attention weights attends uniformly over the in-edges
+     * and the self loop */
+    rtka_gat_layer_t* gat = rtka_gnn_gat(in, hidden, 2);
+    for (uint32_t i = 0; i < gat->attention_weights->data->size; i++) {
+        gat->attention_weights->data->data[i].confidence = 0.0f;
+    }
+    out = rtka_gnn_message_pass(&gat->base, x, graph);
+    rtka_grad_node_t* h = rtka_grad_matmul(x, gat->weight_linear);
+    float* uniform = malloc(SMALL_NODES * sizeof(float));
+    for (uint32_t v = 0; v < SMALL_NODES; v++) {
+        uint32_t degree = 1;
+        for (uint32_t u = 0; u < SMALL_NODES; u++) degree += adj[(size_t)u * SMALL_NODES + v];
+        uniform[v] = 1.0f / (float)degree;
+    }
+    rtka_state_t* reference = malloc((size_t)SMALL_NODES * hidden * sizeof(rtka_state_t));
+    for (uint32_t dst = 0; dst < SMALL_NODES; dst++) {
+        for (uint32_t f = 0; f < hidden; f++) {
+            rtka_state_t acc = rtka_make_state(RTKA_FALSE, 0.0f);
+            for (uint32_t src = 0; src < SMALL_NODES; src++) {
+                if (!adj[(size_t)src * SMALL_NODES + dst]) continue;
+                acc = rtka_combine_or(acc, rtka_combine_and(rtka_make_state(RTKA_TRUE, uniform[dst]),
+                                                            h->data->data[(size_t)src * hidden + f]));
+            }
+            acc = rtka_combine_or(acc, rtka_combine_and(rtka_make_state(RTKA_TRUE, uniform[dst]),
+                                                        h->data->data[(size_t)dst * hidden + f]));
+            reference[(size_t)dst * hidden + f] = acc;
+        }
+    }
+    same = out && same_states(out->data->data, reference, out->data->size, &worst);
+    printf("  GAT (2 heads, uniform attention): %s\n", same ? "matches dense" : "MISMATCH");
+    ok &= same;
+
+    /* Random attention: all coefficients positive, each row summing to 1,
+     * so confidences stay in [0, 1] */
+    for (uint32_t i = 0; i < gat->attention_weights->data->size; i++) {
+        gat->attention_weights->data->data[i].confidence = (float)(next_random() % 2001U) / 1000.0f - 1.0f;
+    }
+    out = rtka_gnn_message_pass(&gat->base, x, graph);
+    bool bounded = out != NULL;
+    for (uint32_t i = 0; bounded && i < out->data->size; i++) {
+        float c = out->data->data[i].confidence;
+        bounded = c >= 0.0f && c <= 1.0f + TOLERANCE;
+    }
+    printf("  GAT (random attention): %s\n", bounded ? "confidences in [0, 1]" : "OUT OF RANGE");
+    ok &= bounded;
+
+    /* Ternary layer: the vote over (TRUE, threshold) AND x, blended with x */
+    rtka_tgn_layer_t* tgn = rtka_gnn_ternary(hidden, hidden, 0.8f);
+    rtka_grad_node_t* xt = rtka_grad_node_create(random_tensor(SMALL_NODES, hidden), false);
+    out = rtka_gnn_message_pass(&tgn->base, xt, graph);
+    rtka_state_t* gated = malloc((size_t)SMALL_NODES * hidden * sizeof(rtka_state_t));
+    for (uint32_t i = 0; i < SMALL_NODES * hidden; i++) {
+        gated[i] = rtka_combine_and(xt->data->data[i], rtka_make_state(RTKA_TRUE, 0.8f));
+    }
+    reference_aggregate(graph, adj, gated, NULL, MSG_TERNARY, false, NULL, hidden, expect);
+    const rtka_state_t half = rtka_make_state(RTKA_TRUE, 0.5f);
+    for (uint32_t i = 0; i < SMALL_NODES * hidden; i++) {
+        expect[i] = rtka_combine_or(rtka_combine_and(xt->data->data[i], half), rtka_combine_and(expect[i], half));
+    }
+    same = out && same_states(out->data->data, expect, out->data->size, &worst);
+    printf("  ternary: %s\n", same ? "matches dense" : "MISMATCH");
+    ok &= same;
+
+    free(gated);
+    free(reference);
+    free(uniform);
+    free(expect);
+    free(adj);
+    rtka_graph_free(graph);
+    return ok;
+}
+
+static bool has_edge(const rtka_graph_t* graph, uint32_t src, uint32_t dst) {
+    uint32_t lo = graph->in_offsets[dst], hi = graph->in_offsets[dst + 1U];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2U;
+        if (graph->in_sources[mid] < src) lo = mid + 1U;
+        else hi = mid;
+    }
+    return lo < graph->in_offsets[dst + 1U] && graph->in_sources[lo] == src;
+}
+
+/* Every edge is a real edge, seeds carry min(degree, fanout) in-edges and
+ * the gathered rows are the original features */
+static bool valid_batch(const rtka_graph_t* graph, const rtka_tensor_t* features,
+                        const rtka_gnn_batch_t* batch, uint32_t fanout) {
+    const rtka_graph_t* sub = batch->graph;
+    uint32_t width = features->shape[1];
+    for (uint32_t e = 0; e < sub->num_edges; e++) {
+        uint32_t src = batch->node_ids[sub->edge_index[2 * e]], dst = batch->node_ids[sub->edge_index[2 * e + 1]];
+        if (!has_edge(graph, src, dst)) return false;
+    }
+    if (sub->csr_edges != sub->num_edges || sub->in_offsets[sub->num_nodes] != sub->num_edges) return false;
+    for (uint32_t i = 0; i < batch->num_seeds; i++) {
+        uint32_t v = batch->node_ids[i];
+        uint32_t degree = graph->in_offsets[v + 1U] - graph->in_offsets[v];
+        if (sub->in_offsets[i + 1U] - sub->in_offsets[i] != (degree < fanout ? degree : fanout)) return false;
+    }
+    for (uint32_t i = 0; i < sub->num_nodes; i++) {
+        if (memcmp(sub->node_features->data + (size_t)i * width,
+                   features->data + (size_t)batch->node_ids[i] * width, width * sizeof(rtka_state_t)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool same_batch(const rtka_gnn_batch_t* a, const rtka_gnn_batch_t* b) {
+    return a->num_seeds == b->num_seeds && a->graph->num_nodes == b->graph->num_nodes &&
+           a->graph->num_edges == b->graph->num_edges &&
+           memcmp(a->node_ids, b->node_ids, a->graph->num_nodes * sizeof(uint32_t)) == 0 &&
+           memcmp(a->graph->edge_index, b->graph->edge_index, 2U * a->graph->num_edges * sizeof(uint32_t)) == 0;
+}
+
+/* Two GCN layers, unnormalized so the result does not see the subgraph's
+ * degrees */
+static rtka_grad_node_t* two_layers(rtka_gcn_layer_t* first, rtka_gcn_layer_t* second,
+                                    rtka_tensor_t* features, rtka_graph_t* graph) {
+    rtka_grad_node_t* x = rtka_grad_node_create(features, false);
+    rtka_grad_node_t* h = x ? rtka_gnn_message_pass(&first->base, x, graph) : NULL;
+    return h ? rtka_gnn_message_pass(&second->base, h, graph) : NULL;
+}
+
+static bool check_sampler(void) {
+    printf("\n--- Neighbour sampler ---\n");
+    const uint32_t width = 6, train_count = 250;
+    rtka_graph_t* graph = random_graph(SMALL_NODES, SMALL_EDGES);
+    rtka_tensor_t* features = random_tensor(SMALL_NODES, width);
+    uint32_t* train = malloc(train_count * sizeof(uint32_t));
+    uint32_t* seen = calloc(SMALL_NODES, sizeof(uint32_t));
+    if (!graph || !features || !train || !seen) return false;
+    for (uint32_t i = 0; i < train_count; i++) train[i] = (i * 7U + 3U) % SMALL_NODES;
+
+    /* Sampled epochs: seeds cover the training set once, batches are valid,
+     * and the thread yields exactly the synchronous sequence */
+    const uint32_t fanouts[] = {3, 2};
+    rtka_gnn_sampler_t *threaded = NULL, *sync = NULL;
+    bool ok = rtka_gnn_sampler_create(&threaded, graph, features, train, train_count, fanouts, 2, 32, 7, 0) == RTKA_SUCCESS &&
+              rtka_gnn_sampler_create(&sync, graph, features, train, train_count, fanouts, 2, 32, 7,
+                                      RTKA_GNN_SAMPLER_SYNC) == RTKA_SUCCESS;
+    uint32_t batches = 0, epochs = 0;
+    bool valid = ok, same = ok, covered = ok;
+    while (ok && epochs < 3) {
+        rtka_gnn_batch_t *a, *b;
+        if (rtka_gnn_sampler_next(threaded, &a) != RTKA_SUCCESS || rtka_gnn_sampler_next(sync, &b) != RTKA_SUCCESS) {
+            ok = false;
+            break;
+        }
+        if (!a || !b) {
+            same &= !a && !b;
+            for (uint32_t i = 0; i < train_count; i++) covered &= seen[train[i]] == epochs + 1U;
+            covered &= batches == rtka_gnn_sampler_batches(sync);
+            rtka_gnn_batch_free(a);
+            rtka_gnn_batch_free(b);
+            batches = 0;
+            epochs++;
+            continue;
+        }
+        valid &= a->epoch == epochs && a->index == batches && valid_batch(graph, features, a, fanouts[0]);
+        same &= same_batch(a, b);
+        for (uint32_t i = 0; i < a->num_seeds; i++) seen[a->node_ids[i]]++;
+        batches++;
+        rtka_gnn_batch_free(a);
+        rtka_gnn_batch_free(b);
+    }
+    rtka_gnn_sampler_free(threaded);
+    rtka_gnn_sampler_free(sync);
+    printf("  fanouts {3, 2}, 3 epochs: %s, %s, %s\n", valid ? "edges / fanouts / features valid" : "INVALID BATCH",
+           covered ? "every seed once per epoch" : "SEEDS NOT COVERED",
+           same ? "thread matches synchronous" : "THREAD DIFFERS");
+    ok &= valid && same && covered;
+
+    /* Full fanout: seed rows of a 2-layer forward equal the full graph's */
+    rtka_gcn_layer_t* first = rtka_gnn_gcn(width, 9, false);
+    rtka_gcn_layer_t* second = rtka_gnn_gcn(9, 9, false);
+    first->normalize = second->normalize = false;
+    first->base.aggregation = second->base.aggregation = MSG_MEAN;
+    uint32_t shape[] = {SMALL_NODES, width};
+    rtka_tensor_t* copy = rtka_tensor_create(shape, 2);
+    memcpy(copy->data, features->data, features->size * sizeof(rtka_state_t));
+    rtka_grad_node_t* full = two_layers(first, second, copy, graph);
+
+    const uint32_t all[] = {RTKA_GNN_ALL_NEIGHBORS, RTKA_GNN_ALL_NEIGHBORS};
+    rtka_gnn_sampler_t* sampler = NULL;
+    bool exact = full && rtka_gnn_sampler_create(&sampler, graph, features, train, train_count, all, 2, 40, 11, 0) == RTKA_SUCCESS;
+    float worst = 0.0f;
+    for (;;) {
+        rtka_gnn_batch_t* batch;
+        if (!exact || rtka_gnn_sampler_next(sampler, &batch) != RTKA_SUCCESS) {
+            exact = false;
+            break;
+        }
+        if (!batch) break;
+        rtka_tensor_t* x = batch->graph->node_features;
+        batch->graph->node_features = NULL;     /* The grad node takes it */
+        rtka_grad_node_t* out = two_layers(first, second, x, batch->graph);
+        for (uint32_t i = 0; out && i < batch->num_seeds; i++) {
+            float d;
+            exact &= same_states(out->data->data + (size_t)i * 9U,
+                                 full->data->data + (size_t)batch->node_ids[i] * 9U, 9, &d);
+            if (d > worst) worst = d;
+        }
+        exact &= out != NULL;
+        rtka_gnn_batch_free(batch);
+    }
+    rtka_gnn_sampler_free(sampler);
+    printf("  full fanout, 2 layers: %s (max confidence error %.1e)\n",
+           exact ? "seed rows match the full graph" : "MISMATCH", (double)worst);
+    ok &= exact;
+
+    free(train);
+    free(seen);
+    rtka_tensor_free(features);
+    rtka_graph_free(graph);
+    return ok;
+}
+
+/* One epoch of sampling plus a 2-layer forward per batch, first
+ * sequentially, then with sampling on the background thread */
+static bool benchmark_sampler(rtka_graph_t* graph, rtka_tensor_t* features) {
+    const uint32_t fanouts[] = {10, 5};
+    rtka_gcn_layer_t* first = rtka_gnn_gcn(BENCH_FEATURES, BENCH_FEATURES, false);
+    rtka_gcn_layer_t* second = rtka_gnn_gcn(BENCH_FEATURES, BENCH_FEATURES, false);
+    rtka_arena_t* arena = rtka_arena_create(SAMPLER_ARENA);
+    uint32_t train = graph->num_nodes < SAMPLER_TRAIN ? graph->num_nodes : SAMPLER_TRAIN;
+    uint32_t* seeds = malloc(train * sizeof(uint32_t));
+    if (!first || !second || !arena || !seeds) return false;
+    for (uint32_t i = 0; i < train; i++) seeds[i] = i;
+
+    printf("  sampled epoch: %u seeds, batches of %u, fanouts {10, 5}\n", train, SAMPLER_BATCH);
+    bool ok = true;
+    for (uint32_t mode = 0; mode < 2 && ok; mode++) {
+        rtka_gnn_sampler_t* sampler;
+        if (rtka_gnn_sampler_create(&sampler, graph, features, seeds, train, fanouts, 2, SAMPLER_BATCH, 3,
+                                    mode ? 0 : RTKA_GNN_SAMPLER_SYNC) != RTKA_SUCCESS) {
+            ok = false;
+            break;
+        }
+        double sampling = 0.0, compute = 0.0, t0 = now_seconds();
+        uint64_t sampled_nodes = 0;
+        for (;;) {
+            double t1 = now_seconds();
+            rtka_gnn_batch_t* batch;
+            if (rtka_gnn_sampler_next(sampler, &batch) != RTKA_SUCCESS) {
+                ok = false;
+                break;
+            }
+            double t2 = now_seconds();
+            sampling += t2 - t1;
+            if (!batch) break;
+            sampled_nodes += batch->graph->num_nodes;
+
+            rtka_arena_begin_step(arena);
+            rtka_grad_node_t* x = rtka_grad_node_create(batch->graph->node_features, false);
+            rtka_grad_node_t* h = x ? rtka_gnn_message_pass(&first->base, x, batch->graph) : NULL;
+            ok &= h && rtka_gnn_message_pass(&second->base, h, batch->graph) != NULL;
+            rtka_arena_end_step(arena);
+            rtka_gnn_batch_free(batch);
+            compute += now_seconds() - t2;
+        }
+        printf("  %-10s %.3f s total: %.3f s %s sampling, %.3f s forward (%.0f nodes per batch)\n",
+               mode ? "pipelined" : "sequential", now_seconds() - t0, sampling,
+               mode ? "waiting on" : "in", compute,
+               (double)sampled_nodes / rtka_gnn_sampler_batches(sampler));
+        rtka_gnn_sampler_free(sampler);
+    }
+    rtka_arena_destroy(arena);
+    free(seeds);
+    return ok;
+}
+
+static bool benchmark(uint32_t nodes) {
+    printf("\n--- SpMM, %u nodes x %u features, average in-degree %u ---\n", nodes, BENCH_FEATURES, BENCH_DEGREE);
+    uint64_t edges = (uint64_t)nodes * BENCH_DEGREE;
+    double t0 = now_seconds();
+    rtka_graph_t* graph = random_graph(nodes, (uint32_t)edges);
+    bool ok = graph && rtka_graph_compute_adjacency(graph) == RTKA_SUCCESS;
+    rtka_tensor_t* messages = random_tensor(nodes, BENCH_FEATURES);
+    rtka_tensor_t* out = random_tensor(nodes, BENCH_FEATURES);
+    if (!ok || !messages || !out) {
+        printf("  allocation failed\n");
+        return false;
+    }
+    printf("  CSR build: %.3f s, %.1f MB (a dense adjacency tensor would be %.1f GB)\n", now_seconds() - t0,
+           (double)(((uint64_t)nodes + 1U) * 4U + (uint64_t)graph->in_offsets[nodes] * 8U + nodes * 4ULL) / 1e6,
+           (double)nodes * nodes * sizeof(rtka_state_t) / 1e9);
+
+    const rtka_simd_level_t levels[] = {RTKA_SIMD_SCALAR, RTKA_SIMD_AVX2};
+    for (uint32_t l = 0; l < 2; l++) {
+        if (!rtka_gnn_set_kernel(levels[l])) continue;
+        t0 = now_seconds();
+        ok &= rtka_gnn_spmm(graph, messages, messages, MSG_SUM, true, NULL, out) == RTKA_SUCCESS;
+        double seconds = now_seconds() - t0;
+        printf("  %-6s normalized sum: %.3f s (%.1f M edge-features/s)\n", l ? "avx2" : "scalar", seconds,
+               seconds > 0.0 ? (double)graph->in_offsets[nodes] * BENCH_FEATURES / seconds / 1e6 : 0.0);
+    }
+    t0 = now_seconds();
+    ok &= rtka_gnn_spmm(graph, messages, NULL, MSG_TERNARY, false, NULL, out) == RTKA_SUCCESS;
+    printf("  ternary vote:          %.3f s\n", now_seconds() - t0);
+    ok &= benchmark_sampler(graph, messages);
+
+    rtka_tensor_free(messages);
+    rtka_tensor_free(out);
+    rtka_graph_free(graph);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t nodes = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 200000U;
+    if (nodes == 0) nodes = 200000U;
+
+    printf("=== RTKA GNN Sparse Message Passing Test ===\n");
+    bool ok = check_csr();
+
+    printf("\n--- SpMM vs dense adjacency ---\n");
+    rtka_simd_level_t best = rtka_gnn_kernel();
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    ok &= check_spmm(RTKA_SIMD_SCALAR, NULL);
+    ok &= check_spmm(RTKA_SIMD_AVX2, NULL);
+    ok &= check_spmm(RTKA_SIMD_AVX2, pool);
+    rtka_pool_destroy(pool);
+    rtka_gnn_set_kernel(best);
+
+    ok &= check_layers();
+    ok &= check_sampler();
+    ok &= benchmark(nodes);
+    rtka_gnn_set_kernel(best);
+
+    printf("\n%s\n", ok ? "All GNN checks passed" : "GNN checks FAILED");
+    return ok ? 0 : 1;
+}
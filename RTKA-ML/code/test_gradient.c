@@ -0,0 +1,234 @@
+/**
+ * File: test_gradient.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Checks the tape autograd: the reverse sweep over an AND / OR / NOT
+ * chain and a two-layer matmul must match gradients worked out by hand,
+ * a deep chain must keep only a few gradient buffers live, a reused tape
+ * must recycle its pool, and releasing activations must not change the
+ * gradients.
+ */
+
+#include "rtka_gradient.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define CHAIN_DEPTH 24U
+#define CHAIN_SIZE  4096U
+
+static float frand(void) {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+static rtka_tensor_t* random_tensor(const uint32_t* shape, uint32_t ndim) {
+    rtka_tensor_t* t = rtka_tensor_create(shape, ndim);
+    for (uint32_t i = 0; i < t->size; i++) {
+        t->data[i] = rtka_make_state((rtka_value_t)((rand() % 3) - 1), frand());
+    }
+    return t;
+}
+
+static rtka_tensor_t* copy_tensor(const rtka_tensor_t* src) {
+    rtka_tensor_t* t = rtka_tensor_create(src->shape, src->ndim);
+    for (uint32_t i = 0; i < t->size; i++) t->data[i] = src->data[i];
+    return t;
+}
+
+static bool report(const char* name, bool ok) {
+    printf("%-14s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool close_to(float a, float b) {
+    return fabsf(a - b) <= 1e-4f * (1.0f + fabsf(b));
+}
+
+/* Operation k of the chain: AND, OR, NOT in turn */
+static rtka_grad_op_t chain_op(uint32_t k) {
+    return k % 3 == 0 ? GRAD_OP_AND : (k % 3 == 1 ? GRAD_OP_OR : GRAD_OP_NOT);
+}
+
+typedef struct {
+    rtka_grad_node_t* x;
+    rtka_grad_node_t* w[CHAIN_DEPTH];
+    rtka_grad_node_t* h[CHAIN_DEPTH];
+} chain_t;
+
+/* h[k] = op_k(h[k - 1], w[k]) on fresh leaves copied from xs / ws */
+static void chain_forward(chain_t* c, rtka_tensor_t* xs, rtka_tensor_t** ws) {
+    c->x = rtka_grad_node_create(copy_tensor(xs), true);
+    rtka_grad_node_t* h = c->x;
+    for (uint32_t k = 0; k < CHAIN_DEPTH; k++) {
+        c->w[k] = rtka_grad_node_create(copy_tensor(ws[k]), true);
+        switch (chain_op(k)) {
+            case GRAD_OP_AND: h = rtka_grad_and(h, c->w[k]); break;
+            case GRAD_OP_OR:  h = rtka_grad_or(h, c->w[k]); break;
+            default:          h = rtka_grad_not(h); break;
+        }
+        c->h[k] = h;
+    }
+}
+
+static void chain_free(chain_t* c) {
+    for (uint32_t k = 0; k < CHAIN_DEPTH; k++) {
+        rtka_grad_node_free(c->h[k]);
+        rtka_grad_node_free(c->w[k]);
+    }
+    rtka_grad_node_free(c->x);
+}
+
+/* Scalar reverse chain rule per element, from the kept activations */
+static void chain_reference(const chain_t* c, float* gx, float* gw) {
+    for (uint32_t i = 0; i < CHAIN_SIZE; i++) {
+        float g = 1.0f;
+        for (int32_t k = (int32_t)CHAIN_DEPTH - 1; k >= 0; k--) {
+            rtka_state_t in = k ? c->h[k - 1]->data->data[i] : c->x->data->data[i];
+            rtka_state_t w = c->w[k]->data->data[i];
+            float* gwk = &gw[(uint32_t)k * CHAIN_SIZE + i];
+            switch (chain_op((uint32_t)k)) {
+                case GRAD_OP_AND:
+                    *gwk = rtka_grad_and_wrt_b(in, w, g);
+                    g = rtka_grad_and_wrt_a(in, w, g);
+                    break;
+                case GRAD_OP_OR:
+                    *gwk = rtka_grad_or_wrt_a(w, in, g);
+                    g = rtka_grad_or_wrt_a(in, w, g);
+                    break;
+                default:
+                    *gwk = 0.0f;
+                    break;
+            }
+        }
+        gx[i] = g;
+    }
+}
+
+static bool chain_matches(const chain_t* c, const float* gx, const float* gw) {
+    for (uint32_t i = 0; i < CHAIN_SIZE; i++) {
+        if (!close_to(c->x->grad->data[i].confidence, gx[i])) return false;
+        for (uint32_t k = 0; k < CHAIN_DEPTH; k++) {
+            if (!close_to(c->w[k]->grad->data[i].confidence, gw[k * CHAIN_SIZE + i])) return false;
+        }
+    }
+    return true;
+}
+
+static bool check_chain(void) {
+    uint32_t shape[] = {CHAIN_SIZE};
+    rtka_tensor_t* xs = random_tensor(shape, 1);
+    rtka_tensor_t* ws[CHAIN_DEPTH];
+    for (uint32_t k = 0; k < CHAIN_DEPTH; k++) ws[k] = random_tensor(shape, 1);
+
+    float* gx = (float*)malloc(CHAIN_SIZE * sizeof(float));
+    float* gw = (float*)malloc(CHAIN_DEPTH * CHAIN_SIZE * sizeof(float));
+    rtka_grad_tape_t* tape = rtka_grad_tape_create();
+
+    /* Step 1: activations kept, so the reference can read them */
+    chain_t c;
+    rtka_grad_tape_begin(tape);
+    chain_forward(&c, xs, ws);
+    rtka_grad_backward(c.h[CHAIN_DEPTH - 1]);
+    rtka_grad_tape_end(tape);
+
+    chain_reference(&c, gx, gw);
+    bool ok = report("chain grads", chain_matches(&c, gx, gw));
+
+    bool intermediates_returned = true;
+    for (uint32_t k = 0; k + 1 < CHAIN_DEPTH; k++) {
+        intermediates_returned = intermediates_returned && !c.h[k]->grad;
+    }
+    size_t one = (size_t)CHAIN_SIZE * sizeof(rtka_state_t);
+    ok &= report("chain pool", intermediates_returned && tape->buffer_count <= 3 &&
+                               tape->peak_grad_bytes <= 3 * one);
+    printf("  depth %u: %u pooled buffers, peak %zu KB (one per node: %zu KB)\n",
+           CHAIN_DEPTH, tape->buffer_count, tape->peak_grad_bytes / 1024,
+           (size_t)CHAIN_DEPTH * one / 1024);
+    chain_free(&c);
+
+    /* Step 2: same tape, activations released as the sweep passes them */
+    uint32_t buffers = tape->buffer_count;
+    tape->release_activations = true;
+    rtka_grad_tape_begin(tape);
+    chain_forward(&c, xs, ws);
+    rtka_grad_backward(c.h[CHAIN_DEPTH - 1]);
+    rtka_grad_tape_end(tape);
+
+    bool released = true;
+    for (uint32_t k = 0; k + 1 < CHAIN_DEPTH; k++) released = released && !c.h[k]->data;
+    ok &= report("chain release", chain_matches(&c, gx, gw) && released &&
+                                  c.h[CHAIN_DEPTH - 1]->data && tape->buffer_count == buffers);
+    chain_free(&c);
+
+    rtka_grad_tape_free(tape);
+    free(gx);
+    free(gw);
+    rtka_tensor_free(xs);
+    for (uint32_t k = 0; k < CHAIN_DEPTH; k++) rtka_tensor_free(ws[k]);
+    return ok;
+}
+
+static float signed_at(const rtka_tensor_t* t, uint32_t i) {
+    return (float)t->data[i].value * t->data[i].confidence;
+}
+
+/* y = (x W1) W2: dW2 = h^T G, dh = G W2^T, dW1 = x^T dh with G = 1 */
+static bool check_matmul(void) {
+    const uint32_t m = 5, k = 7, j = 6, n = 4;
+    uint32_t xs_shape[] = {m, k}, w1_shape[] = {k, j}, w2_shape[] = {j, n};
+
+    rtka_grad_tape_t* tape = rtka_grad_tape_create();
+    rtka_grad_tape_begin(tape);
+    rtka_grad_node_t* x = rtka_grad_node_create(random_tensor(xs_shape, 2), false);
+    rtka_grad_node_t* w1 = rtka_grad_node_create(random_tensor(w1_shape, 2), true);
+    rtka_grad_node_t* w2 = rtka_grad_node_create(random_tensor(w2_shape, 2), true);
+    rtka_grad_node_t* h = rtka_grad_matmul(x, w1);
+    rtka_grad_node_t* y = rtka_grad_matmul(h, w2);
+    rtka_grad_backward(y);
+    rtka_grad_tape_end(tape);
+
+    bool ok = y->grad && !h->grad && !x->grad;
+    for (uint32_t p = 0; ok && p < j; p++) {
+        for (uint32_t q = 0; q < n; q++) {
+            float ref = 0.0f;
+            for (uint32_t r = 0; r < m; r++) ref += signed_at(h->data, r * j + p);
+            ok = ok && close_to(w2->grad->data[p * n + q].confidence, ref);
+        }
+    }
+    for (uint32_t p = 0; ok && p < k; p++) {
+        for (uint32_t q = 0; q < j; q++) {
+            float dh = 0.0f;
+            for (uint32_t r = 0; r < n; r++) dh += signed_at(w2->data, q * n + r);
+            float ref = 0.0f;
+            for (uint32_t r = 0; r < m; r++) ref += signed_at(x->data, r * k + p) * dh;
+            ok = ok && close_to(w1->grad->data[p * j + q].confidence, ref);
+        }
+    }
+    ok = report("matmul grads", ok);
+
+    rtka_grad_node_free(y);
+    rtka_grad_node_free(h);
+    rtka_grad_node_free(w2);
+    rtka_grad_node_free(w1);
+    rtka_grad_node_free(x);
+    rtka_grad_tape_free(tape);
+    return ok;
+}
+
+int main(void) {
+    printf("RTKA Tape Autograd Test\n");
+    printf("=======================\n\n");
+
+    srand(7);
+    bool ok = check_chain();
+    ok &= check_matmul();
+
+    printf("\n%s\n", ok ? "Tape gradients match" : "Mismatch detected");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1156 @@
+/**
+ * File: test_graph.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Graph: CSR construction and ternary PageRank
+ *
+ * The parallel builder is checked against sorted unique edge pairs and
+ * across thread counts, the binary file by a round trip. The pull sweep is
+ * checked against the original all-pairs iteration, the delta mode against
+ * the pull fixed point, then both run to convergence on a large skewed
+ * random graph (vertex count from argv[1], default 10^6). The CSR Markov
+ * step is checked against the original dense matrix, the batched mode
+ * against single steps, and both are timed on the large graph. BFS,
+ * delta-stepping and confidence propagation are checked against queue,
+ * heap and level-by-level references and timed against the first two.
+ * Push-relabel is checked against Edmonds-Karp and its own minimum cut,
+ * Louvain against planted communities and a direct modularity.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_graph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define SMALL_VERTICES   1500U
+#define SMALL_EDGES      12000U
+#define SMALL_ITERATIONS 25U
+#define AVERAGE_DEGREE   8U
+#define POOL_THREADS     3U
+#define BUILD_VERTICES   20000U
+#define BUILD_EDGES      400000U
+#define GRAPH_FILE       "build/test_graph.rgf"
+#define MARKOV_VERTICES  400U
+#define MARKOV_STEPS     10U
+#define MARKOV_VECTORS   16U
+#define TRAVERSE_VERTICES 50000U
+#define PROPAGATE_DEPTH  4U
+#define FLOW_VERTICES    2000U
+#define GROUPS           40U
+#define GROUP_SIZE       250U
+#define GROUP_DEGREE     10U
+#define FLOW_TERMINAL_EDGES 1000U
+#define FLOW_BENCH_VERTICES 20000U   /* Edmonds-Karp grows with the flow graph */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 16);
+}
+
+/* A quarter of the edges land on the first 1% of vertices, so the in-degree
+ * is skewed; self loops and repeated edges occur */
+static void random_edges(uint32_t vertices, uint32_t edges, uint32_t* from, uint32_t* to) {
+    uint32_t hubs = vertices / 100U ? vertices / 100U : 1U;
+    for (uint32_t e = 0; e < edges; e++) {
+        from[e] = next_random() % vertices;
+        to[e] = next_random() % 4U == 0U ? next_random() % hubs : next_random() % vertices;
+    }
+}
+
+static rtka_graph_sparse_t* random_graph(uint32_t vertices, uint32_t edges) {
+    uint32_t* from = malloc((size_t)edges * sizeof(uint32_t));
+    uint32_t* to = malloc((size_t)edges * sizeof(uint32_t));
+    rtka_graph_sparse_t* graph = NULL;
+    if (from && to) {
+        random_edges(vertices, edges, from, to);
+        graph = rtka_graph_create_csr(vertices, edges, from, to, NULL);
+    }
+    free(from);
+    free(to);
+    return graph;
+}
+
+static bool same_graph(const rtka_graph_sparse_t* a, const rtka_graph_sparse_t* b) {
+    if (a->num_vertices != b->num_vertices || a->num_edges != b->num_edges) return false;
+    if ((a->edge_weights == NULL) != (b->edge_weights == NULL)) return false;
+    size_t n = a->num_vertices, m = a->num_edges;
+    return memcmp(a->adjacency_list, b->adjacency_list, (n + 1) * sizeof(uint32_t)) == 0 &&
+           memcmp(a->degree, b->degree, n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->edge_indices, b->edge_indices, m * sizeof(uint32_t)) == 0 &&
+           (!a->edge_weights || memcmp(a->edge_weights, b->edge_weights, m * sizeof(rtka_state_t)) == 0);
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* The original O(V^2 + E) iteration */
+static void reference_iterate(rtka_state_t* ranks, rtka_confidence_t* importance,
+                              const rtka_graph_sparse_t* graph) {
+    uint32_t n = graph->num_vertices;
+    rtka_confidence_t damping = 0.85f;
+    rtka_confidence_t teleport = (1.0f - damping) / n;
+    rtka_state_t* new_ranks = malloc(n * sizeof(rtka_state_t));
+    rtka_confidence_t* new_importance = malloc(n * sizeof(rtka_confidence_t));
+
+    for (uint32_t v = 0; v < n; v++) {
+        rtka_state_t rank_sum = rtka_make_state(RTKA_FALSE, 0.0f);
+        rtka_confidence_t importance_sum = 0.0f;
+        for (uint32_t u = 0; u < n; u++) {
+            if (u == v) continue;
+            for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1]; e++) {
+                if (graph->edge_indices[e] == v) {
+                    rtka_state_t contribution = ranks[u];
+                    contribution.confidence /= graph->degree[u];
+                    rank_sum = rtka_combine_or(rank_sum, contribution);
+                    importance_sum += importance[u] / graph->degree[u];
+                    break;
+                }
+            }
+        }
+        new_ranks[v].confidence = damping * rank_sum.confidence + teleport;
+        new_importance[v] = damping * importance_sum + teleport;
+        if (new_ranks[v].confidence > 0.66f) {
+            new_ranks[v].value = RTKA_TRUE;
+        } else if (new_ranks[v].confidence < 0.33f) {
+            new_ranks[v].value = RTKA_FALSE;
+        } else {
+            new_ranks[v].value = RTKA_UNKNOWN;
+        }
+    }
+
+    memcpy(ranks, new_ranks, n * sizeof(rtka_state_t));
+    memcpy(importance, new_importance, n * sizeof(rtka_confidence_t));
+    free(new_ranks);
+    free(new_importance);
+}
+
+static bool check_builder(void) {
+    printf("\n--- CSR construction ---\n");
+    const uint32_t from[] = {0, 1, 0, 2, 0, 1, 3};
+    const uint32_t to[]   = {1, 2, 2, 0, 1, 1, 3};
+    rtka_state_t weights[7];
+    for (uint32_t e = 0; e < 7; e++) weights[e] = rtka_make_state(RTKA_TRUE, 0.1f * (float)(e + 1));
+    rtka_graph_sparse_t* graph = rtka_graph_create_csr(4, 7, from, to, weights);
+    bool ok = graph != NULL;
+    if (ok) {
+        /* 0->1 repeated once: six edges, rows sorted, the first weight kept */
+        const uint32_t offsets[] = {0, 2, 4, 5, 6};
+        const uint32_t targets[] = {1, 2, 1, 2, 0, 3};
+        ok = graph->num_edges == 6 &&
+             memcmp(graph->adjacency_list, offsets, sizeof(offsets)) == 0 &&
+             memcmp(graph->edge_indices, targets, sizeof(targets)) == 0 &&
+             graph->degree[0] == 2 && graph->degree[3] == 1 &&
+             graph->edge_weights[0].confidence == weights[0].confidence &&
+             graph->edge_weights[2].confidence == weights[5].confidence;
+
+        rtka_graph_add_edge_weighted(graph, 1, 3, rtka_make_state(RTKA_UNKNOWN, 0.5f));
+        rtka_graph_add_edge_weighted(graph, 0, 2, rtka_make_state(RTKA_FALSE, 0.25f));
+        rtka_graph_add_edge_weighted(graph, 7, 0, rtka_make_state(RTKA_TRUE, 1.0f));
+        const uint32_t grown[] = {0, 2, 5, 6, 7};
+        ok = ok && graph->num_edges == 7 && graph->degree[1] == 3 &&
+             memcmp(graph->adjacency_list, grown, sizeof(grown)) == 0 &&
+             graph->edge_indices[4] == 3 &&
+             graph->edge_weights[4].value == RTKA_UNKNOWN &&
+             graph->edge_weights[1].value == RTKA_FALSE &&
+             graph->edge_weights[0].value == RTKA_TRUE;
+    }
+    const uint32_t bad_to[] = {1, 4};
+    ok = ok && rtka_graph_create_csr(4, 2, from, bad_to, NULL) == NULL;
+    printf("  dedupe, insertion, weight update: %s\n", ok ? "OK" : "FAILED");
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* Sorted unique (from, to) pairs are the rows, whatever the pool size */
+static bool check_parallel_build(void) {
+    uint32_t* from = malloc(BUILD_EDGES * sizeof(uint32_t));
+    uint32_t* to = malloc(BUILD_EDGES * sizeof(uint32_t));
+    uint64_t* pairs = malloc(BUILD_EDGES * sizeof(uint64_t));
+    rtka_state_t* weights = malloc(BUILD_EDGES * sizeof(rtka_state_t));
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    if (!from || !to || !pairs || !weights || !pool) {
+        free(from);
+        free(to);
+        free(pairs);
+        free(weights);
+        rtka_pool_destroy(pool);
+        return false;
+    }
+    random_edges(BUILD_VERTICES, BUILD_EDGES, from, to);
+    for (uint32_t e = 0; e < BUILD_EDGES; e++) {
+        pairs[e] = (uint64_t)from[e] << 32 | to[e];
+        weights[e] = rtka_make_state(RTKA_TRUE, (float)e);
+    }
+    qsort(pairs, BUILD_EDGES, sizeof(uint64_t), compare_u64);
+    uint32_t unique = 0;
+    for (uint32_t e = 0; e < BUILD_EDGES; e++) {
+        if (e == 0 || pairs[e] != pairs[unique - 1]) pairs[unique++] = pairs[e];
+    }
+
+    double t0 = now_seconds();
+    rtka_graph_sparse_t* threaded = rtka_graph_build_csr(BUILD_VERTICES, BUILD_EDGES, from, to, weights, pool);
+    double threaded_s = now_seconds() - t0;
+    rtka_graph_sparse_t* fallback = rtka_graph_build_csr(BUILD_VERTICES, BUILD_EDGES, from, to, weights, NULL);
+    bool ok = threaded && fallback && threaded->num_edges == unique && same_graph(threaded, fallback);
+    for (uint32_t u = 0; ok && u < BUILD_VERTICES; u++) {
+        for (uint32_t e = threaded->adjacency_list[u]; ok && e < threaded->adjacency_list[u + 1]; e++) {
+            ok = pairs[e] == ((uint64_t)u << 32 | threaded->edge_indices[e]);
+        }
+    }
+    /* Weight of each kept edge: the first occurrence in input order */
+    for (uint32_t e = 0; ok && e < BUILD_EDGES; e++) {
+        uint32_t u = from[e];
+        for (uint32_t k = threaded->adjacency_list[u]; k < threaded->adjacency_list[u + 1]; k++) {
+            if (threaded->edge_indices[k] == to[e]) {
+                ok = threaded->edge_weights[k].confidence <= (float)e;
+                break;
+            }
+        }
+    }
+    printf("  %u edges on %u + 1 threads: %u unique, rows match sorted pairs, same as default pool (%.3f s)  %s\n",
+           BUILD_EDGES, POOL_THREADS, unique, threaded_s, ok ? "OK" : "FAILED");
+
+    rtka_graph_free_sparse(threaded);
+    rtka_graph_free_sparse(fallback);
+    rtka_pool_destroy(pool);
+    free(from);
+    free(to);
+    free(pairs);
+    free(weights);
+    return ok;
+}
+
+static bool check_file(void) {
+    rtka_graph_sparse_t* graph = random_graph(BUILD_VERTICES, BUILD_EDGES / 4U);
+    if (!graph) return false;
+    rtka_graph_add_edge_weighted(graph, 0, 1, rtka_make_state(RTKA_UNKNOWN, 0.5f));
+
+    rtka_graph_sparse_t* loaded = NULL;
+    bool ok = rtka_graph_save(graph, GRAPH_FILE) == RTKA_SUCCESS &&
+              rtka_graph_load(&loaded, GRAPH_FILE) == RTKA_SUCCESS &&
+              loaded->map != NULL && same_graph(graph, loaded);
+
+    /* Same ranks from the mapping, then an insertion copies the edges out */
+    if (ok) {
+        rtka_pagerank_t* a = rtka_pagerank_init(graph);
+        rtka_pagerank_t* b = rtka_pagerank_init(loaded);
+        ok = a && b;
+        for (uint32_t it = 0; ok && it < 5; it++) {
+            rtka_pagerank_iterate(a, graph);
+            rtka_pagerank_iterate(b, loaded);
+        }
+        ok = ok && memcmp(a->importance, b->importance, BUILD_VERTICES * sizeof(rtka_confidence_t)) == 0;
+        rtka_pagerank_free(a);
+        rtka_pagerank_free(b);
+
+        rtka_graph_add_edge_weighted(graph, 7, 3, rtka_make_state(RTKA_FALSE, 0.2f));
+        rtka_graph_add_edge_weighted(loaded, 7, 3, rtka_make_state(RTKA_FALSE, 0.2f));
+        ok = ok && same_graph(graph, loaded);
+    }
+    rtka_graph_free_sparse(loaded);
+    loaded = NULL;
+
+    /* The file itself is untouched by the insertion */
+    ok = ok && rtka_graph_load(&loaded, GRAPH_FILE) == RTKA_SUCCESS &&
+         loaded->num_edges + 1 == graph->num_edges;
+    rtka_graph_free_sparse(loaded);
+    loaded = NULL;
+
+    FILE* f = fopen(GRAPH_FILE, "r+b");
+    if (f) {
+        fputc('X', f);
+        fclose(f);
+    }
+    ok = ok && rtka_graph_load(&loaded, GRAPH_FILE) == RTKA_ERROR_INVALID_VALUE && loaded == NULL;
+    ok = ok && rtka_graph_load(&loaded, "build/no_such.rgf") == RTKA_ERROR_INVALID_VALUE;
+    remove(GRAPH_FILE);
+
+    printf("  save / load round trip, copy-on-write insertion, bad magic: %s\n", ok ? "OK" : "FAILED");
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+static bool check_reference(rtka_simd_level_t level) {
+    if (!rtka_pagerank_set_kernel(level)) {
+        printf("  %-6s kernel not available\n", rtka_simd_level_name(level));
+        return true;
+    }
+    rtka_graph_sparse_t* graph = random_graph(SMALL_VERTICES, SMALL_EDGES);
+    rtka_pagerank_t* pr = graph ? rtka_pagerank_init(graph) : NULL;
+    if (!pr) {
+        rtka_graph_free_sparse(graph);
+        return false;
+    }
+    uint32_t n = graph->num_vertices;
+    rtka_state_t* ranks = malloc(n * sizeof(rtka_state_t));
+    rtka_confidence_t* importance = malloc(n * sizeof(rtka_confidence_t));
+    memcpy(ranks, pr->ranks, n * sizeof(rtka_state_t));
+    memcpy(importance, pr->importance, n * sizeof(rtka_confidence_t));
+
+    double worst = 0.0;
+    uint32_t value_mismatches = 0;
+    for (uint32_t it = 0; it < SMALL_ITERATIONS; it++) {
+        rtka_pagerank_iterate(pr, graph);
+        reference_iterate(ranks, importance, graph);
+        for (uint32_t v = 0; v < n; v++) {
+            double di = fabs(pr->importance[v] - importance[v]) / importance[v];
+            double dr = fabs(pr->ranks[v].confidence - ranks[v].confidence) / ranks[v].confidence;
+            if (di > worst) worst = di;
+            if (dr > worst) worst = dr;
+            if (pr->ranks[v].value != ranks[v].value) value_mismatches++;
+        }
+    }
+    bool ok = worst < 1e-4 && value_mismatches == 0;
+    printf("  %-6s %u iterations vs all-pairs: max relative error %.2e, value mismatches %u  %s\n",
+           rtka_simd_level_name(level), SMALL_ITERATIONS, worst, value_mismatches, ok ? "OK" : "FAILED");
+
+    free(ranks);
+    free(importance);
+    rtka_pagerank_free(pr);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* Iterates to convergence; returns seconds, or a negative value on failure */
+static double run_to_convergence(rtka_pagerank_t* pr, rtka_graph_sparse_t* graph, uint32_t max_iterations) {
+    double start = now_seconds();
+    do {
+        rtka_pagerank_iterate(pr, graph);
+        if (!pr->work) return -1.0;
+    } while (!rtka_pagerank_converged(pr) && pr->iterations < max_iterations);
+    return rtka_pagerank_converged(pr) ? now_seconds() - start : -1.0;
+}
+
+static bool check_delta(void) {
+    rtka_graph_sparse_t* graph = random_graph(50000, 50000U * AVERAGE_DEGREE);
+    rtka_pagerank_t* pull = graph ? rtka_pagerank_init(graph) : NULL;
+    rtka_pagerank_t* delta = graph ? rtka_pagerank_init(graph) : NULL;
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    bool ok = pull && delta && pool;
+    if (ok) {
+        pull->convergence_threshold = 1e-6f;
+        delta->convergence_threshold = 1e-4f;
+        delta->mode = RTKA_PAGERANK_DELTA;
+        delta->pool = pool;
+        ok = run_to_convergence(pull, graph, 200) >= 0.0 && run_to_convergence(delta, graph, 200) >= 0.0;
+    }
+    double l1 = 0.0, worst = 0.0;
+    if (ok) {
+        for (uint32_t v = 0; v < graph->num_vertices; v++) {
+            l1 += fabs(pull->importance[v] - delta->importance[v]);
+            double dr = fabs(pull->ranks[v].confidence - delta->ranks[v].confidence);
+            if (dr > worst) worst = dr;
+        }
+        ok = l1 < 1e-3 && worst < 1e-5;
+    }
+    printf("  delta (%u threads) vs pull fixed point: importance L1 %.2e, rank confidence max %.2e  %s\n",
+           POOL_THREADS, l1, worst, ok ? "OK" : "FAILED");
+    rtka_pagerank_free(pull);
+    rtka_pagerank_free(delta);
+    rtka_pool_destroy(pool);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* The original dense transition matrix and vector x matrix step */
+static rtka_state_t* reference_markov(const rtka_graph_sparse_t* graph) {
+    uint32_t n = graph->num_vertices;
+    rtka_state_t* m = malloc((size_t)n * n * sizeof(rtka_state_t));
+    if (!m) return NULL;
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            m[(size_t)i * n + j] = i == j ? rtka_make_state(RTKA_UNKNOWN, 0.1f) : rtka_make_state(RTKA_FALSE, 0.0f);
+        }
+        uint32_t start = graph->adjacency_list[i], end = graph->adjacency_list[i + 1];
+        if (end == start) continue;
+        rtka_confidence_t prob = 1.0f / (end - start);
+        for (uint32_t e = start; e < end; e++) {
+            rtka_state_t* w = &m[(size_t)i * n + graph->edge_indices[e]];
+            *w = graph->edge_weights ? graph->edge_weights[e] : rtka_make_state(RTKA_TRUE, prob);
+            w->confidence *= prob;
+        }
+    }
+    return m;
+}
+
+static void reference_markov_step(const rtka_state_t* current, const rtka_state_t* m, uint32_t n,
+                                  rtka_state_t* next) {
+    for (uint32_t j = 0; j < n; j++) {
+        rtka_state_t new_state = rtka_make_state(RTKA_FALSE, 0.0f);
+        for (uint32_t i = 0; i < n; i++) {
+            new_state = rtka_combine_or(new_state, rtka_combine_and(current[i], m[(size_t)i * n + j]));
+        }
+        new_state.confidence = 0.85f * new_state.confidence + 0.15f / n;
+        if (new_state.confidence > 0.66f) {
+            new_state.value = RTKA_TRUE;
+        } else if (new_state.confidence < 0.33f) {
+            new_state.value = RTKA_FALSE;
+        } else {
+            new_state.value = RTKA_UNKNOWN;
+        }
+        next[j] = new_state;
+    }
+}
+
+static void random_distribution(rtka_state_t* states, uint32_t n, uint32_t stride) {
+    for (uint32_t i = 0; i < n; i++) {
+        states[(size_t)i * stride] = rtka_make_state(RTKA_UNKNOWN, (float)(next_random() % 1000U) / 1000.0f);
+    }
+}
+
+static bool check_markov(void) {
+    printf("\n--- Markov chain ---\n");
+    rtka_graph_sparse_t* graph = random_graph(MARKOV_VERTICES, MARKOV_VERTICES * AVERAGE_DEGREE);
+    if (graph) rtka_graph_add_edge_weighted(graph, 7, 7, rtka_make_state(RTKA_TRUE, 0.5f));
+    rtka_transition_matrix_t* tm = graph ? rtka_markov_from_graph(graph) : NULL;
+    rtka_state_t* dense = graph ? reference_markov(graph) : NULL;
+    uint32_t n = MARKOV_VERTICES, vectors = MARKOV_VECTORS;
+    rtka_state_t* a = malloc(n * sizeof(rtka_state_t));
+    rtka_state_t* b = malloc(n * sizeof(rtka_state_t));
+    rtka_state_t* c = malloc(n * sizeof(rtka_state_t));
+    rtka_state_t* d = malloc(n * sizeof(rtka_state_t));
+    rtka_state_t* batch = malloc((size_t)n * vectors * sizeof(rtka_state_t));
+    rtka_state_t* single = malloc((size_t)n * vectors * sizeof(rtka_state_t));
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    bool ok = tm && dense && a && b && c && d && batch && single && pool;
+
+    /* CSR step against the dense product */
+    double worst = 0.0;
+    uint32_t value_mismatches = 0;
+    if (ok) {
+        random_distribution(a, n, 1);
+        memcpy(c, a, n * sizeof(rtka_state_t));
+        for (uint32_t s = 0; s < MARKOV_STEPS; s++) {
+            rtka_markov_step(a, tm, b);
+            reference_markov_step(c, dense, n, d);
+            memcpy(a, b, n * sizeof(rtka_state_t));
+            memcpy(c, d, n * sizeof(rtka_state_t));
+            for (uint32_t i = 0; i < n; i++) {
+                double dr = fabs(a[i].confidence - c[i].confidence) / c[i].confidence;
+                if (dr > worst) worst = dr;
+                if (a[i].value != c[i].value) value_mismatches++;
+            }
+        }
+        uint32_t self_loops = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint32_t e = graph->adjacency_list[i]; e < graph->adjacency_list[i + 1]; e++) {
+                self_loops += graph->edge_indices[e] == i;
+            }
+        }
+        ok = worst < 1e-5 && value_mismatches == 0 && tm->nnz == graph->num_edges + n - self_loops;
+    }
+    printf("  CSR step, %u steps vs dense: max relative error %.2e, value mismatches %u  %s\n",
+           MARKOV_STEPS, worst, value_mismatches, ok ? "OK" : "FAILED");
+
+    /* Many distributions at once against one at a time */
+    double batch_error = INFINITY;
+    if (ok) {
+        for (uint32_t v = 0; v < vectors; v++) random_distribution(batch + v, n, vectors);
+        memcpy(single, batch, (size_t)n * vectors * sizeof(rtka_state_t));
+        ok = rtka_markov_propagate(tm, batch, vectors, MARKOV_STEPS, pool) == RTKA_SUCCESS;
+        batch_error = 0.0;
+        for (uint32_t v = 0; ok && v < vectors; v++) {
+            for (uint32_t i = 0; i < n; i++) a[i] = single[(size_t)i * vectors + v];
+            for (uint32_t s = 0; s < MARKOV_STEPS; s++) {
+                rtka_markov_step(a, tm, b);
+                memcpy(a, b, n * sizeof(rtka_state_t));
+            }
+            for (uint32_t i = 0; i < n; i++) {
+                const rtka_state_t* x = &batch[(size_t)i * vectors + v];
+                batch_error = fmax(batch_error, fabs(x->confidence - a[i].confidence));
+                if (x->value != a[i].value) batch_error = INFINITY;
+            }
+        }
+        ok &= batch_error < 1e-6;
+    }
+    bool refused = tm && rtka_markov_propagate(tm, batch, 0, 1, pool) == RTKA_ERROR_INVALID_VALUE &&
+                   rtka_markov_propagate(NULL, batch, 1, 1, pool) == RTKA_ERROR_NULL_POINTER;
+    ok &= refused;
+    printf("  %u distributions x %u steps, %u threads, vs single steps: max error %.2e, bad arguments refused %s  %s\n",
+           vectors, MARKOV_STEPS, POOL_THREADS, batch_error, refused ? "yes" : "no", ok ? "OK" : "FAILED");
+
+    /* The steady state is a fixed point of the step */
+    rtka_state_t* steady = ok ? rtka_markov_steady_state(tm) : NULL;
+    double fixed = INFINITY;
+    if (steady) {
+        rtka_markov_step(steady, tm, b);
+        fixed = 0.0;
+        for (uint32_t i = 0; i < n; i++) fixed = fmax(fixed, fabs(b[i].confidence - steady[i].confidence));
+    }
+    ok &= fixed < 1e-5;
+    printf("  steady state moves %.2e under one more step  %s\n", fixed, ok ? "OK" : "FAILED");
+
+    free(steady);
+    free(a);
+    free(b);
+    free(c);
+    free(d);
+    free(batch);
+    free(single);
+    free(dense);
+    rtka_pool_destroy(pool);
+    rtka_markov_free(tm);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* Steps a random distribution over the large graph one vector at a time and
+ * MARKOV_VECTORS at once */
+static bool benchmark_markov(rtka_graph_sparse_t* graph) {
+    double t0 = now_seconds();
+    rtka_transition_matrix_t* tm = rtka_markov_from_graph(graph);
+    double build_s = now_seconds() - t0;
+    uint32_t n = graph->num_vertices, vectors = MARKOV_VECTORS;
+    rtka_state_t* a = malloc((size_t)n * sizeof(rtka_state_t));
+    rtka_state_t* b = malloc((size_t)n * sizeof(rtka_state_t));
+    rtka_state_t* batch = malloc((size_t)n * vectors * sizeof(rtka_state_t));
+    bool ok = tm && a && b && batch;
+    if (ok) {
+        random_distribution(a, n, 1);
+        for (uint32_t v = 0; v < vectors; v++) random_distribution(batch + v, n, vectors);
+
+        t0 = now_seconds();
+        for (uint32_t s = 0; s < MARKOV_STEPS; s++) {
+            rtka_markov_step(s % 2U ? b : a, tm, s % 2U ? a : b);
+        }
+        double step_s = (now_seconds() - t0) / MARKOV_STEPS;
+        t0 = now_seconds();
+        ok = rtka_markov_propagate(tm, batch, vectors, MARKOV_STEPS, NULL) == RTKA_SUCCESS;
+        double batch_s = (now_seconds() - t0) / MARKOV_STEPS;
+        printf("  markov: CSR %.2f s, %u transitions; step %.2f ms (%.1f M transitions/s), "
+               "%u distributions %.2f ms per step (%.1f M transitions/s)\n",
+               build_s, tm->nnz, step_s * 1e3, tm->nnz / step_s / 1e6, vectors, batch_s * 1e3,
+               (double)tm->nnz * vectors / batch_s / 1e6);
+    }
+    free(a);
+    free(b);
+    free(batch);
+    rtka_markov_free(tm);
+    return ok;
+}
+
+/* Queue BFS, as rtka_graph_bfs_ternary was written */
+static uint32_t reference_bfs(const rtka_graph_sparse_t* graph, uint32_t source, uint32_t* depth, uint32_t* queue) {
+    for (uint32_t v = 0; v < graph->num_vertices; v++) depth[v] = RTKA_GRAPH_UNREACHED;
+    uint32_t head = 0, tail = 0;
+    depth[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        uint32_t v = queue[head++];
+        for (uint32_t e = graph->adjacency_list[v]; e < graph->adjacency_list[v + 1]; e++) {
+            uint32_t u = graph->edge_indices[e];
+            if (depth[u] == RTKA_GRAPH_UNREACHED) {
+                depth[u] = depth[v] + 1U;
+                queue[tail++] = u;
+            }
+        }
+    }
+    return tail;
+}
+
+/* Binary-heap Dijkstra with lazy deletion */
+typedef struct {
+    float dist;
+    uint32_t vertex;
+} heap_entry_t;
+
+static void heap_push(heap_entry_t* heap, size_t* size, heap_entry_t x) {
+    size_t i = (*size)++;
+    while (i && heap[(i - 1) / 2].dist > x.dist) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = x;
+}
+
+static heap_entry_t heap_pop(heap_entry_t* heap, size_t* size) {
+    heap_entry_t top = heap[0], last = heap[--(*size)];
+    size_t i = 0;
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= *size) break;
+        if (c + 1 < *size && heap[c + 1].dist < heap[c].dist) c++;
+        if (heap[c].dist >= last.dist) break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    if (*size) heap[i] = last;
+    return top;
+}
+
+static bool reference_dijkstra(const rtka_graph_sparse_t* graph, uint32_t source, const float* lengths, float* dist) {
+    heap_entry_t* heap = malloc(((size_t)graph->num_edges + 1) * sizeof(heap_entry_t));
+    if (!heap) return false;
+    for (uint32_t v = 0; v < graph->num_vertices; v++) dist[v] = INFINITY;
+    size_t size = 0;
+    dist[source] = 0.0f;
+    heap_push(heap, &size, (heap_entry_t){0.0f, source});
+    while (size) {
+        heap_entry_t top = heap_pop(heap, &size);
+        if (top.dist > dist[top.vertex]) continue;
+        uint32_t v = top.vertex;
+        for (uint32_t e = graph->adjacency_list[v]; e < graph->adjacency_list[v + 1]; e++) {
+            uint32_t u = graph->edge_indices[e];
+            float nd = dist[v] + lengths[e];
+            if (nd < dist[u]) {
+                dist[u] = nd;
+                heap_push(heap, &size, (heap_entry_t){nd, u});
+            }
+        }
+    }
+    free(heap);
+    return true;
+}
+
+/* Every vertex first reached at level d ORs in its level d - 1 parents,
+ * taken in ascending order */
+static void reference_propagate(rtka_state_t* states, const rtka_graph_sparse_t* graph,
+                                uint32_t source, uint32_t max_depth, uint32_t* depth, uint32_t* queue) {
+    uint32_t reached = reference_bfs(graph, source, depth, queue);
+    uint32_t n = graph->num_vertices;
+    for (uint32_t d = 1; d <= max_depth; d++) {
+        float decay = powf(0.9f, (float)d);
+        for (uint32_t i = 0; i < reached; i++) {
+            uint32_t u = queue[i];
+            if (depth[u] != d) continue;
+            rtka_state_t acc = states[u];
+            for (uint32_t p = 0; p < n; p++) {
+                if (depth[p] != d - 1U || p == u) continue;
+                for (uint32_t e = graph->adjacency_list[p]; e < graph->adjacency_list[p + 1]; e++) {
+                    if (graph->edge_indices[e] != u) continue;
+                    rtka_state_t propagated = rtka_combine_and(states[p], graph->edge_weights[e]);
+                    propagated.confidence *= decay;
+                    acc = rtka_combine_or(acc, propagated);
+                }
+            }
+            states[u] = acc;
+        }
+    }
+}
+
+static void random_lengths(float* lengths, uint32_t edges) {
+    for (uint32_t e = 0; e < edges; e++) lengths[e] = 0.01f + (float)(next_random() % 1000U) / 100.0f;
+}
+
+static bool check_traversal(void) {
+    printf("\n--- Traversal ---\n");
+    rtka_graph_sparse_t* graph = random_graph(TRAVERSE_VERTICES, TRAVERSE_VERTICES * AVERAGE_DEGREE);
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    rtka_graph_traversal_t* t = rtka_graph_traversal_init(pool);
+    uint32_t n = TRAVERSE_VERTICES;
+    uint32_t* depth = malloc(n * sizeof(uint32_t));
+    uint32_t* expect = malloc(n * sizeof(uint32_t));
+    uint32_t* queue = malloc(n * sizeof(uint32_t));
+    float* lengths = graph ? malloc(((size_t)graph->num_edges + 1) * sizeof(float)) : NULL;
+    float* dist = malloc(n * sizeof(float));
+    float* ref = malloc(n * sizeof(float));
+    bool ok = graph && pool && t && depth && expect && queue && lengths && dist && ref;
+
+    /* BFS from a hub, an ordinary vertex, and cut off at depth 2 */
+    uint32_t mismatches = 0, bottom_up = 0;
+    const uint32_t sources[] = {0, n / 2U + 7U};
+    for (uint32_t i = 0; ok && i < 2; i++) {
+        reference_bfs(graph, sources[i], expect, queue);
+        ok = rtka_graph_bfs(t, graph, sources[i], RTKA_GRAPH_UNREACHED, depth) == RTKA_SUCCESS;
+        for (uint32_t v = 0; ok && v < n; v++) mismatches += depth[v] != expect[v];
+        bottom_up += t->bottom_up_levels;
+        ok = ok && rtka_graph_bfs(t, graph, sources[i], 2, depth) == RTKA_SUCCESS;
+        for (uint32_t v = 0; ok && v < n; v++) {
+            mismatches += depth[v] != (expect[v] <= 2U ? expect[v] : RTKA_GRAPH_UNREACHED);
+        }
+    }
+    bool refused = t && graph && rtka_graph_bfs(t, graph, n, RTKA_GRAPH_UNREACHED, depth) == RTKA_ERROR_INVALID_VALUE &&
+                   rtka_graph_sssp(t, graph, 0, NULL, 0.0f, NULL) == RTKA_ERROR_NULL_POINTER;
+    ok = ok && mismatches == 0 && bottom_up > 0 && refused;
+    printf("  BFS vs queue (%u threads): depth mismatches %u, bottom-up levels %u, bad arguments refused %s  %s\n",
+           POOL_THREADS, mismatches, bottom_up, refused ? "yes" : "no", ok ? "OK" : "FAILED");
+
+    /* Delta-stepping with random lengths at two widths, and unit lengths */
+    uint32_t sssp_mismatches = 0;
+    if (ok) {
+        random_lengths(lengths, graph->num_edges);
+        ok = reference_dijkstra(graph, sources[1], lengths, ref);
+        const float widths[] = {0.0f, 25.0f};
+        for (uint32_t w = 0; ok && w < 2; w++) {
+            ok = rtka_graph_sssp(t, graph, sources[1], lengths, widths[w], dist) == RTKA_SUCCESS;
+            for (uint32_t v = 0; ok && v < n; v++) sssp_mismatches += dist[v] != ref[v];
+        }
+        reference_bfs(graph, sources[1], expect, queue);
+        ok = ok && rtka_graph_sssp(t, graph, sources[1], NULL, 0.0f, dist) == RTKA_SUCCESS;
+        for (uint32_t v = 0; ok && v < n; v++) {
+            sssp_mismatches += expect[v] == RTKA_GRAPH_UNREACHED ? dist[v] != INFINITY : dist[v] != (float)expect[v];
+        }
+        ok = ok && sssp_mismatches == 0;
+    }
+    printf("  delta-stepping vs heap Dijkstra and BFS: distance mismatches %u  %s\n",
+           sssp_mismatches, ok ? "OK" : "FAILED");
+
+    /* Ternary wrappers: the queue BFS confidences, Dijkstra agreeing on an
+     * unweighted graph */
+    double worst = INFINITY;
+    rtka_state_t* bfs = ok ? rtka_graph_bfs_ternary(graph, sources[1]) : NULL;
+    rtka_state_t* best = ok ? rtka_graph_dijkstra_ternary(graph, sources[1]) : NULL;
+    if (bfs && best) {
+        worst = 0.0;
+        reference_bfs(graph, sources[1], expect, queue);
+        for (uint32_t v = 0; v < n; v++) {
+            float c = 1.0f;
+            for (uint32_t d = 0; expect[v] != RTKA_GRAPH_UNREACHED && d < expect[v]; d++) c *= 0.9f;
+            rtka_value_t value = expect[v] == RTKA_GRAPH_UNREACHED ? RTKA_UNKNOWN : RTKA_TRUE;
+            if (expect[v] == RTKA_GRAPH_UNREACHED) c = 0.0f;
+            if (bfs[v].value != value || bfs[v].confidence != c || best[v].value != value) worst = INFINITY;
+            if (c > 0.0f) worst = fmax(worst, fabs(best[v].confidence - c) / c);
+        }
+    }
+    ok = ok && worst < 1e-5;
+    printf("  ternary BFS exact, ternary Dijkstra max relative error %.2e  %s\n", worst, ok ? "OK" : "FAILED");
+    free(bfs);
+    free(best);
+
+    /* Confidence propagation on a small weighted graph */
+    uint32_t mismatched_states = 0;
+    rtka_graph_sparse_t* small = ok ? random_graph(2000, 2000U * AVERAGE_DEGREE) : NULL;
+    if (small) {
+        uint32_t sn = small->num_vertices;
+        small->edge_weights = malloc(((size_t)small->num_edges + 1) * sizeof(rtka_state_t));
+        rtka_state_t* states = malloc(sn * sizeof(rtka_state_t));
+        ok = small->edge_weights && states;
+        for (uint32_t e = 0; ok && e < small->num_edges; e++) {
+            rtka_value_t value = (rtka_value_t)((int)(next_random() % 3U) - 1);
+            small->edge_weights[e] = rtka_make_state(value, (float)(next_random() % 1000U) / 1000.0f);
+        }
+        for (uint32_t v = 0; ok && v < sn; v++) {
+            small->vertex_states[v] = rtka_make_state(RTKA_FALSE, (float)(next_random() % 100U) / 1000.0f);
+            states[v] = small->vertex_states[v];
+        }
+        if (ok) {
+            rtka_propagate_confidence(small, 3, PROPAGATE_DEPTH);
+            reference_propagate(states, small, 3, PROPAGATE_DEPTH, expect, queue);
+            for (uint32_t v = 0; v < sn; v++) {
+                mismatched_states += small->vertex_states[v].value != states[v].value ||
+                                     fabsf(small->vertex_states[v].confidence - states[v].confidence) > 1e-6f;
+            }
+            ok = mismatched_states == 0;
+        }
+        free(states);
+    }
+    ok = ok && small;
+    printf("  confidence propagation, depth %u, vs level-by-level: mismatched states %u  %s\n",
+           PROPAGATE_DEPTH, mismatched_states, ok ? "OK" : "FAILED");
+
+    rtka_graph_free_sparse(small);
+    free(depth);
+    free(expect);
+    free(queue);
+    free(lengths);
+    free(dist);
+    free(ref);
+    rtka_graph_traversal_free(t);
+    rtka_pool_destroy(pool);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* BFS and shortest paths from vertex 1 against the serial references */
+static bool benchmark_traversal(rtka_graph_sparse_t* graph) {
+    uint32_t n = graph->num_vertices, source = 1U % n;
+    rtka_graph_traversal_t* t = rtka_graph_traversal_init(NULL);
+    uint32_t* depth = malloc((size_t)n * sizeof(uint32_t));
+    uint32_t* queue = malloc((size_t)n * sizeof(uint32_t));
+    float* lengths = malloc(((size_t)graph->num_edges + 1) * sizeof(float));
+    float* dist = malloc((size_t)n * sizeof(float));
+    bool ok = t && depth && queue && lengths && dist;
+    if (ok) {
+        double t0 = now_seconds();
+        ok = rtka_graph_bfs(t, graph, source, RTKA_GRAPH_UNREACHED, depth) == RTKA_SUCCESS;
+        double first_s = now_seconds() - t0;
+        t0 = now_seconds();
+        ok = ok && rtka_graph_bfs(t, graph, source, RTKA_GRAPH_UNREACHED, depth) == RTKA_SUCCESS;
+        double bfs_s = now_seconds() - t0;
+        t0 = now_seconds();
+        uint32_t reached = reference_bfs(graph, source, depth, queue);
+        double queue_s = now_seconds() - t0;
+        printf("  BFS: %.1f ms (%.1f ms with transpose, %u levels, %u bottom-up), queue %.1f ms, %u reached\n",
+               bfs_s * 1e3, first_s * 1e3, t->levels, t->bottom_up_levels, queue_s * 1e3, reached);
+
+        random_lengths(lengths, graph->num_edges);
+        t0 = now_seconds();
+        ok = ok && rtka_graph_sssp(t, graph, source, lengths, 0.0f, dist) == RTKA_SUCCESS;
+        double sssp_s = now_seconds() - t0;
+        t0 = now_seconds();
+        ok = ok && reference_dijkstra(graph, source, lengths, dist);
+        double heap_s = now_seconds() - t0;
+        printf("  SSSP: delta-stepping %.1f ms, heap Dijkstra %.1f ms\n", sssp_s * 1e3, heap_s * 1e3);
+    }
+    free(depth);
+    free(queue);
+    free(lengths);
+    free(dist);
+    rtka_graph_traversal_free(t);
+    return ok;
+}
+
+/* Edmonds-Karp over its own residual arcs */
+static double reference_max_flow(const rtka_graph_sparse_t* graph, uint32_t source, uint32_t sink,
+                                 const float* capacities) {
+    uint32_t n = graph->num_vertices, m = graph->num_edges;
+    uint32_t* first = calloc((size_t)n + 1, sizeof(uint32_t));
+    uint32_t* head = malloc(2 * (size_t)m * sizeof(uint32_t) + 4);
+    double* cap = malloc(2 * (size_t)m * sizeof(double) + 8);
+    uint32_t* fill = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t* parent = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t* queue = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    double total = -1.0;
+    if (!first || !head || !cap || !fill || !parent || !queue) goto done;
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1]; e++) {
+            first[u + 1]++;
+            first[graph->edge_indices[e] + 1]++;
+        }
+    }
+    for (uint32_t v = 0; v < n; v++) first[v + 1] += first[v];
+    memcpy(fill, first, n * sizeof(uint32_t));
+    /* Arc a pairs with a ^ 1 when both ends are written in order: keep an
+     * explicit partner instead */
+    uint32_t* partner = malloc(2 * (size_t)m * sizeof(uint32_t) + 4);
+    if (!partner) goto done;
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            uint32_t a = fill[u]++, b = fill[v]++;
+            head[a] = v, cap[a] = u == v ? 0.0 : capacities[e], partner[a] = b;
+            head[b] = u, cap[b] = 0.0, partner[b] = a;
+        }
+    }
+    total = 0.0;
+    for (;;) {
+        for (uint32_t v = 0; v < n; v++) parent[v] = UINT32_MAX;
+        uint32_t qh = 0, qt = 0;
+        queue[qt++] = source;
+        parent[source] = UINT32_MAX - 1;
+        while (qh < qt && parent[sink] == UINT32_MAX) {
+            uint32_t v = queue[qh++];
+            for (uint32_t a = first[v]; a < first[v + 1]; a++) {
+                if (cap[a] > 0.0 && parent[head[a]] == UINT32_MAX) {
+                    parent[head[a]] = a;
+                    queue[qt++] = head[a];
+                }
+            }
+        }
+        if (parent[sink] == UINT32_MAX) break;
+        double push = INFINITY;
+        for (uint32_t v = sink; v != source; v = head[partner[parent[v]]]) push = fmin(push, cap[parent[v]]);
+        for (uint32_t v = sink; v != source; v = head[partner[parent[v]]]) {
+            cap[parent[v]] -= push;
+            cap[partner[parent[v]]] += push;
+        }
+        total += push;
+    }
+    free(partner);
+done:
+    free(first);
+    free(head);
+    free(cap);
+    free(fill);
+    free(parent);
+    free(queue);
+    return total;
+}
+
+static bool check_max_flow(void) {
+    printf("\n--- Maximum flow ---\n");
+    rtka_graph_sparse_t* graph = random_graph(FLOW_VERTICES, FLOW_VERTICES * AVERAGE_DEGREE);
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    float* caps = graph ? malloc(((size_t)graph->num_edges + 1) * sizeof(float)) : NULL;
+    uint8_t* side = malloc(FLOW_VERTICES);
+    bool ok = graph && pool && caps && side;
+    if (ok) random_lengths(caps, graph->num_edges);
+
+    /* Several pairs, hub sinks included */
+    const uint32_t pairs[][2] = {{5, 0}, {0, 7}, {123, 1999}, {17, 3}};
+    double worst = 0.0, cut_error = 0.0;
+    for (uint32_t p = 0; ok && p < 4; p++) {
+        double value = -1.0;
+        ok = rtka_graph_max_flow_value(graph, pairs[p][0], pairs[p][1], caps, pool, &value, side) == RTKA_SUCCESS;
+        double expect = reference_max_flow(graph, pairs[p][0], pairs[p][1], caps);
+        worst = fmax(worst, fabs(value - expect) / fmax(expect, 1.0));
+        double cut = 0.0;
+        for (uint32_t u = 0; u < FLOW_VERTICES; u++) {
+            for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1]; e++) {
+                if (side[u] && !side[graph->edge_indices[e]]) cut += caps[e];
+            }
+        }
+        cut_error = fmax(cut_error, fabs(cut - value) / fmax(value, 1.0));
+        ok = ok && side[pairs[p][0]] && !side[pairs[p][1]];
+    }
+    ok = ok && worst < 1e-9 && cut_error < 1e-9;
+    printf("  push-relabel vs Edmonds-Karp, 4 pairs: max relative error %.2e, minimum cut error %.2e  %s\n",
+           worst, cut_error, ok ? "OK" : "FAILED");
+
+    /* Unreachable sink, bad arguments, the ternary form */
+    double none = -1.0;
+    rtka_graph_sparse_t* pair = rtka_graph_create_sparse(3);
+    if (pair) rtka_graph_add_edge_weighted(pair, 0, 1, rtka_make_state(RTKA_TRUE, 0.5f));
+    rtka_state_t cut_off = pair ? rtka_graph_max_flow(pair, 0, 2) : rtka_make_state(RTKA_UNKNOWN, 0.0f);
+    rtka_state_t half = pair ? rtka_graph_max_flow(pair, 0, 1) : rtka_make_state(RTKA_UNKNOWN, 0.0f);
+    bool edges = ok && rtka_graph_max_flow_value(graph, 3, 3, caps, pool, &none, NULL) == RTKA_ERROR_INVALID_VALUE &&
+                 rtka_graph_max_flow_value(graph, 3, 4, caps, pool, NULL, NULL) == RTKA_ERROR_NULL_POINTER &&
+                 cut_off.value == RTKA_FALSE && half.value == RTKA_TRUE && half.confidence == 1.0f;
+    ok = ok && edges;
+    printf("  unreachable sink FALSE, full share TRUE 1.0, bad arguments refused %s  %s\n",
+           edges ? "yes" : "no", ok ? "OK" : "FAILED");
+
+    rtka_graph_free_sparse(pair);
+    free(caps);
+    free(side);
+    rtka_pool_destroy(pool);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* GROUPS groups of GROUP_SIZE, GROUP_DEGREE edges per vertex inside its
+ * group and one to anywhere */
+static rtka_graph_sparse_t* planted_graph(void) {
+    uint32_t n = GROUPS * GROUP_SIZE, edges = n * (GROUP_DEGREE + 1U);
+    uint32_t* from = malloc((size_t)edges * sizeof(uint32_t));
+    uint32_t* to = malloc((size_t)edges * sizeof(uint32_t));
+    rtka_graph_sparse_t* graph = NULL;
+    if (from && to) {
+        uint32_t e = 0;
+        for (uint32_t v = 0; v < n; v++) {
+            uint32_t base = v / GROUP_SIZE * GROUP_SIZE;
+            for (uint32_t d = 0; d < GROUP_DEGREE; d++, e++) {
+                from[e] = v;
+                to[e] = base + next_random() % GROUP_SIZE;
+            }
+            from[e] = v;
+            to[e++] = next_random() % n;
+        }
+        graph = rtka_graph_create_csr(n, edges, from, to, NULL);
+    }
+    free(from);
+    free(to);
+    return graph;
+}
+
+/* Newman modularity of a partition of the symmetrized graph */
+static double reference_modularity(const rtka_graph_sparse_t* graph, const uint32_t* community) {
+    uint32_t n = graph->num_vertices;
+    double* volume = calloc(n, sizeof(double));
+    double internal = 0.0, total = 0.0;
+    if (!volume) return NAN;
+    for (uint32_t u = 0; u < n; u++) {
+        for (uint32_t e = graph->adjacency_list[u]; e < graph->adjacency_list[u + 1]; e++) {
+            uint32_t v = graph->edge_indices[e];
+            volume[community[u]] += 1.0;
+            volume[community[v]] += 1.0;
+            total += 2.0;
+            if (community[u] == community[v]) internal += 2.0;
+        }
+    }
+    double q = internal / total;
+    for (uint32_t c = 0; c < n; c++) q -= (volume[c] / total) * (volume[c] / total);
+    free(volume);
+    return q;
+}
+
+static bool check_louvain(void) {
+    printf("\n--- Louvain ---\n");
+    rtka_graph_sparse_t* graph = planted_graph();
+    rtka_thread_pool_t* pool = rtka_pool_create(POOL_THREADS, 0);
+    uint32_t n = GROUPS * GROUP_SIZE;
+    uint32_t* community = malloc(n * sizeof(uint32_t));
+    uint32_t* majority = calloc((size_t)GROUPS * n, sizeof(uint32_t));
+    bool ok = graph && pool && community && majority;
+
+    double q = NAN, expect = NAN;
+    uint32_t communities = 0, agree = 0;
+    if (ok) {
+        ok = rtka_graph_louvain(graph, pool, community, &q) == RTKA_SUCCESS;
+        expect = reference_modularity(graph, community);
+        for (uint32_t v = 0; ok && v < n; v++) {
+            if (community[v] >= n) ok = false;
+            else if (community[v] + 1U > communities) communities = community[v] + 1U;
+        }
+        /* Vertices in their group's most common community */
+        for (uint32_t v = 0; ok && v < n; v++) majority[(size_t)(v / GROUP_SIZE) * n + community[v]]++;
+        for (uint32_t g = 0; ok && g < GROUPS; g++) {
+            uint32_t best = 0;
+            for (uint32_t c = 0; c < communities; c++) best = majority[(size_t)g * n + c] > best ? majority[(size_t)g * n + c] : best;
+            agree += best;
+        }
+        ok = ok && fabs(q - expect) < 1e-9 && q > 0.75 && agree >= n * 95U / 100U &&
+             communities >= GROUPS / 2U && communities <= 2U * GROUPS;
+    }
+    printf("  %u planted groups, %u threads: %u communities, %.1f%% with their group, modularity %.4f (direct %.4f)  %s\n",
+           GROUPS, POOL_THREADS, communities, 100.0 * agree / n, q, expect, ok ? "OK" : "FAILED");
+
+    uint32_t* ternary = ok ? rtka_graph_louvain_ternary(graph) : NULL;
+    double q_default = ternary ? reference_modularity(graph, ternary) : NAN;
+    ok = ok && ternary && q_default > 0.75;
+    printf("  default pool: modularity %.4f  %s\n", q_default, ok ? "OK" : "FAILED");
+
+    free(ternary);
+    free(community);
+    free(majority);
+    rtka_pool_destroy(pool);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+/* Push-relabel between two vertices joined to FLOW_TERMINAL_EDGES random
+ * vertices each, on a random graph a tenth the benchmark size (at most
+ * FLOW_BENCH_VERTICES, which bounds the Edmonds-Karp reference), then
+ * Louvain on the same graph */
+static bool benchmark_flow_louvain(uint32_t vertices) {
+    uint32_t fn = vertices / 10U;
+    if (fn < FLOW_VERTICES) fn = FLOW_VERTICES;
+    if (fn > FLOW_BENCH_VERTICES) fn = FLOW_BENCH_VERTICES;
+    uint32_t edges = fn * AVERAGE_DEGREE + 2U * FLOW_TERMINAL_EDGES;
+    uint32_t* from = malloc((size_t)edges * sizeof(uint32_t));
+    uint32_t* to = malloc((size_t)edges * sizeof(uint32_t));
+    uint32_t* community = malloc((size_t)fn * sizeof(uint32_t));
+    rtka_graph_sparse_t* flow_graph = NULL;
+    if (from && to) {
+        random_edges(fn, fn * AVERAGE_DEGREE, from, to);
+        for (uint32_t i = 0, e = fn * AVERAGE_DEGREE; i < FLOW_TERMINAL_EDGES; i++) {
+            from[e] = 0, to[e++] = 2U + next_random() % (fn - 2U);
+            from[e] = 2U + next_random() % (fn - 2U), to[e++] = 1;
+        }
+        flow_graph = rtka_graph_create_csr(fn, edges, from, to, NULL);
+    }
+    free(from);
+    free(to);
+    float* caps = flow_graph ? malloc(((size_t)flow_graph->num_edges + 1) * sizeof(float)) : NULL;
+    bool ok = flow_graph && caps && community;
+    if (ok) {
+        random_lengths(caps, flow_graph->num_edges);
+        double value = 0.0, q = 0.0;
+        double t0 = now_seconds();
+        ok = rtka_graph_max_flow_value(flow_graph, 0, 1, caps, NULL, &value, NULL) == RTKA_SUCCESS;
+        double flow_s = now_seconds() - t0;
+        t0 = now_seconds();
+        double expect = reference_max_flow(flow_graph, 0, 1, caps);
+        double ek_s = now_seconds() - t0;
+        ok = ok && fabs(value - expect) <= 1e-9 * fmax(expect, 1.0);
+        printf("  max flow %.2f over %u edges: push-relabel %.1f ms, Edmonds-Karp %.1f ms\n",
+               value, flow_graph->num_edges, flow_s * 1e3, ek_s * 1e3);
+        t0 = now_seconds();
+        ok = ok && rtka_graph_louvain(flow_graph, NULL, community, &q) == RTKA_SUCCESS;
+        printf("  louvain: %.2f s, modularity %.4f\n", now_seconds() - t0, q);
+    }
+    free(caps);
+    free(community);
+    rtka_graph_free_sparse(flow_graph);
+    return ok;
+}
+
+static bool benchmark(uint32_t vertices) {
+    uint64_t edges64 = (uint64_t)vertices * AVERAGE_DEGREE;
+    uint32_t edges = edges64 > UINT32_MAX ? UINT32_MAX : (uint32_t)edges64;
+    printf("\n--- %u vertices, %u edges, %u pool threads ---\n",
+           vertices, edges, rtka_pool_size(rtka_pool_default()));
+
+    uint32_t* from = malloc((size_t)edges * sizeof(uint32_t));
+    uint32_t* to = malloc((size_t)edges * sizeof(uint32_t));
+    if (!from || !to) {
+        free(from);
+        free(to);
+        return false;
+    }
+    random_edges(vertices, edges, from, to);
+    double t0 = now_seconds();
+    rtka_graph_sparse_t* built = rtka_graph_create_csr(vertices, edges, from, to, NULL);
+    double build_s = now_seconds() - t0;
+    free(from);
+    free(to);
+    if (!built) return false;
+    printf("  build CSR: %.2f s (%u edges kept)\n", build_s, built->num_edges);
+
+    t0 = now_seconds();
+    rtka_graph_sparse_t* graph = NULL;
+    bool saved = rtka_graph_save(built, GRAPH_FILE) == RTKA_SUCCESS;
+    double save_s = now_seconds() - t0;
+    t0 = now_seconds();
+    if (saved && rtka_graph_load(&graph, GRAPH_FILE) == RTKA_SUCCESS) {
+        printf("  save: %.2f s, load (mapped): %.4f s\n", save_s, now_seconds() - t0);
+        rtka_graph_free_sparse(built);
+    } else {
+        printf("  save / load failed, using the built graph\n");
+        graph = built;
+    }
+    remove(GRAPH_FILE);
+
+    bool ok = true;
+    const rtka_pagerank_mode_t modes[] = {RTKA_PAGERANK_PULL, RTKA_PAGERANK_DELTA};
+    for (uint32_t m = 0; m < 2; m++) {
+        rtka_pagerank_t* pr = rtka_pagerank_init(graph);
+        if (!pr) {
+            ok = false;
+            break;
+        }
+        pr->mode = modes[m];
+        pr->convergence_threshold = 1e-6f;
+        double seconds = run_to_convergence(pr, graph, 500);
+        double total = 0.0;
+        for (uint32_t v = 0; v < vertices; v++) total += pr->importance[v];
+        if (seconds < 0.0) ok = false;
+        printf("  %-5s converged: %s after %u iterations, %.2f s (%.1f M edges/s, residual %.2e, importance sum %.4f)\n",
+               modes[m] == RTKA_PAGERANK_PULL ? "pull" : "delta", seconds >= 0.0 ? "yes" : "NO",
+               pr->iterations, seconds, seconds > 0.0 ? (double)graph->num_edges * pr->iterations / seconds / 1e6 : 0.0,
+               (double)pr->residual, total);
+        rtka_pagerank_free(pr);
+    }
+    ok &= benchmark_markov(graph);
+    ok &= benchmark_traversal(graph);
+    ok &= benchmark_flow_louvain(vertices);
+    rtka_graph_free_sparse(graph);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t vertices = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000000U;
+    if (vertices == 0) vertices = 1000000U;
+
+    printf("=== RTKA Graph Test ===\n");
+    bool ok = check_builder();
+    ok &= check_parallel_build();
+    ok &= check_file();
+
+    printf("\n--- PageRank ---\n");
+    rtka_simd_level_t best = rtka_pagerank_kernel();
+    ok &= check_reference(RTKA_SIMD_SCALAR);
+    ok &= check_reference(RTKA_SIMD_AVX2);
+    rtka_pagerank_set_kernel(best);
+    ok &= check_delta();
+    ok &= check_markov();
+    ok &= check_traversal();
+    ok &= check_max_flow();
+    ok &= check_louvain();
+
+    ok &= benchmark(vertices);
+
+    printf("\n%s\n", ok ? "All graph checks passed" : "Graph checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -12,14 +12,24 @@
  *   - MDN parameter splitting tests
  *   - MDNRNN integration tests
  *   - Output verification tests
+ * v1.0.1 - Step arena test: training steps allocate from one arena
+ *   that rtka_arena_end_step releases after rtka_optimizer_step
+ * v1.0.2 - Checkpointed BPTT test: every segment length gives the same
+ *   gradients, which match finite differences, in O(sqrt(T)) memory
+ * v1.0.3 - Streaming inference test: stream steps match rtka_mdnrnn_step
+ *   (sigma to the last bit of expf), rows reset alone, rollouts repeat under one seed; per-step
+ *   time against rtka_mdnrnn_step
  * 
  * NOTE: This file contains ONLY test logic and output.
  * Algorithm implementations are in separate modules.
  */
 
+#define _GNU_SOURCE
 #include "rtka_mdnrnn.h"
+#include "rtka_optimizer.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
@@ -78,7 +88,6 @@ static void print_mdn_stats(const char* prefix, rtka_mdn_output_t* mdn_out) {
     
     printf("%s Pi sum check: ", prefix);
     /* Check that pi sums to ~1.0 for each batch */
-    uint32_t batch = mdn_out->pi->shape[0];
     uint32_t K = mdn_out->pi->shape[1];
     
     float sum = 0.0f;
@@ -286,9 +295,9 @@ static bool test_mdn_forward(void) {
     /* Forward pass */
     rtka_mdn_output_t output = rtka_mdn_forward(mdn, input_node);
     
-    bool passed = (output.pi != NULL) &&
-                  (output.mu != NULL) &&
-                  (output.sigma != NULL);
+    bool passed = check_tensor_not_null(output.pi) &&
+                  check_tensor_not_null(output.mu) &&
+                  check_tensor_not_null(output.sigma);
     
     if (passed) {
         print_tensor_shape("Pi", output.pi);
@@ -305,7 +314,8 @@ static bool test_mdn_forward(void) {
         
         if (passed) {
             /* Check pi is normalized */
-            passed = check_pi_normalized(output.pi, 0.01f);
+            passed = check_pi_normalized(output.pi, 0.01f) &&
+                     check_value_range(output.pi, 0.0f, 1.0f);
             print_mdn_stats("MDN", &output);
         }
     }
@@ -456,9 +466,10 @@ static bool test_mdnrnn_step(void) {
     /* Single step */
     rtka_mdn_output_t output = rtka_mdnrnn_step(model, z_t, a_t);
     
-    bool passed = (output.pi != NULL) &&
-                  (output.mu != NULL) &&
-                  (output.sigma != NULL);
+    bool passed = check_tensor_not_null(output.pi) &&
+                  check_tensor_not_null(output.mu) &&
+                  check_tensor_not_null(output.sigma) &&
+                  check_value_range(output.pi, 0.0f, 1.0f);
     
     if (passed) {
         printf("Step output:\n");
@@ -476,6 +487,350 @@ static bool test_mdnrnn_step(void) {
     return passed;
 }
 
+static bool test_arena_training_step(void) {
+    print_test_header("MDNRNN Arena Training Steps");
+    
+    uint32_t batch = 2, seq_len = 8, z_size = 16, action_size = 3;
+    const uint32_t steps = 20;
+    
+    if (rtka_memory_init() != RTKA_SUCCESS) return false;
+    
+    rtka_mdnrnn_t* model = rtka_mdnrnn_create(z_size, action_size, 64, 5);
+    rtka_optimizer_t* opt = rtka_optimizer_sgd(0.01f, 0.9f);
+    rtka_arena_t* arena = rtka_arena_create(RTKA_STEP_ARENA_SIZE);
+    if (!model || !opt || !arena) return false;
+    rtka_mdnrnn_init_hidden(model, batch);
+    
+    rtka_lstm_layer_t* lstm = model->lstm;
+    rtka_grad_node_t* params[] = {
+        lstm->gate_i.weight, lstm->gate_i.bias, lstm->gate_f.weight, lstm->gate_f.bias,
+        lstm->gate_g.weight, lstm->gate_g.bias, lstm->gate_o.weight, lstm->gate_o.bias,
+        model->mdn->fc_weight, model->mdn->fc_bias
+    };
+    uint32_t param_count = sizeof(params) / sizeof(params[0]);
+    
+    uint32_t z_shape[] = {batch, seq_len, z_size};
+    uint32_t a_shape[] = {batch, seq_len, action_size};
+    rtka_tensor_t* z = rtka_tensor_create(z_shape, 3);
+    rtka_tensor_t* actions = rtka_tensor_create(a_shape, 3);
+    for (uint32_t i = 0; i < z->size; i++) z->data[i] = rtka_make_state(RTKA_TRUE, 0.4f);
+    for (uint32_t i = 0; i < actions->size; i++) actions->data[i] = rtka_make_state(RTKA_FALSE, 0.2f);
+    
+    bool passed = true;
+    clock_t start = clock();
+    for (uint32_t step = 0; step < steps && passed; step++) {
+        rtka_arena_begin_step(arena);
+        
+        rtka_mdnrnn_output_t output = rtka_mdnrnn_forward(model, z, actions, NULL, NULL);
+        passed = output.mdn_params.pi && output.hidden_state &&
+                 output.hidden_state->allocator == &arena->allocator;
+        
+        /* Stand-in gradient: the update path is what is being exercised */
+        for (uint32_t p = 0; p < param_count; p++) {
+            for (uint32_t i = 0; i < params[p]->grad->size; i++) {
+                params[p]->grad->data[i].confidence = 1e-3f;
+            }
+        }
+        rtka_optimizer_step(opt, params, param_count);
+        rtka_optimizer_zero_grad(opt, params, param_count);
+        
+        rtka_mdnrnn_output_free(&output);
+        rtka_arena_end_step(arena);
+        
+        /* Everything except carried state and optimizer buffers is released */
+        passed = passed && atomic_load(&arena->stack.current_offset) == 0 &&
+                 rtka_current_allocator() == rtka_heap_allocator() &&
+                 lstm->h_prev->allocator == rtka_heap_allocator() &&
+                 opt->momentum_buffers[0]->allocator == rtka_heap_allocator();
+    }
+    double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / steps;
+    
+    passed = passed && arena->steps == steps && arena->overflows == 0 && arena->high_water > 0;
+    printf("Arena: %u steps, %.2f ms/step, %zu KB high water, %llu heap fallbacks\n",
+           (unsigned)arena->steps, ms, arena->high_water / 1024U,
+           (unsigned long long)arena->overflows);
+    
+    rtka_arena_destroy(arena);
+    rtka_tensor_free(z);
+    rtka_tensor_free(actions);
+    rtka_mdnrnn_free(model);
+    rtka_memory_cleanup();
+    
+    print_test_result("MDNRNN Arena Training Steps", passed);
+    return passed;
+}
+
+/* Signed-plane loss sum(G * output) of one forward from (h_0, c_0); with a
+ * gradient buffer, also runs backward and copies the eight gate gradients */
+static double lstm_loss(rtka_lstm_layer_t* lstm, rtka_grad_node_t* input,
+                        rtka_tensor_t* h_0, rtka_tensor_t* c_0,
+                        const rtka_tensor_t* grad_out, float* grads, bool* ok) {
+    rtka_grad_node_t* params[] = {
+        lstm->gate_i.weight, lstm->gate_i.bias, lstm->gate_f.weight, lstm->gate_f.bias,
+        lstm->gate_g.weight, lstm->gate_g.bias, lstm->gate_o.weight, lstm->gate_o.bias
+    };
+    
+    rtka_lstm_output_t out = rtka_lstm_forward(lstm, input, h_0, c_0);
+    if (!out.output) {
+        *ok = false;
+        return 0.0;
+    }
+    
+    double loss = 0.0;
+    for (uint32_t i = 0; i < out.output->data->size; i++) {
+        rtka_state_t y = out.output->data->data[i];
+        loss += (double)grad_out->data[i].confidence * y.confidence * (float)y.value;
+    }
+    
+    if (grads) {
+        for (uint32_t p = 0; p < 8; p++) rtka_grad_zero(params[p]);
+        *ok = *ok && rtka_lstm_backward(lstm, input->data, grad_out, NULL) == RTKA_SUCCESS;
+        for (uint32_t p = 0; p < 8; p++) {
+            for (uint32_t i = 0; i < params[p]->grad->size; i++) {
+                *grads++ = params[p]->grad->data[i].confidence;
+            }
+        }
+    }
+    
+    rtka_grad_node_free(out.output);
+    rtka_tensor_free(out.hidden_state);
+    rtka_tensor_free(out.cell_state);
+    return loss;
+}
+
+static void set_signed(rtka_tensor_t* t, uint32_t i, float s) {
+    t->data[i] = rtka_make_state(s > 0.0f ? RTKA_TRUE : s < 0.0f ? RTKA_FALSE : RTKA_UNKNOWN, fabsf(s));
+}
+
+static bool test_lstm_checkpointed_bptt(void) {
+    print_test_header("LSTM Checkpointed BPTT");
+    
+    uint32_t batch = 2, seq_len = 23, input_size = 5, hidden_size = 8;
+    srand(17);
+    
+    rtka_lstm_layer_t* lstm = rtka_lstm_create(input_size, hidden_size, true);
+    if (!lstm) return false;
+    
+    uint32_t in_shape[] = {batch, seq_len, input_size};
+    uint32_t out_shape[] = {batch, seq_len, hidden_size};
+    uint32_t state_shape[] = {batch, hidden_size};
+    rtka_tensor_t* input = rtka_tensor_create(in_shape, 3);
+    rtka_tensor_t* grad_out = rtka_tensor_create(out_shape, 3);
+    rtka_tensor_t* h_0 = rtka_tensor_create(state_shape, 2);
+    rtka_tensor_t* c_0 = rtka_tensor_create(state_shape, 2);
+    for (uint32_t i = 0; i < input->size; i++) {
+        set_signed(input, i, ((float)rand() / RAND_MAX) * 2.0f - 1.0f);
+    }
+    for (uint32_t i = 0; i < grad_out->size; i++) {
+        grad_out->data[i] = rtka_make_state(RTKA_UNKNOWN, ((float)rand() / RAND_MAX) * 2.0f - 1.0f);
+    }
+    for (uint32_t i = 0; i < h_0->size; i++) {
+        set_signed(h_0, i, ((float)rand() / RAND_MAX) - 0.5f);
+        set_signed(c_0, i, ((float)rand() / RAND_MAX) - 0.5f);
+    }
+    rtka_grad_node_t* input_node = rtka_grad_node_create(input, false);
+    
+    uint32_t count = rtka_lstm_param_count(lstm);
+    float* reference = (float*)malloc(count * sizeof(float));
+    float* grads = (float*)malloc(count * sizeof(float));
+    bool passed = reference && grads;
+    
+    /* One segment keeps every timestep: plain BPTT */
+    rtka_lstm_set_checkpoint_segment(lstm, seq_len);
+    if (passed) lstm_loss(lstm, input_node, h_0, c_0, grad_out, reference, &passed);
+    
+    uint32_t segments[] = {0, 1, 4, 7};
+    for (uint32_t s = 0; s < 4 && passed; s++) {
+        rtka_lstm_set_checkpoint_segment(lstm, segments[s]);
+        lstm_loss(lstm, input_node, h_0, c_0, grad_out, grads, &passed);
+        
+        float worst = 0.0f;
+        for (uint32_t i = 0; i < count; i++) {
+            float err = fabsf(grads[i] - reference[i]) / (1.0f + fabsf(reference[i]));
+            if (err > worst) worst = err;
+        }
+        printf("Segment %2u: %u checkpoints, max rel diff %.2e\n", segments[s],
+               lstm->checkpoints->checkpoint_count, (double)worst);
+        passed = passed && worst < 1e-5f;
+    }
+    
+    /* Finite differences on a few weights and biases of each gate. A gate
+     * below 0.5 reads as UNKNOWN, so the loss jumps where a pre-activation
+     * crosses zero; the one-sided difference away from a jump must match */
+    rtka_lstm_gate_t* gates[] = {&lstm->gate_i, &lstm->gate_f, &lstm->gate_g, &lstm->gate_o};
+    const float eps = 1e-3f;
+    uint32_t gate_params = count / 4;
+    double base = lstm_loss(lstm, input_node, h_0, c_0, grad_out, NULL, &passed);
+    for (uint32_t g = 0; g < 4 && passed; g++) {
+        rtka_tensor_t* w = gates[g]->weight->data;
+        rtka_tensor_t* b = gates[g]->bias->data;
+        uint32_t probes[] = {g * 7U % w->size, w->size - 1 - g, w->size + g % hidden_size};
+        for (uint32_t p = 0; p < 3; p++) {
+            rtka_tensor_t* t = probes[p] < w->size ? w : b;
+            uint32_t i = probes[p] < w->size ? probes[p] : probes[p] - w->size;
+            float analytic = reference[g * gate_params + probes[p]];
+            rtka_state_t saved = t->data[i];
+            float v = saved.confidence * (float)saved.value;
+            
+            set_signed(t, i, v + eps);
+            double up = lstm_loss(lstm, input_node, h_0, c_0, grad_out, NULL, &passed);
+            set_signed(t, i, v - eps);
+            double down = lstm_loss(lstm, input_node, h_0, c_0, grad_out, NULL, &passed);
+            t->data[i] = saved;
+            
+            float forward = (float)((up - base) / eps), backward = (float)((base - down) / eps);
+            float tol = 2e-4f + 2e-2f * fabsf(analytic);
+            passed = passed && (fabsf(forward - analytic) <= tol || fabsf(backward - analytic) <= tol);
+        }
+    }
+    
+    /* Memory: sqrt(T) segments against storing every step of a long sequence */
+    const uint32_t long_seq = 1024;
+    rtka_lstm_set_checkpoint_segment(lstm, 0);
+    size_t sqrt_bytes = rtka_lstm_backward_bytes(lstm, batch, long_seq);
+    rtka_lstm_set_checkpoint_segment(lstm, long_seq);
+    size_t full_bytes = rtka_lstm_backward_bytes(lstm, batch, long_seq);
+    printf("T = %u backward memory: %zu KB checkpointed, %zu KB storing every step\n",
+           long_seq, sqrt_bytes / 1024, full_bytes / 1024);
+    passed = passed && sqrt_bytes * 8 < full_bytes;
+    
+    free(reference);
+    free(grads);
+    rtka_grad_node_free(input_node);
+    rtka_tensor_free(grad_out);
+    rtka_tensor_free(h_0);
+    rtka_tensor_free(c_0);
+    rtka_lstm_free(lstm);
+    
+    print_test_result("LSTM Checkpointed BPTT", passed);
+    return passed;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool same_states(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return a && b && a->size == b->size && memcmp(a->data, b->data, a->size * sizeof(rtka_state_t)) == 0;
+}
+
+/* Vector and scalar expf may differ in the last bit */
+static bool close_states(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    if (!a || !b || a->size != b->size) return false;
+    for (uint32_t i = 0; i < a->size; i++) {
+        if (a->data[i].value != b->data[i].value ||
+            fabsf(a->data[i].confidence - b->data[i].confidence) > 1e-6f * a->data[i].confidence) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_mdnrnn_stream(void) {
+    print_test_header("MDNRNN Streaming Inference");
+    
+    const uint32_t batch = 4, z_size = 32, action_size = 3, hidden = 256, steps = 6;
+    rtka_mdnrnn_t* model = rtka_mdnrnn_create(z_size, action_size, hidden, 5);
+    rtka_mdnrnn_stream_t* stream = model ? rtka_mdnrnn_stream_create(model, batch) : NULL;
+    if (!stream) {
+        rtka_mdnrnn_free(model);
+        return false;
+    }
+    rtka_mdnrnn_init_hidden(model, batch);
+    
+    uint32_t z_shape[] = {batch, z_size};
+    uint32_t a_shape[] = {batch, action_size};
+    rtka_tensor_t* z_t = rtka_tensor_create(z_shape, 2);
+    rtka_tensor_t* a_t = rtka_tensor_create(a_shape, 2);
+    float z[4 * 32], a[4 * 3];
+    
+    /* Same inputs both ways: state, pi and mu bit for bit, sigma to rounding */
+    bool matches = true;
+    for (uint32_t t = 0; t < steps && matches; t++) {
+        for (uint32_t i = 0; i < batch * z_size; i++) {
+            z[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+            set_signed(z_t, i, z[i]);
+        }
+        for (uint32_t i = 0; i < batch * action_size; i++) {
+            a[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+            set_signed(a_t, i, a[i]);
+        }
+        
+        rtka_mdn_output_t expect = rtka_mdnrnn_step(model, z_t, a_t);
+        matches = rtka_mdnrnn_stream_step(stream, z, a) == RTKA_SUCCESS &&
+                  same_states(expect.pi, stream->output.pi) &&
+                  same_states(expect.mu, stream->output.mu) &&
+                  close_states(expect.sigma, stream->output.sigma);
+        for (uint32_t b = 0; b < batch && matches; b++) {
+            const float* h = rtka_mdnrnn_stream_hidden(stream, b);
+            for (uint32_t j = 0; j < hidden; j++) {
+                rtka_state_t s = model->lstm->h_prev->data[b * hidden + j];
+                matches = matches && h[j] == s.confidence * (rtka_confidence_t)s.value;
+            }
+        }
+        rtka_mdn_output_free(&expect);
+    }
+    printf("%u steps of %u rows match rtka_mdnrnn_step: %s\n", steps, batch, matches ? "yes" : "NO");
+    
+    /* One row restarts, the others carry on */
+    rtka_mdnrnn_stream_reset_row(stream, 1);
+    bool reset = true;
+    for (uint32_t j = 0; j < hidden; j++) {
+        reset = reset && rtka_mdnrnn_stream_hidden(stream, 1)[j] == 0.0f;
+    }
+    bool carried = false;
+    for (uint32_t j = 0; j < hidden; j++) carried |= rtka_mdnrnn_stream_hidden(stream, 0)[j] != 0.0f;
+    reset = reset && carried;
+    
+    /* Rollouts: finite samples, repeated exactly from one seed */
+    const uint32_t horizon = 32;
+    float* actions = (float*)malloc(horizon * batch * action_size * sizeof(float));
+    float* first = (float*)malloc(2 * horizon * batch * z_size * sizeof(float));
+    float* second = first ? first + horizon * batch * z_size : NULL;
+    bool rolled = actions && first;
+    for (uint32_t i = 0; rolled && i < horizon * batch * action_size; i++) actions[i] = i % 3 ? 0.5f : -0.5f;
+    
+    rtka_rng_t rng;
+    for (uint32_t pass = 0; rolled && pass < 2; pass++) {
+        rtka_random_init_stream(&rng, 42, 0);
+        rtka_mdnrnn_stream_reset(stream);
+        rolled = rtka_mdnrnn_stream_rollout(stream, z, actions, horizon, &rng,
+                                            pass ? second : first) == RTKA_SUCCESS;
+    }
+    for (uint32_t i = 0; rolled && i < horizon * batch * z_size; i++) rolled = isfinite(first[i]);
+    rolled = rolled && memcmp(first, second, horizon * batch * z_size * sizeof(float)) == 0;
+    printf("Row reset: %s, %u-step rollout repeats: %s\n", reset ? "yes" : "NO", horizon,
+           rolled ? "yes" : "NO");
+    
+    /* Per-step latency, same work each way */
+    const uint32_t timed = 200;
+    double t0 = now_seconds();
+    for (uint32_t t = 0; t < timed; t++) {
+        rtka_mdn_output_t out = rtka_mdnrnn_step(model, z_t, a_t);
+        rtka_mdn_output_free(&out);
+    }
+    double allocating = (now_seconds() - t0) / timed;
+    t0 = now_seconds();
+    bool stepped = true;
+    for (uint32_t t = 0; t < timed; t++) stepped &= rtka_mdnrnn_stream_step(stream, z, a) == RTKA_SUCCESS;
+    double streaming = (now_seconds() - t0) / timed;
+    printf("Step of %u rows: rtka_mdnrnn_step %.1f us, stream %.1f us\n", batch, allocating * 1e6,
+           streaming * 1e6);
+    
+    free(actions);
+    free(first);
+    rtka_tensor_free(z_t);
+    rtka_tensor_free(a_t);
+    rtka_mdnrnn_stream_free(stream);
+    rtka_mdnrnn_free(model);
+    
+    bool passed = matches && reset && rolled && stepped;
+    print_test_result("MDNRNN Streaming Inference", passed);
+    return passed;
+}
+
 /* ============================================================================
  * MAIN TEST RUNNER
  * ============================================================================ */
@@ -501,6 +856,9 @@ int main(void) {
     total++; if (test_mdnrnn_creation()) passed++;
     total++; if (test_mdnrnn_forward()) passed++;
     total++; if (test_mdnrnn_step()) passed++;
+    total++; if (test_arena_training_step()) passed++;
+    total++; if (test_lstm_checkpointed_bptt()) passed++;
+    total++; if (test_mdnrnn_stream()) passed++;
     
     /* Final results */
     printf("\n");
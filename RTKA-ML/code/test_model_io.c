@@ -0,0 +1,331 @@
+/**
+ * File: test_model_io.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Model Files: LSTM, MDN-RNN and sequential round trips
+ *
+ * A shared load points every parameter tensor into the mapping, 64-byte
+ * aligned, allocates no gradients and gives the saved model's outputs bit
+ * for bit. A private load trains on copy-on-write pages and leaves the
+ * file alone. Ternary layers saved with their bit-planes infer from the
+ * mapped planes. Truncated, foreign and wrong-kind files are refused.
+ * Then cold start is timed against building the model.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_model_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define LSTM_PATH    "/tmp/rtka_model_lstm.bin"
+#define MDNRNN_PATH  "/tmp/rtka_model_mdnrnn.bin"
+#define SEQ_PATH     "/tmp/rtka_model_seq.bin"
+#define BAD_PATH     "/tmp/rtka_model_bad.bin"
+#define LOADS        200U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void fill_random(rtka_tensor_t* t) {
+    for (uint32_t i = 0; i < t->size; i++) {
+        float v = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+        t->data[i] = rtka_make_state(v > 0.0f ? RTKA_TRUE : RTKA_FALSE, fabsf(v));
+    }
+}
+
+static bool same_states(const rtka_tensor_t* a, const rtka_tensor_t* b) {
+    return a && b && a->size == b->size && memcmp(a->data, b->data, a->size * sizeof(rtka_state_t)) == 0;
+}
+
+/* Inside [map, map + length) and 64-byte aligned */
+static bool in_map(const void* p, const void* map, size_t length) {
+    const uint8_t* q = (const uint8_t*)p;
+    const uint8_t* base = (const uint8_t*)map;
+    return q >= base && q < base + length && ((uintptr_t)q & 63U) == 0;
+}
+
+static rtka_tensor_t* lstm_run(rtka_lstm_layer_t* lstm, const rtka_tensor_t* input) {
+    rtka_tensor_t* copy = rtka_tensor_create(input->shape, input->ndim);
+    if (!copy) return NULL;
+    memcpy(copy->data, input->data, input->size * sizeof(rtka_state_t));
+    rtka_grad_node_t* node = rtka_grad_node_create(copy, false);
+    if (!node || !rtka_lstm_init_hidden(lstm, input->shape[0])) {
+        rtka_grad_node_free(node);
+        return NULL;
+    }
+    rtka_lstm_output_t out = rtka_lstm_forward(lstm, node, NULL, NULL);
+    rtka_tensor_t* h = out.hidden_state;
+    if (out.output) rtka_grad_node_free(out.output);
+    rtka_tensor_free(out.cell_state);
+    rtka_grad_node_free(node);
+    return h;
+}
+
+static bool check_lstm(void) {
+    printf("\n--- LSTM ---\n");
+    rtka_lstm_layer_t* lstm = rtka_lstm_create(12, 32, true);
+    if (!lstm) return false;
+    bool saved = rtka_lstm_save(lstm, LSTM_PATH) == RTKA_SUCCESS;
+
+    uint32_t shape[] = {3, 6, 12};
+    rtka_tensor_t* input = rtka_tensor_create(shape, 3);
+    if (!input) return false;
+    fill_random(input);
+    rtka_tensor_t* expect = lstm_run(lstm, input);
+
+    rtka_lstm_layer_t* shared = NULL;
+    bool loaded = saved && rtka_lstm_load(&shared, LSTM_PATH, 0) == RTKA_SUCCESS;
+    bool mapped = loaded && in_map(shared->weight_packed->data, shared->map, shared->map_length) &&
+                  in_map(shared->bias_packed->data, shared->map, shared->map_length) &&
+                  same_states(shared->weight_packed, lstm->weight_packed) &&
+                  same_states(shared->bias_packed, lstm->bias_packed);
+    bool frozen = loaded && !shared->gate_i.weight->grad && !shared->gate_o.bias->grad &&
+                  shared->gate_f.weight->data->data ==
+                      shared->weight_packed->data + 32U * (12U + 32U);
+    rtka_tensor_t* got = loaded ? lstm_run(shared, input) : NULL;
+    bool same = same_states(expect, got);
+    printf("  weights mapped %s, frozen %s, hidden state %s\n", mapped ? "yes" : "NO",
+           frozen ? "yes" : "NO", same ? "identical" : "DIFFERS");
+
+    /* Private: writable and trainable, the file keeps the saved weights */
+    rtka_lstm_layer_t* private_copy = NULL;
+    bool cow = saved && rtka_lstm_load(&private_copy, LSTM_PATH, RTKA_MODEL_LOAD_PRIVATE) == RTKA_SUCCESS &&
+               private_copy->gate_i.weight->grad != NULL;
+    if (cow) {
+        rtka_lstm_reset_parameters(private_copy);
+        rtka_lstm_layer_t* again = NULL;
+        cow = rtka_lstm_load(&again, LSTM_PATH, 0) == RTKA_SUCCESS &&
+              same_states(again->weight_packed, lstm->weight_packed) &&
+              !same_states(private_copy->weight_packed, lstm->weight_packed);
+        rtka_lstm_free(again);
+    }
+    printf("  private load: trainable, writes stay in memory %s\n", cow ? "yes" : "NO");
+
+    rtka_tensor_free(expect);
+    rtka_tensor_free(got);
+    rtka_tensor_free(input);
+    rtka_lstm_free(private_copy);
+    rtka_lstm_free(shared);
+    rtka_lstm_free(lstm);
+
+    bool ok = saved && loaded && mapped && frozen && same && cow;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool same_mdnrnn_output(const rtka_mdnrnn_output_t* a, const rtka_mdnrnn_output_t* b) {
+    return same_states(a->mdn_params.pi, b->mdn_params.pi) && same_states(a->mdn_params.mu, b->mdn_params.mu) &&
+           same_states(a->mdn_params.sigma, b->mdn_params.sigma) &&
+           same_states(a->hidden_state, b->hidden_state);
+}
+
+static bool check_mdnrnn(void) {
+    printf("\n--- MDN-RNN ---\n");
+    rtka_mdnrnn_t* model = rtka_mdnrnn_create(16, 3, 64, 5);
+    if (!model) return false;
+    bool saved = rtka_mdnrnn_save(model, MDNRNN_PATH) == RTKA_SUCCESS;
+
+    rtka_mdnrnn_t* shared = NULL;
+    bool loaded = saved && rtka_mdnrnn_load(&shared, MDNRNN_PATH, RTKA_MODEL_LOAD_POPULATE) == RTKA_SUCCESS;
+    bool sized = loaded && shared->z_size == 16 && shared->action_size == 3 && shared->hidden_size == 64 &&
+                 shared->num_gaussians == 5 && shared->batch_first == model->batch_first &&
+                 rtka_mdnrnn_param_count(shared) == rtka_mdnrnn_param_count(model);
+    bool mapped = loaded && in_map(shared->mdn->fc_weight->data->data, shared->map, shared->map_length) &&
+                  in_map(shared->lstm->weight_packed->data, shared->map, shared->map_length) &&
+                  !shared->mdn->fc_weight->grad;
+
+    uint32_t z_shape[] = {2, 5, 16};
+    uint32_t a_shape[] = {2, 5, 3};
+    rtka_tensor_t* z = rtka_tensor_create(z_shape, 3);
+    rtka_tensor_t* actions = rtka_tensor_create(a_shape, 3);
+    if (!z || !actions) return false;
+    fill_random(z);
+    fill_random(actions);
+
+    bool same = false;
+    if (loaded && rtka_mdnrnn_init_hidden(model, 2) && rtka_mdnrnn_init_hidden(shared, 2)) {
+        rtka_mdnrnn_output_t expect = rtka_mdnrnn_forward(model, z, actions, NULL, NULL);
+        rtka_mdnrnn_output_t got = rtka_mdnrnn_forward(shared, z, actions, NULL, NULL);
+        same = same_mdnrnn_output(&expect, &got);
+        rtka_mdnrnn_output_free(&expect);
+        rtka_mdnrnn_output_free(&got);
+    }
+    printf("  %u parameters mapped %s, mixture outputs %s\n", rtka_mdnrnn_param_count(model),
+           mapped ? "yes" : "NO", same ? "identical" : "DIFFER");
+
+    rtka_tensor_free(z);
+    rtka_tensor_free(actions);
+    rtka_mdnrnn_free(shared);
+    rtka_mdnrnn_free(model);
+
+    bool ok = saved && loaded && sized && mapped && same;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_sequential(void) {
+    printf("\n--- Sequential model ---\n");
+    rtka_model_t* model = rtka_ml_create_model(MODEL_TERNARY_NET);
+    if (!model) return false;
+    rtka_ml_add_layer(model, (rtka_layer_t*)rtka_nn_linear(16, 100, true));
+    rtka_ternary_layer_t* ternary = rtka_nn_ternary(100, 10, 0.3f);
+    if (!ternary) return false;
+    ternary->quantize_activations = false;
+    rtka_ml_add_layer(model, (rtka_layer_t*)ternary);
+    model->epochs_trained = 7;
+    bool saved = rtka_ml_model_save(model, SEQ_PATH, RTKA_MODEL_SAVE_TERNARY) == RTKA_SUCCESS;
+
+    rtka_model_t* shared = NULL;
+    bool loaded = saved && rtka_ml_model_load(&shared, SEQ_PATH, 0) == RTKA_SUCCESS &&
+                  shared->network->num_layers == 2;
+    bool layers = false, planes = false, same = false;
+    if (loaded) {
+        rtka_linear_layer_t* linear = (rtka_linear_layer_t*)shared->network->layers[0];
+        rtka_ternary_layer_t* t = (rtka_ternary_layer_t*)shared->network->layers[1];
+        rtka_layer_t* source = model->network->layers[0];
+        layers = shared->type == MODEL_TERNARY_NET && shared->epochs_trained == 7 &&
+                 linear->base.type == LAYER_LINEAR && linear->use_bias &&
+                 same_states(linear->base.weight->data, source->weight->data) &&
+                 same_states(linear->base.bias->data, source->bias->data) &&
+                 t->base.type == LAYER_TERNARY && t->threshold == 0.3f && !t->quantize_activations &&
+                 !t->base.training && !t->base.weight->grad;
+        planes = t->packed && in_map(t->packed->pos, shared->map, shared->map_length) &&
+                 t->packed->rows == 10 && t->packed->cols == 100;
+
+        /* Ternary activations take the popcount path, both sides planes */
+        uint32_t shape[] = {4, 100};
+        rtka_tensor_t* input = rtka_tensor_create(shape, 2);
+        if (input) {
+            for (uint32_t i = 0; i < input->size; i++) {
+                input->data[i] = rtka_make_state((rtka_value_t)(rand() % 3 - 1), 1.0f);
+            }
+            rtka_tensor_t* expect = rtka_nn_ternary_infer(ternary, input);
+            rtka_tensor_t* got = rtka_nn_ternary_infer(t, input);
+            same = same_states(expect, got);
+            rtka_tensor_free(expect);
+            rtka_tensor_free(got);
+            rtka_tensor_free(input);
+        }
+    }
+    printf("  layers restored %s, ternary planes mapped %s, inference %s\n", layers ? "yes" : "NO",
+           planes ? "yes" : "NO", same ? "identical" : "DIFFERS");
+
+    /* The rtka_ml.h entry points: copy-on-write, trainable */
+    rtka_model_t* legacy = rtka_ml_load_model(SEQ_PATH);
+    bool trainable = legacy && legacy->trained && legacy->network->layers[0]->weight->grad &&
+                     legacy->network->layers[1]->training;
+    printf("  rtka_ml_load_model: trainable %s\n", trainable ? "yes" : "NO");
+
+    rtka_ml_free_model(legacy);
+    rtka_ml_free_model(shared);
+    rtka_ml_free_model(model);
+
+    bool ok = saved && loaded && layers && planes && same && trainable;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool copy_prefix(const char* from, const char* to, long bytes, bool flip_magic) {
+    FILE* in = fopen(from, "rb");
+    FILE* out = fopen(to, "wb");
+    bool ok = in && out;
+    for (long i = 0; ok && i < bytes; i++) {
+        int c = fgetc(in);
+        if (c == EOF) break;
+        if (flip_magic && i == 0) c ^= 0xFF;
+        ok = fputc(c, out) != EOF;
+    }
+    if (in) fclose(in);
+    if (out) ok &= fclose(out) == 0;
+    return ok;
+}
+
+static bool check_rejects(void) {
+    printf("\n--- Refused files ---\n");
+    rtka_model_file_kind_t kind_lstm = 0, kind_mdnrnn = 0, kind_seq = 0;
+    bool kinds = rtka_model_file_kind(LSTM_PATH, &kind_lstm) == RTKA_SUCCESS &&
+                 rtka_model_file_kind(MDNRNN_PATH, &kind_mdnrnn) == RTKA_SUCCESS &&
+                 rtka_model_file_kind(SEQ_PATH, &kind_seq) == RTKA_SUCCESS &&
+                 kind_lstm == RTKA_MODEL_FILE_LSTM && kind_mdnrnn == RTKA_MODEL_FILE_MDNRNN &&
+                 kind_seq == RTKA_MODEL_FILE_SEQUENTIAL;
+
+    rtka_mdnrnn_t* mdnrnn = NULL;
+    bool wrong_kind = rtka_mdnrnn_load(&mdnrnn, LSTM_PATH, 0) == RTKA_ERROR_INVALID_VALUE && !mdnrnn;
+
+    rtka_lstm_layer_t* lstm = NULL;
+    bool truncated = copy_prefix(LSTM_PATH, BAD_PATH, 4096, false) &&
+                     rtka_lstm_load(&lstm, BAD_PATH, 0) == RTKA_ERROR_INVALID_VALUE && !lstm;
+    bool foreign = copy_prefix(LSTM_PATH, BAD_PATH, 1L << 30, true) &&
+                   rtka_lstm_load(&lstm, BAD_PATH, 0) == RTKA_ERROR_INVALID_VALUE &&
+                   rtka_model_file_kind(BAD_PATH, &kind_lstm) == RTKA_ERROR_INVALID_VALUE;
+    bool missing = rtka_lstm_load(&lstm, "/tmp/rtka_model_missing.bin", 0) == RTKA_ERROR_INVALID_VALUE;
+    remove(BAD_PATH);
+
+    /* Other layer kinds have no record */
+    rtka_model_t* model = rtka_ml_create_model(MODEL_CLASSIFIER);
+    rtka_layer_t* dropout = (rtka_layer_t*)calloc(1, sizeof(rtka_layer_t));
+    bool unsupported = model && dropout;
+    if (unsupported) {
+        dropout->type = LAYER_DROPOUT;
+        rtka_ml_add_layer(model, dropout);
+        unsupported = rtka_ml_model_save(model, BAD_PATH, 0) == RTKA_ERROR_INVALID_VALUE &&
+                      remove(BAD_PATH) != 0;
+    }
+    else free(dropout);
+    rtka_ml_free_model(model);
+
+    printf("  kinds %s, wrong kind %s, truncated %s, foreign %s, missing %s, dropout %s\n",
+           kinds ? "read" : "NO", wrong_kind ? "refused" : "NO", truncated ? "refused" : "NO",
+           foreign ? "refused" : "NO", missing ? "refused" : "NO", unsupported ? "refused" : "NO");
+    bool ok = kinds && wrong_kind && truncated && foreign && missing && unsupported;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool benchmark(void) {
+    printf("\n--- Cold start, MDN-RNN z 32, hidden 256, 5 gaussians ---\n");
+    double t0 = now_seconds();
+    rtka_mdnrnn_t* model = rtka_mdnrnn_create(32, 3, 256, 5);
+    double build = now_seconds() - t0;
+    if (!model) return false;
+    bool ok = rtka_mdnrnn_save(model, MDNRNN_PATH) == RTKA_SUCCESS;
+    rtka_mdnrnn_free(model);
+
+    t0 = now_seconds();
+    for (uint32_t i = 0; ok && i < LOADS; i++) {
+        rtka_mdnrnn_t* loaded = NULL;
+        ok = rtka_mdnrnn_load(&loaded, MDNRNN_PATH, 0) == RTKA_SUCCESS;
+        rtka_mdnrnn_free(loaded);
+    }
+    double load = (now_seconds() - t0) / LOADS;
+    printf("  create + init: %.3f ms, shared load: %.3f ms\n", build * 1e3, load * 1e3);
+
+    remove(LSTM_PATH);
+    remove(MDNRNN_PATH);
+    remove(SEQ_PATH);
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Model File Test ===\n");
+    srand(7);
+    bool ok = check_lstm();
+    ok &= check_mdnrnn();
+    ok &= check_sequential();
+    ok &= check_rejects();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All model file checks passed" : "Model file checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -15,6 +15,134 @@
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+
+/* Solutions for n = 0..16 (OEIS A000170, with 0 for the empty board) */
+static const uint64_t known_counts[] = {
+    0, 1, 0, 0, 2, 10, 4, 40, 92, 352, 724, 2680, 14200, 73712, 365596,
+    2279184, 14772512
+};
+
+static bool report(const char* name, bool ok) {
+    printf("%-16s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool check_counts(void) {
+    bool ok = true;
+    for (uint32_t n = 0; n <= 13; n++) ok &= rtka_nqueens_count(n) == known_counts[n];
+    for (uint32_t n = 0; n <= 15; n++) ok &= rtka_nqueens_count_parallel(n, NULL) == known_counts[n];
+
+    double start = wall_seconds();
+    uint64_t count = rtka_nqueens_count_parallel(16, rtka_pool_default());
+    printf("  16-queens: %llu solutions in %.3f s on %u threads\n", (unsigned long long)count,
+           wall_seconds() - start, rtka_pool_size(rtka_pool_default()) + 1U);
+    ok &= count == known_counts[16];
+    ok &= rtka_nqueens_count(NQUEENS_BITS_MAX_SIZE + 1U) == 0;
+    return report("bitmask count", ok);
+}
+
+typedef struct {
+    uint8_t solutions[92][8];
+    uint32_t seen;
+    bool valid;
+} enum_check_t;
+
+static bool record_solution(void* ctx, const uint8_t* cols, uint32_t n) {
+    enum_check_t* e = (enum_check_t*)ctx;
+    for (uint32_t a = 0; a < n; a++) {
+        for (uint32_t b = a + 1; b < n; b++) {
+            uint32_t dc = cols[a] > cols[b] ? cols[a] - cols[b] : cols[b] - cols[a];
+            if (dc == 0 || dc == b - a) e->valid = false;
+        }
+    }
+    if (e->seen < 92 && n == 8) memcpy(e->solutions[e->seen], cols, n);
+    e->seen++;
+    return true;
+}
+
+static bool stop_at_third(void* ctx, const uint8_t* cols, uint32_t n) {
+    (void)cols;
+    (void)n;
+    return ++*(uint32_t*)ctx < 3;
+}
+
+static bool check_enumerate(void) {
+    enum_check_t e = {.valid = true};
+    bool ok = rtka_nqueens_enumerate(8, 0, record_solution, &e) == 92 && e.seen == 92 && e.valid;
+    for (uint32_t i = 1; i < 92; i++) ok &= memcmp(e.solutions[i - 1], e.solutions[i], 8) < 0;
+
+    uint32_t calls = 0;
+    ok &= rtka_nqueens_enumerate(10, 0, stop_at_third, &calls) == 3 && calls == 3;
+    ok &= rtka_nqueens_enumerate(10, 5, NULL, NULL) == 5;
+
+    /* Past the ternary board's 32 columns */
+    e.seen = 0;
+    e.valid = true;
+    ok &= rtka_nqueens_enumerate(33, 1, record_solution, &e) == 1 && e.valid;
+    ok &= rtka_nqueens_enumerate(33, 1, stop_at_third, &calls) == 1;
+    return report("enumerate", ok);
+}
+
+static bool check_solve_all(void) {
+    nqueens_state_t state;
+    uint32_t count = 0;
+    rtka_nqueens_init(&state, 8);
+    bool ok = rtka_nqueens_solve_all(&state, &count, 0) && count == 92 && rtka_nqueens_validate(&state);
+    ok &= state.board[0][0].value == RTKA_TRUE;             /* First solution: 0 4 7 5 2 6 1 3 */
+
+    rtka_nqueens_init(&state, 10);
+    ok &= rtka_nqueens_solve_all(&state, &count, 100) && count == 100;
+    ok &= rtka_nqueens_validate(&state);
+
+    uint8_t attacked[4] = {0, 1, 3, 2};
+    ok &= !rtka_nqueens_load(&state, attacked, 4);
+    rtka_nqueens_init(&state, 3);
+    ok &= !rtka_nqueens_solve_all(&state, &count, 0) && count == 0;
+    return report("solve all", ok);
+}
+
+/* Independent check: one queen per column and diagonal, O(n) */
+static bool valid_placement(const uint32_t* cols, uint32_t n) {
+    uint8_t* seen = (uint8_t*)calloc((size_t)5U * n, 1);
+    bool ok = seen != NULL;
+    for (uint32_t r = 0; ok && r < n; r++) {
+        uint32_t c = cols[r];
+        if (c >= n || seen[c] || seen[n + r + c] || seen[3U * n + r - c + n - 1U]) ok = false;
+        else seen[c] = seen[n + r + c] = seen[3U * n + r - c + n - 1U] = 1;
+    }
+    free(seen);
+    return ok;
+}
+
+static bool check_min_conflicts(void) {
+    static const uint32_t sizes[] = {4, 5, 6, 8, 10, 50, 1000, 100000, 1000000};
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t n = sizes[i];
+        uint32_t* cols = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+        nqueens_mc_stats_t stats;
+        double start = wall_seconds();
+        bool solved = rtka_nqueens_min_conflicts(n, cols, 28 + i, 0, &stats);
+        double seconds = wall_seconds() - start;
+        ok &= solved && valid_placement(cols, n);
+        if (n >= 1000) {
+            printf("  n=%-8u %7.3f s, %u initial conflicts, %llu swaps, %u restarts\n", n, seconds,
+                   stats.initial_conflicts, (unsigned long long)stats.swaps, stats.restarts);
+        }
+        free(cols);
+    }
+    uint32_t cols[3];
+    ok &= !rtka_nqueens_min_conflicts(2, cols, 1, 0, NULL);
+    ok &= !rtka_nqueens_min_conflicts(3, cols, 1, 0, NULL);
+    return report("min-conflicts", ok);
+}
 
 int main(void) {
     printf("╔════════════════════════════════════════════╗\n");
@@ -109,7 +237,12 @@ int main(void) {
     printf("║ 5. UNKNOWN→FALSE transitions are tracked   ║\n");
     printf("║ 6. Threat levels use ternary OR logic      ║\n");
     printf("║ 7. Board confidence measures solution      ║\n");
-    printf("╚════════════════════════════════════════════╝\n");
-    
-    return 0;
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    bool ok = check_counts();
+    ok &= check_enumerate();
+    ok &= check_solve_all();
+    ok &= check_min_conflicts();
+    printf("\n%s\n", ok ? "Bitmask results verified" : "Mismatch detected");
+    return ok ? 0 : 1;
 }
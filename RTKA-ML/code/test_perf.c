@@ -0,0 +1,384 @@
+/**
+ * File: test_perf.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Perf: search counters and timers, threads, reset, export
+ *
+ * Built against solver objects compiled with RTKA_PERF_ENABLED. A SAT
+ * solve's counters match the solver's own statistics and every decision
+ * is timed; rtka_solve_recursive is timed once per call from outside and
+ * counts its nodes, backtracks and guess depth; IDA* times one span and
+ * counts one iteration per threshold, with the nodes the solution
+ * reports; A* times every expansion. Counts of threads that have exited
+ * remain, their slots are reused, reset zeroes a snapshot, and the export
+ * carries every counter. Then the cost of a hook is timed.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_perf.h"
+#include "rtka_sat.h"
+#include "rtka_sudoku_729.h"
+#include "rtka_rubik_ida.h"
+#include "rtka_astar.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define THREADS      4U
+#define GRID_SIZE    64
+#define HOOK_CALLS   10000000U
+
+#ifndef RTKA_PERF_ENABLED
+#error "test_perf needs the solvers built with RTKA_PERF_ENABLED"
+#endif
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* n + 1 pigeons into n holes has no solution */
+static void pigeonhole(sat_state_t* state, uint32_t holes) {
+    uint32_t pigeons = holes + 1;
+    rtka_sat_init(state, pigeons * holes);
+
+    int32_t clause[16];
+    for (uint32_t p = 0; p < pigeons; p++) {
+        for (uint32_t h = 0; h < holes; h++) clause[h] = (int32_t)(p * holes + h + 1);
+        rtka_sat_add_clause(state, clause, holes);
+    }
+    for (uint32_t h = 0; h < holes; h++) {
+        for (uint32_t p = 0; p < pigeons; p++) {
+            for (uint32_t q = p + 1; q < pigeons; q++) {
+                int32_t pair[] = {-(int32_t)(p * holes + h + 1), -(int32_t)(q * holes + h + 1)};
+                rtka_sat_add_clause(state, pair, 2);
+            }
+        }
+    }
+}
+
+static bool check_sat(void) {
+    printf("\n--- SAT propagate / decide ---\n");
+    rtka_perf_reset();
+    sat_state_t state;
+    pigeonhole(&state, 7);
+    bool unsat = !rtka_sat_solve(&state);
+
+    rtka_perf_snapshot_t snap;
+    rtka_perf_snapshot(&snap);
+    const uint64_t* c = snap.counters;
+    /* Unsatisfiable without assumptions: every pick yields a decision */
+    bool ok = snap.enabled && unsat && c[RTKA_PERF_SAT_DECISIONS] == state.decisions &&
+              c[RTKA_PERF_SAT_CONFLICTS] == state.conflicts &&
+              c[RTKA_PERF_SAT_PROPAGATIONS] == state.propagations &&
+              snap.timer_calls[RTKA_PERF_TIMER_SAT_DECIDE] == state.decisions &&
+              snap.timer_calls[RTKA_PERF_TIMER_SAT_PROPAGATE] > state.conflicts &&
+              snap.timer_ns[RTKA_PERF_TIMER_SAT_PROPAGATE] > 0U &&
+              snap.depth_max > 0U && snap.depth_max <= state.num_vars;
+    printf("  PHP(8,7): %llu decisions, %llu conflicts, %llu propagations (solver: %llu, %llu, %llu)\n",
+           (unsigned long long)c[RTKA_PERF_SAT_DECISIONS], (unsigned long long)c[RTKA_PERF_SAT_CONFLICTS],
+           (unsigned long long)c[RTKA_PERF_SAT_PROPAGATIONS], (unsigned long long)state.decisions,
+           (unsigned long long)state.conflicts, (unsigned long long)state.propagations);
+    printf("  propagate: %llu calls, %.3f ms; decide: %llu calls, %.3f ms; deepest level %u\n",
+           (unsigned long long)snap.timer_calls[RTKA_PERF_TIMER_SAT_PROPAGATE],
+           (double)snap.timer_ns[RTKA_PERF_TIMER_SAT_PROPAGATE] * 1e-6,
+           (unsigned long long)snap.timer_calls[RTKA_PERF_TIMER_SAT_DECIDE],
+           (double)snap.timer_ns[RTKA_PERF_TIMER_SAT_DECIDE] * 1e-6, snap.depth_max);
+    rtka_sat_free(&state);
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_sudoku(void) {
+    printf("\n--- rtka_solve_recursive ---\n");
+    /* AI Escargot needs guesses beyond propagation */
+    const char* puzzle = "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..";
+    uint8_t grid[9][9];
+    for (uint32_t i = 0; i < 81; i++) grid[i / 9][i % 9] = puzzle[i] == '.' ? 0U : (uint8_t)(puzzle[i] - '0');
+
+    rtka_perf_reset();
+    sudoku_729_t* solver = rtka_sudoku_init(grid);
+    bool solved = solver && rtka_solve_recursive(solver) && rtka_validate_solution(solver);
+    free(solver);
+
+    rtka_perf_snapshot_t snap;
+    rtka_perf_snapshot(&snap);
+    uint64_t nodes = snap.counters[RTKA_PERF_SUDOKU_NODES];
+    uint64_t backtracks = snap.counters[RTKA_PERF_SUDOKU_BACKTRACKS];
+    /* Below the root every node follows a guess, and one guess path stays */
+    bool ok = solved && nodes > 1U && backtracks > 0U && backtracks < nodes &&
+              snap.timer_calls[RTKA_PERF_TIMER_SUDOKU_SOLVE] == 1U &&
+              snap.timer_ns[RTKA_PERF_TIMER_SUDOKU_SOLVE] > 0U &&
+              snap.depth_max > 0U && snap.depth_max < 81U;
+    printf("  AI Escargot: %llu nodes, %llu backtracks, deepest guess %u, %.3f ms in 1 call\n",
+           (unsigned long long)nodes, (unsigned long long)backtracks, snap.depth_max,
+           (double)snap.timer_ns[RTKA_PERF_TIMER_SUDOKU_SOLVE] * 1e-6);
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static void scramble(rubik_cubie_t* c, uint32_t count) {
+    rtka_rubik_cubie_solved(c);
+    uint32_t last = 6U;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t face;
+        do face = (uint32_t)rand() % 6U; while (face == last);
+        last = face;
+        rtka_rubik_cubie_move(c, face * 3U + (uint32_t)rand() % 3U);
+    }
+}
+
+static bool check_ida(void) {
+    printf("\n--- IDA* threshold loop ---\n");
+    rubik_pdb_t* pdb = NULL;
+    if (rtka_rubik_pdb_generate(&pdb, 0) != RTKA_SUCCESS) {
+        printf("  FAIL: pattern databases\n");
+        return false;
+    }
+    srand(7);
+    rubik_cubie_t cube;
+    scramble(&cube, 7);
+
+    rtka_perf_reset();
+    rubik_solution_t solution;
+    bool found = rtka_rubik_ida_solve_optimal(&cube, pdb, 12, &solution);
+    rtka_perf_snapshot_t snap;
+    rtka_perf_snapshot(&snap);
+    uint64_t iterations = snap.counters[RTKA_PERF_IDA_ITERATIONS];
+    bool serial_ok = found && iterations > 0U &&
+                     snap.timer_calls[RTKA_PERF_TIMER_IDA_THRESHOLD] == iterations &&
+                     snap.counters[RTKA_PERF_IDA_NODES] == solution.nodes;
+    printf("  optimal (%u moves): %llu thresholds, %llu nodes (solution: %llu), %.3f ms\n", solution.length,
+           (unsigned long long)iterations, (unsigned long long)snap.counters[RTKA_PERF_IDA_NODES],
+           (unsigned long long)solution.nodes, (double)snap.timer_ns[RTKA_PERF_TIMER_IDA_THRESHOLD] * 1e-6);
+
+    /* Subtrees count their nodes on the workers that search them */
+    rtka_thread_pool_t* pool = rtka_pool_create(2, 0);
+    rtka_perf_reset();
+    rubik_solution_t parallel;
+    bool parallel_found = pool && rtka_rubik_ida_solve_optimal_parallel(&cube, pdb, 12, pool, &parallel, NULL, 0);
+    rtka_pool_destroy(pool);
+    rtka_perf_snapshot(&snap);
+    iterations = snap.counters[RTKA_PERF_IDA_ITERATIONS];
+    bool parallel_ok = parallel_found && parallel.length == solution.length && iterations > 0U &&
+                       snap.timer_calls[RTKA_PERF_TIMER_IDA_THRESHOLD] == iterations &&
+                       snap.counters[RTKA_PERF_IDA_NODES] == parallel.nodes;
+    printf("  parallel (%u moves): %llu thresholds, %llu nodes (solution: %llu)\n", parallel.length,
+           (unsigned long long)iterations, (unsigned long long)snap.counters[RTKA_PERF_IDA_NODES],
+           (unsigned long long)parallel.nodes);
+
+    rtka_rubik_pdb_free(pdb);
+    bool ok = serial_ok && parallel_ok;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+typedef struct {
+    int16_t x, y;
+} grid_cell_t;
+
+static uint8_t grid_wall[GRID_SIZE][GRID_SIZE];
+
+static bool is_goal_grid(void* state) {
+    const grid_cell_t* c = (const grid_cell_t*)state;
+    return c->x == GRID_SIZE - 1 && c->y == GRID_SIZE - 1;
+}
+
+static uint32_t neighbors_grid(void* state, void* neighbors, uint32_t max_neighbors) {
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {-1, 0, 1, 0};
+    const grid_cell_t* c = (const grid_cell_t*)state;
+    grid_cell_t* out = (grid_cell_t*)neighbors;
+    uint32_t count = 0;
+    for (int i = 0; i < 4 && count < max_neighbors; i++) {
+        int nx = c->x + dx[i], ny = c->y + dy[i];
+        if (nx < 0 || nx >= GRID_SIZE || ny < 0 || ny >= GRID_SIZE || grid_wall[ny][nx]) continue;
+        out[count++] = (grid_cell_t){(int16_t)nx, (int16_t)ny};
+    }
+    return count;
+}
+
+static rtka_state_t heuristic_grid(void* state, void* goal) {
+    const grid_cell_t* c = (const grid_cell_t*)state;
+    const grid_cell_t* g = (const grid_cell_t*)goal;
+    return rtka_make_state(RTKA_TRUE, (float)(abs(c->x - g->x) + abs(c->y - g->y)));
+}
+
+static rtka_state_t cost_grid(void* from, void* to) {
+    (void)from;
+    (void)to;
+    return rtka_make_state(RTKA_TRUE, 1.0f);
+}
+
+static bool route(uint32_t flags, rtka_perf_snapshot_t* snap) {
+    rtka_astar_t* astar = rtka_astar_create();
+    if (!astar) return false;
+    astar->flags = flags | ASTAR_INTEGER_COSTS;
+    astar->is_goal = is_goal_grid;
+    astar->heuristic = heuristic_grid;
+    astar->cost = cost_grid;
+    astar->get_neighbors_into = neighbors_grid;
+    astar->state_size = sizeof(grid_cell_t);
+
+    grid_cell_t start = {0, 0}, goal = {GRID_SIZE - 1, GRID_SIZE - 1};
+    rtka_perf_reset();
+    bool found = rtka_astar_search(astar, &start, &goal) != NULL;
+    rtka_perf_snapshot(snap);
+    rtka_astar_free(astar);
+    return found;
+}
+
+static bool check_astar(void) {
+    printf("\n--- A* expand ---\n");
+    srand(11);
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) grid_wall[y][x] = (uint8_t)(rand() % 100 < 20);
+    }
+    grid_wall[0][0] = 0;
+    grid_wall[GRID_SIZE - 1][GRID_SIZE - 1] = 0;
+
+    bool ok = true;
+    const uint32_t modes[2] = {0U, ASTAR_BIDIRECTIONAL};
+    for (uint32_t m = 0; m < 2; m++) {
+        rtka_perf_snapshot_t snap;
+        bool found = route(modes[m], &snap);
+        uint64_t expansions = snap.counters[RTKA_PERF_ASTAR_EXPANSIONS];
+        uint64_t neighbors = snap.counters[RTKA_PERF_ASTAR_NEIGHBORS];
+        bool mode_ok = found && expansions > 0U && snap.timer_calls[RTKA_PERF_TIMER_ASTAR_EXPAND] == expansions &&
+                       neighbors >= expansions && neighbors <= 4U * expansions;
+        printf("  %s: %llu expansions, %llu neighbors, %.3f ms expanding\n",
+               m ? "bidirectional" : "forward", (unsigned long long)expansions, (unsigned long long)neighbors,
+               (double)snap.timer_ns[RTKA_PERF_TIMER_ASTAR_EXPAND] * 1e-6);
+        ok &= mode_ok;
+    }
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+typedef struct {
+    pthread_barrier_t* attached;
+    uint64_t decisions;
+    uint64_t conflicts;
+} sat_result_t;
+
+static void* solve_main(void* arg) {
+    sat_result_t* result = (sat_result_t*)arg;
+    sat_state_t state;
+    pigeonhole(&state, 6);
+    (void)rtka_sat_solve(&state);
+    result->decisions = state.decisions;
+    result->conflicts = state.conflicts;
+    rtka_sat_free(&state);
+    /* Every thread of a round holds its slot at once */
+    pthread_barrier_wait(result->attached);
+    return NULL;
+}
+
+/* Totals of exited threads remain and a second round reuses their slots */
+static bool check_threads(void) {
+    printf("\n--- Threads ---\n");
+    rtka_perf_reset();
+    uint64_t decisions = 0, conflicts = 0;
+    uint32_t slots[2] = {0, 0};
+    bool ok = true;
+    for (uint32_t round = 0; round < 2; round++) {
+        pthread_t threads[THREADS];
+        sat_result_t results[THREADS];
+        pthread_barrier_t attached;
+        pthread_barrier_init(&attached, NULL, THREADS);
+        for (uint32_t t = 0; t < THREADS; t++) {
+            results[t].attached = &attached;
+            ok &= pthread_create(&threads[t], NULL, solve_main, &results[t]) == 0;
+        }
+        for (uint32_t t = 0; t < THREADS; t++) {
+            pthread_join(threads[t], NULL);
+            decisions += results[t].decisions;
+            conflicts += results[t].conflicts;
+        }
+        pthread_barrier_destroy(&attached);
+        rtka_perf_snapshot_t snap;
+        rtka_perf_snapshot(&snap);
+        slots[round] = snap.threads;
+        ok &= snap.counters[RTKA_PERF_SAT_DECISIONS] == decisions &&
+              snap.counters[RTKA_PERF_SAT_CONFLICTS] == conflicts;
+    }
+    ok &= slots[1] == slots[0];
+    printf("  %u threads x 2 rounds: %llu decisions, %llu conflicts, %u slots after each round\n", THREADS,
+           (unsigned long long)decisions, (unsigned long long)conflicts, slots[1]);
+
+    rtka_perf_reset();
+    rtka_perf_snapshot_t snap;
+    rtka_perf_snapshot(&snap);
+    bool zero = snap.depth_max == 0U;
+    for (uint32_t i = 0; i < RTKA_PERF_COUNTER_COUNT; i++) zero &= snap.counters[i] == 0U;
+    for (uint32_t i = 0; i < RTKA_PERF_TIMER_COUNT; i++) zero &= snap.timer_calls[i] == 0U;
+    printf("  after reset: %s\n", zero ? "all zero" : "NOT ZERO");
+    ok &= zero;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_export(void) {
+    printf("\n--- Export ---\n");
+    RTKA_PERF_COUNT(RTKA_PERF_SAT_DECISIONS, 42);
+    size_t length = rtka_perf_export(NULL, 0);
+    char* text = malloc(length + 1U);
+    bool ok = text && rtka_perf_export(text, length + 1U) == length && strlen(text) == length;
+    ok = ok && strstr(text, "rtka_perf_enabled 1\n") && strstr(text, "rtka_sat_decisions_total 42\n");
+    for (uint32_t i = 0; ok && i < RTKA_PERF_COUNTER_COUNT; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "# TYPE rtka_%s_total counter\n", rtka_perf_counter_name((rtka_perf_counter_t)i));
+        ok &= strstr(text, name) != NULL;
+    }
+    for (uint32_t i = 0; ok && i < RTKA_PERF_TIMER_COUNT; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "{timer=\"%s\"}", rtka_perf_timer_name((rtka_perf_timer_t)i));
+        ok &= strstr(text, name) != NULL;
+    }
+    char small[32];
+    ok &= rtka_perf_export(small, sizeof(small)) == length && strlen(small) == sizeof(small) - 1U;
+    printf("  %zu bytes of Prometheus text\n", length);
+    free(text);
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool benchmark(void) {
+    printf("\n--- Hook cost ---\n");
+    double t0 = now_seconds();
+    for (uint32_t i = 0; i < HOOK_CALLS; i++) RTKA_PERF_COUNT(RTKA_PERF_SAT_PROPAGATIONS, 1);
+    double count = now_seconds() - t0;
+
+    t0 = now_seconds();
+    for (uint32_t i = 0; i < HOOK_CALLS; i++) {
+        RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_SAT_DECIDE);
+        RTKA_PERF_TIMER_END(timer);
+    }
+    double timed = now_seconds() - t0;
+    rtka_perf_reset();
+
+    printf("  counter: %.2f ns, timer: %.2f ns\n", count * 1e9 / HOOK_CALLS, timed * 1e9 / HOOK_CALLS);
+    return true;
+}
+
+int main(void) {
+    printf("=== RTKA Perf Test ===\n");
+    bool ok = check_sat();
+    ok &= check_sudoku();
+    ok &= check_ida();
+    ok &= check_astar();
+    ok &= check_threads();
+    ok &= check_export();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All perf checks passed" : "Perf checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/**
+ * File: test_q8.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Quantized Confidence
+ *
+ * Every pair of the 256 confidences must combine to the rounded real
+ * result, every pair of values to the Kleene operation of rtka_u_core.h,
+ * conversions must round-trip within half a step, and batches must match
+ * the scalar operations. Then AND batches are timed against rtka_state_t.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_q8.h"
+#include "rtka_u_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define BATCH 4099U                 /* Prime: ragged vector tails */
+#define BENCH_COUNT 65536U
+#define BENCH_REPEAT 2000U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool check_confidence(void) {
+    uint32_t wrong[3] = { 0, 0, 0 };
+    for (uint32_t a = 0; a < 256; a++) {
+        for (uint32_t b = 0; b < 256; b++) {
+            double and_ref = floor((double)a * (double)b / 255.0 + 0.5);
+            double or_ref = (double)(a + b) - and_ref;
+            double equiv_ref = floor((double)(a + b) / 2.0 + 0.5);
+            wrong[0] += rtka_q8_conf_and((uint8_t)a, (uint8_t)b) != (uint8_t)and_ref;
+            wrong[1] += rtka_q8_conf_or((uint8_t)a, (uint8_t)b) != (uint8_t)or_ref;
+            wrong[2] += rtka_q8_conf_equiv((uint8_t)a, (uint8_t)b) != (uint8_t)equiv_ref;
+        }
+    }
+    printf("  confidence pairs off the rounded result: and %u, or %u, equiv %u\n",
+           wrong[0], wrong[1], wrong[2]);
+    return wrong[0] + wrong[1] + wrong[2] == 0;
+}
+
+static bool check_values(void) {
+    uint32_t wrong = 0;
+    for (int a = -1; a <= 1; a++) {
+        for (int b = -1; b <= 1; b++) {
+            rtka_state_q8_t x = { (int8_t)a, 200 }, y = { (int8_t)b, 100 };
+            rtka_value_t va = (rtka_value_t)a, vb = (rtka_value_t)b;
+            wrong += rtka_q8_and(x, y).value != rtka_and(va, vb);
+            wrong += rtka_q8_or(x, y).value != rtka_or(va, vb);
+            wrong += rtka_q8_nand(x, y).value != rtka_not(rtka_and(va, vb));
+            wrong += rtka_q8_nor(x, y).value != rtka_not(rtka_or(va, vb));
+            wrong += rtka_q8_implies(x, y).value != rtka_implies(va, vb);
+            wrong += rtka_q8_equiv(x, y).value != rtka_equiv(va, vb);
+            wrong += rtka_q8_not(x).value != rtka_not(va) || rtka_q8_not(x).confidence != 200;
+        }
+    }
+    printf("  Kleene value mismatches: %u\n", wrong);
+    return wrong == 0;
+}
+
+static bool check_conversion(void) {
+    float worst = 0.0f;
+    bool exact = true;
+    for (uint32_t i = 0; i <= 100000; i++) {
+        rtka_state_t s = rtka_make_state(RTKA_TRUE, (float)i / 100000.0f);
+        rtka_state_t back = rtka_q8_to_state(rtka_q8_from_state(s));
+        worst = fmaxf(worst, fabsf(back.confidence - s.confidence));
+    }
+    for (uint32_t q = 0; q < 256; q++) {
+        rtka_state_q8_t s = { RTKA_FALSE, (uint8_t)q };
+        rtka_state_q8_t back = rtka_q8_from_state(rtka_q8_to_state(s));
+        exact &= back.confidence == q && back.value == RTKA_FALSE;
+    }
+    bool clamped = rtka_q8_from_state(rtka_make_state(RTKA_TRUE, 1.5f)).confidence == 255 &&
+                   rtka_q8_from_state(rtka_make_state(RTKA_TRUE, -0.5f)).confidence == 0;
+    printf("  round trip: worst error %.5f (half step %.5f), codes %s, out of range %s\n", worst,
+           0.5f / 255.0f, exact ? "exact" : "CHANGED", clamped ? "clamped" : "NOT CLAMPED");
+    return worst <= 0.5f / 255.0f + 1e-6f && exact && clamped;
+}
+
+typedef void (*q8_batch_fn)(const rtka_state_q8_t*, const rtka_state_q8_t*, rtka_state_q8_t*, uint32_t);
+typedef rtka_state_q8_t (*q8_op_fn)(rtka_state_q8_t, rtka_state_q8_t);
+
+static bool check_batches(void) {
+    const q8_batch_fn batches[] = { rtka_q8_and_batch, rtka_q8_or_batch, rtka_q8_nand_batch,
+                                    rtka_q8_nor_batch, rtka_q8_implies_batch, rtka_q8_equiv_batch };
+    const q8_op_fn ops[] = { rtka_q8_and, rtka_q8_or, rtka_q8_nand, rtka_q8_nor, rtka_q8_implies, rtka_q8_equiv };
+    static rtka_state_q8_t a[BATCH], b[BATCH], r[BATCH];
+    static rtka_state_t wide[BATCH];
+    for (uint32_t i = 0; i < BATCH; i++) {
+        a[i] = (rtka_state_q8_t){ (int8_t)(rand() % 3 - 1), (uint8_t)rand() };
+        b[i] = (rtka_state_q8_t){ (int8_t)(rand() % 3 - 1), (uint8_t)rand() };
+    }
+
+    uint32_t wrong = 0;
+    for (uint32_t k = 0; k < 6; k++) {
+        batches[k](a, b, r, BATCH);
+        for (uint32_t i = 0; i < BATCH; i++) {
+            rtka_state_q8_t want = ops[k](a[i], b[i]);
+            wrong += r[i].value != want.value || r[i].confidence != want.confidence;
+        }
+    }
+    rtka_q8_dequantize(a, wide, BATCH);
+    rtka_q8_quantize(wide, r, BATCH);
+    for (uint32_t i = 0; i < BATCH; i++) {
+        wrong += r[i].value != a[i].value || r[i].confidence != a[i].confidence;
+    }
+    printf("  batch mismatches over %u states: %u\n", BATCH, wrong);
+    return wrong == 0;
+}
+
+static bool benchmark(void) {
+    rtka_state_q8_t* a = (rtka_state_q8_t*)malloc(BENCH_COUNT * sizeof(rtka_state_q8_t) * 3);
+    rtka_state_t* wide = (rtka_state_t*)malloc(BENCH_COUNT * sizeof(rtka_state_t) * 3);
+    if (!a || !wide) return false;
+    rtka_state_q8_t *b = a + BENCH_COUNT, *r = b + BENCH_COUNT;
+    for (uint32_t i = 0; i < 2 * BENCH_COUNT; i++) {
+        a[i] = (rtka_state_q8_t){ (int8_t)(rand() % 3 - 1), (uint8_t)rand() };
+    }
+    rtka_q8_dequantize(a, wide, 2 * BENCH_COUNT);
+
+    double t0 = now_seconds();
+    for (uint32_t k = 0; k < BENCH_REPEAT; k++) {
+        rtka_q8_and_batch(a, b, r, BENCH_COUNT);
+        __asm__ volatile("" : : "r"(r) : "memory");
+    }
+    double q8 = now_seconds() - t0;
+    t0 = now_seconds();
+    for (uint32_t k = 0; k < BENCH_REPEAT; k++) {
+        rtka_and_batch(wide, wide + BENCH_COUNT, wide + 2 * BENCH_COUNT, BENCH_COUNT);
+        __asm__ volatile("" : : "r"(wide) : "memory");
+    }
+    double f32 = now_seconds() - t0;
+
+    double per = 1e9 / ((double)BENCH_REPEAT * BENCH_COUNT);
+    printf("\n--- AND of %u states ---\n", BENCH_COUNT);
+    printf("  rtka_state_t    %zu bytes: %.3f ns/state\n", sizeof(rtka_state_t), f32 * per);
+    printf("  rtka_state_q8_t %zu bytes: %.3f ns/state (%.1fx)\n", sizeof(rtka_state_q8_t), q8 * per, f32 / q8);
+    free(a);
+    free(wide);
+    return true;
+}
+
+int main(void) {
+    printf("=== RTKA Quantized Confidence Test ===\n");
+    bool ok = check_confidence();
+    ok &= check_values();
+    ok &= check_conversion();
+    ok &= check_batches();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All quantized confidence checks passed" : "Quantized confidence checks FAILED");
+    return ok ? 0 : 1;
+}
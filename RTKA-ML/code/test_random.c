@@ -0,0 +1,248 @@
+/**
+ * File: test_random.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Random: jumps, streams, thread streams, bulk fills
+ *
+ * Indexed streams must be reproducible and must not share outputs; the
+ * generators pthreads get from rtka_random_thread must differ, and reseeding
+ * one must repeat its sequence. Bulk fills must equal four scalar
+ * xoshiro256** lanes seeded the documented way, whatever the length, and
+ * follow their distributions. Then fills are timed against per-call draws.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_random.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_DRAWS  4096U
+#define THREADS       4U
+#define FILL_COUNT    (1U << 20)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Count of values present more than once */
+static uint32_t duplicates(uint64_t* values, size_t count) {
+    qsort(values, count, sizeof(uint64_t), compare_u64);
+    uint32_t repeated = 0;
+    for (size_t i = 1; i < count; i++) repeated += values[i] == values[i - 1];
+    return repeated;
+}
+
+static bool check_streams(void) {
+    printf("\n--- Indexed streams ---\n");
+    uint64_t* draws = (uint64_t*)malloc(4U * STREAM_DRAWS * sizeof(uint64_t));
+    if (!draws) return false;
+
+    bool repeatable = true;
+    for (uint32_t s = 0; s < 4; s++) {
+        rtka_rng_t a, b;
+        rtka_random_init_stream(&a, 42, s);
+        rtka_random_init_stream(&b, 42, s);
+        for (uint32_t i = 0; i < STREAM_DRAWS; i++) {
+            draws[s * STREAM_DRAWS + i] = rtka_random_next(&a);
+            repeatable &= draws[s * STREAM_DRAWS + i] == rtka_random_next(&b);
+        }
+    }
+    /* Stream 1 is stream 0 jumped once */
+    rtka_rng_t zero, one;
+    rtka_random_init_stream(&zero, 42, 0);
+    rtka_random_jump(&zero);
+    rtka_random_init_stream(&one, 42, 1);
+    bool jumped = memcmp(&zero, &one, sizeof(zero)) == 0;
+    rtka_random_long_jump(&zero);
+    bool long_jumped = memcmp(&zero, &one, sizeof(zero)) != 0;
+
+    uint32_t shared = duplicates(draws, 4U * STREAM_DRAWS);
+    printf("  same seed and index: %s\n", repeatable ? "same sequence" : "SEQUENCES DIFFER");
+    printf("  stream 1 = stream 0 after jump: %s; long jump moves elsewhere: %s\n",
+           jumped ? "yes" : "NO", long_jumped ? "yes" : "NO");
+    printf("  %u draws from 4 streams, %u repeated\n", 4U * STREAM_DRAWS, shared);
+    free(draws);
+    return repeatable && jumped && long_jumped && shared == 0;
+}
+
+typedef struct {
+    uint64_t first[64];
+    uint64_t reseeded[2][64];
+    float value;
+} thread_record_t;
+
+static void* thread_main(void* arg) {
+    thread_record_t* record = (thread_record_t*)arg;
+    rtka_rng_t* rng = rtka_random_thread();
+    for (uint32_t i = 0; i < 64; i++) record->first[i] = rtka_random_next(rng);
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        rtka_random_seed_thread(7);
+        for (uint32_t i = 0; i < 64; i++) record->reseeded[pass][i] = rtka_random_next(rtka_random_thread());
+    }
+    record->value = rtka_random_float();
+    return NULL;
+}
+
+static bool check_threads(void) {
+    printf("\n--- Thread streams ---\n");
+    thread_record_t records[THREADS];
+    pthread_t threads[THREADS];
+    for (uint32_t t = 0; t < THREADS; t++) {
+        if (pthread_create(&threads[t], NULL, thread_main, &records[t]) != 0) return false;
+    }
+    for (uint32_t t = 0; t < THREADS; t++) pthread_join(threads[t], NULL);
+
+    uint64_t all[THREADS * 64];
+    bool reproducible = true, in_range = true;
+    for (uint32_t t = 0; t < THREADS; t++) {
+        memcpy(all + t * 64, records[t].first, sizeof(records[t].first));
+        reproducible &= memcmp(records[t].reseeded[0], records[t].reseeded[1], sizeof(records[t].reseeded[0])) == 0 &&
+                        memcmp(records[t].reseeded[0], records[0].reseeded[0], sizeof(records[t].reseeded[0])) == 0;
+        in_range &= records[t].value >= 0.0f && records[t].value < 1.0f;
+    }
+    uint32_t shared = duplicates(all, THREADS * 64);
+    printf("  %u threads, %u first draws, %u repeated\n", THREADS, THREADS * 64, shared);
+    printf("  reseeding with one seed: %s\n", reproducible ? "same sequence in every thread" : "SEQUENCES DIFFER");
+    return shared == 0 && reproducible && in_range;
+}
+
+/* Scalar reference of the fills: lane k seeded by splitmix of the k-th
+ * output of rng, outputs interleaved lane by lane */
+static uint64_t reference_output(rtka_rng_t lanes[4], size_t i) {
+    return rtka_random_next(&lanes[i % 4]);
+}
+
+static void reference_lanes(rtka_rng_t* rng, rtka_rng_t lanes[4]) {
+    for (int k = 0; k < 4; k++) rtka_random_init_splitmix(&lanes[k], rtka_random_next(rng));
+}
+
+static bool check_fills(void) {
+    printf("\n--- Bulk fills ---\n");
+#ifdef __AVX2__
+    printf("  AVX2 lanes\n");
+#else
+    printf("  scalar lanes\n");
+#endif
+    float f[67];
+    rtka_value_t v[67];
+    rtka_state_t st[67];
+    uint32_t mismatches = 0;
+    for (size_t count = 1; count <= 67; count++) {
+        rtka_rng_t rng, ref;
+        rtka_rng_t lanes[3][4];
+        rtka_random_init_splitmix(&rng, 1000 + count);
+        ref = rng;
+        rtka_random_fill_float(&rng, f, count);
+        rtka_random_fill_ternary(&rng, v, count);
+        rtka_random_fill_state(&rng, st, count);
+        for (int k = 0; k < 3; k++) reference_lanes(&ref, lanes[k]);
+        mismatches += memcmp(&rng, &ref, sizeof(rng)) != 0;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t x = reference_output(lanes[0], i);
+            mismatches += f[i] != (float)(x >> 40) * 0x1.0p-24f;
+            x = reference_output(lanes[1], i);
+            mismatches += v[i] != (rtka_value_t)((int32_t)(((x >> 32) * 3U) >> 32) - 1);
+            x = reference_output(lanes[2], i);
+            mismatches += st[i].value != (rtka_value_t)((int32_t)(((x >> 32) * 3U) >> 32) - 1) ||
+                          st[i].confidence != (float)(x & 0xFFFFFFU) * 0x1.0p-24f;
+        }
+    }
+    printf("  lengths 1..67 against four scalar lanes: %u mismatches\n", mismatches);
+
+    /* Distributions */
+    float* floats = (float*)malloc(FILL_COUNT * sizeof(float));
+    rtka_value_t* values = (rtka_value_t*)malloc(FILL_COUNT * sizeof(rtka_value_t));
+    rtka_state_t* states = (rtka_state_t*)malloc(FILL_COUNT * sizeof(rtka_state_t));
+    if (!floats || !values || !states) return false;
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, 99);
+    rtka_random_fill_float(&rng, floats, FILL_COUNT);
+    rtka_random_fill_ternary(&rng, values, FILL_COUNT);
+    rtka_random_fill_state(&rng, states, FILL_COUNT);
+
+    double sum = 0.0, confidence = 0.0;
+    uint32_t outside = 0, counts[3] = { 0, 0, 0 }, state_counts[3] = { 0, 0, 0 };
+    for (uint32_t i = 0; i < FILL_COUNT; i++) {
+        sum += floats[i];
+        outside += floats[i] < 0.0f || floats[i] >= 1.0f;
+        outside += values[i] < RTKA_FALSE || values[i] > RTKA_TRUE;
+        outside += states[i].value < RTKA_FALSE || states[i].value > RTKA_TRUE ||
+                   states[i].confidence < 0.0f || states[i].confidence >= 1.0f;
+        if (outside) break;
+        counts[values[i] + 1]++;
+        state_counts[states[i].value + 1]++;
+        confidence += states[i].confidence;
+    }
+    double mean = sum / FILL_COUNT, third = FILL_COUNT / 3.0;
+    bool thirds = true;
+    for (int k = 0; k < 3; k++) {
+        thirds &= counts[k] > third * 0.99 && counts[k] < third * 1.01;
+        thirds &= state_counts[k] > third * 0.99 && state_counts[k] < third * 1.01;
+    }
+    printf("  %u floats: mean %.4f; ternary F/U/T %.4f/%.4f/%.4f; state confidence mean %.4f\n", FILL_COUNT,
+           mean, counts[0] / (double)FILL_COUNT, counts[1] / (double)FILL_COUNT, counts[2] / (double)FILL_COUNT,
+           confidence / FILL_COUNT);
+    free(floats);
+    free(values);
+    free(states);
+    return mismatches == 0 && outside == 0 && mean > 0.499 && mean < 0.501 && thirds &&
+           confidence / FILL_COUNT > 0.499 && confidence / FILL_COUNT < 0.501;
+}
+
+static bool benchmark(void) {
+    printf("\n--- %u draws ---\n", FILL_COUNT);
+    float* floats = (float*)malloc(FILL_COUNT * sizeof(float));
+    rtka_value_t* values = (rtka_value_t*)malloc(FILL_COUNT * sizeof(rtka_value_t));
+    if (!floats || !values) return false;
+    rtka_rng_t rng;
+    rtka_random_init_splitmix(&rng, 5);
+
+    double t0 = now_seconds();
+    for (uint32_t i = 0; i < FILL_COUNT; i++) floats[i] = rtka_random_uniform(&rng);
+    double per_call = now_seconds() - t0;
+    t0 = now_seconds();
+    for (uint32_t i = 0; i < FILL_COUNT; i++) floats[i] = rtka_random_float();
+    double thread_call = now_seconds() - t0;
+    t0 = now_seconds();
+    rtka_random_fill_float(&rng, floats, FILL_COUNT);
+    double filled = now_seconds() - t0;
+    printf("  floats: per call %.2f ms, thread stream per call %.2f ms, fill %.2f ms (%.1fx)\n", per_call * 1e3,
+           thread_call * 1e3, filled * 1e3, per_call / filled);
+
+    t0 = now_seconds();
+    for (uint32_t i = 0; i < FILL_COUNT; i++) values[i] = rtka_random_ternary(&rng);
+    per_call = now_seconds() - t0;
+    t0 = now_seconds();
+    rtka_random_fill_ternary(&rng, values, FILL_COUNT);
+    filled = now_seconds() - t0;
+    printf("  ternary: per call %.2f ms, fill %.2f ms (%.1fx)\n", per_call * 1e3, filled * 1e3, per_call / filled);
+    free(floats);
+    free(values);
+    return true;
+}
+
+int main(void) {
+    printf("=== RTKA Random Test ===\n");
+    bool ok = check_streams();
+    ok &= check_threads();
+    ok &= check_fills();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All random checks passed" : "Random checks FAILED");
+    return ok ? 0 : 1;
+}
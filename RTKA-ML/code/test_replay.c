@@ -0,0 +1,305 @@
+/**
+ * File: test_replay.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Experience Replay: ring storage, batch gathering, priorities
+ *
+ * Every observation carries its id, so a sampled transition can be checked
+ * against what was stored: its next state must be the following
+ * observation, and after wrapping only the newest capacity transitions may
+ * come back. An episode cut without done must keep both transitions.
+ * Prioritized sampling must follow priority and weight by it. Then storage
+ * and sampling are timed against per-experience tensors stacked by hand.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_reinforcement.h"
+#include "rtka_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define OBS          16U
+#define CAPACITY     500U
+#define BATCH        64U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+/* Observation id in every confidence slot */
+static void observation(rtka_state_t* row, uint32_t size, uint32_t id) {
+    for (uint32_t k = 0; k < size; k++) row[k] = rtka_make_state((rtka_value_t)((int)(k % 3U) - 1), (float)id);
+}
+
+static uint32_t row_id(const rtka_state_t* row, uint32_t size) {
+    for (uint32_t k = 1; k < size; k++) {
+        if (row[k].confidence != row[0].confidence) return UINT32_MAX;
+    }
+    return (uint32_t)row[0].confidence;
+}
+
+/* Episodes of 5 to 40 steps, the last one ended early with done so nothing
+ * is cut; transition rewards are the state ids */
+static uint32_t store_episodes(rtka_replay_buffer_t* buffer, uint32_t transitions, uint32_t* next_id) {
+    rtka_state_t state[OBS], next[OBS];
+    uint32_t stored = 0;
+    while (stored < transitions) {
+        uint32_t length = 5U + next_random() % 36U, id = (*next_id)++;
+        observation(state, OBS, id);
+        for (uint32_t t = 0; t < length && stored < transitions; t++, stored++) {
+            bool done = t + 1U == length || stored + 1U == transitions;
+            observation(next, OBS, *next_id);
+            if (rtka_rl_store_states(buffer, state, (rtka_value_t)((int)(id % 3U) - 1), (float)id, next, done) != RTKA_SUCCESS) {
+                return stored;
+            }
+            id = (*next_id)++;
+            memcpy(state, next, sizeof(state));
+        }
+    }
+    return stored;
+}
+
+static bool check_ring(void) {
+    printf("\n--- Ring storage ---\n");
+    rtka_replay_buffer_t* buffer = rtka_rl_create_buffer(CAPACITY, OBS);
+    rtka_replay_batch_t* batch = rtka_rl_create_batch(BATCH, OBS);
+    if (!buffer || !batch) return false;
+
+    uint32_t next_id = 0, stored = 0, bad = 0, old = 0, samples = 0, oldest = 0;
+    for (uint32_t round = 0; round < 8; round++) {
+        stored += store_episodes(buffer, 300, &next_id);
+        /* Ids of every kept transition are at least that of the oldest kept one */
+        oldest = UINT32_MAX;
+        for (uint32_t row = 0; row < buffer->rows; row++) {
+            if (!buffer->valid[row]) continue;
+            uint32_t id = row_id(buffer->observations + (size_t)row * OBS, OBS);
+            if (id < oldest) oldest = id;
+        }
+        for (uint32_t b = 0; b < 20; b++) {
+            if (rtka_rl_sample_batch(buffer, batch, 0.0f) != RTKA_SUCCESS) return false;
+            for (uint32_t i = 0; i < BATCH; i++, samples++) {
+                uint32_t id = row_id(batch->states->data + (size_t)i * OBS, OBS);
+                uint32_t next = row_id(batch->next_states->data + (size_t)i * OBS, OBS);
+                bool ok = id != UINT32_MAX && batch->rewards[i] == (float)id &&
+                          batch->actions[i] == (rtka_value_t)((int)(id % 3U) - 1) &&
+                          (batch->dones[i] || next == id + 1U) && batch->weights[i] == 1.0f;
+                bad += !ok;
+                old += id < oldest;
+            }
+        }
+    }
+    bool full = buffer->size == CAPACITY;
+    printf("  %u transitions into %u slots, %u samples: %s, %s, %u kept\n", stored, CAPACITY, samples,
+           bad ? "SAMPLES DISAGREE WITH STORE" : "state, next state, action and reward match",
+           old ? "RETIRED TRANSITIONS SAMPLED" : "only kept transitions sampled", buffer->size);
+
+    /* An episode cut without done: both transitions keep their next states */
+    rtka_replay_buffer_t* cut = rtka_rl_create_buffer(8, OBS);
+    rtka_state_t a[OBS], b[OBS], c[OBS], d[OBS];
+    observation(a, OBS, 100);
+    observation(b, OBS, 101);
+    observation(c, OBS, 200);
+    observation(d, OBS, 201);
+    bool kept = cut && rtka_rl_store_states(cut, a, RTKA_TRUE, 100.0f, b, false) == RTKA_SUCCESS &&
+                rtka_rl_store_states(cut, c, RTKA_TRUE, 200.0f, d, false) == RTKA_SUCCESS && cut->size == 2;
+    for (uint32_t s = 0; s < 20 && kept; s++) {
+        kept &= rtka_rl_sample_batch(cut, batch, 0.0f) == RTKA_SUCCESS;
+        for (uint32_t i = 0; i < BATCH && kept; i++) {
+            uint32_t id = row_id(batch->states->data + (size_t)i * OBS, OBS);
+            kept &= row_id(batch->next_states->data + (size_t)i * OBS, OBS) == id + 1U;
+        }
+    }
+    printf("  episode cut without done: %s\n", kept ? "both transitions keep their next state" : "NEXT STATE LOST");
+
+    rtka_rl_free_buffer(cut);
+    rtka_rl_free_buffer(buffer);
+    rtka_rl_free_batch(batch);
+    return !bad && !old && full && kept;
+}
+
+static bool check_tensor_store(void) {
+    printf("\n--- Tensor observations ---\n");
+    rtka_replay_buffer_t* buffer = rtka_rl_create_buffer(4, OBS);
+    rtka_replay_batch_t* batch = rtka_rl_create_batch(4, OBS);
+    uint32_t shape[1] = { OBS };
+    rtka_tensor_t* aos = rtka_tensor_create_in(rtka_heap_allocator(), shape, 1);
+    rtka_tensor_t* soa = rtka_tensor_create_soa_in(rtka_heap_allocator(), shape, 1);
+    if (!buffer || !batch || !aos || !soa) return false;
+
+    observation(aos->data, OBS, 7);
+    for (uint32_t k = 0; k < OBS; k++) {
+        soa->values[k] = aos->data[k].value;
+        soa->confidences[k] = 8.0f;
+    }
+    bool ok = rtka_rl_store_experience(buffer, aos, RTKA_FALSE, 1.0f, soa, true) == RTKA_SUCCESS &&
+              rtka_rl_sample_batch(buffer, batch, 0.0f) == RTKA_SUCCESS &&
+              row_id(batch->states->data, OBS) == 7 && row_id(batch->next_states->data, OBS) == 8 &&
+              batch->states->data[1].value == RTKA_UNKNOWN;
+    uint32_t wrong[1] = { OBS + 1U };
+    rtka_tensor_t* longer = rtka_tensor_create_in(rtka_heap_allocator(), wrong, 1);
+    ok &= longer && rtka_rl_store_experience(buffer, longer, RTKA_FALSE, 1.0f, aos, true) == RTKA_ERROR_INVALID_VALUE;
+    printf("  AoS state, SoA next state: %s\n", ok ? "stored and gathered as AoS rows, wrong sizes refused"
+                                                   : "TENSOR STORE FAILED");
+    rtka_tensor_free(longer);
+    rtka_tensor_free(aos);
+    rtka_tensor_free(soa);
+    rtka_rl_free_buffer(buffer);
+    rtka_rl_free_batch(batch);
+    return ok;
+}
+
+static bool check_priorities(void) {
+    printf("\n--- Prioritized replay ---\n");
+    const uint32_t capacity = 4096, batch_size = 256, batches = 400;
+    rtka_replay_buffer_t* buffer = rtka_rl_create_prioritized_buffer(capacity, OBS, 1.0f);
+    rtka_replay_batch_t* batch = rtka_rl_create_batch(batch_size, OBS);
+    if (!buffer || !batch) return false;
+    uint32_t next_id = 0;
+    store_episodes(buffer, capacity, &next_id);
+
+    /* Priority class 1 .. 4 by id */
+    for (uint32_t row = 0; row < buffer->rows; row++) {
+        if (!buffer->valid[row]) continue;
+        uint32_t id = row_id(buffer->observations + (size_t)row * OBS, OBS);
+        rtka_confidence_t td = (rtka_confidence_t)(id % 4U + 1U);
+        rtka_rl_update_priorities(buffer, &row, &td, 1);
+    }
+    uint64_t counts[4] = {0};
+    uint32_t weight_errors = 0;
+    for (uint32_t b = 0; b < batches; b++) {
+        if (rtka_rl_sample_batch(buffer, batch, 1.0f) != RTKA_SUCCESS) return false;
+        float largest = 0.0f;
+        for (uint32_t i = 0; i < batch_size; i++) {
+            uint32_t id = row_id(batch->states->data + (size_t)i * OBS, OBS);
+            counts[id % 4U]++;
+            /* beta = 1: weight x priority is the same for all */
+            float product = batch->weights[i] * (float)(id % 4U + 1U);
+            if (batch->weights[i] > largest) largest = batch->weights[i];
+            if (i > 0) {
+                uint32_t first = row_id(batch->states->data, OBS);
+                float reference = batch->weights[0] * (float)(first % 4U + 1U);
+                weight_errors += fabsf(product - reference) > 1e-4f * reference;
+            }
+        }
+        weight_errors += fabsf(largest - 1.0f) > 1e-6f;
+    }
+
+    double total = (double)batch_size * batches, worst = 0.0;
+    printf("  priorities 1:2:3:4, sampled");
+    for (uint32_t c = 0; c < 4; c++) {
+        double share = (double)counts[c] / total, error = fabs(share - (c + 1.0) / 10.0);
+        if (error > worst) worst = error;
+        printf(" %.3f", share);
+    }
+    printf(" (largest error %.3f); weights %s\n", worst,
+           weight_errors ? "NOT INVERSE TO PRIORITY" : "inverse to priority, largest 1");
+    rtka_rl_free_buffer(buffer);
+    rtka_rl_free_batch(batch);
+    return worst < 0.01 && weight_errors == 0;
+}
+
+/* Store and sample with one heap tensor per observation, stacking batches
+ * by hand, against the ring */
+static bool benchmark(void) {
+    const uint32_t capacity = 100000, obs = 64, batch_size = 256, batches = 2000;
+    printf("\n--- %u transitions of %u elements, %u batches of %u ---\n", capacity, obs, batches, batch_size);
+    uint32_t shape[2] = { batch_size, obs }, row_shape[1] = { obs };
+    rtka_state_t* source = (rtka_state_t*)malloc(((size_t)capacity + 1U) * obs * sizeof(rtka_state_t));
+    if (!source) return false;
+    for (uint32_t i = 0; i <= capacity; i++) observation(source + (size_t)i * obs, obs, i);
+
+    double t0 = now_seconds();
+    rtka_tensor_t** states = (rtka_tensor_t**)malloc(capacity * sizeof(rtka_tensor_t*));
+    rtka_tensor_t** next_states = (rtka_tensor_t**)malloc(capacity * sizeof(rtka_tensor_t*));
+    if (!states || !next_states) return false;
+    for (uint32_t i = 0; i < capacity; i++) {
+        states[i] = rtka_tensor_create_in(rtka_heap_allocator(), row_shape, 1);
+        next_states[i] = rtka_tensor_create_in(rtka_heap_allocator(), row_shape, 1);
+        if (!states[i] || !next_states[i]) return false;
+        memcpy(states[i]->data, source + (size_t)i * obs, obs * sizeof(rtka_state_t));
+        memcpy(next_states[i]->data, source + (size_t)(i + 1U) * obs, obs * sizeof(rtka_state_t));
+    }
+    double tensor_store = now_seconds() - t0;
+    rtka_tensor_t* stacked = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    rtka_tensor_t* stacked_next = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    if (!stacked || !stacked_next) return false;
+    t0 = now_seconds();
+    for (uint32_t b = 0; b < batches; b++) {
+        for (uint32_t i = 0; i < batch_size; i++) {
+            uint32_t idx = next_random() % capacity;
+            memcpy(stacked->data + (size_t)i * obs, states[idx]->data, obs * sizeof(rtka_state_t));
+            memcpy(stacked_next->data + (size_t)i * obs, next_states[idx]->data, obs * sizeof(rtka_state_t));
+        }
+    }
+    double tensor_sample = now_seconds() - t0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        rtka_tensor_free(states[i]);
+        rtka_tensor_free(next_states[i]);
+    }
+    free(states);
+    free(next_states);
+    rtka_tensor_free(stacked);
+    rtka_tensor_free(stacked_next);
+
+    bool ok = true;
+    double ring_store[2], ring_sample[2];
+    for (int prioritized = 0; prioritized < 2; prioritized++) {
+        rtka_replay_buffer_t* buffer = prioritized ? rtka_rl_create_prioritized_buffer(capacity, obs, 0.6f)
+                                                   : rtka_rl_create_buffer(capacity, obs);
+        rtka_replay_batch_t* batch = rtka_rl_create_batch(batch_size, obs);
+        if (!buffer || !batch) return false;
+        t0 = now_seconds();
+        for (uint32_t i = 0; i < capacity; i++) {
+            ok &= rtka_rl_store_states(buffer, source + (size_t)i * obs, RTKA_TRUE, 0.0f,
+                                       source + (size_t)(i + 1U) * obs, false) == RTKA_SUCCESS;
+        }
+        ring_store[prioritized] = now_seconds() - t0;
+        t0 = now_seconds();
+        for (uint32_t b = 0; b < batches && ok; b++) {
+            ok &= rtka_rl_sample_batch(buffer, batch, 0.4f) == RTKA_SUCCESS;
+            if (prioritized) rtka_rl_update_priorities(buffer, batch->indices, batch->weights, batch_size);
+        }
+        ring_sample[prioritized] = now_seconds() - t0;
+        rtka_rl_free_buffer(buffer);
+        rtka_rl_free_batch(batch);
+    }
+    free(source);
+
+    printf("  tensor per observation: store %.1f ms, sample %.1f us/batch\n", tensor_store * 1e3,
+           tensor_sample * 1e6 / batches);
+    printf("  ring, uniform:          store %.1f ms, sample %.1f us/batch\n", ring_store[0] * 1e3,
+           ring_sample[0] * 1e6 / batches);
+    printf("  ring, prioritized:      store %.1f ms, sample %.1f us/batch (with priority updates)\n",
+           ring_store[1] * 1e3, ring_sample[1] * 1e6 / batches);
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Experience Replay Test ===\n");
+    bool ok = check_ring();
+    ok &= check_tensor_store();
+    ok &= check_priorities();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All replay checks passed" : "Replay checks FAILED");
+    return ok ? 0 : 1;
+}
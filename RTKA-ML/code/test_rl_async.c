@@ -0,0 +1,179 @@
+/**
+ * File: test_rl_async.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Asynchronous DQN: actor threads, mailboxes, parameter board
+ *
+ * Actor threads run vectors of chain environments whose observations carry
+ * the episode and step, so every transition that reached the replay buffer
+ * through a mailbox can be checked: its next state must be the following
+ * step. The learner must have stepped, changing the Q-network, and the run
+ * must stop after the requested episodes. Then collection of a costly
+ * environment is timed with the synchronous loop and with actors.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_reinforcement.h"
+#include "rtka_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OBS          8U
+#define ACTORS       4U
+#define ENVS         4U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Episodes of 8 + id % 5 steps; slot 1 is the step, slot 2 the episode,
+ * slot 3 the environment id. work dependent multiply-adds per step. */
+typedef struct {
+    uint32_t id;
+    uint32_t t;
+    uint32_t episodes;
+    uint32_t work;
+    float sink;
+} chain_t;
+
+static rtka_tensor_t* chain_observation(chain_t* c) {
+    uint32_t shape[1] = { OBS };
+    rtka_tensor_t* obs = rtka_tensor_create(shape, 1);
+    if (!obs) return NULL;
+    float x = c->sink;
+    for (uint32_t k = 0; k < c->work; k++) x = x * 0.999f + 0.001f;
+    c->sink = x;
+    for (uint32_t k = 0; k < OBS; k++) {
+        float v = k == 1 ? (float)c->t : k == 2 ? (float)c->episodes : k == 3 ? (float)c->id : (float)k * 0.1f;
+        obs->data[k] = rtka_make_state(RTKA_TRUE, v);
+    }
+    return obs;
+}
+
+static rtka_tensor_t* chain_reset(void* data) {
+    chain_t* c = (chain_t*)data;
+    c->t = 0;
+    c->episodes++;
+    return chain_observation(c);
+}
+
+static rtka_tensor_t* chain_step(void* data, rtka_value_t action, rtka_confidence_t* reward, bool* done) {
+    chain_t* c = (chain_t*)data;
+    c->t++;
+    *reward = action == RTKA_TRUE ? 1.0f : 0.0f;
+    *done = c->t >= 8U + c->id % 5U;
+    return chain_observation(c);
+}
+
+static bool make_vectors(chain_t* chains, rtka_vec_env_t** vecs, uint32_t actors, uint32_t envs, uint32_t work) {
+    rtka_environment_t descriptors[ENVS * 16U];
+    for (uint32_t a = 0; a < actors; a++) {
+        for (uint32_t e = 0; e < envs; e++) {
+            chain_t* c = &chains[a * envs + e];
+            memset(c, 0, sizeof(*c));
+            c->id = a * envs + e;
+            c->work = work;
+            descriptors[e] = (rtka_environment_t){ chain_reset, chain_step, OBS, 3, c };
+        }
+        if (rtka_vec_env_create(&vecs[a], descriptors, envs, NULL) != RTKA_SUCCESS) return false;
+    }
+    return true;
+}
+
+static uint32_t finished_episodes(const chain_t* chains, uint32_t count) {
+    uint32_t episodes = 0;
+    for (uint32_t i = 0; i < count; i++) episodes += chains[i].episodes ? chains[i].episodes - 1U : 0U;
+    return episodes;
+}
+
+static float weight_sum(const rtka_dqn_agent_t* agent) {
+    float sum = 0.0f;
+    rtka_tensor_t* w = agent->q_network->network->layers[0]->weight->data;
+    for (uint32_t i = 0; i < w->size; i++) sum += w->data[i].confidence;
+    return sum;
+}
+
+static bool check_async(void) {
+    printf("\n--- %u actors x %u environments ---\n", ACTORS, ENVS);
+    chain_t chains[ACTORS * ENVS];
+    rtka_vec_env_t* vecs[ACTORS];
+    rtka_dqn_agent_t* agent = rtka_rl_create_dqn(OBS, 3, 0.5f, 0.9f);
+    if (!agent || !agent->buffer || !make_vectors(chains, vecs, ACTORS, ENVS, 0)) return false;
+
+    float before = weight_sum(agent);
+    rtka_async_config_t config = { .batch_size = 16, .publish_interval = 4, .mailbox_capacity = 64 };
+    bool ok = rtka_rl_train_dqn_async(agent, vecs, ACTORS, 200, &config) == RTKA_SUCCESS;
+    uint32_t episodes = finished_episodes(chains, ACTORS * ENVS);
+
+    /* Every transition in the ring: next state is the following step of
+     * the same episode of the same environment */
+    uint32_t checked = 0, broken = 0;
+    rtka_replay_buffer_t* buffer = agent->buffer;
+    for (uint32_t row = 0; row < buffer->rows; row++) {
+        if (!buffer->valid[row] || buffer->dones[row]) continue;
+        const rtka_state_t* s = buffer->observations + (size_t)row * OBS;
+        const rtka_state_t* n = buffer->observations + (size_t)((row + 1U) % buffer->rows) * OBS;
+        broken += n[1].confidence != s[1].confidence + 1.0f || n[2].confidence != s[2].confidence ||
+                  n[3].confidence != s[3].confidence;
+        checked++;
+    }
+    bool learned = agent->async_updates > 0 && weight_sum(agent) != before && agent->epsilon < 0.5f;
+    printf("  200 episodes requested, %u finished, %u transitions stored\n", episodes, buffer->size);
+    printf("  %u stored transitions checked: %s\n", checked,
+           broken ? "NEXT STATES DO NOT FOLLOW" : "every next state is the following step");
+    printf("  learner: %llu updates, weights %s, epsilon %.3f\n", (unsigned long long)agent->async_updates,
+           weight_sum(agent) != before ? "changed" : "UNCHANGED", agent->epsilon);
+
+    /* Bad arguments */
+    ok &= rtka_rl_train_dqn_async(agent, vecs, 0, 10, NULL) == RTKA_ERROR_INVALID_VALUE;
+    ok &= rtka_rl_train_dqn_async(NULL, vecs, 1, 10, NULL) == RTKA_ERROR_NULL_POINTER;
+    for (uint32_t a = 0; a < ACTORS; a++) rtka_vec_env_free(vecs[a]);
+    return ok && episodes >= 200 && checked > 0 && broken == 0 && learned;
+}
+
+static bool benchmark(void) {
+    const uint32_t work = 20000, episodes = 64;
+    chain_t* chains = (chain_t*)malloc(ACTORS * ENVS * sizeof(chain_t));
+    rtka_vec_env_t* vecs[ACTORS];
+    rtka_vec_env_t* single[1];
+    if (!chains) return false;
+    printf("\n--- %u episodes, %u multiply-adds per environment step ---\n", episodes, work);
+
+    rtka_dqn_agent_t* agent = rtka_rl_create_dqn(OBS, 3, 0.5f, 0.9f);
+    if (!agent || !make_vectors(chains, single, 1, ACTORS * ENVS, work)) return false;
+    double t0 = now_seconds();
+    rtka_rl_train_dqn_vectorized(agent, single[0], episodes);
+    double serial = now_seconds() - t0;
+    rtka_vec_env_free(single[0]);
+
+    agent = rtka_rl_create_dqn(OBS, 3, 0.5f, 0.9f);
+    if (!agent || !make_vectors(chains, vecs, ACTORS, ENVS, work)) return false;
+    t0 = now_seconds();
+    bool ok = rtka_rl_train_dqn_async(agent, vecs, ACTORS, episodes, NULL) == RTKA_SUCCESS;
+    double async = now_seconds() - t0;
+    for (uint32_t a = 0; a < ACTORS; a++) rtka_vec_env_free(vecs[a]);
+
+    printf("  one vector of %u, collect then learn: %.1f ms\n", ACTORS * ENVS, serial * 1e3);
+    printf("  %u actors of %u, learner alongside: %.1f ms (%.2fx, %llu learner updates)\n", ACTORS, ENVS,
+           async * 1e3, serial / async, (unsigned long long)agent->async_updates);
+    free(chains);
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Asynchronous DQN Test ===\n");
+    bool ok = check_async();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All asynchronous DQN checks passed" : "Asynchronous DQN checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -14,8 +14,48 @@
 #include "rtka_rubik_324.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#define KERNEL_CHECK_MOVES  2000
+#define KERNEL_BENCH_MOVES  1000000
+
+/* Every kernel against the cubie model over one random sequence, then
+ * rotations per second for each */
+static bool check_kernels(void) {
+    static const rtka_simd_level_t levels[] = {RTKA_SIMD_SCALAR, RTKA_SIMD_SSE41, RTKA_SIMD_AVX2};
+    rtka_simd_level_t chosen = rtka_rubik_324_kernel();
+    bool ok = true;
+
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        if (!rtka_rubik_324_set_kernel(levels[l])) continue;
+        rubik_324_state_t* cube = rtka_rubik_324_create_solved();
+        rubik_cubie_t ref, got;
+        uint8_t colors[54];
+        rtka_rubik_cubie_solved(&ref);
+        srand(32);
+        bool same = true;
+        for (int i = 0; i < KERNEL_CHECK_MOVES; i++) {
+            rubik_324_move_t move = (rubik_324_move_t)(rand() % MOVE_324_COUNT);
+            rtka_rubik_324_rotate(cube, move);
+            rtka_rubik_cubie_move(&ref, (uint32_t)move * 3U);
+            rtka_rubik_cubie_stickers(&ref, colors);
+            same &= memcmp(colors, rtka_rubik_324_colors(cube), sizeof(colors)) == 0;
+        }
+        same &= rtka_rubik_324_cubies(cube, &got) && memcmp(&got, &ref, sizeof(ref)) == 0;
+
+        clock_t start = clock();
+        for (int i = 0; i < KERNEL_BENCH_MOVES; i++) rtka_rubik_324_rotate(cube, (rubik_324_move_t)(i % MOVE_324_COUNT));
+        double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        printf("%-8s %s, %.1f M rotations/s\n", rtka_simd_level_name(levels[l]), same ? "matches cubies" : "MISMATCH",
+               KERNEL_BENCH_MOVES / (elapsed > 0.0 ? elapsed : 1e-9) * 1e-6);
+        ok &= same;
+        rtka_rubik_324_free(cube);
+    }
+    (void)rtka_rubik_324_set_kernel(chosen);
+    return ok;
+}
+
 int main(void) {
     printf("╔════════════════════════════════════════════╗\n");
     printf("║   RTKA 324-STATE RUBIK'S CUBE SOLVER      ║\n");
@@ -101,6 +141,13 @@ int main(void) {
     
     rtka_rubik_324_free(cube);
     
+    /* Test 6: Move kernels */
+    printf("\n═══════════════════════════════════════\n");
+    printf("Test 5: Move table kernels\n");
+    printf("═══════════════════════════════════════\n");
+    
+    bool kernels_ok = check_kernels();
+    
     printf("\n╔════════════════════════════════════════════╗\n");
     printf("║       324-STATE ADVANTAGES                ║\n");
     printf("╠════════════════════════════════════════════╣\n");
@@ -112,5 +159,5 @@ int main(void) {
     printf("║ 6. Parallel bit ops on modern CPUs         ║\n");
     printf("╚════════════════════════════════════════════╝\n");
     
-    return 0;
+    return kernels_ok ? 0 : 1;
 }
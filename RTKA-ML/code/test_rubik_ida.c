@@ -0,0 +1,265 @@
+/**
+ * File: test_rubik_ida.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Rubik's Cube IDA* with pattern databases
+ */
+
+#include "rtka_rubik_ida.h"
+#include "rtka_rubik_324.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PDB_PATH        "build/rubik_ida.pdb"
+#define SCRAMBLES       20U
+#define PARALLEL_THREADS 3U
+
+static bool report(const char* name, bool ok) {
+    printf("%-16s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* "R U R' U'" style text to moves */
+static uint32_t parse_moves(const char* text, uint8_t* moves) {
+    static const char faces[] = "UDFBLR";
+    uint32_t n = 0;
+    for (const char* p = text; *p; p++) {
+        const char* f = strchr(faces, *p);
+        if (!f) continue;
+        uint32_t power = p[1] == '2' ? 1U : p[1] == '\'' ? 2U : 0U;
+        moves[n++] = (uint8_t)((uint32_t)(f - faces) * 3U + power);
+    }
+    return n;
+}
+
+static bool solves_to_identity(const char* text) {
+    uint8_t moves[128];
+    rubik_cubie_t c;
+    rtka_rubik_cubie_solved(&c);
+    rtka_rubik_cubie_apply(&c, moves, parse_moves(text, moves));
+    return rtka_rubik_cubie_is_solved(&c) && rtka_rubik_cubie_is_valid(&c);
+}
+
+/* Group relations, inverse moves and the sticker view of one turn */
+static bool check_cubies(void) {
+    bool ok = solves_to_identity("U U U U") && solves_to_identity("R L R' L'");
+    ok &= solves_to_identity("F B F' B'") && solves_to_identity("U D U' D'");
+    ok &= solves_to_identity("R U R' U' R U R' U' R U R' U' R U R' U' R U R' U' R U R' U'");
+    ok &= solves_to_identity("R2 U2 R2 U2 R2 U2 R2 U2 R2 U2 R2 U2");
+    ok &= !solves_to_identity("R U R' U'");
+
+    rubik_cubie_t c;
+    for (uint32_t m = 0; m < RUBIK_IDA_MOVES; m++) {
+        rtka_rubik_cubie_solved(&c);
+        rtka_rubik_cubie_move(&c, m);
+        ok &= rtka_rubik_cubie_is_valid(&c) && !rtka_rubik_cubie_is_solved(&c);
+        rtka_rubik_cubie_move(&c, rtka_rubik_move_inverse(m));
+        ok &= rtka_rubik_cubie_is_solved(&c);
+    }
+
+    /* U clockwise: front top row shows the right face's color, left's top row the front's */
+    uint8_t colors[54];
+    rtka_rubik_cubie_solved(&c);
+    rtka_rubik_cubie_move(&c, 0);
+    rtka_rubik_cubie_stickers(&c, colors);
+    for (uint32_t i = 0; i < 3; i++) ok &= colors[18 + i] == 3U && colors[9 + i] == 2U && colors[21 + i] == 2U;
+
+    rtka_rubik_cubie_solved(&c);
+    c.co[0] = 1;                                    /* One twisted corner */
+    ok &= !rtka_rubik_cubie_is_valid(&c);
+    return report("cubie moves", ok);
+}
+
+static void scramble(rubik_cubie_t* c, uint8_t* moves, uint32_t count) {
+    rtka_rubik_cubie_solved(c);
+    for (uint32_t i = 0; i < count; i++) {
+        /* Random face differing from the last, random power */
+        uint32_t face;
+        do face = (uint32_t)rand() % 6U; while (i && face == moves[i - 1U] / 3U);
+        moves[i] = (uint8_t)(face * 3U + (uint32_t)rand() % 3U);
+        rtka_rubik_cubie_move(c, moves[i]);
+    }
+}
+
+static bool check_pdb_files(const rubik_pdb_t* pdb) {
+    bool ok = rtka_rubik_pdb_save(pdb, "build/rubik_ida_copy.pdb") == RTKA_SUCCESS;
+    rubik_pdb_t* copy = NULL;
+    ok &= rtka_rubik_pdb_load(&copy, "build/rubik_ida_copy.pdb") == RTKA_SUCCESS;
+    ok &= copy && rtka_rubik_pdb_flags(copy) == rtka_rubik_pdb_flags(pdb);
+    rtka_rubik_pdb_free(copy);
+
+    /* Truncated file */
+    FILE* f = fopen("build/rubik_ida_copy.pdb", "r+b");
+    ok &= f != NULL;
+    if (f) {
+        fputs("JUNK", f);
+        fclose(f);
+    }
+    ok &= rtka_rubik_pdb_load(&copy, "build/rubik_ida_copy.pdb") == RTKA_ERROR_INVALID_VALUE && copy == NULL;
+    ok &= rtka_rubik_pdb_load(&copy, "build/no_such.pdb") == RTKA_ERROR_INVALID_VALUE;
+    remove("build/rubik_ida_copy.pdb");
+    return report("pdb files", ok);
+}
+
+/* 20-move scrambles by two-phase search, every answer replayed */
+static bool check_two_phase(const rubik_pdb_t* pdb) {
+    bool ok = true;
+    uint32_t longest = 0;
+    uint64_t nodes = 0;
+    double start = wall_seconds();
+    for (uint32_t k = 0; k < SCRAMBLES; k++) {
+        rubik_cubie_t c;
+        uint8_t moves[20];
+        scramble(&c, moves, 20);
+        rubik_solution_t s;
+        bool found = rtka_rubik_ida_solve(&c, pdb, 22, &s);
+        rtka_rubik_cubie_apply(&c, s.moves, s.length);
+        ok &= found && s.length <= 22U && rtka_rubik_cubie_is_solved(&c);
+        if (s.length > longest) longest = s.length;
+        nodes += s.nodes;
+    }
+    printf("  %u scrambles of 20: %.3f s, longest %u moves, %llu nodes\n", SCRAMBLES, wall_seconds() - start,
+           longest, (unsigned long long)nodes);
+    return report("two-phase", ok);
+}
+
+/* Optimal lengths never exceed the scramble; the 14-move T permutation has
+ * an 11-move optimum in the half-turn metric */
+static bool check_optimal(const rubik_pdb_t* pdb) {
+    bool ok = true;
+    double start = wall_seconds();
+    for (uint32_t k = 0; k < SCRAMBLES; k++) {
+        rubik_cubie_t c;
+        uint8_t moves[11];
+        scramble(&c, moves, 11);
+        rubik_solution_t s;
+        bool found = rtka_rubik_ida_solve_optimal(&c, pdb, 11, &s);
+        rtka_rubik_cubie_apply(&c, s.moves, s.length);
+        ok &= found && s.length <= 11U && rtka_rubik_cubie_is_solved(&c);
+    }
+    printf("  %u scrambles of 11: %.3f s\n", SCRAMBLES, wall_seconds() - start);
+
+    uint8_t moves[32];
+    rubik_cubie_t c;
+    rtka_rubik_cubie_solved(&c);
+    rtka_rubik_cubie_apply(&c, moves, parse_moves("R U R' U' R' F R2 U' R' U' R U R' F'", moves));
+    rubik_solution_t s;
+    ok &= rtka_rubik_ida_solve_optimal(&c, pdb, 14, &s) && s.length == 11U;
+    rtka_rubik_cubie_apply(&c, s.moves, s.length);
+    ok &= rtka_rubik_cubie_is_solved(&c);
+    rtka_rubik_cubie_solved(&c);
+    rtka_rubik_cubie_apply(&c, moves, parse_moves("R U R' U' R' F R2 U' R' U' R U R' F'", moves));
+    ok &= !rtka_rubik_ida_solve_optimal(&c, pdb, 10, &s);
+    return report("optimal", ok);
+}
+
+/* The pool search returns the serial answer; per-worker rates printed */
+static bool check_parallel(const rubik_pdb_t* pdb) {
+    rtka_thread_pool_t* pool = rtka_pool_create(PARALLEL_THREADS, 0);
+    bool ok = pool != NULL;
+    rubik_ida_worker_stats_t stats[PARALLEL_THREADS + 1U];
+    double serial = 0.0, parallel = 0.0;
+    for (uint32_t k = 0; ok && k < 4; k++) {
+        rubik_cubie_t c;
+        uint8_t moves[13];
+        scramble(&c, moves, 13);
+        rubik_solution_t a, b;
+        double start = wall_seconds();
+        bool found_a = rtka_rubik_ida_solve_optimal(&c, pdb, 13, &a);
+        serial += wall_seconds() - start;
+        start = wall_seconds();
+        bool found_b = rtka_rubik_ida_solve_optimal_parallel(&c, pdb, 13, pool, &b, stats, PARALLEL_THREADS + 1U);
+        parallel += wall_seconds() - start;
+        ok &= found_a && found_b && a.length == b.length && memcmp(a.moves, b.moves, a.length) == 0;
+    }
+    printf("  4 scrambles of 13: serial %.3f s, %u threads %.3f s\n", serial, PARALLEL_THREADS + 1U, parallel);
+    for (uint32_t w = 0; ok && w <= PARALLEL_THREADS; w++) {
+        printf("  worker %u: %3u subtrees, %.2f M nodes/s\n", w, stats[w].subtrees, stats[w].nodes_per_second * 1e-6);
+    }
+
+    /* Nothing within the bound: every subtree searched, none claimed */
+    rubik_cubie_t c;
+    uint8_t moves[32];
+    rtka_rubik_cubie_solved(&c);
+    rtka_rubik_cubie_apply(&c, moves, parse_moves("R U R' U' R' F R2 U' R' U' R U R' F'", moves));
+    rubik_solution_t s;
+    ok &= ok && !rtka_rubik_ida_solve_optimal_parallel(&c, pdb, 10, pool, &s, NULL, 0) && s.nodes > 0;
+    ok &= ok && rtka_rubik_ida_solve_optimal_parallel(&c, pdb, 11, pool, &s, NULL, 0) && s.length == 11U;
+    rtka_pool_destroy(pool);
+    return report("parallel", ok);
+}
+
+/* The 324-state cube solves through its cubies and its bits agree */
+static bool check_324(const rubik_pdb_t* pdb) {
+    rubik_324_state_t* cube = rtka_rubik_324_create_solved();
+    bool ok = cube != NULL;
+    for (uint32_t i = 0; ok && i < 40; i++) rtka_rubik_324_rotate(cube, (rubik_324_move_t)(rand() % MOVE_324_COUNT));
+    ok &= ok && !rtka_rubik_324_is_solved(cube);
+    rubik_solution_t s;
+    ok &= ok && rtka_rubik_324_solve_ida(cube, pdb, 24, false, &s);
+    rubik_cubie_t cubies;
+    ok &= ok && rtka_rubik_324_cubies(cube, &cubies) && rtka_rubik_cubie_is_solved(&cubies);
+
+    /* R then L is L then R on the sticker bits too */
+    rubik_324_state_t* a = rtka_rubik_324_create_solved();
+    rubik_324_state_t* b = rtka_rubik_324_create_solved();
+    rtka_rubik_324_rotate(a, MOVE_324_R);
+    rtka_rubik_324_rotate(a, MOVE_324_L);
+    rtka_rubik_324_rotate(b, MOVE_324_L);
+    rtka_rubik_324_rotate(b, MOVE_324_R);
+    for (uint32_t i = 0; i < 3; i++) {
+        rtka_rubik_324_rotate(a, MOVE_324_R);
+        rtka_rubik_324_rotate(a, MOVE_324_L);
+        rtka_rubik_324_rotate(a, MOVE_324_L);
+        rtka_rubik_324_rotate(a, MOVE_324_R);
+    }
+    ok &= rtka_rubik_324_is_solved(a) == false;
+    for (uint32_t i = 0; i < 3; i++) {
+        rtka_rubik_324_rotate(b, MOVE_324_R);
+        rtka_rubik_324_rotate(b, MOVE_324_L);
+    }
+    ok &= rtka_rubik_324_is_solved(b);
+    rtka_rubik_324_free(a);
+    rtka_rubik_324_free(b);
+    rtka_rubik_324_free(cube);
+    return report("324 view", ok);
+}
+
+int main(void) {
+    printf("RTKA Rubik IDA* Test\n");
+    printf("====================\n\n");
+    srand(31);
+
+    bool ok = check_cubies();
+
+    double start = wall_seconds();
+    rubik_pdb_t* pdb = NULL;
+    bool opened = rtka_rubik_pdb_open(&pdb, PDB_PATH, RUBIK_PDB_CORNERS) == RTKA_SUCCESS;
+    printf("  databases ready in %.2f s\n", wall_seconds() - start);
+    ok &= report("pdb open", opened && (rtka_rubik_pdb_flags(pdb) & RUBIK_PDB_CORNERS));
+    if (opened) {
+        ok &= check_pdb_files(pdb);
+        ok &= check_two_phase(pdb);
+        ok &= check_optimal(pdb);
+        ok &= check_parallel(pdb);
+        ok &= check_324(pdb);
+    }
+    rtka_rubik_pdb_free(pdb);
+
+    printf("\n%s\n", ok ? "All solutions verified" : "Mismatch detected");
+    return ok ? 0 : 1;
+}
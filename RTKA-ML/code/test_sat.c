@@ -10,44 +10,376 @@
  *
  */
 
+#define _GNU_SOURCE
 #include "rtka_sat.h"
+#include "rtka_sat_dimacs.h"
+#include "rtka_sat_portfolio.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#define BRUTE_VARS      12U
+#define BRUTE_CLAUSES   52U
+#define BRUTE_ROUNDS    300U
+#define ASSUME_VARS     60U
+#define ASSUME_CLAUSES  240U
+#define ASSUME_QUERIES  400U
+#define PLANTED_VARS    40000U
+#define PLANTED_CLAUSES 120000U
+
+static bool report(const char* name, bool ok) {
+    printf("%-16s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static int32_t random_literal(uint32_t vars) {
+    int32_t v = (int32_t)(rand() % vars) + 1;
+    return rand() & 1 ? v : -v;
+}
+
+static bool brute_force(const int32_t* clauses, uint32_t count, uint32_t vars) {
+    for (uint32_t mask = 0; mask < (1U << vars); mask++) {
+        bool all = true;
+        for (uint32_t c = 0; c < count && all; c++) {
+            bool any = false;
+            for (uint32_t k = 0; k < 3 && !any; k++) {
+                int32_t l = clauses[3 * c + k];
+                bool bit = (mask >> (abs(l) - 1)) & 1U;
+                any = l > 0 ? bit : !bit;
+            }
+            all = any;
+        }
+        if (all) return true;
+    }
+    return false;
+}
+
+/* Random 3-SAT near the threshold, checked against exhaustive search */
+static bool check_brute_force(void) {
+    int32_t clauses[3 * BRUTE_CLAUSES];
+    uint32_t sat_count = 0;
+    bool ok = true;
+    for (uint32_t round = 0; round < BRUTE_ROUNDS && ok; round++) {
+        sat_state_t state;
+        rtka_sat_init(&state, BRUTE_VARS);
+        for (uint32_t c = 0; c < BRUTE_CLAUSES; c++) {
+            for (uint32_t k = 0; k < 3; k++) clauses[3 * c + k] = random_literal(BRUTE_VARS);
+            rtka_sat_add_clause(&state, &clauses[3 * c], 3);
+        }
+        bool sat = rtka_sat_solve(&state);
+        ok = sat == brute_force(clauses, BRUTE_CLAUSES, BRUTE_VARS) &&
+             (!sat || rtka_sat_is_satisfied(&state));
+        sat_count += sat;
+        rtka_sat_free(&state);
+    }
+    printf("  %u instances, %u satisfiable\n", BRUTE_ROUNDS, sat_count);
+    return report("brute force", ok);
+}
+
+/* n + 1 pigeons into n holes has no solution */
+static void pigeonhole(sat_state_t* state, uint32_t holes) {
+    uint32_t pigeons = holes + 1;
+    rtka_sat_init(state, pigeons * holes);
+
+    int32_t clause[16];
+    for (uint32_t p = 0; p < pigeons; p++) {
+        for (uint32_t h = 0; h < holes; h++) clause[h] = (int32_t)(p * holes + h + 1);
+        rtka_sat_add_clause(state, clause, holes);
+    }
+    for (uint32_t h = 0; h < holes; h++) {
+        for (uint32_t p = 0; p < pigeons; p++) {
+            for (uint32_t q = p + 1; q < pigeons; q++) {
+                int32_t pair[] = {-(int32_t)(p * holes + h + 1), -(int32_t)(q * holes + h + 1)};
+                rtka_sat_add_clause(state, pair, 2);
+            }
+        }
+    }
+}
+
+static bool check_pigeonhole(uint32_t holes) {
+    uint32_t pigeons = holes + 1;
+    sat_state_t state;
+    pigeonhole(&state, holes);
+
+    state.proof = tmpfile();
+    clock_t start = clock();
+    bool sat = rtka_sat_solve(&state);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("  %u pigeons: %llu conflicts, %u restarts, %u learned clauses deleted, %.3f s\n",
+           pigeons, (unsigned long long)state.conflicts, state.restarts, state.deleted, elapsed);
+
+    /* Proof: one line per learned clause, deletions marked, empty clause last */
+    uint32_t lines = 0, deletions = 0;
+    char line[4096], last[4096] = "";
+    rewind(state.proof);
+    while (fgets(line, sizeof(line), state.proof)) {
+        lines++;
+        deletions += line[0] == 'd';
+        strcpy(last, line);
+    }
+    fclose(state.proof);
+    bool proof_ok = lines == state.learned + deletions + 1 && deletions == state.deleted &&
+                    strcmp(last, "0\n") == 0;
+    printf("  DRAT proof: %u lines, %u deletions\n", lines, deletions);
+    rtka_sat_free(&state);
+    return report("pigeonhole", !sat) & report("drat proof", proof_ok);
+}
+
+static bool solve_fresh(const int32_t* clauses, const int32_t* units, uint32_t n) {
+    sat_state_t state;
+    rtka_sat_init(&state, ASSUME_VARS);
+    for (uint32_t c = 0; c < ASSUME_CLAUSES; c++) rtka_sat_add_clause(&state, (int32_t*)&clauses[3 * c], 3);
+    for (uint32_t i = 0; i < n; i++) rtka_sat_add_clause(&state, (int32_t*)&units[i], 1);
+    bool sat = rtka_sat_solve(&state);
+    rtka_sat_free(&state);
+    return sat;
+}
+
+/* One retained solver answering many assumption queries must agree with a
+ * fresh solver given the assumptions as unit clauses, and a refutation's
+ * failed set must be unsatisfiable on its own */
+static bool check_assumptions(void) {
+    int32_t clauses[3 * ASSUME_CLAUSES];
+    sat_state_t state;
+    rtka_sat_init(&state, ASSUME_VARS);
+    for (uint32_t c = 0; c < ASSUME_CLAUSES; c++) {
+        for (uint32_t k = 0; k < 3; k++) clauses[3 * c + k] = random_literal(ASSUME_VARS);
+        rtka_sat_add_clause(&state, &clauses[3 * c], 3);
+    }
+
+    bool ok = true;
+    uint32_t refuted = 0;
+    double incremental = 0.0, rebuilt = 0.0;
+    for (uint32_t q = 0; q < ASSUME_QUERIES && ok; q++) {
+        int32_t assume[8];
+        uint32_t n = 1 + (uint32_t)rand() % 8;
+        for (uint32_t i = 0; i < n; i++) assume[i] = random_literal(ASSUME_VARS);
+
+        clock_t start = clock();
+        bool sat = rtka_sat_solve_assuming(&state, assume, n);
+        incremental += (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        bool want = solve_fresh(clauses, assume, n);
+        rebuilt += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        ok = sat == want && !state.inconsistent;
+        if (ok && sat) {
+            ok = rtka_sat_is_satisfied(&state);
+            for (uint32_t i = 0; i < n && ok; i++) {
+                ok = state.variables[abs(assume[i])].value == (assume[i] > 0 ? RTKA_TRUE : RTKA_FALSE);
+            }
+        } else if (ok) {
+            refuted++;
+            ok = state.num_failed > 0 && !solve_fresh(clauses, state.failed, state.num_failed);
+            for (uint32_t f = 0; f < state.num_failed && ok; f++) {
+                bool given = false;
+                for (uint32_t i = 0; i < n; i++) given = given || assume[i] == state.failed[f];
+                ok = given;
+            }
+        }
+    }
+    printf("  %u queries, %u refuted, %u clauses learned: %.3f s incremental, %.3f s rebuilt\n",
+           ASSUME_QUERIES, refuted, state.learned, incremental, rebuilt);
+    ok = report("assumptions", ok);
+
+    /* Clauses added after a solve: forbid the last model, then contradict */
+    bool grew = rtka_sat_solve(&state);
+    int32_t block[ASSUME_VARS];
+    for (uint32_t v = 1; v <= ASSUME_VARS; v++) {
+        block[v - 1] = state.variables[v].value == RTKA_TRUE ? -(int32_t)v : (int32_t)v;
+    }
+    rtka_sat_add_clause(&state, block, ASSUME_VARS);
+    bool next = rtka_sat_solve(&state);
+    bool differs = false;
+    for (uint32_t v = 1; v <= ASSUME_VARS && next; v++) {
+        differs = differs || state.variables[v].value != (block[v - 1] > 0 ? RTKA_FALSE : RTKA_TRUE);
+    }
+    int32_t x = 1, not_x = -1;
+    rtka_sat_add_clause(&state, &x, 1);
+    rtka_sat_add_clause(&state, &not_x, 1);
+    grew = grew && (!next || differs) && !rtka_sat_solve(&state) && state.inconsistent;
+    rtka_sat_free(&state);
+    return ok & report("added clauses", grew);
+}
+
+/* Four diversified instances on three pool workers plus the caller */
+static bool check_portfolio(void) {
+    rtka_thread_pool_t* pool = rtka_pool_create(3, 0);
+    if (!pool) return report("portfolio", false);
+
+    int32_t clauses[3 * BRUTE_CLAUSES];
+    bool ok = true;
+    for (uint32_t round = 0; round < BRUTE_ROUNDS / 6 && ok; round++) {
+        sat_state_t state;
+        rtka_sat_init(&state, BRUTE_VARS);
+        for (uint32_t c = 0; c < BRUTE_CLAUSES; c++) {
+            for (uint32_t k = 0; k < 3; k++) clauses[3 * c + k] = random_literal(BRUTE_VARS);
+            rtka_sat_add_clause(&state, &clauses[3 * c], 3);
+        }
+        bool sat = rtka_sat_solve_portfolio(&state, pool, 4);
+        ok = sat == brute_force(clauses, BRUTE_CLAUSES, BRUTE_VARS) &&
+             (sat ? rtka_sat_is_satisfied(&state) : state.inconsistent);
+        rtka_sat_free(&state);
+    }
+    ok = report("portfolio", ok);
+
+    sat_state_t state;
+    pigeonhole(&state, 8);
+    clock_t start = clock();
+    bool sat = rtka_sat_solve_portfolio(&state, pool, 4);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("  9 pigeons, 4 instances: %u clauses imported by instance 0, %.3f s cpu\n",
+           state.imported, elapsed);
+    ok &= report("portfolio unsat", !sat && state.inconsistent);
+    rtka_sat_free(&state);
+
+    rtka_pool_destroy(pool);
+    return ok;
+}
+
+/* In-memory CNF: comments, clauses across lines, SATLIB "%" trailer */
+static bool check_dimacs_text(void) {
+    const char* cnf = "c example\n"
+                      "p cnf 3 4\n"
+                      "1 2 0\n"
+                      "-1\n 3 0 -2 -3 0\n"
+                      "c between clauses\n"
+                      "1 3 0\n"
+                      "%\n0\n";
+    sat_state_t state;
+    bool ok = rtka_sat_parse_dimacs(&state, cnf, strlen(cnf)) == RTKA_SUCCESS &&
+              state.num_vars == 3 && state.num_clauses == 4 &&
+              rtka_sat_solve(&state) && rtka_sat_is_satisfied(&state);
+    rtka_sat_free(&state);
+
+    const char* headerless = "1 2 0\n";
+    const char* out_of_range = "p cnf 2 1\n1 3 0\n";
+    const char* junk = "p cnf 2 1\n1 2x 0\n";
+    ok &= rtka_sat_parse_dimacs(&state, headerless, strlen(headerless)) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sat_free(&state);
+    ok &= rtka_sat_parse_dimacs(&state, out_of_range, strlen(out_of_range)) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sat_free(&state);
+    ok &= rtka_sat_parse_dimacs(&state, junk, strlen(junk)) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sat_free(&state);
+    return report("dimacs parse", ok);
+}
+
+/* "v" lines of a written model must repeat the solver's assignment */
+static bool model_round_trip(const sat_state_t* state) {
+    FILE* f = tmpfile();
+    if (!f || rtka_sat_write_model(state, true, f) != RTKA_SUCCESS) return false;
+    rewind(f);
+
+    char token[32];
+    bool ok = fscanf(f, "%31s", token) == 1 && strcmp(token, "s") == 0 &&
+              fscanf(f, "%31s", token) == 1 && strcmp(token, "SATISFIABLE") == 0;
+    uint32_t seen = 0;
+    while (ok && fscanf(f, "%31s", token) == 1) {
+        if (strcmp(token, "v") == 0) continue;
+        long lit = strtol(token, NULL, 10);
+        if (lit == 0) break;
+        rtka_value_t want = lit > 0 ? RTKA_TRUE : RTKA_FALSE;
+        ok = (uint32_t)labs(lit) == seen + 1 && state->variables[labs(lit)].value == want;
+        seen++;
+    }
+    fclose(f);
+    return ok && seen == state->num_vars;
+}
+
+/* Large random 3-SAT with a hidden solution every clause agrees with */
+static bool check_planted(void) {
+    bool* hidden = (bool*)malloc((PLANTED_VARS + 1) * sizeof(bool));
+    for (uint32_t v = 1; v <= PLANTED_VARS; v++) hidden[v] = rand() & 1;
+
+    char path[] = "/tmp/rtka_sat_XXXXXX";
+    int fd = mkstemp(path);
+    FILE* f = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!f) {
+        free(hidden);
+        return report("planted 3-SAT", false);
+    }
+    fprintf(f, "c planted 3-SAT\np cnf %u %u\n", PLANTED_VARS, PLANTED_CLAUSES);
+    for (uint32_t c = 0; c < PLANTED_CLAUSES; c++) {
+        int32_t lits[3];
+        bool agrees = false;
+        while (!agrees) {
+            for (uint32_t k = 0; k < 3; k++) {
+                lits[k] = random_literal(PLANTED_VARS);
+                agrees = agrees || (lits[k] > 0) == hidden[abs(lits[k])];
+            }
+        }
+        fprintf(f, "%d %d %d 0\n", lits[0], lits[1], lits[2]);
+    }
+    fclose(f);
+
+    sat_state_t state;
+    clock_t start = clock();
+    rtka_error_t err = rtka_sat_load_dimacs(&state, path);
+    double load = (double)(clock() - start) / CLOCKS_PER_SEC;
+    unlink(path);
+
+    start = clock();
+    bool sat = err == RTKA_SUCCESS && rtka_sat_solve(&state);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("  %u vars, %u clauses: loaded in %.3f s, %llu conflicts, %llu decisions, %.3f s\n",
+           state.num_vars, state.num_clauses, load, (unsigned long long)state.conflicts,
+           (unsigned long long)state.decisions, elapsed);
+    bool ok = sat && rtka_sat_is_satisfied(&state) &&
+              state.assigned == PLANTED_VARS;
+    bool model = sat && model_round_trip(&state);
+    rtka_sat_free(&state);
+    free(hidden);
+    return report("planted 3-SAT", ok) & report("model output", model);
+}
 
 int main(void) {
     printf("RTKA SAT Test\n");
     printf("=============\n\n");
-    
+
     sat_state_t state;
     rtka_sat_init(&state, 3);
-    
+
     int32_t c1[] = {1, 2};
     int32_t c2[] = {-1, 3};
     int32_t c3[] = {-2, -3};
     int32_t c4[] = {1, 3};
-    
+
     rtka_sat_add_clause(&state, c1, 2);
     rtka_sat_add_clause(&state, c2, 2);
     rtka_sat_add_clause(&state, c3, 2);
     rtka_sat_add_clause(&state, c4, 2);
-    
+
     printf("Formula: (x1∨x2) ∧ (¬x1∨x3) ∧ (¬x2∨¬x3) ∧ (x1∨x3)\n\n");
-    
+
     clock_t start = clock();
     bool sat = rtka_sat_solve(&state);
     double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
-    
+
     if (sat) {
         printf("✅ SATISFIABLE in %.6f seconds\n", elapsed);
         printf("Solution: ");
         for (uint32_t v = 1; v <= 3; v++) {
-            printf("x%d=%s ", v, 
+            printf("x%d=%s ", v,
                    state.variables[v].value == RTKA_TRUE ? "T" : "F");
         }
         printf("\nRTKA transitions: %d\n", state.rtka_transitions);
     } else {
         printf("❌ UNSATISFIABLE\n");
     }
-    
-    return 0;
+    bool ok = sat && rtka_sat_is_satisfied(&state);
+    rtka_sat_free(&state);
+
+    printf("\n");
+    srand(21);
+    ok &= check_brute_force();
+    ok &= check_dimacs_text();
+    ok &= check_pigeonhole(7);
+    ok &= check_planted();
+    ok &= check_assumptions();
+    ok &= check_portfolio();
+
+    printf("\n%s\n", ok ? "CDCL results verified" : "Mismatch detected");
+    return ok ? 0 : 1;
 }
@@ -0,0 +1,314 @@
+/**
+ * File: test_solver.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Generic CSP Solver - min-conflicts, arc consistency and parallel modes
+ */
+
+#include "rtka_solver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAE_VARS        2000U
+#define NAE_PER_VAR     3U          /* Triples = NAE_VARS * NAE_PER_VAR / 2 */
+
+static bool report(const char* name, bool ok) {
+    printf("%-16s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Not-all-equal: some pair of the scope differs */
+static bool not_all_equal(const rtka_state_t* vars, uint32_t count) {
+    for (uint32_t i = 1; i < count; i++) {
+        if (vars[i].value != vars[0].value) return true;
+    }
+    return false;
+}
+
+static bool pinned_true(const rtka_state_t* vars, uint32_t count) {
+    (void)count;
+    return vars[0].value == RTKA_TRUE;
+}
+
+static bool differ(const rtka_state_t* vars, uint32_t count) {
+    (void)count;
+    return vars[0].value != vars[1].value;
+}
+
+static bool pinned_false(const rtka_state_t* vars, uint32_t count) {
+    (void)count;
+    return vars[0].value == RTKA_FALSE;
+}
+
+typedef struct {
+    rtka_csp_t csp;
+    rtka_constraint_t* storage;
+    uint32_t* scopes;
+    int8_t* planted;
+    rtka_domain_t* domains;
+} nae_problem_t;
+
+/* Random NAE triples that all hold under a planted assignment, plus a
+ * unary constraint pinning x0; built by hand so the test owns all memory */
+static bool nae_build(nae_problem_t* p, uint32_t nv, uint32_t triples) {
+    uint32_t nc = triples + 1U;
+    p->csp.num_variables = nv;
+    p->csp.num_constraints = nc;
+    p->csp.variables = (rtka_state_t*)calloc(nv, sizeof(rtka_state_t));
+    p->csp.constraints = (rtka_constraint_t**)calloc(nc, sizeof(rtka_constraint_t*));
+    p->csp.domain_sizes = NULL;
+    p->csp.domains = NULL;
+    p->storage = (rtka_constraint_t*)calloc(nc, sizeof(rtka_constraint_t));
+    p->scopes = (uint32_t*)calloc((size_t)triples * 3U + 1U, sizeof(uint32_t));
+    p->planted = (int8_t*)calloc(nv, 1);
+    if (!p->csp.variables || !p->csp.constraints || !p->storage || !p->scopes || !p->planted) return false;
+
+    for (uint32_t v = 0; v < nv; v++) {
+        p->planted[v] = (rand() & 1) ? RTKA_TRUE : RTKA_FALSE;
+        p->csp.variables[v] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
+    }
+    p->planted[0] = RTKA_TRUE;
+
+    for (uint32_t t = 0; t < triples; t++) {
+        uint32_t* scope = &p->scopes[3U * t];
+        do {
+            scope[0] = (uint32_t)rand() % nv;
+            scope[1] = (uint32_t)rand() % nv;
+            scope[2] = (uint32_t)rand() % nv;
+        } while (scope[0] == scope[1] || scope[1] == scope[2] || scope[0] == scope[2] ||
+                 (p->planted[scope[0]] == p->planted[scope[1]] && p->planted[scope[1]] == p->planted[scope[2]]));
+        p->storage[t] = (rtka_constraint_t){CONSTRAINT_TERNARY, scope, 3, not_all_equal, NULL};
+        p->csp.constraints[t] = &p->storage[t];
+    }
+    p->storage[triples] = (rtka_constraint_t){CONSTRAINT_TERNARY, &p->scopes[3U * triples], 1, pinned_true, NULL};
+    p->csp.constraints[triples] = &p->storage[triples];
+    return true;
+}
+
+/* Exam timetabling: each variable takes one of three slots (FALSE /
+ * UNKNOWN / TRUE as slot values) and each conflict pair must differ; the
+ * pairs are drawn across a planted timetable so one always exists */
+static bool slots_build(nae_problem_t* p, uint32_t nv, uint32_t pairs) {
+    p->csp.num_variables = nv;
+    p->csp.num_constraints = pairs;
+    p->csp.variables = (rtka_state_t*)calloc(nv, sizeof(rtka_state_t));
+    p->csp.constraints = (rtka_constraint_t**)calloc(pairs ? pairs : 1U, sizeof(rtka_constraint_t*));
+    p->storage = (rtka_constraint_t*)calloc(pairs ? pairs : 1U, sizeof(rtka_constraint_t));
+    p->scopes = (uint32_t*)calloc((size_t)pairs * 2U + 1U, sizeof(uint32_t));
+    p->planted = (int8_t*)calloc(nv, 1);
+    p->domains = (rtka_domain_t*)calloc(nv, sizeof(rtka_domain_t));
+    if (!p->csp.variables || !p->csp.constraints || !p->storage || !p->scopes || !p->planted || !p->domains) return false;
+
+    for (uint32_t v = 0; v < nv; v++) {
+        p->planted[v] = (int8_t)(rand() % 3 - 1);
+        p->csp.variables[v] = rtka_make_state(RTKA_UNKNOWN, 0.5f);
+        p->domains[v] = RTKA_DOMAIN_ALL;
+    }
+    p->csp.domains = p->domains;
+    for (uint32_t t = 0; t < pairs; t++) {
+        uint32_t* scope = &p->scopes[2U * t];
+        do {
+            scope[0] = (uint32_t)rand() % nv;
+            scope[1] = (uint32_t)rand() % nv;
+        } while (p->planted[scope[0]] == p->planted[scope[1]]);
+        p->storage[t] = (rtka_constraint_t){CONSTRAINT_TERNARY, scope, 2, differ, NULL};
+        p->csp.constraints[t] = &p->storage[t];
+    }
+    return true;
+}
+
+static void nae_free(nae_problem_t* p) {
+    free(p->domains);
+    free(p->csp.variables);
+    free(p->csp.constraints);
+    free(p->storage);
+    free(p->scopes);
+    free(p->planted);
+}
+
+/* Every constraint re-checked against the final assignment */
+static bool nae_satisfied(const nae_problem_t* p) {
+    for (uint32_t c = 0; c < p->csp.num_constraints; c++) {
+        const rtka_constraint_t* k = p->csp.constraints[c];
+        rtka_state_t vals[3];
+        for (uint32_t j = 0; j < k->num_vars; j++) vals[j] = p->csp.variables[k->variables[j]];
+        if (!k->check_fn(vals, k->num_vars)) return false;
+    }
+    for (uint32_t v = 0; v < p->csp.num_variables; v++) {
+        if (p->csp.variables[v].confidence != 1.0f) return false;
+    }
+    return true;
+}
+
+static bool check_planted(void) {
+    nae_problem_t p = {0};
+    srand(28);
+    bool ok = nae_build(&p, NAE_VARS, NAE_VARS * NAE_PER_VAR / 2U);
+    double start = wall_seconds();
+    ok &= ok && rtka_solver_min_conflicts(&p.csp, 0, 28);
+    double seconds = wall_seconds() - start;
+    ok &= nae_satisfied(&p);
+    const rtka_solver_stats_t* stats = rtka_solver_get_stats();
+    printf("  %u vars, %u triples: %.3f s, %llu flips\n", NAE_VARS, NAE_VARS * NAE_PER_VAR / 2U, seconds,
+           (unsigned long long)stats->nodes_explored);
+    nae_free(&p);
+    return report("planted NAE", ok);
+}
+
+/* Definite starting values with full confidence are kept, so an already
+ * satisfying assignment costs no flips; the strategy entry point agrees */
+static bool check_warm_start(void) {
+    nae_problem_t p = {0};
+    srand(29);
+    bool ok = nae_build(&p, 200, 300);
+    for (uint32_t v = 0; ok && v < 200; v++) p.csp.variables[v] = rtka_make_state(p.planted[v], 1.0f);
+    ok &= ok && rtka_solver_solve(&p.csp, SEARCH_MIN_CONFLICTS) && nae_satisfied(&p);
+    ok &= rtka_solver_get_stats()->nodes_explored == 0;
+    for (uint32_t v = 0; ok && v < 200; v++) ok &= p.csp.variables[v].value == p.planted[v];
+    nae_free(&p);
+    return report("warm start", ok);
+}
+
+/* x0 pinned TRUE and FALSE at once: restarts run out */
+static bool check_unsat(void) {
+    nae_problem_t p = {0};
+    srand(30);
+    bool ok = nae_build(&p, 4, 1);
+    p.storage[0] = (rtka_constraint_t){CONSTRAINT_TERNARY, &p.scopes[3], 1, pinned_false, NULL};
+    ok &= ok && !rtka_solver_min_conflicts(&p.csp, 0, 1);
+    nae_free(&p);
+
+    ok &= !rtka_solver_min_conflicts(NULL, 0, 1);
+    return report("unsatisfiable", ok);
+}
+
+static bool check_timetable(void) {
+    nae_problem_t p = {0};
+    srand(29);
+    bool ok = slots_build(&p, 1000, 2000);
+    double start = wall_seconds();
+    ok &= ok && rtka_solver_solve(&p.csp, SEARCH_ARC_CONSISTENCY);
+    double seconds = wall_seconds() - start;
+    ok &= nae_satisfied(&p);
+    for (uint32_t v = 0; ok && v < 1000; v++) {
+        ok &= p.domains[v] == (rtka_domain_t)(1U << (p.csp.variables[v].value + 1));
+    }
+    const rtka_solver_stats_t* stats = rtka_solver_get_stats();
+    printf("  1000 exams, 2000 conflicts: %.3f s, %u nodes, %u backtracks, %u checks\n", seconds,
+           stats->nodes_explored, stats->backtracks, stats->constraint_checks);
+    nae_free(&p);
+    return report("timetable AC", ok);
+}
+
+/* A chain of differ pairs from a pinned TRUE settles by propagation alone,
+ * and four mutually conflicting exams do not fit three slots */
+static bool check_propagation(void) {
+    nae_problem_t p = {0};
+    bool ok = slots_build(&p, 100, 99);
+    p.csp.domains = NULL;                              /* Binary defaults */
+    p.csp.variables[0] = rtka_make_state(RTKA_TRUE, 1.0f);
+    for (uint32_t t = 0; ok && t < 99; t++) {
+        p.scopes[2U * t] = t;
+        p.scopes[2U * t + 1U] = t + 1U;
+    }
+    ok &= ok && rtka_solver_arc_consistency(&p.csp);
+    for (uint32_t v = 0; ok && v < 100; v++) ok &= p.csp.variables[v].value == ((v & 1U) ? RTKA_FALSE : RTKA_TRUE);
+    nae_free(&p);
+
+    nae_problem_t k4 = {0};
+    ok &= slots_build(&k4, 4, 6);
+    for (uint32_t i = 0, t = 0; ok && i < 4; i++) {
+        for (uint32_t j = i + 1U; j < 4; j++, t++) {
+            k4.scopes[2U * t] = i;
+            k4.scopes[2U * t + 1U] = j;
+        }
+    }
+    ok &= rtka_solver_arc_consistency(&k4.csp);        /* Pairwise consistent... */
+    ok &= !rtka_solver_solve(&k4.csp, SEARCH_ARC_CONSISTENCY);    /* ...but no timetable */
+    ok &= rtka_solver_get_stats()->backtracks > 0;
+    nae_free(&k4);
+    return report("propagation", ok);
+}
+
+/* 3-colourings of a 16-cycle: (k - 1)^n + (k - 1) = 2^16 + 2, counted
+ * sequentially and split across a pool, with max_solutions stopping early */
+static bool check_find_all(void) {
+    nae_problem_t p = {0};
+    bool ok = slots_build(&p, 16, 16);
+    for (uint32_t t = 0; ok && t < 16; t++) {
+        p.scopes[2U * t] = t;
+        p.scopes[2U * t + 1U] = (t + 1U) % 16U;
+    }
+    rtka_thread_pool_t* pool = rtka_pool_create(3, 0);
+    ok &= pool != NULL;
+    ok &= rtka_solver_find_all_solutions(&p.csp, NULL, 0) == 65538U;
+    uint32_t sequential_nodes = rtka_solver_get_stats()->nodes_explored;
+
+    ok &= rtka_solver_find_all_parallel(&p.csp, NULL, 0, 0, pool) == 65538U;
+    const rtka_solver_stats_t* stats = rtka_solver_get_stats();
+    printf("  16-cycle: %u nodes sequential, %u split across 4 threads\n", sequential_nodes, stats->nodes_explored);
+    ok &= stats->nodes_explored >= sequential_nodes;
+
+    static rtka_state_t rows[10][16];
+    rtka_state_t* solutions[10];
+    for (uint32_t i = 0; i < 10; i++) solutions[i] = rows[i];
+    ok &= rtka_solver_find_all_parallel(&p.csp, solutions, 10, 3, pool) == 10U;
+    for (uint32_t i = 0; ok && i < 10; i++) {
+        for (uint32_t v = 0; v < 16; v++) ok &= rows[i][v].value != rows[i][(v + 1U) % 16U].value;
+    }
+    ok &= rtka_solver_find_all_solutions(&p.csp, solutions, 10) == 10U;
+    for (uint32_t v = 0; ok && v < 16; v++) ok &= rows[0][v].value == ((v & 1U) ? RTKA_FALSE : RTKA_TRUE);
+
+    nae_free(&p);
+    rtka_pool_destroy(pool);
+    return report("find all", ok);
+}
+
+static bool check_parallel(void) {
+    nae_problem_t p = {0};
+    srand(29);
+    bool ok = slots_build(&p, 1000, 2000);
+    rtka_thread_pool_t* pool = rtka_pool_create(3, 0);
+    ok &= ok && pool && rtka_solver_solve_parallel(&p.csp, 6, pool);
+    ok &= nae_satisfied(&p);
+    const rtka_solver_stats_t* stats = rtka_solver_get_stats();
+    printf("  timetable on 4 threads: %u nodes, %u backtracks\n", stats->nodes_explored, stats->backtracks);
+
+    /* Pinned into conflict: AC fails at the root and no subtree is run */
+    p.csp.domains[0] = p.csp.domains[1] = RTKA_DOMAIN_TRUE;
+    p.scopes[0] = 0;
+    p.scopes[1] = 1;
+    ok &= !rtka_solver_solve_parallel(&p.csp, 4, pool);
+    nae_free(&p);
+    rtka_pool_destroy(pool);
+    return report("parallel solve", ok);
+}
+
+int main(void) {
+    printf("RTKA CSP Solver Test\n");
+    printf("====================\n\n");
+
+    bool ok = check_planted();
+    ok &= check_warm_start();
+    ok &= check_unsat();
+    ok &= check_timetable();
+    ok &= check_propagation();
+    ok &= check_find_all();
+    ok &= check_parallel();
+
+    printf("\n%s\n", ok ? "All constraints verified" : "Mismatch detected");
+    return ok ? 0 : 1;
+}
@@ -15,6 +15,61 @@
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define BATCH_PUZZLES   30000U
+#define FILE_PUZZLES    64U
+
+static bool report(const char* name, bool ok) {
+    printf("%-16s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+/* A complete grid consistent with the clues of the puzzle */
+static bool grid_solves(const char* solved, const char* clues) {
+    uint16_t row[9] = {0}, col[9] = {0}, box[9] = {0};
+    for (uint32_t cell = 0; cell < 81; cell++) {
+        if (solved[cell] < '1' || solved[cell] > '9') return false;
+        if (clues[cell] >= '1' && clues[cell] <= '9' && clues[cell] != solved[cell]) return false;
+        uint16_t bit = (uint16_t)(1U << (solved[cell] - '1'));
+        uint32_t r = cell / 9, c = cell % 9, b = get_box(r, c);
+        if ((row[r] | col[c] | box[b]) & bit) return false;
+        row[r] |= bit;
+        col[c] |= bit;
+        box[b] |= bit;
+    }
+    return true;
+}
+
+/* Validity-preserving shuffle: relabel digits, swap rows inside each band,
+ * optionally transpose */
+static void transform_puzzle(char* out, const char* in) {
+    char digits[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    for (uint32_t i = 8; i > 0; i--) {
+        uint32_t j = (uint32_t)rand() % (i + 1);
+        char t = digits[i];
+        digits[i] = digits[j];
+        digits[j] = t;
+    }
+    uint32_t rows[9];
+    for (uint32_t band = 0; band < 3; band++) {
+        uint32_t perm[3] = {0, 1, 2};
+        for (uint32_t i = 2; i > 0; i--) {
+            uint32_t j = (uint32_t)rand() % (i + 1);
+            uint32_t t = perm[i];
+            perm[i] = perm[j];
+            perm[j] = t;
+        }
+        for (uint32_t i = 0; i < 3; i++) rows[band * 3 + i] = band * 3 + perm[i];
+    }
+    bool transpose = rand() & 1;
+    for (uint32_t r = 0; r < 9; r++) {
+        for (uint32_t c = 0; c < 9; c++) {
+            char v = in[rows[r] * 9 + c];
+            out[transpose ? c * 9 + r : r * 9 + c] = (v >= '1' && v <= '9') ? digits[v - '1'] : '.';
+        }
+    }
+}
 
 void print_header(void) {
     printf("╔════════════════════════════════════════════╗\n");
@@ -43,6 +98,112 @@ void print_analysis(sudoku_729_t* puzzle) {
     printf("└────────────────────────────────────────┘\n\n");
 }
 
+static void grid_text(char* text, uint8_t grid[9][9]) {
+    for (uint32_t cell = 0; cell < 81; cell++) {
+        uint8_t v = grid[cell / 9][cell % 9];
+        text[cell] = v ? (char)('0' + v) : '.';
+    }
+}
+
+/* Bitboard engine on the three puzzles, plus the 729 view it materializes.
+ * Solutions are checked against the clues rather than the 729 solver's
+ * grids: this Platinum Blonde transcription has more than one. */
+static bool check_bitboard(char texts[3][82]) {
+    bool ok = true, view = true;
+    for (uint32_t p = 0; p < 3; p++) {
+        uint8_t cells[81];
+        for (uint32_t i = 0; i < 81; i++) cells[i] = texts[p][i] == '.' ? 0U : (uint8_t)(texts[p][i] - '0');
+
+        sudoku_bits_t board;
+        sudoku_729_t state;
+        ok &= rtka_sudoku_bits_init(&board, cells);
+        rtka_sudoku_bits_materialize(&board, &state);
+        for (uint32_t cell = 0; cell < 81; cell++) {
+            uint32_t unknown = 0;
+            for (uint32_t d = 0; d < 9; d++) unknown += state.cell_digit[cell][d].value == RTKA_UNKNOWN;
+            if (cells[cell]) {
+                view &= state.cell_digit[cell][cells[cell] - 1U].value == RTKA_TRUE && unknown == 0;
+            } else {
+                view &= unknown == (uint32_t)count_bits(board.possible[cell]) && unknown > 0;
+            }
+        }
+
+        ok &= rtka_sudoku_bits_solve(&board);
+        char solved[82] = {0};
+        for (uint32_t i = 0; i < 81; i++) solved[i] = (char)('1' + board.solution[i]);
+        ok &= grid_solves(solved, texts[p]);
+        printf("  bitboard %u: %u guesses\n", p + 1, board.guesses);
+
+        rtka_sudoku_bits_materialize(&board, &state);
+        view &= rtka_validate_solution(&state) && state.unknown_count == 0;
+    }
+
+    uint8_t broken[81] = {5, 5};                        /* Same digit twice in a row */
+    sudoku_bits_t board;
+    ok &= !rtka_sudoku_bits_init(&board, broken);
+    return report("bitboard", ok) & report("729 view", view);
+}
+
+static bool check_batch(char texts[3][82]) {
+    size_t length = (size_t)BATCH_PUZZLES * 82U;
+    char* text = (char*)malloc(length);
+    char* clues = (char*)malloc(length);
+    if (!text || !clues) {
+        free(text);
+        free(clues);
+        return report("batch", false);
+    }
+    srand(25);
+    for (uint32_t i = 0; i < BATCH_PUZZLES; i++) {
+        transform_puzzle(text + (size_t)i * 82U, texts[i % 3]);
+        text[(size_t)i * 82U + 81U] = '\n';
+    }
+    memcpy(clues, text, length);
+
+    sudoku_batch_stats_t stats;
+    bool ok = rtka_sudoku_solve_batch(text, length, rtka_pool_default(), &stats) == RTKA_SUCCESS;
+    ok &= stats.puzzles == BATCH_PUZZLES && stats.solved == BATCH_PUZZLES;
+    for (uint32_t i = 0; ok && i < BATCH_PUZZLES; i++) {
+        ok = grid_solves(text + (size_t)i * 82U, clues + (size_t)i * 82U);
+    }
+    printf("  %llu puzzles in %.3f s: %.0f puzzles/sec, %.1f guesses/puzzle\n",
+           (unsigned long long)stats.puzzles, stats.seconds, stats.puzzles_per_sec,
+           stats.puzzles ? (double)stats.guesses / (double)stats.puzzles : 0.0);
+    free(text);
+    free(clues);
+    return report("batch", ok);
+}
+
+/* Malformed lines are left alone; the rest are solved in place */
+static bool check_file(char texts[3][82]) {
+    const char* in_path = "test_sudoku_in.txt";
+    const char* out_path = "test_sudoku_out.txt";
+    FILE* f = fopen(in_path, "wb");
+    if (!f) return report("batch file", false);
+    fputs("# header line\n", f);
+    for (uint32_t i = 0; i < FILE_PUZZLES; i++) fprintf(f, "%s\r\n", texts[i % 3]);
+    fputs("12345\n", f);
+    fclose(f);
+
+    sudoku_batch_stats_t stats;
+    bool ok = rtka_sudoku_solve_file(in_path, out_path, NULL, &stats) == RTKA_SUCCESS;
+    ok &= stats.puzzles == FILE_PUZZLES && stats.solved == FILE_PUZZLES;
+
+    char line[128];
+    uint32_t lines = 0, solved = 0;
+    f = fopen(out_path, "rb");
+    while (ok && f && fgets(line, sizeof(line), f)) {
+        if (lines > 0 && lines <= FILE_PUZZLES) solved += grid_solves(line, texts[(lines - 1) % 3]);
+        lines++;
+    }
+    if (f) fclose(f);
+    ok &= solved == FILE_PUZZLES && lines == FILE_PUZZLES + 2U;
+    ok &= rtka_sudoku_solve_file("missing_sudoku.txt", NULL, NULL, &stats) == RTKA_ERROR_INVALID_VALUE;
+    remove(in_path);
+    remove(out_path);
+    return report("batch file", ok);
+}
+
 int main(void) {
     print_header();
     
@@ -94,7 +255,9 @@ int main(void) {
         {"Puzzle 3: Golden Nugget (Very Hard)", golden}
     };
     
+    char texts[3][82] = {{0}};
     for (int i = 0; i < 3; i++) {
+        grid_text(texts[i], puzzles[i].puzzle);
         print_puzzle_header(puzzles[i].name);
         
         printf("Initial puzzle:\n");
@@ -151,7 +314,11 @@ int main(void) {
     printf("║ 4. Bit operations for 27×27 constraints    ║\n");
     printf("║ 5. No random evolution needed              ║\n");
     printf("║ 6. Confidence guides smart backtracking    ║\n");
-    printf("╚════════════════════════════════════════════╝\n");
-    
-    return 0;
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    bool ok = check_bitboard(texts);
+    ok &= check_batch(texts);
+    ok &= check_file(texts);
+    printf("\n%s\n", ok ? "Bitboard results verified" : "Mismatch detected");
+    return ok ? 0 : 1;
 }
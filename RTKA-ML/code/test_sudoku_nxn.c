@@ -0,0 +1,184 @@
+/**
+ * File: test_sudoku_nxn.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA n²×n² Sudoku Solver
+ */
+
+#include "rtka_sudoku_nxn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_CELLS       (64U * 64U)
+#define GRIDS_PER_SIZE  8U
+
+static const char* hard_9x9[] = {
+    "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..",
+    "......12.....35......6...7.7.....3.....4..8..1...........12.....8.....4..5....6..",
+    ".......39.....1..5..3.5.8....8.9...6.7...2...1..4.......9.8..5..2....6..4..7....."
+};
+
+static bool report(const char* name, bool ok) {
+    printf("%-16s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void shuffle(uint32_t* v, uint32_t n) {
+    for (uint32_t i = n - 1U; i > 0; i--) {
+        uint32_t j = (uint32_t)rand() % (i + 1U);
+        uint32_t t = v[i];
+        v[i] = v[j];
+        v[j] = t;
+    }
+}
+
+/* Random full grid: the shifted pattern under digit relabeling and row /
+ * column shuffles that stay inside bands and stacks */
+static void random_grid(uint32_t box, uint8_t* grid) {
+    uint32_t side = box * box;
+    uint32_t digits[64], rows[64], cols[64], order[8];
+    for (uint32_t i = 0; i < side; i++) digits[i] = i;
+    shuffle(digits, side);
+
+    uint32_t* maps[2] = {rows, cols};
+    for (uint32_t m = 0; m < 2; m++) {
+        for (uint32_t i = 0; i < box; i++) order[i] = i;
+        shuffle(order, box);
+        for (uint32_t band = 0; band < box; band++) {
+            uint32_t inner[8];
+            for (uint32_t i = 0; i < box; i++) inner[i] = i;
+            shuffle(inner, box);
+            for (uint32_t i = 0; i < box; i++) maps[m][band * box + i] = order[band] * box + inner[i];
+        }
+    }
+    for (uint32_t r = 0; r < side; r++) {
+        for (uint32_t c = 0; c < side; c++) {
+            uint32_t rr = rows[r], cc = cols[c];
+            grid[r * side + c] = (uint8_t)(digits[(box * (rr % box) + rr / box + cc) % side] + 1U);
+        }
+    }
+}
+
+static bool consistent(const sudoku_nxn_t* s, const uint8_t* clues) {
+    if (!rtka_sudoku_nxn_validate(s)) return false;
+    for (uint32_t cell = 0; cell < s->cells; cell++) {
+        if (clues[cell] && s->solution[cell] + 1U != clues[cell]) return false;
+    }
+    return true;
+}
+
+static bool check_hard_9x9(void) {
+    bool ok = true;
+    for (uint32_t p = 0; p < 3; p++) {
+        uint8_t clues[81];
+        for (uint32_t i = 0; i < 81; i++) clues[i] = hard_9x9[p][i] == '.' ? 0U : (uint8_t)(hard_9x9[p][i] - '0');
+        sudoku_nxn_t s;
+        ok &= rtka_sudoku_nxn_init(&s, 3, clues) == RTKA_SUCCESS;
+        ok &= rtka_sudoku_nxn_solve(&s) && consistent(&s, clues);
+        printf("  9x9 %u: %llu guesses\n", p + 1, (unsigned long long)s.guesses);
+        rtka_sudoku_nxn_free(&s);
+    }
+    return report("hard 9x9", ok);
+}
+
+static bool check_errors(void) {
+    uint8_t clues[MAX_CELLS] = {0};
+    sudoku_nxn_t s;
+    bool ok = rtka_sudoku_nxn_init(&s, 1, clues) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sudoku_nxn_free(&s);
+    ok &= rtka_sudoku_nxn_init(&s, 9, clues) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sudoku_nxn_free(&s);
+
+    clues[0] = 17;                                      /* Above 16 */
+    ok &= rtka_sudoku_nxn_init(&s, 4, clues) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sudoku_nxn_free(&s);
+
+    clues[0] = 5;
+    clues[16 * 15] = 5;                                 /* Same column */
+    ok &= rtka_sudoku_nxn_init(&s, 4, clues) == RTKA_ERROR_INVALID_VALUE;
+    rtka_sudoku_nxn_free(&s);
+    return report("bad grids", ok);
+}
+
+/* Ternary view of a fresh 16x16 board: clues TRUE, their peers FALSE for
+ * that digit, and every open cell UNKNOWN across its candidates */
+static bool check_states(void) {
+    uint8_t clues[256] = {0};
+    clues[0] = 3;
+    sudoku_nxn_t s;
+    bool ok = rtka_sudoku_nxn_init(&s, 4, clues) == RTKA_SUCCESS;
+    rtka_state_t t = rtka_sudoku_nxn_state(&s, 0, 2);
+    ok &= t.value == RTKA_TRUE && t.confidence == 1.0f;
+    ok &= rtka_sudoku_nxn_state(&s, 0, 3).value == RTKA_FALSE;
+    ok &= rtka_sudoku_nxn_state(&s, 5, 2).value == RTKA_FALSE;      /* Same row */
+    ok &= rtka_sudoku_nxn_state(&s, 17, 2).value == RTKA_FALSE;     /* Same box */
+    t = rtka_sudoku_nxn_state(&s, 5, 0);
+    ok &= t.value == RTKA_UNKNOWN && t.confidence == 1.0f / 15.0f;
+    t = rtka_sudoku_nxn_state(&s, 255, 2);
+    ok &= t.value == RTKA_UNKNOWN && t.confidence == 1.0f / 16.0f;
+    rtka_sudoku_nxn_free(&s);
+    return report("ternary view", ok);
+}
+
+/* Random grids of each size with a fraction of cells blanked; time per cell
+ * is printed so propagation cost can be compared across sizes */
+static bool check_sizes(void) {
+    static const uint32_t blank_pct[SUDOKU_NXN_MAX_BOX + 1U] = {0, 0, 60, 60, 55, 40, 35, 30, 30};
+    static uint8_t grid[MAX_CELLS], clues[MAX_CELLS];
+    bool ok = true;
+    srand(26);
+    for (uint32_t box = SUDOKU_NXN_MIN_BOX; box <= SUDOKU_NXN_MAX_BOX; box++) {
+        uint32_t side = box * box, cells = side * side, blanks = 0;
+        uint64_t guesses = 0;
+        double seconds = 0.0;
+        bool size_ok = true;
+        for (uint32_t g = 0; g < GRIDS_PER_SIZE; g++) {
+            random_grid(box, grid);
+            for (uint32_t cell = 0; cell < cells; cell++) {
+                bool blank = (uint32_t)rand() % 100U < blank_pct[box];
+                clues[cell] = blank ? 0U : grid[cell];
+                blanks += blank;
+            }
+            sudoku_nxn_t s;
+            double start = wall_seconds();
+            size_ok &= rtka_sudoku_nxn_init(&s, box, clues) == RTKA_SUCCESS;
+            size_ok &= rtka_sudoku_nxn_solve(&s);
+            seconds += wall_seconds() - start;
+            size_ok &= consistent(&s, clues);
+            guesses += s.guesses;
+            rtka_sudoku_nxn_free(&s);
+        }
+        printf("  %2ux%-2u: %5u blanks/grid, %6.1f ns/cell, %llu guesses\n", side, side,
+               blanks / GRIDS_PER_SIZE, seconds * 1e9 / ((double)cells * GRIDS_PER_SIZE),
+               (unsigned long long)guesses);
+        ok &= size_ok;
+    }
+    return report("n^2 x n^2", ok);
+}
+
+int main(void) {
+    printf("RTKA n^2 x n^2 Sudoku Test\n");
+    printf("==========================\n\n");
+
+    bool ok = check_hard_9x9();
+    ok &= check_errors();
+    ok &= check_states();
+    ok &= check_sizes();
+
+    printf("\n%s\n", ok ? "All grids verified" : "Mismatch detected");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,567 @@
+/**
+ * File: test_tensor.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Checks the structure-of-arrays tensor layout against the interleaved
+ * one: every tensor op on SoA, AoS and mixed operands must agree, the
+ * rtka_vector_t views must alias the planes, and layout conversion must
+ * round-trip (including transposed sources). Fused expressions must
+ * match the op-by-op chain, broadcasting included. The _into / _inplace
+ * variants must match the allocating ops and allocate nothing once warm.
+ * Ops on slices and transposes must match the same ops on copies.
+ */
+
+#include "rtka_tensor.h"
+#include "rtka_tensor_expr.h"
+#include "rtka_u_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+static float frand(void) {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+static rtka_tensor_t* random_tensor(const uint32_t* shape, uint32_t ndim) {
+    rtka_tensor_t* t = rtka_tensor_create(shape, ndim);
+    for (uint32_t i = 0; i < t->size; i++) {
+        t->data[i] = rtka_make_state((rtka_value_t)((rand() % 3) - 1), frand());
+    }
+    return t;
+}
+
+/* Transposed header over the same storage */
+static rtka_tensor_t transposed(const rtka_tensor_t* t) {
+    rtka_tensor_t view = *t;
+    view.shape[0] = t->shape[1];
+    view.shape[1] = t->shape[0];
+    view.strides[0] = t->strides[1];
+    view.strides[1] = t->strides[0];
+    view.flags &= ~RTKA_TENSOR_CONTIGUOUS;
+    return view;
+}
+
+/* Element-wise equality in index order, any layout or strides */
+static bool same(const rtka_tensor_t* a, const rtka_tensor_t* b, float tol) {
+    if (!a || !b || a->size != b->size) return false;
+    for (uint32_t i = 0; i < a->size; i++) {
+        rtka_state_t x = rtka_tensor_load(a, rtka_tensor_offset(a, i));
+        rtka_state_t y = rtka_tensor_load(b, rtka_tensor_offset(b, i));
+        if (x.value != y.value || fabsf(x.confidence - y.confidence) > tol) return false;
+    }
+    return true;
+}
+
+static bool report(const char* name, bool ok) {
+    printf("%-14s %s\n", name, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_layout(void) {
+    uint32_t shape[] = {7, 13};
+    rtka_tensor_t* aos = random_tensor(shape, 2);
+    rtka_tensor_t* soa = rtka_tensor_to_soa(aos);
+    rtka_tensor_t* back = rtka_tensor_to_aos(soa);
+
+    bool ok = rtka_tensor_is_soa(soa) && !rtka_tensor_is_soa(back) &&
+              soa->data == NULL && same(aos, soa, 0.0f) && same(aos, back, 0.0f);
+    ok &= ((uintptr_t)soa->values % RTKA_CACHE_LINE_SIZE) == 0 &&
+          ((uintptr_t)soa->confidences % RTKA_CACHE_LINE_SIZE) == 0;
+    ok &= rtka_tensor_memory_size(soa) >= sizeof(rtka_tensor_t) + soa->size * 8U;
+
+    /* Transposed source gathers in index order */
+    rtka_tensor_t t = transposed(aos);
+    rtka_tensor_t* t_soa = rtka_tensor_to_soa(&t);
+    for (uint32_t i = 0; i < 7 && ok; i++) {
+        for (uint32_t j = 0; j < 13 && ok; j++) {
+            rtka_state_t x = aos->data[i * 13 + j], y = rtka_tensor_load(t_soa, j * 7 + i);
+            ok = x.value == y.value && x.confidence == y.confidence;
+        }
+    }
+
+    /* A transposed SoA view made contiguous in place (soa is consumed) */
+    rtka_tensor_t view = transposed(soa);
+    rtka_tensor_make_contiguous(&view);
+    ok &= rtka_tensor_is_contiguous(&view) && same(&view, t_soa, 0.0f);
+
+    rtka_tensor_free(aos);
+    rtka_tensor_free(soa);
+    rtka_tensor_free(back);
+    rtka_tensor_free(t_soa);
+    return report("layout", ok);
+}
+
+static bool check_vector_interop(void) {
+    uint32_t shape[] = {4, 25};
+    rtka_tensor_t* soa = rtka_tensor_create_soa(shape, 2);
+    rtka_vector_t vec;
+    bool ok = rtka_tensor_as_vector(soa, &vec) && vec.count == 100 &&
+              vec.values == soa->values && vec.confidences == soa->confidences;
+
+    /* Writes through the vector are writes to the tensor */
+    for (uint32_t i = 0; i < vec.count; i++) {
+        vec.values[i] = (i % 2) ? RTKA_TRUE : RTKA_UNKNOWN;
+        vec.confidences[i] = 0.25f;
+    }
+    ok &= rtka_tensor_load(soa, 3).value == RTKA_TRUE && rtka_tensor_load(soa, 3).confidence == 0.25f;
+
+    rtka_value_t values[100];
+    rtka_confidence_t confidences[100];
+    for (uint32_t i = 0; i < 100; i++) {
+        values[i] = RTKA_FALSE;
+        confidences[i] = 0.5f;
+    }
+    rtka_vector_t owned = { values, confidences, 100, 100 };
+    uint32_t wrap_shape[] = {10, 10};
+    rtka_tensor_t* wrapped = rtka_tensor_wrap_vector(&owned, wrap_shape, 2);
+    ok &= wrapped && wrapped->values == values;
+    if (wrapped) {
+        rtka_tensor_store(wrapped, 42, rtka_make_state(RTKA_TRUE, 0.75f));
+        ok &= values[42] == RTKA_TRUE && confidences[42] == 0.75f;
+        ok &= rtka_tensor_reduce_and(wrapped).value == RTKA_FALSE;
+    }
+    uint32_t bad_shape[] = {3, 3};
+    ok &= rtka_tensor_wrap_vector(&owned, bad_shape, 2) == NULL;
+
+    /* AoS tensors have no vector view */
+    rtka_tensor_t* aos = rtka_tensor_create(shape, 2);
+    ok &= !rtka_tensor_as_vector(aos, &vec);
+
+    rtka_tensor_free(wrapped);
+    rtka_tensor_free(soa);
+    rtka_tensor_free(aos);
+    return report("vector view", ok);
+}
+
+static bool check_elementwise(void) {
+    uint32_t shape[] = {3, 111};
+    rtka_tensor_t* a = random_tensor(shape, 2);
+    rtka_tensor_t* b = random_tensor(shape, 2);
+    rtka_tensor_t* sa = rtka_tensor_to_soa(a);
+    rtka_tensor_t* sb = rtka_tensor_to_soa(b);
+    bool ok = true;
+
+    rtka_tensor_t* (*const binary[])(const rtka_tensor_t*, const rtka_tensor_t*) = {
+        rtka_tensor_and, rtka_tensor_or
+    };
+    for (size_t f = 0; f < 2; f++) {
+        rtka_tensor_t* ref = binary[f](a, b);
+        rtka_tensor_t* soa = binary[f](sa, sb);
+        rtka_tensor_t* mixed_a = binary[f](sa, b);
+        rtka_tensor_t* mixed_b = binary[f](a, sb);
+        ok &= rtka_tensor_is_soa(soa) && rtka_tensor_is_soa(mixed_a) && !rtka_tensor_is_soa(mixed_b);
+        ok &= same(ref, soa, 1e-6f) && same(ref, mixed_a, 1e-6f) && same(ref, mixed_b, 1e-6f);
+        rtka_tensor_free(ref);
+        rtka_tensor_free(soa);
+        rtka_tensor_free(mixed_a);
+        rtka_tensor_free(mixed_b);
+    }
+
+    rtka_tensor_t* not_ref = rtka_tensor_not(a);
+    rtka_tensor_t* not_soa = rtka_tensor_not(sa);
+    ok &= same(not_ref, not_soa, 0.0f);
+    for (uint32_t i = 0; i < a->size; i++) {
+        ok &= not_ref->data[i].value == rtka_not(a->data[i].value);
+    }
+
+    rtka_state_t and_ref = rtka_tensor_reduce_and(a), and_soa = rtka_tensor_reduce_and(sa);
+    rtka_state_t or_ref = rtka_tensor_reduce_or(a), or_soa = rtka_tensor_reduce_or(sa);
+    ok &= and_ref.value == and_soa.value && or_ref.value == or_soa.value;
+
+    /* Confidence plane ops */
+    for (uint32_t i = 0; i < a->size; i++) {
+        a->data[i].confidence *= 3.0f;
+        sa->confidences[i] *= 3.0f;
+    }
+    rtka_tensor_normalize_confidence(a);
+    rtka_tensor_normalize_confidence(sa);
+    ok &= same(a, sa, 0.0f);
+
+    rtka_tensor_free(a);
+    rtka_tensor_free(b);
+    rtka_tensor_free(sa);
+    rtka_tensor_free(sb);
+    rtka_tensor_free(not_ref);
+    rtka_tensor_free(not_soa);
+    return report("elementwise", ok);
+}
+
+static bool check_matmul_linear(void) {
+    uint32_t a_shape[] = {9, 70}, b_shape[] = {70, 33}, bias_shape[] = {33};
+    rtka_tensor_t* a = random_tensor(a_shape, 2);
+    rtka_tensor_t* b = random_tensor(b_shape, 2);
+    rtka_tensor_t* bias = random_tensor(bias_shape, 1);
+    rtka_tensor_t* sa = rtka_tensor_to_soa(a);
+    rtka_tensor_t* sb = rtka_tensor_to_soa(b);
+    rtka_tensor_t* sbias = rtka_tensor_to_soa(bias);
+
+    rtka_tensor_t* mm_ref = rtka_tensor_matmul(a, b);
+    rtka_tensor_t* mm_soa = rtka_tensor_matmul(sa, sb);
+    rtka_tensor_t* mm_mixed = rtka_tensor_matmul(a, sb);
+    bool ok = same(mm_ref, mm_soa, 1e-5f) && same(mm_ref, mm_mixed, 1e-5f) &&
+              rtka_tensor_is_soa(mm_soa);
+
+    rtka_tensor_t* lin_ref = rtka_tensor_linear(a, b, bias);
+    rtka_tensor_t* lin_soa = rtka_tensor_linear(sa, sb, sbias);
+    rtka_tensor_t* lin_mixed = rtka_tensor_linear(sa, b, bias);
+    ok &= same(lin_ref, lin_soa, 1e-4f) && same(lin_ref, lin_mixed, 1e-4f);
+
+    rtka_tensor_free(a);
+    rtka_tensor_free(b);
+    rtka_tensor_free(bias);
+    rtka_tensor_free(sa);
+    rtka_tensor_free(sb);
+    rtka_tensor_free(sbias);
+    rtka_tensor_free(mm_ref);
+    rtka_tensor_free(mm_soa);
+    rtka_tensor_free(mm_mixed);
+    rtka_tensor_free(lin_ref);
+    rtka_tensor_free(lin_soa);
+    rtka_tensor_free(lin_mixed);
+    return report("matmul/linear", ok);
+}
+
+/* not(and(a, b)) or c, fused and op by op */
+static rtka_expr_t build_chain(rtka_tensor_expr_t* e, const rtka_tensor_t* a,
+                               const rtka_tensor_t* b, const rtka_tensor_t* c) {
+    rtka_expr_init(e);
+    rtka_expr_t x = rtka_expr_and(e, rtka_expr_input(e, a), rtka_expr_input(e, b));
+    return rtka_expr_or(e, rtka_expr_not(e, x), rtka_expr_input(e, c));
+}
+
+static rtka_tensor_t* unfused_chain(const rtka_tensor_t* a, const rtka_tensor_t* b,
+                                    const rtka_tensor_t* c) {
+    rtka_tensor_t* x = rtka_tensor_and(a, b);
+    rtka_tensor_t* y = rtka_tensor_not(x);
+    rtka_tensor_t* z = rtka_tensor_or(y, c);
+    rtka_tensor_free(x);
+    rtka_tensor_free(y);
+    return z;
+}
+
+static bool check_expr(void) {
+    uint32_t shape[] = {5, 301}, row_shape[] = {301}, col_shape[] = {5, 1};
+    rtka_tensor_t* a = random_tensor(shape, 2);
+    rtka_tensor_t* b = random_tensor(shape, 2);
+    rtka_tensor_t* c = random_tensor(shape, 2);
+    rtka_tensor_t* sb = rtka_tensor_to_soa(b);
+    rtka_tensor_expr_t e;
+
+    rtka_tensor_t* ref = unfused_chain(a, b, c);
+    rtka_tensor_t* fused = rtka_expr_eval(&e, build_chain(&e, a, sb, c));
+    bool ok = same(ref, fused, 1e-6f);
+
+    /* Broadcast: matrix + row, matrix * column; dead nodes are skipped */
+    rtka_tensor_t* row = random_tensor(row_shape, 1);
+    rtka_tensor_t* col = random_tensor(col_shape, 2);
+    rtka_expr_init(&e);
+    rtka_expr_t x = rtka_expr_input(&e, a);
+    rtka_expr_not(&e, rtka_expr_input(&e, c));
+    rtka_expr_t sum = rtka_expr_add(&e, x, rtka_expr_input(&e, row));
+    rtka_expr_t prod = rtka_expr_mul(&e, sum, rtka_expr_input(&e, col));
+    rtka_tensor_t* bc = rtka_expr_eval(&e, prod);
+    ok &= bc && bc->ndim == 2 && bc->shape[0] == 5 && bc->shape[1] == 301;
+    for (uint32_t i = 0; i < 5 && ok; i++) {
+        for (uint32_t j = 0; j < 301 && ok; j++) {
+            rtka_state_t sa = a->data[i * 301 + j], sr = row->data[j], sc = col->data[i];
+            float s = ((float)sa.value * sa.confidence + (float)sr.value * sr.confidence) *
+                      (float)sc.value * sc.confidence;
+            rtka_state_t got = bc->data[i * 301 + j];
+            ok = fabsf((float)got.value * got.confidence - s) <= 1e-5f &&
+                 (s == 0.0f || got.value == (s > 0.0f ? RTKA_TRUE : RTKA_FALSE));
+        }
+    }
+
+    /* rtka_tensor_add broadcasts the same way */
+    rtka_tensor_t* added = rtka_tensor_add(a, row);
+    rtka_expr_init(&e);
+    rtka_tensor_t* added_ref = rtka_expr_eval(&e, rtka_expr_add(&e, rtka_expr_input(&e, a),
+                                                                rtka_expr_input(&e, row)));
+    ok &= same(added, added_ref, 0.0f);
+
+    /* In place into an input */
+    ok &= rtka_expr_eval_into(&e, build_chain(&e, a, b, c), c) == RTKA_SUCCESS && same(ref, c, 1e-6f);
+
+    /* Errors are sticky and reported */
+    uint32_t bad_shape[] = {4, 301};
+    rtka_tensor_t* bad = rtka_tensor_create(bad_shape, 2);
+    rtka_expr_init(&e);
+    rtka_expr_t broken = rtka_expr_and(&e, rtka_expr_input(&e, a), rtka_expr_input(&e, bad));
+    ok &= broken == RTKA_EXPR_INVALID && e.error == RTKA_ERROR_INVALID_VALUE;
+    ok &= rtka_expr_not(&e, rtka_expr_input(&e, a)) == RTKA_EXPR_INVALID;
+    ok &= rtka_expr_eval(&e, 0) == NULL;
+    ok &= rtka_expr_eval_into(&e, 0, a) == RTKA_ERROR_INVALID_VALUE;
+    ok &= rtka_tensor_add(a, bad) == NULL;
+
+    rtka_tensor_t* tensors[] = {a, b, c, sb, ref, fused, row, col, bc, added, added_ref, bad};
+    for (size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); i++) rtka_tensor_free(tensors[i]);
+    return report("expr", ok);
+}
+
+/* not(and(a, b)) or c over 4M elements */
+static void time_expr(void) {
+    uint32_t shape[] = {1U << 22};
+    rtka_tensor_t* a = random_tensor(shape, 1);
+    rtka_tensor_t* b = random_tensor(shape, 1);
+    rtka_tensor_t* c = random_tensor(shape, 1);
+    rtka_tensor_expr_t e;
+
+    clock_t start = clock();
+    rtka_tensor_t* chained = unfused_chain(a, b, c);
+    double unfused = (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC;
+
+    start = clock();
+    rtka_tensor_t* fused = rtka_expr_eval(&e, build_chain(&e, a, b, c));
+    double single = (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC;
+
+    printf("chain 4M       op by op %.2f ms, fused %.2f ms\n", unfused, single);
+    rtka_tensor_free(a);
+    rtka_tensor_free(b);
+    rtka_tensor_free(c);
+    rtka_tensor_free(chained);
+    rtka_tensor_free(fused);
+}
+
+/* Counts allocations routed through the thread's current allocator */
+static uint32_t counted_allocs;
+
+static void* counting_alloc(size_t size, void* context) {
+    (void)context;
+    counted_allocs++;
+    return aligned_alloc(64, (size + 63U) & ~(size_t)63U);
+}
+
+static void counting_free(void* ptr, void* context) {
+    (void)context;
+    free(ptr);
+}
+
+static bool check_into(void) {
+    uint32_t shape[] = {6, 40}, w_shape[] = {40, 24}, out_shape[] = {6, 24}, row_shape[] = {40};
+    rtka_tensor_t* a = random_tensor(shape, 2);
+    rtka_tensor_t* b = random_tensor(shape, 2);
+    rtka_tensor_t* row = random_tensor(row_shape, 1);
+    rtka_tensor_t* w = random_tensor(w_shape, 2);
+    rtka_tensor_t* out = rtka_tensor_create(shape, 2);
+    rtka_tensor_t* out_soa = rtka_tensor_create_soa(shape, 2);
+    rtka_tensor_t* mm_out = rtka_tensor_create(out_shape, 2);
+    bool ok = true;
+
+    rtka_tensor_t* (*const alloc_ops[])(const rtka_tensor_t*, const rtka_tensor_t*) = {
+        rtka_tensor_add, rtka_tensor_multiply, rtka_tensor_and, rtka_tensor_or
+    };
+    rtka_error_t (*const into_ops[])(rtka_tensor_t*, const rtka_tensor_t*, const rtka_tensor_t*) = {
+        rtka_tensor_add_into, rtka_tensor_multiply_into, rtka_tensor_and_into, rtka_tensor_or_into
+    };
+    rtka_error_t (*const inplace_ops[])(rtka_tensor_t*, const rtka_tensor_t*) = {
+        rtka_tensor_add_inplace, rtka_tensor_multiply_inplace, rtka_tensor_and_inplace,
+        rtka_tensor_or_inplace
+    };
+    for (size_t f = 0; f < 4; f++) {
+        rtka_tensor_t* ref = alloc_ops[f](a, b);
+        ok &= into_ops[f](out, a, b) == RTKA_SUCCESS && same(ref, out, 1e-6f);
+        ok &= into_ops[f](out_soa, a, b) == RTKA_SUCCESS && same(ref, out_soa, 1e-6f);
+
+        /* a op= b, and a broadcast row */
+        rtka_tensor_t* copy = rtka_tensor_to_aos(a);
+        ok &= inplace_ops[f](copy, b) == RTKA_SUCCESS && same(ref, copy, 1e-6f);
+        rtka_tensor_t* bc_ref = alloc_ops[f](a, row);
+        rtka_tensor_t* bc = rtka_tensor_to_aos(a);
+        ok &= inplace_ops[f](bc, row) == RTKA_SUCCESS && same(bc_ref, bc, 1e-6f);
+        ok &= inplace_ops[f](row, a) == RTKA_ERROR_INVALID_VALUE;
+
+        rtka_tensor_free(ref);
+        rtka_tensor_free(copy);
+        rtka_tensor_free(bc_ref);
+        rtka_tensor_free(bc);
+    }
+
+    rtka_tensor_t* not_ref = rtka_tensor_not(a);
+    ok &= rtka_tensor_not_into(out_soa, a) == RTKA_SUCCESS && same(not_ref, out_soa, 0.0f);
+    rtka_tensor_t* copy = rtka_tensor_to_aos(a);
+    ok &= rtka_tensor_not_inplace(copy) == RTKA_SUCCESS && same(not_ref, copy, 0.0f);
+
+    rtka_tensor_t* lin_ref = rtka_tensor_linear(a, w, NULL);
+    ok &= rtka_tensor_linear_into(mm_out, a, w, NULL) == RTKA_SUCCESS && same(lin_ref, mm_out, 0.0f);
+    rtka_tensor_t* mm_ref = rtka_tensor_matmul(a, w);
+    ok &= rtka_tensor_matmul_into(mm_out, a, w) == RTKA_SUCCESS && same(mm_ref, mm_out, 0.0f);
+    ok &= rtka_tensor_matmul_into(out, a, w) == RTKA_ERROR_INVALID_VALUE;
+
+    /* Axis reductions against the sequence fold, both axes */
+    uint32_t cols_shape[] = {40}, rows_shape[] = {6};
+    rtka_tensor_t* over_rows = rtka_tensor_create(cols_shape, 1);
+    rtka_tensor_t* over_cols = rtka_tensor_reduce_along_axis(a, 1, rtka_recursive_or_seq);
+    ok &= rtka_tensor_reduce_along_axis_into(over_rows, a, 0, rtka_recursive_and_seq) == RTKA_SUCCESS;
+    ok &= over_cols && over_cols->ndim == 1 && over_cols->shape[0] == 6;
+    rtka_state_t fiber[40];
+    for (uint32_t j = 0; j < 40 && ok; j++) {
+        for (uint32_t i = 0; i < 6; i++) fiber[i] = a->data[i * 40 + j];
+        rtka_state_t want = rtka_recursive_and_seq(fiber, 6), got = over_rows->data[j];
+        ok = got.value == want.value && fabsf(got.confidence - want.confidence) <= 1e-6f;
+    }
+    for (uint32_t i = 0; i < 6 && ok; i++) {
+        rtka_state_t want = rtka_recursive_or_seq(a->data + i * 40, 40), got = over_cols->data[i];
+        ok = got.value == want.value && fabsf(got.confidence - want.confidence) <= 1e-6f;
+    }
+    rtka_tensor_t* wrong = rtka_tensor_create(rows_shape, 1);
+    ok &= rtka_tensor_reduce_along_axis_into(wrong, a, 0, rtka_recursive_and_seq) == RTKA_ERROR_INVALID_VALUE;
+
+    /* Warm: a timestep's worth of _into / _inplace calls allocates nothing */
+    rtka_allocator_t counting = { counting_alloc, counting_free, NULL };
+    rtka_allocator_t* saved = rtka_tls_memory.allocator;
+    rtka_tls_memory.allocator = &counting;
+    counted_allocs = 0;
+    for (int step = 0; step < 3; step++) {
+        ok &= rtka_tensor_linear_into(mm_out, a, w, NULL) == RTKA_SUCCESS;
+        ok &= rtka_tensor_matmul_into(mm_out, a, w) == RTKA_SUCCESS;
+        ok &= rtka_tensor_multiply_into(out, a, b) == RTKA_SUCCESS;
+        ok &= rtka_tensor_add_inplace(out, row) == RTKA_SUCCESS;
+        ok &= rtka_tensor_and_into(out_soa, a, b) == RTKA_SUCCESS;
+        ok &= rtka_tensor_not_inplace(out) == RTKA_SUCCESS;
+        ok &= rtka_tensor_reduce_along_axis_into(over_rows, a, 0, rtka_recursive_and_seq) == RTKA_SUCCESS;
+    }
+    rtka_tls_memory.allocator = saved;
+    ok &= counted_allocs == 0;
+
+    rtka_tensor_t* tensors[] = {a, b, row, w, out, out_soa, mm_out, not_ref, copy, lin_ref, mm_ref,
+                                over_rows, over_cols, wrong};
+    for (size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); i++) rtka_tensor_free(tensors[i]);
+    return report("into/inplace", ok);
+}
+
+/* Every op on strided views against the op on contiguous copies */
+static bool check_views(bool soa_base) {
+    uint32_t shape[] = {12, 50};
+    rtka_tensor_t* base_aos = random_tensor(shape, 2);
+    rtka_tensor_t* other_aos = random_tensor(shape, 2);
+    rtka_tensor_t* base = soa_base ? rtka_tensor_to_soa(base_aos) : base_aos;
+    rtka_tensor_t* other = soa_base ? rtka_tensor_to_soa(other_aos) : other_aos;
+
+    /* Rows 2..9, columns 5..45: unit inner stride, row stride 50 */
+    uint32_t start[] = {2, 5}, stop[] = {9, 45};
+    rtka_tensor_view_t va = rtka_tensor_slice(base, start, stop);
+    rtka_tensor_view_t vb = rtka_tensor_slice(other, start, stop);
+    rtka_tensor_t a = rtka_tensor_view_as_tensor(&va);
+    rtka_tensor_t b = rtka_tensor_view_as_tensor(&vb);
+    rtka_tensor_t* ca = rtka_tensor_from_view(&va);
+    rtka_tensor_t* cb = rtka_tensor_from_view(&vb);
+    bool ok = !rtka_tensor_is_contiguous(&a) && rtka_tensor_is_contiguous(ca) &&
+              a.shape[0] == 7 && a.shape[1] == 40 && same(&a, ca, 0.0f);
+    ok &= rtka_tensor_is_soa(ca) == soa_base;
+
+    rtka_tensor_t* (*const binary[])(const rtka_tensor_t*, const rtka_tensor_t*) = {
+        rtka_tensor_and, rtka_tensor_or, rtka_tensor_add, rtka_tensor_multiply
+    };
+    for (size_t f = 0; f < 4; f++) {
+        rtka_tensor_t* ref = binary[f](ca, cb);
+        rtka_tensor_t* got = binary[f](&a, &b);
+        ok &= same(ref, got, 1e-6f);
+        rtka_tensor_free(ref);
+        rtka_tensor_free(got);
+    }
+    rtka_tensor_t* not_ref = rtka_tensor_not(ca);
+    rtka_tensor_t* not_got = rtka_tensor_not(&a);
+    ok &= same(not_ref, not_got, 0.0f);
+
+    rtka_state_t r1 = rtka_tensor_reduce_or(ca), r2 = rtka_tensor_reduce_or(&a);
+    ok &= r1.value == r2.value && fabsf(r1.confidence - r2.confidence) <= 1e-6f;
+    rtka_tensor_t* ax_ref = rtka_tensor_reduce_along_axis(ca, 0, rtka_recursive_and_seq);
+    rtka_tensor_t* ax_got = rtka_tensor_reduce_along_axis(&a, 0, rtka_recursive_and_seq);
+    ok &= same(ax_ref, ax_got, 1e-6f);
+
+    /* Transposed view: non-unit inner stride; matmul and linear through it */
+    uint32_t swap[] = {1, 0};
+    rtka_tensor_t* t = rtka_tensor_transpose(other, swap);
+    rtka_tensor_t* t_copy = rtka_tensor_to_aos(t);
+    ok &= t && !rtka_tensor_is_contiguous(t) && t->shape[0] == 50 && t->shape[1] == 12;
+    uint32_t w_start[] = {5, 0}, w_stop[] = {45, 12};
+    rtka_tensor_view_t vw = rtka_tensor_slice(t, w_start, w_stop);
+    rtka_tensor_t w = rtka_tensor_view_as_tensor(&vw);
+    rtka_tensor_t* cw = rtka_tensor_from_view(&vw);
+    rtka_tensor_t* mm_copy = rtka_tensor_matmul(ca, cw);
+    rtka_tensor_t* mm_view = rtka_tensor_matmul(&a, &w);
+    ok &= same(mm_copy, mm_view, 1e-5f);
+    rtka_tensor_t* lin_copy = rtka_tensor_linear(ca, cw, NULL);
+    rtka_tensor_t* lin_view = rtka_tensor_linear(&a, &w, NULL);
+    ok &= same(lin_copy, lin_view, 1e-4f);
+
+    /* Strided output: not(a) written through the view, the rest untouched */
+    rtka_tensor_t* before = rtka_tensor_to_aos(other);
+    ok &= rtka_tensor_copy_into(&b, not_ref) == RTKA_SUCCESS && same(&b, not_ref, 0.0f);
+    for (uint32_t i = 0; i < 12 && ok; i++) {
+        for (uint32_t j = 0; j < 50 && ok; j++) {
+            if (i >= 2 && i < 9 && j >= 5 && j < 45) continue;
+            rtka_state_t x = rtka_tensor_load(other, i * 50 + j), y = before->data[i * 50 + j];
+            ok = x.value == y.value && x.confidence == y.confidence;
+        }
+    }
+
+    /* Reshape / squeeze / unsqueeze alias the storage */
+    uint32_t flat_shape[] = {600};
+    rtka_tensor_t* flat = rtka_tensor_reshape(base, flat_shape, 1);
+    rtka_tensor_t* lifted = rtka_tensor_unsqueeze(base, 0);
+    rtka_tensor_t* squeezed = lifted ? rtka_tensor_squeeze(lifted) : NULL;
+    ok &= flat && same(flat, base, 0.0f) && rtka_tensor_reshape(t, flat_shape, 1) == NULL;
+    ok &= lifted && lifted->ndim == 3 && lifted->shape[0] == 1 && rtka_tensor_is_contiguous(lifted);
+    ok &= squeezed && squeezed->ndim == 2 && same(squeezed, base, 0.0f);
+    uint32_t bad_axes[] = {0, 0};
+    ok &= rtka_tensor_transpose(base, bad_axes) == NULL;
+
+    rtka_tensor_t* tensors[] = {ca, cb, not_ref, not_got, ax_ref, ax_got, t, t_copy, cw, mm_copy,
+                                mm_view, lin_copy, lin_view, before, flat, lifted, squeezed};
+    for (size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); i++) rtka_tensor_free(tensors[i]);
+    if (soa_base) {
+        rtka_tensor_free(base);
+        rtka_tensor_free(other);
+    }
+    rtka_tensor_free(base_aos);
+    rtka_tensor_free(other_aos);
+    return report(soa_base ? "views (SoA)" : "views (AoS)", ok);
+}
+
+/* AND over a million elements, both layouts */
+static void time_reduce(void) {
+    uint32_t shape[] = {1U << 20};
+    rtka_tensor_t* aos = rtka_tensor_unknown(shape, 1);
+    rtka_tensor_t* soa = rtka_tensor_to_soa(aos);
+    rtka_tensor_t* layouts[] = {aos, soa};
+    double ms[2];
+    volatile float sink = 0.0f;
+
+    for (int l = 0; l < 2; l++) {
+        clock_t start = clock();
+        for (int r = 0; r < 20; r++) sink += rtka_tensor_reduce_and(layouts[l]).confidence;
+        ms[l] = (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC / 20.0;
+    }
+    (void)sink;
+    printf("reduce_and 1M  AoS %.3f ms, SoA %.3f ms\n", ms[0], ms[1]);
+    rtka_tensor_free(aos);
+    rtka_tensor_free(soa);
+}
+
+int main(void) {
+    printf("RTKA Tensor Layout Test\n");
+    printf("=======================\n\n");
+
+    srand(7);
+    bool ok = check_layout();
+    ok &= check_vector_interop();
+    ok &= check_elementwise();
+    ok &= check_matmul_linear();
+    ok &= check_expr();
+    ok &= check_into();
+    ok &= check_views(false);
+    ok &= check_views(true);
+    time_reduce();
+    time_expr();
+
+    printf("\n%s\n", ok ? "SoA and AoS agree" : "Mismatch detected");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,310 @@
+/**
+ * File: test_threadpool.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Thread Pool: tasks, parallel_for and nested use
+ *
+ * Every submitted task runs once before rtka_pool_wait returns. A
+ * parallel_for covers its range exactly once, with worker indices below
+ * rtka_pool_size + 1. Nested loops, on the same pool or on a smaller pool
+ * from inside a larger pool's worker, run inline and still hand out
+ * indices that fit the pool they were given. Spawned work: recursive
+ * fork-join (Fibonacci), a fan-out that idle workers must steal from, a
+ * deque that has to grow, a split range covered exactly once, and outside
+ * threads waiting side by side, one helping and the others blocked.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_threadpool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TASKS        1000U
+#define RANGE        10000U
+#define OUTER_CHUNKS 64U
+#define INNER_RANGE  32U
+#define FIB_N        22U
+#define FIB_SERIAL   8U
+#define FAN_OUT      2000U
+#define SPLIT_RANGE  5000U
+#define WAITERS      3U
+
+static void count_task(void* arg) {
+    atomic_fetch_add_explicit((atomic_uint*)arg, 1U, memory_order_relaxed);
+}
+
+static bool check_tasks(rtka_thread_pool_t* pool) {
+    atomic_uint done = 0;
+    bool ok = true;
+    for (uint32_t i = 0; i < TASKS; i++) ok &= rtka_pool_submit(pool, count_task, &done) == RTKA_SUCCESS;
+    rtka_pool_wait(pool);
+    ok &= atomic_load(&done) == TASKS;
+    printf("  %u tasks: %u ran  %s\n", TASKS, atomic_load(&done), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+typedef struct {
+    atomic_uchar* hits;
+    uint32_t participants;
+    atomic_uint bad_index;
+} cover_ctx_t;
+
+static void cover_range(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    cover_ctx_t* c = ctx;
+    if (worker >= c->participants) atomic_fetch_add(&c->bad_index, 1U);
+    for (uint32_t i = begin; i < end; i++) atomic_fetch_add_explicit(&c->hits[i], 1U, memory_order_relaxed);
+}
+
+static bool check_parallel_for(rtka_thread_pool_t* pool) {
+    atomic_uchar* hits = calloc(RANGE, sizeof(atomic_uchar));
+    if (!hits) return false;
+    cover_ctx_t ctx = { hits, rtka_pool_size(pool) + 1U, 0 };
+    rtka_pool_parallel_for(pool, 0, RANGE, 7, cover_range, &ctx);
+
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < RANGE; i++) wrong += atomic_load(&hits[i]) != 1U;
+    bool ok = wrong == 0 && atomic_load(&ctx.bad_index) == 0;
+    printf("  parallel_for over %u: %u items not hit once, %u bad worker indices  %s\n", RANGE, wrong,
+           atomic_load(&ctx.bad_index), ok ? "OK" : "FAIL");
+    free(hits);
+    return ok;
+}
+
+/* Outer loop on one pool; every outer chunk runs an inner loop on `inner`
+ * and records which participant slot the inner body was handed. The sleep
+ * yields the caller so outer workers, not just the caller, take chunks. */
+typedef struct {
+    rtka_thread_pool_t* inner;
+    uint32_t inner_participants;
+    atomic_uint inner_items;
+    atomic_uint bad_index;
+} nested_ctx_t;
+
+static void inner_body(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    nested_ctx_t* n = ctx;
+    if (worker >= n->inner_participants) atomic_fetch_add(&n->bad_index, 1U);
+    atomic_fetch_add(&n->inner_items, end - begin);
+}
+
+static void outer_body(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    nested_ctx_t* n = ctx;
+    usleep(200);
+    for (uint32_t i = begin; i < end; i++) rtka_pool_parallel_for(n->inner, 0, INNER_RANGE, 1, inner_body, n);
+}
+
+static bool check_nested(const char* name, rtka_thread_pool_t* outer, rtka_thread_pool_t* inner) {
+    nested_ctx_t ctx = { inner, rtka_pool_size(inner) + 1U, 0, 0 };
+    rtka_pool_parallel_for(outer, 0, OUTER_CHUNKS, 1, outer_body, &ctx);
+
+    bool ok = atomic_load(&ctx.inner_items) == OUTER_CHUNKS * INNER_RANGE && atomic_load(&ctx.bad_index) == 0;
+    printf("  %s: %u inner items, %u indices >= %u  %s\n", name, atomic_load(&ctx.inner_items),
+           atomic_load(&ctx.bad_index), ctx.inner_participants, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+/* Fork-join Fibonacci: every call above FIB_SERIAL spawns one branch and
+ * runs the other itself, then waits for the spawned one */
+typedef struct {
+    rtka_thread_pool_t* pool;
+    uint32_t n;
+    uint64_t result;
+} fib_task_t;
+
+static uint64_t fib_serial(uint32_t n) {
+    return n < 2U ? n : fib_serial(n - 1U) + fib_serial(n - 2U);
+}
+
+static void fib_task(void* arg) {
+    fib_task_t* t = arg;
+    if (t->n <= FIB_SERIAL) {
+        t->result = fib_serial(t->n);
+        return;
+    }
+    fib_task_t left = { t->pool, t->n - 1U, 0 }, right = { t->pool, t->n - 2U, 0 };
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    if (rtka_pool_spawn(t->pool, &group, fib_task, &left) != RTKA_SUCCESS) fib_task(&left);
+    fib_task(&right);
+    rtka_pool_wait_group(t->pool, &group);
+    t->result = left.result + right.result;
+}
+
+static bool check_fork_join(rtka_thread_pool_t* pool) {
+    rtka_pool_stats_t before = rtka_pool_get_stats(pool);
+    fib_task_t root = { pool, FIB_N, 0 };
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    bool ok = rtka_pool_spawn(pool, &group, fib_task, &root) == RTKA_SUCCESS;
+    rtka_pool_wait_group(pool, &group);
+    rtka_pool_stats_t after = rtka_pool_get_stats(pool);
+
+    uint64_t expect = fib_serial(FIB_N);
+    ok &= root.result == expect;
+    printf("  fib(%u) forked: %llu (expect %llu), %llu tasks, %llu stolen  %s\n", FIB_N,
+           (unsigned long long)root.result, (unsigned long long)expect,
+           (unsigned long long)(after.executed - before.executed), (unsigned long long)(after.stolen - before.stolen),
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+/* One task spawns FAN_OUT children onto its own deque, more than the
+ * initial ring holds, then sleeps so the other workers have to steal.
+ * It is submitted rather than spawned, so it runs on a worker, never on
+ * the waiting caller, which has no deque. */
+typedef struct {
+    rtka_thread_pool_t* pool;
+    atomic_uint done;
+    atomic_uint bad_index;
+} fan_ctx_t;
+
+static void fan_child(void* arg) {
+    fan_ctx_t* f = arg;
+    if (rtka_pool_worker_index(f->pool) > rtka_pool_size(f->pool)) atomic_fetch_add(&f->bad_index, 1U);
+    atomic_fetch_add_explicit(&f->done, 1U, memory_order_relaxed);
+}
+
+static void fan_parent(void* arg) {
+    fan_ctx_t* f = arg;
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    for (uint32_t i = 0; i < FAN_OUT; i++) {
+        if (rtka_pool_spawn(f->pool, &group, fan_child, f) != RTKA_SUCCESS) fan_child(f);
+    }
+    usleep(20000);
+    rtka_pool_wait_group(f->pool, &group);
+}
+
+static bool check_fan_out(rtka_thread_pool_t* pool) {
+    rtka_pool_stats_t before = rtka_pool_get_stats(pool);
+    fan_ctx_t ctx = { pool, 0, 0 };
+    bool ok = rtka_pool_submit(pool, fan_parent, &ctx) == RTKA_SUCCESS;
+    rtka_pool_wait(pool);
+    rtka_pool_stats_t after = rtka_pool_get_stats(pool);
+
+    uint64_t stolen = after.stolen - before.stolen, grows = after.deque_grows - before.deque_grows;
+    ok &= atomic_load(&ctx.done) == FAN_OUT && atomic_load(&ctx.bad_index) == 0 && stolen > 0 && grows > 0;
+    printf("  fan-out of %u: %u ran, %llu stolen, %llu deque grows  %s\n", FAN_OUT, atomic_load(&ctx.done),
+           (unsigned long long)stolen, (unsigned long long)grows, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool check_spawn_range(rtka_thread_pool_t* pool) {
+    atomic_uchar* hits = calloc(SPLIT_RANGE, sizeof(atomic_uchar));
+    if (!hits) return false;
+    cover_ctx_t ctx = { hits, rtka_pool_size(pool) + 1U, 0 };
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    bool ok = rtka_pool_spawn_range(pool, &group, 0, SPLIT_RANGE, 3, cover_range, &ctx) == RTKA_SUCCESS;
+    rtka_pool_wait_group(pool, &group);
+
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < SPLIT_RANGE; i++) wrong += atomic_load(&hits[i]) != 1U;
+    ok &= wrong == 0 && atomic_load(&ctx.bad_index) == 0;
+    printf("  spawn_range over %u: %u items not hit once, %u bad worker indices  %s\n", SPLIT_RANGE, wrong,
+           atomic_load(&ctx.bad_index), ok ? "OK" : "FAIL");
+    free(hits);
+    return ok;
+}
+
+/* Several outside threads fork at once; one helps as participant 0, the
+ * rest block, and every one gets its own answer */
+typedef struct {
+    rtka_thread_pool_t* pool;
+    uint32_t n;
+    uint64_t result;
+} waiter_arg_t;
+
+static void* waiter_main(void* arg) {
+    waiter_arg_t* w = arg;
+    fib_task_t root = { w->pool, w->n, 0 };
+    rtka_task_group_t group;
+    rtka_task_group_init(&group);
+    if (rtka_pool_spawn(w->pool, &group, fib_task, &root) != RTKA_SUCCESS) fib_task(&root);
+    rtka_pool_wait_group(w->pool, &group);
+    w->result = root.result;
+    return NULL;
+}
+
+static bool check_outside_waiters(rtka_thread_pool_t* pool) {
+    pthread_t threads[WAITERS];
+    waiter_arg_t args[WAITERS];
+    uint32_t started = 0;
+    for (uint32_t i = 0; i < WAITERS; i++) {
+        args[i] = (waiter_arg_t){ pool, FIB_N - 2U - i, 0 };
+        if (pthread_create(&threads[i], NULL, waiter_main, &args[i]) == 0) started++;
+    }
+    bool ok = started == WAITERS;
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        ok &= args[i].result == fib_serial(args[i].n);
+    }
+    printf("  %u outside threads forking at once: %s\n", WAITERS, ok ? "all correct  OK" : "FAIL");
+    return ok;
+}
+
+/* Fork-join on the 1-thread pool from inside the 4-thread pool's workers */
+typedef struct {
+    rtka_thread_pool_t* inner;
+    atomic_uint wrong;
+} nested_fork_t;
+
+static void nested_fork_body(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)worker;
+    nested_fork_t* n = ctx;
+    usleep(200);
+    for (uint32_t i = begin; i < end; i++) {
+        fib_task_t root = { n->inner, 12U, 0 };
+        rtka_task_group_t group;
+        rtka_task_group_init(&group);
+        if (rtka_pool_spawn(n->inner, &group, fib_task, &root) != RTKA_SUCCESS) fib_task(&root);
+        rtka_pool_wait_group(n->inner, &group);
+        if (root.result != fib_serial(12U)) atomic_fetch_add(&n->wrong, 1U);
+    }
+}
+
+static bool check_nested_fork(rtka_thread_pool_t* outer, rtka_thread_pool_t* inner) {
+    nested_fork_t ctx = { inner, 0 };
+    rtka_pool_parallel_for(outer, 0, OUTER_CHUNKS, 1, nested_fork_body, &ctx);
+    bool ok = atomic_load(&ctx.wrong) == 0;
+    printf("  1-thread pool forks inside 4-thread pool: %u wrong  %s\n", atomic_load(&ctx.wrong),
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Thread Pool Test ===\n");
+    printf("\n--- Tasks and parallel_for ---\n");
+    rtka_thread_pool_t* large = rtka_pool_create(4, 0);
+    rtka_thread_pool_t* small = rtka_pool_create(1, 0);
+    if (!large || !small) return 1;
+
+    bool ok = check_tasks(large);
+    ok &= check_parallel_for(large);
+    ok &= check_parallel_for(small);
+    ok &= check_nested("same pool nested", large, large);
+    ok &= check_nested("1-thread pool inside 4-thread pool", large, small);
+
+    printf("\n--- Work stealing ---\n");
+    ok &= check_fork_join(large);
+    ok &= check_fork_join(small);
+    ok &= check_fan_out(large);
+    ok &= check_spawn_range(large);
+    ok &= check_outside_waiters(large);
+    ok &= check_nested_fork(large, small);
+
+    rtka_pool_destroy(small);
+    rtka_pool_destroy(large);
+    printf("\n%s\n", ok ? "All thread pool checks passed" : "Thread pool checks FAILED");
+    return ok ? 0 : 1;
+}
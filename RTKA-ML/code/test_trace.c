@@ -0,0 +1,268 @@
+/**
+ * File: test_trace.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Trace: rings, export, pool and solver hooks
+ *
+ * Nothing is recorded before start or after stop. Threads recording past
+ * their ring keep the newest events and report the rest as overwritten.
+ * The exported JSON carries one thread_name record per ring and every held
+ * event once. The pool emits a chunk span per parallel_for chunk and a task
+ * span per helper; a SAT solve emits one conflict instant per learned
+ * clause and propagation spans whose literal counts add up to the solver's
+ * own statistic. Then the cost of a hook is timed, off and on.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_trace.h"
+#include "rtka_threadpool.h"
+#include "rtka_sat.h"
+#include "rtka_sudoku_729.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_EVENTS    1024U
+#define THREADS        4U
+#define THREAD_EVENTS  3000U
+#define CHUNKS         64U
+#define HOOK_CALLS     10000000U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    uint32_t events;                     /* Of one name */
+    uint64_t arg_sum;                    /* Of its "args" value */
+    uint32_t names;                      /* thread_name records */
+    uint32_t spans;
+    uint32_t instants;
+    bool closed;                         /* Final "]}" present */
+} trace_count_t;
+
+/* Export into memory and count; one event per line by construction */
+static bool count_events(const char* name, trace_count_t* count) {
+    memset(count, 0, sizeof(*count));
+    char* text = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&text, &size);
+    if (!out) return false;
+    bool ok = rtka_trace_export_json(out) == RTKA_SUCCESS;
+    fclose(out);
+    if (!ok) {
+        free(text);
+        return false;
+    }
+
+    char needle[64];
+    snprintf(needle, sizeof(needle), "{\"name\":\"%s\"", name);
+    for (char* line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+        if (strstr(line, "\"ph\":\"M\"")) count->names++;
+        if (strstr(line, "\"ph\":\"X\"")) count->spans++;
+        if (strstr(line, "\"ph\":\"i\"")) count->instants++;
+        if (strcmp(line, "]}") == 0) count->closed = true;
+        if (strncmp(line, needle, strlen(needle)) != 0) continue;
+        count->events++;
+        const char* args = strstr(line, "\"args\":{\"");
+        if (args) {
+            const char* colon = strchr(args + 9, ':');
+            if (colon) count->arg_sum += strtoull(colon + 1, NULL, 10);
+        }
+    }
+    free(text);
+    return true;
+}
+
+static void* record_main(void* arg) {
+    uint32_t index = *(const uint32_t*)arg;
+    char name[RTKA_TRACE_NAME_MAX];
+    snprintf(name, sizeof(name), "writer \"%u\"", index);
+    rtka_trace_name_thread(name);
+    for (uint32_t i = 0; i < THREAD_EVENTS; i++) {
+        uint64_t span = rtka_trace_begin();
+        rtka_trace_end(RTKA_TRACE_POOL_CHUNK, span, i);
+    }
+    return NULL;
+}
+
+static bool check_rings(void) {
+    printf("\n--- Rings ---\n");
+    rtka_trace_stats_t stats;
+
+    /* Off: hooks record nothing */
+    uint64_t span = rtka_trace_begin();
+    rtka_trace_end(RTKA_TRACE_POOL_TASK, span, 0);
+    rtka_trace_instant(RTKA_TRACE_SAT_RESTART, 1);
+    rtka_trace_get_stats(&stats);
+    bool quiet = stats.recorded == 0 && stats.threads == 0;
+
+    rtka_trace_start(RING_EVENTS);
+    pthread_t threads[THREADS];
+    uint32_t indices[THREADS];
+    for (uint32_t t = 0; t < THREADS; t++) {
+        indices[t] = t;
+        if (pthread_create(&threads[t], NULL, record_main, &indices[t]) != 0) return false;
+    }
+    for (uint32_t t = 0; t < THREADS; t++) pthread_join(threads[t], NULL);
+    rtka_trace_stop();
+
+    rtka_trace_instant(RTKA_TRACE_SAT_RESTART, 1);
+    rtka_trace_get_stats(&stats);
+    bool kept = stats.recorded == THREADS * RING_EVENTS &&
+                stats.overwritten == THREADS * (THREAD_EVENTS - RING_EVENTS) && stats.dropped == 0;
+    printf("  %u threads x %u events into %u-event rings: %llu held, %llu overwritten\n",
+           stats.threads, THREAD_EVENTS, RING_EVENTS, (unsigned long long)stats.recorded,
+           (unsigned long long)stats.overwritten);
+
+    /* Newest events survive: args THREAD_EVENTS - RING_EVENTS .. THREAD_EVENTS - 1 */
+    trace_count_t count;
+    bool exported = count_events("pool_chunk", &count);
+    uint64_t first = THREAD_EVENTS - RING_EVENTS, last = THREAD_EVENTS - 1U;
+    uint64_t expect_sum = THREADS * (first + last) * RING_EVENTS / 2U;
+    exported &= count.events == THREADS * RING_EVENTS && count.arg_sum == expect_sum &&
+                count.names == THREADS && count.spans == THREADS * RING_EVENTS && count.closed;
+    printf("  export: %u threads named, %u spans, newest kept %s\n", count.names, count.spans,
+           count.arg_sum == expect_sum ? "yes" : "NO");
+
+    /* Cleared rings of exited threads are reused, not grown */
+    rtka_trace_clear();
+    rtka_trace_start(RING_EVENTS);
+    for (uint32_t t = 0; t < THREADS; t++) {
+        if (pthread_create(&threads[t], NULL, record_main, &indices[t]) != 0) return false;
+    }
+    for (uint32_t t = 0; t < THREADS; t++) pthread_join(threads[t], NULL);
+    rtka_trace_stop();
+    rtka_trace_get_stats(&stats);
+    bool reused = stats.threads == THREADS && stats.recorded == THREADS * RING_EVENTS;
+    printf("  after clear: %u rings for %u new threads\n", stats.threads, THREADS);
+    rtka_trace_clear();
+
+    bool ok = quiet && kept && exported && reused;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static void chunk_body(void* ctx, uint32_t begin, uint32_t end, uint32_t worker) {
+    (void)ctx;
+    (void)worker;
+    volatile uint64_t sink = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        for (uint32_t k = 0; k < 20000U; k++) sink += k ^ i;
+    }
+}
+
+/* n + 1 pigeons into n holes has no solution */
+static void pigeonhole(sat_state_t* state, uint32_t holes) {
+    uint32_t pigeons = holes + 1;
+    rtka_sat_init(state, pigeons * holes);
+
+    int32_t clause[16];
+    for (uint32_t p = 0; p < pigeons; p++) {
+        for (uint32_t h = 0; h < holes; h++) clause[h] = (int32_t)(p * holes + h + 1);
+        rtka_sat_add_clause(state, clause, holes);
+    }
+    for (uint32_t h = 0; h < holes; h++) {
+        for (uint32_t p = 0; p < pigeons; p++) {
+            for (uint32_t q = p + 1; q < pigeons; q++) {
+                int32_t pair[] = {-(int32_t)(p * holes + h + 1), -(int32_t)(q * holes + h + 1)};
+                rtka_sat_add_clause(state, pair, 2);
+            }
+        }
+    }
+}
+
+static bool check_hooks(void) {
+    printf("\n--- Pool and solver hooks ---\n");
+    rtka_trace_start(1U << 20);
+
+    rtka_thread_pool_t* pool = rtka_pool_create(3, 0);
+    if (!pool) return false;
+    rtka_pool_parallel_for(pool, 0, CHUNKS, 1, chunk_body, NULL);
+    rtka_pool_destroy(pool);
+
+    trace_count_t chunks, tasks, joins;
+    bool counted = count_events("pool_chunk", &chunks) && count_events("pool_task", &tasks) &&
+                   count_events("pool_join", &joins);
+    bool pool_ok = counted && chunks.events == CHUNKS && tasks.events == 3U && joins.events == 1U;
+    printf("  parallel_for: %u chunk spans, %u task spans, %u join\n", chunks.events, tasks.events,
+           joins.events);
+
+    sat_state_t state;
+    pigeonhole(&state, 7);
+    bool unsat = !rtka_sat_solve(&state);
+    trace_count_t propagations, conflicts;
+    counted = count_events("sat_propagate", &propagations) && count_events("sat_conflict", &conflicts);
+    bool sat_ok = counted && unsat && conflicts.events == state.learned &&
+                  propagations.arg_sum == state.propagations;
+    printf("  SAT PHP(8,7): %u conflicts for %llu learned, %llu literals for %llu propagations\n",
+           conflicts.events, (unsigned long long)state.learned, (unsigned long long)propagations.arg_sum,
+           (unsigned long long)state.propagations);
+    rtka_sat_free(&state);
+
+    /* AI Escargot needs guesses beyond singles and pairs */
+    const char* puzzle = "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..";
+    uint8_t cells[81];
+    for (uint32_t i = 0; i < 81; i++) cells[i] = puzzle[i] == '.' ? 0U : (uint8_t)(puzzle[i] - '0');
+    sudoku_bits_t board;
+    bool solved = rtka_sudoku_bits_init(&board, cells) && rtka_sudoku_bits_solve(&board);
+    trace_count_t backtracks;
+    bool sudoku_ok = count_events("sudoku_backtrack", &backtracks) && solved && backtracks.events > 0;
+    printf("  Sudoku: %u backtracks\n", backtracks.events);
+
+    rtka_trace_stop();
+    rtka_trace_stats_t stats;
+    rtka_trace_get_stats(&stats);
+    bool whole = stats.overwritten == 0 && stats.dropped == 0;
+
+    bool written = rtka_trace_write("/tmp/rtka_trace_test.json") == RTKA_SUCCESS;
+    printf("  %llu events in %u rings written to /tmp/rtka_trace_test.json\n",
+           (unsigned long long)stats.recorded, stats.threads);
+    rtka_trace_clear();
+
+    bool ok = pool_ok && sat_ok && sudoku_ok && whole && written;
+    printf("  %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool benchmark(void) {
+    printf("\n--- Hook cost ---\n");
+    double t0 = now_seconds();
+    for (uint32_t i = 0; i < HOOK_CALLS; i++) {
+        uint64_t span = rtka_trace_begin();
+        rtka_trace_end(RTKA_TRACE_POOL_CHUNK, span, i);
+    }
+    double off = now_seconds() - t0;
+
+    rtka_trace_start(1U << 16);
+    t0 = now_seconds();
+    for (uint32_t i = 0; i < HOOK_CALLS; i++) {
+        uint64_t span = rtka_trace_begin();
+        rtka_trace_end(RTKA_TRACE_POOL_CHUNK, span, i);
+    }
+    double on = now_seconds() - t0;
+    rtka_trace_stop();
+    rtka_trace_clear();
+
+    printf("  span off: %.2f ns, on: %.2f ns\n", off * 1e9 / HOOK_CALLS, on * 1e9 / HOOK_CALLS);
+    return true;
+}
+
+int main(void) {
+    printf("=== RTKA Trace Test ===\n");
+    bool ok = check_rings();
+    ok &= check_hooks();
+    ok &= benchmark();
+    printf("\n%s\n", ok ? "All trace checks passed" : "Trace checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+/**
+ * File: test_vec_env.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Test RTKA Vectorized Environments: lockstep stepping, batched actions
+ *
+ * A vector of random-walk environments must follow the same trajectories
+ * as the environments stepped one by one, on the caller's thread or on a
+ * pool, resetting the ones that finish. Batched action selection must pick
+ * what the single-state selectors pick, from one forward pass, and the
+ * vectorized DQN loop must run its episodes. Then action selection for a
+ * vector is timed against one forward pass per environment.
+ */
+
+#define _GNU_SOURCE
+#include "rtka_reinforcement.h"
+#include "rtka_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OBS      16U
+#define ENVS     8U
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Walk of a position under ternary actions; an episode lasts 10 + id % 7 steps */
+typedef struct {
+    uint32_t id;
+    int32_t position;
+    uint32_t t;
+    uint32_t episodes;
+} walk_t;
+
+static rtka_tensor_t* walk_observation(const walk_t* w) {
+    uint32_t shape[1] = { OBS };
+    rtka_tensor_t* obs = rtka_tensor_create(shape, 1);
+    if (!obs) return NULL;
+    for (uint32_t k = 0; k < OBS; k++) {
+        float x = (float)w->position * 0.1f + (float)k * 0.01f + (float)w->t * 0.001f;
+        obs->data[k] = rtka_make_state(k == 0 ? (rtka_value_t)(w->position > 0) - (w->position < 0) : RTKA_TRUE,
+                                       k == 1 ? (float)w->t : k == 2 ? (float)w->episodes : x);
+    }
+    return obs;
+}
+
+static rtka_tensor_t* walk_reset(void* data) {
+    walk_t* w = (walk_t*)data;
+    w->position = 0;
+    w->t = 0;
+    w->episodes++;
+    return walk_observation(w);
+}
+
+static rtka_tensor_t* walk_step(void* data, rtka_value_t action, rtka_confidence_t* reward, bool* done) {
+    walk_t* w = (walk_t*)data;
+    w->position += (int32_t)action;
+    w->t++;
+    *reward = (rtka_confidence_t)w->position * 0.5f;
+    *done = w->t >= 10U + w->id % 7U;
+    return walk_observation(w);
+}
+
+static rtka_environment_t walk_env(walk_t* w, uint32_t id) {
+    memset(w, 0, sizeof(*w));
+    w->id = id;
+    return (rtka_environment_t){ walk_reset, walk_step, OBS, 3, w };
+}
+
+static rtka_value_t scripted_action(uint32_t step, uint32_t env) {
+    return (rtka_value_t)((int)((step * 7U + env * 3U) % 3U) - 1);
+}
+
+static bool rows_equal(const rtka_state_t* a, const rtka_tensor_t* b) {
+    return memcmp(a, b->data, OBS * sizeof(rtka_state_t)) == 0;
+}
+
+static bool check_lockstep(rtka_thread_pool_t* pool) {
+    printf("\n--- Lockstep stepping (%s) ---\n", pool ? "thread pool" : "caller's thread");
+    walk_t walks[ENVS], references[ENVS];
+    rtka_environment_t envs[ENVS], singles[ENVS];
+    for (uint32_t i = 0; i < ENVS; i++) {
+        envs[i] = walk_env(&walks[i], i);
+        singles[i] = walk_env(&references[i], i);
+    }
+    rtka_vec_env_t* vec;
+    if (rtka_vec_env_create(&vec, envs, ENVS, pool) != RTKA_SUCCESS) return false;
+    if (rtka_vec_env_reset(vec) != RTKA_SUCCESS) return false;
+
+    uint32_t mismatches = 0, finished = 0;
+    rtka_tensor_t* current[ENVS];
+    for (uint32_t i = 0; i < ENVS; i++) {
+        current[i] = singles[i].reset(singles[i].env_data);
+        mismatches += !rows_equal(vec->observations->data + i * OBS, current[i]);
+    }
+    rtka_value_t actions[ENVS];
+    for (uint32_t step = 0; step < 100; step++) {
+        for (uint32_t i = 0; i < ENVS; i++) actions[i] = scripted_action(step, i);
+        if (rtka_vec_env_step(vec, actions) != RTKA_SUCCESS) return false;
+        for (uint32_t i = 0; i < ENVS; i++) {
+            rtka_confidence_t reward;
+            bool done;
+            rtka_tensor_t* next = singles[i].step(singles[i].env_data, actions[i], &reward, &done);
+            mismatches += !rows_equal(vec->previous->data + i * OBS, current[i]);
+            mismatches += !rows_equal(vec->next_observations->data + i * OBS, next);
+            mismatches += vec->rewards[i] != reward || vec->dones[i] != done;
+            rtka_tensor_free(current[i]);
+            current[i] = next;
+            if (done) {
+                finished++;
+                rtka_tensor_free(current[i]);
+                current[i] = singles[i].reset(singles[i].env_data);
+            }
+            mismatches += !rows_equal(vec->observations->data + i * OBS, current[i]);
+        }
+    }
+    for (uint32_t i = 0; i < ENVS; i++) rtka_tensor_free(current[i]);
+    rtka_vec_env_free(vec);
+    printf("  %u environments, 100 steps, %u episodes finished: %s\n", ENVS, finished,
+           mismatches ? "TRAJECTORIES DIFFER" : "observations, rewards, dones and resets match");
+    return mismatches == 0 && finished > 0;
+}
+
+static bool check_actions(rtka_dqn_agent_t* agent, rtka_pg_agent_t* pg) {
+    printf("\n--- Batched action selection ---\n");
+    const uint32_t rows = 64;
+    uint32_t shape[2] = { rows, OBS }, row_shape[2] = { 1, OBS };
+    rtka_tensor_t* states = rtka_tensor_create_in(rtka_heap_allocator(), shape, 2);
+    rtka_tensor_t* single = rtka_tensor_create_in(rtka_heap_allocator(), row_shape, 2);
+    if (!states || !single) return false;
+    for (uint32_t i = 0; i < states->size; i++) {
+        states->data[i] = rtka_make_state(RTKA_TRUE, (float)((i * 2654435761U) >> 24) / 255.0f - 0.5f);
+    }
+
+    rtka_value_t actions[64];
+    agent->epsilon = 0.0f;
+    bool ok = rtka_rl_select_actions_epsilon_greedy(agent, states, actions) == RTKA_SUCCESS;
+    uint32_t disagree = 0;
+    for (uint32_t i = 0; i < rows && ok; i++) {
+        memcpy(single->data, states->data + i * OBS, OBS * sizeof(rtka_state_t));
+        disagree += rtka_rl_select_action_epsilon_greedy(agent, single) != actions[i];
+    }
+
+    /* A deterministic policy row: one output carries all the probability */
+    bool pg_ok = rtka_rl_select_actions_policy(pg, states, actions) == RTKA_SUCCESS;
+    for (uint32_t i = 0; i < rows && pg_ok; i++) pg_ok &= rtka_is_valid_value(actions[i]);
+
+    agent->epsilon = 1.0f;
+    uint32_t counts[3] = {0};
+    for (uint32_t r = 0; r < 50 && ok; r++) {
+        ok &= rtka_rl_select_actions_epsilon_greedy(agent, states, actions) == RTKA_SUCCESS;
+        for (uint32_t i = 0; i < rows; i++) counts[actions[i] + 1]++;
+    }
+    bool spread = counts[0] > 900 && counts[1] > 900 && counts[2] > 900;
+    printf("  greedy: %s; policy: %s; epsilon 1: %u/%u/%u\n",
+           disagree ? "BATCH DIFFERS FROM SINGLE" : "batch matches the single-state selector",
+           pg_ok ? "one ternary action per row" : "POLICY SELECTION FAILED", counts[0], counts[1], counts[2]);
+    rtka_tensor_free(states);
+    rtka_tensor_free(single);
+    return ok && disagree == 0 && pg_ok && spread;
+}
+
+static bool check_training(rtka_dqn_agent_t* agent, rtka_thread_pool_t* pool) {
+    printf("\n--- Vectorized DQN ---\n");
+    walk_t walks[ENVS];
+    rtka_environment_t envs[ENVS];
+    for (uint32_t i = 0; i < ENVS; i++) envs[i] = walk_env(&walks[i], i);
+    rtka_vec_env_t* vec;
+    if (rtka_vec_env_create(&vec, envs, ENVS, pool) != RTKA_SUCCESS) return false;
+
+    agent->epsilon = 0.5f;
+    uint32_t before = agent->buffer->size;
+    rtka_rl_train_dqn_vectorized(agent, vec, 40);
+    uint32_t episodes = 0;
+    for (uint32_t i = 0; i < ENVS; i++) episodes += walks[i].episodes - 1U;
+    bool ok = episodes >= 40 && episodes < 40 + ENVS && agent->buffer->size > before && agent->epsilon < 0.5f;
+    printf("  40 episodes requested, %u finished, %u transitions stored, epsilon %.3f: %s\n", episodes,
+           agent->buffer->size - before, agent->epsilon, ok ? "ok" : "TRAINING LOOP FAILED");
+    rtka_vec_env_free(vec);
+
+    walk_t walk;
+    rtka_environment_t env = walk_env(&walk, 3);
+    rtka_rl_train_dqn(agent, &env, 5);
+    printf("  single environment, 5 episodes: %u finished\n", walk.episodes - 1U);
+    return ok && walk.episodes - 1U == 5U;
+}
+
+static bool benchmark(rtka_dqn_agent_t* agent) {
+    const uint32_t n = 64, steps = 50;
+    printf("\n--- %u environments, %u steps, greedy ---\n", n, steps);
+    walk_t* walks = (walk_t*)malloc(n * sizeof(walk_t));
+    rtka_environment_t* envs = (rtka_environment_t*)malloc(n * sizeof(rtka_environment_t));
+    rtka_value_t* actions = (rtka_value_t*)malloc(n * sizeof(rtka_value_t));
+    uint32_t row_shape[2] = { 1, OBS };
+    rtka_tensor_t* single = rtka_tensor_create_in(rtka_heap_allocator(), row_shape, 2);
+    if (!walks || !envs || !actions || !single) return false;
+    for (uint32_t i = 0; i < n; i++) envs[i] = walk_env(&walks[i], i);
+    rtka_vec_env_t* vec;
+    if (rtka_vec_env_create(&vec, envs, n, NULL) != RTKA_SUCCESS) return false;
+    agent->epsilon = 0.0f;
+
+    bool ok = rtka_vec_env_reset(vec) == RTKA_SUCCESS;
+    double t0 = now_seconds();
+    for (uint32_t s = 0; s < steps && ok; s++) {
+        for (uint32_t i = 0; i < n; i++) {
+            memcpy(single->data, vec->observations->data + i * OBS, OBS * sizeof(rtka_state_t));
+            actions[i] = rtka_rl_select_action_epsilon_greedy(agent, single);
+        }
+        ok &= rtka_vec_env_step(vec, actions) == RTKA_SUCCESS;
+    }
+    double one_by_one = now_seconds() - t0;
+
+    ok &= rtka_vec_env_reset(vec) == RTKA_SUCCESS;
+    t0 = now_seconds();
+    for (uint32_t s = 0; s < steps && ok; s++) {
+        ok &= rtka_rl_select_actions_epsilon_greedy(agent, vec->observations, actions) == RTKA_SUCCESS;
+        ok &= rtka_vec_env_step(vec, actions) == RTKA_SUCCESS;
+    }
+    double batched = now_seconds() - t0;
+
+    printf("  one forward pass per environment: %.2f ms/step\n", one_by_one * 1e3 / steps);
+    printf("  one forward pass per vector:      %.2f ms/step (%.1fx)\n", batched * 1e3 / steps,
+           one_by_one / batched);
+    rtka_vec_env_free(vec);
+    rtka_tensor_free(single);
+    free(walks);
+    free(envs);
+    free(actions);
+    return ok;
+}
+
+int main(void) {
+    printf("=== RTKA Vectorized Environment Test ===\n");
+    rtka_thread_pool_t* pool = rtka_pool_create(4, 0);
+    rtka_dqn_agent_t* agent = rtka_rl_create_dqn(OBS, 3, 0.0f, 0.9f);
+    rtka_pg_agent_t* pg = rtka_rl_create_pg(OBS, 3);
+    if (!pool || !agent || !agent->buffer || !pg) {
+        printf("Setup failed\n");
+        return 1;
+    }
+    /* Predictions need a trained model; the weights are the initial ones */
+    agent->q_network->trained = true;
+    agent->target_network->trained = true;
+    pg->policy_network->trained = true;
+
+    bool ok = check_lockstep(NULL);
+    ok &= check_lockstep(pool);
+    ok &= check_actions(agent, pg);
+    ok &= check_training(agent, pool);
+    ok &= benchmark(agent);
+    rtka_pool_destroy(pool);
+    printf("\n%s\n", ok ? "All vectorized environment checks passed" : "Vectorized environment checks FAILED");
+    return ok ? 0 : 1;
+}
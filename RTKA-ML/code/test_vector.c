@@ -0,0 +1,290 @@
+/**
+ * File: test_vector.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ *
+ * PROPRIETARY AND CONFIDENTIAL
+ * This file is proprietary to H. Overman and may not be reproduced,
+ * distributed, or used without explicit written permission.
+ *
+ * For licensing inquiries: opsec.ee@pm.me
+ *
+ * Checks every SIMD kernel set the CPU supports against the scalar
+ * Kleene operations, on unaligned planes with ragged tails, and the
+ * activation approximations against double libm within their ulp bounds.
+ */
+
+#include "rtka_vector.h"
+#include "rtka_threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define TEST_SIZE 1031U   /* Prime: exercises every remainder length */
+#define TEST_OFFSET 1U    /* Element offset to break alignment */
+
+typedef void (*vector_binary_op)(const rtka_vector_t*, const rtka_vector_t*, rtka_vector_t*);
+
+static rtka_value_t ref_nand(rtka_value_t a, rtka_value_t b) { return rtka_not(rtka_and(a, b)); }
+static rtka_value_t ref_nor(rtka_value_t a, rtka_value_t b) { return rtka_not(rtka_or(a, b)); }
+
+static void make_vector(rtka_vector_t* v, rtka_value_t* vals, float* confs, uint32_t n) {
+    v->values = vals + TEST_OFFSET;
+    v->confidences = confs + TEST_OFFSET;
+    v->count = n;
+    v->capacity = n;
+    for (uint32_t i = 0; i < n; i++) {
+        v->values[i] = (rtka_value_t)((rand() % 3) - 1);
+        v->confidences[i] = (float)rand() / (float)RAND_MAX;
+    }
+}
+
+static bool check_binary(const char* name, vector_binary_op op,
+                         rtka_value_t (*ref_val)(rtka_value_t, rtka_value_t),
+                         rtka_confidence_t (*ref_conf)(rtka_confidence_t, rtka_confidence_t),
+                         const rtka_vector_t* a, const rtka_vector_t* b, rtka_vector_t* r) {
+    for (uint32_t n = 0; n <= 40; n++) {
+        rtka_vector_t sa = *a, sb = *b;
+        sa.count = sb.count = n;
+        op(&sa, &sb, r);
+        for (uint32_t i = 0; i < n; i++) {
+            if (r->values[i] != ref_val(a->values[i], b->values[i]) ||
+                fabsf(r->confidences[i] - ref_conf(a->confidences[i], b->confidences[i])) > 1e-6f) {
+                printf("  %-8s FAIL at n=%u i=%u\n", name, n, i);
+                return false;
+            }
+        }
+    }
+
+    op(a, b, r);
+    for (uint32_t i = 0; i < a->count; i++) {
+        if (r->values[i] != ref_val(a->values[i], b->values[i]) ||
+            fabsf(r->confidences[i] - ref_conf(a->confidences[i], b->confidences[i])) > 1e-6f) {
+            printf("  %-8s FAIL at i=%u\n", name, i);
+            return false;
+        }
+    }
+    return r->count == a->count;
+}
+
+static bool check_not(const rtka_vector_t* a, rtka_vector_t* r) {
+    rtka_vector_not(a, r);
+    for (uint32_t i = 0; i < a->count; i++) {
+        if (r->values[i] != rtka_not(a->values[i]) || r->confidences[i] != a->confidences[i]) {
+            printf("  not      FAIL at i=%u\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Left fold with early exit: the reference semantics of the reductions */
+static bool check_reduce(rtka_vector_t* a) {
+    uint32_t full = a->count;
+    bool ok = true;
+
+    for (uint32_t n = 0; n <= full && ok; n += (n < 200 ? 1 : 97)) {
+        a->count = n;
+        for (int is_and = 0; is_and < 2; is_and++) {
+            rtka_value_t v = is_and ? RTKA_TRUE : RTKA_FALSE;
+            float c = 1.0f;
+            if (n > 0) {
+                v = a->values[0];
+                c = a->confidences[0];
+                for (uint32_t i = 1; i < n && v != (is_and ? RTKA_FALSE : RTKA_TRUE); i++) {
+                    v = is_and ? rtka_and(v, a->values[i]) : rtka_or(v, a->values[i]);
+                    c = is_and ? rtka_conf_and(c, a->confidences[i]) : rtka_conf_or(c, a->confidences[i]);
+                }
+            }
+            rtka_state_t s = is_and ? rtka_vector_reduce_and(a) : rtka_vector_reduce_or(a);
+            if (s.value != v || fabsf(s.confidence - c) > 1e-5f) {
+                printf("  reduce_%s FAIL at n=%u\n", is_and ? "and" : "or", n);
+                ok = false;
+            }
+        }
+    }
+
+    a->count = full;
+    return ok;
+}
+
+/* |got - want| in units of the float spacing at want */
+static double ulp_error(float got, double want) {
+    float w = (float)want;
+    int exponent;
+    frexpf(w, &exponent);
+    double ulp = fabsf(w) < 1.17549435e-38f ? ldexp(1.0, -149) : ldexp(1.0, exponent - 24);
+    return fabs((double)got - want) / ulp;
+}
+
+static double ref_sigmoid(double x) { return 1.0 / (1.0 + exp(-x)); }
+
+typedef void (*vector_map_op)(const float* RTKA_RESTRICT, float* RTKA_RESTRICT, uint32_t);
+
+/* Every 4099th float of magnitude below limit, both signs, through op;
+ * worst error within bound. Inputs below floor are skipped. */
+static bool check_map(const char* name, vector_map_op op, double (*ref)(double),
+                      float floor, float limit, double bound, float* in, float* out, uint32_t n) {
+    union { uint32_t bits; float value; } top = { .value = limit };
+    double worst = 0.0;
+    uint32_t bits = 0x00800000U;
+    while (bits < top.bits) {
+        uint32_t count = 0;
+        for (; count + 1 < n && bits < top.bits; bits += 4099U) {
+            union { uint32_t bits; float value; } x = { bits };
+            in[count++] = x.value;
+            if (-x.value >= floor) in[count++] = -x.value;
+        }
+        op(in, out, count);
+        for (uint32_t i = 0; i < count; i++) {
+            double want = ref((double)in[i]);
+            if (fabs(want) < 1.17549435e-38) continue;
+            double err = ulp_error(out[i], want);
+            if (err > worst) worst = err;
+        }
+    }
+    bool ok = worst <= bound;
+    if (!ok) printf("  %s: %.2f ulp, bound %.1f\n", name, worst, bound);
+    return ok;
+}
+
+static bool check_softmax(float* in, float* out, uint32_t n) {
+    bool ok = true;
+    for (uint32_t i = 0; i < n; i++) in[i] = (float)((int)(i * 37U % 101U) - 50) * 0.7f;
+    double top = -INFINITY, sum = 0.0;
+    for (uint32_t i = 0; i < n; i++) top = fmax(top, in[i]);
+    for (uint32_t i = 0; i < n; i++) sum += exp(in[i] - top);
+
+    rtka_vector_softmax_f32(in, out, n);
+    for (uint32_t i = 0; i < n; i++) {
+        ok &= fabs(out[i] - exp(in[i] - top) / sum) <= 1e-5 * (exp(in[i] - top) / sum);
+    }
+    rtka_vector_log_softmax_f32(in, out, n);
+    for (uint32_t i = 0; i < n; i++) {
+        double want = in[i] - top - log(sum);
+        ok &= fabs(out[i] - want) <= 1e-6 * (1.0 + fabs(want));
+    }
+    /* In place */
+    rtka_vector_softmax_f32(in, in, n);
+    for (uint32_t i = 0; i < n; i++) {
+        float x = (float)((int)(i * 37U % 101U) - 50) * 0.7f;
+        ok &= fabs(in[i] - exp(x - top) / sum) <= 1e-5 * (exp(x - top) / sum);
+    }
+    if (!ok) printf("  softmax / log-softmax mismatch\n");
+    return ok;
+}
+
+static bool check_activations(void) {
+    static float in[TEST_SIZE], out[TEST_SIZE];
+    bool ok = true;
+    ok &= check_map("exp", rtka_vector_exp_f32, exp, -87.33f, 88.37f, 1.5, in, out, TEST_SIZE);
+    ok &= check_map("sigmoid", rtka_vector_sigmoid_f32, ref_sigmoid, -87.0f, 100.0f, 4.5, in, out, TEST_SIZE);
+    ok &= check_map("tanh", rtka_vector_tanh_f32, tanh, -20.0f, 20.0f, 2.5, in, out, TEST_SIZE);
+    ok &= check_softmax(in, out, TEST_SIZE);
+    return ok;
+}
+
+static double time_tanh(bool fast) {
+    static float in[TEST_SIZE], out[TEST_SIZE];
+    const int iters = 20000;
+    for (uint32_t i = 0; i < TEST_SIZE; i++) in[i] = (float)i * 0.01f - 5.0f;
+    clock_t start = clock();
+    for (int k = 0; k < iters; k++) {
+        if (fast) {
+            rtka_vector_tanh_f32(in, out, TEST_SIZE);
+        } else {
+            for (uint32_t i = 0; i < TEST_SIZE; i++) out[i] = tanhf(in[i]);
+        }
+        __asm__ volatile("" : : "r"(out) : "memory");
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / ((double)iters * TEST_SIZE);
+}
+
+static double time_and(const rtka_vector_t* a, const rtka_vector_t* b, rtka_vector_t* r) {
+    const int iters = 20000;
+    clock_t start = clock();
+    for (int k = 0; k < iters; k++) {
+        rtka_vector_and(a, b, r);
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / ((double)iters * a->count);
+}
+
+int main(void) {
+    printf("RTKA Vector SIMD Dispatch Test\n");
+    printf("==============================\n\n");
+
+    static rtka_value_t va[TEST_SIZE + TEST_OFFSET], vb[TEST_SIZE + TEST_OFFSET], vr[TEST_SIZE + TEST_OFFSET];
+    static float ca[TEST_SIZE + TEST_OFFSET], cb[TEST_SIZE + TEST_OFFSET], cr[TEST_SIZE + TEST_OFFSET];
+    rtka_vector_t a, b, r;
+
+    srand(42);
+    make_vector(&a, va, ca, TEST_SIZE);
+    make_vector(&b, vb, cb, TEST_SIZE);
+    make_vector(&r, vr, cr, TEST_SIZE);
+
+    rtka_simd_level_t native = rtka_simd_level();
+    printf("Selected kernels: %s (width %u)\n\n", rtka_simd_level_name(native), rtka_simd_width());
+
+    const rtka_simd_level_t levels[] = {
+        RTKA_SIMD_SCALAR, RTKA_SIMD_SSE41, RTKA_SIMD_AVX2, RTKA_SIMD_AVX512, RTKA_SIMD_NEON
+    };
+
+    bool all_ok = true;
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        if (!rtka_simd_set_level(levels[l])) continue;
+
+        bool ok = true;
+        ok &= check_binary("and", rtka_vector_and, rtka_and, rtka_conf_and, &a, &b, &r);
+        ok &= check_binary("or", rtka_vector_or, rtka_or, rtka_conf_or, &a, &b, &r);
+        ok &= check_binary("nand", rtka_vector_nand, ref_nand, rtka_conf_and, &a, &b, &r);
+        ok &= check_binary("nor", rtka_vector_nor, ref_nor, rtka_conf_or, &a, &b, &r);
+        ok &= check_binary("implies", rtka_vector_implies, rtka_implies, rtka_conf_or, &a, &b, &r);
+        ok &= check_not(&a, &r);
+        ok &= check_activations();
+
+        printf("%-8s %s  (AND %.3f ns/elem, tanh %.3f ns/elem)\n", rtka_simd_level_name(levels[l]),
+               ok ? "PASS" : "FAIL", time_and(&a, &b, &r), time_tanh(true));
+        all_ok &= ok;
+    }
+
+    /* Reductions over chains without an absorbing element for the first 500 terms */
+    for (uint32_t i = 0; i < 500; i++) {
+        if (a.values[i] == RTKA_FALSE) a.values[i] = RTKA_UNKNOWN;
+        if (b.values[i] == RTKA_TRUE) b.values[i] = RTKA_UNKNOWN;
+        a.confidences[i] = b.confidences[i] = 0.99f;
+    }
+    bool reduce_ok = check_reduce(&a) && check_reduce(&b);
+    printf("reduce   %s\n", reduce_ok ? "PASS" : "FAIL");
+    all_ok &= reduce_ok;
+
+    /* Parallel AND on the shared pool against the serial kernel */
+    {
+        const uint32_t n = 1U << 20;
+        rtka_value_t* pv = malloc(3U * n * sizeof(rtka_value_t));
+        float* pc = malloc(3U * n * sizeof(float));
+        rtka_vector_t pa = { pv, pc, n, n };
+        rtka_vector_t pb = { pv + n, pc + n, n, n };
+        rtka_vector_t pr = { pv + 2U * n, pc + 2U * n, 0, n };
+        for (uint32_t i = 0; i < 2U * n; i++) {
+            pv[i] = (rtka_value_t)((rand() % 3) - 1);
+            pc[i] = (float)rand() / (float)RAND_MAX;
+        }
+
+        rtka_vector_parallel_and(&pa, &pb, &pr, 0);
+        bool par_ok = pr.count == n;
+        for (uint32_t i = 0; i < n && par_ok; i++) {
+            par_ok = pr.values[i] == rtka_and(pa.values[i], pb.values[i]) &&
+                     fabsf(pr.confidences[i] - pa.confidences[i] * pb.confidences[i]) <= 1e-6f;
+        }
+        printf("parallel %s  (%u pool workers)\n", par_ok ? "PASS" : "FAIL",
+               rtka_pool_size(rtka_pool_default()));
+        all_ok &= par_ok;
+        free(pv);
+        free(pc);
+    }
+
+    bool restored = rtka_simd_set_level(native);
+    printf("tanhf    %.3f ns/elem (libm)\n", time_tanh(false));
+    printf("\n%s\n", (all_ok && restored) ? "All kernel sets match scalar reference" : "Mismatch detected");
+    return (all_ok && restored) ? 0 : 1;
+}
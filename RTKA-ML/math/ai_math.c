@@ -15,19 +15,45 @@
  * - Linear algebra interfaces
  * - Utility functions
  * 
+ * CHANGELOG v1.1.0:
+ * - aim_mean, aim_std_dev: pairwise summation in 8 SIMD lanes
+ * 
+ * CHANGELOG v1.2.0:
+ * - aim_svd: blocked one-sided Jacobi, round-robin block pairs per thread
+ * - aim_svd_truncated: randomized range finder with power iterations
+ * - aim_eigen_decomposition: Householder tridiagonalization and implicit
+ *   QL with Wilkinson shifts, rotations applied in cache-sized batches
+ * - aim_set_num_threads: team size of the decompositions
+ * - float32 activations on Cephes polynomials, reductions of the softmax
+ *   pair in 8 lanes; aim_log_softmax fused in double
+ * 
+ * CHANGELOG v1.3.0:
+ * - aim_ols: TSQR, row blocks folded into triangular factors per thread,
+ *   the factors folded together; aim_ols_stream for batched rows
+ * 
  * IMPLEMENTATION NOTES:
  * - Uses standard math.h functions for exp, log, sqrt
+ * - Decompositions use POSIX threads unless built with AIM_NO_THREADS
  * - Numerical stability techniques applied (log-sum-exp for softmax)
  * - Early validation for error conditions
  * - All operations validated for NaN and Inf
  */
 
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "ai_math.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <float.h>
 
+#ifndef AIM_NO_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 /* ============================================================================
  * CONSTANTS
  * ============================================================================ */
@@ -35,6 +61,7 @@
 #define AIM_EPSILON 1e-10
 #define AIM_LOG2 0.693147180559945309417
 #define AIM_SQRT_2PI 2.506628274631000502415
+#define AIM_2PI 6.283185307179586476925
 
 /* ============================================================================
  * ACTIVATION FUNCTIONS
@@ -107,6 +134,208 @@ aim_error_t aim_softmax(const double* AIM_RESTRICT input,
     return AIM_SUCCESS;
 }
 
+aim_error_t aim_log_softmax(const double* input, double* output, size_t size) {
+    if (input == NULL || output == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    if (size == 0) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    
+    double max_val = input[0];
+    for (size_t i = 1; i < size; i++) {
+        if (input[i] > max_val) {
+            max_val = input[i];
+        }
+    }
+    
+    double sum_exp = 0.0;
+    for (size_t i = 0; i < size; i++) {
+        sum_exp += exp(input[i] - max_val);
+    }
+    if (!aim_is_valid(sum_exp)) {
+        return AIM_ERROR_DOMAIN;
+    }
+    
+    /* sum_exp >= 1: the maximum contributes exp(0) */
+    double log_sum = max_val + log(sum_exp);
+    for (size_t i = 0; i < size; i++) {
+        output[i] = input[i] - log_sum;
+    }
+    
+    return AIM_SUCCESS;
+}
+
+/* ============================================================================
+ * FLOAT32 ACTIVATIONS
+ * Cephes expf on [-ln2/2, ln2/2] after x = n ln2 + r, scaled by 2^n built in
+ * the exponent bits; tanh takes an odd polynomial below 0.625 where
+ * 1 - 2 / (e^2x + 1) would cancel. No branches, so the loops vectorize.
+ * ============================================================================ */
+
+/* r = x - n ln2 in two parts; fused or in double so that -ffast-math cannot
+ * fold the parts back into one rounded product */
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+#define AIM_EXP_REDUCE(x, n) fmaf((n), 2.12194440e-4f, fmaf((n), -0.693359375f, (x)))
+#else
+#define AIM_EXP_REDUCE(x, n) ((float)((double)(x) - (double)(n) * 0.693147180559945309))
+#endif
+
+#define AIM_F32_LANES 8
+
+AIM_INLINE float aim_expf_approx(float x) {
+    x = x < -87.33654f ? -87.33654f : x;
+    x = x > 88.37626f ? 88.37626f : x;
+    float n = floorf(x * 1.44269504089f + 0.5f);
+    float r = AIM_EXP_REDUCE(x, n);
+    
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+    
+    union { uint32_t bits; float value; } scale = { (uint32_t)((int32_t)n + 127) << 23 };
+    return p * scale.value;
+}
+
+AIM_INLINE float aim_tanhf_approx(float x) {
+    float a = fabsf(x);
+    float z = x * x;
+    float p = -5.70498872745e-3f;
+    p = p * z + 2.06390887954e-2f;
+    p = p * z - 5.37397155531e-2f;
+    p = p * z + 1.33314422036e-1f;
+    p = p * z - 3.33332819422e-1f;
+    float small = x + x * z * p;
+    float large = 1.0f - 2.0f / (aim_expf_approx(2.0f * a) + 1.0f);
+    large = x < 0.0f ? -large : large;
+    return a < 0.625f ? small : large;
+}
+
+void aim_exp_batch_f32(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = aim_expf_approx(input[i]);
+    }
+}
+
+void aim_sigmoid_batch_f32(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = 1.0f / (1.0f + aim_expf_approx(-input[i]));
+    }
+}
+
+void aim_tanh_batch_f32(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = aim_tanhf_approx(input[i]);
+    }
+}
+
+void aim_relu_batch_f32(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = input[i] > 0.0f ? input[i] : 0.0f;
+    }
+}
+
+/* Maximum, AIM_ERROR_DOMAIN when it is not finite; lanes keep the loop vectorized */
+static aim_error_t aim_max_f32(const float* input, size_t size, float* result) {
+    float lanes[AIM_F32_LANES];
+    for (size_t l = 0; l < AIM_F32_LANES; l++) {
+        lanes[l] = input[0];
+    }
+    size_t full = size - size % AIM_F32_LANES;
+    for (size_t i = 0; i < full; i += AIM_F32_LANES) {
+        for (size_t l = 0; l < AIM_F32_LANES; l++) {
+            lanes[l] = input[i + l] > lanes[l] ? input[i + l] : lanes[l];
+        }
+    }
+    for (size_t i = full; i < size; i++) {
+        lanes[0] = input[i] > lanes[0] ? input[i] : lanes[0];
+    }
+    
+    float max_val = lanes[0];
+    for (size_t l = 1; l < AIM_F32_LANES; l++) {
+        max_val = lanes[l] > max_val ? lanes[l] : max_val;
+    }
+    if (!aim_is_valid((double)max_val)) {
+        return AIM_ERROR_DOMAIN;
+    }
+    *result = max_val;
+    return AIM_SUCCESS;
+}
+
+/* Σ exp(x - shift), stored to output when it is not NULL */
+static float aim_exp_sum_f32(const float* input, float* output, size_t size, float shift) {
+    float lanes[AIM_F32_LANES] = {0.0f};
+    size_t full = size - size % AIM_F32_LANES;
+    
+    for (size_t i = 0; i < full; i += AIM_F32_LANES) {
+        for (size_t l = 0; l < AIM_F32_LANES; l++) {
+            float e = aim_expf_approx(input[i + l] - shift);
+            lanes[l] += e;
+            if (output != NULL) {
+                output[i + l] = e;
+            }
+        }
+    }
+    for (size_t i = full; i < size; i++) {
+        float e = aim_expf_approx(input[i] - shift);
+        lanes[i - full] += e;
+        if (output != NULL) {
+            output[i] = e;
+        }
+    }
+    
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+aim_error_t aim_softmax_f32(const float* input, float* output, size_t size) {
+    if (input == NULL || output == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    if (size == 0) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    
+    float max_val;
+    aim_error_t err = aim_max_f32(input, size, &max_val);
+    if (err != AIM_SUCCESS) {
+        return err;
+    }
+    
+    float scale = 1.0f / aim_exp_sum_f32(input, output, size, max_val);
+    for (size_t i = 0; i < size; i++) {
+        output[i] *= scale;
+    }
+    
+    return AIM_SUCCESS;
+}
+
+aim_error_t aim_log_softmax_f32(const float* input, float* output, size_t size) {
+    if (input == NULL || output == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    if (size == 0) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    
+    float max_val;
+    aim_error_t err = aim_max_f32(input, size, &max_val);
+    if (err != AIM_SUCCESS) {
+        return err;
+    }
+    
+    float log_sum = max_val + logf(aim_exp_sum_f32(input, NULL, size, max_val));
+    for (size_t i = 0; i < size; i++) {
+        output[i] = input[i] - log_sum;
+    }
+    
+    return AIM_SUCCESS;
+}
+
 /* ============================================================================
  * STATISTICAL FUNCTIONS
  * ============================================================================ */
@@ -149,6 +378,84 @@ aim_error_t aim_z_score(double x, double mu, double sigma, double* result) {
     return AIM_SUCCESS;
 }
 
+/*
+ * Pairwise summation: AIM_SUM_BLOCK terms at a time in AIM_SUM_LANES
+ * independent lanes, which vectorize, with block sums combined as a binary
+ * tree, so rounding error grows as O(log n) rather than O(n). A NaN or Inf
+ * term always makes its block sum non-finite; only such blocks are
+ * rescanned to tell bad input from overflow.
+ */
+#define AIM_SUM_LANES 8
+#define AIM_SUM_BLOCK 256
+
+static double aim_block_sum(const double* data, size_t size, double mean, bool squares) {
+    double lanes[AIM_SUM_LANES] = {0.0};
+    size_t full = size - size % AIM_SUM_LANES;
+    
+    if (squares) {
+        for (size_t i = 0; i < full; i += AIM_SUM_LANES) {
+            for (size_t l = 0; l < AIM_SUM_LANES; l++) {
+                double diff = data[i + l] - mean;
+                lanes[l] += diff * diff;
+            }
+        }
+        for (size_t i = full; i < size; i++) {
+            double diff = data[i] - mean;
+            lanes[i - full] += diff * diff;
+        }
+    } else {
+        for (size_t i = 0; i < full; i += AIM_SUM_LANES) {
+            for (size_t l = 0; l < AIM_SUM_LANES; l++) {
+                lanes[l] += data[i + l];
+            }
+        }
+        for (size_t i = full; i < size; i++) {
+            lanes[i - full] += data[i];
+        }
+    }
+    
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+/* Σ data, or Σ (data - mean)² with squares; AIM_ERROR_DOMAIN on NaN/Inf */
+static aim_error_t aim_pairwise_sum(const double* data, size_t size, double mean,
+                                    bool squares, double* result) {
+    /* level[d] holds the sum of 2^d blocks while bit d of blocks is set */
+    double level[sizeof(size_t) * 8];
+    size_t blocks = 0;
+    
+    for (size_t first = 0; first < size; first += AIM_SUM_BLOCK) {
+        size_t length = size - first < AIM_SUM_BLOCK ? size - first : AIM_SUM_BLOCK;
+        double sum = aim_block_sum(data + first, length, mean, squares);
+        if (!aim_is_valid(sum)) {
+            for (size_t i = first; i < first + length; i++) {
+                if (!aim_is_valid(data[i])) {
+                    return AIM_ERROR_DOMAIN;
+                }
+            }
+        }
+        
+        size_t carry = blocks++;
+        size_t depth = 0;
+        while (carry & 1) {
+            sum += level[depth++];
+            carry >>= 1;
+        }
+        level[depth] = sum;
+    }
+    
+    double total = 0.0;
+    for (size_t depth = 0; blocks != 0; depth++, blocks >>= 1) {
+        if (blocks & 1) {
+            total += level[depth];
+        }
+    }
+    
+    *result = total;
+    return AIM_SUCCESS;
+}
+
 aim_error_t aim_mean(const double* data, size_t size, double* result) {
     if (data == NULL || result == NULL) {
         return AIM_ERROR_NULL_PARAM;
@@ -158,11 +465,9 @@ aim_error_t aim_mean(const double* data, size_t size, double* result) {
     }
     
     double sum = 0.0;
-    for (size_t i = 0; i < size; i++) {
-        if (!aim_is_valid(data[i])) {
-            return AIM_ERROR_DOMAIN;
-        }
-        sum += data[i];
+    aim_error_t err = aim_pairwise_sum(data, size, 0.0, false, &sum);
+    if (err != AIM_SUCCESS) {
+        return err;
     }
     
     *result = sum / (double)size;
@@ -179,12 +484,9 @@ aim_error_t aim_std_dev(const double* data, size_t size, double mean, double* re
     }
     
     double sum_sq_diff = 0.0;
-    for (size_t i = 0; i < size; i++) {
-        if (!aim_is_valid(data[i])) {
-            return AIM_ERROR_DOMAIN;
-        }
-        double diff = data[i] - mean;
-        sum_sq_diff += diff * diff;
+    aim_error_t err = aim_pairwise_sum(data, size, mean, true, &sum_sq_diff);
+    if (err != AIM_SUCCESS) {
+        return err;
     }
     
     double variance = sum_sq_diff / (double)(size - 1);
@@ -592,11 +894,337 @@ aim_error_t aim_gradient_descent_step(double* theta, const double* gradient,
 }
 
 /* ============================================================================
- * LINEAR ALGEBRA OPERATIONS
- * NOTE: These functions require LAPACK/BLAS for actual implementation
- * Providing interface definitions for integration with external libraries
+ * PARALLEL EXECUTION
+ * Decompositions split their work over a team of threads that meet at
+ * aim_team_sync between phases. Builds with AIM_NO_THREADS run every team
+ * on the calling thread alone.
+ * ============================================================================ */
+
+#define AIM_MAX_THREADS 64
+#define AIM_PARALLEL_MIN_WORK 262144.0   /* Flops per phase worth a second thread */
+
+static size_t aim_thread_limit = 0;
+
+void aim_set_num_threads(size_t num_threads) {
+    aim_thread_limit = num_threads;
+}
+
+typedef struct aim_team aim_team_t;
+typedef void (*aim_task_fn)(aim_team_t* team, size_t index, void* ctx);
+
+struct aim_team {
+    size_t count;
+    aim_task_fn fn;
+    void* ctx;
+#ifndef AIM_NO_THREADS
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    size_t arrived;
+    size_t generation;
+    bool go;
+#endif
+};
+
+/* Threads for a phase of work flops, capped by aim_set_num_threads */
+static size_t aim_team_size(double work) {
+#ifdef AIM_NO_THREADS
+    (void)work;
+    return 1;
+#else
+    size_t threads = aim_thread_limit;
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (size_t)online : 1;
+    }
+    if (threads > AIM_MAX_THREADS) {
+        threads = AIM_MAX_THREADS;
+    }
+    double useful = work / AIM_PARALLEL_MIN_WORK;
+    if (useful < (double)threads) {
+        threads = useful < 1.0 ? 1 : (size_t)useful;
+    }
+    return threads;
+#endif
+}
+
+/* Wait until every member of the team has arrived */
+static void aim_team_sync(aim_team_t* team) {
+#ifdef AIM_NO_THREADS
+    (void)team;
+#else
+    if (team->count == 1) {
+        return;
+    }
+    pthread_mutex_lock(&team->lock);
+    size_t generation = team->generation;
+    if (++team->arrived == team->count) {
+        team->arrived = 0;
+        team->generation++;
+        pthread_cond_broadcast(&team->wake);
+    } else {
+        while (generation == team->generation) {
+            pthread_cond_wait(&team->wake, &team->lock);
+        }
+    }
+    pthread_mutex_unlock(&team->lock);
+#endif
+}
+
+/* [begin, end) of total items for one member */
+static void aim_team_range(const aim_team_t* team, size_t index, size_t total,
+                           size_t* begin, size_t* end) {
+    *begin = total * index / team->count;
+    *end = total * (index + 1) / team->count;
+}
+
+#ifndef AIM_NO_THREADS
+typedef struct {
+    aim_team_t* team;
+    size_t index;
+} aim_member_t;
+
+static void* aim_member_main(void* arg) {
+    aim_member_t* member = (aim_member_t*)arg;
+    aim_team_t* team = member->team;
+    
+    /* The team size is only known once every thread has been started */
+    pthread_mutex_lock(&team->lock);
+    while (!team->go) {
+        pthread_cond_wait(&team->wake, &team->lock);
+    }
+    pthread_mutex_unlock(&team->lock);
+    
+    team->fn(team, member->index, team->ctx);
+    return NULL;
+}
+#endif
+
+/* Run fn on up to threads members, member 0 on the calling thread. Threads
+ * that cannot be started shrink the team instead of failing the call. */
+static void aim_team_run(aim_task_fn fn, void* ctx, size_t threads) {
+    aim_team_t team;
+    team.count = 1;
+    team.fn = fn;
+    team.ctx = ctx;
+    
+#ifndef AIM_NO_THREADS
+    pthread_t handles[AIM_MAX_THREADS];
+    aim_member_t members[AIM_MAX_THREADS];
+    size_t started = 0;
+    
+    pthread_mutex_init(&team.lock, NULL);
+    pthread_cond_init(&team.wake, NULL);
+    team.arrived = 0;
+    team.generation = 0;
+    team.go = false;
+    
+    pthread_mutex_lock(&team.lock);
+    for (size_t t = 1; t < threads && t < AIM_MAX_THREADS; t++) {
+        members[t].team = &team;
+        members[t].index = t;
+        if (pthread_create(&handles[t], NULL, aim_member_main, &members[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+    team.count = started + 1;
+    team.go = true;
+    pthread_cond_broadcast(&team.wake);
+    pthread_mutex_unlock(&team.lock);
+#else
+    (void)threads;
+#endif
+    
+    fn(&team, 0, ctx);
+    
+#ifndef AIM_NO_THREADS
+    for (size_t t = 1; t <= started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    pthread_cond_destroy(&team.wake);
+    pthread_mutex_destroy(&team.lock);
+#endif
+}
+
+/* ============================================================================
+ * LEAST SQUARES
+ * TSQR: the rows of [X | y] are folded into an upper triangular R of
+ * (p + 1) x (p + 1) by Householder reflections of R stacked over a block of
+ * rows, never forming X^T X. Team members fold row ranges of their own and
+ * their factors are folded into one the same way; streams fold each batch
+ * as it arrives. With R = [R11 z; 0 rho], beta solves R11 beta = z and
+ * rho^2 is the residual sum of squares.
  * ============================================================================ */
 
+#define AIM_OLS_BLOCK_ROWS 256
+
+struct aim_ols_stream {
+    size_t p;
+    size_t rows;
+    double* R;              /* (p + 1) x (p + 1), row-major, upper triangular */
+    double* block;          /* AIM_OLS_BLOCK_ROWS x (p + 1) */
+    double* w;              /* p + 1 */
+};
+
+/*
+ * Fold rows x k block B (row-major, overwritten) into R (k x k): for each
+ * column j, the reflection of R[j][j] over B[:, j] zeroing that column, then
+ * applied to the columns after it.
+ */
+static void aim_qr_fold(double* R, size_t k, double* B, size_t rows, double* w) {
+    for (size_t j = 0; j < k; j++) {
+        double tail = 0.0;
+        for (size_t i = 0; i < rows; i++) {
+            tail += B[i * k + j] * B[i * k + j];
+        }
+        if (tail == 0.0) {
+            continue;
+        }
+        
+        double alpha = R[j * k + j];
+        double norm = sqrt(alpha * alpha + tail);
+        double beta = alpha >= 0.0 ? -norm : norm;
+        double tau = (beta - alpha) / beta;
+        double scale = 1.0 / (alpha - beta);
+        for (size_t i = 0; i < rows; i++) {
+            B[i * k + j] *= scale;
+        }
+        R[j * k + j] = beta;
+        
+        /* w = v^T [R row j; B] over columns j + 1.., v[0] = 1 on R */
+        size_t rest = k - j - 1;
+        double* AIM_RESTRICT wr = w + j + 1;
+        double* AIM_RESTRICT row = R + j * k + j + 1;
+        memcpy(wr, row, rest * sizeof(double));
+        for (size_t i = 0; i < rows; i++) {
+            const double* b = B + i * k + j + 1;
+            double v = B[i * k + j];
+            for (size_t c = 0; c < rest; c++) {
+                wr[c] += v * b[c];
+            }
+        }
+        for (size_t c = 0; c < rest; c++) {
+            wr[c] *= tau;
+            row[c] -= wr[c];
+        }
+        for (size_t i = 0; i < rows; i++) {
+            double* b = B + i * k + j + 1;
+            double v = B[i * k + j];
+            for (size_t c = 0; c < rest; c++) {
+                b[c] -= v * wr[c];
+            }
+        }
+    }
+}
+
+/* Fold rows of X (rows x p) and y through block into R */
+static void aim_ols_fold_rows(double* R, size_t p, const double* X, const double* y,
+                              size_t rows, double* block, double* w) {
+    size_t k = p + 1;
+    for (size_t first = 0; first < rows; first += AIM_OLS_BLOCK_ROWS) {
+        size_t count = rows - first < AIM_OLS_BLOCK_ROWS ? rows - first : AIM_OLS_BLOCK_ROWS;
+        for (size_t i = 0; i < count; i++) {
+            memcpy(block + i * k, X + (first + i) * p, p * sizeof(double));
+            block[i * k + p] = y[first + i];
+        }
+        aim_qr_fold(R, k, block, count, w);
+    }
+}
+
+typedef struct {
+    const double* X;
+    const double* y;
+    size_t rows;
+    size_t p;
+    double* factors[AIM_MAX_THREADS];   /* Each k x k, then scratch */
+    aim_error_t status[AIM_MAX_THREADS];
+} aim_ols_job_t;
+
+static void aim_ols_task(aim_team_t* team, size_t index, void* ctx) {
+    aim_ols_job_t* job = (aim_ols_job_t*)ctx;
+    size_t k = job->p + 1;
+    size_t begin, end;
+    aim_team_range(team, index, job->rows, &begin, &end);
+    
+    double* factor = (double*)calloc(k * k + AIM_OLS_BLOCK_ROWS * k + k, sizeof(double));
+    job->factors[index] = factor;
+    if (factor == NULL) {
+        job->status[index] = AIM_ERROR_NOMEM;
+        return;
+    }
+    aim_ols_fold_rows(factor, job->p, job->X + begin * job->p, job->y + begin, end - begin,
+                      factor + k * k, factor + k * k + AIM_OLS_BLOCK_ROWS * k);
+}
+
+/* Fold rows of X and y into R over a team; each member's R is then folded
+ * in as a block of k rows */
+static aim_error_t aim_ols_fold(double* R, size_t p, const double* X, const double* y,
+                                size_t rows, double* block, double* w) {
+    size_t k = p + 1;
+    size_t threads = aim_team_size(2.0 * (double)rows * (double)k * (double)k);
+    if (threads == 1) {
+        aim_ols_fold_rows(R, p, X, y, rows, block, w);
+        return AIM_SUCCESS;
+    }
+    
+    aim_ols_job_t* job = (aim_ols_job_t*)calloc(1, sizeof(aim_ols_job_t));
+    if (job == NULL) {
+        return AIM_ERROR_NOMEM;
+    }
+    job->X = X;
+    job->y = y;
+    job->rows = rows;
+    job->p = p;
+    aim_team_run(aim_ols_task, job, threads);
+    
+    aim_error_t err = AIM_SUCCESS;
+    for (size_t t = 0; t < AIM_MAX_THREADS; t++) {
+        if (job->status[t] != AIM_SUCCESS) {
+            err = job->status[t];
+        }
+    }
+    for (size_t t = 0; t < AIM_MAX_THREADS; t++) {
+        if (job->factors[t] != NULL && err == AIM_SUCCESS) {
+            aim_qr_fold(R, k, job->factors[t], k, w);
+        }
+        free(job->factors[t]);
+    }
+    free(job);
+    return err;
+}
+
+/* Back substitution of R11 beta = z; AIM_ERROR_DOMAIN when X is rank
+ * deficient to AIM_EPSILON relative to its largest pivot */
+static aim_error_t aim_ols_back_substitute(const double* R, size_t p, double* beta) {
+    size_t k = p + 1;
+    double largest = 0.0;
+    for (size_t j = 0; j < p; j++) {
+        largest = fmax(largest, fabs(R[j * k + j]));
+    }
+    if (!aim_is_valid(largest)) {
+        return AIM_ERROR_DOMAIN;
+    }
+    
+    for (size_t j = p; j-- > 0;) {
+        double pivot = R[j * k + j];
+        if (fabs(pivot) <= AIM_EPSILON * largest || pivot == 0.0) {
+            return AIM_ERROR_DOMAIN;
+        }
+        double sum = R[j * k + p];
+        for (size_t c = j + 1; c < p; c++) {
+            sum -= R[j * k + c] * beta[c];
+        }
+        beta[j] = sum / pivot;
+    }
+    
+    for (size_t j = 0; j < p; j++) {
+        if (!aim_is_valid(beta[j])) {
+            return AIM_ERROR_DOMAIN;
+        }
+    }
+    return AIM_SUCCESS;
+}
+
 aim_error_t aim_ols(const double* X, const double* y,
                    size_t n, size_t p, double* beta) {
     if (X == NULL || y == NULL || beta == NULL) {
@@ -606,20 +1234,377 @@ aim_error_t aim_ols(const double* X, const double* y,
         return AIM_ERROR_INVALID_SIZE;
     }
     
-    /* 
-     * NOTE: Full OLS implementation requires matrix operations:
-     * 1. X^T * X (matrix multiplication)
-     * 2. (X^T * X)^(-1) (matrix inversion or Cholesky decomposition)
-     * 3. (X^T * X)^(-1) * X^T * y (matrix-vector multiplication)
-     * 
-     * Production implementation should use LAPACK's DGELS (least squares solver)
-     * or implement using Cholesky decomposition for numerical stability
-     * 
-     * This is a stub that indicates the interface.
-     * Link against LAPACK and use dgels_ for actual implementation.
-     */
+    aim_ols_stream_t* stream = NULL;
+    aim_error_t err = aim_ols_stream_create(p, &stream);
+    if (err != AIM_SUCCESS) {
+        return err;
+    }
+    err = aim_ols_stream_update(stream, X, y, n);
+    if (err == AIM_SUCCESS) {
+        err = aim_ols_stream_solve(stream, beta, NULL);
+    }
+    aim_ols_stream_free(stream);
+    return err;
+}
+
+aim_error_t aim_ols_stream_create(size_t p, aim_ols_stream_t** stream) {
+    if (stream == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    *stream = NULL;
+    if (p == 0 || p > 4096) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    
+    size_t k = p + 1;
+    aim_ols_stream_t* s = (aim_ols_stream_t*)malloc(sizeof(aim_ols_stream_t));
+    double* storage = (double*)calloc(k * k + AIM_OLS_BLOCK_ROWS * k + k, sizeof(double));
+    if (s == NULL || storage == NULL) {
+        free(s);
+        free(storage);
+        return AIM_ERROR_NOMEM;
+    }
+    s->p = p;
+    s->rows = 0;
+    s->R = storage;
+    s->block = storage + k * k;
+    s->w = s->block + AIM_OLS_BLOCK_ROWS * k;
+    *stream = s;
+    return AIM_SUCCESS;
+}
+
+aim_error_t aim_ols_stream_update(aim_ols_stream_t* stream, const double* X,
+                                 const double* y, size_t rows) {
+    if (stream == NULL || X == NULL || y == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    if (rows == 0) {
+        return AIM_SUCCESS;
+    }
+    
+    aim_error_t err = aim_ols_fold(stream->R, stream->p, X, y, rows, stream->block, stream->w);
+    if (err == AIM_SUCCESS) {
+        stream->rows += rows;
+    }
+    return err;
+}
+
+aim_error_t aim_ols_stream_merge(aim_ols_stream_t* into, const aim_ols_stream_t* from) {
+    if (into == NULL || from == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    if (into->p != from->p || into == from) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    
+    size_t k = into->p + 1;
+    size_t rows = k < AIM_OLS_BLOCK_ROWS ? k : AIM_OLS_BLOCK_ROWS;
+    for (size_t first = 0; first < k; first += rows) {
+        size_t count = k - first < rows ? k - first : rows;
+        memcpy(into->block, from->R + first * k, count * k * sizeof(double));
+        aim_qr_fold(into->R, k, into->block, count, into->w);
+    }
+    into->rows += from->rows;
+    return AIM_SUCCESS;
+}
+
+aim_error_t aim_ols_stream_solve(const aim_ols_stream_t* stream, double* beta,
+                                double* residual_ss) {
+    if (stream == NULL || beta == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    if (stream->rows <= stream->p) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    
+    aim_error_t err = aim_ols_back_substitute(stream->R, stream->p, beta);
+    if (err == AIM_SUCCESS && residual_ss != NULL) {
+        double rho = stream->R[stream->p * (stream->p + 1) + stream->p];
+        *residual_ss = rho * rho;
+    }
+    return err;
+}
+
+void aim_ols_stream_free(aim_ols_stream_t* stream) {
+    if (stream != NULL) {
+        free(stream->R);
+        free(stream);
+    }
+}
+
+/* ============================================================================
+ * SINGULAR VALUE DECOMPOSITION
+ * One-sided Jacobi (Hestenes): plane rotations of column pairs until every
+ * pair is orthogonal; the column norms are then the singular values. Columns
+ * are grouped in blocks of AIM_JACOBI_BLOCK that stay in cache while all
+ * their pairs are rotated. A sweep first rotates the pairs inside each block,
+ * then pairs the blocks round-robin; the block pairs of a round are disjoint
+ * and are rotated by the team at once.
+ * ============================================================================ */
+
+#define AIM_JACOBI_BLOCK 16
+#define AIM_JACOBI_MAX_SWEEPS 60
+#define AIM_SVD_OVERSAMPLE 10
+
+typedef struct {
+    double* W;              /* rows x cols, column-major */
+    double* V;              /* cols x cols, column-major */
+    size_t rows;
+    size_t cols;
+    size_t blocks;
+    size_t slots;           /* blocks rounded up to even for the round-robin */
+    double tolerance;
+    double negligible;      /* Squared norm of a column lost in rounding */
+    size_t rotations[AIM_MAX_THREADS];
+} aim_jacobi_t;
+
+/* Orthogonalize columns i and j; 1 when they needed a rotation */
+static size_t aim_jacobi_rotate(const aim_jacobi_t* job, size_t i, size_t j) {
+    double* AIM_RESTRICT wi = job->W + i * job->rows;
+    double* AIM_RESTRICT wj = job->W + j * job->rows;
+    double alpha = 0.0, beta = 0.0, gamma = 0.0;
+    
+    for (size_t r = 0; r < job->rows; r++) {
+        alpha += wi[r] * wi[r];
+        beta += wj[r] * wj[r];
+        gamma += wi[r] * wj[r];
+    }
+    if (alpha <= job->negligible || beta <= job->negligible ||
+        fabs(gamma) <= job->tolerance * sqrt(alpha * beta)) {
+        return 0;
+    }
+    
+    double zeta = (beta - alpha) / (2.0 * gamma);
+    double t = (zeta >= 0.0 ? 1.0 : -1.0) / (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+    double c = 1.0 / sqrt(1.0 + t * t);
+    double s = c * t;
+    
+    for (size_t r = 0; r < job->rows; r++) {
+        double x = wi[r];
+        wi[r] = c * x - s * wj[r];
+        wj[r] = s * x + c * wj[r];
+    }
+    double* AIM_RESTRICT vi = job->V + i * job->cols;
+    double* AIM_RESTRICT vj = job->V + j * job->cols;
+    for (size_t r = 0; r < job->cols; r++) {
+        double x = vi[r];
+        vi[r] = c * x - s * vj[r];
+        vj[r] = s * x + c * vj[r];
+    }
+    return 1;
+}
+
+static void aim_jacobi_block(const aim_jacobi_t* job, size_t block, size_t* first, size_t* last) {
+    *first = block * AIM_JACOBI_BLOCK;
+    *last = *first + AIM_JACOBI_BLOCK < job->cols ? *first + AIM_JACOBI_BLOCK : job->cols;
+}
+
+/* Blocks of pair p in a round: slot 0 stays, the others turn one seat */
+static void aim_jacobi_pair(size_t slots, size_t round, size_t p, size_t* a, size_t* b) {
+    size_t seats = slots - 1;
+    *a = p == 0 ? 0 : 1 + (round + p) % seats;
+    *b = 1 + (round + seats - p) % seats;
+}
+
+static void aim_jacobi_sweep(aim_team_t* team, size_t index, void* ctx) {
+    aim_jacobi_t* job = (aim_jacobi_t*)ctx;
+    size_t rotations = 0;
+    size_t first, last, other_first, other_last;
+    
+    for (size_t block = index; block < job->blocks; block += team->count) {
+        aim_jacobi_block(job, block, &first, &last);
+        for (size_t i = first; i < last; i++) {
+            for (size_t j = i + 1; j < last; j++) {
+                rotations += aim_jacobi_rotate(job, i, j);
+            }
+        }
+    }
+    aim_team_sync(team);
+    
+    for (size_t round = 0; round + 1 < job->slots; round++) {
+        for (size_t p = index; p < job->slots / 2; p += team->count) {
+            size_t a, b;
+            aim_jacobi_pair(job->slots, round, p, &a, &b);
+            if (a >= job->blocks || b >= job->blocks) {
+                continue;
+            }
+            aim_jacobi_block(job, a, &first, &last);
+            aim_jacobi_block(job, b, &other_first, &other_last);
+            for (size_t i = first; i < last; i++) {
+                for (size_t j = other_first; j < other_last; j++) {
+                    rotations += aim_jacobi_rotate(job, i, j);
+                }
+            }
+        }
+        aim_team_sync(team);
+    }
+    
+    job->rotations[index] = rotations;
+}
+
+static void aim_swap_columns(double* M, size_t length, size_t i, size_t j) {
+    double* a = M + i * length;
+    double* b = M + j * length;
+    for (size_t r = 0; r < length; r++) {
+        double x = a[r];
+        a[r] = b[r];
+        b[r] = x;
+    }
+}
+
+/*
+ * W (rows x cols, rows >= cols, column-major) = U * diag(sigma) * V^T.
+ * On return the columns of W are the left singular vectors for the first
+ * rank values, zero after them; V is overwritten, sigma is descending.
+ */
+static aim_error_t aim_jacobi_svd(double* W, size_t rows, size_t cols,
+                                  double* V, double* sigma, size_t* rank) {
+    aim_jacobi_t* job = (aim_jacobi_t*)malloc(sizeof(aim_jacobi_t));
+    if (job == NULL) {
+        return AIM_ERROR_NOMEM;
+    }
+    job->W = W;
+    job->V = V;
+    job->rows = rows;
+    job->cols = cols;
+    job->blocks = (cols + AIM_JACOBI_BLOCK - 1) / AIM_JACOBI_BLOCK;
+    job->slots = job->blocks + job->blocks % 2;
+    job->tolerance = (double)rows * DBL_EPSILON;
+    
+    /* Rotations keep the Frobenius norm; columns below its rounding level
+     * are noise and would keep rotating against each other */
+    double frobenius = 0.0;
+    for (size_t i = 0; i < rows * cols; i++) {
+        frobenius += W[i] * W[i];
+    }
+    job->negligible = frobenius * DBL_EPSILON * DBL_EPSILON;
+    
+    memset(V, 0, cols * cols * sizeof(double));
+    for (size_t j = 0; j < cols; j++) {
+        V[j * cols + j] = 1.0;
+    }
+    
+    /* A round rotates about cols * AIM_JACOBI_BLOCK pairs of 6 * rows flops */
+    size_t threads = aim_team_size(6.0 * (double)rows * (double)cols * AIM_JACOBI_BLOCK);
+    size_t sweep = 0;
+    for (;;) {
+        memset(job->rotations, 0, sizeof(job->rotations));
+        aim_team_run(aim_jacobi_sweep, job, threads);
+        size_t rotations = 0;
+        for (size_t t = 0; t < AIM_MAX_THREADS; t++) {
+            rotations += job->rotations[t];
+        }
+        if (rotations == 0) {
+            break;
+        }
+        if (++sweep == AIM_JACOBI_MAX_SWEEPS) {
+            free(job);
+            return AIM_ERROR_CONVERGENCE;
+        }
+    }
+    free(job);
+    
+    for (size_t j = 0; j < cols; j++) {
+        double sum = 0.0;
+        for (size_t r = 0; r < rows; r++) {
+            sum += W[j * rows + r] * W[j * rows + r];
+        }
+        sigma[j] = sqrt(sum);
+    }
     
-    return AIM_ERROR_LAPACK_NOT_AVAILABLE;
+    /* Descending order, columns of W and V following their values */
+    for (size_t j = 0; j < cols; j++) {
+        size_t largest = j;
+        for (size_t k = j + 1; k < cols; k++) {
+            if (sigma[k] > sigma[largest]) {
+                largest = k;
+            }
+        }
+        if (largest != j) {
+            double x = sigma[j];
+            sigma[j] = sigma[largest];
+            sigma[largest] = x;
+            aim_swap_columns(W, rows, j, largest);
+            aim_swap_columns(V, cols, j, largest);
+        }
+    }
+    
+    double cutoff = sigma[0] * (double)rows * DBL_EPSILON;
+    *rank = 0;
+    for (size_t j = 0; j < cols; j++) {
+        double* w = W + j * rows;
+        if (sigma[j] > cutoff && sigma[j] > 0.0) {
+            double inverse = 1.0 / sigma[j];
+            for (size_t r = 0; r < rows; r++) {
+                w[r] *= inverse;
+            }
+            (*rank)++;
+        } else {
+            memset(w, 0, rows * sizeof(double));
+        }
+    }
+    
+    return AIM_SUCCESS;
+}
+
+/*
+ * Columns rank..rows-1 of Q (rows x rows, column-major) completing its first
+ * rank orthonormal columns to a basis: each is the unit vector farthest from
+ * the span so far, orthogonalized twice. residual holds rows doubles.
+ */
+static void aim_complete_basis(double* Q, size_t rows, size_t rank, double* residual) {
+    for (size_t k = 0; k < rows; k++) {
+        residual[k] = 1.0;
+    }
+    for (size_t c = 0; c < rank; c++) {
+        for (size_t k = 0; k < rows; k++) {
+            residual[k] -= Q[c * rows + k] * Q[c * rows + k];
+        }
+    }
+    
+    for (size_t c = rank; c < rows; c++) {
+        size_t pick = 0;
+        for (size_t k = 1; k < rows; k++) {
+            if (residual[k] > residual[pick]) {
+                pick = k;
+            }
+        }
+        
+        double* q = Q + c * rows;
+        memset(q, 0, rows * sizeof(double));
+        q[pick] = 1.0;
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t b = 0; b < c; b++) {
+                const double* basis = Q + b * rows;
+                double dot = 0.0;
+                for (size_t k = 0; k < rows; k++) {
+                    dot += basis[k] * q[k];
+                }
+                for (size_t k = 0; k < rows; k++) {
+                    q[k] -= dot * basis[k];
+                }
+            }
+        }
+        
+        double norm = 0.0;
+        for (size_t k = 0; k < rows; k++) {
+            norm += q[k] * q[k];
+        }
+        double inverse = 1.0 / sqrt(norm);
+        for (size_t k = 0; k < rows; k++) {
+            q[k] *= inverse;
+            residual[k] -= q[k] * q[k];
+        }
+    }
+}
+
+static bool aim_all_valid(const double* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (!aim_is_valid(data[i])) {
+            return false;
+        }
+    }
+    return true;
 }
 
 aim_error_t aim_svd(const double* A, size_t m, size_t n,
@@ -631,19 +1616,526 @@ aim_error_t aim_svd(const double* A, size_t m, size_t n,
         return AIM_ERROR_INVALID_SIZE;
     }
     
-    /*
-     * NOTE: SVD requires LAPACK's DGESVD routine
-     * A = U * Sigma * V^T
-     * 
-     * Production implementation requires:
-     * - LAPACK dgesvd_ function
-     * - Proper workspace allocation
-     * - Error handling for convergence
-     * 
-     * This is a stub that indicates the interface.
-     */
+    /* Jacobi runs on the columns of A, or of A^T when A is wide, so that
+     * there are never more columns than rows */
+    bool tall = m >= n;
+    size_t rows = tall ? m : n;
+    size_t cols = tall ? n : m;
+    if (rows > SIZE_MAX / sizeof(double) / rows) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    if (!aim_all_valid(A, m * n)) {
+        return AIM_ERROR_DOMAIN;
+    }
+    
+    double* W = (double*)malloc(rows * rows * sizeof(double));
+    double* V = (double*)malloc(cols * cols * sizeof(double));
+    double* residual = (double*)malloc(rows * sizeof(double));
+    if (W == NULL || V == NULL || residual == NULL) {
+        free(W);
+        free(V);
+        free(residual);
+        return AIM_ERROR_NOMEM;
+    }
+    
+    if (tall) {
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                W[j * m + i] = A[i * n + j];
+            }
+        }
+    } else {
+        /* Rows of A are the columns of A^T */
+        memcpy(W, A, m * n * sizeof(double));
+    }
+    
+    size_t rank = 0;
+    aim_error_t err = aim_jacobi_svd(W, rows, cols, V, sigma, &rank);
+    if (err == AIM_SUCCESS) {
+        aim_complete_basis(W, rows, rank, residual);
+        
+        /* A = W S V^T, or A^T = W S V^T for a wide A */
+        const double* left = tall ? W : V;
+        const double* right = tall ? V : W;
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < m; j++) {
+                U[i * m + j] = left[j * m + i];
+            }
+        }
+        memcpy(VT, right, n * n * sizeof(double));
+    }
+    
+    free(W);
+    free(V);
+    free(residual);
+    return err;
+}
+
+/* ============================================================================
+ * RANDOMIZED TRUNCATED SVD
+ * Range finder (Halko, Martinsson, Tropp): Y = (A A^T)^q A Omega for a
+ * Gaussian Omega of k + AIM_SVD_OVERSAMPLE columns, orthonormalized after
+ * every product; the small B = Q^T A is then decomposed with Jacobi.
+ * ============================================================================ */
+
+typedef struct {
+    const double* A;        /* m x n, row-major */
+    size_t m;
+    size_t n;
+    size_t width;
+    const double* input;
+    double* output;
+} aim_product_t;
+
+/* output (m x width) = A * input (n x width), rows split over the team */
+static void aim_product_task(aim_team_t* team, size_t index, void* ctx) {
+    aim_product_t* job = (aim_product_t*)ctx;
+    size_t begin, end;
+    aim_team_range(team, index, job->m, &begin, &end);
+    
+    for (size_t i = begin; i < end; i++) {
+        double* AIM_RESTRICT out = job->output + i * job->width;
+        memset(out, 0, job->width * sizeof(double));
+        for (size_t j = 0; j < job->n; j++) {
+            double a = job->A[i * job->n + j];
+            const double* in = job->input + j * job->width;
+            for (size_t c = 0; c < job->width; c++) {
+                out[c] += a * in[c];
+            }
+        }
+    }
+}
+
+/* output (n x width) = A^T * input (m x width), columns of A split */
+static void aim_product_transposed_task(aim_team_t* team, size_t index, void* ctx) {
+    aim_product_t* job = (aim_product_t*)ctx;
+    size_t begin, end;
+    aim_team_range(team, index, job->n, &begin, &end);
+    
+    memset(job->output + begin * job->width, 0, (end - begin) * job->width * sizeof(double));
+    for (size_t i = 0; i < job->m; i++) {
+        const double* in = job->input + i * job->width;
+        for (size_t j = begin; j < end; j++) {
+            double a = job->A[i * job->n + j];
+            double* AIM_RESTRICT out = job->output + j * job->width;
+            for (size_t c = 0; c < job->width; c++) {
+                out[c] += a * in[c];
+            }
+        }
+    }
+}
+
+static void aim_product(const double* A, size_t m, size_t n, size_t width,
+                        const double* input, double* output, bool transposed) {
+    aim_product_t job = { A, m, n, width, input, output };
+    size_t threads = aim_team_size(2.0 * (double)m * (double)n * (double)width);
+    aim_team_run(transposed ? aim_product_transposed_task : aim_product_task, &job, threads);
+}
+
+/* Orthonormalize the columns of Y (rows x width, row-major) by Gram-Schmidt
+ * run twice; columns dependent on the earlier ones become zero. work holds
+ * rows * width doubles. */
+static void aim_orthonormalize(double* Y, size_t rows, size_t width, double* work) {
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t c = 0; c < width; c++) {
+            work[c * rows + i] = Y[i * width + c];
+        }
+    }
+    
+    for (size_t c = 0; c < width; c++) {
+        double* q = work + c * rows;
+        double before = 0.0;
+        for (size_t i = 0; i < rows; i++) {
+            before += q[i] * q[i];
+        }
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t b = 0; b < c; b++) {
+                const double* basis = work + b * rows;
+                double dot = 0.0;
+                for (size_t i = 0; i < rows; i++) {
+                    dot += basis[i] * q[i];
+                }
+                for (size_t i = 0; i < rows; i++) {
+                    q[i] -= dot * basis[i];
+                }
+            }
+        }
+        double norm = 0.0;
+        for (size_t i = 0; i < rows; i++) {
+            norm += q[i] * q[i];
+        }
+        double scale = norm > before * (double)rows * DBL_EPSILON && norm > 0.0 ? 1.0 / sqrt(norm) : 0.0;
+        for (size_t i = 0; i < rows; i++) {
+            q[i] *= scale;
+        }
+    }
+    
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t c = 0; c < width; c++) {
+            Y[i * width + c] = work[c * rows + i];
+        }
+    }
+}
+
+/* splitmix64 stream through Box-Muller */
+static double aim_gaussian(uint64_t* state) {
+    uint64_t bits[2];
+    for (int k = 0; k < 2; k++) {
+        uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        bits[k] = z ^ (z >> 31);
+    }
+    double u1 = ((double)(bits[0] >> 11) + 1.0) * 0x1.0p-53;
+    double u2 = (double)(bits[1] >> 11) * 0x1.0p-53;
+    return sqrt(-2.0 * log(u1)) * cos(AIM_2PI * u2);
+}
+
+aim_error_t aim_svd_truncated(const double* A, size_t m, size_t n, size_t k,
+                             size_t power_iterations, uint64_t seed,
+                             double* U, double* sigma, double* VT) {
+    if (A == NULL || U == NULL || sigma == NULL || VT == NULL) {
+        return AIM_ERROR_NULL_PARAM;
+    }
+    size_t smaller = m < n ? m : n;
+    if (m == 0 || n == 0 || k == 0 || k > smaller) {
+        return AIM_ERROR_INVALID_SIZE;
+    }
+    if (!aim_all_valid(A, m * n)) {
+        return AIM_ERROR_DOMAIN;
+    }
+    
+    size_t width = k + AIM_SVD_OVERSAMPLE < smaller ? k + AIM_SVD_OVERSAMPLE : smaller;
+    size_t larger = m > n ? m : n;
+    double* Y = (double*)malloc(m * width * sizeof(double));
+    double* Z = (double*)malloc(n * width * sizeof(double));
+    double* work = (double*)malloc(larger * width * sizeof(double));
+    double* V = (double*)malloc(width * width * sizeof(double));
+    double* values = (double*)malloc(width * sizeof(double));
+    if (Y == NULL || Z == NULL || work == NULL || V == NULL || values == NULL) {
+        free(Y);
+        free(Z);
+        free(work);
+        free(V);
+        free(values);
+        return AIM_ERROR_NOMEM;
+    }
+    
+    uint64_t state = seed;
+    for (size_t i = 0; i < n * width; i++) {
+        Z[i] = aim_gaussian(&state);
+    }
+    aim_product(A, m, n, width, Z, Y, false);
+    aim_orthonormalize(Y, m, width, work);
+    for (size_t q = 0; q < power_iterations; q++) {
+        aim_product(A, m, n, width, Y, Z, true);
+        aim_orthonormalize(Z, n, width, work);
+        aim_product(A, m, n, width, Z, Y, false);
+        aim_orthonormalize(Y, m, width, work);
+    }
+    
+    /* B^T = A^T Q, n x width, column-major for Jacobi */
+    aim_product(A, m, n, width, Y, Z, true);
+    for (size_t j = 0; j < n; j++) {
+        for (size_t c = 0; c < width; c++) {
+            work[c * n + j] = Z[j * width + c];
+        }
+    }
+    
+    size_t rank = 0;
+    aim_error_t err = aim_jacobi_svd(work, n, width, V, values, &rank);
+    if (err == AIM_SUCCESS) {
+        /* B^T = W S V^T, so A ~ Q B = (Q V) S W^T */
+        for (size_t i = 0; i < m; i++) {
+            const double* q = Y + i * width;
+            for (size_t c = 0; c < k; c++) {
+                const double* v = V + c * width;
+                double sum = 0.0;
+                for (size_t r = 0; r < width; r++) {
+                    sum += q[r] * v[r];
+                }
+                U[i * k + c] = sum;
+            }
+        }
+        memcpy(sigma, values, k * sizeof(double));
+        memcpy(VT, work, k * n * sizeof(double));
+    }
+    
+    free(Y);
+    free(Z);
+    free(work);
+    free(V);
+    free(values);
+    return err;
+}
+
+/* ============================================================================
+ * SYMMETRIC EIGENSOLVER
+ * Householder reduction to tridiagonal form, the team splitting the rows of
+ * the trailing matrix at every step, then implicit QL/QR iteration with
+ * Wilkinson shifts. The Givens rotations of the iteration are buffered and
+ * applied to the eigenvectors in batches of columns that stay in cache, the
+ * batches split over the team.
+ * ============================================================================ */
+
+#define AIM_QR_MAX_ITERATIONS 64
+#define AIM_ROTATION_COLUMNS 32
+#define AIM_REFLECTOR_ROWS 16
+
+typedef struct {
+    double* A;              /* n x n, row-major; row k keeps reflector k */
+    size_t n;
+    double* tau;
+    double* diagonal;
+    double* offdiagonal;
+    double* w;              /* n */
+} aim_tridiagonal_t;
+
+/* x (length) becomes v with v[0] = 1 and (I - tau v v^T) x = beta e1 */
+static void aim_householder(double* x, size_t length, double* tau, double* beta) {
+    double tail = 0.0;
+    for (size_t i = 1; i < length; i++) {
+        tail += x[i] * x[i];
+    }
+    if (tail == 0.0) {
+        *tau = 0.0;
+        *beta = x[0];
+        return;
+    }
+    
+    double norm = sqrt(x[0] * x[0] + tail);
+    double b = x[0] >= 0.0 ? -norm : norm;
+    double scale = 1.0 / (x[0] - b);
+    *tau = (b - x[0]) / b;
+    *beta = b;
+    x[0] = 1.0;
+    for (size_t i = 1; i < length; i++) {
+        x[i] *= scale;
+    }
+}
+
+static void aim_tridiagonal_task(aim_team_t* team, size_t index, void* ctx) {
+    aim_tridiagonal_t* job = (aim_tridiagonal_t*)ctx;
+    size_t n = job->n;
+    double* A = job->A;
+    double* w = job->w;
+    
+    for (size_t k = 0; k + 2 < n; k++) {
+        size_t length = n - k - 1;
+        double* v = A + k * n + k + 1;
+        double* trailing = A + (k + 1) * n + k + 1;
+        
+        if (index == 0) {
+            job->diagonal[k] = A[k * n + k];
+            aim_householder(v, length, &job->tau[k], &job->offdiagonal[k]);
+        }
+        aim_team_sync(team);
+        
+        double tau = job->tau[k];
+        if (tau != 0.0) {
+            size_t begin, end;
+            aim_team_range(team, index, length, &begin, &end);
+            
+            /* p = tau * A22 * v */
+            for (size_t r = begin; r < end; r++) {
+                const double* row = trailing + r * n;
+                double dot = 0.0;
+                for (size_t c = 0; c < length; c++) {
+                    dot += row[c] * v[c];
+                }
+                w[r] = tau * dot;
+            }
+            aim_team_sync(team);
+            
+            /* w = p - (tau / 2) (p . v) v */
+            if (index == 0) {
+                double dot = 0.0;
+                for (size_t c = 0; c < length; c++) {
+                    dot += w[c] * v[c];
+                }
+                double scale = 0.5 * tau * dot;
+                for (size_t c = 0; c < length; c++) {
+                    w[c] -= scale * v[c];
+                }
+            }
+            aim_team_sync(team);
+            
+            /* A22 -= v w^T + w v^T */
+            for (size_t r = begin; r < end; r++) {
+                double* AIM_RESTRICT row = trailing + r * n;
+                double vr = v[r], wr = w[r];
+                for (size_t c = 0; c < length; c++) {
+                    row[c] -= vr * w[c] + wr * v[c];
+                }
+            }
+        }
+        aim_team_sync(team);
+    }
+}
+
+typedef struct {
+    const double* A;        /* Reflectors, as left by the reduction */
+    const double* tau;
+    size_t n;
+    double* Z;              /* n x n, row-major */
+} aim_reflectors_t;
+
+/*
+ * Z = H[n-3] ... H[1] H[0] = Q^T, built as I H[n-3] ... H[0] from the right so
+ * that rows stay independent; the team splits the rows, a few at a time
+ * sharing every reflector while it is in cache. Row r is untouched by the
+ * reflectors k >= r, which only act on columns past it.
+ */
+static void aim_reflectors_task(aim_team_t* team, size_t index, void* ctx) {
+    aim_reflectors_t* job = (aim_reflectors_t*)ctx;
+    size_t n = job->n;
+    size_t begin, end;
+    aim_team_range(team, index, n, &begin, &end);
+    
+    for (size_t r = begin; r < end; r++) {
+        memset(job->Z + r * n, 0, n * sizeof(double));
+        job->Z[r * n + r] = 1.0;
+    }
+    
+    for (size_t first = begin; first < end; first += AIM_REFLECTOR_ROWS) {
+        size_t last = first + AIM_REFLECTOR_ROWS < end ? first + AIM_REFLECTOR_ROWS : end;
+        if (last < 2) {
+            continue;
+        }
+        size_t top = last - 2 < n - 3 ? last - 2 : n - 3;
+        for (size_t k = top + 1; k-- > 0;) {
+            double tau = job->tau[k];
+            if (tau == 0.0) {
+                continue;
+            }
+            const double* v = job->A + k * n + k + 1;
+            size_t length = n - k - 1;
+            for (size_t r = first > k + 1 ? first : k + 1; r < last; r++) {
+                double* AIM_RESTRICT z = job->Z + r * n + k + 1;
+                double dot = 0.0;
+                for (size_t c = 0; c < length; c++) {
+                    dot += z[c] * v[c];
+                }
+                dot *= tau;
+                for (size_t c = 0; c < length; c++) {
+                    z[c] -= dot * v[c];
+                }
+            }
+        }
+    }
+}
+
+typedef struct {
+    size_t index;
+    double c;
+    double s;
+} aim_rotation_t;
+
+typedef struct {
+    const aim_rotation_t* rotations;
+    size_t count;
+    size_t n;
+    double* Z;              /* Row j is eigenvector j */
+} aim_rotations_t;
+
+static void aim_rotations_task(aim_team_t* team, size_t index, void* ctx) {
+    aim_rotations_t* job = (aim_rotations_t*)ctx;
+    size_t chunks = (job->n + AIM_ROTATION_COLUMNS - 1) / AIM_ROTATION_COLUMNS;
+    size_t begin, end;
+    aim_team_range(team, index, chunks, &begin, &end);
+    
+    for (size_t chunk = begin; chunk < end; chunk++) {
+        size_t first = chunk * AIM_ROTATION_COLUMNS;
+        size_t width = job->n - first < AIM_ROTATION_COLUMNS ? job->n - first : AIM_ROTATION_COLUMNS;
+        for (size_t q = 0; q < job->count; q++) {
+            const aim_rotation_t* g = &job->rotations[q];
+            double* AIM_RESTRICT x = job->Z + g->index * job->n + first;
+            double* AIM_RESTRICT y = x + job->n;
+            for (size_t col = 0; col < width; col++) {
+                double f = y[col];
+                y[col] = g->s * x[col] + g->c * f;
+                x[col] = g->c * x[col] - g->s * f;
+            }
+        }
+    }
+}
+
+static void aim_rotations_flush(aim_rotation_t* rotations, size_t* count, size_t n, double* Z) {
+    if (*count == 0) {
+        return;
+    }
+    aim_rotations_t job = { rotations, *count, n, Z };
+    aim_team_run(aim_rotations_task, &job, aim_team_size(6.0 * (double)*count * (double)n));
+    *count = 0;
+}
+
+/*
+ * Implicit QL iteration with Wilkinson shifts on the tridiagonal matrix
+ * (d, e), e[i] coupling d[i] and d[i + 1]. Rotations of rows i and i + 1
+ * of Z are buffered in rotations (capacity entries).
+ */
+static aim_error_t aim_tridiagonal_ql(double* d, double* e, size_t n, double* Z,
+                                      aim_rotation_t* rotations, size_t capacity) {
+    size_t pending = 0;
+    
+    for (size_t l = 0; l < n; l++) {
+        size_t iterations = 0;
+        size_t m;
+        do {
+            for (m = l; m + 1 < n; m++) {
+                double dd = fabs(d[m]) + fabs(d[m + 1]);
+                if (fabs(e[m]) <= DBL_EPSILON * dd) {
+                    break;
+                }
+            }
+            if (m == l) {
+                break;
+            }
+            if (++iterations > AIM_QR_MAX_ITERATIONS) {
+                return AIM_ERROR_CONVERGENCE;
+            }
+            if (pending + (m - l) > capacity) {
+                aim_rotations_flush(rotations, &pending, n, Z);
+            }
+            
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + (g >= 0.0 ? r : -r));
+            double s = 1.0, c = 1.0, p = 0.0;
+            bool underflow = false;
+            for (size_t i = m; i-- > l;) {
+                double f = s * e[i];
+                double b = c * e[i];
+                r = hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0.0) {
+                    d[i + 1] -= p;
+                    e[m] = 0.0;
+                    underflow = true;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                rotations[pending].index = i;
+                rotations[pending].c = c;
+                rotations[pending].s = s;
+                pending++;
+            }
+            if (!underflow) {
+                d[l] -= p;
+                e[l] = g;
+                e[m] = 0.0;
+            }
+        } while (m != l);
+    }
     
-    return AIM_ERROR_LAPACK_NOT_AVAILABLE;
+    aim_rotations_flush(rotations, &pending, n, Z);
+    return AIM_SUCCESS;
 }
 
 aim_error_t aim_eigen_decomposition(const double* A, size_t n,
@@ -652,23 +2144,89 @@ aim_error_t aim_eigen_decomposition(const double* A, size_t n,
     if (A == NULL || eigenvalues == NULL || eigenvectors == NULL) {
         return AIM_ERROR_NULL_PARAM;
     }
-    if (n == 0) {
+    if (n == 0 || n > SIZE_MAX / sizeof(double) / n) {
         return AIM_ERROR_INVALID_SIZE;
     }
+    if (!aim_all_valid(A, n * n)) {
+        return AIM_ERROR_DOMAIN;
+    }
     
-    /*
-     * NOTE: Eigenvalue decomposition for symmetric matrices requires LAPACK's DSYEV
-     * A * v = lambda * v
-     * 
-     * Production implementation requires:
-     * - LAPACK dsyev_ function (or dsyevd_ for divide-and-conquer)
-     * - Workspace allocation (LWORK query)
-     * - Symmetry validation
-     * 
-     * This is a stub that indicates the interface.
-     */
+    double scale = 0.0;
+    for (size_t i = 0; i < n * n; i++) {
+        scale = fmax(scale, fabs(A[i]));
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i + 1; j < n; j++) {
+            if (fabs(A[i * n + j] - A[j * n + i]) > AIM_EPSILON * scale) {
+                return AIM_ERROR_DOMAIN;
+            }
+        }
+    }
+    
+    size_t capacity = 8 * n + 64;
+    double* work = (double*)malloc(n * n * sizeof(double));
+    double* tau = (double*)calloc(n, sizeof(double));
+    double* offdiagonal = (double*)calloc(n, sizeof(double));
+    double* w = (double*)malloc(n * sizeof(double));
+    aim_rotation_t* rotations = (aim_rotation_t*)malloc(capacity * sizeof(aim_rotation_t));
+    if (work == NULL || tau == NULL || offdiagonal == NULL || w == NULL || rotations == NULL) {
+        free(work);
+        free(tau);
+        free(offdiagonal);
+        free(w);
+        free(rotations);
+        return AIM_ERROR_NOMEM;
+    }
+    memcpy(work, A, n * n * sizeof(double));
+    
+    aim_tridiagonal_t reduction = { work, n, tau, eigenvalues, offdiagonal, w };
+    aim_team_run(aim_tridiagonal_task, &reduction, aim_team_size(4.0 * (double)n * (double)n));
+    if (n >= 2) {
+        eigenvalues[n - 2] = work[(n - 2) * n + n - 2];
+        offdiagonal[n - 2] = work[(n - 2) * n + n - 1];
+    }
+    eigenvalues[n - 1] = work[(n - 1) * n + n - 1];
+    offdiagonal[n - 1] = 0.0;
+    
+    if (n >= 3) {
+        aim_reflectors_t reflectors = { work, tau, n, eigenvectors };
+        aim_team_run(aim_reflectors_task, &reflectors,
+                     aim_team_size(2.0 * (double)n * (double)n * (double)n));
+    } else {
+        memset(eigenvectors, 0, n * n * sizeof(double));
+        for (size_t i = 0; i < n; i++) {
+            eigenvectors[i * n + i] = 1.0;
+        }
+    }
+    
+    aim_error_t err = aim_tridiagonal_ql(eigenvalues, offdiagonal, n, eigenvectors,
+                                         rotations, capacity);
+    
+    /* Ascending eigenvalues; eigenvector j is row j of Z, column j of the
+     * column-major output */
+    if (err == AIM_SUCCESS) {
+        for (size_t j = 0; j < n; j++) {
+            size_t smallest = j;
+            for (size_t k = j + 1; k < n; k++) {
+                if (eigenvalues[k] < eigenvalues[smallest]) {
+                    smallest = k;
+                }
+            }
+            if (smallest != j) {
+                double x = eigenvalues[j];
+                eigenvalues[j] = eigenvalues[smallest];
+                eigenvalues[smallest] = x;
+                aim_swap_columns(eigenvectors, n, j, smallest);
+            }
+        }
+    }
     
-    return AIM_ERROR_LAPACK_NOT_AVAILABLE;
+    free(work);
+    free(tau);
+    free(offdiagonal);
+    free(w);
+    free(rotations);
+    return err;
 }
 
 /* ============================================================================
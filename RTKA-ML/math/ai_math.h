@@ -16,13 +16,28 @@
  * - Optimization: Gradient descent step
  * - Linear algebra interfaces: OLS, SVD, Eigenvalues
  * 
+ * CHANGELOG v1.1.0:
+ * - aim_mean, aim_std_dev: pairwise summation, O(ε log n) error
+ * 
+ * CHANGELOG v1.2.0:
+ * - aim_svd, aim_eigen_decomposition: native, no LAPACK needed
+ * - aim_svd_truncated: randomized SVD of the leading components
+ * - aim_set_num_threads: threads of the decompositions
+ * - float32 activations: polynomial exp / sigmoid / tanh, ReLU, softmax,
+ *   fused log-softmax (also in double)
+ * 
+ * CHANGELOG v1.3.0:
+ * - aim_ols: native TSQR over row blocks in parallel, no normal equations
+ * - aim_ols_stream: least squares over rows that arrive in batches, and
+ *   merging of fits over separate parts of the data
+ * 
  * DEPENDENCIES:
  * - Standard C library (math.h, stdlib.h, stdbool.h)
- * - Optional: LAPACK/BLAS for advanced linear algebra (SVD, Eigenvalues)
+ * - POSIX threads for the decompositions (define AIM_NO_THREADS to build
+ *   them single-threaded)
  * 
  * USAGE:
- * Include this header and link against ai_math.c
- * For SVD and Eigenvalue functions, link against LAPACK/BLAS
+ * Include this header and link against ai_math.c (-lm -lpthread)
  */
 
 #ifndef AI_MATH_H
@@ -122,6 +137,51 @@ aim_error_t aim_softmax(const double* AIM_RESTRICT input,
                         double* AIM_RESTRICT output,
                         size_t size);
 
+/**
+ * Log-softmax: x_i - log(sum(exp(x_j))), fused in one exp pass
+ * @param input Input array
+ * @param output Output array (may be the same as input)
+ * @param size Number of elements
+ * @return AIM_SUCCESS or error code
+ */
+AIM_NODISCARD
+aim_error_t aim_log_softmax(const double* input, double* output, size_t size);
+
+/* ----------------------------------------------------------------------------
+ * float32 activations
+ * Branch-free polynomial approximations that vectorize. Maximum error
+ * against double libm over every float input, vectorized with -ffast-math:
+ *   exp      1.2 ulp on [-87.33, 88.37], inputs clamped to that range
+ *   sigmoid  4.2 ulp
+ *   tanh     2.2 ulp
+ * Output may be the same array as input.
+ * ---------------------------------------------------------------------------- */
+
+void aim_exp_batch_f32(const float* input, float* output, size_t size);
+void aim_sigmoid_batch_f32(const float* input, float* output, size_t size);
+void aim_tanh_batch_f32(const float* input, float* output, size_t size);
+void aim_relu_batch_f32(const float* input, float* output, size_t size);
+
+/**
+ * Softmax over float32, polynomial exp
+ * @param input Input array
+ * @param output Output array (may be the same as input)
+ * @param size Number of elements
+ * @return AIM_SUCCESS or error code
+ */
+AIM_NODISCARD
+aim_error_t aim_softmax_f32(const float* input, float* output, size_t size);
+
+/**
+ * Log-softmax over float32, fused: one exp pass, nothing stored
+ * @param input Input array
+ * @param output Output array (may be the same as input)
+ * @param size Number of elements
+ * @return AIM_SUCCESS or error code
+ */
+AIM_NODISCARD
+aim_error_t aim_log_softmax_f32(const float* input, float* output, size_t size);
+
 /* ============================================================================
  * STATISTICAL FUNCTIONS
  * ============================================================================ */
@@ -149,7 +209,7 @@ AIM_NODISCARD
 aim_error_t aim_z_score(double x, double mu, double sigma, double* result);
 
 /**
- * Calculate mean of array
+ * Calculate mean of array (pairwise summation)
  * @param data Input array
  * @param size Number of elements (must be > 0)
  * @param result Pointer to store result
@@ -159,7 +219,7 @@ AIM_NODISCARD
 aim_error_t aim_mean(const double* data, size_t size, double* result);
 
 /**
- * Calculate standard deviation of array
+ * Calculate standard deviation of array (pairwise summation)
  * @param data Input array
  * @param size Number of elements (must be > 1)
  * @param mean Mean value (pre-computed for efficiency)
@@ -319,53 +379,135 @@ aim_error_t aim_gradient_descent_step(double* theta, const double* gradient,
 
 /* ============================================================================
  * LINEAR ALGEBRA OPERATIONS
- * These functions provide interfaces to standard operations
+ * Native least squares and decompositions
  * ============================================================================ */
 
 /**
- * Ordinary Least Squares: beta = (X^T * X)^(-1) * X^T * y
- * Solves linear regression using normal equations
+ * Ordinary Least Squares: beta minimizing ||X * beta - y||
+ * Solved by QR of [X | y] (TSQR): row blocks are reduced to triangular
+ * factors in parallel and the factors combined, so X^T * X is never formed
+ * and the cost is O(n * p^2) over all threads
  * @param X Design matrix (n x p, row-major)
  * @param y Response vector (n x 1)
  * @param n Number of samples (must be > p)
  * @param p Number of features (must be > 0)
  * @param beta Output coefficients (p x 1)
- * @return AIM_SUCCESS or error code
- * NOTE: Requires LAPACK for matrix inversion
+ * @return AIM_SUCCESS or error code (AIM_ERROR_DOMAIN if X is rank deficient
+ *         or holds NaN / Inf)
  */
 AIM_NODISCARD
 aim_error_t aim_ols(const double* X, const double* y,
                    size_t n, size_t p, double* beta);
 
+/**
+ * Streaming least squares: the (p + 1) x (p + 1) triangular factor of the
+ * rows seen so far, for data that does not fit in memory or arrives in
+ * batches. Batches of any size give the fit aim_ols gives on all the rows.
+ */
+typedef struct aim_ols_stream aim_ols_stream_t;
+
+/**
+ * Create an empty stream
+ * @param p Number of features (1..4096)
+ * @param stream Output stream, freed with aim_ols_stream_free
+ * @return AIM_SUCCESS or error code
+ */
+AIM_NODISCARD
+aim_error_t aim_ols_stream_create(size_t p, aim_ols_stream_t** stream);
+
+/**
+ * Add a batch of rows, in parallel when the batch is large
+ * @param stream Stream
+ * @param X Batch of the design matrix (rows x p, row-major)
+ * @param y Batch of the response (rows x 1)
+ * @param rows Rows in the batch (0 is a no-op)
+ * @return AIM_SUCCESS or error code
+ */
+AIM_NODISCARD
+aim_error_t aim_ols_stream_update(aim_ols_stream_t* stream, const double* X,
+                                 const double* y, size_t rows);
+
+/**
+ * Add the rows of another stream, e.g. one fed by another thread or node
+ * @param into Stream receiving the rows
+ * @param from Stream of the same p; unchanged
+ * @return AIM_SUCCESS or error code
+ */
+AIM_NODISCARD
+aim_error_t aim_ols_stream_merge(aim_ols_stream_t* into, const aim_ols_stream_t* from);
+
+/**
+ * Coefficients of the rows seen so far; the stream can keep growing
+ * @param stream Stream with more than p rows
+ * @param beta Output coefficients (p x 1)
+ * @param residual_ss Output residual sum of squares (may be NULL)
+ * @return AIM_SUCCESS or error code (AIM_ERROR_DOMAIN if rank deficient)
+ */
+AIM_NODISCARD
+aim_error_t aim_ols_stream_solve(const aim_ols_stream_t* stream, double* beta,
+                                double* residual_ss);
+
+/**
+ * Free a stream (NULL is a no-op)
+ */
+void aim_ols_stream_free(aim_ols_stream_t* stream);
+
 /**
  * Singular Value Decomposition: A = U * Sigma * V^T
  * @param A Input matrix (m x n, row-major)
  * @param m Number of rows
  * @param n Number of columns
- * @param U Left singular vectors (m x m)
- * @param sigma Singular values (min(m,n))
- * @param VT Right singular vectors transposed (n x n)
+ * @param U Left singular vectors (m x m, row-major)
+ * @param sigma Singular values (min(m,n), descending)
+ * @param VT Right singular vectors transposed (n x n, row-major)
  * @return AIM_SUCCESS or error code
- * NOTE: Requires LAPACK (dgesvd)
+ * NOTE: One-sided Jacobi; vectors past the numerical rank complete an
+ * orthonormal basis
  */
 AIM_NODISCARD
 aim_error_t aim_svd(const double* A, size_t m, size_t n,
                    double* U, double* sigma, double* VT);
 
+/**
+ * Randomized truncated SVD: A ~ U * Sigma * V^T over the k largest values
+ * @param A Input matrix (m x n, row-major)
+ * @param m Number of rows
+ * @param n Number of columns
+ * @param k Components (1 to min(m,n))
+ * @param power_iterations Passes of A*A^T sharpening the range (1-2 typical)
+ * @param seed Seed of the Gaussian test matrix
+ * @param U Left singular vectors (m x k, row-major)
+ * @param sigma Singular values (k, descending)
+ * @param VT Right singular vectors transposed (k x n, row-major)
+ * @return AIM_SUCCESS or error code
+ * NOTE: Components past the numerical rank have zero vectors
+ */
+AIM_NODISCARD
+aim_error_t aim_svd_truncated(const double* A, size_t m, size_t n, size_t k,
+                             size_t power_iterations, uint64_t seed,
+                             double* U, double* sigma, double* VT);
+
 /**
  * Eigenvalue decomposition: A*v = lambda*v
  * @param A Symmetric matrix (n x n, row-major)
  * @param n Matrix dimension
- * @param eigenvalues Output eigenvalues (n)
+ * @param eigenvalues Output eigenvalues (n, ascending)
  * @param eigenvectors Output eigenvectors (n x n, column-major)
- * @return AIM_SUCCESS or error code
- * NOTE: Requires LAPACK (dsyev)
+ * @return AIM_SUCCESS or error code (AIM_ERROR_DOMAIN if not symmetric)
  */
 AIM_NODISCARD
 aim_error_t aim_eigen_decomposition(const double* A, size_t n,
                                    double* eigenvalues,
                                    double* eigenvectors);
 
+/**
+ * Threads used by the decompositions
+ * @param num_threads Thread count, 0 for one per online CPU (default)
+ * NOTE: Small problems run on fewer threads; not safe to change while a
+ * decomposition runs
+ */
+void aim_set_num_threads(size_t num_threads);
+
 /* ============================================================================
  * UTILITY FUNCTIONS
  * ============================================================================ */
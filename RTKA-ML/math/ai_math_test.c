@@ -0,0 +1,935 @@
+/**
+ * File: ai_math_test.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * AI Mathematical Operations - Test Suite
+ *
+ * Checks of the native decompositions and least squares. Test matrices
+ * are built as Q1 * diag(s) * Q2^T from products of random Householder
+ * reflectors, so the singular values and eigenvalues are known exactly;
+ * regressions compare the TSQR fit with the normal equations.
+ *
+ * CHANGELOG:
+ * 2025-12-14: Initial test implementation
+ *   - aim_svd: U * Sigma * V^T reconstruction, orthonormal U and V,
+ *     singular values of known, rank-deficient, zero, 1 x n and n x 1
+ *     matrices, one and several threads
+ *   - aim_eigen_decomposition: A * v = lambda * v, orthonormal vectors,
+ *     eigenvalues of known and repeated spectra, error codes
+ *   - aim_svd_truncated: leading values, vectors and rank-k error against
+ *     the full SVD, tall, wide and rank-deficient
+ * 2025-12-21: Least squares
+ *   - aim_ols: TSQR coefficients against long double normal equations on
+ *     well-conditioned data, one and several threads; exact fits; nearly
+ *     collinear columns against the true coefficients, where the normal
+ *     equations lose accuracy; exactly collinear columns rejected
+ *   - aim_ols_stream: uneven batches and merged shards against aim_ols,
+ *     residual sum of squares against the residuals, error codes
+ */
+
+#include "ai_math.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* ============================================================================
+ * TEST CONFIGURATION
+ * ============================================================================ */
+
+#define TEST_TOLERANCE 1e-9
+#define TEST_TRUNCATED_TOLERANCE 1e-7
+#define TEST_OLS_TOLERANCE 1e-10
+
+/* Test result tracking */
+typedef struct {
+    size_t passed;
+    size_t failed;
+    size_t total;
+} test_results_t;
+
+static test_results_t g_test_results = {0};
+static uint64_t g_seed = 0x9E3779B97F4A7C15ULL;
+
+/* ============================================================================
+ * TEST UTILITIES
+ * ============================================================================ */
+
+/**
+ * Report test result
+ */
+static void report_test(const char* test_name, bool passed) {
+    g_test_results.total++;
+    if (passed) {
+        g_test_results.passed++;
+        printf("[PASS] %s\n", test_name);
+    } else {
+        g_test_results.failed++;
+        printf("[FAIL] %s\n", test_name);
+    }
+}
+
+/**
+ * Print test summary
+ */
+static void print_test_summary(void) {
+    printf("\n");
+    printf("========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Total:  %zu\n", g_test_results.total);
+    printf("Passed: %zu\n", g_test_results.passed);
+    printf("Failed: %zu\n", g_test_results.failed);
+    printf("Success Rate: %.1f%%\n",
+           100.0 * (double)g_test_results.passed / (double)g_test_results.total);
+    printf("========================================\n");
+}
+
+/* ============================================================================
+ * TEST DATA GENERATION
+ * ============================================================================ */
+
+/**
+ * Uniform value in [-1, 1)
+ */
+static double next_uniform(void) {
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 7;
+    g_seed ^= g_seed << 17;
+    return (double)(g_seed >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+/**
+ * Random orthogonal n x n matrix (row-major): a product of n Householder
+ * reflectors I - 2 v v^T / (v^T v)
+ */
+static void random_orthogonal(double* Q, size_t n) {
+    double* v = (double*)malloc(n * sizeof(double));
+    double* Qv = (double*)malloc(n * sizeof(double));
+    memset(Q, 0, n * n * sizeof(double));
+    for (size_t i = 0; i < n; i++) {
+        Q[i * n + i] = 1.0;
+    }
+    for (size_t r = 0; r < n; r++) {
+        double norm2 = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            v[i] = next_uniform();
+            norm2 += v[i] * v[i];
+        }
+        /* Q <- Q * H */
+        for (size_t i = 0; i < n; i++) {
+            double dot = 0.0;
+            for (size_t j = 0; j < n; j++) {
+                dot += Q[i * n + j] * v[j];
+            }
+            Qv[i] = dot;
+        }
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                Q[i * n + j] -= 2.0 * Qv[i] * v[j] / norm2;
+            }
+        }
+    }
+    free(v);
+    free(Qv);
+}
+
+/**
+ * A = Q1 * diag(s) * Q2^T (m x n, row-major) for min(m, n) values s
+ */
+static void build_matrix(double* A, size_t m, size_t n, const double* s) {
+    size_t r = m < n ? m : n;
+    double* Q1 = (double*)malloc(m * m * sizeof(double));
+    double* Q2 = (double*)malloc(n * n * sizeof(double));
+    random_orthogonal(Q1, m);
+    random_orthogonal(Q2, n);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < r; k++) {
+                sum += Q1[i * m + k] * s[k] * Q2[j * n + k];
+            }
+            A[i * n + j] = sum;
+        }
+    }
+    free(Q1);
+    free(Q2);
+}
+
+/**
+ * Largest |Q^T Q - I| over the first cols columns of Q (rows x ld, row-major)
+ */
+static double orthonormality_error(const double* Q, size_t rows, size_t ld, size_t cols) {
+    double worst = 0.0;
+    for (size_t a = 0; a < cols; a++) {
+        for (size_t b = a; b < cols; b++) {
+            double dot = 0.0;
+            for (size_t i = 0; i < rows; i++) {
+                dot += Q[i * ld + a] * Q[i * ld + b];
+            }
+            worst = fmax(worst, fabs(dot - (a == b ? 1.0 : 0.0)));
+        }
+    }
+    return worst;
+}
+
+/**
+ * Largest |Q Q^T - I| over the first rows rows of Q (rows x cols, row-major)
+ */
+static double row_orthonormality_error(const double* Q, size_t rows, size_t cols) {
+    double worst = 0.0;
+    for (size_t a = 0; a < rows; a++) {
+        for (size_t b = a; b < rows; b++) {
+            double dot = 0.0;
+            for (size_t j = 0; j < cols; j++) {
+                dot += Q[a * cols + j] * Q[b * cols + j];
+            }
+            worst = fmax(worst, fabs(dot - (a == b ? 1.0 : 0.0)));
+        }
+    }
+    return worst;
+}
+
+/* ============================================================================
+ * SVD TESTS
+ * ============================================================================ */
+
+/**
+ * Full SVD of A: reconstruction, orthonormal U and V, descending values
+ * and, when given, the expected singular values; errors relative to the
+ * largest singular value
+ */
+static bool check_svd(const char* name, const double* A, size_t m, size_t n,
+                      const double* expected) {
+    size_t r = m < n ? m : n;
+    double* U = (double*)malloc(m * m * sizeof(double));
+    double* sigma = (double*)malloc(r * sizeof(double));
+    double* VT = (double*)malloc(n * n * sizeof(double));
+
+    aim_error_t err = aim_svd(A, m, n, U, sigma, VT);
+    bool ok = err == AIM_SUCCESS;
+    double recon = 0.0, value_error = 0.0;
+    double u_error = 0.0, v_error = 0.0;
+    if (ok) {
+        double scale = fmax(1.0, sigma[0]);
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                double sum = 0.0;
+                for (size_t k = 0; k < r; k++) {
+                    sum += U[i * m + k] * sigma[k] * VT[k * n + j];
+                }
+                recon = fmax(recon, fabs(sum - A[i * n + j]) / scale);
+            }
+        }
+        u_error = orthonormality_error(U, m, m, m);
+        v_error = row_orthonormality_error(VT, n, n);
+        for (size_t k = 0; k < r; k++) {
+            ok &= sigma[k] >= 0.0 && (k == 0 || sigma[k] <= sigma[k - 1]);
+            if (expected) {
+                value_error = fmax(value_error, fabs(sigma[k] - expected[k]) / scale);
+            }
+        }
+        ok &= recon <= TEST_TOLERANCE && u_error <= TEST_TOLERANCE &&
+              v_error <= TEST_TOLERANCE && value_error <= TEST_TOLERANCE;
+    }
+
+    printf("  %-28s %3zu x %-3zu  recon %.1e  U %.1e  V %.1e  sigma %.1e\n",
+           name, m, n, recon, u_error, v_error, value_error);
+    report_test(name, ok);
+
+    free(U);
+    free(sigma);
+    free(VT);
+    return ok;
+}
+
+static void test_svd_known(void) {
+    const double diag[4] = {3.0, 0.0, 0.0, -2.0};
+    const double diag_s[2] = {3.0, 2.0};
+    check_svd("SVD 2x2 diagonal", diag, 2, 2, diag_s);
+
+    const double ones[4] = {1.0, 1.0, 1.0, 1.0};
+    const double ones_s[2] = {2.0, 0.0};
+    check_svd("SVD 2x2 rank one", ones, 2, 2, ones_s);
+
+    const double row[3] = {1.0, 2.0, 2.0};
+    const double row_s[1] = {3.0};
+    check_svd("SVD 1 x n", row, 1, 3, row_s);
+
+    const double column[3] = {2.0, -3.0, 6.0};
+    const double column_s[1] = {7.0};
+    check_svd("SVD n x 1", column, 3, 1, column_s);
+
+    const double single[1] = {-4.5};
+    const double single_s[1] = {4.5};
+    check_svd("SVD 1 x 1", single, 1, 1, single_s);
+
+    const double zero[9] = {0.0};
+    const double zero_s[3] = {0.0, 0.0, 0.0};
+    check_svd("SVD zero matrix", zero, 3, 3, zero_s);
+
+    double A[8 * 6];
+    const double known_s[5] = {5.0, 3.0, 1.0, 0.5, 0.125};
+    build_matrix(A, 6, 5, known_s);
+    check_svd("SVD known spectrum tall", A, 6, 5, known_s);
+    build_matrix(A, 5, 6, known_s);
+    check_svd("SVD known spectrum wide", A, 5, 6, known_s);
+
+    double wide_row[40];
+    double norm2 = 0.0;
+    for (size_t j = 0; j < 40; j++) {
+        wide_row[j] = next_uniform();
+        norm2 += wide_row[j] * wide_row[j];
+    }
+    double wide_row_s[1] = {sqrt(norm2)};
+    check_svd("SVD 1 x 40 random", wide_row, 1, 40, wide_row_s);
+    check_svd("SVD 40 x 1 random", wide_row, 40, 1, wide_row_s);
+}
+
+static void test_svd_rank_deficient(void) {
+    double A[8 * 7];
+    const double rank2_s[5] = {4.0, 2.0, 0.0, 0.0, 0.0};
+    build_matrix(A, 7, 5, rank2_s);
+    check_svd("SVD rank 2 tall", A, 7, 5, rank2_s);
+    build_matrix(A, 5, 7, rank2_s);
+    check_svd("SVD rank 2 wide", A, 5, 7, rank2_s);
+
+    /* Repeated singular values: any basis of the shared subspace works */
+    const double repeated_s[6] = {2.0, 2.0, 2.0, 1.0, 1.0, 0.0};
+    build_matrix(A, 8, 6, repeated_s);
+    check_svd("SVD repeated values", A, 8, 6, repeated_s);
+
+    /* Two identical columns */
+    double twin[4 * 3] = {
+        1.0, 2.0, 1.0,
+        0.0, 1.0, 0.0,
+        3.0, -1.0, 3.0,
+        2.0, 0.5, 2.0
+    };
+    check_svd("SVD identical columns", twin, 4, 3, NULL);
+}
+
+static void test_svd_threads(void) {
+    const size_t m = 96, n = 64;
+    double* A = (double*)malloc(m * n * sizeof(double));
+    double* s = (double*)malloc(n * sizeof(double));
+    for (size_t k = 0; k < n; k++) {
+        s[k] = (double)(n - k);
+    }
+    build_matrix(A, m, n, s);
+
+    aim_set_num_threads(1);
+    check_svd("SVD 96 x 64, 1 thread", A, m, n, s);
+    aim_set_num_threads(4);
+    check_svd("SVD 96 x 64, 4 threads", A, m, n, s);
+
+    double* AT = (double*)malloc(m * n * sizeof(double));
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            AT[j * m + i] = A[i * n + j];
+        }
+    }
+    check_svd("SVD 64 x 96, 4 threads", AT, n, m, s);
+    aim_set_num_threads(0);
+
+    free(A);
+    free(AT);
+    free(s);
+}
+
+static void test_svd_errors(void) {
+    double A[4] = {1.0, 2.0, 3.0, 4.0};
+    double U[4], sigma[2], VT[4];
+    bool ok = aim_svd(NULL, 2, 2, U, sigma, VT) == AIM_ERROR_NULL_PARAM;
+    ok &= aim_svd(A, 0, 2, U, sigma, VT) == AIM_ERROR_INVALID_SIZE;
+    ok &= aim_svd(A, 2, 0, U, sigma, VT) == AIM_ERROR_INVALID_SIZE;
+    A[3] = NAN;
+    ok &= aim_svd(A, 2, 2, U, sigma, VT) == AIM_ERROR_DOMAIN;
+    report_test("SVD error codes", ok);
+}
+
+/* ============================================================================
+ * EIGENDECOMPOSITION TESTS
+ * ============================================================================ */
+
+/**
+ * Eigendecomposition of symmetric A: residual ||A v - lambda v||,
+ * orthonormal vectors, ascending values and, when given, the expected
+ * eigenvalues; errors relative to the largest |eigenvalue|
+ */
+static bool check_eigen(const char* name, const double* A, size_t n, const double* expected) {
+    double* values = (double*)malloc(n * sizeof(double));
+    double* vectors = (double*)malloc(n * n * sizeof(double));
+
+    aim_error_t err = aim_eigen_decomposition(A, n, values, vectors);
+    bool ok = err == AIM_SUCCESS;
+    double residual = 0.0, value_error = 0.0, v_error = 0.0;
+    if (ok) {
+        double scale = fmax(1.0, fmax(fabs(values[0]), fabs(values[n - 1])));
+        for (size_t k = 0; k < n; k++) {
+            /* Column-major: vector k is contiguous */
+            const double* v = &vectors[k * n];
+            for (size_t i = 0; i < n; i++) {
+                double sum = 0.0;
+                for (size_t j = 0; j < n; j++) {
+                    sum += A[i * n + j] * v[j];
+                }
+                residual = fmax(residual, fabs(sum - values[k] * v[i]) / scale);
+            }
+            ok &= k == 0 || values[k] >= values[k - 1];
+            if (expected) {
+                value_error = fmax(value_error, fabs(values[k] - expected[k]) / scale);
+            }
+        }
+        /* Columns of the column-major matrix are the rows of its transpose */
+        v_error = row_orthonormality_error(vectors, n, n);
+        ok &= residual <= TEST_TOLERANCE && v_error <= TEST_TOLERANCE &&
+              value_error <= TEST_TOLERANCE;
+    }
+
+    printf("  %-28s %3zu x %-3zu  residual %.1e  V %.1e  lambda %.1e\n",
+           name, n, n, residual, v_error, value_error);
+    report_test(name, ok);
+
+    free(values);
+    free(vectors);
+    return ok;
+}
+
+/**
+ * A = Q * diag(lambda) * Q^T (n x n)
+ */
+static void build_symmetric(double* A, size_t n, const double* lambda) {
+    double* Q = (double*)malloc(n * n * sizeof(double));
+    random_orthogonal(Q, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i; j < n; j++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < n; k++) {
+                sum += Q[i * n + k] * lambda[k] * Q[j * n + k];
+            }
+            A[i * n + j] = sum;
+            A[j * n + i] = sum;
+        }
+    }
+    free(Q);
+}
+
+static void test_eigen_known(void) {
+    const double pair[4] = {2.0, 1.0, 1.0, 2.0};
+    const double pair_l[2] = {1.0, 3.0};
+    check_eigen("Eigen 2x2", pair, 2, pair_l);
+
+    const double single[1] = {-4.0};
+    const double single_l[1] = {-4.0};
+    check_eigen("Eigen 1x1", single, 1, single_l);
+
+    const double zero[9] = {0.0};
+    const double zero_l[3] = {0.0, 0.0, 0.0};
+    check_eigen("Eigen zero matrix", zero, 3, zero_l);
+
+    /* Second-difference matrix: lambda_k = 2 - 2 cos(k pi / (n + 1)) */
+    enum { TOEPLITZ_N = 12 };
+    double toeplitz[TOEPLITZ_N * TOEPLITZ_N] = {0.0};
+    double toeplitz_l[TOEPLITZ_N];
+    for (size_t i = 0; i < TOEPLITZ_N; i++) {
+        toeplitz[i * TOEPLITZ_N + i] = 2.0;
+        if (i + 1 < TOEPLITZ_N) {
+            toeplitz[i * TOEPLITZ_N + i + 1] = -1.0;
+            toeplitz[(i + 1) * TOEPLITZ_N + i] = -1.0;
+        }
+        toeplitz_l[i] = 2.0 - 2.0 * cos((double)(i + 1) * M_PI / (TOEPLITZ_N + 1));
+    }
+    check_eigen("Eigen second difference", toeplitz, TOEPLITZ_N, toeplitz_l);
+
+    double A[48 * 48];
+    double lambda[48];
+    for (size_t k = 0; k < 48; k++) {
+        lambda[k] = -12.0 + 0.5 * (double)k;
+    }
+    build_symmetric(A, 48, lambda);
+    check_eigen("Eigen known spectrum", A, 48, lambda);
+
+    /* Repeated and zero eigenvalues, as in a rank-deficient covariance */
+    const double repeated_l[8] = {-3.0, -3.0, 0.0, 0.0, 0.0, 1.0, 5.0, 5.0};
+    build_symmetric(A, 8, repeated_l);
+    check_eigen("Eigen repeated and zero", A, 8, repeated_l);
+}
+
+static void test_eigen_errors(void) {
+    const double skew[4] = {1.0, 2.0, -2.0, 1.0};
+    double values[2], vectors[4];
+    bool ok = aim_eigen_decomposition(skew, 2, values, vectors) == AIM_ERROR_DOMAIN;
+    ok &= aim_eigen_decomposition(skew, 0, values, vectors) == AIM_ERROR_INVALID_SIZE;
+    ok &= aim_eigen_decomposition(NULL, 2, values, vectors) == AIM_ERROR_NULL_PARAM;
+    report_test("Eigen error codes", ok);
+}
+
+/* ============================================================================
+ * TRUNCATED SVD TESTS
+ * ============================================================================ */
+
+/**
+ * Truncated SVD of k components against the full SVD of the same matrix:
+ * leading singular values, the same singular vectors up to sign, and a
+ * rank-k error ||A - U_k S_k V_k^T||_F no worse than the optimal one
+ */
+static bool check_truncated(const char* name, const double* A, size_t m, size_t n, size_t k) {
+    size_t r = m < n ? m : n;
+    double* U = (double*)malloc(m * m * sizeof(double));
+    double* sigma = (double*)malloc(r * sizeof(double));
+    double* VT = (double*)malloc(n * n * sizeof(double));
+    double* Uk = (double*)malloc(m * k * sizeof(double));
+    double* sk = (double*)malloc(k * sizeof(double));
+    double* VTk = (double*)malloc(k * n * sizeof(double));
+
+    bool ok = aim_svd(A, m, n, U, sigma, VT) == AIM_SUCCESS &&
+              aim_svd_truncated(A, m, n, k, 2, 7, Uk, sk, VTk) == AIM_SUCCESS;
+    double value_error = 0.0, vector_error = 0.0, u_error = 0.0, v_error = 0.0;
+    double error_ratio = 0.0;
+    if (ok) {
+        double scale = fmax(1.0, sigma[0]);
+        for (size_t c = 0; c < k; c++) {
+            value_error = fmax(value_error, fabs(sk[c] - sigma[c]) / scale);
+            if (sigma[c] <= TEST_TOLERANCE * scale) {
+                continue;
+            }
+            double u_dot = 0.0, v_dot = 0.0;
+            for (size_t i = 0; i < m; i++) {
+                u_dot += Uk[i * k + c] * U[i * m + c];
+            }
+            for (size_t j = 0; j < n; j++) {
+                v_dot += VTk[c * n + j] * VT[c * n + j];
+            }
+            vector_error = fmax(vector_error, fmax(fabs(fabs(u_dot) - 1.0), fabs(fabs(v_dot) - 1.0)));
+        }
+
+        size_t rank = 0;
+        while (rank < k && sk[rank] > TEST_TOLERANCE * scale) {
+            rank++;
+        }
+        u_error = orthonormality_error(Uk, m, k, rank);
+        v_error = row_orthonormality_error(VTk, rank, n);
+
+        double optimal = 0.0, achieved = 0.0;
+        for (size_t c = k; c < r; c++) {
+            optimal += sigma[c] * sigma[c];
+        }
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                double sum = 0.0;
+                for (size_t c = 0; c < k; c++) {
+                    sum += Uk[i * k + c] * sk[c] * VTk[c * n + j];
+                }
+                double d = A[i * n + j] - sum;
+                achieved += d * d;
+            }
+        }
+        /* Relative to ||A||_F so an exact rank-k fit compares 0 with 0 */
+        double total = 0.0;
+        for (size_t c = 0; c < r; c++) {
+            total += sigma[c] * sigma[c];
+        }
+        error_ratio = (sqrt(achieved) - sqrt(optimal)) / sqrt(total);
+
+        ok &= value_error <= TEST_TRUNCATED_TOLERANCE && vector_error <= TEST_TRUNCATED_TOLERANCE &&
+              u_error <= TEST_TOLERANCE && v_error <= TEST_TOLERANCE &&
+              error_ratio <= TEST_TRUNCATED_TOLERANCE;
+    }
+
+    printf("  %-28s %3zu x %-3zu k %-2zu  sigma %.1e  vectors %.1e  U %.1e  V %.1e  excess %.1e\n",
+           name, m, n, k, value_error, vector_error, u_error, v_error, error_ratio);
+    report_test(name, ok);
+
+    free(U);
+    free(sigma);
+    free(VT);
+    free(Uk);
+    free(sk);
+    free(VTk);
+    return ok;
+}
+
+static void test_svd_truncated(void) {
+    const size_t m = 80, n = 50;
+    double* A = (double*)malloc(m * n * sizeof(double));
+    double s[50];
+
+    /* Decaying spectrum, as in a correlation matrix with a few factors */
+    for (size_t c = 0; c < n; c++) {
+        s[c] = 10.0 * pow(0.5, (double)c);
+    }
+    build_matrix(A, m, n, s);
+    check_truncated("Truncated SVD decaying tall", A, m, n, 6);
+    build_matrix(A, n, m, s);
+    check_truncated("Truncated SVD decaying wide", A, n, m, 6);
+
+    /* Exactly rank 3, more components asked for than the rank */
+    memset(s, 0, sizeof(s));
+    s[0] = 6.0;
+    s[1] = 3.0;
+    s[2] = 2.0;
+    build_matrix(A, m, n, s);
+    check_truncated("Truncated SVD rank 3, k 5", A, m, n, 5);
+
+    /* Every component */
+    const double small_s[4] = {4.0, 3.0, 2.0, 1.0};
+    build_matrix(A, 6, 4, small_s);
+    check_truncated("Truncated SVD k = min(m,n)", A, 6, 4, 4);
+
+    double U[6 * 4], sigma[4], VT[4 * 4];
+    bool ok = aim_svd_truncated(A, 6, 4, 0, 1, 1, U, sigma, VT) == AIM_ERROR_INVALID_SIZE;
+    ok &= aim_svd_truncated(A, 6, 4, 5, 1, 1, U, sigma, VT) == AIM_ERROR_INVALID_SIZE;
+    report_test("Truncated SVD error codes", ok);
+
+    free(A);
+}
+
+/* ============================================================================
+ * LEAST SQUARES TESTS
+ * ============================================================================ */
+
+/**
+ * Regression data: X (n x p) of uniform features with an intercept column
+ * first, and y = X * beta plus uniform noise of the given amplitude
+ */
+static void build_regression(double* X, double* y, size_t n, size_t p,
+                             const double* beta, double noise) {
+    for (size_t i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (size_t j = 0; j < p; j++) {
+            X[i * p + j] = j == 0 ? 1.0 : next_uniform();
+            sum += X[i * p + j] * beta[j];
+        }
+        y[i] = sum + noise * next_uniform();
+    }
+}
+
+/**
+ * Reference fit: X^T X beta = X^T y by Cholesky, accumulated in long double;
+ * false when X^T X is not numerically positive definite
+ */
+static bool normal_equations(const double* X, const double* y, size_t n, size_t p, double* beta) {
+    long double* G = (long double*)calloc(p * p, sizeof(long double));
+    long double* b = (long double*)calloc(p, sizeof(long double));
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t a = 0; a < p; a++) {
+            long double xa = X[i * p + a];
+            b[a] += xa * y[i];
+            for (size_t c = 0; c <= a; c++) {
+                G[a * p + c] += xa * X[i * p + c];
+            }
+        }
+    }
+    /* G = L L^T, L in the lower triangle */
+    for (size_t j = 0; j < p && ok; j++) {
+        long double d = G[j * p + j];
+        for (size_t c = 0; c < j; c++) {
+            d -= G[j * p + c] * G[j * p + c];
+        }
+        if (d <= 0.0L) {
+            ok = false;
+            break;
+        }
+        G[j * p + j] = sqrtl(d);
+        for (size_t i = j + 1; i < p; i++) {
+            long double sum = G[i * p + j];
+            for (size_t c = 0; c < j; c++) {
+                sum -= G[i * p + c] * G[j * p + c];
+            }
+            G[i * p + j] = sum / G[j * p + j];
+        }
+    }
+    if (ok) {
+        for (size_t j = 0; j < p; j++) {
+            long double sum = b[j];
+            for (size_t c = 0; c < j; c++) {
+                sum -= G[j * p + c] * b[c];
+            }
+            b[j] = sum / G[j * p + j];
+        }
+        for (size_t j = p; j-- > 0;) {
+            long double sum = b[j];
+            for (size_t c = j + 1; c < p; c++) {
+                sum -= G[c * p + j] * b[c];
+            }
+            b[j] = sum / G[j * p + j];
+            beta[j] = (double)b[j];
+        }
+    }
+    free(G);
+    free(b);
+    return ok;
+}
+
+/**
+ * Largest |a - b| relative to the largest |b|
+ */
+static double relative_difference(const double* a, const double* b, size_t size) {
+    double worst = 0.0, scale = 0.0;
+    for (size_t i = 0; i < size; i++) {
+        worst = fmax(worst, fabs(a[i] - b[i]));
+        scale = fmax(scale, fabs(b[i]));
+    }
+    return worst / fmax(scale, 1e-300);
+}
+
+/**
+ * Sum of squared residuals of y - X * beta
+ */
+static double residual_sum_of_squares(const double* X, const double* y, size_t n, size_t p,
+                                      const double* beta) {
+    double rss = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double r = y[i];
+        for (size_t j = 0; j < p; j++) {
+            r -= X[i * p + j] * beta[j];
+        }
+        rss += r * r;
+    }
+    return rss;
+}
+
+static void test_ols_normal_equations(void) {
+    const size_t cases[3][2] = {{50, 3}, {5000, 12}, {200000, 24}};
+    double beta_true[24];
+    for (size_t j = 0; j < 24; j++) {
+        beta_true[j] = 3.0 * next_uniform();
+    }
+
+    for (size_t c = 0; c < 3; c++) {
+        size_t n = cases[c][0], p = cases[c][1];
+        double* X = (double*)malloc(n * p * sizeof(double));
+        double* y = (double*)malloc(n * sizeof(double));
+        double beta[24], beta_serial[24], reference[24];
+        build_regression(X, y, n, p, beta_true, 0.1);
+
+        bool ok = normal_equations(X, y, n, p, reference);
+        aim_set_num_threads(1);
+        ok &= aim_ols(X, y, n, p, beta_serial) == AIM_SUCCESS;
+        aim_set_num_threads(4);
+        ok &= aim_ols(X, y, n, p, beta) == AIM_SUCCESS;
+        aim_set_num_threads(0);
+
+        double serial_error = ok ? relative_difference(beta_serial, reference, p) : INFINITY;
+        double parallel_error = ok ? relative_difference(beta, reference, p) : INFINITY;
+        ok &= serial_error <= TEST_OLS_TOLERANCE && parallel_error <= TEST_OLS_TOLERANCE;
+
+        char name[64];
+        snprintf(name, sizeof(name), "OLS vs normal equations %zu x %zu", n, p);
+        printf("  %-40s 1 thread %.1e  4 threads %.1e\n", name, serial_error, parallel_error);
+        report_test(name, ok);
+
+        free(X);
+        free(y);
+    }
+}
+
+static void test_ols_exact_fit(void) {
+    const size_t n = 1000, p = 6;
+    const double beta_true[6] = {0.5, -2.0, 4.0, 1e-3, -7.5, 3.0};
+    double* X = (double*)malloc(n * p * sizeof(double));
+    double* y = (double*)malloc(n * sizeof(double));
+    build_regression(X, y, n, p, beta_true, 0.0);
+
+    double beta[6], rss = -1.0;
+    aim_ols_stream_t* stream = NULL;
+    bool ok = aim_ols_stream_create(p, &stream) == AIM_SUCCESS &&
+              aim_ols_stream_update(stream, X, y, n) == AIM_SUCCESS &&
+              aim_ols_stream_solve(stream, beta, &rss) == AIM_SUCCESS;
+    double error = ok ? relative_difference(beta, beta_true, p) : INFINITY;
+    ok &= error <= TEST_OLS_TOLERANCE && rss >= 0.0 && rss <= 1e-20;
+    printf("  %-40s beta %.1e  rss %.1e\n", "OLS exact fit", error, rss);
+    report_test("OLS exact fit", ok);
+
+    aim_ols_stream_free(stream);
+    free(X);
+    free(y);
+}
+
+/**
+ * Nearly collinear columns: x2 = x1 + delta * noise. The fit of exact
+ * data recovers the true coefficients to about cond(X) * eps; the
+ * normal equations square the condition number and lose the rest
+ */
+static void test_ols_ill_conditioned(void) {
+    const size_t n = 2000, p = 4;
+    const double beta_true[4] = {1.0, 2.0, -3.0, 0.5};
+    const double deltas[2] = {1e-5, 1e-7};
+    double* X = (double*)malloc(n * p * sizeof(double));
+    double* y = (double*)malloc(n * sizeof(double));
+
+    for (size_t d = 0; d < 2; d++) {
+        for (size_t i = 0; i < n; i++) {
+            double x1 = next_uniform();
+            X[i * p + 0] = 1.0;
+            X[i * p + 1] = x1;
+            X[i * p + 2] = x1 + deltas[d] * next_uniform();
+            X[i * p + 3] = next_uniform();
+            y[i] = 0.0;
+            for (size_t j = 0; j < p; j++) {
+                y[i] += X[i * p + j] * beta_true[j];
+            }
+        }
+
+        double beta[4], reference[4];
+        bool ok = aim_ols(X, y, n, p, beta) == AIM_SUCCESS;
+        double error = ok ? relative_difference(beta, beta_true, p) : INFINITY;
+        double normal_error = normal_equations(X, y, n, p, reference) ?
+                              relative_difference(reference, beta_true, p) : INFINITY;
+        /* cond(X) is about 1 / delta */
+        ok &= error <= 1e3 * 2.2e-16 / deltas[d] && error < normal_error;
+
+        char name[64];
+        snprintf(name, sizeof(name), "OLS nearly collinear, delta %.0e", deltas[d]);
+        printf("  %-40s TSQR %.1e  normal equations %.1e\n", name, error, normal_error);
+        report_test(name, ok);
+    }
+
+    /* Exactly collinear: x3 = x1 + x2, and a repeated column */
+    for (size_t i = 0; i < n; i++) {
+        X[i * p + 0] = 1.0;
+        X[i * p + 1] = next_uniform();
+        X[i * p + 2] = next_uniform();
+        X[i * p + 3] = X[i * p + 1] + X[i * p + 2];
+        y[i] = next_uniform();
+    }
+    double beta[4];
+    bool ok = aim_ols(X, y, n, p, beta) == AIM_ERROR_DOMAIN;
+    for (size_t i = 0; i < n; i++) {
+        X[i * p + 3] = X[i * p + 1];
+    }
+    ok &= aim_ols(X, y, n, p, beta) == AIM_ERROR_DOMAIN;
+    report_test("OLS exactly collinear rejected", ok);
+
+    free(X);
+    free(y);
+}
+
+static void test_ols_stream(void) {
+    const size_t n = 20000, p = 10;
+    double beta_true[10];
+    for (size_t j = 0; j < p; j++) {
+        beta_true[j] = next_uniform();
+    }
+    double* X = (double*)malloc(n * p * sizeof(double));
+    double* y = (double*)malloc(n * sizeof(double));
+    build_regression(X, y, n, p, beta_true, 0.5);
+
+    double batch[10], streamed[10], merged[10], rss_streamed = 0.0, rss_merged = 0.0;
+    bool ok = aim_ols(X, y, n, p, batch) == AIM_SUCCESS;
+    double rss = residual_sum_of_squares(X, y, n, p, batch);
+
+    /* Uneven batches around the fold block size, solved part way through */
+    const size_t sizes[] = {1, 7, 255, 256, 257, 1000, 3, 9000};
+    aim_ols_stream_t* stream = NULL;
+    ok &= aim_ols_stream_create(p, &stream) == AIM_SUCCESS;
+    size_t first = 0;
+    for (size_t b = 0; ok && first < n; b++) {
+        size_t rows = b < sizeof(sizes) / sizeof(sizes[0]) ? sizes[b] : n - first;
+        rows = rows < n - first ? rows : n - first;
+        ok &= aim_ols_stream_update(stream, X + first * p, y + first, rows) == AIM_SUCCESS;
+        first += rows;
+        if (first == 1) {
+            ok &= aim_ols_stream_solve(stream, streamed, NULL) == AIM_ERROR_INVALID_SIZE;
+        }
+        if (first == 1519) {
+            ok &= aim_ols_stream_solve(stream, streamed, NULL) == AIM_SUCCESS;
+        }
+    }
+    ok &= aim_ols_stream_solve(stream, streamed, &rss_streamed) == AIM_SUCCESS;
+    double stream_error = ok ? relative_difference(streamed, batch, p) : INFINITY;
+
+    /* Three shards, as fed by separate threads or nodes, merged in turn */
+    aim_ols_stream_t* shards[3] = {NULL, NULL, NULL};
+    const size_t bounds[4] = {0, 4321, 4400, n};
+    for (size_t s = 0; s < 3; s++) {
+        ok &= aim_ols_stream_create(p, &shards[s]) == AIM_SUCCESS &&
+              aim_ols_stream_update(shards[s], X + bounds[s] * p, y + bounds[s],
+                                    bounds[s + 1] - bounds[s]) == AIM_SUCCESS;
+    }
+    ok &= aim_ols_stream_merge(shards[0], shards[2]) == AIM_SUCCESS &&
+          aim_ols_stream_merge(shards[0], shards[1]) == AIM_SUCCESS &&
+          aim_ols_stream_solve(shards[0], merged, &rss_merged) == AIM_SUCCESS;
+    double merge_error = ok ? relative_difference(merged, batch, p) : INFINITY;
+
+    double rss_error = fmax(fabs(rss_streamed - rss), fabs(rss_merged - rss)) / rss;
+    ok &= stream_error <= TEST_OLS_TOLERANCE && merge_error <= TEST_OLS_TOLERANCE &&
+          rss_error <= TEST_OLS_TOLERANCE;
+    printf("  %-40s batches %.1e  shards %.1e  rss %.1e\n", "OLS stream vs batch",
+           stream_error, merge_error, rss_error);
+    report_test("OLS stream vs batch", ok);
+
+    aim_ols_stream_free(stream);
+    for (size_t s = 0; s < 3; s++) {
+        aim_ols_stream_free(shards[s]);
+    }
+    free(X);
+    free(y);
+}
+
+static void test_ols_errors(void) {
+    double X[6] = {1.0, 2.0, 1.0, 3.0, 1.0, 5.0};
+    double y[3] = {1.0, 2.0, 3.0};
+    double beta[2];
+    bool ok = aim_ols(NULL, y, 3, 2, beta) == AIM_ERROR_NULL_PARAM;
+    ok &= aim_ols(X, y, 2, 2, beta) == AIM_ERROR_INVALID_SIZE;
+    ok &= aim_ols(X, y, 3, 0, beta) == AIM_ERROR_INVALID_SIZE;
+    X[3] = NAN;
+    ok &= aim_ols(X, y, 3, 2, beta) == AIM_ERROR_DOMAIN;
+
+    aim_ols_stream_t* a = NULL;
+    aim_ols_stream_t* b = NULL;
+    ok &= aim_ols_stream_create(0, &a) == AIM_ERROR_INVALID_SIZE && a == NULL;
+    ok &= aim_ols_stream_create(2, &a) == AIM_SUCCESS && aim_ols_stream_create(3, &b) == AIM_SUCCESS;
+    ok &= aim_ols_stream_merge(a, b) == AIM_ERROR_INVALID_SIZE;
+    ok &= aim_ols_stream_merge(a, a) == AIM_ERROR_INVALID_SIZE;
+    ok &= aim_ols_stream_update(a, X, y, 0) == AIM_SUCCESS;
+    ok &= aim_ols_stream_solve(a, beta, NULL) == AIM_ERROR_INVALID_SIZE;
+    aim_ols_stream_free(a);
+    aim_ols_stream_free(b);
+    aim_ols_stream_free(NULL);
+    report_test("OLS error codes", ok);
+}
+
+/* ============================================================================
+ * MAIN TEST RUNNER
+ * ============================================================================ */
+
+int main(void) {
+    printf("========================================\n");
+    printf("AI Mathematical Operations Test Suite\n");
+    printf("Copyright (c) 2025 - H.Overman\n");
+    printf("Email: opsec.ee@pm.me\n");
+    printf("========================================\n\n");
+
+    printf("=== SVD Tests ===\n");
+    test_svd_known();
+    test_svd_rank_deficient();
+    test_svd_threads();
+    test_svd_errors();
+    printf("\n");
+
+    printf("=== Eigendecomposition Tests ===\n");
+    test_eigen_known();
+    test_eigen_errors();
+    printf("\n");
+
+    printf("=== Truncated SVD Tests ===\n");
+    test_svd_truncated();
+    printf("\n");
+
+    printf("=== Least Squares Tests ===\n");
+    test_ols_normal_equations();
+    test_ols_exact_fit();
+    test_ols_ill_conditioned();
+    test_ols_stream();
+    test_ols_errors();
+    printf("\n");
+
+    print_test_summary();
+
+    return (g_test_results.failed == 0U) ? 0 : 1;
+}
@@ -7,6 +7,7 @@
  */
 
 #include "rtka_core.h"
+#include "rtka_perf.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -85,7 +86,8 @@ rtka_state_t rtka_recursive_and(const rtka_state_t* states, uint32_t count) {
     rtka_value_t result_value = states[0].value;
     rtka_confidence_t result_conf = states[0].confidence;
     
-    for (uint32_t i = 1; i < count; i++) {
+    uint32_t i = 1;
+    for (; i < count; i++) {
         /* Early termination on FALSE */
         if (RTKA_UNLIKELY(result_value == RTKA_FALSE)) {
             break;
@@ -94,6 +96,7 @@ rtka_state_t rtka_recursive_and(const rtka_state_t* states, uint32_t count) {
         result_value = rtka_and(result_value, states[i].value);
         result_conf = rtka_conf_and(result_conf, states[i].confidence);
     }
+    RTKA_PERF_FOLD(i, count);
     
     return rtka_make_state(result_value, result_conf);
 }
@@ -109,7 +112,8 @@ rtka_state_t rtka_recursive_or(const rtka_state_t* states, uint32_t count) {
     rtka_value_t result_value = states[0].value;
     rtka_confidence_t result_conf = states[0].confidence;
     
-    for (uint32_t i = 1; i < count; i++) {
+    uint32_t i = 1;
+    for (; i < count; i++) {
         /* Early termination on TRUE */
         if (RTKA_UNLIKELY(result_value == RTKA_TRUE)) {
             break;
@@ -118,6 +122,7 @@ rtka_state_t rtka_recursive_or(const rtka_state_t* states, uint32_t count) {
         result_value = rtka_or(result_value, states[i].value);
         result_conf = rtka_conf_or(result_conf, states[i].confidence);
     }
+    RTKA_PERF_FOLD(i, count);
     
     return rtka_make_state(result_value, result_conf);
 }
@@ -143,6 +148,7 @@ void rtka_and_batch(
     uint32_t count
 ) {
     uint32_t i = 0;
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     
     /* Unroll by 4 for better instruction-level parallelism */
     for (; i + 3 < count; i += 4) {
@@ -155,6 +161,8 @@ void rtka_and_batch(
     for (; i < count; i++) {
         result[i] = rtka_combine_and(a[i], b[i]);
     }
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 void rtka_or_batch(
@@ -164,6 +172,7 @@ void rtka_or_batch(
     uint32_t count
 ) {
     uint32_t i = 0;
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     
     for (; i + 3 < count; i += 4) {
         result[i] = rtka_combine_or(a[i], b[i]);
@@ -175,6 +184,8 @@ void rtka_or_batch(
     for (; i < count; i++) {
         result[i] = rtka_combine_or(a[i], b[i]);
     }
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 void rtka_nand_batch(
@@ -184,6 +195,7 @@ void rtka_nand_batch(
     uint32_t count
 ) {
     uint32_t i = 0;
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     
     for (; i + 3 < count; i += 4) {
         result[i] = rtka_combine_nand(a[i], b[i]);
@@ -195,6 +207,8 @@ void rtka_nand_batch(
     for (; i < count; i++) {
         result[i] = rtka_combine_nand(a[i], b[i]);
     }
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 void rtka_nor_batch(
@@ -204,6 +218,7 @@ void rtka_nor_batch(
     uint32_t count
 ) {
     uint32_t i = 0;
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     
     for (; i + 3 < count; i += 4) {
         result[i] = rtka_combine_nor(a[i], b[i]);
@@ -215,6 +230,8 @@ void rtka_nor_batch(
     for (; i < count; i++) {
         result[i] = rtka_combine_nor(a[i], b[i]);
     }
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 void rtka_not_batch(
@@ -223,6 +240,7 @@ void rtka_not_batch(
     uint32_t count
 ) {
     uint32_t i = 0;
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     
     for (; i + 3 < count; i += 4) {
         result[i] = rtka_combine_not(a[i]);
@@ -234,6 +252,8 @@ void rtka_not_batch(
     for (; i < count; i++) {
         result[i] = rtka_combine_not(a[i]);
     }
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 /* ============================================================================
@@ -19,6 +19,10 @@
  *
  * RTKA Core Bridge Implementation - MIT Licensed
  *
+ * v1.1.0 - Metrics from the rtka_perf instrumentation layer
+ *   - Per-thread counters replace the global metrics spinlock
+ *   - Metrics read zero unless built with RTKA_PERF_ENABLED
+ *
  * v1.0.1 - Initial implementation
  *   - Performance tracking
  *   - Module interface
@@ -28,6 +32,7 @@
 #include "rtka_core_bridge.h"
 #include "rtka_memory.h"
 #include "rtka_allocator.h"
+#include "rtka_perf.h"
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
@@ -35,81 +40,28 @@
 #include <math.h>
 #include <stdlib.h>
 
-/* Performance tracking */
-static rtka_performance_t g_performance_metrics = {0};
 static bool g_bridge_initialized = false;
 
-#ifdef RTKA_C11_AVAILABLE
-static _Atomic bool g_metrics_lock = false;
-
-static void acquire_metrics_lock(void) {
-    bool expected = false;
-    while (!atomic_compare_exchange_weak(&g_metrics_lock, &expected, true)) {
-        expected = false;
-    }
-}
-
-static void release_metrics_lock(void) {
-    atomic_store(&g_metrics_lock, false);
-}
-#else
-static void acquire_metrics_lock(void) {}
-static void release_metrics_lock(void) {}
-#endif
-
 /* Module operations with tracking */
 static rtka_state_t core_module_and(rtka_state_t lhs, rtka_state_t rhs) {
-    clock_t start_time = clock();
-
-    rtka_state_t result = rtka_combine_and(lhs, rhs);
-
-    clock_t elapsed = clock() - start_time;
-
-    acquire_metrics_lock();
-    g_performance_metrics.operations_count++;
-    g_performance_metrics.total_time_ns +=
-    (uint64_t)(elapsed * 1000000000ULL / CLOCKS_PER_SEC);
-    release_metrics_lock();
-
-    return result;
+    RTKA_PERF_COUNT(RTKA_PERF_OPERATIONS, 1U);
+    return rtka_combine_and(lhs, rhs);
 }
 
 static rtka_state_t core_module_or(rtka_state_t lhs, rtka_state_t rhs) {
-    clock_t start_time = clock();
-
-    rtka_state_t result = rtka_combine_or(lhs, rhs);
-
-    clock_t elapsed = clock() - start_time;
-
-    acquire_metrics_lock();
-    g_performance_metrics.operations_count++;
-    g_performance_metrics.total_time_ns +=
-    (uint64_t)(elapsed * 1000000000ULL / CLOCKS_PER_SEC);
-    release_metrics_lock();
-
-    return result;
+    RTKA_PERF_COUNT(RTKA_PERF_OPERATIONS, 1U);
+    return rtka_combine_or(lhs, rhs);
 }
 
 static rtka_state_t core_module_not(rtka_state_t operand, rtka_state_t unused) {
     (void)unused;
-
-    rtka_state_t result = rtka_combine_not(operand);
-
-    acquire_metrics_lock();
-    g_performance_metrics.operations_count++;
-    release_metrics_lock();
-
-    return result;
+    RTKA_PERF_COUNT(RTKA_PERF_OPERATIONS, 1U);
+    return rtka_combine_not(operand);
 }
 
 static rtka_state_t core_module_equiv(rtka_state_t lhs, rtka_state_t rhs) {
-    rtka_state_t result = rtka_combine_equiv(lhs, rhs);
-
-    acquire_metrics_lock();
-    g_performance_metrics.operations_count++;
-    release_metrics_lock();
-
-    return result;
+    RTKA_PERF_COUNT(RTKA_PERF_OPERATIONS, 1U);
+    return rtka_combine_equiv(lhs, rhs);
 }
 
 /* Batch operations */
@@ -121,14 +73,14 @@ static void core_batch_and(const rtka_vector_t* lhs, const rtka_vector_t* rhs, r
 
     result->count = count;
 
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     for (uint32_t i = 0U; i < count; i++) {
         result->values[i] = rtka_and(lhs->values[i], rhs->values[i]);
         result->confidences[i] = rtka_conf_and(lhs->confidences[i], rhs->confidences[i]);
     }
 
-    acquire_metrics_lock();
-    g_performance_metrics.operations_count += count;
-    release_metrics_lock();
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 static void core_batch_or(const rtka_vector_t* lhs, const rtka_vector_t* rhs, rtka_vector_t* result) {
@@ -139,14 +91,14 @@ static void core_batch_or(const rtka_vector_t* lhs, const rtka_vector_t* rhs, rt
 
     result->count = count;
 
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_VECTOR);
     for (uint32_t i = 0U; i < count; i++) {
         result->values[i] = rtka_or(lhs->values[i], rhs->values[i]);
         result->confidences[i] = rtka_conf_or(lhs->confidences[i], rhs->confidences[i]);
     }
 
-    acquire_metrics_lock();
-    g_performance_metrics.operations_count += count;
-    release_metrics_lock();
+    RTKA_PERF_TIMER_END(timer);
+    RTKA_PERF_VECTOR(count);
 }
 
 /* Validation */
@@ -180,14 +132,13 @@ static size_t core_deserialize_state(const void* buffer, void* data, size_t buff
 
 /* Module lifecycle */
 static bool core_module_init(void) {
-    memset(&g_performance_metrics, 0, sizeof(g_performance_metrics));
+    rtka_perf_reset();
     g_bridge_initialized = true;
     return true;
 }
 
 static void core_module_cleanup(void) {
     g_bridge_initialized = false;
-    memset(&g_performance_metrics, 0, sizeof(g_performance_metrics));
 }
 
 /* Module descriptor */
@@ -215,8 +166,9 @@ const rtka_module_t rtka_core_module = {
     .init_fn = core_module_init,
     .cleanup_fn = core_module_cleanup,
 
-    .module_data = &g_performance_metrics,
-    .data_size = sizeof(g_performance_metrics)
+    /* Metrics live in the per-thread slots of rtka_perf */
+    .module_data = NULL,
+    .data_size = 0U
 };
 
 /* Vector operations - Fixed to use allocator system */
@@ -325,17 +277,23 @@ void rtka_core_bridge_cleanup(void) {
 }
 
 rtka_performance_t rtka_core_get_performance_metrics(void) {
-    acquire_metrics_lock();
-    rtka_performance_t metrics_copy = g_performance_metrics;
-    release_metrics_lock();
-
-    return metrics_copy;
+    rtka_perf_snapshot_t snap;
+    rtka_perf_snapshot(&snap);
+
+    rtka_performance_t metrics = {0};
+    metrics.operations_count = snap.counters[RTKA_PERF_OPERATIONS];
+    metrics.cache_hits = snap.counters[RTKA_PERF_CACHE_HITS];
+    metrics.cache_misses = snap.counters[RTKA_PERF_CACHE_MISSES];
+    metrics.early_terminations = (uint32_t)snap.counters[RTKA_PERF_EARLY_TERMINATIONS];
+    metrics.recursion_depth_max = snap.recursion_depth_max;
+    for (uint32_t i = 0U; i < RTKA_PERF_TIMER_COUNT; i++) {
+        metrics.total_time_ns += snap.timer_ns[i];
+    }
+    return metrics;
 }
 
 void rtka_core_reset_performance_metrics(void) {
-    acquire_metrics_lock();
-    memset(&g_performance_metrics, 0, sizeof(g_performance_metrics));
-    release_metrics_lock();
+    rtka_perf_reset();
 }
 
 /* Compatibility testing */
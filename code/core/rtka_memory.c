@@ -6,18 +6,483 @@
  * RTKA Memory Management Implementation
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE                 /* MAP_HUGETLB, syscall */
+#endif
+
 #include "rtka_memory.h"
+#include "rtka_perf.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
 
+#ifdef __linux__
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 /* Global allocators */
 static rtka_allocator_t* g_default_state_allocator = NULL;
 static rtka_allocator_t* g_default_temp_allocator = NULL;
 static bool g_memory_initialized = false;
 
+#ifdef RTKA_C11_AVAILABLE
+/* Per-thread block cache of one pool. Registered on the pool for the
+ * pool's lifetime: counters outlive the thread, and a magazine released at
+ * thread exit is adopted by the next thread that needs one. */
+struct rtka_magazine {
+    rtka_allocator_t* owner;
+    rtka_magazine_t* next;
+    bool attached;                  /* Bound to a live thread; guarded by pool_mutex */
+    uint32_t count;
+    atomic_uint_fast32_t allocation_count;  /* Written by the attached thread only */
+    atomic_uint_fast32_t free_count;
+    atomic_size_t bytes;
+    rtka_pool_block_t* blocks[RTKA_MAGAZINE_SIZE];
+};
+
+/* Single writer: a plain load/store pair keeps the fast path free of locked RMWs */
+static inline void magazine_count_add(atomic_uint_fast32_t* counter, uint32_t n) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+/* Caller holds pool_mutex */
+static void magazine_drain_locked(rtka_pool_allocator_t* pool, rtka_magazine_t* mag, uint32_t n) {
+    while (n > 0U && mag->count > 0U) {
+        rtka_pool_block_t* block = mag->blocks[--mag->count];
+        block->next = pool->free_list;
+        pool->free_list = block;
+        pool->allocated_count--;
+        n--;
+    }
+}
+
+static void magazine_thread_exit(void* arg) {
+    rtka_magazine_t* mag = (rtka_magazine_t*)arg;
+    rtka_pool_allocator_t* pool = &mag->owner->impl.pool;
+
+    mtx_lock(&pool->pool_mutex);
+    magazine_drain_locked(pool, mag, mag->count);
+    mag->attached = false;
+    mtx_unlock(&pool->pool_mutex);
+}
+
+static rtka_magazine_t* magazine_get(rtka_allocator_t* allocator) {
+    rtka_pool_allocator_t* pool = &allocator->impl.pool;
+    rtka_magazine_t* mag = tss_get(pool->magazine_key);
+    if (RTKA_LIKELY(mag != NULL)) return mag;
+
+    mtx_lock(&pool->pool_mutex);
+    for (mag = pool->magazines; mag && mag->attached; mag = mag->next) {
+    }
+    if (!mag) {
+        mag = calloc(1U, sizeof(rtka_magazine_t));
+        if (mag) {
+            mag->owner = allocator;
+            atomic_init(&mag->allocation_count, 0U);
+            atomic_init(&mag->free_count, 0U);
+            atomic_init(&mag->bytes, 0U);
+            mag->next = pool->magazines;
+            pool->magazines = mag;
+        }
+    }
+    if (mag) mag->attached = true;
+    mtx_unlock(&pool->pool_mutex);
+
+    if (mag && tss_set(pool->magazine_key, mag) != thrd_success) {
+        mtx_lock(&pool->pool_mutex);
+        mag->attached = false;
+        mtx_unlock(&pool->pool_mutex);
+        return NULL;
+    }
+    return mag;
+}
+
+static void* magazine_alloc(rtka_pool_allocator_t* pool, rtka_magazine_t* mag, size_t size) {
+    RTKA_PERF_COUNT(mag->count == 0U ? RTKA_PERF_CACHE_MISSES : RTKA_PERF_CACHE_HITS, 1U);
+    if (mag->count == 0U) {
+        /* Refill a batch with one lock round-trip */
+        mtx_lock(&pool->pool_mutex);
+        while (mag->count < RTKA_MAGAZINE_BATCH && pool->free_list) {
+            rtka_pool_block_t* block = pool->free_list;
+            pool->free_list = block->next;
+            mag->blocks[mag->count++] = block;
+            pool->allocated_count++;
+        }
+        if (pool->allocated_count > pool->peak_usage) {
+            pool->peak_usage = pool->allocated_count;
+        }
+        mtx_unlock(&pool->pool_mutex);
+        if (mag->count == 0U) return NULL;
+    }
+
+    rtka_pool_block_t* block = mag->blocks[--mag->count];
+    magazine_count_add(&mag->allocation_count, 1U);
+    atomic_store_explicit(&mag->bytes, atomic_load_explicit(&mag->bytes, memory_order_relaxed) + size,
+                          memory_order_relaxed);
+    return block->data;
+}
+
+static void magazine_free(rtka_pool_allocator_t* pool, rtka_magazine_t* mag, rtka_pool_block_t* block) {
+    if (mag->count == RTKA_MAGAZINE_SIZE) {
+        mtx_lock(&pool->pool_mutex);
+        magazine_drain_locked(pool, mag, RTKA_MAGAZINE_BATCH);
+        mtx_unlock(&pool->pool_mutex);
+    }
+    mag->blocks[mag->count++] = block;
+    magazine_count_add(&mag->free_count, 1U);
+}
+
+static void pool_enable_magazines(rtka_pool_allocator_t* pool) {
+    pool->magazines = NULL;
+    pool->magazines_enabled = (tss_create(&pool->magazine_key, magazine_thread_exit) == thrd_success);
+}
+
+static void pool_release_magazines(rtka_pool_allocator_t* pool) {
+    if (!pool->magazines_enabled) return;
+    /* No destructor runs for the key after this */
+    tss_delete(pool->magazine_key);
+    rtka_magazine_t* mag = pool->magazines;
+    while (mag) {
+        rtka_magazine_t* next = mag->next;
+        free(mag);
+        mag = next;
+    }
+    pool->magazines = NULL;
+    pool->magazines_enabled = false;
+}
+#endif
+
+/* Arena backing. Hugetlbfs mappings are reserved at mmap time, so a host
+ * without reserved pages fails there and drops to the next size down. */
+#ifdef __linux__
+#define ARENA_MPOL_BIND 2           /* <numaif.h> values, without libnuma */
+#define ARENA_MPOL_INTERLEAVE 3
+#define ARENA_HUGE_SHIFT 26         /* MAP_HUGE_SHIFT */
+#define ARENA_HUGE_2M ((size_t)2U << 20)
+#define ARENA_HUGE_1G ((size_t)1U << 30)
+
+static size_t arena_system_page(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0L ? (size_t)page : 4096U;
+}
+
+static void* arena_map_huge(size_t size, size_t huge, size_t* mapped) {
+    int log2_huge = __builtin_ctzll((unsigned long long)huge);
+    size_t length = RTKA_ALIGN_UP(size, huge);
+    void* base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2_huge << ARENA_HUGE_SHIFT), -1, 0);
+    if (base == MAP_FAILED) return NULL;
+    *mapped = length;
+    return base;
+}
+
+/* Ordinary pages, 2 MB aligned so transparent huge pages can back all of it */
+static void* arena_map_transparent(size_t size, size_t* mapped) {
+    size_t length = RTKA_ALIGN_UP(size, ARENA_HUGE_2M);
+    size_t slack = ARENA_HUGE_2M - arena_system_page();
+    uint8_t* raw = mmap(NULL, length + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+
+    uint8_t* base = (uint8_t*)RTKA_ALIGN_UP((uintptr_t)raw, (uintptr_t)ARENA_HUGE_2M);
+    if (base > raw) munmap(raw, (size_t)(base - raw));
+    if (raw + slack > base) munmap(base + length, (size_t)(raw + slack - base));
+    (void)madvise(base, length, MADV_HUGEPAGE);
+    *mapped = length;
+    return base;
+}
+
+static bool arena_bind(void* base, size_t length, const rtka_arena_config_t* config, int32_t* bound) {
+    uint32_t nodes = rtka_numa_node_count();
+    unsigned long mask;
+    int mode;
+    if (config->numa_policy == RTKA_NUMA_BIND) {
+        int32_t node = config->numa_node < 0 ? (int32_t)rtka_numa_current_node() : config->numa_node;
+        if ((uint32_t)node >= nodes) return false;
+        mask = 1UL << node;
+        mode = ARENA_MPOL_BIND;
+        *bound = node;
+    } else {
+        mask = nodes >= RTKA_NUMA_MAX_NODES ? ~0UL : (1UL << nodes) - 1UL;
+        mode = ARENA_MPOL_INTERLEAVE;
+    }
+    /* Kernels without NUMA support (or sandboxes) refuse: keep the mapping unbound */
+    if (syscall(SYS_mbind, base, length, mode, &mask, (unsigned long)RTKA_NUMA_MAX_NODES + 1UL, 0U) != 0) {
+        *bound = -1;
+    }
+    return true;
+}
+#endif
+
+static void* arena_alloc(size_t size, size_t alignment, const rtka_arena_config_t* config, rtka_arena_t* arena) {
+    arena->mapped_size = 0U;
+    arena->page_size = 0U;
+    arena->node = -1;
+
+#ifdef __linux__
+    size_t page = arena_system_page();
+    /* Mappings are only page aligned; stricter alignments keep aligned_alloc */
+    if (config && alignment <= page) {
+        if (config->numa_policy == RTKA_NUMA_BIND && config->numa_node >= 0 &&
+            (uint32_t)config->numa_node >= rtka_numa_node_count()) {
+            return NULL;
+        }
+
+        size_t mapped = 0U;
+        uint8_t* base = NULL;
+        if (config->page_size == RTKA_PAGES_DEFAULT) {
+            mapped = RTKA_ALIGN_UP(size, page);
+            base = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == MAP_FAILED) base = NULL;
+        } else {
+            if (config->page_size == RTKA_PAGES_HUGE_1G) {
+                base = arena_map_huge(size, ARENA_HUGE_1G, &mapped);
+                if (base) arena->page_size = ARENA_HUGE_1G;
+            }
+            if (!base) {
+                base = arena_map_huge(size, ARENA_HUGE_2M, &mapped);
+                if (base) arena->page_size = ARENA_HUGE_2M;
+            }
+            if (!base) base = arena_map_transparent(size, &mapped);
+        }
+        if (!base) return NULL;
+        if (!arena->page_size) arena->page_size = page;
+        arena->mapped_size = mapped;
+
+        if (config->numa_policy != RTKA_NUMA_LOCAL && !arena_bind(base, mapped, config, &arena->node)) {
+            munmap(base, mapped);
+            arena->mapped_size = 0U;
+            return NULL;
+        }
+        if (config->prefault) {
+            for (size_t offset = 0U; offset < mapped; offset += arena->page_size) {
+                ((volatile uint8_t*)base)[offset] = 0U;
+            }
+        }
+        return base;
+    }
+#else
+    (void)config;
+#endif
+    return aligned_alloc(alignment, size);
+}
+
+static void arena_free(void* base, const rtka_arena_t* arena) {
+#ifdef __linux__
+    if (arena->mapped_size) {
+        munmap(base, arena->mapped_size);
+        return;
+    }
+#else
+    (void)arena;
+#endif
+    free(base);
+}
+
+uint32_t rtka_numa_node_count(void) {
+    uint32_t nodes = 1U;
+#ifdef __linux__
+    /* A list such as "0", "0-1" or "0,2-3": the highest node listed, plus one */
+    FILE* online = fopen("/sys/devices/system/node/online", "r");
+    if (online) {
+        uint32_t node = 0U;
+        bool digits = false;
+        int c;
+        while ((c = fgetc(online)) != EOF) {
+            if (c >= '0' && c <= '9') {
+                node = node * 10U + (uint32_t)(c - '0');
+                digits = true;
+            } else {
+                if (digits && node + 1U > nodes) nodes = node + 1U;
+                node = 0U;
+                digits = false;
+            }
+        }
+        if (digits && node + 1U > nodes) nodes = node + 1U;
+        fclose(online);
+    }
+#endif
+    return RTKA_MIN(nodes, RTKA_NUMA_MAX_NODES);
+}
+
+uint32_t rtka_numa_current_node(void) {
+#ifdef __linux__
+    unsigned cpu = 0U, node = 0U;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) return node;
+#endif
+    return 0U;
+}
+
+/* Slab header, first cache line of every slab and large span */
+struct rtka_slab {
+    rtka_slab_t* next;
+    rtka_slab_t* prev;              /* Large spans only: unlinked on free */
+    size_t span;
+    uint32_t class_index;
+};
+
+struct RTKA_ALIGNED(64) rtka_slab_class {
+    size_t object_size;
+    rtka_pool_block_t* free_list;
+    rtka_slab_t* slabs;
+    rtka_slab_class_stats_t stats;
+#ifdef RTKA_C11_AVAILABLE
+    mtx_t lock;
+#endif
+};
+
+#define RTKA_SLAB_HEADER RTKA_CACHE_LINE_SIZE
+
+static size_t slab_class_size(uint32_t index) {
+    if (index < 4U) return (size_t)(index + 1U) * 64U;
+    index -= 4U;
+    uint32_t octave = 8U + index / 4U;
+    return ((size_t)1U << octave) + (size_t)(index % 4U + 1U) * ((size_t)1U << (octave - 2U));
+}
+
+uint32_t rtka_slab_class_index(size_t size) {
+    if (size <= 256U) return size == 0U ? 0U : (uint32_t)((size - 1U) / 64U);
+    if (size > RTKA_SLAB_MAX_OBJECT) return RTKA_SLAB_CLASS_COUNT;
+
+    size_t s = size - 1U;
+    uint32_t octave = 8U;
+    while ((s >> (octave + 1U)) != 0U) octave++;
+    return 4U + (octave - 8U) * 4U + (uint32_t)((s - ((size_t)1U << octave)) >> (octave - 2U));
+}
+
+static inline void slab_lock(const rtka_slab_allocator_t* slab, rtka_slab_class_t* cls) {
+#ifdef RTKA_C11_AVAILABLE
+    if (slab->thread_safe) mtx_lock(&cls->lock);
+#else
+    (void)slab; (void)cls;
+#endif
+}
+
+static inline void slab_unlock(const rtka_slab_allocator_t* slab, rtka_slab_class_t* cls) {
+#ifdef RTKA_C11_AVAILABLE
+    if (slab->thread_safe) mtx_unlock(&cls->lock);
+#else
+    (void)slab; (void)cls;
+#endif
+}
+
+static void slab_count_alloc(rtka_slab_class_t* cls, size_t bytes) {
+    rtka_slab_class_stats_t* st = &cls->stats;
+    st->allocation_count++;
+    st->live_objects++;
+    st->current_bytes += bytes;
+    st->total_bytes += bytes;
+    if (st->live_objects > st->peak_objects) st->peak_objects = st->live_objects;
+    if (st->current_bytes > st->peak_bytes) st->peak_bytes = st->current_bytes;
+}
+
+static void slab_count_free(rtka_slab_class_t* cls, size_t bytes) {
+    cls->stats.free_count++;
+    cls->stats.live_objects--;
+    cls->stats.current_bytes -= bytes;
+}
+
+/* Carve a fresh slab onto the class free list; caller holds the class lock */
+static bool slab_refill(rtka_slab_class_t* cls, uint32_t index) {
+    rtka_slab_t* slab = aligned_alloc(RTKA_SLAB_SIZE, RTKA_SLAB_SIZE);
+    if (!slab) return false;
+
+    slab->span = RTKA_SLAB_SIZE;
+    slab->class_index = index;
+    slab->prev = NULL;
+    slab->next = cls->slabs;
+    cls->slabs = slab;
+    cls->stats.slab_count++;
+
+    size_t count = (RTKA_SLAB_SIZE - RTKA_SLAB_HEADER) / cls->object_size;
+    uint8_t* object = (uint8_t*)slab + RTKA_SLAB_HEADER + (count - 1U) * cls->object_size;
+    for (size_t i = 0U; i < count; i++, object -= cls->object_size) {
+        rtka_pool_block_t* block = (rtka_pool_block_t*)object;
+        block->next = cls->free_list;
+        cls->free_list = block;
+    }
+    return true;
+}
+
+static void* slab_alloc(rtka_slab_allocator_t* slab, size_t size) {
+    uint32_t index = rtka_slab_class_index(size);
+    rtka_slab_class_t* cls = &slab->classes[index];
+
+    if (RTKA_UNLIKELY(index == RTKA_SLAB_CLASS_COUNT)) {
+        if (size > SIZE_MAX - 2U * RTKA_SLAB_SIZE) return NULL;
+        size_t span = RTKA_ALIGN_UP(size + RTKA_SLAB_HEADER, (size_t)RTKA_SLAB_SIZE);
+        rtka_slab_t* large = aligned_alloc(RTKA_SLAB_SIZE, span);
+        if (!large) return NULL;
+
+        large->span = span;
+        large->class_index = index;
+        large->prev = NULL;
+
+        slab_lock(slab, cls);
+        large->next = cls->slabs;
+        if (cls->slabs) cls->slabs->prev = large;
+        cls->slabs = large;
+        cls->stats.slab_count++;
+        slab_count_alloc(cls, span);
+        slab_unlock(slab, cls);
+        return (uint8_t*)large + RTKA_SLAB_HEADER;
+    }
+
+    slab_lock(slab, cls);
+    if (RTKA_UNLIKELY(!cls->free_list) && !slab_refill(cls, index)) {
+        slab_unlock(slab, cls);
+        return NULL;
+    }
+    rtka_pool_block_t* block = cls->free_list;
+    cls->free_list = block->next;
+    slab_count_alloc(cls, cls->object_size);
+    slab_unlock(slab, cls);
+    return block;
+}
+
+static void slab_free(rtka_slab_allocator_t* slab, void* ptr) {
+    rtka_slab_t* header = (rtka_slab_t*)((uintptr_t)ptr & ~(uintptr_t)(RTKA_SLAB_SIZE - 1U));
+    uint32_t index = header->class_index;
+    rtka_slab_class_t* cls = &slab->classes[index];
+
+    slab_lock(slab, cls);
+    if (RTKA_UNLIKELY(index == RTKA_SLAB_CLASS_COUNT)) {
+        if (header->prev) header->prev->next = header->next;
+        else cls->slabs = header->next;
+        if (header->next) header->next->prev = header->prev;
+        cls->stats.slab_count--;
+        slab_count_free(cls, header->span);
+        slab_unlock(slab, cls);
+        free(header);
+        return;
+    }
+
+    rtka_pool_block_t* block = (rtka_pool_block_t*)ptr;
+    block->next = cls->free_list;
+    cls->free_list = block;
+    slab_count_free(cls, cls->object_size);
+    slab_unlock(slab, cls);
+}
+
+static void slab_init_locks(rtka_slab_allocator_t* slab) {
+#ifdef RTKA_C11_AVAILABLE
+    for (uint32_t i = 0U; i <= RTKA_SLAB_CLASS_COUNT; i++) {
+        mtx_init(&slab->classes[i].lock, mtx_plain);
+    }
+#endif
+    slab->thread_safe = true;
+}
+
 /* Pool allocator implementation */
 rtka_allocator_t* rtka_create_pool_allocator(size_t block_size, size_t block_count, bool thread_safe) {
+    return rtka_create_pool_allocator_with_config(block_size, block_count, thread_safe, NULL);
+}
+
+rtka_allocator_t* rtka_create_pool_allocator_with_config(size_t block_size, size_t block_count, bool thread_safe,
+                                                         const rtka_arena_config_t* config) {
     if (block_size == 0U || block_count == 0U) return NULL;
 
     rtka_allocator_t* allocator = calloc(1U, sizeof(rtka_allocator_t));
@@ -31,7 +496,7 @@ rtka_allocator_t* rtka_create_pool_allocator(size_t block_size, size_t block_cou
     size_t actual_block_size = RTKA_ALIGN_UP(block_size + sizeof(rtka_pool_block_t), 16U);
     size_t total_size = actual_block_size * block_count;
 
-    pool->memory_base = aligned_alloc(RTKA_CACHE_LINE_SIZE, total_size);
+    pool->memory_base = arena_alloc(total_size, RTKA_CACHE_LINE_SIZE, config, &pool->arena);
     if (!pool->memory_base) {
         free(allocator);
         return NULL;
@@ -61,6 +526,7 @@ rtka_allocator_t* rtka_create_pool_allocator(size_t block_size, size_t block_cou
         mtx_init(&pool->pool_mutex, mtx_plain);
         atomic_init(&pool->allocated_count, 0U);
         atomic_init(&pool->peak_usage, 0U);
+        pool_enable_magazines(pool);
     }
 #endif
 
@@ -70,6 +536,11 @@ rtka_allocator_t* rtka_create_pool_allocator(size_t block_size, size_t block_cou
 
 /* Stack allocator implementation */
 rtka_allocator_t* rtka_create_stack_allocator(size_t stack_size, size_t alignment) {
+    return rtka_create_stack_allocator_with_config(stack_size, alignment, NULL);
+}
+
+rtka_allocator_t* rtka_create_stack_allocator_with_config(size_t stack_size, size_t alignment,
+                                                          const rtka_arena_config_t* config) {
     if (stack_size == 0U || alignment == 0U) return NULL;
 
     rtka_allocator_t* allocator = calloc(1U, sizeof(rtka_allocator_t));
@@ -80,7 +551,7 @@ rtka_allocator_t* rtka_create_stack_allocator(size_t stack_size, size_t alignmen
 
     rtka_stack_allocator_t* stack = &allocator->impl.stack;
 
-    stack->memory_base = aligned_alloc(alignment, stack_size);
+    stack->memory_base = arena_alloc(stack_size, alignment, config, &stack->arena);
     if (!stack->memory_base) {
         free(allocator);
         return NULL;
@@ -96,6 +567,11 @@ rtka_allocator_t* rtka_create_stack_allocator(size_t stack_size, size_t alignmen
 
 /* Ring allocator implementation */
 rtka_allocator_t* rtka_create_ring_allocator(size_t element_size, size_t element_count) {
+    return rtka_create_ring_allocator_with_config(element_size, element_count, NULL);
+}
+
+rtka_allocator_t* rtka_create_ring_allocator_with_config(size_t element_size, size_t element_count,
+                                                         const rtka_arena_config_t* config) {
     if (element_size == 0U || element_count == 0U) return NULL;
 
     rtka_allocator_t* allocator = calloc(1U, sizeof(rtka_allocator_t));
@@ -107,7 +583,7 @@ rtka_allocator_t* rtka_create_ring_allocator(size_t element_size, size_t element
     rtka_ring_allocator_t* ring = &allocator->impl.ring;
 
     size_t total_size = element_size * element_count;
-    ring->memory_base = aligned_alloc(RTKA_CACHE_LINE_SIZE, total_size);
+    ring->memory_base = arena_alloc(total_size, RTKA_CACHE_LINE_SIZE, config, &ring->arena);
     if (!ring->memory_base) {
         free(allocator);
         return NULL;
@@ -123,6 +599,39 @@ rtka_allocator_t* rtka_create_ring_allocator(size_t element_size, size_t element
     return allocator;
 }
 
+/* Slab allocator implementation */
+rtka_allocator_t* rtka_create_slab_allocator(bool thread_safe) {
+    rtka_allocator_t* allocator = calloc(1U, sizeof(rtka_allocator_t));
+    if (!allocator) return NULL;
+
+    allocator->type = RTKA_ALLOC_SLAB;
+    allocator->name = "RTKA Slab Allocator";
+
+    rtka_slab_allocator_t* slab = &allocator->impl.slab;
+    size_t table_size = RTKA_ALIGN_UP(sizeof(rtka_slab_class_t) * (RTKA_SLAB_CLASS_COUNT + 1U),
+                                      (size_t)RTKA_CACHE_LINE_SIZE);
+    slab->classes = aligned_alloc(RTKA_CACHE_LINE_SIZE, table_size);
+    if (!slab->classes) {
+        free(allocator);
+        return NULL;
+    }
+    memset(slab->classes, 0, table_size);
+
+    for (uint32_t i = 0U; i < RTKA_SLAB_CLASS_COUNT; i++) {
+        slab->classes[i].object_size = slab_class_size(i);
+        slab->classes[i].stats.object_size = slab->classes[i].object_size;
+    }
+
+#ifdef RTKA_C11_AVAILABLE
+    if (thread_safe) slab_init_locks(slab);
+#else
+    (void)thread_safe;
+#endif
+
+    allocator->initialized = true;
+    return allocator;
+}
+
 /* Destroy allocator */
 void rtka_destroy_allocator(rtka_allocator_t* allocator) {
     if (!allocator) return;
@@ -131,17 +640,34 @@ void rtka_destroy_allocator(rtka_allocator_t* allocator) {
         case RTKA_ALLOC_POOL:
 #ifdef RTKA_C11_AVAILABLE
             if (allocator->impl.pool.thread_safe) {
+                pool_release_magazines(&allocator->impl.pool);
                 mtx_destroy(&allocator->impl.pool.pool_mutex);
             }
 #endif
-            free(allocator->impl.pool.memory_base);
+            arena_free(allocator->impl.pool.memory_base, &allocator->impl.pool.arena);
             break;
         case RTKA_ALLOC_STACK:
-            free(allocator->impl.stack.memory_base);
+            arena_free(allocator->impl.stack.memory_base, &allocator->impl.stack.arena);
             break;
         case RTKA_ALLOC_RING:
-            free(allocator->impl.ring.memory_base);
+            arena_free(allocator->impl.ring.memory_base, &allocator->impl.ring.arena);
+            break;
+        case RTKA_ALLOC_SLAB: {
+            rtka_slab_allocator_t* slab = &allocator->impl.slab;
+            for (uint32_t i = 0U; i <= RTKA_SLAB_CLASS_COUNT; i++) {
+                rtka_slab_t* s = slab->classes[i].slabs;
+                while (s) {
+                    rtka_slab_t* next = s->next;
+                    free(s);
+                    s = next;
+                }
+#ifdef RTKA_C11_AVAILABLE
+                if (slab->thread_safe) mtx_destroy(&slab->classes[i].lock);
+#endif
+            }
+            free(slab->classes);
             break;
+        }
         default:
             break;
     }
@@ -149,8 +675,67 @@ void rtka_destroy_allocator(rtka_allocator_t* allocator) {
     free(allocator);
 }
 
+/* Per-node pools */
+struct rtka_node_allocators {
+    uint32_t node_count;
+    rtka_allocator_t* pools[];
+};
+
+rtka_node_allocators_t* rtka_create_node_pool_allocators(size_t block_size, size_t block_count, bool thread_safe,
+                                                         const rtka_arena_config_t* config) {
+    uint32_t count = rtka_numa_node_count();
+    rtka_node_allocators_t* nodes = calloc(1U, sizeof(rtka_node_allocators_t) + count * sizeof(rtka_allocator_t*));
+    if (!nodes) return NULL;
+    nodes->node_count = count;
+
+    rtka_arena_config_t node_config = {0};
+    if (config) node_config = *config;
+    node_config.numa_policy = RTKA_NUMA_BIND;
+
+    for (uint32_t node = 0U; node < count; node++) {
+        node_config.numa_node = (int32_t)node;
+        nodes->pools[node] = rtka_create_pool_allocator_with_config(block_size, block_count, thread_safe,
+                                                                    &node_config);
+        if (!nodes->pools[node]) {
+            rtka_destroy_node_allocators(nodes);
+            return NULL;
+        }
+    }
+    return nodes;
+}
+
+void rtka_destroy_node_allocators(rtka_node_allocators_t* nodes) {
+    if (!nodes) return;
+    for (uint32_t node = 0U; node < nodes->node_count; node++) {
+        rtka_destroy_allocator(nodes->pools[node]);
+    }
+    free(nodes);
+}
+
+rtka_allocator_t* rtka_node_allocator(const rtka_node_allocators_t* nodes) {
+    if (!nodes) return NULL;
+    uint32_t node = rtka_numa_current_node();
+    return nodes->pools[node < nodes->node_count ? node : 0U];
+}
+
+rtka_allocator_t* rtka_node_allocator_at(const rtka_node_allocators_t* nodes, uint32_t node) {
+    return nodes && node < nodes->node_count ? nodes->pools[node] : NULL;
+}
+
+rtka_allocator_t* rtka_node_allocator_owner(const rtka_node_allocators_t* nodes, const void* ptr) {
+    if (!nodes || !ptr) return NULL;
+    for (uint32_t node = 0U; node < nodes->node_count; node++) {
+        const rtka_pool_allocator_t* pool = &nodes->pools[node]->impl.pool;
+        const uint8_t* base = (const uint8_t*)pool->memory_base;
+        if ((const uint8_t*)ptr >= base && (const uint8_t*)ptr < base + pool->total_size) {
+            return nodes->pools[node];
+        }
+    }
+    return NULL;
+}
+
 /* Memory allocation */
-void* rtka_memory_alloc(rtka_allocator_t* allocator, size_t size) {
+static void* memory_alloc(rtka_allocator_t* allocator, size_t size) {
     if (!allocator || !allocator->initialized || size == 0U) return NULL;
 
     void* ptr = NULL;
@@ -161,6 +746,11 @@ void* rtka_memory_alloc(rtka_allocator_t* allocator, size_t size) {
             if (size > pool->block_size) return NULL;
 
 #ifdef RTKA_C11_AVAILABLE
+            if (pool->magazines_enabled) {
+                /* Counted in the magazine; rtka_get_memory_stats sums them */
+                rtka_magazine_t* mag = magazine_get(allocator);
+                if (RTKA_LIKELY(mag != NULL)) return magazine_alloc(pool, mag, size);
+            }
             if (pool->thread_safe) {
                 mtx_lock(&pool->pool_mutex);
             }
@@ -212,6 +802,10 @@ void* rtka_memory_alloc(rtka_allocator_t* allocator, size_t size) {
             break;
         }
 
+        case RTKA_ALLOC_SLAB:
+            /* Counted per class; rtka_get_memory_stats folds them in */
+            return slab_alloc(&allocator->impl.slab, size);
+
         default:
             break;
     }
@@ -229,20 +823,43 @@ void* rtka_memory_alloc(rtka_allocator_t* allocator, size_t size) {
     return ptr;
 }
 
+void* rtka_memory_alloc(rtka_allocator_t* allocator, size_t size) {
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_ALLOC);
+    void* ptr = memory_alloc(allocator, size);
+    RTKA_PERF_TIMER_END(timer);
+
+    RTKA_PERF_COUNT(ptr ? RTKA_PERF_ALLOCATIONS : RTKA_PERF_ALLOC_FAILURES, 1U);
+    RTKA_PERF_COUNT(RTKA_PERF_ALLOC_BYTES, ptr ? size : 0U);
+    return ptr;
+}
+
 /* Memory deallocation */
 void rtka_memory_free(rtka_allocator_t* allocator, void* ptr) {
     if (!allocator || !ptr) return;
+    RTKA_PERF_COUNT(RTKA_PERF_FREES, 1U);
+
+    if (allocator->type == RTKA_ALLOC_SLAB) {
+        slab_free(&allocator->impl.slab, ptr);
+        return;
+    }
 
     if (allocator->type == RTKA_ALLOC_POOL) {
         rtka_pool_allocator_t* pool = &allocator->impl.pool;
+        rtka_pool_block_t* block = (rtka_pool_block_t*)((uint8_t*)ptr - offsetof(rtka_pool_block_t, data));
 
 #ifdef RTKA_C11_AVAILABLE
+        if (pool->magazines_enabled) {
+            rtka_magazine_t* mag = magazine_get(allocator);
+            if (RTKA_LIKELY(mag != NULL)) {
+                magazine_free(pool, mag, block);
+                return;
+            }
+        }
         if (pool->thread_safe) {
             mtx_lock(&pool->pool_mutex);
         }
 #endif
 
-        rtka_pool_block_t* block = (rtka_pool_block_t*)((uint8_t*)ptr - offsetof(rtka_pool_block_t, data));
         block->next = pool->free_list;
         pool->free_list = block;
         pool->allocated_count--;
@@ -277,7 +894,7 @@ void rtka_memory_reset(rtka_allocator_t* allocator) {
 
 /* RTKA-specific functions */
 rtka_state_t* rtka_alloc_state_array(rtka_allocator_t* allocator, uint32_t count) {
-    if (!allocator || count == 0U || count > MAX_FACTORS) return NULL;
+    if (!allocator || count == 0U || count > RTKA_MAX_FACTORS) return NULL;
 
     size_t total_size = sizeof(rtka_state_t) * count;
     return (rtka_state_t*)rtka_memory_alloc(allocator, total_size);
@@ -348,8 +965,11 @@ rtka_error_t rtka_enable_threading(rtka_allocator_t* allocator) {
             mtx_init(&pool->pool_mutex, mtx_plain);
             atomic_init(&pool->allocated_count, pool->allocated_count);
             atomic_init(&pool->peak_usage, pool->peak_usage);
+            pool_enable_magazines(pool);
             pool->thread_safe = true;
         }
+    } else if (allocator->type == RTKA_ALLOC_SLAB && !allocator->impl.slab.thread_safe) {
+        slab_init_locks(&allocator->impl.slab);
     }
     return RTKA_SUCCESS;
 #else
@@ -357,6 +977,24 @@ rtka_error_t rtka_enable_threading(rtka_allocator_t* allocator) {
 #endif
 }
 
+void rtka_pool_flush_thread_cache(rtka_allocator_t* allocator) {
+#ifdef RTKA_C11_AVAILABLE
+    if (!allocator || allocator->type != RTKA_ALLOC_POOL) return;
+
+    rtka_pool_allocator_t* pool = &allocator->impl.pool;
+    if (!pool->magazines_enabled) return;
+
+    rtka_magazine_t* mag = tss_get(pool->magazine_key);
+    if (!mag) return;
+
+    mtx_lock(&pool->pool_mutex);
+    magazine_drain_locked(pool, mag, mag->count);
+    mtx_unlock(&pool->pool_mutex);
+#else
+    (void)allocator;
+#endif
+}
+
 /* Statistics */
 rtka_memory_stats_t rtka_get_memory_stats(const rtka_allocator_t* allocator) {
     if (!allocator) {
@@ -364,24 +1002,74 @@ rtka_memory_stats_t rtka_get_memory_stats(const rtka_allocator_t* allocator) {
         return empty;
     }
 
-    return allocator->stats;
+    rtka_memory_stats_t stats = allocator->stats;
+
+#ifdef RTKA_C11_AVAILABLE
+    if (allocator->type == RTKA_ALLOC_POOL && allocator->impl.pool.magazines_enabled) {
+        /* Fold in the per-thread counters; the registry only grows under the lock */
+        mtx_t* lock = (mtx_t*)&allocator->impl.pool.pool_mutex;
+        mtx_lock(lock);
+        for (const rtka_magazine_t* mag = allocator->impl.pool.magazines; mag; mag = mag->next) {
+            size_t bytes = atomic_load_explicit(&mag->bytes, memory_order_relaxed);
+            stats.allocation_count += (uint32_t)atomic_load_explicit(&mag->allocation_count, memory_order_relaxed);
+            stats.free_count += (uint32_t)atomic_load_explicit(&mag->free_count, memory_order_relaxed);
+            stats.total_allocated += bytes;
+            stats.current_usage += bytes;
+        }
+        mtx_unlock(lock);
+        if (stats.current_usage > stats.peak_usage) {
+            stats.peak_usage = stats.current_usage;
+        }
+    }
+#endif
+
+    if (allocator->type == RTKA_ALLOC_SLAB) {
+        size_t peak = 0U;
+        for (uint32_t i = 0U; i <= RTKA_SLAB_CLASS_COUNT; i++) {
+            rtka_slab_class_stats_t cs;
+            if (rtka_get_slab_class_stats(allocator, i, &cs) != RTKA_SUCCESS) continue;
+            stats.allocation_count += cs.allocation_count;
+            stats.free_count += cs.free_count;
+            stats.total_allocated += cs.total_bytes;
+            stats.current_usage += cs.current_bytes;
+            peak += cs.peak_bytes;  /* Classes peak independently: an upper bound */
+        }
+        stats.peak_usage = peak;
+    }
+
+    return stats;
+}
+
+rtka_error_t rtka_get_slab_class_stats(const rtka_allocator_t* allocator, uint32_t class_index,
+                                       rtka_slab_class_stats_t* stats) {
+    if (!allocator || !stats) return RTKA_ERROR_NULL_POINTER;
+    if (allocator->type != RTKA_ALLOC_SLAB) return RTKA_ERROR_NOT_SUPPORTED;
+    if (class_index > RTKA_SLAB_CLASS_COUNT) return RTKA_ERROR_INVALID_VALUE;
+
+    const rtka_slab_allocator_t* slab = &allocator->impl.slab;
+    rtka_slab_class_t* cls = &slab->classes[class_index];
+    slab_lock(slab, cls);
+    *stats = cls->stats;
+    slab_unlock(slab, cls);
+    return RTKA_SUCCESS;
 }
 
 bool rtka_check_memory_leaks(const rtka_allocator_t* allocator) {
     if (!allocator) return false;
 
-    return allocator->stats.allocation_count != allocator->stats.free_count;
+    rtka_memory_stats_t stats = rtka_get_memory_stats(allocator);
+    return stats.allocation_count != stats.free_count;
 }
 
 size_t rtka_get_total_memory_usage(void) {
     size_t total = 0U;
 
     if (g_default_state_allocator) {
-        total += g_default_state_allocator->stats.current_usage;
+        total += rtka_get_memory_stats(g_default_state_allocator).current_usage;
     }
 
     if (g_default_temp_allocator) {
-        total += g_default_temp_allocator->stats.current_usage;
+        total += rtka_get_memory_stats(g_default_temp_allocator).current_usage;
     }
 
     return total;
@@ -18,6 +18,41 @@
 #include <threads.h>
 #endif
 
+/* Arena backing for pool, stack and ring allocators. Without a config the
+ * arena comes from aligned_alloc. With one it is mmap'd: on hugetlbfs
+ * pages of the requested size when the kernel has them reserved (1 GB
+ * falls back to 2 MB), else on ordinary pages aligned to 2 MB and advised
+ * for transparent huge pages. The NUMA policy is applied before any page
+ * is touched; prefault then touches every page at creation, so first use
+ * takes no faults. Off Linux the config is ignored. */
+typedef enum {
+    RTKA_PAGES_DEFAULT,
+    RTKA_PAGES_HUGE_2M,
+    RTKA_PAGES_HUGE_1G
+} rtka_page_size_t;
+
+typedef enum {
+    RTKA_NUMA_LOCAL,                /* Kernel default: first touch */
+    RTKA_NUMA_BIND,
+    RTKA_NUMA_INTERLEAVE            /* Pages round-robin over every online node */
+} rtka_numa_policy_t;
+
+typedef struct {
+    rtka_page_size_t page_size;
+    rtka_numa_policy_t numa_policy;
+    int32_t numa_node;              /* RTKA_NUMA_BIND target; -1 for the calling thread's node */
+    bool prefault;
+} rtka_arena_config_t;
+
+/* How an allocator's arena ended up backed */
+typedef struct {
+    size_t mapped_size;             /* 0 when memory_base came from aligned_alloc */
+    size_t page_size;               /* hugetlbfs page size, else the system page */
+    int32_t node;                   /* Bound node; -1 unbound, interleaved or mbind refused */
+} rtka_arena_t;
+
+#define RTKA_NUMA_MAX_NODES 64U
+
 /* Pool allocator */
 typedef struct rtka_pool_block rtka_pool_block_t;
 struct rtka_pool_block {
@@ -25,8 +60,16 @@ struct rtka_pool_block {
     uint8_t data[];
 };
 
+/* Thread-local magazines (thread-safe pools): alloc/free hit a per-thread
+ * block cache and only take pool_mutex to move RTKA_MAGAZINE_BATCH blocks */
+#define RTKA_MAGAZINE_SIZE 64U
+#define RTKA_MAGAZINE_BATCH 32U
+
+typedef struct rtka_magazine rtka_magazine_t;
+
 typedef struct {
     void* memory_base;
+    rtka_arena_t arena;
     size_t total_size;
     size_t block_size;
     size_t block_count;
@@ -36,6 +79,9 @@ typedef struct {
     atomic_uint_fast32_t allocated_count;
     atomic_uint_fast32_t peak_usage;
     mtx_t pool_mutex;
+    tss_t magazine_key;
+    rtka_magazine_t* magazines;     /* Every thread's cache, for stats and teardown */
+    bool magazines_enabled;
     #else
     uint32_t allocated_count;
     uint32_t peak_usage;
@@ -48,6 +94,7 @@ typedef struct {
 /* Stack allocator */
 typedef struct {
     void* memory_base;
+    rtka_arena_t arena;
     size_t total_size;
     size_t current_offset;
     size_t alignment;
@@ -57,6 +104,7 @@ typedef struct {
 /* Ring buffer allocator */
 typedef struct {
     void* memory_base;
+    rtka_arena_t arena;
     size_t total_size;
     size_t write_offset;
     size_t read_offset;
@@ -65,6 +113,37 @@ typedef struct {
     bool full;
 } rtka_ring_allocator_t;
 
+/* Size-class slab allocator: mixed-size requests are rounded up to one of
+ * RTKA_SLAB_CLASS_COUNT classes - 64, 128, 192, then every power of two
+ * with its 1.25x, 1.5x and 1.75x steps up to RTKA_SLAB_MAX_OBJECT - and
+ * carved from RTKA_SLAB_SIZE-aligned slabs, so every object is 64-byte
+ * aligned and free finds its class by masking the pointer. Larger requests
+ * get a dedicated slab-aligned span, counted under class RTKA_SLAB_CLASS_COUNT. */
+#define RTKA_SLAB_SIZE (64U * 1024U)
+#define RTKA_SLAB_MAX_OBJECT (16U * 1024U)
+#define RTKA_SLAB_CLASS_COUNT 28U
+
+typedef struct rtka_slab rtka_slab_t;
+
+typedef struct {
+    size_t object_size;             /* 0 for the large-span class */
+    uint32_t slab_count;
+    uint32_t allocation_count;
+    uint32_t free_count;
+    uint32_t live_objects;
+    uint32_t peak_objects;
+    size_t current_bytes;           /* Class-rounded (span size for large) */
+    size_t peak_bytes;
+    size_t total_bytes;
+} rtka_slab_class_stats_t;
+
+typedef struct rtka_slab_class rtka_slab_class_t;
+
+typedef struct {
+    rtka_slab_class_t* classes;     /* RTKA_SLAB_CLASS_COUNT + 1 entries, one lock each */
+    bool thread_safe;
+} rtka_slab_allocator_t;
+
 /* Generic allocator */
 typedef struct {
     rtka_allocator_type_t type;
@@ -75,6 +154,7 @@ typedef struct {
         rtka_pool_allocator_t pool;
         rtka_stack_allocator_t stack;
         rtka_ring_allocator_t ring;
+        rtka_slab_allocator_t slab;
     } impl;
 
     rtka_memory_stats_t stats;
@@ -98,6 +178,51 @@ rtka_allocator_t* rtka_create_stack_allocator(size_t stack_size, size_t alignmen
 RTKA_NODISCARD
 rtka_allocator_t* rtka_create_ring_allocator(size_t element_size, size_t element_count);
 
+RTKA_NODISCARD
+rtka_allocator_t* rtka_create_slab_allocator(bool thread_safe);
+
+/* As above with the arena placed by config (NULL: aligned_alloc). NULL
+ * when config binds to a node that is not online. */
+RTKA_NODISCARD
+rtka_allocator_t* rtka_create_pool_allocator_with_config(size_t block_size, size_t block_count, bool thread_safe,
+                                                         const rtka_arena_config_t* config);
+
+RTKA_NODISCARD
+rtka_allocator_t* rtka_create_stack_allocator_with_config(size_t stack_size, size_t alignment,
+                                                          const rtka_arena_config_t* config);
+
+RTKA_NODISCARD
+rtka_allocator_t* rtka_create_ring_allocator_with_config(size_t element_size, size_t element_count,
+                                                         const rtka_arena_config_t* config);
+
+/* Per-node pools: one pool allocator per online node, its arena bound to
+ * that node (config's NUMA fields are overridden). Blocks must be freed
+ * to the pool that allocated them; rtka_node_allocator_owner finds it. */
+typedef struct rtka_node_allocators rtka_node_allocators_t;
+
+RTKA_NODISCARD
+rtka_node_allocators_t* rtka_create_node_pool_allocators(size_t block_size, size_t block_count, bool thread_safe,
+                                                         const rtka_arena_config_t* config);
+
+void rtka_destroy_node_allocators(rtka_node_allocators_t* nodes);
+
+/* The calling thread's node's pool */
+RTKA_NODISCARD
+rtka_allocator_t* rtka_node_allocator(const rtka_node_allocators_t* nodes);
+
+RTKA_NODISCARD
+rtka_allocator_t* rtka_node_allocator_at(const rtka_node_allocators_t* nodes, uint32_t node);
+
+RTKA_NODISCARD
+rtka_allocator_t* rtka_node_allocator_owner(const rtka_node_allocators_t* nodes, const void* ptr);
+
+/* Online nodes (1 without NUMA) and the node the calling thread runs on */
+RTKA_NODISCARD
+uint32_t rtka_numa_node_count(void);
+
+RTKA_NODISCARD
+uint32_t rtka_numa_current_node(void);
+
 void rtka_destroy_allocator(rtka_allocator_t* allocator);
 
 /* Allocation functions */
@@ -125,6 +250,19 @@ rtka_error_t rtka_set_default_allocators(rtka_allocator_t* state_allocator,
 /* Threading control */
 rtka_error_t rtka_enable_threading(rtka_allocator_t* allocator);
 
+/* Return the calling thread's cached pool blocks to the shared free list
+ * (also done automatically at thread exit) */
+void rtka_pool_flush_thread_cache(rtka_allocator_t* allocator);
+
+/* Slab size classes: index serving size (RTKA_SLAB_CLASS_COUNT above
+ * RTKA_SLAB_MAX_OBJECT) and per-class counters */
+RTKA_NODISCARD
+uint32_t rtka_slab_class_index(size_t size);
+
+RTKA_NODISCARD
+rtka_error_t rtka_get_slab_class_stats(const rtka_allocator_t* allocator, uint32_t class_index,
+                                       rtka_slab_class_stats_t* stats);
+
 /* Statistics */
 RTKA_NODISCARD
 rtka_memory_stats_t rtka_get_memory_stats(const rtka_allocator_t* allocator);
@@ -0,0 +1,302 @@
+/**
+ * File: rtka_packed.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * RTKA Packed Ternary Values Implementation
+ */
+
+#include "rtka_packed.h"
+#include "rtka_perf.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * VECTOR MANAGEMENT
+ * ============================================================================ */
+
+rtka_packed_vector_t* rtka_packed_create(uint32_t capacity) {
+    if (capacity == 0U) return NULL;
+
+    rtka_packed_vector_t* vec = calloc(1U, sizeof(rtka_packed_vector_t));
+    if (!vec) return NULL;
+
+    uint32_t words = RTKA_PACKED_WORDS(capacity);
+    size_t bytes = RTKA_ALIGN_UP(words * sizeof(rtka_packed_word_t), RTKA_CACHE_LINE_SIZE);
+
+    vec->words = aligned_alloc(RTKA_CACHE_LINE_SIZE, bytes);
+    if (!vec->words) {
+        free(vec);
+        return NULL;
+    }
+    memset(vec->words, 0, bytes);
+
+    vec->count = 0U;
+    vec->word_count = words;
+    vec->capacity = capacity;
+    return vec;
+}
+
+void rtka_packed_destroy(rtka_packed_vector_t* vec) {
+    if (!vec) return;
+    free(vec->words);
+    free(vec);
+}
+
+void rtka_packed_fill(rtka_packed_vector_t* vec, rtka_value_t value, uint32_t count) {
+    if (!vec) return;
+    if (count > vec->capacity) count = vec->capacity;
+
+    uint64_t pos = (value == RTKA_TRUE) ? ~0ULL : 0ULL;
+    uint64_t neg = (value == RTKA_FALSE) ? ~0ULL : 0ULL;
+    uint32_t words = RTKA_PACKED_WORDS(count);
+
+    for (uint32_t w = 0U; w < words; w++) {
+        uint64_t mask = rtka_packed_tail_mask(count, w);
+        vec->words[w].pos = pos & mask;
+        vec->words[w].neg = neg & mask;
+    }
+    for (uint32_t w = words; w < vec->word_count; w++) {
+        vec->words[w].pos = 0ULL;
+        vec->words[w].neg = 0ULL;
+    }
+
+    vec->count = count;
+}
+
+/* ============================================================================
+ * CONVERSIONS
+ * ============================================================================ */
+
+rtka_error_t rtka_packed_from_values(rtka_packed_vector_t* dst,
+                                     const rtka_value_t* values,
+                                     uint32_t count) {
+    if (!dst || (!values && count > 0U)) return RTKA_ERROR_NULL_POINTER;
+    if (count > dst->capacity) return RTKA_ERROR_INVALID_DIMENSION;
+
+    uint32_t words = RTKA_PACKED_WORDS(count);
+
+    for (uint32_t w = 0U; w < words; w++) {
+        uint32_t base = w * RTKA_PACKED_WORD_BITS;
+        uint32_t n = RTKA_MIN(RTKA_PACKED_WORD_BITS, count - base);
+        uint64_t pos = 0ULL;
+        uint64_t neg = 0ULL;
+
+        /* Branch-free: compiler turns this into compare + shift/or */
+        for (uint32_t i = 0U; i < n; i++) {
+            rtka_value_t v = values[base + i];
+            pos |= (uint64_t)(v == RTKA_TRUE) << i;
+            neg |= (uint64_t)(v == RTKA_FALSE) << i;
+        }
+
+        dst->words[w].pos = pos;
+        dst->words[w].neg = neg;
+    }
+    for (uint32_t w = words; w < dst->word_count; w++) {
+        dst->words[w].pos = 0ULL;
+        dst->words[w].neg = 0ULL;
+    }
+
+    dst->count = count;
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_packed_to_values(const rtka_packed_vector_t* src,
+                                   rtka_value_t* values,
+                                   uint32_t count) {
+    if (!src || (!values && count > 0U)) return RTKA_ERROR_NULL_POINTER;
+    if (count > src->count) return RTKA_ERROR_INVALID_DIMENSION;
+
+    uint32_t words = RTKA_PACKED_WORDS(count);
+
+    for (uint32_t w = 0U; w < words; w++) {
+        uint32_t base = w * RTKA_PACKED_WORD_BITS;
+        uint32_t n = RTKA_MIN(RTKA_PACKED_WORD_BITS, count - base);
+        uint64_t pos = src->words[w].pos;
+        uint64_t neg = src->words[w].neg;
+
+        for (uint32_t i = 0U; i < n; i++) {
+            values[base + i] = (rtka_value_t)((int)((pos >> i) & 1U) - (int)((neg >> i) & 1U));
+        }
+    }
+
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_packed_from_states(rtka_packed_vector_t* dst,
+                                     const rtka_state_t* states,
+                                     uint32_t count) {
+    if (!dst || (!states && count > 0U)) return RTKA_ERROR_NULL_POINTER;
+    if (count > dst->capacity) return RTKA_ERROR_INVALID_DIMENSION;
+
+    uint32_t words = RTKA_PACKED_WORDS(count);
+
+    for (uint32_t w = 0U; w < words; w++) {
+        uint32_t base = w * RTKA_PACKED_WORD_BITS;
+        uint32_t n = RTKA_MIN(RTKA_PACKED_WORD_BITS, count - base);
+        uint64_t pos = 0ULL;
+        uint64_t neg = 0ULL;
+
+        for (uint32_t i = 0U; i < n; i++) {
+            rtka_value_t v = states[base + i].value;
+            pos |= (uint64_t)(v == RTKA_TRUE) << i;
+            neg |= (uint64_t)(v == RTKA_FALSE) << i;
+        }
+
+        dst->words[w].pos = pos;
+        dst->words[w].neg = neg;
+    }
+    for (uint32_t w = words; w < dst->word_count; w++) {
+        dst->words[w].pos = 0ULL;
+        dst->words[w].neg = 0ULL;
+    }
+
+    dst->count = count;
+    return RTKA_SUCCESS;
+}
+
+rtka_error_t rtka_packed_from_vector(rtka_packed_vector_t* dst, const rtka_vector_t* src) {
+    if (!src) return RTKA_ERROR_NULL_POINTER;
+    if (src->count > RTKA_MAX_VECTOR_SIZE) return RTKA_ERROR_INVALID_DIMENSION;
+    return rtka_packed_from_values(dst, src->values, src->count);
+}
+
+rtka_error_t rtka_packed_to_vector(const rtka_packed_vector_t* src, rtka_vector_t* dst) {
+    if (!src || !dst) return RTKA_ERROR_NULL_POINTER;
+    if (src->count > RTKA_MAX_VECTOR_SIZE) return RTKA_ERROR_INVALID_DIMENSION;
+
+    rtka_error_t err = rtka_packed_to_values(src, dst->values, src->count);
+    if (err != RTKA_SUCCESS) return err;
+
+    dst->count = src->count;
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * BIT-SLICED BATCH OPERATIONS
+ * ============================================================================ */
+
+static rtka_error_t packed_check_binary(const rtka_packed_vector_t* a,
+                                        const rtka_packed_vector_t* b,
+                                        const rtka_packed_vector_t* result,
+                                        uint32_t* count) {
+    if (!a || !b || !result) return RTKA_ERROR_NULL_POINTER;
+
+    *count = RTKA_MIN(a->count, b->count);
+    if (*count > result->capacity) return RTKA_ERROR_INVALID_DIMENSION;
+    return RTKA_SUCCESS;
+}
+
+/* Clear trits past `count` in the last word (operands may differ in length) */
+static void packed_finish(rtka_packed_vector_t* result, uint32_t count) {
+    uint32_t words = RTKA_PACKED_WORDS(count);
+    if (words > 0U) {
+        uint64_t mask = rtka_packed_tail_mask(count, words - 1U);
+        result->words[words - 1U].pos &= mask;
+        result->words[words - 1U].neg &= mask;
+    }
+    result->count = count;
+}
+
+/* One loop per operation so every kernel inlines into its own loop body */
+#define RTKA_PACKED_BINARY_OP(name, kernel)                                    \
+rtka_error_t name(const rtka_packed_vector_t* a,                               \
+                  const rtka_packed_vector_t* b,                               \
+                  rtka_packed_vector_t* result) {                              \
+    uint32_t count = 0U;                                                       \
+    rtka_error_t err = packed_check_binary(a, b, result, &count);              \
+    if (err != RTKA_SUCCESS) return err;                                       \
+                                                                               \
+    const rtka_packed_word_t* wa = a->words;                                   \
+    const rtka_packed_word_t* wb = b->words;                                   \
+    rtka_packed_word_t* wr = result->words;                                    \
+    uint32_t words = RTKA_PACKED_WORDS(count);                                 \
+                                                                               \
+    for (uint32_t w = 0U; w < words; w++) {                                    \
+        wr[w] = kernel(wa[w], wb[w]);                                          \
+    }                                                                          \
+    RTKA_PERF_VECTOR(count);                                                   \
+                                                                               \
+    packed_finish(result, count);                                              \
+    return RTKA_SUCCESS;                                                       \
+}
+
+RTKA_PACKED_BINARY_OP(rtka_packed_and, rtka_packed_and_word)
+RTKA_PACKED_BINARY_OP(rtka_packed_or, rtka_packed_or_word)
+RTKA_PACKED_BINARY_OP(rtka_packed_nand, rtka_packed_nand_word)
+RTKA_PACKED_BINARY_OP(rtka_packed_nor, rtka_packed_nor_word)
+RTKA_PACKED_BINARY_OP(rtka_packed_implies, rtka_packed_implies_word)
+RTKA_PACKED_BINARY_OP(rtka_packed_equiv, rtka_packed_equiv_word)
+RTKA_PACKED_BINARY_OP(rtka_packed_xor, rtka_packed_xor_word)
+
+#undef RTKA_PACKED_BINARY_OP
+
+rtka_error_t rtka_packed_not(const rtka_packed_vector_t* a, rtka_packed_vector_t* result) {
+    if (!a || !result) return RTKA_ERROR_NULL_POINTER;
+    if (a->count > result->capacity) return RTKA_ERROR_INVALID_DIMENSION;
+
+    uint32_t words = RTKA_PACKED_WORDS(a->count);
+    for (uint32_t w = 0U; w < words; w++) {
+        result->words[w] = rtka_packed_not_word(a->words[w]);
+    }
+    RTKA_PERF_VECTOR(a->count);
+
+    result->count = a->count;
+    return RTKA_SUCCESS;
+}
+
+/* ============================================================================
+ * REDUCTIONS
+ * ============================================================================ */
+
+rtka_value_t rtka_packed_reduce_and(const rtka_packed_vector_t* vec) {
+    if (!vec || vec->count == 0U) return RTKA_TRUE;
+
+    uint32_t words = RTKA_PACKED_WORDS(vec->count);
+    bool all_true = true;
+
+    for (uint32_t w = 0U; w < words; w++) {
+        /* Early termination: any FALSE in this word decides the chain */
+        if (RTKA_UNLIKELY(vec->words[w].neg != 0ULL)) {
+            RTKA_PERF_FOLD(RTKA_MIN((w + 1U) * RTKA_PACKED_WORD_BITS, vec->count), vec->count);
+            return RTKA_FALSE;
+        }
+        all_true &= (vec->words[w].pos == rtka_packed_tail_mask(vec->count, w));
+    }
+    RTKA_PERF_FOLD(vec->count, vec->count);
+
+    return all_true ? RTKA_TRUE : RTKA_UNKNOWN;
+}
+
+rtka_value_t rtka_packed_reduce_or(const rtka_packed_vector_t* vec) {
+    if (!vec || vec->count == 0U) return RTKA_FALSE;
+
+    uint32_t words = RTKA_PACKED_WORDS(vec->count);
+    bool all_false = true;
+
+    for (uint32_t w = 0U; w < words; w++) {
+        /* Early termination: any TRUE in this word decides the chain */
+        if (RTKA_UNLIKELY(vec->words[w].pos != 0ULL)) {
+            RTKA_PERF_FOLD(RTKA_MIN((w + 1U) * RTKA_PACKED_WORD_BITS, vec->count), vec->count);
+            return RTKA_TRUE;
+        }
+        all_false &= (vec->words[w].neg == rtka_packed_tail_mask(vec->count, w));
+    }
+    RTKA_PERF_FOLD(vec->count, vec->count);
+
+    return all_false ? RTKA_FALSE : RTKA_UNKNOWN;
+}
+
+rtka_packed_counts_t rtka_packed_count(const rtka_packed_vector_t* vec) {
+    rtka_packed_counts_t counts = {0U, 0U, 0U};
+    if (!vec) return counts;
+
+    uint32_t words = RTKA_PACKED_WORDS(vec->count);
+    for (uint32_t w = 0U; w < words; w++) {
+        counts.true_count += (uint32_t)__builtin_popcountll(vec->words[w].pos);
+        counts.false_count += (uint32_t)__builtin_popcountll(vec->words[w].neg);
+    }
+
+    counts.unknown_count = vec->count - counts.true_count - counts.false_count;
+    return counts;
+}
@@ -0,0 +1,285 @@
+/**
+ * File: rtka_packed.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * RTKA Packed Ternary Values - Bit-Sliced Encoding
+ *
+ * CHANGELOG:
+ *
+ * v1.0.0 - Initial packed representation
+ *   - Two bit-planes per 64 trits (pos = TRUE, neg = FALSE)
+ *   - Bit-sliced AND/OR/NOT/NAND/NOR/IMPLIES/EQUIV/XOR on whole words
+ *   - Pack/unpack against rtka_value_t, rtka_state_t and rtka_vector_t
+ *   - Word-at-a-time short-circuit reductions
+ *
+ * Encoding per trit i of a word:
+ *   pos bit | neg bit | value
+ *   --------+---------+---------
+ *      1    |    0    | TRUE
+ *      0    |    1    | FALSE
+ *      0    |    0    | UNKNOWN
+ *      1    |    1    | invalid (never produced by the kernels)
+ *
+ * 64 trits occupy 16 bytes instead of 256 bytes as an rtka_value_t array
+ * (int-sized enum) or 512 bytes as an rtka_state_t array, so the value
+ * plane streams through cache 16x denser than the enum array and 32x
+ * denser than the states.
+ * Confidence is not represented here; pair a packed vector with a float
+ * plane when confidence propagation is required.
+ */
+
+#ifndef RTKA_PACKED_H
+#define RTKA_PACKED_H
+
+#include "rtka_types.h"
+#include "rtka_core.h"
+
+#define RTKA_PACKED_WORD_BITS 64U
+
+/* Number of words needed to hold n trits */
+#define RTKA_PACKED_WORDS(n) (((n) + RTKA_PACKED_WORD_BITS - 1U) / RTKA_PACKED_WORD_BITS)
+
+/* 64 trits in two bit-planes */
+typedef struct {
+    uint64_t pos;   /* bit set: trit is TRUE */
+    uint64_t neg;   /* bit set: trit is FALSE */
+} rtka_packed_word_t;
+
+/* Packed ternary vector */
+typedef struct {
+    rtka_packed_word_t* words;
+    uint32_t count;         /* Number of trits */
+    uint32_t word_count;    /* RTKA_PACKED_WORDS(capacity) */
+    uint32_t capacity;      /* Maximum trits */
+    uint32_t reserved;
+} rtka_packed_vector_t;
+
+/* ============================================================================
+ * WORD KERNELS
+ * Each operation evaluates 64 strong Kleene operations at once
+ * ============================================================================ */
+
+/**
+ * Conjunction: FALSE dominates, TRUE only when both TRUE
+ */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_and_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = { a.pos & b.pos, a.neg | b.neg };
+    return r;
+}
+
+/**
+ * Disjunction: TRUE dominates, FALSE only when both FALSE
+ */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_or_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = { a.pos | b.pos, a.neg & b.neg };
+    return r;
+}
+
+/**
+ * Negation: swap planes, UNKNOWN maps to itself
+ */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_not_word(rtka_packed_word_t a) {
+    rtka_packed_word_t r = { a.neg, a.pos };
+    return r;
+}
+
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_nand_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = { a.neg | b.neg, a.pos & b.pos };
+    return r;
+}
+
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_nor_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = { a.neg & b.neg, a.pos | b.pos };
+    return r;
+}
+
+/**
+ * Implication: ¬a ∨ b
+ */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_implies_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = { a.neg | b.pos, a.pos & b.neg };
+    return r;
+}
+
+/**
+ * Equivalence: UNKNOWN if either operand UNKNOWN, else TRUE when equal
+ */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_equiv_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = {
+        (a.pos & b.pos) | (a.neg & b.neg),
+        (a.pos & b.neg) | (a.neg & b.pos)
+    };
+    return r;
+}
+
+/**
+ * XOR: UNKNOWN if either operand UNKNOWN, else TRUE when different
+ */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_packed_word_t rtka_packed_xor_word(rtka_packed_word_t a, rtka_packed_word_t b) {
+    rtka_packed_word_t r = {
+        (a.pos & b.neg) | (a.neg & b.pos),
+        (a.pos & b.pos) | (a.neg & b.neg)
+    };
+    return r;
+}
+
+/* Mask of valid trit positions in word `index` of a vector holding `count` trits */
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+uint64_t rtka_packed_tail_mask(uint32_t count, uint32_t index) {
+    uint32_t first = index * RTKA_PACKED_WORD_BITS;
+    if (count >= first + RTKA_PACKED_WORD_BITS) return ~0ULL;
+    if (count <= first) return 0ULL;
+    return (1ULL << (count - first)) - 1ULL;
+}
+
+/* ============================================================================
+ * ELEMENT ACCESS
+ * ============================================================================ */
+
+RTKA_NODISCARD RTKA_PURE RTKA_INLINE
+rtka_value_t rtka_packed_get(const rtka_packed_vector_t* vec, uint32_t index) {
+    const rtka_packed_word_t* w = &vec->words[index / RTKA_PACKED_WORD_BITS];
+    uint32_t bit = index % RTKA_PACKED_WORD_BITS;
+    return (rtka_value_t)((int)((w->pos >> bit) & 1U) - (int)((w->neg >> bit) & 1U));
+}
+
+RTKA_INLINE
+void rtka_packed_set(rtka_packed_vector_t* vec, uint32_t index, rtka_value_t value) {
+    rtka_packed_word_t* w = &vec->words[index / RTKA_PACKED_WORD_BITS];
+    uint64_t bit = 1ULL << (index % RTKA_PACKED_WORD_BITS);
+    w->pos = (value == RTKA_TRUE) ? (w->pos | bit) : (w->pos & ~bit);
+    w->neg = (value == RTKA_FALSE) ? (w->neg | bit) : (w->neg & ~bit);
+}
+
+/* ============================================================================
+ * VECTOR MANAGEMENT
+ * ============================================================================ */
+
+/**
+ * Create packed vector able to hold `capacity` trits, all UNKNOWN
+ * Word storage is cache-line aligned
+ */
+RTKA_NODISCARD
+rtka_packed_vector_t* rtka_packed_create(uint32_t capacity);
+
+void rtka_packed_destroy(rtka_packed_vector_t* vec);
+
+/**
+ * Set all trits in [0, count) to the given value
+ */
+void rtka_packed_fill(rtka_packed_vector_t* vec, rtka_value_t value, uint32_t count);
+
+/* ============================================================================
+ * CONVERSIONS
+ * ============================================================================ */
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_from_values(rtka_packed_vector_t* dst,
+                                     const rtka_value_t* values,
+                                     uint32_t count);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_to_values(const rtka_packed_vector_t* src,
+                                   rtka_value_t* values,
+                                   uint32_t count);
+
+/* Value plane of an AoS state array; confidences are ignored */
+RTKA_NODISCARD
+rtka_error_t rtka_packed_from_states(rtka_packed_vector_t* dst,
+                                     const rtka_state_t* states,
+                                     uint32_t count);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_from_vector(rtka_packed_vector_t* dst, const rtka_vector_t* src);
+
+/**
+ * Unpack into rtka_vector_t value plane
+ * Confidences of dst are left untouched
+ */
+RTKA_NODISCARD
+rtka_error_t rtka_packed_to_vector(const rtka_packed_vector_t* src, rtka_vector_t* dst);
+
+/* ============================================================================
+ * BIT-SLICED BATCH OPERATIONS
+ * result may alias a or b; result->count = min(a->count, b->count)
+ * ============================================================================ */
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_and(const rtka_packed_vector_t* a,
+                             const rtka_packed_vector_t* b,
+                             rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_or(const rtka_packed_vector_t* a,
+                            const rtka_packed_vector_t* b,
+                            rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_not(const rtka_packed_vector_t* a, rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_nand(const rtka_packed_vector_t* a,
+                              const rtka_packed_vector_t* b,
+                              rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_nor(const rtka_packed_vector_t* a,
+                             const rtka_packed_vector_t* b,
+                             rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_implies(const rtka_packed_vector_t* a,
+                                 const rtka_packed_vector_t* b,
+                                 rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_equiv(const rtka_packed_vector_t* a,
+                               const rtka_packed_vector_t* b,
+                               rtka_packed_vector_t* result);
+
+RTKA_NODISCARD
+rtka_error_t rtka_packed_xor(const rtka_packed_vector_t* a,
+                             const rtka_packed_vector_t* b,
+                             rtka_packed_vector_t* result);
+
+/* ============================================================================
+ * REDUCTIONS
+ * Early termination tested once per 64 trits
+ * ============================================================================ */
+
+/**
+ * AND over all trits: FALSE as soon as any word carries a neg bit
+ * Empty vector yields TRUE (identity)
+ */
+RTKA_NODISCARD
+rtka_value_t rtka_packed_reduce_and(const rtka_packed_vector_t* vec);
+
+/**
+ * OR over all trits: TRUE as soon as any word carries a pos bit
+ * Empty vector yields FALSE (identity)
+ */
+RTKA_NODISCARD
+rtka_value_t rtka_packed_reduce_or(const rtka_packed_vector_t* vec);
+
+typedef struct {
+    uint32_t true_count;
+    uint32_t false_count;
+    uint32_t unknown_count;
+} rtka_packed_counts_t;
+
+/**
+ * Count TRUE/FALSE/UNKNOWN by popcount over the planes
+ */
+RTKA_NODISCARD
+rtka_packed_counts_t rtka_packed_count(const rtka_packed_vector_t* vec);
+
+#endif /* RTKA_PACKED_H */
@@ -0,0 +1,219 @@
+/**
+ * File: rtka_perf.h
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * RTKA Hot-Path Instrumentation
+ *
+ * CHANGELOG:
+ *
+ * v1.0.0 - Initial instrumentation layer
+ *   - Compile-time switch: define RTKA_PERF_ENABLED to collect; otherwise
+ *     every RTKA_PERF_* macro expands to nothing
+ *   - Per-thread counter slots, single writer, summed on read
+ *   - Cycle-counter scoped timers (rdtsc / cntvct_el0), calibrated to ns
+ *     against CLOCK_MONOTONIC when a snapshot is taken
+ *   - Snapshot and Prometheus text export
+ *
+ * A thread's first event attaches it to a slot; the slot returns to the
+ * registry at thread exit and is adopted by the next new thread, so counts
+ * outlive their threads and the registry stays bounded by peak thread
+ * count. Writes are a relaxed load/store pair on the thread's own cache
+ * line, never a locked RMW. Reset records a baseline instead of clearing
+ * slots another thread is writing.
+ *
+ *   RTKA_PERF_TIMER_BEGIN(t, RTKA_PERF_TIMER_VECTOR);
+ *   ... work ...
+ *   RTKA_PERF_TIMER_END(t);
+ *   RTKA_PERF_COUNT(RTKA_PERF_VECTOR_OPS, 1);
+ *
+ * With GCC/Clang, RTKA_PERF_SCOPE(timer) times until the end of the block.
+ */
+
+#ifndef RTKA_PERF_H
+#define RTKA_PERF_H
+
+#include "rtka_types.h"
+
+typedef enum {
+    RTKA_PERF_OPERATIONS,           /* Ternary combinations evaluated */
+    RTKA_PERF_CACHE_HITS,           /* Allocations served by a thread magazine */
+    RTKA_PERF_CACHE_MISSES,         /* Magazine refills from the shared pool */
+    RTKA_PERF_EARLY_TERMINATIONS,   /* Folds stopped by an absorbing element */
+    RTKA_PERF_RECURSIVE_EVALS,
+    RTKA_PERF_VECTOR_OPS,
+    RTKA_PERF_VECTOR_ELEMENTS,
+    RTKA_PERF_ALLOCATIONS,
+    RTKA_PERF_ALLOC_FAILURES,
+    RTKA_PERF_ALLOC_BYTES,
+    RTKA_PERF_FREES,
+    RTKA_PERF_COUNTER_COUNT
+} rtka_perf_counter_t;
+
+typedef enum {
+    RTKA_PERF_TIMER_RECURSIVE,
+    RTKA_PERF_TIMER_VECTOR,
+    RTKA_PERF_TIMER_ALLOC,
+    RTKA_PERF_TIMER_COUNT
+} rtka_perf_timer_t;
+
+/* Totals over every thread since start or the last rtka_perf_reset */
+typedef struct {
+    uint64_t counters[RTKA_PERF_COUNTER_COUNT];
+    uint64_t timer_calls[RTKA_PERF_TIMER_COUNT];
+    uint64_t timer_ticks[RTKA_PERF_TIMER_COUNT];
+    uint64_t timer_ns[RTKA_PERF_TIMER_COUNT];
+    uint32_t recursion_depth_max;   /* Longest fold, in states consumed */
+    uint32_t threads;               /* Slots in the registry */
+    double ns_per_tick;
+    bool enabled;                   /* Built with RTKA_PERF_ENABLED */
+} rtka_perf_snapshot_t;
+
+/* Declared either way; without RTKA_PERF_ENABLED they report zeros */
+void rtka_perf_snapshot(rtka_perf_snapshot_t* snapshot);
+void rtka_perf_reset(void);
+
+/* Prometheus text exposition of a snapshot. Returns the length of the full
+ * text, as snprintf does; output is truncated when it exceeds size. */
+size_t rtka_perf_export(char* buffer, size_t size);
+
+const char* rtka_perf_counter_name(rtka_perf_counter_t counter);
+const char* rtka_perf_timer_name(rtka_perf_timer_t timer);
+
+#ifdef RTKA_PERF_ENABLED
+
+#ifndef RTKA_C11_AVAILABLE
+#error "RTKA_PERF_ENABLED requires C11 atomics and threads"
+#endif
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef struct rtka_perf_slot rtka_perf_slot_t;
+struct rtka_perf_slot {
+    atomic_uint_fast64_t counters[RTKA_PERF_COUNTER_COUNT];
+    atomic_uint_fast64_t timer_calls[RTKA_PERF_TIMER_COUNT];
+    atomic_uint_fast64_t timer_ticks[RTKA_PERF_TIMER_COUNT];
+    atomic_uint_fast32_t depth_max;
+    atomic_uint_fast32_t depth_generation;  /* Reset generation depth_max belongs to */
+    atomic_bool attached;
+    rtka_perf_slot_t* next;
+} RTKA_ALIGNED(RTKA_CACHE_LINE_SIZE);
+
+extern _Thread_local rtka_perf_slot_t* rtka_perf_tls_slot;
+extern atomic_uint_fast32_t rtka_perf_generation;
+
+/* Slow path of the first event on a thread; NULL if no slot could be had */
+rtka_perf_slot_t* rtka_perf_attach(void);
+
+static RTKA_INLINE rtka_perf_slot_t* rtka_perf_slot(void) {
+    rtka_perf_slot_t* slot = rtka_perf_tls_slot;
+    return RTKA_LIKELY(slot != NULL) ? slot : rtka_perf_attach();
+}
+
+/* Single writer: a plain load/store pair avoids a locked RMW */
+static RTKA_INLINE void rtka_perf_add(atomic_uint_fast64_t* counter, uint64_t n) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+static RTKA_INLINE uint64_t rtka_perf_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static RTKA_INLINE void rtka_perf_count(rtka_perf_counter_t counter, uint64_t n) {
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_LIKELY(slot != NULL)) rtka_perf_add(&slot->counters[counter], n);
+}
+
+static RTKA_INLINE void rtka_perf_depth(uint32_t depth) {
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_UNLIKELY(slot == NULL)) return;
+    uint_fast32_t generation = atomic_load_explicit(&rtka_perf_generation, memory_order_relaxed);
+    if (RTKA_UNLIKELY(atomic_load_explicit(&slot->depth_generation, memory_order_relaxed) != generation)) {
+        atomic_store_explicit(&slot->depth_max, depth, memory_order_relaxed);
+        atomic_store_explicit(&slot->depth_generation, generation, memory_order_relaxed);
+    } else if (depth > atomic_load_explicit(&slot->depth_max, memory_order_relaxed)) {
+        atomic_store_explicit(&slot->depth_max, depth, memory_order_relaxed);
+    }
+}
+
+/* One fold of `count` states that stopped after `consumed` */
+static RTKA_INLINE void rtka_perf_fold(uint32_t consumed, uint32_t count) {
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_UNLIKELY(slot == NULL)) return;
+    rtka_perf_add(&slot->counters[RTKA_PERF_RECURSIVE_EVALS], 1U);
+    rtka_perf_add(&slot->counters[RTKA_PERF_OPERATIONS], consumed > 0U ? consumed - 1U : 0U);
+    if (consumed < count) rtka_perf_add(&slot->counters[RTKA_PERF_EARLY_TERMINATIONS], 1U);
+    rtka_perf_depth(consumed);
+}
+
+/* One batch operation over `count` elements */
+static RTKA_INLINE void rtka_perf_vector(uint32_t count) {
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_UNLIKELY(slot == NULL)) return;
+    rtka_perf_add(&slot->counters[RTKA_PERF_VECTOR_OPS], 1U);
+    rtka_perf_add(&slot->counters[RTKA_PERF_VECTOR_ELEMENTS], count);
+    rtka_perf_add(&slot->counters[RTKA_PERF_OPERATIONS], count);
+}
+
+typedef struct {
+    rtka_perf_timer_t timer;
+    uint64_t start;
+} rtka_perf_scope_t;
+
+static RTKA_INLINE rtka_perf_scope_t rtka_perf_scope_begin(rtka_perf_timer_t timer) {
+    return (rtka_perf_scope_t){ .timer = timer, .start = rtka_perf_ticks() };
+}
+
+static RTKA_INLINE void rtka_perf_scope_end(const rtka_perf_scope_t* scope) {
+    uint64_t elapsed = rtka_perf_ticks() - scope->start;
+    rtka_perf_slot_t* slot = rtka_perf_slot();
+    if (RTKA_UNLIKELY(slot == NULL)) return;
+    rtka_perf_add(&slot->timer_ticks[scope->timer], elapsed);
+    rtka_perf_add(&slot->timer_calls[scope->timer], 1U);
+}
+
+#define RTKA_PERF_COUNT(counter, n) rtka_perf_count((counter), (uint64_t)(n))
+#define RTKA_PERF_DEPTH(depth) rtka_perf_depth((uint32_t)(depth))
+#define RTKA_PERF_FOLD(consumed, count) rtka_perf_fold((uint32_t)(consumed), (uint32_t)(count))
+#define RTKA_PERF_VECTOR(count) rtka_perf_vector((uint32_t)(count))
+#define RTKA_PERF_TIMER_BEGIN(name, timer) const rtka_perf_scope_t name = rtka_perf_scope_begin(timer)
+#define RTKA_PERF_TIMER_END(name) rtka_perf_scope_end(&(name))
+
+#ifdef __GNUC__
+#define RTKA_PERF_JOIN_(a, b) a##b
+#define RTKA_PERF_JOIN(a, b) RTKA_PERF_JOIN_(a, b)
+#define RTKA_PERF_SCOPE(timer)                                                  \
+    const rtka_perf_scope_t RTKA_PERF_JOIN(rtka_perf_scope_, __LINE__)          \
+    __attribute__((cleanup(rtka_perf_scope_end))) = rtka_perf_scope_begin(timer)
+#endif
+
+#else /* !RTKA_PERF_ENABLED */
+
+#define RTKA_PERF_COUNT(counter, n) ((void)0)
+#define RTKA_PERF_DEPTH(depth) ((void)0)
+#define RTKA_PERF_FOLD(consumed, count) ((void)0)
+#define RTKA_PERF_VECTOR(count) ((void)0)
+#define RTKA_PERF_TIMER_BEGIN(name, timer) ((void)0)
+#define RTKA_PERF_TIMER_END(name) ((void)0)
+
+#endif /* RTKA_PERF_ENABLED */
+
+#ifndef RTKA_PERF_SCOPE
+#define RTKA_PERF_SCOPE(timer) ((void)0)
+#endif
+
+#endif /* RTKA_PERF_H */
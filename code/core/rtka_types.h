@@ -166,7 +166,8 @@ typedef enum {
     RTKA_ALLOC_SYSTEM,
     RTKA_ALLOC_POOL,
     RTKA_ALLOC_STACK,
-    RTKA_ALLOC_RING
+    RTKA_ALLOC_RING,
+    RTKA_ALLOC_SLAB
 } rtka_allocator_type_t;
 
 /* Memory statistics */
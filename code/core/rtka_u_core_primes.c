@@ -13,42 +13,186 @@
  */
 
 #include "rtka_u_core_primes.h"
+#include "rtka_perf.h"
 #include <math.h>
 
-/* Recursive AND with early termination */
-rtka_state_t rtka_recursive_and_seq(const rtka_state_t* states, uint32_t count) {
-    if (count == 0) return rtka_make_state(RTKA_TRUE, 1.0f);
-    if (count == 1) return states[0];
+/* ============================================================================
+ * SEQUENCE REDUCTIONS
+ *
+ * Blocked form of the left fold. Each block of RTKA_SEQ_BLOCK states is first
+ * scanned for its minimum value (vectorizable, no early branch); only a block
+ * holding the absorbing element drops to the exact element-wise fold, so the
+ * result — including where confidence stops accumulating — matches the
+ * one-state-at-a-time loop. Confidences multiply into RTKA_SEQ_LANES
+ * independent accumulators that are combined as a tree at the end.
+ *
+ * OR is evaluated as AND over negated values: the absorbing TRUE becomes
+ * FALSE, and a + b - ab becomes the product of complements 1 - c.
+ * ============================================================================ */
 
-    rtka_value_t result_value = states[0].value;
-    rtka_confidence_t result_conf = states[0].confidence;
+#define RTKA_SEQ_BLOCK 64U
+#define RTKA_SEQ_LANES 8U
+#define RTKA_SEQ_LN2 0.69314718055994530942
 
-    for (uint32_t i = 1; i < count; i++) {
-        if (result_value == RTKA_FALSE) break;  /* Early termination */
+/* Sign applied to values: +1 for AND, -1 for OR (mapped onto AND) */
+static RTKA_INLINE float seq_conf_term(float c, int32_t sign) {
+    return (sign > 0) ? c : 1.0f - c;
+}
 
-        result_value = rtka_and(result_value, states[i].value);
-        result_conf = rtka_conf_and(result_conf, states[i].confidence);
+static RTKA_INLINE int32_t seq_block_min(const rtka_state_t* states, int32_t sign) {
+    int32_t block_min = RTKA_TRUE;
+    for (uint32_t j = 0; j < RTKA_SEQ_BLOCK; j++) {
+        int32_t v = sign * (int32_t)states[j].value;
+        block_min = v < block_min ? v : block_min;
     }
+    return block_min;
+}
 
-    return rtka_make_state(result_value, result_conf);
+/* Exact element-wise fold from `start`; stops after the absorbing element */
+static RTKA_INLINE uint32_t seq_fold_tail(const rtka_state_t* states, uint32_t start, uint32_t count,
+                                          int32_t sign, int32_t* value) {
+    uint32_t i = start;
+    for (; i < count; i++) {
+        int32_t v = sign * (int32_t)states[i].value;
+        *value = v < *value ? v : *value;
+        if (RTKA_UNLIKELY(*value == RTKA_FALSE)) return i + 1U;
+    }
+    return count;
+}
+
+static RTKA_INLINE rtka_state_t seq_reduce(const rtka_state_t* states, uint32_t count, int32_t sign) {
+    float acc[RTKA_SEQ_LANES];
+    for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) acc[k] = 1.0f;
+
+    int32_t value = sign * (int32_t)states[0].value;
+    acc[0] = seq_conf_term(states[0].confidence, sign);
+
+    uint32_t i = 1;
+    if (value != RTKA_FALSE) {
+        for (; i + RTKA_SEQ_BLOCK <= count; i += RTKA_SEQ_BLOCK) {
+            int32_t block_min = seq_block_min(&states[i], sign);
+            if (RTKA_UNLIKELY(block_min == RTKA_FALSE)) break;
+
+            for (uint32_t j = 0; j < RTKA_SEQ_BLOCK; j += RTKA_SEQ_LANES) {
+                for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) {
+                    acc[k] *= seq_conf_term(states[i + j + k].confidence, sign);
+                }
+            }
+            value = block_min < value ? block_min : value;
+        }
+    } else {
+        i = count;
+    }
+
+    uint32_t end = seq_fold_tail(states, i, count, sign, &value);
+    /* An absorbing first state consumes only itself */
+    RTKA_PERF_FOLD(sign * (int32_t)states[0].value == RTKA_FALSE ? 1U : end, count);
+    for (uint32_t j = i; j < end; j++) {
+        acc[0] *= seq_conf_term(states[j].confidence, sign);
+    }
+
+    /* Tree combine: 8 -> 4 -> 2 -> 1 */
+    for (uint32_t width = RTKA_SEQ_LANES / 2U; width > 0U; width /= 2U) {
+        for (uint32_t k = 0; k < width; k++) acc[k] *= acc[k + width];
+    }
+
+    float conf = (sign > 0) ? acc[0] : 1.0f - acc[0];
+    return rtka_make_state((rtka_value_t)(sign * value), conf);
+}
+
+/*
+ * Log-space variant. Accumulators are double and renormalized with frexp
+ * after every block, so the running product keeps full precision for any
+ * chain length; the result is ln of the product.
+ */
+static RTKA_INLINE rtka_value_t seq_reduce_log(const rtka_state_t* states, uint32_t count,
+                                               int32_t sign, double* log_product) {
+    double acc[RTKA_SEQ_LANES];
+    for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) acc[k] = 1.0;
+    int64_t exponent = 0;
+
+    int32_t value = sign * (int32_t)states[0].value;
+    acc[0] = (double)seq_conf_term(states[0].confidence, sign);
+
+    uint32_t i = 1;
+    if (value != RTKA_FALSE) {
+        for (; i + RTKA_SEQ_BLOCK <= count; i += RTKA_SEQ_BLOCK) {
+            int32_t block_min = seq_block_min(&states[i], sign);
+            if (RTKA_UNLIKELY(block_min == RTKA_FALSE)) break;
+
+            for (uint32_t j = 0; j < RTKA_SEQ_BLOCK; j += RTKA_SEQ_LANES) {
+                for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) {
+                    acc[k] *= (double)seq_conf_term(states[i + j + k].confidence, sign);
+                }
+            }
+            for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) {
+                int e;
+                acc[k] = frexp(acc[k], &e);
+                exponent += e;
+            }
+            value = block_min < value ? block_min : value;
+        }
+    } else {
+        i = count;
+    }
+
+    uint32_t end = seq_fold_tail(states, i, count, sign, &value);
+    /* An absorbing first state consumes only itself */
+    RTKA_PERF_FOLD(sign * (int32_t)states[0].value == RTKA_FALSE ? 1U : end, count);
+    for (uint32_t j = i; j < end; j++) {
+        acc[0] *= (double)seq_conf_term(states[j].confidence, sign);
+    }
+
+    /* Sum of logs rather than log of product: the combined mantissas may still underflow */
+    double log_sum = (double)exponent * RTKA_SEQ_LN2;
+    for (uint32_t k = 0; k < RTKA_SEQ_LANES; k++) log_sum += log(acc[k]);
+
+    *log_product = log_sum;
+    return (rtka_value_t)(sign * value);
+}
+
+/* Recursive AND with early termination */
+rtka_state_t rtka_recursive_and_seq(const rtka_state_t* states, uint32_t count) {
+    if (count == 0) return rtka_make_state(RTKA_TRUE, 1.0f);
+    if (count == 1) return states[0];
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_RECURSIVE);
+    rtka_state_t result = seq_reduce(states, count, 1);
+    RTKA_PERF_TIMER_END(timer);
+    return result;
 }
 
 /* Recursive OR with early termination */
 rtka_state_t rtka_recursive_or_seq(const rtka_state_t* states, uint32_t count) {
     if (count == 0) return rtka_make_state(RTKA_FALSE, 1.0f);
     if (count == 1) return states[0];
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_RECURSIVE);
+    rtka_state_t result = seq_reduce(states, count, -1);
+    RTKA_PERF_TIMER_END(timer);
+    return result;
+}
 
-    rtka_value_t result_value = states[0].value;
-    rtka_confidence_t result_conf = states[0].confidence;
-
-    for (uint32_t i = 1; i < count; i++) {
-        if (result_value == RTKA_TRUE) break;  /* Early termination */
-
-        result_value = rtka_or(result_value, states[i].value);
-        result_conf = rtka_conf_or(result_conf, states[i].confidence);
+rtka_value_t rtka_recursive_and_seq_log(const rtka_state_t* states, uint32_t count,
+                                        double* log_confidence) {
+    if (count == 0) {
+        *log_confidence = 0.0;
+        return RTKA_TRUE;
     }
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_RECURSIVE);
+    rtka_value_t result = seq_reduce_log(states, count, 1, log_confidence);
+    RTKA_PERF_TIMER_END(timer);
+    return result;
+}
 
-    return rtka_make_state(result_value, result_conf);
+rtka_value_t rtka_recursive_or_seq_log(const rtka_state_t* states, uint32_t count,
+                                       double* log_complement) {
+    if (count == 0) {
+        *log_complement = -INFINITY;   /* confidence 1.0 as in rtka_recursive_or_seq */
+        return RTKA_FALSE;
+    }
+    RTKA_PERF_TIMER_BEGIN(timer, RTKA_PERF_TIMER_RECURSIVE);
+    rtka_value_t result = seq_reduce_log(states, count, -1, log_complement);
+    RTKA_PERF_TIMER_END(timer);
+    return result;
 }
 
 /* Generic recursive evaluation */
@@ -62,12 +206,14 @@ rtka_state_t rtka_recursive_eval(const rtka_state_t* states, uint32_t count,
     rtka_value_t result_value = states[0].value;
     rtka_confidence_t result_conf = states[0].confidence;
 
-    for (uint32_t i = 1; i < count; i++) {
+    uint32_t i = 1;
+    for (; i < count; i++) {
         if (result_value == absorbing_element) break;
 
         result_value = operation(result_value, states[i].value);
         result_conf = conf_prop(result_conf, states[i].confidence);
     }
+    RTKA_PERF_FOLD(i, count);
 
     return rtka_make_state(result_value, result_conf);
 }
@@ -146,18 +292,223 @@ rtka_state_t rtka_combine_states(const rtka_state_t* states, uint32_t count) {
     return rtka_make_state(combined_value, total_conf);
 }
 
-/* Simple primality check */
-bool rtka_is_likely_prime(uint64_t n) {
-    if (n <= 1) return false;
-    if (n <= 3) return true;
-    if (n % 2 == 0 || n % 3 == 0) return false;
+/* ============================================================================
+ * PRIMALITY
+ *
+ * Candidates first meet the odd primes below 256. Divisibility is a multiply
+ * by the divisor's inverse mod 2^64: n * inv(p) <= (2^64 - 1) / p exactly
+ * when p divides n, so the prefilter issues no division. Below 256^2 the
+ * prefilter alone is exact.
+ *
+ * Survivors go to Miller-Rabin with the seven bases that are deterministic
+ * for every n < 2^64 (three suffice below 2^32). Arithmetic is Montgomery
+ * with R = 2^64: one 64x64 -> 128 multiply and one REDC per step, again no
+ * division. Up to RTKA_PRIME_LANES candidates run in lockstep over
+ * structure-of-arrays state; the lanes' multiplies are independent, so
+ * they overlap instead of waiting on each other's latency.
+ * ============================================================================ */
+
+#define RTKA_PRIME_SMALL_LIMIT 65536ULL     /* 256^2: the prefilter is exact below this */
+#define RTKA_PRIME_LANES 4U
+
+typedef struct {
+    uint32_t prime;
+    uint64_t inverse;                       /* prime^-1 mod 2^64 */
+    uint64_t limit;                         /* (2^64 - 1) / prime */
+} prime_divisor_t;
+
+static const prime_divisor_t prime_divisors[] = {
+    {3U, 0xaaaaaaaaaaaaaaabULL, 0x5555555555555555ULL}, {5U, 0xcccccccccccccccdULL, 0x3333333333333333ULL},
+    {7U, 0x6db6db6db6db6db7ULL, 0x2492492492492492ULL}, {11U, 0x2e8ba2e8ba2e8ba3ULL, 0x1745d1745d1745d1ULL},
+    {13U, 0x4ec4ec4ec4ec4ec5ULL, 0x13b13b13b13b13b1ULL}, {17U, 0xf0f0f0f0f0f0f0f1ULL, 0x0f0f0f0f0f0f0f0fULL},
+    {19U, 0x86bca1af286bca1bULL, 0x0d79435e50d79435ULL}, {23U, 0xd37a6f4de9bd37a7ULL, 0x0b21642c8590b216ULL},
+    {29U, 0x34f72c234f72c235ULL, 0x08d3dcb08d3dcb08ULL}, {31U, 0xef7bdef7bdef7bdfULL, 0x0842108421084210ULL},
+    {37U, 0x14c1bacf914c1badULL, 0x06eb3e45306eb3e4ULL}, {41U, 0x8f9c18f9c18f9c19ULL, 0x063e7063e7063e70ULL},
+    {43U, 0x82fa0be82fa0be83ULL, 0x05f417d05f417d05ULL}, {47U, 0x51b3bea3677d46cfULL, 0x0572620ae4c415c9ULL},
+    {53U, 0x21cfb2b78c13521dULL, 0x04d4873ecade304dULL}, {59U, 0xcbeea4e1a08ad8f3ULL, 0x0456c797dd49c341ULL},
+    {61U, 0x4fbcda3ac10c9715ULL, 0x04325c53ef368eb0ULL}, {67U, 0xf0b7672a07a44c6bULL, 0x03d226357e16ece5ULL},
+    {71U, 0x193d4bb7e327a977ULL, 0x039b0ad12073615aULL}, {73U, 0x7e3f1f8fc7e3f1f9ULL, 0x0381c0e070381c0eULL},
+    {79U, 0x9b8b577e613716afULL, 0x033d91d2a2067b23ULL}, {83U, 0xa3784a062b2e43dbULL, 0x03159721ed7e7534ULL},
+    {89U, 0xf47e8fd1fa3f47e9ULL, 0x02e05c0b81702e05ULL}, {97U, 0xa3a0fd5c5f02a3a1ULL, 0x02a3a0fd5c5f02a3ULL},
+    {101U, 0x3a4c0a237c32b16dULL, 0x0288df0cac5b3f5dULL}, {103U, 0xdab7ec1dd3431b57ULL, 0x027c45979c95204fULL},
+    {107U, 0x77a04c8f8d28ac43ULL, 0x02647c69456217ecULL}, {109U, 0xa6c0964fda6c0965ULL, 0x02593f69b02593f6ULL},
+    {113U, 0x90fdbc090fdbc091ULL, 0x0243f6f0243f6f02ULL}, {127U, 0x7efdfbf7efdfbf7fULL, 0x0204081020408102ULL},
+    {131U, 0x03e88cb3c9484e2bULL, 0x01f44659e4a42715ULL}, {137U, 0xe21a291c077975b9ULL, 0x01de5d6e3f8868a4ULL},
+    {139U, 0x3aef6ca970586723ULL, 0x01d77b654b82c339ULL}, {149U, 0xdf5b0f768ce2cabdULL, 0x01b7d6c3dda338b2ULL},
+    {151U, 0x6fe4dfc9bf937f27ULL, 0x01b2036406c80d90ULL}, {157U, 0x5b4fe5e92c0685b5ULL, 0x01a16d3f97a4b01aULL},
+    {163U, 0x1f693a1c451ab30bULL, 0x01920fb49d0e228dULL}, {167U, 0x8d07aa27db35a717ULL, 0x01886e5f0abb0499ULL},
+    {173U, 0x882383b30d516325ULL, 0x017ad2208e0ecc35ULL}, {179U, 0xed6866f8d962ae7bULL, 0x016e1f76b4337c6cULL},
+    {181U, 0x3454dca410f8ed9dULL, 0x016a13cd15372904ULL}, {191U, 0x1d7ca632ee936f3fULL, 0x01571ed3c506b39aULL},
+    {193U, 0x70bf015390948f41ULL, 0x015390948f40feacULL}, {197U, 0xc96bdb9d3d137e0dULL, 0x014cab88725af6e7ULL},
+    {199U, 0x2697cc8aef46c0f7ULL, 0x0149539e3b2d066eULL}, {211U, 0xc0e8f2a76e68575bULL, 0x013698df3de07479ULL},
+    {223U, 0x687763dfdb43bb1fULL, 0x0125e22708092f11ULL}, {227U, 0x1b10ea929ba144cbULL, 0x0120b470c67c0d88ULL},
+    {229U, 0x1d10c4c0478bbcedULL, 0x011e2ef3b3fb8744ULL}, {233U, 0x63fb9aeb1fdcd759ULL, 0x0119453808ca29c0ULL},
+    {239U, 0x64afaa4f437b2e0fULL, 0x0112358e75d30336ULL}, {241U, 0xf010fef010fef011ULL, 0x010fef010fef010fULL},
+    {251U, 0x28cbfbeb9a020a33ULL, 0x0105197f7d734041ULL},
+};
+
+#define RTKA_PRIME_DIVISORS (sizeof(prime_divisors) / sizeof(prime_divisors[0]))
+
+static const uint64_t prime_bases_32[] = {2U, 7U, 61U};
+static const uint64_t prime_bases_64[] = {2U, 325U, 9375U, 28178U, 450775U, 9780504U, 1795265022U};
+
+typedef enum {
+    PRIME_COMPOSITE,
+    PRIME_PROVEN,
+    PRIME_UNDECIDED
+} prime_verdict_t;
+
+static RTKA_INLINE prime_verdict_t prime_prefilter(uint64_t n) {
+    if (n < 2U) return PRIME_COMPOSITE;
+    if (!(n & 1U)) return n == 2U ? PRIME_PROVEN : PRIME_COMPOSITE;
+    for (uint32_t i = 0; i < RTKA_PRIME_DIVISORS; i++) {
+        if (n * prime_divisors[i].inverse <= prime_divisors[i].limit) {
+            return n == prime_divisors[i].prime ? PRIME_PROVEN : PRIME_COMPOSITE;
+        }
+    }
+    return n < RTKA_PRIME_SMALL_LIMIT ? PRIME_PROVEN : PRIME_UNDECIDED;
+}
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 prime_wide_t;
+#endif
+
+/* Low half of a * b; high half through *hi */
+static RTKA_INLINE uint64_t prime_mul_wide(uint64_t a, uint64_t b, uint64_t* hi) {
+#ifdef __SIZEOF_INT128__
+    prime_wide_t p = (prime_wide_t)a * b;
+    *hi = (uint64_t)(p >> 64);
+    return (uint64_t)p;
+#else
+    uint64_t al = a & 0xFFFFFFFFU, ah = a >> 32, bl = b & 0xFFFFFFFFU, bh = b >> 32;
+    uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFU) + (hl & 0xFFFFFFFFU);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (ll & 0xFFFFFFFFU);
+#endif
+}
+
+/* a * b / R mod n for a, b < n; inverse is n^-1 mod 2^64 */
+static RTKA_INLINE uint64_t prime_mont_mul(uint64_t a, uint64_t b, uint64_t n, uint64_t inverse) {
+    uint64_t hi, lo = prime_mul_wide(a, b, &hi);
+    uint64_t mh;
+    (void)prime_mul_wide(lo * inverse, n, &mh);
+    /* The low halves cancel exactly, so (ab - mn) / R = hi - mh, in (-n, n) */
+    return hi >= mh ? hi - mh : hi - mh + n;
+}
+
+typedef struct {
+    uint64_t n[RTKA_PRIME_LANES];
+    uint64_t inverse[RTKA_PRIME_LANES];
+    uint64_t one[RTKA_PRIME_LANES];         /* R mod n */
+    uint64_t minus_one[RTKA_PRIME_LANES];   /* n - R mod n */
+    uint64_t r2[RTKA_PRIME_LANES];          /* R^2 mod n, into Montgomery form */
+    uint64_t d[RTKA_PRIME_LANES];           /* n - 1 = d * 2^s, d odd */
+    uint32_t s[RTKA_PRIME_LANES];
+    bool composite[RTKA_PRIME_LANES];
+} prime_lanes_t;
+
+static void prime_lanes_init(prime_lanes_t* lanes, uint32_t lane, uint64_t n) {
+    uint64_t inverse = n;                   /* Correct to 3 bits for odd n */
+    for (uint32_t i = 0; i < 5U; i++) inverse *= 2U - n * inverse;
+    uint64_t one = (0U - n) % n;
+    uint64_t r2 = one;
+    for (uint32_t i = 0; i < 64U; i++) r2 = r2 >= n - r2 ? r2 - (n - r2) : r2 + r2;
+    uint64_t d = n - 1U;
+    uint32_t s = 0;
+    while (!(d & 1U)) d >>= 1, s++;
+
+    lanes->n[lane] = n;
+    lanes->inverse[lane] = inverse;
+    lanes->one[lane] = one;
+    lanes->minus_one[lane] = n - one;
+    lanes->r2[lane] = r2;
+    lanes->d[lane] = d;
+    lanes->s[lane] = s;
+    lanes->composite[lane] = false;
+}
+
+/* One Miller-Rabin round per lane against `base` */
+static void prime_lanes_round(prime_lanes_t* lanes, uint32_t count, uint64_t base) {
+    uint64_t a[RTKA_PRIME_LANES], x[RTKA_PRIME_LANES], d_max = 0;
+    bool decided[RTKA_PRIME_LANES];
+    uint32_t s_max = 0;
+
+    for (uint32_t k = 0; k < count; k++) {
+        uint64_t b = base % lanes->n[k];
+        a[k] = prime_mont_mul(b, lanes->r2[k], lanes->n[k], lanes->inverse[k]);
+        x[k] = lanes->one[k];
+        /* A base that is a multiple of n says nothing */
+        decided[k] = lanes->composite[k] || b == 0U;
+        d_max |= lanes->d[k];
+        s_max = lanes->s[k] > s_max ? lanes->s[k] : s_max;
+    }
+
+    /* x = a^d, left to right; lanes with shorter d square R mod n meanwhile */
+    for (int32_t bit = 63 - __builtin_clzll(d_max); bit >= 0; bit--) {
+        for (uint32_t k = 0; k < count; k++) {
+            uint64_t sq = prime_mont_mul(x[k], x[k], lanes->n[k], lanes->inverse[k]);
+            uint64_t mul = prime_mont_mul(sq, a[k], lanes->n[k], lanes->inverse[k]);
+            x[k] = (lanes->d[k] >> bit) & 1U ? mul : sq;
+        }
+    }
 
-    uint64_t sqrt_n = (uint64_t)sqrt((double)n);
-    for (uint64_t i = 5; i <= sqrt_n; i += 6) {
-        if (n % i == 0 || n % (i + 2) == 0) return false;
+    for (uint32_t k = 0; k < count; k++) {
+        if (x[k] == lanes->one[k] || x[k] == lanes->minus_one[k]) decided[k] = true;
     }
+    for (uint32_t r = 1; r < s_max; r++) {
+        for (uint32_t k = 0; k < count; k++) {
+            if (decided[k] || r >= lanes->s[k]) continue;
+            x[k] = prime_mont_mul(x[k], x[k], lanes->n[k], lanes->inverse[k]);
+            decided[k] = x[k] == lanes->minus_one[k];
+        }
+    }
+    for (uint32_t k = 0; k < count; k++) lanes->composite[k] |= !decided[k];
+}
+
+static void prime_lanes_run(prime_lanes_t* lanes, uint32_t count) {
+    bool wide = false;
+    for (uint32_t k = 0; k < count; k++) wide |= lanes->n[k] > UINT32_MAX;
+    const uint64_t* bases = wide ? prime_bases_64 : prime_bases_32;
+    uint32_t base_count = wide ? (uint32_t)(sizeof(prime_bases_64) / sizeof(prime_bases_64[0]))
+                               : (uint32_t)(sizeof(prime_bases_32) / sizeof(prime_bases_32[0]));
+    for (uint32_t i = 0; i < base_count; i++) prime_lanes_round(lanes, count, bases[i]);
+}
 
-    return true;
+/* Deterministic for every 64-bit n */
+bool rtka_is_likely_prime(uint64_t n) {
+    prime_verdict_t verdict = prime_prefilter(n);
+    if (verdict != PRIME_UNDECIDED) return verdict == PRIME_PROVEN;
+
+    prime_lanes_t lanes;
+    prime_lanes_init(&lanes, 0, n);
+    prime_lanes_run(&lanes, 1U);
+    return !lanes.composite[0];
+}
+
+void rtka_is_likely_prime_batch(const uint64_t* candidates, uint32_t count, bool* is_prime) {
+    prime_lanes_t lanes;
+    uint32_t slot[RTKA_PRIME_LANES];
+    uint32_t filled = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        prime_verdict_t verdict = prime_prefilter(candidates[i]);
+        if (verdict != PRIME_UNDECIDED) {
+            is_prime[i] = verdict == PRIME_PROVEN;
+            continue;
+        }
+        prime_lanes_init(&lanes, filled, candidates[i]);
+        slot[filled++] = i;
+        if (filled < RTKA_PRIME_LANES) continue;
+
+        prime_lanes_run(&lanes, filled);
+        for (uint32_t k = 0; k < filled; k++) is_prime[slot[k]] = !lanes.composite[k];
+        filled = 0;
+    }
+    if (filled) {
+        prime_lanes_run(&lanes, filled);
+        for (uint32_t k = 0; k < filled; k++) is_prime[slot[k]] = !lanes.composite[k];
+    }
 }
 
 /* Validate confidence range */
@@ -16,6 +16,16 @@
  * - Pure mathematical operations, no dependencies
  * - UNKNOWN Preservation Theorem implementation
  * - Early termination optimization
+ *
+ * v1.3.2 - Blocked sequence reductions
+ * - Per-block min scan, absorbing-element check once per block
+ * - Confidence product over independent accumulators, tree-combined
+ * - Log-space variants for chains that underflow float
+ *
+ * v1.3.3 - Deterministic primality
+ * - Small-prime prefilter by multiplicative inverse, no division
+ * - Miller-Rabin in Montgomery form, exact for every 64-bit n
+ * - Batch test interleaving several candidates
  */
 
 #ifndef RTKA_U_CORE_H
@@ -70,6 +80,16 @@ RTKA_INLINE RTKA_PURE rtka_confidence_t rtka_conf_equiv(rtka_confidence_t a, rtk
 /* Recursive operations */
 rtka_state_t rtka_recursive_and_seq(const rtka_state_t* states, uint32_t count);
 rtka_state_t rtka_recursive_or_seq(const rtka_state_t* states, uint32_t count);
+
+/*
+ * Log-space sequence reductions for very long chains
+ * AND stores ln(confidence); OR stores ln(1 - confidence). Neither underflows
+ * where the float product in the functions above would reach 0 (or 1).
+ */
+rtka_value_t rtka_recursive_and_seq_log(const rtka_state_t* states, uint32_t count,
+                                        double* log_confidence);
+rtka_value_t rtka_recursive_or_seq_log(const rtka_state_t* states, uint32_t count,
+                                       double* log_complement);
 rtka_state_t rtka_recursive_eval(const rtka_state_t* states, uint32_t count,
                                  rtka_value_t (*operation)(rtka_value_t, rtka_value_t),
                                  rtka_confidence_t (*conf_prop)(rtka_confidence_t, rtka_confidence_t),
@@ -84,7 +104,10 @@ uint32_t rtka_expected_depth(uint64_t prime, uint32_t factor_count);
 rtka_confidence_t rtka_unknown_persistence_probability(uint32_t n);
 bool rtka_preserves_unknown(rtka_value_t op_result, const rtka_value_t* inputs, uint32_t count);
 rtka_state_t rtka_combine_states(const rtka_state_t* states, uint32_t count);
+
+/* Exact for every 64-bit n despite the name: deterministic Miller-Rabin */
 bool rtka_is_likely_prime(uint64_t n);
+void rtka_is_likely_prime_batch(const uint64_t* candidates, uint32_t count, bool* is_prime);
 bool rtka_valid_confidence(rtka_confidence_t c);
 
 #endif /* RTKA_U_CORE_H */
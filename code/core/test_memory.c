@@ -0,0 +1,836 @@
+/**
+ * File: test_memory.c
+ * Copyright (c) 2025 - H.Overman opsec.ee@pm.me
+ * Email: opsec.ee@pm.me
+ *
+ * RTKA Memory Module - Test Suite
+ *
+ * Includes rtka_memory.c so the checks can walk a pool's magazine
+ * registry and free list: every block is on the free list, cached in a
+ * magazine, or held by the caller, and allocated_count is everything off
+ * the free list.
+ *
+ * CHANGELOG:
+ *
+ * v1.0.0 - Thread-local magazines
+ *   - Refill, overflow drain and flush against the pool counters
+ *   - magazine_thread_exit: an exiting thread's cache returns to the free
+ *     list, its magazine detaches and blocks it handed out stay counted
+ *   - magazine_get: concurrent rounds of threads adopt the magazines of
+ *     exited ones before the registry grows
+ *   - Multi-threaded alloc / free / cross-thread free / flush harness
+ *
+ * v1.1.0 - Size-class slabs
+ *   - rtka_slab_class_index at both edges of every class, zero and past
+ *     RTKA_SLAB_MAX_OBJECT, against the class sizes allocations report
+ *   - Objects 64-byte aligned and counted in their class, slab refill,
+ *     large spans, and mixed sizes from several threads
+ *
+ * v1.2.0 - Arenas
+ *   - No config: aligned_alloc; default pages: mmap of whole pages
+ *   - Huge pages fall back 1 GB -> 2 MB -> 2 MB-aligned transparent pages
+ *     on hosts without reserved pages; prefault, interleave and bind
+ *   - Alignments past a page and binding an offline node
+ *   - Per-node pools and rtka_node_allocator_owner
+ */
+
+#include "rtka_memory.c"
+#include <stdio.h>
+
+/* ============================================================================
+ * TEST CONFIGURATION
+ * ============================================================================ */
+
+#define TEST_THREADS 4U
+#define TEST_STRESS_THREADS 8U
+#define TEST_STRESS_ITERATIONS 20000U
+#define TEST_STRESS_LIVE 48U
+#define TEST_MAILBOX_SIZE 64U
+
+/* Test result tracking */
+typedef struct {
+    size_t passed;
+    size_t failed;
+    size_t total;
+} test_results_t;
+
+static test_results_t g_test_results = {0};
+
+/* ============================================================================
+ * TEST UTILITIES
+ * ============================================================================ */
+
+/**
+ * Report test result
+ */
+static void report_test(const char* test_name, bool passed) {
+    g_test_results.total++;
+    if (passed) {
+        g_test_results.passed++;
+        printf("[PASS] %s\n", test_name);
+    } else {
+        g_test_results.failed++;
+        printf("[FAIL] %s\n", test_name);
+    }
+}
+
+/**
+ * Print test summary
+ */
+static void print_test_summary(void) {
+    printf("\n");
+    printf("========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Total:  %zu\n", g_test_results.total);
+    printf("Passed: %zu\n", g_test_results.passed);
+    printf("Failed: %zu\n", g_test_results.failed);
+    printf("Success Rate: %.1f%%\n",
+           100.0 * (double)g_test_results.passed / (double)g_test_results.total);
+    printf("========================================\n");
+}
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* Reusable barrier: the last of count arrivals releases the others */
+typedef struct {
+    mtx_t lock;
+    cnd_t released;
+    uint32_t count;
+    uint32_t arrived;
+    uint32_t generation;
+} test_gate_t;
+
+static void gate_init(test_gate_t* gate, uint32_t count) {
+    mtx_init(&gate->lock, mtx_plain);
+    cnd_init(&gate->released);
+    gate->count = count;
+    gate->arrived = 0U;
+    gate->generation = 0U;
+}
+
+static void gate_destroy(test_gate_t* gate) {
+    cnd_destroy(&gate->released);
+    mtx_destroy(&gate->lock);
+}
+
+static void gate_wait(test_gate_t* gate) {
+    mtx_lock(&gate->lock);
+    uint32_t generation = gate->generation;
+    if (++gate->arrived == gate->count) {
+        gate->arrived = 0U;
+        gate->generation++;
+        cnd_broadcast(&gate->released);
+    } else {
+        while (generation == gate->generation) cnd_wait(&gate->released, &gate->lock);
+    }
+    mtx_unlock(&gate->lock);
+}
+
+/* ============================================================================
+ * POOL INSPECTION (no other thread may use the pool meanwhile)
+ * ============================================================================ */
+
+static size_t free_list_length(const rtka_allocator_t* allocator) {
+    size_t n = 0U;
+    for (const rtka_pool_block_t* b = allocator->impl.pool.free_list; b; b = b->next) n++;
+    return n;
+}
+
+static uint32_t registry_length(const rtka_allocator_t* allocator) {
+    uint32_t n = 0U;
+    for (const rtka_magazine_t* m = allocator->impl.pool.magazines; m; m = m->next) n++;
+    return n;
+}
+
+static size_t cached_blocks(const rtka_allocator_t* allocator) {
+    size_t n = 0U;
+    for (const rtka_magazine_t* m = allocator->impl.pool.magazines; m; m = m->next) n += m->count;
+    return n;
+}
+
+static uint32_t attached_magazines(const rtka_allocator_t* allocator) {
+    uint32_t n = 0U;
+    for (const rtka_magazine_t* m = allocator->impl.pool.magazines; m; m = m->next) n += m->attached;
+    return n;
+}
+
+/**
+ * Every block is free, cached or one of the live blocks the caller holds
+ */
+static bool pool_accounted(const rtka_allocator_t* allocator, size_t live) {
+    const rtka_pool_allocator_t* pool = &allocator->impl.pool;
+    size_t free_blocks = free_list_length(allocator);
+    size_t allocated = atomic_load(&pool->allocated_count);
+    return free_blocks + cached_blocks(allocator) + live == pool->block_count &&
+           allocated == pool->block_count - free_blocks;
+}
+
+/* ============================================================================
+ * MAGAZINE TESTS
+ * ============================================================================ */
+
+/**
+ * One allocation takes a batch off the free list, a flush returns it
+ */
+static void test_magazine_refill_flush(void) {
+    rtka_allocator_t* allocator = rtka_create_pool_allocator(32U, 256U, true);
+    bool created = allocator && allocator->impl.pool.magazines_enabled;
+    report_test("Magazines: thread-safe pool enables them", created);
+    if (!created) {
+        rtka_destroy_allocator(allocator);
+        return;
+    }
+
+    void* p = rtka_memory_alloc(allocator, 32U);
+    const rtka_pool_allocator_t* pool = &allocator->impl.pool;
+    report_test("Magazines: first allocation refills one batch",
+                p && atomic_load(&pool->allocated_count) == RTKA_MAGAZINE_BATCH &&
+                cached_blocks(allocator) == RTKA_MAGAZINE_BATCH - 1U && registry_length(allocator) == 1U &&
+                pool_accounted(allocator, 1U));
+
+    rtka_memory_free(allocator, p);
+    report_test("Magazines: free caches the block", cached_blocks(allocator) == RTKA_MAGAZINE_BATCH &&
+                pool_accounted(allocator, 0U));
+
+    rtka_pool_flush_thread_cache(allocator);
+    report_test("Magazines: flush returns the cache to the free list",
+                atomic_load(&pool->allocated_count) == 0U && cached_blocks(allocator) == 0U &&
+                free_list_length(allocator) == 256U && !rtka_check_memory_leaks(allocator));
+
+    rtka_destroy_allocator(allocator);
+}
+
+/**
+ * Frees past RTKA_MAGAZINE_SIZE drain a batch; exhaustion counts every block
+ */
+static void test_magazine_overflow(void) {
+    enum { BLOCKS = 160, LIVE = 100 };
+    rtka_allocator_t* allocator = rtka_create_pool_allocator(16U, BLOCKS, true);
+    if (!allocator) {
+        report_test("Magazines: overflow pool created", false);
+        return;
+    }
+
+    void* blocks[BLOCKS];
+    bool all = true;
+    for (uint32_t i = 0U; i < LIVE; i++) all &= (blocks[i] = rtka_memory_alloc(allocator, 16U)) != NULL;
+    bool counted = all && pool_accounted(allocator, LIVE);
+    for (uint32_t i = 0U; i < LIVE; i++) rtka_memory_free(allocator, blocks[i]);
+    report_test("Magazines: overflowing frees drain in batches",
+                counted && cached_blocks(allocator) <= RTKA_MAGAZINE_SIZE && pool_accounted(allocator, 0U));
+
+    uint32_t got = 0U;
+    while (got < BLOCKS && (blocks[got] = rtka_memory_alloc(allocator, 16U)) != NULL) got++;
+    report_test("Magazines: every block reachable, then NULL",
+                got == BLOCKS && rtka_memory_alloc(allocator, 16U) == NULL &&
+                free_list_length(allocator) == 0U && pool_accounted(allocator, BLOCKS));
+
+    for (uint32_t i = 0U; i < got; i++) rtka_memory_free(allocator, blocks[i]);
+    rtka_pool_flush_thread_cache(allocator);
+    rtka_memory_stats_t stats = rtka_get_memory_stats(allocator);
+    report_test("Magazines: stats sum the magazine counters",
+                stats.allocation_count == LIVE + BLOCKS && stats.free_count == LIVE + BLOCKS &&
+                free_list_length(allocator) == BLOCKS);
+
+    rtka_destroy_allocator(allocator);
+}
+
+typedef struct {
+    rtka_allocator_t* allocator;
+    void* kept[3];
+} exit_args_t;
+
+static int exit_main(void* arg) {
+    exit_args_t* args = (exit_args_t*)arg;
+    void* blocks[10];
+    for (uint32_t i = 0U; i < 10U; i++) blocks[i] = rtka_memory_alloc(args->allocator, 32U);
+    for (uint32_t i = 0U; i < 7U; i++) rtka_memory_free(args->allocator, blocks[i]);
+    for (uint32_t i = 0U; i < 3U; i++) args->kept[i] = blocks[7U + i];
+    return 0;    /* No flush: magazine_thread_exit drains the cache */
+}
+
+/**
+ * An exiting thread's cache drains; blocks it handed out stay counted
+ */
+static void test_magazine_thread_exit(void) {
+    rtka_allocator_t* allocator = rtka_create_pool_allocator(32U, 128U, true);
+    if (!allocator) {
+        report_test("Magazines: thread exit pool created", false);
+        return;
+    }
+
+    exit_args_t args = {.allocator = allocator};
+    thrd_t thread;
+    bool ran = thrd_create(&thread, exit_main, &args) == thrd_success && thrd_join(thread, NULL) == thrd_success;
+    bool kept = ran && args.kept[0] && args.kept[1] && args.kept[2];
+    report_test("Magazines: exit drains the cache and detaches",
+                kept && registry_length(allocator) == 1U && attached_magazines(allocator) == 0U &&
+                cached_blocks(allocator) == 0U && atomic_load(&allocator->impl.pool.allocated_count) == 3U &&
+                pool_accounted(allocator, 3U));
+
+    /* Freed on this thread, into the exited thread's magazine it adopts */
+    for (uint32_t i = 0U; kept && i < 3U; i++) rtka_memory_free(allocator, args.kept[i]);
+    rtka_pool_flush_thread_cache(allocator);
+    rtka_memory_stats_t stats = rtka_get_memory_stats(allocator);
+    report_test("Magazines: cross-thread frees balance after exit",
+                kept && registry_length(allocator) == 1U && pool_accounted(allocator, 0U) &&
+                free_list_length(allocator) == 128U && stats.allocation_count == 10U &&
+                stats.free_count == 10U && !rtka_check_memory_leaks(allocator));
+
+    rtka_destroy_allocator(allocator);
+}
+
+typedef struct {
+    rtka_allocator_t* allocator;
+    test_gate_t* gate;
+    uint32_t allocations;
+    bool ok;
+} round_args_t;
+
+/* Holds a magazine until every thread of the round has one */
+static int round_main(void* arg) {
+    round_args_t* args = (round_args_t*)arg;
+    void* blocks[8];
+    args->ok = true;
+    for (uint32_t i = 0U; i < args->allocations; i++) {
+        args->ok &= (blocks[i] = rtka_memory_alloc(args->allocator, 32U)) != NULL;
+    }
+    gate_wait(args->gate);
+    for (uint32_t i = 0U; i < args->allocations; i++) rtka_memory_free(args->allocator, blocks[i]);
+    return 0;
+}
+
+static bool run_round(rtka_allocator_t* allocator, uint32_t threads, uint32_t allocations) {
+    thrd_t handles[TEST_THREADS + 2U];
+    round_args_t args[TEST_THREADS + 2U];
+    test_gate_t gate;
+    gate_init(&gate, threads);
+    bool ok = true;
+    for (uint32_t t = 0U; t < threads; t++) {
+        args[t] = (round_args_t){.allocator = allocator, .gate = &gate, .allocations = allocations};
+        ok &= thrd_create(&handles[t], round_main, &args[t]) == thrd_success;
+    }
+    for (uint32_t t = 0U; t < threads; t++) {
+        thrd_join(handles[t], NULL);
+        ok &= args[t].ok;
+    }
+    gate_destroy(&gate);
+    return ok;
+}
+
+/**
+ * magazine_get adopts detached magazines before allocating new ones
+ */
+static void test_magazine_registry_reuse(void) {
+    enum { ALLOCATIONS = 8 };
+    rtka_allocator_t* allocator = rtka_create_pool_allocator(32U, 512U, true);
+    if (!allocator) {
+        report_test("Magazines: registry pool created", false);
+        return;
+    }
+
+    bool first = run_round(allocator, TEST_THREADS, ALLOCATIONS);
+    report_test("Magazines: one magazine per concurrent thread",
+                first && registry_length(allocator) == TEST_THREADS && attached_magazines(allocator) == 0U &&
+                pool_accounted(allocator, 0U) && cached_blocks(allocator) == 0U);
+
+    bool second = run_round(allocator, TEST_THREADS, ALLOCATIONS);
+    bool adopted_once = true;
+    for (const rtka_magazine_t* m = allocator->impl.pool.magazines; m; m = m->next) {
+        adopted_once &= atomic_load(&m->allocation_count) == 2U * ALLOCATIONS;
+    }
+    report_test("Magazines: a second round adopts every exited magazine",
+                second && registry_length(allocator) == TEST_THREADS && adopted_once &&
+                pool_accounted(allocator, 0U));
+
+    bool third = run_round(allocator, TEST_THREADS + 2U, ALLOCATIONS);
+    rtka_memory_stats_t stats = rtka_get_memory_stats(allocator);
+    uint32_t expected = (3U * TEST_THREADS + 2U) * ALLOCATIONS;
+    report_test("Magazines: the registry grows only past the reused ones",
+                third && registry_length(allocator) == TEST_THREADS + 2U && attached_magazines(allocator) == 0U &&
+                stats.allocation_count == expected && stats.free_count == expected &&
+                free_list_length(allocator) == 512U);
+
+    rtka_destroy_allocator(allocator);
+}
+
+/* A block travelling to another thread with the tag written into it */
+typedef struct {
+    uint64_t* block;
+    uint64_t tag;
+} held_block_t;
+
+typedef struct {
+    mtx_t lock;
+    held_block_t blocks[TEST_MAILBOX_SIZE];
+    uint32_t count;
+} mailbox_t;
+
+typedef struct {
+    rtka_allocator_t* allocator;
+    test_gate_t* gate;
+    mailbox_t* mailboxes;
+    uint32_t index;
+    uint64_t allocations;
+    uint64_t frees;
+    bool ok;
+} stress_args_t;
+
+static void stress_free(stress_args_t* args, held_block_t held) {
+    args->ok &= *held.block == held.tag;
+    rtka_memory_free(args->allocator, held.block);
+    args->frees++;
+}
+
+static void stress_drain_mailbox(stress_args_t* args) {
+    mailbox_t* mine = &args->mailboxes[args->index];
+    held_block_t received[TEST_MAILBOX_SIZE];
+    mtx_lock(&mine->lock);
+    uint32_t count = mine->count;
+    memcpy(received, mine->blocks, count * sizeof(held_block_t));
+    mine->count = 0U;
+    mtx_unlock(&mine->lock);
+    for (uint32_t i = 0U; i < count; i++) stress_free(args, received[i]);
+}
+
+static int stress_main(void* arg) {
+    stress_args_t* args = (stress_args_t*)arg;
+    mailbox_t* next = &args->mailboxes[(args->index + 1U) % TEST_STRESS_THREADS];
+    held_block_t live[TEST_STRESS_LIVE];
+    uint32_t live_count = 0U;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL * (args->index + 1U);
+    args->ok = true;
+
+    for (uint32_t i = 0U; i < TEST_STRESS_ITERATIONS; i++) {
+        uint64_t r = next_random(&rng);
+        if (live_count < TEST_STRESS_LIVE && (r & 1U)) {
+            uint64_t* block = rtka_memory_alloc(args->allocator, 64U);
+            if (block) {
+                uint64_t tag = ((uint64_t)args->index << 32) | i;
+                *block = tag;
+                live[live_count++] = (held_block_t){block, tag};
+                args->allocations++;
+            }
+        } else if (live_count > 0U) {
+            held_block_t held = live[--live_count];
+            bool sent = false;
+            if ((r & 6U) == 0U) {
+                /* Freed by the next thread, into its magazine */
+                mtx_lock(&next->lock);
+                if (next->count < TEST_MAILBOX_SIZE) {
+                    next->blocks[next->count++] = held;
+                    sent = true;
+                }
+                mtx_unlock(&next->lock);
+            }
+            if (!sent) stress_free(args, held);
+        }
+        if ((i & 63U) == 0U) stress_drain_mailbox(args);
+        if ((r >> 32) % 1000U == 0U) rtka_pool_flush_thread_cache(args->allocator);
+    }
+
+    /* Nothing is sent after the gate */
+    gate_wait(args->gate);
+    stress_drain_mailbox(args);
+    while (live_count > 0U) stress_free(args, live[--live_count]);
+    if (args->index & 1U) rtka_pool_flush_thread_cache(args->allocator);
+    return 0;
+}
+
+/**
+ * Threads allocate, free, free each other's blocks and flush at random
+ */
+static void test_magazine_stress(void) {
+    enum { BLOCKS = 2048 };
+    rtka_allocator_t* allocator = rtka_create_pool_allocator(64U, BLOCKS, true);
+    if (!allocator) {
+        report_test("Magazines: stress pool created", false);
+        return;
+    }
+
+    mailbox_t mailboxes[TEST_STRESS_THREADS];
+    stress_args_t args[TEST_STRESS_THREADS];
+    thrd_t handles[TEST_STRESS_THREADS];
+    test_gate_t gate;
+    gate_init(&gate, TEST_STRESS_THREADS);
+    for (uint32_t t = 0U; t < TEST_STRESS_THREADS; t++) {
+        mtx_init(&mailboxes[t].lock, mtx_plain);
+        mailboxes[t].count = 0U;
+    }
+
+    bool ok = true;
+    for (uint32_t t = 0U; t < TEST_STRESS_THREADS; t++) {
+        args[t] = (stress_args_t){.allocator = allocator, .gate = &gate, .mailboxes = mailboxes, .index = t};
+        ok &= thrd_create(&handles[t], stress_main, &args[t]) == thrd_success;
+    }
+    uint64_t allocations = 0U, frees = 0U;
+    for (uint32_t t = 0U; t < TEST_STRESS_THREADS; t++) {
+        thrd_join(handles[t], NULL);
+        ok &= args[t].ok;
+        allocations += args[t].allocations;
+        frees += args[t].frees;
+    }
+
+    rtka_memory_stats_t stats = rtka_get_memory_stats(allocator);
+    printf("  %u threads: %llu allocations, %llu frees, %u magazines\n", TEST_STRESS_THREADS,
+           (unsigned long long)allocations, (unsigned long long)frees, registry_length(allocator));
+    report_test("Magazines: stress blocks never shared, every free matched",
+                ok && allocations > 0U && allocations == frees);
+    report_test("Magazines: stress leaves every block free or cached",
+                pool_accounted(allocator, 0U) && cached_blocks(allocator) == 0U &&
+                free_list_length(allocator) == BLOCKS && attached_magazines(allocator) == 0U &&
+                registry_length(allocator) == TEST_STRESS_THREADS);
+    report_test("Magazines: stress stats match the threads' counts",
+                stats.allocation_count == allocations && stats.free_count == frees &&
+                !rtka_check_memory_leaks(allocator));
+
+    for (uint32_t t = 0U; t < TEST_STRESS_THREADS; t++) mtx_destroy(&mailboxes[t].lock);
+    gate_destroy(&gate);
+    rtka_destroy_allocator(allocator);
+}
+
+/* ============================================================================
+ * SLAB TESTS
+ * ============================================================================ */
+
+/**
+ * Each class serves sizes above the previous class up to its own size
+ */
+static void test_slab_class_boundaries(void) {
+    bool sizes_ok = true, edges_ok = true;
+    size_t previous = 0U;
+    for (uint32_t i = 0U; i < RTKA_SLAB_CLASS_COUNT; i++) {
+        size_t size = slab_class_size(i);
+        /* 64, 128, 192, 256, then quarter steps of each power of two */
+        sizes_ok &= size > previous && size % RTKA_CACHE_LINE_SIZE == 0U &&
+                    (i < 4U ? size == 64U * (i + 1U) : size * 4U <= previous * 5U);
+        edges_ok &= rtka_slab_class_index(previous + 1U) == i && rtka_slab_class_index(size) == i;
+        previous = size;
+    }
+    report_test("Slab: class sizes step by 64 then by quarters", sizes_ok && slab_class_size(4U) == 320U &&
+                slab_class_size(RTKA_SLAB_CLASS_COUNT - 1U) == RTKA_SLAB_MAX_OBJECT);
+    report_test("Slab: every class edge maps to its class", edges_ok);
+    report_test("Slab: zero and oversize requests",
+                rtka_slab_class_index(0U) == 0U && rtka_slab_class_index(1U) == 0U &&
+                rtka_slab_class_index(RTKA_SLAB_MAX_OBJECT + 1U) == RTKA_SLAB_CLASS_COUNT &&
+                rtka_slab_class_index(SIZE_MAX) == RTKA_SLAB_CLASS_COUNT);
+}
+
+/**
+ * Allocations at class edges land in the class and fill it
+ */
+static void test_slab_allocations(void) {
+    rtka_allocator_t* allocator = rtka_create_slab_allocator(false);
+    if (!allocator) {
+        report_test("Slab: allocator created", false);
+        return;
+    }
+
+    bool placed = true, stats_ok = true;
+    size_t previous = 0U;
+    for (uint32_t i = 0U; i < RTKA_SLAB_CLASS_COUNT; i++) {
+        size_t size = slab_class_size(i);
+        uint8_t* low = rtka_memory_alloc(allocator, previous + 1U);
+        uint8_t* high = rtka_memory_alloc(allocator, size);
+        placed &= low && high && low != high && ((uintptr_t)low % RTKA_CACHE_LINE_SIZE) == 0U &&
+                  ((uintptr_t)high % RTKA_CACHE_LINE_SIZE) == 0U;
+        if (low && high) {
+            memset(low, 0xA5, size);
+            memset(high, 0x5A, size);
+            placed &= low[size - 1U] == 0xA5 && high[0] == 0x5A;
+        }
+
+        rtka_slab_class_stats_t cs;
+        stats_ok &= rtka_get_slab_class_stats(allocator, i, &cs) == RTKA_SUCCESS && cs.object_size == size &&
+                    cs.allocation_count == 2U && cs.live_objects == 2U && cs.current_bytes == 2U * size &&
+                    cs.slab_count == 1U;
+        rtka_memory_free(allocator, low);
+        rtka_memory_free(allocator, high);
+        stats_ok &= rtka_get_slab_class_stats(allocator, i, &cs) == RTKA_SUCCESS && cs.free_count == 2U &&
+                    cs.live_objects == 0U && cs.current_bytes == 0U;
+        previous = size;
+    }
+    report_test("Slab: edge sizes aligned, disjoint and full size", placed);
+    report_test("Slab: edge sizes counted in their class", stats_ok);
+
+    /* One object past a slab's capacity takes a second slab */
+    enum { CAPACITY = (RTKA_SLAB_SIZE - RTKA_SLAB_HEADER) / 64U };
+    void* objects[CAPACITY + 1U];
+    bool all = true;
+    for (uint32_t i = 0U; i <= CAPACITY; i++) all &= (objects[i] = rtka_memory_alloc(allocator, 64U)) != NULL;
+    rtka_slab_class_stats_t cs;
+    bool refilled = all && rtka_get_slab_class_stats(allocator, 0U, &cs) == RTKA_SUCCESS &&
+                    cs.slab_count == 2U && cs.peak_objects == CAPACITY + 1U;
+    for (uint32_t i = 0U; i <= CAPACITY; i++) rtka_memory_free(allocator, objects[i]);
+    report_test("Slab: a full slab refills with a second", refilled);
+
+    size_t large_size = RTKA_SLAB_MAX_OBJECT + 1U;
+    size_t span = RTKA_ALIGN_UP(large_size + RTKA_SLAB_HEADER, (size_t)RTKA_SLAB_SIZE);
+    uint8_t* large = rtka_memory_alloc(allocator, large_size);
+    bool large_ok = large && ((uintptr_t)large % RTKA_CACHE_LINE_SIZE) == 0U &&
+                    rtka_get_slab_class_stats(allocator, RTKA_SLAB_CLASS_COUNT, &cs) == RTKA_SUCCESS &&
+                    cs.object_size == 0U && cs.slab_count == 1U && cs.current_bytes == span;
+    if (large) memset(large, 0x3C, large_size);
+    rtka_memory_free(allocator, large);
+    large_ok &= rtka_get_slab_class_stats(allocator, RTKA_SLAB_CLASS_COUNT, &cs) == RTKA_SUCCESS &&
+                cs.slab_count == 0U && cs.live_objects == 0U && cs.current_bytes == 0U;
+    report_test("Slab: oversize requests get a dedicated span", large_ok);
+
+    report_test("Slab: class index range checked",
+                rtka_get_slab_class_stats(allocator, RTKA_SLAB_CLASS_COUNT + 1U, &cs) == RTKA_ERROR_INVALID_VALUE &&
+                !rtka_check_memory_leaks(allocator));
+
+    rtka_destroy_allocator(allocator);
+}
+
+typedef struct {
+    rtka_allocator_t* allocator;
+    uint32_t index;
+    bool ok;
+} slab_args_t;
+
+static int slab_main(void* arg) {
+    slab_args_t* args = (slab_args_t*)arg;
+    uint8_t* live[32];
+    size_t sizes[32];
+    uint64_t rng = 0xD1B54A32D192ED03ULL * (args->index + 1U);
+    args->ok = true;
+    for (uint32_t round = 0U; round < 200U; round++) {
+        for (uint32_t i = 0U; i < 32U; i++) {
+            sizes[i] = next_random(&rng) % (RTKA_SLAB_MAX_OBJECT + RTKA_SLAB_SIZE) + 1U;
+            live[i] = rtka_memory_alloc(args->allocator, sizes[i]);
+            if (live[i]) memset(live[i], (int)(args->index + i), sizes[i]);
+            args->ok &= live[i] != NULL;
+        }
+        for (uint32_t i = 0U; i < 32U; i++) {
+            if (!live[i]) continue;
+            uint8_t fill = (uint8_t)(args->index + i);
+            args->ok &= live[i][0] == fill && live[i][sizes[i] - 1U] == fill;
+            rtka_memory_free(args->allocator, live[i]);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Threads mixing every class and large spans on a thread-safe slab
+ */
+static void test_slab_threads(void) {
+    rtka_allocator_t* allocator = rtka_create_slab_allocator(true);
+    if (!allocator) {
+        report_test("Slab: thread-safe allocator created", false);
+        return;
+    }
+
+    thrd_t handles[TEST_THREADS];
+    slab_args_t args[TEST_THREADS];
+    bool ok = true;
+    for (uint32_t t = 0U; t < TEST_THREADS; t++) {
+        args[t] = (slab_args_t){.allocator = allocator, .index = t};
+        ok &= thrd_create(&handles[t], slab_main, &args[t]) == thrd_success;
+    }
+    for (uint32_t t = 0U; t < TEST_THREADS; t++) {
+        thrd_join(handles[t], NULL);
+        ok &= args[t].ok;
+    }
+
+    bool drained = true;
+    for (uint32_t i = 0U; i <= RTKA_SLAB_CLASS_COUNT; i++) {
+        rtka_slab_class_stats_t cs;
+        drained &= rtka_get_slab_class_stats(allocator, i, &cs) == RTKA_SUCCESS && cs.live_objects == 0U &&
+                   cs.current_bytes == 0U && cs.allocation_count == cs.free_count;
+    }
+    rtka_memory_stats_t stats = rtka_get_memory_stats(allocator);
+    report_test("Slab: threads keep their objects intact", ok);
+    report_test("Slab: threads leave every class empty",
+                drained && stats.allocation_count == TEST_THREADS * 200U * 32U &&
+                !rtka_check_memory_leaks(allocator));
+
+    rtka_destroy_allocator(allocator);
+}
+
+/* ============================================================================
+ * ARENA TESTS
+ * ============================================================================ */
+
+#define TEST_HUGE_2M ((size_t)2U << 20)
+#define TEST_HUGE_1G ((size_t)1U << 30)
+
+/**
+ * Round trip through a pool and confirm its arena is whole and usable
+ */
+static bool pool_usable(rtka_allocator_t* allocator) {
+    const rtka_pool_allocator_t* pool = &allocator->impl.pool;
+    void* blocks[4];
+    bool ok = true;
+    for (uint32_t i = 0U; i < 4U; i++) {
+        blocks[i] = rtka_memory_alloc(allocator, pool->block_size);
+        ok &= blocks[i] != NULL && (uint8_t*)blocks[i] >= (uint8_t*)pool->memory_base &&
+              (uint8_t*)blocks[i] + pool->block_size <= (uint8_t*)pool->memory_base + pool->total_size;
+        if (blocks[i]) memset(blocks[i], 0x77, pool->block_size);
+    }
+    for (uint32_t i = 0U; i < 4U; i++) rtka_memory_free(allocator, blocks[i]);
+    return ok;
+}
+
+/**
+ * The mapping covers the arena in whole pages of the size it reports
+ */
+static bool arena_covers(const rtka_arena_t* arena, const void* base, size_t size) {
+    return arena->mapped_size >= size && arena->page_size > 0U && arena->mapped_size % arena->page_size == 0U &&
+           (uintptr_t)base % arena->page_size == 0U;
+}
+
+static void test_arena_default(void) {
+    size_t page = arena_system_page();
+    rtka_allocator_t* plain = rtka_create_pool_allocator(64U, 100U, false);
+    report_test("Arena: no config comes from aligned_alloc",
+                plain && plain->impl.pool.arena.mapped_size == 0U && plain->impl.pool.arena.page_size == 0U &&
+                plain->impl.pool.arena.node == -1 && pool_usable(plain));
+    rtka_destroy_allocator(plain);
+
+    rtka_arena_config_t config = {.page_size = RTKA_PAGES_DEFAULT, .numa_policy = RTKA_NUMA_LOCAL};
+    rtka_allocator_t* mapped = rtka_create_pool_allocator_with_config(64U, 100U, false, &config);
+    const rtka_arena_t* arena = mapped ? &mapped->impl.pool.arena : NULL;
+    report_test("Arena: default pages map whole system pages",
+                arena && arena->page_size == page && arena_covers(arena, mapped->impl.pool.memory_base,
+                                                                  mapped->impl.pool.total_size) &&
+                arena->mapped_size < mapped->impl.pool.total_size + page && arena->node == -1 &&
+                pool_usable(mapped));
+    rtka_destroy_allocator(mapped);
+}
+
+/**
+ * Huge pages where reserved, else the next size down, else transparent
+ */
+static void test_arena_huge_fallback(void) {
+    size_t page = arena_system_page();
+    rtka_arena_config_t config = {.page_size = RTKA_PAGES_HUGE_2M, .numa_policy = RTKA_NUMA_LOCAL};
+    rtka_allocator_t* huge = rtka_create_pool_allocator_with_config(64U, 1000U, true, &config);
+    const rtka_arena_t* arena = huge ? &huge->impl.pool.arena : NULL;
+    /* Hugetlbfs or transparent, both come 2 MB aligned in 2 MB multiples */
+    bool huge_ok = arena && (arena->page_size == TEST_HUGE_2M || arena->page_size == page) &&
+                   arena_covers(arena, huge->impl.pool.memory_base, huge->impl.pool.total_size) &&
+                   arena->mapped_size % TEST_HUGE_2M == 0U &&
+                   (uintptr_t)huge->impl.pool.memory_base % TEST_HUGE_2M == 0U;
+    printf("  2 MB request: %s pages\n", arena && arena->page_size == TEST_HUGE_2M ? "hugetlbfs" : "transparent");
+    report_test("Arena: 2 MB pages, or 2 MB-aligned transparent pages", huge_ok && pool_usable(huge));
+    rtka_destroy_allocator(huge);
+
+    config.page_size = RTKA_PAGES_HUGE_1G;
+    rtka_allocator_t* gigantic = rtka_create_stack_allocator_with_config(3U << 20, 64U, &config);
+    arena = gigantic ? &gigantic->impl.stack.arena : NULL;
+    bool gigantic_ok = arena &&
+                       (arena->page_size == TEST_HUGE_1G || arena->page_size == TEST_HUGE_2M ||
+                        arena->page_size == page) &&
+                       arena_covers(arena, gigantic->impl.stack.memory_base, 3U << 20) &&
+                       arena->mapped_size % TEST_HUGE_2M == 0U;
+    uint8_t* top = gigantic ? rtka_memory_alloc(gigantic, 3U << 20) : NULL;
+    if (top) memset(top, 0x11, 3U << 20);
+    printf("  1 GB request: %zu KB pages\n", arena ? arena->page_size >> 10 : 0U);
+    report_test("Arena: 1 GB pages fall back to a smaller size", gigantic_ok && top != NULL);
+    rtka_destroy_allocator(gigantic);
+
+    /* Prefault touches every page; anonymous pages read back zero */
+    config.page_size = RTKA_PAGES_HUGE_2M;
+    config.prefault = true;
+    rtka_allocator_t* ring = rtka_create_ring_allocator_with_config(256U, 4096U, &config);
+    bool zero = ring != NULL;
+    for (size_t i = 0U; ring && i < ring->impl.ring.total_size; i += 4096U) {
+        zero &= ((const uint8_t*)ring->impl.ring.memory_base)[i] == 0U;
+    }
+    void* element = ring ? rtka_memory_alloc(ring, 256U) : NULL;
+    report_test("Arena: prefaulted ring is zeroed and usable",
+                zero && element == ring->impl.ring.memory_base &&
+                arena_covers(&ring->impl.ring.arena, ring->impl.ring.memory_base, ring->impl.ring.total_size));
+    rtka_destroy_allocator(ring);
+}
+
+static void test_arena_alignment_and_nodes(void) {
+    size_t page = arena_system_page();
+    rtka_arena_config_t config = {.page_size = RTKA_PAGES_HUGE_2M, .numa_policy = RTKA_NUMA_LOCAL};
+    /* mmap only guarantees page alignment */
+    rtka_allocator_t* aligned = rtka_create_stack_allocator_with_config(1U << 20, 2U * page, &config);
+    report_test("Arena: alignment past a page keeps aligned_alloc",
+                aligned && aligned->impl.stack.arena.mapped_size == 0U &&
+                (uintptr_t)aligned->impl.stack.memory_base % (2U * page) == 0U);
+    rtka_destroy_allocator(aligned);
+
+    uint32_t nodes = rtka_numa_node_count();
+    config.numa_policy = RTKA_NUMA_BIND;
+    config.numa_node = (int32_t)nodes;
+    report_test("Arena: binding an offline node fails",
+                nodes >= 1U && rtka_create_pool_allocator_with_config(64U, 100U, false, &config) == NULL);
+
+    /* mbind may be refused (no NUMA, sandbox): the arena stays, unbound */
+    config.numa_node = -1;
+    rtka_allocator_t* bound = rtka_create_pool_allocator_with_config(64U, 100U, true, &config);
+    int32_t node = bound ? bound->impl.pool.arena.node : -2;
+    report_test("Arena: bind to the calling thread's node",
+                bound && (node == -1 || (uint32_t)node < nodes) && pool_usable(bound));
+    rtka_destroy_allocator(bound);
+
+    config.numa_policy = RTKA_NUMA_INTERLEAVE;
+    rtka_allocator_t* interleaved = rtka_create_pool_allocator_with_config(64U, 100U, true, &config);
+    report_test("Arena: interleaved arenas name no node",
+                interleaved && interleaved->impl.pool.arena.node == -1 && pool_usable(interleaved));
+    rtka_destroy_allocator(interleaved);
+
+    rtka_node_allocators_t* per_node = rtka_create_node_pool_allocators(64U, 256U, true, NULL);
+    bool owners = per_node != NULL;
+    void* mine = NULL;
+    if (per_node) {
+        rtka_allocator_t* local = rtka_node_allocator(per_node);
+        mine = rtka_memory_alloc(local, 64U);
+        int stack_value = 0;
+        owners = mine && rtka_node_allocator_owner(per_node, mine) == local &&
+                 rtka_node_allocator_owner(per_node, &stack_value) == NULL &&
+                 rtka_node_allocator_at(per_node, nodes) == NULL;
+        for (uint32_t n = 0U; n < nodes; n++) {
+            rtka_allocator_t* pool = rtka_node_allocator_at(per_node, n);
+            owners &= pool && pool->impl.pool.arena.mapped_size > 0U &&
+                      (pool->impl.pool.arena.node == (int32_t)n || pool->impl.pool.arena.node == -1);
+        }
+        rtka_memory_free(local, mine);
+    }
+    report_test("Arena: per-node pools own their blocks", owners);
+    rtka_destroy_node_allocators(per_node);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("RTKA Memory Module Test Suite\n");
+    printf("Copyright (c) 2025 - H.Overman\n");
+    printf("Email: opsec.ee@pm.me\n");
+    printf("========================================\n\n");
+
+    printf("=== Magazine Tests ===\n");
+    test_magazine_refill_flush();
+    test_magazine_overflow();
+    test_magazine_thread_exit();
+    test_magazine_registry_reuse();
+    test_magazine_stress();
+    printf("\n");
+
+    printf("=== Slab Tests ===\n");
+    test_slab_class_boundaries();
+    test_slab_allocations();
+    test_slab_threads();
+    printf("\n");
+
+    printf("=== Arena Tests ===\n");
+    test_arena_default();
+    test_arena_huge_fallback();
+    test_arena_alignment_and_nodes();
+    printf("\n");
+
+    print_test_summary();
+
+    return (g_test_results.failed == 0U) ? 0 : 1;
+}